@@ -1,6 +1,12 @@
 #ifndef ZFP_CACHE_H
 #define ZFP_CACHE_H
 
+#include <algorithm>
+#include <ctime>
+#if defined(__cplusplus) && __cplusplus >= 201103L
+  #include <chrono>
+#endif
+#include "zfp.h"
 #include "memory.h"
 
 #ifdef ZFP_WITH_CACHE_PROFILE
@@ -10,7 +16,62 @@
 
 namespace zfp {
 
-// direct-mapped or two-way skew-associative write-back cache
+// cache line replacement policy
+enum cache_policy {
+  cache_direct_mapped = 0, // direct mapped (or two-way skew associative) cache
+  cache_lru = 1,           // set associative with least-recently-used replacement
+  cache_clock = 2,         // set associative with CLOCK (second chance) replacement
+  cache_arc = 3            // set associative with adaptive replacement (ARC)
+};
+
+// profiling range reported to callbacks set by zfp_set_trace_hooks()
+class trace_range {
+public:
+  explicit trace_range(const char* name) { zfp_trace_begin(name); }
+  ~trace_range() { zfp_trace_end(); }
+private:
+  trace_range(const trace_range&);
+  trace_range& operator=(const trace_range&);
+};
+
+// cache statistics gathered at run time when enabled
+class cache_statistics {
+public:
+  cache_statistics() { reset(); }
+
+  // zero all counters
+  void reset()
+  {
+    hits = misses = evictions = writebacks = unchanged = prefetches = promotions = 0;
+    encodes = decodes = 0;
+    encode_time = decode_time = 0;
+  }
+
+  // current time in seconds used for timing block encoding and decoding
+  static double time()
+  {
+#if defined(__cplusplus) && __cplusplus >= 201103L
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#else
+    return double(std::clock()) / CLOCKS_PER_SEC;
+#endif
+  }
+
+  uint64 hits;        // number of block accesses served by the cache
+  uint64 misses;      // number of block accesses not served by the cache
+  uint64 evictions;   // number of cached blocks replaced by other blocks
+  uint64 writebacks;  // number of modified cached blocks written back
+  uint64 unchanged;   // number of written-back blocks left as is since unchanged
+  uint64 prefetches;  // number of blocks fetched ahead of use
+  uint64 promotions;  // number of misses served by the secondary cache
+  uint64 encodes;     // number of blocks compressed
+  uint64 decodes;     // number of blocks decompressed
+  double encode_time; // seconds spent compressing blocks
+  double decode_time; // seconds spent decompressing blocks
+};
+
+// direct-mapped, two-way skew-associative, or N-way set-associative
+// write-back cache
 template <class Line>
 class Cache {
 public:
@@ -87,7 +148,18 @@ public:
   };
 
   // allocate cache with at least minsize lines
-  Cache(uint minsize = 0) : tag(0), line(0)
+  Cache(uint minsize = 0) :
+    replacement(cache_direct_mapped),
+    nways(1),
+    assoc(1),
+    ticks(0),
+    tag(0),
+    line(0),
+    stamp(0),
+    flag(0),
+    hand(0),
+    ghost(0),
+    memory(zfp::default_allocator())
   {
     resize(minsize);
 #ifdef ZFP_WITH_CACHE_PROFILE
@@ -98,7 +170,14 @@ public:
   }
 
   // copy constructor--performs a deep copy
-  Cache(const Cache& c) : tag(0), line(0)
+  Cache(const Cache& c) :
+    tag(0),
+    line(0),
+    stamp(0),
+    flag(0),
+    hand(0),
+    ghost(0),
+    memory(c.memory)
   {
     deep_copy(c);
   }
@@ -106,8 +185,10 @@ public:
   // destructor
   ~Cache()
   {
-    zfp::deallocate_aligned(tag);
-    zfp::deallocate_aligned(line);
+    zfp_memory_release(zfp_memory_host_cache, line_bytes());
+    zfp::deallocate_aligned(tag, memory);
+    zfp::deallocate_aligned(line, memory);
+    free_policy();
 #ifdef ZFP_WITH_CACHE_PROFILE
     std::cerr << "cache R1=" << hit[0][0] << " R2=" << hit[1][0] << " RM=" << miss[0] << " RB=" << back[0]
               <<      " W1=" << hit[0][1] << " W2=" << hit[1][1] << " WM=" << miss[1] << " WB=" << back[1] << std::endl;
@@ -122,15 +203,89 @@ public:
     return *this;
   }
 
+#if defined(__cplusplus) && __cplusplus >= 201103L
+  // move constructor--transfers cache lines in constant time
+  Cache(Cache&& c) : Cache() { swap(c); }
+
+  // move assignment operator--exchanges contents with c
+  Cache& operator=(Cache&& c)
+  {
+    swap(c);
+    return *this;
+  }
+#endif
+
+  // exchange contents with another cache in constant time
+  void swap(Cache& c)
+  {
+    std::swap(replacement, c.replacement);
+    std::swap(nways, c.nways);
+    std::swap(assoc, c.assoc);
+    std::swap(ticks, c.ticks);
+    std::swap(mask, c.mask);
+    std::swap(tag, c.tag);
+    std::swap(line, c.line);
+    std::swap(stamp, c.stamp);
+    std::swap(flag, c.flag);
+    std::swap(hand, c.hand);
+    std::swap(ghost, c.ghost);
+    std::swap(memory, c.memory);
+#ifdef ZFP_WITH_CACHE_PROFILE
+    std::swap_ranges(hit[0], hit[0] + 2, c.hit[0]);
+    std::swap_ranges(hit[1], hit[1] + 2, c.hit[1]);
+    std::swap_ranges(miss, miss + 2, c.miss);
+    std::swap_ranges(back, back + 2, c.back);
+#endif
+  }
+
   // cache size in number of lines
   uint size() const { return mask + 1; }
 
-  // change cache size to at least minsize lines (all contents will be lost)
+  // change cache size to at least minsize lines (all contents will be lost);
+  // the size is halved, down to two lines, until within any memory limit
+  // set by zfp_memory_set_limit(zfp_memory_host_cache, ...)
   void resize(uint minsize)
   {
+    zfp_memory_release(zfp_memory_host_cache, line_bytes());
     for (mask = minsize ? minsize - 1 : 1; mask & (mask + 1); mask |= mask + 1);
-    zfp::reallocate_aligned(tag, ((size_t)mask + 1) * sizeof(Tag), ZFP_MEMORY_ALIGNMENT);
-    zfp::reallocate_aligned(line, ((size_t)mask + 1) * sizeof(Line), ZFP_MEMORY_ALIGNMENT);
+    while (!zfp_memory_acquire(zfp_memory_host_cache, line_bytes(mask))) {
+      if (mask == 1) {
+        zfp_memory_charge(zfp_memory_host_cache, line_bytes(mask));
+        break;
+      }
+      mask >>= 1;
+    }
+    zfp::reallocate_aligned(tag, ((size_t)mask + 1) * sizeof(Tag), ZFP_MEMORY_ALIGNMENT, memory);
+    zfp::reallocate_aligned(line, ((size_t)mask + 1) * sizeof(Line), ZFP_MEMORY_ALIGNMENT, memory);
+    alloc_policy();
+    clear();
+  }
+
+  // allocate cache lines from given allocator (all contents will be lost)
+  void set_allocator(allocator* memory)
+  {
+    zfp_memory_release(zfp_memory_host_cache, line_bytes());
+    zfp::deallocate_aligned(tag, this->memory);
+    zfp::deallocate_aligned(line, this->memory);
+    tag = 0;
+    line = 0;
+    this->memory = memory;
+    resize(mask + 1);
+  }
+
+  // replacement policy
+  cache_policy policy() const { return replacement; }
+
+  // number of lines per set (one if direct mapped)
+  uint ways() const { return assoc; }
+
+  // set replacement policy and associativity (all contents will be lost)
+  void set_policy(cache_policy policy, uint ways = 4)
+  {
+    replacement = policy;
+    // round number of ways up to a power of two
+    for (nways = 1; policy != cache_direct_mapped && nways < std::max(ways, 2u); nways *= 2);
+    alloc_policy();
     clear();
   }
 
@@ -138,6 +293,15 @@ public:
   // otherwise return null
   Line* lookup(Index x, bool write)
   {
+    if (assoc > 1) {
+      uint i = find(x);
+      if (i == npos)
+        return 0;
+      touch(i);
+      if (write)
+        tag[i].mark();
+      return line + i;
+    }
     uint i = primary(x);
     if (tag[i].index() == x) {
       if (write)
@@ -160,6 +324,8 @@ public:
   // write-back (if the line is in use) and then fetch the requested line
   Tag access(Line*& ptr, Index x, bool write)
   {
+    if (assoc > 1)
+      return access_associative(ptr, x, write);
     uint i = primary(x);
     if (tag[i].index() == x) {
       ptr = line + i;
@@ -200,6 +366,8 @@ public:
   {
     for (uint i = 0; i <= mask; i++)
       tag[i].clear();
+    if (ghost)
+      std::fill(ghost, ghost + 2 * (size_t)(mask + 1), Index(0));
   }
 
   // flush cache line
@@ -213,12 +381,29 @@ public:
   const_iterator first() { return const_iterator(this); }
 
 protected:
+  static const uint npos = uint(-1); // line not found
+
   // perform a deep copy
   void deep_copy(const Cache& c)
   {
+    zfp_memory_release(zfp_memory_host_cache, line_bytes());
+    zfp_memory_charge(zfp_memory_host_cache, c.line_bytes());
     mask = c.mask;
-    zfp::clone_aligned(tag, c.tag, mask + 1, ZFP_MEMORY_ALIGNMENT);
-    zfp::clone_aligned(line, c.line, mask + 1, ZFP_MEMORY_ALIGNMENT);
+    zfp::deallocate_aligned(tag, memory);
+    zfp::deallocate_aligned(line, memory);
+    tag = 0;
+    line = 0;
+    memory = c.memory;
+    zfp::clone_aligned(tag, c.tag, mask + 1, ZFP_MEMORY_ALIGNMENT, memory);
+    zfp::clone_aligned(line, c.line, mask + 1, ZFP_MEMORY_ALIGNMENT, memory);
+    replacement = c.replacement;
+    nways = c.nways;
+    assoc = c.assoc;
+    ticks = c.ticks;
+    zfp::clone(stamp, c.stamp, mask + 1);
+    zfp::clone(flag, c.flag, mask + 1);
+    zfp::clone(hand, c.hand, mask + 1);
+    zfp::clone(ghost, c.ghost, 2 * (size_t)(mask + 1));
 #ifdef ZFP_WITH_CACHE_PROFILE
     hit[0][0] = c.hit[0][0];
     hit[0][1] = c.hit[0][1];
@@ -231,6 +416,192 @@ protected:
 #endif
   }
 
+  // bytes of tags and lines of cache with mask + 1 lines
+  static size_t line_bytes(Index mask) { return ((size_t)mask + 1) * (sizeof(Tag) + sizeof(Line)); }
+
+  // bytes of tags and lines accounted to zfp_memory_host_cache
+  size_t line_bytes() const { return line ? line_bytes(mask) : 0; }
+
+  // allocate per-line and per-set replacement state
+  void alloc_policy()
+  {
+    free_policy();
+    // a set cannot hold more lines than the cache
+    assoc = std::min(nways, mask + 1);
+    if (assoc > 1) {
+      size_t lines = (size_t)mask + 1;
+      zfp::reallocate(stamp, lines * sizeof(uint64));
+      zfp::reallocate(flag, lines * sizeof(uchar));
+      zfp::reallocate(hand, lines * sizeof(uint));
+      zfp::reallocate(ghost, 2 * lines * sizeof(Index));
+      std::fill(stamp, stamp + lines, uint64(0));
+      std::fill(flag, flag + lines, uchar(0));
+      std::fill(hand, hand + lines, 0u);
+      std::fill(ghost, ghost + 2 * lines, Index(0));
+    }
+    ticks = 0;
+  }
+
+  // free replacement state
+  void free_policy()
+  {
+    zfp::deallocate(stamp);
+    zfp::deallocate(flag);
+    zfp::deallocate(hand);
+    zfp::deallocate(ghost);
+    stamp = 0;
+    flag = 0;
+    hand = 0;
+    ghost = 0;
+  }
+
+  // first line of set that line #x maps to
+  uint set_base(Index x) const { return (x & (mask / assoc)) * assoc; }
+
+  // return line holding #x in set-associative cache, or npos if not cached
+  uint find(Index x) const
+  {
+    uint base = set_base(x);
+    for (uint i = base; i < base + assoc; i++)
+      if (tag[i].index() == x)
+        return i;
+    return npos;
+  }
+
+  // record hit on line i
+  void touch(uint i)
+  {
+    switch (replacement) {
+      case cache_clock:
+        flag[i] = 1;
+        break;
+      case cache_arc:
+        // promote line to frequently used list
+        flag[i] = 1;
+        stamp[i] = ++ticks;
+        break;
+      default:
+        stamp[i] = ++ticks;
+        break;
+    }
+  }
+
+  // set-associative counterpart of access()
+  Tag access_associative(Line*& ptr, Index x, bool write)
+  {
+    uint i = find(x);
+    if (i != npos) {
+      ptr = line + i;
+      touch(i);
+      if (write)
+        tag[i].mark();
+#ifdef ZFP_WITH_CACHE_PROFILE
+      hit[0][write]++;
+#endif
+      return tag[i];
+    }
+    // cache line not found; select victim according to policy
+    i = victim(x);
+    ptr = line + i;
+    Tag t = tag[i];
+    tag[i] = Tag(x, write);
+#ifdef ZFP_WITH_CACHE_PROFILE
+    miss[write]++;
+    if (t.dirty())
+      back[write]++;
+#endif
+    return t;
+  }
+
+  // select line to replace with #x and initialize its replacement state
+  uint victim(Index x)
+  {
+    uint base = set_base(x);
+    uint i = npos;
+    // prefer an unused line
+    for (uint j = base; j < base + assoc && i == npos; j++)
+      if (!tag[j].used())
+        i = j;
+    switch (replacement) {
+      case cache_clock:
+        if (i == npos) {
+          // advance hand, clearing reference bits, until an unreferenced line is found
+          uint& h = hand[base];
+          for (i = base + h; flag[i]; i = base + h) {
+            flag[i] = 0;
+            h = (h + 1) % assoc;
+          }
+          h = (h + 1) % assoc;
+        }
+        flag[i] = 0;
+        break;
+      case cache_arc: {
+        // lines with flag set belong to T2 (seen at least twice), others to T1;
+        // ghost lists B1 and B2 hold lines recently evicted from T1 and T2
+        uint& p = hand[base]; // target size of T1
+        Index* b1 = ghost + 2 * base;
+        Index* b2 = b1 + assoc;
+        bool in_b1 = remove_ghost(b1, x);
+        bool in_b2 = remove_ghost(b2, x);
+        if (in_b1)
+          p = std::min(p + 1, assoc);
+        else if (in_b2)
+          p = p ? p - 1 : 0;
+        if (i == npos) {
+          uint t1 = 0;
+          for (uint j = base; j < base + assoc; j++)
+            t1 += !flag[j];
+          bool from_t1 = t1 && (t1 > p || (in_b2 && t1 == p) || t1 == assoc);
+          i = least_recent(base, from_t1 ? 0 : 1);
+          insert_ghost(from_t1 ? b1 : b2, tag[i].index());
+        }
+        flag[i] = in_b1 || in_b2;
+        stamp[i] = ++ticks;
+        break;
+      }
+      default:
+        if (i == npos)
+          i = least_recent(base, 2);
+        stamp[i] = ++ticks;
+        break;
+    }
+    return i;
+  }
+
+  // least recently used line in set whose flag matches (any flag if 2)
+  uint least_recent(uint base, uint f) const
+  {
+    uint i = npos;
+    for (uint j = base; j < base + assoc; j++)
+      if ((f == 2 || flag[j] == f) && (i == npos || stamp[j] < stamp[i]))
+        i = j;
+    return i;
+  }
+
+  // remove #x from ghost list, if present
+  bool remove_ghost(Index* list, Index x)
+  {
+    for (uint j = 0; j < assoc; j++)
+      if (list[j] == x) {
+        std::copy(list + j + 1, list + assoc, list + j);
+        list[assoc - 1] = 0;
+        return true;
+      }
+    return false;
+  }
+
+  // append #x to ghost list, discarding its oldest entry if full
+  void insert_ghost(Index* list, Index x)
+  {
+    uint j;
+    for (j = 0; j < assoc && list[j]; j++);
+    if (j == assoc) {
+      std::copy(list + 1, list + assoc, list);
+      j--;
+    }
+    list[j] = x;
+  }
+
   uint primary(Index x) const { return x & mask; }
   uint secondary(Index x) const
   {
@@ -252,9 +623,18 @@ protected:
     return x & mask;
   }
 
-  Index mask; // cache line mask
-  Tag* tag;   // cache line tags
-  Line* line; // actual decompressed cache lines
+  cache_policy replacement; // replacement policy
+  uint nways;               // requested number of lines per set
+  uint assoc;               // number of lines per set (one if direct mapped)
+  uint64 ticks;             // access counter used to order line accesses
+  Index mask;               // cache line mask
+  Tag* tag;                 // cache line tags
+  Line* line;               // actual decompressed cache lines
+  uint64* stamp;            // per line: time of last access (LRU, ARC)
+  uchar* flag;              // per line: reference bit (CLOCK) or T2 membership (ARC)
+  uint* hand;               // per set: clock hand (CLOCK) or target size of T1 (ARC)
+  Index* ghost;             // per set: ghost lists B1 and B2 of evicted lines (ARC)
+  allocator* memory;        // allocator of tags and lines
 #ifdef ZFP_WITH_CACHE_PROFILE
   uint64 hit[2][2]; // number of primary/secondary read/write hits
   uint64 miss[2];   // number of read/write misses
@@ -1,19 +1,32 @@
 #ifndef ZFP_CACHE3_H
 #define ZFP_CACHE3_H
 
+#include <cfloat>
+#include <cmath>
+#include <vector>
 #include "cache.h"
 #include "store3.h"
 
 namespace zfp {
 
-template <typename Scalar, class Codec>
+template <typename Scalar, class Codec, class Store = BlockStore3<Scalar, Codec> >
 class BlockCache3 {
 public:
   // constructor of cache of given size
-  BlockCache3(BlockStore3<Scalar, Codec>& store, size_t bytes = 0) :
+  BlockCache3(Store& store, size_t bytes = 0) :
     cache((uint)((bytes + sizeof(CacheLine) - 1) / sizeof(CacheLine))),
+    secondary(1),
     store(store),
-    codec(0)
+    codec(0),
+    tiered(false),
+    budget(0),
+    accesses(0),
+    missed(0),
+    profile(false),
+    check(false),
+    depth(0),
+    backlog(0),
+    queued(0)
   {
     alloc();
   }
@@ -24,39 +37,325 @@ public:
   // cache size in number of bytes
   size_t size() const { return cache.size() * sizeof(CacheLine); }
 
-  // set minimum cache size in bytes (inferred from blocks if zero)
+  // set minimum cache size in bytes (inferred from blocks if zero); this
+  // disables adaptive sizing
   void resize(size_t bytes)
   {
     flush();
+    budget = 0;
     cache.resize(lines(bytes, store.blocks()));
   }
 
+  // byte budget of adaptive cache sizing (zero if disabled)
+  size_t adaptive_budget() const { return budget; }
+
+  // size cache adaptively within a budget of bytes (zero disables), starting
+  // with one slab of bx * by blocks (the whole array's if zero) and doubling
+  // the cache whenever too many accesses miss; lowering the budget shrinks
+  // the cache to fit
+  void set_adaptive(size_t bytes, size_t bx = 0, size_t by = 0)
+  {
+    budget = bytes;
+    accesses = missed = 0;
+    if (!budget)
+      return;
+    if (!bx || !by) {
+      bx = store.block_size_x();
+      by = store.block_size_y();
+    }
+    // round slab up to a power of two lines, then down to fit the budget
+    size_t n;
+    for (n = 1; n < bx * by; n *= 2);
+    while (n > 1 && n * sizeof(CacheLine) > budget)
+      n /= 2;
+    if (n != cache.size()) {
+      flush();
+      cache.resize(static_cast<uint>(n));
+    }
+  }
+
+  // set cache line replacement policy and number of lines per set
+  void set_policy(cache_policy policy, uint ways = 4)
+  {
+    flush();
+    cache.set_policy(policy, ways);
+  }
+
+  // move cache lines and compressed storage to memory from given allocator
+  void set_allocator(allocator* memory)
+  {
+    flush();
+    cache.set_allocator(memory);
+    secondary.set_allocator(memory);
+    free();
+    store.set_allocator(memory);
+    alloc();
+  }
+
+  // move compressed storage only to memory from given allocator
+  void set_store_allocator(allocator* memory)
+  {
+    flush();
+    free();
+    store.set_allocator(memory);
+    alloc();
+  }
+
+  // size in bytes of secondary cache of evicted blocks (zero if disabled)
+  size_t secondary_size() const { return tiered ? secondary.size() * sizeof(SecondaryLine) : 0; }
+
+  // set minimum size in bytes of secondary cache that keeps blocks evicted
+  // from the cache rounded to single precision, so that a later miss on
+  // them is served by conversion rather than decompression (zero disables)
+  void set_secondary_size(size_t bytes)
+  {
+    tiered = bytes != 0;
+    secondary.resize(tiered ? static_cast<uint>((bytes + sizeof(SecondaryLine) - 1) / sizeof(SecondaryLine)) : 1);
+  }
+
+  // number of blocks prefetched in block order following a cache miss
+  uint prefetch() const { return depth; }
+
+  // set number of blocks to prefetch following a cache miss (zero disables)
+  void set_prefetch(uint blocks) { depth = blocks; }
+
+  // maximum number of evicted modified blocks awaiting compression
+  uint write_behind() const { return backlog; }
+
+  // set number of evicted modified blocks to queue before compressing them
+  // as a batch (zero compresses each block upon eviction)
+  void set_write_behind(uint blocks)
+  {
+    flush();
+    backlog = blocks;
+    pending_line.resize(blocks);
+    pending_index.resize(blocks);
+  }
+
+  // whether modified blocks are compared with their fetched contents
+  bool skip_unchanged() const { return check; }
+
+  // enable or disable skipping compression of modified blocks whose values
+  // are unchanged since fetched, as detected via a 64-bit checksum
+  void set_skip_unchanged(bool enable)
+  {
+    // cached blocks were fetched without a checksum
+    flush();
+    clear();
+    check = enable;
+  }
+
+  // enable or disable gathering of statistics
+  void set_stats(bool enable) { profile = enable; }
+
+  // statistics gathered since last reset
+  const cache_statistics& stats() const { return statistics; }
+
+  // zero statistics
+  void reset_stats() { statistics.reset(); }
+
   // rate in bits per value
   double rate() const { return store.rate(); }
 
   // set rate in bits per value
   double set_rate(double rate)
   {
-    cache.clear();
+    clear();
     free();
     rate = store.set_rate(rate);
     alloc();
     return rate;
   }
 
-  // empty cache without compressing modified cached blocks
-  void clear() const { cache.clear(); }
+  // lower rate in bits per value while preserving contents
+  double set_rate_preserving(double rate)
+  {
+    flush();
+    clear();
+    free();
+    rate = store.set_rate_preserving(rate);
+    alloc();
+    return rate;
+  }
+
+  // set precision in uncompressed bits per value
+  uint set_precision(uint precision)
+  {
+    clear();
+    free();
+    store.set_precision(precision);
+    alloc();
+    return codec->precision();
+  }
+
+  // set absolute error tolerance
+  double set_accuracy(double tolerance)
+  {
+    clear();
+    free();
+    store.set_accuracy(tolerance);
+    alloc();
+    return codec->accuracy();
+  }
+
+  // limit compressed blocks to given number of bytes, lowering accuracy as
+  // needed
+  size_t set_budget(size_t bytes)
+  {
+    clear();
+    free();
+    store.set_budget(bytes);
+    alloc();
+    return bytes;
+  }
+
+  // enable reversible (lossless) compression
+  void set_reversible()
+  {
+    clear();
+    free();
+    store.set_reversible();
+    alloc();
+  }
+
+  // maximum number of bit planes decoded per block
+  uint max_precision() const { return codec->max_precision(); }
+
+  // limit decoding of cache misses to the first precision bit planes (zero
+  // for all), discarding cached blocks; intended for read-only access, as
+  // modified blocks would be encoded at the same limited precision
+  uint set_max_precision(uint precision)
+  {
+    flush();
+    clear();
+    return codec->set_max_precision(precision);
+  }
+
+  // empty cache and attach codec to store's (possibly reallocated) storage
+  void reset()
+  {
+    clear();
+    free();
+    alloc();
+  }
+
+  // reclaim storage held by stale variable-length blocks
+  void compact() const
+  {
+    flush();
+    store.compact(codec);
+  }
+
+  // replace compressed blocks overlapping box with packed blocks, discarding
+  // cached copies of their previous values
+  size_t unpack_blocks(const void* buffer, size_t x, size_t y, size_t z, size_t mx, size_t my, size_t mz)
+  {
+    flush();
+    clear();
+    return store.unpack(codec, buffer, x, y, z, mx, my, mz);
+  }
+
+  // copy box of mx * my * mz values at (x, y, z) of array cached by src to
+  // (dx, dy, dz); when both stores are compatible and the box is equally
+  // aligned to blocks in both arrays, blocks of the same shape that the box
+  // covers are copied without decompression, while edge blocks are
+  // decompressed and recompressed
+  void copy_blocks(const BlockCache3& src, size_t x, size_t y, size_t z, size_t mx, size_t my, size_t mz, size_t dx, size_t dy, size_t dz)
+  {
+    if (!mx || !my || !mz)
+      return;
+    src.flush();
+    flush();
+    clear();
+    const bool aligned = store.compatible(src.store) && x % 4 == dx % 4 && y % 4 == dy % 4 && z % 4 == dz % 4;
+    for (size_t k = dz / 4; k <= (dz + mz - 1) / 4; k++)
+      for (size_t j = dy / 4; j <= (dy + my - 1) / 4; j++)
+        for (size_t i = dx / 4; i <= (dx + mx - 1) / 4; i++) {
+          // intersection of block with box
+          size_t xmin = std::max(dx, 4 * i), xmax = std::min(dx + mx, 4 * i + 4);
+          size_t ymin = std::max(dy, 4 * j), ymax = std::min(dy + my, 4 * j + 4);
+          size_t zmin = std::max(dz, 4 * k), zmax = std::min(dz + mz, 4 * k + 4);
+          // corresponding position in src
+          size_t sx = x + (xmin - dx);
+          size_t sy = y + (ymin - dy);
+          size_t sz = z + (zmin - dz);
+          size_t b = store.block_index(xmin, ymin, zmin);
+          size_t a = src.store.block_index(sx, sy, sz);
+          uint shape = store.block_shape(b);
+          if (aligned && shape == src.store.block_shape(a) &&
+              xmax - xmin == 4 - (shape & 3u) &&
+              ymax - ymin == 4 - ((shape >> 2) & 3u) &&
+              zmax - zmin == 4 - ((shape >> 4) & 3u))
+            store.copy_block(codec, b, src.store, a);
+          else {
+            Scalar block[4 * 4 * 4];
+            src.get_box(block, sx, sy, sz, xmax - xmin, ymax - ymin, zmax - zmin, 1, 4, 16);
+            put_box(block, xmin, ymin, zmin, xmax - xmin, ymax - ymin, zmax - zmin, 1, 4, 16);
+          }
+        }
+  }
+
+  // empty cache and write-behind queue without compressing modified blocks
+  void clear() const
+  {
+    cache.clear();
+    secondary.clear();
+    queued = 0;
+  }
 
   // flush cache by compressing all modified cached blocks
   void flush() const
   {
+    trace_range range("zfp:cache_flush");
+#ifdef _OPENMP
+    if (store.mode() == zfp_mode_fixed_rate) {
+      // gather modified cached and queued blocks and compress them in parallel
+      std::vector<size_t> index(pending_index.begin(), pending_index.begin() + queued);
+      std::vector<const Scalar*> block;
+      for (size_t i = 0; i < queued; i++)
+        block.push_back(pending_line[i].data());
+      for (typename zfp::Cache<CacheLine>::const_iterator p = cache.first(); p; p++) {
+        if (p->tag.dirty()) {
+          if (profile)
+            statistics.writebacks++;
+          if (changed(p->line)) {
+            index.push_back(p->tag.index() - 1);
+            block.push_back(p->line->data());
+          }
+        }
+        cache.flush(p->line);
+      }
+      queued = 0;
+      const ptrdiff_t blocks = static_cast<ptrdiff_t>(index.size());
+      // copy any borrowed blocks before threads modify them
+      if (blocks)
+        store.own();
+      double t = profile ? cache_statistics::time() : 0.0;
+      #pragma omp parallel if (blocks > 1)
+      {
+        Codec* codec = store.codec();
+        #pragma omp for
+        for (ptrdiff_t i = 0; i < blocks; i++)
+          store.encode(codec, index[i], block[i]);
+      }
+      if (profile) {
+        statistics.encode_time += cache_statistics::time() - t;
+        statistics.encodes += blocks;
+      }
+      return;
+    }
+#endif
     for (typename zfp::Cache<CacheLine>::const_iterator p = cache.first(); p; p++) {
       if (p->tag.dirty()) {
         size_t block_index = p->tag.index() - 1;
-        store.encode(codec, block_index, p->line->data());
+        if (profile)
+          statistics.writebacks++;
+        if (changed(p->line))
+          encode(block_index, p->line->data());
       }
       cache.flush(p->line);
     }
+    drain();
   }
 
   // perform a deep copy
@@ -64,9 +363,43 @@ public:
   {
     free();
     cache = c.cache;
+    secondary = c.secondary;
+    tiered = c.tiered;
+    budget = c.budget;
+    accesses = c.accesses;
+    missed = c.missed;
+    profile = c.profile;
+    check = c.check;
+    statistics = c.statistics;
+    depth = c.depth;
+    backlog = c.backlog;
+    queued = c.queued;
+    pending_line = c.pending_line;
+    pending_index = c.pending_index;
     alloc();
   }
 
+  // exchange contents with cache c in constant time; the stores backing the
+  // two caches must be exchanged at the same time
+  void swap(BlockCache3& c)
+  {
+    cache.swap(c.cache);
+    secondary.swap(c.secondary);
+    std::swap(codec, c.codec);
+    std::swap(tiered, c.tiered);
+    std::swap(budget, c.budget);
+    std::swap(accesses, c.accesses);
+    std::swap(missed, c.missed);
+    std::swap(profile, c.profile);
+    std::swap(check, c.check);
+    std::swap(statistics, c.statistics);
+    std::swap(depth, c.depth);
+    std::swap(backlog, c.backlog);
+    std::swap(queued, c.queued);
+    pending_line.swap(c.pending_line);
+    pending_index.swap(c.pending_index);
+  }
+
   // inspector
   Scalar get(size_t i, size_t j, size_t k) const
   {
@@ -88,12 +421,54 @@ public:
     return (*p)(i, j, k);
   }
 
+  // pointer to cached block with given index; marks block modified if write
+  Scalar* block(size_t block_index, bool write) const { return line(block_index, write)->data(); }
+
+  // apply f(p, i, j, k, ...) to each block intersecting the box of size
+  // mx * my * mz at (x, y, z), passing it the block's part of the box
+  // relative to (x, y, z); see array3::for_each_block
+  template <typename Pointer, class Function>
+  Function visit(Function f, bool write, size_t x, size_t y, size_t z, size_t mx, size_t my, size_t mz) const
+  {
+    const size_t m = ~size_t(3);
+    for (size_t k = z & m; k < z + mz; k += 4) {
+      size_t kmin = std::max(k, z);
+      size_t kmax = std::min(k + 4, z + mz);
+      for (size_t j = y & m; j < y + my; j += 4) {
+        size_t jmin = std::max(j, y);
+        size_t jmax = std::min(j + 4, y + my);
+        for (size_t i = x & m; i < x + mx; i += 4) {
+          size_t imin = std::max(i, x);
+          size_t imax = std::min(i + 4, x + mx);
+          Pointer p = block(store.block_index(i, j, k), write) + (imin - i) + 4 * ((jmin - j) + 4 * (kmin - k));
+          f(p, imin - x, jmin - y, kmin - z, imax - imin, jmax - jmin, kmax - kmin);
+        }
+      }
+    }
+    return f;
+  }
+
   // copy block from cache, if cached, or fetch from persistent storage without caching
   void get_block(size_t block_index, Scalar* p, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz) const
   {
     const CacheLine* line = cache.lookup((uint)block_index + 1, false);
-    if (line)
+    if (profile)
+      (line ? statistics.hits : statistics.misses)++;
+    // blocks served by the secondary cache are decompressed at full precision
+    if (line && !line->approximate) {
       line->get(p, sx, sy, sz, store.block_shape(block_index));
+      return;
+    }
+    // copy block if it awaits compression in write-behind queue
+    size_t i = find_pending(block_index);
+    if (i < queued)
+      pending_line[i].get(p, sx, sy, sz, store.block_shape(block_index));
+    else if (profile) {
+      double t = cache_statistics::time();
+      store.decode(codec, block_index, p, sx, sy, sz);
+      statistics.decode_time += cache_statistics::time() - t;
+      statistics.decodes++;
+    }
     else
       store.decode(codec, block_index, p, sx, sy, sz);
   }
@@ -102,18 +477,320 @@ public:
   void put_block(size_t block_index, const Scalar* p, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz) const
   {
     CacheLine* line = cache.lookup((uint)block_index + 1, true);
-    if (line)
+    if (profile)
+      (line ? statistics.hits : statistics.misses)++;
+    if (line) {
       line->put(p, sx, sy, sz, store.block_shape(block_index));
+      line->approximate = false;
+      return;
+    }
+    // discard any stale queued or secondary copy of block
+    size_t i = find_pending(block_index);
+    if (i < queued)
+      remove_pending(i);
+    discard(block_index);
+    if (profile) {
+      double t = cache_statistics::time();
+      store.encode(codec, block_index, p, sx, sy, sz);
+      statistics.encode_time += cache_statistics::time() - t;
+      statistics.encodes++;
+    }
     else
       store.encode(codec, block_index, p, sx, sy, sz);
   }
 
+  // decompress all blocks to strided array, in parallel if OpenMP is enabled
+  void get_blocks(Scalar* p, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz) const
+  {
+#ifdef _OPENMP
+    // decode all blocks using the store's codec for each thread
+    const ptrdiff_t blocks = static_cast<ptrdiff_t>(store.blocks());
+    double t = profile ? cache_statistics::time() : 0.0;
+    #pragma omp parallel if (blocks > 1)
+    {
+      Codec* codec = store.codec();
+      #pragma omp for
+      for (ptrdiff_t b = 0; b < blocks; b++)
+        store.decode(codec, size_t(b), p + block_offset(size_t(b), sx, sy, sz), sx, sy, sz);
+    }
+    if (profile) {
+      statistics.decode_time += cache_statistics::time() - t;
+      statistics.decodes += blocks;
+    }
+    // cached and queued blocks may have been modified since last compressed
+    for (typename zfp::Cache<CacheLine>::const_iterator q = cache.first(); q; q++) {
+      size_t block_index = q->tag.index() - 1;
+      if (!q->line->approximate)
+        q->line->get(p + block_offset(block_index, sx, sy, sz), sx, sy, sz, store.block_shape(block_index));
+    }
+    for (size_t i = 0; i < queued; i++)
+      pending_line[i].get(p + block_offset(pending_index[i], sx, sy, sz), sx, sy, sz, store.block_shape(pending_index[i]));
+#else
+    for (size_t block_index = 0; block_index < store.blocks(); block_index++)
+      get_block(block_index, p + block_offset(block_index, sx, sy, sz), sx, sy, sz);
+#endif
+  }
+
+  // compress all blocks of strided array, in parallel if OpenMP is enabled
+  // and blocks are stored at fixed rate
+  void put_blocks(const Scalar* p, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz)
+  {
+#ifdef _OPENMP
+    if (store.mode() == zfp_mode_fixed_rate) {
+      // cached and queued blocks are superseded
+      clear();
+      store.own();
+      // encode all blocks using the store's codec for each thread
+      const ptrdiff_t blocks = static_cast<ptrdiff_t>(store.blocks());
+      double t = profile ? cache_statistics::time() : 0.0;
+      #pragma omp parallel if (blocks > 1)
+      {
+        Codec* codec = store.codec();
+        #pragma omp for
+        for (ptrdiff_t b = 0; b < blocks; b++)
+          store.encode(codec, size_t(b), p + block_offset(size_t(b), sx, sy, sz), sx, sy, sz);
+      }
+      if (profile) {
+        statistics.encode_time += cache_statistics::time() - t;
+        statistics.encodes += blocks;
+      }
+      return;
+    }
+#endif
+    for (size_t block_index = 0; block_index < store.blocks(); block_index++)
+      put_block(block_index, p + block_offset(block_index, sx, sy, sz), sx, sy, sz);
+  }
+
+  // decompress box of mx * my * mz values at (x, y, z) to strided array
+  // without caching any blocks; blocks fully covered by the box are
+  // decompressed directly to p, in parallel if OpenMP is enabled
+  void get_box(Scalar* p, size_t x, size_t y, size_t z, size_t mx, size_t my, size_t mz, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz) const
+  {
+    std::vector<size_t> index;
+    box_blocks(index, x, y, z, mx, my, mz);
+    const ptrdiff_t blocks = static_cast<ptrdiff_t>(index.size());
+    double t = profile ? cache_statistics::time() : 0.0;
+#ifdef _OPENMP
+    #pragma omp parallel if (blocks > 1)
+#endif
+    {
+      Codec* codec = store.codec();
+#ifdef _OPENMP
+      #pragma omp for
+#endif
+      for (ptrdiff_t b = 0; b < blocks; b++) {
+        size_t block_index = index[size_t(b)];
+        size_t lo[3], hi[3];
+        ptrdiff_t offset = clip(block_index, x, y, z, mx, my, mz, sx, sy, sz, lo, hi);
+        if (covered(block_index, lo, hi))
+          store.decode(codec, block_index, p + offset, sx, sy, sz);
+        else {
+          // partially covered block is decompressed to a temporary buffer
+          Scalar block[64];
+          store.decode(codec, block_index, block, 1, 4, 16);
+          copy_out(block, lo, hi, p + offset, sx, sy, sz);
+        }
+      }
+    }
+    if (profile) {
+      statistics.decode_time += cache_statistics::time() - t;
+      statistics.decodes += blocks;
+    }
+    // cached and queued blocks may have been modified since last compressed
+    for (typename zfp::Cache<CacheLine>::const_iterator q = cache.first(); q; q++)
+      if (!q->line->approximate)
+        get_box_block(q->tag.index() - 1, q->line->data(), p, x, y, z, mx, my, mz, sx, sy, sz);
+    for (size_t i = 0; i < queued; i++)
+      get_box_block(pending_index[i], pending_line[i].data(), p, x, y, z, mx, my, mz, sx, sy, sz);
+  }
+
+  // compress box of mx * my * mz values at (x, y, z) from strided array;
+  // uncached blocks fully covered by the box are compressed directly from p,
+  // in parallel if OpenMP is enabled and blocks are stored at fixed rate,
+  // while partially covered blocks are updated in the cache
+  void put_box(const Scalar* p, size_t x, size_t y, size_t z, size_t mx, size_t my, size_t mz, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz)
+  {
+    std::vector<size_t> index;
+    box_blocks(index, x, y, z, mx, my, mz);
+    std::vector<size_t> full;
+    for (size_t b = 0; b < index.size(); b++) {
+      size_t block_index = index[b];
+      size_t lo[3], hi[3];
+      ptrdiff_t offset = clip(block_index, x, y, z, mx, my, mz, sx, sy, sz, lo, hi);
+      if (covered(block_index, lo, hi)) {
+        CacheLine* line = cache.lookup((uint)block_index + 1, true);
+        if (profile)
+          (line ? statistics.hits : statistics.misses)++;
+        if (line) {
+          line->put(p + offset, sx, sy, sz, store.block_shape(block_index));
+          line->approximate = false;
+        }
+        else {
+          // discard any stale queued or secondary copy of block
+          size_t i = find_pending(block_index);
+          if (i < queued)
+            remove_pending(i);
+          discard(block_index);
+          full.push_back(block_index);
+        }
+      }
+      else
+        copy_in(p + offset, sx, sy, sz, lo, hi, block(block_index, true));
+    }
+    const ptrdiff_t blocks = static_cast<ptrdiff_t>(full.size());
+    if (!blocks)
+      return;
+    // copy any borrowed blocks before threads modify them
+    store.own();
+    double t = profile ? cache_statistics::time() : 0.0;
+#ifdef _OPENMP
+    // variable-length blocks share one buffer and must be compressed serially
+    #pragma omp parallel if (blocks > 1 && store.mode() == zfp_mode_fixed_rate)
+#endif
+    {
+      Codec* codec = store.codec();
+#ifdef _OPENMP
+      #pragma omp for
+#endif
+      for (ptrdiff_t b = 0; b < blocks; b++) {
+        size_t block_index = full[size_t(b)];
+        size_t lo[3], hi[3];
+        ptrdiff_t offset = clip(block_index, x, y, z, mx, my, mz, sx, sy, sz, lo, hi);
+        store.encode(codec, block_index, p + offset, sx, sy, sz);
+      }
+    }
+    if (profile) {
+      statistics.encode_time += cache_statistics::time() - t;
+      statistics.encodes += blocks;
+    }
+  }
+
+  // compress all blocks with values given by f(i, j, k), evaluated one block
+  // at a time; blocks are compressed in parallel by threads with their own
+  // copy of f if OpenMP is enabled and blocks are stored at fixed rate
+  template <class Function>
+  void generate_blocks(Function f)
+  {
+    // cached and queued blocks are superseded
+    clear();
+    store.own();
+    const ptrdiff_t blocks = static_cast<ptrdiff_t>(store.blocks());
+    double t = profile ? cache_statistics::time() : 0.0;
+#ifdef _OPENMP
+    // variable-length blocks share one buffer and must be compressed serially
+    #pragma omp parallel firstprivate(f) if (blocks > 1 && store.mode() == zfp_mode_fixed_rate)
+#endif
+    {
+      Codec* codec = store.codec();
+#ifdef _OPENMP
+      #pragma omp for
+#endif
+      for (ptrdiff_t b = 0; b < blocks; b++) {
+        Scalar block[64];
+        generate_block(f, size_t(b), block);
+        store.encode(codec, size_t(b), block, 1, 4, 16);
+      }
+    }
+    if (profile) {
+      statistics.encode_time += cache_statistics::time() - t;
+      statistics.encodes += blocks;
+    }
+  }
+
 protected:
+  // evaluate f(i, j, k) at the elements of the given block and store them
+  // contiguously at p; padding outside the array is left unset
+  template <class Function>
+  void generate_block(Function& f, size_t block_index, Scalar* p) const
+  {
+    uint shape = store.block_shape(block_index);
+    size_t mx = 4 - (shape & 3u); shape >>= 2;
+    size_t my = 4 - (shape & 3u); shape >>= 2;
+    size_t mz = 4 - (shape & 3u);
+    size_t x = 4 * (block_index % store.block_size_x()); block_index /= store.block_size_x();
+    size_t y = 4 * (block_index % store.block_size_y()); block_index /= store.block_size_y();
+    size_t z = 4 * block_index;
+    for (size_t k = 0; k < mz; k++, p += 16 - 4 * my)
+      for (size_t j = 0; j < my; j++, p += 4 - mx)
+        for (size_t i = 0; i < mx; i++, p++)
+          *p = f(x + i, y + j, z + k);
+  }
+
+  // offset into strided array of first value in block
+  ptrdiff_t block_offset(size_t block_index, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz) const
+  {
+    ptrdiff_t i = static_cast<ptrdiff_t>(block_index % store.block_size_x()); block_index /= store.block_size_x();
+    ptrdiff_t j = static_cast<ptrdiff_t>(block_index % store.block_size_y()); block_index /= store.block_size_y();
+    ptrdiff_t k = static_cast<ptrdiff_t>(block_index);
+    return 4 * (i * sx + j * sy + k * sz);
+  }
+
+  // indices of blocks intersecting box of mx * my * mz values at (x, y, z)
+  void box_blocks(std::vector<size_t>& index, size_t x, size_t y, size_t z, size_t mx, size_t my, size_t mz) const
+  {
+    if (mx && my && mz)
+      for (size_t k = z & ~size_t(3); k < z + mz; k += 4)
+        for (size_t j = y & ~size_t(3); j < y + my; j += 4)
+          for (size_t i = x & ~size_t(3); i < x + mx; i += 4)
+            index.push_back(store.block_index(i, j, k));
+  }
+
+  // block-local ranges [lo, hi) of values of block inside box, which are
+  // empty if they do not intersect; returns offset into strided array of
+  // box of first such value
+  ptrdiff_t clip(size_t block_index, size_t x, size_t y, size_t z, size_t mx, size_t my, size_t mz, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz, size_t* lo, size_t* hi) const
+  {
+    size_t i = 4 * (block_index % store.block_size_x()); block_index /= store.block_size_x();
+    size_t j = 4 * (block_index % store.block_size_y()); block_index /= store.block_size_y();
+    size_t k = 4 * block_index;
+    lo[0] = std::max(i, x) - i; hi[0] = std::max(std::min(i + 4, x + mx), i) - i;
+    lo[1] = std::max(j, y) - j; hi[1] = std::max(std::min(j + 4, y + my), j) - j;
+    lo[2] = std::max(k, z) - k; hi[2] = std::max(std::min(k + 4, z + mz), k) - k;
+    return sx * static_cast<ptrdiff_t>(i + lo[0] - x) + sy * static_cast<ptrdiff_t>(j + lo[1] - y) + sz * static_cast<ptrdiff_t>(k + lo[2] - z);
+  }
+
+  // whether ranges [lo, hi) span all values of block with given index
+  bool covered(size_t block_index, const size_t* lo, const size_t* hi) const
+  {
+    uint shape = store.block_shape(block_index);
+    for (uint d = 0; d < 3; d++, shape >>= 2)
+      if (lo[d] || hi[d] != 4 - (shape & 3u))
+        return false;
+    return true;
+  }
+
+  // copy part [lo, hi) of contiguous block q to strided array p
+  static void copy_out(const Scalar* q, const size_t* lo, const size_t* hi, Scalar* p, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz)
+  {
+    for (size_t k = lo[2]; k < hi[2]; k++)
+      for (size_t j = lo[1]; j < hi[1]; j++)
+        for (size_t i = lo[0]; i < hi[0]; i++)
+          p[sx * ptrdiff_t(i - lo[0]) + sy * ptrdiff_t(j - lo[1]) + sz * ptrdiff_t(k - lo[2])] = q[i + 4 * (j + 4 * k)];
+  }
+
+  // copy strided array p to part [lo, hi) of contiguous block q
+  static void copy_in(const Scalar* p, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz, const size_t* lo, const size_t* hi, Scalar* q)
+  {
+    for (size_t k = lo[2]; k < hi[2]; k++)
+      for (size_t j = lo[1]; j < hi[1]; j++)
+        for (size_t i = lo[0]; i < hi[0]; i++)
+          q[i + 4 * (j + 4 * k)] = p[sx * ptrdiff_t(i - lo[0]) + sy * ptrdiff_t(j - lo[1]) + sz * ptrdiff_t(k - lo[2])];
+  }
+
+  // copy part of decompressed block q inside box to strided array p
+  void get_box_block(size_t block_index, const Scalar* q, Scalar* p, size_t x, size_t y, size_t z, size_t mx, size_t my, size_t mz, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz) const
+  {
+    size_t lo[3], hi[3];
+    ptrdiff_t offset = clip(block_index, x, y, z, mx, my, mz, sx, sy, sz, lo, hi);
+    if (lo[0] < hi[0] && lo[1] < hi[1] && lo[2] < hi[2])
+      copy_out(q, lo, hi, p + offset, sx, sy, sz);
+  }
+
   // allocate codec
   void alloc()
   {
     codec = new Codec(store.compressed_data(), store.compressed_size());
-    codec->set_rate(store.rate());
+    store.configure(codec);
   }
 
   // free allocated data
@@ -136,6 +813,19 @@ protected:
     const Scalar* data() const { return a; }
     Scalar* data() { return a; }
 
+    // 64-bit FNV-1a hash of block values
+    uint64 checksum() const
+    {
+      const uchar* p = reinterpret_cast<const uchar*>(a);
+      uint64 h = UINT64C(0xcbf29ce484222325);
+      for (size_t n = 0; n < sizeof(a); n++)
+        h = (h ^ p[n]) * UINT64C(0x100000001b3);
+      return h;
+    }
+
+    uint64 fetched;   // checksum of values when fetched
+    bool approximate; // whether values were rounded by the secondary cache
+
     // copy whole block from cache line
     void get(Scalar* p, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz) const
     {
@@ -197,23 +887,262 @@ protected:
     Scalar a[4 * 4 * 4];
   };
 
+  // block evicted from the cache with values rounded to single precision
+  class SecondaryLine {
+  public:
+    // round block values; return false if some value exceeds the float range
+    bool put(const Scalar* p)
+    {
+      for (uint i = 0; i < 4 * 4 * 4; i++) {
+        if (std::fabs(p[i]) > FLT_MAX)
+          return false;
+        a[i] = static_cast<float>(p[i]);
+      }
+      return true;
+    }
+
+    // convert rounded block values back to scalar type
+    void get(Scalar* p) const
+    {
+      for (uint i = 0; i < 4 * 4 * 4; i++)
+        p[i] = static_cast<Scalar>(a[i]);
+    }
+
+  protected:
+    float a[4 * 4 * 4];
+  };
+
   // return cache line for (i, j, k); may require write-back and fetch
-  CacheLine* line(size_t i, size_t j, size_t k, bool write) const
+  CacheLine* line(size_t i, size_t j, size_t k, bool write) const { return line(store.block_index(i, j, k), write); }
+
+  // return cache line for block; may require write-back and fetch
+  CacheLine* line(size_t block_index, bool write) const
   {
     CacheLine* p = 0;
-    size_t block_index = store.block_index(i, j, k);
+    // reconsider cache size once per window of accesses
+    if (budget && ++accesses >= adapt_window * cache.size())
+      adapt();
+    // on a miss, first fetch the blocks that are likely to be accessed next
+    if (depth && !cache.lookup((uint)block_index + 1, false))
+      prefetch(block_index + 1, std::min<size_t>(depth, cache.size() - 1));
     typename zfp::Cache<CacheLine>::Tag tag = cache.access(p, (uint)block_index + 1, write);
     size_t stored_block_index = tag.index() - 1;
     if (stored_block_index != block_index) {
+      missed++;
+      if (profile) {
+        statistics.misses++;
+        if (tag.used())
+          statistics.evictions++;
+        if (tag.dirty())
+          statistics.writebacks++;
+      }
       // write back occupied cache line if it is dirty
       if (tag.dirty())
-        store.encode(codec, stored_block_index, p->data());
+        write_back(stored_block_index, p);
+      // keep evicted unmodified block in secondary cache; modified blocks
+      // are served by decompression so that reads reflect compression error
+      if (tag.used() && !tag.dirty())
+        demote(stored_block_index, p);
       // fetch cache line
-      store.decode(codec, block_index, p->data());
+      fetch(block_index, p, write);
+    }
+    else {
+      if (profile)
+        statistics.hits++;
+      // modify block only after decompressing it at full precision
+      if (write && p->approximate)
+        refetch(block_index, p);
     }
     return p;
   }
 
+  // double cache size, within budget, if the last window of accesses missed
+  // more often than a sweep over a cache-resident slab would
+  void adapt() const
+  {
+    size_t n = 2 * size_t(cache.size());
+    if (missed * adapt_ratio > accesses && n * sizeof(CacheLine) <= budget) {
+      flush();
+      cache.resize(static_cast<uint>(n));
+    }
+    accesses = missed = 0;
+  }
+
+  // fetch up to count blocks starting at block_index that are not cached
+  void prefetch(size_t block_index, size_t count) const
+  {
+    size_t end = std::min(block_index + count, store.blocks());
+    for (; block_index < end; block_index++) {
+      if (cache.lookup((uint)block_index + 1, false))
+        continue;
+      CacheLine* p = 0;
+      typename zfp::Cache<CacheLine>::Tag tag = cache.access(p, (uint)block_index + 1, false);
+      if (profile) {
+        statistics.prefetches++;
+        if (tag.used())
+          statistics.evictions++;
+        if (tag.dirty())
+          statistics.writebacks++;
+      }
+      if (tag.dirty())
+        write_back(tag.index() - 1, p);
+      if (tag.used() && !tag.dirty())
+        demote(tag.index() - 1, p);
+      fetch(block_index, p, false);
+    }
+  }
+
+  // true unless modified line is known to hold the values it was fetched with
+  bool changed(const CacheLine* line) const
+  {
+    if (!check || line->checksum() != line->fetched)
+      return true;
+    if (profile)
+      statistics.unchanged++;
+    return false;
+  }
+
+  // write back modified block, deferring compression if write-behind is enabled
+  void write_back(size_t block_index, const CacheLine* line) const
+  {
+    if (!changed(line))
+      return;
+    if (!backlog) {
+      encode(block_index, line->data());
+      return;
+    }
+    if (queued == backlog)
+      drain();
+    std::copy(line->data(), line->data() + 4 * 4 * 4, pending_line[queued].data());
+    pending_index[queued++] = block_index;
+  }
+
+  // fetch block, reclaiming it from the write-behind queue if pending or,
+  // unless it is about to be modified, from the secondary cache
+  void fetch(size_t block_index, CacheLine* line, bool write) const
+  {
+    size_t i = find_pending(block_index);
+    line->approximate = false;
+    if (i < queued) {
+      // block has not yet been compressed, so cache line remains modified
+      std::copy(pending_line[i].data(), pending_line[i].data() + 4 * 4 * 4, line->data());
+      remove_pending(i);
+      cache.lookup((uint)block_index + 1, true);
+      // ensure the line does not compare equal to its stored block
+      if (check)
+        line->fetched = ~line->checksum();
+      return;
+    }
+    if (tiered) {
+      SecondaryLine* q = secondary.lookup((uint)block_index + 1, false);
+      if (q) {
+        // blocks are held by at most one of the two caches
+        secondary.flush(q);
+        if (!write) {
+          q->get(line->data());
+          line->approximate = true;
+          if (profile)
+            statistics.promotions++;
+          if (check)
+            line->fetched = line->checksum();
+          return;
+        }
+      }
+    }
+    decode(block_index, line->data());
+    if (check)
+      line->fetched = line->checksum();
+  }
+
+  // replace rounded values of cached block with fully decompressed ones
+  void refetch(size_t block_index, CacheLine* line) const
+  {
+    decode(block_index, line->data());
+    line->approximate = false;
+    if (check)
+      line->fetched = line->checksum();
+  }
+
+  // move block evicted from the cache to the secondary cache
+  void demote(size_t block_index, const CacheLine* line) const
+  {
+    if (!tiered)
+      return;
+    SecondaryLine* q = 0;
+    secondary.access(q, (uint)block_index + 1, false);
+    if (!q->put(line->data()))
+      secondary.flush(q);
+  }
+
+  // discard any copy of block held by the secondary cache
+  void discard(size_t block_index) const
+  {
+    if (tiered) {
+      SecondaryLine* q = secondary.lookup((uint)block_index + 1, false);
+      if (q)
+        secondary.flush(q);
+    }
+  }
+
+  // position of block in write-behind queue (or queued if not pending)
+  size_t find_pending(size_t block_index) const
+  {
+    size_t i;
+    for (i = 0; i < queued && pending_index[i] != block_index; i++);
+    return i;
+  }
+
+  // remove i-th block from write-behind queue
+  void remove_pending(size_t i) const
+  {
+    queued--;
+    if (i != queued) {
+      pending_line[i] = pending_line[queued];
+      pending_index[i] = pending_index[queued];
+    }
+  }
+
+  // compress all blocks in write-behind queue
+  void drain() const
+  {
+    for (size_t i = 0; i < queued; i++)
+      encode(pending_index[i], pending_line[i].data());
+    queued = 0;
+  }
+
+  // encode contiguous block, timing it if statistics are enabled
+  void encode(size_t block_index, const Scalar* block) const
+  {
+    if (profile) {
+      double t = cache_statistics::time();
+      store.encode(codec, block_index, block);
+      statistics.encode_time += cache_statistics::time() - t;
+      statistics.encodes++;
+    }
+    else
+      store.encode(codec, block_index, block);
+  }
+
+  // decode contiguous block, timing it if statistics are enabled
+  void decode(size_t block_index, Scalar* block) const
+  {
+    if (profile) {
+      double t = cache_statistics::time();
+      store.decode(codec, block_index, block);
+      statistics.decode_time += cache_statistics::time() - t;
+      statistics.decodes++;
+    }
+    else
+      store.decode(codec, block_index, block);
+  }
+
+  // adaptation window in accesses per cache line
+  static const size_t adapt_window = 4 * 4 * 4;
+
+  // grow cache when more than one in adapt_ratio accesses miss, i.e., at
+  // twice the rate of a sweep that touches each value of a block once
+  static const size_t adapt_ratio = 32;
+
   // default number of cache lines for array with given number of blocks
   static uint lines(size_t blocks)
   {
@@ -230,9 +1159,22 @@ protected:
     return std::max(n, 1u);
   }
 
-  mutable Cache<CacheLine> cache;    // cache of decompressed blocks
-  BlockStore3<Scalar, Codec>& store; // store backed by cache
-  Codec* codec;                      // compression codec
+  mutable Cache<CacheLine> cache;      // cache of decompressed blocks
+  mutable Cache<SecondaryLine> secondary; // evicted blocks rounded to float
+  Store& store;                        // store backed by cache
+  Codec* codec;                        // compression codec
+  bool tiered;                         // whether secondary cache is in use
+  size_t budget;                       // byte budget of adaptive sizing (zero if disabled)
+  mutable size_t accesses;             // accesses in current adaptation window
+  mutable size_t missed;               // misses in current adaptation window
+  bool profile;                        // whether to gather statistics
+  bool check;                          // whether to skip unchanged blocks
+  mutable cache_statistics statistics; // statistics gathered since last reset
+  uint depth;                          // number of blocks to prefetch on a miss
+  uint backlog;                        // capacity of write-behind queue
+  mutable size_t queued;               // number of blocks in write-behind queue
+  mutable std::vector<CacheLine> pending_line; // evicted blocks awaiting compression
+  mutable std::vector<size_t> pending_index;   // indices of queued blocks
 };
 
 }
@@ -31,6 +31,23 @@ public:
     cache.resize(lines(bytes, store.blocks()));
   }
 
+  // set cache line replacement policy and number of lines per set
+  void set_policy(cache_policy policy, uint ways = 4)
+  {
+    flush();
+    cache.set_policy(policy, ways);
+  }
+
+  // move cache lines and compressed storage to memory from given allocator
+  void set_allocator(allocator* memory)
+  {
+    flush();
+    cache.set_allocator(memory);
+    free();
+    store.set_allocator(memory);
+    alloc();
+  }
+
   // rate in bits per value
   double rate() const { return store.rate(); }
 
@@ -44,12 +61,24 @@ public:
     return rate;
   }
 
+  // lower rate in bits per value while preserving contents
+  double set_rate_preserving(double rate)
+  {
+    flush();
+    cache.clear();
+    free();
+    rate = store.set_rate_preserving(rate);
+    alloc();
+    return rate;
+  }
+
   // empty cache without compressing modified cached blocks
   void clear() const { cache.clear(); }
 
   // flush cache by compressing all modified cached blocks
   void flush() const
   {
+    trace_range range("zfp:cache_flush");
     for (typename zfp::Cache<CacheLine>::const_iterator p = cache.first(); p; p++) {
       if (p->tag.dirty()) {
         size_t block_index = p->tag.index() - 1;
@@ -67,6 +96,14 @@ public:
     alloc();
   }
 
+  // exchange contents with cache c in constant time; the stores backing the
+  // two caches must be exchanged at the same time
+  void swap(BlockCache4& c)
+  {
+    cache.swap(c.cache);
+    std::swap(codec, c.codec);
+  }
+
   // inspector
   Scalar get(size_t i, size_t j, size_t k, size_t l) const
   {
@@ -0,0 +1,121 @@
+#ifndef ZFP_COARSEN3_H
+#define ZFP_COARSEN3_H
+
+#include <algorithm>
+#include "zfp/exception.h"
+
+// downsampling of 3D arrays by averaging in the compressed domain
+
+namespace zfp {
+
+template <typename Scalar, class Codec>
+class array3;
+
+namespace internal {
+namespace dim3 {
+
+// builds each block of a coarser array from the factor^3 fine blocks it
+// covers; each full fine block is reduced to its (4 / factor)^3 sub-block
+// averages by decoding its coefficients and inverting only the low-sequency
+// part of the decorrelating transform, while partial blocks and blocks of
+// reversible arrays, which have no such shortcut, are decoded in full
+template <class Array>
+class block_coarsener {
+public:
+  typedef typename Array::value_type value_type;
+  typedef typename Array::codec_type codec_type;
+
+  static void coarsen(const Array& src, Array& dst, uint factor)
+  {
+    if (factor != 2 && factor != 4)
+      throw zfp::exception("zfp::coarsen requires a factor of 2 or 4");
+    if (&src == &dst)
+      throw zfp::exception("zfp::coarsen requires distinct arrays");
+    src.flush_cache();
+    dst.resize((src.nx + factor - 1) / factor, (src.ny + factor - 1) / factor, (src.nz + factor - 1) / factor, false);
+    const long blocks = static_cast<long>(dst.store.blocks());
+    // variable-length blocks are appended to shared storage one at a time
+#ifdef _OPENMP
+    #pragma omp parallel if (dst.mode() == zfp_mode_fixed_rate)
+#endif
+    {
+      codec_type* scodec = src.store.codec();
+      codec_type* dcodec = dst.store.codec();
+#ifdef _OPENMP
+      #pragma omp for
+#endif
+      for (long b = 0; b < blocks; b++)
+        coarsen_block(src, scodec, dst, dcodec, factor, size_t(b));
+    }
+    dst.clear_cache();
+  }
+
+protected:
+  // encode block b of dst from the fine blocks of src that it covers
+  static void coarsen_block(const Array& src, codec_type* scodec, const Array& dst, codec_type* dcodec, uint factor, size_t b)
+  {
+    const size_t bx = src.store.block_size_x();
+    const size_t by = src.store.block_size_y();
+    const size_t bz = src.store.block_size_z();
+    const size_t i0 = factor * (b % dst.store.block_size_x());
+    const size_t j0 = factor * (b / dst.store.block_size_x() % dst.store.block_size_y());
+    const size_t k0 = factor * (b / (dst.store.block_size_x() * dst.store.block_size_y()));
+    // number of coarse values per fine block along each dimension
+    const uint m = 4 / factor;
+    value_type block[64];
+    value_type fine[64];
+    std::fill(block, block + 64, value_type(0));
+    for (size_t k = k0; k < std::min(k0 + factor, bz); k++)
+      for (size_t j = j0; j < std::min(j0 + factor, by); j++)
+        for (size_t i = i0; i < std::min(i0 + factor, bx); i++) {
+          const size_t f = i + bx * (j + by * k);
+          value_type* p = block + m * ((i - i0) + 4 * (j - j0) + 16 * (k - k0));
+          if (!src.store.block_shape(f) && src.store.decode_lod(scodec, f, fine, factor == 2 ? 1 : 0)) {
+            for (uint z = 0; z < m; z++)
+              for (uint y = 0; y < m; y++)
+                for (uint x = 0; x < m; x++)
+                  p[x + 4 * y + 16 * z] = fine[x + m * (y + m * z)];
+          }
+          else {
+            src.store.decode(scodec, f, fine);
+            average(fine, p, factor, std::min(src.nx - 4 * i, size_t(4)), std::min(src.ny - 4 * j, size_t(4)), std::min(src.nz - 4 * k, size_t(4)));
+          }
+        }
+    dst.store.encode(dcodec, b, block);
+  }
+
+  // average factor^3 cells of fine block holding nx * ny * nz valid values
+  // and store the averages at p with strides 1, 4, 16
+  static void average(const value_type* fine, value_type* p, uint factor, size_t nx, size_t ny, size_t nz)
+  {
+    const uint m = 4 / factor;
+    for (uint z = 0; z < m; z++)
+      for (uint y = 0; y < m; y++)
+        for (uint x = 0; x < m; x++) {
+          double sum = 0;
+          size_t count = 0;
+          for (size_t k = factor * z; k < std::min(size_t(factor * (z + 1)), nz); k++)
+            for (size_t j = factor * y; j < std::min(size_t(factor * (y + 1)), ny); j++)
+              for (size_t i = factor * x; i < std::min(size_t(factor * (x + 1)), nx); i++, count++)
+                sum += double(fine[i + 4 * j + 16 * k]);
+          if (count)
+            p[x + 4 * y + 16 * z] = value_type(sum / double(count));
+        }
+  }
+};
+
+} // dim3
+} // internal
+
+// resize dst to the size of src divided by factor (2 or 4), rounded up, and
+// fill it with the averages of factor^3 cells of src, encoding each block of
+// dst directly from sub-block averages of the blocks of src that it covers
+template <typename Scalar, class Codec>
+void coarsen(const array3<Scalar, Codec>& src, array3<Scalar, Codec>& dst, uint factor)
+{
+  zfp::internal::dim3::block_coarsener< array3<Scalar, Codec> >::coarsen(src, dst, factor);
+}
+
+} // zfp
+
+#endif
@@ -0,0 +1,78 @@
+#ifndef ZFP_CODEC_POOL_H
+#define ZFP_CODEC_POOL_H
+
+#include <cstddef>
+#include <vector>
+
+#ifdef _OPENMP
+  #include <omp.h>
+#endif
+
+namespace zfp {
+
+// codecs owned by a block store, one per thread, each attached to the
+// store's compressed data; a thread's codec is allocated on first use and
+// reused by later operations, so concurrent block encoding and decoding
+// need neither per-operation codec construction nor shared stream state
+template <class Codec>
+class CodecPool {
+public:
+  // default constructor
+  CodecPool() {}
+
+  // copies start out empty, as codecs are tied to their store
+  CodecPool(const CodecPool&) {}
+
+  // destructor
+  ~CodecPool() { free(); }
+
+  // assignment leaves codecs untouched
+  CodecPool& operator=(const CodecPool&) { return *this; }
+
+  // codec of calling thread, configured for the current compression mode of
+  // store and attached to its current storage
+  template <class Store>
+  Codec* get(const Store& store) const
+  {
+    Codec* c = 0;
+    size_t i = thread();
+#ifdef _OPENMP
+    #pragma omp critical(zfp_codec_pool)
+#endif
+    {
+      if (codec.size() <= i)
+        codec.resize(i + 1, static_cast<Codec*>(0));
+      if (!codec[i])
+        codec[i] = new Codec(store.compressed_data(), store.compressed_size());
+      c = codec[i];
+    }
+    store.configure(c);
+    store.attach(c);
+    return c;
+  }
+
+  // deallocate all codecs
+  void free()
+  {
+    for (size_t i = 0; i < codec.size(); i++)
+      delete codec[i];
+    codec.clear();
+  }
+
+protected:
+  // index of calling thread
+  static size_t thread()
+  {
+#ifdef _OPENMP
+    return size_t(omp_get_thread_num());
+#else
+    return 0;
+#endif
+  }
+
+  mutable std::vector<Codec*> codec; // codec per thread (null until first use)
+};
+
+}
+
+#endif
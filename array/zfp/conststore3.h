@@ -0,0 +1,233 @@
+#ifndef ZFP_CONST_STORE3_H
+#define ZFP_CONST_STORE3_H
+
+#include <vector>
+#include "zfp/store3.h"
+#include "zfp/index.h"
+
+namespace zfp {
+
+// read-only compressed block store for 3D array whose variable-length
+// blocks are packed back to back and located via a delta-coded index
+template <typename Scalar, class Codec>
+class ConstBlockStore3 : public BlockStore3<Scalar, Codec> {
+public:
+  // default constructor
+  ConstBlockStore3() :
+    bits(0)
+  {}
+
+  // block store for array of size nx * ny * nz and given rate
+  ConstBlockStore3(size_t nx, size_t ny, size_t nz, double rate) :
+    bits(0)
+  {
+    set_rate(rate);
+    resize(nx, ny, nz);
+  }
+
+  // perform a deep copy
+  void deep_copy(const ConstBlockStore3& s)
+  {
+    BlockStore3<Scalar, Codec>::deep_copy(s);
+    delta_index.deep_copy(s.delta_index);
+    bits = s.bits;
+  }
+
+  // rate in bits per value of compressed blocks, excluding index
+  double rate() const { return blocks() ? double(bits) / (blocks() * block_size) : 0.0; }
+
+  // storage required by index in bits
+  size_t index_size_bits() const { return delta_index.size_bits(); }
+
+  // set rate in bits per value
+  double set_rate(double rate)
+  {
+    free();
+    compression_mode = zfp_mode_fixed_rate;
+    rate = Codec::nearest_rate(rate);
+    bits_per_block = uint(rate * block_size);
+    return rate;
+  }
+
+  // set precision in uncompressed bits per value
+  uint set_precision(uint precision)
+  {
+    free();
+    compression_mode = zfp_mode_fixed_precision;
+    this->precision = std::min(precision, uint(CHAR_BIT * sizeof(Scalar)));
+    return this->precision;
+  }
+
+  // set absolute error tolerance
+  double set_accuracy(double tolerance)
+  {
+    free();
+    compression_mode = zfp_mode_fixed_accuracy;
+    Codec codec(0, 0);
+    this->tolerance = codec.set_accuracy(tolerance);
+    return this->tolerance;
+  }
+
+  // enable reversible (lossless) compression
+  void set_reversible()
+  {
+    free();
+    compression_mode = zfp_mode_reversible;
+  }
+
+  // configure codec for current compression mode
+  void configure(Codec* codec) const
+  {
+    switch (compression_mode) {
+      case zfp_mode_fixed_precision:
+        codec->set_precision(precision);
+        break;
+      case zfp_mode_fixed_accuracy:
+        codec->set_accuracy(tolerance);
+        break;
+      case zfp_mode_reversible:
+        codec->set_reversible();
+        break;
+      default:
+        codec->set_rate(double(bits_per_block) / block_size);
+        break;
+    }
+  }
+
+  // resize array; contents are all zero until set() is called, or are
+  // undefined until load() is called unless clear is true
+  void resize(size_t nx, size_t ny, size_t nz, bool clear = true)
+  {
+    free();
+    if (nx == 0 || ny == 0 || nz == 0) {
+      this->nx = this->ny = this->nz = 0;
+      bx = by = bz = 0;
+    }
+    else {
+      this->nx = nx;
+      this->ny = ny;
+      this->nz = nz;
+      bx = (nx + 3) / 4;
+      by = (ny + 3) / 4;
+      bz = (nz + 3) / 4;
+    }
+    if (clear)
+      set(0);
+  }
+
+  // compress all blocks of array stored at p (or zeros if p is null) in one pass
+  void set(const Scalar* p)
+  {
+    free();
+    size_t n = blocks();
+    if (!n)
+      return;
+    // start with a guess of compressed size and grow as needed
+    size_t words = n + staging_words();
+    bytes = words * word_bytes();
+    zfp::reallocate_aligned(data, bytes, ZFP_MEMORY_ALIGNMENT, memory);
+    Codec codec(data, bytes);
+    configure(&codec);
+    codec.set_padding(false);
+    std::vector<size_t> size(n);
+    const Scalar zero[block_size] = {};
+    const ptrdiff_t sx = 1;
+    const ptrdiff_t sy = static_cast<ptrdiff_t>(nx);
+    const ptrdiff_t sz = static_cast<ptrdiff_t>(nx * ny);
+    size_t offset = 0;
+    size_t block_index = 0;
+    for (size_t k = 0; k < bz; k++)
+      for (size_t j = 0; j < by; j++)
+        for (size_t i = 0; i < bx; i++, block_index++) {
+          if (offset / word_bits() + staging_words() > words) {
+            words = std::max(2 * words, offset / word_bits() + staging_words());
+            resize_buffer(words * word_bytes(), offset);
+            codec.open(data, bytes);
+          }
+          uint shape = this->shape(block_index);
+          size[block_index] = p ? codec.encode_block_strided(offset, shape, p + 4 * (i + nx * (j + ny * k)), sx, sy, sz)
+                                : codec.encode_block(offset, shape, zero);
+          offset += size[block_index];
+        }
+    // trim storage to compressed size
+    bits = offset;
+    resize_buffer((offset + word_bits() - 1) / word_bits() * word_bytes(), offset);
+    delta_index.build(&size[0], n);
+  }
+
+  // load fixed-rate blocks of maxbits bits each stored in raster order at
+  // bit offset of buffer, e.g., by zfp_compress(), borrowing the buffer if
+  // requested and its blocks are word aligned
+  void load(const void* buffer, size_t offset, uint maxbits, bool borrow)
+  {
+    free();
+    size_t n = blocks();
+    bytes = n * bits_per_block / word_bits() * word_bytes();
+    zfp::reallocate_aligned(data, bytes, ZFP_MEMORY_ALIGNMENT, memory);
+    BlockStore3<Scalar, Codec>::load(buffer, offset, maxbits, n, borrow);
+    bits = n * bits_per_block;
+    std::vector<size_t> size(n, bits_per_block);
+    delta_index.build(&size[0], n);
+  }
+
+  // codec of calling thread, configured for this store's packed blocks
+  Codec* codec() const { return this->codecs.get(*this); }
+
+  // decode contiguous block with given index
+  size_t decode(Codec* codec, size_t block_index, Scalar* block) const
+  {
+    return codec->decode_block(delta_index.offset(block_index), this->shape(block_index), block);
+  }
+
+  // decode block with given index to strided array
+  size_t decode(Codec* codec, size_t block_index, Scalar* p, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz) const
+  {
+    return codec->decode_block_strided(delta_index.offset(block_index), this->shape(block_index), p, sx, sy, sz);
+  }
+
+  using BlockStore3<Scalar, Codec>::blocks;
+
+protected:
+  // reallocate compressed storage to given byte size, preserving first bits
+  void resize_buffer(size_t size, size_t bits)
+  {
+    void* buffer = memory->allocate(size, ZFP_MEMORY_ALIGNMENT);
+    std::memcpy(buffer, data, (bits + word_bits() - 1) / word_bits() * word_bytes());
+    zfp::deallocate_aligned(data, memory);
+    data = buffer;
+    bytes = size;
+  }
+
+  // free block store and index
+  void free()
+  {
+    BlockStore3<Scalar, Codec>::free();
+    delta_index.free();
+    bits = 0;
+  }
+
+  using BlockStore3<Scalar, Codec>::staging_words;
+  using BlockStore3<Scalar, Codec>::word_bits;
+  using BlockStore3<Scalar, Codec>::word_bytes;
+  using BlockStore3<Scalar, Codec>::block_size;
+  using BlockStore3<Scalar, Codec>::bits_per_block;
+  using BlockStore3<Scalar, Codec>::data;
+  using BlockStore3<Scalar, Codec>::memory;
+  using BlockStore3<Scalar, Codec>::bytes;
+  using BlockStore3<Scalar, Codec>::compression_mode;
+  using BlockStore3<Scalar, Codec>::precision;
+  using BlockStore3<Scalar, Codec>::tolerance;
+  using BlockStore3<Scalar, Codec>::nx;
+  using BlockStore3<Scalar, Codec>::ny;
+  using BlockStore3<Scalar, Codec>::nz;
+  using BlockStore3<Scalar, Codec>::bx;
+  using BlockStore3<Scalar, Codec>::by;
+  using BlockStore3<Scalar, Codec>::bz;
+
+  DeltaBlockIndex delta_index; // delta-coded bit offsets of blocks
+  size_t bits;                 // number of bits of compressed blocks
+};
+
+}
+
+#endif
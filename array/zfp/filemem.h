@@ -0,0 +1,193 @@
+#ifndef ZFP_FILEMEM_H
+#define ZFP_FILEMEM_H
+
+#include <algorithm>
+#include <map>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+#include "zfp/exception.h"
+#include "zfp/memory.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+  #define ZFP_FILE_ALLOCATOR 1
+#endif
+
+namespace zfp {
+
+// allocator that places buffers in a memory-mapped file, e.g., on NVMe, so
+// that compressed storage of arrays larger than memory is paged to and from
+// the file on demand; only recently touched pages remain resident, and
+// advise() lets views read blocks ahead of use or write them back and drop
+// them from memory once done; on platforms without mmap(), buffers come
+// from the heap; this allocator is not thread-safe
+class file_allocator : public allocator {
+public:
+  // allocator backed by file at path, which is created or truncated; unless
+  // kept, the file is unlinked at once and vanishes with the allocator
+  explicit file_allocator(const std::string& path, bool keep = false) :
+    fd(-1),
+    end(0)
+  {
+#ifdef ZFP_FILE_ALLOCATOR
+    fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+    if (fd < 0)
+      throw zfp::exception("zfp cannot create file " + path);
+    if (!keep)
+      unlink(path.c_str());
+#else
+    unused_(path);
+    unused_(keep);
+#endif
+  }
+
+  // unmap any remaining buffers and close file
+  ~file_allocator()
+  {
+    while (!mapped.empty())
+      deallocate(mapped.begin()->first);
+#ifdef ZFP_FILE_ALLOCATOR
+    close(fd);
+#endif
+  }
+
+  // map size bytes, rounded up to whole pages, at the end of the file
+  void* allocate(size_t size, size_t alignment)
+  {
+    const size_t page = page_size();
+    size = std::max((size + page - 1) / page, size_t(1)) * page;
+#ifdef ZFP_FILE_ALLOCATOR
+    // mappings are page aligned
+    if (alignment > page || ftruncate(fd, off_t(end + size)))
+      throw std::bad_alloc();
+    void* ptr = mmap(0, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, off_t(end));
+    if (ptr == MAP_FAILED)
+      throw std::bad_alloc();
+#else
+    void* ptr = zfp::allocate_aligned(size, alignment);
+#endif
+    mapped[ptr] = region(end, size);
+    end += size;
+    return ptr;
+  }
+
+  // unmap buffer and release its file space
+  void deallocate(void* ptr)
+  {
+    std::map<void*, region>::iterator it = mapped.find(ptr);
+    if (it == mapped.end())
+      return;
+    const region r = it->second;
+    mapped.erase(it);
+#ifdef ZFP_FILE_ALLOCATOR
+    munmap(ptr, r.second);
+    if (r.first + r.second == end) {
+      // shrink file past last buffer still in use
+      end = 0;
+      for (it = mapped.begin(); it != mapped.end(); ++it)
+        end = std::max(end, it->second.first + it->second.second);
+      // failure to shrink merely leaves the file larger than needed
+      if (ftruncate(fd, off_t(end))) {}
+    }
+  #ifdef FALLOC_FL_PUNCH_HOLE
+    else
+      fallocate(fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE, off_t(r.first), off_t(r.second));
+  #endif
+#else
+    zfp::deallocate_aligned(ptr);
+#endif
+  }
+
+  // read pages spanned by range ahead of use, or write them back to the
+  // file and drop them from memory
+  void advise(const void* ptr, size_t size, bool needed)
+  {
+#ifdef ZFP_FILE_ALLOCATOR
+    std::map<void*, region>::const_iterator it = mapped.upper_bound(const_cast<void*>(ptr));
+    if (!size || it == mapped.begin())
+      return;
+    --it;
+    // clip range to enclosing pages of buffer
+    const size_t page = page_size();
+    uchar* base = static_cast<uchar*>(it->first);
+    size_t begin = size_t(static_cast<const uchar*>(ptr) - base);
+    size_t stop = std::min(begin + size, it->second.second);
+    begin = begin / page * page;
+    stop = (stop + page - 1) / page * page;
+    if (begin >= stop)
+      return;
+    if (needed)
+      madvise(base + begin, stop - begin, MADV_WILLNEED);
+    else {
+      msync(base + begin, stop - begin, MS_SYNC);
+      madvise(base + begin, stop - begin, MADV_DONTNEED);
+  #ifdef POSIX_FADV_DONTNEED
+      posix_fadvise(fd, off_t(it->second.first + begin), off_t(stop - begin), POSIX_FADV_DONTNEED);
+  #endif
+    }
+#else
+    unused_(ptr);
+    unused_(size);
+    unused_(needed);
+#endif
+  }
+
+  // total number of bytes currently allocated
+  size_t size() const
+  {
+    size_t bytes = 0;
+    for (std::map<void*, region>::const_iterator it = mapped.begin(); it != mapped.end(); ++it)
+      bytes += it->second.second;
+    return bytes;
+  }
+
+  // number of allocated bytes currently resident in memory
+  size_t resident() const
+  {
+#ifdef ZFP_FILE_ALLOCATOR
+    const size_t page = page_size();
+    size_t bytes = 0;
+    for (std::map<void*, region>::const_iterator it = mapped.begin(); it != mapped.end(); ++it) {
+      size_t pages = it->second.second / page;
+  #ifdef __APPLE__
+      std::vector<char> status(pages);
+  #else
+      std::vector<unsigned char> status(pages);
+  #endif
+      if (!mincore(it->first, it->second.second, &status[0]))
+        for (size_t i = 0; i < pages; i++)
+          if (status[i] & 1)
+            bytes += page;
+    }
+    return bytes;
+#else
+    return size();
+#endif
+  }
+
+protected:
+  typedef std::pair<size_t, size_t> region; // file offset and byte size
+
+  // granularity of mappings
+  static size_t page_size()
+  {
+#ifdef ZFP_FILE_ALLOCATOR
+    return size_t(sysconf(_SC_PAGESIZE));
+#else
+    return ZFP_MEMORY_ALIGNMENT;
+#endif
+  }
+
+  int fd;                         // file descriptor of backing file
+  size_t end;                     // file size in bytes
+  std::map<void*, region> mapped; // file region of each allocated buffer
+};
+
+}
+
+#endif
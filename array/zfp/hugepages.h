@@ -0,0 +1,94 @@
+#ifndef ZFP_HUGEPAGES_H
+#define ZFP_HUGEPAGES_H
+
+#include <map>
+#include <new>
+#include "zfp/memory.h"
+
+#ifdef __linux__
+  #include <sys/mman.h>
+#endif
+
+namespace zfp {
+
+// allocator that backs buffers with 2 MB huge pages on Linux; explicit
+// pages come from the hugetlbfs pool reserved by the administrator (see
+// /proc/sys/vm/nr_hugepages), while transparent pages are requested via
+// madvise(); if explicit pages are not available, regular pages are used;
+// on other platforms, memory is merely aligned on 2 MB boundaries when
+// ZFP_WITH_ALIGNED_ALLOC is defined; this allocator is not thread-safe
+class huge_page_allocator : public allocator {
+public:
+  static const size_t page_size = 0x200000u;
+
+  // allocator using explicit (hugetlbfs) or transparent huge pages
+  explicit huge_page_allocator(bool explicit_pages = false) : explicit_pages(explicit_pages) {}
+
+  // deallocate any remaining buffers
+  ~huge_page_allocator()
+  {
+    while (!mapped.empty())
+      deallocate(mapped.begin()->first);
+  }
+
+  // allocate size bytes rounded up to a whole number of huge pages
+  void* allocate(size_t size, size_t alignment)
+  {
+    size = std::max((size + page_size - 1) / page_size, size_t(1)) * page_size;
+    void* ptr = 0;
+#ifdef __linux__
+    if (explicit_pages) {
+      ptr = mmap(0, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+      if (ptr == MAP_FAILED)
+        ptr = mmap(0, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (ptr == MAP_FAILED)
+        throw std::bad_alloc();
+    }
+    else {
+      if (posix_memalign(&ptr, std::max(alignment, size_t(page_size)), size))
+        throw std::bad_alloc();
+  #ifdef MADV_HUGEPAGE
+      madvise(ptr, size, MADV_HUGEPAGE);
+  #endif
+    }
+#else
+    ptr = zfp::allocate_aligned(size, std::max(alignment, size_t(page_size)));
+#endif
+    mapped[ptr] = size;
+    return ptr;
+  }
+
+  // deallocate memory obtained from allocate()
+  void deallocate(void* ptr)
+  {
+    std::map<void*, size_t>::iterator it = mapped.find(ptr);
+    if (it == mapped.end())
+      return;
+#ifdef __linux__
+    if (explicit_pages)
+      munmap(ptr, it->second);
+    else
+      std::free(ptr);
+#else
+    zfp::deallocate_aligned(ptr);
+#endif
+    mapped.erase(it);
+  }
+
+  // total number of bytes currently allocated
+  size_t size() const
+  {
+    size_t bytes = 0;
+    for (std::map<void*, size_t>::const_iterator it = mapped.begin(); it != mapped.end(); ++it)
+      bytes += it->second;
+    return bytes;
+  }
+
+protected:
+  bool explicit_pages;            // use hugetlbfs rather than transparent pages
+  std::map<void*, size_t> mapped; // size of each allocated buffer
+};
+
+}
+
+#endif
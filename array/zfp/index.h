@@ -0,0 +1,219 @@
+#ifndef ZFP_INDEX_H
+#define ZFP_INDEX_H
+
+#include <algorithm>
+#include <climits>
+#include "zfp/memory.h"
+
+namespace zfp {
+
+// compact index of variable-length blocks stored in units of stream words
+class BlockIndex {
+public:
+  // default constructor
+  BlockIndex() :
+    blocks(0),
+    pos(0),
+    len(0)
+  {}
+
+  // destructor
+  ~BlockIndex() { free(); }
+
+  // perform a deep copy
+  void deep_copy(const BlockIndex& index)
+  {
+    blocks = index.blocks;
+    zfp::clone(pos, index.pos, blocks);
+    zfp::clone(len, index.len, blocks);
+  }
+
+  // exchange contents with another index
+  void swap(BlockIndex& index)
+  {
+    std::swap(blocks, index.blocks);
+    std::swap(pos, index.pos);
+    std::swap(len, index.len);
+  }
+
+  // allocate index for given number of blocks of unit length stored in order
+  void resize(size_t blocks)
+  {
+    free();
+    if (blocks) {
+      this->blocks = blocks;
+      zfp::reallocate(pos, blocks * sizeof(uint64));
+      zfp::reallocate(len, blocks * sizeof(uint16));
+      for (size_t i = 0; i < blocks; i++)
+        set(i, i, 1);
+    }
+  }
+
+  // free index
+  void free()
+  {
+    zfp::deallocate(pos);
+    zfp::deallocate(len);
+    pos = 0;
+    len = 0;
+    blocks = 0;
+  }
+
+  // number of blocks indexed
+  size_t size() const { return blocks; }
+
+  // word offset of block
+  size_t offset(size_t block_index) const { return static_cast<size_t>(pos[block_index]); }
+
+  // length of block in number of words
+  size_t length(size_t block_index) const { return len[block_index]; }
+
+  // set word offset and length of block
+  void set(size_t block_index, size_t offset, size_t length)
+  {
+    pos[block_index] = offset;
+    len[block_index] = static_cast<uint16>(length);
+  }
+
+protected:
+  // copying is supported only via deep_copy
+  BlockIndex(const BlockIndex&);
+  BlockIndex& operator=(const BlockIndex&);
+
+  size_t blocks; // number of blocks indexed
+  uint64* pos;   // word offset of each block
+  uint16* len;   // word length of each block (at most ZFP_MAX_BITS bits)
+};
+
+// read-only index of back-to-back blocks whose offsets are delta coded;
+// one absolute bit offset is stored per chunk of blocks, and block sizes
+// are stored relative to the smallest block using a fixed number of bits
+class DeltaBlockIndex {
+public:
+  // default constructor
+  DeltaBlockIndex() :
+    blocks(0),
+    base(0),
+    delta(0),
+    min_size(0),
+    width(0)
+  {}
+
+  // destructor
+  ~DeltaBlockIndex() { free(); }
+
+  // perform a deep copy
+  void deep_copy(const DeltaBlockIndex& index)
+  {
+    blocks = index.blocks;
+    min_size = index.min_size;
+    width = index.width;
+    zfp::clone(base, index.base, chunks());
+    zfp::clone(delta, index.delta, words());
+  }
+
+  // build index from sizes in bits of consecutively stored blocks
+  void build(const size_t* size, size_t blocks)
+  {
+    free();
+    if (!blocks)
+      return;
+    this->blocks = blocks;
+    // determine number of bits needed to code block sizes
+    size_t min = *std::min_element(size, size + blocks);
+    size_t max = *std::max_element(size, size + blocks);
+    min_size = min;
+    for (width = 0; (max - min) >> width; width++);
+    // store chunk offsets and block size deltas
+    zfp::reallocate(base, chunks() * sizeof(uint64));
+    zfp::reallocate(delta, words() * sizeof(uint64));
+    std::fill(delta, delta + words(), uint64(0));
+    uint64 offset = 0;
+    for (size_t i = 0; i < blocks; i++) {
+      if (!(i % chunk_size))
+        base[i / chunk_size] = offset;
+      put(i, size[i] - min);
+      offset += size[i];
+    }
+  }
+
+  // free index
+  void free()
+  {
+    zfp::deallocate(base);
+    zfp::deallocate(delta);
+    base = 0;
+    delta = 0;
+    blocks = 0;
+    min_size = 0;
+    width = 0;
+  }
+
+  // number of blocks indexed
+  size_t size() const { return blocks; }
+
+  // storage required by index in bits
+  size_t size_bits() const { return CHAR_BIT * sizeof(uint64) * (chunks() + words()); }
+
+  // bit offset of block
+  size_t offset(size_t block_index) const
+  {
+    size_t first = block_index - block_index % chunk_size;
+    size_t offset = static_cast<size_t>(base[first / chunk_size]) + (block_index - first) * min_size;
+    for (size_t i = first; i < block_index; i++)
+      offset += get(i);
+    return offset;
+  }
+
+  // size of block in bits
+  size_t block_size(size_t block_index) const { return min_size + get(block_index); }
+
+protected:
+  // copying is supported only via deep_copy
+  DeltaBlockIndex(const DeltaBlockIndex&);
+  DeltaBlockIndex& operator=(const DeltaBlockIndex&);
+
+  static const size_t chunk_size = 32; // number of blocks per absolute offset
+  static const size_t word_bits = CHAR_BIT * sizeof(uint64);
+
+  // number of chunks and number of words of block size deltas
+  size_t chunks() const { return (blocks + chunk_size - 1) / chunk_size; }
+  size_t words() const { return (blocks * width + word_bits - 1) / word_bits; }
+
+  // store width-bit delta for block i
+  void put(size_t i, size_t value)
+  {
+    if (!width)
+      return;
+    size_t pos = i * width;
+    size_t w = pos / word_bits;
+    uint s = static_cast<uint>(pos % word_bits);
+    delta[w] |= uint64(value) << s;
+    if (s + width > word_bits)
+      delta[w + 1] |= uint64(value) >> (word_bits - s);
+  }
+
+  // fetch width-bit delta for block i
+  size_t get(size_t i) const
+  {
+    if (!width)
+      return 0;
+    size_t pos = i * width;
+    size_t w = pos / word_bits;
+    uint s = static_cast<uint>(pos % word_bits);
+    uint64 value = delta[w] >> s;
+    if (s + width > word_bits)
+      value |= delta[w + 1] << (word_bits - s);
+    return static_cast<size_t>(value & ((uint64(1) << width) - 1));
+  }
+
+  size_t blocks;   // number of blocks indexed
+  uint64* base;    // bit offset of first block in each chunk
+  uint64* delta;   // packed differences between block sizes and min_size
+  size_t min_size; // size of smallest block in bits
+  uint width;      // number of bits per block size delta
+};
+
+}
+
+#endif
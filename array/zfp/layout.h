@@ -0,0 +1,82 @@
+#ifndef ZFP_LAYOUT_H
+#define ZFP_LAYOUT_H
+
+#include <algorithm>
+#include <cstddef>
+#include "zfp/types.h"
+
+namespace zfp {
+
+// order in which fixed-rate blocks are laid out in memory
+enum block_order {
+  block_order_raster = 0, // x varies fastest, then y, then z (zfp stream order)
+  block_order_morton = 1  // Z-order curve over bx * by * bz blocks
+};
+
+// mapping from raster-order block index to position of block in memory
+class BlockLayout {
+public:
+  // default constructor
+  BlockLayout() :
+    mode(block_order_raster),
+    bx(0), by(0), bz(0)
+  {}
+
+  // order of blocks in memory
+  block_order order() const { return mode; }
+
+  // set order of blocks in memory
+  void set_order(block_order order) { mode = order; }
+
+  // set number of blocks along each dimension
+  void resize(size_t bx, size_t by, size_t bz)
+  {
+    this->bx = bx;
+    this->by = by;
+    this->bz = bz;
+  }
+
+  // position in memory of block with given raster-order index
+  size_t position(size_t block_index) const
+  {
+    if (mode == block_order_raster)
+      return block_index;
+    size_t i = block_index % bx; block_index /= bx;
+    size_t j = block_index % by; block_index /= by;
+    size_t k = block_index;
+    return rank(i, j, k);
+  }
+
+protected:
+  // number of blocks with smaller Morton code than block (i, j, k); blocks
+  // outside the bx * by * bz domain are skipped so that no storage is wasted
+  size_t rank(size_t i, size_t j, size_t k) const
+  {
+    size_t s = 1;
+    while (s < bx || s < by || s < bz)
+      s *= 2;
+    size_t r = 0;
+    size_t x = 0, y = 0, z = 0;
+    for (s /= 2; s; s /= 2) {
+      // octant of (i, j, k) in cube of side 2s with origin (x, y, z)
+      uint o = uint(i >= x + s) + 2 * uint(j >= y + s) + 4 * uint(k >= z + s);
+      // count blocks in preceding octants
+      for (uint p = 0; p < o; p++)
+        r += extent(bx, x + s * (p & 1u), s) * extent(by, y + s * ((p >> 1) & 1u), s) * extent(bz, z + s * (p >> 2), s);
+      x += s * (o & 1u);
+      y += s * ((o >> 1) & 1u);
+      z += s * (o >> 2);
+    }
+    return r;
+  }
+
+  // number of blocks in [x, x + s) within [0, n)
+  static size_t extent(size_t n, size_t x, size_t s) { return x < n ? std::min(n - x, s) : 0; }
+
+  block_order mode; // order of blocks in memory
+  size_t bx, by, bz; // number of blocks per dimension
+};
+
+}
+
+#endif
@@ -0,0 +1,156 @@
+#ifndef ZFP_LINEAR3_H
+#define ZFP_LINEAR3_H
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <limits>
+#include "zfp/exception.h"
+
+// linear operations on 3D arrays performed on transform coefficients
+
+namespace zfp {
+
+template <typename Scalar, class Codec>
+class array3;
+
+namespace internal {
+namespace dim3 {
+
+// BLAS-1 operations that combine the decoded integer coefficients of
+// fixed-rate blocks without the inverse and forward block-floating-point
+// and decorrelating transforms, which are linear up to rounding
+template <class Array>
+class coefficient_ops {
+public:
+  typedef typename Array::value_type value_type;
+  typedef typename Array::codec_type codec_type;
+  typedef typename codec_type::int_type int_type;
+
+  // y = alpha * x + y
+  static void axpy(double alpha, const Array& x, Array& y)
+  {
+    if (x.size_x() != y.size_x() || x.size_y() != y.size_y() || x.size_z() != y.size_z())
+      throw zfp::exception("zfp::axpy requires arrays of equal size");
+    apply(alpha, &x, y);
+  }
+
+  // x = alpha * x
+  static void scale(double alpha, Array& x)
+  {
+    apply(alpha, 0, x);
+  }
+
+protected:
+  // y = alpha * x + y if x is nonnull, else y = alpha * y
+  static void apply(double alpha, const Array* x, Array& y)
+  {
+    if ((x && x->mode() != zfp_mode_fixed_rate) || y.mode() != zfp_mode_fixed_rate)
+      throw zfp::exception("zfp coefficient-domain operations require fixed-rate arrays");
+    if (zfp::trait<value_type>::type == zfp_type_int32 || zfp::trait<value_type>::type == zfp_type_int64)
+      throw zfp::exception("zfp coefficient-domain operations require floating-point arrays");
+    if (x)
+      x->flush_cache();
+    y.flush_cache();
+    // copy any borrowed compressed data before threads modify it
+    y.own();
+    const long blocks = static_cast<long>(y.store.blocks());
+#ifdef _OPENMP
+    #pragma omp parallel
+#endif
+    {
+      // fixed-rate blocks occupy whole words and may be updated concurrently
+      // through each thread's codecs
+      codec_type* xcodec = x ? x->store.codec() : 0;
+      codec_type* ycodec = y.store.codec();
+#ifdef _OPENMP
+      #pragma omp for
+#endif
+      for (long b = 0; b < blocks; b++)
+        apply_block(alpha, x ? &x->store : 0, xcodec, y.store, ycodec, size_t(b));
+    }
+    // discard cached blocks superseded by the updated coefficients
+    y.clear_cache();
+  }
+
+  // update block b of y in coefficient space
+  template <class Store>
+  static void apply_block(double alpha, const Store* xs, codec_type* xcodec, const Store& ys, codec_type* ycodec, size_t b)
+  {
+    // coefficients are integers relative to 2^(emax - q); long double holds
+    // 64-bit coefficients exactly where supported
+    const int q = int(CHAR_BIT * sizeof(value_type)) - 2;
+    const uint n = 64;
+    int_type xc[n], yc[n];
+    long double z[n];
+    int ex = 0, ey = 0;
+    bool xnonzero = false;
+    bool ynonzero = false;
+    long double xscale = 0, yscale = alpha;
+    if (xs) {
+      xs->decode_coefficients(xcodec, b, xc, ex);
+      xscale = alpha;
+      yscale = 1;
+    }
+    ys.decode_coefficients(ycodec, b, yc, ey);
+    // combine coefficients and find their maximum magnitude
+    long double cmax = 0;
+    for (uint i = 0; i < n; i++) {
+      xnonzero |= xs && xc[i];
+      ynonzero |= yc[i] != 0;
+      z[i] = (xs ? std::ldexp(xscale * static_cast<long double>(xc[i]), ex - q) : 0.0L) + std::ldexp(yscale * static_cast<long double>(yc[i]), ey - q);
+      cmax = std::max(cmax, std::fabs(z[i]));
+    }
+    int emax = std::numeric_limits<value_type>::min_exponent - 1;
+    if (cmax > 0) {
+      // bound values via the exponents of the terms: |a x + y| < 2^(max(ea, ey) + 1)
+      // where |alpha| <= 2^a and |a x| < 2^ea = 2^(ex + a)
+      int a, e = INT_MIN;
+      if (std::fabs(std::frexp(alpha, &a)) == 0.5)
+        a--;
+      if (xnonzero && alpha != 0)
+        e = ex + a;
+      if (ynonzero) {
+        int s = ey;
+        if (!xs)
+          s += a;
+        e = e == INT_MIN ? s : std::max(e, s) + 1;
+      }
+      // the inverse transform amplifies coefficients by less than 3.75 per
+      // dimension, so values are also bounded by 2^(c + 6) for |z| < 2^c
+      int c;
+      std::frexp(cmax, &c);
+      if (e == INT_MIN || c + 6 < e)
+        e = c + 6;
+      emax = std::max(emax, std::min(e, std::numeric_limits<value_type>::max_exponent));
+      // quantize combined coefficients relative to the new common exponent
+      for (uint i = 0; i < n; i++)
+        yc[i] = static_cast<int_type>(std::ldexp(z[i], q - emax));
+    }
+    else
+      std::fill(yc, yc + n, int_type(0));
+    ys.encode_coefficients(ycodec, b, yc, emax);
+  }
+};
+
+} // dim3
+} // internal
+
+// y = alpha * x + y for fixed-rate arrays x and y of equal size, computed
+// block by block and in parallel on the decoded transform coefficients
+template <typename Scalar, class Codec>
+void axpy(double alpha, const array3<Scalar, Codec>& x, array3<Scalar, Codec>& y)
+{
+  zfp::internal::dim3::coefficient_ops< array3<Scalar, Codec> >::axpy(alpha, x, y);
+}
+
+// x = alpha * x for fixed-rate array x, computed on transform coefficients
+template <typename Scalar, class Codec>
+void scale(double alpha, array3<Scalar, Codec>& x)
+{
+  zfp::internal::dim3::coefficient_ops< array3<Scalar, Codec> >::scale(alpha, x);
+}
+
+} // zfp
+
+#endif
@@ -99,6 +99,52 @@ deallocate_aligned(T* ptr)
 #endif
 }
 
+// interface for allocators of large aligned buffers that hold compressed
+// blocks and cache lines, e.g., in huge pages or host-pinned memory
+class allocator {
+public:
+  virtual ~allocator() {}
+
+  // allocate size bytes with alignment; throws std::bad_alloc on failure
+  virtual void* allocate(size_t size, size_t alignment) = 0;
+
+  // deallocate non-null memory obtained from allocate()
+  virtual void deallocate(void* ptr) = 0;
+
+  // hint that size bytes at ptr, within memory obtained from allocate(),
+  // will (needed) or will not be accessed soon; ignored by default
+  virtual void advise(const void* ptr, size_t size, bool needed)
+  {
+    unused_(ptr);
+    unused_(size);
+    unused_(needed);
+  }
+};
+
+// allocator based on allocate_aligned() and deallocate_aligned()
+class aligned_allocator : public allocator {
+public:
+  void* allocate(size_t size, size_t alignment) { return zfp::allocate_aligned(size, alignment); }
+  void deallocate(void* ptr) { zfp::deallocate_aligned(ptr); }
+};
+
+// allocator used by arrays unless another one is specified
+inline allocator*
+default_allocator()
+{
+  static aligned_allocator memory;
+  return &memory;
+}
+
+// deallocate memory pointed to by ptr using given allocator
+template <typename T>
+inline void
+deallocate_aligned(T* ptr, allocator* memory)
+{
+  if (ptr)
+    memory->deallocate(ptr);
+}
+
 // reallocate size bytes
 template <typename T>
 inline void
@@ -116,6 +162,15 @@ reallocate_aligned(T*& ptr, size_t size, size_t alignment)
   ptr = static_cast<T*>(zfp::allocate_aligned(size, alignment));
 }
 
+template <typename T>
+inline void
+reallocate_aligned(T*& ptr, size_t size, size_t alignment, allocator* memory)
+{
+  zfp::deallocate_aligned(ptr, memory);
+  ptr = 0;
+  ptr = static_cast<T*>(memory->allocate(size, alignment));
+}
+
 // clone array 'T src[count]'
 template <typename T>
 inline void
@@ -156,6 +211,31 @@ clone_aligned(void*& dst, const void* src, size_t bytes, size_t alignment)
     dst = 0;
 }
 
+// clone array 'T src[count]' into memory obtained from given allocator
+template <typename T>
+inline void
+clone_aligned(T*& dst, const T* src, size_t count, size_t alignment, allocator* memory)
+{
+  zfp::deallocate_aligned(dst, memory);
+  dst = 0;
+  if (src) {
+    dst = static_cast<T*>(memory->allocate(count * sizeof(T), alignment));
+    std::copy(src, src + count, dst);
+  }
+}
+
+template <>
+inline void
+clone_aligned(void*& dst, const void* src, size_t bytes, size_t alignment, allocator* memory)
+{
+  zfp::deallocate_aligned(dst, memory);
+  dst = 0;
+  if (src) {
+    dst = memory->allocate(bytes, alignment);
+    std::memcpy(dst, src, bytes);
+  }
+}
+
 }
 
 #undef unused_
@@ -0,0 +1,49 @@
+#ifndef ZFP_PARALLEL3_H
+#define ZFP_PARALLEL3_H
+
+#ifdef _OPENMP
+  #include <omp.h>
+#endif
+
+// parallel algorithms over 3D arrays
+
+namespace zfp {
+namespace internal {
+namespace dim3 {
+
+// apply f to the index-th of count block-aligned partitions of array a
+template <class Array, class Function>
+void for_each_partition(Array& a, Function f, size_t index, size_t count)
+{
+  typename Array::private_view view(&a);
+  view.partition(index, count);
+  view.for_each_block(element_visitor<typename Array::value_type, Function>(f, view.global_x(0), view.global_y(0), view.global_z(0)));
+  view.flush_cache();
+}
+
+} // dim3
+} // internal
+
+// apply f(i, j, k, v) to each element v of 3D array a, allowing f to modify
+// v; each thread updates a block-aligned partition of a through a private
+// cache and applies its own copy of f
+template < typename Scalar, class Codec, class Function >
+void parallel_for(array3<Scalar, Codec>& a, Function f)
+{
+  a.flush_cache();
+  // copy any borrowed compressed data before threads modify it
+  a.own();
+#ifdef _OPENMP
+  // variable-length blocks share one buffer and must be compressed serially
+  #pragma omp parallel if (a.mode() == zfp_mode_fixed_rate)
+  zfp::internal::dim3::for_each_partition(a, f, size_t(omp_get_thread_num()), size_t(omp_get_num_threads()));
+#else
+  zfp::internal::dim3::for_each_partition(a, f, 0, 1);
+#endif
+  // discard cached blocks superseded by the private caches
+  a.clear_cache();
+}
+
+} // zfp
+
+#endif
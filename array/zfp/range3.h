@@ -0,0 +1,147 @@
+#ifndef ZFP_RANGE3_H
+#define ZFP_RANGE3_H
+
+#include <algorithm>
+#include <vector>
+
+// splittable block-aligned ranges of 3D arrays
+
+namespace zfp {
+namespace internal {
+namespace dim3 {
+
+// block visitor that applies f(x, y, z, value) to each element in a block
+template <typename Scalar, class Function>
+class element_visitor {
+public:
+  element_visitor(Function& f, size_t x, size_t y, size_t z) : f(f), x(x), y(y), z(z) {}
+
+  void operator()(Scalar* p, size_t i, size_t j, size_t k, size_t mx, size_t my, size_t mz)
+  {
+    for (size_t kk = 0; kk < mz; kk++, p += 16 - 4 * my)
+      for (size_t jj = 0; jj < my; jj++, p += 4 - mx)
+        for (size_t ii = 0; ii < mx; ii++, p++)
+          f(x + i + ii, y + j + jj, z + k + kk, *p);
+  }
+
+protected:
+  Function& f;   // function applied to each element
+  size_t x, y, z; // global index of view origin
+};
+
+// box of whole blocks of a 3D array whose elements are accessed through a
+// private cache; ranges satisfy the TBB Range concept and may be split in
+// two, e.g., by tbb::parallel_for, while disjoint ranges obtained from
+// array3::block_ranges() suit C++17 parallel algorithms
+template <class Container>
+class block_range {
+public:
+  typedef Container container_type;
+  typedef typename container_type::value_type value_type;
+  typedef typename container_type::private_view private_view;
+  typedef typename container_type::private_const_view private_const_view;
+
+  // range of all blocks of array, divisible down to grain blocks
+  explicit block_range(container_type* array, size_t grain = 1) :
+    array(array),
+    grain(std::max(grain, size_t(1)))
+  {
+    b[0] = 0; e[0] = (array->size_x() + 3) / 4;
+    b[1] = 0; e[1] = (array->size_y() + 3) / 4;
+    b[2] = 0; e[2] = (array->size_z() + 3) / 4;
+  }
+
+  // splitting constructor: take upper half of r along its longest dimension
+  // and leave lower half in r (Split is tbb::split or tbb::proportional_split)
+  template <class Split>
+  block_range(block_range& r, Split) :
+    array(r.array),
+    grain(r.grain)
+  {
+    std::copy(r.b, r.b + 3, b);
+    std::copy(r.e, r.e + 3, e);
+    uint d = r.longest();
+    b[d] = r.e[d] = r.b[d] + (r.e[d] - r.b[d]) / 2;
+  }
+
+  // TBB Range concept
+  bool empty() const { return !blocks(); }
+  bool is_divisible() const { return blocks() > grain && e[longest()] - b[longest()] > 1; }
+
+  // number of blocks in range
+  size_t blocks() const { return (e[0] - b[0]) * (e[1] - b[1]) * (e[2] - b[2]); }
+
+  // global index of first element in range
+  size_t global_x(size_t i) const { return 4 * b[0] + i; }
+  size_t global_y(size_t j) const { return 4 * b[1] + j; }
+  size_t global_z(size_t k) const { return 4 * b[2] + k; }
+
+  // dimensions of range in number of elements
+  size_t size_x() const { return std::min(4 * e[0], array->size_x()) - 4 * b[0]; }
+  size_t size_y() const { return std::min(4 * e[1], array->size_y()) - 4 * b[1]; }
+  size_t size_z() const { return std::min(4 * e[2], array->size_z()) - 4 * b[2]; }
+
+  // apply f(i, j, k, v) to each element v in range, allowing f to modify v;
+  // modified blocks are compressed from the private cache before returning
+  template <class Function>
+  Function for_each(Function f) const
+  {
+    if (!empty()) {
+      private_view view(array, global_x(0), global_y(0), global_z(0), size_x(), size_y(), size_z());
+      view.for_each_block(element_visitor<value_type, Function>(f, global_x(0), global_y(0), global_z(0)));
+      view.flush_cache();
+    }
+    return f;
+  }
+
+  // apply f(i, j, k, v) to each element v in range without modifying it
+  template <class Function>
+  Function for_each_const(Function f) const
+  {
+    if (!empty()) {
+      private_const_view view(array, global_x(0), global_y(0), global_z(0), size_x(), size_y(), size_z());
+      view.for_each_block(element_visitor<const value_type, Function>(f, global_x(0), global_y(0), global_z(0)));
+    }
+    return f;
+  }
+
+  // partition array into at most count nonempty block-aligned slabs
+  static std::vector<block_range> partition(container_type* array, size_t count)
+  {
+    std::vector<block_range> ranges;
+    block_range r(array);
+    count = std::max(count, size_t(1));
+    uint d = r.longest();
+    size_t bmin = r.b[d];
+    size_t bmax = r.e[d];
+    for (size_t i = 0; i < count; i++) {
+      r.b[d] = bmin + (bmax - bmin) * (i + 0) / count;
+      r.e[d] = bmin + (bmax - bmin) * (i + 1) / count;
+      if (!r.empty())
+        ranges.push_back(r);
+    }
+    return ranges;
+  }
+
+protected:
+  // dimension with the most blocks
+  uint longest() const
+  {
+    uint d = 0;
+    for (uint i = 1; i < 3; i++)
+      if (e[i] - b[i] > e[d] - b[d])
+        d = i;
+    return d;
+  }
+
+  container_type* array; // underlying container
+  size_t grain;          // minimum number of blocks of divisible range
+  size_t b[3];           // first block index along each dimension
+  size_t e[3];           // one past last block index along each dimension
+};
+
+} // dim3
+} // internal
+} // zfp
+
+#endif
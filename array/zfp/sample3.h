@@ -0,0 +1,138 @@
+#ifndef ZFP_SAMPLE3_H
+#define ZFP_SAMPLE3_H
+
+#include <algorithm>
+#include <vector>
+
+#ifdef _OPENMP
+  #include <omp.h>
+#endif
+
+// evaluation of 3D arrays at scattered points
+
+namespace zfp {
+namespace internal {
+namespace dim3 {
+
+// batched point queries that decode each block touched by the points once,
+// bypassing the array's cache, rather than visiting blocks in query order
+template <class Array>
+class point_sampler {
+public:
+  typedef typename Array::value_type value_type;
+  typedef typename Array::codec_type codec_type;
+
+  // evaluate array at n points (x, y, z) stored consecutively
+  static void sample(const Array& a, const double* points, size_t n, value_type* out, bool interpolate)
+  {
+    if (!n || !a.size())
+      return;
+    const uint k = interpolate ? 8u : 1u;
+    std::vector<tap> taps(n * k);
+    std::vector<double> weight(n * k);
+    std::vector<value_type> value(n * k);
+
+    // gather grid points of all queries and sort them by block
+    for (size_t p = 0; p < n; p++, points += 3) {
+      size_t i0[3], i1[3];
+      double t[3];
+      locate(points[0], a.nx, interpolate, i0[0], i1[0], t[0]);
+      locate(points[1], a.ny, interpolate, i0[1], i1[1], t[1]);
+      locate(points[2], a.nz, interpolate, i0[2], i1[2], t[2]);
+      // bit d of tap number j selects upper grid point along axis d
+      for (uint j = 0; j < k; j++) {
+        size_t i = (j & 1u) ? i1[0] : i0[0];
+        size_t jj = (j & 2u) ? i1[1] : i0[1];
+        size_t kk = (j & 4u) ? i1[2] : i0[2];
+        tap& q = taps[k * p + j];
+        q.block = a.store.block_index(i, jj, kk);
+        q.index = k * p + j;
+        q.offset = uint((i & 3u) + 4 * ((jj & 3u) + 4 * (kk & 3u)));
+        weight[k * p + j] = ((j & 1u) ? t[0] : 1 - t[0]) * ((j & 2u) ? t[1] : 1 - t[1]) * ((j & 4u) ? t[2] : 1 - t[2]);
+      }
+    }
+    std::sort(taps.begin(), taps.end());
+
+    // decode disjoint runs of blocks in parallel from up-to-date storage
+    a.flush_cache();
+    const long count = static_cast<long>(taps.size());
+#ifdef _OPENMP
+    #pragma omp parallel if (count > 1)
+#endif
+    {
+      long parts = 1;
+      long part = 0;
+#ifdef _OPENMP
+      parts = omp_get_num_threads();
+      part = omp_get_thread_num();
+#endif
+      const size_t begin = split(taps, count, parts, part);
+      const size_t end = split(taps, count, parts, part + 1);
+      codec_type* codec = a.store.codec();
+      value_type block[64];
+      size_t b = a.store.blocks();
+      for (size_t i = begin; i < end; i++) {
+        if (taps[i].block != b) {
+          b = taps[i].block;
+          a.store.decode(codec, b, block);
+        }
+        value[taps[i].index] = block[taps[i].offset];
+      }
+    }
+
+    // combine tapped values with their weights
+    for (size_t p = 0; p < n; p++) {
+      if (interpolate) {
+        double sum = 0;
+        for (uint j = 0; j < k; j++)
+          sum += weight[k * p + j] * double(value[k * p + j]);
+        out[p] = value_type(sum);
+      }
+      else
+        out[p] = value[p];
+    }
+  }
+
+protected:
+  // grid point of block contributing to value of a point
+  struct tap {
+    bool operator<(const tap& q) const { return block < q.block || (block == q.block && index < q.index); }
+    size_t block; // index of block holding grid point
+    size_t index; // point index times taps per point plus tap number
+    uint offset;  // offset of grid point within block
+  };
+
+  // grid indices i0 <= i1 bracketing coordinate x along axis of n grid
+  // points, and weight t of i1; without interpolation, i0 = i1 is the grid
+  // point nearest x; coordinates outside the array, and NaNs, are clamped
+  static void locate(double x, size_t n, bool interpolate, size_t& i0, size_t& i1, double& t)
+  {
+    const double max = double(n - 1);
+    x = x > 0 ? std::min(x, max) : 0;
+    if (interpolate) {
+      i0 = size_t(x);
+      i1 = std::min(i0 + 1, n - 1);
+      t = x - double(i0);
+    }
+    else {
+      i0 = i1 = size_t(x + 0.5);
+      t = 0;
+    }
+  }
+
+  // first of the sorted taps assigned to part of parts, advanced to a block
+  // boundary so that each block is decoded by a single thread
+  static size_t split(const std::vector<tap>& taps, long count, long parts, long part)
+  {
+    size_t i = size_t(count) * size_t(part) / size_t(parts);
+    while (0 < i && i < taps.size() && taps[i].block == taps[i - 1].block)
+      i++;
+    return i;
+  }
+};
+
+} // dim3
+} // internal
+} // zfp
+
+#endif
@@ -0,0 +1,135 @@
+#ifndef ZFP_SHARED_CACHE3_H
+#define ZFP_SHARED_CACHE3_H
+
+// concurrent read-only cache of 3D array blocks (requires C++11)
+
+#if defined(__cplusplus) && __cplusplus >= 201103L
+
+#include <atomic>
+#include <memory>
+#include "store3.h"
+
+namespace zfp {
+
+// direct-mapped cache of decompressed blocks shared by OpenMP or other
+// threads for read-only access; lookups are lock free and validated by
+// a per-line sequence counter (seqlock), which is odd while one thread
+// decodes a block into the line, so that other threads requesting that
+// block wait for it rather than decoding it again
+template <typename Scalar, class Codec, class Store = BlockStore3<Scalar, Codec> >
+class SharedBlockCache3 {
+public:
+  // constructor of cache of given size
+  SharedBlockCache3(const Store& store, size_t bytes = 0) :
+    store(store),
+    mask(0),
+    decoded(0)
+  {
+    resize(bytes);
+  }
+
+  // cache size in number of bytes
+  size_t size() const { return (size_t(mask) + 1) * sizeof(Line); }
+
+  // set minimum cache size in bytes (inferred from blocks if zero); not
+  // thread safe
+  void resize(size_t bytes)
+  {
+    size_t n = bytes ? (bytes + sizeof(Line) - 1) / sizeof(Line) : store.blocks();
+    size_t count = 1;
+    while (count < n && count < max_lines)
+      count <<= 1;
+    line.reset(new Line[count]);
+    mask = count - 1;
+    clear();
+  }
+
+  // empty cache; not thread safe
+  void clear() const
+  {
+    for (size_t i = 0; i <= mask; i++) {
+      line[i].seq.store(0, std::memory_order_relaxed);
+      line[i].tag.store(0, std::memory_order_relaxed);
+    }
+  }
+
+  // number of blocks decompressed since construction
+  size_t decodes() const { return decoded.load(std::memory_order_relaxed); }
+
+  // inspector
+  Scalar get(size_t i, size_t j, size_t k) const
+  {
+    size_t block_index = store.block_index(i, j, k);
+    uint offset = (i & 3u) + 4 * ((j & 3u) + 4 * (k & 3u));
+    Line& l = line[block_index & mask];
+    for (uint spins = 0;; spins++) {
+      uint seq = l.seq.load(std::memory_order_acquire);
+      if (!(seq & 1u)) {
+        if (l.tag.load(std::memory_order_relaxed) == block_index + 1) {
+          // hit; value is valid only if line was not refilled meanwhile
+          Scalar value = l.a[offset].load(std::memory_order_relaxed);
+          std::atomic_thread_fence(std::memory_order_acquire);
+          if (l.seq.load(std::memory_order_relaxed) == seq)
+            return value;
+        }
+        else if (l.seq.compare_exchange_weak(seq, seq + 1, std::memory_order_acquire, std::memory_order_relaxed))
+          return fill(l, seq, block_index, offset);
+      }
+      else if (spins >= max_spins) {
+        // line is held by a stalled thread; decode block without caching it
+        Scalar block[64];
+        decode(block_index, block);
+        return block[offset];
+      }
+    }
+  }
+
+protected:
+  // cache line with decompressed block; sequence counter is even when line
+  // is stable and odd while being filled
+  struct Line {
+    std::atomic<uint> seq;     // sequence counter
+    std::atomic<size_t> tag;   // block index + 1 (zero if empty)
+    std::atomic<Scalar> a[64]; // decompressed values
+  };
+
+  // decode block with a codec of its own, as the store's codec pool is
+  // indexed by OpenMP thread number and would otherwise let threads that
+  // are not members of one OpenMP team share a bit stream
+  void decode(size_t block_index, Scalar* block) const
+  {
+    Codec codec(store.compressed_data(), store.compressed_size());
+    store.configure(&codec);
+    store.decode(&codec, block_index, block);
+    decoded.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // decode block into line claimed with odd sequence number seq + 1 and
+  // return value at offset
+  Scalar fill(Line& l, uint seq, size_t block_index, uint offset) const
+  {
+    Scalar block[64];
+    decode(block_index, block);
+    // order stores after claim so that concurrent readers fail validation
+    std::atomic_thread_fence(std::memory_order_release);
+    l.tag.store(block_index + 1, std::memory_order_relaxed);
+    for (uint i = 0; i < 64; i++)
+      l.a[i].store(block[i], std::memory_order_relaxed);
+    l.seq.store(seq + 2, std::memory_order_release);
+    return block[offset];
+  }
+
+  static const size_t max_lines = size_t(1) << 24; // limit on cache lines
+  static const uint max_spins = 1u << 12;          // wait for line before decoding
+
+  const Store& store;                 // store backed by cache
+  std::unique_ptr<Line[]> line;       // cache lines
+  size_t mask;                        // cache line mask
+  mutable std::atomic<size_t> decoded; // number of blocks decompressed
+};
+
+}
+
+#endif
+
+#endif
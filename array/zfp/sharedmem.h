@@ -0,0 +1,162 @@
+#ifndef ZFP_SHAREDMEM_H
+#define ZFP_SHAREDMEM_H
+
+#include <cstring>
+#include <string>
+#include "zfp.h"
+#include "zfp/exception.h"
+#include "zfp/memory.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+  #define ZFP_SHARED_SEGMENT 1
+#endif
+
+namespace zfp {
+
+// serialized compressed array held in a named POSIX shared memory segment;
+// one process publishes an array's header and compressed blocks, after which
+// other processes on the node attach to the segment and construct arrays
+// that borrow its blocks read-only while keeping private caches, so that
+// the compressed data is stored once per node rather than once per process
+class shared_segment {
+public:
+  // publish header and compressed data of array under name, e.g., "/table";
+  // any existing segment of the same name is unlinked first, so that
+  // processes still attached to it are unaffected
+  template <class Array>
+  shared_segment(const std::string& name, const Array& a) :
+    name(name),
+    base(0),
+    bytes(0)
+  {
+    typename Array::header h(a);
+    const size_t header_bytes = h.size_bytes();
+    const size_t data_bytes = a.compressed_size();
+    const size_t offset = data_offset(header_bytes);
+    map(true, offset + data_bytes);
+    uchar* p = static_cast<uchar*>(base);
+    std::memcpy(p + sizeof(layout), h.data(), header_bytes);
+    std::memcpy(p + offset, a.compressed_data(), data_bytes);
+    layout* l = static_cast<layout*>(base);
+    l->header_bytes = header_bytes;
+    l->data_bytes = data_bytes;
+    l->data_offset = offset;
+    // mark segment as complete only once its contents are in place
+    l->magic = magic();
+  }
+
+  // attach read-only to segment published under name
+  explicit shared_segment(const std::string& name) :
+    name(name),
+    base(0),
+    bytes(0)
+  {
+    map(false, 0);
+    const layout* l = static_cast<const layout*>(base);
+    if (bytes < sizeof(layout) || l->magic != magic() ||
+        l->data_offset < data_offset(l->header_bytes) || l->data_offset + l->data_bytes > bytes) {
+      unmap();
+      throw zfp::exception("zfp shared segment " + name + " is incomplete or corrupt");
+    }
+  }
+
+  // unmap segment; the segment persists until unlinked and unmapped by all
+  ~shared_segment() { unmap(); }
+
+  // remove name of segment so that no more processes may attach to it
+  bool unlink() const
+  {
+#ifdef ZFP_SHARED_SEGMENT
+    return !shm_unlink(name.c_str());
+#else
+    return false;
+#endif
+  }
+
+  // serialized array header
+  const void* header_data() const { return static_cast<const uchar*>(base) + sizeof(layout); }
+  size_t header_size() const { return size_t(static_cast<const layout*>(base)->header_bytes); }
+
+  // compressed blocks for use by arrays that borrow them
+  const void* compressed_data() const { return static_cast<const uchar*>(base) + size_t(static_cast<const layout*>(base)->data_offset); }
+  size_t compressed_size() const { return size_t(static_cast<const layout*>(base)->data_bytes); }
+
+  // byte size of mapped segment
+  size_t size() const { return bytes; }
+
+protected:
+  // segment prefix preceding the header and the aligned compressed blocks
+  struct layout {
+    uint64 magic;        // set last by publisher
+    uint64 header_bytes; // byte size of header
+    uint64 data_bytes;   // byte size of compressed blocks
+    uint64 data_offset;  // byte offset of compressed blocks within segment
+  };
+
+  static uint64 magic() { return (uint64(0x7a667073u) << 32) + 0x686d0001u; }
+
+  // offset of compressed blocks following header
+  static size_t data_offset(uint64 header_bytes)
+  {
+    const size_t alignment = ZFP_MEMORY_ALIGNMENT;
+    return (sizeof(layout) + size_t(header_bytes) + alignment - 1) / alignment * alignment;
+  }
+
+  // create (publisher) or open (reader) segment and map it into memory
+  void map(bool create, size_t size)
+  {
+#ifdef ZFP_SHARED_SEGMENT
+    if (create)
+      shm_unlink(name.c_str());
+    int fd = create ? shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644)
+                    : shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0)
+      throw zfp::exception("zfp shared segment " + name + " cannot be opened");
+    struct stat st;
+    if (create ? ftruncate(fd, off_t(size)) : fstat(fd, &st)) {
+      close(fd);
+      throw zfp::exception("zfp shared segment " + name + " cannot be sized");
+    }
+    if (!create)
+      size = size_t(st.st_size);
+    void* p = size ? mmap(0, size, create ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+    close(fd);
+    if (p == MAP_FAILED)
+      throw zfp::exception("zfp shared segment " + name + " cannot be mapped");
+    base = p;
+    bytes = size;
+#else
+    unused_(create);
+    unused_(size);
+    throw zfp::exception("zfp shared segments require POSIX shared memory");
+#endif
+  }
+
+  // unmap segment
+  void unmap()
+  {
+#ifdef ZFP_SHARED_SEGMENT
+    if (base)
+      munmap(base, bytes);
+#endif
+    base = 0;
+    bytes = 0;
+  }
+
+  std::string name; // segment name
+  void* base;       // mapped segment
+  size_t bytes;     // byte size of mapped segment
+
+private:
+  // copying is not supported
+  shared_segment(const shared_segment&);
+  shared_segment& operator=(const shared_segment&);
+};
+
+}
+
+#endif
@@ -0,0 +1,99 @@
+#ifndef ZFP_SHARED_VIEW3_H
+#define ZFP_SHARED_VIEW3_H
+
+// read-only view of 3D array with cache shared among threads (requires C++11)
+
+#if defined(__cplusplus) && __cplusplus >= 201103L
+
+#include "zfp/sharedcache3.h"
+#include "zfp/view3.h"
+
+namespace zfp {
+namespace internal {
+namespace dim3 {
+
+// thread-safe read-only view of 3D (sub)array whose cache is shared by all
+// threads, OpenMP or otherwise, reading through it, so that each block is
+// decompressed once rather than once per thread
+template <class Container>
+class shared_const_view : public preview<Container> {
+public:
+  typedef Container container_type;
+  typedef typename container_type::value_type value_type;
+  typedef typename container_type::codec_type codec_type;
+  typedef typename zfp::internal::dim3::const_reference<shared_const_view> const_reference;
+  typedef typename zfp::internal::dim3::const_pointer<shared_const_view> const_pointer;
+  typedef typename zfp::internal::dim3::const_iterator<shared_const_view> const_iterator;
+
+  // construction--perform shallow copy of (sub)array after compressing
+  // modified blocks cached by the array
+  shared_const_view(container_type* array, size_t cache_size = 0) :
+    preview<Container>(array),
+    cache(array->store, cache_size ? cache_size : array->cache.size())
+  {
+    array->cache.flush();
+  }
+  shared_const_view(container_type* array, size_t x, size_t y, size_t z, size_t nx, size_t ny, size_t nz, size_t cache_size = 0) :
+    preview<Container>(array, x, y, z, nx, ny, nz),
+    cache(array->store, cache_size ? cache_size : array->cache.size())
+  {
+    array->cache.flush();
+  }
+
+  // dimensions of (sub)array
+  size_t size_x() const { return nx; }
+  size_t size_y() const { return ny; }
+  size_t size_z() const { return nz; }
+
+  // cache size in number of bytes
+  size_t cache_size() const { return cache.size(); }
+
+  // set minimum cache size in bytes (not thread safe)
+  void set_cache_size(size_t bytes) { cache.resize(bytes); }
+
+  // empty cache, e.g., after the array is modified (not thread safe)
+  void clear_cache() const { cache.clear(); }
+
+  // number of blocks decompressed through this view
+  size_t decodes() const { return cache.decodes(); }
+
+  // (i, j, k) inspector
+  const_reference operator()(size_t i, size_t j, size_t k) const { return const_reference(this, x + i, y + j, z + k); }
+
+  // random access iterators
+  const_iterator cbegin() const { return const_iterator(this, x, y, z); }
+  const_iterator cend() const { return const_iterator(this, x, y, z + nz); }
+  const_iterator begin() const { return cbegin(); }
+  const_iterator end() const { return cend(); }
+
+protected:
+  friend class zfp::internal::dim3::const_handle<shared_const_view>;
+  friend class zfp::internal::dim3::const_pointer<shared_const_view>;
+  friend class zfp::internal::dim3::const_iterator<shared_const_view>;
+
+  using preview<Container>::min_x;
+  using preview<Container>::max_x;
+  using preview<Container>::min_y;
+  using preview<Container>::max_y;
+  using preview<Container>::min_z;
+  using preview<Container>::max_z;
+  using preview<Container>::x;
+  using preview<Container>::y;
+  using preview<Container>::z;
+  using preview<Container>::nx;
+  using preview<Container>::ny;
+  using preview<Container>::nz;
+
+  // inspector
+  value_type get(size_t x, size_t y, size_t z) const { return cache.get(x, y, z); }
+
+  SharedBlockCache3<value_type, codec_type> cache; // shared cache of decompressed blocks
+};
+
+} // dim3
+} // internal
+} // zfp
+
+#endif
+
+#endif
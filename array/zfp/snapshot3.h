@@ -0,0 +1,124 @@
+#ifndef ZFP_SNAPSHOT3_H
+#define ZFP_SNAPSHOT3_H
+
+namespace zfp {
+namespace internal {
+namespace dim3 {
+
+// read-only snapshot of 3D array that shares compressed blocks with the
+// array; only blocks modified after the snapshot is taken are copied
+template <class Container>
+class snapshot_view : public BlockSnapshot {
+public:
+  typedef Container container_type;
+  typedef typename container_type::value_type value_type;
+  typedef typename container_type::codec_type codec_type;
+
+  // snapshot of current array contents (modified cached blocks are compressed first)
+  explicit snapshot_view(container_type* array) :
+    BlockSnapshot(flushed_store(array), array->store.blocks()),
+    nx(array->size_x()), ny(array->size_y()), nz(array->size_z()),
+    bx((nx + 3) / 4), by((ny + 3) / 4),
+    live(array->store.compressed_data(), array->store.compressed_size()),
+    copy(array->store.compressed_data(), array->store.compressed_size()),
+    index(size_t(-1))
+  {
+    array->store.configure(&live);
+    array->store.configure(&copy);
+  }
+
+  // copy constructor--shares unchanged blocks with the same array
+  snapshot_view(const snapshot_view& s) :
+    BlockSnapshot(s),
+    nx(s.nx), ny(s.ny), nz(s.nz),
+    bx(s.bx), by(s.by),
+    live(s.live),
+    copy(s.copy),
+    index(size_t(-1))
+  {}
+
+  // dimensions of array at time of snapshot
+  size_t size() const { return nx * ny * nz; }
+  size_t size_x() const { return nx; }
+  size_t size_y() const { return ny; }
+  size_t size_z() const { return nz; }
+
+  // (i, j, k) inspector
+  value_type operator()(size_t i, size_t j, size_t k) const
+  {
+    size_t block_index = (i / 4) + bx * ((j / 4) + by * (k / 4));
+    if (block_index != index) {
+      decode(block_index, block, 1, 4, 16);
+      index = block_index;
+    }
+    return block[(i & 3u) + 4 * ((j & 3u) + 4 * (k & 3u))];
+  }
+
+  // flat index inspector
+  value_type operator[](size_t index) const
+  {
+    size_t i = index % nx; index /= nx;
+    size_t j = index % ny; index /= ny;
+    size_t k = index;
+    return operator()(i, j, k);
+  }
+
+  // decompress snapshot and store at p
+  void get(value_type* p) const
+  {
+    const ptrdiff_t sx = 1;
+    const ptrdiff_t sy = static_cast<ptrdiff_t>(nx);
+    const ptrdiff_t sz = static_cast<ptrdiff_t>(nx * ny);
+    for (size_t z = 0, block_index = 0; z < nz; z += 4)
+      for (size_t y = 0; y < ny; y += 4)
+        for (size_t x = 0; x < nx; x += 4, block_index++)
+          decode(block_index, p + sx * x + sy * y + sz * z, sx, sy, sz);
+  }
+
+protected:
+  typedef BlockStore3<value_type, codec_type> store_type;
+
+  // compress modified cached blocks and return array store
+  static const BlockStore* flushed_store(container_type* array)
+  {
+    array->flush_cache();
+    return &array->store;
+  }
+
+  // decode block from its copy, if any, or from the array store
+  void decode(size_t block_index, value_type* p, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz) const
+  {
+    const void* data = preserved(block_index);
+    if (data) {
+      copy.open(const_cast<void*>(data), preserved_size(block_index));
+      copy.decode_block_strided(0, shape(block_index), p, sx, sy, sz);
+    }
+    else
+      static_cast<const store_type*>(store)->decode(&live, block_index, p, sx, sy, sz);
+  }
+
+  // shape of block with given index
+  uint shape(size_t block_index) const
+  {
+    size_t i = 4 * (block_index % bx); block_index /= bx;
+    size_t j = 4 * (block_index % by); block_index /= by;
+    size_t k = 4 * block_index;
+    uint mx = i + 4 > nx ? uint(i + 4 - nx) : 0u;
+    uint my = j + 4 > ny ? uint(j + 4 - ny) : 0u;
+    uint mz = k + 4 > nz ? uint(k + 4 - nz) : 0u;
+    return mx + 4 * (my + 4 * mz);
+  }
+
+  size_t nx, ny, nz;             // array dimensions
+  size_t bx, by;                 // array dimensions in number of blocks
+  mutable codec_type live;       // codec for blocks shared with the array
+  mutable codec_type copy;       // codec for preserved copies of blocks
+  mutable size_t index;          // index of decoded block
+  mutable value_type block[64];  // most recently decoded block
+};
+
+} // dim3
+} // internal
+} // zfp
+
+#endif
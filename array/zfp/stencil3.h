@@ -0,0 +1,107 @@
+#ifndef ZFP_STENCIL3_H
+#define ZFP_STENCIL3_H
+
+#include <algorithm>
+
+namespace zfp {
+namespace internal {
+namespace dim3 {
+
+// read-only view for stencil computations that holds the block containing
+// the current element and a one-element halo from its neighbor blocks
+template <class Container>
+class stencil_view {
+public:
+  typedef Container container_type;
+  typedef typename container_type::value_type value_type;
+
+  // construction--no block is loaded until center() is called
+  explicit stencil_view(const container_type* array) :
+    array(array),
+    bi(size_t(-1)), bj(0), bk(0),
+    i(0), j(0), k(0)
+  {}
+
+  // make (i, j, k) the current element, loading its neighborhood if needed
+  void center(size_t i, size_t j, size_t k)
+  {
+    if ((i >> 2) != bi || (j >> 2) != bj || (k >> 2) != bk)
+      load(i >> 2, j >> 2, k >> 2);
+    this->i = (i & 3u) + 1;
+    this->j = (j & 3u) + 1;
+    this->k = (k & 3u) + 1;
+  }
+
+  // call f(i, j, k, s) for each array element (i, j, k) in block order,
+  // where s is this view centered at (i, j, k)
+  template <class Function>
+  Function for_each(Function f)
+  {
+    const size_t nx = array->size_x();
+    const size_t ny = array->size_y();
+    const size_t nz = array->size_z();
+    for (size_t z = 0; z < nz; z += 4)
+      for (size_t y = 0; y < ny; y += 4)
+        for (size_t x = 0; x < nx; x += 4)
+          for (size_t k = z; k < std::min(z + 4, nz); k++)
+            for (size_t j = y; j < std::min(y + 4, ny); j++)
+              for (size_t i = x; i < std::min(x + 4, nx); i++) {
+                center(i, j, k);
+                f(i, j, k, static_cast<const stencil_view&>(*this));
+              }
+    return f;
+  }
+
+  // force neighborhood to be reloaded, e.g., after the array is modified
+  void invalidate() { bi = size_t(-1); }
+
+  // value at offset (di, dj, dk) from current element, with |di|, |dj|, |dk| <= 1
+  value_type operator()(ptrdiff_t di, ptrdiff_t dj, ptrdiff_t dk) const { return a[(i + di) + 6 * ((j + dj) + 6 * (k + dk))]; }
+
+protected:
+  // copy block (bi, bj, bk) and adjacent values from its 26 neighbors
+  void load(size_t bi, size_t bj, size_t bk)
+  {
+    this->bi = bi;
+    this->bj = bj;
+    this->bk = bk;
+    // values outside the array are unspecified
+    std::fill(a, a + 6 * 6 * 6, value_type(0));
+    const size_t mx = (array->size_x() + 3) / 4;
+    const size_t my = (array->size_y() + 3) / 4;
+    const size_t mz = (array->size_z() + 3) / 4;
+    for (int dk = -1; dk <= 1; dk++) {
+      if ((dk < 0 && !bk) || (dk > 0 && bk + 1 == mz))
+        continue;
+      for (int dj = -1; dj <= 1; dj++) {
+        if ((dj < 0 && !bj) || (dj > 0 && bj + 1 == my))
+          continue;
+        for (int di = -1; di <= 1; di++) {
+          if ((di < 0 && !bi) || (di > 0 && bi + 1 == mx))
+            continue;
+          // source range [min, max) within neighbor block and destination offset
+          uint xmin = di < 0 ? 3 : 0, xmax = di > 0 ? 1 : 4, x0 = di < 0 ? 0 : di > 0 ? 5 : 1;
+          uint ymin = dj < 0 ? 3 : 0, ymax = dj > 0 ? 1 : 4, y0 = dj < 0 ? 0 : dj > 0 ? 5 : 1;
+          uint zmin = dk < 0 ? 3 : 0, zmax = dk > 0 ? 1 : 4, z0 = dk < 0 ? 0 : dk > 0 ? 5 : 1;
+          size_t block_index = (bi + di) + mx * ((bj + dj) + my * (bk + dk));
+          const value_type* p = array->cache.block(block_index, false);
+          for (uint z = zmin; z < zmax; z++)
+            for (uint y = ymin; y < ymax; y++)
+              for (uint x = xmin; x < xmax; x++)
+                a[(x0 + x - xmin) + 6 * ((y0 + y - ymin) + 6 * (z0 + z - zmin))] = p[x + 4 * (y + 4 * z)];
+        }
+      }
+    }
+  }
+
+  const container_type* array; // underlying container
+  size_t bi, bj, bk;           // index of loaded block
+  size_t i, j, k;              // halo index of current element
+  value_type a[6 * 6 * 6];     // block with one-element halo
+};
+
+} // dim3
+} // internal
+} // zfp
+
+#endif
@@ -1,10 +1,109 @@
 #ifndef ZFP_STORE_H
 #define ZFP_STORE_H
 
+#include <algorithm>
 #include <climits>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "zfp/exception.h"
+#include "zfp/index.h"
+#include "zfp/layout.h"
+#include "zfp/memory.h"
 
 namespace zfp {
 
+class BlockStore;
+
+// compressed blocks of a store as of the time a snapshot was taken; blocks
+// that are unchanged are shared with the store, while blocks about to be
+// modified or discarded by the store are first copied to the snapshot
+class BlockSnapshot {
+public:
+  // number of blocks copied since the snapshot was taken
+  size_t preserved_blocks() const
+  {
+    size_t count = 0;
+    for (size_t i = 0; i < block.size(); i++)
+      if (block[i])
+        count++;
+    return count;
+  }
+
+  // number of bytes of compressed data held by copied blocks
+  size_t preserved_bytes() const
+  {
+    size_t bytes = 0;
+    for (size_t i = 0; i < length.size(); i++)
+      bytes += length[i];
+    return bytes;
+  }
+
+protected:
+  // snapshot of given number of blocks held by store
+  BlockSnapshot(const BlockStore* store, size_t blocks);
+
+  // copy constructor--shares unchanged blocks and copies preserved ones
+  BlockSnapshot(const BlockSnapshot& s);
+
+  // destructor
+  virtual ~BlockSnapshot();
+
+  // true if snapshot no longer shares any blocks with its store
+  bool detached() const { return !store; }
+
+  // copy of block with given index or null if unchanged since snapshot
+  const void* preserved(size_t block_index) const { return block[block_index]; }
+
+  // byte size of copy of block with given index
+  size_t preserved_size(size_t block_index) const { return length[block_index]; }
+
+  // copy count consecutive blocks, as they were when the snapshot was taken,
+  // to dst and return number of bytes copied
+  size_t read(size_t first, size_t count, void* dst) const;
+
+  // guard against concurrent modification when the snapshot is read by
+  // another thread; the store holds this lock while updating the snapshot
+  virtual void lock() const {}
+  virtual void unlock() const {}
+
+  // release snapshot allocated via new from a thread other than the one
+  // modifying the store; the snapshot is deleted here if detached or else
+  // later by the store
+  void retire();
+
+  const BlockStore* store;    // store sharing unchanged blocks (null if detached)
+  std::vector<uchar*> block;  // copies of blocks modified after snapshot
+  std::vector<size_t> length; // byte size of each copied block
+  bool retired;               // true if snapshot is no longer in use
+
+private:
+  friend class BlockStore;
+
+  // deallocate copied blocks
+  void free()
+  {
+    for (size_t i = 0; i < block.size(); i++)
+      zfp::deallocate(block[i]);
+    std::vector<uchar*>().swap(block);
+    std::vector<size_t>().swap(length);
+  }
+
+  // copy block of given byte size before the store modifies it
+  void preserve(size_t block_index, const void* data, size_t bytes)
+  {
+    uchar* copy = static_cast<uchar*>(zfp::allocate(bytes));
+    std::memcpy(copy, data, bytes);
+    block[block_index] = copy;
+    length[block_index] = bytes;
+  }
+
+  // assignment is not supported
+  BlockSnapshot& operator=(const BlockSnapshot&);
+};
+
 // base class for block store
 class BlockStore {
 public:
@@ -14,12 +113,227 @@ public:
   // pointer to compressed data for read or write access
   void* compressed_data() const { return data; }
 
+  // compression mode
+  zfp_mode mode() const { return compression_mode; }
+
+  // reclaim storage held by stale variable-length blocks
+  template <class Codec>
+  void compact(Codec* codec) const
+  {
+    if (!variable())
+      return;
+    size_t blocks = index.size();
+    size_t live = used - garbage;
+    size_t capacity = live + staging_words();
+    void* buffer = memory->allocate(capacity * word_bytes(), ZFP_MEMORY_ALIGNMENT);
+    // copy blocks in order of block index
+    size_t offset = 0;
+    for (size_t i = 0; i < blocks; i++) {
+      size_t length = index.length(i);
+      std::memcpy(word(buffer, offset), word(data, index.offset(i)), length * word_bytes());
+      index.set(i, offset, length);
+      offset += length;
+    }
+    zfp::deallocate_aligned(data, memory);
+    data = buffer;
+    bytes = capacity * word_bytes();
+    used = live;
+    garbage = 0;
+    codec->open(data, bytes);
+  }
+
+  // move compressed storage to memory obtained from given allocator
+  void set_allocator(allocator* memory)
+  {
+    // snapshots must not share storage about to be deallocated
+    detach_snapshots();
+    void* buffer = 0;
+    if (data) {
+      buffer = memory->allocate(bytes, ZFP_MEMORY_ALIGNMENT);
+      std::memcpy(buffer, data, bytes);
+      release();
+    }
+    data = buffer;
+    this->memory = memory;
+  }
+
+  // use caller-owned buffer of fixed-rate compressed blocks in place of a
+  // copy; the buffer must outlive the store or the first call to own()
+  void borrow(const void* buffer)
+  {
+    release();
+    data = const_cast<void*>(buffer);
+    owner = false;
+  }
+
+  // true if compressed blocks reside in a borrowed buffer
+  bool borrowed() const { return !owner; }
+
+  // load blocks of maxbits bits each stored back to back in raster order at
+  // bit offset of buffer, as written by zfp_compress() in fixed-rate mode;
+  // when requested, the buffer is borrowed if its blocks are word aligned,
+  // and otherwise blocks are copied; a truncated block does not decode the
+  // same once zero padded, so maxbits must match the store's block size
+  void load(const void* buffer, size_t offset, uint maxbits, size_t blocks, bool borrow)
+  {
+    if (variable() || maxbits != bits_per_block)
+      throw zfp::exception("zfp stream rate is not a word-aligned array rate");
+    const uchar* begin = static_cast<const uchar*>(buffer) + offset / word_bits() * word_bytes();
+    offset %= word_bits();
+    if (!offset && layout.order() == block_order_raster) {
+      if (borrow && !(reinterpret_cast<size_t>(begin) % word_bytes()))
+        this->borrow(begin);
+      else
+        std::memcpy(data, begin, blocks * maxbits / word_bits() * word_bytes());
+      return;
+    }
+    // copy blocks one bit string of at most 64 bits at a time
+    const size_t size = (offset + blocks * maxbits + word_bits() - 1) / word_bits() * word_bytes();
+    bitstream* src = stream_open(const_cast<uchar*>(begin), size);
+    bitstream* dst = stream_open(data, bytes);
+    stream_rseek(src, offset);
+    for (size_t b = 0; b < blocks; b++) {
+      stream_wseek(dst, layout.position(b) * bits_per_block);
+      for (uint n = maxbits; n;) {
+        uint m = std::min(n, 64u);
+        stream_write_bits(dst, stream_read_bits(src, m), m);
+        n -= m;
+      }
+    }
+    stream_flush(dst);
+    stream_close(dst);
+    stream_close(src);
+  }
+
+  // number of snapshots sharing blocks with this store
+  size_t snapshot_count() const { return snapshots.size(); }
+
+  // copy borrowed compressed blocks to memory owned by the store
+  void own() const
+  {
+    if (!owner) {
+      void* buffer = memory->allocate(bytes, ZFP_MEMORY_ALIGNMENT);
+      std::memcpy(buffer, data, bytes);
+      for (size_t i = 0; i < snapshots.size(); i++)
+        snapshots[i]->lock();
+      data = buffer;
+      for (size_t i = 0; i < snapshots.size(); i++)
+        snapshots[i]->unlock();
+      owner = true;
+    }
+  }
+
+  // reattach codec to storage that was reallocated via another codec
+  template <class Codec>
+  void attach(Codec* codec) const
+  {
+    if (codec->buffer() != data || codec->buffer_size() != bytes)
+      codec->open(data, bytes);
+  }
+
+  // attach codec for modifying blocks, copying any borrowed blocks first
+  template <class Codec>
+  void acquire(Codec* codec) const
+  {
+    own();
+    attach(codec);
+  }
+
+  // number of bytes needed to pack block with given index
+  size_t packed_size(size_t block_index) const
+  {
+    return (variable() ? sizeof(uint64) : 0) + length(block_index) * word_bytes();
+  }
+
+  // copy compressed block to buffer without decompression and return number
+  // of bytes copied; variable-length blocks are prefixed with their length
+  size_t pack(size_t block_index, void* buffer) const
+  {
+    uchar* p = static_cast<uchar*>(buffer);
+    size_t words = length(block_index);
+    if (variable()) {
+      uint64 n = words;
+      std::memcpy(p, &n, sizeof(n));
+      p += sizeof(n);
+    }
+    std::memcpy(p, word(data, offset(block_index) / word_bits()), words * word_bytes());
+    return packed_size(block_index);
+  }
+
+  // replace block with compressed block packed by a store having the same
+  // compression mode and parameters, and return number of bytes consumed
+  template <class Codec>
+  size_t unpack(Codec* codec, size_t block_index, const void* buffer) const
+  {
+    const uchar* p = static_cast<const uchar*>(buffer);
+    preserve(block_index);
+    acquire(codec);
+    if (!variable()) {
+      size_t words = length(block_index);
+      std::memcpy(word(data, offset(block_index) / word_bits()), p, words * word_bytes());
+      return words * word_bytes();
+    }
+    uint64 n;
+    std::memcpy(&n, p, sizeof(n));
+    p += sizeof(n);
+    if (n > staging_words())
+      throw zfp::exception("zfp packed block exceeds maximum block size");
+    size_t words = static_cast<size_t>(n);
+    std::memcpy(word(data, reserve(codec) / word_bits()), p, words * word_bytes());
+    commit(codec, block_index, words * word_bits());
+    return sizeof(n) + words * word_bytes();
+  }
+
+  // true if compressed blocks of s decode to the same values in this store,
+  // i.e., if both stores share compression mode and parameters
+  bool compatible(const BlockStore& s) const
+  {
+    if (compression_mode != s.compression_mode)
+      return false;
+    switch (compression_mode) {
+      case zfp_mode_fixed_precision:
+        return precision == s.precision;
+      case zfp_mode_fixed_accuracy:
+        return tolerance == s.tolerance;
+      case zfp_mode_reversible:
+        return true;
+      default:
+        return bits_per_block == s.bits_per_block;
+    }
+  }
+
+  // replace block with block s_index of compatible store s without
+  // decompression; blocks are word aligned and copied as is
+  template <class Codec>
+  void copy_block(Codec* codec, size_t block_index, const BlockStore& s, size_t s_index) const
+  {
+    preserve(block_index);
+    acquire(codec);
+    size_t words = s.length(s_index);
+    if (!variable()) {
+      std::memmove(word(data, offset(block_index) / word_bits()), word(s.data, s.offset(s_index) / word_bits()), words * word_bytes());
+      return;
+    }
+    // reserve first, as growing the store may move the source block
+    size_t bits = reserve(codec);
+    std::memcpy(word(data, bits / word_bits()), word(s.data, s.offset(s_index) / word_bits()), words * word_bytes());
+    commit(codec, block_index, words * word_bits());
+  }
+
 protected:
   // protected default constructor
   BlockStore() :
     bits_per_block(0),
     data(0),
-    bytes(0)
+    bytes(0),
+    compression_mode(zfp_mode_fixed_rate),
+    precision(0),
+    tolerance(0),
+    budget(0),
+    used(0),
+    garbage(0),
+    owner(true),
+    memory(zfp::default_allocator())
   {}
 
   // perform a deep copy
@@ -27,31 +341,350 @@ protected:
   {
     bits_per_block = s.bits_per_block;
     bytes = s.bytes;
-    zfp::clone_aligned(data, s.data, s.bytes, ZFP_MEMORY_ALIGNMENT);
+    release();
+    memory = s.memory;
+    zfp::clone_aligned(data, s.data, s.bytes, ZFP_MEMORY_ALIGNMENT, memory);
+    compression_mode = s.compression_mode;
+    precision = s.precision;
+    tolerance = s.tolerance;
+    budget = s.budget;
+    index.deep_copy(s.index);
+    layout = s.layout;
+    used = s.used;
+    garbage = s.garbage;
   }
 
+  // exchange contents with another store
+  void swap(BlockStore& s)
+  {
+    std::swap(bits_per_block, s.bits_per_block);
+    std::swap(data, s.data);
+    std::swap(bytes, s.bytes);
+    std::swap(compression_mode, s.compression_mode);
+    std::swap(precision, s.precision);
+    std::swap(tolerance, s.tolerance);
+    std::swap(budget, s.budget);
+    index.swap(s.index);
+    std::swap(layout, s.layout);
+    std::swap(used, s.used);
+    std::swap(garbage, s.garbage);
+    std::swap(owner, s.owner);
+    std::swap(memory, s.memory);
+    // snapshots follow the blocks they share
+    snapshots.swap(s.snapshots);
+    for (size_t i = 0; i < snapshots.size(); i++) {
+      snapshots[i]->lock();
+      snapshots[i]->store = this;
+      snapshots[i]->unlock();
+    }
+    for (size_t i = 0; i < s.snapshots.size(); i++) {
+      s.snapshots[i]->lock();
+      s.snapshots[i]->store = &s;
+      s.snapshots[i]->unlock();
+    }
+  }
+
+  // true if blocks vary in length and are located via index
+  bool variable() const { return compression_mode != zfp_mode_fixed_rate; }
+
   // allocate memory for persistent block store
   void alloc(size_t blocks, bool clear)
   {
+    if (variable()) {
+      alloc_variable(blocks);
+      return;
+    }
     size_t words = (blocks * bits_per_block + CHAR_BIT * sizeof(uint64) - 1) / (CHAR_BIT * sizeof(uint64));
     bytes = words * sizeof(uint64);
-    zfp::reallocate_aligned(data, bytes, ZFP_MEMORY_ALIGNMENT);
+    release();
+    zfp::reallocate_aligned(data, bytes, ZFP_MEMORY_ALIGNMENT, memory);
     if (clear)
       std::fill(static_cast<uint64*>(data), static_cast<uint64*>(data) + words, uint64(0));
   }
 
+  // allocate one zero word per block, which decodes to an all-zero block
+  void alloc_variable(size_t blocks)
+  {
+    index.resize(blocks);
+    used = blocks;
+    garbage = 0;
+    bytes = (used + staging_words()) * word_bytes();
+    release();
+    zfp::reallocate_aligned(data, bytes, ZFP_MEMORY_ALIGNMENT, memory);
+    std::memset(data, 0, bytes);
+  }
+
+  // switch to fixed-rate mode with given bits per block by truncating each
+  // block; for zfp's embedded coding, the result is identical to compressing
+  // at the lower rate; variable-length blocks shorter than the new rate are
+  // zero padded, which leaves their values unchanged
+  void transcode(size_t blocks, uint bits)
+  {
+    if (compression_mode == zfp_mode_reversible)
+      throw zfp::exception("zfp reversible blocks cannot be transcoded");
+    // padding truncated blocks would alter their values
+    if (!variable() && bits > bits_per_block)
+      throw zfp::exception("zfp fixed-rate blocks cannot be transcoded to a higher rate");
+    // snapshots keep the blocks as they were
+    detach_snapshots();
+    const size_t words = bits / word_bits();
+    const size_t size = (blocks * bits + CHAR_BIT * sizeof(uint64) - 1) / (CHAR_BIT * sizeof(uint64)) * sizeof(uint64);
+    void* buffer = memory->allocate(size, ZFP_MEMORY_ALIGNMENT);
+    std::memset(word(buffer, blocks * words), 0, size - blocks * words * word_bytes());
+    const ptrdiff_t n = static_cast<ptrdiff_t>(blocks);
+#ifdef _OPENMP
+    #pragma omp parallel for if (n > 1)
+#endif
+    for (ptrdiff_t b = 0; b < n; b++) {
+      size_t block_index = size_t(b);
+      size_t count = std::min(length(block_index), words);
+      uchar* dst = static_cast<uchar*>(word(buffer, layout.position(block_index) * words));
+      std::memcpy(dst, word(data, offset(block_index) / word_bits()), count * word_bytes());
+      std::memset(dst + count * word_bytes(), 0, (words - count) * word_bytes());
+    }
+    release();
+    data = buffer;
+    bytes = size;
+    index.free();
+    used = 0;
+    garbage = 0;
+    compression_mode = zfp_mode_fixed_rate;
+    bits_per_block = bits;
+    budget = 0;
+  }
+
+  // adopt compression parameters and allocator of s and lay out blocks such
+  // that block b reuses the compressed bits of block source[b] of s, or is
+  // zero if source[b] is npos
+  void relocate(const BlockStore& s, const std::vector<size_t>& source)
+  {
+    bits_per_block = s.bits_per_block;
+    compression_mode = s.compression_mode;
+    precision = s.precision;
+    tolerance = s.tolerance;
+    budget = s.budget;
+    memory = s.memory;
+    layout.set_order(s.layout.order());
+    const size_t blocks = source.size();
+    if (!variable()) {
+      alloc(blocks, true);
+      const size_t words = bits_per_block / word_bits();
+      for (size_t b = 0; b < blocks; b++)
+        if (source[b] != npos)
+          std::memcpy(word(data, offset(b) / word_bits()), word(s.data, s.offset(source[b]) / word_bits()), words * word_bytes());
+    }
+    else {
+      // zero blocks occupy one word
+      index.resize(blocks);
+      used = 0;
+      garbage = 0;
+      for (size_t b = 0; b < blocks; b++)
+        used += source[b] != npos ? s.length(source[b]) : 1;
+      bytes = (used + staging_words()) * word_bytes();
+      release();
+      zfp::reallocate_aligned(data, bytes, ZFP_MEMORY_ALIGNMENT, memory);
+      std::memset(data, 0, bytes);
+      for (size_t b = 0, offset = 0; b < blocks; b++) {
+        size_t length = 1;
+        if (source[b] != npos) {
+          length = s.length(source[b]);
+          std::memcpy(word(data, offset), word(s.data, s.offset(source[b]) / word_bits()), length * word_bytes());
+        }
+        index.set(b, offset, length);
+        offset += length;
+      }
+    }
+  }
+
+  // lay out the given number of fixed-rate blocks in memory in given order
+  void reorder(size_t blocks, block_order order)
+  {
+    BlockLayout old = layout;
+    layout.set_order(order);
+    if (variable() || !data || order == old.order())
+      return;
+    // snapshots keep the blocks where they were
+    detach_snapshots();
+    const size_t words = bits_per_block / word_bits();
+    void* buffer = memory->allocate(bytes, ZFP_MEMORY_ALIGNMENT);
+    std::memset(word(buffer, blocks * words), 0, bytes - blocks * words * word_bytes());
+    const ptrdiff_t n = static_cast<ptrdiff_t>(blocks);
+#ifdef _OPENMP
+    #pragma omp parallel for if (n > 1)
+#endif
+    for (ptrdiff_t b = 0; b < n; b++) {
+      size_t block_index = size_t(b);
+      std::memcpy(word(buffer, layout.position(block_index) * words), word(data, old.position(block_index) * words), words * word_bytes());
+    }
+    release();
+    data = buffer;
+  }
+
   // free block store
   void free()
   {
+    detach_snapshots();
     if (data) {
-      zfp::deallocate_aligned(data);
-      data = 0;
+      release();
       bytes = 0;
     }
+    index.free();
+    used = 0;
+    garbage = 0;
+  }
+
+  // copy block to snapshots that still share it before it is modified
+  void preserve(size_t block_index) const
+  {
+    for (size_t i = 0; i < snapshots.size(); i++) {
+      BlockSnapshot* s = snapshots[i];
+      s->lock();
+      if (!s->retired && !s->block[block_index])
+        s->preserve(block_index, word(data, offset(block_index) / word_bits()), length(block_index) * word_bytes());
+      s->unlock();
+    }
+  }
+
+  // copy all shared blocks to snapshots before blocks are discarded
+  void detach_snapshots()
+  {
+    prune_snapshots();
+    for (size_t i = 0; i < snapshots.size(); i++) {
+      BlockSnapshot* s = snapshots[i];
+      s->lock();
+      for (size_t block_index = 0; block_index < s->block.size(); block_index++)
+        if (!s->block[block_index])
+          s->preserve(block_index, word(data, offset(block_index) / word_bits()), length(block_index) * word_bytes());
+      s->store = 0;
+      s->unlock();
+    }
+    snapshots.clear();
+  }
+
+  // delete snapshots retired by other threads
+  void prune_snapshots() const
+  {
+    for (size_t i = 0; i < snapshots.size();) {
+      BlockSnapshot* s = snapshots[i];
+      s->lock();
+      bool retired = s->retired;
+      s->unlock();
+      if (retired) {
+        snapshots.erase(snapshots.begin() + ptrdiff_t(i));
+        s->store = 0;
+        delete s;
+      }
+      else
+        i++;
+    }
+  }
+
+  // deallocate owned or forget borrowed compressed blocks
+  void release()
+  {
+    if (owner)
+      zfp::deallocate_aligned(data, memory);
+    data = 0;
+    owner = true;
   }
 
   // bit offset to block store
-  size_t offset(size_t block_index) const { return block_index * bits_per_block; }
+  size_t offset(size_t block_index) const
+  {
+    return variable() ? index.offset(block_index) * word_bits() : layout.position(block_index) * bits_per_block;
+  }
+
+  // length of block in number of words
+  size_t length(size_t block_index) const
+  {
+    return variable() ? index.length(block_index) : bits_per_block / word_bits();
+  }
+
+  // bit offset to staging area for encoding one variable-length block
+  template <class Codec>
+  size_t reserve(Codec* codec) const
+  {
+    size_t capacity = bytes / word_bytes();
+    if (used + staging_words() > capacity) {
+      // grow store geometrically
+      capacity = std::max(2 * capacity, used + staging_words());
+      void* buffer = memory->allocate(capacity * word_bytes(), ZFP_MEMORY_ALIGNMENT);
+      std::memcpy(buffer, data, used * word_bytes());
+      zfp::deallocate_aligned(data, memory);
+      data = buffer;
+      bytes = capacity * word_bytes();
+      codec->open(data, bytes);
+    }
+    return used * word_bits();
+  }
+
+  // move block of given size in bits from staging area to its permanent location
+  template <class Codec>
+  void commit(Codec* codec, size_t block_index, size_t bits) const
+  {
+    size_t words = bits / word_bits();
+    size_t length = index.length(block_index);
+    if (words <= length) {
+      // overwrite block in place; any unused words become garbage
+      size_t offset = index.offset(block_index);
+      std::memmove(word(data, offset), word(data, used), words * word_bytes());
+      index.set(block_index, offset, words);
+      garbage += length - words;
+    }
+    else {
+      // append block to store and retire its previous storage
+      index.set(block_index, used, words);
+      used += words;
+      garbage += length;
+    }
+    // compact store when most of it is garbage
+    if (2 * garbage > used)
+      compact(codec);
+  }
+
+  // pass hint that blocks with given indices will (or will not) be accessed
+  // soon to the allocator, coalescing their storage into contiguous ranges
+  void advise(const std::vector<size_t>& blocks, bool needed) const
+  {
+    // borrowed storage does not come from the allocator
+    if (!data || !owner || blocks.empty())
+      return;
+    std::vector<std::pair<size_t, size_t> > range(blocks.size());
+    for (size_t i = 0; i < blocks.size(); i++) {
+      size_t begin = offset(blocks[i]) / word_bits();
+      range[i] = std::make_pair(begin, begin + length(blocks[i]));
+    }
+    std::sort(range.begin(), range.end());
+    size_t begin = range[0].first;
+    size_t end = range[0].second;
+    for (size_t i = 1; i <= range.size(); i++) {
+      if (i < range.size() && range[i].first <= end)
+        end = std::max(end, range[i].second);
+      else {
+        memory->advise(word(data, begin), (end - begin) * word_bytes(), needed);
+        if (i < range.size()) {
+          begin = range[i].first;
+          end = range[i].second;
+        }
+      }
+    }
+  }
+
+  // number of bits of live compressed data in variable-rate mode
+  size_t compressed_bits() const { return (used - garbage) * word_bits(); }
+
+  // index of nonexistent block
+  static const size_t npos = size_t(-1);
+
+  // stream word size in bits and bytes
+  static size_t word_bits() { return stream_alignment(); }
+  static size_t word_bytes() { return stream_alignment() / CHAR_BIT; }
+
+  // number of words reserved for encoding one block of at most ZFP_MAX_BITS bits
+  static size_t staging_words() { return (ZFP_MAX_BITS + word_bits() - 1) / word_bits(); }
+
+  // pointer to word with given offset
+  static void* word(void* buffer, size_t offset) { return static_cast<uchar*>(buffer) + offset * word_bytes(); }
 
   // shape 0 <= m <= 3 of block containing index i, 0 <= i <= n - 1
   static uint shape_code(size_t i, size_t n)
@@ -64,11 +697,95 @@ protected:
     return static_cast<uint>(m);
   }
 
-  uint bits_per_block; // number of bits of compressed storage per block
-  void* data;          // pointer to compressed blocks
-  size_t bytes;        // compressed data size
+  uint bits_per_block;       // number of bits of compressed storage per block
+  mutable void* data;        // pointer to compressed blocks
+  mutable size_t bytes;      // compressed data size
+  zfp_mode compression_mode; // fixed-rate or variable-rate compression mode
+  uint precision;            // uncompressed bits per value in fixed-precision mode
+  mutable double tolerance;  // absolute error tolerance in fixed-accuracy mode
+  size_t budget;             // bytes of compressed blocks (zero if unlimited)
+  mutable BlockIndex index;  // word offsets and lengths of variable-length blocks
+  BlockLayout layout;        // order of fixed-rate blocks in memory
+  mutable size_t used;       // number of words in use by blocks, including garbage
+  mutable size_t garbage;    // number of words held by stale blocks
+  mutable bool owner;        // false if data is borrowed from the caller
+  allocator* memory;         // allocator of compressed storage
+  mutable std::vector<BlockSnapshot*> snapshots; // snapshots sharing blocks
+
+private:
+  friend class BlockSnapshot;
 };
 
+inline
+BlockSnapshot::BlockSnapshot(const BlockStore* store, size_t blocks) :
+  store(store),
+  block(blocks, static_cast<uchar*>(0)),
+  length(blocks, 0),
+  retired(false)
+{
+  store->prune_snapshots();
+  store->snapshots.push_back(this);
+}
+
+inline
+BlockSnapshot::BlockSnapshot(const BlockSnapshot& s) :
+  store(s.store),
+  block(s.block.size(), static_cast<uchar*>(0)),
+  length(s.length),
+  retired(false)
+{
+  for (size_t i = 0; i < block.size(); i++)
+    if (s.block[i]) {
+      block[i] = static_cast<uchar*>(zfp::allocate(length[i]));
+      std::memcpy(block[i], s.block[i], length[i]);
+    }
+  if (store)
+    store->snapshots.push_back(this);
+}
+
+inline
+BlockSnapshot::~BlockSnapshot()
+{
+  if (store) {
+    std::vector<BlockSnapshot*>& list = store->snapshots;
+    list.erase(std::find(list.begin(), list.end(), this));
+  }
+  free();
+}
+
+inline void
+BlockSnapshot::retire()
+{
+  lock();
+  bool shared = store != 0;
+  if (shared) {
+    retired = true;
+    free();
+  }
+  unlock();
+  if (!shared)
+    delete this;
+}
+
+inline size_t
+BlockSnapshot::read(size_t first, size_t count, void* dst) const
+{
+  uchar* p = static_cast<uchar*>(dst);
+  lock();
+  for (size_t block_index = first; block_index < first + count; block_index++) {
+    const void* src = block[block_index];
+    size_t bytes = length[block_index];
+    if (!src) {
+      src = store->word(store->data, store->offset(block_index) / store->word_bits());
+      bytes = store->length(block_index) * store->word_bytes();
+    }
+    std::memcpy(p, src, bytes);
+    p += bytes;
+  }
+  unlock();
+  return size_t(p - static_cast<uchar*>(dst));
+}
+
 }
 
 #endif
@@ -2,6 +2,7 @@
 #define ZFP_STORE2_H
 
 #include "zfp/store.h"
+#include "zfp/codecpool.h"
 #include "zfp/memory.h"
 
 namespace zfp {
@@ -29,6 +30,18 @@ public:
   // destructor
   ~BlockStore2() { free(); }
 
+#if defined(__cplusplus) && __cplusplus >= 201103L
+  // move constructor--transfers compressed storage in constant time
+  BlockStore2(BlockStore2&& s) : BlockStore2() { swap(s); }
+
+  // move assignment operator--exchanges contents with s
+  BlockStore2& operator=(BlockStore2&& s)
+  {
+    swap(s);
+    return *this;
+  }
+#endif
+
   // perform a deep copy
   void deep_copy(const BlockStore2& s)
   {
@@ -40,6 +53,16 @@ public:
     by = s.by;
   }
 
+  // exchange contents with another store in constant time
+  void swap(BlockStore2& s)
+  {
+    BlockStore::swap(s);
+    std::swap(nx, s.nx);
+    std::swap(ny, s.ny);
+    std::swap(bx, s.bx);
+    std::swap(by, s.by);
+  }
+
   // rate in bits per value
   double rate() const { return double(bits_per_block) / block_size; }
 
@@ -53,6 +76,18 @@ public:
     return rate;
   }
 
+  // lower rate in bits per value, preserving contents by truncating
+  // compressed blocks
+  double set_rate_preserving(double rate)
+  {
+    rate = Codec::nearest_rate(rate);
+    transcode(blocks(), uint(rate * block_size));
+    return rate;
+  }
+
+  // configure codec for current rate
+  void configure(Codec* codec) const { codec->set_rate(rate()); }
+
   // resize array
   void resize(size_t nx, size_t ny, bool clear = true)
   {
@@ -70,6 +105,52 @@ public:
     }
   }
 
+  // resize array while preserving values where the old and new domains
+  // overlap; compressed blocks are moved rather than recompressed, except for
+  // partial blocks along the old boundary whose shape changes
+  void resize_preserving(size_t nx, size_t ny)
+  {
+    if (!blocks() || !nx || !ny) {
+      resize(nx, ny);
+      return;
+    }
+    BlockStore2 old;
+    swap(old);
+    this->nx = nx;
+    this->ny = ny;
+    bx = (nx + 3) / 4;
+    by = (ny + 3) / 4;
+    // map each new block to the old block at the same position
+    std::vector<size_t> source(blocks(), size_t(npos));
+    std::vector<size_t> from, to;
+    for (size_t j = 0; j < std::min(by, old.by); j++)
+      for (size_t i = 0; i < std::min(bx, old.bx); i++) {
+        size_t b = i + bx * j;
+        size_t a = i + old.bx * j;
+        uint m = old.shape(a);
+        if (m && m != shape(b)) {
+          from.push_back(a);
+          to.push_back(b);
+        }
+        else
+          source[b] = a;
+      }
+    relocate(old, source);
+    // re-encode partial blocks with zeros in place of padding
+    if (!to.empty()) {
+      Codec src(old.compressed_data(), old.compressed_size());
+      Codec dst(compressed_data(), compressed_size());
+      src.set_rate(old.rate());
+      dst.set_rate(rate());
+      for (size_t n = 0; n < to.size(); n++) {
+        Scalar block[block_size];
+        std::fill(block, block + block_size, Scalar(0));
+        old.decode(&src, from[n], block, 1, 4);
+        encode(&dst, to[n], block);
+      }
+    }
+  }
+
   // total number of blocks
   size_t blocks() const { return bx * by; }
 
@@ -83,27 +164,34 @@ public:
   // encoding of block dimensions
   uint block_shape(size_t block_index) const { return shape(block_index); }
 
+  // codec of calling thread, configured and attached to compressed storage
+  Codec* codec() const { return codecs.get(*this); }
+
   // encode contiguous block with given index
   size_t encode(Codec* codec, size_t block_index, const Scalar* block) const
   {
+    acquire(codec);
     return codec->encode_block(offset(block_index), shape(block_index), block);
   }
 
   // encode block with given index from strided array
   size_t encode(Codec* codec, size_t block_index, const Scalar* p, ptrdiff_t sx, ptrdiff_t sy) const
   {
+    acquire(codec);
     return codec->encode_block_strided(offset(block_index), shape(block_index), p, sx, sy);
   }
 
   // decode contiguous block with given index
   size_t decode(Codec* codec, size_t block_index, Scalar* block) const
   {
+    attach(codec);
     return codec->decode_block(offset(block_index), shape(block_index), block);
   }
 
   // decode block with given index to strided array
   size_t decode(Codec* codec, size_t block_index, Scalar* p, ptrdiff_t sx, ptrdiff_t sy) const
   {
+    attach(codec);
     return codec->decode_block_strided(offset(block_index), shape(block_index), p, sx, sy);
   }
 
@@ -122,6 +210,7 @@ protected:
 
   size_t nx, ny; // array dimensions
   size_t bx, by; // array dimensions in number of blocks
+  CodecPool<Codec> codecs; // per-thread codecs
 };
 
 }
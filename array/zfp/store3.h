@@ -1,7 +1,9 @@
 #ifndef ZFP_STORE3_H
 #define ZFP_STORE3_H
 
+#include <cmath>
 #include "zfp/store.h"
+#include "zfp/codecpool.h"
 #include "zfp/memory.h"
 
 namespace zfp {
@@ -25,12 +27,25 @@ public:
     by((ny + 3) / 4),
     bz((nz + 3) / 4)
   {
+    layout.resize(bx, by, bz);
     set_rate(rate);
   }
 
   // destructor
   ~BlockStore3() { free(); }
 
+#if defined(__cplusplus) && __cplusplus >= 201103L
+  // move constructor--transfers compressed storage in constant time
+  BlockStore3(BlockStore3&& s) : BlockStore3() { swap(s); }
+
+  // move assignment operator--exchanges contents with s
+  BlockStore3& operator=(BlockStore3&& s)
+  {
+    swap(s);
+    return *this;
+  }
+#endif
+
   // perform a deep copy
   void deep_copy(const BlockStore3& s)
   {
@@ -44,19 +59,127 @@ public:
     bz = s.bz;
   }
 
-  // rate in bits per value
-  double rate() const { return double(bits_per_block) / block_size; }
+  // exchange contents with another store in constant time
+  void swap(BlockStore3& s)
+  {
+    BlockStore::swap(s);
+    std::swap(nx, s.nx);
+    std::swap(ny, s.ny);
+    std::swap(nz, s.nz);
+    std::swap(bx, s.bx);
+    std::swap(by, s.by);
+    std::swap(bz, s.bz);
+  }
+
+  // rate in bits per value (average over all blocks in variable-rate modes)
+  double rate() const
+  {
+    if (!variable())
+      return double(bits_per_block) / block_size;
+    return blocks() ? double(compressed_bits()) / (blocks() * block_size) : 0.0;
+  }
 
   // set rate in bits per value
   double set_rate(double rate)
   {
     free();
+    compression_mode = zfp_mode_fixed_rate;
+    budget = 0;
     rate = Codec::nearest_rate(rate);
     bits_per_block = uint(rate * block_size);
     alloc(blocks(), true);
     return rate;
   }
 
+  // lower rate in bits per value, preserving contents by truncating
+  // compressed blocks
+  double set_rate_preserving(double rate)
+  {
+    rate = Codec::nearest_rate(rate);
+    transcode(blocks(), uint(rate * block_size));
+    return rate;
+  }
+
+  // set precision in uncompressed bits per value
+  uint set_precision(uint precision)
+  {
+    free();
+    compression_mode = zfp_mode_fixed_precision;
+    bits_per_block = 0;
+    budget = 0;
+    this->precision = std::min(precision, uint(CHAR_BIT * sizeof(Scalar)));
+    alloc(blocks(), true);
+    return this->precision;
+  }
+
+  // set absolute error tolerance
+  double set_accuracy(double tolerance)
+  {
+    free();
+    compression_mode = zfp_mode_fixed_accuracy;
+    bits_per_block = 0;
+    budget = 0;
+    this->tolerance = tolerance;
+    alloc(blocks(), true);
+    return tolerance;
+  }
+
+  // limit compressed blocks to given number of bytes in fixed-accuracy mode,
+  // whose tolerance starts at zero and is raised whenever the blocks exceed
+  // the budget
+  size_t set_budget(size_t bytes)
+  {
+    free();
+    compression_mode = zfp_mode_fixed_accuracy;
+    bits_per_block = 0;
+    budget = bytes;
+    tolerance = 0;
+    alloc(blocks(), true);
+    return budget;
+  }
+
+  // budget in bytes of compressed blocks (zero if unlimited)
+  size_t budget_size() const { return budget; }
+
+  // current absolute error tolerance in fixed-accuracy mode
+  double accuracy() const { return tolerance; }
+
+  // enable reversible (lossless) compression
+  void set_reversible()
+  {
+    free();
+    compression_mode = zfp_mode_reversible;
+    bits_per_block = 0;
+    budget = 0;
+    alloc(blocks(), true);
+  }
+
+  // order of fixed-rate blocks in memory
+  zfp::block_order block_order() const { return layout.order(); }
+
+  // lay out fixed-rate blocks in memory in given order, moving existing
+  // blocks without recompression
+  void set_block_order(zfp::block_order order) { reorder(blocks(), order); }
+
+  // configure codec for current compression mode
+  void configure(Codec* codec) const
+  {
+    switch (compression_mode) {
+      case zfp_mode_fixed_precision:
+        codec->set_precision(precision);
+        break;
+      case zfp_mode_fixed_accuracy:
+        codec->set_accuracy(tolerance);
+        break;
+      case zfp_mode_reversible:
+        codec->set_reversible();
+        break;
+      default:
+        codec->set_rate(rate());
+        break;
+    }
+  }
+
   // resize array
   void resize(size_t nx, size_t ny, size_t nz, bool clear = true)
   {
@@ -72,10 +195,61 @@ public:
       bx = (nx + 3) / 4;
       by = (ny + 3) / 4;
       bz = (nz + 3) / 4;
+      layout.resize(bx, by, bz);
       alloc(blocks(), clear);
     }
   }
 
+  // resize array while preserving values where the old and new domains
+  // overlap; compressed blocks are moved rather than recompressed, except for
+  // partial blocks along the old boundary whose shape changes
+  void resize_preserving(size_t nx, size_t ny, size_t nz)
+  {
+    if (!blocks() || !nx || !ny || !nz) {
+      resize(nx, ny, nz);
+      return;
+    }
+    BlockStore3 old;
+    swap(old);
+    this->nx = nx;
+    this->ny = ny;
+    this->nz = nz;
+    bx = (nx + 3) / 4;
+    by = (ny + 3) / 4;
+    bz = (nz + 3) / 4;
+    layout.resize(bx, by, bz);
+    // map each new block to the old block at the same position
+    std::vector<size_t> source(blocks(), size_t(npos));
+    std::vector<size_t> from, to;
+    for (size_t k = 0; k < std::min(bz, old.bz); k++)
+      for (size_t j = 0; j < std::min(by, old.by); j++)
+        for (size_t i = 0; i < std::min(bx, old.bx); i++) {
+          size_t b = i + bx * (j + by * k);
+          size_t a = i + old.bx * (j + old.by * k);
+          uint m = old.shape(a);
+          if (m && m != shape(b)) {
+            from.push_back(a);
+            to.push_back(b);
+          }
+          else
+            source[b] = a;
+        }
+    relocate(old, source);
+    // re-encode partial blocks with zeros in place of padding
+    if (!to.empty()) {
+      Codec src(old.compressed_data(), old.compressed_size());
+      Codec dst(compressed_data(), compressed_size());
+      old.configure(&src);
+      configure(&dst);
+      for (size_t n = 0; n < to.size(); n++) {
+        Scalar block[block_size];
+        std::fill(block, block + block_size, Scalar(0));
+        old.decode(&src, from[n], block, 1, 4, 16);
+        encode(&dst, to[n], block);
+      }
+    }
+  }
+
   // total number of blocks
   size_t blocks() const { return bx * by * bz; }
 
@@ -90,31 +264,206 @@ public:
   // encoding of block dimensions
   uint block_shape(size_t block_index) const { return shape(block_index); }
 
+  // codec of calling thread, configured and attached to compressed storage
+  Codec* codec() const { return codecs.get(*this); }
+
   // encode contiguous block with given index
   size_t encode(Codec* codec, size_t block_index, const Scalar* block) const
   {
-    return codec->encode_block(offset(block_index), shape(block_index), block);
+    preserve(block_index);
+    acquire(codec);
+    if (!variable())
+      return codec->encode_block(offset(block_index), shape(block_index), block);
+    size_t size = codec->encode_block(reserve(codec), shape(block_index), block);
+    commit(codec, block_index, size);
+    if (over_budget())
+      fit_budget(codec);
+    return size;
   }
 
   // encode block with given index from strided array
   size_t encode(Codec* codec, size_t block_index, const Scalar* p, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz) const
   {
-    return codec->encode_block_strided(offset(block_index), shape(block_index), p, sx, sy, sz);
+    preserve(block_index);
+    acquire(codec);
+    if (!variable())
+      return codec->encode_block_strided(offset(block_index), shape(block_index), p, sx, sy, sz);
+    size_t size = codec->encode_block_strided(reserve(codec), shape(block_index), p, sx, sy, sz);
+    commit(codec, block_index, size);
+    if (over_budget())
+      fit_budget(codec);
+    return size;
   }
 
   // decode contiguous block with given index
   size_t decode(Codec* codec, size_t block_index, Scalar* block) const
   {
+    if (budget)
+      configure(codec);
+    attach(codec);
     return codec->decode_block(offset(block_index), shape(block_index), block);
   }
 
   // decode block with given index to strided array
   size_t decode(Codec* codec, size_t block_index, Scalar* p, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz) const
   {
+    if (budget)
+      configure(codec);
+    attach(codec);
     return codec->decode_block_strided(offset(block_index), shape(block_index), p, sx, sy, sz);
   }
 
+  // decode transform coefficients and common exponent of block with given index
+  template <typename Int>
+  size_t decode_coefficients(Codec* codec, size_t block_index, Int* coeff, int& emax) const
+  {
+    attach(codec);
+    return codec->decode_block_coefficients(offset(block_index), coeff, emax);
+  }
+
+  // decode (2^level)^3 sub-block averages of full block with given index
+  size_t decode_lod(Codec* codec, size_t block_index, Scalar* block, uint level) const
+  {
+    if (budget)
+      configure(codec);
+    attach(codec);
+    return codec->decode_block_lod(offset(block_index), block, level);
+  }
+
+  // encode transform coefficients of fixed-rate block with given index in place
+  template <typename Int>
+  size_t encode_coefficients(Codec* codec, size_t block_index, const Int* coeff, int emax) const
+  {
+    preserve(block_index);
+    acquire(codec);
+    return codec->encode_block_coefficients(offset(block_index), coeff, emax);
+  }
+
+  // number of bytes needed to pack blocks overlapping box of mx * my * mz
+  // values at (x, y, z)
+  size_t packed_size(size_t x, size_t y, size_t z, size_t mx, size_t my, size_t mz) const
+  {
+    size_t size = 0;
+    if (mx && my && mz)
+      for (size_t k = z / 4; k < std::min((z + mz + 3) / 4, bz); k++)
+        for (size_t j = y / 4; j < std::min((y + my + 3) / 4, by); j++)
+          for (size_t i = x / 4; i < std::min((x + mx + 3) / 4, bx); i++)
+            size += BlockStore::packed_size(i + bx * (j + by * k));
+    return size;
+  }
+
+  // copy compressed blocks overlapping box, in raster order, to buffer and
+  // return number of bytes copied
+  size_t pack(void* buffer, size_t x, size_t y, size_t z, size_t mx, size_t my, size_t mz) const
+  {
+    uchar* p = static_cast<uchar*>(buffer);
+    if (mx && my && mz)
+      for (size_t k = z / 4; k < std::min((z + mz + 3) / 4, bz); k++)
+        for (size_t j = y / 4; j < std::min((y + my + 3) / 4, by); j++)
+          for (size_t i = x / 4; i < std::min((x + mx + 3) / 4, bx); i++)
+            p += BlockStore::pack(i + bx * (j + by * k), p);
+    return static_cast<size_t>(p - static_cast<uchar*>(buffer));
+  }
+
+  // replace compressed blocks overlapping box with blocks packed from a box
+  // spanning as many blocks, and return number of bytes consumed
+  size_t unpack(Codec* codec, const void* buffer, size_t x, size_t y, size_t z, size_t mx, size_t my, size_t mz) const
+  {
+    const uchar* p = static_cast<const uchar*>(buffer);
+    if (mx && my && mz)
+      for (size_t k = z / 4; k < std::min((z + mz + 3) / 4, bz); k++)
+        for (size_t j = y / 4; j < std::min((y + my + 3) / 4, by); j++)
+          for (size_t i = x / 4; i < std::min((x + mx + 3) / 4, bx); i++)
+            p += BlockStore::unpack(codec, i + bx * (j + by * k), p);
+    return static_cast<size_t>(p - static_cast<const uchar*>(buffer));
+  }
+
+  // pass hint that compressed blocks overlapping box of mx * my * mz values
+  // at (x, y, z) will (or will not) be accessed soon to the allocator
+  void advise(size_t x, size_t y, size_t z, size_t mx, size_t my, size_t mz, bool needed) const
+  {
+    std::vector<size_t> list;
+    if (mx && my && mz)
+      for (size_t k = z / 4; k < std::min((z + mz + 3) / 4, bz); k++)
+        for (size_t j = y / 4; j < std::min((y + my + 3) / 4, by); j++)
+          for (size_t i = x / 4; i < std::min((x + mx + 3) / 4, bx); i++)
+            list.push_back(i + bx * (j + by * k));
+    BlockStore::advise(list, needed);
+  }
+
 protected:
+  // true if compressed blocks exceed memory budget
+  bool over_budget() const { return budget && compressed_bits() > CHAR_BIT * budget; }
+
+  // raise tolerance and re-encode all blocks until they fit the budget with
+  // some headroom; blocks still all zero, which occupy one word, are assumed
+  // to be written later with as many bits as the average block written so
+  // far, so that filling an array one block at a time triggers few passes;
+  // the number of factors of two by which to raise the tolerance is
+  // estimated from the bits shed per factor of two, which starts out at its
+  // upper bound of one bit per value, but at most doubles from one pass to
+  // the next, as passes that drop only a few bit planes may shed far fewer
+  // bits than later ones; blocks whose values are small relative to the
+  // tolerance, e.g., smooth or nearly constant blocks, lose precision first;
+  // codec is reconfigured for the final tolerance
+  void fit_budget(Codec* codec) const
+  {
+    // blocks are decoded with the tolerance they were encoded with
+    Codec src(compressed_data(), compressed_size());
+    const double target = double(CHAR_BIT) * double(budget - budget / 8);
+    size_t written = 0;
+    for (size_t b = 0; b < blocks(); b++)
+      if (length(b) > 1)
+        written++;
+    if (!written)
+      return;
+    const double scale = double(blocks()) / double(written);
+    double shed = double(blocks() * block_size);
+    int step = 0;
+    int e;
+    if (tolerance > 0) {
+      // tolerance is a power of two
+      std::frexp(tolerance, &e);
+      e--;
+    }
+    else {
+      // first pass starts from a tolerance that loses no precision
+      double max = 0;
+      configure(&src);
+      for (size_t b = 0; b < blocks(); b++) {
+        Scalar block[block_size];
+        decode(&src, b, block);
+        for (size_t i = 0; i < block_size; i++)
+          max = std::max(max, double(std::fabs(block[i])));
+      }
+      std::frexp(max, &e);
+      e -= int(CHAR_BIT * sizeof(Scalar));
+    }
+    for (double bits = scale * double(compressed_bits()); bits > target;) {
+      double estimate = std::ceil((bits - target) / shed);
+      step = step ? int(std::min(estimate, 2.0 * step)) : int(estimate);
+      step = std::max(step, 1);
+      configure(&src);
+      e += step;
+      tolerance = std::ldexp(1.0, e);
+      configure(codec);
+      for (size_t b = 0; b < blocks(); b++) {
+        Scalar block[block_size];
+        preserve(b);
+        attach(&src);
+        src.decode_block(offset(b), shape(b), block);
+        acquire(codec);
+        commit(codec, b, codec->encode_block(reserve(codec), shape(b), block));
+      }
+      // stop once blocks no longer shrink, e.g., if budget is below minimum
+      double size = scale * double(compressed_bits());
+      if (size >= bits)
+        break;
+      shed = (bits - size) / step;
+      bits = size;
+    }
+  }
+
   // shape of block with given global block index
   uint shape(size_t block_index) const
   {
@@ -131,6 +480,7 @@ protected:
 
   size_t nx, ny, nz; // array dimensions
   size_t bx, by, bz; // array dimensions in number of blocks
+  CodecPool<Codec> codecs; // per-thread codecs
 };
 
 }
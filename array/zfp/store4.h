@@ -2,6 +2,7 @@
 #define ZFP_STORE4_H
 
 #include "zfp/store.h"
+#include "zfp/codecpool.h"
 #include "zfp/memory.h"
 
 namespace zfp {
@@ -33,6 +34,18 @@ public:
   // destructor
   ~BlockStore4() { free(); }
 
+#if defined(__cplusplus) && __cplusplus >= 201103L
+  // move constructor--transfers compressed storage in constant time
+  BlockStore4(BlockStore4&& s) : BlockStore4() { swap(s); }
+
+  // move assignment operator--exchanges contents with s
+  BlockStore4& operator=(BlockStore4&& s)
+  {
+    swap(s);
+    return *this;
+  }
+#endif
+
   // perform a deep copy
   void deep_copy(const BlockStore4& s)
   {
@@ -48,6 +61,20 @@ public:
     bw = s.bw;
   }
 
+  // exchange contents with another store in constant time
+  void swap(BlockStore4& s)
+  {
+    BlockStore::swap(s);
+    std::swap(nx, s.nx);
+    std::swap(ny, s.ny);
+    std::swap(nz, s.nz);
+    std::swap(nw, s.nw);
+    std::swap(bx, s.bx);
+    std::swap(by, s.by);
+    std::swap(bz, s.bz);
+    std::swap(bw, s.bw);
+  }
+
   // rate in bits per value
   double rate() const { return double(bits_per_block) / block_size; }
 
@@ -61,6 +88,18 @@ public:
     return rate;
   }
 
+  // lower rate in bits per value, preserving contents by truncating
+  // compressed blocks
+  double set_rate_preserving(double rate)
+  {
+    rate = Codec::nearest_rate(rate);
+    transcode(blocks(), uint(rate * block_size));
+    return rate;
+  }
+
+  // configure codec for current rate
+  void configure(Codec* codec) const { codec->set_rate(rate()); }
+
   // resize array
   void resize(size_t nx, size_t ny, size_t nz, size_t nw, bool clear = true)
   {
@@ -82,6 +121,58 @@ public:
     }
   }
 
+  // resize array while preserving values where the old and new domains
+  // overlap; compressed blocks are moved rather than recompressed, except for
+  // partial blocks along the old boundary whose shape changes
+  void resize_preserving(size_t nx, size_t ny, size_t nz, size_t nw)
+  {
+    if (!blocks() || !nx || !ny || !nz || !nw) {
+      resize(nx, ny, nz, nw);
+      return;
+    }
+    BlockStore4 old;
+    swap(old);
+    this->nx = nx;
+    this->ny = ny;
+    this->nz = nz;
+    this->nw = nw;
+    bx = (nx + 3) / 4;
+    by = (ny + 3) / 4;
+    bz = (nz + 3) / 4;
+    bw = (nw + 3) / 4;
+    // map each new block to the old block at the same position
+    std::vector<size_t> source(blocks(), size_t(npos));
+    std::vector<size_t> from, to;
+    for (size_t l = 0; l < std::min(bw, old.bw); l++)
+      for (size_t k = 0; k < std::min(bz, old.bz); k++)
+        for (size_t j = 0; j < std::min(by, old.by); j++)
+          for (size_t i = 0; i < std::min(bx, old.bx); i++) {
+            size_t b = i + bx * (j + by * (k + bz * l));
+            size_t a = i + old.bx * (j + old.by * (k + old.bz * l));
+            uint m = old.shape(a);
+            if (m && m != shape(b)) {
+              from.push_back(a);
+              to.push_back(b);
+            }
+            else
+              source[b] = a;
+          }
+    relocate(old, source);
+    // re-encode partial blocks with zeros in place of padding
+    if (!to.empty()) {
+      Codec src(old.compressed_data(), old.compressed_size());
+      Codec dst(compressed_data(), compressed_size());
+      src.set_rate(old.rate());
+      dst.set_rate(rate());
+      for (size_t n = 0; n < to.size(); n++) {
+        Scalar block[block_size];
+        std::fill(block, block + block_size, Scalar(0));
+        old.decode(&src, from[n], block, 1, 4, 16, 64);
+        encode(&dst, to[n], block);
+      }
+    }
+  }
+
   // total number of blocks
   size_t blocks() const { return bx * by * bz * bw; }
 
@@ -97,27 +188,34 @@ public:
   // encoding of block dimensions
   uint block_shape(size_t block_index) const { return shape(block_index); }
 
+  // codec of calling thread, configured and attached to compressed storage
+  Codec* codec() const { return codecs.get(*this); }
+
   // encode contiguous block with given index
   size_t encode(Codec* codec, size_t block_index, const Scalar* block) const
   {
+    acquire(codec);
     return codec->encode_block(offset(block_index), shape(block_index), block);
   }
 
   // encode block with given index from strided array
   size_t encode(Codec* codec, size_t block_index, const Scalar* p, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz, ptrdiff_t sw) const
   {
+    acquire(codec);
     return codec->encode_block_strided(offset(block_index), shape(block_index), p, sx, sy, sz, sw);
   }
 
   // decode contiguous block with given index
   size_t decode(Codec* codec, size_t block_index, Scalar* block) const
   {
+    attach(codec);
     return codec->decode_block(offset(block_index), shape(block_index), block);
   }
 
   // decode block with given index to strided array
   size_t decode(Codec* codec, size_t block_index, Scalar* p, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz, ptrdiff_t sw) const
   {
+    attach(codec);
     return codec->decode_block_strided(offset(block_index), shape(block_index), p, sx, sy, sz, sw);
   }
 
@@ -140,6 +238,7 @@ protected:
 
   size_t nx, ny, nz, nw; // array dimensions
   size_t bx, by, bz, bw; // array dimensions in number of blocks
+  CodecPool<Codec> codecs; // per-thread codecs
 };
 
 }
@@ -9,18 +9,35 @@ struct trait;
 /*
   static const zfp_type type;    // corresponding zfp type
   static const size_t precision; // precision in number of bits
+  typedef int_type;              // integer type of transform coefficients
 */
 
 template <>
 struct trait<float> {
   static const zfp_type type = zfp_type_float;
   static const size_t precision = CHAR_BIT * sizeof(float);
+  typedef int32 int_type;
 };
 
 template <>
 struct trait<double> {
   static const zfp_type type = zfp_type_double;
   static const size_t precision = CHAR_BIT * sizeof(double);
+  typedef int64 int_type;
+};
+
+template <>
+struct trait<int32> {
+  static const zfp_type type = zfp_type_int32;
+  static const size_t precision = CHAR_BIT * sizeof(int32);
+  typedef int32 int_type;
+};
+
+template <>
+struct trait<int64> {
+  static const zfp_type type = zfp_type_int64;
+  static const size_t precision = CHAR_BIT * sizeof(int64);
+  typedef int64 int_type;
 };
 
 }
@@ -25,6 +25,12 @@ public:
   size_t global_y(size_t j) const { return y + j; }
   size_t global_z(size_t k) const { return z + k; }
 
+  // hint that compressed blocks of (sub)array will be accessed soon
+  void prefetch() const { array->prefetch(x, y, z, nx, ny, nz); }
+
+  // hint that compressed blocks of (sub)array will not be accessed for a while
+  void evict() const { array->evict(x, y, z, nx, ny, nz); }
+
 protected:
   // construction and assignment--perform shallow copy of (sub)array
   explicit preview(container_type* array) : array(array), x(0), y(0), z(0), nx(array->size_x()), ny(array->size_y()), nz(array->size_z()) {}
@@ -74,6 +80,16 @@ public:
   // (i, j, k) inspector
   const_reference operator()(size_t i, size_t j, size_t k) const { return const_reference(this, x + i, y + j, z + k); }
 
+  // apply f(p, i, j, k, mx, my, mz) to each decompressed block intersecting
+  // the view, where p points to view element (i, j, k) and the mx * my * mz
+  // view elements in the block are stored with strides 1, 4, 16
+  template <class Function>
+  Function for_each_block(Function f) const { return array->cache.template visit<const value_type*>(f, false, x, y, z, nx, ny, nz); }
+
+  // decompress view and store at p with strides sx, sy, sz (all zero for
+  // contiguous storage), one block at a time and bypassing the cache
+  void get(value_type* p, ptrdiff_t sx = 0, ptrdiff_t sy = 0, ptrdiff_t sz = 0) const { array->get(p, x, y, z, nx, ny, nz, sx, sy, sz); }
+
   // random access iterators
   const_iterator cbegin() const { return const_iterator(this, x, y, z); }
   const_iterator cend() const { return const_iterator(this, x, y, z + nz); }
@@ -123,6 +139,20 @@ public:
   // (i) mutator
   reference operator()(size_t i, size_t j, size_t k) { return reference(this, x + i, y + j, z + k); }
 
+  // block visitor from base class
+  using const_view<Container>::for_each_block;
+
+  // apply f to each block intersecting the view, allowing f to modify it
+  template <class Function>
+  Function for_each_block(Function f) { return array->cache.template visit<value_type*>(f, true, x, y, z, nx, ny, nz); }
+
+  // bulk copy of view to strided memory from base class
+  void get(value_type* p, ptrdiff_t sx = 0, ptrdiff_t sy = 0, ptrdiff_t sz = 0) const { const_view<Container>::get(p, sx, sy, sz); }
+
+  // copy values stored at p with strides sx, sy, sz (all zero for contiguous
+  // storage) to view, compressing fully covered blocks directly
+  void set(const value_type* p, ptrdiff_t sx = 0, ptrdiff_t sy = 0, ptrdiff_t sz = 0) { array->set(p, x, y, z, nx, ny, nz, sx, sy, sz); }
+
   // random access iterators
   iterator begin() { return iterator(this, x, y, z); }
   iterator end() { return iterator(this, x, y, z + nz); }
@@ -408,11 +438,17 @@ public:
   private_const_view(container_type* array, size_t cache_size = 0) :
     preview<Container>(array),
     cache(array->store, cache_size ? cache_size : array->cache.size())
-  {}
+  {
+    if (!cache_size)
+      fit_cache(array->cache.adaptive_budget());
+  }
   private_const_view(container_type* array, size_t x, size_t y, size_t z, size_t nx, size_t ny, size_t nz, size_t cache_size = 0) :
     preview<Container>(array, x, y, z, nx, ny, nz),
     cache(array->store, cache_size ? cache_size : array->cache.size())
-  {}
+  {
+    if (!cache_size)
+      fit_cache(array->cache.adaptive_budget());
+  }
 
   // dimensions of (sub)array
   size_t size_x() const { return nx; }
@@ -428,9 +464,20 @@ public:
   // empty cache without compressing modified cached blocks
   void clear_cache() const { cache.clear(); }
 
+  // maximum number of bit planes decoded per block
+  uint max_precision() const { return cache.max_precision(); }
+
+  // decode only the first precision bit planes (zero for all) of blocks not
+  // yet cached, trading accuracy for faster reads, and empty the cache
+  uint set_max_precision(uint precision) { return cache.set_max_precision(precision); }
+
   // (i, j, k) inspector
   const_reference operator()(size_t i, size_t j, size_t k) const { return const_reference(this, x + i, y + j, z + k); }
 
+  // apply f to each block intersecting the view using the private cache
+  template <class Function>
+  Function for_each_block(Function f) const { return cache.template visit<const value_type*>(f, false, x, y, z, nx, ny, nz); }
+
   // random access iterators
   const_iterator cbegin() const { return const_iterator(this, x, y, z); }
   const_iterator cend() const { return const_iterator(this, x, y, z + nz); }
@@ -459,6 +506,14 @@ protected:
   // inspector
   value_type get(size_t x, size_t y, size_t z) const { return cache.get(x, y, z); }
 
+  // size cache adaptively within budget, starting with one slab of the
+  // blocks intersecting the view (budget of zero leaves cache size as is)
+  void fit_cache(size_t budget)
+  {
+    if (budget && nx && ny)
+      cache.set_adaptive(budget, (x + nx + 3) / 4 - x / 4, (y + ny + 3) / 4 - y / 4);
+  }
+
   BlockCache3<value_type, codec_type> cache; // cache of decompressed blocks
 };
 
@@ -486,6 +541,8 @@ public:
       partition(y, ny, index, count);
     else
       partition(z, nz, index, count);
+    // refit adaptively sized cache to the partition
+    fit_cache(cache.adaptive_budget());
   }
 
   // flush cache by compressing all modified cached blocks
@@ -497,6 +554,13 @@ public:
   // (i, j, k) mutator
   reference operator()(size_t i, size_t j, size_t k) { return reference(this, x + i, y + j, z + k); }
 
+  // block visitor from base class
+  using private_const_view<Container>::for_each_block;
+
+  // apply f to each block intersecting the view, allowing f to modify it
+  template <class Function>
+  Function for_each_block(Function f) { return cache.template visit<value_type*>(f, true, x, y, z, nx, ny, nz); }
+
   // random access iterators
   iterator begin() { return iterator(this, x, y, z); }
   iterator end() { return iterator(this, x, y, z + nz); }
@@ -524,6 +588,10 @@ protected:
   using private_const_view<Container>::ny;
   using private_const_view<Container>::nz;
   using private_const_view<Container>::cache;
+  using private_const_view<Container>::fit_cache;
+
+  // precision limit applies to read-only views only
+  using private_const_view<Container>::set_max_precision;
 
   // block-aligned partition of [offset, offset + size): index out of count
   static void partition(size_t& offset, size_t& size, size_t index, size_t count)
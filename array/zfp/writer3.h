@@ -0,0 +1,214 @@
+#ifndef ZFP_WRITER3_H
+#define ZFP_WRITER3_H
+
+// asynchronous serialization of 3D arrays (requires C++11)
+
+#if defined(__cplusplus) && __cplusplus >= 201103L
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <future>
+#include <mutex>
+#include <string>
+#include <vector>
+#if defined(__unix__) || defined(__APPLE__)
+  #include <unistd.h>
+  #define ZFP_WITH_FD_WRITER 1
+#endif
+
+namespace zfp {
+namespace internal {
+namespace dim3 {
+
+// snapshot of fixed-rate 3D array whose header and compressed blocks are
+// written by another thread while the array continues to be modified
+template <class Container>
+class async_writer : public BlockSnapshot {
+public:
+  typedef Container container_type;
+  typedef typename container_type::header header_type;
+
+  // freeze array contents (modified cached blocks are compressed first)
+  explicit async_writer(container_type* array) :
+    BlockSnapshot(flushed_store(array), array->store.blocks()),
+    header(*array),
+    block_bytes(static_cast<size_t>(array->rate() * 64) / CHAR_BIT),
+    payload_bytes(array->compressed_size())
+  {}
+
+  // write header and compressed data via f(data, size) in chunks whose
+  // size and address are multiples of alignment; return bytes written
+  // (excluding any zero padding of the last chunk)
+  template <class Function>
+  size_t write(Function& f, size_t alignment)
+  {
+    const size_t capacity = ((chunk_size + alignment - 1) / alignment) * alignment;
+    // buffer aligned on alignment boundary regardless of ZFP_WITH_ALIGNED_ALLOC
+    std::vector<uchar> storage(capacity + alignment);
+    uchar* buffer = storage.data() + (alignment - reinterpret_cast<uintptr_t>(storage.data()) % alignment) % alignment;
+    size_t size = 0;
+    // header
+    std::memcpy(buffer, header.data(), header.size_bytes());
+    size += header.size_bytes();
+    // compressed blocks
+    const size_t blocks = block.size();
+    for (size_t first = 0; first < blocks;) {
+      size_t count = std::min((capacity - size) / block_bytes, blocks - first);
+      if (!count) {
+        size = emit(f, buffer, size, alignment);
+        continue;
+      }
+      size += read(first, count, buffer + size);
+      first += count;
+    }
+    // zero padding of payload to compressed size
+    for (size_t pad = payload_bytes - blocks * block_bytes; pad;) {
+      size_t n = std::min(pad, capacity - size);
+      std::fill(buffer + size, buffer + size + n, uchar(0));
+      size += n;
+      pad -= n;
+      if (size == capacity)
+        size = emit(f, buffer, size, alignment);
+    }
+    // final chunk padded to alignment
+    if (size) {
+      size_t n = ((size + alignment - 1) / alignment) * alignment;
+      std::fill(buffer + size, buffer + n, uchar(0));
+      f(static_cast<const void*>(buffer), n);
+    }
+    return header.size_bytes() + payload_bytes;
+  }
+
+  // release writer allocated via new once it is no longer needed
+  using BlockSnapshot::retire;
+
+  // write snapshot via f on calling thread, then retire it
+  template <class Function>
+  static size_t run(async_writer* writer, Function f, size_t alignment)
+  {
+    size_t bytes;
+    try {
+      bytes = writer->write(f, alignment);
+    }
+    catch (...) {
+      writer->retire();
+      throw;
+    }
+    writer->retire();
+    return bytes;
+  }
+
+protected:
+  static const size_t chunk_size = 0x100000u; // bytes per call to f
+
+  // ensure blocks are stored at fixed rate and compress modified cached blocks
+  static const BlockStore* flushed_store(container_type* array)
+  {
+    if (array->mode() != zfp_mode_fixed_rate)
+      throw zfp::exception("zfp serialization supports only fixed-rate arrays");
+    array->flush_cache();
+    return &array->store;
+  }
+
+  // pass whole aligned chunks of buffer to f and return size of remainder
+  template <class Function>
+  static size_t emit(Function& f, uchar* buffer, size_t size, size_t alignment)
+  {
+    size_t n = size - size % alignment;
+    if (n) {
+      f(static_cast<const void*>(buffer), n);
+      std::memmove(buffer, buffer + n, size - n);
+    }
+    return size - n;
+  }
+
+  // store may be modified by one thread while another thread writes blocks
+  void lock() const { mutex.lock(); }
+  void unlock() const { mutex.unlock(); }
+
+  header_type header;         // serialized array metadata
+  size_t block_bytes;         // bytes per compressed block
+  size_t payload_bytes;       // bytes of compressed data
+  mutable std::mutex mutex;   // guards blocks and store pointer
+};
+
+#ifdef ZFP_WITH_FD_WRITER
+// writes to POSIX file descriptor, optionally opened with O_DIRECT
+class fd_writer {
+public:
+  explicit fd_writer(int fd) : fd(fd) {}
+
+  void operator()(const void* data, size_t size) const
+  {
+    const char* p = static_cast<const char*>(data);
+    while (size) {
+      ssize_t n = ::write(fd, p, size);
+      if (n < 0) {
+        if (errno == EINTR)
+          continue;
+        throw zfp::exception(std::string("zfp write failed: ") + std::strerror(errno));
+      }
+      p += n;
+      size -= size_t(n);
+    }
+  }
+
+protected:
+  int fd; // file descriptor
+};
+#endif
+
+// write header and compressed data of array a via f(data, size) on a
+// background thread; the returned future holds the number of bytes written
+template <class Container, class Function>
+inline std::future<size_t>
+write_async(Container* a, Function f, size_t alignment)
+{
+  async_writer<Container>* writer = new async_writer<Container>(a);
+  try {
+    return std::async(std::launch::async, &async_writer<Container>::template run<Function>, writer, f, alignment);
+  }
+  catch (...) {
+    writer->retire();
+    throw;
+  }
+}
+
+#ifdef ZFP_WITH_FD_WRITER
+// write array a to file descriptor fd at its current offset; with direct
+// I/O, data is written in 4 KB aligned chunks and the file is truncated
+template <class Container>
+inline std::future<size_t>
+write_async(Container* a, int fd, bool direct)
+{
+  if (!direct)
+    return write_async(a, fd_writer(fd), 1);
+  const size_t alignment = 0x1000u;
+  off_t offset = ::lseek(fd, 0, SEEK_CUR);
+  if (offset < 0 || offset % off_t(alignment))
+    throw zfp::exception("zfp direct I/O requires an aligned file offset");
+  async_writer<Container>* writer = new async_writer<Container>(a);
+  try {
+    return std::async(std::launch::async, [writer, fd, offset, alignment]() -> size_t {
+      size_t bytes = async_writer<Container>::run(writer, fd_writer(fd), alignment);
+      // remove zero padding of last aligned chunk
+      if (::ftruncate(fd, offset + off_t(bytes)))
+        throw zfp::exception(std::string("zfp write failed: ") + std::strerror(errno));
+      return bytes;
+    });
+  }
+  catch (...) {
+    writer->retire();
+    throw;
+  }
+}
+#endif
+
+} // dim3
+} // internal
+} // zfp
+
+#endif
+
+#endif
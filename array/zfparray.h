@@ -10,13 +10,20 @@
 
 namespace zfp {
 
+// number of bytes of compressed storage that an array may use, passed in
+// place of a rate to construct arrays whose accuracy adapts to the budget
+struct budget {
+  explicit budget(size_t bytes) : bytes(bytes) {}
+  size_t bytes;
+};
+
 // abstract base class for compressed array of scalars
 class array {
 public:
   #include "zfp/header.h"
 
   // factory function (see zfpfactory.h)
-  static zfp::array* construct(const zfp::array::header& header, const void* buffer = 0, size_t buffer_size_bytes = 0);
+  static zfp::array* construct(const zfp::array::header& header, const void* buffer = 0, size_t buffer_size_bytes = 0, bool borrow = false);
 
   // public virtual destructor (can delete array through base class pointer)
   virtual ~array() {}
@@ -86,6 +93,17 @@ protected:
     nw = a.nw;
   }
 
+  // exchange metadata with another array
+  void swap(array& a)
+  {
+    std::swap(type, a.type);
+    std::swap(dims, a.dims);
+    std::swap(nx, a.nx);
+    std::swap(ny, a.ny);
+    std::swap(nz, a.nz);
+    std::swap(nw, a.nw);
+  }
+
   zfp_type type;         // scalar type
   uint dims;             // array dimensionality (1, 2, 3, or 4)
   size_t nx, ny, nz, nw; // array dimensions
@@ -56,16 +56,22 @@ public:
       set(p);
   }
 
-  // constructor, from previously-serialized compressed array
-  array1(const zfp::array::header& header, const void* buffer = 0, size_t buffer_size_bytes = 0) :
+  // constructor, from previously-serialized compressed array; when borrow
+  // is true, buffer is used in place and copied only once it is modified
+  array1(const zfp::array::header& header, const void* buffer = 0, size_t buffer_size_bytes = 0, bool borrow = false) :
     array(1, Codec::type, header),
-    store(header.size_x(), header.rate()),
+    store(0, header.rate()),
     cache(store)
   {
+    // zero-initialize storage only if no compressed data is given
+    store.resize(nx, !buffer);
     if (buffer) {
       if (buffer_size_bytes && buffer_size_bytes < store.compressed_size())
         throw zfp::exception("buffer size is smaller than required");
-      std::memcpy(store.compressed_data(), buffer, store.compressed_size());
+      if (borrow)
+        store.borrow(buffer);
+      else
+        std::memcpy(store.compressed_data(), buffer, store.compressed_size());
     }
   }
 
@@ -100,6 +106,31 @@ public:
     return *this;
   }
 
+#if defined(__cplusplus) && __cplusplus >= 201103L
+  // move constructor--transfers compressed storage and cache in constant time
+  array1(array1&& a) :
+    array(1, Codec::type),
+    cache(store)
+  {
+    swap(a);
+  }
+
+  // move assignment operator--exchanges contents with a
+  array1& operator=(array1&& a)
+  {
+    swap(a);
+    return *this;
+  }
+#endif
+
+  // exchange contents with another array in constant time
+  void swap(array1& a)
+  {
+    array::swap(a);
+    store.swap(a.store);
+    cache.swap(a.cache);
+  }
+
   // total number of elements in array
   size_t size() const { return nx; }
 
@@ -114,12 +145,27 @@ public:
     cache.clear();
   }
 
+  // resize the array while preserving values where the old and new
+  // domains overlap (new elements are zero); compressed blocks are moved
+  // without recompression except for partial blocks along the old boundary
+  void resize_preserving(size_t nx)
+  {
+    cache.flush();
+    cache.clear();
+    this->nx = nx;
+    store.resize_preserving(nx);
+  }
+
   // rate in bits per value
   double rate() const { return cache.rate(); }
 
   // set rate in bits per value
   double set_rate(double rate) { return cache.set_rate(rate); }
 
+  // lower rate in bits per value without losing contents; compressed blocks
+  // are truncated rather than decompressed and recompressed
+  double set_rate_preserving(double rate) { return cache.set_rate_preserving(rate); }
+
   // number of bytes of compressed data
   size_t compressed_size() const { return store.compressed_size(); }
 
@@ -130,6 +176,12 @@ public:
     return store.compressed_data();
   }
 
+  // true if compressed data resides in a borrowed buffer that is not yet copied
+  bool borrowed() const { return store.borrowed(); }
+
+  // copy borrowed compressed data to storage owned by the array
+  void own() { store.own(); }
+
   // cache size in number of bytes
   size_t cache_size() const { return cache.size(); }
 
@@ -140,6 +192,13 @@ public:
     cache.resize(bytes);
   }
 
+  // set cache line replacement policy and number of lines per set
+  void set_cache_policy(cache_policy policy, uint ways = 4) { cache.set_policy(policy, ways); }
+
+  // allocate compressed storage and cache from given allocator, which must
+  // outlive the array (contents are preserved)
+  void set_allocator(allocator* memory) { cache.set_allocator(memory); }
+
   // empty cache without compressing modified cached blocks
   void clear_cache() const { cache.clear(); }
 
@@ -226,6 +285,8 @@ protected:
 
 typedef array1<float> array1f;
 typedef array1<double> array1d;
+typedef array1<int32> array1i;
+typedef array1<int64> array1l;
 
 }
 
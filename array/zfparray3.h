@@ -13,6 +13,14 @@
 #include "zfp/pointer3.h"
 #include "zfp/iterator3.h"
 #include "zfp/view3.h"
+#include "zfp/range3.h"
+#include "zfp/stencil3.h"
+#include "zfp/snapshot3.h"
+#include "zfp/writer3.h"
+#include "zfp/sharedview3.h"
+#include "zfp/linear3.h"
+#include "zfp/sample3.h"
+#include "zfp/coarsen3.h"
 
 namespace zfp {
 
@@ -42,6 +50,12 @@ public:
   typedef zfp::internal::dim3::nested_view2<array3> nested_view3;
   typedef zfp::internal::dim3::nested_view3<array3> nested_view;
   typedef zfp::internal::dim3::private_view<array3> private_view;
+  typedef zfp::internal::dim3::stencil_view<array3> stencil_view;
+  typedef zfp::internal::dim3::block_range<array3> block_range;
+  typedef zfp::internal::dim3::snapshot_view<array3> snapshot_view;
+#if defined(__cplusplus) && __cplusplus >= 201103L
+  typedef zfp::internal::dim3::shared_const_view<array3> shared_const_view;
+#endif
 
   // default constructor
   array3() :
@@ -63,17 +77,44 @@ public:
       set(p);
   }
 
-  // constructor, from previously-serialized compressed array
-  array3(const zfp::array::header& header, const void* buffer = 0, size_t buffer_size_bytes = 0) :
+  // constructor of nx * ny * nz array whose compressed blocks fit in the
+  // given budget, at least cache_size bytes of cache, and optionally
+  // initialized from flat array p
+  array3(size_t nx, size_t ny, size_t nz, const zfp::budget& budget, const value_type* p = 0, size_t cache_size = 0) :
+    array(3, Codec::type),
+    store(nx, ny, nz, 0.0),
+    cache(store, cache_size)
+  {
+    this->nx = nx;
+    this->ny = ny;
+    this->nz = nz;
+    cache.set_budget(budget.bytes);
+    if (p)
+      set(p);
+  }
+
+  // constructor, from previously-serialized compressed array or fixed-rate
+  // zfp_compress() output; when borrow is true and blocks are word aligned,
+  // buffer is used in place and copied only once it is modified
+  array3(const zfp::array::header& header, const void* buffer = 0, size_t buffer_size_bytes = 0, bool borrow = false) :
     array(3, Codec::type, header),
-    store(header.size_x(), header.size_y(), header.size_z(), header.rate()),
+    store(0, 0, 0, header.rate()),
     cache(store)
   {
-    if (buffer) {
-      if (buffer_size_bytes && buffer_size_bytes < store.compressed_size())
-        throw zfp::exception("buffer size is smaller than required");
-      std::memcpy(store.compressed_data(), buffer, store.compressed_size());
-    }
+    load(header, buffer, 0, buffer_size_bytes, borrow);
+  }
+
+  // constructor, from fixed-rate stream written by zfp_write_header() with
+  // ZFP_HEADER_FULL followed by zfp_compress(), e.g., a memory-mapped file;
+  // when borrow is true and blocks are word aligned, the stream is used in
+  // place and copied only once it is modified
+  array3(const void* stream, size_t stream_size_bytes, bool borrow = false) :
+    array(3, Codec::type, typename Codec::header(stream)),
+    store(0, 0, 0, typename Codec::header(stream).rate()),
+    cache(store)
+  {
+    typename Codec::header header(stream);
+    load(header, stream, CHAR_BIT * header.size_bytes(), stream_size_bytes, borrow);
   }
 
   // copy constructor--performs a deep copy
@@ -109,6 +150,31 @@ public:
     return *this;
   }
 
+#if defined(__cplusplus) && __cplusplus >= 201103L
+  // move constructor--transfers compressed storage and cache in constant time
+  array3(array3&& a) :
+    array(3, Codec::type),
+    cache(store)
+  {
+    swap(a);
+  }
+
+  // move assignment operator--exchanges contents with a
+  array3& operator=(array3&& a)
+  {
+    swap(a);
+    return *this;
+  }
+#endif
+
+  // exchange contents with another array in constant time
+  void swap(array3& a)
+  {
+    array::swap(a);
+    store.swap(a.store);
+    cache.swap(a.cache);
+  }
+
   // total number of elements in array
   size_t size() const { return nx * ny * nz; }
 
@@ -127,12 +193,66 @@ public:
     cache.clear();
   }
 
+  // resize the array while preserving values where the old and new
+  // domains overlap (new elements are zero); compressed blocks are moved
+  // without recompression except for partial blocks along the old boundary
+  void resize_preserving(size_t nx, size_t ny, size_t nz)
+  {
+    cache.flush();
+    cache.clear();
+    this->nx = nx;
+    this->ny = ny;
+    this->nz = nz;
+    store.resize_preserving(nx, ny, nz);
+  }
+
   // rate in bits per value
   double rate() const { return cache.rate(); }
 
   // set rate in bits per value
   double set_rate(double rate) { return cache.set_rate(rate); }
 
+  // lower rate in bits per value without losing contents; compressed blocks
+  // are truncated rather than decompressed and recompressed
+  double set_rate_preserving(double rate) { return cache.set_rate_preserving(rate); }
+
+  // set precision in uncompressed bits per value (variable-rate storage)
+  uint set_precision(uint precision) { return cache.set_precision(precision); }
+
+  // set absolute error tolerance (variable-rate storage)
+  double set_accuracy(double tolerance) { return cache.set_accuracy(tolerance); }
+
+  // enable reversible (lossless) compression (variable-rate storage)
+  void set_reversible() { cache.set_reversible(); }
+
+  // limit compressed storage to given number of bytes, raising the error
+  // tolerance (variable-rate storage) whenever blocks exceed the budget
+  size_t set_budget(size_t bytes) { return cache.set_budget(bytes); }
+
+  // budget in bytes of compressed storage (zero if unlimited)
+  size_t budget() const { return store.budget_size(); }
+
+  // absolute error tolerance in fixed-accuracy mode, which grows as a
+  // budgeted array fills its budget
+  double accuracy() const { return store.accuracy(); }
+
+  // compression mode
+  zfp_mode mode() const { return store.mode(); }
+
+  // reclaim storage held by stale variable-length blocks
+  void compact() { cache.compact(); }
+
+  // order of fixed-rate blocks in compressed storage
+  zfp::block_order block_order() const { return store.block_order(); }
+
+  // lay out fixed-rate blocks in given order; Morton order keeps blocks that
+  // are near in space near in memory, but only raster order matches zfp streams
+  void set_block_order(zfp::block_order order)
+  {
+    cache.flush();
+    store.set_block_order(order);
+  }
+
   // number of bytes of compressed data
   size_t compressed_size() const { return store.compressed_size(); }
 
@@ -143,6 +263,23 @@ public:
     return store.compressed_data();
   }
 
+  // true if compressed data resides in a borrowed buffer that is not yet copied
+  bool borrowed() const { return store.borrowed(); }
+
+  // copy borrowed compressed data to storage owned by the array
+  void own() { store.own(); }
+
+  // partition array into at most n block-aligned ranges, each accessed
+  // through a private cache, e.g., for std::for_each(std::execution::par);
+  // modified cached blocks are compressed first, and the cache should be
+  // cleared once ranges have been modified
+  std::vector<block_range> block_ranges(size_t n)
+  {
+    flush_cache();
+    own();
+    return block_range::partition(this, n);
+  }
+
   // cache size in number of bytes
   size_t cache_size() const { return cache.size(); }
 
@@ -153,42 +290,140 @@ public:
     cache.resize(bytes);
   }
 
+  // set cache line replacement policy and number of lines per set
+  void set_cache_policy(cache_policy policy, uint ways = 4) { cache.set_policy(policy, ways); }
+
+  // allocate compressed storage and cache from given allocator, which must
+  // outlive the array (contents are preserved)
+  void set_allocator(allocator* memory) { cache.set_allocator(memory); }
+
+  // allocate only compressed storage from given allocator, e.g., one backed
+  // by a file, while cache lines stay where they are (contents are preserved)
+  void set_store_allocator(allocator* memory) { cache.set_store_allocator(memory); }
+
+  // hint that compressed blocks overlapping box will be accessed soon
+  void prefetch(size_t x, size_t y, size_t z, size_t nx, size_t ny, size_t nz) const { store.advise(x, y, z, nx, ny, nz, true); }
+
+  // hint that compressed blocks overlapping box will not be accessed for a while
+  void evict(size_t x, size_t y, size_t z, size_t nx, size_t ny, size_t nz) const { store.advise(x, y, z, nx, ny, nz, false); }
+
+  // byte budget of adaptive cache sizing (zero if disabled)
+  size_t cache_budget() const { return cache.adaptive_budget(); }
+
+  // size cache adaptively within budget bytes, starting with one slab of
+  // blocks and growing it when accesses miss often (zero disables); views
+  // with private caches inherit the budget
+  void set_cache_budget(size_t bytes) { cache.set_adaptive(bytes); }
+
+  // set number of blocks to prefetch in block order on a cache miss (zero disables)
+  void set_cache_prefetch(uint blocks) { cache.set_prefetch(blocks); }
+
+  // size in bytes of secondary cache of evicted blocks (zero if disabled)
+  size_t cache_secondary_size() const { return cache.secondary_size(); }
+
+  // set minimum size in bytes of secondary cache holding evicted blocks
+  // rounded to single precision; reads that miss the cache but hit the
+  // secondary cache return rounded values (zero disables)
+  void set_cache_secondary_size(size_t bytes) { cache.set_secondary_size(bytes); }
+
+  // set number of evicted modified blocks to compress as a batch (zero disables)
+  void set_cache_write_behind(uint blocks) { cache.set_write_behind(blocks); }
+
+  // enable or disable skipping compression of modified blocks whose values
+  // are unchanged since they were cached
+  void set_cache_skip_unchanged(bool enable) { cache.set_skip_unchanged(enable); }
+
+  // enable or disable gathering of cache statistics
+  void set_cache_stats(bool enable) { cache.set_stats(enable); }
+
+  // cache statistics gathered since last reset
+  cache_statistics cache_stats() const { return cache.stats(); }
+
+  // zero cache statistics
+  void reset_cache_stats() { cache.reset_stats(); }
+
   // empty cache without compressing modified cached blocks
   void clear_cache() const { cache.clear(); }
 
   // flush cache by compressing all modified cached blocks
   void flush_cache() const { cache.flush(); }
 
+  // read-only snapshot of current contents that shares unmodified blocks
+  snapshot_view snapshot() { return snapshot_view(this); }
+
+#if defined(__cplusplus) && __cplusplus >= 201103L
+  // serialize fixed-rate array on a background thread while it continues to
+  // be modified; header and compressed data, as of this call, are passed to
+  // f(const void* data, size_t size) in chunks whose size is a multiple of
+  // alignment; the future holds the number of bytes written (excluding padding)
+  template <class Function>
+  std::future<size_t> write_async(Function f, size_t alignment = 1)
+  {
+    return zfp::internal::dim3::write_async(this, f, alignment);
+  }
+
+#ifdef ZFP_WITH_FD_WRITER
+  // serialize array to file descriptor at its current offset; for files
+  // opened with O_DIRECT, set direct to write 4 KB aligned chunks
+  std::future<size_t> write_async(int fd, bool direct = false)
+  {
+    return zfp::internal::dim3::write_async(this, fd, direct);
+  }
+#endif
+#endif
+
   // decompress array and store at p
   void get(value_type* p) const
   {
-    const size_t bx = store.block_size_x();
-    const size_t by = store.block_size_y();
-    const size_t bz = store.block_size_z();
     const ptrdiff_t sx = 1;
     const ptrdiff_t sy = static_cast<ptrdiff_t>(nx);
     const ptrdiff_t sz = static_cast<ptrdiff_t>(nx * ny);
-    size_t block_index = 0;
-    for (size_t k = 0; k < bz; k++, p += 4 * nx * (ny - by))
-      for (size_t j = 0; j < by; j++, p += 4 * (nx - bx))
-        for (size_t i = 0; i < bx; i++, p += 4)
-          cache.get_block(block_index++, p, sx, sy, sz);
+    cache.get_blocks(p, sx, sy, sz);
   }
 
   // initialize array by copying and compressing data stored at p
   void set(const value_type* p)
   {
-    const size_t bx = store.block_size_x();
-    const size_t by = store.block_size_y();
-    const size_t bz = store.block_size_z();
     const ptrdiff_t sx = 1;
     const ptrdiff_t sy = static_cast<ptrdiff_t>(nx);
     const ptrdiff_t sz = static_cast<ptrdiff_t>(nx * ny);
-    size_t block_index = 0;
-    for (size_t k = 0; k < bz; k++, p += 4 * nx * (ny - by))
-      for (size_t j = 0; j < by; j++, p += 4 * (nx - bx))
-        for (size_t i = 0; i < bx; i++, p += 4)
-          cache.put_block(block_index++, p, sx, sy, sz);
+    cache.put_blocks(p, sx, sy, sz);
+  }
+
+  // initialize array by evaluating f(i, j, k) one block at a time and
+  // compressing each block once, without an uncompressed copy of the array
+  template <class Function>
+  void generate(Function f) { cache.generate_blocks(f); }
+
+  // number of bytes needed to pack compressed blocks overlapping box of
+  // mx * my * mz values at (x, y, z)
+  size_t packed_size(size_t x, size_t y, size_t z, size_t mx, size_t my, size_t mz) const
+  {
+    cache.flush();
+    return store.packed_size(x, y, z, mx, my, mz);
+  }
+
+  // copy compressed blocks overlapping box to buffer without decompression,
+  // e.g., to send them to another array; returns number of bytes copied
+  size_t pack(void* buffer, size_t x, size_t y, size_t z, size_t mx, size_t my, size_t mz) const
+  {
+    cache.flush();
+    return store.pack(buffer, x, y, z, mx, my, mz);
+  }
+
+  // replace compressed blocks overlapping box with blocks packed by an array
+  // with the same compression mode and parameters; returns bytes consumed
+  size_t unpack(const void* buffer, size_t x, size_t y, size_t z, size_t mx, size_t my, size_t mz)
+  {
+    return cache.unpack_blocks(buffer, x, y, z, mx, my, mz);
+  }
+
+  // evaluate array at n points whose (x, y, z) coordinates are stored
+  // consecutively, either at the nearest grid point or by trilinear
+  // interpolation, decoding each block touched by the points once
+  void sample(const double* points, size_t n, value_type* out, bool interpolate = false) const
+  {
+    zfp::internal::dim3::point_sampler<array3>::sample(*this, points, n, out, interpolate);
   }
 
   // (i, j, k) accessors
@@ -209,6 +444,40 @@ public:
     return reference(this, i, j, k);
   }
 
+  // apply f(p, i, j, k, mx, my, mz) to each decompressed block, where p
+  // points to value (i, j, k) and the block's mx * my * mz values are stored
+  // with strides 1, 4, 16; p is valid only for the duration of the call
+  template <class Function>
+  Function for_each_block(Function f) const { return cache.template visit<const value_type*>(f, false, 0, 0, 0, nx, ny, nz); }
+
+  // apply f to each block as above, allowing f to modify the block
+  template <class Function>
+  Function for_each_block(Function f) { return cache.template visit<value_type*>(f, true, 0, 0, 0, nx, ny, nz); }
+
+  // decompress box of mx * my * mz values at (x, y, z) and store at p with
+  // strides sx, sy, sz (all zero for a contiguous box)
+  void get(value_type* p, size_t x, size_t y, size_t z, size_t mx, size_t my, size_t mz, ptrdiff_t sx = 0, ptrdiff_t sy = 0, ptrdiff_t sz = 0) const
+  {
+    if (!sx && !sy && !sz) {
+      sx = 1;
+      sy = static_cast<ptrdiff_t>(mx);
+      sz = static_cast<ptrdiff_t>(mx * my);
+    }
+    cache.get_box(p, x, y, z, mx, my, mz, sx, sy, sz);
+  }
+
+  // copy box of mx * my * mz values stored at p with strides sx, sy, sz (all
+  // zero for a contiguous box) to (x, y, z)
+  void set(const value_type* p, size_t x, size_t y, size_t z, size_t mx, size_t my, size_t mz, ptrdiff_t sx = 0, ptrdiff_t sy = 0, ptrdiff_t sz = 0)
+  {
+    if (!sx && !sy && !sz) {
+      sx = 1;
+      sy = static_cast<ptrdiff_t>(mx);
+      sz = static_cast<ptrdiff_t>(mx * my);
+    }
+    cache.put_box(p, x, y, z, mx, my, mz, sx, sy, sz);
+  }
+
   // sequential iterators
   const_iterator cbegin() const { return const_iterator(this, 0, 0, 0); }
   const_iterator cend() const { return const_iterator(this, 0, 0, nz); }
@@ -233,6 +502,17 @@ protected:
   friend class zfp::internal::dim3::nested_view2<array3>;
   friend class zfp::internal::dim3::nested_view3<array3>;
   friend class zfp::internal::dim3::private_view<array3>;
+  friend class zfp::internal::dim3::stencil_view<array3>;
+  friend class zfp::internal::dim3::snapshot_view<array3>;
+  friend class zfp::internal::dim3::coefficient_ops<array3>;
+  friend class zfp::internal::dim3::point_sampler<array3>;
+  friend class zfp::internal::dim3::block_coarsener<array3>;
+#if defined(__cplusplus) && __cplusplus >= 201103L
+  friend class zfp::internal::dim3::async_writer<array3>;
+  friend class zfp::internal::dim3::shared_const_view<array3>;
+#endif
+  template <typename S, class C>
+  friend void copy_blocks(const array3<S, C>& src, size_t x, size_t y, size_t z, size_t nx, size_t ny, size_t nz, array3<S, C>& dst, size_t dx, size_t dy, size_t dz);
 
   // perform a deep copy
   void deep_copy(const array3& a)
@@ -245,6 +525,20 @@ protected:
     cache.deep_copy(a.cache);
   }
 
+  // load compressed blocks found at given bit offset of buffer of given byte
+  // size (zero if unknown), or zero-initialize storage if buffer is null
+  void load(const zfp::array::header& header, const void* buffer, size_t offset, size_t size, bool borrow)
+  {
+    store.resize(nx, ny, nz, !buffer);
+    if (buffer) {
+      const uint maxbits = static_cast<uint>(header.rate() * 64);
+      const size_t bits = offset + store.blocks() * maxbits;
+      if (size && CHAR_BIT * size < bits)
+        throw zfp::exception("buffer size is smaller than required");
+      store.load(buffer, offset, maxbits, store.blocks(), borrow);
+    }
+  }
+
   // global index bounds
   size_t min_x() const { return 0; }
   size_t max_x() const { return nx; }
@@ -277,7 +571,23 @@ protected:
 
 typedef array3<float> array3f;
 typedef array3<double> array3d;
+typedef array3<int32> array3i;
+typedef array3<int64> array3l;
+
+// copy box of nx * ny * nz values at (x, y, z) of src to (dx, dy, dz) of dst,
+// e.g., to exchange halos between subdomains; when both arrays share
+// compression mode and parameters and the box is aligned alike to blocks
+// in both, whole blocks are copied without recompression and only blocks
+// along the edges of the box are recompressed; src and dst may be the same
+// array only if the source and destination boxes are disjoint
+template <typename Scalar, class Codec>
+inline void copy_blocks(const array3<Scalar, Codec>& src, size_t x, size_t y, size_t z, size_t nx, size_t ny, size_t nz, array3<Scalar, Codec>& dst, size_t dx, size_t dy, size_t dz)
+{
+  dst.cache.copy_blocks(src.cache, x, y, z, nx, ny, nz, dx, dy, dz);
+}
 
 }
 
+#include "zfp/parallel3.h"
+
 #endif
@@ -65,16 +65,22 @@ public:
       set(p);
   }
 
-  // constructor, from previously-serialized compressed array
-  array4(const zfp::array::header& header, const void* buffer = 0, size_t buffer_size_bytes = 0) :
+  // constructor, from previously-serialized compressed array; when borrow
+  // is true, buffer is used in place and copied only once it is modified
+  array4(const zfp::array::header& header, const void* buffer = 0, size_t buffer_size_bytes = 0, bool borrow = false) :
     array(4, Codec::type, header),
-    store(header.size_x(), header.size_y(), header.size_z(), header.size_w(), header.rate()),
+    store(0, 0, 0, 0, header.rate()),
     cache(store)
   {
+    // zero-initialize storage only if no compressed data is given
+    store.resize(nx, ny, nz, nw, !buffer);
     if (buffer) {
       if (buffer_size_bytes && buffer_size_bytes < store.compressed_size())
         throw zfp::exception("buffer size is smaller than required");
-      std::memcpy(store.compressed_data(), buffer, store.compressed_size());
+      if (borrow)
+        store.borrow(buffer);
+      else
+        std::memcpy(store.compressed_data(), buffer, store.compressed_size());
     }
   }
 
@@ -112,6 +118,31 @@ public:
     return *this;
   }
 
+#if defined(__cplusplus) && __cplusplus >= 201103L
+  // move constructor--transfers compressed storage and cache in constant time
+  array4(array4&& a) :
+    array(4, Codec::type),
+    cache(store)
+  {
+    swap(a);
+  }
+
+  // move assignment operator--exchanges contents with a
+  array4& operator=(array4&& a)
+  {
+    swap(a);
+    return *this;
+  }
+#endif
+
+  // exchange contents with another array in constant time
+  void swap(array4& a)
+  {
+    array::swap(a);
+    store.swap(a.store);
+    cache.swap(a.cache);
+  }
+
   // total number of elements in array
   size_t size() const { return nx * ny * nz * nw; }
 
@@ -132,12 +163,30 @@ public:
     cache.clear();
   }
 
+  // resize the array while preserving values where the old and new
+  // domains overlap (new elements are zero); compressed blocks are moved
+  // without recompression except for partial blocks along the old boundary
+  void resize_preserving(size_t nx, size_t ny, size_t nz, size_t nw)
+  {
+    cache.flush();
+    cache.clear();
+    this->nx = nx;
+    this->ny = ny;
+    this->nz = nz;
+    this->nw = nw;
+    store.resize_preserving(nx, ny, nz, nw);
+  }
+
   // rate in bits per value
   double rate() const { return cache.rate(); }
 
   // set rate in bits per value
   double set_rate(double rate) { return cache.set_rate(rate); }
 
+  // lower rate in bits per value without losing contents; compressed blocks
+  // are truncated rather than decompressed and recompressed
+  double set_rate_preserving(double rate) { return cache.set_rate_preserving(rate); }
+
   // number of bytes of compressed data
   size_t compressed_size() const { return store.compressed_size(); }
 
@@ -148,6 +197,12 @@ public:
     return store.compressed_data();
   }
 
+  // true if compressed data resides in a borrowed buffer that is not yet copied
+  bool borrowed() const { return store.borrowed(); }
+
+  // copy borrowed compressed data to storage owned by the array
+  void own() { store.own(); }
+
   // cache size in number of bytes
   size_t cache_size() const { return cache.size(); }
 
@@ -158,6 +213,13 @@ public:
     cache.resize(bytes);
   }
 
+  // set cache line replacement policy and number of lines per set
+  void set_cache_policy(cache_policy policy, uint ways = 4) { cache.set_policy(policy, ways); }
+
+  // allocate compressed storage and cache from given allocator, which must
+  // outlive the array (contents are preserved)
+  void set_allocator(allocator* memory) { cache.set_allocator(memory); }
+
   // empty cache without compressing modified cached blocks
   void clear_cache() const { cache.clear(); }
 
@@ -292,6 +354,8 @@ protected:
 
 typedef array4<float> array4f;
 typedef array4<double> array4d;
+typedef array4<int32> array4i;
+typedef array4<int64> array4l;
 
 }
 
@@ -0,0 +1,673 @@
+#ifndef ZFP_BLOCK_CODEC_H
+#define ZFP_BLOCK_CODEC_H
+
+#include <climits>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include "zfp.h"
+
+// functions callable from both host and (CUDA or HIP) device code
+#if defined(__CUDACC__) || defined(__HIPCC__)
+  #define ZFP_HOST_DEVICE __host__ __device__
+#else
+  #define ZFP_HOST_DEVICE
+#endif
+
+// header-only implementation of the zfp fixed-rate block codec that compilers
+// may inline into user loops; emits the same bits as libzfp
+namespace zfp {
+namespace cpp {
+
+// integer types and exponent width for block-floating-point conversion
+template <typename Scalar>
+struct block_traits;
+
+template <>
+struct block_traits<float> {
+  typedef int32 Int;
+  typedef uint32 UInt;
+  static const uint ebits = 8;
+};
+
+template <>
+struct block_traits<double> {
+  typedef int64 Int;
+  typedef uint64 UInt;
+  static const uint ebits = 11;
+};
+
+// number of trailing zero-bits in x != 0
+inline ZFP_HOST_DEVICE uint
+ctz64(uint64 x)
+{
+#if defined(__CUDA_ARCH__) || defined(__HIP_DEVICE_COMPILE__)
+  return uint(__ffsll((long long)x) - 1);
+#elif defined(__GNUC__)
+  return uint(__builtin_ctzll(x));
+#else
+  uint n = 0;
+  if (!(x & UINT64C(0xffffffff))) { x >>= 32; n += 32; }
+  if (!(x & UINT64C(0xffff))) { x >>= 16; n += 16; }
+  if (!(x & UINT64C(0xff))) { x >>= 8; n += 8; }
+  if (!(x & UINT64C(0xf))) { x >>= 4; n += 4; }
+  if (!(x & UINT64C(0x3))) { x >>= 2; n += 2; }
+  return n + !(x & 1u);
+#endif
+}
+
+// sequential writer of bits to 64-bit words, least significant bit first
+class block_writer {
+public:
+  // position writer at given bit offset, preserving preceding bits
+  ZFP_HOST_DEVICE block_writer(uint64* data, size_t offset) :
+    ptr(data + offset / 64),
+    buffer(0),
+    bits(uint(offset % 64)),
+    mask(~uint64(0) << bits)
+  {}
+
+  // write single bit (must be 0 or 1)
+  ZFP_HOST_DEVICE uint write_bit(uint bit)
+  {
+    buffer += uint64(bit) << bits;
+    if (++bits == 64) {
+      put(buffer, mask);
+      buffer = 0;
+      bits = 0;
+    }
+    return bit;
+  }
+
+  // write 0 <= n <= 64 low bits of value; return value shifted by n
+  ZFP_HOST_DEVICE uint64 write_bits(uint64 value, uint n)
+  {
+    buffer += value << bits;
+    bits += n;
+    if (bits >= 64) {
+      value >>= 1;
+      n--;
+      bits -= 64;
+      put(buffer, mask);
+      buffer = value >> (n - bits);
+    }
+    buffer &= (uint64(1) << bits) - 1;
+    return value >> n;
+  }
+
+  // append n zero-bits
+  ZFP_HOST_DEVICE void pad(uint n)
+  {
+    for (bits += n; bits >= 64; bits -= 64) {
+      put(buffer, mask);
+      buffer = 0;
+    }
+  }
+
+  // output buffered bits, preserving succeeding bits of partial word
+  ZFP_HOST_DEVICE void flush()
+  {
+    if (bits)
+      put(buffer, mask & ((uint64(1) << bits) - 1));
+  }
+
+protected:
+  // store the bits of value selected by m in the next word and advance; the
+  // remaining bits may belong to neighboring blocks, which on the device may
+  // be written concurrently by other threads
+  ZFP_HOST_DEVICE void put(uint64 value, uint64 m)
+  {
+    if (m == ~uint64(0))
+      *ptr = value;
+    else {
+#if defined(__CUDA_ARCH__) || defined(__HIP_DEVICE_COMPILE__)
+      atomicAnd((unsigned long long*)ptr, (unsigned long long)~m);
+      atomicOr((unsigned long long*)ptr, (unsigned long long)value);
+#else
+      *ptr = (*ptr & ~m) | value;
+#endif
+    }
+    ptr++;
+    mask = ~uint64(0);
+  }
+
+  uint64* ptr;   // next word to write
+  uint64 buffer; // incomplete word
+  uint bits;     // number of bits in buffer
+  uint64 mask;   // bits of next word that belong to the block
+};
+
+// sequential reader of bits from 64-bit words, least significant bit first
+class block_reader {
+public:
+  // position reader at given bit offset
+  ZFP_HOST_DEVICE block_reader(const uint64* data, size_t offset) :
+    ptr(data + offset / 64),
+    buffer(0),
+    bits(0)
+  {
+    uint n = uint(offset % 64);
+    if (n) {
+      buffer = *ptr++ >> n;
+      bits = 64 - n;
+    }
+  }
+
+  // read single bit
+  ZFP_HOST_DEVICE uint read_bit()
+  {
+    if (!bits) {
+      buffer = *ptr++;
+      bits = 64;
+    }
+    bits--;
+    uint bit = uint(buffer) & 1u;
+    buffer >>= 1;
+    return bit;
+  }
+
+  // read 0 <= n <= 64 bits
+  ZFP_HOST_DEVICE uint64 read_bits(uint n)
+  {
+    uint64 value = buffer;
+    if (bits < n) {
+      buffer = *ptr++;
+      value += buffer << bits;
+      bits += 64 - n;
+      if (!bits)
+        buffer = 0;
+      else {
+        buffer >>= 64 - bits;
+        value &= (uint64(2) << (n - 1)) - 1;
+      }
+    }
+    else {
+      bits -= n;
+      buffer >>= n;
+      value &= (uint64(1) << n) - 1;
+    }
+    return value;
+  }
+
+  // skip up to n zero-bits and the one-bit after them; return zeros skipped
+  ZFP_HOST_DEVICE uint read_zeros(uint n)
+  {
+    uint zeros = 0;
+    while (zeros < n) {
+      if (!bits) {
+        buffer = *ptr++;
+        bits = 64;
+      }
+      uint c = n - zeros < bits ? n - zeros : bits;
+      uint64 y = c < 64 ? buffer & ((uint64(1) << c) - 1) : buffer;
+      if (y) {
+        uint t = ctz64(y);
+        buffer >>= t;
+        buffer >>= 1;
+        bits -= t + 1;
+        return zeros + t;
+      }
+      buffer = c < 64 ? buffer >> c : 0;
+      bits -= c;
+      zeros += c;
+    }
+    return zeros;
+  }
+
+protected:
+  const uint64* ptr; // next word to read
+  uint64 buffer;     // unread bits of current word
+  uint bits;         // number of bits in buffer
+};
+
+// fixed-rate coding of contiguous blocks of 4^dims scalars
+template <typename Scalar, uint dims>
+class block_codec {
+public:
+  typedef typename block_traits<Scalar>::Int Int;
+  typedef typename block_traits<Scalar>::UInt UInt;
+
+  static const uint block_size = 1u << (2 * dims);             // block size in number of scalars
+  static const uint ebits = block_traits<Scalar>::ebits;       // number of exponent bits
+  static const uint min_bits = 1 + ebits;                      // smallest supported block size in bits
+
+  // encode contiguous block using maxbits >= min_bits bits starting at given
+  // bit offset into data; return maxbits
+  static ZFP_HOST_DEVICE size_t encode_block(uint64* data, size_t offset, uint maxbits, const Scalar* fblock)
+  {
+    block_writer w(data, offset);
+    // compute maximum exponent
+    int emax = exponent_block(fblock);
+    uint maxprec = precision(emax);
+    uint e = maxprec ? uint(emax + ebias) : 0;
+    // encode block only if biased exponent is nonzero
+    if (e) {
+      Int iblock[block_size];
+      // encode common exponent; LSB indicates that exponent is nonzero
+      uint bits = 1 + ebits;
+      w.write_bits(2 * e + 1, bits);
+      if (is_constant(fblock)) {
+        // the decorrelating transform maps a constant block to its DC coefficient
+        fwd_cast(iblock, fblock, 1, emax);
+        bits += encode_first_int(w, maxbits - bits, maxprec, int2uint(iblock[0]));
+      }
+      else {
+        fwd_cast(iblock, fblock, block_size, emax);
+        bits += encode_ints(w, maxbits - bits, maxprec, iblock);
+      }
+      // pad block to its fixed size
+      w.pad(maxbits - bits);
+    }
+    else {
+      // write single zero-bit to indicate that all values are zero
+      w.write_bit(0);
+      w.pad(maxbits - 1);
+    }
+    w.flush();
+    return maxbits;
+  }
+
+  // decode contiguous block of maxbits bits starting at given bit offset into
+  // data; return maxbits
+  static ZFP_HOST_DEVICE size_t decode_block(const uint64* data, size_t offset, uint maxbits, Scalar* fblock)
+  {
+    block_reader r(data, offset);
+    // test if block has nonzero values
+    if (r.read_bit()) {
+      Int iblock[block_size];
+      // decode common exponent
+      int emax = int(r.read_bits(ebits)) - ebias;
+      uint maxprec = precision(emax);
+      // decode integer block
+      decode_ints(r, maxbits - 1 - ebits, maxprec, iblock);
+      // perform inverse block-floating-point transform
+      inv_cast(iblock, fblock, emax);
+    }
+    else {
+      // set all values to zero
+      for (uint i = 0; i < block_size; i++)
+        fblock[i] = 0;
+    }
+    return maxbits;
+  }
+
+  // pad partial block of width n <= 4 and stride s
+  static ZFP_HOST_DEVICE void pad_block(Scalar* p, uint n, uint s)
+  {
+    switch (n) {
+      case 0:
+        p[0 * s] = 0;
+        /* FALLTHROUGH */
+      case 1:
+        p[1 * s] = p[0 * s];
+        /* FALLTHROUGH */
+      case 2:
+        p[2 * s] = p[1 * s];
+        /* FALLTHROUGH */
+      case 3:
+        p[3 * s] = p[0 * s];
+        /* FALLTHROUGH */
+      default:
+        break;
+    }
+  }
+
+protected:
+  static const int ebias = (1 << (ebits - 1)) - 1;     // exponent bias
+  static const uint intprec = CHAR_BIT * sizeof(UInt); // integer precision
+
+  // maximum number of bit planes to encode
+  static ZFP_HOST_DEVICE uint precision(int emax)
+  {
+    int p = emax - ZFP_MIN_EXP + 2 * int(dims + 1);
+    return p < 0 ? 0 : p > ZFP_MAX_PREC ? uint(ZFP_MAX_PREC) : uint(p);
+  }
+
+  // maximum floating-point exponent in block, ignoring NaNs
+  static ZFP_HOST_DEVICE int exponent_block(const Scalar* p)
+  {
+    // nonnegative IEEE values other than NaN are ordered like their bits
+    const UInt inf = UInt((UInt(1) << ebits) - 1) << (intprec - 1 - ebits);
+    UInt max = 0;
+    for (uint i = 0; i < block_size; i++) {
+      UInt x;
+      std::memcpy(&x, p + i, sizeof(x));
+      x &= UInt(~UInt(0)) >> 1;
+      if (x > inf)
+        x = 0;
+      if (max < x)
+        max = x;
+    }
+    Scalar f;
+    std::memcpy(&f, &max, sizeof(f));
+    if (f > 0) {
+      int e;
+      std::frexp(f, &e);
+      // clamp exponent in case f is denormal
+      return e > 1 - ebias ? e : 1 - ebias;
+    }
+    return -ebias;
+  }
+
+  // return true if all values are bitwise equal to the first
+  static ZFP_HOST_DEVICE bool is_constant(const Scalar* p)
+  {
+    UInt u, v, d = 0;
+    std::memcpy(&u, p, sizeof(u));
+    for (uint i = 1; i < block_size; i++) {
+      std::memcpy(&v, p + i, sizeof(v));
+      d |= u ^ v;
+    }
+    return !d;
+  }
+
+  // forward block-floating-point transform of n values to signed integers
+  static ZFP_HOST_DEVICE void fwd_cast(Int* iblock, const Scalar* fblock, uint n, int emax)
+  {
+    const Scalar s = std::ldexp(Scalar(1), int(intprec) - 2 - emax);
+    for (uint i = 0; i < n; i++)
+      iblock[i] = Int(s * fblock[i]);
+  }
+
+  // inverse block-floating-point transform from signed integers
+  static ZFP_HOST_DEVICE void inv_cast(const Int* iblock, Scalar* fblock, int emax)
+  {
+    const Scalar s = std::ldexp(Scalar(1), emax - (int(intprec) - 2));
+    for (uint i = 0; i < block_size; i++)
+      fblock[i] = Scalar(s * iblock[i]);
+  }
+
+  // forward lifting transform of n 4-vectors with stride s between elements
+  static ZFP_HOST_DEVICE void fwd_lift(Int* p, uint s, uint n)
+  {
+    Int* q = p + s;
+    Int* r = q + s;
+    Int* t = r + s;
+    // vectors are independent, so this loop vectorizes
+    for (uint i = 0; i < n; i++) {
+      Int x = p[i];
+      Int y = q[i];
+      Int z = r[i];
+      Int w = t[i];
+      x += w; x >>= 1; w -= x;
+      z += y; z >>= 1; y -= z;
+      x += z; x >>= 1; z -= x;
+      w += y; w >>= 1; y -= w;
+      w += y >> 1; y -= w >> 1;
+      p[i] = x;
+      q[i] = y;
+      r[i] = z;
+      t[i] = w;
+    }
+  }
+
+  // inverse lifting transform of n 4-vectors with stride s between elements
+  static ZFP_HOST_DEVICE void inv_lift(Int* p, uint s, uint n)
+  {
+    Int* q = p + s;
+    Int* r = q + s;
+    Int* t = r + s;
+    // vectors are independent, so this loop vectorizes
+    for (uint i = 0; i < n; i++) {
+      Int x = p[i];
+      Int y = q[i];
+      Int z = r[i];
+      Int w = t[i];
+      y += w >> 1; w -= y >> 1;
+      y += w; w <<= 1; w -= y;
+      z += x; x <<= 1; x -= z;
+      y += z; z <<= 1; z -= y;
+      w += x; x <<= 1; x -= w;
+      p[i] = x;
+      q[i] = y;
+      r[i] = z;
+      t[i] = w;
+    }
+  }
+
+  // forward decorrelating transform along x, then y, z, and w
+  static ZFP_HOST_DEVICE void fwd_xform(Int* p)
+  {
+    // transform along x
+    for (uint i = 0; i < block_size; i += 4)
+      fwd_lift(p + i, 1, 1);
+    // transform along each remaining dimension for all preceding ones at once
+    for (uint s = 4; s < block_size; s *= 4)
+      for (uint i = 0; i < block_size; i += 4 * s)
+        fwd_lift(p + i, s, s);
+  }
+
+  // inverse decorrelating transform along w, then z, y, and x
+  static ZFP_HOST_DEVICE void inv_xform(Int* p)
+  {
+    // transform along each dimension but x for all preceding ones at once
+    for (uint s = block_size / 4; s > 1; s /= 4)
+      for (uint i = 0; i < block_size; i += 4 * s)
+        inv_lift(p + i, s, s);
+    // transform along x
+    for (uint i = 0; i < block_size; i += 4)
+      inv_lift(p + i, 1, 1);
+  }
+
+  // map two's complement signed integer to negabinary unsigned integer
+  static ZFP_HOST_DEVICE UInt int2uint(Int x)
+  {
+    const UInt nbmask = UInt(~UInt(0)) / 3 * 2;
+    return (UInt(x) + nbmask) ^ nbmask;
+  }
+
+  // map negabinary unsigned integer to two's complement signed integer
+  static ZFP_HOST_DEVICE Int uint2int(UInt x)
+  {
+    const UInt nbmask = UInt(~UInt(0)) / 3 * 2;
+    return Int((x ^ nbmask) - nbmask);
+  }
+
+  // coefficient order by polynomial degree/frequency
+  static ZFP_HOST_DEVICE const uchar* perm()
+  {
+    static const uchar perm_1[4] = {
+      0, 1, 2, 3,
+    };
+    static const uchar perm_2[16] = {
+      0, 1, 4, 5, 2, 8, 6, 9, 3, 12, 10, 7, 13, 11, 14, 15,
+    };
+    static const uchar perm_3[64] = {
+      0, 1, 4, 16, 20, 17, 5, 2, 8, 32, 21, 6, 18, 24, 9, 33,
+      36, 3, 12, 48, 22, 25, 37, 40, 34, 10, 7, 19, 28, 13, 49, 52,
+      41, 38, 26, 23, 29, 53, 11, 35, 44, 14, 50, 56, 42, 27, 39, 45,
+      30, 54, 57, 60, 51, 15, 43, 46, 58, 61, 55, 31, 62, 59, 47, 63,
+    };
+    static const uchar perm_4[256] = {
+      0, 1, 4, 16, 64, 5, 80, 17, 68, 65, 20, 2, 8, 32, 128, 84,
+      81, 69, 21, 6, 18, 66, 24, 72, 9, 96, 33, 36, 129, 132, 144, 3,
+      12, 48, 192, 85, 82, 70, 22, 73, 25, 88, 37, 100, 97, 148, 145, 133,
+      10, 160, 34, 136, 130, 40, 7, 19, 67, 28, 76, 13, 112, 49, 52, 193,
+      196, 208, 86, 89, 101, 149, 161, 137, 41, 134, 38, 164, 26, 152, 146, 104,
+      98, 74, 83, 71, 23, 77, 29, 92, 53, 116, 113, 212, 209, 197, 11, 35,
+      131, 44, 140, 14, 176, 50, 56, 194, 200, 224, 90, 165, 102, 153, 150, 105,
+      168, 162, 138, 42, 87, 93, 117, 213, 27, 75, 99, 39, 135, 147, 108, 45,
+      141, 156, 30, 78, 177, 180, 54, 114, 120, 57, 198, 210, 216, 201, 225, 228,
+      15, 240, 51, 204, 195, 60, 169, 166, 154, 106, 91, 103, 151, 109, 157, 94,
+      181, 118, 121, 214, 217, 229, 163, 139, 43, 142, 46, 172, 58, 184, 178, 232,
+      226, 202, 241, 205, 61, 199, 55, 244, 31, 220, 211, 124, 115, 79, 170, 167,
+      155, 107, 158, 110, 173, 122, 185, 182, 233, 230, 218, 95, 245, 119, 221, 215,
+      125, 242, 206, 62, 203, 59, 248, 47, 236, 227, 188, 179, 143, 171, 174, 186,
+      234, 246, 222, 126, 219, 123, 249, 111, 237, 231, 189, 183, 159, 252, 243, 207,
+      63, 175, 250, 187, 238, 235, 190, 253, 247, 223, 127, 254, 251, 239, 191, 255,
+    };
+    switch (dims) {
+      case 1:
+        return perm_1;
+      case 2:
+        return perm_2;
+      case 3:
+        return perm_3;
+      default:
+        return perm_4;
+    }
+  }
+
+  // encode sequence of unsigned integers that are zero except for first, u
+  static ZFP_HOST_DEVICE uint encode_first_int(block_writer& w, uint maxbits, uint maxprec, UInt u)
+  {
+    const uint kmin = intprec > maxprec ? intprec - maxprec : 0;
+    uint bits = maxbits;
+    bool significant = false;
+    // emit the same bits as encode_ints, one bit plane at a time
+    for (uint k = intprec; bits && k-- > kmin;) {
+      uint x = uint(u >> k) & 1u;
+      if (!significant) {
+        // group test; nothing more to emit while first value is zero
+        bits--;
+        if (!w.write_bit(x))
+          continue;
+        significant = true;
+      }
+      // emit bit of first value
+      if (bits) {
+        bits--;
+        w.write_bit(x);
+      }
+      // group test of remaining zero values
+      if (bits) {
+        bits--;
+        w.write_bit(0);
+      }
+    }
+    return maxbits - bits;
+  }
+
+  // encode block of integers using at most maxbits bits
+  static ZFP_HOST_DEVICE uint encode_ints(block_writer& w, uint maxbits, uint maxprec, Int* iblock)
+  {
+    // bypass transform and bit plane extraction for constant blocks
+    bool constant = true;
+    for (uint i = 1; i < block_size; i++)
+      constant &= iblock[i] == iblock[0];
+    if (constant)
+      return encode_first_int(w, maxbits, maxprec, int2uint(iblock[0]));
+
+    // perform decorrelating transform
+    fwd_xform(iblock);
+    // reorder signed coefficients and convert to unsigned integer
+    UInt ublock[block_size];
+    const uchar* order = perm();
+    for (uint i = 0; i < block_size; i++)
+      ublock[i] = int2uint(iblock[order[i]]);
+
+    const uint kmin = intprec > maxprec ? intprec - maxprec : 0;
+    uint bits = maxbits;
+    uint n = 0;
+    // encode one bit plane at a time from MSB to LSB
+    for (uint k = intprec; bits && k-- > kmin;) {
+      // encode first n bits of bit plane #k
+      uint m = n < bits ? n : bits;
+      bits -= m;
+      if (block_size <= 64) {
+        // extract bit plane #k to x
+        uint64 x = 0;
+        for (uint i = 0; i < block_size; i++)
+          x += uint64((ublock[i] >> k) & 1u) << i;
+        x = w.write_bits(x, m);
+        // unary run-length encode remainder of bit plane
+        while (n < block_size && bits && (bits--, w.write_bit(!!x))) {
+          // emit run of zeros and its terminating one-bit in a single write
+          uint t = ctz64(x);
+          m = t + 1 < block_size - 1 - n ? t + 1 : block_size - 1 - n;
+          m = m < bits ? m : bits;
+          bits -= m;
+          w.write_bits(x, m);
+          // the last coefficient's one-bit is implied by its group test
+          x >>= t;
+          x >>= 1;
+          n += t + 1;
+        }
+      }
+      else {
+        for (uint i = 0; i < m; i++)
+          w.write_bit((ublock[i] >> k) & 1u);
+        // count remaining one-bits in bit plane
+        uint c = 0;
+        for (uint i = m; i < block_size; i++)
+          c += (ublock[i] >> k) & 1u;
+        // unary run-length encode remainder of bit plane
+        for (; n < block_size && bits && (--bits, w.write_bit(!!c)); c--, n++)
+          for (; n < block_size - 1 && bits && (--bits, !w.write_bit((ublock[n] >> k) & 1u)); n++)
+            ;
+      }
+    }
+    return maxbits - bits;
+  }
+
+  // decode block of integers using at most maxbits bits
+  static ZFP_HOST_DEVICE void decode_ints(block_reader& r, uint maxbits, uint maxprec, Int* iblock)
+  {
+    UInt ublock[block_size];
+    for (uint i = 0; i < block_size; i++)
+      ublock[i] = 0;
+
+    const uint kmin = intprec > maxprec ? intprec - maxprec : 0;
+    uint bits = maxbits;
+    uint n = 0;
+    // decode one bit plane at a time from MSB to LSB
+    for (uint k = intprec; bits && k-- > kmin;) {
+      // decode first n bits of bit plane #k
+      uint m = n < bits ? n : bits;
+      bits -= m;
+      if (block_size <= 64) {
+        uint64 x = r.read_bits(m);
+        // unary run-length decode remainder of bit plane
+        for (; n < block_size && bits && (bits--, r.read_bit()); x += uint64(1) << n++) {
+          // skip run of zeros and its one-bit; the last one-bit is implied
+          m = block_size - 1 - n < bits ? block_size - 1 - n : bits;
+          uint i = r.read_zeros(m);
+          bits -= i + (i < m);
+          n += i;
+        }
+        // deposit bit plane from x
+        for (uint i = 0; x; i++, x >>= 1)
+          ublock[i] += UInt(x & 1u) << k;
+      }
+      else {
+        for (uint i = 0; i < m; i += 64) {
+          uint c = m - i < 64 ? m - i : 64;
+          uint64 x = r.read_bits(c);
+          for (uint j = i; x; j++, x >>= 1)
+            ublock[j] += UInt(x & 1u) << k;
+        }
+        // unary run-length decode remainder of bit plane
+        for (; n < block_size && bits && (--bits, r.read_bit()); ublock[n] += UInt(1) << k, n++) {
+          // skip run of zeros and its one-bit; the last one-bit is implied
+          m = block_size - 1 - n < bits ? block_size - 1 - n : bits;
+          uint i = r.read_zeros(m);
+          bits -= i + (i < m);
+          n += i;
+        }
+      }
+    }
+
+    // a lone DC coefficient inverse transforms to a constant block
+    UInt d = 0;
+    for (uint i = 1; i < block_size; i++)
+      d |= ublock[i];
+    if (!d) {
+      Int x = uint2int(ublock[0]);
+      for (uint i = 0; i < block_size; i++)
+        iblock[i] = x;
+    }
+    else {
+      // reorder unsigned coefficients and convert to signed integer
+      const uchar* order = perm();
+      for (uint i = 0; i < block_size; i++)
+        iblock[order[i]] = uint2int(ublock[i]);
+      // perform decorrelating transform
+      inv_xform(iblock);
+    }
+  }
+};
+
+}
+}
+
+#endif
@@ -0,0 +1,244 @@
+#ifndef ZFP_CARRAY3_H
+#define ZFP_CARRAY3_H
+
+#include <cstddef>
+#include <cstring>
+#include "zfparray.h"
+#include "zfpcodec.h"
+#include "zfp/cache3.h"
+#include "zfp/conststore3.h"
+
+namespace zfp {
+
+// read-only compressed 3D array of scalars, initialized in one pass via set()
+template < typename Scalar, class Codec = zfp::zfp_codec<Scalar, 3> >
+class const_array3 : public array {
+public:
+  typedef const_array3 container_type;
+  typedef Scalar value_type;
+  typedef Codec codec_type;
+
+  // default constructor
+  const_array3() :
+    array(3, Codec::type),
+    cache(store)
+  {}
+
+  // constructor of nx * ny * nz array using rate bits per value, at least
+  // cache_size bytes of cache, and optionally initialized from flat array p
+  const_array3(size_t nx, size_t ny, size_t nz, double rate, const value_type* p = 0, size_t cache_size = 0) :
+    array(3, Codec::type),
+    store(nx, ny, nz, rate),
+    cache(store, cache_size)
+  {
+    this->nx = nx;
+    this->ny = ny;
+    this->nz = nz;
+    if (p)
+      set(p);
+  }
+
+  // constructor, from fixed-rate stream written by zfp_write_header() with
+  // ZFP_HEADER_FULL followed by zfp_compress(); when borrow is true and
+  // blocks are word aligned, the stream is used in place
+  const_array3(const void* stream, size_t stream_size_bytes, bool borrow = false) :
+    array(3, Codec::type, typename Codec::header(stream)),
+    cache(store)
+  {
+    typename Codec::header header(stream);
+    const size_t offset = CHAR_BIT * header.size_bytes();
+    const uint maxbits = static_cast<uint>(header.rate() * 64);
+    store.set_rate(header.rate());
+    store.resize(nx, ny, nz, false);
+    if (stream_size_bytes && CHAR_BIT * stream_size_bytes < offset + store.blocks() * maxbits)
+      throw zfp::exception("buffer size is smaller than required");
+    store.load(stream, offset, maxbits, borrow);
+    cache.reset();
+  }
+
+  // copy constructor--performs a deep copy
+  const_array3(const const_array3& a) :
+    array(),
+    cache(store)
+  {
+    deep_copy(a);
+  }
+
+  // virtual destructor
+  virtual ~const_array3() {}
+
+  // assignment operator--performs a deep copy
+  const_array3& operator=(const const_array3& a)
+  {
+    if (this != &a)
+      deep_copy(a);
+    return *this;
+  }
+
+  // total number of elements in array
+  size_t size() const { return nx * ny * nz; }
+
+  // array dimensions
+  size_t size_x() const { return nx; }
+  size_t size_y() const { return ny; }
+  size_t size_z() const { return nz; }
+
+  // resize the array (all previously stored data will be lost)
+  void resize(size_t nx, size_t ny, size_t nz)
+  {
+    this->nx = nx;
+    this->ny = ny;
+    this->nz = nz;
+    store.resize(nx, ny, nz);
+    cache.reset();
+  }
+
+  // rate in bits per value of compressed blocks, excluding index
+  double rate() const { return store.rate(); }
+
+  // storage required by block index in bits
+  size_t index_size_bits() const { return store.index_size_bits(); }
+
+  // compression mode
+  zfp_mode mode() const { return store.mode(); }
+
+  // set rate in bits per value (array contents are lost until set() is called)
+  double set_rate(double rate)
+  {
+    rate = store.set_rate(rate);
+    reset();
+    return rate;
+  }
+
+  // set precision in uncompressed bits per value
+  uint set_precision(uint precision)
+  {
+    precision = store.set_precision(precision);
+    reset();
+    return precision;
+  }
+
+  // set absolute error tolerance
+  double set_accuracy(double tolerance)
+  {
+    tolerance = store.set_accuracy(tolerance);
+    reset();
+    return tolerance;
+  }
+
+  // enable reversible (lossless) compression
+  void set_reversible()
+  {
+    store.set_reversible();
+    reset();
+  }
+
+  // number of bytes of compressed data
+  size_t compressed_size() const { return store.compressed_size(); }
+
+  // pointer to compressed data
+  void* compressed_data() const { return store.compressed_data(); }
+
+  // cache size in number of bytes
+  size_t cache_size() const { return cache.size(); }
+
+  // set minimum cache size in bytes (array dimensions must be known)
+  void set_cache_size(size_t bytes) { cache.resize(bytes); }
+
+  // set cache line replacement policy and number of lines per set
+  void set_cache_policy(cache_policy policy, uint ways = 4) { cache.set_policy(policy, ways); }
+
+  // allocate compressed storage and cache from given allocator, which must
+  // outlive the array (contents are preserved)
+  void set_allocator(allocator* memory) { cache.set_allocator(memory); }
+
+  // byte budget of adaptive cache sizing (zero if disabled)
+  size_t cache_budget() const { return cache.adaptive_budget(); }
+
+  // size cache adaptively within budget bytes, starting with one slab of
+  // blocks and growing it when accesses miss often (zero disables); views
+  // with private caches inherit the budget
+  void set_cache_budget(size_t bytes) { cache.set_adaptive(bytes); }
+
+  // set number of blocks to prefetch in block order on a cache miss (zero disables)
+  void set_cache_prefetch(uint blocks) { cache.set_prefetch(blocks); }
+
+  // size in bytes of secondary cache of evicted blocks (zero if disabled)
+  size_t cache_secondary_size() const { return cache.secondary_size(); }
+
+  // set minimum size in bytes of secondary cache holding evicted blocks
+  // rounded to single precision; reads that miss the cache but hit the
+  // secondary cache return rounded values (zero disables)
+  void set_cache_secondary_size(size_t bytes) { cache.set_secondary_size(bytes); }
+
+  // enable or disable gathering of cache statistics
+  void set_cache_stats(bool enable) { cache.set_stats(enable); }
+
+  // cache statistics gathered since last reset
+  cache_statistics cache_stats() const { return cache.stats(); }
+
+  // zero cache statistics
+  void reset_cache_stats() { cache.reset_stats(); }
+
+  // empty cache
+  void clear_cache() const { cache.clear(); }
+
+  // decompress array and store at p
+  void get(value_type* p) const
+  {
+    const ptrdiff_t sx = 1;
+    const ptrdiff_t sy = static_cast<ptrdiff_t>(nx);
+    const ptrdiff_t sz = static_cast<ptrdiff_t>(nx * ny);
+    cache.get_blocks(p, sx, sy, sz);
+  }
+
+  // initialize array by compressing all data stored at p in one pass
+  void set(const value_type* p)
+  {
+    store.set(p);
+    cache.reset();
+  }
+
+  // (i, j, k) inspector
+  value_type operator()(size_t i, size_t j, size_t k) const { return cache.get(i, j, k); }
+
+  // flat index inspector
+  value_type operator[](size_t index) const
+  {
+    size_t i = index % nx; index /= nx;
+    size_t j = index % ny; index /= ny;
+    size_t k = index;
+    return cache.get(i, j, k);
+  }
+
+protected:
+  // compress zero-valued array using current compression mode
+  void reset()
+  {
+    store.resize(nx, ny, nz);
+    cache.reset();
+  }
+
+  // perform a deep copy
+  void deep_copy(const const_array3& a)
+  {
+    // copy base class members
+    array::deep_copy(a);
+    // copy persistent storage
+    store.deep_copy(a.store);
+    // copy cached data
+    cache.deep_copy(a.cache);
+  }
+
+  typedef ConstBlockStore3<value_type, codec_type> store_type;
+
+  store_type store;                                       // persistent storage of compressed blocks
+  BlockCache3<value_type, codec_type, store_type> cache; // cache of decompressed blocks
+};
+
+typedef const_array3<float> const_array3f;
+typedef const_array3<double> const_array3d;
+
+}
+
+#endif
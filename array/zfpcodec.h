@@ -15,21 +15,56 @@ template <typename Scalar, uint dims>
 class zfp_codec_base {
 protected:
   // constructor takes pre-allocated buffer of compressed blocks
-  zfp_codec_base(void* data, size_t size)
+  zfp_codec_base(void* data, size_t size) :
+    padding(true)
   {
     bitstream* stream = stream_open(data, size);
     zfp = zfp_stream_open(stream);
   }
 
+  // copy constructor--attaches to the same buffer using the same parameters
+  zfp_codec_base(const zfp_codec_base& c) :
+    padding(c.padding)
+  {
+    bitstream* stream = stream_open(c.buffer(), c.buffer_size());
+    zfp = zfp_stream_open(stream);
+    uint minbits, maxbits, maxprec;
+    int minexp;
+    zfp_stream_params(c.zfp, &minbits, &maxbits, &maxprec, &minexp);
+    zfp_stream_set_params(zfp, minbits, maxbits, maxprec, minexp);
+  }
+
+#if defined(__cplusplus) && __cplusplus >= 201103L
+  // move constructor--transfers compressed stream in constant time
+  zfp_codec_base(zfp_codec_base&& c) :
+    zfp(c.zfp),
+    padding(c.padding)
+  {
+    c.zfp = 0;
+  }
+#endif
+
 public:
   // destructor
   ~zfp_codec_base()
   {
-    bitstream* stream = zfp_stream_bit_stream(zfp);
-    zfp_stream_close(zfp);
-    stream_close(stream);
+    if (zfp) {
+      bitstream* stream = zfp_stream_bit_stream(zfp);
+      zfp_stream_close(zfp);
+      stream_close(stream);
+    }
   }
 
+#if defined(__cplusplus) && __cplusplus >= 201103L
+  // move assignment operator--exchanges streams with c
+  zfp_codec_base& operator=(zfp_codec_base&& c)
+  {
+    std::swap(zfp, c.zfp);
+    std::swap(padding, c.padding);
+    return *this;
+  }
+#endif
+
   // return nearest rate supported
   static double nearest_rate(double target_rate)
   {
@@ -45,18 +80,68 @@ public:
   // set rate in bits/value
   double set_rate(double rate) { return zfp_stream_set_rate(zfp, rate, type, dims, zfp_true); }
 
+  // precision in uncompressed bits/value (fixed-precision mode only)
+  uint precision() const { return zfp_stream_precision(zfp); }
+
+  // set precision in uncompressed bits/value
+  uint set_precision(uint precision) { return zfp_stream_set_precision(zfp, precision); }
+
+  // absolute error tolerance (fixed-accuracy mode only)
+  double accuracy() const { return zfp_stream_accuracy(zfp); }
+
+  // set absolute error tolerance
+  double set_accuracy(double tolerance) { return zfp_stream_set_accuracy(zfp, tolerance); }
+
+  // enable reversible (lossless) compression
+  void set_reversible() { zfp_stream_set_reversible(zfp); }
+
+  // maximum number of bit planes coded per block
+  uint max_precision() const { return zfp->maxprec; }
+
+  // limit coding to the first precision bit planes (zero for all) so that
+  // decoding stops early at reduced accuracy; blocks encoded with this limit
+  // lose the remaining planes
+  uint set_max_precision(uint precision)
+  {
+    zfp_stream_set_params(zfp, zfp->minbits, zfp->maxbits, precision ? std::min(precision, uint(ZFP_MAX_PREC)) : ZFP_MAX_PREC, zfp->minexp);
+    return zfp->maxprec;
+  }
+
+  // pad encoded blocks to whole words (default) or pack them back to back
+  void set_padding(bool pad) { padding = pad; }
+
+  // associate codec with a new buffer of compressed blocks
+  void open(void* data, size_t size)
+  {
+    bitstream* stream = zfp_stream_bit_stream(zfp);
+    zfp_stream_set_bit_stream(zfp, stream_open(data, size));
+    stream_close(stream);
+  }
+
+  // pointer to and size in bytes of buffer that codec is attached to
+  void* buffer() const { return stream_data(zfp_stream_bit_stream(zfp)); }
+  size_t buffer_size() const { return stream_capacity(zfp_stream_bit_stream(zfp)); }
+
   static const zfp_type type = zfp::trait<Scalar>::type; // scalar type
+  typedef typename zfp::trait<Scalar>::int_type int_type; // transform coefficient type
 
   // zfp::codec_base::header class for array (de)serialization
   #include "zfp/zfpheader.h"
 
 protected:
+  // flush stream; return number of bits of padding counted toward block size
+  size_t flush()
+  {
+    size_t bits = zfp_stream_flush(zfp);
+    return padding ? bits : 0;
+  }
+
   // encode full contiguous block
   size_t encode_block(size_t offset, const Scalar* block)
   {
     stream_wseek(zfp->stream, offset);
     size_t size = cpp::encode_block<Scalar, dims>(zfp, block);
-    size += zfp_stream_flush(zfp);
+    size += flush();
     return size;
   }
 
@@ -69,9 +154,41 @@ protected:
     return size;
   }
 
+public:
+  // encode block of transform coefficients with common exponent (lossy modes only)
+  size_t encode_block_coefficients(size_t offset, const int_type* coeff, int emax)
+  {
+    stream_wseek(zfp->stream, offset);
+    size_t size = cpp::encode_block_coefficients<dims>(zfp, coeff, emax);
+    size += flush();
+    return size;
+  }
+
+  // decode block to transform coefficients and common exponent (lossy modes only)
+  size_t decode_block_coefficients(size_t offset, int_type* coeff, int& emax)
+  {
+    stream_rseek(zfp->stream, offset);
+    size_t size = cpp::decode_block_coefficients<dims>(zfp, coeff, &emax);
+    size += zfp_stream_align(zfp);
+    return size;
+  }
+
+  // decode full block to (2^level)^dims sub-block averages (zero if unsupported)
+  size_t decode_block_lod(size_t offset, Scalar* block, uint level)
+  {
+    stream_rseek(zfp->stream, offset);
+    size_t size = cpp::decode_block_lod<Scalar, dims>(zfp, block, level);
+    if (size)
+      size += zfp_stream_align(zfp);
+    return size;
+  }
+
+protected:
+
   static const size_t block_size = 1u << (2 * dims); // block size in number of scalars
 
   zfp_stream* zfp; // compressed zfp stream
+  bool padding;    // whether block sizes include padding to word boundaries
 };
 
 // zfp codec templated on scalar type and number of dimensions
@@ -103,7 +220,7 @@ public:
     }
     else
       size = cpp::encode_block_strided<Scalar>(zfp, p, sx);
-    size += zfp_stream_flush(zfp);
+    size += flush();
     return size;
   }
 
@@ -132,6 +249,7 @@ public:
 protected:
   using zfp_codec_base<Scalar, 1>::encode_block;
   using zfp_codec_base<Scalar, 1>::decode_block;
+  using zfp_codec_base<Scalar, 1>::flush;
   using zfp_codec_base<Scalar, 1>::zfp;
 };
 
@@ -161,7 +279,7 @@ public:
     }
     else
       size = cpp::encode_block_strided<Scalar>(zfp, p, sx, sy);
-    size += zfp_stream_flush(zfp);
+    size += flush();
     return size;
   }
 
@@ -191,6 +309,7 @@ public:
 protected:
   using zfp_codec_base<Scalar, 2>::encode_block;
   using zfp_codec_base<Scalar, 2>::decode_block;
+  using zfp_codec_base<Scalar, 2>::flush;
   using zfp_codec_base<Scalar, 2>::zfp;
 };
 
@@ -221,7 +340,7 @@ public:
     }
     else
       size = cpp::encode_block_strided<Scalar>(zfp, p, sx, sy, sz);
-    size += zfp_stream_flush(zfp);
+    size += flush();
     return size;
   }
 
@@ -252,6 +371,7 @@ public:
 protected:
   using zfp_codec_base<Scalar, 3>::encode_block;
   using zfp_codec_base<Scalar, 3>::decode_block;
+  using zfp_codec_base<Scalar, 3>::flush;
   using zfp_codec_base<Scalar, 3>::zfp;
 };
 
@@ -283,7 +403,7 @@ public:
     }
     else
       size = cpp::encode_block_strided<Scalar>(zfp, p, sx, sy, sz, sw);
-    size += zfp_stream_flush(zfp);
+    size += flush();
     return size;
   }
 
@@ -315,6 +435,7 @@ public:
 protected:
   using zfp_codec_base<Scalar, 4>::encode_block;
   using zfp_codec_base<Scalar, 4>::decode_block;
+  using zfp_codec_base<Scalar, 4>::flush;
   using zfp_codec_base<Scalar, 4>::zfp;
 };
 
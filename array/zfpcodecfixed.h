@@ -0,0 +1,343 @@
+#ifndef ZFP_CODEC_FIXED_H
+#define ZFP_CODEC_FIXED_H
+
+#include <climits>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include "zfp.h"
+#include "zfpblockcodec.h"
+#include "zfp/exception.h"
+#include "zfp/traits.h"
+
+namespace zfp {
+
+// base class for zfp coding of {float, double} x {1D, 2D, 3D, 4D} data at a
+// rate fixed at compile time; blocks are encoded by the inlined header-only
+// codec, which emits the same bits as libzfp in fixed-rate mode, so that
+// zfp_codec_fixed and zfp_codec may be used interchangeably on the same
+// compressed data
+template <typename Scalar, uint dims, uint bits_per_value>
+class zfp_codec_fixed_base {
+protected:
+  typedef zfp::cpp::block_codec<Scalar, dims> block_codec;
+
+  // constructor takes pre-allocated buffer of compressed blocks
+  zfp_codec_fixed_base(void* data, size_t size) :
+    words(static_cast<uint64*>(data)),
+    bytes(size)
+  {
+    if (stream_alignment() != word_bits)
+      throw zfp::exception("zfp fixed-rate codec requires 64-bit stream words");
+  }
+
+public:
+  // return nearest rate supported, which is independent of target rate
+  static double nearest_rate(double /*target_rate*/) { return rate(); }
+
+  // rate in bits/value
+  static double rate() { return double(block_bits) / block_size; }
+
+  // set rate in bits/value; the rate is fixed and cannot be changed
+  double set_rate(double /*rate*/) { return rate(); }
+
+  // precision in uncompressed bits/value (fixed-precision mode only)
+  uint precision() const { return 0; }
+
+  // fixed-precision mode is not supported
+  uint set_precision(uint /*precision*/) { throw zfp::exception("zfp fixed-rate codec supports only fixed-rate mode"); }
+
+  // absolute error tolerance (fixed-accuracy mode only)
+  double accuracy() const { return 0.0; }
+
+  // fixed-accuracy mode is not supported
+  double set_accuracy(double /*tolerance*/) { throw zfp::exception("zfp fixed-rate codec supports only fixed-rate mode"); }
+
+  // reversible mode is not supported
+  void set_reversible() { throw zfp::exception("zfp fixed-rate codec supports only fixed-rate mode"); }
+
+  // associate codec with a new buffer of compressed blocks
+  void open(void* data, size_t size)
+  {
+    words = static_cast<uint64*>(data);
+    bytes = size;
+  }
+
+  // pointer to and size in bytes of buffer that codec is attached to
+  void* buffer() const { return words; }
+  size_t buffer_size() const { return bytes; }
+
+  static const zfp_type type = zfp::trait<Scalar>::type; // scalar type
+
+  // zfp::codec_base::header class for array (de)serialization
+  #include "zfp/zfpheader.h"
+
+protected:
+  static const uint word_bits = 64;                            // bits per stream word
+  static const uint block_size = block_codec::block_size;      // block size in number of scalars
+  static const uint min_bits = bits_per_value * block_size > block_codec::min_bits ? bits_per_value * block_size : block_codec::min_bits; // bits per block before alignment
+  static const uint block_bits = (min_bits + word_bits - 1) & ~(word_bits - 1); // bits per block rounded up to whole words
+
+  // encode contiguous block at bit offset
+  size_t encode(size_t offset, const Scalar* block) { return block_codec::encode_block(words, offset, block_bits, block); }
+
+  // decode contiguous block at bit offset
+  size_t decode(size_t offset, Scalar* block) const { return block_codec::decode_block(words, offset, block_bits, block); }
+
+  // pad partial block of width n <= 4 and stride s
+  static void pad_block(Scalar* p, uint n, uint s) { block_codec::pad_block(p, n, s); }
+
+  uint64* words; // buffer of compressed blocks
+  size_t bytes;  // buffer size in bytes
+};
+
+// zfp codec templated on scalar type, number of dimensions, and rate in
+// bits per value fixed at compile time
+template <typename Scalar, uint dims, uint bits_per_value>
+class zfp_codec_fixed;
+
+// 1D codec
+template <typename Scalar, uint bits_per_value>
+class zfp_codec_fixed<Scalar, 1, bits_per_value> : public zfp_codec_fixed_base<Scalar, 1, bits_per_value> {
+public:
+  // constructor takes pre-allocated buffer of compressed blocks
+  zfp_codec_fixed(void* data, size_t size) : zfp_codec_fixed_base<Scalar, 1, bits_per_value>(data, size) {}
+
+  // encode contiguous 1D block
+  size_t encode_block(size_t offset, uint shape, const Scalar* block)
+  {
+    return shape ? encode_block_strided(offset, shape, block, 1)
+                 : encode(offset, block);
+  }
+
+  // encode 1D block from strided storage
+  size_t encode_block_strided(size_t offset, uint shape, const Scalar* p, ptrdiff_t sx)
+  {
+    Scalar block[4];
+    uint nx = 4 - (shape & 3u); shape >>= 2;
+    for (uint x = 0; x < nx; x++, p += sx)
+      block[x] = *p;
+    pad_block(block, nx, 1);
+    return encode(offset, block);
+  }
+
+  // decode contiguous 1D block
+  size_t decode_block(size_t offset, uint shape, Scalar* block)
+  {
+    return shape ? decode_block_strided(offset, shape, block, 1)
+                 : decode(offset, block);
+  }
+
+  // decode 1D block to strided storage
+  size_t decode_block_strided(size_t offset, uint shape, Scalar* p, ptrdiff_t sx)
+  {
+    Scalar block[4];
+    size_t size = decode(offset, block);
+    uint nx = 4 - (shape & 3u); shape >>= 2;
+    for (uint x = 0; x < nx; x++, p += sx)
+      *p = block[x];
+    return size;
+  }
+
+protected:
+  using zfp_codec_fixed_base<Scalar, 1, bits_per_value>::encode;
+  using zfp_codec_fixed_base<Scalar, 1, bits_per_value>::decode;
+  using zfp_codec_fixed_base<Scalar, 1, bits_per_value>::pad_block;
+};
+
+// 2D codec
+template <typename Scalar, uint bits_per_value>
+class zfp_codec_fixed<Scalar, 2, bits_per_value> : public zfp_codec_fixed_base<Scalar, 2, bits_per_value> {
+public:
+  // constructor takes pre-allocated buffer of compressed blocks
+  zfp_codec_fixed(void* data, size_t size) : zfp_codec_fixed_base<Scalar, 2, bits_per_value>(data, size) {}
+
+  // encode contiguous 2D block
+  size_t encode_block(size_t offset, uint shape, const Scalar* block)
+  {
+    return shape ? encode_block_strided(offset, shape, block, 1, 4)
+                 : encode(offset, block);
+  }
+
+  // encode 2D block from strided storage
+  size_t encode_block_strided(size_t offset, uint shape, const Scalar* p, ptrdiff_t sx, ptrdiff_t sy)
+  {
+    Scalar block[16];
+    uint nx = 4 - (shape & 3u); shape >>= 2;
+    uint ny = 4 - (shape & 3u); shape >>= 2;
+    for (uint y = 0; y < ny; y++, p += sy - (ptrdiff_t)nx * sx) {
+      for (uint x = 0; x < nx; x++, p += sx)
+        block[4 * y + x] = *p;
+      pad_block(block + 4 * y, nx, 1);
+    }
+    for (uint x = 0; x < 4; x++)
+      pad_block(block + x, ny, 4);
+    return encode(offset, block);
+  }
+
+  // decode contiguous 2D block
+  size_t decode_block(size_t offset, uint shape, Scalar* block)
+  {
+    return shape ? decode_block_strided(offset, shape, block, 1, 4)
+                 : decode(offset, block);
+  }
+
+  // decode 2D block to strided storage
+  size_t decode_block_strided(size_t offset, uint shape, Scalar* p, ptrdiff_t sx, ptrdiff_t sy)
+  {
+    Scalar block[16];
+    size_t size = decode(offset, block);
+    uint nx = 4 - (shape & 3u); shape >>= 2;
+    uint ny = 4 - (shape & 3u); shape >>= 2;
+    for (uint y = 0; y < ny; y++, p += sy - (ptrdiff_t)nx * sx)
+      for (uint x = 0; x < nx; x++, p += sx)
+        *p = block[4 * y + x];
+    return size;
+  }
+
+protected:
+  using zfp_codec_fixed_base<Scalar, 2, bits_per_value>::encode;
+  using zfp_codec_fixed_base<Scalar, 2, bits_per_value>::decode;
+  using zfp_codec_fixed_base<Scalar, 2, bits_per_value>::pad_block;
+};
+
+// 3D codec
+template <typename Scalar, uint bits_per_value>
+class zfp_codec_fixed<Scalar, 3, bits_per_value> : public zfp_codec_fixed_base<Scalar, 3, bits_per_value> {
+public:
+  // constructor takes pre-allocated buffer of compressed blocks
+  zfp_codec_fixed(void* data, size_t size) : zfp_codec_fixed_base<Scalar, 3, bits_per_value>(data, size) {}
+
+  // encode contiguous 3D block
+  size_t encode_block(size_t offset, uint shape, const Scalar* block)
+  {
+    return shape ? encode_block_strided(offset, shape, block, 1, 4, 16)
+                 : encode(offset, block);
+  }
+
+  // encode 3D block from strided storage
+  size_t encode_block_strided(size_t offset, uint shape, const Scalar* p, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz)
+  {
+    Scalar block[64];
+    uint nx = 4 - (shape & 3u); shape >>= 2;
+    uint ny = 4 - (shape & 3u); shape >>= 2;
+    uint nz = 4 - (shape & 3u); shape >>= 2;
+    for (uint z = 0; z < nz; z++, p += sz - (ptrdiff_t)ny * sy) {
+      for (uint y = 0; y < ny; y++, p += sy - (ptrdiff_t)nx * sx) {
+        for (uint x = 0; x < nx; x++, p += sx)
+          block[16 * z + 4 * y + x] = *p;
+        pad_block(block + 16 * z + 4 * y, nx, 1);
+      }
+      for (uint x = 0; x < 4; x++)
+        pad_block(block + 16 * z + x, ny, 4);
+    }
+    for (uint y = 0; y < 4; y++)
+      for (uint x = 0; x < 4; x++)
+        pad_block(block + 4 * y + x, nz, 16);
+    return encode(offset, block);
+  }
+
+  // decode contiguous 3D block
+  size_t decode_block(size_t offset, uint shape, Scalar* block)
+  {
+    return shape ? decode_block_strided(offset, shape, block, 1, 4, 16)
+                 : decode(offset, block);
+  }
+
+  // decode 3D block to strided storage
+  size_t decode_block_strided(size_t offset, uint shape, Scalar* p, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz)
+  {
+    Scalar block[64];
+    size_t size = decode(offset, block);
+    uint nx = 4 - (shape & 3u); shape >>= 2;
+    uint ny = 4 - (shape & 3u); shape >>= 2;
+    uint nz = 4 - (shape & 3u); shape >>= 2;
+    for (uint z = 0; z < nz; z++, p += sz - (ptrdiff_t)ny * sy)
+      for (uint y = 0; y < ny; y++, p += sy - (ptrdiff_t)nx * sx)
+        for (uint x = 0; x < nx; x++, p += sx)
+          *p = block[16 * z + 4 * y + x];
+    return size;
+  }
+
+protected:
+  using zfp_codec_fixed_base<Scalar, 3, bits_per_value>::encode;
+  using zfp_codec_fixed_base<Scalar, 3, bits_per_value>::decode;
+  using zfp_codec_fixed_base<Scalar, 3, bits_per_value>::pad_block;
+};
+
+// 4D codec
+template <typename Scalar, uint bits_per_value>
+class zfp_codec_fixed<Scalar, 4, bits_per_value> : public zfp_codec_fixed_base<Scalar, 4, bits_per_value> {
+public:
+  // constructor takes pre-allocated buffer of compressed blocks
+  zfp_codec_fixed(void* data, size_t size) : zfp_codec_fixed_base<Scalar, 4, bits_per_value>(data, size) {}
+
+  // encode contiguous 4D block
+  size_t encode_block(size_t offset, uint shape, const Scalar* block)
+  {
+    return shape ? encode_block_strided(offset, shape, block, 1, 4, 16, 64)
+                 : encode(offset, block);
+  }
+
+  // encode 4D block from strided storage
+  size_t encode_block_strided(size_t offset, uint shape, const Scalar* p, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz, ptrdiff_t sw)
+  {
+    Scalar block[256];
+    uint nx = 4 - (shape & 3u); shape >>= 2;
+    uint ny = 4 - (shape & 3u); shape >>= 2;
+    uint nz = 4 - (shape & 3u); shape >>= 2;
+    uint nw = 4 - (shape & 3u); shape >>= 2;
+    for (uint w = 0; w < nw; w++, p += sw - (ptrdiff_t)nz * sz) {
+      for (uint z = 0; z < nz; z++, p += sz - (ptrdiff_t)ny * sy) {
+        for (uint y = 0; y < ny; y++, p += sy - (ptrdiff_t)nx * sx) {
+          for (uint x = 0; x < nx; x++, p += sx)
+            block[64 * w + 16 * z + 4 * y + x] = *p;
+          pad_block(block + 64 * w + 16 * z + 4 * y, nx, 1);
+        }
+        for (uint x = 0; x < 4; x++)
+          pad_block(block + 64 * w + 16 * z + x, ny, 4);
+      }
+      for (uint y = 0; y < 4; y++)
+        for (uint x = 0; x < 4; x++)
+          pad_block(block + 64 * w + 4 * y + x, nz, 16);
+    }
+    for (uint z = 0; z < 4; z++)
+      for (uint y = 0; y < 4; y++)
+        for (uint x = 0; x < 4; x++)
+          pad_block(block + 16 * z + 4 * y + x, nw, 64);
+    return encode(offset, block);
+  }
+
+  // decode contiguous 4D block
+  size_t decode_block(size_t offset, uint shape, Scalar* block)
+  {
+    return shape ? decode_block_strided(offset, shape, block, 1, 4, 16, 64)
+                 : decode(offset, block);
+  }
+
+  // decode 4D block to strided storage
+  size_t decode_block_strided(size_t offset, uint shape, Scalar* p, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz, ptrdiff_t sw)
+  {
+    Scalar block[256];
+    size_t size = decode(offset, block);
+    uint nx = 4 - (shape & 3u); shape >>= 2;
+    uint ny = 4 - (shape & 3u); shape >>= 2;
+    uint nz = 4 - (shape & 3u); shape >>= 2;
+    uint nw = 4 - (shape & 3u); shape >>= 2;
+    for (uint w = 0; w < nw; w++, p += sw - (ptrdiff_t)nz * sz)
+      for (uint z = 0; z < nz; z++, p += sz - (ptrdiff_t)ny * sy)
+        for (uint y = 0; y < ny; y++, p += sy - (ptrdiff_t)nx * sx)
+          for (uint x = 0; x < nx; x++, p += sx)
+            *p = block[64 * w + 16 * z + 4 * y + x];
+    return size;
+  }
+
+protected:
+  using zfp_codec_fixed_base<Scalar, 4, bits_per_value>::encode;
+  using zfp_codec_fixed_base<Scalar, 4, bits_per_value>::decode;
+  using zfp_codec_fixed_base<Scalar, 4, bits_per_value>::pad_block;
+};
+
+}
+
+#endif
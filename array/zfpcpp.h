@@ -45,6 +45,14 @@ template <typename Scalar>
 inline size_t
 encode_partial_block_strided(zfp_stream* zfp, const Scalar* p, size_t nx, size_t ny, size_t nz, size_t nw, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz, ptrdiff_t sw);
 
+template <uint dims>
+inline size_t
+encode_block_coefficients(zfp_stream* zfp, const int32* coeff, int emax);
+
+template <uint dims>
+inline size_t
+encode_block_coefficients(zfp_stream* zfp, const int64* coeff, int emax);
+
 // encoder specializations ----------------------------------------------------
 
 template<>
@@ -79,6 +87,38 @@ template<>
 inline size_t
 encode_block<double, 4>(zfp_stream* zfp, const double* block) { return zfp_encode_block_double_4(zfp, block); }
 
+template<>
+inline size_t
+encode_block<int32, 1>(zfp_stream* zfp, const int32* block) { return zfp_encode_block_int32_1(zfp, block); }
+
+template<>
+inline size_t
+encode_block<int32, 2>(zfp_stream* zfp, const int32* block) { return zfp_encode_block_int32_2(zfp, block); }
+
+template<>
+inline size_t
+encode_block<int32, 3>(zfp_stream* zfp, const int32* block) { return zfp_encode_block_int32_3(zfp, block); }
+
+template<>
+inline size_t
+encode_block<int32, 4>(zfp_stream* zfp, const int32* block) { return zfp_encode_block_int32_4(zfp, block); }
+
+template<>
+inline size_t
+encode_block<int64, 1>(zfp_stream* zfp, const int64* block) { return zfp_encode_block_int64_1(zfp, block); }
+
+template<>
+inline size_t
+encode_block<int64, 2>(zfp_stream* zfp, const int64* block) { return zfp_encode_block_int64_2(zfp, block); }
+
+template<>
+inline size_t
+encode_block<int64, 3>(zfp_stream* zfp, const int64* block) { return zfp_encode_block_int64_3(zfp, block); }
+
+template<>
+inline size_t
+encode_block<int64, 4>(zfp_stream* zfp, const int64* block) { return zfp_encode_block_int64_4(zfp, block); }
+
 template <>
 inline size_t
 encode_block_strided<float>(zfp_stream* zfp, const float* p, ptrdiff_t sx) { return zfp_encode_block_strided_float_1(zfp, p, (int)sx); }
@@ -111,6 +151,38 @@ template <>
 inline size_t
 encode_block_strided<double>(zfp_stream* zfp, const double* p, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz, ptrdiff_t sw) { return zfp_encode_block_strided_double_4(zfp, p, (int)sx, (int)sy, (int)sz, (int)sw); }
 
+template <>
+inline size_t
+encode_block_strided<int32>(zfp_stream* zfp, const int32* p, ptrdiff_t sx) { return zfp_encode_block_strided_int32_1(zfp, p, (int)sx); }
+
+template <>
+inline size_t
+encode_block_strided<int32>(zfp_stream* zfp, const int32* p, ptrdiff_t sx, ptrdiff_t sy) { return zfp_encode_block_strided_int32_2(zfp, p, (int)sx, (int)sy); }
+
+template <>
+inline size_t
+encode_block_strided<int32>(zfp_stream* zfp, const int32* p, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz) { return zfp_encode_block_strided_int32_3(zfp, p, (int)sx, (int)sy, (int)sz); }
+
+template <>
+inline size_t
+encode_block_strided<int32>(zfp_stream* zfp, const int32* p, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz, ptrdiff_t sw) { return zfp_encode_block_strided_int32_4(zfp, p, (int)sx, (int)sy, (int)sz, (int)sw); }
+
+template <>
+inline size_t
+encode_block_strided<int64>(zfp_stream* zfp, const int64* p, ptrdiff_t sx) { return zfp_encode_block_strided_int64_1(zfp, p, (int)sx); }
+
+template <>
+inline size_t
+encode_block_strided<int64>(zfp_stream* zfp, const int64* p, ptrdiff_t sx, ptrdiff_t sy) { return zfp_encode_block_strided_int64_2(zfp, p, (int)sx, (int)sy); }
+
+template <>
+inline size_t
+encode_block_strided<int64>(zfp_stream* zfp, const int64* p, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz) { return zfp_encode_block_strided_int64_3(zfp, p, (int)sx, (int)sy, (int)sz); }
+
+template <>
+inline size_t
+encode_block_strided<int64>(zfp_stream* zfp, const int64* p, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz, ptrdiff_t sw) { return zfp_encode_block_strided_int64_4(zfp, p, (int)sx, (int)sy, (int)sz, (int)sw); }
+
 template <>
 inline size_t
 encode_partial_block_strided<float>(zfp_stream* zfp, const float* p, size_t nx, ptrdiff_t sx)
@@ -145,6 +217,72 @@ template <>
 inline size_t
 encode_partial_block_strided<double>(zfp_stream* zfp, const double* p, size_t nx, size_t ny, size_t nz, size_t nw, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz, ptrdiff_t sw) { return zfp_encode_partial_block_strided_double_4(zfp, p, (uint)nx, (uint)ny, (uint)nz, (uint)nw, (int)sx, (int)sy, (int)sz, (int)sw); }
 
+template <>
+inline size_t
+encode_partial_block_strided<int32>(zfp_stream* zfp, const int32* p, size_t nx, ptrdiff_t sx)
+{ return zfp_encode_partial_block_strided_int32_1(zfp, p, (uint)nx, (int)sx); }
+
+template <>
+inline size_t
+encode_partial_block_strided<int32>(zfp_stream* zfp, const int32* p, size_t nx, size_t ny, ptrdiff_t sx, ptrdiff_t sy) { return zfp_encode_partial_block_strided_int32_2(zfp, p, (uint)nx, (uint)ny, (int)sx, (int)sy); }
+
+template <>
+inline size_t
+encode_partial_block_strided<int32>(zfp_stream* zfp, const int32* p, size_t nx, size_t ny, size_t nz, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz) { return zfp_encode_partial_block_strided_int32_3(zfp, p, (uint)nx, (uint)ny, (uint)nz, (int)sx, (int)sy, (int)sz); }
+
+template <>
+inline size_t
+encode_partial_block_strided<int32>(zfp_stream* zfp, const int32* p, size_t nx, size_t ny, size_t nz, size_t nw, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz, ptrdiff_t sw) { return zfp_encode_partial_block_strided_int32_4(zfp, p, (uint)nx, (uint)ny, (uint)nz, (uint)nw, (int)sx, (int)sy, (int)sz, (int)sw); }
+
+template <>
+inline size_t
+encode_partial_block_strided<int64>(zfp_stream* zfp, const int64* p, size_t nx, ptrdiff_t sx)
+{ return zfp_encode_partial_block_strided_int64_1(zfp, p, (uint)nx, (int)sx); }
+
+template <>
+inline size_t
+encode_partial_block_strided<int64>(zfp_stream* zfp, const int64* p, size_t nx, size_t ny, ptrdiff_t sx, ptrdiff_t sy) { return zfp_encode_partial_block_strided_int64_2(zfp, p, (uint)nx, (uint)ny, (int)sx, (int)sy); }
+
+template <>
+inline size_t
+encode_partial_block_strided<int64>(zfp_stream* zfp, const int64* p, size_t nx, size_t ny, size_t nz, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz) { return zfp_encode_partial_block_strided_int64_3(zfp, p, (uint)nx, (uint)ny, (uint)nz, (int)sx, (int)sy, (int)sz); }
+
+template <>
+inline size_t
+encode_partial_block_strided<int64>(zfp_stream* zfp, const int64* p, size_t nx, size_t ny, size_t nz, size_t nw, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz, ptrdiff_t sw) { return zfp_encode_partial_block_strided_int64_4(zfp, p, (uint)nx, (uint)ny, (uint)nz, (uint)nw, (int)sx, (int)sy, (int)sz, (int)sw); }
+
+template <>
+inline size_t
+encode_block_coefficients<1>(zfp_stream* zfp, const int32* coeff, int emax) { return zfp_encode_block_coefficients_float_1(zfp, coeff, emax); }
+
+template <>
+inline size_t
+encode_block_coefficients<2>(zfp_stream* zfp, const int32* coeff, int emax) { return zfp_encode_block_coefficients_float_2(zfp, coeff, emax); }
+
+template <>
+inline size_t
+encode_block_coefficients<3>(zfp_stream* zfp, const int32* coeff, int emax) { return zfp_encode_block_coefficients_float_3(zfp, coeff, emax); }
+
+template <>
+inline size_t
+encode_block_coefficients<4>(zfp_stream* zfp, const int32* coeff, int emax) { return zfp_encode_block_coefficients_float_4(zfp, coeff, emax); }
+
+template <>
+inline size_t
+encode_block_coefficients<1>(zfp_stream* zfp, const int64* coeff, int emax) { return zfp_encode_block_coefficients_double_1(zfp, coeff, emax); }
+
+template <>
+inline size_t
+encode_block_coefficients<2>(zfp_stream* zfp, const int64* coeff, int emax) { return zfp_encode_block_coefficients_double_2(zfp, coeff, emax); }
+
+template <>
+inline size_t
+encode_block_coefficients<3>(zfp_stream* zfp, const int64* coeff, int emax) { return zfp_encode_block_coefficients_double_3(zfp, coeff, emax); }
+
+template <>
+inline size_t
+encode_block_coefficients<4>(zfp_stream* zfp, const int64* coeff, int emax) { return zfp_encode_block_coefficients_double_4(zfp, coeff, emax); }
+
 // decoder declarations -------------------------------------------------------
 
 template <typename Scalar, uint dims>
@@ -183,6 +321,18 @@ template <typename Scalar>
 inline size_t
 decode_partial_block_strided(zfp_stream* zfp, Scalar* p, size_t nx, size_t ny, size_t nz, size_t nw, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz, ptrdiff_t sw);
 
+template <uint dims>
+inline size_t
+decode_block_coefficients(zfp_stream* zfp, int32* coeff, int* emax);
+
+template <uint dims>
+inline size_t
+decode_block_coefficients(zfp_stream* zfp, int64* coeff, int* emax);
+
+template <typename Scalar, uint dims>
+inline size_t
+decode_block_lod(zfp_stream* zfp, Scalar* block, uint level);
+
 // decoder specializations ----------------------------------------------------
 
 template<>
@@ -217,6 +367,38 @@ template<>
 inline size_t
 decode_block<double, 4>(zfp_stream* zfp, double* block) { return zfp_decode_block_double_4(zfp, block); }
 
+template<>
+inline size_t
+decode_block<int32, 1>(zfp_stream* zfp, int32* block) { return zfp_decode_block_int32_1(zfp, block); }
+
+template<>
+inline size_t
+decode_block<int32, 2>(zfp_stream* zfp, int32* block) { return zfp_decode_block_int32_2(zfp, block); }
+
+template<>
+inline size_t
+decode_block<int32, 3>(zfp_stream* zfp, int32* block) { return zfp_decode_block_int32_3(zfp, block); }
+
+template<>
+inline size_t
+decode_block<int32, 4>(zfp_stream* zfp, int32* block) { return zfp_decode_block_int32_4(zfp, block); }
+
+template<>
+inline size_t
+decode_block<int64, 1>(zfp_stream* zfp, int64* block) { return zfp_decode_block_int64_1(zfp, block); }
+
+template<>
+inline size_t
+decode_block<int64, 2>(zfp_stream* zfp, int64* block) { return zfp_decode_block_int64_2(zfp, block); }
+
+template<>
+inline size_t
+decode_block<int64, 3>(zfp_stream* zfp, int64* block) { return zfp_decode_block_int64_3(zfp, block); }
+
+template<>
+inline size_t
+decode_block<int64, 4>(zfp_stream* zfp, int64* block) { return zfp_decode_block_int64_4(zfp, block); }
+
 template <>
 inline size_t
 decode_block_strided<float>(zfp_stream* zfp, float* p, ptrdiff_t sx) { return zfp_decode_block_strided_float_1(zfp, p, (int)sx); }
@@ -249,6 +431,38 @@ template <>
 inline size_t
 decode_block_strided<double>(zfp_stream* zfp, double* p, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz, ptrdiff_t sw) { return zfp_decode_block_strided_double_4(zfp, p, (int)sx, (int)sy, (int)sz, (int)sw); }
 
+template <>
+inline size_t
+decode_block_strided<int32>(zfp_stream* zfp, int32* p, ptrdiff_t sx) { return zfp_decode_block_strided_int32_1(zfp, p, (int)sx); }
+
+template <>
+inline size_t
+decode_block_strided<int32>(zfp_stream* zfp, int32* p, ptrdiff_t sx, ptrdiff_t sy) { return zfp_decode_block_strided_int32_2(zfp, p, (int)sx, (int)sy); }
+
+template <>
+inline size_t
+decode_block_strided<int32>(zfp_stream* zfp, int32* p, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz) { return zfp_decode_block_strided_int32_3(zfp, p, (int)sx, (int)sy, (int)sz); }
+
+template <>
+inline size_t
+decode_block_strided<int32>(zfp_stream* zfp, int32* p, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz, ptrdiff_t sw) { return zfp_decode_block_strided_int32_4(zfp, p, (int)sx, (int)sy, (int)sz, (int)sw); }
+
+template <>
+inline size_t
+decode_block_strided<int64>(zfp_stream* zfp, int64* p, ptrdiff_t sx) { return zfp_decode_block_strided_int64_1(zfp, p, (int)sx); }
+
+template <>
+inline size_t
+decode_block_strided<int64>(zfp_stream* zfp, int64* p, ptrdiff_t sx, ptrdiff_t sy) { return zfp_decode_block_strided_int64_2(zfp, p, (int)sx, (int)sy); }
+
+template <>
+inline size_t
+decode_block_strided<int64>(zfp_stream* zfp, int64* p, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz) { return zfp_decode_block_strided_int64_3(zfp, p, (int)sx, (int)sy, (int)sz); }
+
+template <>
+inline size_t
+decode_block_strided<int64>(zfp_stream* zfp, int64* p, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz, ptrdiff_t sw) { return zfp_decode_block_strided_int64_4(zfp, p, (int)sx, (int)sy, (int)sz, (int)sw); }
+
 template <>
 inline size_t
 decode_partial_block_strided<float>(zfp_stream* zfp, float* p, size_t nx, ptrdiff_t sx) { return zfp_decode_partial_block_strided_float_1(zfp, p, (uint)nx, (int)sx); }
@@ -281,6 +495,134 @@ template <>
 inline size_t
 decode_partial_block_strided<double>(zfp_stream* zfp, double* p, size_t nx, size_t ny, size_t nz, size_t nw, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz, ptrdiff_t sw) { return zfp_decode_partial_block_strided_double_4(zfp, p, (uint)nx, (uint)ny, (uint)nz, (uint)nw, (int)sx, (int)sy, (int)sz, (int)sw); }
 
+template <>
+inline size_t
+decode_partial_block_strided<int32>(zfp_stream* zfp, int32* p, size_t nx, ptrdiff_t sx) { return zfp_decode_partial_block_strided_int32_1(zfp, p, (uint)nx, (int)sx); }
+
+template <>
+inline size_t
+decode_partial_block_strided<int32>(zfp_stream* zfp, int32* p, size_t nx, size_t ny, ptrdiff_t sx, ptrdiff_t sy) { return zfp_decode_partial_block_strided_int32_2(zfp, p, (uint)nx, (uint)ny, (int)sx, (int)sy); }
+
+template <>
+inline size_t
+decode_partial_block_strided<int32>(zfp_stream* zfp, int32* p, size_t nx, size_t ny, size_t nz, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz) { return zfp_decode_partial_block_strided_int32_3(zfp, p, (uint)nx, (uint)ny, (uint)nz, (int)sx, (int)sy, (int)sz); }
+
+template <>
+inline size_t
+decode_partial_block_strided<int32>(zfp_stream* zfp, int32* p, size_t nx, size_t ny, size_t nz, size_t nw, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz, ptrdiff_t sw) { return zfp_decode_partial_block_strided_int32_4(zfp, p, (uint)nx, (uint)ny, (uint)nz, (uint)nw, (int)sx, (int)sy, (int)sz, (int)sw); }
+
+template <>
+inline size_t
+decode_partial_block_strided<int64>(zfp_stream* zfp, int64* p, size_t nx, ptrdiff_t sx) { return zfp_decode_partial_block_strided_int64_1(zfp, p, (uint)nx, (int)sx); }
+
+template <>
+inline size_t
+decode_partial_block_strided<int64>(zfp_stream* zfp, int64* p, size_t nx, size_t ny, ptrdiff_t sx, ptrdiff_t sy) { return zfp_decode_partial_block_strided_int64_2(zfp, p, (uint)nx, (uint)ny, (int)sx, (int)sy); }
+
+template <>
+inline size_t
+decode_partial_block_strided<int64>(zfp_stream* zfp, int64* p, size_t nx, size_t ny, size_t nz, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz) { return zfp_decode_partial_block_strided_int64_3(zfp, p, (uint)nx, (uint)ny, (uint)nz, (int)sx, (int)sy, (int)sz); }
+
+template <>
+inline size_t
+decode_partial_block_strided<int64>(zfp_stream* zfp, int64* p, size_t nx, size_t ny, size_t nz, size_t nw, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz, ptrdiff_t sw) { return zfp_decode_partial_block_strided_int64_4(zfp, p, (uint)nx, (uint)ny, (uint)nz, (uint)nw, (int)sx, (int)sy, (int)sz, (int)sw); }
+
+template <>
+inline size_t
+decode_block_coefficients<1>(zfp_stream* zfp, int32* coeff, int* emax) { return zfp_decode_block_coefficients_float_1(zfp, coeff, emax); }
+
+template <>
+inline size_t
+decode_block_coefficients<2>(zfp_stream* zfp, int32* coeff, int* emax) { return zfp_decode_block_coefficients_float_2(zfp, coeff, emax); }
+
+template <>
+inline size_t
+decode_block_coefficients<3>(zfp_stream* zfp, int32* coeff, int* emax) { return zfp_decode_block_coefficients_float_3(zfp, coeff, emax); }
+
+template <>
+inline size_t
+decode_block_coefficients<4>(zfp_stream* zfp, int32* coeff, int* emax) { return zfp_decode_block_coefficients_float_4(zfp, coeff, emax); }
+
+template <>
+inline size_t
+decode_block_coefficients<1>(zfp_stream* zfp, int64* coeff, int* emax) { return zfp_decode_block_coefficients_double_1(zfp, coeff, emax); }
+
+template <>
+inline size_t
+decode_block_coefficients<2>(zfp_stream* zfp, int64* coeff, int* emax) { return zfp_decode_block_coefficients_double_2(zfp, coeff, emax); }
+
+template <>
+inline size_t
+decode_block_coefficients<3>(zfp_stream* zfp, int64* coeff, int* emax) { return zfp_decode_block_coefficients_double_3(zfp, coeff, emax); }
+
+template <>
+inline size_t
+decode_block_coefficients<4>(zfp_stream* zfp, int64* coeff, int* emax) { return zfp_decode_block_coefficients_double_4(zfp, coeff, emax); }
+
+template <>
+inline size_t
+decode_block_lod<float, 1>(zfp_stream* zfp, float* block, uint level) { return zfp_decode_block_lod_float_1(zfp, block, level); }
+
+template <>
+inline size_t
+decode_block_lod<float, 2>(zfp_stream* zfp, float* block, uint level) { return zfp_decode_block_lod_float_2(zfp, block, level); }
+
+template <>
+inline size_t
+decode_block_lod<float, 3>(zfp_stream* zfp, float* block, uint level) { return zfp_decode_block_lod_float_3(zfp, block, level); }
+
+template <>
+inline size_t
+decode_block_lod<float, 4>(zfp_stream* zfp, float* block, uint level) { return zfp_decode_block_lod_float_4(zfp, block, level); }
+
+template <>
+inline size_t
+decode_block_lod<double, 1>(zfp_stream* zfp, double* block, uint level) { return zfp_decode_block_lod_double_1(zfp, block, level); }
+
+template <>
+inline size_t
+decode_block_lod<double, 2>(zfp_stream* zfp, double* block, uint level) { return zfp_decode_block_lod_double_2(zfp, block, level); }
+
+template <>
+inline size_t
+decode_block_lod<double, 3>(zfp_stream* zfp, double* block, uint level) { return zfp_decode_block_lod_double_3(zfp, block, level); }
+
+template <>
+inline size_t
+decode_block_lod<double, 4>(zfp_stream* zfp, double* block, uint level) { return zfp_decode_block_lod_double_4(zfp, block, level); }
+
+template <>
+inline size_t
+decode_block_lod<int32, 1>(zfp_stream* zfp, int32* block, uint level) { return zfp_decode_block_lod_int32_1(zfp, block, level); }
+
+template <>
+inline size_t
+decode_block_lod<int32, 2>(zfp_stream* zfp, int32* block, uint level) { return zfp_decode_block_lod_int32_2(zfp, block, level); }
+
+template <>
+inline size_t
+decode_block_lod<int32, 3>(zfp_stream* zfp, int32* block, uint level) { return zfp_decode_block_lod_int32_3(zfp, block, level); }
+
+template <>
+inline size_t
+decode_block_lod<int32, 4>(zfp_stream* zfp, int32* block, uint level) { return zfp_decode_block_lod_int32_4(zfp, block, level); }
+
+template <>
+inline size_t
+decode_block_lod<int64, 1>(zfp_stream* zfp, int64* block, uint level) { return zfp_decode_block_lod_int64_1(zfp, block, level); }
+
+template <>
+inline size_t
+decode_block_lod<int64, 2>(zfp_stream* zfp, int64* block, uint level) { return zfp_decode_block_lod_int64_2(zfp, block, level); }
+
+template <>
+inline size_t
+decode_block_lod<int64, 3>(zfp_stream* zfp, int64* block, uint level) { return zfp_decode_block_lod_int64_3(zfp, block, level); }
+
+template <>
+inline size_t
+decode_block_lod<int64, 4>(zfp_stream* zfp, int64* block, uint level) { return zfp_decode_block_lod_int64_4(zfp, block, level); }
+
 }
 }
 
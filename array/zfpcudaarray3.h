@@ -0,0 +1,298 @@
+#ifndef ZFP_CUDA_ARRAY3_H
+#define ZFP_CUDA_ARRAY3_H
+
+#include <cstddef>
+#include <cuda_runtime.h>
+#include "zfparray3.h"
+#include "zfpblockcodec.h"
+#include "zfp/exception.h"
+
+// fixed-rate compressed 3D arrays whose compressed blocks reside in device
+// memory; must be compiled with nvcc
+namespace zfp {
+namespace cuda {
+
+// lightweight handle to a device-resident array, passed by value to kernels
+template <typename Scalar>
+class view3 {
+public:
+  typedef Scalar value_type;
+  typedef zfp::cpp::block_codec<Scalar, 3> codec;
+
+  // array dimensions
+  __host__ __device__ size_t size_x() const { return nx; }
+  __host__ __device__ size_t size_y() const { return ny; }
+  __host__ __device__ size_t size_z() const { return nz; }
+
+  // array dimensions in number of blocks
+  __host__ __device__ size_t blocks_x() const { return bx; }
+  __host__ __device__ size_t blocks_y() const { return by; }
+  __host__ __device__ size_t blocks_z() const { return bz; }
+
+  // decompress block (bi, bj, bk) to 64 contiguous values
+  __device__ void decode_block(size_t bi, size_t bj, size_t bk, Scalar* block) const
+  {
+    codec::decode_block(data, offset(bi, bj, bk), bits, block);
+  }
+
+  // compress 64 contiguous values to block (bi, bj, bk), ignoring values
+  // outside the array; different threads may encode different blocks
+  // concurrently
+  __device__ void encode_block(size_t bi, size_t bj, size_t bk, const Scalar* block) const
+  {
+    const uint mx = nx - 4 * bi < 4 ? uint(nx - 4 * bi) : 4u;
+    const uint my = ny - 4 * bj < 4 ? uint(ny - 4 * bj) : 4u;
+    const uint mz = nz - 4 * bk < 4 ? uint(nz - 4 * bk) : 4u;
+    if (mx < 4 || my < 4 || mz < 4) {
+      // pad partial block the same way as zfp does
+      Scalar p[64];
+      for (uint i = 0; i < 64; i++)
+        p[i] = block[i];
+      for (uint z = 0; z < mz; z++) {
+        for (uint y = 0; y < my; y++)
+          codec::pad_block(p + 16 * z + 4 * y, mx, 1);
+        for (uint x = 0; x < 4; x++)
+          codec::pad_block(p + 16 * z + x, my, 4);
+      }
+      for (uint y = 0; y < 4; y++)
+        for (uint x = 0; x < 4; x++)
+          codec::pad_block(p + 4 * y + x, mz, 16);
+      codec::encode_block(data, offset(bi, bj, bk), bits, p);
+    }
+    else
+      codec::encode_block(data, offset(bi, bj, bk), bits, block);
+  }
+
+  // value at (i, j, k); decompresses the whole block, so repeated accesses
+  // should go through a block_cache3
+  __device__ Scalar operator()(size_t i, size_t j, size_t k) const
+  {
+    Scalar block[64];
+    decode_block(i / 4, j / 4, k / 4, block);
+    return block[(i & 3u) + 4 * ((j & 3u) + 4 * (k & 3u))];
+  }
+
+protected:
+  template <typename> friend class array3;
+
+  // bit offset to block (bi, bj, bk) in raster order
+  __host__ __device__ size_t offset(size_t bi, size_t bj, size_t bk) const
+  {
+    return (bi + bx * (bj + by * bk)) * bits;
+  }
+
+  uint64* data;         // compressed blocks in device memory
+  size_t nx, ny, nz;    // array dimensions
+  size_t bx, by, bz;    // array dimensions in number of blocks
+  uint bits;            // number of bits per block
+};
+
+// cache of decompressed blocks in shared memory, declared __shared__ in a
+// kernel and used collectively by the threads of a thread block; the cache
+// holds a box of up to 'lines' blocks, which are loaded and flushed by
+// functions that all threads must call
+template <typename Scalar, uint lines = 8>
+class block_cache3 {
+public:
+  // cache no blocks (collective)
+  __device__ void init()
+  {
+    if (threadIdx.x + blockDim.x * (threadIdx.y + blockDim.y * threadIdx.z) == 0) {
+      mx = my = mz = 0;
+      for (uint l = 0; l < lines; l++)
+        dirty[l] = false;
+    }
+    __syncthreads();
+  }
+
+  // flush modified blocks and cache the box of mx * my * mz <= lines blocks
+  // with first block (bi, bj, bk) (collective)
+  __device__ void load(const view3<Scalar>& v, size_t bi, size_t bj, size_t bk, uint mx, uint my, uint mz)
+  {
+    flush(v);
+    const uint t = threadIdx.x + blockDim.x * (threadIdx.y + blockDim.y * threadIdx.z);
+    const uint threads = blockDim.x * blockDim.y * blockDim.z;
+    // one thread per block decodes into its cache line
+    for (uint l = t; l < mx * my * mz; l += threads)
+      v.decode_block(bi + l % mx, bj + (l / mx) % my, bk + l / (mx * my), line[l]);
+    if (!t) {
+      this->bi = bi;
+      this->bj = bj;
+      this->bk = bk;
+      this->mx = mx;
+      this->my = my;
+      this->mz = mz;
+    }
+    __syncthreads();
+  }
+
+  // compress modified cached blocks (collective)
+  __device__ void flush(const view3<Scalar>& v)
+  {
+    __syncthreads();
+    const uint t = threadIdx.x + blockDim.x * (threadIdx.y + blockDim.y * threadIdx.z);
+    const uint threads = blockDim.x * blockDim.y * blockDim.z;
+    for (uint l = t; l < mx * my * mz; l += threads)
+      if (dirty[l]) {
+        v.encode_block(bi + l % mx, bj + (l / mx) % my, bk + l / (mx * my), line[l]);
+        dirty[l] = false;
+      }
+    __syncthreads();
+  }
+
+  // value at (i, j, k), which is decompressed on demand if not cached
+  __device__ Scalar get(const view3<Scalar>& v, size_t i, size_t j, size_t k) const
+  {
+    int l = find(i, j, k);
+    return l < 0 ? v(i, j, k) : line[l][(i & 3u) + 4 * ((j & 3u) + 4 * (k & 3u))];
+  }
+
+  // set cached value at (i, j, k) and return true, or return false if
+  // (i, j, k) is not cached; concurrent writes to the same value race
+  __device__ bool set(size_t i, size_t j, size_t k, Scalar val)
+  {
+    int l = find(i, j, k);
+    if (l < 0)
+      return false;
+    line[l][(i & 3u) + 4 * ((j & 3u) + 4 * (k & 3u))] = val;
+    dirty[l] = true;
+    return true;
+  }
+
+protected:
+  // cache line holding (i, j, k), or -1 if not cached
+  __device__ int find(size_t i, size_t j, size_t k) const
+  {
+    size_t x = i / 4 - bi;
+    size_t y = j / 4 - bj;
+    size_t z = k / 4 - bk;
+    // unsigned comparisons also reject blocks before the cached box
+    if (x < mx && y < my && z < mz)
+      return int(x + mx * (y + my * z));
+    return -1;
+  }
+
+  Scalar line[lines][64]; // decompressed blocks
+  bool dirty[lines];      // modified blocks
+  size_t bi, bj, bk;      // first cached block
+  uint mx, my, mz;        // number of cached blocks per dimension
+};
+
+// fixed-rate compressed 3D array in device memory
+template <typename Scalar>
+class array3 {
+public:
+  typedef Scalar value_type;
+  typedef view3<Scalar> view_type;
+  typedef zfp::cpp::block_codec<Scalar, 3> codec;
+
+  // empty array
+  array3() { init(0, 0, 0, 0); }
+
+  // nx * ny * nz array of zeros using rate bits per value
+  array3(size_t nx, size_t ny, size_t nz, double rate)
+  {
+    init(nx, ny, nz, block_bits(rate));
+    alloc();
+    if (cudaMemset(v.data, 0, bytes) != cudaSuccess)
+      throw zfp::exception("zfp device memory could not be initialized");
+  }
+
+  // copy of fixed-rate host array, transferred without decompression
+  explicit array3(const zfp::array3<Scalar>& a)
+  {
+    if (a.mode() != zfp_mode_fixed_rate || a.block_order() != zfp::block_order_raster)
+      throw zfp::exception("zfp device arrays require fixed-rate host arrays in raster block order");
+    init(a.size_x(), a.size_y(), a.size_z(), block_bits(a.rate()));
+    alloc();
+    const void* src = a.compressed_data();
+    if (cudaMemcpy(v.data, src, bytes, cudaMemcpyHostToDevice) != cudaSuccess) {
+      free();
+      throw zfp::exception("zfp compressed blocks could not be copied to device");
+    }
+  }
+
+  // destructor
+  ~array3() { free(); }
+
+  // array dimensions
+  size_t size_x() const { return v.nx; }
+  size_t size_y() const { return v.ny; }
+  size_t size_z() const { return v.nz; }
+
+  // rate in bits per value
+  double rate() const { return double(v.bits) / 64; }
+
+  // number of bytes of compressed data
+  size_t compressed_size() const { return bytes; }
+
+  // pointer to compressed data in device memory
+  void* compressed_data() const { return v.data; }
+
+  // handle for use in kernels
+  view_type view() const { return v; }
+
+  // copy compressed blocks to host array a without decompression
+  void get(zfp::array3<Scalar>& a) const
+  {
+    a.resize(v.nx, v.ny, v.nz, false);
+    a.set_rate(rate());
+    a.set_block_order(zfp::block_order_raster);
+    if (a.compressed_size() != bytes)
+      throw zfp::exception("zfp host array rate does not match device array");
+    a.clear_cache();
+    if (cudaMemcpy(a.compressed_data(), v.data, bytes, cudaMemcpyDeviceToHost) != cudaSuccess)
+      throw zfp::exception("zfp compressed blocks could not be copied from device");
+  }
+
+protected:
+  // number of bits per block at given rate
+  static uint block_bits(double rate)
+  {
+    uint bits = uint(rate * 64 + 0.5);
+    if (bits < codec::min_bits)
+      throw zfp::exception("zfp device array rate is too low");
+    return bits;
+  }
+
+  void init(size_t nx, size_t ny, size_t nz, uint bits)
+  {
+    v.data = 0;
+    v.nx = nx;
+    v.ny = ny;
+    v.nz = nz;
+    v.bx = (nx + 3) / 4;
+    v.by = (ny + 3) / 4;
+    v.bz = (nz + 3) / 4;
+    v.bits = bits;
+    bytes = (v.bx * v.by * v.bz * bits + 63) / 64 * sizeof(uint64);
+  }
+
+  void alloc()
+  {
+    if (bytes && cudaMalloc((void**)&v.data, bytes) != cudaSuccess) {
+      v.data = 0;
+      throw zfp::exception("zfp device memory could not be allocated");
+    }
+  }
+
+  void free()
+  {
+    if (v.data)
+      cudaFree(v.data);
+    v.data = 0;
+  }
+
+  view_type v;  // dimensions and device pointer
+  size_t bytes; // size of compressed data in bytes
+
+private:
+  // not copyable
+  array3(const array3&);
+  array3& operator=(const array3&);
+};
+
+}
+}
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef ZFP_DEVICE_H
+#define ZFP_DEVICE_H
+
+#include "zfpblockcodec.h"
+
+// fixed-rate block codec callable from user CUDA and HIP kernels (and from
+// host code); block i of a stream occupies bits [i * maxbits, (i + 1) * maxbits)
+// as in fixed-rate streams produced by zfp_compress
+
+// smallest supported number of bits per block
+template <typename Scalar, uint dims>
+inline ZFP_HOST_DEVICE uint
+zfp_device_block_min_bits()
+{
+  return zfp::cpp::block_codec<Scalar, dims>::min_bits;
+}
+
+// encode contiguous block of 4^dims values as block #index of stream using
+// maxbits bits; blocks may be encoded concurrently; return maxbits
+template <typename Scalar, uint dims>
+inline ZFP_HOST_DEVICE size_t
+zfp_device_encode_block(uint64* stream, size_t index, uint maxbits, const Scalar* block)
+{
+  return zfp::cpp::block_codec<Scalar, dims>::encode_block(stream, index * maxbits, maxbits, block);
+}
+
+// decode block #index of maxbits bits from stream to contiguous block of
+// 4^dims values; return maxbits
+template <typename Scalar, uint dims>
+inline ZFP_HOST_DEVICE size_t
+zfp_device_decode_block(const uint64* stream, size_t index, uint maxbits, Scalar* block)
+{
+  return zfp::cpp::block_codec<Scalar, dims>::decode_block(stream, index * maxbits, maxbits, block);
+}
+
+// pad partial block row of width n <= 4 and stride s before encoding
+template <typename Scalar, uint dims>
+inline ZFP_HOST_DEVICE void
+zfp_device_pad_block(Scalar* p, uint n, uint s)
+{
+  zfp::cpp::block_codec<Scalar, dims>::pad_block(p, n, s);
+}
+
+#endif
@@ -6,18 +6,13 @@
   #error "zfparray.h must be included before zfpfactory.h"
 #endif
 
-zfp::array* zfp::array::construct(const zfp::array::header& header, const void* buffer, size_t buffer_size_bytes)
+zfp::array* zfp::array::construct(const zfp::array::header& header, const void* buffer, size_t buffer_size_bytes, bool borrow)
 {
   // extract metadata from header
   const zfp_type type = header.scalar_type();
-  const double rate = header.rate();
   const uint dims = header.dimensionality();
-  const size_t nx = header.size_x();
-  const size_t ny = header.size_y();
-  const size_t nz = header.size_z();
-  const size_t nw = header.size_w();
 
-  // construct once (passing zfp::array::header will read it again)
+  // construct once, borrowing but not yet copying any compressed data
   zfp::array* arr = 0;
   std::string error;
   switch (dims) {
@@ -25,10 +20,16 @@ zfp::array* zfp::array::construct(const zfp::array::header& header, const void*
 #ifdef ZFP_ARRAY4_H
       switch (type) {
         case zfp_type_float:
-          arr = new zfp::array4f(nx, ny, nz, nw, rate);
+          arr = new zfp::array4f(header, borrow ? buffer : 0, 0, borrow);
           break;
         case zfp_type_double:
-          arr = new zfp::array4d(nx, ny, nz, nw, rate);
+          arr = new zfp::array4d(header, borrow ? buffer : 0, 0, borrow);
+          break;
+        case zfp_type_int32:
+          arr = new zfp::array4i(header, borrow ? buffer : 0, 0, borrow);
+          break;
+        case zfp_type_int64:
+          arr = new zfp::array4l(header, borrow ? buffer : 0, 0, borrow);
           break;
         default:
           /* NOTREACHED */
@@ -44,10 +45,16 @@ zfp::array* zfp::array::construct(const zfp::array::header& header, const void*
 #ifdef ZFP_ARRAY3_H
       switch (type) {
         case zfp_type_float:
-          arr = new zfp::array3f(nx, ny, nz, rate);
+          arr = new zfp::array3f(header, borrow ? buffer : 0, 0, borrow);
           break;
         case zfp_type_double:
-          arr = new zfp::array3d(nx, ny, nz, rate);
+          arr = new zfp::array3d(header, borrow ? buffer : 0, 0, borrow);
+          break;
+        case zfp_type_int32:
+          arr = new zfp::array3i(header, borrow ? buffer : 0, 0, borrow);
+          break;
+        case zfp_type_int64:
+          arr = new zfp::array3l(header, borrow ? buffer : 0, 0, borrow);
           break;
         default:
           /* NOTREACHED */
@@ -63,10 +70,16 @@ zfp::array* zfp::array::construct(const zfp::array::header& header, const void*
 #ifdef ZFP_ARRAY2_H
       switch (type) {
         case zfp_type_float:
-          arr = new zfp::array2f(nx, ny, rate);
+          arr = new zfp::array2f(header, borrow ? buffer : 0, 0, borrow);
           break;
         case zfp_type_double:
-          arr = new zfp::array2d(nx, ny, rate);
+          arr = new zfp::array2d(header, borrow ? buffer : 0, 0, borrow);
+          break;
+        case zfp_type_int32:
+          arr = new zfp::array2i(header, borrow ? buffer : 0, 0, borrow);
+          break;
+        case zfp_type_int64:
+          arr = new zfp::array2l(header, borrow ? buffer : 0, 0, borrow);
           break;
         default:
           /* NOTREACHED */
@@ -82,10 +95,16 @@ zfp::array* zfp::array::construct(const zfp::array::header& header, const void*
 #ifdef ZFP_ARRAY1_H
       switch (type) {
         case zfp_type_float:
-          arr = new zfp::array1f(nx, rate);
+          arr = new zfp::array1f(header, borrow ? buffer : 0, 0, borrow);
           break;
         case zfp_type_double:
-          arr = new zfp::array1d(nx, rate);
+          arr = new zfp::array1d(header, borrow ? buffer : 0, 0, borrow);
+          break;
+        case zfp_type_int32:
+          arr = new zfp::array1i(header, borrow ? buffer : 0, 0, borrow);
+          break;
+        case zfp_type_int64:
+          arr = new zfp::array1l(header, borrow ? buffer : 0, 0, borrow);
           break;
         default:
           /* NOTREACHED */
@@ -110,7 +129,8 @@ zfp::array* zfp::array::construct(const zfp::array::header& header, const void*
       delete arr;
       throw zfp::exception("zfp buffer size is smaller than required");
     }
-    std::memcpy(arr->compressed_data(), buffer, arr->compressed_size());
+    if (!borrow)
+      std::memcpy(arr->compressed_data(), buffer, arr->compressed_size());
   }
 
   return arr;
@@ -0,0 +1,185 @@
+#ifndef ZFP_SERIES3_H
+#define ZFP_SERIES3_H
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+#include "zfparray.h"
+#include "zfpcodec.h"
+#include "zfp/cache4.h"
+#include "zfp/store4.h"
+
+namespace zfp {
+
+// append-only time series of nx * ny * nz arrays of scalars; each group of
+// four consecutive steps is compressed once as a layer of 4D blocks when
+// complete, while the most recent, incomplete group is held uncompressed
+template < typename Scalar, class Codec = zfp::zfp_codec<Scalar, 4> >
+class series3 : public array {
+public:
+  typedef series3 container_type;
+  typedef Scalar value_type;
+  typedef Codec codec_type;
+
+  // default constructor
+  series3() :
+    array(4, Codec::type),
+    cache(store)
+  {}
+
+  // constructor of empty series of nx * ny * nz arrays using rate bits per
+  // value and at least cache_size bytes of cache
+  series3(size_t nx, size_t ny, size_t nz, double rate, size_t cache_size = 0) :
+    array(4, Codec::type),
+    store(nx, ny, nz, 0, rate),
+    cache(store, cache_size),
+    slab(4 * nx * ny * nz)
+  {
+    this->nx = nx;
+    this->ny = ny;
+    this->nz = nz;
+  }
+
+  // copy constructor--performs a deep copy
+  series3(const series3& s) :
+    array(),
+    cache(store)
+  {
+    deep_copy(s);
+  }
+
+  // virtual destructor
+  virtual ~series3() {}
+
+  // assignment operator--performs a deep copy
+  series3& operator=(const series3& s)
+  {
+    if (this != &s)
+      deep_copy(s);
+    return *this;
+  }
+
+  // total number of elements in series
+  size_t size() const { return nx * ny * nz * nw; }
+
+  // dimensions of each step
+  size_t size_x() const { return nx; }
+  size_t size_y() const { return ny; }
+  size_t size_z() const { return nz; }
+
+  // number of steps appended
+  size_t steps() const { return nw; }
+
+  // number of steps that fit in compressed storage without reallocation
+  size_t capacity() const { return 4 * store.block_size_w(); }
+
+  // ensure compressed storage for at least the given number of steps
+  void reserve(size_t steps)
+  {
+    if (steps > capacity())
+      grow((steps + 3) / 4);
+  }
+
+  // rate in bits per value
+  double rate() const { return store.rate(); }
+
+  // number of bytes of compressed data, including reserved storage
+  size_t compressed_size() const { return store.compressed_size(); }
+
+  // pointer to compressed data of all complete groups of four steps
+  void* compressed_data() const { return store.compressed_data(); }
+
+  // cache size in number of bytes
+  size_t cache_size() const { return cache.size(); }
+
+  // set minimum cache size in bytes
+  void set_cache_size(size_t bytes) { cache.resize(bytes); }
+
+  // set cache line replacement policy and number of lines per set
+  void set_cache_policy(cache_policy policy, uint ways = 4) { cache.set_policy(policy, ways); }
+
+  // empty cache
+  void clear_cache() const { cache.clear(); }
+
+  // append step stored at p as nx * ny * nz array in amortized constant time
+  void append(const value_type* p)
+  {
+    const size_t n = nx * ny * nz;
+    std::copy(p, p + n, slab.begin() + (nw & 3u) * n);
+    if ((++nw & 3u) == 0)
+      compress(nw / 4 - 1);
+  }
+
+  // decompress step t and store at p
+  void get(size_t t, value_type* p) const
+  {
+    for (size_t k = 0; k < nz; k++)
+      for (size_t j = 0; j < ny; j++)
+        for (size_t i = 0; i < nx; i++)
+          *p++ = get(i, j, k, t);
+  }
+
+  // (i, j, k, t) inspector
+  value_type operator()(size_t i, size_t j, size_t k, size_t t) const { return get(i, j, k, t); }
+
+protected:
+  // value at (i, j, k) of step t
+  value_type get(size_t i, size_t j, size_t k, size_t t) const
+  {
+    if (t < (nw & ~size_t(3)))
+      return cache.get(i, j, k, t);
+    return slab[i + nx * (j + ny * (k + nz * (t & 3u)))];
+  }
+
+  // compress open slab as layer l of blocks
+  void compress(size_t l)
+  {
+    if (l >= store.block_size_w())
+      grow(std::max(l + 1, 2 * store.block_size_w()));
+    const size_t bx = store.block_size_x();
+    const size_t by = store.block_size_y();
+    const size_t bz = store.block_size_z();
+    const ptrdiff_t sx = 1;
+    const ptrdiff_t sy = static_cast<ptrdiff_t>(nx);
+    const ptrdiff_t sz = static_cast<ptrdiff_t>(nx * ny);
+    const ptrdiff_t sw = static_cast<ptrdiff_t>(nx * ny * nz);
+    const value_type* p = &slab[0];
+    size_t block_index = bx * by * bz * l;
+    for (size_t k = 0; k < bz; k++, p += 4 * nx * (ny - by))
+      for (size_t j = 0; j < by; j++, p += 4 * (nx - bx))
+        for (size_t i = 0; i < bx; i++, p += 4)
+          cache.put_block(block_index++, p, sx, sy, sz, sw);
+  }
+
+  // grow compressed storage to the given number of layers of blocks; blocks
+  // already compressed are moved rather than recompressed
+  void grow(size_t layers)
+  {
+    cache.flush();
+    store.resize_preserving(nx, ny, nz, 4 * layers);
+  }
+
+  // perform a deep copy
+  void deep_copy(const series3& s)
+  {
+    // copy base class members
+    array::deep_copy(s);
+    // copy persistent storage
+    store.deep_copy(s.store);
+    // copy cached data
+    cache.deep_copy(s.cache);
+    // copy open slab
+    slab = s.slab;
+  }
+
+  BlockStore4<value_type, codec_type> store; // compressed groups of four steps
+  BlockCache4<value_type, codec_type> cache; // cache of decompressed blocks
+  std::vector<value_type> slab;              // uncompressed open group of steps
+};
+
+typedef series3<float> series3f;
+typedef series3<double> series3d;
+
+}
+
+#endif
@@ -100,6 +100,7 @@ typedef struct {
   cfp_array1d (*ctor)(size_t n, double rate, const double* p, size_t cache_size);
   cfp_array1d (*ctor_copy)(const cfp_array1d src);
   cfp_array1d (*ctor_header)(const cfp_header h, const void* buffer, size_t buffer_size_bytes);
+  cfp_array1d (*ctor_adopt)(const cfp_header h, const void* buffer, size_t buffer_size_bytes);
   void (*dtor)(cfp_array1d self);
 
   void (*deep_copy)(cfp_array1d self, const cfp_array1d src);
@@ -112,6 +113,8 @@ typedef struct {
   void (*flush_cache)(const cfp_array1d self);
   size_t (*compressed_size)(const cfp_array1d self);
   void* (*compressed_data)(const cfp_array1d self);
+  zfp_bool (*borrowed)(const cfp_array1d self);
+  void (*own)(cfp_array1d self);
   size_t (*size)(const cfp_array1d self);
   void (*resize)(cfp_array1d self, size_t n, zfp_bool clear);
 
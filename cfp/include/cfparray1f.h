@@ -100,6 +100,7 @@ typedef struct {
   cfp_array1f (*ctor)(size_t n, double rate, const float* p, size_t cache_size);
   cfp_array1f (*ctor_copy)(const cfp_array1f src);
   cfp_array1f (*ctor_header)(const cfp_header h, const void* buffer, size_t buffer_size_bytes);
+  cfp_array1f (*ctor_adopt)(const cfp_header h, const void* buffer, size_t buffer_size_bytes);
   void (*dtor)(cfp_array1f self);
 
   void (*deep_copy)(cfp_array1f self, const cfp_array1f src);
@@ -112,6 +113,8 @@ typedef struct {
   void (*flush_cache)(const cfp_array1f self);
   size_t (*compressed_size)(const cfp_array1f self);
   void* (*compressed_data)(const cfp_array1f self);
+  zfp_bool (*borrowed)(const cfp_array1f self);
+  void (*own)(cfp_array1f self);
   size_t (*size)(const cfp_array1f self);
   void (*resize)(cfp_array1f self, size_t n, zfp_bool clear);
 
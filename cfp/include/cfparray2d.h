@@ -101,6 +101,7 @@ typedef struct {
   cfp_array2d (*ctor)(size_t nx, size_t ny, double rate, const double* p, size_t cache_size);
   cfp_array2d (*ctor_copy)(const cfp_array2d src);
   cfp_array2d (*ctor_header)(const cfp_header h, const void* buffer, size_t buffer_size_bytes);
+  cfp_array2d (*ctor_adopt)(const cfp_header h, const void* buffer, size_t buffer_size_bytes);
   void (*dtor)(cfp_array2d self);
 
   void (*deep_copy)(cfp_array2d self, const cfp_array2d src);
@@ -113,6 +114,8 @@ typedef struct {
   void (*flush_cache)(const cfp_array2d self);
   size_t (*compressed_size)(const cfp_array2d self);
   void* (*compressed_data)(const cfp_array2d self);
+  zfp_bool (*borrowed)(const cfp_array2d self);
+  void (*own)(cfp_array2d self);
   size_t (*size)(const cfp_array2d self);
   size_t (*size_x)(const cfp_array2d self);
   size_t (*size_y)(const cfp_array2d self);
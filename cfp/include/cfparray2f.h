@@ -101,6 +101,7 @@ typedef struct {
   cfp_array2f (*ctor)(size_t nx, size_t ny, double rate, const float* p, size_t cache_size);
   cfp_array2f (*ctor_copy)(const cfp_array2f src);
   cfp_array2f (*ctor_header)(const cfp_header h, const void* buffer, size_t buffer_size_bytes);
+  cfp_array2f (*ctor_adopt)(const cfp_header h, const void* buffer, size_t buffer_size_bytes);
   void (*dtor)(cfp_array2f self);
 
   void (*deep_copy)(cfp_array2f self, const cfp_array2f src);
@@ -113,6 +114,8 @@ typedef struct {
   void (*flush_cache)(const cfp_array2f self);
   size_t (*compressed_size)(const cfp_array2f self);
   void* (*compressed_data)(const cfp_array2f self);
+  zfp_bool (*borrowed)(const cfp_array2f self);
+  void (*own)(cfp_array2f self);
   size_t (*size)(const cfp_array2f self);
   size_t (*size_x)(const cfp_array2f self);
   size_t (*size_y)(const cfp_array2f self);
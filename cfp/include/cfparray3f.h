@@ -22,6 +22,14 @@ typedef struct {
   size_t x, y, z;
 } cfp_iter3f;
 
+typedef struct {
+  void* object;
+} cfp_private_view3f;
+
+/* block visitor f(p, i, j, k, mx, my, mz, context) called with the block's
+   mx * my * mz values stored at p with strides 1, 4, 16 */
+typedef void (*cfp_block_func3f)(float* p, size_t i, size_t j, size_t k, size_t mx, size_t my, size_t mz, void* context);
+
 typedef struct {
   /* member functions */
   float (*get)(const cfp_ref3f self);
@@ -97,23 +105,51 @@ typedef struct {
   size_t (*size)(const cfp_header self);
 } cfp_header3f_api;
 
+typedef struct {
+  /* constructor/destructor */
+  cfp_private_view3f (*ctor)(cfp_array3f a, size_t cache_size);
+  cfp_private_view3f (*ctor_subset)(cfp_array3f a, size_t x, size_t y, size_t z, size_t nx, size_t ny, size_t nz, size_t cache_size);
+  void (*dtor)(cfp_private_view3f self);
+  /* view extent and mapping to array indices */
+  size_t (*size_x)(const cfp_private_view3f self);
+  size_t (*size_y)(const cfp_private_view3f self);
+  size_t (*size_z)(const cfp_private_view3f self);
+  size_t (*global_x)(const cfp_private_view3f self, size_t i);
+  size_t (*global_y)(const cfp_private_view3f self, size_t j);
+  size_t (*global_z)(const cfp_private_view3f self, size_t k);
+  void (*partition)(cfp_private_view3f self, size_t index, size_t count);
+  /* private cache */
+  size_t (*cache_size)(const cfp_private_view3f self);
+  void (*set_cache_size)(cfp_private_view3f self, size_t bytes);
+  void (*clear_cache)(const cfp_private_view3f self);
+  void (*flush_cache)(const cfp_private_view3f self);
+  /* accessors */
+  float (*get)(const cfp_private_view3f self, size_t i, size_t j, size_t k);
+  void (*set)(cfp_private_view3f self, size_t i, size_t j, size_t k, float val);
+} cfp_private_view3f_api;
+
 typedef struct {
   cfp_array3f (*ctor_default)();
   cfp_array3f (*ctor)(size_t nx, size_t ny, size_t nz, double rate, const float* p, size_t cache_size);
   cfp_array3f (*ctor_copy)(const cfp_array3f src);
   cfp_array3f (*ctor_header)(const cfp_header h, const void* buffer, size_t buffer_size_bytes);
+  cfp_array3f (*ctor_adopt)(const cfp_header h, const void* buffer, size_t buffer_size_bytes);
   void (*dtor)(cfp_array3f self);
 
   void (*deep_copy)(cfp_array3f self, const cfp_array3f src);
 
   double (*rate)(const cfp_array3f self);
   double (*set_rate)(cfp_array3f self, double rate);
+  uint (*set_precision)(cfp_array3f self, uint precision);
+  void (*set_reversible)(cfp_array3f self);
   size_t (*cache_size)(const cfp_array3f self);
   void (*set_cache_size)(cfp_array3f self, size_t bytes);
   void (*clear_cache)(const cfp_array3f self);
   void (*flush_cache)(const cfp_array3f self);
   size_t (*compressed_size)(const cfp_array3f self);
   void* (*compressed_data)(const cfp_array3f self);
+  zfp_bool (*borrowed)(const cfp_array3f self);
+  void (*own)(cfp_array3f self);
   size_t (*size)(const cfp_array3f self);
   size_t (*size_x)(const cfp_array3f self);
   size_t (*size_y)(const cfp_array3f self);
@@ -140,6 +176,16 @@ typedef struct {
   cfp_ptr3f_api pointer;
   cfp_iter3f_api iterator;
   cfp_header3f_api header;
+
+  /* bulk access to boxes and blocks of values with strides (0 for contiguous) */
+  void (*get_box)(const cfp_array3f self, float* p, size_t x, size_t y, size_t z, size_t nx, size_t ny, size_t nz, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz);
+  void (*set_box)(cfp_array3f self, const float* p, size_t x, size_t y, size_t z, size_t nx, size_t ny, size_t nz, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz);
+  void (*get_block)(const cfp_array3f self, float* p, size_t bx, size_t by, size_t bz, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz);
+  void (*set_block)(cfp_array3f self, const float* p, size_t bx, size_t by, size_t bz, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz);
+  void (*for_each_block)(cfp_array3f self, cfp_block_func3f f, void* context, zfp_bool write);
+
+  /* thread-safe views with private caches */
+  cfp_private_view3f_api private_view;
 } cfp_array3f_api;
 
 #endif
@@ -0,0 +1,191 @@
+#ifndef CFP_ARRAY_3I
+#define CFP_ARRAY_3I
+
+#include <stddef.h>
+#include "zfp.h"
+
+typedef struct {
+  void* object;
+} cfp_array3i;
+
+typedef struct {
+  cfp_array3i array;
+  size_t x, y, z;
+} cfp_ref3i;
+
+typedef struct {
+  cfp_ref3i reference;
+} cfp_ptr3i;
+
+typedef struct {
+  cfp_array3i array;
+  size_t x, y, z;
+} cfp_iter3i;
+
+typedef struct {
+  void* object;
+} cfp_private_view3i;
+
+/* block visitor f(p, i, j, k, mx, my, mz, context) called with the block's
+   mx * my * mz values stored at p with strides 1, 4, 16 */
+typedef void (*cfp_block_func3i)(int32* p, size_t i, size_t j, size_t k, size_t mx, size_t my, size_t mz, void* context);
+
+typedef struct {
+  /* member functions */
+  int32 (*get)(const cfp_ref3i self);
+  void (*set)(cfp_ref3i self, int32 val);
+  cfp_ptr3i (*ptr)(cfp_ref3i self);
+  void (*copy)(cfp_ref3i self, const cfp_ref3i src);
+} cfp_ref3i_api;
+
+typedef struct {
+  /* member functions */
+  int32 (*get)(const cfp_ptr3i self);
+  int32 (*get_at)(const cfp_ptr3i self, ptrdiff_t d);
+  void (*set)(cfp_ptr3i self, int32 val);
+  void (*set_at)(cfp_ptr3i self, ptrdiff_t d, int32 val);
+  cfp_ref3i (*ref)(cfp_ptr3i self);
+  cfp_ref3i (*ref_at)(cfp_ptr3i self, ptrdiff_t d);
+  /* non-member functions */
+  zfp_bool (*lt)(const cfp_ptr3i lhs, const cfp_ptr3i rhs);
+  zfp_bool (*gt)(const cfp_ptr3i lhs, const cfp_ptr3i rhs);
+  zfp_bool (*leq)(const cfp_ptr3i lhs, const cfp_ptr3i rhs);
+  zfp_bool (*geq)(const cfp_ptr3i lhs, const cfp_ptr3i rhs);
+  zfp_bool (*eq)(const cfp_ptr3i lhs, const cfp_ptr3i rhs);
+  zfp_bool (*neq)(const cfp_ptr3i lhs, const cfp_ptr3i rhs);
+  ptrdiff_t (*distance)(const cfp_ptr3i first, const cfp_ptr3i last);
+  cfp_ptr3i (*next)(const cfp_ptr3i p, ptrdiff_t d);
+  cfp_ptr3i (*prev)(const cfp_ptr3i p, ptrdiff_t d);
+  cfp_ptr3i (*inc)(const cfp_ptr3i p);
+  cfp_ptr3i (*dec)(const cfp_ptr3i p);
+} cfp_ptr3i_api;
+
+typedef struct {
+  /* member functions */
+  int32 (*get)(const cfp_iter3i self);
+  int32 (*get_at)(const cfp_iter3i self, ptrdiff_t d);
+  void (*set)(cfp_iter3i self, int32 val);
+  void (*set_at)(cfp_iter3i self, ptrdiff_t d, int32 val);
+  cfp_ref3i (*ref)(cfp_iter3i self);
+  cfp_ref3i (*ref_at)(cfp_iter3i self, ptrdiff_t d);
+  cfp_ptr3i (*ptr)(cfp_iter3i self);
+  cfp_ptr3i (*ptr_at)(cfp_iter3i self, ptrdiff_t d);
+  size_t (*i)(const cfp_iter3i self);
+  size_t (*j)(const cfp_iter3i self);
+  size_t (*k)(const cfp_iter3i self);
+  /* non-member functions */
+  zfp_bool (*lt)(const cfp_iter3i lhs, const cfp_iter3i rhs);
+  zfp_bool (*gt)(const cfp_iter3i lhs, const cfp_iter3i rhs);
+  zfp_bool (*leq)(const cfp_iter3i lhs, const cfp_iter3i rhs);
+  zfp_bool (*geq)(const cfp_iter3i lhs, const cfp_iter3i rhs);
+  zfp_bool (*eq)(const cfp_iter3i lhs, const cfp_iter3i rhs);
+  zfp_bool (*neq)(const cfp_iter3i lhs, const cfp_iter3i rhs);
+  ptrdiff_t (*distance)(const cfp_iter3i first, const cfp_iter3i last);
+  cfp_iter3i (*next)(const cfp_iter3i it, ptrdiff_t d);
+  cfp_iter3i (*prev)(const cfp_iter3i it, ptrdiff_t d);
+  cfp_iter3i (*inc)(const cfp_iter3i it);
+  cfp_iter3i (*dec)(const cfp_iter3i it);
+} cfp_iter3i_api;
+
+typedef struct {
+  /* constructor/destructor */
+  cfp_header (*ctor)(const cfp_array3i a);
+  cfp_header (*ctor_buffer)(const void* data, size_t size);
+  void (*dtor)(cfp_header self);
+  /* array metadata */
+  zfp_type (*scalar_type)(const cfp_header self);
+  uint (*dimensionality)(const cfp_header self);
+  size_t (*size_x)(const cfp_header self);
+  size_t (*size_y)(const cfp_header self);
+  size_t (*size_z)(const cfp_header self);
+  size_t (*size_w)(const cfp_header self);
+  double (*rate)(const cfp_header self);
+  /* header payload: data pointer and byte size */
+  const void* (*data)(const cfp_header self);
+  size_t (*size)(const cfp_header self);
+} cfp_header3i_api;
+
+typedef struct {
+  /* constructor/destructor */
+  cfp_private_view3i (*ctor)(cfp_array3i a, size_t cache_size);
+  cfp_private_view3i (*ctor_subset)(cfp_array3i a, size_t x, size_t y, size_t z, size_t nx, size_t ny, size_t nz, size_t cache_size);
+  void (*dtor)(cfp_private_view3i self);
+  /* view extent and mapping to array indices */
+  size_t (*size_x)(const cfp_private_view3i self);
+  size_t (*size_y)(const cfp_private_view3i self);
+  size_t (*size_z)(const cfp_private_view3i self);
+  size_t (*global_x)(const cfp_private_view3i self, size_t i);
+  size_t (*global_y)(const cfp_private_view3i self, size_t j);
+  size_t (*global_z)(const cfp_private_view3i self, size_t k);
+  void (*partition)(cfp_private_view3i self, size_t index, size_t count);
+  /* private cache */
+  size_t (*cache_size)(const cfp_private_view3i self);
+  void (*set_cache_size)(cfp_private_view3i self, size_t bytes);
+  void (*clear_cache)(const cfp_private_view3i self);
+  void (*flush_cache)(const cfp_private_view3i self);
+  /* accessors */
+  int32 (*get)(const cfp_private_view3i self, size_t i, size_t j, size_t k);
+  void (*set)(cfp_private_view3i self, size_t i, size_t j, size_t k, int32 val);
+} cfp_private_view3i_api;
+
+typedef struct {
+  cfp_array3i (*ctor_default)();
+  cfp_array3i (*ctor)(size_t nx, size_t ny, size_t nz, double rate, const int32* p, size_t cache_size);
+  cfp_array3i (*ctor_copy)(const cfp_array3i src);
+  cfp_array3i (*ctor_header)(const cfp_header h, const void* buffer, size_t buffer_size_bytes);
+  cfp_array3i (*ctor_adopt)(const cfp_header h, const void* buffer, size_t buffer_size_bytes);
+  void (*dtor)(cfp_array3i self);
+
+  void (*deep_copy)(cfp_array3i self, const cfp_array3i src);
+
+  double (*rate)(const cfp_array3i self);
+  double (*set_rate)(cfp_array3i self, double rate);
+  uint (*set_precision)(cfp_array3i self, uint precision);
+  void (*set_reversible)(cfp_array3i self);
+  size_t (*cache_size)(const cfp_array3i self);
+  void (*set_cache_size)(cfp_array3i self, size_t bytes);
+  void (*clear_cache)(const cfp_array3i self);
+  void (*flush_cache)(const cfp_array3i self);
+  size_t (*compressed_size)(const cfp_array3i self);
+  void* (*compressed_data)(const cfp_array3i self);
+  zfp_bool (*borrowed)(const cfp_array3i self);
+  void (*own)(cfp_array3i self);
+  size_t (*size)(const cfp_array3i self);
+  size_t (*size_x)(const cfp_array3i self);
+  size_t (*size_y)(const cfp_array3i self);
+  size_t (*size_z)(const cfp_array3i self);
+  void (*resize)(cfp_array3i self, size_t nx, size_t ny, size_t nz, zfp_bool clear);
+
+  void (*get_array)(const cfp_array3i self, int32* p);
+  void (*set_array)(cfp_array3i self, const int32* p);
+  int32 (*get_flat)(const cfp_array3i self, size_t i);
+  void (*set_flat)(cfp_array3i self, size_t i, int32 val);
+  int32 (*get)(const cfp_array3i self, size_t i, size_t j, size_t k);
+  void (*set)(cfp_array3i self, size_t i, size_t j, size_t k, int32 val);
+
+  cfp_ref3i (*ref)(cfp_array3i self, size_t i, size_t j, size_t k);
+  cfp_ref3i (*ref_flat)(cfp_array3i self, size_t i);
+
+  cfp_ptr3i (*ptr)(cfp_array3i self, size_t i, size_t j, size_t k);
+  cfp_ptr3i (*ptr_flat)(cfp_array3i self, size_t i);
+
+  cfp_iter3i (*begin)(cfp_array3i self);
+  cfp_iter3i (*end)(cfp_array3i self);
+
+  cfp_ref3i_api reference;
+  cfp_ptr3i_api pointer;
+  cfp_iter3i_api iterator;
+  cfp_header3i_api header;
+
+  /* bulk access to boxes and blocks of values with strides (0 for contiguous) */
+  void (*get_box)(const cfp_array3i self, int32* p, size_t x, size_t y, size_t z, size_t nx, size_t ny, size_t nz, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz);
+  void (*set_box)(cfp_array3i self, const int32* p, size_t x, size_t y, size_t z, size_t nx, size_t ny, size_t nz, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz);
+  void (*get_block)(const cfp_array3i self, int32* p, size_t bx, size_t by, size_t bz, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz);
+  void (*set_block)(cfp_array3i self, const int32* p, size_t bx, size_t by, size_t bz, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz);
+  void (*for_each_block)(cfp_array3i self, cfp_block_func3i f, void* context, zfp_bool write);
+
+  /* thread-safe views with private caches */
+  cfp_private_view3i_api private_view;
+} cfp_array3i_api;
+
+#endif
@@ -0,0 +1,191 @@
+#ifndef CFP_ARRAY_3L
+#define CFP_ARRAY_3L
+
+#include <stddef.h>
+#include "zfp.h"
+
+typedef struct {
+  void* object;
+} cfp_array3l;
+
+typedef struct {
+  cfp_array3l array;
+  size_t x, y, z;
+} cfp_ref3l;
+
+typedef struct {
+  cfp_ref3l reference;
+} cfp_ptr3l;
+
+typedef struct {
+  cfp_array3l array;
+  size_t x, y, z;
+} cfp_iter3l;
+
+typedef struct {
+  void* object;
+} cfp_private_view3l;
+
+/* block visitor f(p, i, j, k, mx, my, mz, context) called with the block's
+   mx * my * mz values stored at p with strides 1, 4, 16 */
+typedef void (*cfp_block_func3l)(int64* p, size_t i, size_t j, size_t k, size_t mx, size_t my, size_t mz, void* context);
+
+typedef struct {
+  /* member functions */
+  int64 (*get)(const cfp_ref3l self);
+  void (*set)(cfp_ref3l self, int64 val);
+  cfp_ptr3l (*ptr)(cfp_ref3l self);
+  void (*copy)(cfp_ref3l self, const cfp_ref3l src);
+} cfp_ref3l_api;
+
+typedef struct {
+  /* member functions */
+  int64 (*get)(const cfp_ptr3l self);
+  int64 (*get_at)(const cfp_ptr3l self, ptrdiff_t d);
+  void (*set)(cfp_ptr3l self, int64 val);
+  void (*set_at)(cfp_ptr3l self, ptrdiff_t d, int64 val);
+  cfp_ref3l (*ref)(cfp_ptr3l self);
+  cfp_ref3l (*ref_at)(cfp_ptr3l self, ptrdiff_t d);
+  /* non-member functions */
+  zfp_bool (*lt)(const cfp_ptr3l lhs, const cfp_ptr3l rhs);
+  zfp_bool (*gt)(const cfp_ptr3l lhs, const cfp_ptr3l rhs);
+  zfp_bool (*leq)(const cfp_ptr3l lhs, const cfp_ptr3l rhs);
+  zfp_bool (*geq)(const cfp_ptr3l lhs, const cfp_ptr3l rhs);
+  zfp_bool (*eq)(const cfp_ptr3l lhs, const cfp_ptr3l rhs);
+  zfp_bool (*neq)(const cfp_ptr3l lhs, const cfp_ptr3l rhs);
+  ptrdiff_t (*distance)(const cfp_ptr3l first, const cfp_ptr3l last);
+  cfp_ptr3l (*next)(const cfp_ptr3l p, ptrdiff_t d);
+  cfp_ptr3l (*prev)(const cfp_ptr3l p, ptrdiff_t d);
+  cfp_ptr3l (*inc)(const cfp_ptr3l p);
+  cfp_ptr3l (*dec)(const cfp_ptr3l p);
+} cfp_ptr3l_api;
+
+typedef struct {
+  /* member functions */
+  int64 (*get)(const cfp_iter3l self);
+  int64 (*get_at)(const cfp_iter3l self, ptrdiff_t d);
+  void (*set)(cfp_iter3l self, int64 val);
+  void (*set_at)(cfp_iter3l self, ptrdiff_t d, int64 val);
+  cfp_ref3l (*ref)(cfp_iter3l self);
+  cfp_ref3l (*ref_at)(cfp_iter3l self, ptrdiff_t d);
+  cfp_ptr3l (*ptr)(cfp_iter3l self);
+  cfp_ptr3l (*ptr_at)(cfp_iter3l self, ptrdiff_t d);
+  size_t (*i)(const cfp_iter3l self);
+  size_t (*j)(const cfp_iter3l self);
+  size_t (*k)(const cfp_iter3l self);
+  /* non-member functions */
+  zfp_bool (*lt)(const cfp_iter3l lhs, const cfp_iter3l rhs);
+  zfp_bool (*gt)(const cfp_iter3l lhs, const cfp_iter3l rhs);
+  zfp_bool (*leq)(const cfp_iter3l lhs, const cfp_iter3l rhs);
+  zfp_bool (*geq)(const cfp_iter3l lhs, const cfp_iter3l rhs);
+  zfp_bool (*eq)(const cfp_iter3l lhs, const cfp_iter3l rhs);
+  zfp_bool (*neq)(const cfp_iter3l lhs, const cfp_iter3l rhs);
+  ptrdiff_t (*distance)(const cfp_iter3l first, const cfp_iter3l last);
+  cfp_iter3l (*next)(const cfp_iter3l it, ptrdiff_t d);
+  cfp_iter3l (*prev)(const cfp_iter3l it, ptrdiff_t d);
+  cfp_iter3l (*inc)(const cfp_iter3l it);
+  cfp_iter3l (*dec)(const cfp_iter3l it);
+} cfp_iter3l_api;
+
+typedef struct {
+  /* constructor/destructor */
+  cfp_header (*ctor)(const cfp_array3l a);
+  cfp_header (*ctor_buffer)(const void* data, size_t size);
+  void (*dtor)(cfp_header self);
+  /* array metadata */
+  zfp_type (*scalar_type)(const cfp_header self);
+  uint (*dimensionality)(const cfp_header self);
+  size_t (*size_x)(const cfp_header self);
+  size_t (*size_y)(const cfp_header self);
+  size_t (*size_z)(const cfp_header self);
+  size_t (*size_w)(const cfp_header self);
+  double (*rate)(const cfp_header self);
+  /* header payload: data pointer and byte size */
+  const void* (*data)(const cfp_header self);
+  size_t (*size)(const cfp_header self);
+} cfp_header3l_api;
+
+typedef struct {
+  /* constructor/destructor */
+  cfp_private_view3l (*ctor)(cfp_array3l a, size_t cache_size);
+  cfp_private_view3l (*ctor_subset)(cfp_array3l a, size_t x, size_t y, size_t z, size_t nx, size_t ny, size_t nz, size_t cache_size);
+  void (*dtor)(cfp_private_view3l self);
+  /* view extent and mapping to array indices */
+  size_t (*size_x)(const cfp_private_view3l self);
+  size_t (*size_y)(const cfp_private_view3l self);
+  size_t (*size_z)(const cfp_private_view3l self);
+  size_t (*global_x)(const cfp_private_view3l self, size_t i);
+  size_t (*global_y)(const cfp_private_view3l self, size_t j);
+  size_t (*global_z)(const cfp_private_view3l self, size_t k);
+  void (*partition)(cfp_private_view3l self, size_t index, size_t count);
+  /* private cache */
+  size_t (*cache_size)(const cfp_private_view3l self);
+  void (*set_cache_size)(cfp_private_view3l self, size_t bytes);
+  void (*clear_cache)(const cfp_private_view3l self);
+  void (*flush_cache)(const cfp_private_view3l self);
+  /* accessors */
+  int64 (*get)(const cfp_private_view3l self, size_t i, size_t j, size_t k);
+  void (*set)(cfp_private_view3l self, size_t i, size_t j, size_t k, int64 val);
+} cfp_private_view3l_api;
+
+typedef struct {
+  cfp_array3l (*ctor_default)();
+  cfp_array3l (*ctor)(size_t nx, size_t ny, size_t nz, double rate, const int64* p, size_t cache_size);
+  cfp_array3l (*ctor_copy)(const cfp_array3l src);
+  cfp_array3l (*ctor_header)(const cfp_header h, const void* buffer, size_t buffer_size_bytes);
+  cfp_array3l (*ctor_adopt)(const cfp_header h, const void* buffer, size_t buffer_size_bytes);
+  void (*dtor)(cfp_array3l self);
+
+  void (*deep_copy)(cfp_array3l self, const cfp_array3l src);
+
+  double (*rate)(const cfp_array3l self);
+  double (*set_rate)(cfp_array3l self, double rate);
+  uint (*set_precision)(cfp_array3l self, uint precision);
+  void (*set_reversible)(cfp_array3l self);
+  size_t (*cache_size)(const cfp_array3l self);
+  void (*set_cache_size)(cfp_array3l self, size_t bytes);
+  void (*clear_cache)(const cfp_array3l self);
+  void (*flush_cache)(const cfp_array3l self);
+  size_t (*compressed_size)(const cfp_array3l self);
+  void* (*compressed_data)(const cfp_array3l self);
+  zfp_bool (*borrowed)(const cfp_array3l self);
+  void (*own)(cfp_array3l self);
+  size_t (*size)(const cfp_array3l self);
+  size_t (*size_x)(const cfp_array3l self);
+  size_t (*size_y)(const cfp_array3l self);
+  size_t (*size_z)(const cfp_array3l self);
+  void (*resize)(cfp_array3l self, size_t nx, size_t ny, size_t nz, zfp_bool clear);
+
+  void (*get_array)(const cfp_array3l self, int64* p);
+  void (*set_array)(cfp_array3l self, const int64* p);
+  int64 (*get_flat)(const cfp_array3l self, size_t i);
+  void (*set_flat)(cfp_array3l self, size_t i, int64 val);
+  int64 (*get)(const cfp_array3l self, size_t i, size_t j, size_t k);
+  void (*set)(cfp_array3l self, size_t i, size_t j, size_t k, int64 val);
+
+  cfp_ref3l (*ref)(cfp_array3l self, size_t i, size_t j, size_t k);
+  cfp_ref3l (*ref_flat)(cfp_array3l self, size_t i);
+
+  cfp_ptr3l (*ptr)(cfp_array3l self, size_t i, size_t j, size_t k);
+  cfp_ptr3l (*ptr_flat)(cfp_array3l self, size_t i);
+
+  cfp_iter3l (*begin)(cfp_array3l self);
+  cfp_iter3l (*end)(cfp_array3l self);
+
+  cfp_ref3l_api reference;
+  cfp_ptr3l_api pointer;
+  cfp_iter3l_api iterator;
+  cfp_header3l_api header;
+
+  /* bulk access to boxes and blocks of values with strides (0 for contiguous) */
+  void (*get_box)(const cfp_array3l self, int64* p, size_t x, size_t y, size_t z, size_t nx, size_t ny, size_t nz, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz);
+  void (*set_box)(cfp_array3l self, const int64* p, size_t x, size_t y, size_t z, size_t nx, size_t ny, size_t nz, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz);
+  void (*get_block)(const cfp_array3l self, int64* p, size_t bx, size_t by, size_t bz, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz);
+  void (*set_block)(cfp_array3l self, const int64* p, size_t bx, size_t by, size_t bz, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz);
+  void (*for_each_block)(cfp_array3l self, cfp_block_func3l f, void* context, zfp_bool write);
+
+  /* thread-safe views with private caches */
+  cfp_private_view3l_api private_view;
+} cfp_array3l_api;
+
+#endif
@@ -103,6 +103,7 @@ typedef struct {
   cfp_array4d (*ctor)(size_t nx, size_t ny, size_t nz, size_t nw, double rate, const double* p, size_t cache_size);
   cfp_array4d (*ctor_copy)(const cfp_array4d src);
   cfp_array4d (*ctor_header)(const cfp_header h, const void* buffer, size_t buffer_size_bytes);
+  cfp_array4d (*ctor_adopt)(const cfp_header h, const void* buffer, size_t buffer_size_bytes);
   void (*dtor)(cfp_array4d self);
 
   void (*deep_copy)(cfp_array4d self, const cfp_array4d src);
@@ -115,6 +116,8 @@ typedef struct {
   void (*flush_cache)(const cfp_array4d self);
   size_t (*compressed_size)(const cfp_array4d self);
   void* (*compressed_data)(const cfp_array4d self);
+  zfp_bool (*borrowed)(const cfp_array4d self);
+  void (*own)(cfp_array4d self);
   size_t (*size)(const cfp_array4d self);
   size_t (*size_x)(const cfp_array4d self);
   size_t (*size_y)(const cfp_array4d self);
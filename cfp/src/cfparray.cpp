@@ -7,6 +7,8 @@
 #include "cfparray2d.cpp"
 #include "cfparray3f.cpp"
 #include "cfparray3d.cpp"
+#include "cfparray3i.cpp"
+#include "cfparray3l.cpp"
 #include "cfparray4f.cpp"
 #include "cfparray4d.cpp"
 
@@ -17,6 +19,7 @@ const cfp_api CFP_NAMESPACE = {
     cfp_array1f_ctor,
     cfp_array1f_ctor_copy,
     cfp_array1f_ctor_header,
+    cfp_array1f_ctor_adopt,
     cfp_array1f_dtor,
 
     cfp_array1f_deep_copy,
@@ -29,6 +32,8 @@ const cfp_api CFP_NAMESPACE = {
     cfp_array1f_flush_cache,
     cfp_array1f_compressed_size,
     cfp_array1f_compressed_data,
+    cfp_array1f_borrowed,
+    cfp_array1f_own,
     cfp_array1f_size,
     cfp_array1f_resize,
 
@@ -119,6 +124,7 @@ const cfp_api CFP_NAMESPACE = {
     cfp_array1d_ctor,
     cfp_array1d_ctor_copy,
     cfp_array1d_ctor_header,
+    cfp_array1d_ctor_adopt,
     cfp_array1d_dtor,
 
     cfp_array1d_deep_copy,
@@ -131,6 +137,8 @@ const cfp_api CFP_NAMESPACE = {
     cfp_array1d_flush_cache,
     cfp_array1d_compressed_size,
     cfp_array1d_compressed_data,
+    cfp_array1d_borrowed,
+    cfp_array1d_own,
     cfp_array1d_size,
     cfp_array1d_resize,
 
@@ -221,6 +229,7 @@ const cfp_api CFP_NAMESPACE = {
     cfp_array2f_ctor,
     cfp_array2f_ctor_copy,
     cfp_array2f_ctor_header,
+    cfp_array2f_ctor_adopt,
     cfp_array2f_dtor,
 
     cfp_array2f_deep_copy,
@@ -233,6 +242,8 @@ const cfp_api CFP_NAMESPACE = {
     cfp_array2f_flush_cache,
     cfp_array2f_compressed_size,
     cfp_array2f_compressed_data,
+    cfp_array2f_borrowed,
+    cfp_array2f_own,
     cfp_array2f_size,
     cfp_array2f_size_x,
     cfp_array2f_size_y,
@@ -326,6 +337,7 @@ const cfp_api CFP_NAMESPACE = {
     cfp_array2d_ctor,
     cfp_array2d_ctor_copy,
     cfp_array2d_ctor_header,
+    cfp_array2d_ctor_adopt,
     cfp_array2d_dtor,
 
     cfp_array2d_deep_copy,
@@ -338,6 +350,8 @@ const cfp_api CFP_NAMESPACE = {
     cfp_array2d_flush_cache,
     cfp_array2d_compressed_size,
     cfp_array2d_compressed_data,
+    cfp_array2d_borrowed,
+    cfp_array2d_own,
     cfp_array2d_size,
     cfp_array2d_size_x,
     cfp_array2d_size_y,
@@ -431,18 +445,23 @@ const cfp_api CFP_NAMESPACE = {
     cfp_array3f_ctor,
     cfp_array3f_ctor_copy,
     cfp_array3f_ctor_header,
+    cfp_array3f_ctor_adopt,
     cfp_array3f_dtor,
 
     cfp_array3f_deep_copy,
 
     cfp_array3f_rate,
     cfp_array3f_set_rate,
+    cfp_array3f_set_precision,
+    cfp_array3f_set_reversible,
     cfp_array3f_cache_size,
     cfp_array3f_set_cache_size,
     cfp_array3f_clear_cache,
     cfp_array3f_flush_cache,
     cfp_array3f_compressed_size,
     cfp_array3f_compressed_data,
+    cfp_array3f_borrowed,
+    cfp_array3f_own,
     cfp_array3f_size,
     cfp_array3f_size_x,
     cfp_array3f_size_y,
@@ -531,6 +550,31 @@ const cfp_api CFP_NAMESPACE = {
       cfp_header_data,
       cfp_header_size_bytes,
     },
+
+    cfp_array3f_get_box,
+    cfp_array3f_set_box,
+    cfp_array3f_get_block,
+    cfp_array3f_set_block,
+    cfp_array3f_for_each_block,
+
+    {
+      cfp_array3f_cfp_private_view3f_ctor,
+      cfp_array3f_cfp_private_view3f_ctor_subset,
+      cfp_array3f_cfp_private_view3f_dtor,
+      cfp_array3f_cfp_private_view3f_size_x,
+      cfp_array3f_cfp_private_view3f_size_y,
+      cfp_array3f_cfp_private_view3f_size_z,
+      cfp_array3f_cfp_private_view3f_global_x,
+      cfp_array3f_cfp_private_view3f_global_y,
+      cfp_array3f_cfp_private_view3f_global_z,
+      cfp_array3f_cfp_private_view3f_partition,
+      cfp_array3f_cfp_private_view3f_cache_size,
+      cfp_array3f_cfp_private_view3f_set_cache_size,
+      cfp_array3f_cfp_private_view3f_clear_cache,
+      cfp_array3f_cfp_private_view3f_flush_cache,
+      cfp_array3f_cfp_private_view3f_get,
+      cfp_array3f_cfp_private_view3f_set,
+    },
   },
   // array3d
   {
@@ -538,18 +582,23 @@ const cfp_api CFP_NAMESPACE = {
     cfp_array3d_ctor,
     cfp_array3d_ctor_copy,
     cfp_array3d_ctor_header,
+    cfp_array3d_ctor_adopt,
     cfp_array3d_dtor,
 
     cfp_array3d_deep_copy,
 
     cfp_array3d_rate,
     cfp_array3d_set_rate,
+    cfp_array3d_set_precision,
+    cfp_array3d_set_reversible,
     cfp_array3d_cache_size,
     cfp_array3d_set_cache_size,
     cfp_array3d_clear_cache,
     cfp_array3d_flush_cache,
     cfp_array3d_compressed_size,
     cfp_array3d_compressed_data,
+    cfp_array3d_borrowed,
+    cfp_array3d_own,
     cfp_array3d_size,
     cfp_array3d_size_x,
     cfp_array3d_size_y,
@@ -638,6 +687,305 @@ const cfp_api CFP_NAMESPACE = {
       cfp_header_data,
       cfp_header_size_bytes,
     },
+
+    cfp_array3d_get_box,
+    cfp_array3d_set_box,
+    cfp_array3d_get_block,
+    cfp_array3d_set_block,
+    cfp_array3d_for_each_block,
+
+    {
+      cfp_array3d_cfp_private_view3d_ctor,
+      cfp_array3d_cfp_private_view3d_ctor_subset,
+      cfp_array3d_cfp_private_view3d_dtor,
+      cfp_array3d_cfp_private_view3d_size_x,
+      cfp_array3d_cfp_private_view3d_size_y,
+      cfp_array3d_cfp_private_view3d_size_z,
+      cfp_array3d_cfp_private_view3d_global_x,
+      cfp_array3d_cfp_private_view3d_global_y,
+      cfp_array3d_cfp_private_view3d_global_z,
+      cfp_array3d_cfp_private_view3d_partition,
+      cfp_array3d_cfp_private_view3d_cache_size,
+      cfp_array3d_cfp_private_view3d_set_cache_size,
+      cfp_array3d_cfp_private_view3d_clear_cache,
+      cfp_array3d_cfp_private_view3d_flush_cache,
+      cfp_array3d_cfp_private_view3d_get,
+      cfp_array3d_cfp_private_view3d_set,
+    },
+  },
+  // array3i
+  {
+    cfp_array3i_ctor_default,
+    cfp_array3i_ctor,
+    cfp_array3i_ctor_copy,
+    cfp_array3i_ctor_header,
+    cfp_array3i_ctor_adopt,
+    cfp_array3i_dtor,
+
+    cfp_array3i_deep_copy,
+
+    cfp_array3i_rate,
+    cfp_array3i_set_rate,
+    cfp_array3i_set_precision,
+    cfp_array3i_set_reversible,
+    cfp_array3i_cache_size,
+    cfp_array3i_set_cache_size,
+    cfp_array3i_clear_cache,
+    cfp_array3i_flush_cache,
+    cfp_array3i_compressed_size,
+    cfp_array3i_compressed_data,
+    cfp_array3i_borrowed,
+    cfp_array3i_own,
+    cfp_array3i_size,
+    cfp_array3i_size_x,
+    cfp_array3i_size_y,
+    cfp_array3i_size_z,
+    cfp_array3i_resize,
+
+    cfp_array3i_get_array,
+    cfp_array3i_set_array,
+    cfp_array3i_get_flat,
+    cfp_array3i_set_flat,
+    cfp_array3i_get,
+    cfp_array3i_set,
+
+    cfp_array3i_ref,
+    cfp_array3i_ref_flat,
+
+    cfp_array3i_ptr,
+    cfp_array3i_ptr_flat,
+
+    cfp_array3i_begin,
+    cfp_array3i_end,
+
+    {
+      cfp_array3i_cfp_ref3i_get,
+      cfp_array3i_cfp_ref3i_set,
+      cfp_array3i_cfp_ref3i_ptr,
+      cfp_array3i_cfp_ref3i_copy,
+    },
+
+    {
+      cfp_array3i_cfp_ptr3i_get,
+      cfp_array3i_cfp_ptr3i_get_at,
+      cfp_array3i_cfp_ptr3i_set,
+      cfp_array3i_cfp_ptr3i_set_at,
+      cfp_array3i_cfp_ptr3i_ref,
+      cfp_array3i_cfp_ptr3i_ref_at,
+      cfp_array3i_cfp_ptr3i_lt,
+      cfp_array3i_cfp_ptr3i_gt,
+      cfp_array3i_cfp_ptr3i_leq,
+      cfp_array3i_cfp_ptr3i_geq,
+      cfp_array3i_cfp_ptr3i_eq,
+      cfp_array3i_cfp_ptr3i_neq,
+      cfp_array3i_cfp_ptr3i_distance,
+      cfp_array3i_cfp_ptr3i_next,
+      cfp_array3i_cfp_ptr3i_prev,
+      cfp_array3i_cfp_ptr3i_inc,
+      cfp_array3i_cfp_ptr3i_dec,
+    },
+
+    {
+      cfp_array3i_cfp_iter3i_get,
+      cfp_array3i_cfp_iter3i_get_at,
+      cfp_array3i_cfp_iter3i_set,
+      cfp_array3i_cfp_iter3i_set_at,
+      cfp_array3i_cfp_iter3i_ref,
+      cfp_array3i_cfp_iter3i_ref_at,
+      cfp_array3i_cfp_iter3i_ptr,
+      cfp_array3i_cfp_iter3i_ptr_at,
+      cfp_array3i_cfp_iter3i_i,
+      cfp_array3i_cfp_iter3i_j,
+      cfp_array3i_cfp_iter3i_k,
+      cfp_array3i_cfp_iter3i_lt,
+      cfp_array3i_cfp_iter3i_gt,
+      cfp_array3i_cfp_iter3i_leq,
+      cfp_array3i_cfp_iter3i_geq,
+      cfp_array3i_cfp_iter3i_eq,
+      cfp_array3i_cfp_iter3i_neq,
+      cfp_array3i_cfp_iter3i_distance,
+      cfp_array3i_cfp_iter3i_next,
+      cfp_array3i_cfp_iter3i_prev,
+      cfp_array3i_cfp_iter3i_inc,
+      cfp_array3i_cfp_iter3i_dec,
+    },
+
+    {
+      cfp_header_ctor_array3i,
+      cfp_header_ctor_buffer,
+      cfp_header_dtor,
+      cfp_header_scalar_type,
+      cfp_header_dimensionality,
+      cfp_header_size_x,
+      cfp_header_size_y,
+      cfp_header_size_z,
+      cfp_header_size_w,
+      cfp_header_rate,
+      cfp_header_data,
+      cfp_header_size_bytes,
+    },
+
+    cfp_array3i_get_box,
+    cfp_array3i_set_box,
+    cfp_array3i_get_block,
+    cfp_array3i_set_block,
+    cfp_array3i_for_each_block,
+
+    {
+      cfp_array3i_cfp_private_view3i_ctor,
+      cfp_array3i_cfp_private_view3i_ctor_subset,
+      cfp_array3i_cfp_private_view3i_dtor,
+      cfp_array3i_cfp_private_view3i_size_x,
+      cfp_array3i_cfp_private_view3i_size_y,
+      cfp_array3i_cfp_private_view3i_size_z,
+      cfp_array3i_cfp_private_view3i_global_x,
+      cfp_array3i_cfp_private_view3i_global_y,
+      cfp_array3i_cfp_private_view3i_global_z,
+      cfp_array3i_cfp_private_view3i_partition,
+      cfp_array3i_cfp_private_view3i_cache_size,
+      cfp_array3i_cfp_private_view3i_set_cache_size,
+      cfp_array3i_cfp_private_view3i_clear_cache,
+      cfp_array3i_cfp_private_view3i_flush_cache,
+      cfp_array3i_cfp_private_view3i_get,
+      cfp_array3i_cfp_private_view3i_set,
+    },
+  },
+  // array3l
+  {
+    cfp_array3l_ctor_default,
+    cfp_array3l_ctor,
+    cfp_array3l_ctor_copy,
+    cfp_array3l_ctor_header,
+    cfp_array3l_ctor_adopt,
+    cfp_array3l_dtor,
+
+    cfp_array3l_deep_copy,
+
+    cfp_array3l_rate,
+    cfp_array3l_set_rate,
+    cfp_array3l_set_precision,
+    cfp_array3l_set_reversible,
+    cfp_array3l_cache_size,
+    cfp_array3l_set_cache_size,
+    cfp_array3l_clear_cache,
+    cfp_array3l_flush_cache,
+    cfp_array3l_compressed_size,
+    cfp_array3l_compressed_data,
+    cfp_array3l_borrowed,
+    cfp_array3l_own,
+    cfp_array3l_size,
+    cfp_array3l_size_x,
+    cfp_array3l_size_y,
+    cfp_array3l_size_z,
+    cfp_array3l_resize,
+
+    cfp_array3l_get_array,
+    cfp_array3l_set_array,
+    cfp_array3l_get_flat,
+    cfp_array3l_set_flat,
+    cfp_array3l_get,
+    cfp_array3l_set,
+
+    cfp_array3l_ref,
+    cfp_array3l_ref_flat,
+
+    cfp_array3l_ptr,
+    cfp_array3l_ptr_flat,
+
+    cfp_array3l_begin,
+    cfp_array3l_end,
+
+    {
+      cfp_array3l_cfp_ref3l_get,
+      cfp_array3l_cfp_ref3l_set,
+      cfp_array3l_cfp_ref3l_ptr,
+      cfp_array3l_cfp_ref3l_copy,
+    },
+
+    {
+      cfp_array3l_cfp_ptr3l_get,
+      cfp_array3l_cfp_ptr3l_get_at,
+      cfp_array3l_cfp_ptr3l_set,
+      cfp_array3l_cfp_ptr3l_set_at,
+      cfp_array3l_cfp_ptr3l_ref,
+      cfp_array3l_cfp_ptr3l_ref_at,
+      cfp_array3l_cfp_ptr3l_lt,
+      cfp_array3l_cfp_ptr3l_gt,
+      cfp_array3l_cfp_ptr3l_leq,
+      cfp_array3l_cfp_ptr3l_geq,
+      cfp_array3l_cfp_ptr3l_eq,
+      cfp_array3l_cfp_ptr3l_neq,
+      cfp_array3l_cfp_ptr3l_distance,
+      cfp_array3l_cfp_ptr3l_next,
+      cfp_array3l_cfp_ptr3l_prev,
+      cfp_array3l_cfp_ptr3l_inc,
+      cfp_array3l_cfp_ptr3l_dec,
+    },
+
+    {
+      cfp_array3l_cfp_iter3l_get,
+      cfp_array3l_cfp_iter3l_get_at,
+      cfp_array3l_cfp_iter3l_set,
+      cfp_array3l_cfp_iter3l_set_at,
+      cfp_array3l_cfp_iter3l_ref,
+      cfp_array3l_cfp_iter3l_ref_at,
+      cfp_array3l_cfp_iter3l_ptr,
+      cfp_array3l_cfp_iter3l_ptr_at,
+      cfp_array3l_cfp_iter3l_i,
+      cfp_array3l_cfp_iter3l_j,
+      cfp_array3l_cfp_iter3l_k,
+      cfp_array3l_cfp_iter3l_lt,
+      cfp_array3l_cfp_iter3l_gt,
+      cfp_array3l_cfp_iter3l_leq,
+      cfp_array3l_cfp_iter3l_geq,
+      cfp_array3l_cfp_iter3l_eq,
+      cfp_array3l_cfp_iter3l_neq,
+      cfp_array3l_cfp_iter3l_distance,
+      cfp_array3l_cfp_iter3l_next,
+      cfp_array3l_cfp_iter3l_prev,
+      cfp_array3l_cfp_iter3l_inc,
+      cfp_array3l_cfp_iter3l_dec,
+    },
+
+    {
+      cfp_header_ctor_array3l,
+      cfp_header_ctor_buffer,
+      cfp_header_dtor,
+      cfp_header_scalar_type,
+      cfp_header_dimensionality,
+      cfp_header_size_x,
+      cfp_header_size_y,
+      cfp_header_size_z,
+      cfp_header_size_w,
+      cfp_header_rate,
+      cfp_header_data,
+      cfp_header_size_bytes,
+    },
+
+    cfp_array3l_get_box,
+    cfp_array3l_set_box,
+    cfp_array3l_get_block,
+    cfp_array3l_set_block,
+    cfp_array3l_for_each_block,
+
+    {
+      cfp_array3l_cfp_private_view3l_ctor,
+      cfp_array3l_cfp_private_view3l_ctor_subset,
+      cfp_array3l_cfp_private_view3l_dtor,
+      cfp_array3l_cfp_private_view3l_size_x,
+      cfp_array3l_cfp_private_view3l_size_y,
+      cfp_array3l_cfp_private_view3l_size_z,
+      cfp_array3l_cfp_private_view3l_global_x,
+      cfp_array3l_cfp_private_view3l_global_y,
+      cfp_array3l_cfp_private_view3l_global_z,
+      cfp_array3l_cfp_private_view3l_partition,
+      cfp_array3l_cfp_private_view3l_cache_size,
+      cfp_array3l_cfp_private_view3l_set_cache_size,
+      cfp_array3l_cfp_private_view3l_clear_cache,
+      cfp_array3l_cfp_private_view3l_flush_cache,
+      cfp_array3l_cfp_private_view3l_get,
+      cfp_array3l_cfp_private_view3l_set,
+    },
   },
   // array4f
   {
@@ -645,6 +993,7 @@ const cfp_api CFP_NAMESPACE = {
     cfp_array4f_ctor,
     cfp_array4f_ctor_copy,
     cfp_array4f_ctor_header,
+    cfp_array4f_ctor_adopt,
     cfp_array4f_dtor,
 
     cfp_array4f_deep_copy,
@@ -657,6 +1006,8 @@ const cfp_api CFP_NAMESPACE = {
     cfp_array4f_flush_cache,
     cfp_array4f_compressed_size,
     cfp_array4f_compressed_data,
+    cfp_array4f_borrowed,
+    cfp_array4f_own,
     cfp_array4f_size,
     cfp_array4f_size_x,
     cfp_array4f_size_y,
@@ -754,6 +1105,7 @@ const cfp_api CFP_NAMESPACE = {
     cfp_array4d_ctor,
     cfp_array4d_ctor_copy,
     cfp_array4d_ctor_header,
+    cfp_array4d_ctor_adopt,
     cfp_array4d_dtor,
 
     cfp_array4d_deep_copy,
@@ -766,6 +1118,8 @@ const cfp_api CFP_NAMESPACE = {
     cfp_array4d_flush_cache,
     cfp_array4d_compressed_size,
     cfp_array4d_compressed_data,
+    cfp_array4d_borrowed,
+    cfp_array4d_own,
     cfp_array4d_size,
     cfp_array4d_size_x,
     cfp_array4d_size_y,
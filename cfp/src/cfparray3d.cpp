@@ -7,6 +7,7 @@
 #define CFP_REF_TYPE cfp_ref3d
 #define CFP_PTR_TYPE cfp_ptr3d
 #define CFP_ITER_TYPE cfp_iter3d
+#define CFP_VIEW_TYPE cfp_private_view3d
 #define ZFP_ARRAY_TYPE zfp::array3d
 #define ZFP_SCALAR_TYPE double
 
@@ -17,5 +18,6 @@
 #undef CFP_REF_TYPE
 #undef CFP_PTR_TYPE
 #undef CFP_ITER_TYPE
+#undef CFP_VIEW_TYPE
 #undef ZFP_ARRAY_TYPE
 #undef ZFP_SCALAR_TYPE
@@ -0,0 +1,23 @@
+#include "cfparray3l.h"
+#include "zfparray3.h"
+
+#include "template/template.h"
+
+#define CFP_ARRAY_TYPE cfp_array3l
+#define CFP_REF_TYPE cfp_ref3l
+#define CFP_PTR_TYPE cfp_ptr3l
+#define CFP_ITER_TYPE cfp_iter3l
+#define CFP_VIEW_TYPE cfp_private_view3l
+#define ZFP_ARRAY_TYPE zfp::array3l
+#define ZFP_SCALAR_TYPE int64
+
+#include "template/cfparray.cpp"
+#include "template/cfparray3.cpp"
+
+#undef CFP_ARRAY_TYPE
+#undef CFP_REF_TYPE
+#undef CFP_PTR_TYPE
+#undef CFP_ITER_TYPE
+#undef CFP_VIEW_TYPE
+#undef ZFP_ARRAY_TYPE
+#undef ZFP_SCALAR_TYPE
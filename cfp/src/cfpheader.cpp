@@ -10,6 +10,8 @@
 #include "cfparray2d.h"
 #include "cfparray3f.h"
 #include "cfparray3d.h"
+#include "cfparray3i.h"
+#include "cfparray3l.h"
 #include "cfparray4f.h"
 #include "cfparray4d.h"
 
@@ -23,6 +23,15 @@ _t1(CFP_ARRAY_TYPE, ctor_header)(CFP_HEADER_TYPE h, const void* buffer, size_t b
   return a;
 }
 
+// borrow buffer without a copy; it must outlive the array or a call to own()
+static CFP_ARRAY_TYPE
+_t1(CFP_ARRAY_TYPE, ctor_adopt)(CFP_HEADER_TYPE h, const void* buffer, size_t buffer_size_bytes)
+{
+  CFP_ARRAY_TYPE a;
+  a.object = new ZFP_ARRAY_TYPE(*static_cast<zfp::array::header*>(h.object), buffer, buffer_size_bytes, true);
+  return a;
+}
+
 static void
 _t1(CFP_ARRAY_TYPE, dtor)(CFP_ARRAY_TYPE self)
 {
@@ -54,6 +63,18 @@ _t1(CFP_ARRAY_TYPE, compressed_data)(CFP_ARRAY_TYPE self)
   return static_cast<const ZFP_ARRAY_TYPE*>(self.object)->compressed_data();
 }
 
+static zfp_bool
+_t1(CFP_ARRAY_TYPE, borrowed)(CFP_ARRAY_TYPE self)
+{
+  return static_cast<const ZFP_ARRAY_TYPE*>(self.object)->borrowed();
+}
+
+static void
+_t1(CFP_ARRAY_TYPE, own)(CFP_ARRAY_TYPE self)
+{
+  static_cast<ZFP_ARRAY_TYPE*>(self.object)->own();
+}
+
 static void
 _t1(CFP_ARRAY_TYPE, deep_copy)(CFP_ARRAY_TYPE self, const CFP_ARRAY_TYPE src)
 {
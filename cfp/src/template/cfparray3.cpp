@@ -93,6 +93,18 @@ _t1(CFP_ARRAY_TYPE, ctor)(size_t nx, size_t ny, size_t nz, double rate, const ZF
   return a;
 }
 
+static uint
+_t1(CFP_ARRAY_TYPE, set_precision)(CFP_ARRAY_TYPE self, uint precision)
+{
+  return static_cast<ZFP_ARRAY_TYPE*>(self.object)->set_precision(precision);
+}
+
+static void
+_t1(CFP_ARRAY_TYPE, set_reversible)(CFP_ARRAY_TYPE self)
+{
+  static_cast<ZFP_ARRAY_TYPE*>(self.object)->set_reversible();
+}
+
 static size_t
 _t1(CFP_ARRAY_TYPE, size_x)(CFP_ARRAY_TYPE self)
 {
@@ -129,6 +141,73 @@ _t1(CFP_ARRAY_TYPE, set)(CFP_ARRAY_TYPE self, size_t i, size_t j, size_t k, ZFP_
   static_cast<ZFP_ARRAY_TYPE*>(self.object)->operator()(i, j, k) = val;
 }
 
+static void
+_t1(CFP_ARRAY_TYPE, get_box)(CFP_ARRAY_TYPE self, ZFP_SCALAR_TYPE* p, size_t x, size_t y, size_t z, size_t nx, size_t ny, size_t nz, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz)
+{
+  static_cast<const ZFP_ARRAY_TYPE*>(self.object)->get(p, x, y, z, nx, ny, nz, sx, sy, sz);
+}
+
+static void
+_t1(CFP_ARRAY_TYPE, set_box)(CFP_ARRAY_TYPE self, const ZFP_SCALAR_TYPE* p, size_t x, size_t y, size_t z, size_t nx, size_t ny, size_t nz, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz)
+{
+  static_cast<ZFP_ARRAY_TYPE*>(self.object)->set(p, x, y, z, nx, ny, nz, sx, sy, sz);
+}
+
+// utility function: extent of block (bx, by, bz), which may be partial
+static void
+block_box(const ZFP_ARRAY_TYPE* a, size_t bx, size_t by, size_t bz, size_t& nx, size_t& ny, size_t& nz)
+{
+  nx = std::min(a->size_x() - 4 * bx, size_t(4));
+  ny = std::min(a->size_y() - 4 * by, size_t(4));
+  nz = std::min(a->size_z() - 4 * bz, size_t(4));
+}
+
+static void
+_t1(CFP_ARRAY_TYPE, get_block)(CFP_ARRAY_TYPE self, ZFP_SCALAR_TYPE* p, size_t bx, size_t by, size_t bz, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz)
+{
+  const ZFP_ARRAY_TYPE* a = static_cast<const ZFP_ARRAY_TYPE*>(self.object);
+  size_t nx, ny, nz;
+  block_box(a, bx, by, bz, nx, ny, nz);
+  a->get(p, 4 * bx, 4 * by, 4 * bz, nx, ny, nz, sx, sy, sz);
+}
+
+static void
+_t1(CFP_ARRAY_TYPE, set_block)(CFP_ARRAY_TYPE self, const ZFP_SCALAR_TYPE* p, size_t bx, size_t by, size_t bz, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz)
+{
+  ZFP_ARRAY_TYPE* a = static_cast<ZFP_ARRAY_TYPE*>(self.object);
+  size_t nx, ny, nz;
+  block_box(a, bx, by, bz, nx, ny, nz);
+  a->set(p, 4 * bx, 4 * by, 4 * bz, nx, ny, nz, sx, sy, sz);
+}
+
+#ifndef CFP_BLOCK_VISITOR
+#define CFP_BLOCK_VISITOR
+// adapter from C callback with context to C++ block visitor
+template <typename Scalar, typename Function>
+class block_visitor {
+public:
+  block_visitor(Function f, void* context) : f(f), context(context) {}
+  template <typename Pointer>
+  void operator()(Pointer p, size_t i, size_t j, size_t k, size_t mx, size_t my, size_t mz) const
+  {
+    f(const_cast<Scalar*>(p), i, j, k, mx, my, mz, context);
+  }
+protected:
+  Function f;
+  void* context;
+};
+#endif
+
+static void
+_t1(CFP_ARRAY_TYPE, for_each_block)(CFP_ARRAY_TYPE self, void (*f)(ZFP_SCALAR_TYPE*, size_t, size_t, size_t, size_t, size_t, size_t, void*), void* context, zfp_bool write)
+{
+  typedef block_visitor<ZFP_SCALAR_TYPE, void (*)(ZFP_SCALAR_TYPE*, size_t, size_t, size_t, size_t, size_t, size_t, void*)> visitor;
+  if (write)
+    static_cast<ZFP_ARRAY_TYPE*>(self.object)->for_each_block(visitor(f, context));
+  else
+    static_cast<const ZFP_ARRAY_TYPE*>(self.object)->for_each_block(visitor(f, context));
+}
+
 static CFP_REF_TYPE
 _t1(CFP_ARRAY_TYPE, ref)(CFP_ARRAY_TYPE self, size_t i, size_t j, size_t k)
 {
@@ -520,3 +599,103 @@ _t2(CFP_ARRAY_TYPE, CFP_ITER_TYPE, k)(CFP_ITER_TYPE self)
 {
   return self.z;
 }
+
+static CFP_VIEW_TYPE
+_t2(CFP_ARRAY_TYPE, CFP_VIEW_TYPE, ctor)(CFP_ARRAY_TYPE a, size_t cache_size)
+{
+  CFP_VIEW_TYPE v;
+  v.object = new ZFP_ARRAY_TYPE::private_view(static_cast<ZFP_ARRAY_TYPE*>(a.object), cache_size);
+  return v;
+}
+
+static CFP_VIEW_TYPE
+_t2(CFP_ARRAY_TYPE, CFP_VIEW_TYPE, ctor_subset)(CFP_ARRAY_TYPE a, size_t x, size_t y, size_t z, size_t nx, size_t ny, size_t nz, size_t cache_size)
+{
+  CFP_VIEW_TYPE v;
+  v.object = new ZFP_ARRAY_TYPE::private_view(static_cast<ZFP_ARRAY_TYPE*>(a.object), x, y, z, nx, ny, nz, cache_size);
+  return v;
+}
+
+static void
+_t2(CFP_ARRAY_TYPE, CFP_VIEW_TYPE, dtor)(CFP_VIEW_TYPE self)
+{
+  delete static_cast<ZFP_ARRAY_TYPE::private_view*>(self.object);
+}
+
+static size_t
+_t2(CFP_ARRAY_TYPE, CFP_VIEW_TYPE, size_x)(CFP_VIEW_TYPE self)
+{
+  return static_cast<const ZFP_ARRAY_TYPE::private_view*>(self.object)->size_x();
+}
+
+static size_t
+_t2(CFP_ARRAY_TYPE, CFP_VIEW_TYPE, size_y)(CFP_VIEW_TYPE self)
+{
+  return static_cast<const ZFP_ARRAY_TYPE::private_view*>(self.object)->size_y();
+}
+
+static size_t
+_t2(CFP_ARRAY_TYPE, CFP_VIEW_TYPE, size_z)(CFP_VIEW_TYPE self)
+{
+  return static_cast<const ZFP_ARRAY_TYPE::private_view*>(self.object)->size_z();
+}
+
+static size_t
+_t2(CFP_ARRAY_TYPE, CFP_VIEW_TYPE, global_x)(CFP_VIEW_TYPE self, size_t i)
+{
+  return static_cast<const ZFP_ARRAY_TYPE::private_view*>(self.object)->global_x(i);
+}
+
+static size_t
+_t2(CFP_ARRAY_TYPE, CFP_VIEW_TYPE, global_y)(CFP_VIEW_TYPE self, size_t j)
+{
+  return static_cast<const ZFP_ARRAY_TYPE::private_view*>(self.object)->global_y(j);
+}
+
+static size_t
+_t2(CFP_ARRAY_TYPE, CFP_VIEW_TYPE, global_z)(CFP_VIEW_TYPE self, size_t k)
+{
+  return static_cast<const ZFP_ARRAY_TYPE::private_view*>(self.object)->global_z(k);
+}
+
+static void
+_t2(CFP_ARRAY_TYPE, CFP_VIEW_TYPE, partition)(CFP_VIEW_TYPE self, size_t index, size_t count)
+{
+  static_cast<ZFP_ARRAY_TYPE::private_view*>(self.object)->partition(index, count);
+}
+
+static size_t
+_t2(CFP_ARRAY_TYPE, CFP_VIEW_TYPE, cache_size)(CFP_VIEW_TYPE self)
+{
+  return static_cast<const ZFP_ARRAY_TYPE::private_view*>(self.object)->cache_size();
+}
+
+static void
+_t2(CFP_ARRAY_TYPE, CFP_VIEW_TYPE, set_cache_size)(CFP_VIEW_TYPE self, size_t bytes)
+{
+  static_cast<ZFP_ARRAY_TYPE::private_view*>(self.object)->set_cache_size(bytes);
+}
+
+static void
+_t2(CFP_ARRAY_TYPE, CFP_VIEW_TYPE, clear_cache)(CFP_VIEW_TYPE self)
+{
+  static_cast<const ZFP_ARRAY_TYPE::private_view*>(self.object)->clear_cache();
+}
+
+static void
+_t2(CFP_ARRAY_TYPE, CFP_VIEW_TYPE, flush_cache)(CFP_VIEW_TYPE self)
+{
+  static_cast<const ZFP_ARRAY_TYPE::private_view*>(self.object)->flush_cache();
+}
+
+static ZFP_SCALAR_TYPE
+_t2(CFP_ARRAY_TYPE, CFP_VIEW_TYPE, get)(CFP_VIEW_TYPE self, size_t i, size_t j, size_t k)
+{
+  return static_cast<const ZFP_ARRAY_TYPE::private_view*>(self.object)->operator()(i, j, k);
+}
+
+static void
+_t2(CFP_ARRAY_TYPE, CFP_VIEW_TYPE, set)(CFP_VIEW_TYPE self, size_t i, size_t j, size_t k, ZFP_SCALAR_TYPE val)
+{
+  static_cast<ZFP_ARRAY_TYPE::private_view*>(self.object)->operator()(i, j, k) = val;
+}
@@ -26,6 +26,10 @@ _t1(CFP_HEADER_TYPE, ctor_buffer)(const void* data, size_t bytes)
           h.object = new zfp::array3f::header(data, bytes);
         else if (scalar_type == zfp_type_double)
           h.object = new zfp::array3d::header(data, bytes);
+        else if (scalar_type == zfp_type_int32)
+          h.object = new zfp::array3i::header(data, bytes);
+        else if (scalar_type == zfp_type_int64)
+          h.object = new zfp::array3l::header(data, bytes);
         break;
       case 4:
         if (scalar_type == zfp_type_float)
@@ -89,6 +93,22 @@ _t1(CFP_HEADER_TYPE, ctor_array3d)(cfp_array3d a)
   return h;
 }
 
+static CFP_HEADER_TYPE
+_t1(CFP_HEADER_TYPE, ctor_array3i)(cfp_array3i a)
+{
+  CFP_HEADER_TYPE h;
+  h.object = new zfp::array3i::header(*static_cast<zfp::array3i*>(a.object));
+  return h;
+}
+
+static CFP_HEADER_TYPE
+_t1(CFP_HEADER_TYPE, ctor_array3l)(cfp_array3l a)
+{
+  CFP_HEADER_TYPE h;
+  h.object = new zfp::array3l::header(*static_cast<zfp::array3l*>(a.object));
+  return h;
+}
+
 static CFP_HEADER_TYPE
 _t1(CFP_HEADER_TYPE, ctor_array4f)(cfp_array4f a)
 {
@@ -0,0 +1,59 @@
+/* flat entry points into the cfp API for zFORp, since Fortran cannot call
+   through the function pointers held by the cfp namespace struct; arrays
+   and views are passed as their opaque object pointers */
+
+#include "cfparray.h"
+
+#define ZFORP_CFP_ARRAY3(t, Scalar) \
+\
+void* \
+zforp_cfp_array3##t##_ctor(size_t nx, size_t ny, size_t nz, double rate, const Scalar* p, size_t cache_size) \
+{ \
+  return CFP_NAMESPACE.array3##t.ctor(nx, ny, nz, rate, p, cache_size).object; \
+} \
+\
+void zforp_cfp_array3##t##_dtor(void* a) { cfp_array3##t x = { a }; CFP_NAMESPACE.array3##t.dtor(x); } \
+double zforp_cfp_array3##t##_rate(void* a) { cfp_array3##t x = { a }; return CFP_NAMESPACE.array3##t.rate(x); } \
+double zforp_cfp_array3##t##_set_rate(void* a, double rate) { cfp_array3##t x = { a }; return CFP_NAMESPACE.array3##t.set_rate(x, rate); } \
+size_t zforp_cfp_array3##t##_cache_size(void* a) { cfp_array3##t x = { a }; return CFP_NAMESPACE.array3##t.cache_size(x); } \
+void zforp_cfp_array3##t##_set_cache_size(void* a, size_t bytes) { cfp_array3##t x = { a }; CFP_NAMESPACE.array3##t.set_cache_size(x, bytes); } \
+void zforp_cfp_array3##t##_clear_cache(void* a) { cfp_array3##t x = { a }; CFP_NAMESPACE.array3##t.clear_cache(x); } \
+void zforp_cfp_array3##t##_flush_cache(void* a) { cfp_array3##t x = { a }; CFP_NAMESPACE.array3##t.flush_cache(x); } \
+size_t zforp_cfp_array3##t##_compressed_size(void* a) { cfp_array3##t x = { a }; return CFP_NAMESPACE.array3##t.compressed_size(x); } \
+void* zforp_cfp_array3##t##_compressed_data(void* a) { cfp_array3##t x = { a }; return CFP_NAMESPACE.array3##t.compressed_data(x); } \
+size_t zforp_cfp_array3##t##_size_x(void* a) { cfp_array3##t x = { a }; return CFP_NAMESPACE.array3##t.size_x(x); } \
+size_t zforp_cfp_array3##t##_size_y(void* a) { cfp_array3##t x = { a }; return CFP_NAMESPACE.array3##t.size_y(x); } \
+size_t zforp_cfp_array3##t##_size_z(void* a) { cfp_array3##t x = { a }; return CFP_NAMESPACE.array3##t.size_z(x); } \
+void zforp_cfp_array3##t##_get_array(void* a, Scalar* p) { cfp_array3##t x = { a }; CFP_NAMESPACE.array3##t.get_array(x, p); } \
+void zforp_cfp_array3##t##_set_array(void* a, const Scalar* p) { cfp_array3##t x = { a }; CFP_NAMESPACE.array3##t.set_array(x, p); } \
+Scalar zforp_cfp_array3##t##_get(void* a, size_t i, size_t j, size_t k) { cfp_array3##t x = { a }; return CFP_NAMESPACE.array3##t.get(x, i, j, k); } \
+void zforp_cfp_array3##t##_set(void* a, size_t i, size_t j, size_t k, Scalar val) { cfp_array3##t x = { a }; CFP_NAMESPACE.array3##t.set(x, i, j, k, val); } \
+\
+void* \
+zforp_cfp_private_view3##t##_ctor(void* a, size_t cache_size) \
+{ \
+  cfp_array3##t x = { a }; \
+  return CFP_NAMESPACE.array3##t.private_view.ctor(x, cache_size).object; \
+} \
+\
+void* \
+zforp_cfp_private_view3##t##_ctor_subset(void* a, size_t x0, size_t y0, size_t z0, size_t nx, size_t ny, size_t nz, size_t cache_size) \
+{ \
+  cfp_array3##t x = { a }; \
+  return CFP_NAMESPACE.array3##t.private_view.ctor_subset(x, x0, y0, z0, nx, ny, nz, cache_size).object; \
+} \
+\
+void zforp_cfp_private_view3##t##_dtor(void* v) { cfp_private_view3##t x = { v }; CFP_NAMESPACE.array3##t.private_view.dtor(x); } \
+size_t zforp_cfp_private_view3##t##_size_x(void* v) { cfp_private_view3##t x = { v }; return CFP_NAMESPACE.array3##t.private_view.size_x(x); } \
+size_t zforp_cfp_private_view3##t##_size_y(void* v) { cfp_private_view3##t x = { v }; return CFP_NAMESPACE.array3##t.private_view.size_y(x); } \
+size_t zforp_cfp_private_view3##t##_size_z(void* v) { cfp_private_view3##t x = { v }; return CFP_NAMESPACE.array3##t.private_view.size_z(x); } \
+size_t zforp_cfp_private_view3##t##_global_x(void* v, size_t i) { cfp_private_view3##t x = { v }; return CFP_NAMESPACE.array3##t.private_view.global_x(x, i); } \
+size_t zforp_cfp_private_view3##t##_global_y(void* v, size_t j) { cfp_private_view3##t x = { v }; return CFP_NAMESPACE.array3##t.private_view.global_y(x, j); } \
+size_t zforp_cfp_private_view3##t##_global_z(void* v, size_t k) { cfp_private_view3##t x = { v }; return CFP_NAMESPACE.array3##t.private_view.global_z(x, k); } \
+void zforp_cfp_private_view3##t##_partition(void* v, size_t index, size_t count) { cfp_private_view3##t x = { v }; CFP_NAMESPACE.array3##t.private_view.partition(x, index, count); } \
+void zforp_cfp_private_view3##t##_flush_cache(void* v) { cfp_private_view3##t x = { v }; CFP_NAMESPACE.array3##t.private_view.flush_cache(x); } \
+Scalar zforp_cfp_private_view3##t##_get(void* v, size_t i, size_t j, size_t k) { cfp_private_view3##t x = { v }; return CFP_NAMESPACE.array3##t.private_view.get(x, i, j, k); } \
+void zforp_cfp_private_view3##t##_set(void* v, size_t i, size_t j, size_t k, Scalar val) { cfp_private_view3##t x = { v }; CFP_NAMESPACE.array3##t.private_view.set(x, i, j, k, val); }
+
+ZFORP_CFP_ARRAY3(f, float)
+ZFORP_CFP_ARRAY3(d, double)
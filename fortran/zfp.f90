@@ -1,6 +1,6 @@
 module zFORp
 
-  use, intrinsic :: iso_c_binding, only: c_int, c_int64_t, c_size_t, c_double, c_ptr, c_null_ptr, c_loc
+  use, intrinsic :: iso_c_binding, only: c_int, c_int64_t, c_size_t, c_float, c_double, c_ptr, c_null_ptr, c_loc
   implicit none
   private
 
@@ -20,6 +20,27 @@ module zFORp
     type(c_ptr) :: object = c_null_ptr
   end type zFORp_field
 
+  ! compressed arrays and private views backed by cfp
+  type, bind(c) :: zFORp_array3f
+    private
+    type(c_ptr) :: object = c_null_ptr
+  end type zFORp_array3f
+
+  type, bind(c) :: zFORp_private_view3f
+    private
+    type(c_ptr) :: object = c_null_ptr
+  end type zFORp_private_view3f
+
+  type, bind(c) :: zFORp_array3d
+    private
+    type(c_ptr) :: object = c_null_ptr
+  end type zFORp_array3d
+
+  type, bind(c) :: zFORp_private_view3d
+    private
+    type(c_ptr) :: object = c_null_ptr
+  end type zFORp_private_view3d
+
   enum, bind(c)
     enumerator :: zFORp_type_none = 0, &
                   zFORp_type_int32 = 1, &
@@ -40,7 +61,11 @@ module zFORp
   enum, bind(c)
     enumerator :: zFORp_exec_serial = 0, &
                   zFORp_exec_omp = 1, &
-                  zFORp_exec_cuda = 2
+                  zFORp_exec_cuda = 2, &
+                  zFORp_exec_hip = 3, &
+                  zFORp_exec_threads = 4, &
+                  zFORp_exec_omp_target = 5, &
+                  zFORp_exec_sycl = 6
   end enum
 
   ! constants are hardcoded
@@ -257,22 +282,78 @@ module zFORp
       integer(c_int) chunk_size_blocks
     end function
 
+    function zfp_stream_thread_count(stream) result(num_threads) bind(c, name="zfp_stream_thread_count")
+      import
+      type(c_ptr), value :: stream
+      integer(c_int) num_threads
+    end function
+
+    function zfp_stream_thread_chunk_size(stream) result(chunk_size_blocks) bind(c, name="zfp_stream_thread_chunk_size")
+      import
+      type(c_ptr), value :: stream
+      integer(c_int) chunk_size_blocks
+    end function
+
     function zfp_stream_set_execution(stream, execution_policy) result(is_success) bind(c, name="zfp_stream_set_execution")
       import
       type(c_ptr), value :: stream
-      integer(c_int) execution_policy, is_success
+      integer(c_int), value :: execution_policy
+      integer(c_int) is_success
     end function
 
     function zfp_stream_set_omp_threads(stream, threads) result(is_success) bind(c, name="zfp_stream_set_omp_threads")
       import
       type(c_ptr), value :: stream
-      integer(c_int) threads, is_success
+      integer(c_int), value :: threads
+      integer(c_int) is_success
     end function
 
     function zfp_stream_set_omp_chunk_size(stream, chunk_size) result(is_success) bind(c, name="zfp_stream_set_omp_chunk_size")
       import
       type(c_ptr), value :: stream
-      integer(c_int) chunk_size, is_success
+      integer(c_int), value :: chunk_size
+      integer(c_int) is_success
+    end function
+
+    function zfp_stream_set_thread_count(stream, threads) result(is_success) bind(c, name="zfp_stream_set_thread_count")
+      import
+      type(c_ptr), value :: stream
+      integer(c_int), value :: threads
+      integer(c_int) is_success
+    end function
+
+    function zfp_stream_set_thread_chunk_size(stream, chunk_size) result(is_success) &
+        bind(c, name="zfp_stream_set_thread_chunk_size")
+      import
+      type(c_ptr), value :: stream
+      integer(c_int), value :: chunk_size
+      integer(c_int) is_success
+    end function
+
+    function zfp_stream_set_cuda_stream(stream, cuda_stream) result(is_success) bind(c, name="zfp_stream_set_cuda_stream")
+      import
+      type(c_ptr), value :: stream, cuda_stream
+      integer(c_int) is_success
+    end function
+
+    function zfp_stream_set_hip_stream(stream, hip_stream) result(is_success) bind(c, name="zfp_stream_set_hip_stream")
+      import
+      type(c_ptr), value :: stream, hip_stream
+      integer(c_int) is_success
+    end function
+
+    function zfp_stream_set_omp_target_device(stream, device) result(is_success) &
+        bind(c, name="zfp_stream_set_omp_target_device")
+      import
+      type(c_ptr), value :: stream
+      integer(c_int), value :: device
+      integer(c_int) is_success
+    end function
+
+    function zfp_stream_set_sycl_queue(stream, queue) result(is_success) bind(c, name="zfp_stream_set_sycl_queue")
+      import
+      type(c_ptr), value :: stream, queue
+      integer(c_int) is_success
     end function
 
     ! high-level API: zfp_field functions
@@ -457,6 +538,386 @@ module zFORp
       type(c_ptr), value :: stream
     end subroutine
 
+    ! compressed arrays: array3f
+
+    function zforp_cfp_array3f_ctor(nx, ny, nz, rate, data_ptr, cache_size) result(array) bind(c, name="zforp_cfp_array3f_ctor")
+      import
+      integer(c_size_t), value :: nx, ny, nz, cache_size
+      real(c_double), value :: rate
+      type(c_ptr), value :: data_ptr
+      type(c_ptr) :: array
+    end function
+
+    subroutine zforp_cfp_array3f_dtor(array) bind(c, name="zforp_cfp_array3f_dtor")
+      import
+      type(c_ptr), value :: array
+    end subroutine
+
+    function zforp_cfp_array3f_rate(array) result(rate) bind(c, name="zforp_cfp_array3f_rate")
+      import
+      type(c_ptr), value :: array
+      real(c_double) rate
+    end function
+
+    function zforp_cfp_array3f_set_rate(array, rate) result(rate_result) bind(c, name="zforp_cfp_array3f_set_rate")
+      import
+      type(c_ptr), value :: array
+      real(c_double), value :: rate
+      real(c_double) rate_result
+    end function
+
+    function zforp_cfp_array3f_cache_size(array) result(cache_size) bind(c, name="zforp_cfp_array3f_cache_size")
+      import
+      type(c_ptr), value :: array
+      integer(c_size_t) cache_size
+    end function
+
+    subroutine zforp_cfp_array3f_set_cache_size(array, cache_size) bind(c, name="zforp_cfp_array3f_set_cache_size")
+      import
+      type(c_ptr), value :: array
+      integer(c_size_t), value :: cache_size
+    end subroutine
+
+    subroutine zforp_cfp_array3f_clear_cache(array) bind(c, name="zforp_cfp_array3f_clear_cache")
+      import
+      type(c_ptr), value :: array
+    end subroutine
+
+    subroutine zforp_cfp_array3f_flush_cache(array) bind(c, name="zforp_cfp_array3f_flush_cache")
+      import
+      type(c_ptr), value :: array
+    end subroutine
+
+    function zforp_cfp_array3f_compressed_size(array) result(compressed_size) bind(c, name="zforp_cfp_array3f_compressed_size")
+      import
+      type(c_ptr), value :: array
+      integer(c_size_t) compressed_size
+    end function
+
+    function zforp_cfp_array3f_compressed_data(array) result(compressed_data) bind(c, name="zforp_cfp_array3f_compressed_data")
+      import
+      type(c_ptr), value :: array
+      type(c_ptr) compressed_data
+    end function
+
+    function zforp_cfp_array3f_size_x(array) result(nx) bind(c, name="zforp_cfp_array3f_size_x")
+      import
+      type(c_ptr), value :: array
+      integer(c_size_t) nx
+    end function
+
+    function zforp_cfp_array3f_size_y(array) result(ny) bind(c, name="zforp_cfp_array3f_size_y")
+      import
+      type(c_ptr), value :: array
+      integer(c_size_t) ny
+    end function
+
+    function zforp_cfp_array3f_size_z(array) result(nz) bind(c, name="zforp_cfp_array3f_size_z")
+      import
+      type(c_ptr), value :: array
+      integer(c_size_t) nz
+    end function
+
+    subroutine zforp_cfp_array3f_get_array(array, data_ptr) bind(c, name="zforp_cfp_array3f_get_array")
+      import
+      type(c_ptr), value :: array, data_ptr
+    end subroutine
+
+    subroutine zforp_cfp_array3f_set_array(array, data_ptr) bind(c, name="zforp_cfp_array3f_set_array")
+      import
+      type(c_ptr), value :: array, data_ptr
+    end subroutine
+
+    function zforp_cfp_array3f_get(array, i, j, k) result(val) bind(c, name="zforp_cfp_array3f_get")
+      import
+      type(c_ptr), value :: array
+      integer(c_size_t), value :: i, j, k
+      real(c_float) val
+    end function
+
+    subroutine zforp_cfp_array3f_set(array, i, j, k, val) bind(c, name="zforp_cfp_array3f_set")
+      import
+      type(c_ptr), value :: array
+      integer(c_size_t), value :: i, j, k
+      real(c_float), value :: val
+    end subroutine
+
+    ! compressed arrays: private_view3f
+
+    function zforp_cfp_private_view3f_ctor(array, cache_size) result(view) bind(c, name="zforp_cfp_private_view3f_ctor")
+      import
+      type(c_ptr), value :: array
+      integer(c_size_t), value :: cache_size
+      type(c_ptr) :: view
+    end function
+
+    function zforp_cfp_private_view3f_ctor_subset(array, x, y, z, nx, ny, nz, cache_size) result(view) &
+        bind(c, name="zforp_cfp_private_view3f_ctor_subset")
+      import
+      type(c_ptr), value :: array
+      integer(c_size_t), value :: x, y, z, nx, ny, nz, cache_size
+      type(c_ptr) :: view
+    end function
+
+    subroutine zforp_cfp_private_view3f_dtor(view) bind(c, name="zforp_cfp_private_view3f_dtor")
+      import
+      type(c_ptr), value :: view
+    end subroutine
+
+    function zforp_cfp_private_view3f_size_x(view) result(nx) bind(c, name="zforp_cfp_private_view3f_size_x")
+      import
+      type(c_ptr), value :: view
+      integer(c_size_t) nx
+    end function
+
+    function zforp_cfp_private_view3f_size_y(view) result(ny) bind(c, name="zforp_cfp_private_view3f_size_y")
+      import
+      type(c_ptr), value :: view
+      integer(c_size_t) ny
+    end function
+
+    function zforp_cfp_private_view3f_size_z(view) result(nz) bind(c, name="zforp_cfp_private_view3f_size_z")
+      import
+      type(c_ptr), value :: view
+      integer(c_size_t) nz
+    end function
+
+    function zforp_cfp_private_view3f_global_x(view, i) result(x) bind(c, name="zforp_cfp_private_view3f_global_x")
+      import
+      type(c_ptr), value :: view
+      integer(c_size_t), value :: i
+      integer(c_size_t) x
+    end function
+
+    function zforp_cfp_private_view3f_global_y(view, j) result(y) bind(c, name="zforp_cfp_private_view3f_global_y")
+      import
+      type(c_ptr), value :: view
+      integer(c_size_t), value :: j
+      integer(c_size_t) y
+    end function
+
+    function zforp_cfp_private_view3f_global_z(view, k) result(z) bind(c, name="zforp_cfp_private_view3f_global_z")
+      import
+      type(c_ptr), value :: view
+      integer(c_size_t), value :: k
+      integer(c_size_t) z
+    end function
+
+    subroutine zforp_cfp_private_view3f_partition(view, index, count) bind(c, name="zforp_cfp_private_view3f_partition")
+      import
+      type(c_ptr), value :: view
+      integer(c_size_t), value :: index, count
+    end subroutine
+
+    subroutine zforp_cfp_private_view3f_flush_cache(view) bind(c, name="zforp_cfp_private_view3f_flush_cache")
+      import
+      type(c_ptr), value :: view
+    end subroutine
+
+    function zforp_cfp_private_view3f_get(view, i, j, k) result(val) bind(c, name="zforp_cfp_private_view3f_get")
+      import
+      type(c_ptr), value :: view
+      integer(c_size_t), value :: i, j, k
+      real(c_float) val
+    end function
+
+    subroutine zforp_cfp_private_view3f_set(view, i, j, k, val) bind(c, name="zforp_cfp_private_view3f_set")
+      import
+      type(c_ptr), value :: view
+      integer(c_size_t), value :: i, j, k
+      real(c_float), value :: val
+    end subroutine
+
+    ! compressed arrays: array3d
+
+    function zforp_cfp_array3d_ctor(nx, ny, nz, rate, data_ptr, cache_size) result(array) bind(c, name="zforp_cfp_array3d_ctor")
+      import
+      integer(c_size_t), value :: nx, ny, nz, cache_size
+      real(c_double), value :: rate
+      type(c_ptr), value :: data_ptr
+      type(c_ptr) :: array
+    end function
+
+    subroutine zforp_cfp_array3d_dtor(array) bind(c, name="zforp_cfp_array3d_dtor")
+      import
+      type(c_ptr), value :: array
+    end subroutine
+
+    function zforp_cfp_array3d_rate(array) result(rate) bind(c, name="zforp_cfp_array3d_rate")
+      import
+      type(c_ptr), value :: array
+      real(c_double) rate
+    end function
+
+    function zforp_cfp_array3d_set_rate(array, rate) result(rate_result) bind(c, name="zforp_cfp_array3d_set_rate")
+      import
+      type(c_ptr), value :: array
+      real(c_double), value :: rate
+      real(c_double) rate_result
+    end function
+
+    function zforp_cfp_array3d_cache_size(array) result(cache_size) bind(c, name="zforp_cfp_array3d_cache_size")
+      import
+      type(c_ptr), value :: array
+      integer(c_size_t) cache_size
+    end function
+
+    subroutine zforp_cfp_array3d_set_cache_size(array, cache_size) bind(c, name="zforp_cfp_array3d_set_cache_size")
+      import
+      type(c_ptr), value :: array
+      integer(c_size_t), value :: cache_size
+    end subroutine
+
+    subroutine zforp_cfp_array3d_clear_cache(array) bind(c, name="zforp_cfp_array3d_clear_cache")
+      import
+      type(c_ptr), value :: array
+    end subroutine
+
+    subroutine zforp_cfp_array3d_flush_cache(array) bind(c, name="zforp_cfp_array3d_flush_cache")
+      import
+      type(c_ptr), value :: array
+    end subroutine
+
+    function zforp_cfp_array3d_compressed_size(array) result(compressed_size) bind(c, name="zforp_cfp_array3d_compressed_size")
+      import
+      type(c_ptr), value :: array
+      integer(c_size_t) compressed_size
+    end function
+
+    function zforp_cfp_array3d_compressed_data(array) result(compressed_data) bind(c, name="zforp_cfp_array3d_compressed_data")
+      import
+      type(c_ptr), value :: array
+      type(c_ptr) compressed_data
+    end function
+
+    function zforp_cfp_array3d_size_x(array) result(nx) bind(c, name="zforp_cfp_array3d_size_x")
+      import
+      type(c_ptr), value :: array
+      integer(c_size_t) nx
+    end function
+
+    function zforp_cfp_array3d_size_y(array) result(ny) bind(c, name="zforp_cfp_array3d_size_y")
+      import
+      type(c_ptr), value :: array
+      integer(c_size_t) ny
+    end function
+
+    function zforp_cfp_array3d_size_z(array) result(nz) bind(c, name="zforp_cfp_array3d_size_z")
+      import
+      type(c_ptr), value :: array
+      integer(c_size_t) nz
+    end function
+
+    subroutine zforp_cfp_array3d_get_array(array, data_ptr) bind(c, name="zforp_cfp_array3d_get_array")
+      import
+      type(c_ptr), value :: array, data_ptr
+    end subroutine
+
+    subroutine zforp_cfp_array3d_set_array(array, data_ptr) bind(c, name="zforp_cfp_array3d_set_array")
+      import
+      type(c_ptr), value :: array, data_ptr
+    end subroutine
+
+    function zforp_cfp_array3d_get(array, i, j, k) result(val) bind(c, name="zforp_cfp_array3d_get")
+      import
+      type(c_ptr), value :: array
+      integer(c_size_t), value :: i, j, k
+      real(c_double) val
+    end function
+
+    subroutine zforp_cfp_array3d_set(array, i, j, k, val) bind(c, name="zforp_cfp_array3d_set")
+      import
+      type(c_ptr), value :: array
+      integer(c_size_t), value :: i, j, k
+      real(c_double), value :: val
+    end subroutine
+
+    ! compressed arrays: private_view3d
+
+    function zforp_cfp_private_view3d_ctor(array, cache_size) result(view) bind(c, name="zforp_cfp_private_view3d_ctor")
+      import
+      type(c_ptr), value :: array
+      integer(c_size_t), value :: cache_size
+      type(c_ptr) :: view
+    end function
+
+    function zforp_cfp_private_view3d_ctor_subset(array, x, y, z, nx, ny, nz, cache_size) result(view) &
+        bind(c, name="zforp_cfp_private_view3d_ctor_subset")
+      import
+      type(c_ptr), value :: array
+      integer(c_size_t), value :: x, y, z, nx, ny, nz, cache_size
+      type(c_ptr) :: view
+    end function
+
+    subroutine zforp_cfp_private_view3d_dtor(view) bind(c, name="zforp_cfp_private_view3d_dtor")
+      import
+      type(c_ptr), value :: view
+    end subroutine
+
+    function zforp_cfp_private_view3d_size_x(view) result(nx) bind(c, name="zforp_cfp_private_view3d_size_x")
+      import
+      type(c_ptr), value :: view
+      integer(c_size_t) nx
+    end function
+
+    function zforp_cfp_private_view3d_size_y(view) result(ny) bind(c, name="zforp_cfp_private_view3d_size_y")
+      import
+      type(c_ptr), value :: view
+      integer(c_size_t) ny
+    end function
+
+    function zforp_cfp_private_view3d_size_z(view) result(nz) bind(c, name="zforp_cfp_private_view3d_size_z")
+      import
+      type(c_ptr), value :: view
+      integer(c_size_t) nz
+    end function
+
+    function zforp_cfp_private_view3d_global_x(view, i) result(x) bind(c, name="zforp_cfp_private_view3d_global_x")
+      import
+      type(c_ptr), value :: view
+      integer(c_size_t), value :: i
+      integer(c_size_t) x
+    end function
+
+    function zforp_cfp_private_view3d_global_y(view, j) result(y) bind(c, name="zforp_cfp_private_view3d_global_y")
+      import
+      type(c_ptr), value :: view
+      integer(c_size_t), value :: j
+      integer(c_size_t) y
+    end function
+
+    function zforp_cfp_private_view3d_global_z(view, k) result(z) bind(c, name="zforp_cfp_private_view3d_global_z")
+      import
+      type(c_ptr), value :: view
+      integer(c_size_t), value :: k
+      integer(c_size_t) z
+    end function
+
+    subroutine zforp_cfp_private_view3d_partition(view, index, count) bind(c, name="zforp_cfp_private_view3d_partition")
+      import
+      type(c_ptr), value :: view
+      integer(c_size_t), value :: index, count
+    end subroutine
+
+    subroutine zforp_cfp_private_view3d_flush_cache(view) bind(c, name="zforp_cfp_private_view3d_flush_cache")
+      import
+      type(c_ptr), value :: view
+    end subroutine
+
+    function zforp_cfp_private_view3d_get(view, i, j, k) result(val) bind(c, name="zforp_cfp_private_view3d_get")
+      import
+      type(c_ptr), value :: view
+      integer(c_size_t), value :: i, j, k
+      real(c_double) val
+    end function
+
+    subroutine zforp_cfp_private_view3d_set(view, i, j, k, val) bind(c, name="zforp_cfp_private_view3d_set")
+      import
+      type(c_ptr), value :: view
+      integer(c_size_t), value :: i, j, k
+      real(c_double), value :: val
+    end subroutine
+
   end interface
 
   ! types
@@ -481,7 +942,11 @@ module zFORp
 
   public :: zFORp_exec_serial, &
             zFORp_exec_omp, &
-            zFORp_exec_cuda
+            zFORp_exec_cuda, &
+            zFORp_exec_hip, &
+            zFORp_exec_threads, &
+            zFORp_exec_omp_target, &
+            zFORp_exec_sycl
 
   ! C macros -> constants
   public :: zFORp_version_major, &
@@ -542,7 +1007,15 @@ module zFORp
             zFORp_stream_omp_chunk_size, &
             zFORp_stream_set_execution, &
             zFORp_stream_set_omp_threads, &
-            zFORp_stream_set_omp_chunk_size
+            zFORp_stream_set_omp_chunk_size, &
+            zFORp_stream_thread_count, &
+            zFORp_stream_thread_chunk_size, &
+            zFORp_stream_set_thread_count, &
+            zFORp_stream_set_thread_chunk_size, &
+            zFORp_stream_set_cuda_stream, &
+            zFORp_stream_set_hip_stream, &
+            zFORp_stream_set_omp_target_device, &
+            zFORp_stream_set_sycl_queue
 
   ! high-level API: zfp_field functions
 
@@ -582,6 +1055,74 @@ module zFORp
 
   public :: zFORp_stream_rewind
 
+  ! compressed arrays backed by cfp
+
+  public :: zFORp_array3f, &
+            zFORp_array3f_ctor, &
+            zFORp_array3f_dtor, &
+            zFORp_array3f_rate, &
+            zFORp_array3f_set_rate, &
+            zFORp_array3f_cache_size, &
+            zFORp_array3f_set_cache_size, &
+            zFORp_array3f_clear_cache, &
+            zFORp_array3f_flush_cache, &
+            zFORp_array3f_compressed_size, &
+            zFORp_array3f_compressed_data, &
+            zFORp_array3f_size_x, &
+            zFORp_array3f_size_y, &
+            zFORp_array3f_size_z, &
+            zFORp_array3f_get_array, &
+            zFORp_array3f_set_array, &
+            zFORp_array3f_get, &
+            zFORp_array3f_set, &
+            zFORp_private_view3f, &
+            zFORp_private_view3f_ctor, &
+            zFORp_private_view3f_ctor_subset, &
+            zFORp_private_view3f_dtor, &
+            zFORp_private_view3f_size_x, &
+            zFORp_private_view3f_size_y, &
+            zFORp_private_view3f_size_z, &
+            zFORp_private_view3f_global_x, &
+            zFORp_private_view3f_global_y, &
+            zFORp_private_view3f_global_z, &
+            zFORp_private_view3f_partition, &
+            zFORp_private_view3f_flush_cache, &
+            zFORp_private_view3f_get, &
+            zFORp_private_view3f_set
+
+  public :: zFORp_array3d, &
+            zFORp_array3d_ctor, &
+            zFORp_array3d_dtor, &
+            zFORp_array3d_rate, &
+            zFORp_array3d_set_rate, &
+            zFORp_array3d_cache_size, &
+            zFORp_array3d_set_cache_size, &
+            zFORp_array3d_clear_cache, &
+            zFORp_array3d_flush_cache, &
+            zFORp_array3d_compressed_size, &
+            zFORp_array3d_compressed_data, &
+            zFORp_array3d_size_x, &
+            zFORp_array3d_size_y, &
+            zFORp_array3d_size_z, &
+            zFORp_array3d_get_array, &
+            zFORp_array3d_set_array, &
+            zFORp_array3d_get, &
+            zFORp_array3d_set, &
+            zFORp_private_view3d, &
+            zFORp_private_view3d_ctor, &
+            zFORp_private_view3d_ctor_subset, &
+            zFORp_private_view3d_dtor, &
+            zFORp_private_view3d_size_x, &
+            zFORp_private_view3d_size_y, &
+            zFORp_private_view3d_size_z, &
+            zFORp_private_view3d_global_x, &
+            zFORp_private_view3d_global_y, &
+            zFORp_private_view3d_global_z, &
+            zFORp_private_view3d_partition, &
+            zFORp_private_view3d_flush_cache, &
+            zFORp_private_view3d_get, &
+            zFORp_private_view3d_set
+
 contains
 
   ! minimal bitstream API
@@ -777,6 +1318,70 @@ contains
     is_success = zfp_stream_set_omp_chunk_size(stream%object, int(chunk_size, c_int))
   end function zFORp_stream_set_omp_chunk_size
 
+  function zFORp_stream_thread_count(stream) result(thread_count) bind(c, name="zforp_stream_thread_count")
+    implicit none
+    type(zFORp_stream), intent(in) :: stream
+    integer thread_count
+    thread_count = zfp_stream_thread_count(stream%object)
+  end function zFORp_stream_thread_count
+
+  function zFORp_stream_thread_chunk_size(stream) result(chunk_size_blocks) bind(c, name="zforp_stream_thread_chunk_size")
+    implicit none
+    type(zFORp_stream), intent(in) :: stream
+    integer (kind=8) chunk_size_blocks
+    chunk_size_blocks = zfp_stream_thread_chunk_size(stream%object)
+  end function zFORp_stream_thread_chunk_size
+
+  function zFORp_stream_set_thread_count(stream, thread_count) result(is_success) bind(c, name="zforp_stream_set_thread_count")
+    implicit none
+    type(zFORp_stream), intent(in) :: stream
+    integer, intent(in) :: thread_count
+    integer is_success
+    is_success = zfp_stream_set_thread_count(stream%object, int(thread_count, c_int))
+  end function zFORp_stream_set_thread_count
+
+  function zFORp_stream_set_thread_chunk_size(stream, chunk_size) result(is_success) &
+      bind(c, name="zforp_stream_set_thread_chunk_size")
+    implicit none
+    type(zFORp_stream), intent(in) :: stream
+    integer, intent(in) :: chunk_size
+    integer is_success
+    is_success = zfp_stream_set_thread_chunk_size(stream%object, int(chunk_size, c_int))
+  end function zFORp_stream_set_thread_chunk_size
+
+  function zFORp_stream_set_cuda_stream(stream, cuda_stream) result(is_success) bind(c, name="zforp_stream_set_cuda_stream")
+    implicit none
+    type(zFORp_stream), intent(in) :: stream
+    type(c_ptr), intent(in) :: cuda_stream
+    integer is_success
+    is_success = zfp_stream_set_cuda_stream(stream%object, cuda_stream)
+  end function zFORp_stream_set_cuda_stream
+
+  function zFORp_stream_set_hip_stream(stream, hip_stream) result(is_success) bind(c, name="zforp_stream_set_hip_stream")
+    implicit none
+    type(zFORp_stream), intent(in) :: stream
+    type(c_ptr), intent(in) :: hip_stream
+    integer is_success
+    is_success = zfp_stream_set_hip_stream(stream%object, hip_stream)
+  end function zFORp_stream_set_hip_stream
+
+  function zFORp_stream_set_omp_target_device(stream, device) result(is_success) &
+      bind(c, name="zforp_stream_set_omp_target_device")
+    implicit none
+    type(zFORp_stream), intent(in) :: stream
+    integer, intent(in) :: device
+    integer is_success
+    is_success = zfp_stream_set_omp_target_device(stream%object, int(device, c_int))
+  end function zFORp_stream_set_omp_target_device
+
+  function zFORp_stream_set_sycl_queue(stream, queue) result(is_success) bind(c, name="zforp_stream_set_sycl_queue")
+    implicit none
+    type(zFORp_stream), intent(in) :: stream
+    type(c_ptr), intent(in) :: queue
+    integer is_success
+    is_success = zfp_stream_set_sycl_queue(stream%object, queue)
+  end function zFORp_stream_set_sycl_queue
+
   ! high-level API: zfp_field functions
 
   function zFORp_field_alloc() result(field) bind(c, name="zforp_field_alloc")
@@ -993,4 +1598,462 @@ contains
     call zfp_stream_rewind(stream%object)
   end subroutine zFORp_stream_rewind
 
+  ! compressed arrays: array3f
+
+  function zFORp_array3f_ctor(nx, ny, nz, rate, data_ptr, cache_size) result(array) bind(c, name="zforp_array3f_ctor")
+    implicit none
+    integer, intent(in) :: nx, ny, nz
+    real (kind=8), intent(in) :: rate
+    type(c_ptr), intent(in) :: data_ptr
+    integer (kind=8), intent(in) :: cache_size
+    type(zFORp_array3f) array
+    array%object = zforp_cfp_array3f_ctor(int(nx, c_size_t), int(ny, c_size_t), int(nz, c_size_t), &
+                                    real(rate, c_double), data_ptr, int(cache_size, c_size_t))
+  end function zFORp_array3f_ctor
+
+  subroutine zFORp_array3f_dtor(array) bind(c, name="zforp_array3f_dtor")
+    implicit none
+    type(zFORp_array3f), intent(inout) :: array
+    call zforp_cfp_array3f_dtor(array%object)
+    array%object = c_null_ptr
+  end subroutine zFORp_array3f_dtor
+
+  function zFORp_array3f_rate(array) result(rate) bind(c, name="zforp_array3f_rate")
+    implicit none
+    type(zFORp_array3f), intent(in) :: array
+    real (kind=8) rate
+    rate = zforp_cfp_array3f_rate(array%object)
+  end function zFORp_array3f_rate
+
+  function zFORp_array3f_set_rate(array, rate) result(rate_result) bind(c, name="zforp_array3f_set_rate")
+    implicit none
+    type(zFORp_array3f), intent(in) :: array
+    real (kind=8), intent(in) :: rate
+    real (kind=8) rate_result
+    rate_result = zforp_cfp_array3f_set_rate(array%object, real(rate, c_double))
+  end function zFORp_array3f_set_rate
+
+  function zFORp_array3f_cache_size(array) result(cache_size) bind(c, name="zforp_array3f_cache_size")
+    implicit none
+    type(zFORp_array3f), intent(in) :: array
+    integer (kind=8) cache_size
+    cache_size = zforp_cfp_array3f_cache_size(array%object)
+  end function zFORp_array3f_cache_size
+
+  subroutine zFORp_array3f_set_cache_size(array, cache_size) bind(c, name="zforp_array3f_set_cache_size")
+    implicit none
+    type(zFORp_array3f), intent(in) :: array
+    integer (kind=8), intent(in) :: cache_size
+    call zforp_cfp_array3f_set_cache_size(array%object, int(cache_size, c_size_t))
+  end subroutine zFORp_array3f_set_cache_size
+
+  subroutine zFORp_array3f_clear_cache(array) bind(c, name="zforp_array3f_clear_cache")
+    implicit none
+    type(zFORp_array3f), intent(in) :: array
+    call zforp_cfp_array3f_clear_cache(array%object)
+  end subroutine zFORp_array3f_clear_cache
+
+  subroutine zFORp_array3f_flush_cache(array) bind(c, name="zforp_array3f_flush_cache")
+    implicit none
+    type(zFORp_array3f), intent(in) :: array
+    call zforp_cfp_array3f_flush_cache(array%object)
+  end subroutine zFORp_array3f_flush_cache
+
+  function zFORp_array3f_compressed_size(array) result(compressed_size) bind(c, name="zforp_array3f_compressed_size")
+    implicit none
+    type(zFORp_array3f), intent(in) :: array
+    integer (kind=8) compressed_size
+    compressed_size = zforp_cfp_array3f_compressed_size(array%object)
+  end function zFORp_array3f_compressed_size
+
+  function zFORp_array3f_compressed_data(array) result(compressed_data) bind(c, name="zforp_array3f_compressed_data")
+    implicit none
+    type(zFORp_array3f), intent(in) :: array
+    type(c_ptr) compressed_data
+    compressed_data = zforp_cfp_array3f_compressed_data(array%object)
+  end function zFORp_array3f_compressed_data
+
+  function zFORp_array3f_size_x(array) result(nx) bind(c, name="zforp_array3f_size_x")
+    implicit none
+    type(zFORp_array3f), intent(in) :: array
+    integer nx
+    nx = int(zforp_cfp_array3f_size_x(array%object))
+  end function zFORp_array3f_size_x
+
+  function zFORp_array3f_size_y(array) result(ny) bind(c, name="zforp_array3f_size_y")
+    implicit none
+    type(zFORp_array3f), intent(in) :: array
+    integer ny
+    ny = int(zforp_cfp_array3f_size_y(array%object))
+  end function zFORp_array3f_size_y
+
+  function zFORp_array3f_size_z(array) result(nz) bind(c, name="zforp_array3f_size_z")
+    implicit none
+    type(zFORp_array3f), intent(in) :: array
+    integer nz
+    nz = int(zforp_cfp_array3f_size_z(array%object))
+  end function zFORp_array3f_size_z
+
+  subroutine zFORp_array3f_get_array(array, data_ptr) bind(c, name="zforp_array3f_get_array")
+    implicit none
+    type(zFORp_array3f), intent(in) :: array
+    type(c_ptr), intent(in) :: data_ptr
+    call zforp_cfp_array3f_get_array(array%object, data_ptr)
+  end subroutine zFORp_array3f_get_array
+
+  subroutine zFORp_array3f_set_array(array, data_ptr) bind(c, name="zforp_array3f_set_array")
+    implicit none
+    type(zFORp_array3f), intent(in) :: array
+    type(c_ptr), intent(in) :: data_ptr
+    call zforp_cfp_array3f_set_array(array%object, data_ptr)
+  end subroutine zFORp_array3f_set_array
+
+  function zFORp_array3f_get(array, i, j, k) result(val) bind(c, name="zforp_array3f_get")
+    implicit none
+    type(zFORp_array3f), intent(in) :: array
+    integer, intent(in) :: i, j, k
+    real (kind=4) val
+    val = zforp_cfp_array3f_get(array%object, int(i, c_size_t), int(j, c_size_t), int(k, c_size_t))
+  end function zFORp_array3f_get
+
+  subroutine zFORp_array3f_set(array, i, j, k, val) bind(c, name="zforp_array3f_set")
+    implicit none
+    type(zFORp_array3f), intent(in) :: array
+    integer, intent(in) :: i, j, k
+    real (kind=4), intent(in) :: val
+    call zforp_cfp_array3f_set(array%object, int(i, c_size_t), int(j, c_size_t), int(k, c_size_t), real(val, c_float))
+  end subroutine zFORp_array3f_set
+
+  ! compressed arrays: private_view3f
+
+  function zFORp_private_view3f_ctor(array, cache_size) result(view) bind(c, name="zforp_private_view3f_ctor")
+    implicit none
+    type(zFORp_array3f), intent(in) :: array
+    integer (kind=8), intent(in) :: cache_size
+    type(zFORp_private_view3f) view
+    view%object = zforp_cfp_private_view3f_ctor(array%object, int(cache_size, c_size_t))
+  end function zFORp_private_view3f_ctor
+
+  function zFORp_private_view3f_ctor_subset(array, x, y, z, nx, ny, nz, cache_size) result(view) &
+      bind(c, name="zforp_private_view3f_ctor_subset")
+    implicit none
+    type(zFORp_array3f), intent(in) :: array
+    integer, intent(in) :: x, y, z, nx, ny, nz
+    integer (kind=8), intent(in) :: cache_size
+    type(zFORp_private_view3f) view
+    view%object = zforp_cfp_private_view3f_ctor_subset(array%object, int(x, c_size_t), int(y, c_size_t), int(z, c_size_t), &
+                                                   int(nx, c_size_t), int(ny, c_size_t), int(nz, c_size_t), &
+                                                   int(cache_size, c_size_t))
+  end function zFORp_private_view3f_ctor_subset
+
+  subroutine zFORp_private_view3f_dtor(view) bind(c, name="zforp_private_view3f_dtor")
+    implicit none
+    type(zFORp_private_view3f), intent(inout) :: view
+    call zforp_cfp_private_view3f_dtor(view%object)
+    view%object = c_null_ptr
+  end subroutine zFORp_private_view3f_dtor
+
+  function zFORp_private_view3f_size_x(view) result(nx) bind(c, name="zforp_private_view3f_size_x")
+    implicit none
+    type(zFORp_private_view3f), intent(in) :: view
+    integer nx
+    nx = int(zforp_cfp_private_view3f_size_x(view%object))
+  end function zFORp_private_view3f_size_x
+
+  function zFORp_private_view3f_size_y(view) result(ny) bind(c, name="zforp_private_view3f_size_y")
+    implicit none
+    type(zFORp_private_view3f), intent(in) :: view
+    integer ny
+    ny = int(zforp_cfp_private_view3f_size_y(view%object))
+  end function zFORp_private_view3f_size_y
+
+  function zFORp_private_view3f_size_z(view) result(nz) bind(c, name="zforp_private_view3f_size_z")
+    implicit none
+    type(zFORp_private_view3f), intent(in) :: view
+    integer nz
+    nz = int(zforp_cfp_private_view3f_size_z(view%object))
+  end function zFORp_private_view3f_size_z
+
+  function zFORp_private_view3f_global_x(view, i) result(x) bind(c, name="zforp_private_view3f_global_x")
+    implicit none
+    type(zFORp_private_view3f), intent(in) :: view
+    integer, intent(in) :: i
+    integer x
+    x = int(zforp_cfp_private_view3f_global_x(view%object, int(i, c_size_t)))
+  end function zFORp_private_view3f_global_x
+
+  function zFORp_private_view3f_global_y(view, j) result(y) bind(c, name="zforp_private_view3f_global_y")
+    implicit none
+    type(zFORp_private_view3f), intent(in) :: view
+    integer, intent(in) :: j
+    integer y
+    y = int(zforp_cfp_private_view3f_global_y(view%object, int(j, c_size_t)))
+  end function zFORp_private_view3f_global_y
+
+  function zFORp_private_view3f_global_z(view, k) result(z) bind(c, name="zforp_private_view3f_global_z")
+    implicit none
+    type(zFORp_private_view3f), intent(in) :: view
+    integer, intent(in) :: k
+    integer z
+    z = int(zforp_cfp_private_view3f_global_z(view%object, int(k, c_size_t)))
+  end function zFORp_private_view3f_global_z
+
+  subroutine zFORp_private_view3f_partition(view, index, count) bind(c, name="zforp_private_view3f_partition")
+    implicit none
+    type(zFORp_private_view3f), intent(in) :: view
+    integer, intent(in) :: index, count
+    call zforp_cfp_private_view3f_partition(view%object, int(index, c_size_t), int(count, c_size_t))
+  end subroutine zFORp_private_view3f_partition
+
+  subroutine zFORp_private_view3f_flush_cache(view) bind(c, name="zforp_private_view3f_flush_cache")
+    implicit none
+    type(zFORp_private_view3f), intent(in) :: view
+    call zforp_cfp_private_view3f_flush_cache(view%object)
+  end subroutine zFORp_private_view3f_flush_cache
+
+  function zFORp_private_view3f_get(view, i, j, k) result(val) bind(c, name="zforp_private_view3f_get")
+    implicit none
+    type(zFORp_private_view3f), intent(in) :: view
+    integer, intent(in) :: i, j, k
+    real (kind=4) val
+    val = zforp_cfp_private_view3f_get(view%object, int(i, c_size_t), int(j, c_size_t), int(k, c_size_t))
+  end function zFORp_private_view3f_get
+
+  subroutine zFORp_private_view3f_set(view, i, j, k, val) bind(c, name="zforp_private_view3f_set")
+    implicit none
+    type(zFORp_private_view3f), intent(in) :: view
+    integer, intent(in) :: i, j, k
+    real (kind=4), intent(in) :: val
+    call zforp_cfp_private_view3f_set(view%object, int(i, c_size_t), int(j, c_size_t), int(k, c_size_t), real(val, c_float))
+  end subroutine zFORp_private_view3f_set
+
+  ! compressed arrays: array3d
+
+  function zFORp_array3d_ctor(nx, ny, nz, rate, data_ptr, cache_size) result(array) bind(c, name="zforp_array3d_ctor")
+    implicit none
+    integer, intent(in) :: nx, ny, nz
+    real (kind=8), intent(in) :: rate
+    type(c_ptr), intent(in) :: data_ptr
+    integer (kind=8), intent(in) :: cache_size
+    type(zFORp_array3d) array
+    array%object = zforp_cfp_array3d_ctor(int(nx, c_size_t), int(ny, c_size_t), int(nz, c_size_t), &
+                                    real(rate, c_double), data_ptr, int(cache_size, c_size_t))
+  end function zFORp_array3d_ctor
+
+  subroutine zFORp_array3d_dtor(array) bind(c, name="zforp_array3d_dtor")
+    implicit none
+    type(zFORp_array3d), intent(inout) :: array
+    call zforp_cfp_array3d_dtor(array%object)
+    array%object = c_null_ptr
+  end subroutine zFORp_array3d_dtor
+
+  function zFORp_array3d_rate(array) result(rate) bind(c, name="zforp_array3d_rate")
+    implicit none
+    type(zFORp_array3d), intent(in) :: array
+    real (kind=8) rate
+    rate = zforp_cfp_array3d_rate(array%object)
+  end function zFORp_array3d_rate
+
+  function zFORp_array3d_set_rate(array, rate) result(rate_result) bind(c, name="zforp_array3d_set_rate")
+    implicit none
+    type(zFORp_array3d), intent(in) :: array
+    real (kind=8), intent(in) :: rate
+    real (kind=8) rate_result
+    rate_result = zforp_cfp_array3d_set_rate(array%object, real(rate, c_double))
+  end function zFORp_array3d_set_rate
+
+  function zFORp_array3d_cache_size(array) result(cache_size) bind(c, name="zforp_array3d_cache_size")
+    implicit none
+    type(zFORp_array3d), intent(in) :: array
+    integer (kind=8) cache_size
+    cache_size = zforp_cfp_array3d_cache_size(array%object)
+  end function zFORp_array3d_cache_size
+
+  subroutine zFORp_array3d_set_cache_size(array, cache_size) bind(c, name="zforp_array3d_set_cache_size")
+    implicit none
+    type(zFORp_array3d), intent(in) :: array
+    integer (kind=8), intent(in) :: cache_size
+    call zforp_cfp_array3d_set_cache_size(array%object, int(cache_size, c_size_t))
+  end subroutine zFORp_array3d_set_cache_size
+
+  subroutine zFORp_array3d_clear_cache(array) bind(c, name="zforp_array3d_clear_cache")
+    implicit none
+    type(zFORp_array3d), intent(in) :: array
+    call zforp_cfp_array3d_clear_cache(array%object)
+  end subroutine zFORp_array3d_clear_cache
+
+  subroutine zFORp_array3d_flush_cache(array) bind(c, name="zforp_array3d_flush_cache")
+    implicit none
+    type(zFORp_array3d), intent(in) :: array
+    call zforp_cfp_array3d_flush_cache(array%object)
+  end subroutine zFORp_array3d_flush_cache
+
+  function zFORp_array3d_compressed_size(array) result(compressed_size) bind(c, name="zforp_array3d_compressed_size")
+    implicit none
+    type(zFORp_array3d), intent(in) :: array
+    integer (kind=8) compressed_size
+    compressed_size = zforp_cfp_array3d_compressed_size(array%object)
+  end function zFORp_array3d_compressed_size
+
+  function zFORp_array3d_compressed_data(array) result(compressed_data) bind(c, name="zforp_array3d_compressed_data")
+    implicit none
+    type(zFORp_array3d), intent(in) :: array
+    type(c_ptr) compressed_data
+    compressed_data = zforp_cfp_array3d_compressed_data(array%object)
+  end function zFORp_array3d_compressed_data
+
+  function zFORp_array3d_size_x(array) result(nx) bind(c, name="zforp_array3d_size_x")
+    implicit none
+    type(zFORp_array3d), intent(in) :: array
+    integer nx
+    nx = int(zforp_cfp_array3d_size_x(array%object))
+  end function zFORp_array3d_size_x
+
+  function zFORp_array3d_size_y(array) result(ny) bind(c, name="zforp_array3d_size_y")
+    implicit none
+    type(zFORp_array3d), intent(in) :: array
+    integer ny
+    ny = int(zforp_cfp_array3d_size_y(array%object))
+  end function zFORp_array3d_size_y
+
+  function zFORp_array3d_size_z(array) result(nz) bind(c, name="zforp_array3d_size_z")
+    implicit none
+    type(zFORp_array3d), intent(in) :: array
+    integer nz
+    nz = int(zforp_cfp_array3d_size_z(array%object))
+  end function zFORp_array3d_size_z
+
+  subroutine zFORp_array3d_get_array(array, data_ptr) bind(c, name="zforp_array3d_get_array")
+    implicit none
+    type(zFORp_array3d), intent(in) :: array
+    type(c_ptr), intent(in) :: data_ptr
+    call zforp_cfp_array3d_get_array(array%object, data_ptr)
+  end subroutine zFORp_array3d_get_array
+
+  subroutine zFORp_array3d_set_array(array, data_ptr) bind(c, name="zforp_array3d_set_array")
+    implicit none
+    type(zFORp_array3d), intent(in) :: array
+    type(c_ptr), intent(in) :: data_ptr
+    call zforp_cfp_array3d_set_array(array%object, data_ptr)
+  end subroutine zFORp_array3d_set_array
+
+  function zFORp_array3d_get(array, i, j, k) result(val) bind(c, name="zforp_array3d_get")
+    implicit none
+    type(zFORp_array3d), intent(in) :: array
+    integer, intent(in) :: i, j, k
+    real (kind=8) val
+    val = zforp_cfp_array3d_get(array%object, int(i, c_size_t), int(j, c_size_t), int(k, c_size_t))
+  end function zFORp_array3d_get
+
+  subroutine zFORp_array3d_set(array, i, j, k, val) bind(c, name="zforp_array3d_set")
+    implicit none
+    type(zFORp_array3d), intent(in) :: array
+    integer, intent(in) :: i, j, k
+    real (kind=8), intent(in) :: val
+    call zforp_cfp_array3d_set(array%object, int(i, c_size_t), int(j, c_size_t), int(k, c_size_t), real(val, c_double))
+  end subroutine zFORp_array3d_set
+
+  ! compressed arrays: private_view3d
+
+  function zFORp_private_view3d_ctor(array, cache_size) result(view) bind(c, name="zforp_private_view3d_ctor")
+    implicit none
+    type(zFORp_array3d), intent(in) :: array
+    integer (kind=8), intent(in) :: cache_size
+    type(zFORp_private_view3d) view
+    view%object = zforp_cfp_private_view3d_ctor(array%object, int(cache_size, c_size_t))
+  end function zFORp_private_view3d_ctor
+
+  function zFORp_private_view3d_ctor_subset(array, x, y, z, nx, ny, nz, cache_size) result(view) &
+      bind(c, name="zforp_private_view3d_ctor_subset")
+    implicit none
+    type(zFORp_array3d), intent(in) :: array
+    integer, intent(in) :: x, y, z, nx, ny, nz
+    integer (kind=8), intent(in) :: cache_size
+    type(zFORp_private_view3d) view
+    view%object = zforp_cfp_private_view3d_ctor_subset(array%object, int(x, c_size_t), int(y, c_size_t), int(z, c_size_t), &
+                                                   int(nx, c_size_t), int(ny, c_size_t), int(nz, c_size_t), &
+                                                   int(cache_size, c_size_t))
+  end function zFORp_private_view3d_ctor_subset
+
+  subroutine zFORp_private_view3d_dtor(view) bind(c, name="zforp_private_view3d_dtor")
+    implicit none
+    type(zFORp_private_view3d), intent(inout) :: view
+    call zforp_cfp_private_view3d_dtor(view%object)
+    view%object = c_null_ptr
+  end subroutine zFORp_private_view3d_dtor
+
+  function zFORp_private_view3d_size_x(view) result(nx) bind(c, name="zforp_private_view3d_size_x")
+    implicit none
+    type(zFORp_private_view3d), intent(in) :: view
+    integer nx
+    nx = int(zforp_cfp_private_view3d_size_x(view%object))
+  end function zFORp_private_view3d_size_x
+
+  function zFORp_private_view3d_size_y(view) result(ny) bind(c, name="zforp_private_view3d_size_y")
+    implicit none
+    type(zFORp_private_view3d), intent(in) :: view
+    integer ny
+    ny = int(zforp_cfp_private_view3d_size_y(view%object))
+  end function zFORp_private_view3d_size_y
+
+  function zFORp_private_view3d_size_z(view) result(nz) bind(c, name="zforp_private_view3d_size_z")
+    implicit none
+    type(zFORp_private_view3d), intent(in) :: view
+    integer nz
+    nz = int(zforp_cfp_private_view3d_size_z(view%object))
+  end function zFORp_private_view3d_size_z
+
+  function zFORp_private_view3d_global_x(view, i) result(x) bind(c, name="zforp_private_view3d_global_x")
+    implicit none
+    type(zFORp_private_view3d), intent(in) :: view
+    integer, intent(in) :: i
+    integer x
+    x = int(zforp_cfp_private_view3d_global_x(view%object, int(i, c_size_t)))
+  end function zFORp_private_view3d_global_x
+
+  function zFORp_private_view3d_global_y(view, j) result(y) bind(c, name="zforp_private_view3d_global_y")
+    implicit none
+    type(zFORp_private_view3d), intent(in) :: view
+    integer, intent(in) :: j
+    integer y
+    y = int(zforp_cfp_private_view3d_global_y(view%object, int(j, c_size_t)))
+  end function zFORp_private_view3d_global_y
+
+  function zFORp_private_view3d_global_z(view, k) result(z) bind(c, name="zforp_private_view3d_global_z")
+    implicit none
+    type(zFORp_private_view3d), intent(in) :: view
+    integer, intent(in) :: k
+    integer z
+    z = int(zforp_cfp_private_view3d_global_z(view%object, int(k, c_size_t)))
+  end function zFORp_private_view3d_global_z
+
+  subroutine zFORp_private_view3d_partition(view, index, count) bind(c, name="zforp_private_view3d_partition")
+    implicit none
+    type(zFORp_private_view3d), intent(in) :: view
+    integer, intent(in) :: index, count
+    call zforp_cfp_private_view3d_partition(view%object, int(index, c_size_t), int(count, c_size_t))
+  end subroutine zFORp_private_view3d_partition
+
+  subroutine zFORp_private_view3d_flush_cache(view) bind(c, name="zforp_private_view3d_flush_cache")
+    implicit none
+    type(zFORp_private_view3d), intent(in) :: view
+    call zforp_cfp_private_view3d_flush_cache(view%object)
+  end subroutine zFORp_private_view3d_flush_cache
+
+  function zFORp_private_view3d_get(view, i, j, k) result(val) bind(c, name="zforp_private_view3d_get")
+    implicit none
+    type(zFORp_private_view3d), intent(in) :: view
+    integer, intent(in) :: i, j, k
+    real (kind=8) val
+    val = zforp_cfp_private_view3d_get(view%object, int(i, c_size_t), int(j, c_size_t), int(k, c_size_t))
+  end function zFORp_private_view3d_get
+
+  subroutine zFORp_private_view3d_set(view, i, j, k, val) bind(c, name="zforp_private_view3d_set")
+    implicit none
+    type(zFORp_private_view3d), intent(in) :: view
+    integer, intent(in) :: i, j, k
+    real (kind=8), intent(in) :: val
+    call zforp_cfp_private_view3d_set(view%object, int(i, c_size_t), int(j, c_size_t), int(k, c_size_t), real(val, c_double))
+  end subroutine zFORp_private_view3d_set
+
 end module zFORp
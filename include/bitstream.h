@@ -8,7 +8,18 @@
 /* forward declaration of opaque type */
 typedef struct bitstream bitstream;
 
-extern_ const size_t stream_word_bits; /* bit stream granularity */
+extern_ const size_t stream_word_bits;   /* bit stream granularity */
+extern_ const size_t stream_struct_bytes; /* byte size of opaque bit stream struct */
+
+/* caller-owned storage large enough for any bit stream struct */
+typedef struct {
+  uint64 data[16];
+} stream_storage;
+
+#ifdef BIT_STREAM_CALLBACK
+/* function that writes or reads bytes of buffer; returns number of bytes */
+typedef size_t (*stream_callback)(void* context, void* buffer, size_t bytes);
+#endif
 
 #ifndef inline_
 #ifdef __cplusplus
@@ -18,6 +29,17 @@ extern "C" {
 /* allocate and initialize bit stream */
 bitstream* stream_open(void* buffer, size_t bytes);
 
+/* initialize bit stream in caller-owned storage of stream_struct_bytes bytes */
+bitstream* stream_init(void* storage, void* buffer, size_t bytes);
+
+#ifdef BIT_STREAM_CALLBACK
+/* allocate and initialize bit stream whose buffer is passed through callbacks */
+bitstream* stream_open_callback(void* buffer, size_t bytes, stream_callback write, stream_callback read, void* context);
+#endif
+
+/* associate bit stream with new buffer and rewind it */
+void stream_reopen(bitstream* stream, void* buffer, size_t bytes);
+
 /* close and deallocate bit stream */
 void stream_close(bitstream* stream);
 
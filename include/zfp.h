@@ -37,6 +37,28 @@
 #define ZFP_HEADER_MAX_BITS 148 /* max number of header bits */
 #define ZFP_MODE_SHORT_MAX  ((1u << ZFP_MODE_SHORT_BITS) - 2)
 
+/* chunk offset index bit lengths */
+#define ZFP_INDEX_CHUNK_BITS 32 /* number of bits encoding chunk count */
+#define ZFP_INDEX_WIDTH_BITS  6 /* number of bits encoding delta width */
+
+/* number of bits in header of chunk encoded by zfp_encode_chunk */
+#define ZFP_CHUNK_HEADER_BITS 64
+
+/* number of bits in header of frame emitted by zfp_compress_framed */
+#define ZFP_FRAME_HEADER_BITS 128
+
+/* maximum number of devices among which CUDA execution partitions a field */
+#define ZFP_CUDA_MAX_DEVICES 16
+
+/* number of bins in histogram of compressed bits per block */
+#define ZFP_STATS_BINS 16
+
+/* number of memory pools accounted by the library */
+#define ZFP_MEMORY_POOLS 4
+
+/* number of phases timed by GPU (de)compression */
+#define ZFP_DEVICE_PHASES 6
+
 /* types ------------------------------------------------------------------- */
 
 /* Boolean constants */
@@ -49,21 +71,102 @@ typedef int zfp_bool; /* Boolean type */
 
 /* execution policy */
 typedef enum {
-  zfp_exec_serial = 0, /* serial execution (default) */
-  zfp_exec_omp    = 1, /* OpenMP multi-threaded execution */
-  zfp_exec_cuda   = 2, /* CUDA parallel execution */
-  zfp_exec_hip    = 3  /* HIP parallel execution */
+  zfp_exec_serial     = 0, /* serial execution (default) */
+  zfp_exec_omp        = 1, /* OpenMP multi-threaded execution */
+  zfp_exec_cuda       = 2, /* CUDA parallel execution */
+  zfp_exec_hip        = 3, /* HIP parallel execution */
+  zfp_exec_threads    = 4, /* thread-pool multi-threaded execution */
+  zfp_exec_omp_target = 5, /* OpenMP target offload execution */
+  zfp_exec_sycl       = 6, /* SYCL parallel execution */
+  zfp_exec_hybrid     = 7  /* GPU and OpenMP co-execution on one field */
 } zfp_exec_policy;
 
+/* instruction set variant of block codec kernels */
+typedef enum {
+  zfp_isa_generic = 0, /* portable baseline (default) */
+  zfp_isa_avx2    = 1, /* x86-64 AVX2 (Haswell and later) */
+  zfp_isa_avx512  = 2, /* x86-64 AVX-512 (Skylake-SP and later) */
+  zfp_isa_sve     = 3, /* AArch64 SVE (A64FX, Graviton3, and later) */
+  zfp_isa_sve2    = 4  /* AArch64 SVE2 (Neoverse N2/V2 and later) */
+} zfp_isa;
+
+/* OpenMP loop schedule used to assign chunks to threads */
+typedef enum {
+  zfp_omp_static  = 0, /* contiguous ranges of chunks per thread (default) */
+  zfp_omp_dynamic = 1, /* chunks handed out one at a time on demand */
+  zfp_omp_guided  = 2, /* ranges of chunks of decreasing size on demand */
+  zfp_omp_auto    = 3, /* schedule chosen by OpenMP implementation */
+  zfp_omp_tasks   = 4  /* chunks run as tasks of enclosing parallel region */
+} zfp_omp_schedule;
+
 /* OpenMP execution parameters */
 typedef struct {
-  uint threads;    /* number of requested threads */
-  uint chunk_size; /* number of blocks per chunk (1D only) */
+  uint threads;              /* number of requested threads */
+  uint chunk_size;           /* number of blocks per chunk (1D only) */
+  zfp_omp_schedule schedule; /* loop schedule for compression */
+  double* thread_time;       /* per-thread compression time in seconds, or NULL */
+  zfp_bool persistent;       /* retain compression buffers across calls */
+  zfp_bool adaptive;         /* size thread count to field, down to serial */
 } zfp_exec_params_omp;
 
+/* device memory allocator (both functions NULL for cudaMalloc/cudaFree) */
+typedef struct {
+  void* (*alloc)(size_t size, void* context); /* allocate device memory */
+  void (*free)(void* ptr, void* context);     /* deallocate device memory */
+  void* context;                              /* user data passed to alloc/free */
+} zfp_device_allocator;
+
+/* CUDA execution parameters */
+typedef struct {
+  zfp_device_allocator allocator;   /* allocator for device scratch and buffers */
+  void* stream;                     /* cudaStream_t to queue work on (NULL for default) */
+  size_t chunk_bytes;               /* host field bytes staged per slab (0 for default) */
+  uint devices;                     /* number of device IDs (0 for current device) */
+  int device[ZFP_CUDA_MAX_DEVICES]; /* IDs of devices that field is partitioned among */
+  zfp_bool prefetch_host;           /* migrate managed-memory output back to host */
+} zfp_exec_params_cuda;
+
+/* HIP execution parameters */
+typedef struct {
+  void* stream; /* hipStream_t to queue work on (NULL for default) */
+} zfp_exec_params_hip;
+
+/* thread-pool execution parameters */
+typedef struct {
+  uint threads;    /* number of requested threads */
+  uint chunk_size; /* number of blocks per chunk */
+  void* pool;      /* worker threads owned by stream (NULL until first use) */
+} zfp_exec_params_threads;
+
+/* OpenMP target offload execution parameters */
+typedef struct {
+  int device;             /* target device number (negative for default) */
+  zfp_bool device_field;  /* field data resides in target device memory */
+  zfp_bool device_stream; /* compressed stream resides in target device memory */
+} zfp_exec_params_omp_target;
+
+/* SYCL execution parameters */
+typedef struct {
+  void* queue; /* sycl::queue to submit work to (NULL for default) */
+} zfp_exec_params_sycl;
+
+/* hybrid GPU and OpenMP execution parameters */
+typedef struct {
+  zfp_exec_policy device; /* GPU policy (zfp_exec_cuda or zfp_exec_hip) */
+  uint threads;           /* number of requested host threads */
+  double ratio;           /* fraction of blocks (de)compressed on device */
+  zfp_bool calibrate;     /* update ratio from measured throughput */
+} zfp_exec_params_hybrid;
+
 /* execution parameters */
 typedef union {
-  zfp_exec_params_omp omp; /* OpenMP parameters */
+  zfp_exec_params_omp omp;               /* OpenMP parameters */
+  zfp_exec_params_cuda cuda;             /* CUDA parameters */
+  zfp_exec_params_hip hip;               /* HIP parameters */
+  zfp_exec_params_threads threads;       /* thread-pool parameters */
+  zfp_exec_params_omp_target omp_target; /* OpenMP target offload parameters */
+  zfp_exec_params_sycl sycl;             /* SYCL parameters */
+  zfp_exec_params_hybrid hybrid;         /* hybrid GPU and OpenMP parameters */
 } zfp_exec_params;
 
 typedef struct {
@@ -71,6 +174,100 @@ typedef struct {
   zfp_exec_params params; /* execution parameters */
 } zfp_execution;
 
+/* chunk offset index for parallel decompression; use accessors */
+typedef struct {
+  size_t chunks;  /* number of chunks of consecutive blocks (zero if unset) */
+  uint64* offset; /* bit offset of each chunk plus end of stream (chunks + 1) */
+  zfp_bool hashing; /* compute content hash of each chunk during compression */
+  size_t hashes;  /* number of chunk hashes (equals chunks if set) */
+  uint32* hash;   /* CRC-32C of each chunk's word-padded bits */
+} zfp_index;
+
+/* phase of GPU (de)compression timed in zfp_stream_stats */
+typedef enum {
+  zfp_device_alloc   = 0, /* device memory allocation */
+  zfp_device_h2d     = 1, /* host-to-device transfer */
+  zfp_device_kernel  = 2, /* encode or decode kernels */
+  zfp_device_offsets = 3, /* block size scan and stream compaction */
+  zfp_device_d2h     = 4, /* device-to-host transfer */
+  zfp_device_free    = 5  /* device memory deallocation */
+} zfp_device_phase;
+
+/* statistics accumulated during (de)compression; see zfp_stream_set_stats */
+typedef struct {
+  uint64 blocks;                    /* number of blocks (de)compressed */
+  uint64 zero_blocks;               /* blocks whose values are all zero */
+  uint64 constant_blocks;           /* other blocks whose values are all equal */
+  uint64 bit_planes;                /* bit planes coded (at most), over all blocks */
+  uint64 bits;                      /* compressed bits over all blocks */
+  uint64 histogram[ZFP_STATS_BINS]; /* blocks whose bit count b has floor(log2(b)) = i */
+  double cast_time;                 /* seconds in block-floating-point conversion */
+  double transform_time;            /* seconds in decorrelating transform */
+  double coding_time;               /* seconds in embedded coding */
+  double concat_time;               /* seconds concatenating per-chunk streams */
+  double device_time[ZFP_DEVICE_PHASES]; /* seconds in each zfp_device_phase */
+  uint threads;                     /* number of entries in thread_blocks */
+  uint64* thread_blocks;            /* blocks per OpenMP thread (may be NULL) */
+  zfp_exec_policy exec;             /* policy used by most recent call */
+  uint exec_threads;                /* threads used by most recent call */
+} zfp_stream_stats;
+
+/* error bound verification of compressed blocks; see zfp_stream_set_verification */
+typedef struct {
+  double max_error;  /* largest absolute error in any verified block */
+  uint64 blocks;     /* number of blocks verified */
+  uint64 violations; /* blocks whose error exceeded the bound */
+  uint64 repaired;   /* violating blocks stored verbatim instead */
+} zfp_verification;
+
+/* memory allocated by the library, accounted per pool; see zfp_memory_query */
+typedef enum {
+  zfp_memory_host_scratch   = 0, /* per-chunk streams of parallel compression */
+  zfp_memory_host_cache     = 1, /* cache lines of compressed arrays */
+  zfp_memory_device_stream  = 2, /* device copies of compressed streams */
+  zfp_memory_device_scratch = 3  /* device copies of fields and work buffers */
+} zfp_memory_pool;
+
+/* byte counts of memory pool */
+typedef struct {
+  size_t current; /* bytes currently allocated */
+  size_t peak;    /* high-water mark since last reset */
+  size_t limit;   /* cap on current bytes (zero if unlimited) */
+} zfp_memory_usage;
+
+/* container of named compressed fields with footer index; opaque */
+typedef struct zfp_container zfp_container;
+
+/* prepared codec for small chunks; opaque */
+typedef struct zfp_chunk_codec zfp_chunk_codec;
+
+/* immutable compression parameters shareable across threads; opaque */
+typedef struct zfp_config zfp_config;
+
+/* fixed-rate CUDA (de)compression prepared for one field shape; opaque */
+typedef struct zfp_cuda_plan zfp_cuda_plan;
+
+/* lossless back end applied to each chunk of fields stored in containers */
+typedef enum {
+  zfp_entropy_none    = 0, /* store compressed chunks as is (default) */
+  zfp_entropy_huffman = 1  /* code bytes of each chunk with a Huffman code */
+} zfp_entropy;
+
+/* time series codec predicting each step from the previous one; opaque */
+typedef struct zfp_temporal zfp_temporal;
+
+/* incremental checkpoints that store only blocks changed since last one; opaque */
+typedef struct zfp_checkpoint zfp_checkpoint;
+
+/* prediction of a field from a correlated primary field */
+typedef enum {
+  zfp_predict_difference = 0, /* residual against primary field */
+  zfp_predict_linear     = 1  /* residual against per-block scaled primary field */
+} zfp_predictor;
+
+/* consumer of a frame emitted by zfp_compress_framed; false aborts compression */
+typedef zfp_bool (*zfp_frame_sink)(const void* frame, size_t size, void* context);
+
 /* compressed stream; use accessors to get/set members */
 typedef struct {
   uint minbits;       /* minimum number of bits to store per block */
@@ -79,6 +276,15 @@ typedef struct {
   int minexp;         /* minimum floating point bit plane number to store */
   bitstream* stream;  /* compressed bit stream */
   zfp_execution exec; /* execution policy and parameters */
+  zfp_index* index;   /* optional chunk offset index (may be NULL) */
+  zfp_isa isa;        /* instruction set variant of codec kernels */
+  void* scratch;      /* buffers retained by parallel compression (may be NULL) */
+  zfp_stream_stats* stats; /* statistics to accumulate (may be NULL) */
+  zfp_bool raw;       /* store blocks verbatim when coding does not pay off */
+  zfp_entropy entropy; /* lossless back end for container chunks */
+  zfp_verification* verify; /* error bound check of compressed blocks (may be NULL) */
+  const uint8* map;   /* per-block bit planes to discard (may be NULL) */
+  zfp_bool relative;  /* accuracy is relative to smallest magnitude in block */
 } zfp_stream;
 
 /* compression mode */
@@ -93,21 +299,46 @@ typedef enum {
 
 /* scalar type */
 typedef enum {
-  zfp_type_none   = 0, /* unspecified type */
-  zfp_type_int32  = 1, /* 32-bit signed integer */
-  zfp_type_int64  = 2, /* 64-bit signed integer */
-  zfp_type_float  = 3, /* single precision floating point */
-  zfp_type_double = 4  /* double precision floating point */
+  zfp_type_none     = 0, /* unspecified type */
+  zfp_type_int32    = 1, /* 32-bit signed integer */
+  zfp_type_int64    = 2, /* 64-bit signed integer */
+  zfp_type_float    = 3, /* single precision floating point */
+  zfp_type_double   = 4, /* double precision floating point */
+  zfp_type_half     = 5, /* IEEE half precision floating point */
+  zfp_type_bfloat16 = 6, /* bfloat16 (truncated single precision) */
+  zfp_type_int8     = 7, /* 8-bit signed integer */
+  zfp_type_uint8    = 8, /* 8-bit unsigned integer */
+  zfp_type_int16    = 9, /* 16-bit signed integer */
+  zfp_type_uint16   = 10 /* 16-bit unsigned integer */
 } zfp_type;
 
+/* reduction of decompressed values */
+typedef enum {
+  zfp_reduce_sum  = 0, /* sum of values */
+  zfp_reduce_mean = 1, /* arithmetic mean of values */
+  zfp_reduce_min  = 2, /* minimum value */
+  zfp_reduce_max  = 3, /* maximum value */
+  zfp_reduce_l2   = 4  /* Euclidean norm (square root of sum of squares) */
+} zfp_reduce_op;
+
 /* uncompressed array; use accessors to get/set members */
 typedef struct {
   zfp_type type;       /* scalar type (e.g. int32, double) */
   uint nx, ny, nz, nw; /* sizes (zero for unused dimensions) */
   int sx, sy, sz, sw;  /* strides (zero for contiguous array a[nw][nz][ny][nx]) */
   void* data;          /* pointer to array data */
+  const uint8* mask;   /* per-value validity (nonzero if valid) or NULL */
+  double fill;         /* value of invalid entries when has_fill is set */
+  zfp_bool has_fill;   /* true if invalid entries hold or receive fill */
 } zfp_field;
 
+/* profiling range callbacks (invoked only if built with ZFP_WITH_TRACING) */
+typedef struct {
+  void (*begin)(const char* name, void* context); /* open named range */
+  void (*end)(void* context);                     /* close innermost range */
+  void* context;                                  /* user data passed to begin/end */
+} zfp_trace_hooks;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -139,6 +370,19 @@ zfp_stream_close(
   zfp_stream* stream /* compressed stream */
 );
 
+/* initialize caller-owned compressed stream, e.g., on the stack */
+void
+zfp_stream_init(
+  zfp_stream* stream, /* compressed stream to initialize */
+  bitstream* bs       /* bit stream to read from and write to (may be NULL) */
+);
+
+/* release buffers held by caller-owned compressed stream without freeing it */
+void
+zfp_stream_release(
+  zfp_stream* stream /* compressed stream */
+);
+
 /* high-level API: compressed stream inspectors ---------------------------- */
 
 /* bit stream associated with compressed stream */
@@ -172,6 +416,12 @@ zfp_stream_accuracy(
   const zfp_stream* stream /* compressed stream */
 );
 
+/* accuracy as pointwise relative error tolerance (when in relative mode) */
+double                     /* tolerance or zero if not in relative mode */
+zfp_stream_relative_accuracy(
+  const zfp_stream* stream /* compressed stream */
+);
+
 /* get all compression parameters in a compact representation */
 uint64                     /* 12- or 64-bit encoding of parameters */
 zfp_stream_mode(
@@ -188,6 +438,24 @@ zfp_stream_params(
   int* minexp               /* minimum base-2 exponent; error <= 2^minexp */
 );
 
+/* true if blocks that do not compress are stored verbatim */
+zfp_bool
+zfp_stream_raw_blocks(
+  const zfp_stream* stream /* compressed stream */
+);
+
+/* per-block number of bit planes discarded relative to stream parameters */
+const uint8*               /* map in raster order of blocks, or NULL if none */
+zfp_stream_block_map(
+  const zfp_stream* stream /* compressed stream */
+);
+
+/* lossless back end applied to chunks added to containers */
+zfp_entropy
+zfp_stream_entropy(
+  const zfp_stream* stream /* compressed stream */
+);
+
 /* byte size of sequentially compressed stream (call after compression) */
 size_t                     /* actual number of bytes of compressed storage */
 zfp_stream_compressed_size(
@@ -201,6 +469,15 @@ zfp_stream_maximum_size(
   const zfp_field* field    /* array to compress */
 );
 
+/* estimate compressed size in bytes by compressing a sample of blocks */
+size_t                      /* estimated number of bytes of compressed storage */
+zfp_stream_estimate_size(
+  const zfp_stream* stream, /* compressed stream */
+  const zfp_field* field,   /* array to compress */
+  double fraction,          /* fraction of blocks to sample in (0, 1] */
+  size_t* bound             /* upper confidence bound on size (may be NULL) */
+);
+
 /* high-level API: initialization of compressed stream parameters ---------- */
 
 /* rewind bit stream to beginning for compression or decompression */
@@ -246,6 +523,23 @@ zfp_stream_set_accuracy(
   double tolerance    /* desired error tolerance */
 );
 
+/* set accuracy as error tolerance relative to each value's magnitude */
+double                /* actual relative error tolerance */
+zfp_stream_set_relative_accuracy(
+  zfp_stream* stream, /* compressed stream */
+  double tolerance    /* desired relative error tolerance */
+);
+
+/* set accuracy or precision to meet compression ratio on sample of blocks */
+double                    /* actual error tolerance or precision; zero on failure */
+zfp_stream_set_target_ratio(
+  zfp_stream* stream,     /* compressed stream */
+  const zfp_field* field, /* array to compress */
+  zfp_mode mode,          /* fixed-accuracy or fixed-precision mode */
+  double ratio,           /* desired uncompressed-to-compressed size ratio */
+  double fraction         /* fraction of blocks to sample in (0, 1] */
+);
+
 /* set parameters from compact encoding; leaves stream intact on failure */
 zfp_mode              /* compression mode or zfp_mode_null upon failure */
 zfp_stream_set_mode(
@@ -263,6 +557,27 @@ zfp_stream_set_params(
   int minexp          /* minimum base-2 exponent; error <= 2^minexp */
 );
 
+/* store blocks verbatim behind a flag bit when coding takes more bits */
+void
+zfp_stream_set_raw_blocks(
+  zfp_stream* stream, /* compressed stream */
+  zfp_bool enable     /* true to prefix each block with a raw-storage flag */
+);
+
+/* set per-block map of bit planes to discard in variable-rate modes */
+void
+zfp_stream_set_block_map(
+  zfp_stream* stream, /* compressed stream */
+  const uint8* map    /* one level per block in raster order (NULL for none) */
+);
+
+/* set lossless back end applied to chunks added to containers */
+zfp_bool              /* true upon success */
+zfp_stream_set_entropy(
+  zfp_stream* stream, /* compressed stream */
+  zfp_entropy coder   /* entropy coder */
+);
+
 /* high-level API: execution policy ---------------------------------------- */
 
 /* current execution policy */
@@ -283,6 +598,127 @@ zfp_stream_omp_chunk_size(
   const zfp_stream* stream /* compressed stream */
 );
 
+/* OpenMP loop schedule used for compression */
+zfp_omp_schedule           /* loop schedule */
+zfp_stream_omp_schedule(
+  const zfp_stream* stream /* compressed stream */
+);
+
+/* array of per-thread OpenMP compression times */
+double*                    /* array of thread times (NULL if not timed) */
+zfp_stream_omp_thread_time(
+  const zfp_stream* stream /* compressed stream */
+);
+
+/* whether OpenMP compression buffers are retained across calls */
+zfp_bool                   /* true if buffers are retained */
+zfp_stream_omp_persistent(
+  const zfp_stream* stream /* compressed stream */
+);
+
+/* whether OpenMP thread count is adapted to field size */
+zfp_bool                   /* true if thread count is adaptive */
+zfp_stream_omp_adaptive(
+  const zfp_stream* stream /* compressed stream */
+);
+
+/* number of thread-pool threads to use */
+uint                       /* number of threads (0 for default) */
+zfp_stream_thread_count(
+  const zfp_stream* stream /* compressed stream */
+);
+
+/* number of blocks per thread-pool chunk */
+uint                       /* number of blocks per chunk (0 for default) */
+zfp_stream_thread_chunk_size(
+  const zfp_stream* stream /* compressed stream */
+);
+
+/* device memory allocator used by CUDA execution */
+zfp_device_allocator       /* allocator (NULL functions for default) */
+zfp_stream_cuda_allocator(
+  const zfp_stream* stream /* compressed stream */
+);
+
+/* CUDA stream on which device work is queued */
+void*                      /* cudaStream_t (NULL for default stream) */
+zfp_stream_cuda_stream(
+  const zfp_stream* stream /* compressed stream */
+);
+
+/* bytes of host-resident field staged on the device per CUDA slab */
+size_t                     /* number of bytes (0 for default) */
+zfp_stream_cuda_chunk_bytes(
+  const zfp_stream* stream /* compressed stream */
+);
+
+/* number of devices among which CUDA execution partitions fields */
+uint                       /* number of devices (0 for current device) */
+zfp_stream_cuda_devices(
+  const zfp_stream* stream /* compressed stream */
+);
+
+/* ID of CUDA device that (de)compresses given slab of field */
+int                        /* device ID (-1 if none) */
+zfp_stream_cuda_device(
+  const zfp_stream* stream, /* compressed stream */
+  uint slab                 /* slab index in [0, devices) */
+);
+
+/* whether managed-memory output is migrated back to host after CUDA work */
+zfp_bool                   /* true if output is prefetched to host */
+zfp_stream_cuda_prefetch_host(
+  const zfp_stream* stream /* compressed stream */
+);
+
+/* HIP stream on which device work is queued */
+void*                      /* hipStream_t (NULL for default stream) */
+zfp_stream_hip_stream(
+  const zfp_stream* stream /* compressed stream */
+);
+
+/* OpenMP target device that (de)compresses fields */
+int                        /* device number (negative for default device) */
+zfp_stream_omp_target_device(
+  const zfp_stream* stream /* compressed stream */
+);
+
+/* whether field data passed to OpenMP target execution is device memory */
+zfp_bool                   /* true if field is a device pointer */
+zfp_stream_omp_target_device_field(
+  const zfp_stream* stream /* compressed stream */
+);
+
+/* whether bit stream passed to OpenMP target execution is device memory */
+zfp_bool                   /* true if stream buffer is a device pointer */
+zfp_stream_omp_target_device_stream(
+  const zfp_stream* stream /* compressed stream */
+);
+
+/* SYCL queue to which device work is submitted */
+void*                      /* sycl::queue* (NULL for default queue) */
+zfp_stream_sycl_queue(
+  const zfp_stream* stream /* compressed stream */
+);
+
+/* GPU policy that hybrid execution pairs with host threads */
+zfp_exec_policy            /* zfp_exec_cuda or zfp_exec_hip (serial if not hybrid) */
+zfp_stream_hybrid_device(
+  const zfp_stream* stream /* compressed stream */
+);
+
+/* number of host threads used by hybrid execution */
+uint                       /* number of threads (0 for default) */
+zfp_stream_hybrid_threads(
+  const zfp_stream* stream /* compressed stream */
+);
+
+/* fraction of blocks that hybrid execution (de)compresses on device */
+double                     /* fraction in [0, 1] (0 if not hybrid) */
+zfp_stream_hybrid_ratio(
+  const zfp_stream* stream /* compressed stream */
+);
+
 /* set execution policy */
 zfp_bool                 /* true upon success */
 zfp_stream_set_execution(
@@ -304,109 +740,431 @@ zfp_stream_set_omp_chunk_size(
   uint chunk_size     /* number of blocks per chunk (0 for default) */
 );
 
-/* high-level API: uncompressed array construction/destruction ------------- */
-
-/* allocate field struct */
-zfp_field* /* pointer to default initialized field */
-zfp_field_alloc();
+/* set OpenMP execution policy and loop schedule for compression */
+zfp_bool                   /* true upon success */
+zfp_stream_set_omp_schedule(
+  zfp_stream* stream,       /* compressed stream */
+  zfp_omp_schedule schedule /* loop schedule */
+);
 
-/* allocate metadata for 1D field f[nx] */
-zfp_field*       /* allocated field metadata */
-zfp_field_1d(
-  void* pointer, /* pointer to uncompressed scalars (may be NULL) */
-  zfp_type type, /* scalar type */
-  uint nx        /* number of scalars */
+/* set OpenMP execution policy and array to record per-thread compression times */
+zfp_bool              /* true upon success */
+zfp_stream_set_omp_thread_time(
+  zfp_stream* stream, /* compressed stream */
+  double* time        /* array with one entry per thread, or NULL to disable */
 );
 
-/* allocate metadata for 2D field f[ny][nx] */
-zfp_field*       /* allocated field metadata */
-zfp_field_2d(
-  void* pointer, /* pointer to uncompressed scalars (may be NULL) */
-  zfp_type type, /* scalar type */
-  uint nx,       /* number of scalars in x dimension */
-  uint ny        /* number of scalars in y dimension */
+/* set OpenMP execution policy and whether to retain compression buffers */
+zfp_bool              /* true upon success */
+zfp_stream_set_omp_persistent(
+  zfp_stream* stream, /* compressed stream */
+  zfp_bool persistent /* retain buffers until zfp_stream_close if true */
 );
 
-/* allocate metadata for 3D field f[nz][ny][nx] */
-zfp_field*       /* allocated field metadata */
-zfp_field_3d(
-  void* pointer, /* pointer to uncompressed scalars (may be NULL) */
-  zfp_type type, /* scalar type */
-  uint nx,       /* number of scalars in x dimension */
-  uint ny,       /* number of scalars in y dimension */
-  uint nz        /* number of scalars in z dimension */
+/* set OpenMP execution policy and whether to adapt thread count to field size */
+zfp_bool              /* true upon success */
+zfp_stream_set_omp_adaptive(
+  zfp_stream* stream, /* compressed stream */
+  zfp_bool adaptive   /* use fewer threads or serial execution for small fields */
 );
 
-/* allocate metadata for 4D field f[nw][nz][ny][nx] */
-zfp_field*       /* allocated field metadata */
-zfp_field_4d(
-  void* pointer, /* pointer to uncompressed scalars (may be NULL) */
-  zfp_type type, /* scalar type */
-  uint nx,       /* number of scalars in x dimension */
-  uint ny,       /* number of scalars in y dimension */
-  uint nz,       /* number of scalars in z dimension */
-  uint nw        /* number of scalars in w dimension */
+/* set thread-pool execution policy and number of threads */
+zfp_bool              /* true upon success */
+zfp_stream_set_thread_count(
+  zfp_stream* stream, /* compressed stream */
+  uint threads        /* number of threads to use (0 for default) */
 );
 
-/* deallocate field metadata */
-void
-zfp_field_free(
-  zfp_field* field /* field metadata */
+/* set thread-pool execution policy and number of blocks per chunk */
+zfp_bool              /* true upon success */
+zfp_stream_set_thread_chunk_size(
+  zfp_stream* stream, /* compressed stream */
+  uint chunk_size     /* number of blocks per chunk (0 for default) */
 );
 
-/* high-level API: uncompressed array inspectors --------------------------- */
+/* set CUDA execution policy and device memory allocator */
+zfp_bool                               /* true upon success */
+zfp_stream_set_cuda_allocator(
+  zfp_stream* stream,                  /* compressed stream */
+  const zfp_device_allocator* allocator /* allocator (NULL for default) */
+);
 
-/* pointer to first scalar in field */
-void*                    /* array pointer */
-zfp_field_pointer(
-  const zfp_field* field /* field metadata */
+/* set CUDA execution policy and stream on which to queue device work */
+zfp_bool              /* true upon success */
+zfp_stream_set_cuda_stream(
+  zfp_stream* stream, /* compressed stream */
+  void* cuda_stream   /* cudaStream_t (NULL for default stream) */
 );
 
-/* pointer to lowest memory address spanned by field */
-void*
-zfp_field_begin(
-  const zfp_field* field /* field metadata */
+/* set CUDA execution policy and bytes of host field staged per slab */
+zfp_bool              /* true upon success */
+zfp_stream_set_cuda_chunk_bytes(
+  zfp_stream* stream, /* compressed stream */
+  size_t chunk_bytes  /* number of bytes (0 for default) */
 );
 
-/* field scalar type */
-zfp_type                 /* scalar type */
-zfp_field_type(
-  const zfp_field* field /* field metadata */
+/* set CUDA execution policy and devices among which to partition fields */
+zfp_bool              /* true upon success */
+zfp_stream_set_cuda_devices(
+  zfp_stream* stream, /* compressed stream */
+  const int* device,  /* device IDs (NULL for current device) */
+  uint devices        /* number of device IDs (at most ZFP_CUDA_MAX_DEVICES) */
 );
 
-/* precision of field scalar type */
-uint                     /* scalar type precision in number of bits */
-zfp_field_precision(
-  const zfp_field* field /* field metadata */
+/* set CUDA execution policy and whether to prefetch managed output to host */
+zfp_bool                 /* true upon success */
+zfp_stream_set_cuda_prefetch_host(
+  zfp_stream* stream,    /* compressed stream */
+  zfp_bool prefetch_host /* migrate managed-memory output back to host */
 );
 
-/* field dimensionality (1, 2, 3, or 4) */
-uint                     /* number of dimensions */
-zfp_field_dimensionality(
-  const zfp_field* field /* field metadata */
+/* set HIP execution policy and stream on which to queue device work */
+zfp_bool              /* true upon success */
+zfp_stream_set_hip_stream(
+  zfp_stream* stream, /* compressed stream */
+  void* hip_stream    /* hipStream_t (NULL for default stream) */
 );
 
-/* field size in number of scalars */
-size_t                    /* total number of scalars */
-zfp_field_size(
-  const zfp_field* field, /* field metadata */
-  uint* size              /* number of scalars per dimension (may be NULL) */
+/* set OpenMP target execution policy and device to offload to */
+zfp_bool              /* true upon success */
+zfp_stream_set_omp_target_device(
+  zfp_stream* stream, /* compressed stream */
+  int device          /* device number (negative for default device) */
 );
 
-/* number of bytes spanned by field data including gaps (if any) */
-size_t
-zfp_field_size_bytes(
-  const zfp_field* field /* field metadata */
+/* set OpenMP target execution policy and where field and stream reside */
+zfp_bool              /* true upon success */
+zfp_stream_set_omp_target_device_data(
+  zfp_stream* stream, /* compressed stream */
+  zfp_bool field,     /* field data allocated with omp_target_alloc */
+  zfp_bool buffer     /* stream buffer allocated with omp_target_alloc */
 );
 
-/* field strides per dimension */
-zfp_bool                  /* true if array is not contiguous */
-zfp_field_stride(
-  const zfp_field* field, /* field metadata */
-  int* stride             /* stride in scalars per dimension (may be NULL) */
+/* set SYCL execution policy and queue to which to submit device work */
+zfp_bool              /* true upon success */
+zfp_stream_set_sycl_queue(
+  zfp_stream* stream, /* compressed stream */
+  void* queue         /* sycl::queue* (NULL for default queue) */
 );
 
-/* field contiguity test */
+/* set hybrid execution policy and GPU policy to pair with host threads */
+zfp_bool                 /* true upon success */
+zfp_stream_set_hybrid_device(
+  zfp_stream* stream,    /* compressed stream */
+  zfp_exec_policy device /* zfp_exec_cuda or zfp_exec_hip */
+);
+
+/* set hybrid execution policy and number of host threads */
+zfp_bool              /* true upon success */
+zfp_stream_set_hybrid_threads(
+  zfp_stream* stream, /* compressed stream */
+  uint threads        /* number of OpenMP threads to use (0 for default) */
+);
+
+/* set hybrid execution policy and fraction of blocks placed on device */
+zfp_bool              /* true upon success */
+zfp_stream_set_hybrid_ratio(
+  zfp_stream* stream, /* compressed stream */
+  double ratio,       /* fraction of blocks in [0, 1] */
+  zfp_bool calibrate  /* update ratio from measured throughput of each call */
+);
+
+/* high-level API: instruction set dispatch ------------------------------- */
+
+/* best instruction set variant supported by library and processor */
+zfp_isa
+zfp_isa_detect();
+
+/* name of instruction set variant, e.g., "avx2" */
+const char*
+zfp_isa_name(
+  zfp_isa isa /* instruction set variant */
+);
+
+/* instruction set variant of codec kernels used by stream */
+zfp_isa
+zfp_stream_isa(
+  const zfp_stream* stream /* compressed stream */
+);
+
+/* select instruction set variant of codec kernels */
+zfp_bool              /* true upon success */
+zfp_stream_set_isa(
+  zfp_stream* stream, /* compressed stream */
+  zfp_isa isa         /* variant supported by library and processor */
+);
+
+/* high-level API: profiling ranges --------------------------------------- */
+
+/* set callbacks that delimit host-side phases of (de)compression */
+void
+zfp_set_trace_hooks(
+  const zfp_trace_hooks* hooks /* callbacks (NULL to disable) */
+);
+
+/* open named range by invoking begin callback, if any */
+void
+zfp_trace_begin(
+  const char* name /* range name, e.g., "zfp:compress" */
+);
+
+/* close innermost range by invoking end callback, if any */
+void
+zfp_trace_end(void);
+
+/* high-level API: statistics --------------------------------------------- */
+
+/* statistics accumulated by stream */
+zfp_stream_stats*          /* statistics or NULL if none are gathered */
+zfp_stream_statistics(
+  const zfp_stream* stream /* compressed stream */
+);
+
+/* accumulate statistics during subsequent (de)compression */
+void
+zfp_stream_set_stats(
+  zfp_stream* stream,     /* compressed stream */
+  zfp_stream_stats* stats /* statistics to add to (NULL to disable) */
+);
+
+/* zero all counts and times, including per-thread block counts */
+void
+zfp_stats_reset(
+  zfp_stream_stats* stats /* statistics */
+);
+
+/* error bound verification accumulated by stream */
+zfp_verification*          /* verification or NULL if blocks are not verified */
+zfp_stream_verification(
+  const zfp_stream* stream /* compressed stream */
+);
+
+/* decode each block after encoding it and check its error against bound */
+void
+zfp_stream_set_verification(
+  zfp_stream* stream,            /* compressed stream */
+  zfp_verification* verification /* results to add to (NULL to disable) */
+);
+
+/* zero error and counts of verification */
+void
+zfp_verification_reset(
+  zfp_verification* verification /* verification */
+);
+
+/* high-level API: memory accounting -------------------------------------- */
+
+/* current, peak, and maximum bytes allocated from pool */
+zfp_memory_usage       /* byte counts (all zero if pool is invalid) */
+zfp_memory_query(
+  zfp_memory_pool pool /* memory pool */
+);
+
+/* bytes that may still be allocated from pool before reaching its limit */
+size_t                 /* available bytes (SIZE_MAX if unlimited) */
+zfp_memory_available(
+  zfp_memory_pool pool /* memory pool */
+);
+
+/* cap bytes allocated from pool; operations fall back on strategies using
+   less memory, when available, rather than exceed the limit */
+void
+zfp_memory_set_limit(
+  zfp_memory_pool pool, /* memory pool */
+  size_t bytes          /* maximum bytes (zero for no limit) */
+);
+
+/* set high-water mark of pool to its current byte count */
+void
+zfp_memory_reset_peak(
+  zfp_memory_pool pool /* memory pool */
+);
+
+/* account for allocation of given size unless it would exceed pool limit */
+zfp_bool               /* true if allocation may proceed */
+zfp_memory_acquire(
+  zfp_memory_pool pool, /* memory pool */
+  size_t bytes          /* size of allocation */
+);
+
+/* account for allocation of given size regardless of pool limit */
+void
+zfp_memory_charge(
+  zfp_memory_pool pool, /* memory pool */
+  size_t bytes          /* size of allocation */
+);
+
+/* account for deallocation of memory previously acquired or charged */
+void
+zfp_memory_release(
+  zfp_memory_pool pool, /* memory pool */
+  size_t bytes          /* size of deallocation */
+);
+
+/* high-level API: chunk offset index ------------------------------------- */
+
+/* allocate empty chunk offset index */
+zfp_index* /* allocated index */
+zfp_index_alloc();
+
+/* deallocate chunk offset index */
+void
+zfp_index_free(
+  zfp_index* index /* index to deallocate (may be NULL) */
+);
+
+/* number of chunks recorded in index */
+size_t                   /* number of chunks (zero if not set) */
+zfp_index_chunks(
+  const zfp_index* index /* chunk offset index */
+);
+
+/* bit offset of chunk relative to beginning of compressed field */
+uint64                    /* bit offset (total bits when chunk = chunks) */
+zfp_index_offset(
+  const zfp_index* index, /* chunk offset index */
+  size_t chunk            /* chunk number in [0, chunks] */
+);
+
+/* set index from array of chunks + 1 nondecreasing bit offsets */
+zfp_bool                  /* true upon success */
+zfp_index_set(
+  zfp_index* index,       /* chunk offset index */
+  size_t chunks,          /* number of chunks */
+  const uint64* offset    /* chunks + 1 bit offsets, beginning with zero */
+);
+
+/* request content hashes of chunks recorded by parallel compression */
+void
+zfp_index_set_hashing(
+  zfp_index* index, /* chunk offset index */
+  zfp_bool hashing  /* true to compute chunk hashes */
+);
+
+/* content hash of chunk recorded by last parallel compression */
+zfp_bool                  /* true if chunk has a hash */
+zfp_index_hash(
+  const zfp_index* index, /* chunk offset index */
+  size_t chunk,           /* chunk number in [0, chunks) */
+  uint32* hash            /* CRC-32C of chunk's bits padded to whole words */
+);
+
+/* chunk offset index associated with compressed stream */
+zfp_index*                 /* index or NULL if none is associated */
+zfp_stream_index(
+  const zfp_stream* stream /* compressed stream */
+);
+
+/* associate chunk offset index with compressed stream */
+void
+zfp_stream_set_index(
+  zfp_stream* stream, /* compressed stream */
+  zfp_index* index    /* index to populate or consult (may be NULL) */
+);
+
+/* high-level API: uncompressed array construction/destruction ------------- */
+
+/* allocate field struct */
+zfp_field* /* pointer to default initialized field */
+zfp_field_alloc();
+
+/* allocate metadata for 1D field f[nx] */
+zfp_field*       /* allocated field metadata */
+zfp_field_1d(
+  void* pointer, /* pointer to uncompressed scalars (may be NULL) */
+  zfp_type type, /* scalar type */
+  uint nx        /* number of scalars */
+);
+
+/* allocate metadata for 2D field f[ny][nx] */
+zfp_field*       /* allocated field metadata */
+zfp_field_2d(
+  void* pointer, /* pointer to uncompressed scalars (may be NULL) */
+  zfp_type type, /* scalar type */
+  uint nx,       /* number of scalars in x dimension */
+  uint ny        /* number of scalars in y dimension */
+);
+
+/* allocate metadata for 3D field f[nz][ny][nx] */
+zfp_field*       /* allocated field metadata */
+zfp_field_3d(
+  void* pointer, /* pointer to uncompressed scalars (may be NULL) */
+  zfp_type type, /* scalar type */
+  uint nx,       /* number of scalars in x dimension */
+  uint ny,       /* number of scalars in y dimension */
+  uint nz        /* number of scalars in z dimension */
+);
+
+/* allocate metadata for 4D field f[nw][nz][ny][nx] */
+zfp_field*       /* allocated field metadata */
+zfp_field_4d(
+  void* pointer, /* pointer to uncompressed scalars (may be NULL) */
+  zfp_type type, /* scalar type */
+  uint nx,       /* number of scalars in x dimension */
+  uint ny,       /* number of scalars in y dimension */
+  uint nz,       /* number of scalars in z dimension */
+  uint nw        /* number of scalars in w dimension */
+);
+
+/* deallocate field metadata */
+void
+zfp_field_free(
+  zfp_field* field /* field metadata */
+);
+
+/* high-level API: uncompressed array inspectors --------------------------- */
+
+/* pointer to first scalar in field */
+void*                    /* array pointer */
+zfp_field_pointer(
+  const zfp_field* field /* field metadata */
+);
+
+/* pointer to lowest memory address spanned by field */
+void*
+zfp_field_begin(
+  const zfp_field* field /* field metadata */
+);
+
+/* field scalar type */
+zfp_type                 /* scalar type */
+zfp_field_type(
+  const zfp_field* field /* field metadata */
+);
+
+/* precision of field scalar type */
+uint                     /* scalar type precision in number of bits */
+zfp_field_precision(
+  const zfp_field* field /* field metadata */
+);
+
+/* field dimensionality (1, 2, 3, or 4) */
+uint                     /* number of dimensions */
+zfp_field_dimensionality(
+  const zfp_field* field /* field metadata */
+);
+
+/* field size in number of scalars */
+size_t                    /* total number of scalars */
+zfp_field_size(
+  const zfp_field* field, /* field metadata */
+  uint* size              /* number of scalars per dimension (may be NULL) */
+);
+
+/* number of bytes spanned by field data including gaps (if any) */
+size_t
+zfp_field_size_bytes(
+  const zfp_field* field /* field metadata */
+);
+
+/* field strides per dimension */
+zfp_bool                  /* true if array is not contiguous */
+zfp_field_stride(
+  const zfp_field* field, /* field metadata */
+  int* stride             /* stride in scalars per dimension (may be NULL) */
+);
+
+/* field contiguity test */
 zfp_bool                 /* true if field layout is contiguous */
 zfp_field_is_contiguous(
   const zfp_field* field /* field metadata */
@@ -418,6 +1176,19 @@ zfp_field_metadata(
   const zfp_field* field /* field metadata */
 );
 
+/* fill value of invalid entries */
+zfp_bool                 /* true if field has fill value */
+zfp_field_fill_value(
+  const zfp_field* field, /* field metadata */
+  double* value           /* fill value (may be NULL) */
+);
+
+/* per-value validity mask */
+const uint8*             /* mask in raster order, or NULL if none */
+zfp_field_mask(
+  const zfp_field* field /* field metadata */
+);
+
 /* high-level API: uncompressed array specification ------------------------ */
 
 /* set pointer to first scalar in field */
@@ -509,6 +1280,26 @@ zfp_field_set_metadata(
   uint64 meta       /* compact 52-bit encoding of metadata */
 );
 
+/* mark values equal to fill value (any NaN if NaN) as invalid */
+void
+zfp_field_set_fill_value(
+  zfp_field* field, /* field metadata */
+  double value      /* fill value */
+);
+
+/* remove fill value */
+void
+zfp_field_clear_fill_value(
+  zfp_field* field /* field metadata */
+);
+
+/* set per-value validity mask in raster order (NULL for none) */
+void
+zfp_field_set_mask(
+  zfp_field* field,  /* field metadata */
+  const uint8* mask  /* nx * ny * nz * nw bytes, nonzero if valid */
+);
+
 /* high-level API: compression and decompression --------------------------- */
 
 /* compress entire field (nonzero return value upon success) */
@@ -518,6 +1309,61 @@ zfp_compress(
   const zfp_field* field /* field metadata */
 );
 
+/* compress field as if of another scalar type, converting each block */
+size_t                    /* cumulative number of bytes of compressed storage */
+zfp_compress_as(
+  zfp_stream* stream,     /* compressed stream */
+  const zfp_field* field, /* field metadata */
+  zfp_type type           /* scalar type of compressed stream */
+);
+
+/* recompress blocks of fixed-rate stream that intersect box in place */
+size_t                    /* cumulative number of bytes of compressed storage */
+zfp_compress_subset(
+  zfp_stream* stream,     /* compressed stream positioned at start of field */
+  const zfp_field* field, /* field metadata */
+  size_t x0,              /* box origin along x */
+  size_t y0,              /* box origin along y */
+  size_t z0,              /* box origin along z */
+  size_t nx,              /* box size along x */
+  size_t ny,              /* box size along y */
+  size_t nz               /* box size along z */
+);
+
+/* compress field of interleaved components, e.g., array of structs */
+size_t                    /* cumulative number of bytes of compressed storage */
+zfp_compress_interleaved(
+  zfp_stream* stream,     /* compressed stream */
+  const zfp_field* field, /* field of first component */
+  uint components         /* number of consecutive scalars per element */
+);
+
+/* compress contiguous field into stream opened on its own storage */
+size_t                   /* cumulative number of bytes of compressed storage */
+zfp_compress_inplace(
+  zfp_stream* stream,    /* compressed stream at start of field storage */
+  const zfp_field* field /* field metadata */
+);
+
+/* begin compressing 3D field one slab of z planes at a time */
+void
+zfp_compress_begin(
+  zfp_stream* stream /* compressed stream */
+);
+
+/* compress next slab, whose z extent is a multiple of four unless last */
+zfp_bool                /* true upon success */
+zfp_compress_slab(
+  zfp_stream* stream,   /* compressed stream */
+  const zfp_field* slab /* 3D field metadata for slab */
+);
+
+/* finish compressing field one slab at a time */
+size_t               /* cumulative number of bytes of compressed storage */
+zfp_compress_end(
+  zfp_stream* stream /* compressed stream */
+);
+
 /* decompress entire field (nonzero return value upon success) */
 size_t                /* cumulative number of bytes of compressed storage */
 zfp_decompress(
@@ -525,6 +1371,346 @@ zfp_decompress(
   zfp_field* field    /* field metadata */
 );
 
+/* decompress stream of another scalar type, converting each block */
+size_t                /* cumulative number of bytes of compressed storage */
+zfp_decompress_as(
+  zfp_stream* stream, /* compressed stream */
+  zfp_field* field,   /* field metadata */
+  zfp_type type       /* scalar type of compressed stream */
+);
+
+/* decompress (2^level)^d sub-block averages of each block, 0 <= level <= 2 */
+size_t                /* cumulative number of bytes of compressed storage */
+zfp_decompress_lod(
+  zfp_stream* stream, /* compressed stream */
+  zfp_field* field,   /* full-resolution field metadata and reduced array */
+  uint level          /* level of detail */
+);
+
+/* decompress field of interleaved components */
+size_t                /* cumulative number of bytes of compressed storage */
+zfp_decompress_interleaved(
+  zfp_stream* stream, /* compressed stream */
+  zfp_field* field,   /* field of first component */
+  uint components     /* number of consecutive scalars per element */
+);
+
+/* decompress box of up to 3D field at (x0, y0, z0) of size nx * ny * nz */
+size_t                /* cumulative number of bytes of compressed storage */
+zfp_decompress_subset(
+  zfp_stream* stream, /* compressed stream */
+  zfp_field* field,   /* full-resolution field metadata and box array */
+  size_t x0,          /* box origin along x */
+  size_t y0,          /* box origin along y */
+  size_t z0,          /* box origin along z */
+  size_t nx,          /* box size along x */
+  size_t ny,          /* box size along y */
+  size_t nz           /* box size along z */
+);
+
+/* reduce decompressed values block by block without storing them */
+size_t                /* cumulative number of bytes of compressed storage */
+zfp_reduce(
+  zfp_stream* stream,     /* compressed stream */
+  const zfp_field* field, /* field metadata (data pointer is not used) */
+  zfp_reduce_op op,       /* reduction to compute */
+  double* result          /* reduced value */
+);
+
+/* dot product of two compressed fields with the same metadata */
+zfp_bool              /* true upon success */
+zfp_dot(
+  zfp_stream* a,          /* compressed stream of first field */
+  zfp_stream* b,          /* compressed stream of second field */
+  const zfp_field* field, /* field metadata (data pointer is not used) */
+  double* result          /* dot product */
+);
+
+/* compress contiguous block with given raster index in place (fixed rate only) */
+uint                      /* number of bits of compressed storage */
+zfp_encode_block_at(
+  zfp_stream* stream,     /* compressed stream positioned at start of field */
+  const zfp_field* field, /* field metadata */
+  size_t block,           /* block index in raster order */
+  const void* data        /* contiguous block of 4^d values */
+);
+
+/* decompress contiguous block with given raster index */
+uint                      /* number of bits of compressed storage */
+zfp_decode_block_at(
+  zfp_stream* stream,     /* compressed stream positioned at start of field */
+  const zfp_field* field, /* field metadata */
+  size_t block,           /* block index in raster order */
+  void* data              /* contiguous block of 4^d values */
+);
+
+/* evaluate field at scattered points, decoding each block touched once */
+zfp_bool                  /* true upon success */
+zfp_sample(
+  zfp_stream* stream,     /* compressed stream positioned at start of field */
+  const zfp_field* field, /* field metadata (data pointer is not used) */
+  const double* points,   /* n points of one coordinate per dimension, x first */
+  size_t n,               /* number of points */
+  void* values,           /* n values of field scalar type */
+  zfp_bool interpolate    /* multilinear interpolation (else nearest grid point) */
+);
+
+/* decompress stream held at start of field storage into that storage */
+size_t               /* cumulative number of bytes of compressed storage */
+zfp_decompress_inplace(
+  zfp_stream* stream, /* stream opened on field storage with compressed size */
+  zfp_field* field    /* field metadata */
+);
+
+/* begin decompressing 3D field one slab of z planes at a time */
+void
+zfp_decompress_begin(
+  zfp_stream* stream /* compressed stream */
+);
+
+/* decompress next slab, whose z extent is a multiple of four unless last */
+zfp_bool              /* true upon success */
+zfp_decompress_slab(
+  zfp_stream* stream, /* compressed stream */
+  zfp_field* slab     /* 3D field metadata for slab */
+);
+
+/* finish decompressing field one slab at a time */
+size_t               /* cumulative number of bytes of compressed storage */
+zfp_decompress_end(
+  zfp_stream* stream /* compressed stream */
+);
+
+/* queue compression on device stream or thread pool (nonzero return value upon success) */
+size_t                   /* cumulative number of bytes of compressed storage */
+zfp_compress_async(
+  zfp_stream* stream,    /* compressed stream */
+  const zfp_field* field /* field metadata */
+);
+
+/* queue decompression on device stream or thread pool (nonzero return value upon success) */
+size_t                /* cumulative number of bytes of compressed storage */
+zfp_decompress_async(
+  zfp_stream* stream, /* compressed stream */
+  zfp_field* field    /* field metadata */
+);
+
+/* decompress 2D/3D field into CUDA or HIP surface object (nonzero return value upon success) */
+size_t                   /* cumulative number of bytes of compressed storage */
+zfp_decompress_surface(
+  zfp_stream* stream,     /* compressed stream */
+  const zfp_field* field, /* field type and dimensions (data ignored) */
+  uint64 surface          /* cudaSurfaceObject_t or hipSurfaceObject_t */
+);
+
+/* decompress listed blocks into consecutive bricks or strided field (nonzero return value upon success) */
+size_t                 /* cumulative number of bytes of compressed storage */
+zfp_decompress_blocks(
+  zfp_stream* stream,  /* compressed stream */
+  zfp_field* field,    /* field metadata (data ignored when bricks are given) */
+  const size_t* index, /* raster-order indices of blocks to decompress */
+  size_t count,        /* number of blocks to decompress */
+  void* bricks         /* count blocks of 4^d values each (or NULL) */
+);
+
+/* compress fields back to back, each beginning on a word boundary */
+size_t                          /* cumulative number of bytes of compressed storage */
+zfp_compress_batch(
+  zfp_stream* stream,             /* compressed stream */
+  const zfp_field* const* fields, /* fields to compress */
+  size_t n,                       /* number of fields */
+  size_t* offsets                 /* n + 1 byte offsets of fields in stream (or NULL) */
+);
+
+/* decompress fields previously compressed with zfp_compress_batch */
+size_t                       /* cumulative number of bytes of compressed storage */
+zfp_decompress_batch(
+  zfp_stream* stream,        /* compressed stream */
+  zfp_field* const* fields,  /* fields to decompress */
+  size_t n,                  /* number of fields */
+  const size_t* offsets      /* n + 1 byte offsets of fields in stream (or NULL) */
+);
+
+/* truncate fixed-rate stream to lower rate without decompression */
+size_t                    /* cumulative number of bytes of compressed storage */
+zfp_transcode(
+  zfp_stream* dst,        /* destination stream with lower fixed rate */
+  zfp_stream* src,        /* source stream in fixed-rate mode */
+  const zfp_field* field  /* field metadata */
+);
+
+/* number of precision layers of progressive stream (zero if unsupported) */
+uint                       /* number of layers */
+zfp_stream_layers(
+  const zfp_stream* stream /* compressed stream */
+);
+
+/* number of bytes holding the first given number of precision layers */
+size_t                      /* byte size of layers (zero if invalid) */
+zfp_stream_layer_size(
+  const zfp_stream* stream, /* compressed stream */
+  const zfp_field* field,   /* field metadata */
+  uint layers               /* number of leading layers */
+);
+
+/* compress field into interleaved precision layers (requires BIT_STREAM_STRIDED) */
+size_t                   /* cumulative number of bytes of compressed storage */
+zfp_compress_progressive(
+  zfp_stream* stream,    /* compressed stream */
+  const zfp_field* field /* field metadata */
+);
+
+/* decompress field from its leading precision layers */
+size_t                /* cumulative number of bytes of compressed storage read */
+zfp_decompress_progressive(
+  zfp_stream* stream, /* compressed stream */
+  zfp_field* field,   /* field metadata */
+  uint layers         /* number of leading layers to decode */
+);
+
+/* compress field to several streams, e.g., at different rates, in one pass */
+size_t                       /* cumulative number of bytes of compressed storage */
+zfp_compress_multi(
+  zfp_stream* const* streams, /* compressed streams, one per target */
+  size_t n,                  /* number of streams */
+  const zfp_field* field     /* field metadata */
+);
+
+/* compress field into chunks of blocks of fixed size, varying block size within */
+size_t                    /* cumulative number of bytes of compressed storage */
+zfp_compress_chunk_rate(
+  zfp_stream* stream,     /* compressed stream in fixed-rate mode */
+  const zfp_field* field, /* field metadata */
+  uint chunk              /* number of blocks per chunk */
+);
+
+/* decompress field previously compressed with zfp_compress_chunk_rate */
+size_t                /* cumulative number of bytes of compressed storage read */
+zfp_decompress_chunk_rate(
+  zfp_stream* stream, /* compressed stream in fixed-rate mode */
+  zfp_field* field,   /* field metadata */
+  uint chunk          /* number of blocks per chunk */
+);
+
+/* byte size of largest frame of given number of blocks */
+size_t                     /* maximum frame size in bytes (zero if invalid) */
+zfp_frame_maximum_size(
+  const zfp_stream* stream, /* compressed stream */
+  const zfp_field* field,   /* field metadata */
+  uint blocks               /* number of blocks per frame */
+);
+
+/* compress field into self-contained frames passed to sink as completed */
+size_t                    /* cumulative number of bytes of frames emitted */
+zfp_compress_framed(
+  const zfp_stream* stream, /* compression mode (bit stream is not used) */
+  const zfp_field* field,   /* field metadata */
+  uint blocks,              /* number of blocks per frame */
+  zfp_frame_sink sink,      /* consumer of frames */
+  void* context             /* user data passed to sink */
+);
+
+/* decompress one frame emitted by zfp_compress_framed, in any order */
+size_t                    /* number of blocks decoded (zero upon failure) */
+zfp_decompress_frame(
+  const zfp_stream* stream, /* compression mode (bit stream is not used) */
+  zfp_field* field,         /* field metadata */
+  const void* frame,        /* frame data */
+  size_t size,              /* frame size in bytes */
+  uint* sequence            /* frame sequence number (or NULL) */
+);
+
+/* byte size of sparse stream with given number of active blocks */
+size_t                     /* maximum stream size in bytes (zero if invalid) */
+zfp_sparse_maximum_size(
+  const zfp_stream* stream, /* compressed stream */
+  const zfp_field* field,   /* bounding box metadata */
+  size_t count              /* number of active blocks */
+);
+
+/* compress active blocks of field or consecutive bricks, preceded by bitmap */
+size_t                    /* cumulative number of bytes of compressed storage */
+zfp_compress_sparse(
+  zfp_stream* stream,     /* compressed stream */
+  const zfp_field* field, /* bounding box metadata (data ignored when bricks are given) */
+  const uint8* active,    /* one byte per block in raster order, nonzero if active */
+  const void* bricks      /* 4^d values per active block in raster order (or NULL) */
+);
+
+/* read bitmap of active blocks at start of sparse stream without advancing */
+size_t                    /* number of active blocks */
+zfp_sparse_map(
+  zfp_stream* stream,     /* compressed stream */
+  const zfp_field* field, /* bounding box metadata */
+  uint8* active           /* one byte per block set to zero or one (or NULL) */
+);
+
+/* decompress active blocks into consecutive bricks or scattered into field */
+size_t                /* cumulative number of bytes of compressed storage */
+zfp_decompress_sparse(
+  zfp_stream* stream, /* compressed stream */
+  zfp_field* field,   /* bounding box metadata (data ignored when bricks are given) */
+  uint8* active,      /* one byte per block set to zero or one (or NULL) */
+  void* bricks        /* 4^d values per active block in raster order (or NULL) */
+);
+
+/* wait for queued device or thread-pool work to complete */
+zfp_bool             /* true upon success */
+zfp_stream_synchronize(
+  zfp_stream* stream /* compressed stream */
+);
+
+/* whether queued device or thread-pool work has completed, without waiting */
+zfp_bool                   /* true if no work is pending */
+zfp_stream_query(
+  const zfp_stream* stream /* compressed stream */
+);
+
+/* prepare fixed-rate CUDA (de)compression of fields with given metadata */
+zfp_cuda_plan*            /* plan or NULL if unsupported */
+zfp_cuda_plan_create(
+  const zfp_stream* stream, /* fixed-rate parameters and CUDA policy */
+  const zfp_field* field    /* field type, dimensions, and strides (data ignored) */
+);
+
+/* deallocate plan */
+void
+zfp_cuda_plan_free(
+  zfp_cuda_plan* plan /* plan to deallocate (may be NULL) */
+);
+
+/* queue compression of device array into device buffer */
+size_t                      /* byte size of compressed stream */
+zfp_cuda_plan_compress(
+  const zfp_cuda_plan* plan, /* prepared plan */
+  void* buffer,              /* device buffer of zfp_stream_maximum_size() bytes */
+  const void* data           /* device array laid out as planned */
+);
+
+/* queue decompression of device buffer into device array */
+size_t                      /* byte size of compressed stream */
+zfp_cuda_plan_decompress(
+  const zfp_cuda_plan* plan, /* prepared plan */
+  void* data,                /* device array laid out as planned */
+  const void* buffer         /* device buffer written by zfp_cuda_plan_compress() */
+);
+
+/* write compressed stream held in host or device memory to file */
+size_t                /* number of bytes written or zero upon failure */
+zfp_cuda_write_file(
+  const char* path,   /* file to create or overwrite */
+  const void* buffer, /* compressed stream in host or device memory */
+  size_t size         /* byte size of compressed stream */
+);
+
+/* read compressed file into host or device memory */
+size_t                /* number of bytes read or zero upon failure */
+zfp_cuda_read_file(
+  const char* path,   /* compressed file */
+  void* buffer,       /* host or device buffer */
+  size_t capacity     /* byte capacity of buffer */
+);
+
 /* write compression parameters and field metadata (optional) */
 size_t                    /* number of bits written or zero upon failure */
 zfp_write_header(
@@ -541,6 +1727,403 @@ zfp_read_header(
   uint mask           /* information to read */
 );
 
+/* write chunk offset index as sequence of fixed-width offset deltas */
+size_t                    /* number of bits written or zero upon failure */
+zfp_write_index(
+  zfp_stream* stream,     /* compressed stream */
+  const zfp_index* index  /* chunk offset index */
+);
+
+/* read chunk offset index previously written by zfp_write_index */
+size_t                /* number of bits read or zero upon failure */
+zfp_read_index(
+  zfp_stream* stream, /* compressed stream */
+  zfp_index* index    /* chunk offset index */
+);
+
+/* rebuild chunk offset index of compressed field by skipping over its blocks */
+size_t                    /* number of compressed bits or zero upon failure */
+zfp_build_index(
+  zfp_stream* stream,     /* compressed stream positioned at field */
+  const zfp_field* field, /* field metadata */
+  zfp_index* index,       /* chunk offset index to populate */
+  size_t granularity      /* number of blocks per chunk */
+);
+
+/* high-level API: container of named fields ------------------------------ */
+
+/* create empty container whose fields begin on given byte boundary */
+zfp_container*      /* container or NULL upon failure */
+zfp_container_create(
+  size_t alignment  /* power-of-two alignment in bytes (e.g., page size) */
+);
+
+/* compress field into container using stream's mode and execution policy */
+zfp_bool                  /* true upon success */
+zfp_container_add(
+  zfp_container* c,       /* container being written */
+  const char* name,       /* unique field name */
+  zfp_stream* stream,     /* compressed stream (bit stream is not used) */
+  const zfp_field* field  /* field to compress */
+);
+
+/* append footer index; no fields may be added afterwards */
+const void*         /* container data or NULL upon failure */
+zfp_container_finish(
+  zfp_container* c, /* container being written */
+  size_t* size      /* byte size of container data (may be NULL) */
+);
+
+/* open container in memory (e.g., mapped file) for reading without copying */
+zfp_container*      /* container or NULL if data is not a valid container */
+zfp_container_open(
+  const void* data, /* container data, which must outlive container */
+  size_t size       /* byte size of container data */
+);
+
+/* deallocate container */
+void
+zfp_container_close(
+  zfp_container* c /* container to deallocate (may be NULL) */
+);
+
+/* number of fields in container */
+size_t                    /* number of fields */
+zfp_container_fields(
+  const zfp_container* c  /* container */
+);
+
+/* position of field with given name */
+size_t                    /* field number or zfp_container_fields(c) if absent */
+zfp_container_find(
+  const zfp_container* c, /* container */
+  const char* name        /* field name */
+);
+
+/* name of field */
+const char*               /* field name or NULL if i is out of range */
+zfp_container_name(
+  const zfp_container* c, /* container */
+  size_t i                /* field number */
+);
+
+/* set scalar type and dimensions of field */
+zfp_bool                  /* true upon success */
+zfp_container_field(
+  const zfp_container* c, /* container */
+  size_t i,               /* field number */
+  zfp_field* field        /* field whose type and dimensions to set */
+);
+
+/* compression parameters of field (see zfp_stream_mode) */
+uint64                    /* compact encoding of parameters */
+zfp_container_mode(
+  const zfp_container* c, /* container */
+  size_t i                /* field number */
+);
+
+/* lossless back end applied to chunks of field */
+zfp_entropy               /* entropy coder */
+zfp_container_entropy(
+  const zfp_container* c, /* container */
+  size_t i                /* field number */
+);
+
+/* byte size of compressed field */
+size_t                    /* number of bytes */
+zfp_container_size(
+  const zfp_container* c, /* container */
+  size_t i                /* field number */
+);
+
+/* number of independently decodable chunks of field */
+size_t                    /* number of chunks */
+zfp_container_chunks(
+  const zfp_container* c, /* container */
+  size_t i                /* field number */
+);
+
+/* decompress entire field using stream's execution policy */
+size_t                    /* number of bytes of compressed storage or zero upon failure */
+zfp_container_decompress(
+  const zfp_container* c, /* container */
+  size_t i,               /* field number */
+  zfp_stream* stream,     /* stream whose mode is set to that of field */
+  zfp_field* field        /* field with matching type and dimensions */
+);
+
+/* decompress box of up to 3D field at (x0, y0, z0) of size nx * ny * nz */
+size_t                    /* number of bytes of compressed storage or zero upon failure */
+zfp_container_decompress_subset(
+  const zfp_container* c, /* container */
+  size_t i,               /* field number */
+  zfp_stream* stream,     /* stream whose mode is set to that of field */
+  zfp_field* field,       /* full-resolution field metadata and box array */
+  size_t x0,              /* box origin along x */
+  size_t y0,              /* box origin along y */
+  size_t z0,              /* box origin along z */
+  size_t nx,              /* box size along x */
+  size_t ny,              /* box size along y */
+  size_t nz               /* box size along z */
+);
+
+/* high-level API: shared configuration ------------------------------------ */
+
+/* snapshot stream's parameters, execution policy, and ISA for concurrent use */
+zfp_config*                /* configuration or NULL upon failure */
+zfp_config_create(
+  const zfp_stream* stream /* stream with compression parameters */
+);
+
+/* deallocate configuration */
+void
+zfp_config_free(
+  zfp_config* config /* configuration to deallocate (may be NULL) */
+);
+
+/* conservative buffer size needed to compress field */
+size_t                      /* maximum number of bytes or zero upon failure */
+zfp_config_maximum_size(
+  const zfp_config* config, /* shared configuration */
+  const zfp_field* field    /* field to compress */
+);
+
+/* initialize caller-owned per-call stream from shared configuration */
+void
+zfp_stream_init_config(
+  zfp_stream* stream,       /* compressed stream to initialize */
+  const zfp_config* config, /* shared configuration */
+  bitstream* bs             /* bit stream to read from and write to (may be NULL) */
+);
+
+/* compress field without header; may be called concurrently */
+size_t                      /* number of bytes written or zero upon failure */
+zfp_config_compress(
+  const zfp_config* config, /* shared configuration */
+  const zfp_field* field,   /* field to compress */
+  void* buffer,             /* word-aligned output buffer */
+  size_t capacity           /* byte size of buffer (at least maximum size) */
+);
+
+/* decompress field compressed by zfp_config_compress; may be called concurrently */
+size_t                      /* number of bytes read or zero upon failure */
+zfp_config_decompress(
+  const zfp_config* config, /* shared configuration */
+  zfp_field* field,         /* field to decompress to */
+  const void* buffer,       /* word-aligned compressed stream */
+  size_t size               /* byte size of compressed stream */
+);
+
+/* high-level API: chunk codec --------------------------------------------- */
+
+/* prepare codec for chunks of given type using stream's mode and ISA */
+zfp_chunk_codec*            /* codec or NULL upon failure */
+zfp_chunk_codec_create(
+  const zfp_stream* stream, /* stream with compression parameters */
+  zfp_type type             /* scalar type of chunks */
+);
+
+/* deallocate codec */
+void
+zfp_chunk_codec_free(
+  zfp_chunk_codec* codec /* codec to deallocate (may be NULL) */
+);
+
+/* conservative buffer size needed to encode chunk */
+size_t                          /* maximum number of bytes or zero upon failure */
+zfp_chunk_codec_maximum_size(
+  const zfp_chunk_codec* codec, /* prepared codec */
+  uint dims,                    /* number of dimensions (1-4) */
+  const size_t* shape           /* chunk size per dimension, x first */
+);
+
+/* encode chunk with header; codec must not be used concurrently */
+size_t                      /* number of bytes written or zero upon failure */
+zfp_encode_chunk(
+  zfp_chunk_codec* codec,   /* prepared codec */
+  const void* in,           /* chunk values */
+  uint dims,                /* number of dimensions (1-4) */
+  const size_t* shape,      /* chunk size per dimension, x first */
+  const ptrdiff_t* strides, /* scalar strides per dimension (or NULL) */
+  void* out,                /* word-aligned output buffer */
+  size_t capacity           /* byte size of out (at least maximum size) */
+);
+
+/* decode chunk encoded by zfp_encode_chunk; codec must not be used concurrently */
+size_t                     /* number of bytes read or zero upon failure */
+zfp_decode_chunk(
+  zfp_chunk_codec* codec,  /* prepared codec */
+  const void* in,          /* word-aligned encoded chunk */
+  size_t size,             /* byte size of encoded chunk */
+  void* out,               /* chunk values */
+  uint dims,               /* number of dimensions (1-4) */
+  const size_t* shape,     /* chunk size per dimension, x first */
+  const ptrdiff_t* strides /* scalar strides per dimension (or NULL) */
+);
+
+/* high-level API: temporal delta compression ------------------------------ */
+
+/* create codec for time series of fields with type and dimensions of field */
+zfp_temporal*           /* codec or NULL upon failure */
+zfp_temporal_create(
+  const zfp_field* field, /* type and dimensions of each step (data ignored) */
+  uint interval           /* steps between keyframes (zero for first only) */
+);
+
+/* deallocate codec */
+void
+zfp_temporal_free(
+  zfp_temporal* codec /* codec to deallocate (may be NULL) */
+);
+
+/* true if next step will be compressed as a keyframe */
+zfp_bool                     /* true if keyframe */
+zfp_temporal_keyframe(
+  const zfp_temporal* codec  /* time series codec */
+);
+
+/* discard reference so that next step is a keyframe */
+void
+zfp_temporal_reset(
+  zfp_temporal* codec /* time series codec */
+);
+
+/* predict next step from given field instead of previous step */
+zfp_bool                     /* true upon success */
+zfp_temporal_set_reference(
+  zfp_temporal* codec,       /* time series codec */
+  const zfp_field* reference /* reference known to encoder and decoder */
+);
+
+/* compress next step as keyframe or as residual against reference */
+size_t                   /* cumulative byte size of stream or zero upon failure */
+zfp_temporal_compress(
+  zfp_temporal* codec,   /* time series codec */
+  zfp_stream* stream,    /* compressed stream and parameters */
+  const zfp_field* field /* field to compress */
+);
+
+/* decompress next step compressed by zfp_temporal_compress */
+size_t                 /* cumulative byte size of stream or zero upon failure */
+zfp_temporal_decompress(
+  zfp_temporal* codec, /* time series codec */
+  zfp_stream* stream,  /* compressed stream and parameters */
+  zfp_field* field     /* field to decompress */
+);
+
+/* high-level API: incremental checkpoints -------------------------------- */
+
+/* create codec for checkpoints of fields with type and dimensions of field */
+zfp_checkpoint*         /* codec or NULL upon failure */
+zfp_checkpoint_create(
+  const zfp_field* field /* type and dimensions of each checkpoint (data ignored) */
+);
+
+/* deallocate codec */
+void
+zfp_checkpoint_free(
+  zfp_checkpoint* codec /* codec to deallocate (may be NULL) */
+);
+
+/* discard block hashes so that next checkpoint is written in full */
+void
+zfp_checkpoint_reset(
+  zfp_checkpoint* codec /* checkpoint codec */
+);
+
+/* number of blocks stored by last checkpoint written or read */
+size_t                        /* number of blocks */
+zfp_checkpoint_blocks(
+  const zfp_checkpoint* codec /* checkpoint codec */
+);
+
+/* compress field in full or as blocks changed since previous checkpoint */
+size_t                   /* cumulative byte size of stream or zero upon failure */
+zfp_checkpoint_write(
+  zfp_checkpoint* codec, /* checkpoint codec */
+  zfp_stream* stream,    /* compressed stream and parameters */
+  const zfp_field* field /* field to compress */
+);
+
+/* decompress checkpoint, overlaying changed blocks onto field */
+size_t                  /* cumulative byte size of stream or zero upon failure */
+zfp_checkpoint_read(
+  zfp_checkpoint* codec, /* checkpoint codec */
+  zfp_stream* stream,    /* compressed stream and parameters */
+  zfp_field* field       /* field holding previous checkpoint to update */
+);
+
+/* high-level API: cross-field prediction ---------------------------------- */
+
+/* compress field as residual against primary field known to the decoder */
+size_t                     /* cumulative byte size of stream or zero upon failure */
+zfp_compress_predicted(
+  zfp_stream* stream,        /* compressed stream and parameters */
+  const zfp_field* field,    /* field to compress */
+  const zfp_field* primary,  /* decoded primary field of same type and dimensions */
+  zfp_predictor predictor    /* how field is predicted from primary */
+);
+
+/* decompress field compressed by zfp_compress_predicted */
+size_t                     /* cumulative byte size of stream or zero upon failure */
+zfp_decompress_predicted(
+  zfp_stream* stream,        /* compressed stream and parameters */
+  zfp_field* field,          /* field to decompress */
+  const zfp_field* primary,  /* primary field passed to zfp_compress_predicted */
+  zfp_predictor predictor    /* predictor passed to zfp_compress_predicted */
+);
+
+/* high-level API: spatial reordering -------------------------------------- */
+
+/* permutation that sorts points by Morton (Z-order) key of their coordinates */
+zfp_bool                        /* true upon success */
+zfp_morton_order(
+  const zfp_stream* stream,     /* execution policy used for sorting */
+  size_t* perm,                 /* output: point perm[i] goes in position i */
+  const zfp_field* const* coord, /* 1D float or double field per coordinate */
+  uint dims                     /* number of coordinates (1-4) */
+);
+
+/* gather values into Morton order: dst[i] = src[perm[i]] */
+zfp_bool               /* true upon success */
+zfp_field_permute(
+  zfp_field* dst,        /* reordered 1D field */
+  const zfp_field* src,  /* 1D field of same type and size as dst */
+  const size_t* perm     /* permutation from zfp_morton_order */
+);
+
+/* scatter values back into original order: dst[perm[i]] = src[i] */
+zfp_bool               /* true upon success */
+zfp_field_unpermute(
+  zfp_field* dst,        /* field in original order */
+  const zfp_field* src,  /* reordered 1D field of same type and size as dst */
+  const size_t* perm     /* permutation from zfp_morton_order */
+);
+
+/* high-level API: 8-bit images -------------------------------------------- */
+
+/* compress interleaved 8-bit gray, RGB, or RGBA image in a single pass */
+size_t                 /* cumulative number of bytes of compressed storage */
+zfp_compress_image(
+  zfp_stream* stream,  /* compressed stream */
+  const uchar* pixels, /* nx * ny pixels of interleaved channels */
+  size_t nx,           /* image width */
+  size_t ny,           /* image height */
+  uint channels,       /* channels per pixel (1-4); RGB in first three */
+  zfp_bool subsample   /* whether to subsample chroma of color images */
+);
+
+/* decompress interleaved 8-bit image */
+size_t                 /* cumulative number of bytes of compressed storage */
+zfp_decompress_image(
+  zfp_stream* stream,  /* compressed stream */
+  uchar* pixels,       /* nx * ny pixels of interleaved channels */
+  size_t nx,           /* image width */
+  size_t ny,           /* image height */
+  uint channels,       /* channels per pixel (1-4); RGB in first three */
+  zfp_bool subsample   /* whether chroma was subsampled */
+);
+
 /* low-level API: stream manipulation -------------------------------------- */
 
 /* flush bit stream--must be called after last encode call or between seeks */
@@ -631,6 +2214,52 @@ uint zfp_encode_partial_block_strided_int64_4(zfp_stream* stream, const int64* p
 uint zfp_encode_partial_block_strided_float_4(zfp_stream* stream, const float* p, uint nx, uint ny, uint nz, uint nw, int sx, int sy, int sz, int sw);
 uint zfp_encode_partial_block_strided_double_4(zfp_stream* stream, const double* p, uint nx, uint ny, uint nz, uint nw, int sx, int sy, int sz, int sw);
 
+/*
+The functions below compress n contiguous blocks stored one after another, as
+if by calling the corresponding zfp_encode_block function on each in turn, and
+produce the same compressed stream.  Up to 16 blocks at a time are decorrelated
+together so that the transform vectorizes across blocks.  The functions return
+the total number of bits of compressed storage.
+*/
+
+/* encode n contiguous blocks of 4^d values each */
+size_t zfp_encode_blocks_int32_1(zfp_stream* stream, size_t n, const int32* blocks);
+size_t zfp_encode_blocks_int64_1(zfp_stream* stream, size_t n, const int64* blocks);
+size_t zfp_encode_blocks_float_1(zfp_stream* stream, size_t n, const float* blocks);
+size_t zfp_encode_blocks_double_1(zfp_stream* stream, size_t n, const double* blocks);
+size_t zfp_encode_blocks_int32_2(zfp_stream* stream, size_t n, const int32* blocks);
+size_t zfp_encode_blocks_int64_2(zfp_stream* stream, size_t n, const int64* blocks);
+size_t zfp_encode_blocks_float_2(zfp_stream* stream, size_t n, const float* blocks);
+size_t zfp_encode_blocks_double_2(zfp_stream* stream, size_t n, const double* blocks);
+size_t zfp_encode_blocks_int32_3(zfp_stream* stream, size_t n, const int32* blocks);
+size_t zfp_encode_blocks_int64_3(zfp_stream* stream, size_t n, const int64* blocks);
+size_t zfp_encode_blocks_float_3(zfp_stream* stream, size_t n, const float* blocks);
+size_t zfp_encode_blocks_double_3(zfp_stream* stream, size_t n, const double* blocks);
+size_t zfp_encode_blocks_int32_4(zfp_stream* stream, size_t n, const int32* blocks);
+size_t zfp_encode_blocks_int64_4(zfp_stream* stream, size_t n, const int64* blocks);
+size_t zfp_encode_blocks_float_4(zfp_stream* stream, size_t n, const float* blocks);
+size_t zfp_encode_blocks_double_4(zfp_stream* stream, size_t n, const double* blocks);
+
+/* encode block of 4^d transform coefficients with common exponent (lossy modes only) */
+uint zfp_encode_block_coefficients_float_1(zfp_stream* stream, const int32* coeff, int emax);
+uint zfp_encode_block_coefficients_double_1(zfp_stream* stream, const int64* coeff, int emax);
+uint zfp_encode_block_coefficients_float_2(zfp_stream* stream, const int32* coeff, int emax);
+uint zfp_encode_block_coefficients_double_2(zfp_stream* stream, const int64* coeff, int emax);
+uint zfp_encode_block_coefficients_float_3(zfp_stream* stream, const int32* coeff, int emax);
+uint zfp_encode_block_coefficients_double_3(zfp_stream* stream, const int64* coeff, int emax);
+uint zfp_encode_block_coefficients_float_4(zfp_stream* stream, const int32* coeff, int emax);
+uint zfp_encode_block_coefficients_double_4(zfp_stream* stream, const int64* coeff, int emax);
+
+/* encode contiguous block of 4^d values to each of n streams (total bits returned) */
+size_t zfp_encode_block_multi_float_1(zfp_stream* const* streams, uint n, const float* block);
+size_t zfp_encode_block_multi_double_1(zfp_stream* const* streams, uint n, const double* block);
+size_t zfp_encode_block_multi_float_2(zfp_stream* const* streams, uint n, const float* block);
+size_t zfp_encode_block_multi_double_2(zfp_stream* const* streams, uint n, const double* block);
+size_t zfp_encode_block_multi_float_3(zfp_stream* const* streams, uint n, const float* block);
+size_t zfp_encode_block_multi_double_3(zfp_stream* const* streams, uint n, const double* block);
+size_t zfp_encode_block_multi_float_4(zfp_stream* const* streams, uint n, const float* block);
+size_t zfp_encode_block_multi_double_4(zfp_stream* const* streams, uint n, const double* block);
+
 /* low-level API: decoder -------------------------------------------------- */
 
 /*
@@ -655,6 +2284,12 @@ uint zfp_decode_partial_block_strided_int64_1(zfp_stream* stream, int64* p, uint
 uint zfp_decode_partial_block_strided_float_1(zfp_stream* stream, float* p, uint nx, int sx);
 uint zfp_decode_partial_block_strided_double_1(zfp_stream* stream, double* p, uint nx, int sx);
 
+/* decode 1D block to 2^level sub-block averages, 0 <= level <= 2 */
+uint zfp_decode_block_lod_int32_1(zfp_stream* stream, int32* block, uint level);
+uint zfp_decode_block_lod_int64_1(zfp_stream* stream, int64* block, uint level);
+uint zfp_decode_block_lod_float_1(zfp_stream* stream, float* block, uint level);
+uint zfp_decode_block_lod_double_1(zfp_stream* stream, double* block, uint level);
+
 /* decode 2D contiguous block of 4x4 values */
 uint zfp_decode_block_int32_2(zfp_stream* stream, int32* block);
 uint zfp_decode_block_int64_2(zfp_stream* stream, int64* block);
@@ -671,6 +2306,12 @@ uint zfp_decode_partial_block_strided_int64_2(zfp_stream* stream, int64* p, uint
 uint zfp_decode_partial_block_strided_float_2(zfp_stream* stream, float* p, uint nx, uint ny, int sx, int sy);
 uint zfp_decode_partial_block_strided_double_2(zfp_stream* stream, double* p, uint nx, uint ny, int sx, int sy);
 
+/* decode 2D block to (2^level)^2 sub-block averages, 0 <= level <= 2 */
+uint zfp_decode_block_lod_int32_2(zfp_stream* stream, int32* block, uint level);
+uint zfp_decode_block_lod_int64_2(zfp_stream* stream, int64* block, uint level);
+uint zfp_decode_block_lod_float_2(zfp_stream* stream, float* block, uint level);
+uint zfp_decode_block_lod_double_2(zfp_stream* stream, double* block, uint level);
+
 /* decode 3D contiguous block of 4x4x4 values */
 uint zfp_decode_block_int32_3(zfp_stream* stream, int32* block);
 uint zfp_decode_block_int64_3(zfp_stream* stream, int64* block);
@@ -687,6 +2328,12 @@ uint zfp_decode_partial_block_strided_int64_3(zfp_stream* stream, int64* p, uint
 uint zfp_decode_partial_block_strided_float_3(zfp_stream* stream, float* p, uint nx, uint ny, uint nz, int sx, int sy, int sz);
 uint zfp_decode_partial_block_strided_double_3(zfp_stream* stream, double* p, uint nx, uint ny, uint nz, int sx, int sy, int sz);
 
+/* decode 3D block to (2^level)^3 sub-block averages, 0 <= level <= 2 */
+uint zfp_decode_block_lod_int32_3(zfp_stream* stream, int32* block, uint level);
+uint zfp_decode_block_lod_int64_3(zfp_stream* stream, int64* block, uint level);
+uint zfp_decode_block_lod_float_3(zfp_stream* stream, float* block, uint level);
+uint zfp_decode_block_lod_double_3(zfp_stream* stream, double* block, uint level);
+
 /* decode 4D contiguous block of 4x4x4x4 values */
 uint zfp_decode_block_int32_4(zfp_stream* stream, int32* block);
 uint zfp_decode_block_int64_4(zfp_stream* stream, int64* block);
@@ -703,6 +2350,40 @@ uint zfp_decode_partial_block_strided_int64_4(zfp_stream* stream, int64* p, uint
 uint zfp_decode_partial_block_strided_float_4(zfp_stream* stream, float* p, uint nx, uint ny, uint nz, uint nw, int sx, int sy, int sz, int sw);
 uint zfp_decode_partial_block_strided_double_4(zfp_stream* stream, double* p, uint nx, uint ny, uint nz, uint nw, int sx, int sy, int sz, int sw);
 
+/* decode 4D block to (2^level)^4 sub-block averages, 0 <= level <= 2 */
+uint zfp_decode_block_lod_int32_4(zfp_stream* stream, int32* block, uint level);
+uint zfp_decode_block_lod_int64_4(zfp_stream* stream, int64* block, uint level);
+uint zfp_decode_block_lod_float_4(zfp_stream* stream, float* block, uint level);
+uint zfp_decode_block_lod_double_4(zfp_stream* stream, double* block, uint level);
+
+/* decode n contiguous blocks of 4^d values each */
+size_t zfp_decode_blocks_int32_1(zfp_stream* stream, size_t n, int32* blocks);
+size_t zfp_decode_blocks_int64_1(zfp_stream* stream, size_t n, int64* blocks);
+size_t zfp_decode_blocks_float_1(zfp_stream* stream, size_t n, float* blocks);
+size_t zfp_decode_blocks_double_1(zfp_stream* stream, size_t n, double* blocks);
+size_t zfp_decode_blocks_int32_2(zfp_stream* stream, size_t n, int32* blocks);
+size_t zfp_decode_blocks_int64_2(zfp_stream* stream, size_t n, int64* blocks);
+size_t zfp_decode_blocks_float_2(zfp_stream* stream, size_t n, float* blocks);
+size_t zfp_decode_blocks_double_2(zfp_stream* stream, size_t n, double* blocks);
+size_t zfp_decode_blocks_int32_3(zfp_stream* stream, size_t n, int32* blocks);
+size_t zfp_decode_blocks_int64_3(zfp_stream* stream, size_t n, int64* blocks);
+size_t zfp_decode_blocks_float_3(zfp_stream* stream, size_t n, float* blocks);
+size_t zfp_decode_blocks_double_3(zfp_stream* stream, size_t n, double* blocks);
+size_t zfp_decode_blocks_int32_4(zfp_stream* stream, size_t n, int32* blocks);
+size_t zfp_decode_blocks_int64_4(zfp_stream* stream, size_t n, int64* blocks);
+size_t zfp_decode_blocks_float_4(zfp_stream* stream, size_t n, float* blocks);
+size_t zfp_decode_blocks_double_4(zfp_stream* stream, size_t n, double* blocks);
+
+/* decode block to 4^d transform coefficients and common exponent (lossy modes only) */
+uint zfp_decode_block_coefficients_float_1(zfp_stream* stream, int32* coeff, int* emax);
+uint zfp_decode_block_coefficients_double_1(zfp_stream* stream, int64* coeff, int* emax);
+uint zfp_decode_block_coefficients_float_2(zfp_stream* stream, int32* coeff, int* emax);
+uint zfp_decode_block_coefficients_double_2(zfp_stream* stream, int64* coeff, int* emax);
+uint zfp_decode_block_coefficients_float_3(zfp_stream* stream, int32* coeff, int* emax);
+uint zfp_decode_block_coefficients_double_3(zfp_stream* stream, int64* coeff, int* emax);
+uint zfp_decode_block_coefficients_float_4(zfp_stream* stream, int32* coeff, int* emax);
+uint zfp_decode_block_coefficients_double_4(zfp_stream* stream, int64* coeff, int* emax);
+
 /* low-level API: utility functions ---------------------------------------- */
 
 /* convert dims-dimensional contiguous block to 32-bit integer type */
@@ -0,0 +1,84 @@
+/*
+** Copyright (c) 2014-2019, Lawrence Livermore National Security, LLC and
+** other zfp project contributors. See the top-level LICENSE file for details.
+** SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#ifndef ZFP_HALO_H
+#define ZFP_HALO_H
+
+#include <mpi.h>
+#include <cstddef>
+#include <vector>
+
+// ghost-layer exchange of compressed 3D arrays between MPI ranks
+
+namespace zfp {
+namespace mpi {
+namespace internal {
+
+// send compressed blocks of the layer of four values at offset 'from' along
+// dimension d to rank dest, and replace the blocks of the layer at offset
+// 'to' with those received from rank source
+template <class Array>
+inline void
+shift_layer(Array& a, MPI_Comm comm, int d, size_t from, int dest, size_t to, int source, int tag, std::vector<unsigned char>& send, std::vector<unsigned char>& recv)
+{
+  size_t x[3] = { 0, 0, 0 };
+  size_t m[3] = { a.size_x(), a.size_y(), a.size_z() };
+  m[d] = 4;
+
+  // pack layer; block sizes vary in variable-rate modes, so exchange sizes first
+  unsigned long long send_size = 0;
+  if (dest != MPI_PROC_NULL) {
+    x[d] = from;
+    send_size = a.packed_size(x[0], x[1], x[2], m[0], m[1], m[2]);
+    send.resize(send_size);
+    if (send_size)
+      a.pack(&send[0], x[0], x[1], x[2], m[0], m[1], m[2]);
+  }
+  unsigned long long recv_size = 0;
+  MPI_Sendrecv(&send_size, 1, MPI_UNSIGNED_LONG_LONG, dest, tag,
+               &recv_size, 1, MPI_UNSIGNED_LONG_LONG, source, tag,
+               comm, MPI_STATUS_IGNORE);
+  recv.resize(recv_size);
+  MPI_Sendrecv(send_size ? &send[0] : 0, static_cast<int>(send_size), MPI_BYTE, dest, tag,
+               recv_size ? &recv[0] : 0, static_cast<int>(recv_size), MPI_BYTE, source, tag,
+               comm, MPI_STATUS_IGNORE);
+
+  // unpack received blocks into ghost layer
+  if (source != MPI_PROC_NULL && recv_size) {
+    x[d] = to;
+    a.unpack(&recv[0], x[0], x[1], x[2], m[0], m[1], m[2]);
+  }
+}
+
+} // internal
+
+// exchange ghost layers of compressed 3D array a holding this rank's
+// subdomain padded with one block (four values) of ghosts on each side; all
+// array dimensions must be multiples of four and at least twelve, and all
+// ranks must use the same compression mode and parameters; comm is a 3D
+// Cartesian communicator whose dimensions 0, 1, 2 map to x, y, z; blocks are
+// exchanged compressed, without re-encoding, one dimension at a time so that
+// edge and corner ghosts are filled as well
+template <class Array>
+inline void
+exchange_halo(Array& a, MPI_Comm comm)
+{
+  const size_t n[3] = { a.size_x(), a.size_y(), a.size_z() };
+  std::vector<unsigned char> send, recv;
+  for (int d = 0; d < 3; d++) {
+    int lower, upper;
+    MPI_Cart_shift(comm, d, 1, &lower, &upper);
+    // send upper interior layer up and fill lower ghost layer
+    internal::shift_layer(a, comm, d, n[d] - 8, upper, 0, lower, 2 * d + 0, send, recv);
+    // send lower interior layer down and fill upper ghost layer
+    internal::shift_layer(a, comm, d, 4, lower, n[d] - 4, upper, 2 * d + 1, send, recv);
+  }
+}
+
+} // mpi
+} // zfp
+
+#endif
@@ -0,0 +1,34 @@
+/*
+** Copyright (c) 2014-2019, Lawrence Livermore National Security, LLC and
+** other zfp project contributors. See the top-level LICENSE file for details.
+** SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#ifndef ZFP_MPI_H
+#define ZFP_MPI_H
+
+#include <mpi.h>
+#include "zfp.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* compress distributed field collectively into global stream written to file */
+size_t                     /* byte size of global stream or zero upon failure */
+zfp_mpi_compress(
+  zfp_stream* stream,      /* compression parameters and local execution policy */
+  const zfp_field* global, /* type and dimensions of global field (data ignored) */
+  const zfp_field* local,  /* subdomain owned by this rank */
+  const size_t* origin,    /* global index of first local value, x first */
+  MPI_File file,           /* file opened on communicator */
+  MPI_Offset offset,       /* byte offset of global stream in file */
+  zfp_index* index,        /* chunk index of variable-rate stream (or NULL) */
+  MPI_Comm comm            /* communicator over which field is distributed */
+);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
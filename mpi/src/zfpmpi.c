@@ -0,0 +1,319 @@
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include "zfpmpi.h"
+
+/* number of values per block along each dimension */
+#define BLOCK_SIDE 4
+
+/* return true if local subdomain lies within global field and is aligned with its blocks */
+static zfp_bool
+check_subdomain(const zfp_field* global, const zfp_field* local, const size_t* origin)
+{
+  uint dims = zfp_field_dimensionality(global);
+  uint gn[4], ln[4];
+  uint i;
+
+  if (!dims || zfp_field_dimensionality(local) != dims || zfp_field_type(local) != zfp_field_type(global))
+    return zfp_false;
+
+  zfp_field_size(global, gn);
+  zfp_field_size(local, ln);
+  for (i = 0; i < dims; i++) {
+    /* only subdomains on the global boundary may have partial blocks */
+    if (origin[i] % BLOCK_SIDE || origin[i] + ln[i] > gn[i])
+      return zfp_false;
+    if (ln[i] % BLOCK_SIDE && origin[i] + ln[i] != gn[i])
+      return zfp_false;
+  }
+
+  return zfp_true;
+}
+
+/* compress subdomain to buffer without disturbing caller's bit stream or index */
+static zfp_bool
+compress_local(zfp_stream* zfp, bitstream* stream, const zfp_field* local)
+{
+  bitstream* s = zfp_stream_bit_stream(zfp);
+  zfp_index* index = zfp_stream_index(zfp);
+  size_t size;
+
+  zfp_stream_set_bit_stream(zfp, stream);
+  zfp_stream_set_index(zfp, NULL);
+  zfp_stream_rewind(zfp);
+  size = zfp_compress(zfp, local);
+  zfp_stream_set_bit_stream(zfp, s);
+  zfp_stream_set_index(zfp, index);
+
+  return size != 0;
+}
+
+/* fixed-rate word-aligned blocks: write each row of local blocks at its global offset */
+static size_t
+compress_fixed(zfp_stream* zfp, uint maxbits, const zfp_field* global, const zfp_field* local, const size_t* origin, MPI_File file, MPI_Offset offset, MPI_Comm comm)
+{
+  uint dims = zfp_field_dimensionality(global);
+  size_t bytes = maxbits / CHAR_BIT;
+  size_t gb[4] = { 1, 1, 1, 1 };
+  size_t lb[4] = { 1, 1, 1, 1 };
+  size_t ob[4] = { 0, 0, 0, 0 };
+  size_t rows, size, x, y, z, w, i;
+  uint gn[4], ln[4];
+  void* buffer;
+  bitstream* stream;
+  MPI_Aint* disp;
+  int ok;
+
+  /* global and local block counts and block origin of subdomain */
+  zfp_field_size(global, gn);
+  zfp_field_size(local, ln);
+  for (i = 0; i < dims; i++) {
+    gb[i] = (gn[i] + BLOCK_SIDE - 1) / BLOCK_SIDE;
+    lb[i] = (ln[i] + BLOCK_SIDE - 1) / BLOCK_SIDE;
+    ob[i] = origin[i] / BLOCK_SIDE;
+  }
+  rows = lb[1] * lb[2] * lb[3];
+
+  /* compress local blocks, which are of equal size and word aligned */
+  size = zfp_stream_maximum_size(zfp, local);
+  buffer = malloc(size);
+  stream = buffer ? stream_open(buffer, size) : NULL;
+  disp = (MPI_Aint*)malloc(rows * sizeof(MPI_Aint));
+  ok = stream && disp && rows <= INT_MAX && lb[0] * bytes <= INT_MAX && compress_local(zfp, stream, local);
+
+  /* all ranks must succeed before entering collective write */
+  MPI_Allreduce(MPI_IN_PLACE, &ok, 1, MPI_INT, MPI_LAND, comm);
+  if (ok) {
+    MPI_Datatype row, filetype;
+    i = 0;
+    for (w = 0; w < lb[3]; w++)
+      for (z = 0; z < lb[2]; z++)
+        for (y = 0; y < lb[1]; y++) {
+          x = ob[0] + gb[0] * ((ob[1] + y) + gb[1] * ((ob[2] + z) + gb[2] * (ob[3] + w)));
+          disp[i++] = (MPI_Aint)(x * bytes);
+        }
+    MPI_Type_contiguous((int)(lb[0] * bytes), MPI_BYTE, &row);
+    MPI_Type_commit(&row);
+    MPI_Type_create_hindexed_block((int)rows, 1, disp, row, &filetype);
+    MPI_Type_commit(&filetype);
+    ok = MPI_File_set_view(file, offset, MPI_BYTE, filetype, "native", MPI_INFO_NULL) == MPI_SUCCESS &&
+         MPI_File_write_all(file, buffer, (int)rows, row, MPI_STATUS_IGNORE) == MPI_SUCCESS;
+    MPI_File_set_view(file, 0, MPI_BYTE, MPI_BYTE, "native", MPI_INFO_NULL);
+    MPI_Type_free(&filetype);
+    MPI_Type_free(&row);
+    MPI_Allreduce(MPI_IN_PLACE, &ok, 1, MPI_INT, MPI_LAND, comm);
+  }
+
+  free(disp);
+  if (stream)
+    stream_close(stream);
+  free(buffer);
+
+  return ok ? gb[0] * gb[1] * gb[2] * gb[3] * bytes : 0;
+}
+
+/* greatest common divisor */
+static uint64
+gcd(uint64 a, uint64 b)
+{
+  while (b) {
+    uint64 r = a % b;
+    a = b;
+    b = r;
+  }
+  return a;
+}
+
+/* compress chunks of block layers of slab and record their bit offsets */
+static zfp_bool
+compress_slab(zfp_stream* zfp, bitstream* stream, const zfp_field* local, uint64 layers, uint64* offset, size_t chunks)
+{
+  bitstream* s = zfp_stream_bit_stream(zfp);
+  zfp_index* index = zfp_stream_index(zfp);
+  size_t bytes = zfp_type_size(zfp_field_type(local));
+  uint n[3];
+  int sx[3];
+  zfp_bool success = zfp_true;
+  size_t chunk;
+
+  zfp_field_size(local, n);
+  zfp_field_stride(local, sx);
+
+  zfp_stream_set_bit_stream(zfp, stream);
+  zfp_stream_set_index(zfp, NULL);
+  zfp_stream_rewind(zfp);
+  zfp_compress_begin(zfp);
+  for (chunk = 0; chunk < chunks && success; chunk++) {
+    size_t z = (size_t)(chunk * layers * BLOCK_SIDE);
+    zfp_field slab = *local;
+    zfp_field_set_size_3d(&slab, n[0], n[1], (uint)(n[2] - z < layers * BLOCK_SIDE ? n[2] - z : layers * BLOCK_SIDE));
+    zfp_field_set_stride_3d(&slab, sx[0], sx[1], sx[2]);
+    zfp_field_set_pointer(&slab, (uchar*)zfp_field_pointer(local) + (ptrdiff_t)z * sx[2] * (ptrdiff_t)bytes);
+    offset[chunk] = stream_wtell(stream);
+    success = zfp_compress_slab(zfp, &slab);
+  }
+  offset[chunks] = stream_wtell(stream);
+  zfp_compress_end(zfp);
+  zfp_stream_set_bit_stream(zfp, s);
+  zfp_stream_set_index(zfp, index);
+
+  return success;
+}
+
+/* variable-rate z slabs: concatenate per-rank streams bit for bit in rank order */
+static size_t
+compress_sequential(zfp_stream* zfp, const zfp_field* global, const zfp_field* local, const size_t* origin, MPI_File file, MPI_Offset offset, zfp_index* index, MPI_Comm comm)
+{
+  const uint64 wbits = stream_word_bits;
+  const size_t wbytes = stream_word_bits / CHAR_BIT;
+  uint gn[3], ln[3];
+  uint64 z0 = 0, nz, layers, g = 0, base = 0, bits, total = 0;
+  uint64 head[2] = { 0, 0 };
+  uint64* all = NULL;
+  uint64* heads = NULL;
+  uint64* chunk_offset = NULL;
+  int* counts = NULL;
+  int* displs = NULL;
+  uchar* shifted = NULL;
+  void* buffer = NULL;
+  bitstream* stream = NULL;
+  bitstream* s = NULL;
+  size_t chunks = 0, size, words = 0;
+  int rank, ranks, r, ok;
+
+  MPI_Comm_rank(comm, &rank);
+  MPI_Comm_size(comm, &ranks);
+
+  /* ranks must own consecutive whole xy planes in rank order */
+  ok = zfp_field_dimensionality(global) == 3;
+  if (ok) {
+    zfp_field_size(global, gn);
+    zfp_field_size(local, ln);
+    ok = ln[0] == gn[0] && ln[1] == gn[1] && !origin[0] && !origin[1];
+  }
+  nz = ok ? ln[2] : 0;
+  MPI_Exscan(&nz, &z0, 1, MPI_UINT64_T, MPI_SUM, comm);
+  if (!rank)
+    z0 = 0;
+  ok = ok && z0 == origin[2];
+  MPI_Allreduce(MPI_IN_PLACE, &ok, 1, MPI_INT, MPI_LAND, comm);
+  if (!ok)
+    return 0;
+
+  /* chunks are the largest groups of block layers that evenly divide every slab */
+  layers = (nz + BLOCK_SIDE - 1) / BLOCK_SIDE;
+  all = (uint64*)malloc(ranks * sizeof(uint64));
+  counts = (int*)malloc(ranks * sizeof(int));
+  displs = (int*)malloc(ranks * sizeof(int));
+  heads = (uint64*)malloc(2 * ranks * sizeof(uint64));
+  ok = all && counts && displs && heads;
+  MPI_Allreduce(MPI_IN_PLACE, &ok, 1, MPI_INT, MPI_LAND, comm);
+  if (!ok)
+    goto cleanup;
+  MPI_Allgather(&layers, 1, MPI_UINT64_T, all, 1, MPI_UINT64_T, comm);
+  for (r = 0; r < ranks; r++)
+    g = gcd(all[r], g);
+  for (r = 0; r < ranks; r++) {
+    counts[r] = (int)(all[r] / g);
+    displs[r] = r ? displs[r - 1] + counts[r - 1] : 0;
+  }
+  chunks = (size_t)(layers / g);
+
+  /* compress local slab */
+  size = zfp_stream_maximum_size(zfp, local);
+  buffer = malloc(size);
+  stream = buffer ? stream_open(buffer, size) : NULL;
+  chunk_offset = (uint64*)malloc((displs[ranks - 1] + counts[ranks - 1] + 1) * sizeof(uint64));
+  ok = stream && chunk_offset && compress_slab(zfp, stream, local, g, chunk_offset + displs[rank], chunks);
+  bits = ok ? chunk_offset[displs[rank] + chunks] : 0;
+
+  /* bit offset of local stream within global stream */
+  MPI_Exscan(&bits, &base, 1, MPI_UINT64_T, MPI_SUM, comm);
+  if (!rank)
+    base = 0;
+  MPI_Allreduce(&bits, &total, 1, MPI_UINT64_T, MPI_SUM, comm);
+
+  /* shift local stream to its bit position within first global word */
+  if (ok) {
+    words = (size_t)((base % wbits + bits + wbits - 1) / wbits);
+    shifted = (uchar*)calloc(words, wbytes);
+    s = shifted ? stream_open(shifted, words * wbytes) : NULL;
+    ok = s != NULL && words <= INT_MAX / wbytes;
+  }
+  if (ok) {
+    stream_pad(s, (uint)(base % wbits));
+    stream_rseek(stream, 0);
+    stream_copy(s, stream, (size_t)bits);
+    stream_flush(s);
+    head[0] = base / wbits;
+    memcpy(&head[1], shifted, wbytes);
+  }
+  MPI_Allreduce(MPI_IN_PLACE, &ok, 1, MPI_INT, MPI_LAND, comm);
+  if (!ok)
+    goto cleanup;
+
+  /* a global word is written by the lowest rank with bits in it */
+  MPI_Allgather(head, 2, MPI_UINT64_T, heads, 2, MPI_UINT64_T, comm);
+  {
+    uint64 first = base / wbits;
+    uint64 last = (base + bits - 1) / wbits;
+    size_t skip = base % wbits ? 1 : 0;
+    size_t i;
+    if (last > first || !skip)
+      for (r = rank + 1; r < ranks && heads[2 * r] == last; r++)
+        for (i = 0; i < wbytes; i++)
+          shifted[(last - first) * wbytes + i] |= ((const uchar*)&heads[2 * r + 1])[i];
+    ok = MPI_File_write_at_all(file, offset + (MPI_Offset)((first + skip) * wbytes), shifted + skip * wbytes, (int)((words - skip) * wbytes), MPI_BYTE, MPI_STATUS_IGNORE) == MPI_SUCCESS;
+  }
+
+  /* assemble global chunk index */
+  if (ok && index) {
+    size_t c;
+    for (c = 0; c < chunks; c++)
+      chunk_offset[displs[rank] + c] += base;
+    MPI_Allgatherv(MPI_IN_PLACE, 0, MPI_DATATYPE_NULL, chunk_offset, counts, displs, MPI_UINT64_T, comm);
+    chunks = (size_t)(displs[ranks - 1] + counts[ranks - 1]);
+    chunk_offset[chunks] = total;
+    ok = zfp_index_set(index, chunks, chunk_offset);
+  }
+  MPI_Allreduce(MPI_IN_PLACE, &ok, 1, MPI_INT, MPI_LAND, comm);
+
+cleanup:
+  if (s)
+    stream_close(s);
+  free(shifted);
+  if (stream)
+    stream_close(stream);
+  free(buffer);
+  free(chunk_offset);
+  free(heads);
+  free(displs);
+  free(counts);
+  free(all);
+
+  return ok ? (size_t)((total + wbits - 1) / wbits * wbytes) : 0;
+}
+
+/* public functions -------------------------------------------------------- */
+
+size_t
+zfp_mpi_compress(zfp_stream* zfp, const zfp_field* global, const zfp_field* local, const size_t* origin, MPI_File file, MPI_Offset offset, zfp_index* index, MPI_Comm comm)
+{
+  int ok = check_subdomain(global, local, origin);
+  uint minbits, maxbits;
+
+  /* decomposition is valid only if every subdomain is */
+  MPI_Allreduce(MPI_IN_PLACE, &ok, 1, MPI_INT, MPI_LAND, comm);
+  if (!ok)
+    return 0;
+
+  /* fixed-size word-aligned blocks may be placed anywhere without an index */
+  zfp_stream_params(zfp, &minbits, &maxbits, NULL, NULL);
+  if (minbits == maxbits && maxbits % stream_word_bits == 0) {
+    if (index)
+      index->chunks = 0;
+    return compress_fixed(zfp, maxbits, global, local, origin, file, offset, comm);
+  }
+
+  return compress_sequential(zfp, global, local, origin, file, offset, index, comm);
+}
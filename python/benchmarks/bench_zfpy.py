@@ -0,0 +1,164 @@
+#!/usr/bin/env python
+
+# Throughput benchmarks for zfpy.  Each case times one zfpy entry point on a
+# smooth random array and reports uncompressed megabytes per second along
+# with the time per call, which for small arrays is dominated by Python-side
+# overhead (argument parsing, stream setup, buffer allocation and copies)
+# rather than by zfp itself.  Results may be saved as JSON and compared with
+# a previous run to catch regressions.
+#
+# usage: bench_zfpy.py [--quick] [--filter TEXT] [--json FILE]
+#                      [--compare FILE] [--threshold FRACTION]
+
+import argparse
+import concurrent.futures
+import itertools
+import json
+import sys
+import timeit
+
+import numpy as np
+import zfpy
+
+DTYPES = ["float32", "float64", "int32", "int64"]
+DIMS = [1, 2, 3, 4]
+SIZES = [1 << 12, 1 << 16, 1 << 20, 1 << 24]
+QUICK_SIZES = [1 << 12, 1 << 20]
+MODES = {
+    "rate": dict(rate=8),
+    "precision": dict(precision=16),
+    "accuracy": dict(tolerance=1e-3),
+    "reversible": dict(),
+}
+EXECUTIONS = {
+    "serial": (zfpy.exec_serial, 0),
+    "omp": (zfpy.exec_omp, 0),
+    "threads": (zfpy.exec_threads, 0),
+}
+OPS = [
+    "compress", "compress_out", "decompress", "decompress_out",
+    "compressor", "decompressor", "compress_many", "decompress_many",
+    "compress_threaded",
+]
+# number of small arrays (de)compressed per call by the batched entry points
+BATCH = 64
+# number of Python threads compressing concurrently, which scales only
+# when zfpy releases the GIL
+THREADS = 4
+
+
+def make_array(dtype, ndim, nbytes):
+    # smooth array of roughly nbytes bytes with equal extents
+    dtype = np.dtype(dtype)
+    n = max(4, int(round((nbytes // dtype.itemsize) ** (1.0 / ndim))))
+    axes = np.meshgrid(*[np.linspace(0, 1, n)] * ndim, indexing="ij")
+    values = np.sin(6 * sum(axes)) + 0.01 * np.random.rand(*axes[0].shape)
+    if dtype.kind == "i":
+        values *= 1 << (8 * dtype.itemsize - 4)
+    return np.ascontiguousarray(values.astype(dtype))
+
+
+def best_time(func, min_time):
+    # best time per call over several repetitions, each lasting min_time
+    timer = timeit.Timer(func)
+    number, elapsed = timer.autorange()
+    number = max(1, int(number * min_time / max(elapsed, 1e-9)))
+    return min(timer.repeat(repeat=3, number=number)) / number
+
+
+def cases(arr, mode, execution, threads, pool):
+    # (operation, callable, bytes of uncompressed data per call)
+    params = dict(MODES[mode], execution=execution, threads=threads)
+    stream = zfpy.compress_numpy(arr, **params)
+    out_stream = bytearray(zfpy.maximum_size(arr, **MODES[mode]))
+    out_array = np.empty_like(arr)
+    decompress_params = dict(execution=execution, threads=threads)
+    yield "compress", lambda: zfpy.compress_numpy(arr, **params), arr.nbytes
+    yield "compress_out", lambda: zfpy.compress_numpy(arr, out=out_stream, **params), arr.nbytes
+    yield "decompress", lambda: zfpy.decompress_numpy(stream, **decompress_params), arr.nbytes
+    yield "decompress_out", lambda: zfpy.decompress_numpy(stream, out=out_array, **decompress_params), arr.nbytes
+
+    compressor = zfpy.Compressor(**params)
+    decompressor = zfpy.Decompressor(**decompress_params)
+    yield "compressor", lambda: compressor.compress(arr), arr.nbytes
+    yield "decompressor", lambda: decompressor.decompress(stream), arr.nbytes
+    if arr.nbytes <= (1 << 16):
+        arrays = [arr] * BATCH
+        streams = [stream] * BATCH
+        yield "compress_many", lambda: compressor.compress_many(arrays), BATCH * arr.nbytes
+        yield "decompress_many", lambda: decompressor.decompress_many(streams), BATCH * arr.nbytes
+
+    yield "compress_threaded", lambda: list(pool.map(lambda a: zfpy.compress_numpy(a, **params), [arr] * THREADS)), THREADS * arr.nbytes
+
+
+def run(args):
+    results = {}
+    pool = concurrent.futures.ThreadPoolExecutor(THREADS)
+    sizes = QUICK_SIZES if args.quick else SIZES
+    modes = ["rate", "reversible"] if args.quick else list(MODES)
+    for dtype, ndim, size, mode, policy in itertools.product(DTYPES, DIMS, sizes, modes, EXECUTIONS):
+        if mode == "accuracy" and np.dtype(dtype).kind == "i":
+            continue
+        prefix = "{}/{}d/{}/{}/{}".format(dtype, ndim, size, mode, policy)
+        if args.filter and not any(f in "{}/{}".format(op, prefix) for op in OPS for f in args.filter):
+            continue
+        arr = make_array(dtype, ndim, size)
+        execution, threads = EXECUTIONS[policy]
+        try:
+            benchmarks = list(cases(arr, mode, execution, threads, pool))
+        except ValueError:
+            # execution policy not supported by this build of zfp
+            continue
+        for op, func, nbytes in benchmarks:
+            name = "{}/{}".format(op, prefix)
+            if args.filter and not any(f in name for f in args.filter):
+                continue
+            try:
+                func()
+            except (ValueError, RuntimeError):
+                # operation not supported by this policy and mode
+                continue
+            seconds = best_time(func, args.min_time)
+            results[name] = {"MB/s": nbytes / seconds / 1e6, "us/call": 1e6 * seconds}
+            print("{:64s} {:10.1f} MB/s {:12.1f} us/call".format(name, results[name]["MB/s"], results[name]["us/call"]))
+            sys.stdout.flush()
+    pool.shutdown()
+    return results
+
+
+def compare(results, baseline, threshold):
+    # report cases whose throughput dropped by more than threshold
+    regressions = 0
+    for name in sorted(set(results) & set(baseline)):
+        old = baseline[name]["MB/s"]
+        new = results[name]["MB/s"]
+        if new < (1 - threshold) * old:
+            regressions += 1
+            print("regression: {} {:.1f} -> {:.1f} MB/s ({:+.0f}%)".format(name, old, new, 100 * (new / old - 1)))
+    print("{} of {} cases regressed by more than {:.0f}%".format(regressions, len(set(results) & set(baseline)), 100 * threshold))
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Measure zfpy throughput")
+    parser.add_argument("--quick", action="store_true", help="run a reduced set of cases")
+    parser.add_argument("--filter", action="append", help="run only cases whose name contains this text")
+    parser.add_argument("--min-time", type=float, default=0.1, help="seconds per timing repetition")
+    parser.add_argument("--json", help="save results to this file")
+    parser.add_argument("--compare", help="compare against results saved by a previous run")
+    parser.add_argument("--threshold", type=float, default=0.1, help="relative slowdown reported as a regression")
+    args = parser.parse_args()
+
+    results = run(args)
+    if args.json:
+        with open(args.json, "w") as f:
+            json.dump(results, f, indent=1, sort_keys=True)
+    if args.compare:
+        with open(args.compare) as f:
+            if compare(results, json.load(f), args.threshold):
+                return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -4,17 +4,35 @@ cimport libc.stdint as stdint
 cdef extern from "bitstream.h":
     cdef struct bitstream:
         pass
-    bitstream* stream_open(void* data, size_t)
-    void stream_close(bitstream* stream)
+    bitstream* stream_open(void* data, size_t) nogil
+    void stream_close(bitstream* stream) nogil
+    size_t stream_wtell(const bitstream* stream)
+    void stream_wseek(bitstream* stream, size_t offset)
 
 cdef extern from "zfp.h":
     # enums
     ctypedef enum zfp_type:
-        zfp_type_none   = 0,
-        zfp_type_int32  = 1,
-        zfp_type_int64  = 2,
-        zfp_type_float  = 3,
-        zfp_type_double = 4
+        zfp_type_none     = 0,
+        zfp_type_int32    = 1,
+        zfp_type_int64    = 2,
+        zfp_type_float    = 3,
+        zfp_type_double   = 4,
+        zfp_type_half     = 5,
+        zfp_type_bfloat16 = 6,
+        zfp_type_int8     = 7,
+        zfp_type_uint8    = 8,
+        zfp_type_int16    = 9,
+        zfp_type_uint16   = 10
+
+    ctypedef enum zfp_exec_policy:
+        zfp_exec_serial     = 0,
+        zfp_exec_omp        = 1,
+        zfp_exec_cuda       = 2,
+        zfp_exec_hip        = 3,
+        zfp_exec_threads    = 4,
+        zfp_exec_omp_target = 5,
+        zfp_exec_sycl       = 6,
+        zfp_exec_hybrid     = 7
 
     ctypedef enum zfp_mode:
         zfp_mode_null            = 0,
@@ -42,18 +60,28 @@ cdef extern from "zfp.h":
     zfp_stream* zfp_stream_open(bitstream* stream)
     void zfp_stream_close(zfp_stream* stream)
     size_t zfp_stream_maximum_size(const zfp_stream* stream, const zfp_field* field)
-    void zfp_stream_set_bit_stream(zfp_stream* stream, bitstream* bs)
+    void zfp_stream_set_bit_stream(zfp_stream* stream, bitstream* bs) nogil
     cython.uint zfp_stream_set_precision(zfp_stream* stream, cython.uint precision)
     double zfp_stream_set_accuracy(zfp_stream* stream, double tolerance)
     double zfp_stream_set_rate(zfp_stream* stream, double rate, zfp_type type, cython.uint dims, int wra)
     void zfp_stream_set_reversible(zfp_stream* stream)
     stdint.uint64_t zfp_stream_mode(const zfp_stream* zfp)
-    zfp_mode zfp_stream_set_mode(zfp_stream* stream, stdint.uint64_t mode)
+    zfp_mode zfp_stream_set_mode(zfp_stream* stream, stdint.uint64_t mode) nogil
+    void zfp_stream_params(const zfp_stream* stream, cython.uint* minbits, cython.uint* maxbits, cython.uint* maxprec, int* minexp)
+    bint zfp_stream_set_execution(zfp_stream* stream, zfp_exec_policy policy)
+    bint zfp_stream_set_omp_threads(zfp_stream* stream, cython.uint threads)
+    bint zfp_stream_set_omp_chunk_size(zfp_stream* stream, cython.uint chunk_size)
+    bint zfp_stream_set_thread_count(zfp_stream* stream, cython.uint threads)
+    bint zfp_stream_set_thread_chunk_size(zfp_stream* stream, cython.uint chunk_size)
     zfp_field* zfp_field_alloc()
     zfp_field* zfp_field_1d(void* pointer, zfp_type, cython.uint nx)
     zfp_field* zfp_field_2d(void* pointer, zfp_type, cython.uint nx, cython.uint ny)
     zfp_field* zfp_field_3d(void* pointer, zfp_type, cython.uint nx, cython.uint ny, cython.uint nz)
     zfp_field* zfp_field_4d(void* pointer, zfp_type, cython.uint nx, cython.uint ny, cython.uint nz, cython.uint nw)
+    void zfp_field_set_size_1d(zfp_field* field, size_t nx)
+    void zfp_field_set_size_2d(zfp_field* field, size_t nx, size_t ny)
+    void zfp_field_set_size_3d(zfp_field* field, size_t nx, size_t ny, size_t nz)
+    void zfp_field_set_size_4d(zfp_field* field, size_t nx, size_t ny, size_t nz, size_t nw)
     void zfp_field_set_stride_1d(zfp_field* field, int sx)
     void zfp_field_set_stride_2d(zfp_field* field, int sx, int sy)
     void zfp_field_set_stride_3d(zfp_field* field, int sx, int sy, int sz)
@@ -63,9 +91,82 @@ cdef extern from "zfp.h":
     zfp_type zfp_field_set_type(zfp_field* field, zfp_type type)
     size_t zfp_compress(zfp_stream* stream, const zfp_field* field) nogil
     size_t zfp_decompress(zfp_stream* stream, zfp_field* field) nogil
-    size_t zfp_write_header(zfp_stream* stream, const zfp_field* field, cython.uint mask)
-    size_t zfp_read_header(zfp_stream* stream, zfp_field* field, cython.uint mask)
-    void zfp_stream_rewind(zfp_stream* stream)
+    size_t zfp_write_header(zfp_stream* stream, const zfp_field* field, cython.uint mask) nogil
+    size_t zfp_read_header(zfp_stream* stream, zfp_field* field, cython.uint mask) nogil
+    void zfp_stream_rewind(zfp_stream* stream) nogil
     void zfp_field_set_pointer(zfp_field* field, void* pointer) nogil
 
 cdef gen_padded_int_list(orig_array, pad=*, length=*)
+
+cdef extern from "cfparray.h":
+    ctypedef struct cfp_array3d:
+        void* object
+
+    ctypedef struct cfp_array3d_api:
+        cfp_array3d (*ctor)(size_t nx, size_t ny, size_t nz, double rate, const double* p, size_t cache_size)
+        void (*dtor)(cfp_array3d self)
+        double (*rate)(const cfp_array3d self)
+        size_t (*cache_size)(const cfp_array3d self)
+        void (*set_cache_size)(cfp_array3d self, size_t bytes)
+        void (*clear_cache)(const cfp_array3d self)
+        void (*flush_cache)(const cfp_array3d self)
+        size_t (*compressed_size)(const cfp_array3d self)
+        void* (*compressed_data)(const cfp_array3d self)
+        size_t (*size_x)(const cfp_array3d self)
+        size_t (*size_y)(const cfp_array3d self)
+        size_t (*size_z)(const cfp_array3d self)
+        void (*get_array)(const cfp_array3d self, double* p) nogil
+        void (*set_array)(cfp_array3d self, const double* p) nogil
+        double (*get)(const cfp_array3d self, size_t i, size_t j, size_t k) nogil
+        void (*set)(cfp_array3d self, size_t i, size_t j, size_t k, double val) nogil
+
+    ctypedef struct cfp_array3i:
+        void* object
+
+    ctypedef struct cfp_array3i_api:
+        cfp_array3i (*ctor)(size_t nx, size_t ny, size_t nz, double rate, const stdint.int32_t* p, size_t cache_size)
+        void (*dtor)(cfp_array3i self)
+        void (*set_reversible)(cfp_array3i self)
+        double (*rate)(const cfp_array3i self)
+        size_t (*cache_size)(const cfp_array3i self)
+        void (*set_cache_size)(cfp_array3i self, size_t bytes)
+        void (*clear_cache)(const cfp_array3i self)
+        void (*flush_cache)(const cfp_array3i self)
+        size_t (*compressed_size)(const cfp_array3i self)
+        void* (*compressed_data)(const cfp_array3i self)
+        size_t (*size_x)(const cfp_array3i self)
+        size_t (*size_y)(const cfp_array3i self)
+        size_t (*size_z)(const cfp_array3i self)
+        void (*get_array)(const cfp_array3i self, stdint.int32_t* p) nogil
+        void (*set_array)(cfp_array3i self, const stdint.int32_t* p) nogil
+        stdint.int32_t (*get)(const cfp_array3i self, size_t i, size_t j, size_t k) nogil
+        void (*set)(cfp_array3i self, size_t i, size_t j, size_t k, stdint.int32_t val) nogil
+
+    ctypedef struct cfp_array3l:
+        void* object
+
+    ctypedef struct cfp_array3l_api:
+        cfp_array3l (*ctor)(size_t nx, size_t ny, size_t nz, double rate, const stdint.int64_t* p, size_t cache_size)
+        void (*dtor)(cfp_array3l self)
+        void (*set_reversible)(cfp_array3l self)
+        double (*rate)(const cfp_array3l self)
+        size_t (*cache_size)(const cfp_array3l self)
+        void (*set_cache_size)(cfp_array3l self, size_t bytes)
+        void (*clear_cache)(const cfp_array3l self)
+        void (*flush_cache)(const cfp_array3l self)
+        size_t (*compressed_size)(const cfp_array3l self)
+        void* (*compressed_data)(const cfp_array3l self)
+        size_t (*size_x)(const cfp_array3l self)
+        size_t (*size_y)(const cfp_array3l self)
+        size_t (*size_z)(const cfp_array3l self)
+        void (*get_array)(const cfp_array3l self, stdint.int64_t* p) nogil
+        void (*set_array)(cfp_array3l self, const stdint.int64_t* p) nogil
+        stdint.int64_t (*get)(const cfp_array3l self, size_t i, size_t j, size_t k) nogil
+        void (*set)(cfp_array3l self, size_t i, size_t j, size_t k, stdint.int64_t val) nogil
+
+    ctypedef struct cfp_api:
+        cfp_array3d_api array3d
+        cfp_array3i_api array3i
+        cfp_array3l_api array3l
+
+    const cfp_api cfp
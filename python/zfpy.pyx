@@ -2,9 +2,12 @@ import sys
 import operator
 import functools
 import cython
-from libc.stdlib cimport malloc, free
+from libc.stdlib cimport malloc, calloc, realloc, free
+from libc.string cimport memcpy
 from cython cimport view
 from libc.stdint cimport uint8_t
+cimport libc.stdint as stdint
+from cpython.pycapsule cimport PyCapsule_IsValid, PyCapsule_GetPointer, PyCapsule_SetName
 
 import itertools
 if sys.version_info[0] == 2:
@@ -29,11 +32,25 @@ type_int32 = zfp_type_int32
 type_int64 = zfp_type_int64
 type_float = zfp_type_float
 type_double = zfp_type_double
+type_half = zfp_type_half
+type_bfloat16 = zfp_type_bfloat16
+type_int8 = zfp_type_int8
+type_uint8 = zfp_type_uint8
+type_int16 = zfp_type_int16
+type_uint16 = zfp_type_uint16
 mode_null = zfp_mode_null
 mode_expert = zfp_mode_expert
 mode_fixed_rate = zfp_mode_fixed_rate
 mode_fixed_precision = zfp_mode_fixed_precision
 mode_fixed_accuracy = zfp_mode_fixed_accuracy
+exec_serial = zfp_exec_serial
+exec_omp = zfp_exec_omp
+exec_cuda = zfp_exec_cuda
+exec_hip = zfp_exec_hip
+exec_threads = zfp_exec_threads
+exec_omp_target = zfp_exec_omp_target
+exec_sycl = zfp_exec_sycl
+exec_hybrid = zfp_exec_hybrid
 
 
 cpdef dtype_to_ztype(dtype):
@@ -45,6 +62,16 @@ cpdef dtype_to_ztype(dtype):
         return zfp_type_float
     elif dtype == np.float64:
         return zfp_type_double
+    elif dtype == np.float16:
+        return zfp_type_half
+    elif dtype == np.int8:
+        return zfp_type_int8
+    elif dtype == np.uint8:
+        return zfp_type_uint8
+    elif dtype == np.int16:
+        return zfp_type_int16
+    elif dtype == np.uint16:
+        return zfp_type_uint16
     else:
         raise TypeError("Unknown dtype: {}".format(dtype))
 
@@ -59,6 +86,16 @@ cpdef dtype_to_format(dtype):
         return 'f' # float
     elif dtype == np.float64:
         return 'd' # double
+    elif dtype == np.float16:
+        return 'e' # half
+    elif dtype == np.int8:
+        return 'b' # signed char
+    elif dtype == np.uint8:
+        return 'B' # unsigned char
+    elif dtype == np.int16:
+        return 'h' # signed short
+    elif dtype == np.uint16:
+        return 'H' # unsigned short
     else:
         raise TypeError("Unknown dtype: {}".format(dtype))
 
@@ -67,6 +104,11 @@ zfp_to_dtype_map = {
     zfp_type_int64: np.int64,
     zfp_type_float: np.float32,
     zfp_type_double: np.float64,
+    zfp_type_half: np.float16,
+    zfp_type_int8: np.int8,
+    zfp_type_uint8: np.uint8,
+    zfp_type_int16: np.int16,
+    zfp_type_uint16: np.uint16,
 }
 cpdef ztype_to_dtype(zfp_type ztype):
     try:
@@ -75,30 +117,177 @@ cpdef ztype_to_dtype(zfp_type ztype):
         raise ValueError("Unsupported zfp_type {}".format(ztype))
 
 cdef zfp_field* _init_field(np.ndarray arr):
-    shape = arr.shape
-    cdef int ndim = arr.ndim
-    cdef zfp_type ztype = dtype_to_ztype(arr.dtype)
-    cdef zfp_field* field
-    cdef void* pointer = arr.data
+    strides = [int(x) / arr.itemsize for x in arr.strides[:arr.ndim]]
+    return _init_field_from_pointer(
+        <void *>arr.data,
+        dtype_to_ztype(arr.dtype),
+        arr.shape,
+        strides
+    )
+
+cdef zfp_field* _init_field_from_pointer(
+    void* pointer,
+    zfp_type ztype,
+    shape,
+    strides,
+):
+    cdef zfp_field* field = zfp_field_alloc()
+    if field == NULL:
+        raise MemoryError()
+    try:
+        _set_field(field, pointer, ztype, shape, strides)
+    except:
+        zfp_field_free(field)
+        raise
+    return field
 
-    strides = [int(x) / arr.itemsize for x in arr.strides[:ndim]]
+cdef _set_field(
+    zfp_field* field,
+    void* pointer,
+    zfp_type ztype,
+    shape,
+    strides,
+):
+    # shape and strides (in number of values) are in C order
+    cdef int ndim = len(shape)
 
     if ndim == 1:
-        field = zfp_field_1d(pointer, ztype, shape[0])
+        zfp_field_set_size_1d(field, shape[0])
         zfp_field_set_stride_1d(field, strides[0])
     elif ndim == 2:
-        field = zfp_field_2d(pointer, ztype, shape[1], shape[0])
+        zfp_field_set_size_2d(field, shape[1], shape[0])
         zfp_field_set_stride_2d(field, strides[1], strides[0])
     elif ndim == 3:
-        field = zfp_field_3d(pointer, ztype, shape[2], shape[1], shape[0])
+        zfp_field_set_size_3d(field, shape[2], shape[1], shape[0])
         zfp_field_set_stride_3d(field, strides[2], strides[1], strides[0])
     elif ndim == 4:
-        field = zfp_field_4d(pointer, ztype, shape[3], shape[2], shape[1], shape[0])
+        zfp_field_set_size_4d(field, shape[3], shape[2], shape[1], shape[0])
         zfp_field_set_stride_4d(field, strides[3], strides[2], strides[1], strides[0])
     else:
         raise RuntimeError("Greater than 4 dimensions not supported")
+    zfp_field_set_type(field, ztype)
+    zfp_field_set_pointer(field, pointer)
 
-    return field
+# DLPack tensor layout (see https://github.com/dmlc/dlpack)
+ctypedef struct DLDevice:
+    int device_type
+    int device_id
+
+ctypedef struct DLDataType:
+    stdint.uint8_t code
+    stdint.uint8_t bits
+    stdint.uint16_t lanes
+
+ctypedef struct DLTensor:
+    void* data
+    DLDevice device
+    int ndim
+    DLDataType dtype
+    stdint.int64_t* shape
+    stdint.int64_t* strides
+    stdint.uint64_t byte_offset
+
+ctypedef struct DLManagedTensor:
+    DLTensor dl_tensor
+    void* manager_ctx
+    void (*deleter)(DLManagedTensor*)
+
+# DLPack device types and data type codes
+cdef enum:
+    kDLCUDA = 2
+    kDLROCM = 10
+    kDLCUDAManaged = 13
+    kDLInt = 0
+    kDLFloat = 2
+
+cdef tuple _contiguous_strides(shape):
+    strides = []
+    cdef size_t stride = 1
+    for x in reversed(shape):
+        strides.insert(0, stride)
+        stride *= x
+    return tuple(strides)
+
+@cython.final
+cdef class DeviceArray:
+    # Device memory exposed by an object that implements either
+    # __cuda_array_interface__ (CuPy, Numba, PyTorch) or DLPack; the object
+    # is kept alive for the lifetime of this view
+    cdef void* data
+    cdef object owner
+    cdef DLManagedTensor* managed
+    cdef readonly object dtype
+    cdef readonly tuple shape
+    cdef readonly tuple strides  # in number of values
+    cdef readonly int policy     # execution policy that can access the data
+
+    def __cinit__(self, obj):
+        self.owner = obj
+        self.managed = NULL
+        if hasattr(obj, "__cuda_array_interface__"):
+            self._from_cuda_array_interface(obj.__cuda_array_interface__)
+        elif hasattr(obj, "__dlpack__"):
+            self._from_dlpack(obj.__dlpack__())
+        else:
+            raise TypeError(
+                "Object exposes neither __cuda_array_interface__ nor DLPack"
+            )
+
+    def __dealloc__(self):
+        if self.managed != NULL and self.managed.deleter != NULL:
+            self.managed.deleter(self.managed)
+
+    cdef _from_cuda_array_interface(self, interface):
+        self.dtype = np.dtype(interface["typestr"])
+        self.shape = tuple([int(x) for x in interface["shape"]])
+        self.data = <void *><size_t>interface["data"][0]
+        if interface.get("strides") is None:
+            self.strides = _contiguous_strides(self.shape)
+        else:
+            self.strides = tuple(
+                [int(x) // self.dtype.itemsize for x in interface["strides"]]
+            )
+        self.policy = zfp_exec_cuda
+
+    cdef _from_dlpack(self, capsule):
+        if not PyCapsule_IsValid(capsule, "dltensor"):
+            raise TypeError("Invalid or consumed DLPack capsule")
+        self.managed = <DLManagedTensor*>PyCapsule_GetPointer(capsule, "dltensor")
+        # the tensor is now owned by this view, which calls its deleter
+        PyCapsule_SetName(capsule, "used_dltensor")
+
+        cdef DLTensor* tensor = &self.managed.dl_tensor
+        if tensor.device.device_type in (kDLCUDA, kDLCUDAManaged):
+            self.policy = zfp_exec_cuda
+        elif tensor.device.device_type == kDLROCM:
+            self.policy = zfp_exec_hip
+        else:
+            raise TypeError("DLPack tensor does not reside on a GPU")
+        if tensor.dtype.lanes != 1 or tensor.dtype.code not in (kDLInt, kDLFloat):
+            raise TypeError("Unsupported DLPack data type")
+
+        kind = "f" if tensor.dtype.code == kDLFloat else "i"
+        self.dtype = np.dtype("{}{}".format(kind, tensor.dtype.bits // 8))
+        self.shape = tuple([tensor.shape[i] for i in range(tensor.ndim)])
+        self.data = <void *>(<char *>tensor.data + tensor.byte_offset)
+        if tensor.strides == NULL:
+            self.strides = _contiguous_strides(self.shape)
+        else:
+            self.strides = tuple([tensor.strides[i] for i in range(tensor.ndim)])
+
+    cdef size_t nbytes(self) except? 0:
+        # size of a contiguous buffer in bytes
+        if self.strides != _contiguous_strides(self.shape):
+            raise ValueError("Device buffer must be contiguous")
+        return functools.reduce(operator.mul, self.shape, 1) * self.dtype.itemsize
+
+cdef zfp_field* _init_device_field(DeviceArray arr):
+    return _init_field_from_pointer(
+        arr.data,
+        dtype_to_ztype(arr.dtype),
+        arr.shape,
+        arr.strides
+    )
 
 cdef gen_padded_int_list(orig_array, pad=0, length=4):
     return [int(x) for x in
@@ -123,12 +312,65 @@ cdef class Memory:
     def __exit__(self, exc_type, exc_value, exc_tb):
         free(self.data)
 
-cpdef bytes compress_numpy(
+cpdef size_t maximum_size(
+    arr,
+    double tolerance = -1,
+    double rate = -1,
+    int precision = -1,
+):
+    # Number of bytes that compress_numpy or compress_device may require for
+    # arr, header included
+    if arr is None:
+        raise TypeError("Input array cannot be None")
+    cdef zfp_field* field
+    if isinstance(arr, np.ndarray):
+        field = _init_field(arr)
+    else:
+        field = _init_device_field(DeviceArray(arr))
+    cdef zfp_stream* stream = zfp_stream_open(NULL)
+    cdef size_t maxsize
+    try:
+        _set_compression_mode(stream, zfp_type_none, len(arr.shape), tolerance, rate, precision)
+        maxsize = zfp_stream_maximum_size(stream, field)
+    finally:
+        zfp_field_free(field)
+        zfp_stream_close(stream)
+    return maxsize
+
+cdef size_t _compress_to(
+    zfp_stream* stream,
+    zfp_field* field,
+    void* data,
+    size_t size,
+    write_header,
+) except 0:
+    cdef bitstream* bstream = stream_open(data, size)
+    cdef size_t compressed_size = 0
+    try:
+        zfp_stream_set_bit_stream(stream, bstream)
+        zfp_stream_rewind(stream)
+        # write the full header so we can reconstruct the numpy array on
+        # decompression
+        if write_header and zfp_write_header(stream, field, HEADER_FULL) == 0:
+            raise RuntimeError("Failed to write header to stream")
+        with nogil:
+            compressed_size = zfp_compress(stream, field)
+        if compressed_size == 0:
+            raise RuntimeError("Failed to write to stream")
+    finally:
+        stream_close(bstream)
+    return compressed_size
+
+cpdef compress_numpy(
     np.ndarray arr,
     double tolerance = -1,
     double rate = -1,
     int precision = -1,
-    write_header=True
+    write_header=True,
+    execution=exec_serial,
+    int threads = 0,
+    int chunk_size = 0,
+    out=None,
 ):
     # Input validation
     if arr is None:
@@ -143,33 +385,38 @@ cpdef bytes compress_numpy(
 
     cdef zfp_type ztype = zfp_type_none
     cdef int ndim = arr.ndim
-    _set_compression_mode(stream, ztype, ndim, tolerance, rate, precision)
-
-    # Allocate space based on the maximum size potentially required by zfp to
-    # store the compressed array
     cdef bytes compress_str = None
-    cdef size_t maxsize = zfp_stream_maximum_size(stream, field)
+    cdef uint8_t[::1] out_view
+    cdef size_t maxsize
+    cdef size_t compressed_size
     try:
-        with Memory(maxsize) as data:
-            bstream = stream_open(data, maxsize)
-            zfp_stream_set_bit_stream(stream, bstream)
-            zfp_stream_rewind(stream)
-            # write the full header so we can reconstruct the numpy array on
-            # decompression
-            if write_header and zfp_write_header(stream, field, HEADER_FULL) == 0:
-                raise RuntimeError("Failed to write header to stream")
-            with nogil:
-                compressed_size = zfp_compress(stream, field)
-            if compressed_size == 0:
-                raise RuntimeError("Failed to write to stream")
-            # copy the compressed data into a perfectly sized bytes object
-            compress_str = (<char *>data)[:compressed_size]
+        _set_compression_mode(stream, ztype, ndim, tolerance, rate, precision)
+        _set_execution(stream, execution, threads, chunk_size)
+
+        # the output buffer must hold the maximum size potentially required
+        # by zfp to store the compressed array
+        maxsize = zfp_stream_maximum_size(stream, field)
+        if out is None:
+            with Memory(maxsize) as data:
+                compressed_size = _compress_to(stream, field, data, maxsize, write_header)
+                # copy the compressed data into a perfectly sized bytes object
+                compress_str = (<char *>data)[:compressed_size]
+        else:
+            # compress directly into the caller's writable buffer
+            out_view = out
+            if <size_t>out_view.shape[0] < maxsize:
+                raise ValueError(
+                    "Out buffer has {} bytes but compression may require "
+                    "{} bytes".format(out_view.shape[0], maxsize)
+                )
+            compressed_size = _compress_to(stream, field, <void *>&out_view[0], maxsize, write_header)
     finally:
         zfp_field_free(field)
         zfp_stream_close(stream)
-        stream_close(bstream)
 
-    return compress_str
+    if out is None:
+        return compress_str
+    return compressed_size
 
 cdef view.array _decompress_with_view(
     zfp_field* field,
@@ -224,6 +471,31 @@ cdef _set_compression_mode(
     else:
         zfp_stream_set_reversible(stream)
 
+cdef _set_execution(
+    zfp_stream *stream,
+    execution,
+    int threads = 0,
+    int chunk_size = 0,
+):
+    # Select the execution policy; threads and chunk_size apply only to the
+    # multi-threaded CPU policies, where zero selects the library default
+    if threads < 0 or chunk_size < 0:
+        raise ValueError("threads and chunk_size must be nonnegative")
+    if not zfp_stream_set_execution(stream, execution):
+        raise ValueError(
+            "Execution policy {} is not available".format(execution)
+        )
+    if execution == zfp_exec_omp:
+        zfp_stream_set_omp_threads(stream, threads)
+        zfp_stream_set_omp_chunk_size(stream, chunk_size)
+    elif execution == zfp_exec_threads:
+        zfp_stream_set_thread_count(stream, threads)
+        zfp_stream_set_thread_chunk_size(stream, chunk_size)
+    elif threads or chunk_size:
+        raise ValueError(
+            "threads and chunk_size require exec_omp or exec_threads"
+        )
+
 cdef _validate_4d_list(in_list, list_name):
     # Validate that the input list is either a valid list for strides or shape
     # Specifically, check it is a list and the length is > 0 and <= 4
@@ -243,6 +515,47 @@ cdef _validate_4d_list(in_list, list_name):
             "User-provided {} is not an iterable"
         )
 
+cdef np.ndarray _output_array(out, zfp_type ztype, shape):
+    # Wrap or validate the user-provided output without copying it
+    dtype = zfpy.ztype_to_dtype(ztype)
+    cdef np.ndarray output
+    if isinstance(out, np.ndarray):
+        output = out
+
+        # check that numpy and user-provided types match
+        if out.dtype != dtype:
+            raise ValueError(
+                "Out ndarray has dtype {} but decompression is using "
+                "{}. Use out=ndarray.data to avoid this check.".format(
+                    out.dtype,
+                    dtype
+                )
+            )
+
+        # check that numpy and user-provided shape match
+        numpy_shape = out.shape
+        user_shape = [x for x in shape if x > 0]
+        if not all(
+                [x == y for x, y in
+                 zip_longest(numpy_shape, user_shape)
+                ]
+        ):
+            raise ValueError(
+                "Out ndarray has shape {} but decompression is using "
+                "{}.  Use out=ndarray.data to avoid this check.".format(
+                    numpy_shape,
+                    user_shape
+                )
+            )
+    else:
+        output = np.frombuffer(out, dtype=dtype)
+        output = output.reshape(shape)
+
+    # values are written in C order directly into the output's memory
+    if not output.flags.c_contiguous or not output.flags.writeable:
+        raise ValueError("Out buffer must be C-contiguous and writeable")
+    return output
+
 cpdef np.ndarray _decompress(
     const uint8_t[::1] compressed_data,
     zfp_type ztype,
@@ -251,6 +564,9 @@ cpdef np.ndarray _decompress(
     double tolerance = -1,
     double rate = -1,
     int precision = -1,
+    execution=exec_serial,
+    int threads = 0,
+    int chunk_size = 0,
 ):
     if compressed_data is None:
         raise TypeError("compressed_data cannot be None")
@@ -276,6 +592,7 @@ cpdef np.ndarray _decompress(
         zfp_field_set_type(field, ztype)
         ndim = sum([1 for x in zshape if x > 0])
         _set_compression_mode(stream, ztype, ndim, tolerance, rate, precision)
+        _set_execution(stream, execution, threads, chunk_size)
 
         # pad the shape with zeros to reach len == 4
         # strides = gen_padded_int_list(reversed(strides), pad=0, length=4)
@@ -284,39 +601,7 @@ cpdef np.ndarray _decompress(
         if out is None:
             output = np.asarray(_decompress_with_view(field, stream))
         else:
-            dtype = zfpy.ztype_to_dtype(ztype)
-            if isinstance(out, np.ndarray):
-                output = out
-
-                # check that numpy and user-provided types match
-                if out.dtype != dtype:
-                    raise ValueError(
-                        "Out ndarray has dtype {} but decompression is using "
-                        "{}. Use out=ndarray.data to avoid this check.".format(
-                            out.dtype,
-                            dtype
-                        )
-                    )
-
-                # check that numpy and user-provided shape match
-                numpy_shape = out.shape
-                user_shape = [x for x in shape if x > 0]
-                if not all(
-                        [x == y for x, y in
-                         zip_longest(numpy_shape, user_shape)
-                        ]
-                ):
-                    raise ValueError(
-                        "Out ndarray has shape {} but decompression is using "
-                        "{}.  Use out=ndarray.data to avoid this check.".format(
-                            numpy_shape,
-                            user_shape
-                        )
-                    )
-            else:
-                output = np.frombuffer(out, dtype=dtype)
-                output = output.reshape(shape)
-
+            output = _output_array(out, ztype, shape)
             _decompress_with_user_array(field, stream, <void *>output.data)
 
     finally:
@@ -328,9 +613,15 @@ cpdef np.ndarray _decompress(
 
 cpdef np.ndarray decompress_numpy(
     const uint8_t[::1] compressed_data,
+    execution=exec_serial,
+    int threads = 0,
+    int chunk_size = 0,
+    out=None,
 ):
     if compressed_data is None:
         raise TypeError("compressed_data cannot be None")
+    if compressed_data is out:
+        raise ValueError("Cannot decompress in-place")
 
     cdef const void* comp_data_pointer = <const void *>&compressed_data[0]
     cdef zfp_field* field = zfp_field_alloc()
@@ -344,10 +635,941 @@ cpdef np.ndarray decompress_numpy(
     try:
         if zfp_read_header(stream, field, HEADER_FULL) == 0:
             raise ValueError("Failed to read required zfp header")
-        output = np.asarray(_decompress_with_view(field, stream))
+        _set_execution(stream, execution, threads, chunk_size)
+        if out is None:
+            output = np.asarray(_decompress_with_view(field, stream))
+        else:
+            shape = (field[0].nw, field[0].nz, field[0].ny, field[0].nx)
+            shape = tuple([x for x in shape if x > 0])
+            output = _output_array(out, field[0]._type, shape)
+            _decompress_with_user_array(field, stream, <void *>output.data)
     finally:
         zfp_field_free(field)
         zfp_stream_close(stream)
         stream_close(bstream)
 
     return output
+
+cdef tuple _field_shape(zfp_field* field):
+    # C-order shape of the array described by field
+    shape = (field[0].nw, field[0].nz, field[0].ny, field[0].nx)
+    return tuple([x for x in shape if x > 0])
+
+@cython.final
+cdef class Compressor:
+    # Compresses a sequence of arrays with one zfp stream, compression mode,
+    # and scratch buffer, which are set up once rather than on every call
+    cdef zfp_stream* stream
+    cdef zfp_field* field
+    cdef void* buffer
+    cdef size_t buffer_size
+    cdef double tolerance
+    cdef double rate
+    cdef int precision
+    cdef int ndim
+    cdef bint write_header
+
+    def __cinit__(
+        self,
+        double tolerance = -1,
+        double rate = -1,
+        int precision = -1,
+        write_header=True,
+        execution=exec_serial,
+        int threads = 0,
+        int chunk_size = 0,
+    ):
+        num_params_set = sum([1 for x in [tolerance, rate, precision] if x >= 0])
+        if num_params_set > 1:
+            raise ValueError("Only one of tolerance, rate, or precision can be set")
+        self.stream = zfp_stream_open(NULL)
+        self.field = zfp_field_alloc()
+        if self.stream == NULL or self.field == NULL:
+            raise MemoryError()
+        self.tolerance = tolerance
+        self.rate = rate
+        self.precision = precision
+        self.ndim = 0
+        self.write_header = write_header
+        _set_execution(self.stream, execution, threads, chunk_size)
+
+    def __dealloc__(self):
+        if self.stream != NULL:
+            zfp_stream_close(self.stream)
+        if self.field != NULL:
+            zfp_field_free(self.field)
+        free(self.buffer)
+
+    cdef size_t _prepare(self, np.ndarray arr, zfp_field* field) except 0:
+        # point field at arr and return the maximum compressed size; the
+        # mode depends on dimensionality only and is reset when it changes
+        if arr is None:
+            raise TypeError("Input array cannot be None")
+        strides = [x // arr.itemsize for x in arr.strides[:arr.ndim]]
+        _set_field(field, <void *>arr.data, dtype_to_ztype(arr.dtype), arr.shape, strides)
+        if arr.ndim != self.ndim:
+            _set_compression_mode(self.stream, zfp_type_none, arr.ndim, self.tolerance, self.rate, self.precision)
+            self.ndim = arr.ndim
+        return zfp_stream_maximum_size(self.stream, field)
+
+    cdef void* _reserve(self, size_t size) except NULL:
+        # grow the scratch buffer to at least size bytes
+        cdef void* buffer
+        if size > self.buffer_size:
+            buffer = realloc(self.buffer, size)
+            if buffer == NULL:
+                raise MemoryError()
+            self.buffer = buffer
+            self.buffer_size = size
+        return self.buffer
+
+    def compress(self, np.ndarray arr, out=None):
+        # Compress arr and return the compressed bytes, or the number of
+        # bytes written when compressing into the writable buffer out
+        cdef size_t maxsize = self._prepare(arr, self.field)
+        cdef size_t compressed_size
+        cdef uint8_t[::1] out_view
+        if out is None:
+            compressed_size = _compress_to(self.stream, self.field, self._reserve(maxsize), maxsize, self.write_header)
+            return (<char *>self.buffer)[:compressed_size]
+        out_view = out
+        if <size_t>out_view.shape[0] < maxsize:
+            raise ValueError(
+                "Out buffer has {} bytes but compression may require "
+                "{} bytes".format(out_view.shape[0], maxsize)
+            )
+        return _compress_to(self.stream, self.field, <void *>&out_view[0], maxsize, self.write_header)
+
+    def compress_many(self, arrays):
+        # Compress each array to its own stream and return a list of bytes.
+        # Streams are written back to back into the scratch buffer, which
+        # word aligns each of them, in a single pass without the GIL.
+        arrays = list(arrays)
+        cdef size_t count = len(arrays)
+        if count == 0:
+            return []
+        cdef zfp_field** fields = <zfp_field**>calloc(count, sizeof(zfp_field*))
+        cdef stdint.uint64_t* modes = <stdint.uint64_t*>malloc(count * sizeof(stdint.uint64_t))
+        cdef size_t* ends = <size_t*>malloc(count * sizeof(size_t))
+        cdef bitstream* bstream = NULL
+        cdef size_t total = 0
+        cdef size_t i
+        cdef size_t failed = count
+        cdef bint header = self.write_header
+        try:
+            if fields == NULL or modes == NULL or ends == NULL:
+                raise MemoryError()
+            for i in range(count):
+                fields[i] = zfp_field_alloc()
+                if fields[i] == NULL:
+                    raise MemoryError()
+                total += self._prepare(arrays[i], fields[i])
+                modes[i] = zfp_stream_mode(self.stream)
+
+            bstream = stream_open(self._reserve(total), total)
+            if bstream == NULL:
+                raise MemoryError()
+            zfp_stream_set_bit_stream(self.stream, bstream)
+            zfp_stream_rewind(self.stream)
+            with nogil:
+                for i in range(count):
+                    zfp_stream_set_mode(self.stream, modes[i])
+                    if header and zfp_write_header(self.stream, fields[i], ZFP_HEADER_FULL) == 0:
+                        failed = i
+                        break
+                    ends[i] = zfp_compress(self.stream, fields[i])
+                    if ends[i] == 0:
+                        failed = i
+                        break
+            if failed < count:
+                raise RuntimeError("Failed to compress array {}".format(failed))
+
+            # restore the mode for the dimensionality last prepared
+            zfp_stream_set_mode(self.stream, modes[count - 1])
+            return [
+                (<char *>self.buffer)[(ends[i - 1] if i else 0):ends[i]]
+                for i in range(count)
+            ]
+        finally:
+            if bstream != NULL:
+                zfp_stream_set_bit_stream(self.stream, NULL)
+                stream_close(bstream)
+            if fields != NULL:
+                for i in range(count):
+                    if fields[i] != NULL:
+                        zfp_field_free(fields[i])
+            free(fields)
+            free(modes)
+            free(ends)
+
+@cython.final
+cdef class Decompressor:
+    # Decompresses a sequence of streams with one zfp stream and field.
+    # Streams carry a full header unless dtype and shape are given, in which
+    # case they are header-less streams compressed with the given mode.
+    cdef zfp_stream* stream
+    cdef zfp_field* field
+    cdef object dtype
+    cdef tuple shape
+
+    def __cinit__(
+        self,
+        dtype=None,
+        shape=None,
+        double tolerance = -1,
+        double rate = -1,
+        int precision = -1,
+        execution=exec_serial,
+        int threads = 0,
+        int chunk_size = 0,
+    ):
+        if (dtype is None) != (shape is None):
+            raise TypeError("dtype and shape must be given together")
+        num_params_set = sum([1 for x in [tolerance, rate, precision] if x >= 0])
+        if num_params_set > 1:
+            raise ValueError("Only one of tolerance, rate, or precision can be set")
+        if dtype is None and num_params_set:
+            raise ValueError("Compression mode is read from the header unless dtype and shape are given")
+        self.stream = zfp_stream_open(NULL)
+        self.field = zfp_field_alloc()
+        if self.stream == NULL or self.field == NULL:
+            raise MemoryError()
+        _set_execution(self.stream, execution, threads, chunk_size)
+        if dtype is not None:
+            _validate_4d_list(shape, "shape")
+            self.dtype = np.dtype(dtype)
+            self.shape = tuple(shape)
+            _set_field(self.field, NULL, dtype_to_ztype(self.dtype), self.shape, _contiguous_strides(self.shape))
+            _set_compression_mode(self.stream, zfp_type_none, len(self.shape), tolerance, rate, precision)
+
+    def __dealloc__(self):
+        if self.stream != NULL:
+            zfp_stream_close(self.stream)
+        if self.field != NULL:
+            zfp_field_free(self.field)
+
+    cdef np.ndarray _output(self, zfp_field* field, out):
+        cdef zfp_type ztype = field[0]._type
+        shape = _field_shape(field)
+        if out is None:
+            return np.empty(shape, dtype=ztype_to_dtype(ztype))
+        return _output_array(out, ztype, shape)
+
+    def decompress(self, const uint8_t[::1] compressed_data, out=None):
+        # Decompress one stream into a new array or into out
+        if compressed_data is None:
+            raise TypeError("compressed_data cannot be None")
+        if compressed_data is out:
+            raise ValueError("Cannot decompress in-place")
+        cdef bitstream* bstream = stream_open(<void *>&compressed_data[0], len(compressed_data))
+        cdef np.ndarray output
+        try:
+            zfp_stream_set_bit_stream(self.stream, bstream)
+            zfp_stream_rewind(self.stream)
+            if self.dtype is None and zfp_read_header(self.stream, self.field, HEADER_FULL) == 0:
+                raise ValueError("Failed to read required zfp header")
+            output = self._output(self.field, out)
+            _decompress_with_user_array(self.field, self.stream, <void *>output.data)
+        finally:
+            zfp_stream_set_bit_stream(self.stream, NULL)
+            stream_close(bstream)
+        return output
+
+    def decompress_many(self, streams):
+        # Decompress each stream into a new array and return the list of
+        # arrays; headers are parsed up front and the streams are then
+        # decompressed in a single pass without the GIL
+        streams = list(streams)
+        cdef size_t count = len(streams)
+        if count == 0:
+            return []
+        cdef zfp_field** fields = <zfp_field**>calloc(count, sizeof(zfp_field*))
+        cdef void** data = <void**>malloc(count * sizeof(void*))
+        cdef size_t* sizes = <size_t*>malloc(count * sizeof(size_t))
+        cdef const uint8_t[::1] view
+        cdef bitstream* bstream = NULL
+        cdef bint header = self.dtype is None
+        cdef size_t i
+        cdef size_t failed = count
+        outputs = []
+        try:
+            if fields == NULL or data == NULL or sizes == NULL:
+                raise MemoryError()
+            for i in range(count):
+                view = streams[i]
+                data[i] = <void *>&view[0]
+                sizes[i] = view.shape[0]
+                fields[i] = zfp_field_alloc()
+                if fields[i] == NULL:
+                    raise MemoryError()
+                if header:
+                    bstream = stream_open(data[i], sizes[i])
+                    zfp_stream_set_bit_stream(self.stream, bstream)
+                    zfp_stream_rewind(self.stream)
+                    if zfp_read_header(self.stream, fields[i], HEADER_FULL) == 0:
+                        raise ValueError("Failed to read zfp header of stream {}".format(i))
+                    zfp_stream_set_bit_stream(self.stream, NULL)
+                    stream_close(bstream)
+                    bstream = NULL
+                else:
+                    fields[i][0] = self.field[0]
+                outputs.append(self._output(fields[i], None))
+                zfp_field_set_pointer(fields[i], <void *>(<np.ndarray>outputs[i]).data)
+
+            with nogil:
+                for i in range(count):
+                    bstream = stream_open(data[i], sizes[i])
+                    zfp_stream_set_bit_stream(self.stream, bstream)
+                    zfp_stream_rewind(self.stream)
+                    # the header also sets the compression mode of the stream
+                    if header and zfp_read_header(self.stream, fields[i], ZFP_HEADER_FULL) == 0:
+                        failed = i
+                    elif zfp_decompress(self.stream, fields[i]) == 0:
+                        failed = i
+                    zfp_stream_set_bit_stream(self.stream, NULL)
+                    stream_close(bstream)
+                    bstream = NULL
+                    if failed < count:
+                        break
+            if failed < count:
+                raise RuntimeError("Failed to decompress stream {}".format(failed))
+        finally:
+            if bstream != NULL:
+                zfp_stream_set_bit_stream(self.stream, NULL)
+                stream_close(bstream)
+            if fields != NULL:
+                for i in range(count):
+                    if fields[i] != NULL:
+                        zfp_field_free(fields[i])
+            free(fields)
+            free(data)
+            free(sizes)
+        return outputs
+
+cdef _device_execution(DeviceArray arr, execution):
+    # Default to the execution policy of the device holding arr
+    return arr.policy if execution is None else execution
+
+cpdef size_t compress_device(
+    arr,
+    out,
+    double tolerance = -1,
+    double rate = -1,
+    int precision = -1,
+    execution=None,
+):
+    # Input validation
+    if arr is None or out is None:
+        raise TypeError("Input array and out buffer cannot be None")
+    num_params_set = sum([1 for x in [tolerance, rate, precision] if x >= 0])
+    if num_params_set > 1:
+        raise ValueError("Only one of tolerance, rate, or precision can be set")
+
+    cdef DeviceArray field_array = DeviceArray(arr)
+    cdef DeviceArray stream_array = DeviceArray(out)
+    cdef size_t size = stream_array.nbytes()
+
+    # Setup zfp structs to begin compression
+    cdef zfp_field* field = _init_device_field(field_array)
+    cdef zfp_stream* stream = zfp_stream_open(NULL)
+    cdef size_t maxsize
+    cdef size_t compressed_size
+    try:
+        ndim = len(field_array.shape)
+        _set_compression_mode(stream, field[0]._type, ndim, tolerance, rate, precision)
+        _set_execution(stream, _device_execution(field_array, execution))
+
+        maxsize = zfp_stream_maximum_size(stream, field)
+        if size < maxsize:
+            raise ValueError(
+                "Out buffer has {} bytes but compression may require "
+                "{} bytes".format(size, maxsize)
+            )
+        # device memory cannot be written by the host, so no header is written
+        compressed_size = _compress_to(stream, field, stream_array.data, size, False)
+    finally:
+        zfp_field_free(field)
+        zfp_stream_close(stream)
+
+    return compressed_size
+
+cpdef decompress_device(
+    compressed_data,
+    out,
+    double tolerance = -1,
+    double rate = -1,
+    int precision = -1,
+    execution=None,
+):
+    if compressed_data is None or out is None:
+        raise TypeError("compressed_data and out cannot be None")
+
+    cdef DeviceArray field_array = DeviceArray(out)
+    cdef DeviceArray stream_array
+    cdef const uint8_t[::1] host_data
+    cdef void* comp_data_pointer
+    cdef size_t size
+
+    # the compressed stream may reside in either device or host memory
+    if (hasattr(compressed_data, "__cuda_array_interface__") or
+        hasattr(compressed_data, "__dlpack__")):
+        stream_array = DeviceArray(compressed_data)
+        comp_data_pointer = stream_array.data
+        size = stream_array.nbytes()
+    else:
+        host_data = compressed_data
+        comp_data_pointer = <void *>&host_data[0]
+        size = len(host_data)
+
+    cdef zfp_field* field = _init_device_field(field_array)
+    cdef bitstream* bstream = stream_open(comp_data_pointer, size)
+    cdef zfp_stream* stream = zfp_stream_open(bstream)
+    cdef size_t ret
+
+    try:
+        zfp_stream_rewind(stream)
+        ndim = len(field_array.shape)
+        _set_compression_mode(stream, field[0]._type, ndim, tolerance, rate, precision)
+        _set_execution(stream, _device_execution(field_array, execution))
+        with nogil:
+            ret = zfp_decompress(stream, field)
+        if ret == 0:
+            raise RuntimeError("error during zfp decompression")
+    finally:
+        zfp_field_free(field)
+        zfp_stream_close(stream)
+        stream_close(bstream)
+
+    return out
+
+cdef _index_range(key, size_t n):
+    # start, step, and count of indices selected by an integer or slice key
+    if isinstance(key, slice):
+        start, stop, step = key.indices(n)
+        return start, step, len(range(start, stop, step)), True
+    i = operator.index(key)
+    if i < 0:
+        i += n
+    if i < 0 or i >= n:
+        raise IndexError("index {} is out of bounds for size {}".format(key, n))
+    return i, 1, 1, False
+
+cdef class array3d:
+    # Compressed 3D array of doubles backed by cfp, indexed NumPy style as
+    # a[z, y, x] with x varying fastest; values are (de)compressed on demand
+    # through a software cache of decompressed blocks
+    cdef cfp_array3d arr
+
+    def __cinit__(self, shape, double rate, data=None, size_t cache_size=0):
+        _validate_4d_list(shape, "shape")
+        if len(shape) != 3:
+            raise ValueError("array3d requires a 3D shape")
+        nz, ny, nx = [int(x) for x in shape]
+        self.arr = cfp.array3d.ctor(nx, ny, nz, rate, NULL, cache_size)
+        if data is not None:
+            self.set(data)
+
+    def __dealloc__(self):
+        if self.arr.object != NULL:
+            cfp.array3d.dtor(self.arr)
+
+    @property
+    def shape(self):
+        return (
+            cfp.array3d.size_z(self.arr),
+            cfp.array3d.size_y(self.arr),
+            cfp.array3d.size_x(self.arr),
+        )
+
+    @property
+    def rate(self):
+        return cfp.array3d.rate(self.arr)
+
+    @property
+    def cache_size(self):
+        return cfp.array3d.cache_size(self.arr)
+
+    @cache_size.setter
+    def cache_size(self, size_t bytes):
+        cfp.array3d.set_cache_size(self.arr, bytes)
+
+    @property
+    def compressed_size(self):
+        return cfp.array3d.compressed_size(self.arr)
+
+    def flush_cache(self):
+        cfp.array3d.flush_cache(self.arr)
+
+    def clear_cache(self):
+        cfp.array3d.clear_cache(self.arr)
+
+    def get(self, out=None):
+        # decompress the whole array into out, or into a new ndarray
+        cdef np.ndarray[double, ndim=3, mode="c"] output
+        if out is None:
+            out = np.empty(self.shape, dtype=np.float64)
+        output = out
+        if output.shape[0] != self.shape[0] or output.shape[1] != self.shape[1] or output.shape[2] != self.shape[2]:
+            raise ValueError("Out ndarray has shape {} but array has shape {}".format(out.shape, self.shape))
+        with nogil:
+            cfp.array3d.get_array(self.arr, <double *>output.data)
+        return out
+
+    def set(self, data):
+        # compress a whole array of values given in C order
+        cdef np.ndarray[double, ndim=3, mode="c"] values = np.ascontiguousarray(data, dtype=np.float64)
+        if values.shape[0] != self.shape[0] or values.shape[1] != self.shape[1] or values.shape[2] != self.shape[2]:
+            raise ValueError("Data has shape {} but array has shape {}".format(values.shape, self.shape))
+        with nogil:
+            cfp.array3d.set_array(self.arr, <const double *>values.data)
+
+    def _ranges(self, key):
+        if not isinstance(key, tuple):
+            key = (key,)
+        if len(key) > 3:
+            raise IndexError("too many indices for array3d")
+        key = key + (slice(None),) * (3 - len(key))
+        return [_index_range(k, n) for k, n in zip(key, self.shape)]
+
+    @cython.boundscheck(False)
+    @cython.wraparound(False)
+    def __getitem__(self, key):
+        ranges = self._ranges(key)
+        (z0, dz, nz, zs), (y0, dy, ny, ys), (x0, dx, nx, xs) = ranges
+        if not (zs or ys or xs):
+            return cfp.array3d.get(self.arr, x0, y0, z0)
+        cdef np.ndarray[double, ndim=3, mode="c"] output = np.empty((nz, ny, nx), dtype=np.float64)
+        cdef Py_ssize_t i, j, k
+        cdef Py_ssize_t cx0 = x0, cy0 = y0, cz0 = z0
+        cdef Py_ssize_t cdx = dx, cdy = dy, cdz = dz
+        cdef Py_ssize_t cnx = nx, cny = ny, cnz = nz
+        with nogil:
+            for k in range(cnz):
+                for j in range(cny):
+                    for i in range(cnx):
+                        output[k, j, i] = cfp.array3d.get(self.arr, cx0 + cdx * i, cy0 + cdy * j, cz0 + cdz * k)
+        # drop dimensions indexed by integers, as NumPy does
+        return output[tuple([slice(None) if s else 0 for (_, _, _, s) in ranges])]
+
+    @cython.boundscheck(False)
+    @cython.wraparound(False)
+    def __setitem__(self, key, value):
+        (z0, dz, nz, zs), (y0, dy, ny, ys), (x0, dx, nx, xs) = self._ranges(key)
+        # broadcast value to the selection, which omits integer-indexed
+        # dimensions, before restoring them
+        selection = tuple([n for n, s in ((nz, zs), (ny, ys), (nx, xs)) if s])
+        value = np.broadcast_to(np.asarray(value, dtype=np.float64), selection)
+        cdef np.ndarray[double, ndim=3, mode="c"] values = np.ascontiguousarray(
+            value.reshape((nz, ny, nx))
+        )
+        cdef Py_ssize_t i, j, k
+        cdef Py_ssize_t cx0 = x0, cy0 = y0, cz0 = z0
+        cdef Py_ssize_t cdx = dx, cdy = dy, cdz = dz
+        cdef Py_ssize_t cnx = nx, cny = ny, cnz = nz
+        with nogil:
+            for k in range(cnz):
+                for j in range(cny):
+                    for i in range(cnx):
+                        cfp.array3d.set(self.arr, cx0 + cdx * i, cy0 + cdy * j, cz0 + cdz * k, values[k, j, i])
+
+    def __reduce__(self):
+        # pickle the compressed representation rather than the values
+        cfp.array3d.flush_cache(self.arr)
+        cdef size_t size = cfp.array3d.compressed_size(self.arr)
+        cdef bytes data = (<char *>cfp.array3d.compressed_data(self.arr))[:size]
+        return (_array3d_from_compressed, (self.shape, self.rate, data, self.cache_size))
+
+def _array3d_from_compressed(shape, double rate, const uint8_t[::1] data, size_t cache_size):
+    cdef array3d a = array3d(shape, rate, None, cache_size)
+    if <size_t>data.shape[0] != cfp.array3d.compressed_size(a.arr):
+        raise ValueError("Compressed data does not match array3d shape and rate")
+    memcpy(cfp.array3d.compressed_data(a.arr), &data[0], data.shape[0])
+    return a
+
+cdef class array3i:
+    # Compressed 3D array of 32-bit integers backed by cfp, indexed NumPy
+    # style as a[z, y, x] with x varying fastest; values are stored exactly
+    # when reversible and otherwise at a fixed rate that discards low bits
+    cdef cfp_array3i arr
+    cdef readonly bint reversible
+
+    def __cinit__(self, shape, double rate, data=None, size_t cache_size=0, bint reversible=False):
+        _validate_4d_list(shape, "shape")
+        if len(shape) != 3:
+            raise ValueError("array3i requires a 3D shape")
+        nz, ny, nx = [int(x) for x in shape]
+        self.arr = cfp.array3i.ctor(nx, ny, nz, rate, NULL, cache_size)
+        # reversible (lossless) storage replaces fixed-rate storage
+        self.reversible = reversible
+        if reversible:
+            cfp.array3i.set_reversible(self.arr)
+        if data is not None:
+            self.set(data)
+
+    def __dealloc__(self):
+        if self.arr.object != NULL:
+            cfp.array3i.dtor(self.arr)
+
+    @property
+    def shape(self):
+        return (
+            cfp.array3i.size_z(self.arr),
+            cfp.array3i.size_y(self.arr),
+            cfp.array3i.size_x(self.arr),
+        )
+
+    @property
+    def rate(self):
+        return cfp.array3i.rate(self.arr)
+
+    @property
+    def cache_size(self):
+        return cfp.array3i.cache_size(self.arr)
+
+    @cache_size.setter
+    def cache_size(self, size_t bytes):
+        cfp.array3i.set_cache_size(self.arr, bytes)
+
+    @property
+    def compressed_size(self):
+        return cfp.array3i.compressed_size(self.arr)
+
+    def flush_cache(self):
+        cfp.array3i.flush_cache(self.arr)
+
+    def clear_cache(self):
+        cfp.array3i.clear_cache(self.arr)
+
+    def get(self, out=None):
+        # decompress the whole array into out, or into a new ndarray
+        cdef np.ndarray[np.int32_t, ndim=3, mode="c"] output
+        if out is None:
+            out = np.empty(self.shape, dtype=np.int32)
+        output = out
+        if output.shape[0] != self.shape[0] or output.shape[1] != self.shape[1] or output.shape[2] != self.shape[2]:
+            raise ValueError("Out ndarray has shape {} but array has shape {}".format(out.shape, self.shape))
+        with nogil:
+            cfp.array3i.get_array(self.arr, <stdint.int32_t *>output.data)
+        return out
+
+    def set(self, data):
+        # compress a whole array of values given in C order
+        cdef np.ndarray[np.int32_t, ndim=3, mode="c"] values = np.ascontiguousarray(data, dtype=np.int32)
+        if values.shape[0] != self.shape[0] or values.shape[1] != self.shape[1] or values.shape[2] != self.shape[2]:
+            raise ValueError("Data has shape {} but array has shape {}".format(values.shape, self.shape))
+        with nogil:
+            cfp.array3i.set_array(self.arr, <const stdint.int32_t *>values.data)
+
+    def _ranges(self, key):
+        if not isinstance(key, tuple):
+            key = (key,)
+        if len(key) > 3:
+            raise IndexError("too many indices for array3i")
+        key = key + (slice(None),) * (3 - len(key))
+        return [_index_range(k, n) for k, n in zip(key, self.shape)]
+
+    @cython.boundscheck(False)
+    @cython.wraparound(False)
+    def __getitem__(self, key):
+        ranges = self._ranges(key)
+        (z0, dz, nz, zs), (y0, dy, ny, ys), (x0, dx, nx, xs) = ranges
+        if not (zs or ys or xs):
+            return cfp.array3i.get(self.arr, x0, y0, z0)
+        cdef np.ndarray[np.int32_t, ndim=3, mode="c"] output = np.empty((nz, ny, nx), dtype=np.int32)
+        cdef Py_ssize_t i, j, k
+        cdef Py_ssize_t cx0 = x0, cy0 = y0, cz0 = z0
+        cdef Py_ssize_t cdx = dx, cdy = dy, cdz = dz
+        cdef Py_ssize_t cnx = nx, cny = ny, cnz = nz
+        with nogil:
+            for k in range(cnz):
+                for j in range(cny):
+                    for i in range(cnx):
+                        output[k, j, i] = cfp.array3i.get(self.arr, cx0 + cdx * i, cy0 + cdy * j, cz0 + cdz * k)
+        # drop dimensions indexed by integers, as NumPy does
+        return output[tuple([slice(None) if s else 0 for (_, _, _, s) in ranges])]
+
+    @cython.boundscheck(False)
+    @cython.wraparound(False)
+    def __setitem__(self, key, value):
+        (z0, dz, nz, zs), (y0, dy, ny, ys), (x0, dx, nx, xs) = self._ranges(key)
+        # broadcast value to the selection, which omits integer-indexed
+        # dimensions, before restoring them
+        selection = tuple([n for n, s in ((nz, zs), (ny, ys), (nx, xs)) if s])
+        value = np.broadcast_to(np.asarray(value, dtype=np.int32), selection)
+        cdef np.ndarray[np.int32_t, ndim=3, mode="c"] values = np.ascontiguousarray(
+            value.reshape((nz, ny, nx))
+        )
+        cdef Py_ssize_t i, j, k
+        cdef Py_ssize_t cx0 = x0, cy0 = y0, cz0 = z0
+        cdef Py_ssize_t cdx = dx, cdy = dy, cdz = dz
+        cdef Py_ssize_t cnx = nx, cny = ny, cnz = nz
+        with nogil:
+            for k in range(cnz):
+                for j in range(cny):
+                    for i in range(cnx):
+                        cfp.array3i.set(self.arr, cx0 + cdx * i, cy0 + cdy * j, cz0 + cdz * k, values[k, j, i])
+
+    def __reduce__(self):
+        # variable-rate storage has no fixed layout, so pickle the exactly
+        # represented values of reversible arrays
+        if self.reversible:
+            return (array3i, (self.shape, self.rate, self.get(), self.cache_size, True))
+        # pickle the compressed representation rather than the values
+        cfp.array3i.flush_cache(self.arr)
+        cdef size_t size = cfp.array3i.compressed_size(self.arr)
+        cdef bytes data = (<char *>cfp.array3i.compressed_data(self.arr))[:size]
+        return (_array3i_from_compressed, (self.shape, self.rate, data, self.cache_size))
+
+def _array3i_from_compressed(shape, double rate, const uint8_t[::1] data, size_t cache_size):
+    cdef array3i a = array3i(shape, rate, None, cache_size)
+    if <size_t>data.shape[0] != cfp.array3i.compressed_size(a.arr):
+        raise ValueError("Compressed data does not match array3i shape and rate")
+    memcpy(cfp.array3i.compressed_data(a.arr), &data[0], data.shape[0])
+    return a
+
+cdef class array3l:
+    # Compressed 3D array of 64-bit integers backed by cfp, indexed NumPy
+    # style as a[z, y, x] with x varying fastest; values are stored exactly
+    # when reversible and otherwise at a fixed rate that discards low bits
+    cdef cfp_array3l arr
+    cdef readonly bint reversible
+
+    def __cinit__(self, shape, double rate, data=None, size_t cache_size=0, bint reversible=False):
+        _validate_4d_list(shape, "shape")
+        if len(shape) != 3:
+            raise ValueError("array3l requires a 3D shape")
+        nz, ny, nx = [int(x) for x in shape]
+        self.arr = cfp.array3l.ctor(nx, ny, nz, rate, NULL, cache_size)
+        # reversible (lossless) storage replaces fixed-rate storage
+        self.reversible = reversible
+        if reversible:
+            cfp.array3l.set_reversible(self.arr)
+        if data is not None:
+            self.set(data)
+
+    def __dealloc__(self):
+        if self.arr.object != NULL:
+            cfp.array3l.dtor(self.arr)
+
+    @property
+    def shape(self):
+        return (
+            cfp.array3l.size_z(self.arr),
+            cfp.array3l.size_y(self.arr),
+            cfp.array3l.size_x(self.arr),
+        )
+
+    @property
+    def rate(self):
+        return cfp.array3l.rate(self.arr)
+
+    @property
+    def cache_size(self):
+        return cfp.array3l.cache_size(self.arr)
+
+    @cache_size.setter
+    def cache_size(self, size_t bytes):
+        cfp.array3l.set_cache_size(self.arr, bytes)
+
+    @property
+    def compressed_size(self):
+        return cfp.array3l.compressed_size(self.arr)
+
+    def flush_cache(self):
+        cfp.array3l.flush_cache(self.arr)
+
+    def clear_cache(self):
+        cfp.array3l.clear_cache(self.arr)
+
+    def get(self, out=None):
+        # decompress the whole array into out, or into a new ndarray
+        cdef np.ndarray[np.int64_t, ndim=3, mode="c"] output
+        if out is None:
+            out = np.empty(self.shape, dtype=np.int64)
+        output = out
+        if output.shape[0] != self.shape[0] or output.shape[1] != self.shape[1] or output.shape[2] != self.shape[2]:
+            raise ValueError("Out ndarray has shape {} but array has shape {}".format(out.shape, self.shape))
+        with nogil:
+            cfp.array3l.get_array(self.arr, <stdint.int64_t *>output.data)
+        return out
+
+    def set(self, data):
+        # compress a whole array of values given in C order
+        cdef np.ndarray[np.int64_t, ndim=3, mode="c"] values = np.ascontiguousarray(data, dtype=np.int64)
+        if values.shape[0] != self.shape[0] or values.shape[1] != self.shape[1] or values.shape[2] != self.shape[2]:
+            raise ValueError("Data has shape {} but array has shape {}".format(values.shape, self.shape))
+        with nogil:
+            cfp.array3l.set_array(self.arr, <const stdint.int64_t *>values.data)
+
+    def _ranges(self, key):
+        if not isinstance(key, tuple):
+            key = (key,)
+        if len(key) > 3:
+            raise IndexError("too many indices for array3l")
+        key = key + (slice(None),) * (3 - len(key))
+        return [_index_range(k, n) for k, n in zip(key, self.shape)]
+
+    @cython.boundscheck(False)
+    @cython.wraparound(False)
+    def __getitem__(self, key):
+        ranges = self._ranges(key)
+        (z0, dz, nz, zs), (y0, dy, ny, ys), (x0, dx, nx, xs) = ranges
+        if not (zs or ys or xs):
+            return cfp.array3l.get(self.arr, x0, y0, z0)
+        cdef np.ndarray[np.int64_t, ndim=3, mode="c"] output = np.empty((nz, ny, nx), dtype=np.int64)
+        cdef Py_ssize_t i, j, k
+        cdef Py_ssize_t cx0 = x0, cy0 = y0, cz0 = z0
+        cdef Py_ssize_t cdx = dx, cdy = dy, cdz = dz
+        cdef Py_ssize_t cnx = nx, cny = ny, cnz = nz
+        with nogil:
+            for k in range(cnz):
+                for j in range(cny):
+                    for i in range(cnx):
+                        output[k, j, i] = cfp.array3l.get(self.arr, cx0 + cdx * i, cy0 + cdy * j, cz0 + cdz * k)
+        # drop dimensions indexed by integers, as NumPy does
+        return output[tuple([slice(None) if s else 0 for (_, _, _, s) in ranges])]
+
+    @cython.boundscheck(False)
+    @cython.wraparound(False)
+    def __setitem__(self, key, value):
+        (z0, dz, nz, zs), (y0, dy, ny, ys), (x0, dx, nx, xs) = self._ranges(key)
+        # broadcast value to the selection, which omits integer-indexed
+        # dimensions, before restoring them
+        selection = tuple([n for n, s in ((nz, zs), (ny, ys), (nx, xs)) if s])
+        value = np.broadcast_to(np.asarray(value, dtype=np.int64), selection)
+        cdef np.ndarray[np.int64_t, ndim=3, mode="c"] values = np.ascontiguousarray(
+            value.reshape((nz, ny, nx))
+        )
+        cdef Py_ssize_t i, j, k
+        cdef Py_ssize_t cx0 = x0, cy0 = y0, cz0 = z0
+        cdef Py_ssize_t cdx = dx, cdy = dy, cdz = dz
+        cdef Py_ssize_t cnx = nx, cny = ny, cnz = nz
+        with nogil:
+            for k in range(cnz):
+                for j in range(cny):
+                    for i in range(cnx):
+                        cfp.array3l.set(self.arr, cx0 + cdx * i, cy0 + cdy * j, cz0 + cdz * k, values[k, j, i])
+
+    def __reduce__(self):
+        # variable-rate storage has no fixed layout, so pickle the exactly
+        # represented values of reversible arrays
+        if self.reversible:
+            return (array3l, (self.shape, self.rate, self.get(), self.cache_size, True))
+        # pickle the compressed representation rather than the values
+        cfp.array3l.flush_cache(self.arr)
+        cdef size_t size = cfp.array3l.compressed_size(self.arr)
+        cdef bytes data = (<char *>cfp.array3l.compressed_data(self.arr))[:size]
+        return (_array3l_from_compressed, (self.shape, self.rate, data, self.cache_size))
+
+def _array3l_from_compressed(shape, double rate, const uint8_t[::1] data, size_t cache_size):
+    cdef array3l a = array3l(shape, rate, None, cache_size)
+    if <size_t>data.shape[0] != cfp.array3l.compressed_size(a.arr):
+        raise ValueError("Compressed data does not match array3l shape and rate")
+    memcpy(cfp.array3l.compressed_data(a.arr), &data[0], data.shape[0])
+    return a
+
+cpdef size_t compress_file(
+    source,
+    out_path,
+    shape=None,
+    dtype=None,
+    double rate = -1,
+    write_header=True,
+    size_t slab_size = 0,
+    execution=exec_serial,
+    int threads = 0,
+    int chunk_size = 0,
+):
+    # Compress a raw array, given as a path or as an (e.g., memory-mapped)
+    # ndarray in C order, to a file one slab of the slowest varying dimension
+    # at a time and return the number of bytes written.  Fixed-rate blocks
+    # have a known size, so slabs are concatenated bit for bit and the file
+    # matches the stream that compress_numpy would produce.
+    if rate < 0:
+        raise ValueError("compress_file requires fixed-rate mode")
+    if isinstance(source, np.ndarray):
+        arr = source
+        if dtype is not None and arr.dtype != np.dtype(dtype):
+            raise ValueError("Array has dtype {} but {} was given".format(arr.dtype, dtype))
+        if shape is not None and arr.shape != tuple(shape):
+            raise ValueError("Array has shape {} but {} was given".format(arr.shape, shape))
+    else:
+        if shape is None or dtype is None:
+            raise TypeError("shape and dtype are required when reading a file")
+        arr = np.memmap(source, dtype=dtype, mode="r", shape=tuple(shape))
+
+    # slabs consist of whole blocks along the slowest varying dimension and
+    # by default span roughly 256 MB of uncompressed data
+    cdef size_t nslow = arr.shape[0]
+    cdef size_t plane_bytes = arr.itemsize * functools.reduce(operator.mul, arr.shape[1:], 1)
+    if slab_size == 0:
+        slab_size = 4 * max(1, (1 << 28) // (4 * plane_bytes))
+    elif slab_size % 4:
+        raise ValueError("slab_size must be a multiple of four")
+    cdef size_t nblocks = functools.reduce(operator.mul, [(n + 3) // 4 for n in arr.shape[1:]], 1)
+
+    cdef zfp_field* field = _init_field(arr)
+    cdef zfp_field* slab_field = NULL
+    cdef zfp_stream* stream = zfp_stream_open(NULL)
+    cdef bitstream* bstream = NULL
+    cdef zfp_type ztype = field[0]._type
+    cdef cython.uint maxbits
+    cdef size_t maxsize
+    cdef size_t offset = 0
+    cdef size_t total = 0
+    cdef size_t words
+    cdef size_t compressed_size
+    try:
+        _set_compression_mode(stream, ztype, arr.ndim, -1, rate, -1)
+        _set_execution(stream, execution, threads, chunk_size)
+        zfp_stream_params(stream, NULL, &maxbits, NULL, NULL)
+
+        # buffer holds one compressed slab, the header, and the partial word
+        # carried over from the previous slab
+        slab_field = _init_field(arr[:slab_size])
+        maxsize = zfp_stream_maximum_size(stream, slab_field) + sizeof(stdint.uint64_t)
+        zfp_field_free(slab_field)
+        slab_field = NULL
+
+        with Memory(maxsize) as data, open(out_path, "wb") as f:
+            bstream = stream_open(data, maxsize)
+            zfp_stream_set_bit_stream(stream, bstream)
+            zfp_stream_rewind(stream)
+            if write_header:
+                if zfp_write_header(stream, field, HEADER_FULL) == 0:
+                    raise RuntimeError("Failed to write header to stream")
+                offset = stream_wtell(bstream)
+
+            for z in range(0, nslow, slab_size):
+                slab_field = _init_field(arr[z:z + slab_size])
+                with nogil:
+                    compressed_size = zfp_compress(stream, slab_field)
+                zfp_field_free(slab_field)
+                slab_field = NULL
+                if compressed_size == 0:
+                    raise RuntimeError("Failed to write to stream")
+
+                # write whole words, then continue the next slab right after
+                # the last block rather than after the padding of the flush
+                offset += nblocks * ((min(z + slab_size, nslow) - z + 3) // 4) * maxbits
+                words = offset // 64
+                f.write((<char *>data)[:8 * words])
+                total += 8 * words
+                if offset % 64:
+                    memcpy(data, <char *>data + 8 * words, 8)
+                offset %= 64
+                stream_wseek(bstream, offset)
+
+            # the final partial word is padded with zeros
+            if offset:
+                f.write((<char *>data)[:8])
+                total += 8
+    finally:
+        if slab_field != NULL:
+            zfp_field_free(slab_field)
+        zfp_field_free(field)
+        zfp_stream_close(stream)
+        if bstream != NULL:
+            stream_close(bstream)
+
+    return total
@@ -2,3 +2,7 @@
 #include "inline/bitstream.c"
 
 const size_t stream_word_bits = wsize;
+const size_t stream_struct_bytes = sizeof(bitstream);
+
+/* compile-time check that stream_storage can hold the bit stream struct */
+typedef char stream_storage_fits[sizeof(bitstream) <= sizeof(stream_storage) ? 1 : -1];
@@ -5,17 +5,36 @@
 #include "encode1.cuh"
 #include "encode2.cuh"
 #include "encode3.cuh"
+#include "encode4.cuh"
 
 #include "decode1.cuh"
 #include "decode2.cuh"
 #include "decode3.cuh"
+#include "decode4.cuh"
 
 #include "ErrorCheck.h"
 
 #include "pointers.cuh"
+#include "trace.cuh"
 #include "type_info.cuh"
+#include <cstring>
 #include <iostream>
+#include <map>
+#include <mutex>
+#include <vector>
 #include <assert.h>
+#if __cplusplus >= 201103L
+#include <thread>
+#endif
+#include <thrust/execution_policy.h>
+#include <thrust/system/cuda/execution_policy.h>
+#include <thrust/scan.h>
+#include <cstdio>
+#ifdef ZFP_WITH_CUFILE
+#include <cufile.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 // we need to know about bitstream, but we don't 
 // want duplicate symbols.
@@ -27,7 +46,31 @@
 namespace internal 
 { 
   
-bool is_contigous3d(const uint dims[3], const int3 &stride, long long int &offset)
+bool is_contigous4d(const uint dims[4], const int4 &stride, long long int &offset)
+{
+  typedef long long int int64;
+  int64 idims[4];
+  idims[0] = dims[0];
+  idims[1] = dims[1];
+  idims[2] = dims[2];
+  idims[3] = dims[3];
+
+  int64 imin = std::min(stride.x,0) * (idims[0] - 1) + 
+               std::min(stride.y,0) * (idims[1] - 1) + 
+               std::min(stride.z,0) * (idims[2] - 1) + 
+               std::min(stride.w,0) * (idims[3] - 1);
+
+  int64 imax = std::max(stride.x,0) * (idims[0] - 1) + 
+               std::max(stride.y,0) * (idims[1] - 1) + 
+               std::max(stride.z,0) * (idims[2] - 1) + 
+               std::max(stride.w,0) * (idims[3] - 1);
+  offset = imin;
+  int64 ns = idims[0] * idims[1] * idims[2] * idims[3];
+
+  return (imax - imin + 1 == ns);
+}
+
+bool is_contigous3d(const uint dims[4], const int4 &stride, long long int &offset)
 {
   typedef long long int int64;
   int64 idims[3];
@@ -48,7 +91,7 @@ bool is_contigous3d(const uint dims[3], const int3 &stride, long long int &offse
   return (imax - imin + 1 == ns);
 }
 
-bool is_contigous2d(const uint dims[3], const int3 &stride, long long int &offset)
+bool is_contigous2d(const uint dims[4], const int4 &stride, long long int &offset)
 {
   typedef long long int int64;
   int64 idims[2];
@@ -72,15 +115,20 @@ bool is_contigous1d(uint dim, const int &stride, long long int &offset)
   return std::abs(stride) == 1;
 }
 
-bool is_contigous(const uint dims[3], const int3 &stride, long long int &offset)
+bool is_contigous(const uint dims[4], const int4 &stride, long long int &offset)
 {
   int d = 0;
   
   if(dims[0] != 0) d++;
   if(dims[1] != 0) d++;
   if(dims[2] != 0) d++;
+  if(dims[3] != 0) d++;
 
-  if(d == 3)
+  if(d == 4)
+  {
+    return is_contigous4d(dims, stride, offset);
+  }
+  else if(d == 3)
   {
     return is_contigous3d(dims, stride, offset);
   }
@@ -98,12 +146,13 @@ bool is_contigous(const uint dims[3], const int3 &stride, long long int &offset)
 // encode expects device pointers
 //
 template<typename T>
-size_t encode(uint dims[3], int3 stride, int bits_per_block, T *d_data, Word *d_stream)
+size_t encode(uint dims[4], int4 stride, int bits_per_block, T *d_data, Word *d_stream, cudaStream_t cuda_stream, unsigned long long int *d_block_bits = NULL)
 {
+  cuZFP::PhaseScope phase(zfp_device_kernel, cuda_stream);
 
   int d = 0;
   size_t len = 1;
-  for(int i = 0; i < 3; ++i)
+  for(int i = 0; i < 4; ++i)
   {
     if(dims[i] != 0)
     {
@@ -118,7 +167,7 @@ size_t encode(uint dims[3], int3 stride, int bits_per_block, T *d_data, Word *d_
   {
     int dim = dims[0];
     int sx = stride.x;
-    stream_size = cuZFP::encode1<T>(dim, sx, d_data, d_stream, bits_per_block); 
+    stream_size = cuZFP::encode1<T>(dim, sx, d_data, d_stream, bits_per_block, d_block_bits, cuda_stream); 
   }
   else if(d == 2)
   {
@@ -126,7 +175,7 @@ size_t encode(uint dims[3], int3 stride, int bits_per_block, T *d_data, Word *d_
     int2 s;
     s.x = stride.x; 
     s.y = stride.y; 
-    stream_size = cuZFP::encode2<T>(ndims, s, d_data, d_stream, bits_per_block); 
+    stream_size = cuZFP::encode2<T>(ndims, s, d_data, d_stream, bits_per_block, d_block_bits, cuda_stream); 
   }
   else if(d == 3)
   {
@@ -135,7 +184,13 @@ size_t encode(uint dims[3], int3 stride, int bits_per_block, T *d_data, Word *d_
     s.y = stride.y; 
     s.z = stride.z; 
     uint3 ndims = make_uint3(dims[0], dims[1], dims[2]);
-    stream_size = cuZFP::encode<T>(ndims, s, d_data, d_stream, bits_per_block); 
+    stream_size = cuZFP::encode<T>(ndims, s, d_data, d_stream, bits_per_block, d_block_bits, cuda_stream); 
+  }
+  else if(d == 4)
+  {
+    int4 s = stride;
+    uint4 ndims = make_uint4(dims[0], dims[1], dims[2], dims[3]);
+    stream_size = cuZFP::encode4<T>(ndims, s, d_data, d_stream, bits_per_block, d_block_bits, cuda_stream); 
   }
 
   errors.chk("Encode");
@@ -144,13 +199,14 @@ size_t encode(uint dims[3], int3 stride, int bits_per_block, T *d_data, Word *d_
 }
 
 template<typename T>
-size_t decode(uint ndims[3], int3 stride, int bits_per_block, Word *stream, T *out)
+size_t decode(uint ndims[4], int4 stride, int bits_per_block, Word *stream, T *out, cudaStream_t cuda_stream, const unsigned long long int *d_offsets = NULL)
 {
+  cuZFP::PhaseScope phase(zfp_device_kernel, cuda_stream);
 
   int d = 0;
   size_t out_size = 1;
   size_t stream_bytes = 0;
-  for(int i = 0; i < 3; ++i)
+  for(int i = 0; i < 4; ++i)
   {
     if(ndims[i] != 0)
     {
@@ -168,14 +224,14 @@ size_t decode(uint ndims[3], int3 stride, int bits_per_block, Word *stream, T *o
     s.y = stride.y; 
     s.z = stride.z; 
 
-    stream_bytes = cuZFP::decode3<T>(dims, s, stream, out, bits_per_block); 
+    stream_bytes = cuZFP::decode3<T>(dims, s, stream, out, bits_per_block, d_offsets, cuda_stream); 
   }
   else if(d == 1)
   {
     uint dim = ndims[0];
     int sx = stride.x;
 
-    stream_bytes = cuZFP::decode1<T>(dim, sx, stream, out, bits_per_block); 
+    stream_bytes = cuZFP::decode1<T>(dim, sx, stream, out, bits_per_block, d_offsets, cuda_stream); 
 
   }
   else if(d == 2)
@@ -188,13 +244,209 @@ size_t decode(uint ndims[3], int3 stride, int bits_per_block, Word *stream, T *o
     s.x = stride.x; 
     s.y = stride.y; 
 
-    stream_bytes = cuZFP::decode2<T>(dims, s, stream, out, bits_per_block); 
+    stream_bytes = cuZFP::decode2<T>(dims, s, stream, out, bits_per_block, d_offsets, cuda_stream); 
+  }
+  else if(d == 4)
+  {
+    uint4 dims = make_uint4(ndims[0], ndims[1], ndims[2], ndims[3]);
+    int4 s = stride;
+
+    stream_bytes = cuZFP::decode4<T>(dims, s, stream, out, bits_per_block, d_offsets, cuda_stream); 
   }
   else std::cerr<<" d ==  "<<d<<" not implemented\n";
  
   return stream_bytes;
 }
 
+//
+// CUDA stream on which all work for this zfp stream is queued
+//
+cudaStream_t get_stream(const zfp_stream *stream)
+{
+  return (cudaStream_t) stream->exec.params.cuda.stream;
+}
+
+//
+// size and memory pool of each live allocation, so that device_free can
+// return its bytes to zfp's memory accounting
+//
+std::mutex device_mutex;
+std::map<void*, std::pair<size_t, zfp_memory_pool> > device_allocations;
+
+//
+// allocate device memory using the stream's allocator, if one is set;
+// fails when the allocation would exceed the memory limit of pool
+//
+void *device_malloc(const zfp_stream *stream, size_t size, zfp_memory_pool pool = zfp_memory_device_scratch)
+{
+  const zfp_device_allocator &allocator = stream->exec.params.cuda.allocator;
+  void *ptr = NULL;
+  if(!zfp_memory_acquire(pool, size))
+  {
+    return NULL;
+  }
+  cuZFP::PhaseScope phase(zfp_device_alloc, get_stream(stream));
+  if(allocator.alloc)
+  {
+    ptr = allocator.alloc(size, allocator.context);
+  }
+  else if(cudaMalloc(&ptr, size) != cudaSuccess)
+  {
+    ptr = NULL;
+  }
+  if(ptr)
+  {
+    std::lock_guard<std::mutex> lock(device_mutex);
+    device_allocations[ptr] = std::make_pair(size, pool);
+  }
+  else
+  {
+    zfp_memory_release(pool, size);
+  }
+  return ptr;
+}
+
+void device_free(const zfp_stream *stream, void *ptr)
+{
+  const zfp_device_allocator &allocator = stream->exec.params.cuda.allocator;
+  if(!ptr)
+  {
+    return;
+  }
+  cuZFP::PhaseScope phase(zfp_device_free, get_stream(stream));
+  {
+    std::lock_guard<std::mutex> lock(device_mutex);
+    std::map<void*, std::pair<size_t, zfp_memory_pool> >::iterator it = device_allocations.find(ptr);
+    if(it != device_allocations.end())
+    {
+      zfp_memory_release(it->second.second, it->second.first);
+      device_allocations.erase(it);
+    }
+  }
+  if(allocator.free)
+  {
+    allocator.free(ptr, allocator.context);
+  }
+  else
+  {
+    cudaFree(ptr);
+  }
+}
+
+//
+// copy compression parameters shared by all blocks to the device
+//
+void set_params(const zfp_stream *stream)
+{
+  const uint minbits = stream->minbits;
+  const uint maxprec = stream->maxprec;
+  const int minexp = stream->minexp;
+  cudaStream_t cuda_stream = get_stream(stream);
+  // queued on the stream so that kernels still in flight keep their values
+  cudaMemcpyToSymbolAsync(cuZFP::c_minbits, &minbits, sizeof(uint), 0, cudaMemcpyHostToDevice, cuda_stream);
+  cudaMemcpyToSymbolAsync(cuZFP::c_maxprec, &maxprec, sizeof(uint), 0, cudaMemcpyHostToDevice, cuda_stream);
+  cudaMemcpyToSymbolAsync(cuZFP::c_minexp, &minexp, sizeof(int), 0, cudaMemcpyHostToDevice, cuda_stream);
+}
+
+size_t num_blocks(const uint dims[4])
+{
+  size_t blocks = 1;
+  for(int i = 0; i < 4; ++i)
+  {
+    if(dims[i] != 0)
+    {
+      blocks *= (dims[i] + 3) / 4;
+    }
+  }
+  return blocks;
+}
+
+//
+// upper bound on the bits needed to encode any one block, rounded up to
+// whole words so that each block can be encoded into its own slot
+//
+uint slot_bits(const zfp_stream *stream, const zfp_field *field)
+{
+  uint dims = zfp_field_dimensionality(field);
+  uint values = 1u << (2 * dims);
+  uint ebits = 0;
+  uint intprec = 0;
+  switch(field->type)
+  {
+    case zfp_type_int32:
+      intprec = 32;
+      break;
+    case zfp_type_int64:
+      intprec = 64;
+      break;
+    case zfp_type_float:
+      ebits = 1 + 8;
+      intprec = 32;
+      break;
+    case zfp_type_double:
+      ebits = 1 + 11;
+      intprec = 64;
+      break;
+    default:
+      return 0;
+  }
+  uint bits = ebits + values - 1 + values * std::min(stream->maxprec, intprec);
+  bits = std::min(bits, stream->maxbits);
+  bits = std::max(bits, stream->minbits);
+  return (bits + Wsize - 1) & ~(Wsize - 1);
+}
+
+//
+// encode blocks into fixed-size slots, then pack them back to back in
+// d_stream; returns the total number of bits and fills in d_offsets
+//
+template<typename T>
+unsigned long long int
+encode_variable(const zfp_stream *stream, uint dims[4], int4 stride, uint bits_per_slot, T *d_data, Word *d_stream, unsigned long long int *d_offsets)
+{
+  typedef unsigned long long int ull;
+  const size_t blocks = num_blocks(dims);
+  cudaStream_t cuda_stream = get_stream(stream);
+
+  const size_t slot_bytes = blocks * bits_per_slot / CHAR_BIT;
+  Word *d_slots = (Word*) device_malloc(stream, slot_bytes);
+  cudaMemsetAsync(d_slots, 0, slot_bytes, cuda_stream);
+
+  // record block sizes starting at d_offsets[1], then scan in place
+  cudaMemsetAsync(d_offsets, 0, sizeof(ull), cuda_stream);
+  encode<T>(dims, stride, (int)bits_per_slot, d_data, d_slots, cuda_stream, d_offsets + 1);
+  ull total_bits = 0;
+  {
+    cuZFP::PhaseScope phase(zfp_device_offsets, cuda_stream);
+    cuZFP::trace_begin("zfp:size");
+    thrust::inclusive_scan(thrust::cuda::par.on(cuda_stream), d_offsets + 1, d_offsets + 1 + blocks, d_offsets + 1);
+
+    // the host needs the total size before the slots can be packed
+    cudaMemcpyAsync(&total_bits, d_offsets + blocks, sizeof(ull), cudaMemcpyDeviceToHost, cuda_stream);
+    cudaStreamSynchronize(cuda_stream);
+    cuZFP::trace_end();
+    cudaMemsetAsync(d_stream, 0, (total_bits + Wsize - 1) / Wsize * sizeof(Word), cuda_stream);
+
+    const int cuda_block_size = 128;
+    dim3 block_size = dim3(cuda_block_size, 1, 1);
+    dim3 grid_size = cuZFP::calculate_grid_size(blocks, cuda_block_size);
+    cuZFP::cudaConcat<<<grid_size, block_size, 0, cuda_stream>>>
+      (d_slots,
+       bits_per_slot / Wsize,
+       d_offsets,
+       d_stream,
+       blocks);
+
+    ErrorCheck errors;
+    errors.chk("Concat");
+  }
+
+  // the slots may only be released once the concat kernel is done
+  cudaStreamSynchronize(cuda_stream);
+  device_free(stream, d_slots);
+  return total_bits;
+}
+
 Word *setup_device_stream_compress(zfp_stream *stream,const zfp_field *field)
 {
   bool stream_device = cuZFP::is_gpu_ptr(stream->stream->begin);
@@ -205,13 +457,15 @@ Word *setup_device_stream_compress(zfp_stream *stream,const zfp_field *field)
     return (Word*) stream->stream->begin;
   }
 
-  Word *d_stream = NULL;
   size_t max_size = zfp_stream_maximum_size(stream, field);
-  cudaMalloc(&d_stream, max_size);
-  return d_stream;
+  return (Word*) device_malloc(stream, max_size, zfp_memory_device_stream);
 }
 
-Word *setup_device_stream_decompress(zfp_stream *stream,const zfp_field *field)
+//
+// copy only the compressed bytes to the device; one extra word is
+// allocated since the block reader may prefetch past the last block
+//
+Word *setup_device_stream_decompress(zfp_stream *stream, size_t stream_bytes)
 {
   bool stream_device = cuZFP::is_gpu_ptr(stream->stream->begin);
   assert(sizeof(word) == sizeof(Word)); // "CUDA version currently only supports 64bit words");
@@ -221,11 +475,15 @@ Word *setup_device_stream_decompress(zfp_stream *stream,const zfp_field *field)
     return (Word*) stream->stream->begin;
   }
 
-  Word *d_stream = NULL;
-  //TODO: change maximum_size to compressed stream size
-  size_t size = zfp_stream_maximum_size(stream, field);
-  cudaMalloc(&d_stream, size);
-  cudaMemcpy(d_stream, stream->stream->begin, size, cudaMemcpyHostToDevice);
+  size_t size = std::min(stream_bytes, stream_capacity(stream->stream));
+  Word *d_stream = (Word*) device_malloc(stream, size + sizeof(Word), zfp_memory_device_stream);
+  if(d_stream)
+  {
+    cudaStream_t cuda_stream = get_stream(stream);
+    cuZFP::PhaseScope phase(zfp_device_h2d, cuda_stream);
+    cudaMemsetAsync(d_stream + size / sizeof(Word), 0, sizeof(Word), cuda_stream);
+    cudaMemcpyAsync(d_stream, stream->stream->begin, size, cudaMemcpyHostToDevice, cuda_stream);
+  }
   return d_stream;
 }
 
@@ -255,7 +513,7 @@ void * offset_void(zfp_type type, void *ptr, long long int offset)
   return offset_ptr;
 }
 
-void *setup_device_field_compress(const zfp_field *field, const int3 &stride, long long int &offset)
+void *setup_device_field_compress(const zfp_stream *stream, const zfp_field *field, const int4 &stride, long long int &offset)
 {
   bool field_device = cuZFP::is_gpu_ptr(field->data);
 
@@ -265,15 +523,16 @@ void *setup_device_field_compress(const zfp_field *field, const int3 &stride, lo
     return field->data;
   }
   
-  uint dims[3];
+  uint dims[4];
   dims[0] = field->nx;
   dims[1] = field->ny;
   dims[2] = field->nz;
+  dims[3] = field->nw;
 
   size_t type_size = zfp_type_size(field->type);
 
   size_t field_size = 1;
-  for(int i = 0; i < 3; ++i)
+  for(int i = 0; i < 4; ++i)
   {
     if(dims[i] != 0)
     {
@@ -289,14 +548,15 @@ void *setup_device_field_compress(const zfp_field *field, const int3 &stride, lo
   if(contig)
   {
     size_t field_bytes = type_size * field_size;
-    cudaMalloc(&d_data, field_bytes);
+    d_data = device_malloc(stream, field_bytes);
 
-    cudaMemcpy(d_data, host_ptr, field_bytes, cudaMemcpyHostToDevice);
+    cuZFP::PhaseScope phase(zfp_device_h2d, get_stream(stream));
+    cudaMemcpyAsync(d_data, host_ptr, field_bytes, cudaMemcpyHostToDevice, get_stream(stream));
   }
   return offset_void(field->type, d_data, -offset);
 }
 
-void *setup_device_field_decompress(const zfp_field *field, const int3 &stride, long long int &offset)
+void *setup_device_field_decompress(const zfp_stream *stream, const zfp_field *field, const int4 &stride, long long int &offset)
 {
   bool field_device = cuZFP::is_gpu_ptr(field->data);
 
@@ -306,15 +566,16 @@ void *setup_device_field_decompress(const zfp_field *field, const int3 &stride,
     return field->data;
   }
 
-  uint dims[3];
+  uint dims[4];
   dims[0] = field->nx;
   dims[1] = field->ny;
   dims[2] = field->nz;
+  dims[3] = field->nw;
 
   size_t type_size = zfp_type_size(field->type);
 
   size_t field_size = 1;
-  for(int i = 0; i < 3; ++i)
+  for(int i = 0; i < 4; ++i)
   {
     if(dims[i] != 0)
     {
@@ -328,12 +589,71 @@ void *setup_device_field_decompress(const zfp_field *field, const int3 &stride,
   if(contig)
   {
     size_t field_bytes = type_size * field_size;
-    cudaMalloc(&d_data, field_bytes);
+    d_data = device_malloc(stream, field_bytes);
   }
   return offset_void(field->type, d_data, -offset);
 }
 
-void cleanup_device_ptr(void *orig_ptr, void *d_ptr, size_t bytes, long long int offset, zfp_type type)
+//
+// lowest address and number of bytes spanned by the field values
+//
+void *field_extent(const zfp_field *field, const uint dims[4], const int4 &stride, size_t &bytes)
+{
+  const long long int s[4] = { stride.x, stride.y, stride.z, stride.w };
+  long long int min = 0;
+  long long int max = 1;
+  for(int i = 0; i < 4; ++i)
+  {
+    if(dims[i] != 0)
+    {
+      const long long int span = s[i] * (long long int)(dims[i] - 1);
+      if(span < 0)
+        min += span;
+      else
+        max += span;
+    }
+  }
+  bytes = (size_t)(max - min) * zfp_type_size(field->type);
+  return offset_void(field->type, field->data, min);
+}
+
+//
+// managed memory is used in place; migrate its pages to the current device
+// before the kernels touch them, and mark input read-mostly so that the
+// host keeps a valid copy; both are hints, so failures (e.g. on devices
+// without concurrent managed access) are ignored
+//
+void prefetch_managed(const zfp_stream *stream, const void *ptr, size_t bytes, bool input)
+{
+  if(!bytes || !cuZFP::is_managed_ptr(ptr))
+  {
+    return;
+  }
+  int device = 0;
+  cudaGetDevice(&device);
+  if(input)
+  {
+    cudaMemAdvise(ptr, bytes, cudaMemAdviseSetReadMostly, device);
+  }
+  cudaMemPrefetchAsync(ptr, bytes, device, get_stream(stream));
+  cudaGetLastError();
+}
+
+//
+// migrate managed output back to the host once the kernels are done,
+// if the caller asked for it
+//
+void prefetch_managed_host(const zfp_stream *stream, const void *ptr, size_t bytes)
+{
+  if(!stream->exec.params.cuda.prefetch_host || !bytes || !cuZFP::is_managed_ptr(ptr))
+  {
+    return;
+  }
+  cudaMemPrefetchAsync(ptr, bytes, cudaCpuDeviceId, get_stream(stream));
+  cudaGetLastError();
+}
+
+void cleanup_device_ptr(const zfp_stream *stream, void *orig_ptr, void *d_ptr, size_t bytes, long long int offset, zfp_type type)
 {
   bool device = cuZFP::is_gpu_ptr(orig_ptr);
   if(device)
@@ -344,134 +664,559 @@ void cleanup_device_ptr(void *orig_ptr, void *d_ptr, size_t bytes, long long int
   void *d_offset_ptr = offset_void(type, d_ptr, offset);
   void *h_offset_ptr = offset_void(type, orig_ptr, offset);
 
+  cudaStream_t cuda_stream = get_stream(stream);
   if(bytes > 0)
   {
-    cudaMemcpy(h_offset_ptr, d_offset_ptr, bytes, cudaMemcpyDeviceToHost);
+    cuZFP::PhaseScope phase(zfp_device_d2h, cuda_stream);
+    cudaMemcpyAsync(h_offset_ptr, d_offset_ptr, bytes, cudaMemcpyDeviceToHost, cuda_stream);
   }
 
-  cudaFree(d_offset_ptr);
+  // staging buffers must outlive any work still queued on the stream
+  cudaStreamSynchronize(cuda_stream);
+  device_free(stream, d_offset_ptr);
 }
 
-} // namespace internal
+//
+// host-resident fields in the default layout are (de)compressed in slabs of
+// whole block layers along the slowest varying dimension; each slab passes
+// through pinned staging buffers on one of two streams, so that host copies,
+// transfers, and kernels overlap and device memory usage stays bounded
+//
+const size_t default_chunk_bytes = (size_t)64 << 20;
+
+int field_dims(const uint dims[4])
+{
+  int d = 0;
+  for(int i = 0; i < 4; ++i)
+  {
+    if(dims[i] != 0) d++;
+  }
+  return d;
+}
+
+bool is_default_layout(const uint dims[4], const int4 &stride)
+{
+  const int strides[4] = {stride.x, stride.y, stride.z, stride.w};
+  const int d = field_dims(dims);
+  long long int s = 1;
+  for(int i = 0; i < d; ++i)
+  {
+    if(strides[i] != s) return false;
+    s *= dims[i];
+  }
+  return true;
+}
+
+//
+// number of block layers that slabs must be a multiple of for them to begin
+// on a word boundary within a fixed-rate compressed stream
+//
+size_t layer_alignment(size_t layer_blocks, uint maxbits)
+{
+  size_t g = Wsize;
+  size_t r = layer_blocks * maxbits % Wsize;
+  while(r)
+  {
+    size_t t = g % r;
+    g = r;
+    r = t;
+  }
+  return Wsize / g;
+}
+
+//
+// number of block layers per slab, or zero if the field is not pipelined
+//
+size_t slab_layers(const zfp_stream *stream, const zfp_field *field, const uint dims[4], const int4 &stride)
+{
+  if(stream->minbits != stream->maxbits ||
+     cuZFP::is_gpu_ptr(field->data) ||
+     !is_default_layout(dims, stride))
+  {
+    return 0;
+  }
+
+  const int d = field_dims(dims);
+  size_t layer_values = 4;
+  size_t layer_blocks = 1;
+  for(int i = 0; i < d - 1; ++i)
+  {
+    layer_values *= dims[i];
+    layer_blocks *= (dims[i] + 3) / 4;
+  }
+  const size_t layer_bytes = layer_values * zfp_type_size(field->type);
+  const size_t total_layers = (dims[d - 1] + 3) / 4;
+
+  size_t chunk_bytes = stream->exec.params.cuda.chunk_bytes;
+  if(!chunk_bytes) chunk_bytes = default_chunk_bytes;
+
+  // under device memory limits, shrink slabs until both double-buffered
+  // field and stream slabs fit, and pipeline fields too large to stage whole
+  const size_t field_avail = zfp_memory_available(zfp_memory_device_scratch);
+  const size_t stream_avail = zfp_memory_available(zfp_memory_device_stream);
+  const size_t layer_stream_bytes = ((layer_blocks * stream->maxbits + Wsize - 1) / Wsize + 1) * sizeof(Word);
+  const size_t fit = std::min(field_avail / (2 * layer_bytes), stream_avail / (2 * layer_stream_bytes));
+  const bool whole = total_layers * layer_bytes <= field_avail &&
+                     total_layers * layer_stream_bytes <= stream_avail;
+
+  const size_t align = layer_alignment(layer_blocks, stream->maxbits);
+  size_t layers = std::max(std::min(chunk_bytes / layer_bytes, fit), (size_t)1);
+  layers = (layers + align - 1) / align * align;
+  if(layers < total_layers)
+  {
+    return layers;
+  }
+  return whole ? 0 : total_layers;
+}
+
+void *host_malloc(size_t size)
+{
+  void *ptr = NULL;
+  if(cudaMallocHost(&ptr, size) != cudaSuccess)
+  {
+    ptr = NULL;
+  }
+  return ptr;
+}
+
+template<typename T>
+bool pipeline(zfp_stream *stream, T *data, uint dims[4], int4 stride, size_t layers, bool compress, size_t &stream_bytes)
+{
+  const int d = field_dims(dims);
+  const uint maxbits = stream->maxbits;
+  const size_t blocks = num_blocks(dims);
+  const size_t total_layers = (dims[d - 1] + 3) / 4;
+  const size_t layer_blocks = blocks / total_layers;
+  size_t slab_row = 1;
+  for(int i = 0; i < d - 1; ++i)
+  {
+    slab_row *= dims[i];
+  }
+  const size_t slab_values = 4 * layers * slab_row;
+  const size_t slab_words = layers * layer_blocks * maxbits / Wsize;
+  const size_t slabs = (total_layers + layers - 1) / layers;
+
+  Word *begin = (Word*) stream->stream->begin;
+  const bool stream_device = cuZFP::is_gpu_ptr(begin);
+  const size_t capacity_words = stream_capacity(stream->stream) / sizeof(Word);
+
+  // pinned user memory is transferred to and from directly, skipping the
+  // staging buffers and host-side copies
+  const bool field_pinned = cuZFP::is_pinned_ptr(data, slab_row * dims[d - 1] * sizeof(T));
+  const bool stream_pinned = !stream_device && cuZFP::is_pinned_ptr(begin, capacity_words * sizeof(Word));
+  const bool stream_staged = !stream_device && !stream_pinned;
+
+  // one extra word per slab accommodates block reader prefetching
+  cudaStream_t streams[2] = {0, 0};
+  T *h_field[2] = {NULL, NULL};
+  T *d_field[2] = {NULL, NULL};
+  Word *h_stream[2] = {NULL, NULL};
+  Word *d_stream[2] = {NULL, NULL};
+  bool ok = true;
+  for(int b = 0; b < 2; ++b)
+  {
+    if(cudaStreamCreateWithFlags(&streams[b], cudaStreamNonBlocking) != cudaSuccess)
+    {
+      streams[b] = 0;
+    }
+    if(!field_pinned)
+    {
+      h_field[b] = (T*) host_malloc(slab_values * sizeof(T));
+    }
+    d_field[b] = (T*) device_malloc(stream, slab_values * sizeof(T));
+    if(stream_staged)
+    {
+      h_stream[b] = (Word*) host_malloc((slab_words + 1) * sizeof(Word));
+    }
+    if(!stream_device)
+    {
+      d_stream[b] = (Word*) device_malloc(stream, (slab_words + 1) * sizeof(Word), zfp_memory_device_stream);
+    }
+    ok = ok && streams[b] && (field_pinned || h_field[b]) && d_field[b] &&
+         (!stream_staged || h_stream[b]) && (stream_device || d_stream[b]);
+  }
+
+  for(size_t i = 0; ok && i < slabs + 2; ++i)
+  {
+    const int b = i & 1;
+
+    // retire slab i - 2 before its buffers are reused
+    if(i >= 2)
+    {
+      const size_t j = i - 2;
+      const size_t n = std::min(layers, total_layers - j * layers);
+      const size_t rows = std::min(4 * n, (size_t)dims[d - 1] - 4 * j * layers);
+      const size_t words = (n * layer_blocks * maxbits + Wsize - 1) / Wsize;
+      cudaStreamSynchronize(streams[b]);
+      if(compress && stream_staged)
+      {
+        memcpy(begin + j * slab_words, h_stream[b], words * sizeof(Word));
+      }
+      else if(!compress && !field_pinned)
+      {
+        memcpy(data + j * slab_values, h_field[b], rows * slab_row * sizeof(T));
+      }
+    }
+
+    if(i >= slabs)
+    {
+      continue;
+    }
+
+    const size_t n = std::min(layers, total_layers - i * layers);
+    const size_t rows = std::min(4 * n, (size_t)dims[d - 1] - 4 * i * layers);
+    const size_t words = (n * layer_blocks * maxbits + Wsize - 1) / Wsize;
+    const size_t field_bytes = rows * slab_row * sizeof(T);
+    uint slab_dims[4] = {dims[0], dims[1], dims[2], dims[3]};
+    slab_dims[d - 1] = (uint)rows;
+    Word *slab_stream = stream_device ? begin + i * slab_words : d_stream[b];
+
+    T *slab_field = field_pinned ? data + i * slab_values : h_field[b];
+    Word *slab_host = stream_pinned ? begin + i * slab_words : h_stream[b];
 
+    if(compress)
+    {
+      if(!field_pinned)
+      {
+        memcpy(h_field[b], data + i * slab_values, field_bytes);
+      }
+      {
+        cuZFP::PhaseScope phase(zfp_device_h2d, streams[b]);
+        cudaMemcpyAsync(d_field[b], slab_field, field_bytes, cudaMemcpyHostToDevice, streams[b]);
+      }
+      cudaMemsetAsync(slab_stream, 0, words * sizeof(Word), streams[b]);
+      encode<T>(slab_dims, stride, (int)maxbits, d_field[b], slab_stream, streams[b]);
+      if(!stream_device)
+      {
+        cuZFP::PhaseScope phase(zfp_device_d2h, streams[b]);
+        cudaMemcpyAsync(slab_host, d_stream[b], words * sizeof(Word), cudaMemcpyDeviceToHost, streams[b]);
+      }
+    }
+    else
+    {
+      if(!stream_device)
+      {
+        const size_t start = i * slab_words;
+        const size_t avail = capacity_words > start ? std::min(words + 1, capacity_words - start) : 0;
+        if(stream_pinned)
+        {
+          cuZFP::PhaseScope phase(zfp_device_h2d, streams[b]);
+          cudaMemcpyAsync(d_stream[b], slab_host, avail * sizeof(Word), cudaMemcpyHostToDevice, streams[b]);
+          cudaMemsetAsync(d_stream[b] + avail, 0, (words + 1 - avail) * sizeof(Word), streams[b]);
+        }
+        else
+        {
+          memcpy(h_stream[b], begin + start, avail * sizeof(Word));
+          memset(h_stream[b] + avail, 0, (words + 1 - avail) * sizeof(Word));
+          cuZFP::PhaseScope phase(zfp_device_h2d, streams[b]);
+          cudaMemcpyAsync(d_stream[b], h_stream[b], (words + 1) * sizeof(Word), cudaMemcpyHostToDevice, streams[b]);
+        }
+      }
+      decode<T>(slab_dims, stride, (int)maxbits, slab_stream, d_field[b], streams[b]);
+      cuZFP::PhaseScope phase(zfp_device_d2h, streams[b]);
+      cudaMemcpyAsync(slab_field, d_field[b], field_bytes, cudaMemcpyDeviceToHost, streams[b]);
+    }
+  }
+
+  ErrorCheck errors;
+  errors.chk("Pipeline");
+
+  for(int b = 0; b < 2; ++b)
+  {
+    if(streams[b])
+    {
+      cudaStreamSynchronize(streams[b]);
+      cudaStreamDestroy(streams[b]);
+    }
+    cudaFreeHost(h_field[b]);
+    cudaFreeHost(h_stream[b]);
+    device_free(stream, d_field[b]);
+    device_free(stream, d_stream[b]);
+  }
+
+  stream_bytes = (blocks * maxbits + Wsize - 1) / Wsize * sizeof(Word);
+  return ok;
+}
+
+//
+// (de)compress a host-resident field through the slab pipeline; returns
+// false if the field is not suited for pipelining or resources are lacking
+//
+bool pipeline_field(zfp_stream *stream, const zfp_field *field, uint dims[4], const int4 &stride, bool compress, size_t &stream_bytes)
+{
+  const size_t layers = slab_layers(stream, field, dims, stride);
+  if(!layers)
+  {
+    return false;
+  }
+
+  cuZFP::TraceRange range("zfp:pipeline");
+  set_params(stream);
+  // the pipeline streams are not ordered with respect to the caller's stream
+  cudaStreamSynchronize(get_stream(stream));
+
+  switch(field->type)
+  {
+    case zfp_type_float:
+      return pipeline<float>(stream, (float*) field->data, dims, stride, layers, compress, stream_bytes);
+    case zfp_type_double:
+      return pipeline<double>(stream, (double*) field->data, dims, stride, layers, compress, stream_bytes);
+    case zfp_type_int32:
+      return pipeline<int>(stream, (int*) field->data, dims, stride, layers, compress, stream_bytes);
+    case zfp_type_int64:
+      return pipeline<long long int>(stream, (long long int*) field->data, dims, stride, layers, compress, stream_bytes);
+    default:
+      return false;
+  }
+}
+
+//
+// zfp wants to flush the stream; bits are set to wsize because the device
+// already did that, and the stream pointer is set to the end of the stream
+//
+void set_stream_end(zfp_stream *stream, size_t stream_bytes)
+{
+  stream->stream->bits = wsize;
+  stream->stream->ptr = stream->stream->begin + stream_bytes / sizeof(Word);
+}
+
+//
+// compress without waiting for the device; work involving host memory or
+// variable-rate compaction still synchronizes on the stream internally
+//
 size_t
-cuda_compress(zfp_stream *stream, const zfp_field *field)
+compress(zfp_stream *stream, const zfp_field *field)
 {
-  uint dims[3];
+  uint dims[4];
   dims[0] = field->nx;
   dims[1] = field->ny;
   dims[2] = field->nz;
+  dims[3] = field->nw;
 
-  int3 stride;  
+  int4 stride;  
   stride.x = field->sx ? field->sx : 1;
   stride.y = field->sy ? field->sy : field->nx;
   stride.z = field->sz ? field->sz : field->nx * field->ny;
+  stride.w = field->sw ? field->sw : field->nx * field->ny * field->nz;
   
   size_t stream_bytes = 0;
+  if(internal::pipeline_field(stream, field, dims, stride, true, stream_bytes))
+  {
+    internal::set_stream_end(stream, stream_bytes);
+    return stream_bytes;
+  }
+
   long long int offset = 0; 
-  void *d_data = internal::setup_device_field_compress(field, stride, offset);
+  cuZFP::trace_begin("zfp:H2D");
+  void *d_data = internal::setup_device_field_compress(stream, field, stride, offset);
 
   if(d_data == NULL)
   {
     // null means the array is non-contiguous host mem which is not supported
+    cuZFP::trace_end();
     return 0;
   }
 
   Word *d_stream = internal::setup_device_stream_compress(stream, field);
+  cuZFP::trace_end();
+  cuZFP::trace_begin("zfp:setup");
+  internal::set_params(stream);
+  cudaStream_t cuda_stream = internal::get_stream(stream);
+
+  // managed field and stream are used in place
+  size_t field_bytes = 0;
+  const void *field_begin = internal::field_extent(field, dims, stride, field_bytes);
+  const size_t max_bytes = std::min(zfp_stream_maximum_size(stream, field), stream_capacity(stream->stream));
+  internal::prefetch_managed(stream, field_begin, field_bytes, true);
+  internal::prefetch_managed(stream, stream->stream->begin, max_bytes, false);
+  cuZFP::trace_end();
+
+  cuZFP::trace_begin("zfp:encode");
+  if(stream->minbits != stream->maxbits)
+  {
+    // variable-rate mode: compact the blocks and build an offset table
+    typedef unsigned long long int ull;
+    const size_t blocks = internal::num_blocks(dims);
+    const uint bits_per_slot = internal::slot_bits(stream, field);
+    ull *d_offsets = (ull*) internal::device_malloc(stream, (blocks + 1) * sizeof(ull));
+
+    ull total_bits = 0;
+    if(field->type == zfp_type_float)
+    {
+      float* data = (float*) d_data;
+      total_bits = internal::encode_variable<float>(stream, dims, stride, bits_per_slot, data, d_stream, d_offsets);
+    }
+    else if(field->type == zfp_type_double)
+    {
+      double* data = (double*) d_data;
+      total_bits = internal::encode_variable<double>(stream, dims, stride, bits_per_slot, data, d_stream, d_offsets);
+    }
+    else if(field->type == zfp_type_int32)
+    {
+      int * data = (int*) d_data;
+      total_bits = internal::encode_variable<int>(stream, dims, stride, bits_per_slot, data, d_stream, d_offsets);
+    }
+    else if(field->type == zfp_type_int64)
+    {
+      long long int * data = (long long int*) d_data;
+      total_bits = internal::encode_variable<long long int>(stream, dims, stride, bits_per_slot, data, d_stream, d_offsets);
+    }
+    stream_bytes = (total_bits + Wsize - 1) / Wsize * sizeof(Word);
 
-  if(field->type == zfp_type_float)
+    // the offsets are needed to decompress, so hand them back to the caller
+    if(stream->index)
+    {
+      ull *offsets = (ull*) malloc((blocks + 1) * sizeof(ull));
+      {
+        cuZFP::PhaseScope phase(zfp_device_d2h, cuda_stream);
+        cudaMemcpyAsync(offsets, d_offsets, (blocks + 1) * sizeof(ull), cudaMemcpyDeviceToHost, cuda_stream);
+      }
+      cudaStreamSynchronize(cuda_stream);
+      zfp_index_set(stream->index, blocks, (const uint64*) offsets);
+      free(offsets);
+    }
+    internal::device_free(stream, d_offsets);
+  }
+  else if(field->type == zfp_type_float)
   {
     float* data = (float*) d_data;
-    stream_bytes = internal::encode<float>(dims, stride, (int)stream->maxbits, data, d_stream);
+    stream_bytes = internal::encode<float>(dims, stride, (int)stream->maxbits, data, d_stream, cuda_stream);
   }
   else if(field->type == zfp_type_double)
   {
     double* data = (double*) d_data;
-    stream_bytes = internal::encode<double>(dims, stride, (int)stream->maxbits, data, d_stream);
+    stream_bytes = internal::encode<double>(dims, stride, (int)stream->maxbits, data, d_stream, cuda_stream);
   }
   else if(field->type == zfp_type_int32)
   {
     int * data = (int*) d_data;
-    stream_bytes = internal::encode<int>(dims, stride, (int)stream->maxbits, data, d_stream);
+    stream_bytes = internal::encode<int>(dims, stride, (int)stream->maxbits, data, d_stream, cuda_stream);
   }
   else if(field->type == zfp_type_int64)
   {
     long long int * data = (long long int*) d_data;
-    stream_bytes = internal::encode<long long int>(dims, stride, (int)stream->maxbits, data, d_stream);
+    stream_bytes = internal::encode<long long int>(dims, stride, (int)stream->maxbits, data, d_stream, cuda_stream);
   }
 
-  internal::cleanup_device_ptr(stream->stream->begin, d_stream, stream_bytes, 0, field->type);
-  internal::cleanup_device_ptr(field->data, d_data, 0, offset, field->type);
+  cuZFP::trace_end();
 
-  // zfp wants to flush the stream.
-  // set bits to wsize because we already did that.
-  size_t compressed_size = stream_bytes / sizeof(Word);
-  stream->stream->bits = wsize;
-  // set stream pointer to end of stream
-  stream->stream->ptr = stream->stream->begin + compressed_size;
+  cuZFP::trace_begin("zfp:D2H");
+  internal::prefetch_managed_host(stream, stream->stream->begin, stream_bytes);
+  internal::cleanup_device_ptr(stream, stream->stream->begin, d_stream, stream_bytes, 0, field->type);
+  internal::cleanup_device_ptr(stream, field->data, d_data, 0, offset, field->type);
+  cuZFP::trace_end();
+
+  internal::set_stream_end(stream, stream_bytes);
 
   return stream_bytes;
 }
-  
-void 
-cuda_decompress(zfp_stream *stream, zfp_field *field)
+
+void
+decompress(zfp_stream *stream, zfp_field *field)
 {
-  uint dims[3];
+  uint dims[4];
   dims[0] = field->nx;
   dims[1] = field->ny;
   dims[2] = field->nz;
+  dims[3] = field->nw;
    
-  int3 stride;  
+  int4 stride;  
   stride.x = field->sx ? field->sx : 1;
   stride.y = field->sy ? field->sy : field->nx;
   stride.z = field->sz ? field->sz : field->nx * field->ny;
+  stride.w = field->sw ? field->sw : field->nx * field->ny * field->nz;
 
-  size_t decoded_bytes = 0;
-  long long int offset = 0;
-  void *d_data = internal::setup_device_field_decompress(field, stride, offset);
-  
-  if(d_data == NULL)
+  size_t pipelined_bytes = 0;
+  if(internal::pipeline_field(stream, field, dims, stride, false, pipelined_bytes))
   {
-    // null means the array is non-contiguous host mem which is not supported
+    internal::set_stream_end(stream, pipelined_bytes);
     return;
   }
 
-  Word *d_stream = internal::setup_device_stream_decompress(stream, field);
-
-  if(field->type == zfp_type_float)
+  typedef unsigned long long int ull;
+  const size_t blocks = internal::num_blocks(dims);
+  cudaStream_t cuda_stream = internal::get_stream(stream);
+  ull *d_offsets = NULL;
+  ull total_bits = (ull)blocks * stream->maxbits;
+  if(stream->minbits != stream->maxbits)
   {
-    float *data = (float*) d_data;
-    decoded_bytes = internal::decode(dims, stride, (int)stream->maxbits, d_stream, data);
+    // variable-rate streams can only be decoded in parallel with block offsets
+    if(!stream->index || zfp_index_chunks(stream->index) != blocks)
+    {
+      return;
+    }
+    total_bits = stream->index->offset[blocks];
+  }
+
+  cuZFP::trace_begin("zfp:H2D");
+  if(stream->minbits != stream->maxbits)
+  {
+    d_offsets = (ull*) internal::device_malloc(stream, (blocks + 1) * sizeof(ull));
+    cuZFP::PhaseScope phase(zfp_device_h2d, cuda_stream);
+    cudaMemcpyAsync(d_offsets, stream->index->offset, (blocks + 1) * sizeof(ull), cudaMemcpyHostToDevice, cuda_stream);
+  }
+
+  size_t decoded_bytes = 0;
+  long long int offset = 0;
+  void *d_data = internal::setup_device_field_decompress(stream, field, stride, offset);
+  
+  if(d_data == NULL)
+  {
+    // null means the array is non-contiguous host mem which is not supported
+    internal::device_free(stream, d_offsets);
+    cuZFP::trace_end();
+    return;
+  }
+
+  const size_t stream_bytes = (total_bits + Wsize - 1) / Wsize * sizeof(Word);
+  Word *d_stream = internal::setup_device_stream_decompress(stream, stream_bytes);
+  cuZFP::trace_end();
+  cuZFP::trace_begin("zfp:setup");
+  internal::set_params(stream);
+
+  // managed field and stream are used in place
+  size_t field_bytes = 0;
+  const void *field_begin = internal::field_extent(field, dims, stride, field_bytes);
+  internal::prefetch_managed(stream, stream->stream->begin, std::min(stream_bytes, stream_capacity(stream->stream)), true);
+  internal::prefetch_managed(stream, field_begin, field_bytes, false);
+  cuZFP::trace_end();
+
+  cuZFP::trace_begin("zfp:decode");
+  if(field->type == zfp_type_float)
+  {
+    float *data = (float*) d_data;
+    decoded_bytes = internal::decode(dims, stride, (int)stream->maxbits, d_stream, data, cuda_stream, d_offsets);
     d_data = (void*) data;
   }
   else if(field->type == zfp_type_double)
   {
     double *data = (double*) d_data;
-    decoded_bytes = internal::decode(dims, stride, (int)stream->maxbits, d_stream, data);
+    decoded_bytes = internal::decode(dims, stride, (int)stream->maxbits, d_stream, data, cuda_stream, d_offsets);
     d_data = (void*) data;
   }
   else if(field->type == zfp_type_int32)
   {
     int *data = (int*) d_data;
-    decoded_bytes = internal::decode(dims, stride, (int)stream->maxbits, d_stream, data);
+    decoded_bytes = internal::decode(dims, stride, (int)stream->maxbits, d_stream, data, cuda_stream, d_offsets);
     d_data = (void*) data;
   }
   else if(field->type == zfp_type_int64)
   {
     long long int *data = (long long int*) d_data;
-    decoded_bytes = internal::decode(dims, stride, (int)stream->maxbits, d_stream, data);
+    decoded_bytes = internal::decode(dims, stride, (int)stream->maxbits, d_stream, data, cuda_stream, d_offsets);
     d_data = (void*) data;
   }
   else
   {
     std::cerr<<"Cannot decompress: type unknown\n";
   }
+  cuZFP::trace_end();
 
    
   size_t type_size = zfp_type_size(field->type);
 
   size_t field_size = 1;
-  for(int i = 0; i < 3; ++i)
+  for(int i = 0; i < 4; ++i)
   {
     if(dims[i] != 0)
     {
@@ -480,12 +1225,750 @@ cuda_decompress(zfp_stream *stream, zfp_field *field)
   }
   
   size_t bytes = type_size * field_size;
-  internal::cleanup_device_ptr(stream->stream->begin, d_stream, 0, 0, field->type);
-  internal::cleanup_device_ptr(field->data, d_data, bytes, offset, field->type);
+  cuZFP::trace_begin("zfp:D2H");
+  internal::prefetch_managed_host(stream, field_begin, field_bytes);
+  internal::cleanup_device_ptr(stream, stream->stream->begin, d_stream, 0, 0, field->type);
+  internal::cleanup_device_ptr(stream, field->data, d_data, bytes, offset, field->type);
   
+  if(d_offsets)
+  {
+    cudaStreamSynchronize(cuda_stream);
+    internal::device_free(stream, d_offsets);
+    decoded_bytes = stream_bytes;
+  }
+  cuZFP::trace_end();
+
   // this is how zfp determins if this was a success
-  size_t words_read = decoded_bytes / sizeof(Word);
-  stream->stream->bits = wsize;
-  // set stream pointer to end of stream
-  stream->stream->ptr = stream->stream->begin + words_read;
+  internal::set_stream_end(stream, decoded_bytes);
+}
+
+//
+// decode a 2D or 3D field straight into a surface object, typically bound
+// to a cudaArray for texture sampling, so that no linear device copy of the
+// field is needed; the field supplies only type and dimensions
+//
+template<typename T>
+size_t decode_surface(const uint dims[4], int bits_per_block, Word *stream, cudaSurfaceObject_t surface, cudaStream_t cuda_stream, const unsigned long long int *d_offsets)
+{
+  if(dims[2] != 0)
+    return cuZFP::decode3surface<T>(make_uint3(dims[0], dims[1], dims[2]), stream, surface, bits_per_block, d_offsets, cuda_stream);
+  return cuZFP::decode2surface<T>(make_uint2(dims[0], dims[1]), stream, surface, bits_per_block, d_offsets, cuda_stream);
+}
+
+void
+decompress_surface(zfp_stream *stream, const zfp_field *field, cudaSurfaceObject_t surface)
+{
+  uint dims[4];
+  dims[0] = field->nx;
+  dims[1] = field->ny;
+  dims[2] = field->nz;
+  dims[3] = field->nw;
+
+  typedef unsigned long long int ull;
+  const size_t blocks = internal::num_blocks(dims);
+  cudaStream_t cuda_stream = internal::get_stream(stream);
+  ull *d_offsets = NULL;
+  ull total_bits = (ull)blocks * stream->maxbits;
+  if(stream->minbits != stream->maxbits)
+  {
+    // variable-rate streams can only be decoded in parallel with block offsets
+    if(!stream->index || zfp_index_chunks(stream->index) != blocks)
+    {
+      return;
+    }
+    total_bits = stream->index->offset[blocks];
+  }
+
+  cuZFP::trace_begin("zfp:H2D");
+  if(stream->minbits != stream->maxbits)
+  {
+    d_offsets = (ull*) internal::device_malloc(stream, (blocks + 1) * sizeof(ull));
+    cudaMemcpyAsync(d_offsets, stream->index->offset, (blocks + 1) * sizeof(ull), cudaMemcpyHostToDevice, cuda_stream);
+  }
+  const size_t stream_bytes = (total_bits + Wsize - 1) / Wsize * sizeof(Word);
+  Word *d_stream = internal::setup_device_stream_decompress(stream, stream_bytes);
+  cuZFP::trace_end();
+  if(d_stream == NULL)
+  {
+    internal::device_free(stream, d_offsets);
+    return;
+  }
+  internal::set_params(stream);
+
+  size_t decoded_bytes = 0;
+  cuZFP::trace_begin("zfp:decode");
+  if(field->type == zfp_type_float)
+    decoded_bytes = decode_surface<float>(dims, (int)stream->maxbits, d_stream, surface, cuda_stream, d_offsets);
+  else if(field->type == zfp_type_int32)
+    decoded_bytes = decode_surface<int>(dims, (int)stream->maxbits, d_stream, surface, cuda_stream, d_offsets);
+  cuZFP::trace_end();
+
+  internal::cleanup_device_ptr(stream, stream->stream->begin, d_stream, 0, 0, field->type);
+  if(d_offsets)
+  {
+    cudaStreamSynchronize(cuda_stream);
+    internal::device_free(stream, d_offsets);
+    decoded_bytes = stream_bytes;
+  }
+
+  internal::set_stream_end(stream, decoded_bytes);
+}
+
+//
+// decode only the listed blocks of a 3D field, e.g., those intersecting a
+// region of interest, into a device-resident box of the field with origin
+// and extent given by box or, if bricks is not null, into a device-resident
+// pool of consecutive 4x4x4 bricks; returns false, leaving the stream
+// untouched, when the blocks cannot be decoded on the device
+//
+template<typename T>
+size_t decode_blocks(const uint dims[4], const int4 &stride, int bits_per_block, Word *stream, void *out, const unsigned long long int *d_index, size_t count, const size_t box[6], bool bricks, cudaStream_t cuda_stream, const unsigned long long int *d_offsets)
+{
+  return cuZFP::decode3blocks<T>(make_uint3(dims[0], dims[1], dims[2]), make_int3(stride.x, stride.y, stride.z), stream, (T*)out, bits_per_block, d_offsets, d_index, count,
+                                 make_uint3((uint)box[0], (uint)box[1], (uint)box[2]), make_uint3((uint)box[3], (uint)box[4], (uint)box[5]), bricks, cuda_stream);
+}
+
+bool
+decompress_blocks(zfp_stream *stream, zfp_field *field, const size_t *index, size_t count, const size_t box[6], void *bricks)
+{
+  uint dims[4];
+  dims[0] = field->nx;
+  dims[1] = field->ny;
+  dims[2] = field->nz;
+  dims[3] = field->nw;
+
+  int4 stride;  
+  stride.x = field->sx ? field->sx : 1;
+  stride.y = field->sy ? field->sy : (int)box[3];
+  stride.z = field->sz ? field->sz : (int)(box[3] * box[4]);
+  stride.w = 0;
+
+  // output is written in place, so it must be accessible to the device
+  void *out = bricks ? bricks : field->data;
+  if(!dims[2] || dims[3] || !count || !cuZFP::is_gpu_ptr(out))
+  {
+    return false;
+  }
+
+  typedef unsigned long long int ull;
+  const size_t blocks = internal::num_blocks(dims);
+  cudaStream_t cuda_stream = internal::get_stream(stream);
+  ull *d_offsets = NULL;
+  ull total_bits = (ull)blocks * stream->maxbits;
+  if(stream->minbits != stream->maxbits)
+  {
+    // variable-rate streams can only be decoded in parallel with block offsets
+    if(!stream->index || zfp_index_chunks(stream->index) != blocks)
+    {
+      return false;
+    }
+    total_bits = stream->index->offset[blocks];
+  }
+
+  cuZFP::trace_begin("zfp:H2D");
+  ull *d_index = (ull*) internal::device_malloc(stream, count * sizeof(ull));
+  if(d_index == NULL)
+  {
+    cuZFP::trace_end();
+    return false;
+  }
+  const std::vector<ull> h_index(index, index + count);
+  cudaMemcpyAsync(d_index, &h_index[0], count * sizeof(ull), cudaMemcpyHostToDevice, cuda_stream);
+  if(stream->minbits != stream->maxbits)
+  {
+    d_offsets = (ull*) internal::device_malloc(stream, (blocks + 1) * sizeof(ull));
+    cudaMemcpyAsync(d_offsets, stream->index->offset, (blocks + 1) * sizeof(ull), cudaMemcpyHostToDevice, cuda_stream);
+  }
+  const size_t stream_bytes = (total_bits + Wsize - 1) / Wsize * sizeof(Word);
+  Word *d_stream = internal::setup_device_stream_decompress(stream, stream_bytes);
+  cuZFP::trace_end();
+  if(d_stream == NULL)
+  {
+    internal::device_free(stream, d_index);
+    internal::device_free(stream, d_offsets);
+    return false;
+  }
+  internal::set_params(stream);
+
+  cuZFP::trace_begin("zfp:decode");
+  if(field->type == zfp_type_float)
+    decode_blocks<float>(dims, stride, (int)stream->maxbits, d_stream, out, d_index, count, box, bricks != NULL, cuda_stream, d_offsets);
+  else if(field->type == zfp_type_double)
+    decode_blocks<double>(dims, stride, (int)stream->maxbits, d_stream, out, d_index, count, box, bricks != NULL, cuda_stream, d_offsets);
+  else if(field->type == zfp_type_int32)
+    decode_blocks<int>(dims, stride, (int)stream->maxbits, d_stream, out, d_index, count, box, bricks != NULL, cuda_stream, d_offsets);
+  else if(field->type == zfp_type_int64)
+    decode_blocks<long long int>(dims, stride, (int)stream->maxbits, d_stream, out, d_index, count, box, bricks != NULL, cuda_stream, d_offsets);
+  cuZFP::trace_end();
+
+  internal::cleanup_device_ptr(stream, stream->stream->begin, d_stream, 0, 0, field->type);
+  cudaStreamSynchronize(cuda_stream);
+  internal::device_free(stream, d_index);
+  internal::device_free(stream, d_offsets);
+
+  // the stream is positioned past the whole field
+  internal::set_stream_end(stream, stream_bytes);
+
+  return true;
+}
+//
+// with a list of devices, host-resident fields are partitioned into slabs
+// of whole block layers along the slowest varying dimension, and each slab
+// is (de)compressed on its own device by its own host thread
+//
+struct device_task
+{
+  int device;         // device that (de)compresses slab
+  zfp_stream stream;  // caller's stream restricted to slab
+  zfp_field field;    // slab of caller's field
+  bitstream *bits;    // compressed slab
+  zfp_index *index;   // block offsets within compressed slab, or NULL
+  void *buffer;       // variable-rate compressed slab, or NULL
+  bool compress;      // compress or decompress slab
+  size_t bytes;       // compressed slab size (zero upon failure)
+};
+
+void run_task(device_task *task)
+{
+  cudaSetDevice(task->device);
+  if(task->compress)
+  {
+    task->bytes = compress(&task->stream, &task->field);
+  }
+  else
+  {
+    decompress(&task->stream, &task->field);
+    task->bytes = stream_size(task->bits);
+  }
+  cudaDeviceSynchronize();
+}
+
+void run_tasks(device_task *task, size_t tasks)
+{
+  int device = 0;
+  cudaGetDevice(&device);
+#if __cplusplus >= 201103L
+  std::vector<std::thread> thread;
+  for(size_t i = 1; i < tasks; ++i)
+  {
+    thread.push_back(std::thread(run_task, &task[i]));
+  }
+  run_task(&task[0]);
+  for(size_t i = 0; i < thread.size(); ++i)
+  {
+    thread[i].join();
+  }
+#else
+  // without C++11 threads, devices take turns
+  for(size_t i = 0; i < tasks; ++i)
+  {
+    run_task(&task[i]);
+  }
+#endif
+  cudaSetDevice(device);
+}
+
+//
+// (de)compress field on the devices listed in the stream's execution
+// parameters; returns false if no devices are listed or field or stream
+// reside on a device, in which case the current device is used
+//
+bool run_devices(zfp_stream *stream, zfp_field *field, bool compress, size_t &stream_bytes)
+{
+  typedef unsigned long long int ull;
+  const uint devices = stream->exec.params.cuda.devices;
+  if(!devices ||
+     cuZFP::is_gpu_ptr(field->data) ||
+     cuZFP::is_gpu_ptr(stream->stream->begin))
+  {
+    return false;
+  }
+
+  uint dims[4] = {field->nx, field->ny, field->nz, field->nw};
+  const int d = field_dims(dims);
+  const bool fixed_rate = stream->minbits == stream->maxbits;
+  const size_t blocks = num_blocks(dims);
+  if(!fixed_rate && !compress && (!stream->index || zfp_index_chunks(stream->index) != blocks))
+  {
+    // variable-rate streams can only be decoded in parallel with block offsets
+    return false;
+  }
+
+  cuZFP::TraceRange range("zfp:devices");
+
+  // partition block layers evenly among devices
+  const size_t total_layers = (dims[d - 1] + 3) / 4;
+  const size_t layer_blocks = blocks / total_layers;
+  const size_t align = fixed_rate ? layer_alignment(layer_blocks, stream->maxbits) : 1;
+  size_t layers = (total_layers + devices - 1) / devices;
+  layers = (layers + align - 1) / align * align;
+  const size_t tasks = (total_layers + layers - 1) / layers;
+
+  const long long int strides[4] = {
+    field->sx ? field->sx : 1,
+    field->sy ? field->sy : (long long int)field->nx,
+    field->sz ? field->sz : (long long int)field->nx * field->ny,
+    field->sw ? field->sw : (long long int)field->nx * field->ny * field->nz,
+  };
+  Word *begin = (Word*) stream->stream->begin;
+  const size_t capacity = stream_capacity(stream->stream);
+  const uint64 *offset = fixed_rate ? NULL : stream->index->offset;
+
+  std::vector<device_task> task(tasks);
+  bool ok = true;
+  for(size_t i = 0; i < tasks; ++i)
+  {
+    device_task &t = task[i];
+    const size_t b0 = i * layers * layer_blocks;
+    const size_t b1 = std::min(i * layers + layers, total_layers) * layer_blocks;
+    const size_t rows = std::min(4 * layers, (size_t)dims[d - 1] - 4 * i * layers);
+
+    t.device = stream->exec.params.cuda.device[i];
+    t.compress = compress;
+    t.bytes = 0;
+    t.index = NULL;
+    t.buffer = NULL;
+
+    // slab of field starting at block layer i * layers
+    t.field = *field;
+    t.field.data = offset_void(field->type, field->data, (long long int)(4 * i * layers) * strides[d - 1]);
+    switch(d)
+    {
+      case 1: t.field.nx = (uint)rows; break;
+      case 2: t.field.ny = (uint)rows; break;
+      case 3: t.field.nz = (uint)rows; break;
+      case 4: t.field.nw = (uint)rows; break;
+    }
+
+    // slab streams have no device list and use each device's default stream
+    t.stream = *stream;
+    t.stream.exec.params.cuda.stream = NULL;
+    t.stream.exec.params.cuda.devices = 0;
+    t.stream.index = NULL;
+    t.stream.scratch = NULL;
+
+    if(fixed_rate)
+    {
+      // fixed-rate slabs begin on word boundaries of the caller's stream
+      const size_t start = b0 * stream->maxbits / Wsize * sizeof(Word);
+      t.bits = stream_open(begin + start / sizeof(Word), capacity > start ? capacity - start : 0);
+    }
+    else if(compress)
+    {
+      // variable-rate slabs are compressed separately and concatenated
+      t.index = zfp_index_alloc();
+      t.stream.index = t.index;
+      const size_t size = zfp_stream_maximum_size(&t.stream, &t.field);
+      t.buffer = malloc(size);
+      t.bits = t.buffer ? stream_open(t.buffer, size) : NULL;
+    }
+    else
+    {
+      // variable-rate slabs begin at the word holding their first bit, so
+      // their first block offset need not be zero
+      const size_t start = offset[b0] / Wsize * sizeof(Word);
+      uint64 *slab_offset = (uint64*) malloc((b1 - b0 + 1) * sizeof(uint64));
+      t.index = slab_offset ? zfp_index_alloc() : NULL;
+      if(t.index)
+      {
+        for(size_t b = b0; b <= b1; ++b)
+        {
+          slab_offset[b - b0] = offset[b] - start * CHAR_BIT;
+        }
+        t.index->offset = slab_offset;
+        t.index->chunks = b1 - b0;
+      }
+      else
+      {
+        free(slab_offset);
+      }
+      t.stream.index = t.index;
+      t.bits = stream_open(begin + start / sizeof(Word), capacity > start ? capacity - start : 0);
+    }
+    t.stream.stream = t.bits;
+    ok = ok && t.bits && (fixed_rate || t.index);
+  }
+
+  if(ok)
+  {
+    run_tasks(&task[0], tasks);
+    for(size_t i = 0; i < tasks; ++i)
+    {
+      ok = ok && task[i].bytes;
+    }
+  }
+
+  if(ok && fixed_rate)
+  {
+    stream_bytes = (blocks * stream->maxbits + Wsize - 1) / Wsize * sizeof(Word);
+  }
+  else if(ok && compress)
+  {
+    // concatenate slabs and shift their block offsets accordingly
+    std::vector<uint64> block_offset(blocks + 1);
+    bitstream *s = stream->stream;
+    uint64 base = 0;
+    size_t b = 0;
+    stream_rewind(s);
+    for(size_t i = 0; i < tasks; ++i)
+    {
+      const zfp_index *index = task[i].index;
+      const size_t n = zfp_index_chunks(index);
+      for(size_t j = 0; j < n; ++j)
+      {
+        block_offset[b++] = base + index->offset[j];
+      }
+      const uint64 bits = index->offset[n];
+      stream_rewind(task[i].bits);
+      stream_copy(s, task[i].bits, bits);
+      base += bits;
+    }
+    block_offset[blocks] = base;
+    stream_flush(s);
+    stream_bytes = stream_size(s);
+    if(stream->index)
+    {
+      zfp_index_set(stream->index, blocks, (const uint64*) &block_offset[0]);
+    }
+  }
+  else if(ok)
+  {
+    stream_bytes = (offset[blocks] + Wsize - 1) / Wsize * sizeof(Word);
+  }
+  else
+  {
+    stream_bytes = 0;
+  }
+
+  for(size_t i = 0; i < tasks; ++i)
+  {
+    stream_close(task[i].bits);
+    zfp_index_free(task[i].index);
+    free(task[i].buffer);
+  }
+
+  set_stream_end(stream, stream_bytes);
+  return true;
+}
+
+} // namespace internal
+
+//
+// synchronous calls time each zfp_device_phase when gathering statistics
+//
+size_t
+cuda_compress(zfp_stream *stream, const zfp_field *field)
+{
+  size_t stream_bytes = 0;
+  if(internal::run_devices(stream, const_cast<zfp_field*>(field), true, stream_bytes))
+  {
+    return stream_bytes;
+  }
+  cuZFP::PhaseTiming timing(stream->stats);
+  stream_bytes = internal::compress(stream, field);
+  cudaStreamSynchronize(internal::get_stream(stream));
+  return stream_bytes;
+}
+
+void
+cuda_decompress(zfp_stream *stream, zfp_field *field)
+{
+  size_t stream_bytes = 0;
+  if(internal::run_devices(stream, field, false, stream_bytes))
+  {
+    return;
+  }
+  cuZFP::PhaseTiming timing(stream->stats);
+  internal::decompress(stream, field);
+  cudaStreamSynchronize(internal::get_stream(stream));
+}
+
+//
+// fields partitioned among several devices are (de)compressed synchronously
+//
+size_t
+cuda_compress_async(zfp_stream *stream, const zfp_field *field)
+{
+  size_t stream_bytes = 0;
+  if(internal::run_devices(stream, const_cast<zfp_field*>(field), true, stream_bytes))
+  {
+    return stream_bytes;
+  }
+  return internal::compress(stream, field);
+}
+
+void
+cuda_decompress_async(zfp_stream *stream, zfp_field *field)
+{
+  size_t stream_bytes = 0;
+  if(!internal::run_devices(stream, field, false, stream_bytes))
+  {
+    internal::decompress(stream, field);
+  }
+}
+
+void
+cuda_decompress_surface(zfp_stream *stream, const zfp_field *field, unsigned long long surface)
+{
+  internal::decompress_surface(stream, field, (cudaSurfaceObject_t)surface);
+  cudaStreamSynchronize(internal::get_stream(stream));
+}
+
+zfp_bool
+cuda_decompress_blocks(zfp_stream *stream, zfp_field *field, const size_t *index, size_t count, const size_t *box, void *bricks)
+{
+  return internal::decompress_blocks(stream, field, index, count, box, bricks) ? zfp_true : zfp_false;
+}
+
+zfp_bool
+cuda_synchronize(zfp_stream *stream)
+{
+  return cudaStreamSynchronize(internal::get_stream(stream)) == cudaSuccess ? zfp_true : zfp_false;
+}
+
+zfp_bool
+cuda_query(const zfp_stream *stream)
+{
+  return cudaStreamQuery(internal::get_stream(stream)) == cudaSuccess ? zfp_true : zfp_false;
+}
+
+//
+// fixed-rate (de)compression of device-resident fields of one type, shape,
+// and rate, with parameters and strides captured up front; executing a plan
+// queues only parameter uploads and kernels on its stream, without pointer
+// queries, allocations, or synchronization, so that it may be captured
+// into a CUDA graph and replayed with new data pointers
+//
+struct zfp_cuda_plan {
+  zfp_stream params; // copy of compression parameters and execution policy
+  zfp_type type;
+  uint dims[4];
+  int4 stride;
+};
+
+zfp_cuda_plan *
+cuda_plan_create(const zfp_stream *stream, const zfp_field *field)
+{
+  zfp_cuda_plan *plan = (zfp_cuda_plan*) malloc(sizeof(zfp_cuda_plan));
+  if(!plan)
+  {
+    return NULL;
+  }
+  plan->params = *stream;
+  plan->params.stream = NULL;
+  plan->params.index = NULL;
+  plan->params.stats = NULL;
+  plan->type = field->type;
+  plan->dims[0] = field->nx;
+  plan->dims[1] = field->ny;
+  plan->dims[2] = field->nz;
+  plan->dims[3] = field->nw;
+  plan->stride.x = field->sx ? field->sx : 1;
+  plan->stride.y = field->sy ? field->sy : field->nx;
+  plan->stride.z = field->sz ? field->sz : field->nx * field->ny;
+  plan->stride.w = field->sw ? field->sw : field->nx * field->ny * field->nz;
+  return plan;
+}
+
+void
+cuda_plan_free(zfp_cuda_plan *plan)
+{
+  free(plan);
+}
+
+size_t
+cuda_plan_compress(const zfp_cuda_plan *plan, void *d_stream, const void *d_data)
+{
+  const zfp_stream *stream = &plan->params;
+  cudaStream_t cuda_stream = internal::get_stream(stream);
+  uint dims[4] = { plan->dims[0], plan->dims[1], plan->dims[2], plan->dims[3] };
+  const int maxbits = (int)stream->maxbits;
+  Word *out = (Word*) d_stream;
+  void *in = const_cast<void*>(d_data);
+
+  // parameters live in constant memory shared with other calls, so they
+  // are uploaded as part of every (captured) execution
+  internal::set_params(stream);
+  cuZFP::trace_begin("zfp:encode");
+  size_t stream_bytes = 0;
+  switch(plan->type)
+  {
+    case zfp_type_float:
+      stream_bytes = internal::encode<float>(dims, plan->stride, maxbits, (float*) in, out, cuda_stream);
+      break;
+    case zfp_type_double:
+      stream_bytes = internal::encode<double>(dims, plan->stride, maxbits, (double*) in, out, cuda_stream);
+      break;
+    case zfp_type_int32:
+      stream_bytes = internal::encode<int>(dims, plan->stride, maxbits, (int*) in, out, cuda_stream);
+      break;
+    case zfp_type_int64:
+      stream_bytes = internal::encode<long long int>(dims, plan->stride, maxbits, (long long int*) in, out, cuda_stream);
+      break;
+    default:
+      break;
+  }
+  cuZFP::trace_end();
+  return stream_bytes;
+}
+
+size_t
+cuda_plan_decompress(const zfp_cuda_plan *plan, void *d_data, const void *d_stream)
+{
+  const zfp_stream *stream = &plan->params;
+  cudaStream_t cuda_stream = internal::get_stream(stream);
+  uint dims[4] = { plan->dims[0], plan->dims[1], plan->dims[2], plan->dims[3] };
+  const int maxbits = (int)stream->maxbits;
+  Word *in = (Word*) const_cast<void*>(d_stream);
+
+  internal::set_params(stream);
+  cuZFP::trace_begin("zfp:decode");
+  size_t stream_bytes = 0;
+  switch(plan->type)
+  {
+    case zfp_type_float:
+      stream_bytes = internal::decode<float>(dims, plan->stride, maxbits, in, (float*) d_data, cuda_stream);
+      break;
+    case zfp_type_double:
+      stream_bytes = internal::decode<double>(dims, plan->stride, maxbits, in, (double*) d_data, cuda_stream);
+      break;
+    case zfp_type_int32:
+      stream_bytes = internal::decode<int>(dims, plan->stride, maxbits, in, (int*) d_data, cuda_stream);
+      break;
+    case zfp_type_int64:
+      stream_bytes = internal::decode<long long int>(dims, plan->stride, maxbits, in, (long long int*) d_data, cuda_stream);
+      break;
+    default:
+      break;
+  }
+  cuZFP::trace_end();
+  return stream_bytes;
+}
+
+//
+// file I/O of compressed streams; device buffers are transferred directly
+// between file and device memory through GPUDirect Storage when available
+// and otherwise through a page-locked host bounce buffer
+//
+namespace internal
+{
+
+// byte size of bounce buffer
+const size_t file_chunk_bytes = 0x800000;
+
+// write or read bytes of host or managed memory through stdio
+size_t host_file_io(FILE *file, void *buffer, size_t bytes, bool write)
+{
+  return write ? fwrite(buffer, 1, bytes, file) : fread(buffer, 1, bytes, file);
+}
+
+// write or read bytes of device memory through bounce buffer
+size_t device_file_io(FILE *file, void *d_buffer, size_t bytes, bool write)
+{
+  void *h_buffer = NULL;
+  if(cudaMallocHost(&h_buffer, std::min(bytes, file_chunk_bytes)) != cudaSuccess)
+  {
+    cudaGetLastError();
+    return 0;
+  }
+  size_t done = 0;
+  while(done < bytes)
+  {
+    size_t n = std::min(bytes - done, file_chunk_bytes);
+    char *d_chunk = (char*)d_buffer + done;
+    if(write)
+    {
+      if(cudaMemcpy(h_buffer, d_chunk, n, cudaMemcpyDeviceToHost) != cudaSuccess ||
+         fwrite(h_buffer, 1, n, file) != n)
+        break;
+    }
+    else
+    {
+      n = fread(h_buffer, 1, n, file);
+      if(!n || cudaMemcpy(d_chunk, h_buffer, n, cudaMemcpyHostToDevice) != cudaSuccess)
+        break;
+    }
+    done += n;
+  }
+  cudaFreeHost(h_buffer);
+  return done;
+}
+
+#ifdef ZFP_WITH_CUFILE
+// write or read bytes of device memory via cuFile; return bytes transferred,
+// or zero if GPUDirect Storage is unavailable for this file
+size_t cufile_io(const char *path, void *d_buffer, size_t bytes, bool write)
+{
+  // the driver is opened once per process and left open
+  static const bool driver = cuFileDriverOpen().err == CU_FILE_SUCCESS;
+  if(!driver)
+    return 0;
+  // direct I/O lets data bypass the page cache; cuFile falls back on
+  // compatibility mode for file systems that do not support it
+  int flags = write ? O_WRONLY | O_CREAT | O_TRUNC : O_RDONLY;
+  int fd = open(path, flags | O_DIRECT, 0644);
+  if(fd < 0)
+    fd = open(path, flags, 0644);
+  if(fd < 0)
+    return 0;
+  CUfileDescr_t descr;
+  CUfileHandle_t handle;
+  memset(&descr, 0, sizeof(descr));
+  descr.handle.fd = fd;
+  descr.type = CU_FILE_HANDLE_TYPE_OPAQUE_FD;
+  size_t done = 0;
+  if(cuFileHandleRegister(&handle, &descr).err == CU_FILE_SUCCESS)
+  {
+    while(done < bytes)
+    {
+      ssize_t n = write ? cuFileWrite(handle, d_buffer, bytes - done, (off_t)done, (off_t)done)
+                        : cuFileRead(handle, d_buffer, bytes - done, (off_t)done, (off_t)done);
+      if(n <= 0)
+        break;
+      done += (size_t)n;
+    }
+    cuFileHandleDeregister(handle);
+  }
+  if(close(fd))
+    done = 0;
+  return done;
+}
+#endif
+
+// write stream to file or read file into stream; return bytes transferred
+size_t file_io(const char *path, void *buffer, size_t bytes, bool write)
+{
+  const bool device = cuZFP::is_gpu_ptr(buffer) && !cuZFP::is_managed_ptr(buffer);
+#ifdef ZFP_WITH_CUFILE
+  if(device)
+  {
+    size_t done = cufile_io(path, buffer, bytes, write);
+    // a short read means the file is smaller than the buffer
+    if(done == bytes || (!write && done))
+      return done;
+  }
+#endif
+  FILE *file = fopen(path, write ? "wb" : "rb");
+  if(!file)
+    return 0;
+  size_t done = device ? device_file_io(file, buffer, bytes, write)
+                       : host_file_io(file, buffer, bytes, write);
+  if(fclose(file) && write)
+    done = 0;
+  return done;
+}
+
+} // namespace internal
+
+size_t
+cuda_write_file(const char *path, const void *buffer, size_t size)
+{
+  size_t bytes = internal::file_io(path, const_cast<void*>(buffer), size, true);
+  return bytes == size ? bytes : 0;
+}
+
+size_t
+cuda_read_file(const char *path, void *buffer, size_t capacity)
+{
+  return internal::file_io(path, buffer, capacity, false);
 }
@@ -8,6 +8,18 @@ extern "C" {
 #endif
   size_t cuda_compress(zfp_stream *stream, const zfp_field *field);
   void cuda_decompress(zfp_stream *stream, zfp_field *field);
+  size_t cuda_compress_async(zfp_stream *stream, const zfp_field *field);
+  void cuda_decompress_async(zfp_stream *stream, zfp_field *field);
+  void cuda_decompress_surface(zfp_stream *stream, const zfp_field *field, unsigned long long surface);
+  zfp_bool cuda_decompress_blocks(zfp_stream *stream, zfp_field *field, const size_t *index, size_t count, const size_t *box, void *bricks);
+  zfp_bool cuda_synchronize(zfp_stream *stream);
+  zfp_bool cuda_query(const zfp_stream *stream);
+  zfp_cuda_plan *cuda_plan_create(const zfp_stream *stream, const zfp_field *field);
+  void cuda_plan_free(zfp_cuda_plan *plan);
+  size_t cuda_plan_compress(const zfp_cuda_plan *plan, void *d_stream, const void *d_data);
+  size_t cuda_plan_decompress(const zfp_cuda_plan *plan, void *d_data, const void *d_stream);
+  size_t cuda_write_file(const char *path, const void *buffer, size_t size);
+  size_t cuda_read_file(const char *path, void *buffer, size_t capacity);
 #ifdef __cplusplus
 }
 #endif
@@ -34,8 +34,9 @@ cudaDecode1(Word *blocks,
             const uint dim,
             const int stride,
             const uint padded_dim,
-            const uint total_blocks,
-            uint maxbits)
+            const unsigned long long int total_blocks,
+            uint maxbits,
+            const unsigned long long int *offsets)
 {
   typedef unsigned long long int ull;
   typedef long long int ll;
@@ -44,9 +45,7 @@ cudaDecode1(Word *blocks,
 
   const int intprec = get_precision<Scalar>();
 
-  const ull blockId = blockIdx.x +
-                      blockIdx.y * gridDim.x +
-                      gridDim.x  * gridDim.y * blockIdx.z;
+  const ull blockId = grid_block_index();
 
   // each thread gets a block so the block index is 
   // the global thread index
@@ -54,7 +53,9 @@ cudaDecode1(Word *blocks,
 
   if(block_idx >= total_blocks) return;
 
-  BlockReader<4> reader(blocks, maxbits, block_idx, total_blocks);
+  // variable-rate streams locate each block through the offset table
+  const ull bit_offset = offsets ? offsets[block_idx] : block_idx * maxbits;
+  BlockReader<4> reader(blocks, bit_offset, maxbits, block_idx, total_blocks);
   Scalar result[4] = {0,0,0,0};
 
   zfp_decode(reader, result, maxbits);
@@ -81,7 +82,9 @@ size_t decode1launch(uint dim,
                      int stride,
                      Word *stream,
                      Scalar *d_data,
-                     uint maxbits)
+                     uint maxbits,
+                     const unsigned long long int *offsets,
+                     cudaStream_t cuda_stream)
 {
   const int cuda_block_size = 128;
 
@@ -110,22 +113,23 @@ size_t decode1launch(uint dim,
   cudaEventCreate(&start);
   cudaEventCreate(&stop);
 
-  cudaEventRecord(start);
+  cudaEventRecord(start, cuda_stream);
 #endif
 
-  cudaDecode1<Scalar> <<< grid_size, block_size >>>
+  cudaDecode1<Scalar> <<< grid_size, block_size, 0, cuda_stream >>>
     (stream,
 		 d_data,
      dim,
      stride,
      zfp_pad,
      zfp_blocks, // total blocks to decode
-     maxbits);
+     maxbits,
+     offsets);
 
 #ifdef CUDA_ZFP_RATE_PRINT
-  cudaEventRecord(stop);
+  cudaEventRecord(stop, cuda_stream);
   cudaEventSynchronize(stop);
-	cudaStreamSynchronize(0);
+	cudaStreamSynchronize(cuda_stream);
 
   float miliseconds = 0;
   cudaEventElapsedTime(&miliseconds, start, stop);
@@ -145,9 +149,11 @@ size_t decode1(int dim,
                int stride,
                Word *stream,
                Scalar *d_data,
-               uint maxbits)
+               uint maxbits,
+               const unsigned long long int *offsets = NULL,
+               cudaStream_t cuda_stream = 0)
 {
-	return decode1launch<Scalar>(dim, stride, stream, d_data, maxbits);
+	return decode1launch<Scalar>(dim, stride, stream, d_data, maxbits, offsets, cuda_stream);
 }
 
 } // namespace cuZFP
@@ -42,26 +42,27 @@ cudaDecode2(Word *blocks,
             const uint2 dims,
             const int2 stride,
             const uint2 padded_dims,
-            uint maxbits)
+            uint maxbits,
+            const unsigned long long int *offsets)
 {
   typedef unsigned long long int ull;
   typedef long long int ll;
-  const ull blockId = blockIdx.x +
-                      blockIdx.y * gridDim.x +
-                      gridDim.x * gridDim.y * blockIdx.z;
+  const ull blockId = grid_block_index();
 
   // each thread gets a block so the block index is 
   // the global thread index
   const ull block_idx = blockId * blockDim.x + threadIdx.x;
   
-  const int total_blocks = (padded_dims.x * padded_dims.y) / 16; 
+  const ull total_blocks = ((ull)padded_dims.x * padded_dims.y) / 16; 
   
   if(block_idx >= total_blocks) 
   {
     return;
   }
 
-  BlockReader<BlockSize> reader(blocks, maxbits, block_idx, total_blocks);
+  // variable-rate streams locate each block through the offset table
+  const ull bit_offset = offsets ? offsets[block_idx] : block_idx * maxbits;
+  BlockReader<BlockSize> reader(blocks, bit_offset, maxbits, block_idx, total_blocks);
  
   Scalar result[BlockSize];
   memset(result, 0, sizeof(Scalar) * BlockSize);
@@ -99,7 +100,9 @@ size_t decode2launch(uint2 dims,
                      int2 stride,
                      Word *stream,
                      Scalar *d_data,
-                     uint maxbits)
+                     uint maxbits,
+                     const unsigned long long int *offsets,
+                     cudaStream_t cuda_stream)
 {
   const int cuda_block_size = 128;
   dim3 block_size;
@@ -111,7 +114,7 @@ size_t decode2launch(uint2 dims,
   if(zfp_pad.x % 4 != 0) zfp_pad.x += 4 - dims.x % 4;
   if(zfp_pad.y % 4 != 0) zfp_pad.y += 4 - dims.y % 4;
 
-  const int zfp_blocks = (zfp_pad.x * zfp_pad.y) / 16; 
+  const size_t zfp_blocks = ((size_t)zfp_pad.x * zfp_pad.y) / 16; 
 
   
   //
@@ -134,21 +137,22 @@ size_t decode2launch(uint2 dims,
   cudaEvent_t start, stop;
   cudaEventCreate(&start);
   cudaEventCreate(&stop);
-  cudaEventRecord(start);
+  cudaEventRecord(start, cuda_stream);
 #endif
 
-  cudaDecode2<Scalar, 16> <<< grid_size, block_size >>>
+  cudaDecode2<Scalar, 16> <<< grid_size, block_size, 0, cuda_stream >>>
     (stream,
 		 d_data,
      dims,
      stride,
      zfp_pad,
-     maxbits);
+     maxbits,
+     offsets);
 
 #ifdef CUDA_ZFP_RATE_PRINT
-  cudaEventRecord(stop);
+  cudaEventRecord(stop, cuda_stream);
   cudaEventSynchronize(stop);
-	cudaStreamSynchronize(0);
+	cudaStreamSynchronize(cuda_stream);
 
   float miliseconds = 0;
   cudaEventElapsedTime(&miliseconds, start, stop);
@@ -168,9 +172,90 @@ size_t decode2(uint2 dims,
                int2 stride,
                Word *stream,
                Scalar *d_data,
-               uint maxbits)
+               uint maxbits,
+               const unsigned long long int *offsets = NULL,
+               cudaStream_t cuda_stream = 0)
 {
-	return decode2launch<Scalar>(dims, stride, stream, d_data, maxbits);
+	return decode2launch<Scalar>(dims, stride, stream, d_data, maxbits, offsets, cuda_stream);
+}
+
+//
+// Variant of cudaDecode2 that stores decoded values through a surface object,
+// e.g., one bound to the cudaArray backing a 2D texture
+//
+template<class Scalar, int BlockSize>
+__global__
+void
+cudaDecode2Surface(Word *blocks,
+                   cudaSurfaceObject_t surface,
+                   const uint2 dims,
+                   const uint2 padded_dims,
+                   uint maxbits,
+                   const unsigned long long int *offsets)
+{
+  typedef unsigned long long int ull;
+  const ull blockId = grid_block_index();
+  const ull block_idx = blockId * blockDim.x + threadIdx.x;
+  const ull total_blocks = ((ull)padded_dims.x * padded_dims.y) / 16; 
+
+  if(block_idx >= total_blocks) 
+  {
+    return;
+  }
+
+  // variable-rate streams locate each block through the offset table
+  const ull bit_offset = offsets ? offsets[block_idx] : block_idx * maxbits;
+  BlockReader<BlockSize> reader(blocks, bit_offset, maxbits, block_idx, total_blocks);
+
+  Scalar result[BlockSize];
+  memset(result, 0, sizeof(Scalar) * BlockSize);
+
+  zfp_decode(reader, result, maxbits);
+
+  // logical pos in 2d array
+  const uint block_dims_x = padded_dims.x >> 2;
+  uint2 block;
+  block.x = (block_idx % block_dims_x) * 4; 
+  block.y = (block_idx / block_dims_x) * 4; 
+  const uint nx = MIN(dims.x - block.x, 4u);
+  const uint ny = MIN(dims.y - block.y, 4u);
+
+  // surfaces are addressed in bytes along x
+  for(uint y = 0; y < ny; y++)
+    for(uint x = 0; x < nx; x++)
+      surf2Dwrite(result[4 * y + x], surface, (int)((block.x + x) * sizeof(Scalar)), (int)(block.y + y));
+}
+
+template<class Scalar>
+size_t decode2surface(uint2 dims, 
+                      Word *stream,
+                      cudaSurfaceObject_t surface,
+                      uint maxbits,
+                      const unsigned long long int *offsets,
+                      cudaStream_t cuda_stream)
+{
+  const int cuda_block_size = 128;
+  uint2 zfp_pad(dims); 
+  if(zfp_pad.x % 4 != 0) zfp_pad.x += 4 - dims.x % 4;
+  if(zfp_pad.y % 4 != 0) zfp_pad.y += 4 - dims.y % 4;
+
+  const size_t zfp_blocks = ((size_t)zfp_pad.x * zfp_pad.y) / 16; 
+  int block_pad = 0; 
+  if(zfp_blocks % cuda_block_size != 0)
+  {
+    block_pad = cuda_block_size - zfp_blocks % cuda_block_size; 
+  }
+  dim3 grid_size = calculate_grid_size(block_pad + zfp_blocks, cuda_block_size);
+
+  cudaDecode2Surface<Scalar, 16> <<< grid_size, dim3(cuda_block_size, 1, 1), 0, cuda_stream >>>
+    (stream,
+     surface,
+     dims,
+     zfp_pad,
+     maxbits,
+     offsets);
+
+  return calc_device_mem2d(zfp_pad, maxbits);
 }
 
 } // namespace cuZFP
@@ -47,27 +47,28 @@ cudaDecode3(Word *blocks,
             const uint3 dims,
             const int3 stride,
             const uint3 padded_dims,
-            uint maxbits)
+            uint maxbits,
+            const unsigned long long int *offsets)
 {
   
   typedef unsigned long long int ull;
   typedef long long int ll;
 
-  const ull blockId = blockIdx.x +
-                      blockIdx.y * gridDim.x +
-                      gridDim.x * gridDim.y * blockIdx.z;
+  const ull blockId = grid_block_index();
   // each thread gets a block so the block index is 
   // the global thread index
   const ull block_idx = blockId * blockDim.x + threadIdx.x;
   
-  const int total_blocks = (padded_dims.x * padded_dims.y * padded_dims.z) / 64; 
+  const ull total_blocks = ((ull)padded_dims.x * padded_dims.y * padded_dims.z) / 64; 
   
   if(block_idx >= total_blocks) 
   {
     return;
   }
 
-  BlockReader<BlockSize> reader(blocks, maxbits, block_idx, total_blocks);
+  // variable-rate streams locate each block through the offset table
+  const ull bit_offset = offsets ? offsets[block_idx] : block_idx * maxbits;
+  BlockReader<BlockSize> reader(blocks, bit_offset, maxbits, block_idx, total_blocks);
  
   Scalar result[BlockSize];
   memset(result, 0, sizeof(Scalar) * BlockSize);
@@ -83,7 +84,7 @@ cudaDecode3(Word *blocks,
   uint3 block;
   block.x = (block_idx % block_dims.x) * 4; 
   block.y = ((block_idx/ block_dims.x) % block_dims.y) * 4; 
-  block.z = (block_idx/ (block_dims.x * block_dims.y)) * 4; 
+  block.z = (block_idx/ ((ull)block_dims.x * block_dims.y)) * 4; 
   
   // default strides
   const ll offset = (ll)block.x * stride.x + (ll)block.y * stride.y + (ll)block.z * stride.z; 
@@ -105,14 +106,175 @@ cudaDecode3(Word *blocks,
     scatter3(result, out + offset, stride.x, stride.y, stride.z);
   }
 }
+
+//
+// Variant of cudaDecode3 in which each thread decodes its zfp block to shared
+// memory, after which the thread block cooperatively stores its zfp blocks,
+// with consecutive threads writing consecutive scalars along x
+//
+template<class Scalar, int BlockSize>
+__global__
+void
+cudaDecode3Staged(Word *blocks,
+                  Scalar *out,
+                  const uint3 dims,
+                  const int3 stride,
+                  const uint3 padded_dims,
+                  uint maxbits,
+                  const unsigned long long int *offsets)
+{
+  typedef unsigned long long int ull;
+  typedef long long int ll;
+  __shared__ Scalar tile[ZFP_3D_STAGED_BLOCKS * ZFP_3D_STAGED_STRIDE];
+  __shared__ ll tile_offset[ZFP_3D_STAGED_BLOCKS];
+  __shared__ uint3 tile_extent[ZFP_3D_STAGED_BLOCKS];
+
+  const ull blockId = grid_block_index();
+  const ull first_block = blockId * blockDim.x;
+  const ull block_idx = first_block + threadIdx.x;
+  const ull total_blocks = ((ull)padded_dims.x * padded_dims.y * padded_dims.z) / 64; 
+  // number of real zfp blocks handled by this thread block
+  const uint count = first_block >= (ull)total_blocks ? 0 : MIN(blockDim.x, total_blocks - first_block);
+
+  if(threadIdx.x < count)
+  {
+    // variable-rate streams locate each block through the offset table
+    const ull bit_offset = offsets ? offsets[block_idx] : block_idx * maxbits;
+    BlockReader<BlockSize> reader(blocks, bit_offset, maxbits, block_idx, total_blocks);
+
+    Scalar result[BlockSize];
+    memset(result, 0, sizeof(Scalar) * BlockSize);
+
+    zfp_decode<Scalar,BlockSize>(reader, result, maxbits);
+
+    Scalar* q = tile + threadIdx.x * ZFP_3D_STAGED_STRIDE;
+    for(int i = 0; i < BlockSize; i++)
+      q[i] = result[i];
+
+    // locate this thread's zfp block and its extent within the field
+    uint3 block_dims;
+    block_dims.x = padded_dims.x >> 2; 
+    block_dims.y = padded_dims.y >> 2; 
+    block_dims.z = padded_dims.z >> 2; 
+    uint3 block;
+    block.x = (block_idx % block_dims.x) * 4; 
+    block.y = ((block_idx/ block_dims.x) % block_dims.y) * 4; 
+    block.z = (block_idx/ ((ull)block_dims.x * block_dims.y)) * 4; 
+    tile_offset[threadIdx.x] = (ll)block.x * stride.x + (ll)block.y * stride.y + (ll)block.z * stride.z;
+    tile_extent[threadIdx.x] = make_uint3(MIN(dims.x - block.x, 4u),
+                                          MIN(dims.y - block.y, 4u),
+                                          MIN(dims.z - block.z, 4u));
+  }
+  __syncthreads();
+
+  // cooperatively store one row of four scalars per zfp block at a time so
+  // that adjacent threads access adjacent scalars
+  for(uint yz = 0; yz < 16; yz++)
+  {
+    const uint y = yz & 3u;
+    const uint z = yz >> 2;
+    for(uint i = threadIdx.x; i < 4 * count; i += blockDim.x)
+    {
+      const uint b = i >> 2;
+      const uint x = i & 3u;
+      const uint3 n = tile_extent[b];
+      if(x < n.x && y < n.y && z < n.z)
+        out[tile_offset[b] + (ll)x * stride.x + (ll)y * stride.y + (ll)z * stride.z] =
+          tile[b * ZFP_3D_STAGED_STRIDE + 16 * z + 4 * y + x];
+    }
+  }
+}
+
+//
+// Variant of cudaDecode3 in which the lanes of a warp cooperatively decode one
+// zfp block to shared memory and then store it
+//
+template<class Scalar, int BlockSize>
+__global__
+void
+cudaDecode3Warp(Word *blocks,
+                Scalar *out,
+                const uint3 dims,
+                const int3 stride,
+                const uint3 padded_dims,
+                uint maxbits,
+                const unsigned long long int *offsets)
+{
+  typedef unsigned long long int ull;
+  typedef long long int ll;
+  typedef typename zfp_traits<Scalar>::Int Int;
+  __shared__ Scalar s_fblock[ZFP_WARP_BLOCKS][BlockSize];
+  __shared__ Int s_iblock[ZFP_WARP_BLOCKS][BlockSize];
+
+  const ull blockId = grid_block_index();
+  // each warp gets a block
+  const uint warp = threadIdx.x / ZFP_WARP_SIZE;
+  const uint lane = threadIdx.x % ZFP_WARP_SIZE;
+  const ull block_idx = blockId * ZFP_WARP_BLOCKS + warp;
+  
+  const ull total_blocks = ((ull)padded_dims.x * padded_dims.y * padded_dims.z) / 64; 
+  
+  if(block_idx >= total_blocks) 
+  {
+    return;
+  }
+
+  // variable-rate streams locate each block through the offset table
+  const ull bit_offset = offsets ? offsets[block_idx] : block_idx * maxbits;
+  BlockReader<BlockSize> reader(blocks, bit_offset, maxbits, block_idx, total_blocks);
+ 
+  Scalar* result = s_fblock[warp];
+  for(uint i = lane; i < BlockSize; i += ZFP_WARP_SIZE)
+    result[i] = 0;
+
+  zfp_decode_warp<Scalar,BlockSize>(reader, result, s_iblock[warp], maxbits, lane);
+  warp_sync();
+
+  // logical block dims
+  uint3 block_dims;
+  block_dims.x = padded_dims.x >> 2; 
+  block_dims.y = padded_dims.y >> 2; 
+  block_dims.z = padded_dims.z >> 2; 
+  // logical pos in 3d array
+  uint3 block;
+  block.x = (block_idx % block_dims.x) * 4; 
+  block.y = ((block_idx/ block_dims.x) % block_dims.y) * 4; 
+  block.z = (block_idx/ ((ull)block_dims.x * block_dims.y)) * 4; 
+  
+  // default strides
+  const ll offset = (ll)block.x * stride.x + (ll)block.y * stride.y + (ll)block.z * stride.z; 
+  const uint nx = MIN(dims.x - block.x, 4u);
+  const uint ny = MIN(dims.y - block.y, 4u);
+  const uint nz = MIN(dims.z - block.z, 4u);
+
+  // adjacent lanes store adjacent scalars along x
+  for(uint i = lane; i < BlockSize; i += ZFP_WARP_SIZE)
+  {
+    const uint x = i & 3u;
+    const uint y = (i >> 2) & 3u;
+    const uint z = i >> 4;
+    if(x < nx && y < ny && z < nz)
+      out[offset + (ll)x * stride.x + (ll)y * stride.y + (ll)z * stride.z] = result[i];
+  }
+}
+
 template<class Scalar>
 size_t decode3launch(uint3 dims, 
                      int3 stride,
                      Word *stream,
                      Scalar *d_data,
-                     uint maxbits)
+                     uint maxbits,
+                     const unsigned long long int *offsets,
+                     cudaStream_t cuda_stream)
 {
-  const int cuda_block_size = 128;
+  // decode 64-bit blocks with one warp per block to relieve register
+  // pressure, and otherwise stage contiguous rows through shared memory so
+  // that stores coalesce
+  const bool warp = sizeof(Scalar) == 8;
+  const bool staged = stride.x == 1;
+  const int cuda_block_size = warp ? ZFP_WARP_BLOCKS * ZFP_WARP_SIZE : staged ? ZFP_3D_STAGED_BLOCKS : 128;
+  // number of zfp blocks per cuda block
+  const int zfp_block_size = warp ? ZFP_WARP_BLOCKS : cuda_block_size;
   dim3 block_size;
   block_size = dim3(cuda_block_size, 1, 1);
 
@@ -123,7 +285,7 @@ size_t decode3launch(uint3 dims,
   if(zfp_pad.y % 4 != 0) zfp_pad.y += 4 - dims.y % 4;
   if(zfp_pad.z % 4 != 0) zfp_pad.z += 4 - dims.z % 4;
 
-  const int zfp_blocks = (zfp_pad.x * zfp_pad.y * zfp_pad.z) / 64; 
+  const size_t zfp_blocks = ((size_t)zfp_pad.x * zfp_pad.y * zfp_pad.z) / 64; 
 
   
   //
@@ -131,15 +293,15 @@ size_t decode3launch(uint3 dims,
   // cuda block size
   //
   int block_pad = 0; 
-  if(zfp_blocks % cuda_block_size != 0)
+  if(zfp_blocks % zfp_block_size != 0)
   {
-    block_pad = cuda_block_size - zfp_blocks % cuda_block_size; 
+    block_pad = zfp_block_size - zfp_blocks % zfp_block_size; 
   }
 
   size_t total_blocks = block_pad + zfp_blocks;
   size_t stream_bytes = calc_device_mem3d(zfp_pad, maxbits);
 
-  dim3 grid_size = calculate_grid_size(total_blocks, cuda_block_size);
+  dim3 grid_size = calculate_grid_size(total_blocks, zfp_block_size);
 
 #ifdef CUDA_ZFP_RATE_PRINT
   // setup some timing code
@@ -147,21 +309,41 @@ size_t decode3launch(uint3 dims,
   cudaEventCreate(&start);
   cudaEventCreate(&stop);
 
-  cudaEventRecord(start);
+  cudaEventRecord(start, cuda_stream);
 #endif
 
-  cudaDecode3<Scalar, 64> <<< grid_size, block_size >>>
-    (stream,
-		 d_data,
-     dims,
-     stride,
-     zfp_pad,
-     maxbits);
+  if(warp)
+    cudaDecode3Warp<Scalar, 64> <<< grid_size, block_size, 0, cuda_stream >>>
+      (stream,
+       d_data,
+       dims,
+       stride,
+       zfp_pad,
+       maxbits,
+       offsets);
+  else if(staged)
+    cudaDecode3Staged<Scalar, 64> <<< grid_size, block_size, 0, cuda_stream >>>
+      (stream,
+       d_data,
+       dims,
+       stride,
+       zfp_pad,
+       maxbits,
+       offsets);
+  else
+    cudaDecode3<Scalar, 64> <<< grid_size, block_size, 0, cuda_stream >>>
+      (stream,
+       d_data,
+       dims,
+       stride,
+       zfp_pad,
+       maxbits,
+       offsets);
 
 #ifdef CUDA_ZFP_RATE_PRINT
-  cudaEventRecord(stop);
+  cudaEventRecord(stop, cuda_stream);
   cudaEventSynchronize(stop);
-	cudaStreamSynchronize(0);
+	cudaStreamSynchronize(cuda_stream);
 
   float miliseconds = 0;
   cudaEventElapsedTime(&miliseconds, start, stop);
@@ -182,9 +364,212 @@ size_t decode3(uint3 dims,
                int3 stride,
                Word  *stream,
                Scalar *d_data,
-               uint maxbits)
+               uint maxbits,
+               const unsigned long long int *offsets = NULL,
+               cudaStream_t cuda_stream = 0)
+{
+	return decode3launch<Scalar>(dims, stride, stream, d_data, maxbits, offsets, cuda_stream);
+}
+
+//
+// Variant of cudaDecode3 that stores decoded values through a surface object,
+// e.g., one bound to the cudaArray backing a 3D texture; the array's
+// block-linear layout keeps each zfp block's stores local
+//
+template<class Scalar, int BlockSize>
+__global__
+void
+cudaDecode3Surface(Word *blocks,
+                   cudaSurfaceObject_t surface,
+                   const uint3 dims,
+                   const uint3 padded_dims,
+                   uint maxbits,
+                   const unsigned long long int *offsets)
+{
+  typedef unsigned long long int ull;
+  const ull blockId = grid_block_index();
+  const ull block_idx = blockId * blockDim.x + threadIdx.x;
+  const ull total_blocks = ((ull)padded_dims.x * padded_dims.y * padded_dims.z) / 64; 
+
+  if(block_idx >= total_blocks) 
+  {
+    return;
+  }
+
+  // variable-rate streams locate each block through the offset table
+  const ull bit_offset = offsets ? offsets[block_idx] : block_idx * maxbits;
+  BlockReader<BlockSize> reader(blocks, bit_offset, maxbits, block_idx, total_blocks);
+
+  Scalar result[BlockSize];
+  memset(result, 0, sizeof(Scalar) * BlockSize);
+
+  zfp_decode<Scalar,BlockSize>(reader, result, maxbits);
+
+  // logical pos in 3d array
+  uint3 block_dims;
+  block_dims.x = padded_dims.x >> 2; 
+  block_dims.y = padded_dims.y >> 2; 
+  uint3 block;
+  block.x = (block_idx % block_dims.x) * 4; 
+  block.y = ((block_idx/ block_dims.x) % block_dims.y) * 4; 
+  block.z = (block_idx/ ((ull)block_dims.x * block_dims.y)) * 4; 
+  const uint nx = MIN(dims.x - block.x, 4u);
+  const uint ny = MIN(dims.y - block.y, 4u);
+  const uint nz = MIN(dims.z - block.z, 4u);
+
+  // surfaces are addressed in bytes along x
+  for(uint z = 0; z < nz; z++)
+    for(uint y = 0; y < ny; y++)
+      for(uint x = 0; x < nx; x++)
+        surf3Dwrite(result[16 * z + 4 * y + x], surface, (int)((block.x + x) * sizeof(Scalar)), (int)(block.y + y), (int)(block.z + z));
+}
+
+template<class Scalar>
+size_t decode3surface(uint3 dims, 
+                      Word *stream,
+                      cudaSurfaceObject_t surface,
+                      uint maxbits,
+                      const unsigned long long int *offsets,
+                      cudaStream_t cuda_stream)
+{
+  const int cuda_block_size = 128;
+  uint3 zfp_pad(dims); 
+  if(zfp_pad.x % 4 != 0) zfp_pad.x += 4 - dims.x % 4;
+  if(zfp_pad.y % 4 != 0) zfp_pad.y += 4 - dims.y % 4;
+  if(zfp_pad.z % 4 != 0) zfp_pad.z += 4 - dims.z % 4;
+
+  const size_t zfp_blocks = ((size_t)zfp_pad.x * zfp_pad.y * zfp_pad.z) / 64; 
+  int block_pad = 0; 
+  if(zfp_blocks % cuda_block_size != 0)
+  {
+    block_pad = cuda_block_size - zfp_blocks % cuda_block_size; 
+  }
+  dim3 grid_size = calculate_grid_size(block_pad + zfp_blocks, cuda_block_size);
+
+  cudaDecode3Surface<Scalar, 64> <<< grid_size, dim3(cuda_block_size, 1, 1), 0, cuda_stream >>>
+    (stream,
+     surface,
+     dims,
+     zfp_pad,
+     maxbits,
+     offsets);
+
+  return calc_device_mem3d(zfp_pad, maxbits);
+}
+
+//
+// Variant of cudaDecode3 that launches threads only for the zfp blocks listed
+// in index, e.g., those intersecting a region of interest, and stores either
+// their intersection with a box of the field, relative to the box origin, or
+// whole blocks back to back in a compact brick pool
+//
+template<class Scalar, int BlockSize>
+__global__
+void
+cudaDecode3Blocks(Word *blocks,
+                  Scalar *out,
+                  const uint3 dims,
+                  const int3 stride,
+                  const uint3 padded_dims,
+                  uint maxbits,
+                  const unsigned long long int *offsets,
+                  const unsigned long long int *index,
+                  const unsigned long long int count,
+                  const uint3 origin,
+                  const uint3 extent,
+                  bool bricks)
+{
+  typedef unsigned long long int ull;
+  typedef long long int ll;
+  const ull blockId = grid_block_index();
+  const ull i = blockId * blockDim.x + threadIdx.x;
+  const ull total_blocks = ((ull)padded_dims.x * padded_dims.y * padded_dims.z) / 64; 
+
+  if(i >= count) 
+  {
+    return;
+  }
+
+  // variable-rate streams locate each block through the offset table
+  const ull block_idx = index[i];
+  const ull bit_offset = offsets ? offsets[block_idx] : block_idx * maxbits;
+  BlockReader<BlockSize> reader(blocks, bit_offset, maxbits, block_idx, total_blocks);
+
+  Scalar result[BlockSize];
+  memset(result, 0, sizeof(Scalar) * BlockSize);
+
+  zfp_decode<Scalar,BlockSize>(reader, result, maxbits);
+
+  if(bricks)
+  {
+    Scalar *p = out + i * BlockSize;
+    for(int j = 0; j < BlockSize; j++)
+      p[j] = result[j];
+    return;
+  }
+
+  // logical pos in 3d array
+  uint3 block_dims;
+  block_dims.x = padded_dims.x >> 2; 
+  block_dims.y = padded_dims.y >> 2; 
+  uint3 block;
+  block.x = (block_idx % block_dims.x) * 4; 
+  block.y = ((block_idx/ block_dims.x) % block_dims.y) * 4; 
+  block.z = (block_idx/ ((ull)block_dims.x * block_dims.y)) * 4; 
+
+  // intersection of block with box, which lies within the field
+  const uint xmin = MAX(block.x, origin.x), xmax = MIN(block.x + 4, origin.x + extent.x);
+  const uint ymin = MAX(block.y, origin.y), ymax = MIN(block.y + 4, origin.y + extent.y);
+  const uint zmin = MAX(block.z, origin.z), zmax = MIN(block.z + 4, origin.z + extent.z);
+  for(uint z = zmin; z < zmax; z++)
+    for(uint y = ymin; y < ymax; y++)
+      for(uint x = xmin; x < xmax; x++)
+        out[(ll)(x - origin.x) * stride.x + (ll)(y - origin.y) * stride.y + (ll)(z - origin.z) * stride.z] =
+          result[16 * (z - block.z) + 4 * (y - block.y) + (x - block.x)];
+}
+
+template<class Scalar>
+size_t decode3blocks(uint3 dims, 
+                     int3 stride,
+                     Word *stream,
+                     Scalar *d_data,
+                     uint maxbits,
+                     const unsigned long long int *offsets,
+                     const unsigned long long int *d_index,
+                     size_t count,
+                     uint3 origin,
+                     uint3 extent,
+                     bool bricks,
+                     cudaStream_t cuda_stream)
 {
-	return decode3launch<Scalar>(dims, stride, stream, d_data, maxbits);
+  const int cuda_block_size = 128;
+  uint3 zfp_pad(dims); 
+  if(zfp_pad.x % 4 != 0) zfp_pad.x += 4 - dims.x % 4;
+  if(zfp_pad.y % 4 != 0) zfp_pad.y += 4 - dims.y % 4;
+  if(zfp_pad.z % 4 != 0) zfp_pad.z += 4 - dims.z % 4;
+
+  int block_pad = 0; 
+  if(count % cuda_block_size != 0)
+  {
+    block_pad = cuda_block_size - count % cuda_block_size; 
+  }
+  dim3 grid_size = calculate_grid_size(block_pad + count, cuda_block_size);
+
+  cudaDecode3Blocks<Scalar, 64> <<< grid_size, dim3(cuda_block_size, 1, 1), 0, cuda_stream >>>
+    (stream,
+     d_data,
+     dims,
+     stride,
+     zfp_pad,
+     maxbits,
+     offsets,
+     d_index,
+     count,
+     origin,
+     extent,
+     bricks);
+
+  return calc_device_mem3d(zfp_pad, maxbits);
 }
 
 } // namespace cuZFP
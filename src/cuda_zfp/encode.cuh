@@ -6,14 +6,6 @@
 namespace cuZFP
 {
 
-// maximum number of bit planes to encode
-__device__ 
-static int
-precision(int maxexp, int maxprec, int minexp)
-{
-  return MIN(maxprec, MAX(0, maxexp - minexp + 8));
-}
-
 template<typename Scalar>
 inline __device__
 void pad_block(Scalar *p, uint n, uint s)
@@ -127,6 +119,39 @@ void __device__ fwd_cast(Int *iblock, const Scalar *fblock, int emax)
 template<int BlockSize>
 struct transform;
 
+template<>
+struct transform<256>
+{
+  template<typename Int>
+  __device__ void fwd_xform(Int *p)
+  {
+
+    uint x, y, z, w;
+    /* transform along x */
+    for (w = 0; w < 4; w++)
+      for (z = 0; z < 4; z++)
+        for (y = 0; y < 4; y++)
+          fwd_lift<Int,1>(p + 4 * y + 16 * z + 64 * w);
+    /* transform along y */
+    for (x = 0; x < 4; x++)
+      for (w = 0; w < 4; w++)
+        for (z = 0; z < 4; z++)
+          fwd_lift<Int,4>(p + 16 * z + 64 * w + 1 * x);
+    /* transform along z */
+    for (y = 0; y < 4; y++)
+      for (x = 0; x < 4; x++)
+        for (w = 0; w < 4; w++)
+          fwd_lift<Int,16>(p + 64 * w + 1 * x + 4 * y);
+    /* transform along w */
+    for (z = 0; z < 4; z++)
+      for (y = 0; y < 4; y++)
+        for (x = 0; x < 4; x++)
+          fwd_lift<Int,64>(p + 1 * x + 4 * y + 16 * z);
+
+   }
+
+};
+
 template<>
 struct transform<64>
 {
@@ -150,6 +175,25 @@ struct transform<64>
 
    }
 
+  // transform shared by the lanes of a warp, each of which lifts one
+  // 4-vector per direction
+  template<typename Int>
+  __device__ void fwd_xform_lane(Int *p, uint lane)
+  {
+    /* transform along x */
+    if(lane < 16)
+      fwd_lift<Int,1>(p + 4 * lane);
+    warp_sync();
+    /* transform along y */
+    if(lane < 16)
+      fwd_lift<Int,4>(p + 16 * (lane >> 2) + (lane & 3u));
+    warp_sync();
+    /* transform along z */
+    if(lane < 16)
+      fwd_lift<Int,16>(p + lane);
+    warp_sync();
+  }
+
 };
 
 template<>
@@ -196,13 +240,13 @@ template<int block_size>
 struct BlockWriter
 {
 
-  uint m_word_index;
+  size_t m_word_index;
   uint m_start_bit;
   uint m_current_bit;
   const int m_maxbits; 
   Word *m_stream;
 
-  __device__ BlockWriter(Word *stream, const int &maxbits, const uint &block_idx)
+  __device__ BlockWriter(Word *stream, const int &maxbits, const unsigned long long int &block_idx)
    :  m_current_bit(0),
       m_maxbits(maxbits),
       m_stream(stream)
@@ -238,7 +282,7 @@ struct BlockWriter
   {
     const uint wbits = sizeof(Word) * 8;
     uint seg_start = (m_start_bit + m_current_bit) % wbits;
-    uint write_index = m_word_index + uint((m_start_bit + m_current_bit) / wbits);
+    size_t write_index = m_word_index + ((m_start_bit + m_current_bit) / wbits);
     uint seg_end = seg_start + n_bits - 1;
     uint shift = seg_start; 
     // we may be asked to write less bits than exist in 'bits'
@@ -267,7 +311,7 @@ struct BlockWriter
   {
     const uint wbits = sizeof(Word) * 8;
     uint seg_start = (m_start_bit + m_current_bit) % wbits;
-    uint write_index = m_word_index + uint((m_start_bit + m_current_bit) / wbits);
+    size_t write_index = m_word_index + ((m_start_bit + m_current_bit) / wbits);
     uint shift = seg_start; 
     // we may be asked to write less bits than exist in 'bits'
     // so we have to make sure that anything after n is zero.
@@ -284,8 +328,91 @@ struct BlockWriter
 
 };
 
+// block writer shared by the lanes of a warp, which all follow the same
+// control flow, though only the leading lane writes to the stream
+template<int block_size>
+struct WarpBlockWriter
+{
+
+  BlockWriter<block_size> m_writer;
+  const bool m_lead;
+
+  __device__ WarpBlockWriter(Word *stream, const int &maxbits, const unsigned long long int &block_idx, const bool &lead)
+   :  m_writer(stream, maxbits, block_idx),
+      m_lead(lead)
+  {
+  }
+
+  // all lanes track the stream position
+  __device__
+  long long unsigned int
+  write_bits(const long long unsigned int &bits, const uint &n_bits)
+  {
+    if(m_lead)
+    {
+      return m_writer.write_bits(bits, n_bits);
+    }
+    m_writer.m_current_bit += n_bits;
+    return bits >> (Word)n_bits;
+  }
+
+  __device__
+  uint write_bit(const unsigned int &bit)
+  {
+    if(m_lead)
+    {
+      m_writer.write_bit(bit);
+    }
+    else
+    {
+      m_writer.m_current_bit += 1;
+    }
+    return bit;
+  }
+
+};
+
+// encode block of more than 64 integers, whose bit planes do not fit in a word
+template<typename UInt, int BlockSize>
+uint inline __device__ encode_many_ints(BlockWriter<BlockSize> &stream,
+                                        int maxbits,
+                                        int maxprec,
+                                        const UInt *ublock)
+{
+  uint intprec = CHAR_BIT * (uint)sizeof(UInt);
+  uint kmin = intprec > maxprec ? intprec - maxprec : 0;
+  uint bits = maxbits;
+  uint i, k, m, n, c;
+
+  for (k = intprec, n = 0; bits && k-- > kmin;) {
+    /* step 1: encode first n bits of bit plane #k */
+    m = min(n, bits);
+    bits -= m;
+    for (i = 0; i < m; i++)
+    {
+      stream.write_bit((ublock[i] >> k) & 1u);
+    }
+    /* step 2: count remaining one-bits in bit plane */
+    c = 0;
+    for (i = m; i < BlockSize; i++)
+    {
+      c += (ublock[i] >> k) & 1u;
+    }
+    /* step 3: unary run-length encode remainder of bit plane */
+    for (; n < BlockSize && bits && (bits--, stream.write_bit(!!c)); c--, n++)
+    {
+      for (; n < BlockSize - 1 && bits && (bits--, !stream.write_bit((ublock[n] >> k) & 1u)); n++)
+      {
+      }
+    }
+  }
+
+  return maxbits - bits;
+}
+
+// encode block of integers and return number of bits written
 template<typename Int, int BlockSize> 
-void inline __device__ encode_block(BlockWriter<BlockSize> &stream,
+uint inline __device__ encode_block(BlockWriter<BlockSize> &stream,
                                     int maxbits,
                                     int maxprec,
                                     Int *iblock)
@@ -297,6 +424,11 @@ void inline __device__ encode_block(BlockWriter<BlockSize> &stream,
   UInt ublock[BlockSize]; 
   fwd_order<Int, UInt, BlockSize>(ublock, iblock);
 
+  if(BlockSize > 64)
+  {
+    return encode_many_ints<UInt, BlockSize>(stream, maxbits, maxprec, ublock);
+  }
+
   uint intprec = CHAR_BIT * (uint)sizeof(UInt);
   uint kmin = intprec > maxprec ? intprec - maxprec : 0;
   uint bits = maxbits;
@@ -324,19 +456,151 @@ void inline __device__ encode_block(BlockWriter<BlockSize> &stream,
       }
     }
   }
-  
+
+  return maxbits - bits;
 }
 
+// number of bits needed to encode bit plane x of a block when n coefficients
+// are already significant; the group tests emit one bit per one bit of x at
+// or above n, plus a terminating zero unless the plane ends on a one bit
+template<int BlockSize>
+inline __device__
+uint plane_bits(uint64 x, uint n, uint &n_next)
+{
+  const uint h = x ? 64 - __clzll(x) : 0;
+  const uint ones = n < BlockSize ? __popcll(x >> n) : 0;
+  n_next = max(n, h);
+  return n_next + ones + (n_next < BlockSize ? 1 : 0) - (ones && n_next == BlockSize ? 1 : 0);
+}
+
+// encode bit plane x given n significant coefficients using at most bits bits
+template<int BlockSize>
+inline __device__
+void encode_plane(BlockWriter<BlockSize> &stream, uint64 x, uint n, uint bits)
+{
+  /* step 1: encode first n bits of bit plane */
+  uint m = min(n, bits);
+  bits -= m;
+  x = stream.write_bits(x, m);
+
+  /* step 2: unary run-length encode remainder of bit plane */
+  for (; n < BlockSize && bits && (bits--, stream.write_bit(!!x)); x >>= 1, n++)
+  {
+    // the group test passed, so emit the run of zeros up to and including
+    // the next one bit at once rather than one bit at a time
+    uint run = __ffsll(x);
+    uint w = min(run, min(BlockSize - 1 - n, bits));
+    if(w)
+    {
+      stream.write_bits(x, w);
+      bits -= w;
+      w = w < run ? w : run - 1;
+      x >>= w;
+      n += w;
+    }
+  }
+}
+
+// encode block of at most 64 integers in shared memory cooperatively by the
+// lanes of a warp and return number of bits written; rather than encoding
+// one bit plane after another, the lanes compute where in the stream each
+// plane begins and then encode the planes concurrently
+template<typename Int, int BlockSize> 
+uint inline __device__ encode_block_warp(WarpBlockWriter<BlockSize> &stream,
+                                         int maxbits,
+                                         int maxprec,
+                                         Int *iblock,
+                                         uint lane)
+{
+  // make the lanes' coefficients visible to the whole warp
+  warp_sync();
+  transform<BlockSize> tform;
+  tform.fwd_xform_lane(iblock, lane);
+
+  // each lane holds coefficients lane, lane + ZFP_WARP_SIZE, ... in
+  // sequency order
+  typedef typename zfp_traits<Int>::UInt UInt;
+  const uint lane_size = BlockSize / ZFP_WARP_SIZE;
+  const unsigned char *perm = get_perm<BlockSize>();
+  UInt ublock[lane_size];
+  for(uint i = 0; i < lane_size; i++)
+  {
+    ublock[i] = int2uint(iblock[perm[lane + ZFP_WARP_SIZE * i]]);
+  }
+
+  // bit planes are numbered p = intprec - 1 - k in encoding order, and lane
+  // owns planes lane, lane + ZFP_WARP_SIZE, ...
+  const uint intprec = CHAR_BIT * (uint)sizeof(UInt);
+  const uint rounds = (CHAR_BIT * sizeof(UInt) + ZFP_WARP_SIZE - 1) / ZFP_WARP_SIZE;
+  const uint planes = min((uint)maxprec, intprec);
+  uint64 plane[rounds];
+  uint i, p, r;
+
+  /* step 1: gather each bit plane from all lanes */
+  for (r = 0; r < rounds; r++)
+  {
+    plane[r] = 0;
+  }
+  for (p = 0; p < planes; p++) {
+    const uint k = intprec - 1 - p;
+    uint64 x = 0;
+    for (i = 0; i < lane_size; i++)
+    {
+      x += warp_ballot((ublock[i] >> k) & 1u) << (ZFP_WARP_SIZE * i);
+    }
+    for (r = 0; r < rounds; r++)
+    {
+      if (p == r * ZFP_WARP_SIZE + lane)
+        plane[r] = x;
+    }
+  }
+
+  /* step 2: scan for significant coefficients and stream offset per plane */
+  uint n_carry = 0;
+  uint offset_carry = 0;
+  uint n[rounds];
+  uint offset[rounds];
+  for (r = 0; r < rounds; r++) {
+    const bool own = r * ZFP_WARP_SIZE + lane < planes;
+    const uint h = plane[r] ? 64 - __clzll(plane[r]) : 0;
+    const uint n_incl = max(warp_scan_max(h, lane), n_carry);
+    const uint n_prev = warp_shfl_up(n_incl, 1);
+    n[r] = lane ? n_prev : n_carry;
+    n_carry = warp_shfl(n_incl, ZFP_WARP_SIZE - 1);
+
+    uint n_next;
+    const uint size = own ? plane_bits<BlockSize>(plane[r], n[r], n_next) : 0;
+    const uint offset_incl = warp_scan_add(size, lane) + offset_carry;
+    offset[r] = offset_incl - size;
+    offset_carry = warp_shfl(offset_incl, ZFP_WARP_SIZE - 1);
+  }
+
+  /* step 3: encode bit planes that start within the bit budget */
+  const uint bits = min(offset_carry, (uint)maxbits);
+  for (r = 0; r < rounds; r++) {
+    if (r * ZFP_WARP_SIZE + lane < planes && offset[r] < bits) {
+      BlockWriter<BlockSize> writer = stream.m_writer;
+      writer.m_current_bit += offset[r];
+      encode_plane<BlockSize>(writer, plane[r], n[r], bits - offset[r]);
+    }
+  }
+
+  return bits;
+}
+
+// encode block and return number of bits written, including padding
 template<typename Scalar, int BlockSize>
-void inline __device__ zfp_encode_block(Scalar *fblock,
+uint inline __device__ zfp_encode_block(Scalar *fblock,
                                         const int maxbits,
-                                        const uint block_idx,
+                                        const unsigned long long int block_idx,
                                         Word *stream)
 {
   BlockWriter<BlockSize> block_writer(stream, maxbits, block_idx);
   int emax = max_exponent<Scalar, BlockSize>(fblock);
-  int maxprec = precision(emax, get_precision<Scalar>(), get_min_exp<Scalar>());
+  int maxprec = precision<BlockSize>(emax, c_maxprec, c_minexp);
   uint e = maxprec ? emax + get_ebias<Scalar>() : 0;
+  // an empty block is a single zero bit, which the zeroed stream already holds
+  uint bits = 1;
   if(e)
   {
     const uint ebits = get_ebits<Scalar>()+1;
@@ -346,74 +610,212 @@ void inline __device__ zfp_encode_block(Scalar *fblock,
     fwd_cast<Scalar, Int, BlockSize>(iblock, fblock, emax);
 
 
-    encode_block<Int, BlockSize>(block_writer, maxbits - ebits, maxprec, iblock);
+    bits = ebits + encode_block<Int, BlockSize>(block_writer, maxbits - ebits, maxprec, iblock);
   }
+  return MAX(bits, c_minbits);
 }
 
 template<>
-void inline __device__ zfp_encode_block<int, 64>(int *fblock,
+uint inline __device__ zfp_encode_block<int, 256>(int *fblock,
+                                              const int maxbits,
+                                              const unsigned long long int block_idx,
+                                             Word *stream)
+{
+  BlockWriter<256> block_writer(stream, maxbits, block_idx);
+  const int intprec = get_precision<int>();
+  uint bits = encode_block<int, 256>(block_writer, maxbits, MIN((int)c_maxprec, intprec), fblock);
+  return MAX(bits, c_minbits);
+}
+
+template<>
+uint inline __device__ zfp_encode_block<long long int, 256>(long long int *fblock,
+                                                        const int maxbits,
+                                                        const unsigned long long int block_idx,
+                                                       Word *stream)
+{
+  BlockWriter<256> block_writer(stream, maxbits, block_idx);
+  const int intprec = get_precision<long long int>();
+  uint bits = encode_block<long long int, 256>(block_writer, maxbits, MIN((int)c_maxprec, intprec), fblock);
+  return MAX(bits, c_minbits);
+}
+
+template<>
+uint inline __device__ zfp_encode_block<int, 64>(int *fblock,
                                              const int maxbits,
-                                             const uint block_idx,
+                                             const unsigned long long int block_idx,
                                              Word *stream)
 {
   BlockWriter<64> block_writer(stream, maxbits, block_idx);
   const int intprec = get_precision<int>();
-  encode_block<int, 64>(block_writer, maxbits, intprec, fblock);
+  uint bits = encode_block<int, 64>(block_writer, maxbits, MIN((int)c_maxprec, intprec), fblock);
+  return MAX(bits, c_minbits);
 }
 
 template<>
-void inline __device__ zfp_encode_block<long long int, 64>(long long int *fblock,
+uint inline __device__ zfp_encode_block<long long int, 64>(long long int *fblock,
                                                        const int maxbits,
-                                                       const uint block_idx,
+                                                       const unsigned long long int block_idx,
                                                        Word *stream)
 {
   BlockWriter<64> block_writer(stream, maxbits, block_idx);
   const int intprec = get_precision<long long int>();
-  encode_block<long long int, 64>(block_writer, maxbits, intprec, fblock);
+  uint bits = encode_block<long long int, 64>(block_writer, maxbits, MIN((int)c_maxprec, intprec), fblock);
+  return MAX(bits, c_minbits);
 }
 
 template<>
-void inline __device__ zfp_encode_block<int, 16>(int *fblock,
+uint inline __device__ zfp_encode_block<int, 16>(int *fblock,
                                              const int maxbits,
-                                             const uint block_idx,
+                                             const unsigned long long int block_idx,
                                              Word *stream)
 {
   BlockWriter<16> block_writer(stream, maxbits, block_idx);
   const int intprec = get_precision<int>();
-  encode_block<int, 16>(block_writer, maxbits, intprec, fblock);
+  uint bits = encode_block<int, 16>(block_writer, maxbits, MIN((int)c_maxprec, intprec), fblock);
+  return MAX(bits, c_minbits);
 }
 
 template<>
-void inline __device__ zfp_encode_block<long long int, 16>(long long int *fblock,
+uint inline __device__ zfp_encode_block<long long int, 16>(long long int *fblock,
                                                        const int maxbits,
-                                                       const uint block_idx,
+                                                       const unsigned long long int block_idx,
                                                        Word *stream)
 {
   BlockWriter<16> block_writer(stream, maxbits, block_idx);
   const int intprec = get_precision<long long int>();
-  encode_block<long long int, 16>(block_writer, maxbits, intprec, fblock);
+  uint bits = encode_block<long long int, 16>(block_writer, maxbits, MIN((int)c_maxprec, intprec), fblock);
+  return MAX(bits, c_minbits);
 }
 
 template<>
-void inline __device__ zfp_encode_block<int, 4>(int *fblock,
+uint inline __device__ zfp_encode_block<int, 4>(int *fblock,
                                              const int maxbits,
-                                             const uint block_idx,
+                                             const unsigned long long int block_idx,
                                              Word *stream)
 {
   BlockWriter<4> block_writer(stream, maxbits, block_idx);
   const int intprec = get_precision<int>();
-  encode_block<int, 4>(block_writer, maxbits, intprec, fblock);
+  uint bits = encode_block<int, 4>(block_writer, maxbits, MIN((int)c_maxprec, intprec), fblock);
+  return MAX(bits, c_minbits);
 }
 
 template<>
-void inline __device__ zfp_encode_block<long long int, 4>(long long int *fblock,
+uint inline __device__ zfp_encode_block<long long int, 4>(long long int *fblock,
                                                        const int maxbits,
-                                                       const uint block_idx,
+                                                       const unsigned long long int block_idx,
                                                        Word *stream)
 {
   BlockWriter<4> block_writer(stream, maxbits, block_idx);
   const int intprec = get_precision<long long int>();
-  encode_block<long long int, 4>(block_writer, maxbits, intprec, fblock);
+  uint bits = encode_block<long long int, 4>(block_writer, maxbits, MIN((int)c_maxprec, intprec), fblock);
+  return MAX(bits, c_minbits);
+}
+
+// encode block in shared memory cooperatively by the lanes of a warp and
+// return number of bits written, including padding; iblock is scratch space
+// for the block's integer coefficients
+template<typename Scalar, int BlockSize>
+uint inline __device__ zfp_encode_block_warp(Scalar *fblock,
+                                             typename zfp_traits<Scalar>::Int *iblock,
+                                             const uint lane,
+                                             const int maxbits,
+                                             const unsigned long long int block_idx,
+                                             Word *stream)
+{
+  WarpBlockWriter<BlockSize> block_writer(stream, maxbits, block_idx, lane == 0);
+  // the largest exponent among the lanes' own values is shared by the warp
+  int emax = -get_ebias<Scalar>();
+  for(uint i = lane; i < BlockSize; i += ZFP_WARP_SIZE)
+  {
+    emax = max(emax, exponent<Scalar>(fabs(fblock[i])));
+  }
+  emax = warp_max(emax);
+  int maxprec = precision<BlockSize>(emax, c_maxprec, c_minexp);
+  uint e = maxprec ? emax + get_ebias<Scalar>() : 0;
+  // an empty block is a single zero bit, which the zeroed stream already holds
+  uint bits = 1;
+  if(e)
+  {
+    const uint ebits = get_ebits<Scalar>()+1;
+    block_writer.write_bits(2 * e + 1, ebits);
+    typedef typename zfp_traits<Scalar>::Int Int;
+    Scalar s = quantize_factor(emax, Scalar());
+    for(uint i = lane; i < BlockSize; i += ZFP_WARP_SIZE)
+    {
+      iblock[i] = (Int) (s * fblock[i]);
+    }
+
+    bits = ebits + encode_block_warp<Int, BlockSize>(block_writer, maxbits - ebits, maxprec, iblock, lane);
+  }
+  return MAX(bits, c_minbits);
+}
+
+template<>
+uint inline __device__ zfp_encode_block_warp<int, 64>(int *fblock,
+                                                  int *,
+                                                  const uint lane,
+                                                  const int maxbits,
+                                                  const unsigned long long int block_idx,
+                                                  Word *stream)
+{
+  WarpBlockWriter<64> block_writer(stream, maxbits, block_idx, lane == 0);
+  const int intprec = get_precision<int>();
+  uint bits = encode_block_warp<int, 64>(block_writer, maxbits, MIN((int)c_maxprec, intprec), fblock, lane);
+  return MAX(bits, c_minbits);
+}
+
+template<>
+uint inline __device__ zfp_encode_block_warp<long long int, 64>(long long int *fblock,
+                                                            long long int *,
+                                                            const uint lane,
+                                                            const int maxbits,
+                                                            const unsigned long long int block_idx,
+                                                            Word *stream)
+{
+  WarpBlockWriter<64> block_writer(stream, maxbits, block_idx, lane == 0);
+  const int intprec = get_precision<long long int>();
+  uint bits = encode_block_warp<long long int, 64>(block_writer, maxbits, MIN((int)c_maxprec, intprec), fblock, lane);
+  return MAX(bits, c_minbits);
+}
+
+//
+// concatenate variable-length blocks encoded into fixed-size slots
+//
+__global__
+void
+cudaConcat(const Word *slots,
+           const uint slot_words,
+           const unsigned long long int *offsets,
+           Word *stream,
+           const unsigned long long int tot_blocks)
+{
+  typedef unsigned long long int ull;
+  const ull blockId = grid_block_index();
+
+  // each thread copies one zfp block
+  const ull block_idx = blockId * blockDim.x + threadIdx.x;
+
+  if(block_idx >= tot_blocks)
+  {
+    return;
+  }
+
+  const Word *src = slots + (size_t)block_idx * slot_words;
+  const ull offset = offsets[block_idx];
+  ull bits = offsets[block_idx + 1] - offset;
+  Word *dst = stream + offset / Wsize;
+  const uint shift = offset % Wsize;
+
+  // neighboring blocks may share a word, so deposit bits atomically
+  for(uint i = 0; bits; i++)
+  {
+    const uint n = MIN(bits, (ull)Wsize);
+    Word w = src[i];
+    if(n < Wsize) w &= ((Word)1 << n) - 1;
+    atomicAdd(&dst[i], w << shift);
+    if(shift + n > Wsize) atomicAdd(&dst[i + 1], w >> (Wsize - shift));
+    bits -= n;
+  }
 }
 
 }  // namespace cuZFP
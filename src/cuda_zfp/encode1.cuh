@@ -40,18 +40,17 @@ cudaEncode1(const uint maxbits,
            const uint dim,
            const int sx,
            const uint padded_dim,
-           const uint tot_blocks)
+           const unsigned long long int tot_blocks,
+           unsigned long long int *block_bits)
 {
 
   typedef unsigned long long int ull;
   typedef long long int ll;
-  const ull blockId = blockIdx.x +
-                      blockIdx.y * gridDim.x +
-                      gridDim.x * gridDim.y * blockIdx.z;
+  const ull blockId = grid_block_index();
 
   // each thread gets a block so the block index is 
   // the global thread index
-  const uint block_idx = blockId * blockDim.x + threadIdx.x;
+  const ull block_idx = blockId * blockDim.x + threadIdx.x;
 
   if(block_idx >= tot_blocks)
   {
@@ -84,7 +83,13 @@ cudaEncode1(const uint maxbits,
     gather1(fblock, scalars + offset, sx);
   }
 
-  zfp_encode_block<Scalar, ZFP_1D_BLOCK_SIZE>(fblock, maxbits, block_idx, stream);  
+  uint bits = zfp_encode_block<Scalar, ZFP_1D_BLOCK_SIZE>(fblock, maxbits, block_idx, stream);  
+
+  // record block size for variable-rate compaction
+  if(block_bits)
+  {
+    block_bits[block_idx] = bits;
+  }
 
 }
 //
@@ -95,7 +100,9 @@ size_t encode1launch(uint dim,
                      int sx,
                      const Scalar *d_data,
                      Word *stream,
-                     const int maxbits)
+                     const int maxbits,
+                     unsigned long long int *block_bits,
+                     cudaStream_t cuda_stream)
 {
   const int cuda_block_size = 128;
   dim3 block_size = dim3(cuda_block_size, 1, 1);
@@ -121,29 +128,30 @@ size_t encode1launch(uint dim,
   //
   size_t stream_bytes = calc_device_mem1d(zfp_pad, maxbits);
   // ensure we have zeros
-  cudaMemset(stream, 0, stream_bytes);
+  cudaMemsetAsync(stream, 0, stream_bytes, cuda_stream);
 
 #ifdef CUDA_ZFP_RATE_PRINT
   cudaEvent_t start, stop;
   cudaEventCreate(&start);
   cudaEventCreate(&stop);
 
-  cudaEventRecord(start);
+  cudaEventRecord(start, cuda_stream);
 #endif
 
-  cudaEncode1<Scalar> <<<grid_size, block_size>>>
+  cudaEncode1<Scalar> <<<grid_size, block_size, 0, cuda_stream>>>
     (maxbits,
      d_data,
      stream,
      dim,
      sx,
      zfp_pad,
-     zfp_blocks);
+     zfp_blocks,
+     block_bits);
 
 #ifdef CUDA_ZFP_RATE_PRINT
-  cudaEventRecord(stop);
+  cudaEventRecord(stop, cuda_stream);
   cudaEventSynchronize(stop);
-  cudaStreamSynchronize(0);
+  cudaStreamSynchronize(cuda_stream);
 
   float miliseconds = 0.f;
   cudaEventElapsedTime(&miliseconds, start, stop);
@@ -164,9 +172,11 @@ size_t encode1(int dim,
                int sx,
                Scalar *d_data,
                Word *stream,
-               const int maxbits)
+               const int maxbits,
+               unsigned long long int *block_bits = NULL,
+               cudaStream_t cuda_stream = 0)
 {
-  return encode1launch<Scalar>(dim, sx, d_data, stream, maxbits);
+  return encode1launch<Scalar>(dim, sx, d_data, stream, maxbits, block_bits, cuda_stream);
 }
 
 }
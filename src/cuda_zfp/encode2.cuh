@@ -50,18 +50,17 @@ cudaEncode2(const uint maxbits,
            const uint2 dims,
            const int2 stride,
            const uint2 padded_dims,
-           const uint tot_blocks)
+           const unsigned long long int tot_blocks,
+           unsigned long long int *block_bits)
 {
 
   typedef unsigned long long int ull;
   typedef long long int ll;
-  const ull blockId = blockIdx.x +
-                      blockIdx.y * gridDim.x +
-                      gridDim.x * gridDim.y * blockIdx.z;
+  const ull blockId = grid_block_index();
 
   // each thread gets a block so the block index is 
   // the global thread index
-  const uint block_idx = blockId * blockDim.x + threadIdx.x;
+  const ull block_idx = blockId * blockDim.x + threadIdx.x;
 
   if(block_idx >= tot_blocks)
   {
@@ -99,7 +98,13 @@ cudaEncode2(const uint maxbits,
     gather2(fblock, scalars + offset, stride.x, stride.y);
   }
 
-  zfp_encode_block<Scalar, ZFP_2D_BLOCK_SIZE>(fblock, maxbits, block_idx, stream);  
+  uint bits = zfp_encode_block<Scalar, ZFP_2D_BLOCK_SIZE>(fblock, maxbits, block_idx, stream);  
+
+  // record block size for variable-rate compaction
+  if(block_bits)
+  {
+    block_bits[block_idx] = bits;
+  }
 
 }
 
@@ -111,7 +116,9 @@ size_t encode2launch(uint2 dims,
                      int2 stride,
                      const Scalar *d_data,
                      Word *stream,
-                     const int maxbits)
+                     const int maxbits,
+                     unsigned long long int *block_bits,
+                     cudaStream_t cuda_stream)
 {
   const int cuda_block_size = 128;
   dim3 block_size = dim3(cuda_block_size, 1, 1);
@@ -120,7 +127,7 @@ size_t encode2launch(uint2 dims,
   if(zfp_pad.x % 4 != 0) zfp_pad.x += 4 - dims.x % 4;
   if(zfp_pad.y % 4 != 0) zfp_pad.y += 4 - dims.y % 4;
 
-  const uint zfp_blocks = (zfp_pad.x * zfp_pad.y) / 16; 
+  const size_t zfp_blocks = ((size_t)zfp_pad.x * zfp_pad.y) / 16; 
 
   //
   // we need to ensure that we launch a multiple of the 
@@ -139,29 +146,30 @@ size_t encode2launch(uint2 dims,
   //
   size_t stream_bytes = calc_device_mem2d(zfp_pad, maxbits);
   // ensure we have zeros
-  cudaMemset(stream, 0, stream_bytes);
+  cudaMemsetAsync(stream, 0, stream_bytes, cuda_stream);
 
 #ifdef CUDA_ZFP_RATE_PRINT
   cudaEvent_t start, stop;
   cudaEventCreate(&start);
   cudaEventCreate(&stop);
-  cudaEventRecord(start);
+  cudaEventRecord(start, cuda_stream);
 #endif
 
-  cudaEncode2<Scalar> <<<grid_size, block_size>>>
+  cudaEncode2<Scalar> <<<grid_size, block_size, 0, cuda_stream>>>
     (maxbits,
      d_data,
      stream,
      dims,
      stride,
      zfp_pad,
-     zfp_blocks);
+     zfp_blocks,
+     block_bits);
 
 #ifdef CUDA_ZFP_RATE_PRINT
   cudaDeviceSynchronize();
-  cudaEventRecord(stop);
+  cudaEventRecord(stop, cuda_stream);
   cudaEventSynchronize(stop);
-  cudaStreamSynchronize(0);
+  cudaStreamSynchronize(cuda_stream);
 
   float miliseconds = 0.f;
   cudaEventElapsedTime(&miliseconds, start, stop);
@@ -179,9 +187,11 @@ size_t encode2(uint2 dims,
                int2 stride,
                Scalar *d_data,
                Word *stream,
-               const int maxbits)
+               const int maxbits,
+               unsigned long long int *block_bits = NULL,
+               cudaStream_t cuda_stream = 0)
 {
-  return encode2launch<Scalar>(dims, stride, d_data, stream, maxbits);
+  return encode2launch<Scalar>(dims, stride, d_data, stream, maxbits, block_bits, cuda_stream);
 }
 
 }
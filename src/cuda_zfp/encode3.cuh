@@ -55,18 +55,17 @@ cudaEncode(const uint maxbits,
            const uint3 dims,
            const int3 stride,
            const uint3 padded_dims,
-           const uint tot_blocks)
+           const unsigned long long int tot_blocks,
+           unsigned long long int *block_bits)
 {
 
   typedef unsigned long long int ull;
   typedef long long int ll;
-  const ull blockId = blockIdx.x +
-                      blockIdx.y * gridDim.x +
-                      gridDim.x * gridDim.y * blockIdx.z;
+  const ull blockId = grid_block_index();
 
   // each thread gets a block so the block index is 
   // the global thread index
-  const uint block_idx = blockId * blockDim.x + threadIdx.x;
+  const ull block_idx = blockId * blockDim.x + threadIdx.x;
 
   if(block_idx >= tot_blocks)
   {
@@ -84,7 +83,7 @@ cudaEncode(const uint maxbits,
   uint3 block;
   block.x = (block_idx % block_dims.x) * 4; 
   block.y = ((block_idx/ block_dims.x) % block_dims.y) * 4; 
-  block.z = (block_idx/ (block_dims.x * block_dims.y)) * 4; 
+  block.z = (block_idx/ ((ull)block_dims.x * block_dims.y)) * 4; 
 
   // default strides
   ll offset = (ll)block.x * stride.x + (ll)block.y * stride.y + (ll)block.z * stride.z; 
@@ -107,8 +106,192 @@ cudaEncode(const uint maxbits,
   {
     gather3(fblock, scalars + offset, stride.x, stride.y, stride.z);
   }
-  zfp_encode_block<Scalar, ZFP_3D_BLOCK_SIZE>(fblock, maxbits, block_idx, stream);  
+  uint bits = zfp_encode_block<Scalar, ZFP_3D_BLOCK_SIZE>(fblock, maxbits, block_idx, stream);  
 
+  // record block size for variable-rate compaction
+  if(block_bits)
+  {
+    block_bits[block_idx] = bits;
+  }
+
+}
+
+//
+// Variant of cudaEncode in which the thread block cooperatively loads its
+// zfp blocks into shared memory, with consecutive threads reading consecutive
+// scalars along x, before each thread encodes its own block from shared memory
+//
+template<class Scalar>
+__global__
+void 
+cudaEncodeStaged(const uint maxbits,
+                 const Scalar* scalars,
+                 Word *stream,
+                 const uint3 dims,
+                 const int3 stride,
+                 const uint3 padded_dims,
+                 const unsigned long long int tot_blocks,
+                 unsigned long long int *block_bits)
+{
+  typedef unsigned long long int ull;
+  typedef long long int ll;
+  __shared__ Scalar tile[ZFP_3D_STAGED_BLOCKS * ZFP_3D_STAGED_STRIDE];
+  __shared__ ll tile_offset[ZFP_3D_STAGED_BLOCKS];
+  __shared__ uint3 tile_extent[ZFP_3D_STAGED_BLOCKS];
+
+  const ull blockId = grid_block_index();
+  const ull first_block = blockId * blockDim.x;
+  const ull block_idx = first_block + threadIdx.x;
+  // number of real zfp blocks handled by this thread block
+  const uint blocks = first_block >= tot_blocks ? 0 : MIN(blockDim.x, tot_blocks - first_block);
+
+  // locate this thread's zfp block and its extent within the field
+  if(threadIdx.x < blocks)
+  {
+    uint3 block_dims;
+    block_dims.x = padded_dims.x >> 2; 
+    block_dims.y = padded_dims.y >> 2; 
+    block_dims.z = padded_dims.z >> 2; 
+    uint3 block;
+    block.x = (block_idx % block_dims.x) * 4; 
+    block.y = ((block_idx/ block_dims.x) % block_dims.y) * 4; 
+    block.z = (block_idx/ ((ull)block_dims.x * block_dims.y)) * 4; 
+    tile_offset[threadIdx.x] = (ll)block.x * stride.x + (ll)block.y * stride.y + (ll)block.z * stride.z;
+    tile_extent[threadIdx.x] = make_uint3(MIN(dims.x - block.x, 4u),
+                                          MIN(dims.y - block.y, 4u),
+                                          MIN(dims.z - block.z, 4u));
+  }
+  __syncthreads();
+
+  // cooperatively load one row of four scalars per zfp block at a time so
+  // that adjacent threads access adjacent scalars
+  for(uint yz = 0; yz < 16; yz++)
+  {
+    const uint y = yz & 3u;
+    const uint z = yz >> 2;
+    for(uint i = threadIdx.x; i < 4 * blocks; i += blockDim.x)
+    {
+      const uint b = i >> 2;
+      const uint x = i & 3u;
+      const uint3 n = tile_extent[b];
+      if(x < n.x && y < n.y && z < n.z)
+        tile[b * ZFP_3D_STAGED_STRIDE + 16 * z + 4 * y + x] =
+          scalars[tile_offset[b] + (ll)x * stride.x + (ll)y * stride.y + (ll)z * stride.z];
+    }
+  }
+  __syncthreads();
+
+  if(threadIdx.x >= blocks)
+  {
+    return;
+  }
+
+  const Scalar* q = tile + threadIdx.x * ZFP_3D_STAGED_STRIDE;
+  const uint3 n = tile_extent[threadIdx.x];
+  Scalar fblock[ZFP_3D_BLOCK_SIZE]; 
+  if(n.x < 4 || n.y < 4 || n.z < 4)
+  {
+    gather_partial3(fblock, q, n.x, n.y, n.z, 1, 4, 16);
+  }
+  else
+  {
+    for(int i = 0; i < ZFP_3D_BLOCK_SIZE; i++)
+      fblock[i] = q[i];
+  }
+  uint bits = zfp_encode_block<Scalar, ZFP_3D_BLOCK_SIZE>(fblock, maxbits, block_idx, stream);  
+
+  // record block size for variable-rate compaction
+  if(block_bits)
+  {
+    block_bits[block_idx] = bits;
+  }
+}
+
+//
+// Variant of cudaEncode in which the lanes of a warp cooperatively encode one
+// zfp block from shared memory, which spreads the coefficients of 64-bit
+// blocks across the warp's registers
+//
+template<class Scalar>
+__global__
+void 
+cudaEncodeWarp(const uint maxbits,
+               const Scalar* scalars,
+               Word *stream,
+               const uint3 dims,
+               const int3 stride,
+               const uint3 padded_dims,
+               const unsigned long long int tot_blocks,
+               unsigned long long int *block_bits)
+{
+  typedef unsigned long long int ull;
+  typedef long long int ll;
+  typedef typename zfp_traits<Scalar>::Int Int;
+  __shared__ Scalar s_fblock[ZFP_WARP_BLOCKS][ZFP_3D_BLOCK_SIZE];
+  __shared__ Int s_iblock[ZFP_WARP_BLOCKS][ZFP_3D_BLOCK_SIZE];
+
+  const ull blockId = grid_block_index();
+
+  // each warp gets a block
+  const uint warp = threadIdx.x / ZFP_WARP_SIZE;
+  const uint lane = threadIdx.x % ZFP_WARP_SIZE;
+  const ull block_idx = blockId * ZFP_WARP_BLOCKS + warp;
+
+  if(block_idx >= tot_blocks)
+  {
+    return;
+  }
+
+  uint3 block_dims;
+  block_dims.x = padded_dims.x >> 2; 
+  block_dims.y = padded_dims.y >> 2; 
+  block_dims.z = padded_dims.z >> 2; 
+
+  // logical pos in 3d array
+  uint3 block;
+  block.x = (block_idx % block_dims.x) * 4; 
+  block.y = ((block_idx/ block_dims.x) % block_dims.y) * 4; 
+  block.z = (block_idx/ ((ull)block_dims.x * block_dims.y)) * 4; 
+
+  // default strides
+  ll offset = (ll)block.x * stride.x + (ll)block.y * stride.y + (ll)block.z * stride.z; 
+  Scalar* fblock = s_fblock[warp];
+
+  bool partial = false;
+  if(block.x + 4 > dims.x) partial = true;
+  if(block.y + 4 > dims.y) partial = true;
+  if(block.z + 4 > dims.z) partial = true;
+ 
+  if(partial) 
+  {
+    if(lane == 0)
+    {
+      const uint nx = block.x + 4 > dims.x ? dims.x - block.x : 4;
+      const uint ny = block.y + 4 > dims.y ? dims.y - block.y : 4;
+      const uint nz = block.z + 4 > dims.z ? dims.z - block.z : 4;
+      gather_partial3(fblock, scalars + offset, nx, ny, nz, stride.x, stride.y, stride.z);
+    }
+  }
+  else
+  {
+    // adjacent lanes load adjacent scalars along x
+    for(uint i = lane; i < ZFP_3D_BLOCK_SIZE; i += ZFP_WARP_SIZE)
+    {
+      const uint x = i & 3u;
+      const uint y = (i >> 2) & 3u;
+      const uint z = i >> 4;
+      fblock[i] = scalars[offset + (ll)x * stride.x + (ll)y * stride.y + (ll)z * stride.z];
+    }
+  }
+  warp_sync();
+
+  uint bits = zfp_encode_block_warp<Scalar, ZFP_3D_BLOCK_SIZE>(fblock, s_iblock[warp], lane, maxbits, block_idx, stream);  
+
+  // record block size for variable-rate compaction
+  if(block_bits && lane == 0)
+  {
+    block_bits[block_idx] = bits;
+  }
 }
 
 //
@@ -119,10 +302,19 @@ size_t encode3launch(uint3 dims,
                      int3 stride,
                      const Scalar *d_data,
                      Word *stream,
-                     const int maxbits)
+                     const int maxbits,
+                     unsigned long long int *block_bits,
+                     cudaStream_t cuda_stream)
 {
 
-  const int cuda_block_size = 128;
+  // encode 64-bit blocks with one warp per block to relieve register
+  // pressure, and otherwise stage contiguous rows through shared memory so
+  // that loads coalesce
+  const bool warp = sizeof(Scalar) == 8;
+  const bool staged = stride.x == 1;
+  const int cuda_block_size = warp ? ZFP_WARP_BLOCKS * ZFP_WARP_SIZE : staged ? ZFP_3D_STAGED_BLOCKS : 128;
+  // number of zfp blocks per cuda block
+  const int zfp_block_size = warp ? ZFP_WARP_BLOCKS : cuda_block_size;
   dim3 block_size = dim3(cuda_block_size, 1, 1);
 
   uint3 zfp_pad(dims); 
@@ -130,46 +322,68 @@ size_t encode3launch(uint3 dims,
   if(zfp_pad.y % 4 != 0) zfp_pad.y += 4 - dims.y % 4;
   if(zfp_pad.z % 4 != 0) zfp_pad.z += 4 - dims.z % 4;
 
-  const uint zfp_blocks = (zfp_pad.x * zfp_pad.y * zfp_pad.z) / 64; 
+  const size_t zfp_blocks = ((size_t)zfp_pad.x * zfp_pad.y * zfp_pad.z) / 64; 
 
   //
   // we need to ensure that we launch a multiple of the 
   // cuda block size
   //
   int block_pad = 0; 
-  if(zfp_blocks % cuda_block_size != 0)
+  if(zfp_blocks % zfp_block_size != 0)
   {
-    block_pad = cuda_block_size - zfp_blocks % cuda_block_size; 
+    block_pad = zfp_block_size - zfp_blocks % zfp_block_size; 
   }
 
   size_t total_blocks = block_pad + zfp_blocks;
 
-  dim3 grid_size = calculate_grid_size(total_blocks, cuda_block_size);
+  dim3 grid_size = calculate_grid_size(total_blocks, zfp_block_size);
 
   size_t stream_bytes = calc_device_mem3d(zfp_pad, maxbits);
   //ensure we start with 0s
-  cudaMemset(stream, 0, stream_bytes);
+  cudaMemsetAsync(stream, 0, stream_bytes, cuda_stream);
 
 #ifdef CUDA_ZFP_RATE_PRINT
   cudaEvent_t start, stop;
   cudaEventCreate(&start);
   cudaEventCreate(&stop);
-  cudaEventRecord(start);
+  cudaEventRecord(start, cuda_stream);
 #endif
 
-  cudaEncode<Scalar> <<<grid_size, block_size>>>
-    (maxbits,
-     d_data,
-     stream,
-     dims,
-     stride,
-     zfp_pad,
-     zfp_blocks);
+  if(warp)
+    cudaEncodeWarp<Scalar> <<<grid_size, block_size, 0, cuda_stream>>>
+      (maxbits,
+       d_data,
+       stream,
+       dims,
+       stride,
+       zfp_pad,
+       zfp_blocks,
+       block_bits);
+  else if(staged)
+    cudaEncodeStaged<Scalar> <<<grid_size, block_size, 0, cuda_stream>>>
+      (maxbits,
+       d_data,
+       stream,
+       dims,
+       stride,
+       zfp_pad,
+       zfp_blocks,
+       block_bits);
+  else
+    cudaEncode<Scalar> <<<grid_size, block_size, 0, cuda_stream>>>
+      (maxbits,
+       d_data,
+       stream,
+       dims,
+       stride,
+       zfp_pad,
+       zfp_blocks,
+       block_bits);
 
 #ifdef CUDA_ZFP_RATE_PRINT
-  cudaEventRecord(stop);
+  cudaEventRecord(stop, cuda_stream);
   cudaEventSynchronize(stop);
-  cudaStreamSynchronize(0);
+  cudaStreamSynchronize(cuda_stream);
 
   float miliseconds = 0;
   cudaEventElapsedTime(&miliseconds, start, stop);
@@ -192,9 +406,11 @@ size_t encode(uint3 dims,
               int3 stride,
               Scalar *d_data,
               Word *stream,
-              const int bits_per_block)
+              const int bits_per_block,
+              unsigned long long int *block_bits = NULL,
+              cudaStream_t cuda_stream = 0)
 {
-  return encode3launch<Scalar>(dims, stride, d_data, stream, bits_per_block);
+  return encode3launch<Scalar>(dims, stride, d_data, stream, bits_per_block, block_bits, cuda_stream);
 }
 
 }
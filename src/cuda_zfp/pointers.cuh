@@ -25,6 +25,46 @@ bool is_gpu_ptr(const void *ptr)
 #endif
 }
 
+// managed (unified) memory is accessed in place, but benefits from having
+// its pages migrated to the device ahead of the kernels
+bool is_managed_ptr(const void *ptr)
+{
+#if CUDART_VERSION >= 10000
+  cudaPointerAttributes atts;
+  const cudaError_t perr = cudaPointerGetAttributes(&atts, ptr);
+  cudaGetLastError();
+  return perr == cudaSuccess && atts.type == cudaMemoryTypeManaged;
+#else
+  return false;
+#endif
+}
+
+// page-locked host memory (cudaMallocHost or cudaHostRegister) spanning
+// bytes from ptr can be the source or target of asynchronous transfers
+bool is_pinned_ptr(const void *ptr, size_t bytes)
+{
+  const char *first = (const char*)ptr;
+  const char *last = first + (bytes ? bytes - 1 : 0);
+  cudaPointerAttributes atts[2];
+  const cudaError_t perr[2] = {
+    cudaPointerGetAttributes(&atts[0], first),
+    cudaPointerGetAttributes(&atts[1], last),
+  };
+  cudaGetLastError();
+  for(int i = 0; i < 2; ++i)
+  {
+#if CUDART_VERSION >= 10000
+    if(perr[i] != cudaSuccess || atts[i].type != cudaMemoryTypeHost)
+#else
+    if(perr[i] != cudaSuccess || atts[i].memoryType != cudaMemoryTypeHost)
+#endif
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
 } // namespace cuZFP
 
 #endif
@@ -19,6 +19,16 @@ typedef unsigned long long Word;
 
 #define NBMASK 0xaaaaaaaaaaaaaaaaull
 
+// number of 3D zfp blocks per thread block staged through shared memory, and
+// scalars per staged block, padded by one to avoid shared memory bank conflicts
+#define ZFP_3D_STAGED_BLOCKS 64
+#define ZFP_3D_STAGED_STRIDE 65
+
+// number of lanes that cooperatively encode or decode one zfp block, and
+// number of such warps per thread block
+#define ZFP_WARP_SIZE 32
+#define ZFP_WARP_BLOCKS 4
+
 namespace cuZFP
 {
 
@@ -61,8 +71,8 @@ size_t calc_device_mem2d(const uint2 dims,
 {
   
   const size_t vals_per_block = 16;
-  size_t total_blocks = (dims.x * dims.y) / vals_per_block; 
-  if((dims.x * dims.y) % vals_per_block != 0) total_blocks++;
+  size_t total_blocks = ((size_t)dims.x * dims.y) / vals_per_block; 
+  if(((size_t)dims.x * dims.y) % vals_per_block != 0) total_blocks++;
   const size_t bits_per_block = maxbits;
   const size_t bits_per_word = sizeof(Word) * 8;
   const size_t total_bits = bits_per_block * total_blocks;
@@ -75,7 +85,7 @@ size_t calc_device_mem3d(const uint3 encoded_dims,
                          const int bits_per_block)
 {
   const size_t vals_per_block = 64;
-  const size_t size = encoded_dims.x * encoded_dims.y * encoded_dims.z; 
+  const size_t size = (size_t)encoded_dims.x * encoded_dims.y * encoded_dims.z; 
   size_t total_blocks = size / vals_per_block; 
   const size_t bits_per_word = sizeof(Word) * 8;
   const size_t total_bits = bits_per_block * total_blocks;
@@ -83,6 +93,19 @@ size_t calc_device_mem3d(const uint3 encoded_dims,
   return alloc_size * sizeof(Word);
 }
 
+size_t calc_device_mem4d(const uint4 encoded_dims, 
+                         const int bits_per_block)
+{
+  const size_t vals_per_block = 256;
+  const size_t size = (size_t)encoded_dims.x * encoded_dims.y * encoded_dims.z * encoded_dims.w; 
+  size_t total_blocks = size / vals_per_block; 
+  const size_t bits_per_word = sizeof(Word) * 8;
+  const size_t total_bits = bits_per_block * total_blocks;
+  size_t alloc_size = total_bits / bits_per_word;
+  if(total_bits % bits_per_word != 0) alloc_size++;
+  return alloc_size * sizeof(Word);
+}
+
 dim3 get_max_grid_dims()
 {
   cudaDeviceProp prop; 
@@ -95,67 +118,131 @@ dim3 get_max_grid_dims()
   return grid_dims;
 }
 
-// size is assumed to have a pad to the nearest cuda block size
+// grid covering size zfp blocks, cuda_block_size of which per thread block
 dim3 calculate_grid_size(size_t size, size_t cuda_block_size)
 {
-  size_t grids = size / cuda_block_size; // because of pad this will be exact
+  size_t grids = (size + cuda_block_size - 1) / cuda_block_size;
   dim3 max_grid_dims = get_max_grid_dims();
-  int dims  = 1;
-  // check to see if we need to add more grids
-  if( grids > max_grid_dims.x)
-  {
-    dims = 2; 
-  }
-  if(grids > max_grid_dims.x * max_grid_dims.y)
-  {
-    dims = 3;
-  }
-
   dim3 grid_size;
   grid_size.x = 1;
   grid_size.y = 1;
   grid_size.z = 1;
- 
-  if(dims == 1)
+
+  // fill rows along x first, then add rows along y and planes along z as
+  // needed; kernels flatten the grid index in 64-bit arithmetic (see
+  // grid_block_index) and skip any surplus blocks in the last row or plane
+  if(grids <= max_grid_dims.x)
   {
-    grid_size.x = grids; 
+    grid_size.x = grids;
   }
-
-  if(dims == 2)
+  else
   {
-    float sq_r = sqrt((float)grids);
-    float intpart = 0;
-    modf(sq_r,&intpart); 
-    uint base = intpart;
-    grid_size.x = base; 
-    grid_size.y = base; 
-    // figure out how many y to add
-    uint rem = (size - base * base);
-    uint y_rows = rem / base;
-    if(rem % base != 0) y_rows ++;
-    grid_size.y += y_rows; 
+    grid_size.x = max_grid_dims.x;
+    size_t rows = (grids + grid_size.x - 1) / grid_size.x;
+    if(rows <= max_grid_dims.y)
+    {
+      grid_size.y = rows;
+    }
+    else
+    {
+      grid_size.y = max_grid_dims.y;
+      grid_size.z = (rows + grid_size.y - 1) / grid_size.y;
+    }
   }
 
-  if(dims == 3)
+  return grid_size;
+}
+
+// global index of the thread block, which may exceed 32 bits
+inline __device__
+unsigned long long int grid_block_index()
+{
+  return blockIdx.x + (unsigned long long int)gridDim.x * (blockIdx.y + (unsigned long long int)gridDim.y * blockIdx.z);
+}
+
+
+// synchronize the lanes of a warp that share a zfp block in shared memory
+inline __device__
+void warp_sync()
+{
+#if (CUDART_VERSION >= 9000)
+  __syncwarp();
+#endif
+}
+
+// bit i is set when lane i satisfies the predicate
+inline __device__
+unsigned long long int warp_ballot(int predicate)
+{
+#if (CUDART_VERSION >= 9000)
+  return __ballot_sync(0xffffffffu, predicate);
+#else
+  return __ballot(predicate);
+#endif
+}
+
+// maximum of x over all lanes of a warp
+inline __device__
+int warp_max(int x)
+{
+  for(int d = ZFP_WARP_SIZE / 2; d > 0; d >>= 1)
   {
-    float cub_r = pow((float)grids, 1.f/3.f);;
-    float intpart = 0;
-    modf(cub_r,&intpart); 
-    int base = intpart;
-    grid_size.x = base; 
-    grid_size.y = base; 
-    grid_size.z = base; 
-    // figure out how many z to add
-    uint rem = (size - base * base * base);
-    uint z_rows = rem / (base * base);
-    if(rem % (base * base) != 0) z_rows ++;
-    grid_size.z += z_rows; 
+#if (CUDART_VERSION >= 9000)
+    x = max(x, __shfl_xor_sync(0xffffffffu, x, d));
+#else
+    x = max(x, __shfl_xor(x, d));
+#endif
   }
+  return x;
+}
 
-  
-  return grid_size;
+// value of x held by lane src
+inline __device__
+uint warp_shfl(uint x, int src)
+{
+#if (CUDART_VERSION >= 9000)
+  return __shfl_sync(0xffffffffu, x, src);
+#else
+  return __shfl(x, src);
+#endif
+}
+
+// value of x held by lane - d, or own x for the first d lanes
+inline __device__
+uint warp_shfl_up(uint x, uint d)
+{
+#if (CUDART_VERSION >= 9000)
+  return __shfl_up_sync(0xffffffffu, x, d);
+#else
+  return __shfl_up(x, d);
+#endif
+}
+
+// inclusive prefix sum of x over lanes 0, ..., lane
+inline __device__
+uint warp_scan_add(uint x, uint lane)
+{
+  for(uint d = 1; d < ZFP_WARP_SIZE; d <<= 1)
+  {
+    uint y = warp_shfl_up(x, d);
+    if(lane >= d)
+      x += y;
+  }
+  return x;
 }
 
+// inclusive prefix maximum of x over lanes 0, ..., lane
+inline __device__
+uint warp_scan_max(uint x, uint lane)
+{
+  for(uint d = 1; d < ZFP_WARP_SIZE; d <<= 1)
+  {
+    uint y = warp_shfl_up(x, d);
+    if(lane >= d)
+      x = max(x, y);
+  }
+  return x;
+}
 
 // map two's complement signed integer to negabinary unsigned integer
 inline __device__ 
@@ -242,10 +329,32 @@ inv_lift(Int* p)
 }
 
 
+// compression parameters common to all blocks (see set_params)
+__constant__ uint c_minbits;
+__constant__ uint c_maxprec;
+__constant__ int c_minexp;
+
+// maximum number of bit planes to encode
+template<int BlockSize>
+__device__ inline
+int precision(int maxexp, int maxprec, int minexp)
+{
+  // 2 * (d + 1) guard bits for d-dimensional blocks
+  const int guard = BlockSize == 4 ? 4 : BlockSize == 16 ? 6 : BlockSize == 64 ? 8 : 10;
+  return MIN(maxprec, MAX(0, maxexp - minexp + guard));
+}
+
 template<int BlockSize>
 __device__ inline
 const unsigned char* get_perm();
 
+template<>
+__device__ inline
+const unsigned char* get_perm<256>()
+{
+  return perm_4;
+}
+
 template<>
 __device__ inline
 const unsigned char* get_perm<64>()
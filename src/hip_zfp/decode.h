@@ -28,7 +28,7 @@ private:
   Word *m_words;
   Word m_buffer;
   bool m_valid_block;
-  int m_block_idx;
+  unsigned long long int m_block_idx;
 
   __device__ BlockReader()
     : m_maxbits(0)
@@ -36,11 +36,11 @@ private:
   }
 
 public:
-  __device__ BlockReader(Word *b, const int &maxbits, const int &block_idx, const int &num_blocks)
+  __device__ BlockReader(Word *b, const int &maxbits, const unsigned long long int &block_idx, const unsigned long long int &num_blocks)
     :  m_maxbits(maxbits), m_valid_block(true)
   {
     if(block_idx >= num_blocks) m_valid_block = false;
-    int word_index = (block_idx * maxbits)  / (sizeof(Word) * 8); 
+    size_t word_index = ((size_t)block_idx * maxbits)  / (sizeof(Word) * 8); 
     m_words = b + word_index;
     m_buffer = *m_words;
     m_hiprrent_bit = (block_idx * maxbits) % (sizeof(Word) * 8); 
@@ -152,9 +152,94 @@ void decode_ints(BlockReader<Size> &reader, uint &max_bits, UInt *data)
 }
 
 
+// decode block of more than 64 integers, whose bit planes do not fit in a word
+template<typename Scalar, int Size, typename UInt>
+inline __device__
+void decode_many_ints(BlockReader<Size> &reader, uint &max_bits, UInt *data)
+{
+  const int intprec = get_precision<Scalar>();
+  memset(data, 0, sizeof(UInt) * Size);
+  const uint kmin = 0;
+  int bits = max_bits;
+  for (uint k = intprec, n = 0; bits && k-- > kmin;)
+  {
+    // decode first n bits of bit plane #k
+    uint m = MIN(n, bits);
+    bits -= m;
+    for (uint i = 0; i < m; i++)
+      if (reader.read_bit())
+        data[i] += (UInt)1 << k;
+    // unary run-length decode remainder of bit plane
+    for (; n < Size && bits && (bits--, reader.read_bit()); data[n] += (UInt)1 << k, n++)
+      for (; n < (Size - 1) && bits && (bits--, !reader.read_bit()); n++);
+  }
+}
+
+// decode block of at most 64 integers cooperatively by the lanes of a
+// wavefront, which all read the same bit planes but deposit only the bits of
+// their own coefficients lane, lane + ZFP_WARP_SIZE, ...
+template<typename Scalar, int Size, typename UInt>
+inline __device__
+void decode_ints_warp(BlockReader<Size> &reader, uint &max_bits, UInt *data, const uint lane)
+{
+  const int intprec = get_precision<Scalar>();
+  const uint lane_size = Size / ZFP_WARP_SIZE;
+  for (uint i = 0; i < lane_size; i++)
+    data[i] = 0;
+  uint64 x; 
+  const uint kmin = 0;
+  int bits = max_bits;
+  for (uint k = intprec, n = 0; bits && k-- > kmin;)
+  {
+    // read bit plane
+    uint m = MIN(n, bits);
+    bits -= m;
+    x = reader.read_bits(m);
+    for (; n < Size && bits && (bits--, reader.read_bit()); x += (Word) 1 << n++)
+      for (; n < (Size - 1) && bits && (bits--, !reader.read_bit()); n++);
+    
+    // deposit this lane's bits of the bit plane
+    for (uint i = 0; i < lane_size; i++)
+    {
+      data[i] += (UInt)((x >> (lane + ZFP_WARP_SIZE * i)) & 1u) << k;
+    }
+  } 
+}
+
 template<int BlockSize>
 struct inv_transform;
 
+template<>
+struct inv_transform<256>
+{
+  template<typename Int>
+  __device__ void inv_xform(Int *p)
+  {
+    uint x, y, z, w;
+    /* transform along w */
+    for (z = 0; z < 4; z++)
+      for (y = 0; y < 4; y++)
+        for (x = 0; x < 4; x++)
+          inv_lift<Int,64>(p + 1 * x + 4 * y + 16 * z);
+    /* transform along z */
+    for (y = 0; y < 4; y++)
+      for (x = 0; x < 4; x++)
+        for (w = 0; w < 4; w++)
+          inv_lift<Int,16>(p + 64 * w + 1 * x + 4 * y);
+    /* transform along y */
+    for (x = 0; x < 4; x++)
+      for (w = 0; w < 4; w++)
+        for (z = 0; z < 4; z++)
+          inv_lift<Int,4>(p + 16 * z + 64 * w + 1 * x);
+    /* transform along x */
+    for (w = 0; w < 4; w++)
+      for (z = 0; z < 4; z++)
+        for (y = 0; y < 4; y++)
+          inv_lift<Int,1>(p + 4 * y + 16 * z + 64 * w);
+  }
+
+};
+
 template<>
 struct inv_transform<64>
 {
@@ -176,6 +261,25 @@ struct inv_transform<64>
         inv_lift<Int,1>(p + 4 * y + 16 * z); 
   }
 
+  // transform shared by the lanes of a wavefront, each of which lifts one
+  // 4-vector per direction
+  template<typename Int>
+  __device__ void inv_xform_lane(Int *p, uint lane)
+  {
+    /* transform along z */
+    if(lane < 16)
+      inv_lift<Int,16>(p + lane);
+    warp_sync();
+    /* transform along y */
+    if(lane < 16)
+      inv_lift<Int,4>(p + 16 * (lane >> 2) + (lane & 3u));
+    warp_sync();
+    /* transform along x */
+    if(lane < 16)
+      inv_lift<Int,1>(p + 4 * lane);
+    warp_sync();
+  }
+
 };
 
 template<>
@@ -243,7 +347,10 @@ __device__ void zfp_decode(BlockReader<BlockSize> &reader, Scalar *fblock, uint
     
     UInt ublock[BlockSize];
 
-    decode_ints<Scalar, BlockSize, UInt>(reader, maxbits, ublock);
+    if(BlockSize > 64)
+      decode_many_ints<Scalar, BlockSize, UInt>(reader, maxbits, ublock);
+    else
+      decode_ints<Scalar, BlockSize, UInt>(reader, maxbits, ublock);
 
     Int iblock[BlockSize];
     const unsigned char *perm = get_perm<BlockSize>();
@@ -275,6 +382,64 @@ __device__ void zfp_decode(BlockReader<BlockSize> &reader, Scalar *fblock, uint
   }
 }
 
+// decode block cooperatively by the lanes of a wavefront into fblock in
+// shared memory, which the lanes have zeroed; iblock is scratch space for the
+// block's integer coefficients
+template<typename Scalar, int BlockSize>
+__device__ void zfp_decode_warp(BlockReader<BlockSize> &reader, Scalar *fblock, typename zfp_traits<Scalar>::Int *iblock, uint maxbits, const uint lane)
+{
+  typedef typename zfp_traits<Scalar>::UInt UInt;
+  typedef typename zfp_traits<Scalar>::Int Int;
+
+  uint s_cont = 1;
+  //
+  // there is no skip path for integers so just continue
+  //
+  if(!is_int<Scalar>())
+  {
+    s_cont = reader.read_bit();
+  }
+
+  if(s_cont)
+  {
+    uint ebits = get_ebits<Scalar>() + 1;
+
+    uint emax;
+    if(!is_int<Scalar>())
+    {
+      // read in the shared exponent
+      emax = reader.read_bits(ebits - 1) - get_ebias<Scalar>();
+    }
+    else
+    {
+      // no exponent bits
+      ebits = 0;
+    }
+
+	  maxbits -= ebits;
+    
+    const uint lane_size = BlockSize / ZFP_WARP_SIZE;
+    UInt ublock[lane_size];
+    decode_ints_warp<Scalar, BlockSize, UInt>(reader, maxbits, ublock, lane);
+
+    const unsigned char *perm = get_perm<BlockSize>();
+    for(uint i = 0; i < lane_size; ++i)
+    {
+		  iblock[perm[lane + ZFP_WARP_SIZE * i]] = uint2int(ublock[i]);
+    }
+    warp_sync();
+    
+    inv_transform<BlockSize> trans;
+    trans.inv_xform_lane(iblock, lane);
+
+		Scalar inv_w = dequantize<Int, Scalar>(1, emax);
+
+    for(uint i = lane; i < BlockSize; i += ZFP_WARP_SIZE)
+    {
+		  fblock[i] = inv_w * (Scalar)iblock[i];
+    }
+  }
+}
 
 }  // namespace hipZFP
 #endif
@@ -28,13 +28,14 @@ void scatter1(const Scalar* q, Scalar* p, int sx)
 
 template<class Scalar>
 __global__
+__launch_bounds__(ZFP_HIP_BLOCK_SIZE)
 void
 hipDecode1(Word *blocks,
             Scalar *out,
             const uint dim,
             const int stride,
             const uint padded_dim,
-            const uint total_blocks,
+            const unsigned long long int total_blocks,
             uint maxbits)
 {
   typedef unsigned long long int ull;
@@ -44,9 +45,7 @@ hipDecode1(Word *blocks,
 
   const int intprec = get_precision<Scalar>();
 
-  const ull blockId = blockIdx.x +
-                      blockIdx.y * gridDim.x +
-                      gridDim.x  * gridDim.y * blockIdx.z;
+  const ull blockId = grid_block_index();
 
   // each thread gets a block so the block index is 
   // the global thread index
@@ -81,9 +80,10 @@ size_t decode1launch(uint dim,
                      int stride,
                      Word *stream,
                      Scalar *d_data,
-                     uint maxbits)
+                     uint maxbits,
+                     hipStream_t hip_stream)
 {
-  const int hip_block_size = 128;
+  const int hip_block_size = ZFP_HIP_BLOCK_SIZE;
 
   uint zfp_pad(dim); 
   if(zfp_pad % 4 != 0) zfp_pad += 4 - dim % 4;
@@ -110,10 +110,10 @@ size_t decode1launch(uint dim,
   hipEventCreate(&start);
   hipEventCreate(&stop);
 
-  hipEventRecord(start);
+  hipEventRecord(start, hip_stream);
 #endif
 
-  hipDecode1<Scalar> <<< grid_size, block_size >>>
+  hipDecode1<Scalar> <<< grid_size, block_size, 0, hip_stream >>>
     (stream,
 		 d_data,
      dim,
@@ -123,9 +123,9 @@ size_t decode1launch(uint dim,
      maxbits);
 
 #ifdef HIP_ZFP_RATE_PRINT
-  hipEventRecord(stop);
+  hipEventRecord(stop, hip_stream);
   hipEventSynchronize(stop);
-	hipStreamSynchronize(0);
+	hipStreamSynchronize(hip_stream);
 
   float miliseconds = 0;
   hipEventElapsedTime(&miliseconds, start, stop);
@@ -145,9 +145,10 @@ size_t decode1(int dim,
                int stride,
                Word *stream,
                Scalar *d_data,
-               uint maxbits)
+               uint maxbits,
+               hipStream_t hip_stream = 0)
 {
-	return decode1launch<Scalar>(dim, stride, stream, d_data, maxbits);
+	return decode1launch<Scalar>(dim, stride, stream, d_data, maxbits, hip_stream);
 }
 
 } // namespace hipZFP
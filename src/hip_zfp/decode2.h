@@ -36,6 +36,7 @@ void scatter2(const Scalar* q, Scalar* p, int sx, int sy)
 
 template<class Scalar, int BlockSize>
 __global__
+__launch_bounds__(ZFP_HIP_BLOCK_SIZE)
 void
 hipDecode2(Word *blocks,
             Scalar *out,
@@ -46,15 +47,13 @@ hipDecode2(Word *blocks,
 {
   typedef unsigned long long int ull;
   typedef long long int ll;
-  const ull blockId = blockIdx.x +
-                      blockIdx.y * gridDim.x +
-                      gridDim.x * gridDim.y * blockIdx.z;
+  const ull blockId = grid_block_index();
 
   // each thread gets a block so the block index is 
   // the global thread index
   const ull block_idx = blockId * blockDim.x + threadIdx.x;
   
-  const int total_blocks = (padded_dims.x * padded_dims.y) / 16; 
+  const ull total_blocks = ((ull)padded_dims.x * padded_dims.y) / 16; 
   
   if(block_idx >= total_blocks) 
   {
@@ -99,9 +98,10 @@ size_t decode2launch(uint2 dims,
                      int2 stride,
                      Word *stream,
                      Scalar *d_data,
-                     uint maxbits)
+                     uint maxbits,
+                     hipStream_t hip_stream)
 {
-  const int hip_block_size = 128;
+  const int hip_block_size = ZFP_HIP_BLOCK_SIZE;
   dim3 block_size;
   block_size = dim3(hip_block_size, 1, 1);
   
@@ -111,7 +111,7 @@ size_t decode2launch(uint2 dims,
   if(zfp_pad.x % 4 != 0) zfp_pad.x += 4 - dims.x % 4;
   if(zfp_pad.y % 4 != 0) zfp_pad.y += 4 - dims.y % 4;
 
-  const int zfp_blocks = (zfp_pad.x * zfp_pad.y) / 16; 
+  const size_t zfp_blocks = ((size_t)zfp_pad.x * zfp_pad.y) / 16; 
 
   
   //
@@ -134,10 +134,10 @@ size_t decode2launch(uint2 dims,
   hipEvent_t start, stop;
   hipEventCreate(&start);
   hipEventCreate(&stop);
-  hipEventRecord(start);
+  hipEventRecord(start, hip_stream);
 #endif
 
-  hipDecode2<Scalar, 16> <<< grid_size, block_size >>>
+  hipDecode2<Scalar, 16> <<< grid_size, block_size, 0, hip_stream >>>
     (stream,
 		 d_data,
      dims,
@@ -146,9 +146,9 @@ size_t decode2launch(uint2 dims,
      maxbits);
 
 #ifdef HIP_ZFP_RATE_PRINT
-  hipEventRecord(stop);
+  hipEventRecord(stop, hip_stream);
   hipEventSynchronize(stop);
-	hipStreamSynchronize(0);
+	hipStreamSynchronize(hip_stream);
 
   float miliseconds = 0;
   hipEventElapsedTime(&miliseconds, start, stop);
@@ -168,9 +168,85 @@ size_t decode2(uint2 dims,
                int2 stride,
                Word *stream,
                Scalar *d_data,
-               uint maxbits)
+               uint maxbits,
+               hipStream_t hip_stream = 0)
 {
-	return decode2launch<Scalar>(dims, stride, stream, d_data, maxbits);
+	return decode2launch<Scalar>(dims, stride, stream, d_data, maxbits, hip_stream);
+}
+
+//
+// Variant of hipDecode2 that stores decoded values through a surface object,
+// e.g., one bound to the hipArray backing a 2D texture
+//
+template<class Scalar, int BlockSize>
+__global__
+__launch_bounds__(ZFP_HIP_BLOCK_SIZE)
+void
+hipDecode2Surface(Word *blocks,
+                  hipSurfaceObject_t surface,
+                  const uint2 dims,
+                  const uint2 padded_dims,
+                  uint maxbits)
+{
+  typedef unsigned long long int ull;
+  const ull blockId = grid_block_index();
+  const ull block_idx = blockId * blockDim.x + threadIdx.x;
+  const ull total_blocks = ((ull)padded_dims.x * padded_dims.y) / 16; 
+
+  if(block_idx >= total_blocks) 
+  {
+    return;
+  }
+
+  BlockReader<BlockSize> reader(blocks, maxbits, block_idx, total_blocks);
+
+  Scalar result[BlockSize];
+  memset(result, 0, sizeof(Scalar) * BlockSize);
+
+  zfp_decode(reader, result, maxbits);
+
+  // logical pos in 2d array
+  const uint block_dims_x = padded_dims.x >> 2;
+  uint2 block;
+  block.x = (block_idx % block_dims_x) * 4; 
+  block.y = (block_idx / block_dims_x) * 4; 
+  const uint nx = MIN(dims.x - block.x, 4u);
+  const uint ny = MIN(dims.y - block.y, 4u);
+
+  // surfaces are addressed in bytes along x
+  for(uint y = 0; y < ny; y++)
+    for(uint x = 0; x < nx; x++)
+      surf2Dwrite(result[4 * y + x], surface, (int)((block.x + x) * sizeof(Scalar)), (int)(block.y + y));
+}
+
+template<class Scalar>
+size_t decode2surface(uint2 dims, 
+                      Word *stream,
+                      hipSurfaceObject_t surface,
+                      uint maxbits,
+                      hipStream_t hip_stream)
+{
+  const int hip_block_size = ZFP_HIP_BLOCK_SIZE;
+  uint2 zfp_pad(dims); 
+  if(zfp_pad.x % 4 != 0) zfp_pad.x += 4 - dims.x % 4;
+  if(zfp_pad.y % 4 != 0) zfp_pad.y += 4 - dims.y % 4;
+
+  const size_t zfp_blocks = ((size_t)zfp_pad.x * zfp_pad.y) / 16; 
+  int block_pad = 0; 
+  if(zfp_blocks % hip_block_size != 0)
+  {
+    block_pad = hip_block_size - zfp_blocks % hip_block_size; 
+  }
+  dim3 grid_size = calhiplate_grid_size(block_pad + zfp_blocks, hip_block_size);
+
+  hipDecode2Surface<Scalar, 16> <<< grid_size, dim3(hip_block_size, 1, 1), 0, hip_stream >>>
+    (stream,
+     surface,
+     dims,
+     zfp_pad,
+     maxbits);
+
+  return calc_device_mem2d(zfp_pad, maxbits);
 }
 
 } // namespace hipZFP
@@ -41,6 +41,7 @@ void scatter3(const Scalar* q, Scalar* p, int sx, int sy, int sz)
 
 template<class Scalar, int BlockSize>
 __global__
+__launch_bounds__(ZFP_HIP_BLOCK_SIZE)
 void
 hipDecode3(Word *blocks,
             Scalar *out,
@@ -53,14 +54,12 @@ hipDecode3(Word *blocks,
   typedef unsigned long long int ull;
   typedef long long int ll;
 
-  const ull blockId = blockIdx.x +
-                      blockIdx.y * gridDim.x +
-                      gridDim.x * gridDim.y * blockIdx.z;
+  const ull blockId = grid_block_index();
   // each thread gets a block so the block index is 
   // the global thread index
   const ull block_idx = blockId * blockDim.x + threadIdx.x;
   
-  const int total_blocks = (padded_dims.x * padded_dims.y * padded_dims.z) / 64; 
+  const ull total_blocks = ((ull)padded_dims.x * padded_dims.y * padded_dims.z) / 64; 
   
   if(block_idx >= total_blocks) 
   {
@@ -83,7 +82,7 @@ hipDecode3(Word *blocks,
   uint3 block;
   block.x = (block_idx % block_dims.x) * 4; 
   block.y = ((block_idx/ block_dims.x) % block_dims.y) * 4; 
-  block.z = (block_idx/ (block_dims.x * block_dims.y)) * 4; 
+  block.z = (block_idx/ ((ull)block_dims.x * block_dims.y)) * 4; 
   
   // default strides
   const ll offset = (ll)block.x * stride.x + (ll)block.y * stride.y + (ll)block.z * stride.z; 
@@ -105,14 +104,89 @@ hipDecode3(Word *blocks,
     scatter3(result, out + offset, stride.x, stride.y, stride.z);
   }
 }
+//
+// Variant of hipDecode3 in which the lanes of a wavefront cooperatively decode
+// one zfp block to shared memory and then store it
+//
+template<class Scalar, int BlockSize>
+__global__
+__launch_bounds__(ZFP_WARP_SIZE)
+void
+hipDecode3Warp(Word *blocks,
+               Scalar *out,
+               const uint3 dims,
+               const int3 stride,
+               const uint3 padded_dims,
+               uint maxbits)
+{
+  typedef unsigned long long int ull;
+  typedef long long int ll;
+  typedef typename zfp_traits<Scalar>::Int Int;
+  __shared__ Scalar result[BlockSize];
+  __shared__ Int iblock[BlockSize];
+
+  const ull blockId = grid_block_index();
+  // each wavefront gets a block
+  const uint lane = threadIdx.x;
+  const ull block_idx = blockId;
+  
+  const ull total_blocks = ((ull)padded_dims.x * padded_dims.y * padded_dims.z) / 64; 
+  
+  if(block_idx >= total_blocks) 
+  {
+    return;
+  }
+
+  BlockReader<BlockSize> reader(blocks, maxbits, block_idx, total_blocks);
+ 
+  for(uint i = lane; i < BlockSize; i += ZFP_WARP_SIZE)
+    result[i] = 0;
+
+  zfp_decode_warp<Scalar,BlockSize>(reader, result, iblock, maxbits, lane);
+  warp_sync();
+
+  // logical block dims
+  uint3 block_dims;
+  block_dims.x = padded_dims.x >> 2; 
+  block_dims.y = padded_dims.y >> 2; 
+  block_dims.z = padded_dims.z >> 2; 
+  // logical pos in 3d array
+  uint3 block;
+  block.x = (block_idx % block_dims.x) * 4; 
+  block.y = ((block_idx/ block_dims.x) % block_dims.y) * 4; 
+  block.z = (block_idx/ ((ull)block_dims.x * block_dims.y)) * 4; 
+  
+  // default strides
+  const ll offset = (ll)block.x * stride.x + (ll)block.y * stride.y + (ll)block.z * stride.z; 
+  const uint nx = MIN(dims.x - block.x, 4u);
+  const uint ny = MIN(dims.y - block.y, 4u);
+  const uint nz = MIN(dims.z - block.z, 4u);
+
+  // adjacent lanes store adjacent scalars along x
+  for(uint i = lane; i < BlockSize; i += ZFP_WARP_SIZE)
+  {
+    const uint x = i & 3u;
+    const uint y = (i >> 2) & 3u;
+    const uint z = i >> 4;
+    if(x < nx && y < ny && z < nz)
+      out[offset + (ll)x * stride.x + (ll)y * stride.y + (ll)z * stride.z] = result[i];
+  }
+}
+
 template<class Scalar>
 size_t decode3launch(uint3 dims, 
                      int3 stride,
                      Word *stream,
                      Scalar *d_data,
-                     uint maxbits)
+                     uint maxbits,
+                     hipStream_t hip_stream)
 {
-  const int hip_block_size = 128;
+  // decode 64-bit blocks with one wavefront per block to relieve register
+  // pressure
+  const bool warp = sizeof(Scalar) == 8;
+  const int hip_block_size = warp ? ZFP_WARP_SIZE : ZFP_HIP_BLOCK_SIZE;
+  // number of zfp blocks per hip block
+  const int zfp_block_size = warp ? 1 : hip_block_size;
   dim3 block_size;
   block_size = dim3(hip_block_size, 1, 1);
 
@@ -123,7 +197,7 @@ size_t decode3launch(uint3 dims,
   if(zfp_pad.y % 4 != 0) zfp_pad.y += 4 - dims.y % 4;
   if(zfp_pad.z % 4 != 0) zfp_pad.z += 4 - dims.z % 4;
 
-  const int zfp_blocks = (zfp_pad.x * zfp_pad.y * zfp_pad.z) / 64; 
+  const size_t zfp_blocks = ((size_t)zfp_pad.x * zfp_pad.y * zfp_pad.z) / 64; 
 
   
   //
@@ -131,15 +205,15 @@ size_t decode3launch(uint3 dims,
   // hip block size
   //
   int block_pad = 0; 
-  if(zfp_blocks % hip_block_size != 0)
+  if(zfp_blocks % zfp_block_size != 0)
   {
-    block_pad = hip_block_size - zfp_blocks % hip_block_size; 
+    block_pad = zfp_block_size - zfp_blocks % zfp_block_size; 
   }
 
   size_t total_blocks = block_pad + zfp_blocks;
   size_t stream_bytes = calc_device_mem3d(zfp_pad, maxbits);
 
-  dim3 grid_size = calhiplate_grid_size(total_blocks, hip_block_size);
+  dim3 grid_size = calhiplate_grid_size(total_blocks, zfp_block_size);
 
 #ifdef HIP_ZFP_RATE_PRINT
   // setup some timing code
@@ -147,21 +221,30 @@ size_t decode3launch(uint3 dims,
   hipEventCreate(&start);
   hipEventCreate(&stop);
 
-  hipEventRecord(start);
+  hipEventRecord(start, hip_stream);
 #endif
 
-  hipDecode3<Scalar, 64> <<< grid_size, block_size >>>
-    (stream,
-		 d_data,
-     dims,
-     stride,
-     zfp_pad,
-     maxbits);
+  if(warp)
+    hipDecode3Warp<Scalar, 64> <<< grid_size, block_size, 0, hip_stream >>>
+      (stream,
+       d_data,
+       dims,
+       stride,
+       zfp_pad,
+       maxbits);
+  else
+    hipDecode3<Scalar, 64> <<< grid_size, block_size, 0, hip_stream >>>
+      (stream,
+       d_data,
+       dims,
+       stride,
+       zfp_pad,
+       maxbits);
 
 #ifdef HIP_ZFP_RATE_PRINT
-  hipEventRecord(stop);
+  hipEventRecord(stop, hip_stream);
   hipEventSynchronize(stop);
-	hipStreamSynchronize(0);
+	hipStreamSynchronize(hip_stream);
 
   float miliseconds = 0;
   hipEventElapsedTime(&miliseconds, start, stop);
@@ -182,9 +265,202 @@ size_t decode3(uint3 dims,
                int3 stride,
                Word  *stream,
                Scalar *d_data,
-               uint maxbits)
+               uint maxbits,
+               hipStream_t hip_stream = 0)
 {
-	return decode3launch<Scalar>(dims, stride, stream, d_data, maxbits);
+	return decode3launch<Scalar>(dims, stride, stream, d_data, maxbits, hip_stream);
+}
+
+//
+// Variant of hipDecode3 that stores decoded values through a surface object,
+// e.g., one bound to the hipArray backing a 3D texture
+//
+template<class Scalar, int BlockSize>
+__global__
+__launch_bounds__(ZFP_HIP_BLOCK_SIZE)
+void
+hipDecode3Surface(Word *blocks,
+                  hipSurfaceObject_t surface,
+                  const uint3 dims,
+                  const uint3 padded_dims,
+                  uint maxbits)
+{
+  typedef unsigned long long int ull;
+  const ull blockId = grid_block_index();
+  const ull block_idx = blockId * blockDim.x + threadIdx.x;
+  const ull total_blocks = ((ull)padded_dims.x * padded_dims.y * padded_dims.z) / 64; 
+
+  if(block_idx >= total_blocks) 
+  {
+    return;
+  }
+
+  BlockReader<BlockSize> reader(blocks, maxbits, block_idx, total_blocks);
+
+  Scalar result[BlockSize];
+  memset(result, 0, sizeof(Scalar) * BlockSize);
+
+  zfp_decode<Scalar,BlockSize>(reader, result, maxbits);
+
+  // logical pos in 3d array
+  uint3 block_dims;
+  block_dims.x = padded_dims.x >> 2; 
+  block_dims.y = padded_dims.y >> 2; 
+  uint3 block;
+  block.x = (block_idx % block_dims.x) * 4; 
+  block.y = ((block_idx/ block_dims.x) % block_dims.y) * 4; 
+  block.z = (block_idx/ ((ull)block_dims.x * block_dims.y)) * 4; 
+  const uint nx = MIN(dims.x - block.x, 4u);
+  const uint ny = MIN(dims.y - block.y, 4u);
+  const uint nz = MIN(dims.z - block.z, 4u);
+
+  // surfaces are addressed in bytes along x
+  for(uint z = 0; z < nz; z++)
+    for(uint y = 0; y < ny; y++)
+      for(uint x = 0; x < nx; x++)
+        surf3Dwrite(result[16 * z + 4 * y + x], surface, (int)((block.x + x) * sizeof(Scalar)), (int)(block.y + y), (int)(block.z + z));
+}
+
+template<class Scalar>
+size_t decode3surface(uint3 dims, 
+                      Word *stream,
+                      hipSurfaceObject_t surface,
+                      uint maxbits,
+                      hipStream_t hip_stream)
+{
+  const int hip_block_size = ZFP_HIP_BLOCK_SIZE;
+  uint3 zfp_pad(dims); 
+  if(zfp_pad.x % 4 != 0) zfp_pad.x += 4 - dims.x % 4;
+  if(zfp_pad.y % 4 != 0) zfp_pad.y += 4 - dims.y % 4;
+  if(zfp_pad.z % 4 != 0) zfp_pad.z += 4 - dims.z % 4;
+
+  const size_t zfp_blocks = ((size_t)zfp_pad.x * zfp_pad.y * zfp_pad.z) / 64; 
+  int block_pad = 0; 
+  if(zfp_blocks % hip_block_size != 0)
+  {
+    block_pad = hip_block_size - zfp_blocks % hip_block_size; 
+  }
+  dim3 grid_size = calhiplate_grid_size(block_pad + zfp_blocks, hip_block_size);
+
+  hipDecode3Surface<Scalar, 64> <<< grid_size, dim3(hip_block_size, 1, 1), 0, hip_stream >>>
+    (stream,
+     surface,
+     dims,
+     zfp_pad,
+     maxbits);
+
+  return calc_device_mem3d(zfp_pad, maxbits);
+}
+
+//
+// Variant of hipDecode3 that launches threads only for the zfp blocks listed
+// in index, e.g., those intersecting a region of interest, and stores either
+// their intersection with a box of the field, relative to the box origin, or
+// whole blocks back to back in a compact brick pool
+//
+template<class Scalar, int BlockSize>
+__global__
+__launch_bounds__(ZFP_HIP_BLOCK_SIZE)
+void
+hipDecode3Blocks(Word *blocks,
+                 Scalar *out,
+                 const uint3 dims,
+                 const int3 stride,
+                 const uint3 padded_dims,
+                 uint maxbits,
+                 const unsigned long long int *index,
+                 const unsigned long long int count,
+                 const uint3 origin,
+                 const uint3 extent,
+                 bool bricks)
+{
+  typedef unsigned long long int ull;
+  typedef long long int ll;
+  const ull blockId = grid_block_index();
+  const ull i = blockId * blockDim.x + threadIdx.x;
+  const ull total_blocks = ((ull)padded_dims.x * padded_dims.y * padded_dims.z) / 64; 
+
+  if(i >= count) 
+  {
+    return;
+  }
+
+  const ull block_idx = index[i];
+  BlockReader<BlockSize> reader(blocks, maxbits, block_idx, total_blocks);
+
+  Scalar result[BlockSize];
+  memset(result, 0, sizeof(Scalar) * BlockSize);
+
+  zfp_decode<Scalar,BlockSize>(reader, result, maxbits);
+
+  if(bricks)
+  {
+    Scalar *p = out + i * BlockSize;
+    for(int j = 0; j < BlockSize; j++)
+      p[j] = result[j];
+    return;
+  }
+
+  // logical pos in 3d array
+  uint3 block_dims;
+  block_dims.x = padded_dims.x >> 2; 
+  block_dims.y = padded_dims.y >> 2; 
+  uint3 block;
+  block.x = (block_idx % block_dims.x) * 4; 
+  block.y = ((block_idx/ block_dims.x) % block_dims.y) * 4; 
+  block.z = (block_idx/ ((ull)block_dims.x * block_dims.y)) * 4; 
+
+  // intersection of block with box, which lies within the field
+  const uint xmin = MAX(block.x, origin.x), xmax = MIN(block.x + 4, origin.x + extent.x);
+  const uint ymin = MAX(block.y, origin.y), ymax = MIN(block.y + 4, origin.y + extent.y);
+  const uint zmin = MAX(block.z, origin.z), zmax = MIN(block.z + 4, origin.z + extent.z);
+  for(uint z = zmin; z < zmax; z++)
+    for(uint y = ymin; y < ymax; y++)
+      for(uint x = xmin; x < xmax; x++)
+        out[(ll)(x - origin.x) * stride.x + (ll)(y - origin.y) * stride.y + (ll)(z - origin.z) * stride.z] =
+          result[16 * (z - block.z) + 4 * (y - block.y) + (x - block.x)];
+}
+
+template<class Scalar>
+size_t decode3blocks(uint3 dims, 
+                     int3 stride,
+                     Word *stream,
+                     Scalar *d_data,
+                     uint maxbits,
+                     const unsigned long long int *d_index,
+                     size_t count,
+                     uint3 origin,
+                     uint3 extent,
+                     bool bricks,
+                     hipStream_t hip_stream)
+{
+  const int hip_block_size = ZFP_HIP_BLOCK_SIZE;
+  uint3 zfp_pad(dims); 
+  if(zfp_pad.x % 4 != 0) zfp_pad.x += 4 - dims.x % 4;
+  if(zfp_pad.y % 4 != 0) zfp_pad.y += 4 - dims.y % 4;
+  if(zfp_pad.z % 4 != 0) zfp_pad.z += 4 - dims.z % 4;
+
+  int block_pad = 0; 
+  if(count % hip_block_size != 0)
+  {
+    block_pad = hip_block_size - count % hip_block_size; 
+  }
+  dim3 grid_size = calhiplate_grid_size(block_pad + count, hip_block_size);
+
+  hipDecode3Blocks<Scalar, 64> <<< grid_size, dim3(hip_block_size, 1, 1), 0, hip_stream >>>
+    (stream,
+     d_data,
+     dims,
+     stride,
+     zfp_pad,
+     maxbits,
+     d_index,
+     count,
+     origin,
+     extent,
+     bricks);
+
+  return calc_device_mem3d(zfp_pad, maxbits);
 }
 
 } // namespace hipZFP
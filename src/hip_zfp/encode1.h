@@ -33,6 +33,7 @@ void gather1(Scalar* q, const Scalar* p, int sx)
 
 template<class Scalar>
 __global__
+__launch_bounds__(ZFP_HIP_BLOCK_SIZE)
 void 
 hipEncode1(const uint maxbits,
            const Scalar* scalars,
@@ -40,18 +41,16 @@ hipEncode1(const uint maxbits,
            const uint dim,
            const int sx,
            const uint padded_dim,
-           const uint tot_blocks)
+           const unsigned long long int tot_blocks)
 {
 
   typedef unsigned long long int ull;
   typedef long long int ll;
-  const ull blockId = blockIdx.x +
-                      blockIdx.y * gridDim.x +
-                      gridDim.x * gridDim.y * blockIdx.z;
+  const ull blockId = grid_block_index();
 
   // each thread gets a block so the block index is 
   // the global thread index
-  const uint block_idx = blockId * blockDim.x + threadIdx.x;
+  const ull block_idx = blockId * blockDim.x + threadIdx.x;
 
   if(block_idx >= tot_blocks)
   {
@@ -95,9 +94,10 @@ size_t encode1launch(uint dim,
                      int sx,
                      const Scalar *d_data,
                      Word *stream,
-                     const int maxbits)
+                     const int maxbits,
+                     hipStream_t hip_stream)
 {
-  const int hip_block_size = 128;
+  const int hip_block_size = ZFP_HIP_BLOCK_SIZE;
   dim3 block_size = dim3(hip_block_size, 1, 1);
 
   uint zfp_pad(dim); 
@@ -121,17 +121,17 @@ size_t encode1launch(uint dim,
   //
   size_t stream_bytes = calc_device_mem1d(zfp_pad, maxbits);
   // ensure we have zeros
-  hipMemset(stream, 0, stream_bytes);
+  hipMemsetAsync(stream, 0, stream_bytes, hip_stream);
 
 #ifdef HIP_ZFP_RATE_PRINT
   hipEvent_t start, stop;
   hipEventCreate(&start);
   hipEventCreate(&stop);
 
-  hipEventRecord(start);
+  hipEventRecord(start, hip_stream);
 #endif
 
-  hipEncode1<Scalar> <<<grid_size, block_size>>>
+  hipEncode1<Scalar> <<<grid_size, block_size, 0, hip_stream>>>
     (maxbits,
      d_data,
      stream,
@@ -141,9 +141,9 @@ size_t encode1launch(uint dim,
      zfp_blocks);
 
 #ifdef HIP_ZFP_RATE_PRINT
-  hipEventRecord(stop);
+  hipEventRecord(stop, hip_stream);
   hipEventSynchronize(stop);
-  hipStreamSynchronize(0);
+  hipStreamSynchronize(hip_stream);
 
   float miliseconds = 0.f;
   hipEventElapsedTime(&miliseconds, start, stop);
@@ -164,9 +164,10 @@ size_t encode1(int dim,
                int sx,
                Scalar *d_data,
                Word *stream,
-               const int maxbits)
+               const int maxbits,
+               hipStream_t hip_stream = 0)
 {
-  return encode1launch<Scalar>(dim, sx, d_data, stream, maxbits);
+  return encode1launch<Scalar>(dim, sx, d_data, stream, maxbits, hip_stream);
 }
 
 }
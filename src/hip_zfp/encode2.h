@@ -43,6 +43,7 @@ void gather2(Scalar* q, const Scalar* p, int sx, int sy)
 
 template<class Scalar>
 __global__
+__launch_bounds__(ZFP_HIP_BLOCK_SIZE)
 void 
 hipEncode2(const uint maxbits,
            const Scalar* scalars,
@@ -50,18 +51,16 @@ hipEncode2(const uint maxbits,
            const uint2 dims,
            const int2 stride,
            const uint2 padded_dims,
-           const uint tot_blocks)
+           const unsigned long long int tot_blocks)
 {
 
   typedef unsigned long long int ull;
   typedef long long int ll;
-  const ull blockId = blockIdx.x +
-                      blockIdx.y * gridDim.x +
-                      gridDim.x * gridDim.y * blockIdx.z;
+  const ull blockId = grid_block_index();
 
   // each thread gets a block so the block index is 
   // the global thread index
-  const uint block_idx = blockId * blockDim.x + threadIdx.x;
+  const ull block_idx = blockId * blockDim.x + threadIdx.x;
 
   if(block_idx >= tot_blocks)
   {
@@ -111,16 +110,17 @@ size_t encode2launch(uint2 dims,
                      int2 stride,
                      const Scalar *d_data,
                      Word *stream,
-                     const int maxbits)
+                     const int maxbits,
+                     hipStream_t hip_stream)
 {
-  const int hip_block_size = 128;
+  const int hip_block_size = ZFP_HIP_BLOCK_SIZE;
   dim3 block_size = dim3(hip_block_size, 1, 1);
 
   uint2 zfp_pad(dims); 
   if(zfp_pad.x % 4 != 0) zfp_pad.x += 4 - dims.x % 4;
   if(zfp_pad.y % 4 != 0) zfp_pad.y += 4 - dims.y % 4;
 
-  const uint zfp_blocks = (zfp_pad.x * zfp_pad.y) / 16; 
+  const size_t zfp_blocks = ((size_t)zfp_pad.x * zfp_pad.y) / 16; 
 
   //
   // we need to ensure that we launch a multiple of the 
@@ -139,16 +139,16 @@ size_t encode2launch(uint2 dims,
   //
   size_t stream_bytes = calc_device_mem2d(zfp_pad, maxbits);
   // ensure we have zeros
-  hipMemset(stream, 0, stream_bytes);
+  hipMemsetAsync(stream, 0, stream_bytes, hip_stream);
 
 #ifdef HIP_ZFP_RATE_PRINT
   hipEvent_t start, stop;
   hipEventCreate(&start);
   hipEventCreate(&stop);
-  hipEventRecord(start);
+  hipEventRecord(start, hip_stream);
 #endif
 
-  hipEncode2<Scalar> <<<grid_size, block_size>>>
+  hipEncode2<Scalar> <<<grid_size, block_size, 0, hip_stream>>>
     (maxbits,
      d_data,
      stream,
@@ -159,9 +159,9 @@ size_t encode2launch(uint2 dims,
 
 #ifdef HIP_ZFP_RATE_PRINT
   hipDeviceSynchronize();
-  hipEventRecord(stop);
+  hipEventRecord(stop, hip_stream);
   hipEventSynchronize(stop);
-  hipStreamSynchronize(0);
+  hipStreamSynchronize(hip_stream);
 
   float miliseconds = 0.f;
   hipEventElapsedTime(&miliseconds, start, stop);
@@ -179,9 +179,10 @@ size_t encode2(uint2 dims,
                int2 stride,
                Scalar *d_data,
                Word *stream,
-               const int maxbits)
+               const int maxbits,
+               hipStream_t hip_stream = 0)
 {
-  return encode2launch<Scalar>(dims, stride, d_data, stream, maxbits);
+  return encode2launch<Scalar>(dims, stride, d_data, stream, maxbits, hip_stream);
 }
 
 }
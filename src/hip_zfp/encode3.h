@@ -48,6 +48,7 @@ void gather3(Scalar* q, const Scalar* p, int sx, int sy, int sz)
 
 template<class Scalar>
 __global__
+__launch_bounds__(ZFP_HIP_BLOCK_SIZE)
 void 
 hipEncode(const uint maxbits,
            const Scalar* scalars,
@@ -55,18 +56,16 @@ hipEncode(const uint maxbits,
            const uint3 dims,
            const int3 stride,
            const uint3 padded_dims,
-           const uint tot_blocks)
+           const unsigned long long int tot_blocks)
 {
 
   typedef unsigned long long int ull;
   typedef long long int ll;
-  const ull blockId = blockIdx.x +
-                      blockIdx.y * gridDim.x +
-                      gridDim.x * gridDim.y * blockIdx.z;
+  const ull blockId = grid_block_index();
 
   // each thread gets a block so the block index is 
   // the global thread index
-  const uint block_idx = blockId * blockDim.x + threadIdx.x;
+  const ull block_idx = blockId * blockDim.x + threadIdx.x;
 
   if(block_idx >= tot_blocks)
   {
@@ -84,7 +83,7 @@ hipEncode(const uint maxbits,
   uint3 block;
   block.x = (block_idx % block_dims.x) * 4; 
   block.y = ((block_idx/ block_dims.x) % block_dims.y) * 4; 
-  block.z = (block_idx/ (block_dims.x * block_dims.y)) * 4; 
+  block.z = (block_idx/ ((ull)block_dims.x * block_dims.y)) * 4; 
 
   // default strides
   ll offset = (ll)block.x * stride.x + (ll)block.y * stride.y + (ll)block.z * stride.z; 
@@ -111,6 +110,85 @@ hipEncode(const uint maxbits,
 
 }
 
+//
+// Variant of hipEncode in which the lanes of a wavefront cooperatively encode
+// one zfp block from shared memory, which spreads the coefficients of 64-bit
+// blocks across the wavefront's registers
+//
+template<class Scalar>
+__global__
+__launch_bounds__(ZFP_WARP_SIZE)
+void 
+hipEncodeWarp(const uint maxbits,
+              const Scalar* scalars,
+              Word *stream,
+              const uint3 dims,
+              const int3 stride,
+              const uint3 padded_dims,
+              const unsigned long long int tot_blocks)
+{
+  typedef unsigned long long int ull;
+  typedef long long int ll;
+  typedef typename zfp_traits<Scalar>::Int Int;
+  __shared__ Scalar fblock[ZFP_3D_BLOCK_SIZE];
+  __shared__ Int iblock[ZFP_3D_BLOCK_SIZE];
+
+  const ull blockId = grid_block_index();
+
+  // each wavefront gets a block
+  const uint lane = threadIdx.x;
+  const ull block_idx = blockId;
+
+  if(block_idx >= tot_blocks)
+  {
+    return;
+  }
+
+  uint3 block_dims;
+  block_dims.x = padded_dims.x >> 2; 
+  block_dims.y = padded_dims.y >> 2; 
+  block_dims.z = padded_dims.z >> 2; 
+
+  // logical pos in 3d array
+  uint3 block;
+  block.x = (block_idx % block_dims.x) * 4; 
+  block.y = ((block_idx/ block_dims.x) % block_dims.y) * 4; 
+  block.z = (block_idx/ ((ull)block_dims.x * block_dims.y)) * 4; 
+
+  // default strides
+  ll offset = (ll)block.x * stride.x + (ll)block.y * stride.y + (ll)block.z * stride.z; 
+
+  bool partial = false;
+  if(block.x + 4 > dims.x) partial = true;
+  if(block.y + 4 > dims.y) partial = true;
+  if(block.z + 4 > dims.z) partial = true;
+ 
+  if(partial) 
+  {
+    if(lane == 0)
+    {
+      const uint nx = block.x + 4 > dims.x ? dims.x - block.x : 4;
+      const uint ny = block.y + 4 > dims.y ? dims.y - block.y : 4;
+      const uint nz = block.z + 4 > dims.z ? dims.z - block.z : 4;
+      gather_partial3(fblock, scalars + offset, nx, ny, nz, stride.x, stride.y, stride.z);
+    }
+  }
+  else
+  {
+    // adjacent lanes load adjacent scalars along x
+    for(uint i = lane; i < ZFP_3D_BLOCK_SIZE; i += ZFP_WARP_SIZE)
+    {
+      const uint x = i & 3u;
+      const uint y = (i >> 2) & 3u;
+      const uint z = i >> 4;
+      fblock[i] = scalars[offset + (ll)x * stride.x + (ll)y * stride.y + (ll)z * stride.z];
+    }
+  }
+  warp_sync();
+
+  zfp_encode_block_warp<Scalar, ZFP_3D_BLOCK_SIZE>(fblock, iblock, lane, maxbits, block_idx, stream);  
+}
+
 //
 // Launch the encode kernel
 //
@@ -119,10 +197,16 @@ size_t encode3launch(uint3 dims,
                      int3 stride,
                      const Scalar *d_data,
                      Word *stream,
-                     const int maxbits)
+                     const int maxbits,
+                     hipStream_t hip_stream)
 {
 
-  const int hip_block_size = 128;
+  // encode 64-bit blocks with one wavefront per block to relieve register
+  // pressure
+  const bool warp = sizeof(Scalar) == 8;
+  const int hip_block_size = warp ? ZFP_WARP_SIZE : ZFP_HIP_BLOCK_SIZE;
+  // number of zfp blocks per hip block
+  const int zfp_block_size = warp ? 1 : hip_block_size;
   dim3 block_size = dim3(hip_block_size, 1, 1);
 
   uint3 zfp_pad(dims); 
@@ -130,46 +214,56 @@ size_t encode3launch(uint3 dims,
   if(zfp_pad.y % 4 != 0) zfp_pad.y += 4 - dims.y % 4;
   if(zfp_pad.z % 4 != 0) zfp_pad.z += 4 - dims.z % 4;
 
-  const uint zfp_blocks = (zfp_pad.x * zfp_pad.y * zfp_pad.z) / 64; 
+  const size_t zfp_blocks = ((size_t)zfp_pad.x * zfp_pad.y * zfp_pad.z) / 64; 
 
   //
   // we need to ensure that we launch a multiple of the 
   // hip block size
   //
   int block_pad = 0; 
-  if(zfp_blocks % hip_block_size != 0)
+  if(zfp_blocks % zfp_block_size != 0)
   {
-    block_pad = hip_block_size - zfp_blocks % hip_block_size; 
+    block_pad = zfp_block_size - zfp_blocks % zfp_block_size; 
   }
 
   size_t total_blocks = block_pad + zfp_blocks;
 
-  dim3 grid_size = calhiplate_grid_size(total_blocks, hip_block_size);
+  dim3 grid_size = calhiplate_grid_size(total_blocks, zfp_block_size);
 
   size_t stream_bytes = calc_device_mem3d(zfp_pad, maxbits);
   //ensure we start with 0s
-  hipMemset(stream, 0, stream_bytes);
+  hipMemsetAsync(stream, 0, stream_bytes, hip_stream);
 
 #ifdef HIP_ZFP_RATE_PRINT
   hipEvent_t start, stop;
   hipEventCreate(&start);
   hipEventCreate(&stop);
-  hipEventRecord(start);
+  hipEventRecord(start, hip_stream);
 #endif
 
-  hipEncode<Scalar> <<<grid_size, block_size>>>
-    (maxbits,
-     d_data,
-     stream,
-     dims,
-     stride,
-     zfp_pad,
-     zfp_blocks);
+  if(warp)
+    hipEncodeWarp<Scalar> <<<grid_size, block_size, 0, hip_stream>>>
+      (maxbits,
+       d_data,
+       stream,
+       dims,
+       stride,
+       zfp_pad,
+       zfp_blocks);
+  else
+    hipEncode<Scalar> <<<grid_size, block_size, 0, hip_stream>>>
+      (maxbits,
+       d_data,
+       stream,
+       dims,
+       stride,
+       zfp_pad,
+       zfp_blocks);
 
 #ifdef HIP_ZFP_RATE_PRINT
-  hipEventRecord(stop);
+  hipEventRecord(stop, hip_stream);
   hipEventSynchronize(stop);
-  hipStreamSynchronize(0);
+  hipStreamSynchronize(hip_stream);
 
   float miliseconds = 0;
   hipEventElapsedTime(&miliseconds, start, stop);
@@ -192,9 +286,10 @@ size_t encode(uint3 dims,
               int3 stride,
               Scalar *d_data,
               Word *stream,
-              const int bits_per_block)
+              const int bits_per_block,
+              hipStream_t hip_stream = 0)
 {
-  return encode3launch<Scalar>(dims, stride, d_data, stream, bits_per_block);
+  return encode3launch<Scalar>(dims, stride, d_data, stream, bits_per_block, hip_stream);
 }
 
 }
@@ -7,16 +7,20 @@
 #include "encode1.h"
 #include "encode2.h"
 #include "encode3.h"
+#include "encode4.h"
 
 #include "decode1.h"
 #include "decode2.h"
 #include "decode3.h"
+#include "decode4.h"
 
 #include "ErrorCheck.h"
 
 #include "pointers.h"
+#include "trace.h"
 #include "type_info.h"
 #include <iostream>
+#include <vector>
 #include <assert.h>
 
 // we need to know about bitstream, but we don't 
@@ -29,7 +33,31 @@
 namespace internal 
 { 
   
-bool is_contigous3d(const uint dims[3], const int3 &stride, long long int &offset)
+bool is_contigous4d(const uint dims[4], const int4 &stride, long long int &offset)
+{
+  typedef long long int int64;
+  int64 idims[4];
+  idims[0] = dims[0];
+  idims[1] = dims[1];
+  idims[2] = dims[2];
+  idims[3] = dims[3];
+
+  int64 imin = std::min(stride.x,0) * (idims[0] - 1) + 
+               std::min(stride.y,0) * (idims[1] - 1) + 
+               std::min(stride.z,0) * (idims[2] - 1) + 
+               std::min(stride.w,0) * (idims[3] - 1);
+
+  int64 imax = std::max(stride.x,0) * (idims[0] - 1) + 
+               std::max(stride.y,0) * (idims[1] - 1) + 
+               std::max(stride.z,0) * (idims[2] - 1) + 
+               std::max(stride.w,0) * (idims[3] - 1);
+  offset = imin;
+  int64 ns = idims[0] * idims[1] * idims[2] * idims[3];
+
+  return (imax - imin + 1 == ns);
+}
+
+bool is_contigous3d(const uint dims[4], const int4 &stride, long long int &offset)
 {
   typedef long long int int64;
   int64 idims[3];
@@ -50,7 +78,7 @@ bool is_contigous3d(const uint dims[3], const int3 &stride, long long int &offse
   return (imax - imin + 1 == ns);
 }
 
-bool is_contigous2d(const uint dims[3], const int3 &stride, long long int &offset)
+bool is_contigous2d(const uint dims[4], const int4 &stride, long long int &offset)
 {
   typedef long long int int64;
   int64 idims[2];
@@ -74,15 +102,20 @@ bool is_contigous1d(uint dim, const int &stride, long long int &offset)
   return std::abs(stride) == 1;
 }
 
-bool is_contigous(const uint dims[3], const int3 &stride, long long int &offset)
+bool is_contigous(const uint dims[4], const int4 &stride, long long int &offset)
 {
   int d = 0;
   
   if(dims[0] != 0) d++;
   if(dims[1] != 0) d++;
   if(dims[2] != 0) d++;
+  if(dims[3] != 0) d++;
 
-  if(d == 3)
+  if(d == 4)
+  {
+    return is_contigous4d(dims, stride, offset);
+  }
+  else if(d == 3)
   {
     return is_contigous3d(dims, stride, offset);
   }
@@ -100,12 +133,13 @@ bool is_contigous(const uint dims[3], const int3 &stride, long long int &offset)
 // encode expects device pointers
 //
 template<typename T>
-size_t encode(uint dims[3], int3 stride, int bits_per_block, T *d_data, Word *d_stream)
+size_t encode(uint dims[4], int4 stride, int bits_per_block, T *d_data, Word *d_stream, hipStream_t hip_stream)
 {
+  hipZFP::PhaseScope phase(zfp_device_kernel, hip_stream);
 
   int d = 0;
   size_t len = 1;
-  for(int i = 0; i < 3; ++i)
+  for(int i = 0; i < 4; ++i)
   {
     if(dims[i] != 0)
     {
@@ -120,7 +154,7 @@ size_t encode(uint dims[3], int3 stride, int bits_per_block, T *d_data, Word *d_
   {
     int dim = dims[0];
     int sx = stride.x;
-    stream_size = hipZFP::encode1<T>(dim, sx, d_data, d_stream, bits_per_block); 
+    stream_size = hipZFP::encode1<T>(dim, sx, d_data, d_stream, bits_per_block, hip_stream); 
   }
   else if(d == 2)
   {
@@ -128,7 +162,7 @@ size_t encode(uint dims[3], int3 stride, int bits_per_block, T *d_data, Word *d_
     int2 s;
     s.x = stride.x; 
     s.y = stride.y; 
-    stream_size = hipZFP::encode2<T>(ndims, s, d_data, d_stream, bits_per_block); 
+    stream_size = hipZFP::encode2<T>(ndims, s, d_data, d_stream, bits_per_block, hip_stream); 
   }
   else if(d == 3)
   {
@@ -137,7 +171,13 @@ size_t encode(uint dims[3], int3 stride, int bits_per_block, T *d_data, Word *d_
     s.y = stride.y; 
     s.z = stride.z; 
     uint3 ndims = make_uint3(dims[0], dims[1], dims[2]);
-    stream_size = hipZFP::encode<T>(ndims, s, d_data, d_stream, bits_per_block); 
+    stream_size = hipZFP::encode<T>(ndims, s, d_data, d_stream, bits_per_block, hip_stream); 
+  }
+  else if(d == 4)
+  {
+    int4 s = stride;
+    uint4 ndims = make_uint4(dims[0], dims[1], dims[2], dims[3]);
+    stream_size = hipZFP::encode4<T>(ndims, s, d_data, d_stream, bits_per_block, hip_stream); 
   }
 
   errors.chk("Encode");
@@ -146,13 +186,14 @@ size_t encode(uint dims[3], int3 stride, int bits_per_block, T *d_data, Word *d_
 }
 
 template<typename T>
-size_t decode(uint ndims[3], int3 stride, int bits_per_block, Word *stream, T *out)
+size_t decode(uint ndims[4], int4 stride, int bits_per_block, Word *stream, T *out, hipStream_t hip_stream)
 {
+  hipZFP::PhaseScope phase(zfp_device_kernel, hip_stream);
 
   int d = 0;
   size_t out_size = 1;
   size_t stream_bytes = 0;
-  for(int i = 0; i < 3; ++i)
+  for(int i = 0; i < 4; ++i)
   {
     if(ndims[i] != 0)
     {
@@ -170,14 +211,14 @@ size_t decode(uint ndims[3], int3 stride, int bits_per_block, Word *stream, T *o
     s.y = stride.y; 
     s.z = stride.z; 
 
-    stream_bytes = hipZFP::decode3<T>(dims, s, stream, out, bits_per_block); 
+    stream_bytes = hipZFP::decode3<T>(dims, s, stream, out, bits_per_block, hip_stream); 
   }
   else if(d == 1)
   {
     uint dim = ndims[0];
     int sx = stride.x;
 
-    stream_bytes = hipZFP::decode1<T>(dim, sx, stream, out, bits_per_block); 
+    stream_bytes = hipZFP::decode1<T>(dim, sx, stream, out, bits_per_block, hip_stream); 
 
   }
   else if(d == 2)
@@ -190,13 +231,28 @@ size_t decode(uint ndims[3], int3 stride, int bits_per_block, Word *stream, T *o
     s.x = stride.x; 
     s.y = stride.y; 
 
-    stream_bytes = hipZFP::decode2<T>(dims, s, stream, out, bits_per_block); 
+    stream_bytes = hipZFP::decode2<T>(dims, s, stream, out, bits_per_block, hip_stream); 
+  }
+  else if(d == 4)
+  {
+    uint4 dims = make_uint4(ndims[0], ndims[1], ndims[2], ndims[3]);
+    int4 s = stride;
+
+    stream_bytes = hipZFP::decode4<T>(dims, s, stream, out, bits_per_block, hip_stream); 
   }
   else std::cerr<<" d ==  "<<d<<" not implemented\n";
  
   return stream_bytes;
 }
 
+//
+// HIP stream on which all work for this zfp stream is queued
+//
+hipStream_t get_stream(const zfp_stream *stream)
+{
+  return (hipStream_t) stream->exec.params.hip.stream;
+}
+
 Word *setup_device_stream_compress(zfp_stream *stream,const zfp_field *field)
 {
   bool stream_device = hipZFP::is_gpu_ptr(stream->stream->begin);
@@ -209,7 +265,10 @@ Word *setup_device_stream_compress(zfp_stream *stream,const zfp_field *field)
 
   Word *d_stream = NULL;
   size_t max_size = zfp_stream_maximum_size(stream, field);
-  hipMalloc(&d_stream, max_size);
+  {
+    hipZFP::PhaseScope phase(zfp_device_alloc, get_stream(stream));
+    hipMalloc(&d_stream, max_size);
+  }
   return d_stream;
 }
 
@@ -226,8 +285,12 @@ Word *setup_device_stream_decompress(zfp_stream *stream,const zfp_field *field)
   Word *d_stream = NULL;
   //TODO: change maximum_size to compressed stream size
   size_t size = zfp_stream_maximum_size(stream, field);
-  hipMalloc(&d_stream, size);
-  hipMemcpy(d_stream, stream->stream->begin, size, hipMemcpyHostToDevice);
+  {
+    hipZFP::PhaseScope phase(zfp_device_alloc, get_stream(stream));
+    hipMalloc(&d_stream, size);
+  }
+  hipZFP::PhaseScope phase(zfp_device_h2d, get_stream(stream));
+  hipMemcpyAsync(d_stream, stream->stream->begin, size, hipMemcpyHostToDevice, get_stream(stream));
   return d_stream;
 }
 
@@ -257,7 +320,7 @@ void * offset_void(zfp_type type, void *ptr, long long int offset)
   return offset_ptr;
 }
 
-void *setup_device_field_compress(const zfp_field *field, const int3 &stride, long long int &offset)
+void *setup_device_field_compress(const zfp_stream *stream, const zfp_field *field, const int4 &stride, long long int &offset)
 {
   bool field_device = hipZFP::is_gpu_ptr(field->data);
 
@@ -267,15 +330,16 @@ void *setup_device_field_compress(const zfp_field *field, const int3 &stride, lo
     return field->data;
   }
   
-  uint dims[3];
+  uint dims[4];
   dims[0] = field->nx;
   dims[1] = field->ny;
   dims[2] = field->nz;
+  dims[3] = field->nw;
 
   size_t type_size = zfp_type_size(field->type);
 
   size_t field_size = 1;
-  for(int i = 0; i < 3; ++i)
+  for(int i = 0; i < 4; ++i)
   {
     if(dims[i] != 0)
     {
@@ -291,14 +355,18 @@ void *setup_device_field_compress(const zfp_field *field, const int3 &stride, lo
   if(contig)
   {
     size_t field_bytes = type_size * field_size;
-    hipMalloc(&d_data, field_bytes);
+    {
+      hipZFP::PhaseScope phase(zfp_device_alloc, get_stream(stream));
+      hipMalloc(&d_data, field_bytes);
+    }
 
-    hipMemcpy(d_data, host_ptr, field_bytes, hipMemcpyHostToDevice);
+    hipZFP::PhaseScope phase(zfp_device_h2d, get_stream(stream));
+    hipMemcpyAsync(d_data, host_ptr, field_bytes, hipMemcpyHostToDevice, get_stream(stream));
   }
   return offset_void(field->type, d_data, -offset);
 }
 
-void *setup_device_field_decompress(const zfp_field *field, const int3 &stride, long long int &offset)
+void *setup_device_field_decompress(const zfp_field *field, const int4 &stride, long long int &offset)
 {
   bool field_device = hipZFP::is_gpu_ptr(field->data);
 
@@ -308,15 +376,16 @@ void *setup_device_field_decompress(const zfp_field *field, const int3 &stride,
     return field->data;
   }
 
-  uint dims[3];
+  uint dims[4];
   dims[0] = field->nx;
   dims[1] = field->ny;
   dims[2] = field->nz;
+  dims[3] = field->nw;
 
   size_t type_size = zfp_type_size(field->type);
 
   size_t field_size = 1;
-  for(int i = 0; i < 3; ++i)
+  for(int i = 0; i < 4; ++i)
   {
     if(dims[i] != 0)
     {
@@ -330,12 +399,13 @@ void *setup_device_field_decompress(const zfp_field *field, const int3 &stride,
   if(contig)
   {
     size_t field_bytes = type_size * field_size;
+    hipZFP::PhaseScope phase(zfp_device_alloc, 0);
     hipMalloc(&d_data, field_bytes);
   }
   return offset_void(field->type, d_data, -offset);
 }
 
-void cleanup_device_ptr(void *orig_ptr, void *d_ptr, size_t bytes, long long int offset, zfp_type type)
+void cleanup_device_ptr(const zfp_stream *stream, void *orig_ptr, void *d_ptr, size_t bytes, long long int offset, zfp_type type)
 {
   bool device = hipZFP::is_gpu_ptr(orig_ptr);
   if(device)
@@ -346,64 +416,82 @@ void cleanup_device_ptr(void *orig_ptr, void *d_ptr, size_t bytes, long long int
   void *d_offset_ptr = offset_void(type, d_ptr, offset);
   void *h_offset_ptr = offset_void(type, orig_ptr, offset);
 
+  hipStream_t hip_stream = get_stream(stream);
   if(bytes > 0)
   {
-    hipMemcpy(h_offset_ptr, d_offset_ptr, bytes, hipMemcpyDeviceToHost);
+    hipZFP::PhaseScope phase(zfp_device_d2h, hip_stream);
+    hipMemcpyAsync(h_offset_ptr, d_offset_ptr, bytes, hipMemcpyDeviceToHost, hip_stream);
   }
 
+  // staging buffers must outlive any work still queued on the stream
+  hipStreamSynchronize(hip_stream);
+
+  hipZFP::PhaseScope phase(zfp_device_free, hip_stream);
   hipFree(d_offset_ptr);
 }
 
-} // namespace internal
-
+//
+// compress without waiting for the device; work involving host memory
+// still synchronizes on the stream internally
+//
 size_t
-hip_compress(zfp_stream *stream, const zfp_field *field)
+compress(zfp_stream *stream, const zfp_field *field)
 {
-  uint dims[3];
+  uint dims[4];
   dims[0] = field->nx;
   dims[1] = field->ny;
   dims[2] = field->nz;
+  dims[3] = field->nw;
 
-  int3 stride;  
+  int4 stride;  
   stride.x = field->sx ? field->sx : 1;
   stride.y = field->sy ? field->sy : field->nx;
   stride.z = field->sz ? field->sz : field->nx * field->ny;
+  stride.w = field->sw ? field->sw : field->nx * field->ny * field->nz;
   
   size_t stream_bytes = 0;
   long long int offset = 0; 
-  void *d_data = internal::setup_device_field_compress(field, stride, offset);
+  hipZFP::trace_begin("zfp:H2D");
+  void *d_data = internal::setup_device_field_compress(stream, field, stride, offset);
 
   if(d_data == NULL)
   {
     // null means the array is non-contiguous host mem which is not supported
+    hipZFP::trace_end();
     return 0;
   }
 
   Word *d_stream = internal::setup_device_stream_compress(stream, field);
+  hipStream_t hip_stream = internal::get_stream(stream);
+  hipZFP::trace_end();
 
+  hipZFP::trace_begin("zfp:encode");
   if(field->type == zfp_type_float)
   {
     float* data = (float*) d_data;
-    stream_bytes = internal::encode<float>(dims, stride, (int)stream->maxbits, data, d_stream);
+    stream_bytes = internal::encode<float>(dims, stride, (int)stream->maxbits, data, d_stream, hip_stream);
   }
   else if(field->type == zfp_type_double)
   {
     double* data = (double*) d_data;
-    stream_bytes = internal::encode<double>(dims, stride, (int)stream->maxbits, data, d_stream);
+    stream_bytes = internal::encode<double>(dims, stride, (int)stream->maxbits, data, d_stream, hip_stream);
   }
   else if(field->type == zfp_type_int32)
   {
     int * data = (int*) d_data;
-    stream_bytes = internal::encode<int>(dims, stride, (int)stream->maxbits, data, d_stream);
+    stream_bytes = internal::encode<int>(dims, stride, (int)stream->maxbits, data, d_stream, hip_stream);
   }
   else if(field->type == zfp_type_int64)
   {
     long long int * data = (long long int*) d_data;
-    stream_bytes = internal::encode<long long int>(dims, stride, (int)stream->maxbits, data, d_stream);
+    stream_bytes = internal::encode<long long int>(dims, stride, (int)stream->maxbits, data, d_stream, hip_stream);
   }
+  hipZFP::trace_end();
 
-  internal::cleanup_device_ptr(stream->stream->begin, d_stream, stream_bytes, 0, field->type);
-  internal::cleanup_device_ptr(field->data, d_data, 0, offset, field->type);
+  hipZFP::trace_begin("zfp:D2H");
+  internal::cleanup_device_ptr(stream, stream->stream->begin, d_stream, stream_bytes, 0, field->type);
+  internal::cleanup_device_ptr(stream, field->data, d_data, 0, offset, field->type);
+  hipZFP::trace_end();
 
   // zfp wants to flush the stream.
   // set bits to wsize because we already did that.
@@ -414,66 +502,74 @@ hip_compress(zfp_stream *stream, const zfp_field *field)
 
   return stream_bytes;
 }
-  
-void 
-hip_decompress(zfp_stream *stream, zfp_field *field)
+
+void
+decompress(zfp_stream *stream, zfp_field *field)
 {
-  uint dims[3];
+  uint dims[4];
   dims[0] = field->nx;
   dims[1] = field->ny;
   dims[2] = field->nz;
+  dims[3] = field->nw;
    
-  int3 stride;  
+  int4 stride;  
   stride.x = field->sx ? field->sx : 1;
   stride.y = field->sy ? field->sy : field->nx;
   stride.z = field->sz ? field->sz : field->nx * field->ny;
+  stride.w = field->sw ? field->sw : field->nx * field->ny * field->nz;
 
   size_t decoded_bytes = 0;
   long long int offset = 0;
+  hipZFP::trace_begin("zfp:H2D");
   void *d_data = internal::setup_device_field_decompress(field, stride, offset);
   
   if(d_data == NULL)
   {
     // null means the array is non-contiguous host mem which is not supported
+    hipZFP::trace_end();
     return;
   }
 
   Word *d_stream = internal::setup_device_stream_decompress(stream, field);
+  hipStream_t hip_stream = internal::get_stream(stream);
+  hipZFP::trace_end();
 
+  hipZFP::trace_begin("zfp:decode");
   if(field->type == zfp_type_float)
   {
     float *data = (float*) d_data;
-    decoded_bytes = internal::decode(dims, stride, (int)stream->maxbits, d_stream, data);
+    decoded_bytes = internal::decode(dims, stride, (int)stream->maxbits, d_stream, data, hip_stream);
     d_data = (void*) data;
   }
   else if(field->type == zfp_type_double)
   {
     double *data = (double*) d_data;
-    decoded_bytes = internal::decode(dims, stride, (int)stream->maxbits, d_stream, data);
+    decoded_bytes = internal::decode(dims, stride, (int)stream->maxbits, d_stream, data, hip_stream);
     d_data = (void*) data;
   }
   else if(field->type == zfp_type_int32)
   {
     int *data = (int*) d_data;
-    decoded_bytes = internal::decode(dims, stride, (int)stream->maxbits, d_stream, data);
+    decoded_bytes = internal::decode(dims, stride, (int)stream->maxbits, d_stream, data, hip_stream);
     d_data = (void*) data;
   }
   else if(field->type == zfp_type_int64)
   {
     long long int *data = (long long int*) d_data;
-    decoded_bytes = internal::decode(dims, stride, (int)stream->maxbits, d_stream, data);
+    decoded_bytes = internal::decode(dims, stride, (int)stream->maxbits, d_stream, data, hip_stream);
     d_data = (void*) data;
   }
   else
   {
     std::cerr<<"Cannot decompress: type unknown\n";
   }
+  hipZFP::trace_end();
 
    
   size_t type_size = zfp_type_size(field->type);
 
   size_t field_size = 1;
-  for(int i = 0; i < 3; ++i)
+  for(int i = 0; i < 4; ++i)
   {
     if(dims[i] != 0)
     {
@@ -482,8 +578,10 @@ hip_decompress(zfp_stream *stream, zfp_field *field)
   }
   
   size_t bytes = type_size * field_size;
-  internal::cleanup_device_ptr(stream->stream->begin, d_stream, 0, 0, field->type);
-  internal::cleanup_device_ptr(field->data, d_data, bytes, offset, field->type);
+  hipZFP::trace_begin("zfp:D2H");
+  internal::cleanup_device_ptr(stream, stream->stream->begin, d_stream, 0, 0, field->type);
+  internal::cleanup_device_ptr(stream, field->data, d_data, bytes, offset, field->type);
+  hipZFP::trace_end();
   
   // this is how zfp determins if this was a success
   size_t words_read = decoded_bytes / sizeof(Word);
@@ -491,3 +589,181 @@ hip_decompress(zfp_stream *stream, zfp_field *field)
   // set stream pointer to end of stream
   stream->stream->ptr = stream->stream->begin + words_read;
 }
+
+//
+// decode a fixed-rate 2D or 3D field straight into a surface object,
+// typically bound to a hipArray for texture sampling; the field supplies
+// only type and dimensions
+//
+template<typename T>
+size_t decode_surface(const uint dims[4], int bits_per_block, Word *stream, hipSurfaceObject_t surface, hipStream_t hip_stream)
+{
+  if(dims[2] != 0)
+    return hipZFP::decode3surface<T>(make_uint3(dims[0], dims[1], dims[2]), stream, surface, bits_per_block, hip_stream);
+  return hipZFP::decode2surface<T>(make_uint2(dims[0], dims[1]), stream, surface, bits_per_block, hip_stream);
+}
+
+void
+decompress_surface(zfp_stream *stream, const zfp_field *field, hipSurfaceObject_t surface)
+{
+  uint dims[4];
+  dims[0] = field->nx;
+  dims[1] = field->ny;
+  dims[2] = field->nz;
+  dims[3] = field->nw;
+
+  hipZFP::trace_begin("zfp:H2D");
+  Word *d_stream = internal::setup_device_stream_decompress(stream, field);
+  hipStream_t hip_stream = internal::get_stream(stream);
+  hipZFP::trace_end();
+
+  size_t decoded_bytes = 0;
+  hipZFP::trace_begin("zfp:decode");
+  if(field->type == zfp_type_float)
+    decoded_bytes = decode_surface<float>(dims, (int)stream->maxbits, d_stream, surface, hip_stream);
+  else if(field->type == zfp_type_int32)
+    decoded_bytes = decode_surface<int>(dims, (int)stream->maxbits, d_stream, surface, hip_stream);
+  hipZFP::trace_end();
+
+  internal::cleanup_device_ptr(stream, stream->stream->begin, d_stream, 0, 0, field->type);
+
+  size_t words_read = decoded_bytes / sizeof(Word);
+  stream->stream->bits = wsize;
+  stream->stream->ptr = stream->stream->begin + words_read;
+}
+
+//
+// decode only the listed blocks of a fixed-rate 3D field, e.g., those
+// intersecting a region of interest, into a device-resident box of the
+// field with origin and extent given by box or, if bricks is not null, into
+// a device-resident pool of consecutive 4x4x4 bricks; returns false,
+// leaving the stream untouched, when the blocks cannot be decoded on the
+// device
+//
+template<typename T>
+size_t decode_blocks(const uint dims[4], const int4 &stride, int bits_per_block, Word *stream, void *out, const unsigned long long int *d_index, size_t count, const size_t box[6], bool bricks, hipStream_t hip_stream)
+{
+  return hipZFP::decode3blocks<T>(make_uint3(dims[0], dims[1], dims[2]), make_int3(stride.x, stride.y, stride.z), stream, (T*)out, bits_per_block, d_index, count,
+                                  make_uint3((uint)box[0], (uint)box[1], (uint)box[2]), make_uint3((uint)box[3], (uint)box[4], (uint)box[5]), bricks, hip_stream);
+}
+
+bool
+decompress_blocks(zfp_stream *stream, zfp_field *field, const size_t *index, size_t count, const size_t box[6], void *bricks)
+{
+  uint dims[4];
+  dims[0] = field->nx;
+  dims[1] = field->ny;
+  dims[2] = field->nz;
+  dims[3] = field->nw;
+
+  int4 stride;  
+  stride.x = field->sx ? field->sx : 1;
+  stride.y = field->sy ? field->sy : (int)box[3];
+  stride.z = field->sz ? field->sz : (int)(box[3] * box[4]);
+  stride.w = 0;
+
+  // output is written in place, so it must be accessible to the device;
+  // blocks are located by position, which requires fixed-rate mode
+  void *out = bricks ? bricks : field->data;
+  if(!dims[2] || dims[3] || !count || !hipZFP::is_gpu_ptr(out) || stream->minbits != stream->maxbits)
+  {
+    return false;
+  }
+
+  typedef unsigned long long int ull;
+  hipStream_t hip_stream = get_stream(stream);
+
+  hipZFP::trace_begin("zfp:H2D");
+  ull *d_index = NULL;
+  if(hipMalloc(&d_index, count * sizeof(ull)) != hipSuccess)
+  {
+    hipZFP::trace_end();
+    return false;
+  }
+  const std::vector<ull> h_index(index, index + count);
+  hipMemcpyAsync(d_index, &h_index[0], count * sizeof(ull), hipMemcpyHostToDevice, hip_stream);
+  Word *d_stream = internal::setup_device_stream_decompress(stream, field);
+  hipZFP::trace_end();
+
+  size_t decoded_bytes = 0;
+  hipZFP::trace_begin("zfp:decode");
+  if(field->type == zfp_type_float)
+    decoded_bytes = decode_blocks<float>(dims, stride, (int)stream->maxbits, d_stream, out, d_index, count, box, bricks != NULL, hip_stream);
+  else if(field->type == zfp_type_double)
+    decoded_bytes = decode_blocks<double>(dims, stride, (int)stream->maxbits, d_stream, out, d_index, count, box, bricks != NULL, hip_stream);
+  else if(field->type == zfp_type_int32)
+    decoded_bytes = decode_blocks<int>(dims, stride, (int)stream->maxbits, d_stream, out, d_index, count, box, bricks != NULL, hip_stream);
+  else if(field->type == zfp_type_int64)
+    decoded_bytes = decode_blocks<long long int>(dims, stride, (int)stream->maxbits, d_stream, out, d_index, count, box, bricks != NULL, hip_stream);
+  hipZFP::trace_end();
+
+  internal::cleanup_device_ptr(stream, stream->stream->begin, d_stream, 0, 0, field->type);
+  hipStreamSynchronize(hip_stream);
+  hipFree(d_index);
+
+  // the stream is positioned past the whole field
+  size_t words_read = decoded_bytes / sizeof(Word);
+  stream->stream->bits = wsize;
+  stream->stream->ptr = stream->stream->begin + words_read;
+
+  return true;
+}
+
+} // namespace internal
+
+//
+// synchronous calls time each zfp_device_phase when gathering statistics
+//
+size_t
+hip_compress(zfp_stream *stream, const zfp_field *field)
+{
+  hipZFP::PhaseTiming timing(stream->stats);
+  size_t stream_bytes = internal::compress(stream, field);
+  hipStreamSynchronize(internal::get_stream(stream));
+  return stream_bytes;
+}
+
+void
+hip_decompress(zfp_stream *stream, zfp_field *field)
+{
+  hipZFP::PhaseTiming timing(stream->stats);
+  internal::decompress(stream, field);
+  hipStreamSynchronize(internal::get_stream(stream));
+}
+
+size_t
+hip_compress_async(zfp_stream *stream, const zfp_field *field)
+{
+  return internal::compress(stream, field);
+}
+
+void
+hip_decompress_async(zfp_stream *stream, zfp_field *field)
+{
+  internal::decompress(stream, field);
+}
+
+void
+hip_decompress_surface(zfp_stream *stream, const zfp_field *field, unsigned long long surface)
+{
+  internal::decompress_surface(stream, field, (hipSurfaceObject_t)(uintptr_t)surface);
+  hipStreamSynchronize(internal::get_stream(stream));
+}
+
+zfp_bool
+hip_decompress_blocks(zfp_stream *stream, zfp_field *field, const size_t *index, size_t count, const size_t *box, void *bricks)
+{
+  return internal::decompress_blocks(stream, field, index, count, box, bricks) ? zfp_true : zfp_false;
+}
+
+zfp_bool
+hip_synchronize(zfp_stream *stream)
+{
+  return hipStreamSynchronize(internal::get_stream(stream)) == hipSuccess ? zfp_true : zfp_false;
+}
+
+zfp_bool
+hip_query(const zfp_stream *stream)
+{
+  return hipStreamQuery(internal::get_stream(stream)) == hipSuccess ? zfp_true : zfp_false;
+}
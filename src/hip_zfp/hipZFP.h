@@ -8,6 +8,12 @@ extern "C" {
 #endif
   size_t hip_compress(zfp_stream *stream, const zfp_field *field);
   void hip_decompress(zfp_stream *stream, zfp_field *field);
+  size_t hip_compress_async(zfp_stream *stream, const zfp_field *field);
+  void hip_decompress_async(zfp_stream *stream, zfp_field *field);
+  void hip_decompress_surface(zfp_stream *stream, const zfp_field *field, unsigned long long surface);
+  zfp_bool hip_decompress_blocks(zfp_stream *stream, zfp_field *field, const size_t *index, size_t count, const size_t *box, void *bricks);
+  zfp_bool hip_synchronize(zfp_stream *stream);
+  zfp_bool hip_query(const zfp_stream *stream);
 #ifdef __cplusplus
 }
 #endif
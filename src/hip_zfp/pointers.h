@@ -7,7 +7,9 @@
 
 namespace hipZFP
 {
-// https://gitlab.kitware.com/third-party/nvpipe/blob/master/encode.c
+// device and managed memory are accessed in place by the kernels; the
+// pointer attribute was renamed in ROCm 6, and earlier versions flag
+// managed memory separately
 bool is_gpu_ptr(const void *ptr)
 {
   hipPointerAttribute_t atts;
@@ -15,13 +17,16 @@ bool is_gpu_ptr(const void *ptr)
 
   // clear last error so other error checking does
   // not pick it up
-  hipError_t error = hipGetLastError();
-#if HIPRT_VERSION >= 10000
-  return perr == hipSuccess &&
-                (atts.type == hipMemoryTypeDevice ||
-                 atts.type == hipMemoryTypeManaged);
+  hipGetLastError();
+  if(perr != hipSuccess)
+  {
+    return false;
+  }
+#if HIP_VERSION_MAJOR >= 6
+  return atts.type == hipMemoryTypeDevice ||
+         atts.type == hipMemoryTypeManaged;
 #else
-  return perr == hipSuccess && atts.memoryType == hipMemoryTypeDevice;
+  return atts.memoryType == hipMemoryTypeDevice || atts.isManaged;
 #endif
 }
 
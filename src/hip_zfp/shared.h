@@ -19,6 +19,18 @@ typedef unsigned long long Word;
 
 #define NBMASK 0xaaaaaaaaaaaaaaaaull
 
+// number of lanes that cooperatively encode or decode one zfp block, which
+// is one wavefront per thread block
+#define ZFP_WARP_SIZE 64
+
+// threads per thread block for kernels that assign one zfp block per thread;
+// a multiple of the wavefront size that is also passed to __launch_bounds__,
+// since the compiler otherwise budgets registers for 1024-thread workgroups
+// and spills the larger (3D and 4D) blocks to scratch
+#ifndef ZFP_HIP_BLOCK_SIZE
+  #define ZFP_HIP_BLOCK_SIZE 256
+#endif
+
 namespace hipZFP
 {
 
@@ -61,8 +73,8 @@ size_t calc_device_mem2d(const uint2 dims,
 {
   
   const size_t vals_per_block = 16;
-  size_t total_blocks = (dims.x * dims.y) / vals_per_block; 
-  if((dims.x * dims.y) % vals_per_block != 0) total_blocks++;
+  size_t total_blocks = ((size_t)dims.x * dims.y) / vals_per_block; 
+  if(((size_t)dims.x * dims.y) % vals_per_block != 0) total_blocks++;
   const size_t bits_per_block = maxbits;
   const size_t bits_per_word = sizeof(Word) * 8;
   const size_t total_bits = bits_per_block * total_blocks;
@@ -75,7 +87,7 @@ size_t calc_device_mem3d(const uint3 encoded_dims,
                          const int bits_per_block)
 {
   const size_t vals_per_block = 64;
-  const size_t size = encoded_dims.x * encoded_dims.y * encoded_dims.z; 
+  const size_t size = (size_t)encoded_dims.x * encoded_dims.y * encoded_dims.z; 
   size_t total_blocks = size / vals_per_block; 
   const size_t bits_per_word = sizeof(Word) * 8;
   const size_t total_bits = bits_per_block * total_blocks;
@@ -83,80 +95,143 @@ size_t calc_device_mem3d(const uint3 encoded_dims,
   return alloc_size * sizeof(Word);
 }
 
+size_t calc_device_mem4d(const uint4 encoded_dims, 
+                         const int bits_per_block)
+{
+  const size_t vals_per_block = 256;
+  const size_t size = (size_t)encoded_dims.x * encoded_dims.y * encoded_dims.z * encoded_dims.w; 
+  size_t total_blocks = size / vals_per_block; 
+  const size_t bits_per_word = sizeof(Word) * 8;
+  const size_t total_bits = bits_per_block * total_blocks;
+  size_t alloc_size = total_bits / bits_per_word;
+  if(total_bits % bits_per_word != 0) alloc_size++;
+  return alloc_size * sizeof(Word);
+}
+
+// grid limits of the current device; individual attributes are queried
+// since hipGetDeviceProperties is too slow to call on every launch
 dim3 get_max_grid_dims()
 {
-  hipDeviceProp_t prop; 
   int device = 0;
-  hipGetDeviceProperties(&prop, device);
+  hipGetDevice(&device);
+  int x = 0, y = 0, z = 0;
+  hipDeviceGetAttribute(&x, hipDeviceAttributeMaxGridDimX, device);
+  hipDeviceGetAttribute(&y, hipDeviceAttributeMaxGridDimY, device);
+  hipDeviceGetAttribute(&z, hipDeviceAttributeMaxGridDimZ, device);
   dim3 grid_dims;
-  grid_dims.x = prop.maxGridSize[0];
-  grid_dims.y = prop.maxGridSize[1];
-  grid_dims.z = prop.maxGridSize[2];
+  grid_dims.x = x;
+  grid_dims.y = y;
+  grid_dims.z = z;
   return grid_dims;
 }
 
-// size is assumed to have a pad to the nearest hip block size
+// grid covering size zfp blocks, hip_block_size of which per thread block
 dim3 calhiplate_grid_size(size_t size, size_t hip_block_size)
 {
-  size_t grids = size / hip_block_size; // because of pad this will be exact
+  size_t grids = (size + hip_block_size - 1) / hip_block_size;
   dim3 max_grid_dims = get_max_grid_dims();
-  int dims  = 1;
-  // check to see if we need to add more grids
-  if( grids > max_grid_dims.x)
-  {
-    dims = 2; 
-  }
-  // avoiding overflow in HIP
-  if(grids > (unsigned long long)max_grid_dims.x * max_grid_dims.y)
-  {
-    dims = 3;
-  }
-
   dim3 grid_size;
   grid_size.x = 1;
   grid_size.y = 1;
   grid_size.z = 1;
- 
-  if(dims == 1)
+
+  // fill rows along x first, then add rows along y and planes along z as
+  // needed; kernels flatten the grid index in 64-bit arithmetic (see
+  // grid_block_index) and skip any surplus blocks in the last row or plane
+  if(grids <= max_grid_dims.x)
   {
-    grid_size.x = grids; 
+    grid_size.x = grids;
   }
-
-  if(dims == 2)
+  else
   {
-    float sq_r = sqrt((float)grids);
-    float intpart = 0.;
-    modf(sq_r,&intpart); 
-    uint base = intpart;
-    grid_size.x = base; 
-    grid_size.y = base; 
-    // figure out how many y to add
-    uint rem = (size - base * base);
-    uint y_rows = rem / base;
-    if(rem % base != 0) y_rows ++;
-    grid_size.y += y_rows; 
+    grid_size.x = max_grid_dims.x;
+    size_t rows = (grids + grid_size.x - 1) / grid_size.x;
+    if(rows <= max_grid_dims.y)
+    {
+      grid_size.y = rows;
+    }
+    else
+    {
+      grid_size.y = max_grid_dims.y;
+      grid_size.z = (rows + grid_size.y - 1) / grid_size.y;
+    }
   }
 
-  if(dims == 3)
+  return grid_size;
+}
+
+// global index of the thread block, which may exceed 32 bits
+inline __device__
+unsigned long long int grid_block_index()
+{
+  return blockIdx.x + (unsigned long long int)gridDim.x * (blockIdx.y + (unsigned long long int)gridDim.y * blockIdx.z);
+}
+
+
+// synchronize the lanes of a wavefront that share a zfp block in shared memory
+inline __device__
+void warp_sync()
+{
+  __syncthreads();
+}
+
+// bit i is set when lane i satisfies the predicate
+inline __device__
+unsigned long long int warp_ballot(int predicate)
+{
+  return __ballot(predicate);
+}
+
+// maximum of x over all lanes of a wavefront
+inline __device__
+int warp_max(int x)
+{
+  for(int d = ZFP_WARP_SIZE / 2; d > 0; d >>= 1)
   {
-    float hipb_r = pow((float)grids, 1.f/3.f);;
-    float intpart = 0.;
-    modf(hipb_r,&intpart); 
-    int base = intpart;
-    grid_size.x = base; 
-    grid_size.y = base; 
-    grid_size.z = base; 
-    // figure out how many z to add
-    uint rem = (size - base * base * base);
-    uint z_rows = rem / (base * base);
-    if(rem % (base * base) != 0) z_rows ++;
-    grid_size.z += z_rows; 
+    x = max(x, __shfl_xor(x, d));
   }
+  return x;
+}
 
-  
-  return grid_size;
+// value of x held by lane src
+inline __device__
+uint warp_shfl(uint x, int src)
+{
+  return __shfl(x, src);
 }
 
+// value of x held by lane - d, or own x for the first d lanes
+inline __device__
+uint warp_shfl_up(uint x, uint d)
+{
+  return __shfl_up(x, d);
+}
+
+// inclusive prefix sum of x over lanes 0, ..., lane
+inline __device__
+uint warp_scan_add(uint x, uint lane)
+{
+  for(uint d = 1; d < ZFP_WARP_SIZE; d <<= 1)
+  {
+    uint y = warp_shfl_up(x, d);
+    if(lane >= d)
+      x += y;
+  }
+  return x;
+}
+
+// inclusive prefix maximum of x over lanes 0, ..., lane
+inline __device__
+uint warp_scan_max(uint x, uint lane)
+{
+  for(uint d = 1; d < ZFP_WARP_SIZE; d <<= 1)
+  {
+    uint y = warp_shfl_up(x, d);
+    if(lane >= d)
+      x = max(x, y);
+  }
+  return x;
+}
 
 // map two's complement signed integer to negabinary unsigned integer
 inline __device__ 
@@ -247,6 +322,13 @@ template<int BlockSize>
 __device__ inline
 const unsigned char* get_perm();
 
+template<>
+__device__ inline
+const unsigned char* get_perm<256>()
+{
+  return perm_4;
+}
+
 template<>
 __device__ inline
 const unsigned char* get_perm<64>()
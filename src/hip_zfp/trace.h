@@ -0,0 +1,202 @@
+#ifndef HIPZFP_TRACE_H
+#define HIPZFP_TRACE_H
+
+#include "zfp.h"
+#include <chrono>
+#include <vector>
+#ifdef ZFP_WITH_TRACING
+#include <roctracer/roctx.h>
+#endif
+
+namespace hipZFP
+{
+
+// open roctx range so that rocprof attributes host and device activity to
+// the current zfp phase; ranges nest and are no-ops unless built with
+// ZFP_WITH_TRACING; the range is also reported to host trace hooks
+inline void trace_begin(const char *name)
+{
+#ifdef ZFP_WITH_TRACING
+  roctxRangePushA(name);
+  zfp_trace_begin(name);
+#else
+  (void)name;
+#endif
+}
+
+// close innermost roctx range and host trace range
+inline void trace_end()
+{
+#ifdef ZFP_WITH_TRACING
+  zfp_trace_end();
+  roctxRangePop();
+#endif
+}
+
+// roctx range spanning the lifetime of this object
+class TraceRange
+{
+public:
+  explicit TraceRange(const char *name) { trace_begin(name); }
+  ~TraceRange() { trace_end(); }
+private:
+  TraceRange(const TraceRange &);
+  TraceRange &operator=(const TraceRange &);
+};
+
+// accumulates the time spent in each zfp_device_phase into stream stats;
+// work queued on the device is timed with events recorded on its stream,
+// while allocation and deallocation, which block the host, use the host
+// clock; elapsed times are collected once the stream has drained
+class PhaseTimer
+{
+public:
+  explicit PhaseTimer(zfp_stream_stats *stats) : stats(stats) {}
+  ~PhaseTimer() { finish(); }
+
+  // start timing phase on stream; returns token to pass to stop()
+  size_t start(zfp_device_phase phase, hipStream_t stream)
+  {
+    Interval interval;
+    interval.phase = phase;
+    interval.stream = stream;
+    interval.begin = interval.end = 0;
+    interval.host = phase == zfp_device_alloc || phase == zfp_device_free;
+    if(interval.host)
+    {
+      interval.clock = std::chrono::steady_clock::now();
+    }
+    else if(hipEventCreate(&interval.begin) == hipSuccess &&
+            hipEventCreate(&interval.end) == hipSuccess)
+    {
+      hipEventRecord(interval.begin, stream);
+    }
+    intervals.push_back(interval);
+    return intervals.size() - 1;
+  }
+
+  // stop timing interval returned by start()
+  void stop(size_t token)
+  {
+    Interval &interval = intervals[token];
+    if(interval.host)
+    {
+      std::chrono::duration<double> t = std::chrono::steady_clock::now() - interval.clock;
+      stats->device_time[interval.phase] += t.count();
+    }
+    else if(interval.end)
+    {
+      hipEventRecord(interval.end, interval.stream);
+    }
+  }
+
+  // wait for timed work to complete and add its elapsed times to stats
+  void finish()
+  {
+    for(size_t i = 0; i < intervals.size(); i++)
+    {
+      Interval &interval = intervals[i];
+      if(interval.host)
+      {
+        continue;
+      }
+      float ms = 0;
+      if(interval.end && hipEventSynchronize(interval.end) == hipSuccess &&
+         hipEventElapsedTime(&ms, interval.begin, interval.end) == hipSuccess)
+      {
+        stats->device_time[interval.phase] += 1e-3 * ms;
+      }
+      if(interval.begin)
+      {
+        hipEventDestroy(interval.begin);
+      }
+      if(interval.end)
+      {
+        hipEventDestroy(interval.end);
+      }
+    }
+    intervals.clear();
+    hipGetLastError();
+  }
+
+private:
+  struct Interval
+  {
+    zfp_device_phase phase;
+    hipStream_t stream;
+    bool host;
+    hipEvent_t begin;
+    hipEvent_t end;
+    std::chrono::steady_clock::time_point clock;
+  };
+
+  PhaseTimer(const PhaseTimer &);
+  PhaseTimer &operator=(const PhaseTimer &);
+
+  zfp_stream_stats *stats;
+  std::vector<Interval> intervals;
+};
+
+// timer of the (de)compression call in progress on this thread, if any
+inline PhaseTimer *&phase_timer()
+{
+  static thread_local PhaseTimer *timer = NULL;
+  return timer;
+}
+
+// times the lifetime of this object as phase when a timer is installed
+class PhaseScope
+{
+public:
+  PhaseScope(zfp_device_phase phase, hipStream_t stream) : timer(phase_timer()), token(0)
+  {
+    if(timer)
+    {
+      token = timer->start(phase, stream);
+    }
+  }
+  ~PhaseScope()
+  {
+    if(timer)
+    {
+      timer->stop(token);
+    }
+  }
+private:
+  PhaseScope(const PhaseScope &);
+  PhaseScope &operator=(const PhaseScope &);
+
+  PhaseTimer *timer;
+  size_t token;
+};
+
+// installs a timer for stats, if not NULL, on this thread while in scope
+class PhaseTiming
+{
+public:
+  explicit PhaseTiming(zfp_stream_stats *stats) : timer(stats), installed(stats && !phase_timer())
+  {
+    if(installed)
+    {
+      phase_timer() = &timer;
+    }
+  }
+  ~PhaseTiming()
+  {
+    if(installed)
+    {
+      timer.finish();
+      phase_timer() = NULL;
+    }
+  }
+private:
+  PhaseTiming(const PhaseTiming &);
+  PhaseTiming &operator=(const PhaseTiming &);
+
+  PhaseTimer timer;
+  bool installed;
+};
+
+} // namespace hipZFP
+
+#endif
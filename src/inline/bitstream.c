@@ -11,7 +11,10 @@ The following assumptions and restrictions apply:
    whether for reading, writing, or both.  This buffer is associated with the
    bit stream via stream_open(buffer, bytes), which allocates and returns a
    pointer to an opaque bit stream struct.  Call stream_close(stream) to
-   deallocate this struct.
+   deallocate this struct.  Alternatively, stream_init(storage, buffer, bytes)
+   initializes the struct in caller-owned memory, e.g., a stream_storage on
+   the stack or at least stream_struct_bytes of thread-local memory, which
+   must not be passed to stream_close.
 
 2. The stream is either in a read or write state (or, initially, in both
    states).  When done writing, call stream_flush(stream) before entering
@@ -95,13 +98,39 @@ The following assumptions and restrictions apply:
    supported only at wsize granularity.  For sequential access, the largest
    possible wsize is preferred due to higher speed.
 
-7. It is up to the user to adhere to these rules.  For performance reasons,
+7. If BIT_STREAM_CALLBACK is defined, a bit stream opened via
+   stream_open_callback(buffer, bytes, write, read, context) uses the memory
+   buffer as a window onto a sequential stream of unbounded length.  When
+   writing, each time the buffer fills, its contents are passed to
+   write(context, buffer, bytes), and stream_flush(stream) also passes on
+   any words written since.  When reading, the buffer is refilled via
+   read(context, buffer, bytes), which returns the number of bytes read;
+   any bits past the end of input read as zero.  Bit offsets and sizes
+   account for all words passed through the buffer.  Only sequential
+   access is supported: stream_rewind(stream) may be called only before
+   any I/O, stream_rseek(stream, offset) and stream_skip(stream, n) may
+   only move forward, and stream_wseek(stream, offset) may not be used.
+   Callback streams cannot also be strided.
+
+8. If BIT_STREAM_BRANCHLESS is defined, stream_read_bits() and
+   stream_write_bits() treat the buffered word and the next word in memory
+   as one double-word accumulator.  Every call then performs a word refill
+   or flush unconditionally, with a select in place of a branch.  Words
+   that are not needed are diverted to a spare word in the bit stream
+   struct, so memory past the stream is never accessed.  This avoids
+   branch mispredictions in the embedded coder.  When compiled for BMI2,
+   masks and variable shifts map to the bzhi and shlx instructions.  The
+   stream layout is unchanged.  This variant requires 64-bit words and
+   cannot be combined with strided or callback streams.
+
+9. It is up to the user to adhere to these rules.  For performance reasons,
    no error checking is done, and in particular buffer overruns are not
    caught.
 */
 
 #include <limits.h>
 #include <stdlib.h>
+#include <string.h>
 
 #ifndef inline_
   #define inline_
@@ -122,26 +151,116 @@ The following assumptions and restrictions apply:
 /* number of bits in a buffered word */
 #define wsize ((uint)(CHAR_BIT * sizeof(word)))
 
+#if defined(BIT_STREAM_STRIDED) && defined(BIT_STREAM_CALLBACK)
+  #error "BIT_STREAM_STRIDED and BIT_STREAM_CALLBACK are mutually exclusive"
+#endif
+
+#ifdef BIT_STREAM_BRANCHLESS
+  #if defined(BIT_STREAM_WORD_TYPE) || defined(BIT_STREAM_STRIDED) || defined(BIT_STREAM_CALLBACK)
+    #error "BIT_STREAM_BRANCHLESS requires 64-bit words and plain bit streams"
+  #endif
+  #ifdef __BMI2__
+    #include <immintrin.h>
+  #endif
+#endif
+
 /* bit stream structure (opaque to caller) */
 struct bitstream {
   uint bits;   /* number of buffered bits (0 <= bits < wsize) */
   word buffer; /* buffer for incoming/outgoing bits (buffer < 2^bits) */
   word* ptr;   /* pointer to next word to be read/written */
   word* begin; /* beginning of stream */
-  word* end;   /* end of stream (currently unused) */
+  word* end;   /* end of stream (end of buffer for callback streams) */
 #ifdef BIT_STREAM_STRIDED
   size_t mask;     /* one less the block size in number of words */
   ptrdiff_t delta; /* number of words between consecutive blocks */
 #endif
+#ifdef BIT_STREAM_CALLBACK
+  stream_callback write; /* drains full buffer when writing (may be NULL) */
+  stream_callback read;  /* refills exhausted buffer when reading (may be NULL) */
+  void* context;         /* user data passed to callbacks */
+  word* limit;           /* end of words available for reading */
+  size_t base;           /* number of words passed through buffer */
+#endif
+#ifdef BIT_STREAM_BRANCHLESS
+  word spare;  /* target of word accesses that are not needed */
+#endif
 };
 
 /* private functions ------------------------------------------------------- */
 
+#ifdef BIT_STREAM_CALLBACK
+/* pass words written to buffer to callback and reuse buffer */
+static void
+stream_drain(bitstream* s)
+{
+  size_t words = (size_t)(s->ptr - s->begin);
+  if (words) {
+    s->write(s->context, s->begin, words * sizeof(word));
+    s->base += words;
+    s->ptr = s->begin;
+  }
+}
+
+/* refill buffer via callback; zeros are read past end of input */
+static void
+stream_fill(bitstream* s)
+{
+  size_t bytes = s->read(s->context, s->begin, sizeof(word) * (size_t)(s->end - s->begin));
+  size_t words = (bytes + sizeof(word) - 1) / sizeof(word);
+  if (!words)
+    words = 1;
+  memset((char*)s->begin + bytes, 0, words * sizeof(word) - bytes);
+  s->base += (size_t)(s->ptr - s->begin);
+  s->ptr = s->begin;
+  s->limit = s->begin + words;
+}
+
+/* position stream at given word, which must be buffered or lie ahead */
+static void
+stream_advance(bitstream* s, size_t offset)
+{
+  size_t words = s->base + (size_t)(s->ptr - s->begin);
+  if (offset < words) {
+    /* back up within buffer */
+    s->ptr -= words - offset;
+    return;
+  }
+  /* discard words, refilling buffer as needed */
+  while (words < offset) {
+    size_t n;
+    if (s->ptr == s->limit)
+      stream_fill(s);
+    n = (size_t)(s->limit - s->ptr);
+    if (n > offset - words)
+      n = offset - words;
+    s->ptr += n;
+    words += n;
+  }
+}
+#endif
+
+/* number of words read or written */
+static size_t
+stream_words(const bitstream* s)
+{
+  size_t words = (size_t)(s->ptr - s->begin);
+#ifdef BIT_STREAM_CALLBACK
+  words += s->base;
+#endif
+  return words;
+}
+
 /* read a single word from memory */
 static word
 stream_read_word(bitstream* s)
 {
-  word w = *s->ptr++;
+  word w;
+#ifdef BIT_STREAM_CALLBACK
+  if (s->read && s->ptr == s->limit)
+    stream_fill(s);
+#endif
+  w = *s->ptr++;
 #ifdef BIT_STREAM_STRIDED
   if (!((s->ptr - s->begin) & s->mask))
     s->ptr += s->delta;
@@ -158,7 +277,34 @@ stream_write_word(bitstream* s, word value)
   if (!((s->ptr - s->begin) & s->mask))
     s->ptr += s->delta;
 #endif
+#ifdef BIT_STREAM_CALLBACK
+  if (s->write && s->ptr == s->end)
+    stream_drain(s);
+#endif
+}
+
+#ifdef BIT_STREAM_BRANCHLESS
+/* low 0 <= n <= 64 bits of x */
+static uint64
+stream_low_bits(uint64 x, uint n)
+{
+#ifdef __BMI2__
+  return _bzhi_u64(x, n);
+#else
+  /* all ones when n = 64 */
+  return x & ((((uint64)1 << (n & 63u)) - 1) | (0 - (uint64)(n >> 6)));
+#endif
+}
+
+/* bits [n, n + 64) of double word (hi, lo) for 0 <= n <= 64 */
+static uint64
+stream_shift_right(uint64 hi, uint64 lo, uint n)
+{
+  /* assert: 0 <= 63 - (n & 63) < 64 */
+  uint64 x = (lo >> (n & 63u)) | ((hi << 1) << (63u - (n & 63u)));
+  return n & 64u ? hi : x;
 }
+#endif
 
 /* public functions -------------------------------------------------------- */
 
@@ -180,7 +326,7 @@ stream_data(const bitstream* s)
 inline_ size_t
 stream_size(const bitstream* s)
 {
-  return sizeof(word) * (size_t)(s->ptr - s->begin);
+  return sizeof(word) * stream_words(s);
 }
 
 /* byte capacity of stream */
@@ -207,7 +353,8 @@ inline_ ptrdiff_t
 stream_stride_delta(const bitstream* s)
 {
 #ifdef BIT_STREAM_STRIDED
-  return s->delta / (s->mask + 1);
+  /* block size is zero when stream is not strided */
+  return s->mask + 1 ? s->delta / (ptrdiff_t)(s->mask + 1) : 0;
 #else
   unused_(s);
   return 0;
@@ -242,6 +389,44 @@ stream_write_bit(bitstream* s, uint bit)
   return bit;
 }
 
+#ifdef BIT_STREAM_BRANCHLESS
+/* read 0 <= n <= 64 bits */
+inline_ uint64
+stream_read_bits(bitstream* s, uint n)
+{
+  /* fetch next word if buffered bits do not suffice, else spare word */
+  uint refill = s->bits < n;
+  const word* p = refill ? s->ptr : &s->spare;
+  word w = *p & (0 - (word)refill);
+  /* append fetched word to buffered bits to form double word (hi, lo) */
+  uint64 lo = s->buffer + (w << s->bits);
+  uint64 hi = stream_shift_right(0, w, wsize - s->bits);
+  s->ptr += refill;
+  /* assert: 0 <= s->bits + refill * wsize - n < wsize */
+  s->bits += refill * wsize - n;
+  s->buffer = stream_shift_right(hi, lo, n);
+  return stream_low_bits(lo, n);
+}
+
+/* write 0 <= n <= 64 low bits of value and return remaining bits */
+inline_ uint64
+stream_write_bits(bitstream* s, uint64 value, uint n)
+{
+  /* append bit string to buffer to form double word (hi, lo) */
+  uint64 v = stream_low_bits(value, n);
+  uint64 lo = s->buffer + (v << s->bits);
+  uint64 hi = stream_shift_right(0, v, wsize - s->bits);
+  /* store low word if full, else spare word */
+  uint flush = (s->bits + n) / wsize;
+  word* p = flush ? s->ptr : &s->spare;
+  *p = lo;
+  s->ptr += flush;
+  /* assert: 0 <= s->bits + n - flush * wsize < wsize */
+  s->bits += n - flush * wsize;
+  s->buffer = flush ? hi : lo;
+  return stream_shift_right(0, value, n);
+}
+#else
 /* read 0 <= n <= 64 bits */
 inline_ uint64
 stream_read_bits(bitstream* s, uint n)
@@ -304,19 +489,20 @@ stream_write_bits(bitstream* s, uint64 value, uint n)
   /* assert: 0 <= n < 64 */
   return value >> n;
 }
+#endif
 
 /* return bit offset to next bit to be read */
 inline_ size_t
 stream_rtell(const bitstream* s)
 {
-  return wsize * (size_t)(s->ptr - s->begin) - s->bits;
+  return wsize * stream_words(s) - s->bits;
 }
 
 /* return bit offset to next bit to be written */
 inline_ size_t
 stream_wtell(const bitstream* s)
 {
-  return wsize * (size_t)(s->ptr - s->begin) + s->bits;
+  return wsize * stream_words(s) + s->bits;
 }
 
 /* position stream for reading or writing at beginning */
@@ -326,6 +512,10 @@ stream_rewind(bitstream* s)
   s->ptr = s->begin;
   s->buffer = 0;
   s->bits = 0;
+#ifdef BIT_STREAM_CALLBACK
+  s->limit = s->begin;
+  s->base = 0;
+#endif
 }
 
 /* position stream for reading at given bit offset */
@@ -333,6 +523,11 @@ inline_ void
 stream_rseek(bitstream* s, size_t offset)
 {
   uint n = offset % wsize;
+#ifdef BIT_STREAM_CALLBACK
+  if (s->read)
+    stream_advance(s, offset / wsize);
+  else
+#endif
   s->ptr = s->begin + offset / wsize;
   if (n) {
     s->buffer = stream_read_word(s) >> n;
@@ -396,6 +591,10 @@ stream_flush(bitstream* s)
   uint bits = (wsize - s->bits) % wsize;
   if (bits)
     stream_pad(s, bits);
+#ifdef BIT_STREAM_CALLBACK
+  if (s->write)
+    stream_drain(s);
+#endif
   return bits;
 }
 
@@ -428,21 +627,59 @@ stream_set_stride(bitstream* s, size_t block, ptrdiff_t delta)
 }
 #endif
 
+/* initialize bit stream in caller-owned storage to user-allocated buffer */
+inline_ bitstream*
+stream_init(void* storage, void* buffer, size_t bytes)
+{
+  bitstream* s = (bitstream*)storage;
+  s->begin = (word*)buffer;
+  s->end = s->begin + bytes / sizeof(word);
+#ifdef BIT_STREAM_STRIDED
+  stream_set_stride(s, 0, 0);
+#endif
+#ifdef BIT_STREAM_CALLBACK
+  s->write = NULL;
+  s->read = NULL;
+  s->context = NULL;
+#endif
+#ifdef BIT_STREAM_BRANCHLESS
+  s->spare = 0;
+#endif
+  stream_rewind(s);
+  return s;
+}
+
 /* allocate and initialize bit stream to user-allocated buffer */
 inline_ bitstream*
 stream_open(void* buffer, size_t bytes)
 {
-  bitstream* s = (bitstream*)malloc(sizeof(bitstream));
+  void* s = malloc(sizeof(bitstream));
+  return s ? stream_init(s, buffer, bytes) : NULL;
+}
+
+#ifdef BIT_STREAM_CALLBACK
+/* allocate and initialize bit stream that passes buffer through callbacks */
+inline_ bitstream*
+stream_open_callback(void* buffer, size_t bytes, stream_callback write, stream_callback read, void* context)
+{
+  bitstream* s = stream_open(buffer, bytes);
   if (s) {
-    s->begin = (word*)buffer;
-    s->end = s->begin + bytes / sizeof(word);
-#ifdef BIT_STREAM_STRIDED
-    stream_set_stride(s, 0, 0);
-#endif
-    stream_rewind(s);
+    s->write = write;
+    s->read = read;
+    s->context = context;
   }
   return s;
 }
+#endif
+
+/* associate bit stream with new buffer and rewind it */
+inline_ void
+stream_reopen(bitstream* s, void* buffer, size_t bytes)
+{
+  s->begin = (word*)buffer;
+  s->end = s->begin + bytes / sizeof(word);
+  stream_rewind(s);
+}
 
 /* close and deallocate bit stream */
 inline_ void
@@ -0,0 +1,9 @@
+/* device-callable variant of one codec translation unit, e.g., encode3d.c,
+   whose public functions are renamed to zfp_encode_block_omptarget_double_3
+   etc.; compiled once per ZFP_OMP_TARGET_CODEC by CMake */
+
+#define ZFP_ISA omptarget
+
+#pragma omp declare target
+#include ZFP_OMP_TARGET_CODEC
+#pragma omp end declare target
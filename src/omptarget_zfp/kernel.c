@@ -0,0 +1,130 @@
+/* device-callable block codec compiled from src/template (see codec.c) */
+#pragma omp declare target
+uint _t2(zfp_encode_block_strided_omptarget, Scalar, 1)(zfp_stream* stream, const Scalar* p, int sx);
+uint _t2(zfp_encode_partial_block_strided_omptarget, Scalar, 1)(zfp_stream* stream, const Scalar* p, uint nx, int sx);
+uint _t2(zfp_encode_block_strided_omptarget, Scalar, 2)(zfp_stream* stream, const Scalar* p, int sx, int sy);
+uint _t2(zfp_encode_partial_block_strided_omptarget, Scalar, 2)(zfp_stream* stream, const Scalar* p, uint nx, uint ny, int sx, int sy);
+uint _t2(zfp_encode_block_strided_omptarget, Scalar, 3)(zfp_stream* stream, const Scalar* p, int sx, int sy, int sz);
+uint _t2(zfp_encode_partial_block_strided_omptarget, Scalar, 3)(zfp_stream* stream, const Scalar* p, uint nx, uint ny, uint nz, int sx, int sy, int sz);
+uint _t2(zfp_decode_block_strided_omptarget, Scalar, 1)(zfp_stream* stream, Scalar* p, int sx);
+uint _t2(zfp_decode_partial_block_strided_omptarget, Scalar, 1)(zfp_stream* stream, Scalar* p, uint nx, int sx);
+uint _t2(zfp_decode_block_strided_omptarget, Scalar, 2)(zfp_stream* stream, Scalar* p, int sx, int sy);
+uint _t2(zfp_decode_partial_block_strided_omptarget, Scalar, 2)(zfp_stream* stream, Scalar* p, uint nx, uint ny, int sx, int sy);
+uint _t2(zfp_decode_block_strided_omptarget, Scalar, 3)(zfp_stream* stream, Scalar* p, int sx, int sy, int sz);
+uint _t2(zfp_decode_partial_block_strided_omptarget, Scalar, 3)(zfp_stream* stream, Scalar* p, uint nx, uint ny, uint nz, int sx, int sy, int sz);
+#pragma omp end declare target
+
+/* compress field of dims <= 3 dimensions to fixed-size blocks on device;
+   field value (0, 0, 0) is data[origin] and words receives the blocks */
+static void
+_t1(compress_target, Scalar)(const zfp_stream* stream, uint dims, const Scalar* data, ptrdiff_t origin, size_t nx, size_t ny, size_t nz, int sx, int sy, int sz, word* words, int device)
+{
+  const zfp_stream zfp = *stream;
+  const size_t bx = (nx + 3) / 4;
+  const size_t by = (ny + 3) / 4;
+  const size_t bz = (nz + 3) / 4;
+  const size_t blocks = bx * by * bz;
+  const size_t n = chunk_blocks(zfp.maxbits);
+  const size_t chunks = (blocks + n - 1) / n;
+  size_t chunk;
+
+  /* each chunk of blocks begins on a word boundary and is written by one thread */
+  #pragma omp target teams distribute parallel for device(device) is_device_ptr(data, words) firstprivate(zfp)
+  for (chunk = 0; chunk < chunks; chunk++) {
+    size_t bmin = chunk * n;
+    size_t bmax = MIN(bmin + n, blocks);
+    size_t block;
+    bitstream s;
+    zfp_stream z = zfp;
+    chunk_stream(&s, words, bmin, bmax, zfp.maxbits);
+    z.stream = &s;
+    for (block = bmin; block < bmax; block++) {
+      /* determine block origin (x, y, z) within array */
+      size_t x = 4 * (block % bx);
+      size_t y = 4 * ((block / bx) % by);
+      size_t k = 4 * (block / (bx * by));
+      const Scalar* p = data + origin + sx * (ptrdiff_t)x + sy * (ptrdiff_t)y + sz * (ptrdiff_t)k;
+      uint mx = (uint)MIN(nx - x, 4u);
+      uint my = (uint)MIN(ny - y, 4u);
+      uint mz = (uint)MIN(nz - k, 4u);
+      /* compress partial or full block */
+      switch (dims) {
+        case 1:
+          if (mx < 4)
+            _t2(zfp_encode_partial_block_strided_omptarget, Scalar, 1)(&z, p, mx, sx);
+          else
+            _t2(zfp_encode_block_strided_omptarget, Scalar, 1)(&z, p, sx);
+          break;
+        case 2:
+          if (mx < 4 || my < 4)
+            _t2(zfp_encode_partial_block_strided_omptarget, Scalar, 2)(&z, p, mx, my, sx, sy);
+          else
+            _t2(zfp_encode_block_strided_omptarget, Scalar, 2)(&z, p, sx, sy);
+          break;
+        default:
+          if (mx < 4 || my < 4 || mz < 4)
+            _t2(zfp_encode_partial_block_strided_omptarget, Scalar, 3)(&z, p, mx, my, mz, sx, sy, sz);
+          else
+            _t2(zfp_encode_block_strided_omptarget, Scalar, 3)(&z, p, sx, sy, sz);
+          break;
+      }
+    }
+    stream_flush(&s);
+  }
+}
+
+/* decompress fixed-size blocks on device to field of dims <= 3 dimensions */
+static void
+_t1(decompress_target, Scalar)(const zfp_stream* stream, uint dims, Scalar* data, ptrdiff_t origin, size_t nx, size_t ny, size_t nz, int sx, int sy, int sz, word* words, int device)
+{
+  const zfp_stream zfp = *stream;
+  const size_t bx = (nx + 3) / 4;
+  const size_t by = (ny + 3) / 4;
+  const size_t bz = (nz + 3) / 4;
+  const size_t blocks = bx * by * bz;
+  const size_t n = chunk_blocks(zfp.maxbits);
+  const size_t chunks = (blocks + n - 1) / n;
+  size_t chunk;
+
+  #pragma omp target teams distribute parallel for device(device) is_device_ptr(data, words) firstprivate(zfp)
+  for (chunk = 0; chunk < chunks; chunk++) {
+    size_t bmin = chunk * n;
+    size_t bmax = MIN(bmin + n, blocks);
+    size_t block;
+    bitstream s;
+    zfp_stream z = zfp;
+    chunk_stream(&s, words, bmin, bmax, zfp.maxbits);
+    z.stream = &s;
+    for (block = bmin; block < bmax; block++) {
+      /* determine block origin (x, y, z) within array */
+      size_t x = 4 * (block % bx);
+      size_t y = 4 * ((block / bx) % by);
+      size_t k = 4 * (block / (bx * by));
+      Scalar* p = data + origin + sx * (ptrdiff_t)x + sy * (ptrdiff_t)y + sz * (ptrdiff_t)k;
+      uint mx = (uint)MIN(nx - x, 4u);
+      uint my = (uint)MIN(ny - y, 4u);
+      uint mz = (uint)MIN(nz - k, 4u);
+      /* decompress partial or full block */
+      switch (dims) {
+        case 1:
+          if (mx < 4)
+            _t2(zfp_decode_partial_block_strided_omptarget, Scalar, 1)(&z, p, mx, sx);
+          else
+            _t2(zfp_decode_block_strided_omptarget, Scalar, 1)(&z, p, sx);
+          break;
+        case 2:
+          if (mx < 4 || my < 4)
+            _t2(zfp_decode_partial_block_strided_omptarget, Scalar, 2)(&z, p, mx, my, sx, sy);
+          else
+            _t2(zfp_decode_block_strided_omptarget, Scalar, 2)(&z, p, sx, sy);
+          break;
+        default:
+          if (mx < 4 || my < 4 || mz < 4)
+            _t2(zfp_decode_partial_block_strided_omptarget, Scalar, 3)(&z, p, mx, my, mz, sx, sy, sz);
+          else
+            _t2(zfp_decode_block_strided_omptarget, Scalar, 3)(&z, p, sx, sy, sz);
+          break;
+      }
+    }
+  }
+}
@@ -0,0 +1,191 @@
+#include <omp.h>
+#include <string.h>
+#include "../inline/inline.h"
+#include "zfp.h"
+#include "zfp/macros.h"
+#include "../template/template.h"
+#include "omptarget.h"
+
+#pragma omp declare target
+#include "../inline/bitstream.c"
+
+/* number of consecutive blocks of maxbits bits that span whole words */
+static size_t
+chunk_blocks(uint maxbits)
+{
+  uint a = maxbits;
+  uint b = wsize;
+  while (b) {
+    uint r = a % b;
+    a = b;
+    b = r;
+  }
+  return wsize / a;
+}
+
+/* set up private stream s over blocks [bmin, bmax) of words */
+static void
+chunk_stream(bitstream* s, word* words, size_t bmin, size_t bmax, uint maxbits)
+{
+  memset(s, 0, sizeof(*s));
+  s->begin = words + bmin * maxbits / wsize;
+  s->end = words + (bmax * maxbits + wsize - 1) / wsize;
+  stream_rewind(s);
+}
+#pragma omp end declare target
+
+/* lowest and one past highest index of field values relative to field->data */
+static void
+field_span(const size_t* n, const int* stride, ptrdiff_t* min, ptrdiff_t* max)
+{
+  uint i;
+  *min = 0;
+  *max = 1;
+  for (i = 0; i < 3; i++) {
+    ptrdiff_t d = stride[i] * (ptrdiff_t)(n[i] - 1);
+    if (d < 0)
+      *min += d;
+    else
+      *max += d;
+  }
+}
+
+/* template instantiation of device kernels ---------------------------------*/
+
+#define Scalar int32
+#include "kernel.c"
+#undef Scalar
+
+#define Scalar int64
+#include "kernel.c"
+#undef Scalar
+
+#define Scalar float
+#include "kernel.c"
+#undef Scalar
+
+#define Scalar double
+#include "kernel.c"
+#undef Scalar
+
+/* (de)compress field on target device; return compressed size in words */
+static size_t
+run_target(zfp_stream* stream, const zfp_field* field, zfp_bool compress)
+{
+  const zfp_exec_params_omp_target* params = &stream->exec.params.omp_target;
+  const int host = omp_get_initial_device();
+  const int device = params->device < 0 ? omp_get_default_device() : params->device;
+  bitstream* s = zfp_stream_bit_stream(stream);
+  uint dims = zfp_field_dimensionality(field);
+  size_t n[3];
+  int stride[3] = { 0, 0, 0 };
+  size_t blocks;
+  size_t words;
+  size_t offset = compress ? stream_wtell(s) : stream_rtell(s);
+  size_t size = zfp_type_size(field->type);
+  size_t bytes;
+  ptrdiff_t min, max;
+  uchar* begin;
+  void* data;
+  word* buffer;
+  zfp_bool success = zfp_true;
+
+  /* blocks are written by independent threads and must start on a word */
+  if (dims < 1 || dims > 3 || !size || offset % wsize)
+    return 0;
+#ifdef BIT_STREAM_CALLBACK
+  if (s->write || s->read)
+    return 0;
+#endif
+  n[0] = field->nx;
+  n[1] = dims > 1 ? field->ny : 1;
+  n[2] = dims > 2 ? field->nz : 1;
+  zfp_field_stride(field, stride);
+  blocks = ((n[0] + 3) / 4) * ((n[1] + 3) / 4) * ((n[2] + 3) / 4);
+  words = (blocks * stream->maxbits + wsize - 1) / wsize;
+  field_span(n, stride, &min, &max);
+  begin = (uchar*)field->data + min * (ptrdiff_t)size;
+  bytes = (size_t)(max - min) * size;
+
+  /* stage host-resident field and stream in device memory */
+  data = params->device_field ? (void*)begin : omp_target_alloc(bytes, device);
+  buffer = params->device_stream ? s->begin + offset / wsize : (word*)omp_target_alloc(words * sizeof(word), device);
+  if (!data || !buffer)
+    success = zfp_false;
+  /* strided fields are copied whole so that interleaved values survive */
+  else if (!params->device_field && (compress || !zfp_field_is_contiguous(field)) &&
+           omp_target_memcpy(data, begin, bytes, 0, 0, device, host))
+    success = zfp_false;
+  else if (!params->device_stream && !compress &&
+           omp_target_memcpy(buffer, s->begin + offset / wsize, words * sizeof(word), 0, 0, device, host))
+    success = zfp_false;
+
+  /* (de)compress on device */
+  if (success) {
+    switch (field->type) {
+      case zfp_type_int32:
+        if (compress)
+          compress_target_int32(stream, dims, (const int32*)data, -min, n[0], n[1], n[2], stride[0], stride[1], stride[2], buffer, device);
+        else
+          decompress_target_int32(stream, dims, (int32*)data, -min, n[0], n[1], n[2], stride[0], stride[1], stride[2], buffer, device);
+        break;
+      case zfp_type_int64:
+        if (compress)
+          compress_target_int64(stream, dims, (const int64*)data, -min, n[0], n[1], n[2], stride[0], stride[1], stride[2], buffer, device);
+        else
+          decompress_target_int64(stream, dims, (int64*)data, -min, n[0], n[1], n[2], stride[0], stride[1], stride[2], buffer, device);
+        break;
+      case zfp_type_float:
+        if (compress)
+          compress_target_float(stream, dims, (const float*)data, -min, n[0], n[1], n[2], stride[0], stride[1], stride[2], buffer, device);
+        else
+          decompress_target_float(stream, dims, (float*)data, -min, n[0], n[1], n[2], stride[0], stride[1], stride[2], buffer, device);
+        break;
+      case zfp_type_double:
+        if (compress)
+          compress_target_double(stream, dims, (const double*)data, -min, n[0], n[1], n[2], stride[0], stride[1], stride[2], buffer, device);
+        else
+          decompress_target_double(stream, dims, (double*)data, -min, n[0], n[1], n[2], stride[0], stride[1], stride[2], buffer, device);
+        break;
+      default:
+        success = zfp_false;
+        break;
+    }
+  }
+
+  /* copy results back to host */
+  if (success) {
+    if (compress && !params->device_stream)
+      success = !omp_target_memcpy(s->begin + offset / wsize, buffer, words * sizeof(word), 0, 0, host, device);
+    else if (!compress && !params->device_field)
+      success = !omp_target_memcpy(begin, data, bytes, 0, 0, host, device);
+  }
+
+  if (data && !params->device_field)
+    omp_target_free(data, device);
+  if (buffer && !params->device_stream)
+    omp_target_free(buffer, device);
+
+  if (!success)
+    return 0;
+
+  /* position stream at end of field; word-aligned seeks do not touch memory */
+  if (compress)
+    stream_wseek(s, offset + words * wsize);
+  else
+    stream_rseek(s, offset + words * wsize);
+
+  return words;
+}
+
+size_t
+omp_target_compress(zfp_stream* stream, const zfp_field* field)
+{
+  return run_target(stream, field, zfp_true) ? stream_size(zfp_stream_bit_stream(stream)) : 0;
+}
+
+void
+omp_target_decompress(zfp_stream* stream, zfp_field* field)
+{
+  run_target(stream, field, zfp_false);
+}
@@ -0,0 +1,15 @@
+#ifndef OMPTARGET_ZFP_H
+#define OMPTARGET_ZFP_H
+
+#include "zfp.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  size_t omp_target_compress(zfp_stream* stream, const zfp_field* field);
+  void omp_target_decompress(zfp_stream* stream, zfp_field* field);
+#ifdef __cplusplus
+}
+#endif
+
+#endif
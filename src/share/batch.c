@@ -0,0 +1,226 @@
+/* batch (de)compression of independent fields into word-aligned segments */
+
+/* exact size in bytes of compressed field in fixed-rate mode (zero if unknown) */
+static size_t
+fixed_rate_size(const zfp_stream* zfp, const zfp_field* field)
+{
+  uint mx = (MAX(field->nx, 1u) + 3) / 4;
+  uint my = (MAX(field->ny, 1u) + 3) / 4;
+  uint mz = (MAX(field->nz, 1u) + 3) / 4;
+  uint mw = (MAX(field->nw, 1u) + 3) / 4;
+  size_t blocks = (size_t)mx * (size_t)my * (size_t)mz * (size_t)mw;
+  size_t bits = blocks * zfp->maxbits;
+
+  if (!zfp_field_dimensionality(field) || zfp_stream_compression_mode(zfp) != zfp_mode_fixed_rate)
+    return 0;
+  return ((bits + stream_word_bits - 1) & ~(stream_word_bits - 1)) / CHAR_BIT;
+}
+
+/* open bit stream over bytes [offset, capacity) of the batch stream */
+static bitstream*
+segment_open(const zfp_stream* zfp, size_t offset)
+{
+  size_t capacity = stream_capacity(zfp->stream);
+  if (offset > capacity)
+    return NULL;
+  return stream_open((uchar*)stream_data(zfp->stream) + offset, capacity - offset);
+}
+
+/* compress field to segment beginning at byte offset */
+static size_t
+compress_segment(const zfp_stream* zfp, const zfp_field* field, size_t offset)
+{
+  zfp_stream s = *zfp;
+  size_t size;
+
+  s.index = NULL;
+  s.stream = segment_open(zfp, offset);
+  if (!s.stream)
+    return 0;
+  /* device execution defers synchronization until all fields are queued */
+  if (is_async_supported(&s, field))
+    size = zfp_compress_async(&s, field);
+  else
+    size = zfp_compress(&s, field);
+  stream_close(s.stream);
+
+  return size;
+}
+
+/* decompress field from segment beginning at byte offset */
+static size_t
+decompress_segment(const zfp_stream* zfp, zfp_field* field, size_t offset)
+{
+  zfp_stream s = *zfp;
+  size_t size;
+
+  s.index = NULL;
+  s.stream = segment_open(zfp, offset);
+  if (!s.stream)
+    return 0;
+  if (is_async_supported(&s, field))
+    size = zfp_decompress_async(&s, field);
+  else
+    size = zfp_decompress(&s, field);
+  stream_close(s.stream);
+
+  return size;
+}
+
+/* compress fields one after another; offsets[0] is given */
+static zfp_bool
+compress_batch_serial(zfp_stream* zfp, const zfp_field* const* fields, size_t n, size_t* offsets)
+{
+  size_t i;
+  for (i = 0; i < n; i++) {
+    size_t size = compress_segment(zfp, fields[i], offsets[i]);
+    if (!size)
+      return zfp_false;
+    offsets[i + 1] = offsets[i] + size;
+  }
+  return zfp_true;
+}
+
+/* decompress fields one after another; offsets are filled in when not known */
+static zfp_bool
+decompress_batch_serial(zfp_stream* zfp, zfp_field* const* fields, size_t n, size_t* offsets, zfp_bool known)
+{
+  size_t i;
+  for (i = 0; i < n; i++) {
+    size_t size = decompress_segment(zfp, fields[i], offsets[i]);
+    if (!size)
+      return zfp_false;
+    if (!known)
+      offsets[i + 1] = offsets[i] + size;
+  }
+  return zfp_true;
+}
+
+/* fill in offsets in fixed-rate mode; return false if sizes are not known */
+static zfp_bool
+batch_offsets(const zfp_stream* zfp, const zfp_field* const* fields, size_t n, size_t* offsets)
+{
+  size_t i;
+  for (i = 0; i < n; i++) {
+    size_t size = fixed_rate_size(zfp, fields[i]);
+    if (!size)
+      return zfp_false;
+    offsets[i + 1] = offsets[i] + size;
+  }
+  return zfp_true;
+}
+
+#ifdef _OPENMP
+
+/* compress one field per thread; offsets[0] is given */
+static zfp_bool
+compress_batch_omp(zfp_stream* zfp, const zfp_field* const* fields, size_t n, size_t* offsets)
+{
+  uint threads = thread_count_omp(zfp);
+  zfp_stream serial = *zfp;
+  bitstream** bs;
+  int failures = 0;
+  int i; /* OpenMP 2.0 requires int loop counter */
+
+  if (n > INT_MAX)
+    return zfp_false;
+  serial.exec.policy = zfp_exec_serial;
+  /* statistics are not gathered for fields (de)compressed concurrently */
+  serial.stats = NULL;
+
+  /* segments can be compressed in place when their sizes are known */
+  if (batch_offsets(zfp, fields, n, offsets)) {
+    if (offsets[n] > stream_capacity(zfp->stream))
+      return zfp_false;
+    #pragma omp parallel for num_threads(threads) reduction(+:failures)
+    for (i = 0; i < (int)n; i++)
+      if (compress_segment(&serial, fields[i], offsets[i]) != offsets[i + 1] - offsets[i])
+        failures++;
+    return !failures;
+  }
+
+  /* otherwise compress each field to its own buffer and concatenate */
+  bs = (bitstream**)calloc(n, sizeof(bitstream*));
+  if (!bs)
+    return zfp_false;
+  #pragma omp parallel for num_threads(threads) reduction(+:failures)
+  for (i = 0; i < (int)n; i++) {
+    zfp_stream s = serial;
+    size_t size = zfp_stream_maximum_size(&s, fields[i]);
+    void* buffer = size ? malloc(size) : NULL;
+    s.index = NULL;
+    s.stream = buffer ? stream_open(buffer, size) : NULL;
+    bs[i] = s.stream;
+    if (!s.stream || !zfp_compress(&s, fields[i]))
+      failures++;
+  }
+  for (i = 0; i < (int)n; i++) {
+    if (!failures) {
+      size_t size = stream_size(bs[i]);
+      if (offsets[i] + size > stream_capacity(zfp->stream))
+        failures++;
+      else {
+        memcpy((uchar*)stream_data(zfp->stream) + offsets[i], stream_data(bs[i]), size);
+        offsets[i + 1] = offsets[i] + size;
+      }
+    }
+    if (bs[i]) {
+      free(stream_data(bs[i]));
+      stream_close(bs[i]);
+    }
+  }
+  free(bs);
+
+  return !failures;
+}
+
+/* decompress one field per thread; offsets must be known */
+static zfp_bool
+decompress_batch_omp(zfp_stream* zfp, zfp_field* const* fields, size_t n, const size_t* offsets)
+{
+  uint threads = thread_count_omp(zfp);
+  zfp_stream serial = *zfp;
+  int failures = 0;
+  int i; /* OpenMP 2.0 requires int loop counter */
+
+  if (n > INT_MAX)
+    return zfp_false;
+  serial.exec.policy = zfp_exec_serial;
+  /* statistics are not gathered for fields (de)compressed concurrently */
+  serial.stats = NULL;
+
+  #pragma omp parallel for num_threads(threads) reduction(+:failures)
+  for (i = 0; i < (int)n; i++)
+    if (!decompress_segment(&serial, fields[i], offsets[i]))
+      failures++;
+
+  return !failures;
+}
+
+#endif
+
+/* compress fields under the current execution policy */
+static zfp_bool
+compress_batch(zfp_stream* zfp, const zfp_field* const* fields, size_t n, size_t* offsets)
+{
+#ifdef _OPENMP
+  /* verified fields are compressed one at a time */
+  if (zfp->exec.policy == zfp_exec_omp && !zfp->verify)
+    return compress_batch_omp(zfp, fields, n, offsets);
+#endif
+  return compress_batch_serial(zfp, fields, n, offsets);
+}
+
+/* decompress fields under the current execution policy */
+static zfp_bool
+decompress_batch(zfp_stream* zfp, zfp_field* const* fields, size_t n, size_t* offsets, zfp_bool known)
+{
+  /* offsets of fixed-rate fields follow from their dimensions */
+  if (!known)
+    known = batch_offsets(zfp, (const zfp_field* const*)fields, n, offsets);
+#ifdef _OPENMP
+  if (zfp->exec.policy == zfp_exec_omp && known)
+    return decompress_batch_omp(zfp, fields, n, offsets);
+#endif
+  return decompress_batch_serial(zfp, fields, n, offsets, known);
+}
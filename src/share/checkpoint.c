@@ -0,0 +1,174 @@
+/* incremental checkpoints that store only blocks changed since the last one */
+
+/* a checkpoint begins with a bit that is set if it is incremental, in which
+   case a bitmap of changed blocks follows; then come the bits of all blocks
+   or only those changed, each encoded as by zfp_compress() in serial */
+struct zfp_checkpoint {
+  zfp_field field;   /* type and dimensions of each checkpoint (data unused) */
+  size_t blocks;     /* number of blocks in field */
+  size_t stored;     /* number of blocks stored by last checkpoint */
+  zfp_bool valid;    /* true if hash holds blocks of previous checkpoint */
+  uint64* hash;      /* hash of compressed bits of each block */
+  uchar* changed;    /* per-block flags of current checkpoint */
+};
+
+/* true if field has the type and dimensions of the checkpoints */
+static zfp_bool
+checkpoint_match(const zfp_checkpoint* codec, const zfp_field* field)
+{
+  return field->type == codec->field.type &&
+         field->nx == codec->field.nx && field->ny == codec->field.ny &&
+         field->nz == codec->field.nz && field->nw == codec->field.nw;
+}
+
+/* true if blocks may be compressed one at a time without side information */
+static zfp_bool
+checkpoint_supported(const zfp_stream* zfp, const zfp_field* field)
+{
+  return !is_masked(field) && !zfp->map && !zfp->relative;
+}
+
+/* compress block on its own and copy its bits to stream s, if any;
+   return 64-bit FNV-1a hash of the bits and their count */
+static uint64
+checkpoint_encode(const zfp_stream* zfp, const zfp_field* field, size_t block, bitstream* s)
+{
+  const uint64 prime = UINT64C(0x100000001b3);
+  uint64 hash = UINT64C(0xcbf29ce484222325);
+  uint64 buffer[(ZFP_MAX_BITS + 63) / 64 + 1];
+  zfp_stream z = *zfp;
+  size_t bits, words, i;
+
+  /* blocks not emitted are not accounted */
+  z.stream = stream_open(buffer, sizeof(buffer));
+  if (!z.stream)
+    return 0;
+  z.index = NULL;
+  z.scratch = NULL;
+  if (!s) {
+    z.stats = NULL;
+    z.verify = NULL;
+  }
+  encode_block_converted(&z, field, codec_type(field->type), block);
+  bits = stream_wtell(z.stream);
+  stream_flush(z.stream);
+
+  /* hash bit count and word-padded bits */
+  words = (bits + 63) / 64;
+  hash = (hash ^ (uint64)bits) * prime;
+  for (i = 0; i < words; i++)
+    hash = (hash ^ buffer[i]) * prime;
+
+  if (s) {
+    stream_rewind(z.stream);
+    stream_copy(s, z.stream, bits);
+  }
+  stream_close(z.stream);
+
+  return hash;
+}
+
+/* allocate state for checkpoints of fields shaped like field */
+static zfp_checkpoint*
+checkpoint_create(const zfp_field* field)
+{
+  zfp_checkpoint* codec;
+
+  if (!zfp_field_dimensionality(field))
+    return NULL;
+
+  codec = (zfp_checkpoint*)malloc(sizeof(zfp_checkpoint));
+  if (!codec)
+    return NULL;
+
+  codec->field = *field;
+  codec->field.sx = codec->field.sy = codec->field.sz = codec->field.sw = 0;
+  codec->field.data = NULL;
+  codec->blocks = field_blocks(field);
+  codec->stored = 0;
+  codec->valid = zfp_false;
+  codec->hash = (uint64*)malloc(codec->blocks * sizeof(uint64));
+  codec->changed = (uchar*)malloc(codec->blocks);
+  if (!codec->hash || !codec->changed) {
+    zfp_checkpoint_free(codec);
+    return NULL;
+  }
+
+  return codec;
+}
+
+/* write full or incremental checkpoint of field */
+static size_t
+checkpoint_write(zfp_checkpoint* codec, zfp_stream* zfp, const zfp_field* field)
+{
+  const zfp_bool incremental = codec->valid;
+  size_t block;
+
+  if (!checkpoint_match(codec, field) || !checkpoint_supported(zfp, field))
+    return 0;
+  wait_async(zfp);
+  codec->valid = zfp_false;
+
+  /* find blocks whose compressed bits differ from previous checkpoint */
+  codec->stored = 0;
+  for (block = 0; block < codec->blocks; block++) {
+    uint64 hash = incremental ? checkpoint_encode(zfp, field, block, NULL) : 0;
+    codec->changed[block] = !incremental || hash != codec->hash[block];
+    if (codec->changed[block]) {
+      codec->hash[block] = hash;
+      codec->stored++;
+    }
+  }
+
+  /* write flag, bitmap, and changed blocks, hashing all blocks of a full checkpoint */
+  zfp_trace_begin("zfp:checkpoint");
+  stream_write_bit(zfp->stream, incremental);
+  if (incremental)
+    for (block = 0; block < codec->blocks; block++)
+      stream_write_bit(zfp->stream, codec->changed[block]);
+  for (block = 0; block < codec->blocks; block++)
+    if (codec->changed[block]) {
+      uint64 hash = checkpoint_encode(zfp, field, block, zfp->stream);
+      if (!incremental)
+        codec->hash[block] = hash;
+    }
+  zfp_trace_end();
+  stream_flush(zfp->stream);
+  codec->valid = zfp_true;
+
+  return stream_size(zfp->stream);
+}
+
+/* read checkpoint and overlay changed blocks onto field */
+static size_t
+checkpoint_read(zfp_checkpoint* codec, zfp_stream* zfp, zfp_field* field)
+{
+  const zfp_type type = codec_type(field->type);
+  zfp_bool incremental;
+  size_t block;
+
+  if (!checkpoint_match(codec, field) || !checkpoint_supported(zfp, field))
+    return 0;
+  wait_async(zfp);
+
+  /* an incremental checkpoint is overlaid onto the previous one */
+  incremental = (zfp_bool)stream_read_bit(zfp->stream);
+  if (incremental && !codec->valid)
+    return 0;
+  codec->valid = zfp_false;
+  codec->stored = 0;
+  for (block = 0; block < codec->blocks; block++) {
+    codec->changed[block] = !incremental || stream_read_bit(zfp->stream);
+    codec->stored += codec->changed[block];
+  }
+
+  zfp_trace_begin("zfp:checkpoint");
+  for (block = 0; block < codec->blocks; block++)
+    if (codec->changed[block])
+      decode_block_converted(zfp, field, type, block);
+  zfp_trace_end();
+  stream_align(zfp->stream);
+  codec->valid = zfp_true;
+
+  return stream_size(zfp->stream);
+}
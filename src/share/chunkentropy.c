@@ -0,0 +1,157 @@
+/* lossless entropy coding of the independently decodable chunks of a container field */
+
+/* byte size of chunk j of compressed stream, padded to whole words */
+static size_t
+container_chunk_bytes(const zfp_index* index, size_t j)
+{
+  uint64 bits = zfp_index_offset(index, j + 1) - zfp_index_offset(index, j);
+  return (size_t)((bits + stream_word_bits - 1) / stream_word_bits) * (stream_word_bits / CHAR_BIT);
+}
+
+#ifdef _OPENMP
+/* number of threads for entropy coding chunks in parallel */
+static uint
+container_threads(const zfp_stream* zfp)
+{
+  return zfp->exec.policy == zfp_exec_omp ? thread_count_omp(zfp) : 1;
+}
+#endif
+
+/* entropy code chunk j of stream in buffer into out; return coded size (zero upon failure) */
+static size_t
+container_encode_chunk(uchar* out, void* buffer, size_t capacity, const zfp_index* index, size_t j)
+{
+  size_t bytes = container_chunk_bytes(index, j);
+  void* data = malloc(MAX(bytes, 1));
+  bitstream* src = stream_open(buffer, capacity);
+  bitstream* dst = stream_open(data, bytes);
+  size_t size = 0;
+
+  if (data && src && dst) {
+    /* chunks begin on arbitrary bit offsets; align them on word boundaries */
+    stream_rseek(src, zfp_index_offset(index, j));
+    stream_copy(dst, src, (size_t)(zfp_index_offset(index, j + 1) - zfp_index_offset(index, j)));
+    stream_flush(dst);
+    size = entropy_encode(out, (const uchar*)data, bytes);
+  }
+  stream_close(dst);
+  stream_close(src);
+  free(data);
+
+  return size;
+}
+
+/* entropy code chunks of stream in buffer into container at offset; return byte size */
+static size_t
+container_encode(zfp_container* c, container_entry* entry, size_t offset, const zfp_stream* zfp, void* buffer, size_t capacity)
+{
+  size_t chunks = zfp_index_chunks(entry->index);
+  uint64* slot = (uint64*)malloc((chunks + 1) * sizeof(uint64));
+  uint64* position = (uint64*)malloc((chunks + 1) * sizeof(uint64));
+  uchar* scratch = NULL;
+  size_t size = 0;
+  size_t j;
+  int chunk;
+  int ok = 1;
+
+  if (!slot || !position || chunks > INT_MAX)
+    goto cleanup;
+
+  /* code each chunk into its own slot of scratch buffer */
+  slot[0] = 0;
+  for (j = 0; j < chunks; j++)
+    slot[j + 1] = slot[j] + entropy_maximum_size(container_chunk_bytes(entry->index, j));
+  scratch = (uchar*)malloc(MAX((size_t)slot[chunks], 1));
+  if (!scratch)
+    goto cleanup;
+#ifdef _OPENMP
+  #pragma omp parallel for num_threads(container_threads(zfp)) reduction(&&:ok)
+#endif
+  for (chunk = 0; chunk < (int)chunks; chunk++) {
+    size_t bytes = container_encode_chunk(scratch + slot[chunk], buffer, capacity, entry->index, (size_t)chunk);
+    position[chunk + 1] = bytes;
+    ok = ok && bytes;
+  }
+
+  /* pack coded chunks and record their offsets */
+  position[0] = 0;
+  for (j = 0; j < chunks; j++)
+    position[j + 1] += position[j];
+  if (!ok || !container_reserve(c, offset + (size_t)position[chunks]) || !zfp_index_set(entry->coded, chunks, position))
+    goto cleanup;
+  for (j = 0; j < chunks; j++)
+    memcpy(c->data + offset + position[j], scratch + slot[j], (size_t)(position[j + 1] - position[j]));
+  entry->entropy = zfp->entropy;
+  size = (size_t)position[chunks];
+
+cleanup:
+  free(scratch);
+  free(position);
+  free(slot);
+  return size;
+}
+
+/* decode entropy-coded chunks of entry into new buffer of given byte size */
+static void*
+container_decode(const zfp_container* c, const container_entry* entry, const zfp_stream* zfp, size_t* size)
+{
+  size_t chunks = zfp_index_chunks(entry->index);
+  const uchar* data = c->data + entry->offset;
+  uint64* slot = (uint64*)malloc((chunks + 1) * sizeof(uint64));
+  uchar* scratch = NULL;
+  void* buffer = NULL;
+  bitstream* dst = NULL;
+  size_t j;
+  int chunk;
+  int ok = 1;
+
+  if (!slot || chunks > INT_MAX)
+    goto cleanup;
+
+  /* decode each chunk into its own slot of scratch buffer */
+  slot[0] = 0;
+  for (j = 0; j < chunks; j++)
+    slot[j + 1] = slot[j] + container_chunk_bytes(entry->index, j);
+  scratch = (uchar*)malloc(MAX((size_t)slot[chunks], 1));
+  if (!scratch)
+    goto cleanup;
+#ifdef _OPENMP
+  #pragma omp parallel for num_threads(container_threads(zfp)) reduction(&&:ok)
+#else
+  (void)zfp;
+#endif
+  for (chunk = 0; chunk < (int)chunks; chunk++) {
+    uint64 begin = zfp_index_offset(entry->coded, (size_t)chunk);
+    uint64 end = zfp_index_offset(entry->coded, (size_t)chunk + 1);
+    ok = ok && entropy_decode(scratch + slot[chunk], (size_t)(slot[chunk + 1] - slot[chunk]), data + begin, (size_t)(end - begin));
+  }
+  if (!ok)
+    goto cleanup;
+
+  /* concatenate chunks at their original bit offsets */
+  *size = (size_t)((zfp_index_offset(entry->index, chunks) + stream_word_bits - 1) / stream_word_bits) * (stream_word_bits / CHAR_BIT);
+  buffer = malloc(MAX(*size, 1));
+  dst = buffer ? stream_open(buffer, *size) : NULL;
+  if (!dst) {
+    free(buffer);
+    buffer = NULL;
+    goto cleanup;
+  }
+  for (j = 0; j < chunks; j++) {
+    bitstream* src = stream_open(scratch + slot[j], (size_t)(slot[j + 1] - slot[j]));
+    if (!src) {
+      free(buffer);
+      buffer = NULL;
+      goto cleanup;
+    }
+    stream_copy(dst, src, (size_t)(zfp_index_offset(entry->index, j + 1) - zfp_index_offset(entry->index, j)));
+    stream_close(src);
+  }
+  stream_flush(dst);
+
+cleanup:
+  stream_close(dst);
+  free(scratch);
+  free(slot);
+  return buffer;
+}
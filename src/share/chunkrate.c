@@ -0,0 +1,218 @@
+/* chunk-rate mode: fixed size per chunk of blocks, variable size per block */
+
+/* number of bits encoding coarseness level of chunk in chunk-rate mode */
+#define CHUNK_RATE_LEVEL_BITS 12
+
+/* number of bits encoding count of blocks of chunk refined by one level */
+static uint
+chunk_rate_count_bits(uint chunk)
+{
+  uint bits = 1;
+  while (bits < 32 && (chunk >> bits))
+    bits++;
+  return bits;
+}
+
+/* coarsest level, at which blocks hold no more than their exponents */
+static uint
+chunk_rate_max_level(zfp_type type)
+{
+  return type == zfp_type_float || type == zfp_type_double ? (1u << CHUNK_RATE_LEVEL_BITS) - 1 : ZFP_MAX_PREC;
+}
+
+/* set parameters for coarseness level, which raises the minimum exponent of
+   floating-point blocks and lowers the precision of integer blocks */
+static void
+chunk_rate_level(zfp_stream* zfp, zfp_type type, uint level)
+{
+  if (type == zfp_type_float || type == zfp_type_double) {
+    zfp->maxprec = ZFP_MAX_PREC;
+    zfp->minexp = ZFP_MIN_EXP + (int)level;
+  }
+  else {
+    zfp->maxprec = ZFP_MAX_PREC - MIN(level, (uint)ZFP_MAX_PREC);
+    zfp->minexp = ZFP_MIN_EXP;
+  }
+}
+
+/* compress blocks [first, last) at coarseness level, one at a time, to
+   scratch stream and return their total size in bits, recording each size
+   if requested; without sizes, stop as soon as the budget is exceeded */
+static size_t
+chunk_rate_trial(zfp_stream* scratch, const zfp_field* field, size_t first, size_t last, uint level, size_t budget, uint* size)
+{
+  /* function table [scalar type] */
+  uint (*ftable[4])(zfp_stream*, const zfp_field*, size_t) = {
+    compress_block_int32,
+    compress_block_int64,
+    compress_block_float,
+    compress_block_double,
+  };
+  size_t bits = 0;
+  size_t i;
+
+  chunk_rate_level(scratch, field->type, level);
+  for (i = first; i < last && (size || bits <= budget); i++) {
+    uint b;
+    stream_rewind(scratch->stream);
+    b = ftable[field->type - zfp_type_int32](scratch, field, i);
+    if (size)
+      size[i - first] = b;
+    bits += b;
+  }
+
+  return bits;
+}
+
+/* compress blocks [first, last) into chunk of given number of blocks, each
+   taking on average maxbits bits; size must hold twice that many entries */
+static void
+chunk_rate_compress(zfp_stream* zfp, zfp_stream* scratch, const zfp_field* field, size_t first, size_t last, uint chunk, uint* size)
+{
+  /* function table [scalar type] */
+  uint (*ftable[4])(zfp_stream*, const zfp_field*, size_t) = {
+    compress_block_int32,
+    compress_block_int64,
+    compress_block_float,
+    compress_block_double,
+  };
+  uint count_bits = chunk_rate_count_bits(chunk);
+  uint remaining = chunk * zfp->maxbits - CHUNK_RATE_LEVEL_BITS - count_bits;
+  size_t budget = remaining;
+  size_t n = last - first;
+  size_t refined = 0;
+  uint lo = 0;
+  uint hi = chunk_rate_max_level(field->type);
+  zfp_stream s = *zfp;
+  size_t i;
+
+  /* find finest level at which all blocks fit, so that blocks share one
+     error tolerance rather than one size */
+  if (chunk_rate_trial(scratch, field, first, last, hi, budget, NULL) <= budget) {
+    while (lo < hi) {
+      uint mid = lo + (hi - lo) / 2;
+      if (chunk_rate_trial(scratch, field, first, last, mid, budget, NULL) <= budget)
+        hi = mid;
+      else
+        lo = mid + 1;
+    }
+    /* spend leftover bits refining leading blocks by one more level */
+    if (hi) {
+      size_t bits = chunk_rate_trial(scratch, field, first, last, hi, budget, size);
+      chunk_rate_trial(scratch, field, first, last, hi - 1, budget, size + n);
+      for (; refined < n && bits - size[refined] + size[n + refined] <= budget; refined++)
+        bits += size[n + refined] - size[refined];
+    }
+  }
+
+  /* encode chunk header and blocks; if not even the coarsest level fits,
+     then trailing blocks are truncated as in fixed-rate mode */
+  stream_write_bits(zfp->stream, hi, CHUNK_RATE_LEVEL_BITS);
+  stream_write_bits(zfp->stream, refined, count_bits);
+  s.minbits = 0;
+  s.verify = NULL;
+  for (i = first; i < last; i++) {
+    chunk_rate_level(&s, field->type, i - first < refined ? hi - 1 : hi);
+    s.maxbits = MIN(remaining, (uint)ZFP_MAX_BITS);
+    remaining -= ftable[field->type - zfp_type_int32](&s, field, i);
+  }
+  stream_pad(zfp->stream, remaining);
+}
+
+/* decompress blocks [first, last) from chunk of given number of blocks */
+static void
+chunk_rate_decompress(zfp_stream* zfp, zfp_field* field, size_t first, size_t last, uint chunk)
+{
+  /* function table [scalar type] */
+  uint (*ftable[4])(zfp_stream*, zfp_field*, size_t) = {
+    decompress_block_int32,
+    decompress_block_int64,
+    decompress_block_float,
+    decompress_block_double,
+  };
+  uint count_bits = chunk_rate_count_bits(chunk);
+  uint remaining = chunk * zfp->maxbits - CHUNK_RATE_LEVEL_BITS - count_bits;
+  uint level = (uint)stream_read_bits(zfp->stream, CHUNK_RATE_LEVEL_BITS);
+  size_t refined = (size_t)stream_read_bits(zfp->stream, count_bits);
+  zfp_stream s = *zfp;
+  size_t i;
+
+  s.minbits = 0;
+  for (i = first; i < last; i++) {
+    chunk_rate_level(&s, field->type, i - first < refined && level ? level - 1 : level);
+    s.maxbits = MIN(remaining, (uint)ZFP_MAX_BITS);
+    remaining -= ftable[field->type - zfp_type_int32](&s, field, i);
+  }
+  stream_skip(zfp->stream, remaining);
+}
+
+/* whether stream and field support chunk-rate (de)compression */
+static zfp_bool
+is_chunk_rate_supported(const zfp_stream* zfp, const zfp_field* field, uint chunk)
+{
+  uint64 bits = (uint64)chunk * zfp->maxbits;
+  return zfp_field_dimensionality(field) && is_plain_field(field) &&
+         zfp_stream_compression_mode(zfp) == zfp_mode_fixed_rate &&
+         bits > CHUNK_RATE_LEVEL_BITS + chunk_rate_count_bits(chunk) && bits <= UINT_MAX;
+}
+
+/* compress field in chunks of given number of fixed-rate blocks */
+static size_t
+chunk_rate_compress_field(zfp_stream* zfp, const zfp_field* field, uint chunk)
+{
+  size_t blocks = field_blocks(field);
+  size_t chunks, c;
+  uint64 buffer[(ZFP_MAX_BITS + 63) / 64 + 1];
+  zfp_stream scratch;
+  uint* size;
+
+  if (!is_chunk_rate_supported(zfp, field, chunk))
+    return 0;
+
+  /* make sure every chunk, including the last, fits in stream */
+  chunks = (blocks + chunk - 1) / chunk;
+  if (stream_wtell(zfp->stream) + (uint64)chunks * chunk * zfp->maxbits > (uint64)stream_capacity(zfp->stream) * CHAR_BIT)
+    return 0;
+
+  /* trial encodings measure block sizes in scratch stream */
+  size = (uint*)malloc(2 * (size_t)chunk * sizeof(uint));
+  if (!size)
+    return 0;
+  scratch = *zfp;
+  scratch.minbits = 0;
+  scratch.maxbits = ZFP_MAX_BITS;
+  scratch.stats = NULL;
+  scratch.verify = NULL;
+  scratch.stream = stream_open(buffer, sizeof(buffer));
+  if (!scratch.stream) {
+    free(size);
+    return 0;
+  }
+
+  for (c = 0; c < chunks; c++)
+    chunk_rate_compress(zfp, &scratch, field, c * chunk, MIN((c + 1) * chunk, blocks), chunk, size);
+
+  stream_close(scratch.stream);
+  free(size);
+  stream_flush(zfp->stream);
+
+  return stream_size(zfp->stream);
+}
+
+/* decompress field compressed in chunk-rate mode */
+static size_t
+chunk_rate_decompress_field(zfp_stream* zfp, zfp_field* field, uint chunk)
+{
+  size_t blocks = field_blocks(field);
+  size_t chunks, c;
+
+  if (!is_chunk_rate_supported(zfp, field, chunk))
+    return 0;
+
+  chunks = (blocks + chunk - 1) / chunk;
+  for (c = 0; c < chunks; c++)
+    chunk_rate_decompress(zfp, field, c * chunk, MIN((c + 1) * chunk, blocks), chunk);
+  stream_align(zfp->stream);
+
+  return stream_rtell(zfp->stream) / CHAR_BIT;
+}
@@ -0,0 +1,435 @@
+/* self-describing container of named compressed fields */
+
+/* container format version; version 1 lacks entropy coding */
+#define CONTAINER_VERSION 2
+/* byte size of container header and trailer */
+#define CONTAINER_HEADER_SIZE 16
+#define CONTAINER_TRAILER_SIZE 32
+
+/* compressed field stored in container */
+typedef struct {
+  char* name;       /* null-terminated field name */
+  uint64 offset;    /* byte offset of compressed field within container */
+  uint64 size;      /* byte size of compressed field */
+  uint64 mode;      /* compression parameters (see zfp_stream_mode) */
+  uint64 meta;      /* field metadata (see zfp_field_metadata) */
+  zfp_entropy entropy; /* lossless back end applied to each chunk */
+  zfp_index* index; /* bit offsets of independently decodable chunks */
+  zfp_index* coded; /* byte offsets of entropy-coded chunks (if coded) */
+} container_entry;
+
+struct zfp_container {
+  uchar* data;             /* container bytes (owned by writer only) */
+  size_t size;             /* number of bytes in use */
+  size_t capacity;         /* number of bytes allocated by writer */
+  size_t alignment;        /* byte alignment of compressed fields */
+  zfp_bool writable;       /* true until writer is finished */
+  container_entry* entry;  /* fields in order stored */
+  size_t entries;          /* number of fields */
+};
+
+/* store 64-bit integer in little-endian byte order */
+static void
+container_put(uchar* p, uint64 value)
+{
+  uint i;
+  for (i = 0; i < 8; i++, value >>= 8)
+    p[i] = (uchar)value;
+}
+
+/* load little-endian 64-bit integer */
+static uint64
+container_get(const uchar* p)
+{
+  uint64 value = 0;
+  uint i;
+  for (i = 8; i--;)
+    value = (value << 8) + p[i];
+  return value;
+}
+
+/* write magic and version */
+static void
+container_put_magic(uchar* p)
+{
+  container_put(p, (uint64)'z' + ((uint64)'f' << 8) + ((uint64)'p' << 16) + ((uint64)'C' << 24) + ((uint64)CONTAINER_VERSION << 32));
+}
+
+/* verify magic and return version (zero if invalid or unsupported) */
+static uint
+container_check_magic(const uchar* p)
+{
+  uint64 word = container_get(p);
+  uint64 version = word >> 32;
+  if ((word & 0xffffffffu) != (uint64)'z' + ((uint64)'f' << 8) + ((uint64)'p' << 16) + ((uint64)'C' << 24))
+    return 0;
+  return version <= CONTAINER_VERSION ? (uint)version : 0;
+}
+
+/* round size up to multiple of alignment */
+static size_t
+container_align(size_t size, size_t alignment)
+{
+  return (size + alignment - 1) & ~(alignment - 1);
+}
+
+/* make room for at least size bytes of writable container */
+static zfp_bool
+container_reserve(zfp_container* c, size_t size)
+{
+  if (size > c->capacity) {
+    size_t capacity = MAX(size, 2 * c->capacity);
+    uchar* data = (uchar*)realloc(c->data, capacity);
+    if (!data)
+      return zfp_false;
+    /* zero padding so that containers are reproducible */
+    memset(data + c->capacity, 0, capacity - c->capacity);
+    c->data = data;
+    c->capacity = capacity;
+  }
+  return zfp_true;
+}
+
+/* append empty entry for field of given name */
+static container_entry*
+container_append(zfp_container* c, const char* name, size_t length)
+{
+  container_entry* entry = (container_entry*)realloc(c->entry, (c->entries + 1) * sizeof(container_entry));
+  if (!entry)
+    return NULL;
+  c->entry = entry;
+  entry += c->entries;
+  entry->name = (char*)malloc(length + 1);
+  entry->entropy = zfp_entropy_none;
+  entry->index = zfp_index_alloc();
+  entry->coded = zfp_index_alloc();
+  if (!entry->name || !entry->index || !entry->coded) {
+    free(entry->name);
+    zfp_index_free(entry->index);
+    zfp_index_free(entry->coded);
+    return NULL;
+  }
+  memcpy(entry->name, name, length);
+  entry->name[length] = '\0';
+  c->entries++;
+  return entry;
+}
+
+/* remove last entry */
+static void
+container_discard(zfp_container* c)
+{
+  container_entry* entry = c->entry + --c->entries;
+  free(entry->name);
+  zfp_index_free(entry->index);
+  zfp_index_free(entry->coded);
+}
+
+/* byte size of serialized entry */
+static size_t
+container_entry_size(const container_entry* entry)
+{
+  size_t offsets = zfp_index_chunks(entry->index) + 1;
+  if (entry->entropy != zfp_entropy_none)
+    offsets *= 2;
+  return 8 + container_align(strlen(entry->name), 8) + 6 * 8 + offsets * 8;
+}
+
+/* entropy coding of chunks of compressed stream (see share/chunkentropy.c) */
+static size_t container_encode(zfp_container* c, container_entry* entry, size_t offset, const zfp_stream* zfp, void* buffer, size_t capacity);
+static void* container_decode(const zfp_container* c, const container_entry* entry, const zfp_stream* zfp, size_t* size);
+
+/* set up stream to decode entry; return false if field does not match */
+static zfp_bool
+container_begin(const zfp_container* c, size_t i, zfp_stream* zfp, const zfp_field* field, bitstream** stream, void** buffer)
+{
+  const container_entry* entry;
+  size_t size;
+  if (i >= c->entries)
+    return zfp_false;
+  entry = c->entry + i;
+  if (zfp_field_metadata(field) != entry->meta || zfp_stream_set_mode(zfp, entry->mode) == zfp_mode_null)
+    return zfp_false;
+  if (entry->entropy == zfp_entropy_none) {
+    /* the stream only reads from the container */
+    *stream = stream_open(c->data + entry->offset, (size_t)entry->size);
+  }
+  else {
+    /* entropy-coded chunks are decoded into a separate buffer */
+    *buffer = container_decode(c, entry, zfp, &size);
+    *stream = *buffer ? stream_open(*buffer, size) : NULL;
+  }
+  if (!*stream)
+    return zfp_false;
+  zfp_stream_set_bit_stream(zfp, *stream);
+  zfp_stream_set_index(zfp, entry->index);
+  zfp_stream_rewind(zfp);
+  return zfp_true;
+}
+
+/* free container and its entries */
+static void
+container_close(zfp_container* c)
+{
+  size_t i;
+  if (!c)
+    return;
+  for (i = 0; i < c->entries; i++) {
+    free(c->entry[i].name);
+    zfp_index_free(c->entry[i].index);
+    zfp_index_free(c->entry[i].coded);
+  }
+  free(c->entry);
+  if (c->capacity)
+    free(c->data);
+  free(c);
+}
+
+/* create empty writable container with given field alignment */
+static zfp_container*
+container_create(size_t alignment)
+{
+  zfp_container* c;
+
+  /* fields must begin on a word boundary */
+  alignment = MAX(alignment, stream_word_bits / CHAR_BIT);
+  if (alignment & (alignment - 1))
+    return NULL;
+
+  c = (zfp_container*)malloc(sizeof(zfp_container));
+  if (!c)
+    return NULL;
+  c->data = NULL;
+  c->size = CONTAINER_HEADER_SIZE;
+  c->capacity = 0;
+  c->alignment = alignment;
+  c->writable = zfp_true;
+  c->entry = NULL;
+  c->entries = 0;
+  if (!container_reserve(c, CONTAINER_HEADER_SIZE)) {
+    free(c);
+    return NULL;
+  }
+  container_put_magic(c->data);
+  container_put(c->data + 8, alignment);
+
+  return c;
+}
+
+/* compress field into container under given name */
+static zfp_bool
+container_add(zfp_container* c, const char* name, zfp_stream* zfp, const zfp_field* field)
+{
+  bitstream* stream = zfp_stream_bit_stream(zfp);
+  zfp_index* index = zfp_stream_index(zfp);
+  uint64 meta = zfp_field_metadata(field);
+  size_t offset = container_align(c->size, c->alignment);
+  size_t maxsize = zfp_stream_maximum_size(zfp, field);
+  container_entry* entry;
+  void* buffer = NULL;
+  bitstream* s;
+  size_t size;
+
+  /* names must be unique */
+  if (!c->writable || meta == ZFP_META_NULL || !maxsize || zfp_container_find(c, name) != c->entries)
+    return zfp_false;
+  if (!container_reserve(c, offset + maxsize) || !(entry = container_append(c, name, strlen(name))))
+    return zfp_false;
+
+  /* compress field into container, or into a buffer whose chunks are then */
+  /* entropy coded, and record its chunk offsets */
+  if (zfp->entropy != zfp_entropy_none && !(buffer = malloc(maxsize))) {
+    container_discard(c);
+    return zfp_false;
+  }
+  s = stream_open(buffer ? buffer : c->data + offset, maxsize);
+  if (!s) {
+    free(buffer);
+    container_discard(c);
+    return zfp_false;
+  }
+  zfp_stream_set_bit_stream(zfp, s);
+  zfp_stream_set_index(zfp, entry->index);
+  zfp_stream_rewind(zfp);
+  size = zfp_compress(zfp, field);
+  stream_close(s);
+  zfp_stream_set_bit_stream(zfp, stream);
+  zfp_stream_set_index(zfp, index);
+
+  /* fields compressed serially consist of a single chunk */
+  if (size && !zfp_index_chunks(entry->index)) {
+    uint64 range[2];
+    range[0] = 0;
+    range[1] = (uint64)size * CHAR_BIT;
+    if (!zfp_index_set(entry->index, 1, range))
+      size = 0;
+  }
+  if (size && buffer)
+    size = container_encode(c, entry, offset, zfp, buffer, maxsize);
+  free(buffer);
+  if (!size) {
+    container_discard(c);
+    return zfp_false;
+  }
+
+  entry->offset = offset;
+  entry->size = size;
+  entry->mode = zfp_stream_mode(zfp);
+  entry->meta = meta;
+  c->size = offset + size;
+
+  return zfp_true;
+}
+
+/* append footer index and trailer; return container bytes */
+static const void*
+container_finish(zfp_container* c, size_t* size)
+{
+  if (c->writable) {
+    size_t offset = container_align(c->size, c->alignment);
+    size_t bytes = CONTAINER_TRAILER_SIZE;
+    uchar* p;
+    size_t i, j;
+
+    /* footer index of fields followed by trailer */
+    for (i = 0; i < c->entries; i++)
+      bytes += container_entry_size(c->entry + i);
+    if (!container_reserve(c, offset + bytes))
+      return NULL;
+    p = c->data + offset;
+    for (i = 0; i < c->entries; i++) {
+      const container_entry* entry = c->entry + i;
+      size_t length = strlen(entry->name);
+      size_t chunks = zfp_index_chunks(entry->index);
+      container_put(p, length);
+      p += 8;
+      memcpy(p, entry->name, length);
+      p += container_align(length, 8);
+      container_put(p + 0, entry->offset);
+      container_put(p + 8, entry->size);
+      container_put(p + 16, entry->mode);
+      container_put(p + 24, entry->meta);
+      container_put(p + 32, entry->entropy);
+      container_put(p + 40, chunks);
+      p += 48;
+      for (j = 0; j <= chunks; j++, p += 8)
+        container_put(p, zfp_index_offset(entry->index, j));
+      if (entry->entropy != zfp_entropy_none)
+        for (j = 0; j <= chunks; j++, p += 8)
+          container_put(p, zfp_index_offset(entry->coded, j));
+    }
+    container_put(p + 0, offset);
+    container_put(p + 8, bytes - CONTAINER_TRAILER_SIZE);
+    container_put(p + 16, c->entries);
+    container_put_magic(p + 24);
+    c->size = offset + bytes;
+    c->writable = zfp_false;
+  }
+
+  if (size)
+    *size = c->size;
+  return c->data;
+}
+
+/* open read-only container over serialized bytes */
+static zfp_container*
+container_open(const void* data, size_t size)
+{
+  const uchar* begin = (const uchar*)data;
+  const uchar* p;
+  const uchar* end;
+  zfp_container* c;
+  uint64 offset, bytes, entries;
+  size_t alignment;
+  size_t words;
+  size_t i;
+  uint version;
+
+  /* validate header and trailer */
+  if (size < CONTAINER_HEADER_SIZE + CONTAINER_TRAILER_SIZE)
+    return NULL;
+  p = begin + size - CONTAINER_TRAILER_SIZE;
+  version = container_check_magic(begin);
+  if (!version || container_check_magic(p + 24) != version)
+    return NULL;
+  /* entries of version 1 lack the entropy coder */
+  words = version < 2 ? 5 : 6;
+  alignment = (size_t)container_get(begin + 8);
+  offset = container_get(p + 0);
+  bytes = container_get(p + 8);
+  entries = container_get(p + 16);
+  if (offset < CONTAINER_HEADER_SIZE || offset > size - CONTAINER_TRAILER_SIZE || bytes != size - CONTAINER_TRAILER_SIZE - offset)
+    return NULL;
+
+  c = (zfp_container*)malloc(sizeof(zfp_container));
+  if (!c)
+    return NULL;
+  c->data = (uchar*)data;
+  c->size = size;
+  c->capacity = 0;
+  c->alignment = alignment;
+  c->writable = zfp_false;
+  c->entry = NULL;
+  c->entries = 0;
+
+  /* parse footer index */
+  p = begin + offset;
+  end = p + bytes;
+  for (i = 0; i < entries; i++) {
+    container_entry* entry;
+    uint64 length, chunks;
+    uint64* position;
+    size_t aligned;
+    size_t j;
+    if (end - p < 8)
+      break;
+    length = container_get(p);
+    p += 8;
+    /* bound name length before aligning it, which could otherwise wrap */
+    if (length > (uint64)(end - p))
+      break;
+    aligned = container_align((size_t)length, 8);
+    if ((size_t)(end - p) < aligned || (size_t)(end - p) - aligned < 8 * words)
+      break;
+    entry = container_append(c, (const char*)p, (size_t)length);
+    if (!entry)
+      break;
+    p += aligned;
+    entry->offset = container_get(p + 0);
+    entry->size = container_get(p + 8);
+    entry->mode = container_get(p + 16);
+    entry->meta = container_get(p + 24);
+    entry->entropy = words < 6 ? zfp_entropy_none : (zfp_entropy)container_get(p + 32);
+    chunks = container_get(p + 8 * words - 8);
+    p += 8 * words;
+    if (entry->offset > offset || entry->size > offset - entry->offset || (uint64)(end - p) / 8 <= chunks)
+      break;
+    if (entry->entropy != zfp_entropy_none && (entry->entropy != zfp_entropy_huffman || (uint64)(end - p) / 16 <= chunks))
+      break;
+    position = (uint64*)malloc(((size_t)chunks + 1) * sizeof(uint64));
+    if (!position)
+      break;
+    for (j = 0; j <= chunks; j++, p += 8)
+      position[j] = container_get(p);
+    if (!zfp_index_set(entry->index, (size_t)chunks, position) || (entry->entropy == zfp_entropy_none && position[chunks] > entry->size * CHAR_BIT)) {
+      free(position);
+      break;
+    }
+    if (entry->entropy != zfp_entropy_none) {
+      /* coded chunks must lie within the compressed field */
+      for (j = 0; j <= chunks; j++, p += 8)
+        position[j] = container_get(p);
+      if (!zfp_index_set(entry->coded, (size_t)chunks, position) || position[chunks] != entry->size) {
+        free(position);
+        break;
+      }
+    }
+    free(position);
+  }
+  if (i < entries) {
+    container_close(c);
+    return NULL;
+  }
+
+  return c;
+}
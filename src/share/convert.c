@@ -0,0 +1,977 @@
+/* (de)compression of fields whose scalar type differs from the codec type */
+
+#if defined(ZFP_WITH_ISA_AVX2) || defined(ZFP_WITH_ISA_AVX512)
+#include <immintrin.h>
+#endif
+
+/* reinterpret bits of float as integer */
+static uint32
+float_bits(float f)
+{
+  uint32 u;
+  memcpy(&u, &f, sizeof(u));
+  return u;
+}
+
+/* reinterpret integer as bits of float */
+static float
+bits_float(uint32 u)
+{
+  float f;
+  memcpy(&f, &u, sizeof(f));
+  return f;
+}
+
+/* convert IEEE half to single precision (exactly) */
+static float
+half_to_float(uint16 h)
+{
+  uint32 s = (uint32)(h & 0x8000u) << 16;
+  uint32 e = (h >> 10) & 0x1fu;
+  uint32 m = h & 0x3ffu;
+  if (e == 0x1fu)
+    /* infinity or NaN */
+    return bits_float(s | 0x7f800000u | (m << 13));
+  if (e == 0) {
+    /* zero or subnormal, which is normal in single precision */
+    float f = (float)m * (1.0f / 16777216.0f);
+    return s ? -f : f;
+  }
+  return bits_float(s | ((e + 112) << 23) | (m << 13));
+}
+
+/* convert single precision to IEEE half with rounding to nearest even */
+static uint16
+float_to_half(float f)
+{
+  uint32 u = float_bits(f);
+  uint32 s = (u >> 16) & 0x8000u;
+  uint32 e = (u >> 23) & 0xffu;
+  uint32 m = u & 0x7fffffu;
+  uint32 r;
+  if (e == 0xffu)
+    /* infinity or quieted NaN */
+    return (uint16)(s | 0x7c00u | (m ? 0x200u | (m >> 13) : 0));
+  if (e > 142)
+    /* overflow */
+    return (uint16)(s | 0x7c00u);
+  if (e < 113) {
+    /* subnormal or zero half; shift implicit one into place */
+    uint32 shift = 126 - e;
+    if (shift > 24)
+      return (uint16)s;
+    m |= 0x800000u;
+    r = m >> shift;
+    m &= (1u << shift) - 1;
+    /* round to nearest, ties to even */
+    if (m > (1u << (shift - 1)) || (m == (1u << (shift - 1)) && (r & 1u)))
+      r++;
+    return (uint16)(s | r);
+  }
+  /* normal half; a carry out of the mantissa correctly bumps the exponent */
+  r = ((e - 112) << 10) | (m >> 13);
+  m &= 0x1fffu;
+  if (m > 0x1000u || (m == 0x1000u && (r & 1u)))
+    r++;
+  return (uint16)(s | r);
+}
+
+/* convert bfloat16 to single precision (exactly) */
+static float
+bfloat16_to_float(uint16 b)
+{
+  return bits_float((uint32)b << 16);
+}
+
+/* convert single precision to bfloat16 with rounding to nearest even */
+static uint16
+float_to_bfloat16(float f)
+{
+  uint32 u = float_bits(f);
+  if ((u & 0x7fffffffu) > 0x7f800000u)
+    /* quieted NaN */
+    return (uint16)((u >> 16) | 0x40u);
+  u += 0x7fffu + ((u >> 16) & 1u);
+  return (uint16)(u >> 16);
+}
+
+#if defined(ZFP_WITH_ISA_AVX2) || defined(ZFP_WITH_ISA_AVX512)
+/* convert n halfs to single precision using F16C instructions */
+__attribute__((target("f16c")))
+static void
+cast_half_f16c(float* q, const uint16* p, uint n)
+{
+  uint i;
+  for (i = 0; i + 4 <= n; i += 4)
+    _mm_storeu_ps(q + i, _mm_cvtph_ps(_mm_loadl_epi64((const __m128i*)(p + i))));
+  for (; i < n; i++)
+    q[i] = half_to_float(p[i]);
+}
+
+/* convert n floats to half using F16C instructions */
+__attribute__((target("f16c")))
+static void
+uncast_half_f16c(uint16* q, const float* p, uint n)
+{
+  uint i;
+  for (i = 0; i + 4 <= n; i += 4)
+    _mm_storel_epi64((__m128i*)(q + i), _mm_cvtps_ph(_mm_loadu_ps(p + i), _MM_FROUND_TO_NEAREST_INT));
+  for (; i < n; i++)
+    q[i] = float_to_half(p[i]);
+}
+#endif
+
+/* convert n 16-bit values of given type to single precision */
+static void
+cast_block_half(float* q, const uint16* p, uint n, zfp_type type, zfp_isa isa)
+{
+  uint i;
+  if (type == zfp_type_bfloat16) {
+    for (i = 0; i < n; i++)
+      q[i] = bfloat16_to_float(p[i]);
+    return;
+  }
+#if defined(ZFP_WITH_ISA_AVX2) || defined(ZFP_WITH_ISA_AVX512)
+  /* every processor supporting AVX2 also supports F16C */
+  if (isa == zfp_isa_avx2 || isa == zfp_isa_avx512) {
+    cast_half_f16c(q, p, n);
+    return;
+  }
+#else
+  (void)isa;
+#endif
+  for (i = 0; i < n; i++)
+    q[i] = half_to_float(p[i]);
+}
+
+/* convert n floats to 16-bit values of given type */
+static void
+uncast_block_half(uint16* q, const float* p, uint n, zfp_type type, zfp_isa isa)
+{
+  uint i;
+  if (type == zfp_type_bfloat16) {
+    for (i = 0; i < n; i++)
+      q[i] = float_to_bfloat16(p[i]);
+    return;
+  }
+#if defined(ZFP_WITH_ISA_AVX2) || defined(ZFP_WITH_ISA_AVX512)
+  if (isa == zfp_isa_avx2 || isa == zfp_isa_avx512) {
+    uncast_half_f16c(q, p, n);
+    return;
+  }
+#else
+  (void)isa;
+#endif
+  for (i = 0; i < n; i++)
+    q[i] = float_to_half(p[i]);
+}
+
+/* block of values of the type coded in place of the field type */
+typedef union {
+  float f[256];
+  double d[256];
+  int32 i[256];
+} convert_block;
+
+/* true if field of given type can be (de)compressed as stream of type */
+static zfp_bool
+is_convertible(zfp_type field, zfp_type stream)
+{
+  zfp_type type = codec_type(field);
+  if (!is_native_type(type) || !is_native_type(stream))
+    return zfp_false;
+  /* floating-point values convert between single and double precision */
+  return type == stream || (type >= zfp_type_float && stream >= zfp_type_float);
+}
+
+/* convert block of field values to coded type */
+static void
+cast_block_converted(convert_block* q, const void* p, uint dims, zfp_type field, zfp_type type, zfp_isa isa)
+{
+  uint n = 1u << (2 * dims);
+  convert_block t;
+  uint i;
+
+  switch (field) {
+    case zfp_type_float:
+      if (type == zfp_type_double)
+        for (i = 0; i < n; i++)
+          q->d[i] = ((const float*)p)[i];
+      else
+        memcpy(q->f, p, n * sizeof(float));
+      return;
+    case zfp_type_double:
+      if (type == zfp_type_float)
+        for (i = 0; i < n; i++)
+          q->f[i] = (float)((const double*)p)[i];
+      else
+        memcpy(q->d, p, n * sizeof(double));
+      return;
+    case zfp_type_int32:
+      memcpy(q->i, p, n * sizeof(int32));
+      return;
+    case zfp_type_half:
+    case zfp_type_bfloat16:
+      if (type == zfp_type_double) {
+        cast_block_half(t.f, (const uint16*)p, n, field, isa);
+        for (i = 0; i < n; i++)
+          q->d[i] = t.f[i];
+      }
+      else
+        cast_block_half(q->f, (const uint16*)p, n, field, isa);
+      return;
+    case zfp_type_int8:
+      zfp_promote_int8_to_int32(q->i, (const int8*)p, dims);
+      return;
+    case zfp_type_uint8:
+      zfp_promote_uint8_to_int32(q->i, (const uint8*)p, dims);
+      return;
+    case zfp_type_int16:
+      zfp_promote_int16_to_int32(q->i, (const int16*)p, dims);
+      return;
+    case zfp_type_uint16:
+      zfp_promote_uint16_to_int32(q->i, (const uint16*)p, dims);
+      return;
+    default:
+      return;
+  }
+}
+
+/* convert decoded block to field type, clamping integers to their range */
+static void
+uncast_block_converted(void* q, const convert_block* p, uint dims, zfp_type field, zfp_type type, zfp_isa isa)
+{
+  uint n = 1u << (2 * dims);
+  convert_block t;
+  uint i;
+
+  switch (field) {
+    case zfp_type_float:
+      if (type == zfp_type_double)
+        for (i = 0; i < n; i++)
+          ((float*)q)[i] = (float)p->d[i];
+      else
+        memcpy(q, p->f, n * sizeof(float));
+      return;
+    case zfp_type_double:
+      if (type == zfp_type_float)
+        for (i = 0; i < n; i++)
+          ((double*)q)[i] = p->f[i];
+      else
+        memcpy(q, p->d, n * sizeof(double));
+      return;
+    case zfp_type_int32:
+      memcpy(q, p->i, n * sizeof(int32));
+      return;
+    case zfp_type_half:
+    case zfp_type_bfloat16:
+      if (type == zfp_type_double) {
+        /* round via single precision */
+        for (i = 0; i < n; i++)
+          t.f[i] = (float)p->d[i];
+        uncast_block_half((uint16*)q, t.f, n, field, isa);
+      }
+      else
+        uncast_block_half((uint16*)q, p->f, n, field, isa);
+      return;
+    case zfp_type_int8:
+      zfp_demote_int32_to_int8((int8*)q, p->i, dims);
+      return;
+    case zfp_type_uint8:
+      zfp_demote_int32_to_uint8((uint8*)q, p->i, dims);
+      return;
+    case zfp_type_int16:
+      zfp_demote_int32_to_int16((int16*)q, p->i, dims);
+      return;
+    case zfp_type_uint16:
+      zfp_demote_int32_to_uint16((uint16*)q, p->i, dims);
+      return;
+    default:
+      return;
+  }
+}
+
+/* locate block in raster order; return offset in values of its first value */
+static ptrdiff_t
+locate_block_converted(const zfp_field* field, size_t block, size_t x0[4], uint n[4], ptrdiff_t s[4])
+{
+  size_t size[4];
+  int stride[4] = { 1, 1, 1, 1 };
+  ptrdiff_t offset = 0;
+  uint d;
+
+  size[0] = MAX(field->nx, 1u);
+  size[1] = MAX(field->ny, 1u);
+  size[2] = MAX(field->nz, 1u);
+  size[3] = MAX(field->nw, 1u);
+  zfp_field_stride(field, stride);
+  for (d = 0; d < 4; d++) {
+    size_t m = (size[d] + 3) / 4;
+    size_t x = 4 * (block % m);
+    block /= m;
+    x0[d] = x;
+    n[d] = (uint)MIN(size[d] - x, 4u);
+    s[d] = stride[d];
+    offset += s[d] * (ptrdiff_t)x;
+  }
+  return offset;
+}
+
+/* gather (scatter if not gather) n[0] x n[1] x n[2] x n[3] values of given
+   byte size between field at p with strides s and contiguous 4^4 block q;
+   when scattering, values not flagged in valid (unless NULL) are skipped */
+static void
+copy_block_converted(void* q, void* p, size_t size, const uint n[4], const ptrdiff_t s[4], zfp_bool gather, const uint8* valid)
+{
+  uint x, y, z, w;
+  for (w = 0; w < n[3]; w++)
+    for (z = 0; z < n[2]; z++)
+      for (y = 0; y < n[1]; y++)
+        for (x = 0; x < n[0]; x++) {
+          uint i = x + 4 * (y + 4 * (z + 4 * w));
+          ptrdiff_t o;
+          uint8* a;
+          uint8* b;
+          if (!gather && valid && !valid[i])
+            continue;
+          o = s[0] * (ptrdiff_t)x + s[1] * (ptrdiff_t)y + s[2] * (ptrdiff_t)z + s[3] * (ptrdiff_t)w;
+          a = (uint8*)q + size * i;
+          b = (uint8*)p + (ptrdiff_t)size * o;
+          /* constant sizes let memcpy compile to single moves */
+          if (!gather) {
+            uint8* c = a;
+            a = b;
+            b = c;
+          }
+          switch (size) {
+            case 1: memcpy(a, b, 1); break;
+            case 2: memcpy(a, b, 2); break;
+            case 4: memcpy(a, b, 4); break;
+            default: memcpy(a, b, 8); break;
+          }
+        }
+}
+
+/* compress contiguous block by the codec of given scalar type */
+static void
+encode_block_codec(zfp_stream* stream, convert_block* p, zfp_type type, uint dims, const uint n[4], zfp_bool partial)
+{
+  switch (type) {
+    case zfp_type_float:
+      if (!partial)
+        switch (dims) {
+          case 1: zfp_encode_block_float_1(stream, p->f); break;
+          case 2: zfp_encode_block_float_2(stream, p->f); break;
+          case 3: zfp_encode_block_float_3(stream, p->f); break;
+          case 4: zfp_encode_block_float_4(stream, p->f); break;
+        }
+      else
+        switch (dims) {
+          case 1: zfp_encode_partial_block_strided_float_1(stream, p->f, n[0], 1); break;
+          case 2: zfp_encode_partial_block_strided_float_2(stream, p->f, n[0], n[1], 1, 4); break;
+          case 3: zfp_encode_partial_block_strided_float_3(stream, p->f, n[0], n[1], n[2], 1, 4, 16); break;
+          case 4: zfp_encode_partial_block_strided_float_4(stream, p->f, n[0], n[1], n[2], n[3], 1, 4, 16, 64); break;
+        }
+      break;
+    case zfp_type_double:
+      if (!partial)
+        switch (dims) {
+          case 1: zfp_encode_block_double_1(stream, p->d); break;
+          case 2: zfp_encode_block_double_2(stream, p->d); break;
+          case 3: zfp_encode_block_double_3(stream, p->d); break;
+          case 4: zfp_encode_block_double_4(stream, p->d); break;
+        }
+      else
+        switch (dims) {
+          case 1: zfp_encode_partial_block_strided_double_1(stream, p->d, n[0], 1); break;
+          case 2: zfp_encode_partial_block_strided_double_2(stream, p->d, n[0], n[1], 1, 4); break;
+          case 3: zfp_encode_partial_block_strided_double_3(stream, p->d, n[0], n[1], n[2], 1, 4, 16); break;
+          case 4: zfp_encode_partial_block_strided_double_4(stream, p->d, n[0], n[1], n[2], n[3], 1, 4, 16, 64); break;
+        }
+      break;
+    default:
+      if (!partial)
+        switch (dims) {
+          case 1: zfp_encode_block_int32_1(stream, p->i); break;
+          case 2: zfp_encode_block_int32_2(stream, p->i); break;
+          case 3: zfp_encode_block_int32_3(stream, p->i); break;
+          case 4: zfp_encode_block_int32_4(stream, p->i); break;
+        }
+      else
+        switch (dims) {
+          case 1: zfp_encode_partial_block_strided_int32_1(stream, p->i, n[0], 1); break;
+          case 2: zfp_encode_partial_block_strided_int32_2(stream, p->i, n[0], n[1], 1, 4); break;
+          case 3: zfp_encode_partial_block_strided_int32_3(stream, p->i, n[0], n[1], n[2], 1, 4, 16); break;
+          case 4: zfp_encode_partial_block_strided_int32_4(stream, p->i, n[0], n[1], n[2], n[3], 1, 4, 16, 64); break;
+        }
+      break;
+  }
+}
+
+/* decompress contiguous block by the codec of given scalar type */
+static void
+decode_block_codec(zfp_stream* stream, convert_block* p, zfp_type type, uint dims, const uint n[4], zfp_bool partial)
+{
+  switch (type) {
+    case zfp_type_float:
+      if (!partial)
+        switch (dims) {
+          case 1: zfp_decode_block_float_1(stream, p->f); break;
+          case 2: zfp_decode_block_float_2(stream, p->f); break;
+          case 3: zfp_decode_block_float_3(stream, p->f); break;
+          case 4: zfp_decode_block_float_4(stream, p->f); break;
+        }
+      else
+        switch (dims) {
+          case 1: zfp_decode_partial_block_strided_float_1(stream, p->f, n[0], 1); break;
+          case 2: zfp_decode_partial_block_strided_float_2(stream, p->f, n[0], n[1], 1, 4); break;
+          case 3: zfp_decode_partial_block_strided_float_3(stream, p->f, n[0], n[1], n[2], 1, 4, 16); break;
+          case 4: zfp_decode_partial_block_strided_float_4(stream, p->f, n[0], n[1], n[2], n[3], 1, 4, 16, 64); break;
+        }
+      break;
+    case zfp_type_double:
+      if (!partial)
+        switch (dims) {
+          case 1: zfp_decode_block_double_1(stream, p->d); break;
+          case 2: zfp_decode_block_double_2(stream, p->d); break;
+          case 3: zfp_decode_block_double_3(stream, p->d); break;
+          case 4: zfp_decode_block_double_4(stream, p->d); break;
+        }
+      else
+        switch (dims) {
+          case 1: zfp_decode_partial_block_strided_double_1(stream, p->d, n[0], 1); break;
+          case 2: zfp_decode_partial_block_strided_double_2(stream, p->d, n[0], n[1], 1, 4); break;
+          case 3: zfp_decode_partial_block_strided_double_3(stream, p->d, n[0], n[1], n[2], 1, 4, 16); break;
+          case 4: zfp_decode_partial_block_strided_double_4(stream, p->d, n[0], n[1], n[2], n[3], 1, 4, 16, 64); break;
+        }
+      break;
+    default:
+      if (!partial)
+        switch (dims) {
+          case 1: zfp_decode_block_int32_1(stream, p->i); break;
+          case 2: zfp_decode_block_int32_2(stream, p->i); break;
+          case 3: zfp_decode_block_int32_3(stream, p->i); break;
+          case 4: zfp_decode_block_int32_4(stream, p->i); break;
+        }
+      else
+        switch (dims) {
+          case 1: zfp_decode_partial_block_strided_int32_1(stream, p->i, n[0], 1); break;
+          case 2: zfp_decode_partial_block_strided_int32_2(stream, p->i, n[0], n[1], 1, 4); break;
+          case 3: zfp_decode_partial_block_strided_int32_3(stream, p->i, n[0], n[1], n[2], 1, 4, 16); break;
+          case 4: zfp_decode_partial_block_strided_int32_4(stream, p->i, n[0], n[1], n[2], n[3], 1, 4, 16, 64); break;
+        }
+      break;
+  }
+}
+
+/* number of bits of per-block validity flags, which are stored only when
+   invalid values are identified by fill value alone */
+static uint
+mask_flag_bits(const zfp_field* field, uint dims)
+{
+  return field->has_fill && !field->mask ? 2 + (1u << (2 * dims)) : 0;
+}
+
+/* true if masked field can be coded by the codec of given scalar type */
+static zfp_bool
+is_maskable(const zfp_stream* stream, const zfp_field* field, zfp_type type)
+{
+  uint dims = zfp_field_dimensionality(field);
+  uint ebits;
+
+  /* only floating-point values are masked */
+  switch (type) {
+    case zfp_type_float:
+      ebits = 8;
+      break;
+    case zfp_type_double:
+      ebits = 11;
+      break;
+    default:
+      return zfp_false;
+  }
+
+  /* flags must leave room for the common exponent of valid values */
+  return dims && stream->maxbits >= mask_flag_bits(field, dims) + 1 + ebits;
+}
+
+/* true if stream parameters can be coarsened by a block map, which
+   requires lossy blocks of variable size */
+static zfp_bool
+is_mappable(const zfp_stream* stream)
+{
+  return stream->minbits < stream->maxbits && stream->minexp >= ZFP_MIN_EXP;
+}
+
+/* stream whose parameters are coarsened by as many bit planes as the block
+   map of the stream assigns to block */
+static zfp_stream*
+map_block_converted(zfp_stream* coarse, zfp_stream* stream, size_t block)
+{
+  uint level = stream->map ? stream->map[block] : 0;
+  if (!level)
+    return stream;
+  *coarse = *stream;
+  coarse->maxprec = stream->maxprec > level ? stream->maxprec - level : 0;
+  coarse->minexp = stream->minexp + (int)level;
+  return coarse;
+}
+
+/* true if value at index i of contiguous block lies within n[0] x ... x n[3] */
+static zfp_bool
+inside_block_masked(uint i, const uint n[4])
+{
+  return (i & 3u) < n[0] && ((i >> 2) & 3u) < n[1] && ((i >> 4) & 3u) < n[2] && (i >> 6) < n[3];
+}
+
+/* true if stream can code blocks of given codec type with an error tolerance
+   relative to the smallest nonzero magnitude in each block */
+static zfp_bool
+is_relative(const zfp_stream* stream, zfp_type type)
+{
+  return (type == zfp_type_float || type == zfp_type_double) && is_mappable(stream);
+}
+
+/* number of bits of per-block precision stored in relative accuracy mode */
+static uint
+relative_bits(zfp_type type)
+{
+  return type == zfp_type_float ? 6 : 7;
+}
+
+/* precision needed to bound the error in each nonzero value of block by
+   2^minexp times its magnitude */
+static uint
+relative_precision_block(const zfp_stream* stream, const convert_block* p, zfp_type type, uint dims, const uint n[4])
+{
+  uint intprec = type == zfp_type_float ? 32 : 64;
+  double amin = 0;
+  double amax = 0;
+  int emin, emax, prec;
+  uint i;
+
+  for (i = 0; i < (1u << (2 * dims)); i++)
+    if (inside_block_masked(i, n)) {
+      double a = fabs(type == zfp_type_float ? (double)p->f[i] : p->d[i]);
+      /* zeros and non-finite values do not constrain the tolerance */
+      if (a > 0 && a <= DBL_MAX) {
+        amin = amin > 0 ? MIN(amin, a) : a;
+        amax = MAX(amax, a);
+      }
+    }
+  if (!(amax > 0))
+    return 0;
+
+  /* amin >= 2^(emin-1), so an absolute tolerance of 2^(emin-1+minexp) suffices */
+  frexp(amin, &emin);
+  frexp(amax, &emax);
+  prec = emax - (emin - 1 + stream->minexp) + 2 * ((int)dims + 1);
+  return (uint)MAX(0, MIN(prec, (int)MIN(stream->maxprec, intprec)));
+}
+
+/* stream that codes the remainder of a block in relative accuracy mode with
+   the given precision stored in its first bits */
+static zfp_stream*
+relative_block_converted(zfp_stream* fine, const zfp_stream* stream, zfp_type type, uint prec)
+{
+  uint bits = relative_bits(type);
+  *fine = *stream;
+  fine->minbits = stream->minbits > bits ? stream->minbits - bits : 0;
+  fine->maxbits = stream->maxbits - bits;
+  fine->maxprec = prec;
+  fine->minexp = ZFP_MIN_EXP;
+  return fine;
+}
+
+/* flag valid values of block with origin x0, by mask if present and else by
+   comparing values p with the fill value; return number of valid values */
+static uint
+validate_block_masked(uint8* valid, const zfp_field* field, const convert_block* p, zfp_type type, const size_t x0[4], const uint n[4])
+{
+  size_t nx = MAX(field->nx, 1u);
+  size_t ny = MAX(field->ny, 1u);
+  size_t nz = MAX(field->nz, 1u);
+  uint count = 0;
+  uint x, y, z, w;
+
+  memset(valid, 0, 256);
+  for (w = 0; w < n[3]; w++)
+    for (z = 0; z < n[2]; z++)
+      for (y = 0; y < n[1]; y++)
+        for (x = 0; x < n[0]; x++) {
+          uint i = x + 4 * (y + 4 * (z + 4 * w));
+          if (field->mask)
+            valid[i] = field->mask[x0[0] + x + nx * (x0[1] + y + ny * (x0[2] + z + nz * (x0[3] + w)))] != 0;
+          else {
+            double v = type == zfp_type_float ? (double)p->f[i] : p->d[i];
+            /* a NaN fill value matches any NaN */
+            valid[i] = field->fill == field->fill ? v != field->fill : v == v;
+          }
+          count += valid[i];
+        }
+  return count;
+}
+
+/* mean of valid values of block */
+static double
+mean_block_masked(const convert_block* p, zfp_type type, const uint8* valid)
+{
+  double sum = 0;
+  uint count = 0;
+  uint i;
+  for (i = 0; i < 256; i++)
+    if (valid[i]) {
+      sum += type == zfp_type_float ? (double)p->f[i] : p->d[i];
+      count++;
+    }
+  return count ? sum / count : 0;
+}
+
+/* set invalid values within n[0] x ... x n[3] block to given value */
+static void
+fill_block_masked(convert_block* p, zfp_type type, const uint8* valid, const uint n[4], double value)
+{
+  uint i;
+  for (i = 0; i < 256; i++)
+    if (!valid[i] && inside_block_masked(i, n)) {
+      if (type == zfp_type_float)
+        p->f[i] = (float)value;
+      else
+        p->d[i] = value;
+    }
+}
+
+/* compress block with origin x0 whose invalid values are identified by mask
+   or fill value; blocks without valid values are not transformed or coded */
+static void
+encode_block_masked(zfp_stream* stream, const zfp_field* field, convert_block* p, zfp_type type, uint dims, const size_t x0[4], const uint n[4], zfp_bool partial)
+{
+  uint8 valid[256];
+  uint values = 1u << (2 * dims);
+  uint count = validate_block_masked(valid, field, p, type, x0, n);
+  uint m = n[0] * n[1] * n[2] * n[3];
+  uint bits = 0;
+  zfp_stream s = *stream;
+  uint i;
+
+  /* without mask, flag blocks as empty (0), full (10), or partially valid (11) */
+  if (!field->mask) {
+    stream_write_bit(stream->stream, count != 0);
+    bits++;
+    if (count) {
+      stream_write_bit(stream->stream, count < m);
+      bits++;
+      if (count < m) {
+        for (i = 0; i < values; i++)
+          stream_write_bit(stream->stream, valid[i]);
+        bits += values;
+      }
+    }
+  }
+
+  /* empty block is padded to the minimum block size only */
+  if (!count) {
+    if (stream->minbits > bits)
+      stream_pad(stream->stream, stream->minbits - bits);
+    return;
+  }
+
+  /* replace invalid values with a smooth value that costs few bits */
+  if (count < m)
+    fill_block_masked(p, type, valid, n, mean_block_masked(p, type, valid));
+
+  /* code block within what remains of the bit budget */
+  s.minbits = stream->minbits > bits ? stream->minbits - bits : 0;
+  s.maxbits = stream->maxbits - bits;
+  encode_block_codec(&s, p, type, dims, n, partial);
+}
+
+/* decompress block with origin x0 and flag its valid values; return number
+   of valid values */
+static uint
+decode_block_masked(zfp_stream* stream, const zfp_field* field, convert_block* p, uint8* valid, zfp_type type, uint dims, const size_t x0[4], const uint n[4], zfp_bool partial)
+{
+  uint values = 1u << (2 * dims);
+  uint count;
+  uint bits = 0;
+  zfp_stream s = *stream;
+  uint i;
+
+  if (field->mask)
+    count = validate_block_masked(valid, field, NULL, type, x0, n);
+  else {
+    memset(valid, 0, 256);
+    count = 0;
+    bits++;
+    if (stream_read_bit(stream->stream)) {
+      bits++;
+      if (stream_read_bit(stream->stream)) {
+        for (i = 0; i < values; i++)
+          count += valid[i] = (uint8)stream_read_bit(stream->stream);
+        bits += values;
+      }
+      else
+        for (i = 0; i < values; i++)
+          if (inside_block_masked(i, n)) {
+            valid[i] = 1;
+            count++;
+          }
+    }
+  }
+
+  /* skip padding of empty block */
+  if (!count) {
+    if (stream->minbits > bits)
+      stream_skip(stream->stream, stream->minbits - bits);
+    return 0;
+  }
+
+  s.minbits = stream->minbits > bits ? stream->minbits - bits : 0;
+  s.maxbits = stream->maxbits - bits;
+  decode_block_codec(&s, p, type, dims, n, partial);
+  return count;
+}
+
+/* compress block of field values by the codec of given scalar type */
+static void
+encode_block_converted(zfp_stream* stream, const zfp_field* field, zfp_type type, size_t block)
+{
+  uint64 vblock[256];
+  convert_block cblock;
+  zfp_stream coarse;
+  zfp_stream fine;
+  size_t x0[4];
+  uint n[4];
+  ptrdiff_t s[4];
+  size_t size = zfp_type_size(field->type);
+  ptrdiff_t offset = locate_block_converted(field, block, x0, n, s);
+  uint dims = zfp_field_dimensionality(field);
+  zfp_bool partial = n[0] * n[1] * n[2] * n[3] < (1u << (2 * dims));
+
+  stream = map_block_converted(&coarse, stream, block);
+
+  /* gather block into contiguous 4x4x4x4 layout; padding is done by codec */
+  if (partial)
+    memset(vblock, 0, sizeof(vblock));
+  copy_block_converted(vblock, (uint8*)field->data + offset * (ptrdiff_t)size, size, n, s, zfp_true, NULL);
+  cast_block_converted(&cblock, vblock, dims, field->type, type, stream->isa);
+
+  if (stream->relative) {
+    uint prec = relative_precision_block(stream, &cblock, type, dims, n);
+    stream_write_bits(stream->stream, prec, relative_bits(type));
+    stream = relative_block_converted(&fine, stream, type, prec);
+  }
+
+  if (is_masked(field))
+    encode_block_masked(stream, field, &cblock, type, dims, x0, n, partial);
+  else
+    encode_block_codec(stream, &cblock, type, dims, n, partial);
+}
+
+/* decompress block by the codec of given scalar type to field values */
+static void
+decode_block_converted(zfp_stream* stream, zfp_field* field, zfp_type type, size_t block)
+{
+  uint64 vblock[256];
+  convert_block cblock;
+  uint8 valid[256];
+  zfp_stream coarse;
+  zfp_stream fine;
+  size_t x0[4];
+  uint n[4];
+  ptrdiff_t s[4];
+  size_t size = zfp_type_size(field->type);
+  ptrdiff_t offset = locate_block_converted(field, block, x0, n, s);
+  uint dims = zfp_field_dimensionality(field);
+  zfp_bool partial = n[0] * n[1] * n[2] * n[3] < (1u << (2 * dims));
+
+  stream = map_block_converted(&coarse, stream, block);
+
+  /* values outside the field are never stored */
+  if (partial)
+    memset(&cblock, 0, sizeof(cblock));
+
+  if (stream->relative) {
+    uint prec = (uint)stream_read_bits(stream->stream, relative_bits(type));
+    stream = relative_block_converted(&fine, stream, type, prec);
+  }
+
+  if (!is_masked(field))
+    decode_block_codec(stream, &cblock, type, dims, n, partial);
+  else if (!decode_block_masked(stream, field, &cblock, valid, type, dims, x0, n, partial) && !field->has_fill)
+    return;
+  else if (field->has_fill)
+    /* invalid values are set to the fill value; otherwise they are left intact */
+    fill_block_masked(&cblock, type, valid, n, field->fill);
+
+  /* scatter block from contiguous 4x4x4x4 layout */
+  uncast_block_converted(vblock, &cblock, dims, field->type, type, stream->isa);
+  copy_block_converted(vblock, (uint8*)field->data + offset * (ptrdiff_t)size, size, n, s, zfp_false, is_masked(field) && !field->has_fill ? valid : NULL);
+}
+
+
+/* number of blocks in field */
+static size_t
+blocks_converted(const zfp_field* field)
+{
+  size_t mx = (MAX(field->nx, 1u) + 3) / 4;
+  size_t my = (MAX(field->ny, 1u) + 3) / 4;
+  size_t mz = (MAX(field->nz, 1u) + 3) / 4;
+  size_t mw = (MAX(field->nw, 1u) + 3) / 4;
+  return mx * my * mz * mw;
+}
+
+/* compress field to stream of given scalar type one block at a time */
+static void
+compress_converted(zfp_stream* stream, const zfp_field* field, zfp_type type)
+{
+  size_t blocks = blocks_converted(field);
+  size_t block;
+  for (block = 0; block < blocks; block++)
+    encode_block_converted(stream, field, type, block);
+}
+
+/* decompress stream of given scalar type to field one block at a time */
+static void
+decompress_converted(zfp_stream* stream, zfp_field* field, zfp_type type)
+{
+  size_t blocks = blocks_converted(field);
+  size_t block;
+  for (block = 0; block < blocks; block++)
+    decode_block_converted(stream, field, type, block);
+}
+
+#ifdef _OPENMP
+/* compress field to stream of given scalar type in parallel */
+static void
+compress_converted_omp(zfp_stream* stream, const zfp_field* field, zfp_type type)
+{
+  /* number of omp threads, blocks, and chunks */
+  uint threads = thread_count_omp(stream);
+  size_t blocks = blocks_converted(field);
+  size_t chunks = chunk_count_omp(stream, blocks, threads);
+  int chunk; /* OpenMP 2.0 requires int loop counter */
+  schedule_omp schedule;
+  zfp_stream_stats* cs;
+
+  /* allocate per-thread streams */
+  bitstream** bs = compress_init_par(stream, field, chunks, blocks);
+
+  /* without them, e.g., under a host scratch limit, compress serially in place */
+  if (!bs) {
+    compress_converted(stream, field, type);
+    return;
+  }
+
+  /* allocate per-chunk statistics if requested */
+  cs = stats_init_par(stream, chunks);
+
+  /* compress chunks of blocks in parallel */
+  schedule = begin_parallel_omp(stream, threads);
+  #pragma omp parallel for num_threads(threads) SCHEDULE_OMP
+  for (chunk = 0; chunk < (int)chunks; chunk++) {
+    double start = start_timer_omp(stream);
+    /* determine range of block indices assigned to this thread */
+    size_t bmin = chunk_offset(blocks, chunks, chunk + 0);
+    size_t bmax = chunk_offset(blocks, chunks, chunk + 1);
+    size_t block;
+    /* set up thread-local bit stream */
+    zfp_stream s = *stream;
+    zfp_stream_set_bit_stream(&s, compress_chunk_par(stream, bs, chunk));
+    s.stats = stats_chunk_par(cs, chunk);
+    zfp_trace_begin("zfp:chunk");
+    count_blocks_omp(stream, bmax - bmin);
+    /* compress sequence of blocks (none if out of memory) */
+    for (block = bmin; block < bmax && s.stream; block++)
+      encode_block_converted(&s, field, type, block);
+    zfp_trace_end();
+    stop_timer_omp(stream, start);
+  }
+  end_parallel_omp(schedule);
+  stats_finish_par(stream, cs, chunks);
+
+  /* concatenate per-thread streams */
+  compress_finish_par(stream, bs, chunks, threads);
+}
+
+/* decompress stream of given scalar type to field in parallel */
+static void
+decompress_converted_omp(zfp_stream* stream, zfp_field* field, zfp_type type)
+{
+  /* number of omp threads, blocks, and chunks */
+  uint threads = thread_count_omp(stream);
+  size_t blocks = blocks_converted(field);
+  size_t chunks = decompress_chunk_count_omp(stream, blocks, threads);
+  int chunk; /* OpenMP 2.0 requires int loop counter */
+  zfp_stream_stats* cs;
+
+  /* allocate per-thread streams; decompress serially if blocks cannot be located */
+  bitstream** bs = chunks ? decompress_init_par(stream, chunks, blocks) : NULL;
+  if (!bs) {
+    decompress_converted(stream, field, type);
+    return;
+  }
+
+  /* allocate per-chunk statistics if requested */
+  cs = stats_init_par(stream, chunks);
+
+  /* decompress chunks of blocks in parallel */
+  #pragma omp parallel for num_threads(threads)
+  for (chunk = 0; chunk < (int)chunks; chunk++) {
+    /* determine range of block indices assigned to this thread */
+    size_t bmin = chunk_offset(blocks, chunks, chunk + 0);
+    size_t bmax = chunk_offset(blocks, chunks, chunk + 1);
+    size_t block;
+    /* set up thread-local bit stream */
+    zfp_stream s = *stream;
+    zfp_stream_set_bit_stream(&s, bs[chunk]);
+    s.stats = stats_chunk_par(cs, chunk);
+    zfp_trace_begin("zfp:chunk");
+    count_blocks_omp(stream, bmax - bmin);
+    for (block = bmin; block < bmax; block++)
+      decode_block_converted(&s, field, type, block);
+    zfp_trace_end();
+  }
+
+  stats_finish_par(stream, cs, chunks);
+
+  /* release per-thread streams and position stream at end of field */
+  decompress_finish_par(stream, bs, chunks, blocks);
+}
+#endif
+
+/* compress field to stream of given scalar type under current policy */
+static zfp_bool
+compress_field_converted(zfp_stream* stream, const zfp_field* field, zfp_type type)
+{
+  switch (stream->exec.policy) {
+    case zfp_exec_serial:
+      compress_converted(stream, field, type);
+      return zfp_true;
+#ifdef _OPENMP
+    case zfp_exec_omp:
+      compress_converted_omp(stream, field, type);
+      return zfp_true;
+#endif
+    default:
+      return zfp_false;
+  }
+}
+
+/* decompress stream of given scalar type to field under current policy */
+static zfp_bool
+decompress_field_converted(zfp_stream* stream, zfp_field* field, zfp_type type)
+{
+  switch (stream->exec.policy) {
+    case zfp_exec_serial:
+      decompress_converted(stream, field, type);
+      return zfp_true;
+#ifdef _OPENMP
+    case zfp_exec_omp:
+      decompress_converted_omp(stream, field, type);
+      return zfp_true;
+#endif
+    default:
+      return zfp_false;
+  }
+}
@@ -0,0 +1,250 @@
+/* lossless entropy coding of byte strings using canonical Huffman codes */
+
+#define ENTROPY_SYMBOLS 256
+/* longest code, which bounds the size of the decoding table */
+#define ENTROPY_MAX_LENGTH 12
+/* method byte followed by 4-bit code length per symbol */
+#define ENTROPY_HEADER_SIZE (1 + ENTROPY_SYMBOLS / 2)
+
+/* coding methods identified by the first byte of a coded string */
+#define ENTROPY_STORED 0
+#define ENTROPY_HUFFMAN 1
+
+/* Huffman tree node; leaves are sorted by weight, then internal nodes follow */
+typedef struct {
+  size_t weight; /* sum of symbol counts */
+  uint symbol;   /* symbol (leaves only) */
+  uint parent;   /* index of parent node */
+} entropy_node;
+
+static int
+compare_entropy_node(const void* a, const void* b)
+{
+  const entropy_node* x = (const entropy_node*)a;
+  const entropy_node* y = (const entropy_node*)b;
+  if (x->weight != y->weight)
+    return x->weight < y->weight ? -1 : +1;
+  return x->symbol < y->symbol ? -1 : +1;
+}
+
+/* upper bound on byte size of n coded bytes */
+static size_t
+entropy_maximum_size(size_t n)
+{
+  return 1 + n;
+}
+
+/* compute Huffman code lengths of at most ENTROPY_MAX_LENGTH bits */
+static void
+entropy_code_lengths(uchar* length, const size_t* count)
+{
+  entropy_node node[2 * ENTROPY_SYMBOLS - 1];
+  size_t weight[ENTROPY_SYMBOLS];
+  uint depth[2 * ENTROPY_SYMBOLS - 1];
+  uint leaves, nodes, i;
+  uint maxlength;
+
+  for (i = 0; i < ENTROPY_SYMBOLS; i++)
+    weight[i] = count[i];
+
+  do {
+    /* sort symbols that occur by weight */
+    leaves = 0;
+    for (i = 0; i < ENTROPY_SYMBOLS; i++) {
+      length[i] = 0;
+      if (weight[i]) {
+        node[leaves].weight = weight[i];
+        node[leaves].symbol = i;
+        leaves++;
+      }
+    }
+    if (leaves < 2) {
+      /* a lone symbol still needs a one-bit code */
+      if (leaves)
+        length[node[0].symbol] = 1;
+      return;
+    }
+    qsort(node, leaves, sizeof(*node), compare_entropy_node);
+
+    /* merge two lightest of sorted leaves and (nondecreasing) internal nodes */
+    {
+      uint leaf = 0;
+      uint internal = leaves;
+      for (nodes = leaves; nodes < 2 * leaves - 1; nodes++) {
+        uint k;
+        node[nodes].weight = 0;
+        for (k = 0; k < 2; k++) {
+          uint j = (leaf < leaves && (internal == nodes || node[leaf].weight <= node[internal].weight)) ? leaf++ : internal++;
+          node[nodes].weight += node[j].weight;
+          node[j].parent = nodes;
+        }
+      }
+    }
+
+    /* assign depths from root down */
+    depth[nodes - 1] = 0;
+    for (i = nodes - 1; i--;)
+      depth[i] = depth[node[i].parent] + 1;
+    maxlength = 0;
+    for (i = 0; i < leaves; i++) {
+      length[node[i].symbol] = (uchar)depth[i];
+      maxlength = MAX(maxlength, depth[i]);
+    }
+
+    /* flatten distribution until codes are short enough */
+    if (maxlength > ENTROPY_MAX_LENGTH)
+      for (i = 0; i < ENTROPY_SYMBOLS; i++)
+        if (weight[i])
+          weight[i] = (weight[i] >> 1) | 1u;
+  } while (maxlength > ENTROPY_MAX_LENGTH);
+}
+
+/* assign canonical codes, bit-reversed for least-significant-bit-first output */
+static void
+entropy_codes(uint* code, const uchar* length)
+{
+  uint count[ENTROPY_MAX_LENGTH + 1];
+  uint next[ENTROPY_MAX_LENGTH + 1];
+  uint c, i, l;
+
+  for (l = 0; l <= ENTROPY_MAX_LENGTH; l++)
+    count[l] = 0;
+  for (i = 0; i < ENTROPY_SYMBOLS; i++)
+    count[length[i]]++;
+  count[0] = 0;
+  for (c = 0, l = 1; l <= ENTROPY_MAX_LENGTH; l++) {
+    c = (c + count[l - 1]) << 1;
+    next[l] = c;
+  }
+  for (i = 0; i < ENTROPY_SYMBOLS; i++) {
+    uint r = 0;
+    l = length[i];
+    if (!l)
+      continue;
+    for (c = next[l]++; l--; c >>= 1)
+      r = (r << 1) + (c & 1u);
+    code[i] = r;
+  }
+}
+
+/* code n bytes into out, which holds entropy_maximum_size(n) bytes; return coded size */
+static size_t
+entropy_encode(uchar* out, const uchar* in, size_t n)
+{
+  size_t count[ENTROPY_SYMBOLS];
+  uchar length[ENTROPY_SYMBOLS];
+  uint code[ENTROPY_SYMBOLS];
+  size_t bits = 0;
+  size_t size, i;
+  uint64 buffer;
+  uint filled;
+  uchar* p;
+
+  for (i = 0; i < ENTROPY_SYMBOLS; i++)
+    count[i] = 0;
+  for (i = 0; i < n; i++)
+    count[in[i]]++;
+  entropy_code_lengths(length, count);
+  for (i = 0; i < ENTROPY_SYMBOLS; i++)
+    bits += count[i] * length[i];
+
+  /* store bytes as is unless coding them pays off */
+  size = ENTROPY_HEADER_SIZE + (bits + CHAR_BIT - 1) / CHAR_BIT;
+  if (size >= entropy_maximum_size(n)) {
+    out[0] = ENTROPY_STORED;
+    memcpy(out + 1, in, n);
+    return entropy_maximum_size(n);
+  }
+
+  out[0] = ENTROPY_HUFFMAN;
+  for (i = 0; i < ENTROPY_SYMBOLS; i += 2)
+    out[1 + i / 2] = (uchar)(length[i] + (length[i + 1] << 4));
+  entropy_codes(code, length);
+  p = out + ENTROPY_HEADER_SIZE;
+  buffer = 0;
+  filled = 0;
+  for (i = 0; i < n; i++) {
+    buffer += (uint64)code[in[i]] << filled;
+    filled += length[in[i]];
+    for (; filled >= CHAR_BIT; filled -= CHAR_BIT, buffer >>= CHAR_BIT)
+      *p++ = (uchar)buffer;
+  }
+  if (filled)
+    *p++ = (uchar)buffer;
+
+  return size;
+}
+
+/* decode n bytes from size coded bytes; return false if input is invalid */
+static zfp_bool
+entropy_decode(uchar* out, size_t n, const uchar* in, size_t size)
+{
+  uint16 table[1u << ENTROPY_MAX_LENGTH];
+  uchar length[ENTROPY_SYMBOLS];
+  uint code[ENTROPY_SYMBOLS];
+  const uchar* p;
+  const uchar* end;
+  size_t kraft = 0;
+  size_t bytes, i;
+  uint64 buffer;
+  uint filled;
+
+  if (!size)
+    return zfp_false;
+  switch (in[0]) {
+    case ENTROPY_STORED:
+      if (size != entropy_maximum_size(n))
+        return zfp_false;
+      memcpy(out, in + 1, n);
+      return zfp_true;
+    case ENTROPY_HUFFMAN:
+      break;
+    default:
+      return zfp_false;
+  }
+  if (size < ENTROPY_HEADER_SIZE)
+    return zfp_false;
+
+  /* code lengths must be in range and not oversubscribe the code space */
+  for (i = 0; i < ENTROPY_SYMBOLS; i++) {
+    length[i] = (uchar)((in[1 + i / 2] >> (i % 2 ? 4 : 0)) & 0xfu);
+    if (length[i] > ENTROPY_MAX_LENGTH)
+      return zfp_false;
+    if (length[i])
+      kraft += (size_t)1 << (ENTROPY_MAX_LENGTH - length[i]);
+  }
+  if (kraft > ((size_t)1 << ENTROPY_MAX_LENGTH))
+    return zfp_false;
+
+  /* table maps next ENTROPY_MAX_LENGTH bits to symbol and code length */
+  entropy_codes(code, length);
+  for (i = 0; i < (1u << ENTROPY_MAX_LENGTH); i++)
+    table[i] = 0;
+  for (i = 0; i < ENTROPY_SYMBOLS; i++)
+    if (length[i]) {
+      uint k;
+      for (k = code[i]; k < (1u << ENTROPY_MAX_LENGTH); k += 1u << length[i])
+        table[k] = (uint16)(i + ((uint)length[i] << 8));
+    }
+
+  /* read past end as zeros, then check that no more bits were consumed */
+  p = in + ENTROPY_HEADER_SIZE;
+  end = in + size;
+  bytes = 0;
+  buffer = 0;
+  filled = 0;
+  for (i = 0; i < n; i++) {
+    uint entry, l;
+    for (; filled < ENTROPY_MAX_LENGTH; filled += CHAR_BIT, bytes++)
+      buffer += (uint64)(p < end ? *p++ : 0) << filled;
+    entry = table[buffer & ((1u << ENTROPY_MAX_LENGTH) - 1)];
+    l = entry >> 8;
+    if (!l)
+      return zfp_false;
+    out[i] = (uchar)entry;
+    buffer >>= l;
+    filled -= l;
+  }
+
+  return bytes * CHAR_BIT - filled <= (size - ENTROPY_HEADER_SIZE) * CHAR_BIT;
+}
@@ -0,0 +1,119 @@
+/* framed streams of self-describing frames of consecutive blocks */
+
+/* whether stream and field support framed (de)compression */
+static zfp_bool
+is_framing_supported(const zfp_stream* zfp, const zfp_field* field, uint blocks)
+{
+  return blocks && is_plain_field(field) && block_maximum_bits(zfp, field) &&
+         (field_blocks(field) + blocks - 1) / blocks <= UINT_MAX;
+}
+
+/* compress field into frames of given number of blocks passed to sink */
+static size_t
+framed_compress(const zfp_stream* zfp, const zfp_field* field, uint blocks, zfp_frame_sink sink, void* context)
+{
+  /* function table [scalar type] */
+  uint (*ftable[4])(zfp_stream*, const zfp_field*, size_t) = {
+    compress_block_int32,
+    compress_block_int64,
+    compress_block_float,
+    compress_block_double,
+  };
+  size_t count = field_blocks(field);
+  size_t capacity = zfp_frame_maximum_size(zfp, field, blocks);
+  size_t bytes = 0;
+  size_t first;
+  uint sequence;
+  zfp_stream s;
+  void* buffer;
+
+  if (!capacity || !sink)
+    return 0;
+
+  /* frames are staged one at a time in a buffer of the largest frame size */
+  buffer = malloc(capacity);
+  if (!buffer)
+    return 0;
+  s = *zfp;
+  s.stats = NULL;
+  s.verify = NULL;
+  s.stream = stream_open(buffer, capacity);
+  if (!s.stream) {
+    free(buffer);
+    return 0;
+  }
+
+  /* each frame holds its sequence number, number of blocks, and index of
+     first block, followed by the blocks, so that it decodes on its own */
+  for (first = 0, sequence = 0; first < count; first += blocks, sequence++) {
+    size_t n = MIN((size_t)blocks, count - first);
+    size_t i, size;
+    stream_rewind(s.stream);
+    stream_write_bits(s.stream, sequence, 32);
+    stream_write_bits(s.stream, n, 32);
+    stream_write_bits(s.stream, first, 64);
+    for (i = 0; i < n; i++)
+      ftable[field->type - zfp_type_int32](&s, field, first + i);
+    stream_flush(s.stream);
+    size = stream_size(s.stream);
+    if (!sink(buffer, size, context)) {
+      bytes = 0;
+      break;
+    }
+    bytes += size;
+  }
+
+  stream_close(s.stream);
+  free(buffer);
+
+  return bytes;
+}
+
+/* decompress blocks of one frame; return number of blocks decoded */
+static size_t
+framed_decompress(const zfp_stream* zfp, zfp_field* field, const void* frame, size_t size, uint* sequence)
+{
+  /* function table [scalar type] */
+  uint (*ftable[4])(zfp_stream*, zfp_field*, size_t) = {
+    decompress_block_int32,
+    decompress_block_int64,
+    decompress_block_float,
+    decompress_block_double,
+  };
+  size_t count = field_blocks(field);
+  size_t first, n, i;
+  uint seq;
+  zfp_stream s;
+
+  if (!frame || size < ZFP_FRAME_HEADER_BITS / CHAR_BIT || size % (stream_word_bits / CHAR_BIT) || !is_framing_supported(zfp, field, 1))
+    return 0;
+
+  /* the frame is only read, though the bit stream API takes a mutable buffer */
+  s = *zfp;
+  s.stats = NULL;
+  s.verify = NULL;
+  s.stream = stream_open((void*)frame, size);
+  if (!s.stream)
+    return 0;
+
+  /* validate header before decoding any block */
+  seq = (uint)stream_read_bits(s.stream, 32);
+  n = (size_t)stream_read_bits(s.stream, 32);
+  first = (size_t)stream_read_bits(s.stream, 64);
+  if (!n || first >= count || n > count - first) {
+    stream_close(s.stream);
+    return 0;
+  }
+
+  for (i = 0; i < n && stream_rtell(s.stream) < (uint64)size * CHAR_BIT; i++)
+    ftable[field->type - zfp_type_int32](&s, field, first + i);
+  /* reject frames that were cut short */
+  if (i < n || stream_rtell(s.stream) > (uint64)size * CHAR_BIT)
+    n = 0;
+  stream_close(s.stream);
+
+  if (n && sequence)
+    *sequence = seq;
+
+  return n;
+}
@@ -0,0 +1,168 @@
+/* hybrid execution: one field split between a GPU and host OpenMP threads */
+
+#if defined(_OPENMP) && (defined(ZFP_WITH_CUDA) || defined(ZFP_WITH_HIP))
+#define ZFP_WITH_HYBRID 1
+
+#ifdef ZFP_WITH_CUDA
+  #define HYBRID_DEFAULT_DEVICE zfp_exec_cuda
+#else
+  #define HYBRID_DEFAULT_DEVICE zfp_exec_hip
+#endif
+
+/* bounds on calibrated fraction of blocks placed on device, so that both
+   sides keep enough work for their throughput to be measured */
+#define HYBRID_MIN_RATIO (1.0 / 16)
+#define HYBRID_MAX_RATIO (15.0 / 16)
+
+static zfp_bool compress_field_exec(zfp_stream* zfp, const zfp_field* field);
+static zfp_bool decompress_field_exec(zfp_stream* zfp, zfp_field* field);
+
+/* number of host threads; by default one core is left to drive the device */
+static uint
+thread_count_hybrid(const zfp_stream* stream)
+{
+  uint count = stream->exec.params.hybrid.threads;
+  if (!count)
+    count = MAX((uint)omp_get_max_threads(), 2u) - 1;
+  return count;
+}
+
+/* subfield made up of block layers [first, last) along slowest dimension */
+static void
+hybrid_slab(zfp_field* slab, const zfp_field* field, size_t first, size_t last)
+{
+  uint dims = zfp_field_dimensionality(field);
+  size_t size[4];
+  size_t n;
+  int stride[4];
+
+  size[0] = field->nx;
+  size[1] = field->ny;
+  size[2] = field->nz;
+  size[3] = field->nw;
+  n = MIN(4 * last, size[dims - 1]) - MIN(4 * first, size[dims - 1]);
+  zfp_field_stride(field, stride);
+
+  *slab = *field;
+  slab->data = (uchar*)field->data + (ptrdiff_t)(4 * first) * stride[dims - 1] * (ptrdiff_t)zfp_type_size(field->type);
+  switch (dims) {
+    case 1: slab->nx = n; break;
+    case 2: slab->ny = n; break;
+    case 3: slab->nz = n; break;
+    case 4: slab->nw = n; break;
+  }
+}
+
+/* number of leading block layers to (de)compress on device */
+static size_t
+hybrid_device_layers(const zfp_stream* zfp, size_t layers, size_t layer_blocks)
+{
+  /* the device slab must end on a word boundary so that the host slab can
+     be (de)compressed through a bit stream of its own */
+  size_t align = 1;
+  size_t count;
+  while ((uint64)align * layer_blocks * zfp->maxbits % stream_word_bits)
+    align++;
+  count = (size_t)(zfp->exec.params.hybrid.ratio * (double)layers / (double)align + 0.5) * align;
+  return MIN(count, layers);
+}
+
+/* (de)compress fixed-rate field with leading block layers on device and
+   remaining layers on host threads concurrently; return false if not
+   supported */
+static zfp_bool
+hybrid_exec(zfp_stream* zfp, const zfp_field* field, zfp_bool compress)
+{
+  zfp_exec_params_hybrid* params = &zfp->exec.params.hybrid;
+  uint dims = zfp_field_dimensionality(field);
+  size_t n[4];
+  size_t layers, layer_blocks, device_layers;
+  size_t count[2];
+  size_t offset, bytes;
+  uint i;
+  zfp_stream part[2];
+  zfp_field slab[2];
+  double time[2] = { 0, 0 };
+  zfp_bool success[2] = { zfp_true, zfp_true };
+  int levels, k;
+
+  /* the device (de)compresses from the beginning of the stream, and both
+     sides must agree on where the other's blocks are */
+  offset = compress ? stream_wtell(zfp->stream) : stream_rtell(zfp->stream);
+  if (zfp_stream_compression_mode(zfp) != zfp_mode_fixed_rate || zfp->verify || offset)
+    return zfp_false;
+
+  n[0] = field->nx;
+  n[1] = field->ny;
+  n[2] = field->nz;
+  n[3] = field->nw;
+  layers = (n[dims - 1] + 3) / 4;
+  layer_blocks = 1;
+  for (i = 0; i + 1 < dims; i++)
+    layer_blocks *= (n[i] + 3) / 4;
+  device_layers = hybrid_device_layers(zfp, layers, layer_blocks);
+  count[0] = device_layers;
+  count[1] = layers - device_layers;
+  bytes = (size_t)((uint64)device_layers * layer_blocks * zfp->maxbits / CHAR_BIT);
+  if (bytes > stream_capacity(zfp->stream))
+    return zfp_false;
+
+  /* device and host sides write disjoint regions of the same buffer */
+  hybrid_slab(&slab[0], field, 0, device_layers);
+  hybrid_slab(&slab[1], field, device_layers, layers);
+  for (k = 0; k < 2; k++) {
+    part[k] = *zfp;
+    part[k].index = NULL;
+    part[k].scratch = NULL;
+    part[k].stats = NULL;
+    memset(&part[k].exec.params, 0, sizeof(part[k].exec.params));
+  }
+  part[0].exec.policy = params->device;
+  part[0].stream = stream_open(stream_data(zfp->stream), bytes);
+  part[1].exec.policy = zfp_exec_omp;
+  part[1].exec.params.omp.threads = thread_count_hybrid(zfp);
+  part[1].stream = stream_open((uchar*)stream_data(zfp->stream) + bytes, stream_capacity(zfp->stream) - bytes);
+  if (!part[0].stream || !part[1].stream) {
+    stream_close(part[0].stream);
+    stream_close(part[1].stream);
+    return zfp_false;
+  }
+
+  /* one outer thread drives the device while the other leads host threads */
+  levels = omp_get_max_active_levels();
+  if (levels < 2)
+    omp_set_max_active_levels(2);
+  #pragma omp parallel for num_threads(2) schedule(static, 1)
+  for (k = 0; k < 2; k++)
+    if (count[k]) {
+      double start = omp_get_wtime();
+      success[k] = compress ? compress_field_exec(&part[k], &slab[k]) : decompress_field_exec(&part[k], &slab[k]);
+      if (compress)
+        stream_flush(part[k].stream);
+      time[k] = omp_get_wtime() - start;
+    }
+  omp_set_max_active_levels(levels);
+
+  for (k = 0; k < 2; k++)
+    stream_close(part[k].stream);
+  if (!success[0] || !success[1])
+    return zfp_false;
+
+  /* move split toward equal time spent on both sides */
+  if (params->calibrate && time[0] > 0 && time[1] > 0) {
+    double device_rate = (double)count[0] / time[0];
+    double host_rate = (double)count[1] / time[1];
+    double ratio = device_rate / (device_rate + host_rate);
+    params->ratio = MAX(HYBRID_MIN_RATIO, MIN(ratio, HYBRID_MAX_RATIO));
+  }
+
+  /* position stream at end of field */
+  if (compress)
+    stream_wseek(zfp->stream, (size_t)((uint64)layers * layer_blocks * zfp->maxbits));
+  else
+    stream_rseek(zfp->stream, (size_t)((uint64)layers * layer_blocks * zfp->maxbits));
+
+  return zfp_true;
+}
+
+#endif
@@ -0,0 +1,169 @@
+/* compression of interleaved 8-bit images with built-in color transform */
+
+/* offsets of pixels of 4x4 block at (x, y), replicating edge pixels of
+   partial blocks */
+static void
+image_offsets(size_t* offset, size_t nx, size_t ny, uint channels, size_t x, size_t y)
+{
+  uint i, j;
+  for (j = 0; j < 4; j++)
+    for (i = 0; i < 4; i++)
+      offset[i + 4 * j] = channels * (MIN(x + i, nx - 1) + nx * MIN(y + j, ny - 1));
+}
+
+/* gather 4x4 block of pixels as 32-bit integers, converting RGB to YCoCg */
+static void
+image_gather(int32 block[4][16], const uchar* pixels, const size_t* offset, uint channels)
+{
+  uint i, k;
+
+  /* promote 8-bit channels to 32-bit integers as in zfp_promote_uint8_to_int32 */
+  for (k = 0; k < channels; k++)
+    for (i = 0; i < 16; i++)
+      block[k][i] = ((int32)pixels[offset[i] + k] - 0x80) << 23;
+
+  /* perform range-preserving YCoCg forward transform, which is exact since
+     the promoted values are multiples of 2^23; the branch-free loop over
+     the block's 16 pixels is readily vectorized */
+  if (channels >= 3)
+    for (i = 0; i < 16; i++) {
+      int32 r = block[0][i];
+      int32 g = block[1][i];
+      int32 b = block[2][i];
+      int32 co = (r - b) >> 1;
+      int32 t = b + co;
+      int32 cg = (g - t) >> 1;
+      block[0][i] = t + cg;
+      block[1][i] = co;
+      block[2][i] = cg;
+    }
+}
+
+/* convert YCoCg to RGB and scatter in-bounds pixels of 4x4 block at (x, y) */
+static void
+image_scatter(uchar* pixels, const size_t* offset, uint channels, int32 block[4][16], size_t nx, size_t ny, size_t x, size_t y)
+{
+  uint i, j, k;
+
+  /* perform YCoCg inverse transform in 64-bit arithmetic to avoid overflow,
+     then clamp to the range that demotes to 8 bits */
+  if (channels >= 3)
+    for (i = 0; i < 16; i++) {
+      int64 luma = block[0][i];
+      int64 co = block[1][i];
+      int64 cg = block[2][i];
+      int64 t = luma - cg;
+      int64 g = 2 * cg + t;
+      int64 b = t - co;
+      int64 r = 2 * co + b;
+      block[0][i] = (int32)MAX(-0x40000000, MIN(r, 0x3fffffff));
+      block[1][i] = (int32)MAX(-0x40000000, MIN(g, 0x3fffffff));
+      block[2][i] = (int32)MAX(-0x40000000, MIN(b, 0x3fffffff));
+    }
+
+  /* demote to 8 bits as in zfp_demote_int32_to_uint8 and store pixels */
+  for (j = 0; j < 4; j++)
+    for (i = 0; i < 4; i++)
+      if (x + i < nx && y + j < ny)
+        for (k = 0; k < channels; k++) {
+          int32 v = (block[k][i + 4 * j] >> 23) + 0x80;
+          pixels[offset[i + 4 * j] + k] = (uchar)MAX(0x00, MIN(v, 0xff));
+        }
+}
+
+/* clamp values to 31-bit range */
+static void
+image_clamp(int32* block, uint n)
+{
+  uint i;
+  for (i = 0; i < n; i++)
+    block[i] = MAX(1 - (1 << 30), MIN(block[i], (1 << 30) - 1));
+}
+
+/* partial forward decorrelating transform of 4-vector with stride s */
+static void
+image_fwd_lift(int32* p, uint s)
+{
+  int32 x = p[0 * s];
+  int32 y = p[1 * s];
+  int32 z = p[2 * s];
+  int32 w = p[3 * s];
+
+  x += w; x >>= 1; w -= x;
+  z += y; z >>= 1; y -= z;
+  x += z; x >>= 1; z -= x;
+  w += y; w >>= 1; y -= w;
+  w += y >> 1; y -= w >> 1;
+
+  p[0 * s] = x;
+  p[1 * s] = y;
+  p[2 * s] = z;
+  p[3 * s] = w;
+}
+
+/* partial inverse decorrelating transform of 4-vector with stride s */
+static void
+image_inv_lift(int32* p, uint s)
+{
+  int32 x = p[0 * s];
+  int32 y = p[1 * s];
+  int32 z = p[2 * s];
+  int32 w = p[3 * s];
+
+  y += w >> 1; w -= y >> 1;
+  y += w; w <<= 1; w -= y;
+  z += x; x <<= 1; x -= z;
+  y += z; z <<= 1; z -= y;
+  w += x; x <<= 1; x -= w;
+
+  p[0 * s] = x;
+  p[1 * s] = y;
+  p[2 * s] = z;
+  p[3 * s] = w;
+}
+
+/* reduce 2D chroma block to the 1D block of its four lowest-sequency
+   coefficients, i.e., its bilinear approximation */
+static void
+image_chroma_downsample(int32* block)
+{
+  uint i;
+  for (i = 0; i < 4; i++)
+    image_fwd_lift(block + 4 * i, 1);
+  for (i = 0; i < 4; i++)
+    image_fwd_lift(block + 1 * i, 4);
+  block[2] = block[4];
+  block[3] = block[5];
+  image_inv_lift(block, 1);
+  image_clamp(block, 4);
+}
+
+/* reconstruct 2D chroma block from 1D block of four coefficients */
+static void
+image_chroma_upsample(int32* block)
+{
+  uint i;
+  image_fwd_lift(block, 1);
+  block[4] = block[2];
+  block[5] = block[3];
+  block[2] = 0;
+  block[3] = 0;
+  for (i = 6; i < 16; i++)
+    block[i] = 0;
+  for (i = 0; i < 4; i++)
+    image_inv_lift(block + 1 * i, 4);
+  for (i = 0; i < 4; i++)
+    image_inv_lift(block + 4 * i, 1);
+  image_clamp(block, 16);
+}
+
+/* limit stream to a quarter of the bits per block for 1D chroma blocks,
+   i.e., to the same rate in bits/value */
+static void
+image_chroma_params(zfp_stream* chroma, const zfp_stream* zfp)
+{
+  *chroma = *zfp;
+  chroma->minbits = (zfp->minbits + 3) / 4;
+  if (zfp->maxbits < ZFP_MAX_BITS)
+    chroma->maxbits = MAX((zfp->maxbits + 3) / 4, chroma->minbits);
+}
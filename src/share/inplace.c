@@ -0,0 +1,198 @@
+/* in-place (de)compression of a dense field within its own storage */
+
+static size_t field_blocks(const zfp_field* field);
+static zfp_bool compress_field(zfp_stream* zfp, const zfp_field* field);
+static zfp_bool decompress_field(zfp_stream* zfp, zfp_field* field);
+
+/* minimum number of values per slab of in-place (de)compression */
+#define INPLACE_SLAB_VALUES 0x1000
+
+/* partition of field into slabs of whole block rows for in-place coding */
+typedef struct {
+  size_t planes;   /* extent of slowest varying dimension */
+  size_t plane;    /* values per hyperplane orthogonal to that dimension */
+  size_t depth;    /* hyperplanes per slab, a multiple of four */
+  size_t slabs;    /* number of slabs */
+  uint maxbits;    /* largest block size that keeps output behind input */
+} inplace_plan;
+
+/* slab of plan with given index and its values at data */
+static zfp_field
+inplace_slab(const zfp_field* field, const inplace_plan* plan, size_t index, void* data)
+{
+  zfp_field slab = *field;
+  size_t planes = MIN(plan->planes - index * plan->depth, plan->depth);
+  slab.data = data;
+  slab.sx = slab.sy = slab.sz = slab.sw = 0;
+  switch (zfp_field_dimensionality(field)) {
+    case 1:
+      slab.nx = planes;
+      break;
+    case 2:
+      slab.ny = planes;
+      break;
+    case 3:
+      slab.nz = planes;
+      break;
+    case 4:
+      slab.nw = planes;
+      break;
+  }
+  return slab;
+}
+
+/* largest block size such that a slab of compressed blocks, plus slack */
+/* for word-granular stream access, fits in the storage of the slab */
+static uint
+inplace_maxbits(const zfp_field* slab)
+{
+  size_t bits = zfp_field_size(slab, NULL) * type_precision(slab->type);
+  size_t slack = 3 * stream_word_bits;
+  size_t maxbits = bits > slack ? (bits - slack) / field_blocks(slab) : 0;
+  return (uint)MIN(maxbits, ZFP_MAX_BITS);
+}
+
+/* plan in-place (de)compression of field stored in bit stream of zfp */
+static zfp_bool
+inplace_plan_field(inplace_plan* plan, const zfp_stream* zfp, const zfp_field* field)
+{
+  zfp_field slab;
+
+  /* the bit stream must begin at the first value of a dense host field */
+  switch (zfp->exec.policy) {
+    case zfp_exec_serial:
+    case zfp_exec_omp:
+    case zfp_exec_threads:
+      break;
+    default:
+      return zfp_false;
+  }
+  if (!is_plain_field(field) || !is_row_major(field) || stream_data(zfp->stream) != field->data)
+    return zfp_false;
+
+  /* slabs are a multiple of four hyperplanes along slowest dimension */
+  switch (zfp_field_dimensionality(field)) {
+    case 1:
+      plan->planes = field->nx;
+      plan->plane = 1;
+      break;
+    case 2:
+      plan->planes = field->ny;
+      plan->plane = field->nx;
+      break;
+    case 3:
+      plan->planes = field->nz;
+      plan->plane = field->nx * field->ny;
+      break;
+    case 4:
+      plan->planes = field->nw;
+      plan->plane = field->nx * field->ny * field->nz;
+      break;
+    default:
+      return zfp_false;
+  }
+  plan->depth = 4 * ((INPLACE_SLAB_VALUES + 4 * plan->plane - 1) / (4 * plan->plane));
+  plan->slabs = (plan->planes + plan->depth - 1) / plan->depth;
+
+  /* cap block size by that of both full and last slab */
+  slab = inplace_slab(field, plan, plan->slabs - 1, NULL);
+  plan->maxbits = inplace_maxbits(&slab);
+  if (plan->slabs > 1) {
+    slab = inplace_slab(field, plan, 0, NULL);
+    plan->maxbits = MIN(plan->maxbits, inplace_maxbits(&slab));
+  }
+
+  /* blocks of fixed or minimum size must not exceed cap */
+  return plan->maxbits && zfp->minbits <= plan->maxbits;
+}
+
+/* compress field slab by slab into its own storage */
+static size_t
+inplace_compress(zfp_stream* zfp, const zfp_field* field)
+{
+  zfp_index* index = zfp->index;
+  uint maxbits = zfp->maxbits;
+  size_t size = zfp_type_size(field->type);
+  size_t word = stream_word_bits / CHAR_BIT;
+  inplace_plan plan;
+  void* lookahead;
+  size_t i;
+
+  /* stream must span storage of field, less any partial word */
+  if (!inplace_plan_field(&plan, zfp, field) || stream_wtell(zfp->stream) || stream_capacity(zfp->stream) < zfp_field_size(field, NULL) * size / word * word)
+    return 0;
+  lookahead = malloc(plan.depth * plan.plane * size);
+  if (!lookahead)
+    return 0;
+
+  /* each slab is copied before any compressed bits reach it */
+  zfp->maxbits = MIN(maxbits, plan.maxbits);
+  zfp->index = NULL;
+  for (i = 0; i < plan.slabs; i++) {
+    zfp_field slab = inplace_slab(field, &plan, i, lookahead);
+    memcpy(lookahead, (const uchar*)field->data + i * plan.depth * plan.plane * size, zfp_field_size(&slab, NULL) * size);
+    if (!compress_field(zfp, &slab))
+      break;
+  }
+  zfp->maxbits = maxbits;
+  zfp->index = index;
+  if (index)
+    index->chunks = 0;
+  free(lookahead);
+  if (i < plan.slabs)
+    return 0;
+  stream_flush(zfp->stream);
+
+  return stream_size(zfp->stream);
+}
+
+/* decompress field slab by slab from stream held in its storage */
+static size_t
+inplace_decompress(zfp_stream* zfp, zfp_field* field)
+{
+  bitstream* stream = zfp->stream;
+  zfp_index* index = zfp->index;
+  uint maxbits = zfp->maxbits;
+  size_t size = zfp_type_size(field->type);
+  size_t bytes = zfp_field_size(field, NULL) * size;
+  size_t csize = stream_capacity(stream);
+  size_t word = stream_word_bits / CHAR_BIT;
+  size_t offset = (bytes - MIN(csize, bytes)) / word * word;
+  stream_storage storage;
+  inplace_plan plan;
+  void* lookahead;
+  uchar* data;
+  size_t i;
+
+  if (!inplace_plan_field(&plan, zfp, field) || stream_rtell(stream) || csize > bytes)
+    return 0;
+  lookahead = malloc(plan.depth * plan.plane * size);
+  if (!lookahead)
+    return 0;
+
+  /* move compressed stream to end of storage and decode it from there */
+  data = (uchar*)field->data;
+  memmove(data + offset, data, csize);
+  zfp->stream = stream_init(&storage, data + offset, csize);
+  zfp->maxbits = MIN(maxbits, plan.maxbits);
+  zfp->index = NULL;
+  for (i = 0; i < plan.slabs; i++) {
+    zfp_field slab = inplace_slab(field, &plan, i, lookahead);
+    size_t begin = i * plan.depth * plan.plane * size;
+    size_t end = begin + zfp_field_size(&slab, NULL) * size;
+    if (!decompress_field(zfp, &slab))
+      break;
+    /* values of all but last slab may overwrite only words already read */
+    if (i + 1 < plan.slabs && end > offset + stream_rtell(zfp->stream) / stream_word_bits * word)
+      break;
+    memcpy(data + begin, lookahead, end - begin);
+  }
+  stream_rseek(stream, stream_rtell(zfp->stream));
+  stream_align(stream);
+  zfp->stream = stream;
+  zfp->maxbits = maxbits;
+  zfp->index = index;
+  free(lookahead);
+
+  return i < plan.slabs ? 0 : stream_size(stream);
+}
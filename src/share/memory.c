@@ -0,0 +1,98 @@
+#ifdef ZFP_WITH_THREADS
+  #include <pthread.h>
+#endif
+
+/* operations on memory pool */
+typedef enum {
+  memory_op_query   = 0, /* report usage */
+  memory_op_acquire = 1, /* add bytes unless limit would be exceeded */
+  memory_op_charge  = 2, /* add bytes */
+  memory_op_release = 3, /* subtract bytes */
+  memory_op_limit   = 4, /* set limit to bytes */
+  memory_op_reset   = 5  /* set peak to current bytes */
+} memory_op;
+
+/* byte counts of each pool, guarded by memory_update() */
+static zfp_memory_usage memory_usage[ZFP_MEMORY_POOLS];
+
+#ifdef ZFP_WITH_THREADS
+static pthread_mutex_t memory_mutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+/* apply operation to byte counts u and copy result to usage; return success */
+static zfp_bool
+memory_apply(zfp_memory_usage* u, memory_op op, size_t bytes, zfp_memory_usage* usage)
+{
+  zfp_bool success = zfp_true;
+  switch (op) {
+    case memory_op_acquire:
+      if (u->limit && (bytes > u->limit || u->current > u->limit - bytes)) {
+        success = zfp_false;
+        break;
+      }
+      /* FALLTHROUGH */
+    case memory_op_charge:
+      u->current += bytes;
+      u->peak = MAX(u->peak, u->current);
+      break;
+    case memory_op_release:
+      u->current -= MIN(u->current, bytes);
+      break;
+    case memory_op_limit:
+      u->limit = bytes;
+      break;
+    case memory_op_reset:
+      u->peak = u->current;
+      break;
+    default:
+      break;
+  }
+  if (usage)
+    *usage = *u;
+  return success;
+}
+
+/* atomically apply operation to pool; return false if not done */
+static zfp_bool
+memory_update(zfp_memory_pool pool, memory_op op, size_t bytes, zfp_memory_usage* usage)
+{
+  zfp_bool success;
+  if ((uint)pool >= ZFP_MEMORY_POOLS) {
+    if (usage)
+      memset(usage, 0, sizeof(*usage));
+    return zfp_false;
+  }
+#if defined(ZFP_WITH_THREADS)
+  pthread_mutex_lock(&memory_mutex);
+  success = memory_apply(memory_usage + pool, op, bytes, usage);
+  pthread_mutex_unlock(&memory_mutex);
+#elif defined(_OPENMP)
+  #pragma omp critical(zfp_memory)
+  success = memory_apply(memory_usage + pool, op, bytes, usage);
+#else
+  success = memory_apply(memory_usage + pool, op, bytes, usage);
+#endif
+  return success;
+}
+
+#if defined(_OPENMP) || defined(ZFP_WITH_THREADS)
+/* allocate size bytes accounted to pool (NULL if over its limit or out of memory) */
+static void*
+memory_malloc(zfp_memory_pool pool, size_t size)
+{
+  void* ptr = NULL;
+  if (memory_update(pool, memory_op_acquire, size, NULL) && !(ptr = malloc(size)))
+    memory_update(pool, memory_op_release, size, NULL);
+  return ptr;
+}
+
+/* deallocate size bytes at ptr obtained from memory_malloc() */
+static void
+memory_free(zfp_memory_pool pool, void* ptr, size_t size)
+{
+  if (ptr) {
+    free(ptr);
+    memory_update(pool, memory_op_release, size, NULL);
+  }
+}
+#endif
@@ -0,0 +1,154 @@
+/* Morton (Z-order) sorting of points given by coordinate fields */
+
+/* bits per radix sort digit */
+#define MORTON_DIGIT_BITS 8
+#define MORTON_DIGITS (1u << MORTON_DIGIT_BITS)
+
+/* value i of 1D floating-point field as double */
+static double
+morton_coordinate(const zfp_field* field, size_t i)
+{
+  ptrdiff_t offset = (ptrdiff_t)i * (field->sx ? field->sx : 1);
+  if (field->type == zfp_type_float)
+    return (double)((const float*)field->data)[offset];
+  return ((const double*)field->data)[offset];
+}
+
+/* interleave bits of coordinates quantized to the bounding box into keys */
+static void
+morton_keys(uint64* key, const zfp_field* const* coord, uint dims, size_t n)
+{
+  /* bits per coordinate, so that keys fit in 64 bits */
+  const uint bits = MIN(64 / dims, 32u);
+  const double levels = (double)(((uint64)1 << bits) - 1);
+  size_t i;
+  uint d;
+
+  for (i = 0; i < n; i++)
+    key[i] = 0;
+  for (d = 0; d < dims; d++) {
+    double min = HUGE_VAL;
+    double max = -HUGE_VAL;
+    double scale;
+    /* bounding box of finite coordinates */
+    for (i = 0; i < n; i++) {
+      double x = morton_coordinate(coord[d], i);
+      if (x - x == 0) {
+        min = MIN(min, x);
+        max = MAX(max, x);
+      }
+    }
+    scale = min < max ? levels / (max - min) : 0;
+    if (!(scale < HUGE_VAL))
+      scale = 0;
+    for (i = 0; i < n; i++) {
+      double x = morton_coordinate(coord[d], i);
+      /* NaNs sort with the smallest coordinates and infinities are clamped */
+      uint64 q = x > min ? (uint64)MIN((x - min) * scale, levels) : 0;
+      uint64 k = 0;
+      uint b;
+      for (b = 0; b < bits; b++)
+        k += ((q >> b) & 1u) << (b * dims + d);
+      key[i] += k;
+    }
+  }
+}
+
+/* stable least-significant-digit radix sort of keys along with their
+   indices, counting and scattering contiguous ranges of keys in parallel */
+static zfp_bool
+morton_sort(uint64* key, size_t* index, size_t n, uint threads)
+{
+  uint64* k = (uint64*)malloc(MAX(n, 1) * sizeof(uint64));
+  size_t* j = (size_t*)malloc(MAX(n, 1) * sizeof(size_t));
+  size_t* count = (size_t*)malloc((size_t)threads * MORTON_DIGITS * sizeof(size_t));
+  uint64* src_key = key;
+  size_t* src_index = index;
+  uint shift;
+
+  if (!k || !j || !count) {
+    free(k);
+    free(j);
+    free(count);
+    return zfp_false;
+  }
+
+  for (shift = 0; shift < 64; shift += MORTON_DIGIT_BITS) {
+    uint64* dst_key = src_key == key ? k : key;
+    size_t* dst_index = src_index == index ? j : index;
+    size_t sum = 0;
+    int t; /* OpenMP 2.0 requires int loop counter */
+    uint d;
+
+    /* count digits of each range of keys */
+#ifdef _OPENMP
+    #pragma omp parallel for num_threads(threads)
+#endif
+    for (t = 0; t < (int)threads; t++) {
+      size_t* c = count + (size_t)t * MORTON_DIGITS;
+      size_t begin = (size_t)(((uint64)n * (uint64)t) / threads);
+      size_t end = (size_t)(((uint64)n * (uint64)(t + 1)) / threads);
+      size_t i;
+      for (i = 0; i < MORTON_DIGITS; i++)
+        c[i] = 0;
+      for (i = begin; i < end; i++)
+        c[(src_key[i] >> shift) & (MORTON_DIGITS - 1)]++;
+    }
+
+    /* skip digit shared by all keys */
+    for (d = 0; d < MORTON_DIGITS; d++) {
+      size_t total = 0;
+      for (t = 0; t < (int)threads; t++)
+        total += count[(size_t)t * MORTON_DIGITS + d];
+      if (total == n)
+        break;
+    }
+    if (d < MORTON_DIGITS)
+      continue;
+
+    /* offsets ordered by digit, then by range, which keeps the sort stable */
+    for (d = 0; d < MORTON_DIGITS; d++)
+      for (t = 0; t < (int)threads; t++) {
+        size_t c = count[(size_t)t * MORTON_DIGITS + d];
+        count[(size_t)t * MORTON_DIGITS + d] = sum;
+        sum += c;
+      }
+
+    /* scatter each range of keys */
+#ifdef _OPENMP
+    #pragma omp parallel for num_threads(threads)
+#endif
+    for (t = 0; t < (int)threads; t++) {
+      size_t* c = count + (size_t)t * MORTON_DIGITS;
+      size_t begin = (size_t)(((uint64)n * (uint64)t) / threads);
+      size_t end = (size_t)(((uint64)n * (uint64)(t + 1)) / threads);
+      size_t i;
+      for (i = begin; i < end; i++) {
+        size_t p = c[(src_key[i] >> shift) & (MORTON_DIGITS - 1)]++;
+        dst_key[p] = src_key[i];
+        dst_index[p] = src_index[i];
+      }
+    }
+    src_key = dst_key;
+    src_index = dst_index;
+  }
+
+  /* sorted indices may have ended up in scratch array */
+  if (src_index != index)
+    memcpy(index, src_index, n * sizeof(size_t));
+
+  free(k);
+  free(j);
+  free(count);
+  return zfp_true;
+}
+
+/* copy value i of src to value j of dst, which have the same type */
+static void
+morton_copy(zfp_field* dst, size_t j, const zfp_field* src, size_t i)
+{
+  const size_t bytes = zfp_type_size(src->type);
+  const uchar* p = (const uchar*)src->data + (ptrdiff_t)i * (src->sx ? src->sx : 1) * (ptrdiff_t)bytes;
+  uchar* q = (uchar*)dst->data + (ptrdiff_t)j * (dst->sx ? dst->sx : 1) * (ptrdiff_t)bytes;
+  memcpy(q, p, bytes);
+}
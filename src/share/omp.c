@@ -13,13 +13,46 @@ thread_count_omp(const zfp_stream* stream)
   return count;
 }
 
+/* cost model of adaptive thread counts: (de)coding a block costs about as
+   much as OMP_BLOCK_BITS plus the bits it stores, and a thread recoups its
+   start-up, stream buffers, and share of concatenation only once it has
+   OMP_THREAD_BITS worth of such work */
+#define OMP_BLOCK_BITS 384
+#define OMP_THREAD_BITS 0x80000
+
+/* number of threads worth using for blocks of at most maxbits bits each */
+static uint
+adaptive_thread_count_omp(const zfp_stream* stream, size_t blocks, uint maxbits)
+{
+  uint threads = thread_count_omp(stream);
+  double work = (double)blocks * (OMP_BLOCK_BITS + maxbits) / OMP_THREAD_BITS;
+  if (work < threads)
+    threads = MAX((uint)work, 1u);
+  return threads;
+}
+
+/* chunks per thread when load balancing dynamically */
+#define OMP_CHUNKS_PER_THREAD 8
+/* fewest blocks per chunk when over-decomposing, to amortize concatenation */
+#define OMP_MIN_CHUNK_BLOCKS 256
+
 /* number of chunks to partition array into */
 static size_t
 chunk_count_omp(const zfp_stream* stream, size_t blocks, uint threads)
 {
   size_t chunk_size = stream->exec.params.omp.chunk_size;
-  /* if no chunk size is specified, assign one chunk per thread */
-  size_t chunks = chunk_size ? (blocks + chunk_size - 1) / chunk_size : threads;
+  size_t chunks;
+  if (chunk_size)
+    chunks = (blocks + chunk_size - 1) / chunk_size;
+  else if (stream->exec.params.omp.schedule == zfp_omp_static) {
+    /* if no chunk size is specified, assign one chunk per thread */
+    chunks = threads;
+  }
+  else {
+    /* over-decompose so that idle threads can pick up remaining work */
+    chunks = MIN((size_t)threads * OMP_CHUNKS_PER_THREAD, blocks / OMP_MIN_CHUNK_BLOCKS);
+    chunks = MAX(chunks, threads);
+  }
   /* each chunk must contain at least one block */
   chunks = MIN(chunks, blocks);
   /* OpenMP 2.0 loop counters must be ints */
@@ -27,4 +60,199 @@ chunk_count_omp(const zfp_stream* stream, size_t blocks, uint threads)
   return chunks;
 }
 
+/* OpenMP 3.0 is needed to set the loop schedule at run time */
+#if _OPENMP >= 200805
+  /* loop schedule of encountering thread */
+  typedef struct {
+    omp_sched_t kind;
+    int size;
+  } schedule_omp;
+  /* schedule clause for parallel compression loops */
+  #define SCHEDULE_OMP schedule(runtime)
+#else
+  typedef int schedule_omp;
+  #define SCHEDULE_OMP schedule(static)
+#endif
+
+/* set loop schedule and reset thread timers; return previous schedule */
+static schedule_omp
+begin_parallel_omp(const zfp_stream* stream, uint threads)
+{
+  double* time = stream->exec.params.omp.thread_time;
+  schedule_omp schedule;
+#if _OPENMP >= 200805
+  omp_sched_t kind;
+  omp_get_schedule(&schedule.kind, &schedule.size);
+  switch (stream->exec.params.omp.schedule) {
+    case zfp_omp_dynamic:
+    case zfp_omp_tasks:
+      kind = omp_sched_dynamic;
+      break;
+    case zfp_omp_guided:
+      kind = omp_sched_guided;
+      break;
+    case zfp_omp_auto:
+      kind = omp_sched_auto;
+      break;
+    default:
+      kind = omp_sched_static;
+      break;
+  }
+  omp_set_schedule(kind, 0);
+#else
+  schedule = 0;
+#endif
+  if (time) {
+    uint i;
+    for (i = 0; i < threads; i++)
+      time[i] = 0;
+  }
+  return schedule;
+}
+
+/* restore loop schedule saved by begin_parallel_omp */
+static void
+end_parallel_omp(schedule_omp schedule)
+{
+#if _OPENMP >= 200805
+  omp_set_schedule(schedule.kind, schedule.size);
+#else
+  (void)schedule;
+#endif
+}
+
+/* start timing work performed by calling thread */
+static double
+start_timer_omp(const zfp_stream* stream)
+{
+  return stream->exec.params.omp.thread_time ? omp_get_wtime() : 0;
+}
+
+/* add time elapsed since start to calling thread's total */
+static void
+stop_timer_omp(const zfp_stream* stream, double start)
+{
+  double* time = stream->exec.params.omp.thread_time;
+  if (time)
+    time[omp_get_thread_num()] += omp_get_wtime() - start;
+}
+
+/* add blocks (de)compressed by calling thread to its count, if requested */
+static void
+count_blocks_omp(const zfp_stream* stream, size_t blocks)
+{
+  zfp_stream_stats* stats = stream->stats;
+  if (stats && stats->thread_blocks) {
+    uint thread = (uint)omp_get_thread_num();
+    if (thread < stats->threads)
+      stats->thread_blocks[thread] += blocks;
+  }
+}
+
+/* OpenMP 4.5 is needed to compress chunks as tasks */
+#if _OPENMP >= 201511
+  #define ZFP_OMP_TASKLOOP 1
+#endif
+
+/* true if chunks are to be compressed as tasks of enclosing parallel region */
+static zfp_bool
+is_tasking_omp(const zfp_stream* stream)
+{
+#ifdef ZFP_OMP_TASKLOOP
+  return stream->exec.params.omp.schedule == zfp_omp_tasks && omp_in_parallel();
+#else
+  (void)stream;
+  return zfp_false;
+#endif
+}
+
+/* task applied to each chunk of a field */
+typedef void (*task_omp)(void* arg, size_t chunk);
+
+/* work shared by threads or tasks compressing chunks of a field */
+typedef struct {
+  const zfp_stream* stream; /* compressed stream */
+  const zfp_field* field;   /* field to compress */
+  bitstream** bs;           /* per-chunk bit streams */
+  size_t blocks;            /* number of blocks in field */
+  size_t chunks;            /* number of chunks */
+  zfp_stream_stats* stats;  /* per-chunk statistics (may be NULL) */
+} work_omp;
+
+/* apply task to chunk while accounting for its blocks and time */
+static void
+run_chunk_omp(task_omp task, const work_omp* work, size_t chunk)
+{
+  size_t bmin = chunk_offset(work->blocks, work->chunks, chunk + 0);
+  size_t bmax = chunk_offset(work->blocks, work->chunks, chunk + 1);
+  double start = start_timer_omp(work->stream);
+  count_blocks_omp(work->stream, bmax - bmin);
+  task((void*)work, chunk);
+  stop_timer_omp(work->stream, start);
+}
+
+/* compress field of given number of blocks by applying task to each chunk */
+static void
+compress_omp(zfp_stream* stream, const zfp_field* field, size_t blocks, task_omp task)
+{
+  /* from within a parallel region, tasks are run by the enclosing team */
+  zfp_bool tasking = is_tasking_omp(stream);
+  uint threads = tasking ? (uint)omp_get_num_threads() : thread_count_omp(stream);
+  size_t chunks = chunk_count_omp(stream, blocks, threads);
+  int chunk; /* OpenMP 2.0 requires int loop counter */
+  schedule_omp schedule;
+  work_omp work;
+
+  /* allocate per-chunk streams */
+  bitstream* s = zfp_stream_bit_stream(stream);
+  bitstream** bs = compress_init_par(stream, field, chunks, blocks);
+
+  /* without them, e.g., under a host scratch limit, compress in place as one chunk */
+  if (!bs) {
+    bs = &s;
+    chunks = 1;
+  }
+
+  /* compress chunks of blocks in parallel */
+  work.stream = stream;
+  work.field = field;
+  work.bs = bs;
+  work.blocks = blocks;
+  work.chunks = chunks;
+  work.stats = stats_init_par(stream, chunks);
+  schedule = begin_parallel_omp(stream, threads);
+  if (tasking) {
+#ifdef ZFP_OMP_TASKLOOP
+    #pragma omp taskloop grainsize(1)
+    for (chunk = 0; chunk < (int)chunks; chunk++)
+      run_chunk_omp(task, &work, (size_t)chunk);
+#endif
+  }
+  else {
+    #pragma omp parallel for num_threads(threads) SCHEDULE_OMP
+    for (chunk = 0; chunk < (int)chunks; chunk++)
+      run_chunk_omp(task, &work, (size_t)chunk);
+  }
+  end_parallel_omp(schedule);
+  stats_finish_par(stream, work.stats, chunks);
+
+  /* concatenate per-chunk streams; tasks leave the team to the caller */
+  if (bs != &s)
+    compress_finish_par(stream, bs, chunks, tasking ? 1 : threads);
+}
+
+/* number of chunks to decompress in parallel (zero if blocks cannot be located) */
+static size_t
+decompress_chunk_count_omp(const zfp_stream* stream, size_t blocks, uint threads)
+{
+  const zfp_index* index = stream->index;
+  /* blocks of fixed size may be partitioned arbitrarily */
+  if (stream->minbits == stream->maxbits)
+    return chunk_count_omp(stream, blocks, threads);
+  /* variable-size blocks must be partitioned as recorded in the index */
+  if (index && index->chunks && index->chunks <= MIN(blocks, INT_MAX))
+    return index->chunks;
+  return 0;
+}
+
 #endif
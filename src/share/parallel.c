@@ -1,4 +1,8 @@
-#ifdef _OPENMP
+#if defined(_OPENMP) || defined(ZFP_WITH_THREADS)
+
+#if defined(ZFP_WITH_ISA_AVX2) || defined(ZFP_WITH_ISA_AVX512)
+#include <immintrin.h>
+#endif
 
 /* block index at which chunk begins */
 static size_t
@@ -7,6 +11,112 @@ chunk_offset(size_t blocks, size_t chunks, size_t chunk)
   return (size_t)(((uint64)blocks * (uint64)chunk) / chunks);
 }
 
+/* per-chunk statistics to merge after (de)compression (NULL if not requested) */
+static zfp_stream_stats*
+stats_init_par(const zfp_stream* stream, size_t chunks)
+{
+  return stream->stats ? (zfp_stream_stats*)calloc(chunks, sizeof(zfp_stream_stats)) : NULL;
+}
+
+/* statistics accumulated by chunk (NULL if not requested) */
+static zfp_stream_stats*
+stats_chunk_par(zfp_stream_stats* stats, size_t chunk)
+{
+  return stats ? stats + chunk : NULL;
+}
+
+/* add per-chunk statistics to those of stream and deallocate them */
+static void
+stats_finish_par(zfp_stream* stream, zfp_stream_stats* stats, size_t chunks)
+{
+  if (stats) {
+    size_t chunk;
+    for (chunk = 0; chunk < chunks; chunk++)
+      stats_add(stream->stats, stats + chunk);
+    free(stats);
+  }
+}
+
+/* per-chunk compression buffers, optionally retained across calls */
+typedef struct {
+  size_t chunks; /* number of buffers */
+  size_t size;   /* byte size of each buffer */
+  void** buffer; /* buffers, allocated on first use (may be NULL) */
+} scratch_par;
+
+/* deallocate compression buffers */
+static void
+scratch_free_par(void* scratch)
+{
+  scratch_par* sp = (scratch_par*)scratch;
+  if (sp) {
+    size_t chunk;
+    for (chunk = 0; chunk < sp->chunks; chunk++)
+      memory_free(zfp_memory_host_scratch, sp->buffer[chunk], sp->size);
+    free(sp->buffer);
+    free(sp);
+  }
+}
+
+/* reserve buffers of at least size bytes for chunks; return success */
+static zfp_bool
+scratch_reserve_par(zfp_stream* stream, size_t chunks, size_t size)
+{
+  scratch_par* sp = (scratch_par*)stream->scratch;
+  /* release buffers that are too small */
+  if (sp && sp->size < size) {
+    scratch_free_par(sp);
+    stream->scratch = sp = NULL;
+  }
+  if (!sp) {
+    sp = (scratch_par*)malloc(sizeof(scratch_par));
+    if (!sp)
+      return zfp_false;
+    sp->chunks = 0;
+    sp->size = size;
+    sp->buffer = NULL;
+    stream->scratch = sp;
+  }
+  /* add slots for any additional chunks; larger buffers are kept */
+  if (sp->chunks < chunks) {
+    void** buffer = (void**)realloc(sp->buffer, chunks * sizeof(void*));
+    if (!buffer)
+      return zfp_false;
+    while (sp->chunks < chunks)
+      buffer[sp->chunks++] = NULL;
+    sp->buffer = buffer;
+  }
+  return zfp_true;
+}
+
+/* true if buffers of size bytes for chunks fit within host scratch limit */
+static zfp_bool
+scratch_admits_par(const zfp_stream* stream, size_t chunks, size_t size)
+{
+  const scratch_par* sp = (const scratch_par*)stream->scratch;
+  size_t available = zfp_memory_available(zfp_memory_host_scratch);
+  size_t missing = chunks;
+  size_t chunk;
+  if (available == (size_t)-1)
+    return zfp_true;
+  if (sp) {
+    if (sp->size < size) {
+      /* buffers that are too small are released first */
+      for (chunk = 0; chunk < sp->chunks; chunk++)
+        if (sp->buffer[chunk])
+          available += sp->size;
+    }
+    else {
+      /* larger buffers already allocated are reused */
+      for (chunk = 0; chunk < MIN(sp->chunks, chunks); chunk++)
+        if (sp->buffer[chunk])
+          missing--;
+      size = sp->size;
+    }
+  }
+  return missing <= available / MAX(size, 1);
+}
+
 /* initialize per-thread bit streams for parallel compression */
 static bitstream**
 compress_init_par(zfp_stream* stream, const zfp_field* field, size_t chunks, size_t blocks)
@@ -48,57 +158,431 @@ compress_init_par(zfp_stream* stream, const zfp_field* field, size_t chunks, siz
          (stream->maxbits % stream_word_bits != 0) ||
          (stream_wtell(stream->stream) % stream_word_bits != 0);
 
-  /* set up buffer for each thread to compress to */
-  bs = (bitstream**)malloc(chunks * sizeof(bitstream*));
+  /* in variable-rate mode, reserve buffers to be allocated by each thread */
+  if (copy && (!scratch_admits_par(stream, chunks, size) || !scratch_reserve_par(stream, chunks, size)))
+    return NULL;
+
+  /* set up bit stream for each chunk, or defer until chunk is compressed */
+  bs = (bitstream**)calloc(chunks, sizeof(bitstream*));
   if (!bs)
     return NULL;
+  if (!copy)
+    for (chunk = 0; chunk < chunks; chunk++) {
+      size_t block = chunk_offset(blocks, chunks, chunk);
+      void* buffer = (uchar*)stream_data(stream->stream) + stream_size(stream->stream) + block * (stream->maxbits / CHAR_BIT);
+      bs[chunk] = stream_open(buffer, size);
+    }
+
+  return bs;
+}
+
+/* bit stream for compressed chunk, allocated on first use (NULL if out of memory) */
+static bitstream*
+compress_chunk_par(const zfp_stream* stream, bitstream** bs, size_t chunk)
+{
+  scratch_par* sp = (scratch_par*)stream->scratch;
+  if (!bs[chunk] && sp) {
+    /* allocate in calling thread so that first touch places pages near it */
+    if (!sp->buffer[chunk])
+      sp->buffer[chunk] = memory_malloc(zfp_memory_host_scratch, sp->size);
+    if (sp->buffer[chunk])
+      bs[chunk] = stream_open(sp->buffer[chunk], sp->size);
+  }
+  return bs[chunk];
+}
+
+/* bit offset of first word boundary at or after offset */
+static size_t
+word_align(size_t offset)
+{
+  return offset + (stream_word_bits - offset % stream_word_bits) % stream_word_bits;
+}
+
+/* copy bits of chunk that begin on a word boundary in dst to clone s of dst; */
+/* these words are not shared with other chunks */
+static void
+concatenate_aligned_par(bitstream* s, bitstream* src, size_t begin, size_t end)
+{
+  size_t align = word_align(begin);
+  if (align < end) {
+    stream_wseek(s, align);
+    stream_rseek(src, align - begin);
+    stream_copy(s, src, end - align);
+    stream_flush(s);
+  }
+}
+
+/* copy in order the leading bits of each chunk that share a word with the */
+/* preceding chunk, then skip over the bits copied by concatenate_aligned_par */
+static void
+concatenate_leading_par(bitstream* dst, bitstream** src, const size_t* begin, size_t chunks, zfp_bool aligned)
+{
+  size_t chunk;
   for (chunk = 0; chunk < chunks; chunk++) {
-    size_t block = chunk_offset(blocks, chunks, chunk);
-    void* buffer = copy ? malloc(size) : (uchar*)stream_data(stream->stream) + stream_size(stream->stream) + block * (stream->maxbits / CHAR_BIT);
-    if (!buffer)
+    size_t align = word_align(begin[chunk]);
+    stream_rewind(src[chunk]);
+    if (aligned && align < begin[chunk + 1]) {
+      stream_copy(dst, src[chunk], align - begin[chunk]);
+      stream_wseek(dst, begin[chunk + 1]);
+    }
+    else
+      stream_copy(dst, src[chunk], begin[chunk + 1] - begin[chunk]);
+  }
+}
+
+#ifdef _OPENMP
+/* concatenate flushed bit streams using OpenMP at bit offsets begin */
+static void
+concatenate_omp(bitstream* dst, bitstream** src, const size_t* begin, size_t chunks, uint threads)
+{
+  zfp_bool done = zfp_true;
+
+  /* copy word-aligned bits of each chunk in parallel */
+  #pragma omp parallel num_threads(threads)
+  {
+    /* thread-local bit stream writing to dst's buffer */
+    bitstream* s = stream_clone(dst);
+    int c; /* OpenMP 2.0 requires int loop counter */
+    if (!s)
+      done = zfp_false;
+    #pragma omp for
+    for (c = 0; c < (int)chunks; c++)
+      if (s)
+        concatenate_aligned_par(s, src[c], begin[c], begin[c + 1]);
+    if (s)
+      stream_close(s);
+  }
+
+  concatenate_leading_par(dst, src, begin, chunks, done);
+}
+#endif
+
+#ifdef ZFP_WITH_THREADS
+/* concatenation shared by pool threads */
+typedef struct {
+  bitstream** dst;     /* per-chunk clones of destination stream */
+  bitstream** src;     /* per-chunk source streams */
+  const size_t* begin; /* chunk bit offsets in destination */
+} concatenate_work_threads;
+
+/* copy word-aligned bits of one chunk */
+static void
+concatenate_chunk_threads(void* arg, size_t chunk)
+{
+  const concatenate_work_threads* work = (const concatenate_work_threads*)arg;
+  concatenate_aligned_par(work->dst[chunk], work->src[chunk], work->begin[chunk], work->begin[chunk + 1]);
+}
+
+/* concatenate flushed bit streams using thread pool at bit offsets begin */
+static void
+concatenate_threads(bitstream* dst, bitstream** src, const size_t* begin, size_t chunks, pool* p)
+{
+  concatenate_work_threads work;
+  bitstream** s = (bitstream**)malloc(chunks * sizeof(bitstream*));
+  size_t chunk = 0;
+
+  /* clone dst for each chunk; copy serially if out of memory */
+  while (s && chunk < chunks && (s[chunk] = stream_clone(dst)))
+    chunk++;
+
+  /* copy word-aligned bits of each chunk in parallel */
+  if (chunk == chunks) {
+    work.dst = s;
+    work.src = src;
+    work.begin = begin;
+    pool_run(p, concatenate_chunk_threads, &work, chunks);
+  }
+
+  concatenate_leading_par(dst, src, begin, chunks, chunk == chunks);
+
+  if (s) {
+    while (chunk--)
+      stream_close(s[chunk]);
+    free(s);
+  }
+}
+#endif
+
+/* concatenate flushed bit streams in parallel at bit offsets begin */
+static void
+concatenate_par(const zfp_stream* stream, bitstream** src, const size_t* begin, size_t chunks, uint threads)
+{
+  bitstream* dst = zfp_stream_bit_stream(stream);
+  switch (stream->exec.policy) {
+#ifdef _OPENMP
+    case zfp_exec_omp:
+      concatenate_omp(dst, src, begin, chunks, threads);
+      break;
+#endif
+#ifdef ZFP_WITH_THREADS
+    case zfp_exec_threads:
+      concatenate_threads(dst, src, begin, chunks, (pool*)stream->exec.params.threads.pool);
+      break;
+#endif
+    default:
+      concatenate_leading_par(dst, src, begin, chunks, zfp_false);
       break;
-    bs[chunk] = stream_open(buffer, size);
   }
+  (void)threads;
+}
 
-  /* handle memory allocation failure */
-  if (copy && chunk < chunks) {
-    while (chunk--) {
-      free(stream_data(bs[chunk]));
-      stream_close(bs[chunk]);
-    }
-    free(bs);
-    bs = NULL;
+/* chunk hashing shared by threads */
+typedef struct {
+  bitstream** src;     /* flushed per-chunk streams */
+  const uint64* offset; /* chunk bit offsets in compressed field */
+  uint32* hash;        /* per-chunk hashes to compute */
+  const uint32* table; /* CRC-32C table for generic instruction set */
+} hash_work_par;
+
+/* CRC-32C (Castagnoli) lookup table for one byte at a time */
+static void
+crc32c_table(uint32* table)
+{
+  uint i, k;
+  for (i = 0; i < 256; i++) {
+    uint32 c = i;
+    for (k = 0; k < 8; k++)
+      c = (c >> 1) ^ (0x82f63b78u & (0u - (c & 1u)));
+    table[i] = c;
   }
+}
 
-  return bs;
+/* CRC-32C of n words, each taken least significant byte first */
+static uint32
+crc32c_generic(const uint64* p, size_t n, const uint32* table)
+{
+  uint32 c = 0xffffffffu;
+  size_t i;
+  uint k;
+  for (i = 0; i < n; i++) {
+    uint64 w = p[i];
+    for (k = 0; k < 8; k++, w >>= 8)
+      c = (c >> 8) ^ table[(c ^ (uint32)w) & 0xffu];
+  }
+  return ~c;
+}
+
+#if defined(ZFP_WITH_ISA_AVX2) || defined(ZFP_WITH_ISA_AVX512)
+/* CRC-32C of n words using SSE4.2 instructions */
+__attribute__((target("sse4.2")))
+static uint32
+crc32c_sse42(const uint64* p, size_t n)
+{
+  uint64 c = 0xffffffffu;
+  size_t i;
+  for (i = 0; i < n; i++)
+    c = _mm_crc32_u64(c, p[i]);
+  return ~(uint32)c;
+}
+#endif
+
+/* hash word-padded bits of flushed chunk stream */
+static void
+hash_chunk_par(void* arg, size_t chunk)
+{
+  const hash_work_par* work = (const hash_work_par*)arg;
+  const uint64* p = (const uint64*)stream_data(work->src[chunk]);
+  size_t n = (size_t)((work->offset[chunk + 1] - work->offset[chunk] + 63) / 64);
+#if defined(ZFP_WITH_ISA_AVX2) || defined(ZFP_WITH_ISA_AVX512)
+  /* every processor supporting AVX2 also supports SSE4.2 */
+  if (!work->table) {
+    work->hash[chunk] = crc32c_sse42(p, n);
+    return;
+  }
+#endif
+  work->hash[chunk] = crc32c_generic(p, n, work->table);
+}
+
+/* hash flushed bit streams in parallel when chunk hashes are requested */
+static void
+hash_par(const zfp_stream* stream, bitstream** src, size_t chunks, uint threads)
+{
+  zfp_index* index = stream->index;
+  uint32 table[256];
+  hash_work_par work;
+  uint32* hash;
+  size_t chunk;
+#ifdef _OPENMP
+  int c; /* OpenMP 2.0 requires int loop counter */
+#endif
+
+  index->hashes = 0;
+  if (!index->hashing || !index->chunks)
+    return;
+  hash = (uint32*)realloc(index->hash, chunks * sizeof(uint32));
+  if (!hash)
+    return;
+  index->hash = hash;
+
+  work.src = src;
+  work.offset = index->offset;
+  work.hash = hash;
+  work.table = NULL;
+  if (stream->isa != zfp_isa_avx2 && stream->isa != zfp_isa_avx512) {
+    crc32c_table(table);
+    work.table = table;
+  }
+
+  switch (stream->exec.policy) {
+#ifdef _OPENMP
+    case zfp_exec_omp:
+      #pragma omp parallel for num_threads(threads)
+      for (c = 0; c < (int)chunks; c++)
+        hash_chunk_par(&work, (size_t)c);
+      break;
+#endif
+#ifdef ZFP_WITH_THREADS
+    case zfp_exec_threads:
+      pool_run((pool*)stream->exec.params.threads.pool, hash_chunk_par, &work, chunks);
+      break;
+#endif
+    default:
+      for (chunk = 0; chunk < chunks; chunk++)
+        hash_chunk_par(&work, chunk);
+      break;
+  }
+  index->hashes = chunks;
+  (void)threads;
 }
 
 /* flush and concatenate bit streams if needed */
 static void
-compress_finish_par(zfp_stream* stream, bitstream** src, size_t chunks)
+compress_finish_par(zfp_stream* stream, bitstream** src, size_t chunks, uint threads)
 {
   bitstream* dst = zfp_stream_bit_stream(stream);
-  zfp_bool copy = (stream_data(dst) != stream_data(*src));
+  zfp_bool copy;
   size_t offset = stream_wtell(dst);
+  size_t* begin = NULL;
+  uint64* position = NULL;
+  double start = stream->stats ? zfp_stats_clock() : 0;
   size_t chunk;
 
-  /* flush each stream and concatenate if necessary */
+  /* give up if any chunk ran out of memory */
+  for (chunk = 0; chunk < chunks; chunk++)
+    if (!src[chunk]) {
+      for (chunk = 0; chunk < chunks; chunk++)
+        if (src[chunk])
+          stream_close(src[chunk]);
+      scratch_free_par(stream->scratch);
+      stream->scratch = NULL;
+      free(src);
+      return;
+    }
+
+  zfp_trace_begin("zfp:concat");
+
+  /* record chunk offsets if requested */
+  if (stream->index) {
+    position = (uint64*)realloc(stream->index->offset, (chunks + 1) * sizeof(uint64));
+    if (position) {
+      stream->index->offset = position;
+      position[0] = 0;
+    }
+    stream->index->chunks = position ? chunks : 0;
+  }
+
+  copy = (stream_data(dst) != stream_data(*src));
+  if (copy)
+    begin = (size_t*)malloc((chunks + 1) * sizeof(size_t));
+
+  /* flush each stream and compute exclusive prefix sum of sizes */
   for (chunk = 0; chunk < chunks; chunk++) {
     size_t bits = stream_wtell(src[chunk]);
+    if (begin)
+      begin[chunk] = offset;
     offset += bits;
+    if (position)
+      position[chunk + 1] = position[chunk] + bits;
     stream_flush(src[chunk]);
-    /* concatenate streams if they are not already contiguous */
-    if (copy) {
+    /* concatenate streams serially if offsets cannot be recorded */
+    if (copy && !begin) {
       stream_rewind(src[chunk]);
       stream_copy(dst, src[chunk], bits);
-      free(stream_data(src[chunk]));
     }
+  }
+
+  /* hash chunks before their buffers are released */
+  if (stream->index)
+    hash_par(stream, src, chunks, threads);
+
+  /* concatenate streams in parallel if they are not already contiguous */
+  if (begin) {
+    begin[chunks] = offset;
+    concatenate_par(stream, src, begin, chunks, threads);
+    free(begin);
+  }
+
+  /* close streams and release their buffers unless asked to retain them */
+  for (chunk = 0; chunk < chunks; chunk++)
     stream_close(src[chunk]);
+  if (stream->exec.policy != zfp_exec_omp || !stream->exec.params.omp.persistent) {
+    scratch_free_par(stream->scratch);
+    stream->scratch = NULL;
   }
 
   free(src);
   if (!copy)
     stream_wseek(dst, offset);
+
+  zfp_trace_end();
+
+  if (stream->stats)
+    stream->stats->concat_time += zfp_stats_clock() - start;
+}
+
+/* bit offset at which chunk begins relative to start of compressed field */
+static uint64
+chunk_bit_offset(const zfp_stream* stream, size_t blocks, size_t chunks, size_t chunk)
+{
+  /* blocks of fixed size are located directly; others via chunk index */
+  if (stream->minbits == stream->maxbits)
+    return (uint64)chunk_offset(blocks, chunks, chunk) * stream->maxbits;
+  else
+    return stream->index->offset[chunk];
+}
+
+/* initialize per-thread bit streams for parallel decompression */
+static bitstream**
+decompress_init_par(zfp_stream* stream, size_t chunks, size_t blocks)
+{
+  bitstream** bs;
+  size_t base = stream_rtell(stream->stream);
+  size_t chunk;
+
+  /* set up stream for each thread to decompress from */
+  bs = (bitstream**)malloc(chunks * sizeof(bitstream*));
+  if (!bs)
+    return NULL;
+  for (chunk = 0; chunk < chunks; chunk++) {
+    bs[chunk] = stream_clone(stream->stream);
+    if (!bs[chunk])
+      break;
+    stream_rseek(bs[chunk], base + (size_t)chunk_bit_offset(stream, blocks, chunks, chunk));
+  }
+
+  /* handle memory allocation failure */
+  if (chunk < chunks) {
+    while (chunk--)
+      stream_close(bs[chunk]);
+    free(bs);
+    bs = NULL;
+  }
+
+  return bs;
+}
+
+/* deallocate per-thread bit streams and advance stream past field */
+static void
+decompress_finish_par(zfp_stream* stream, bitstream** src, size_t chunks, size_t blocks)
+{
+  size_t offset = stream_rtell(stream->stream) + (size_t)chunk_bit_offset(stream, blocks, chunks, chunks);
+  size_t chunk;
+
+  for (chunk = 0; chunk < chunks; chunk++)
+    stream_close(src[chunk]);
+  free(src);
+
+  stream_rseek(stream->stream, offset);
 }
 
 #endif
@@ -0,0 +1,203 @@
+#ifdef ZFP_WITH_THREADS
+#include <pthread.h>
+
+/* task applied to each item of work posted to a thread pool */
+typedef void (*task_pool)(void* arg, size_t item);
+
+/* persistent pool of worker threads */
+typedef struct {
+  pthread_mutex_t mutex; /* guards members below */
+  pthread_cond_t start;  /* signaled when work is posted or pool is closed */
+  pthread_cond_t finish; /* signaled when last busy worker runs out of work */
+  pthread_t* thread;     /* worker threads */
+  uint workers;          /* number of worker threads */
+  uint busy;             /* number of workers yet to finish current work */
+  size_t generation;     /* number of times work has been posted */
+  zfp_bool quit;         /* true when workers are to exit */
+  task_pool task;        /* task to apply to each item */
+  void* arg;             /* argument passed to task */
+  size_t items;          /* number of items of current work */
+  size_t next;           /* next item to claim */
+  pthread_t driver;      /* thread running work started by pool_spawn */
+  zfp_bool spawned;      /* true until driver thread has been joined */
+  zfp_bool finished;     /* true once driver thread has run its function */
+} pool;
+
+/* work run by driver thread of pool */
+typedef struct {
+  pool* p;             /* pool whose driver runs function */
+  void (*func)(void*); /* function to run */
+  void* arg;           /* argument passed to function */
+} driver_pool;
+
+/* apply task to unclaimed items until none remain; mutex must be held */
+static void
+pool_drain(pool* p)
+{
+  while (p->next < p->items) {
+    size_t item = p->next++;
+    pthread_mutex_unlock(&p->mutex);
+    p->task(p->arg, item);
+    pthread_mutex_lock(&p->mutex);
+  }
+}
+
+/* worker thread main loop */
+static void*
+pool_worker(void* arg)
+{
+  pool* p = (pool*)arg;
+  /* workers are started before any work is posted */
+  size_t generation = 0;
+  pthread_mutex_lock(&p->mutex);
+  for (;;) {
+    while (!p->quit && p->generation == generation)
+      pthread_cond_wait(&p->start, &p->mutex);
+    if (p->quit)
+      break;
+    generation = p->generation;
+    pool_drain(p);
+    if (!--p->busy)
+      pthread_cond_signal(&p->finish);
+  }
+  pthread_mutex_unlock(&p->mutex);
+  return NULL;
+}
+
+/* driver thread main function */
+static void*
+pool_driver(void* arg)
+{
+  driver_pool d = *(driver_pool*)arg;
+  free(arg);
+  d.func(d.arg);
+  pthread_mutex_lock(&d.p->mutex);
+  d.p->finished = zfp_true;
+  pthread_mutex_unlock(&d.p->mutex);
+  return NULL;
+}
+
+/* wait for function started by pool_spawn, if any, to return */
+static void
+pool_join(pool* p)
+{
+  if (p && p->spawned) {
+    pthread_join(p->driver, NULL);
+    p->spawned = zfp_false;
+  }
+}
+
+/* true if no function started by pool_spawn is still running */
+static zfp_bool
+pool_idle(pool* p)
+{
+  zfp_bool idle = zfp_true;
+  if (p && p->spawned) {
+    pthread_mutex_lock(&p->mutex);
+    idle = p->finished;
+    pthread_mutex_unlock(&p->mutex);
+  }
+  return idle;
+}
+
+/* run func(arg) on a thread of its own, which may in turn post work to the
+   pool, and return without waiting; func is called directly if no thread
+   can be started */
+static void
+pool_spawn(pool* p, void (*func)(void*), void* arg)
+{
+  driver_pool* d = p ? (driver_pool*)malloc(sizeof(driver_pool)) : NULL;
+  pool_join(p);
+  if (d) {
+    d->p = p;
+    d->func = func;
+    d->arg = arg;
+    p->finished = zfp_false;
+    if (!pthread_create(&p->driver, NULL, pool_driver, d)) {
+      p->spawned = zfp_true;
+      return;
+    }
+    free(d);
+  }
+  func(arg);
+}
+
+/* close pool and join its worker threads */
+static void
+pool_free(pool* p)
+{
+  if (p) {
+    uint i;
+    pool_join(p);
+    pthread_mutex_lock(&p->mutex);
+    p->quit = zfp_true;
+    pthread_cond_broadcast(&p->start);
+    pthread_mutex_unlock(&p->mutex);
+    for (i = 0; i < p->workers; i++)
+      pthread_join(p->thread[i], NULL);
+    pthread_cond_destroy(&p->finish);
+    pthread_cond_destroy(&p->start);
+    pthread_mutex_destroy(&p->mutex);
+    free(p->thread);
+    free(p);
+  }
+}
+
+/* open pool with given number of worker threads (NULL upon failure) */
+static pool*
+pool_alloc(uint workers)
+{
+  pool* p = (pool*)malloc(sizeof(pool));
+  if (!p)
+    return NULL;
+  p->thread = workers ? (pthread_t*)malloc(workers * sizeof(pthread_t)) : NULL;
+  if (workers && !p->thread) {
+    free(p);
+    return NULL;
+  }
+  pthread_mutex_init(&p->mutex, NULL);
+  pthread_cond_init(&p->start, NULL);
+  pthread_cond_init(&p->finish, NULL);
+  p->workers = 0;
+  p->busy = 0;
+  p->generation = 0;
+  p->quit = zfp_false;
+  p->task = NULL;
+  p->arg = NULL;
+  p->items = 0;
+  p->next = 0;
+  p->spawned = zfp_false;
+  p->finished = zfp_true;
+  /* start workers; on failure, make do with those already started */
+  while (p->workers < workers && !pthread_create(&p->thread[p->workers], NULL, pool_worker, p))
+    p->workers++;
+  return p;
+}
+
+/* apply task to items 0, ..., items - 1 using pool and calling thread */
+static void
+pool_run(pool* p, task_pool task, void* arg, size_t items)
+{
+  /* without a pool, the calling thread does all the work */
+  if (!p) {
+    size_t item;
+    for (item = 0; item < items; item++)
+      task(arg, item);
+    return;
+  }
+  pthread_mutex_lock(&p->mutex);
+  p->task = task;
+  p->arg = arg;
+  p->items = items;
+  p->next = 0;
+  p->busy = p->workers;
+  p->generation++;
+  pthread_cond_broadcast(&p->start);
+  /* help out, then wait for workers to complete their last items */
+  pool_drain(p);
+  while (p->busy)
+    pthread_cond_wait(&p->finish, &p->mutex);
+  pthread_mutex_unlock(&p->mutex);
+}
+
+#endif
@@ -0,0 +1,206 @@
+/* cross-field prediction of one field from a compatible primary field */
+
+/* a predicted field is stored, for the linear predictor, as one 32-bit IEEE
+   gain per block followed by the residual compressed by zfp_compress(), which
+   is taken against the primary field scaled by the gain of each block; the
+   residual is computed as in temporal compression */
+
+/* true if field and primary field are compatible with predictor */
+static zfp_bool
+predict_supported(const zfp_field* field, const zfp_field* primary, zfp_predictor predictor)
+{
+  if (!is_plain_field(field) || !zfp_field_dimensionality(field) || !primary ||
+      primary->type != field->type || primary->nx != field->nx || primary->ny != field->ny ||
+      primary->nz != field->nz || primary->nw != field->nw)
+    return zfp_false;
+  switch (predictor) {
+    case zfp_predict_difference:
+      return zfp_true;
+    case zfp_predict_linear:
+      return field->type == zfp_type_float || field->type == zfp_type_double;
+    default:
+      return zfp_false;
+  }
+}
+
+/* value i of contiguous floating-point buffer */
+static double
+predict_get(zfp_type type, const void* p, size_t i)
+{
+  return type == zfp_type_float ? (double)((const float*)p)[i] : ((const double*)p)[i];
+}
+
+/* least-squares gain of each block relating contiguous values x to primary p */
+static void
+predict_fit(const zfp_field* field, const void* x, const void* p, float* gain, double* sum)
+{
+  const size_t nx = MAX(field->nx, 1u);
+  const size_t ny = MAX(field->ny, 1u);
+  const size_t nz = MAX(field->nz, 1u);
+  const size_t nw = MAX(field->nw, 1u);
+  const size_t bx = (nx + 3) / 4;
+  const size_t by = (ny + 3) / 4;
+  const size_t bz = (nz + 3) / 4;
+  const size_t blocks = field_blocks(field);
+  size_t i = 0;
+  size_t b, u, y, z, w;
+
+  /* accumulate count and sums of p, x, p^2, p*x of each block */
+  memset(sum, 0, 5 * blocks * sizeof(double));
+  for (w = 0; w < nw; w++)
+    for (z = 0; z < nz; z++)
+      for (y = 0; y < ny; y++)
+        for (u = 0; u < nx; u++, i++) {
+          double* s = sum + 5 * (u / 4 + bx * (y / 4 + by * (z / 4 + bz * (w / 4))));
+          double pi = predict_get(field->type, p, i);
+          double xi = predict_get(field->type, x, i);
+          s[0] += 1;
+          s[1] += pi;
+          s[2] += xi;
+          s[3] += pi * pi;
+          s[4] += pi * xi;
+        }
+
+  /* the block transform absorbs the intercept, so only the slope is kept */
+  for (b = 0; b < blocks; b++) {
+    const double* s = sum + 5 * b;
+    double var = s[3] - s[1] * s[1] / s[0];
+    double cov = s[4] - s[1] * s[2] / s[0];
+    double g = var > 0 ? cov / var : 0;
+    gain[b] = (g == g && fabs(g) < FLT_MAX) ? (float)g : 0.0f;
+  }
+}
+
+/* replace contiguous primary values p with their prediction using block gains */
+static void
+predict_scale(const zfp_field* field, void* p, const float* gain)
+{
+  const size_t nx = MAX(field->nx, 1u);
+  const size_t ny = MAX(field->ny, 1u);
+  const size_t nz = MAX(field->nz, 1u);
+  const size_t nw = MAX(field->nw, 1u);
+  const size_t bx = (nx + 3) / 4;
+  const size_t by = (ny + 3) / 4;
+  const size_t bz = (nz + 3) / 4;
+  size_t i = 0;
+  size_t x, y, z, w;
+
+  for (w = 0; w < nw; w++)
+    for (z = 0; z < nz; z++)
+      for (y = 0; y < ny; y++)
+        for (x = 0; x < nx; x++, i++) {
+          float g = gain[x / 4 + bx * (y / 4 + by * (z / 4 + bz * (w / 4)))];
+          if (field->type == zfp_type_float)
+            ((float*)p)[i] = g * ((float*)p)[i];
+          else
+            ((double*)p)[i] = (double)g * ((double*)p)[i];
+        }
+}
+
+/* contiguous residual field of given shape, its prediction, and block gains */
+typedef struct {
+  zfp_field residual; /* residual in type coded by stream */
+  void* prediction;   /* contiguous prediction from primary field */
+  float* gain;        /* per-block gains (linear predictor only) */
+  double* sum;        /* per-block sums for fitting gains */
+} predict_state;
+
+/* allocate state for field; return false upon failure */
+static zfp_bool
+predict_begin(predict_state* state, const zfp_stream* zfp, const zfp_field* field, zfp_predictor predictor)
+{
+  const size_t bytes = zfp_field_size(field, NULL) * zfp_type_size(field->type);
+  const size_t blocks = field_blocks(field);
+
+  state->residual = *field;
+  state->residual.type = temporal_residual_type(field->type, zfp);
+  state->residual.sx = state->residual.sy = state->residual.sz = state->residual.sw = 0;
+  state->residual.data = malloc(bytes);
+  state->prediction = malloc(bytes);
+  state->gain = NULL;
+  state->sum = NULL;
+  if (predictor == zfp_predict_linear) {
+    state->gain = (float*)malloc(blocks * sizeof(float));
+    state->sum = (double*)malloc(5 * blocks * sizeof(double));
+  }
+  return state->residual.data && state->prediction && (predictor != zfp_predict_linear || (state->gain && state->sum));
+}
+
+/* deallocate state */
+static void
+predict_end(predict_state* state)
+{
+  free(state->residual.data);
+  free(state->prediction);
+  free(state->gain);
+  free(state->sum);
+}
+
+/* compress field as residual of its prediction from primary */
+static size_t
+predict_compress(zfp_stream* zfp, const zfp_field* field, const zfp_field* primary, zfp_predictor predictor)
+{
+  const size_t n = zfp_field_size(field, NULL);
+  const size_t blocks = field_blocks(field);
+  predict_state state;
+  size_t size = 0;
+  size_t b;
+
+  if (!predict_supported(field, primary, predictor))
+    return 0;
+
+  if (predict_begin(&state, zfp, field, predictor)) {
+    temporal_copy(field, state.residual.data, zfp_true);
+    temporal_copy(primary, state.prediction, zfp_true);
+    if (predictor == zfp_predict_linear) {
+      /* fit and store gains, then scale primary field by them */
+      predict_fit(field, state.residual.data, state.prediction, state.gain, state.sum);
+      for (b = 0; b < blocks; b++) {
+        uint32 bits;
+        memcpy(&bits, state.gain + b, sizeof(bits));
+        stream_write_bits(zfp->stream, bits, 32);
+      }
+      stream_flush(zfp->stream);
+      predict_scale(field, state.prediction, state.gain);
+    }
+    temporal_subtract(state.residual.type, state.residual.data, state.prediction, n);
+    size = zfp_compress(zfp, &state.residual);
+  }
+  predict_end(&state);
+
+  return size;
+}
+
+/* decompress residual and add prediction from primary */
+static size_t
+predict_decompress(zfp_stream* zfp, zfp_field* field, const zfp_field* primary, zfp_predictor predictor)
+{
+  const size_t n = zfp_field_size(field, NULL);
+  const size_t blocks = field_blocks(field);
+  predict_state state;
+  size_t size = 0;
+  size_t b;
+
+  if (!predict_supported(field, primary, predictor))
+    return 0;
+
+  if (predict_begin(&state, zfp, field, predictor)) {
+    temporal_copy(primary, state.prediction, zfp_true);
+    if (predictor == zfp_predict_linear) {
+      for (b = 0; b < blocks; b++) {
+        uint32 bits = (uint32)stream_read_bits(zfp->stream, 32);
+        memcpy(state.gain + b, &bits, sizeof(bits));
+      }
+      stream_align(zfp->stream);
+      predict_scale(field, state.prediction, state.gain);
+    }
+    size = zfp_decompress(zfp, &state.residual);
+    if (size) {
+      temporal_add(state.residual.type, state.prediction, state.residual.data, n);
+      temporal_copy(field, state.prediction, zfp_false);
+    }
+  }
+  predict_end(&state);
+
+  return size;
+}
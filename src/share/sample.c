@@ -0,0 +1,91 @@
+/* evaluation of a compressed field at scattered points */
+
+/* value of a block contributing to a sample, i.e., one grid point of a point */
+typedef struct {
+  size_t block; /* raster index of block holding grid point */
+  size_t index; /* point index times taps per point plus tap number */
+  uint offset;  /* offset of grid point within block */
+} sample_tap;
+
+/* order taps by block, and taps of the same block by index */
+static int
+sample_compare(const void* a, const void* b)
+{
+  const sample_tap* p = (const sample_tap*)a;
+  const sample_tap* q = (const sample_tap*)b;
+  if (p->block != q->block)
+    return p->block < q->block ? -1 : 1;
+  return p->index < q->index ? -1 : p->index > q->index;
+}
+
+/* grid indices i0 <= i1 bracketing coordinate x along axis of n > 0 grid
+   points, and weight t of i1; without interpolation, i0 = i1 is the grid
+   point nearest x; coordinates outside the grid, and NaNs, are clamped */
+static void
+sample_axis(double x, size_t n, zfp_bool interpolate, size_t* i0, size_t* i1, double* t)
+{
+  double max = (double)(n - 1);
+  x = x > 0 ? MIN(x, max) : 0;
+  if (interpolate) {
+    *i0 = (size_t)x;
+    *i1 = MIN(*i0 + 1, n - 1);
+    *t = x - (double)*i0;
+  }
+  else {
+    *i0 = *i1 = (size_t)(x + 0.5);
+    *t = 0;
+  }
+}
+
+/* set up the k taps and weights of each of n points of dims coordinates each */
+static void
+sample_taps(sample_tap* tap, double* weight, const zfp_field* field, const double* point, size_t n, uint k, zfp_bool interpolate)
+{
+  uint dims = zfp_field_dimensionality(field);
+  size_t nx[4];
+  size_t p;
+  uint d, j;
+
+  nx[0] = MAX(field->nx, 1u);
+  nx[1] = MAX(field->ny, 1u);
+  nx[2] = MAX(field->nz, 1u);
+  nx[3] = MAX(field->nw, 1u);
+
+  for (p = 0; p < n; p++, point += dims) {
+    size_t i0[4], i1[4];
+    double t[4];
+    for (d = 0; d < dims; d++)
+      sample_axis(point[d], nx[d], interpolate, i0 + d, i1 + d, t + d);
+    /* bit d of tap number j selects upper grid point along axis d */
+    for (j = 0; j < k; j++) {
+      size_t index = k * p + j;
+      size_t block = 0;
+      uint offset = 0;
+      double w = 1;
+      for (d = dims; d-- > 0;) {
+        zfp_bool upper = (j >> d) & 1u;
+        size_t i = upper ? i1[d] : i0[d];
+        block = block * ((nx[d] + 3) / 4) + i / 4;
+        offset = 4 * offset + (uint)(i & 3u);
+        w *= upper ? t[d] : 1 - t[d];
+      }
+      tap[index].block = block;
+      tap[index].index = index;
+      tap[index].offset = offset;
+      weight[index] = w;
+    }
+  }
+}
+
+#ifdef _OPENMP
+/* first of the sorted taps assigned to part of parts, advanced to a block
+   boundary so that each block is decoded by a single part */
+static size_t
+sample_split(const sample_tap* tap, size_t count, uint parts, uint part)
+{
+  size_t i = (size_t)((uint64)count * part / parts);
+  while (0 < i && i < count && tap[i].block == tap[i - 1].block)
+    i++;
+  return i;
+}
+#endif
@@ -0,0 +1,174 @@
+/* skip-only scan of compressed blocks, e.g., to rebuild a chunk index */
+
+/* block layout parameters of a scalar type and dimensionality */
+typedef struct {
+  uint size;    /* number of values per block */
+  uint intprec; /* number of bits per block-floating-point integer */
+  uint pbits;   /* number of bits of precision in reversible mode */
+  uint ebits;   /* number of bits of common exponent (0 for integers) */
+  int dims;     /* dimensionality */
+} scan_codec;
+
+/* initialize block layout parameters; return false if type is unsupported */
+static zfp_bool
+scan_codec_init(scan_codec* codec, zfp_type type, uint dims)
+{
+  codec->size = 1u << (2 * dims);
+  codec->dims = (int)dims;
+  switch (type) {
+    case zfp_type_int32:
+      codec->intprec = 32;
+      codec->pbits = 5;
+      codec->ebits = 0;
+      return zfp_true;
+    case zfp_type_int64:
+      codec->intprec = 64;
+      codec->pbits = 6;
+      codec->ebits = 0;
+      return zfp_true;
+    case zfp_type_float:
+      codec->intprec = 32;
+      codec->pbits = 5;
+      codec->ebits = 8;
+      return zfp_true;
+    case zfp_type_double:
+      codec->intprec = 64;
+      codec->pbits = 6;
+      codec->ebits = 11;
+      return zfp_true;
+    default:
+      return zfp_false;
+  }
+}
+
+/* skip embedded coding of codec->size integers; return number of bits skipped */
+static uint
+scan_ints(bitstream* stream, const scan_codec* codec, uint maxbits, uint maxprec)
+{
+  uint intprec = codec->intprec;
+  uint size = codec->size;
+  uint kmin = intprec > maxprec ? intprec - maxprec : 0;
+  uint bits = maxbits;
+  uint i, k, m, n;
+
+  /* mirror decode_ints bit plane by bit plane without depositing any bits */
+  for (k = intprec, n = 0; bits && k-- > kmin;) {
+    /* skip first n bits of bit plane #k */
+    m = MIN(n, bits);
+    bits -= m;
+    stream_skip(stream, m);
+    /* skip unary run-length code of remainder of bit plane */
+    for (; n < size && bits && (bits--, stream_read_bit(stream)); n++) {
+      /* skip run of zeros and its one-bit; the last one-bit is implied */
+      m = MIN(size - 1 - n, bits);
+      for (i = 0; i < m && !stream_read_bit(stream); i++)
+        ;
+      bits -= i + (i < m);
+      n += i;
+    }
+  }
+
+  return maxbits - bits;
+}
+
+/* skip reversibly coded integer block; return number of bits skipped */
+static uint
+scan_rev_ints(bitstream* stream, const scan_codec* codec, uint maxbits)
+{
+  uint prec = (uint)stream_read_bits(stream, codec->pbits) + 1;
+  return codec->pbits + scan_ints(stream, codec, maxbits - codec->pbits, prec);
+}
+
+/* skip block coded in lossy or reversible mode; return bits skipped before padding */
+static uint
+scan_block_mode(const zfp_stream* zfp, const scan_codec* codec, uint maxbits)
+{
+  bitstream* stream = zfp->stream;
+  uint bits;
+
+  if (!codec->ebits) {
+    /* integer block */
+    if (zfp->minexp < ZFP_MIN_EXP)
+      return scan_rev_ints(stream, codec, maxbits);
+    return scan_ints(stream, codec, maxbits, zfp->maxprec);
+  }
+
+  /* floating-point block; all-zero blocks consist of a single bit */
+  bits = 1;
+  if (!stream_read_bit(stream))
+    return bits;
+  if (zfp->minexp < ZFP_MIN_EXP) {
+    /* reversible block with or without common exponent */
+    bits++;
+    if (!stream_read_bit(stream)) {
+      stream_skip(stream, codec->ebits);
+      bits += codec->ebits;
+    }
+    bits += scan_rev_ints(stream, codec, maxbits - bits);
+  }
+  else {
+    /* lossy block whose precision depends on its common exponent */
+    int emax = (int)stream_read_bits(stream, codec->ebits) - ((1 << (codec->ebits - 1)) - 1);
+    uint maxprec = MIN(zfp->maxprec, (uint)MAX(0, emax - zfp->minexp + 2 * (codec->dims + 1)));
+    bits += codec->ebits;
+    bits += scan_ints(stream, codec, maxbits - bits, maxprec);
+  }
+
+  return bits;
+}
+
+/* skip one compressed block, including any padding; return bits skipped */
+static uint
+scan_block(const zfp_stream* zfp, const scan_codec* codec)
+{
+  uint bits;
+
+  if (!zfp->raw)
+    bits = scan_block_mode(zfp, codec, zfp->maxbits);
+  else if (stream_read_bit(zfp->stream)) {
+    /* block is stored verbatim */
+    bits = 1 + codec->size * codec->intprec;
+    stream_skip(zfp->stream, bits - 1);
+  }
+  else
+    bits = 1 + scan_block_mode(zfp, codec, zfp->maxbits - 1);
+
+  /* every block occupies at least minbits bits */
+  if (bits < zfp->minbits) {
+    stream_skip(zfp->stream, zfp->minbits - bits);
+    bits = zfp->minbits;
+  }
+
+  return bits;
+}
+
+/* record bit offsets of chunks + 1 chunk boundaries, relative to the current
+   stream position, by skipping over blocks; chunks partition blocks as in
+   parallel compression */
+static zfp_bool
+scan_chunks(zfp_stream* zfp, zfp_type type, uint dims, size_t blocks, size_t chunks, uint64* offset)
+{
+  scan_codec codec;
+  size_t block = 0;
+  size_t chunk;
+
+  if (!scan_codec_init(&codec, type, dims))
+    return zfp_false;
+
+  for (chunk = 0; chunk <= chunks; chunk++) {
+    size_t end = (size_t)(((uint64)blocks * (uint64)chunk) / chunks);
+    if (zfp->minbits == zfp->maxbits) {
+      /* blocks of fixed size are located directly */
+      offset[chunk] = (uint64)end * zfp->maxbits;
+      block = end;
+    }
+    else {
+      uint64 bits = chunk ? offset[chunk - 1] : 0;
+      for (; block < end; block++)
+        bits += scan_block(zfp, &codec);
+      offset[chunk] = bits;
+    }
+  }
+
+  return zfp_true;
+}
@@ -0,0 +1,148 @@
+/* sparse fields of which only blocks marked active are stored */
+
+/* whether stream and field support sparse (de)compression */
+static zfp_bool
+is_sparse_supported(const zfp_stream* zfp, const zfp_field* field)
+{
+  return zfp_field_dimensionality(field) && is_plain_field(field) && block_maximum_bits(zfp, field);
+}
+
+/* compress block bitmap followed by active blocks of field or bricks */
+static size_t
+sparse_compress(zfp_stream* zfp, const zfp_field* field, const uint8* active, const void* bricks)
+{
+  /* function tables [scalar type] */
+  uint (*ftable[4])(zfp_stream*, const zfp_field*, size_t) = {
+    compress_block_int32,
+    compress_block_int64,
+    compress_block_float,
+    compress_block_double,
+  };
+  uint (*btable[4])(zfp_stream*, uint, const void*) = {
+    encode_field_block_int32,
+    encode_field_block_int64,
+    encode_field_block_float,
+    encode_field_block_double,
+  };
+  uint dims = zfp_field_dimensionality(field);
+  size_t blocks = field_blocks(field);
+  size_t size = ((size_t)1 << (2 * dims)) * zfp_type_size(field->type);
+  const uchar* brick = (const uchar*)bricks;
+  size_t b, i;
+
+  if (!active || !is_sparse_supported(zfp, field))
+    return 0;
+
+  /* bitmap of one bit per block in raster order, 64 blocks at a time */
+  for (b = 0; b < blocks; b += 64) {
+    size_t n = MIN(blocks - b, (size_t)64);
+    uint64 word = 0;
+    for (i = 0; i < n; i++)
+      if (active[b + i])
+        word += (uint64)1 << i;
+    stream_write_bits(zfp->stream, word, (uint)n);
+  }
+
+  /* active blocks follow in raster order; inactive blocks are not touched */
+  zfp_trace_begin("zfp:compress_sparse");
+  for (b = 0; b < blocks; b++)
+    if (active[b]) {
+      if (brick) {
+        btable[field->type - zfp_type_int32](zfp, dims, brick);
+        brick += size;
+      }
+      else
+        ftable[field->type - zfp_type_int32](zfp, field, b);
+    }
+  zfp_trace_end();
+  stream_flush(zfp->stream);
+
+  return stream_size(zfp->stream);
+}
+
+/* read block bitmap without advancing stream; return number of active blocks */
+static size_t
+sparse_map(zfp_stream* zfp, const zfp_field* field, uint8* active)
+{
+  size_t blocks = field_blocks(field);
+  size_t base = stream_rtell(zfp->stream);
+  size_t count = 0;
+  size_t b, i;
+
+  if (!is_sparse_supported(zfp, field))
+    return 0;
+
+  for (b = 0; b < blocks; b += 64) {
+    size_t n = MIN(blocks - b, (size_t)64);
+    uint64 word = stream_read_bits(zfp->stream, (uint)n);
+    for (i = 0; i < n; i++, word >>= 1) {
+      count += (size_t)(word & 1u);
+      if (active)
+        active[b + i] = (uint8)(word & 1u);
+    }
+  }
+  stream_rseek(zfp->stream, base);
+
+  return count;
+}
+
+/* decompress active blocks into field or bricks */
+static size_t
+sparse_decompress(zfp_stream* zfp, zfp_field* field, uint8* active, void* bricks)
+{
+  /* function tables [scalar type] */
+  uint (*ftable[4])(zfp_stream*, zfp_field*, size_t) = {
+    decompress_block_int32,
+    decompress_block_int64,
+    decompress_block_float,
+    decompress_block_double,
+  };
+  uint (*btable[4])(zfp_stream*, uint, void*) = {
+    decode_field_block_int32,
+    decode_field_block_int64,
+    decode_field_block_float,
+    decode_field_block_double,
+  };
+  uint dims = zfp_field_dimensionality(field);
+  size_t blocks = field_blocks(field);
+  size_t size = ((size_t)1 << (2 * dims)) * zfp_type_size(field->type);
+  uchar* brick = (uchar*)bricks;
+  size_t map, next;
+  size_t b, i;
+
+  if (!is_sparse_supported(zfp, field))
+    return 0;
+
+  /* alternate between reading the bitmap 64 bits at a time and decoding
+     the active blocks it lists so that the bitmap need not be buffered */
+  map = stream_rtell(zfp->stream);
+  next = map + blocks;
+  zfp_trace_begin("zfp:decompress_sparse");
+  for (b = 0; b < blocks; b += 64) {
+    size_t n = MIN(blocks - b, (size_t)64);
+    uint64 word;
+    stream_rseek(zfp->stream, map);
+    word = stream_read_bits(zfp->stream, (uint)n);
+    map += n;
+    stream_rseek(zfp->stream, next);
+    for (i = 0; i < n; i++) {
+      uint bit = (uint)((word >> i) & 1u);
+      if (active)
+        active[b + i] = (uint8)bit;
+      if (bit) {
+        if (brick) {
+          btable[field->type - zfp_type_int32](zfp, dims, brick);
+          brick += size;
+        }
+        else
+          ftable[field->type - zfp_type_int32](zfp, field, b + i);
+      }
+    }
+    next = stream_rtell(zfp->stream);
+  }
+  zfp_trace_end();
+  stream_rseek(zfp->stream, next);
+  stream_align(zfp->stream);
+
+  return stream_size(zfp->stream);
+}
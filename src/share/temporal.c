@@ -0,0 +1,280 @@
+/* temporal delta compression of time series against the previous step */
+
+static zfp_bool decompress_field(zfp_stream* zfp, zfp_field* field);
+
+struct zfp_temporal {
+  zfp_field field;  /* type and dimensions of each step (data unused) */
+  uint interval;    /* steps between keyframes (zero for first only) */
+  uint frames;      /* steps since and including last keyframe */
+  zfp_bool valid;   /* true if reference holds previous reconstruction */
+  void* reference;  /* contiguous decoder reconstruction of previous step */
+  void* residual;   /* contiguous residual of current step */
+};
+
+/* true if field has the type and dimensions of the series */
+static zfp_bool
+temporal_match(const zfp_temporal* codec, const zfp_field* field)
+{
+  return field->type == codec->field.type &&
+         field->nx == codec->field.nx && field->ny == codec->field.ny &&
+         field->nz == codec->field.nz && field->nw == codec->field.nw;
+}
+
+/* type in which residuals are compressed; reversible floating-point
+   residuals are differences of bit patterns and therefore exact */
+static zfp_type
+temporal_residual_type(zfp_type type, const zfp_stream* zfp)
+{
+  if (zfp_stream_compression_mode(zfp) == zfp_mode_reversible)
+    switch (type) {
+      case zfp_type_float:
+        return zfp_type_int32;
+      case zfp_type_double:
+        return zfp_type_int64;
+      default:
+        break;
+    }
+  return type;
+}
+
+/* gather (strided) field into contiguous buffer or scatter buffer to field */
+static void
+temporal_copy(const zfp_field* field, void* buffer, zfp_bool gather)
+{
+  const size_t bytes = zfp_type_size(field->type);
+  const size_t nx = MAX(field->nx, 1u);
+  const size_t ny = MAX(field->ny, 1u);
+  const size_t nz = MAX(field->nz, 1u);
+  const size_t nw = MAX(field->nw, 1u);
+  int s[4] = { 0, 0, 0, 0 };
+  uchar* q = (uchar*)buffer;
+  size_t x, y, z, w;
+
+  zfp_field_stride(field, s);
+  for (w = 0; w < nw; w++)
+    for (z = 0; z < nz; z++)
+      for (y = 0; y < ny; y++) {
+        uchar* p = (uchar*)field->data + ((ptrdiff_t)y * s[1] + (ptrdiff_t)z * s[2] + (ptrdiff_t)w * s[3]) * (ptrdiff_t)bytes;
+        if (s[0] == 1) {
+          if (gather)
+            memcpy(q, p, nx * bytes);
+          else
+            memcpy(p, q, nx * bytes);
+          q += nx * bytes;
+        }
+        else
+          for (x = 0; x < nx; x++, p += (ptrdiff_t)s[0] * (ptrdiff_t)bytes, q += bytes) {
+            if (gather)
+              memcpy(q, p, bytes);
+            else
+              memcpy(p, q, bytes);
+          }
+      }
+}
+
+/* replace n values with their residuals against reference; integer
+   residuals wrap around */
+static void
+temporal_subtract(zfp_type type, void* values, const void* reference, size_t n)
+{
+  size_t i;
+  switch (type) {
+    case zfp_type_int32: {
+      uint32* v = (uint32*)values;
+      const uint32* r = (const uint32*)reference;
+      for (i = 0; i < n; i++)
+        v[i] -= r[i];
+      } break;
+    case zfp_type_int64: {
+      uint64* v = (uint64*)values;
+      const uint64* r = (const uint64*)reference;
+      for (i = 0; i < n; i++)
+        v[i] -= r[i];
+      } break;
+    case zfp_type_float: {
+      float* v = (float*)values;
+      const float* r = (const float*)reference;
+      for (i = 0; i < n; i++)
+        v[i] -= r[i];
+      } break;
+    case zfp_type_double: {
+      double* v = (double*)values;
+      const double* r = (const double*)reference;
+      for (i = 0; i < n; i++)
+        v[i] -= r[i];
+      } break;
+    default:
+      break;
+  }
+}
+
+/* add n residuals to reference, turning it into the current reconstruction */
+static void
+temporal_add(zfp_type type, void* reference, const void* residual, size_t n)
+{
+  size_t i;
+  switch (type) {
+    case zfp_type_int32: {
+      uint32* r = (uint32*)reference;
+      const uint32* d = (const uint32*)residual;
+      for (i = 0; i < n; i++)
+        r[i] += d[i];
+      } break;
+    case zfp_type_int64: {
+      uint64* r = (uint64*)reference;
+      const uint64* d = (const uint64*)residual;
+      for (i = 0; i < n; i++)
+        r[i] += d[i];
+      } break;
+    case zfp_type_float: {
+      float* r = (float*)reference;
+      const float* d = (const float*)residual;
+      for (i = 0; i < n; i++)
+        r[i] += d[i];
+      } break;
+    case zfp_type_double: {
+      double* r = (double*)reference;
+      const double* d = (const double*)residual;
+      for (i = 0; i < n; i++)
+        r[i] += d[i];
+      } break;
+    default:
+      break;
+  }
+}
+
+/* decode field just compressed at given bit offset, as the decoder will */
+static zfp_bool
+temporal_decode(const zfp_stream* zfp, size_t offset, zfp_field* field)
+{
+  zfp_stream dec = *zfp;
+  zfp_bool status;
+
+  dec.stream = stream_open(stream_data(zfp->stream), stream_capacity(zfp->stream));
+  if (!dec.stream)
+    return zfp_false;
+  dec.exec.policy = zfp_exec_serial;
+  dec.index = NULL;
+  dec.scratch = NULL;
+  dec.stats = NULL;
+  dec.verify = NULL;
+  stream_rseek(dec.stream, offset);
+  status = decompress_field(&dec, field);
+  stream_close(dec.stream);
+
+  return status;
+}
+
+/* allocate codec for series of fields shaped like field */
+static zfp_temporal*
+temporal_create(const zfp_field* field, uint interval)
+{
+  zfp_temporal* codec;
+  size_t bytes;
+
+  if (!is_plain_field(field) || !zfp_field_dimensionality(field))
+    return NULL;
+
+  codec = (zfp_temporal*)malloc(sizeof(zfp_temporal));
+  if (!codec)
+    return NULL;
+
+  codec->field = *field;
+  codec->field.sx = codec->field.sy = codec->field.sz = codec->field.sw = 0;
+  codec->field.data = NULL;
+  codec->interval = interval;
+  codec->frames = 0;
+  codec->valid = zfp_false;
+
+  bytes = zfp_field_size(field, NULL) * zfp_type_size(field->type);
+  codec->reference = malloc(bytes);
+  codec->residual = malloc(bytes);
+  if (!codec->reference || !codec->residual) {
+    zfp_temporal_free(codec);
+    return NULL;
+  }
+
+  return codec;
+}
+
+/* compress field as keyframe or residual of previous step */
+static size_t
+temporal_compress(zfp_temporal* codec, zfp_stream* zfp, const zfp_field* field)
+{
+  const zfp_bool reversible = (zfp_stream_compression_mode(zfp) == zfp_mode_reversible);
+  const size_t n = zfp_field_size(field, NULL);
+  zfp_field residual = codec->field;
+  size_t offset;
+  size_t size;
+
+  if (!temporal_match(codec, field))
+    return 0;
+
+  offset = stream_wtell(zfp->stream);
+  if (zfp_temporal_keyframe(codec)) {
+    size = zfp_compress(zfp, field);
+    codec->valid = zfp_false;
+    if (!size)
+      return 0;
+    /* predict next step from the decoder's reconstruction of this one */
+    residual.data = codec->reference;
+    if (reversible)
+      temporal_copy(field, codec->reference, zfp_true);
+    else if (!temporal_decode(zfp, offset, &residual))
+      return 0;
+    codec->valid = zfp_true;
+    codec->frames = 0;
+  }
+  else {
+    residual.type = temporal_residual_type(field->type, zfp);
+    residual.data = codec->residual;
+    temporal_copy(field, codec->residual, zfp_true);
+    temporal_subtract(residual.type, codec->residual, codec->reference, n);
+    size = zfp_compress(zfp, &residual);
+    /* lossy residuals are replaced with their reconstruction */
+    if (!size || (!reversible && !temporal_decode(zfp, offset, &residual))) {
+      codec->valid = zfp_false;
+      return 0;
+    }
+    temporal_add(residual.type, codec->reference, codec->residual, n);
+  }
+  codec->frames++;
+
+  return size;
+}
+
+/* decompress keyframe or residual and reconstruct field */
+static size_t
+temporal_decompress(zfp_temporal* codec, zfp_stream* zfp, zfp_field* field)
+{
+  const size_t n = zfp_field_size(field, NULL);
+  zfp_field residual = codec->field;
+  size_t size;
+
+  if (!temporal_match(codec, field))
+    return 0;
+
+  if (zfp_temporal_keyframe(codec)) {
+    size = zfp_decompress(zfp, field);
+    codec->valid = zfp_false;
+    if (!size)
+      return 0;
+    temporal_copy(field, codec->reference, zfp_true);
+    codec->valid = zfp_true;
+    codec->frames = 0;
+  }
+  else {
+    residual.type = temporal_residual_type(field->type, zfp);
+    residual.data = codec->residual;
+    size = zfp_decompress(zfp, &residual);
+    if (!size) {
+      codec->valid = zfp_false;
+      return 0;
+    }
+    temporal_add(residual.type, codec->reference, codec->residual, n);
+    temporal_copy(field, codec->reference, zfp_false);
+  }
+  codec->frames++;
+
+  return size;
+}
@@ -0,0 +1,140 @@
+#ifdef ZFP_WITH_THREADS
+#include <limits.h>
+#include <unistd.h>
+
+/* number of threads to use, including calling thread */
+static uint
+thread_count_threads(const zfp_stream* stream)
+{
+  uint count = stream->exec.params.threads.threads;
+  /* if no thread count is specified, use one thread per online processor */
+  if (!count) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    count = cpus > 0 ? (uint)MIN(cpus, (long)UINT_MAX) : 1;
+  }
+  return count;
+}
+
+/* pool of worker threads owned by stream, started on first use */
+static pool*
+pool_threads(zfp_stream* stream)
+{
+  pool* p = (pool*)stream->exec.params.threads.pool;
+  if (!p) {
+    /* calling thread serves as one of the threads */
+    p = pool_alloc(thread_count_threads(stream) - 1);
+    stream->exec.params.threads.pool = p;
+  }
+  return p;
+}
+
+/* chunks per thread so that idle threads can claim remaining work */
+#define THREADS_CHUNKS_PER_THREAD 8
+/* fewest blocks per chunk when over-decomposing, to amortize concatenation */
+#define THREADS_MIN_CHUNK_BLOCKS 256
+
+/* number of chunks to partition array into */
+static size_t
+chunk_count_threads(const zfp_stream* stream, size_t blocks, uint threads)
+{
+  size_t chunk_size = stream->exec.params.threads.chunk_size;
+  size_t chunks;
+  if (chunk_size)
+    chunks = (blocks + chunk_size - 1) / chunk_size;
+  else {
+    /* over-decompose since chunks are claimed dynamically */
+    chunks = MIN((size_t)threads * THREADS_CHUNKS_PER_THREAD, blocks / THREADS_MIN_CHUNK_BLOCKS);
+    chunks = MAX(chunks, threads);
+  }
+  /* each chunk must contain at least one block */
+  return MIN(chunks, blocks);
+}
+
+/* number of chunks to decompress in parallel (zero if blocks cannot be located) */
+static size_t
+decompress_chunk_count_threads(const zfp_stream* stream, size_t blocks, uint threads)
+{
+  const zfp_index* index = stream->index;
+  /* blocks of fixed size may be partitioned arbitrarily */
+  if (stream->minbits == stream->maxbits)
+    return chunk_count_threads(stream, blocks, threads);
+  /* variable-size blocks must be partitioned as recorded in the index */
+  if (index && index->chunks && index->chunks <= blocks)
+    return index->chunks;
+  return 0;
+}
+
+/* work shared by pool threads (de)compressing chunks of a field */
+typedef struct {
+  const zfp_stream* stream; /* compressed stream */
+  const zfp_field* field;   /* field to (de)compress */
+  bitstream** bs;           /* per-chunk bit streams */
+  size_t blocks;            /* number of blocks in field */
+  size_t chunks;            /* number of chunks */
+  zfp_stream_stats* stats;  /* per-chunk statistics (may be NULL) */
+} work_threads;
+
+/* compress field of given number of blocks by applying task to each chunk */
+static void
+compress_threads(zfp_stream* stream, const zfp_field* field, size_t blocks, task_pool task)
+{
+  pool* p = pool_threads(stream);
+  uint threads = p ? p->workers + 1 : 1;
+  size_t chunks = chunk_count_threads(stream, blocks, threads);
+  work_threads work;
+
+  /* allocate per-chunk streams */
+  bitstream* s = zfp_stream_bit_stream(stream);
+  bitstream** bs = compress_init_par(stream, field, chunks, blocks);
+
+  /* without them, e.g., under a host scratch limit, compress in place as one chunk */
+  if (!bs) {
+    bs = &s;
+    chunks = 1;
+  }
+
+  /* compress chunks of blocks in parallel */
+  work.stream = stream;
+  work.field = field;
+  work.bs = bs;
+  work.blocks = blocks;
+  work.chunks = chunks;
+  work.stats = stats_init_par(stream, chunks);
+  pool_run(p, task, &work, chunks);
+  stats_finish_par(stream, work.stats, chunks);
+
+  /* concatenate per-chunk streams */
+  if (bs != &s)
+    compress_finish_par(stream, bs, chunks, threads);
+}
+
+/* decompress field by applying task to each chunk; return false if not done */
+static zfp_bool
+decompress_threads(zfp_stream* stream, const zfp_field* field, size_t blocks, task_pool task)
+{
+  pool* p = pool_threads(stream);
+  uint threads = p ? p->workers + 1 : 1;
+  size_t chunks = decompress_chunk_count_threads(stream, blocks, threads);
+  work_threads work;
+
+  /* allocate per-chunk streams; caller decompresses serially if blocks cannot be located */
+  bitstream** bs = chunks ? decompress_init_par(stream, chunks, blocks) : NULL;
+  if (!bs)
+    return zfp_false;
+
+  /* decompress chunks of blocks in parallel */
+  work.stream = stream;
+  work.field = field;
+  work.bs = bs;
+  work.blocks = blocks;
+  work.chunks = chunks;
+  work.stats = stats_init_par(stream, chunks);
+  pool_run(p, task, &work, chunks);
+  stats_finish_par(stream, work.stats, chunks);
+
+  /* release per-chunk streams and position stream at end of field */
+  decompress_finish_par(stream, bs, chunks, blocks);
+  return zfp_true;
+}
+
+#endif
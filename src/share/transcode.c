@@ -0,0 +1,52 @@
+/* rate transcoding of fixed-rate streams by truncating blocks */
+
+/* copy the first dbits <= sbits bits of each of n sbits-bit blocks */
+static void
+transcode_blocks(bitstream* dst, bitstream* src, size_t n, uint dbits, uint sbits)
+{
+  for (; n--;) {
+    stream_copy(dst, src, dbits);
+    if (sbits > dbits)
+      stream_skip(src, sbits - dbits);
+  }
+}
+
+#ifdef _OPENMP
+/* transcode blocks in parallel chunks that each begin on a word boundary */
+static zfp_bool
+transcode_blocks_omp(zfp_stream* dst, zfp_stream* src, size_t blocks)
+{
+  uint threads = thread_count_omp(dst);
+  size_t dbase = stream_wtell(dst->stream);
+  size_t sbase = stream_rtell(src->stream);
+  size_t chunks;
+  int chunk;
+
+#if defined(BIT_STREAM_STRIDED) || defined(BIT_STREAM_CALLBACK)
+  /* private streams over the same buffer support neither stride nor I/O */
+  return zfp_false;
+#endif
+  /* chunks may be written concurrently only if they do not share words */
+  if (threads < 2 || dst->maxbits % stream_word_bits || dbase % stream_word_bits)
+    return zfp_false;
+
+  chunks = chunk_count_omp(dst, blocks, threads);
+  #pragma omp parallel for num_threads(threads)
+  for (chunk = 0; chunk < (int)chunks; chunk++) {
+    size_t first = blocks * chunk / chunks;
+    size_t last = blocks * (chunk + 1) / chunks;
+    bitstream* d = stream_open(stream_data(dst->stream), stream_capacity(dst->stream));
+    bitstream* s = stream_open(stream_data(src->stream), stream_capacity(src->stream));
+    stream_wseek(d, dbase + first * dst->maxbits);
+    stream_rseek(s, sbase + first * src->maxbits);
+    transcode_blocks(d, s, last - first, dst->maxbits, src->maxbits);
+    stream_flush(d);
+    stream_close(d);
+    stream_close(s);
+  }
+
+  stream_wseek(dst->stream, dbase + blocks * dst->maxbits);
+  stream_rseek(src->stream, sbase + blocks * src->maxbits);
+  return zfp_true;
+}
+#endif
@@ -0,0 +1,437 @@
+#ifndef SYCLZFP_DECODE_H
+#define SYCLZFP_DECODE_H
+
+#include "shared.h"
+
+namespace syclZFP
+{
+
+/* map two's complement signed integer to negabinary unsigned integer */
+inline
+long long int uint2int(unsigned long long int x)
+{
+	return (x ^0xaaaaaaaaaaaaaaaaull) - 0xaaaaaaaaaaaaaaaaull;
+}
+
+inline
+int uint2int(unsigned int x)
+{
+	return (x ^0xaaaaaaaau) - 0xaaaaaaaau;
+}
+
+// reader of one block; words are loaded only once their bits are needed so
+// that the last block never reads past the end of the stream
+class BlockReader
+{
+private:
+  const Word *m_words; // next word to load
+  Word m_buffer;       // unread bits of current word
+  uint m_bits;         // number of unread bits in buffer
+
+  void refill()
+  {
+    m_buffer = *m_words++;
+    m_bits = Wsize;
+  }
+
+public:
+  BlockReader(const Word *b, const int &maxbits, const size_t &block_idx)
+  {
+    const size_t offset = block_idx * maxbits;
+    m_words = b + offset / Wsize;
+    refill();
+    m_buffer >>= offset % Wsize;
+    m_bits -= uint(offset % Wsize);
+  }
+
+  uint read_bit()
+  {
+    if(!m_bits)
+    {
+      refill();
+    }
+    uint bit = m_buffer & 1u;
+    m_buffer >>= 1;
+    --m_bits;
+    return bit;
+  }
+
+  // note this assumes that n_bits is <= 64
+  uint64 read_bits(const uint &n_bits)
+  {
+    if(!n_bits)
+    {
+      return 0;
+    }
+    if(!m_bits)
+    {
+      refill();
+    }
+    uint64 bits;
+    if(n_bits <= m_bits)
+    {
+      // shifting by the word size is undefined
+      bits = n_bits == Wsize ? m_buffer : m_buffer & (((Word)1 << n_bits) - 1);
+      m_buffer = n_bits == Wsize ? 0 : m_buffer >> n_bits;
+      m_bits -= n_bits;
+    }
+    else
+    {
+      // n_bits straddles the word boundary
+      const uint first_read = m_bits;
+      const uint next_read = n_bits - first_read;
+      bits = m_buffer;
+      refill();
+      bits += (m_buffer & (((Word)1 << next_read) - 1)) << first_read;
+      m_buffer >>= next_read;
+      m_bits -= next_read;
+    }
+    return bits;
+  }
+
+}; // block reader
+
+template<typename Scalar, int Size, typename UInt>
+inline
+void decode_ints(BlockReader &reader, uint &max_bits, UInt *data)
+{
+  const int intprec = get_precision<Scalar>();
+  for (int i = 0; i < Size; i++)
+    data[i] = 0;
+  uint64 x;
+  const uint kmin = 0;
+  int bits = max_bits;
+  for (uint k = intprec, n = 0; bits && k-- > kmin;)
+  {
+    // read bit plane
+    uint m = MIN(n, bits);
+    bits -= m;
+    x = reader.read_bits(m);
+    for (; n < Size && bits && (bits--, reader.read_bit()); x += (Word) 1 << n++)
+      for (; n < (Size - 1) && bits && (bits--, !reader.read_bit()); n++);
+
+    // deposit bit plane
+    for (int i = 0; i < Size; i++, x >>= 1)
+    {
+      data[i] += (UInt)(x & 1u) << k;
+    }
+  }
+}
+
+// decode block of more than 64 integers, whose bit planes do not fit in a word
+template<typename Scalar, int Size, typename UInt>
+inline
+void decode_many_ints(BlockReader &reader, uint &max_bits, UInt *data)
+{
+  const int intprec = get_precision<Scalar>();
+  for (int i = 0; i < Size; i++)
+    data[i] = 0;
+  const uint kmin = 0;
+  int bits = max_bits;
+  for (uint k = intprec, n = 0; bits && k-- > kmin;)
+  {
+    // decode first n bits of bit plane #k
+    uint m = MIN(n, bits);
+    bits -= m;
+    for (uint i = 0; i < m; i++)
+      if (reader.read_bit())
+        data[i] += (UInt)1 << k;
+    // unary run-length decode remainder of bit plane
+    for (; n < Size && bits && (bits--, reader.read_bit()); data[n] += (UInt)1 << k, n++)
+      for (; n < (Size - 1) && bits && (bits--, !reader.read_bit()); n++);
+  }
+}
+
+template<int BlockSize>
+struct inv_transform;
+
+template<>
+struct inv_transform<256>
+{
+  template<typename Int>
+  void inv_xform(Int *p)
+  {
+    uint x, y, z, w;
+    /* transform along w */
+    for (z = 0; z < 4; z++)
+      for (y = 0; y < 4; y++)
+        for (x = 0; x < 4; x++)
+          inv_lift<Int,64>(p + 1 * x + 4 * y + 16 * z);
+    /* transform along z */
+    for (y = 0; y < 4; y++)
+      for (x = 0; x < 4; x++)
+        for (w = 0; w < 4; w++)
+          inv_lift<Int,16>(p + 64 * w + 1 * x + 4 * y);
+    /* transform along y */
+    for (x = 0; x < 4; x++)
+      for (w = 0; w < 4; w++)
+        for (z = 0; z < 4; z++)
+          inv_lift<Int,4>(p + 16 * z + 64 * w + 1 * x);
+    /* transform along x */
+    for (w = 0; w < 4; w++)
+      for (z = 0; z < 4; z++)
+        for (y = 0; y < 4; y++)
+          inv_lift<Int,1>(p + 4 * y + 16 * z + 64 * w);
+  }
+
+};
+
+template<>
+struct inv_transform<64>
+{
+  template<typename Int>
+  void inv_xform(Int *p)
+  {
+    uint x, y, z;
+    /* transform along z */
+    for (y = 0; y < 4; y++)
+      for (x = 0; x < 4; x++)
+        inv_lift<Int,16>(p + 1 * x + 4 * y);
+    /* transform along y */
+    for (x = 0; x < 4; x++)
+      for (z = 0; z < 4; z++)
+        inv_lift<Int,4>(p + 16 * z + 1 * x);
+    /* transform along x */
+    for (z = 0; z < 4; z++)
+      for (y = 0; y < 4; y++)
+        inv_lift<Int,1>(p + 4 * y + 16 * z);
+  }
+
+};
+
+template<>
+struct inv_transform<16>
+{
+  template<typename Int>
+  void inv_xform(Int *p)
+  {
+
+    for(int x = 0; x < 4; ++x)
+    {
+      inv_lift<Int,4>(p + 1 * x);
+    }
+    for(int y = 0; y < 4; ++y)
+    {
+      inv_lift<Int,1>(p + 4 * y);
+    }
+  }
+
+};
+
+template<>
+struct inv_transform<4>
+{
+  template<typename Int>
+  void inv_xform(Int *p)
+  {
+    inv_lift<Int,1>(p);
+  }
+
+};
+
+template<typename Scalar, int BlockSize>
+void zfp_decode(BlockReader &reader, Scalar *fblock, uint maxbits)
+{
+  typedef typename zfp_traits<Scalar>::UInt UInt;
+  typedef typename zfp_traits<Scalar>::Int Int;
+
+  uint s_cont = 1;
+  //
+  // there is no skip path for integers so just continue
+  //
+  if(!is_int<Scalar>())
+  {
+    s_cont = reader.read_bit();
+  }
+
+  if(s_cont)
+  {
+    uint ebits = get_ebits<Scalar>() + 1;
+
+    int emax = 0;
+    if(!is_int<Scalar>())
+    {
+      // read in the shared exponent
+      emax = int(reader.read_bits(ebits - 1)) - get_ebias<Scalar>();
+    }
+    else
+    {
+      // no exponent bits
+      ebits = 0;
+    }
+
+    maxbits -= ebits;
+
+    UInt ublock[BlockSize];
+
+    if(BlockSize > 64)
+      decode_many_ints<Scalar, BlockSize, UInt>(reader, maxbits, ublock);
+    else
+      decode_ints<Scalar, BlockSize, UInt>(reader, maxbits, ublock);
+
+    Int iblock[BlockSize];
+    const unsigned char *perm = get_perm<BlockSize>();
+    for(int i = 0; i < BlockSize; ++i)
+    {
+      iblock[perm[i]] = uint2int(ublock[i]);
+    }
+
+    inv_transform<BlockSize> trans;
+    trans.inv_xform(iblock);
+
+    Scalar inv_w = dequantize<Int, Scalar>(1, emax);
+
+    for(int i = 0; i < BlockSize; ++i)
+    {
+      fblock[i] = inv_w * (Scalar)iblock[i];
+    }
+  }
+}
+
+// scatter block of 4^Dims values to origin p, writing only the
+// n[0] * ... * n[Dims - 1] values of partial blocks
+template<int Dims>
+struct scatter;
+
+template<>
+struct scatter<1>
+{
+  template<typename Scalar>
+  static void partial(const Scalar* q, Scalar* p, const uint n[4], const int s[4])
+  {
+    uint x;
+    for (x = 0; x < n[0]; x++)
+      p[(ptrdiff_t)x * s[0]] = q[x];
+  }
+
+  template<typename Scalar>
+  static void full(const Scalar* q, Scalar* p, const int s[4])
+  {
+    uint x;
+    for (x = 0; x < 4; x++, p += s[0])
+      *p = *q++;
+  }
+};
+
+template<>
+struct scatter<2>
+{
+  template<typename Scalar>
+  static void partial(const Scalar* q, Scalar* p, const uint n[4], const int s[4])
+  {
+    uint x, y;
+    for (y = 0; y < n[1]; y++, p += s[1] - (ptrdiff_t)n[0] * s[0])
+      for (x = 0; x < n[0]; x++, p += s[0])
+        *p = q[4 * y + x];
+  }
+
+  template<typename Scalar>
+  static void full(const Scalar* q, Scalar* p, const int s[4])
+  {
+    uint x, y;
+    for (y = 0; y < 4; y++, p += s[1] - 4 * s[0])
+      for (x = 0; x < 4; x++, p += s[0])
+        *p = *q++;
+  }
+};
+
+template<>
+struct scatter<3>
+{
+  template<typename Scalar>
+  static void partial(const Scalar* q, Scalar* p, const uint n[4], const int s[4])
+  {
+    uint x, y, z;
+    for (z = 0; z < n[2]; z++, p += s[2] - (ptrdiff_t)n[1] * s[1])
+      for (y = 0; y < n[1]; y++, p += s[1] - (ptrdiff_t)n[0] * s[0])
+        for (x = 0; x < n[0]; x++, p += s[0])
+          *p = q[16 * z + 4 * y + x];
+  }
+
+  template<typename Scalar>
+  static void full(const Scalar* q, Scalar* p, const int s[4])
+  {
+    uint x, y, z;
+    for (z = 0; z < 4; z++, p += s[2] - 4 * s[1])
+      for (y = 0; y < 4; y++, p += s[1] - 4 * s[0])
+        for (x = 0; x < 4; x++, p += s[0])
+          *p = *q++;
+  }
+};
+
+template<>
+struct scatter<4>
+{
+  template<typename Scalar>
+  static void partial(const Scalar* q, Scalar* p, const uint n[4], const int s[4])
+  {
+    uint x, y, z, w;
+    for (w = 0; w < n[3]; w++, p += s[3] - (ptrdiff_t)n[2] * s[2])
+      for (z = 0; z < n[2]; z++, p += s[2] - (ptrdiff_t)n[1] * s[1])
+        for (y = 0; y < n[1]; y++, p += s[1] - (ptrdiff_t)n[0] * s[0])
+          for (x = 0; x < n[0]; x++, p += s[0])
+            *p = q[64 * w + 16 * z + 4 * y + x];
+  }
+
+  template<typename Scalar>
+  static void full(const Scalar* q, Scalar* p, const int s[4])
+  {
+    uint x, y, z, w;
+    for (w = 0; w < 4; w++, p += s[3] - 4 * s[2])
+      for (z = 0; z < 4; z++, p += s[2] - 4 * s[1])
+        for (y = 0; y < 4; y++, p += s[1] - 4 * s[0])
+          for (x = 0; x < 4; x++, p += s[0])
+            *p = *q++;
+  }
+};
+
+//
+// decode field of Dims dimensions with one work-item per block; returns the
+// number of bytes of the compressed stream
+//
+template<class Scalar, int Dims>
+size_t decode(sycl::queue &q,
+              const Shape &shape,
+              const Word *stream,
+              Scalar *d_data,
+              const int maxbits)
+{
+  const int BlockSize = 1 << (2 * Dims);
+  const size_t blocks = total_blocks(shape);
+  const size_t stream_bytes = calc_device_mem(blocks, maxbits);
+  if(!blocks)
+  {
+    return 0;
+  }
+
+  q.parallel_for(sycl::range<1>(blocks), [=](sycl::id<1> id)
+  {
+    const size_t block_idx = id[0];
+    BlockReader reader(stream, maxbits, block_idx);
+
+    Scalar result[BlockSize];
+    for(int i = 0; i < BlockSize; ++i)
+    {
+      result[i] = 0;
+    }
+
+    zfp_decode<Scalar, BlockSize>(reader, result, maxbits);
+
+    uint n[4];
+    bool partial;
+    Scalar *p = d_data + block_origin<Dims>(shape, block_idx, n, partial);
+    if(partial)
+    {
+      scatter<Dims>::partial(result, p, n, shape.stride);
+    }
+    else
+    {
+      scatter<Dims>::full(result, p, shape.stride);
+    }
+  }).wait();
+
+  return stream_bytes;
+}
+
+}  // namespace syclZFP
+#endif
@@ -0,0 +1,569 @@
+#ifndef SYCLZFP_ENCODE_H
+#define SYCLZFP_ENCODE_H
+
+#include "shared.h"
+
+namespace syclZFP
+{
+
+// maximum number of bit planes to encode
+static int
+precision(int maxexp, int maxprec, int minexp)
+{
+  return MIN(maxprec, MAX(0, maxexp - minexp + 8));
+}
+
+template<typename Scalar>
+inline
+void pad_block(Scalar *p, uint n, uint s)
+{
+  switch (n)
+  {
+    case 0:
+      p[0 * s] = 0;
+      /* FALLTHROUGH */
+    case 1:
+      p[1 * s] = p[0 * s];
+      /* FALLTHROUGH */
+    case 2:
+      p[2 * s] = p[1 * s];
+      /* FALLTHROUGH */
+    case 3:
+      p[3 * s] = p[0 * s];
+      /* FALLTHROUGH */
+    default:
+      break;
+  }
+}
+
+template<class Scalar>
+static int
+exponent(Scalar x)
+{
+  if (x > 0) {
+    // ilogb(x) + 1 is the exponent frexp would return; computing it in
+    // Scalar precision avoids double arithmetic on devices without fp64
+    int e = sycl::ilogb(x) + 1;
+    // clamp exponent in case x is denormalized
+    return MAX(e, 1 - get_ebias<Scalar>());
+  }
+  return -get_ebias<Scalar>();
+}
+
+template<class Scalar, int BlockSize>
+static int
+max_exponent(const Scalar* p)
+{
+  Scalar max_val = 0;
+  for(int i = 0; i < BlockSize; ++i)
+  {
+    Scalar f = sycl::fabs(p[i]);
+    max_val = MAX(max_val, f);
+  }
+  return exponent<Scalar>(max_val);
+}
+
+// lifting transform of 4-vector
+template <class Int, uint s>
+static void
+fwd_lift(Int* p)
+{
+  Int x = *p; p += s;
+  Int y = *p; p += s;
+  Int z = *p; p += s;
+  Int w = *p; p += s;
+
+  // default, non-orthogonal transform (preferred due to speed and quality)
+  //        ( 4  4  4  4) (x)
+  // 1/16 * ( 5  1 -1 -5) (y)
+  //        (-4  4  4 -4) (z)
+  //        (-2  6 -6  2) (w)
+  x += w; x >>= 1; w -= x;
+  z += y; z >>= 1; y -= z;
+  x += z; x >>= 1; z -= x;
+  w += y; w >>= 1; y -= w;
+  w += y >> 1; y -= w >> 1;
+
+  p -= s; *p = w;
+  p -= s; *p = z;
+  p -= s; *p = y;
+  p -= s; *p = x;
+}
+
+template<typename Scalar>
+inline
+Scalar
+quantize_factor(const int &exponent)
+{
+  return LDEXP((Scalar)1, get_precision<Scalar>() - 2 - exponent);
+}
+
+template<typename Scalar, typename Int, int BlockSize>
+inline
+void fwd_cast(Int *iblock, const Scalar *fblock, int emax)
+{
+  Scalar s = quantize_factor<Scalar>(emax);
+  for(int i = 0; i < BlockSize; ++i)
+  {
+    iblock[i] = (Int) (s * fblock[i]);
+  }
+}
+
+template<int BlockSize>
+struct transform;
+
+template<>
+struct transform<256>
+{
+  template<typename Int>
+  void fwd_xform(Int *p)
+  {
+
+    uint x, y, z, w;
+    /* transform along x */
+    for (w = 0; w < 4; w++)
+      for (z = 0; z < 4; z++)
+        for (y = 0; y < 4; y++)
+          fwd_lift<Int,1>(p + 4 * y + 16 * z + 64 * w);
+    /* transform along y */
+    for (x = 0; x < 4; x++)
+      for (w = 0; w < 4; w++)
+        for (z = 0; z < 4; z++)
+          fwd_lift<Int,4>(p + 16 * z + 64 * w + 1 * x);
+    /* transform along z */
+    for (y = 0; y < 4; y++)
+      for (x = 0; x < 4; x++)
+        for (w = 0; w < 4; w++)
+          fwd_lift<Int,16>(p + 64 * w + 1 * x + 4 * y);
+    /* transform along w */
+    for (z = 0; z < 4; z++)
+      for (y = 0; y < 4; y++)
+        for (x = 0; x < 4; x++)
+          fwd_lift<Int,64>(p + 1 * x + 4 * y + 16 * z);
+
+   }
+
+};
+
+template<>
+struct transform<64>
+{
+  template<typename Int>
+  void fwd_xform(Int *p)
+  {
+
+    uint x, y, z;
+    /* transform along x */
+    for (z = 0; z < 4; z++)
+      for (y = 0; y < 4; y++)
+        fwd_lift<Int,1>(p + 4 * y + 16 * z);
+    /* transform along y */
+    for (x = 0; x < 4; x++)
+      for (z = 0; z < 4; z++)
+        fwd_lift<Int,4>(p + 16 * z + 1 * x);
+    /* transform along z */
+    for (y = 0; y < 4; y++)
+      for (x = 0; x < 4; x++)
+        fwd_lift<Int,16>(p + 1 * x + 4 * y);
+
+   }
+
+};
+
+template<>
+struct transform<16>
+{
+  template<typename Int>
+  void fwd_xform(Int *p)
+  {
+
+    uint x, y;
+    /* transform along x */
+    for (y = 0; y < 4; y++)
+     fwd_lift<Int,1>(p + 4 * y);
+    /* transform along y */
+    for (x = 0; x < 4; x++)
+      fwd_lift<Int,4>(p + 1 * x);
+    }
+
+};
+
+template<>
+struct transform<4>
+{
+  template<typename Int>
+  void fwd_xform(Int *p)
+  {
+    fwd_lift<Int,1>(p);
+  }
+
+};
+
+template<typename Int, typename UInt, int BlockSize>
+void fwd_order(UInt *ublock, const Int *iblock)
+{
+  const unsigned char *perm = get_perm<BlockSize>();
+
+  for(int i = 0; i < BlockSize; ++i)
+  {
+    ublock[i] = int2uint(iblock[perm[i]]);
+  }
+}
+
+// writer of one block to a zeroed stream shared by concurrent work-items;
+// words that straddle two blocks are updated atomically
+struct BlockWriter
+{
+  typedef sycl::atomic_ref<Word,
+                           sycl::memory_order::relaxed,
+                           sycl::memory_scope::device,
+                           sycl::access::address_space::global_space> AtomicWord;
+
+  size_t m_word_index;
+  uint m_start_bit;
+  uint m_current_bit;
+  Word *m_stream;
+
+  BlockWriter(Word *stream, const int &maxbits, const size_t &block_idx)
+   :  m_current_bit(0),
+      m_stream(stream)
+  {
+    m_word_index = (block_idx * maxbits) / (sizeof(Word) * 8);
+    m_start_bit = uint((block_idx * maxbits) % (sizeof(Word) * 8));
+  }
+
+  long long unsigned int
+  write_bits(const long long unsigned int &bits, const uint &n_bits)
+  {
+    // nothing to write, and the word past the end of the stream must not be touched
+    if (n_bits == 0) return bits;
+    const uint wbits = sizeof(Word) * 8;
+    uint seg_start = (m_start_bit + m_current_bit) % wbits;
+    size_t write_index = m_word_index + (m_start_bit + m_current_bit) / wbits;
+    uint seg_end = seg_start + n_bits - 1;
+    uint shift = seg_start;
+    // we may be asked to write less bits than exist in 'bits'
+    // so we have to make sure that anything after n is zero.
+    // If this does not happen, then we may write into a zfp
+    // block not at the specified index
+    Word left;
+    if (n_bits == 64) left = 0;
+    else left = (bits >> n_bits) << n_bits;
+
+    Word b = bits - left;
+    Word add = b << shift;
+    AtomicWord(m_stream[write_index]).fetch_add(add);
+    // n_bits straddles the word boundary
+    bool straddle = seg_start < sizeof(Word) * 8 && seg_end >= sizeof(Word) * 8;
+    if(straddle)
+    {
+      Word rem = b >> (sizeof(Word) * 8 - shift);
+      AtomicWord(m_stream[write_index + 1]).fetch_add(rem);
+    }
+    m_current_bit += n_bits;
+
+    // shifting by the word size is undefined
+    if (n_bits == 64) return 0;
+    else return bits >> (Word)n_bits;
+  }
+
+  uint write_bit(const unsigned int &bit)
+  {
+    const uint wbits = sizeof(Word) * 8;
+    uint seg_start = (m_start_bit + m_current_bit) % wbits;
+    size_t write_index = m_word_index + (m_start_bit + m_current_bit) / wbits;
+    uint shift = seg_start;
+
+    Word add = (Word)bit << shift;
+    AtomicWord(m_stream[write_index]).fetch_add(add);
+    m_current_bit += 1;
+
+    return bit;
+  }
+
+};
+
+// encode block of more than 64 integers, whose bit planes do not fit in a word
+template<typename UInt, int BlockSize>
+uint inline encode_many_ints(BlockWriter &stream,
+                             int maxbits,
+                             int maxprec,
+                             const UInt *ublock)
+{
+  uint intprec = CHAR_BIT * (uint)sizeof(UInt);
+  uint kmin = intprec > maxprec ? intprec - maxprec : 0;
+  uint bits = maxbits;
+  uint i, k, m, n, c;
+
+  for (k = intprec, n = 0; bits && k-- > kmin;) {
+    /* step 1: encode first n bits of bit plane #k */
+    m = MIN(n, bits);
+    bits -= m;
+    for (i = 0; i < m; i++)
+    {
+      stream.write_bit((ublock[i] >> k) & 1u);
+    }
+    /* step 2: count remaining one-bits in bit plane */
+    c = 0;
+    for (i = m; i < BlockSize; i++)
+    {
+      c += (ublock[i] >> k) & 1u;
+    }
+    /* step 3: unary run-length encode remainder of bit plane */
+    for (; n < BlockSize && bits && (bits--, stream.write_bit(!!c)); c--, n++)
+    {
+      for (; n < BlockSize - 1 && bits && (bits--, !stream.write_bit((ublock[n] >> k) & 1u)); n++)
+      {
+      }
+    }
+  }
+
+  return maxbits - bits;
+}
+
+template<typename Int, int BlockSize>
+void inline encode_block(BlockWriter &stream,
+                         int maxbits,
+                         int maxprec,
+                         Int *iblock)
+{
+  transform<BlockSize> tform;
+  tform.fwd_xform(iblock);
+
+  typedef typename zfp_traits<Int>::UInt UInt;
+  UInt ublock[BlockSize];
+  fwd_order<Int, UInt, BlockSize>(ublock, iblock);
+
+  if(BlockSize > 64)
+  {
+    encode_many_ints<UInt, BlockSize>(stream, maxbits, maxprec, ublock);
+    return;
+  }
+
+  uint intprec = CHAR_BIT * (uint)sizeof(UInt);
+  uint kmin = intprec > maxprec ? intprec - maxprec : 0;
+  uint bits = maxbits;
+  uint i, k, m, n;
+  uint64 x;
+
+  for (k = intprec, n = 0; bits && k-- > kmin;) {
+    /* step 1: extract bit plane #k to x */
+    x = 0;
+    for (i = 0; i < BlockSize; i++)
+    {
+      x += (uint64)((ublock[i] >> k) & 1u) << i;
+    }
+    /* step 2: encode first n bits of bit plane */
+    m = MIN(n, bits);
+    bits -= m;
+    x = stream.write_bits(x, m);
+
+    /* step 3: unary run-length encode remainder of bit plane */
+    for (; n < BlockSize && bits && (bits--, stream.write_bit(!!x)); x >>= 1, n++)
+    {
+      for (; n < BlockSize - 1 && bits && (bits--, !stream.write_bit(x & 1u)); x >>= 1, n++)
+      {
+      }
+    }
+  }
+
+}
+
+template<typename Scalar, int BlockSize>
+void inline zfp_encode_block(Scalar *fblock,
+                             const int maxbits,
+                             const size_t block_idx,
+                             Word *stream)
+{
+  BlockWriter block_writer(stream, maxbits, block_idx);
+  typedef typename zfp_traits<Scalar>::Int Int;
+  if(is_int<Scalar>())
+  {
+    // integers are encoded losslessly up to maxbits without an exponent
+    encode_block<Int, BlockSize>(block_writer, maxbits, get_precision<Scalar>(), (Int*)fblock);
+    return;
+  }
+  int emax = max_exponent<Scalar, BlockSize>(fblock);
+  int maxprec = precision(emax, get_precision<Scalar>(), get_min_exp<Scalar>());
+  uint e = maxprec ? emax + get_ebias<Scalar>() : 0;
+  if(e)
+  {
+    const uint ebits = get_ebits<Scalar>()+1;
+    block_writer.write_bits(2 * e + 1, ebits);
+    Int iblock[BlockSize];
+    fwd_cast<Scalar, Int, BlockSize>(iblock, fblock, emax);
+
+    encode_block<Int, BlockSize>(block_writer, maxbits - ebits, maxprec, iblock);
+  }
+}
+
+// gather block of 4^Dims values with origin p, padding partial blocks of
+// n[0] * ... * n[Dims - 1] values the same way as zfp does
+template<int Dims>
+struct gather;
+
+template<>
+struct gather<1>
+{
+  template<typename Scalar>
+  static void partial(Scalar* q, const Scalar* p, const uint n[4], const int s[4])
+  {
+    uint x;
+    for (x = 0; x < n[0]; x++)
+      q[x] = p[(ptrdiff_t)x * s[0]];
+    pad_block(q, n[0], 1);
+  }
+
+  template<typename Scalar>
+  static void full(Scalar* q, const Scalar* p, const int s[4])
+  {
+    uint x;
+    for (x = 0; x < 4; x++, p += s[0])
+      *q++ = *p;
+  }
+};
+
+template<>
+struct gather<2>
+{
+  template<typename Scalar>
+  static void partial(Scalar* q, const Scalar* p, const uint n[4], const int s[4])
+  {
+    uint x, y;
+    for (y = 0; y < n[1]; y++, p += s[1] - (ptrdiff_t)n[0] * s[0]) {
+      for (x = 0; x < n[0]; x++, p += s[0])
+        q[4 * y + x] = *p;
+      pad_block(q + 4 * y, n[0], 1);
+    }
+    for (x = 0; x < 4; x++)
+      pad_block(q + x, n[1], 4);
+  }
+
+  template<typename Scalar>
+  static void full(Scalar* q, const Scalar* p, const int s[4])
+  {
+    uint x, y;
+    for (y = 0; y < 4; y++, p += s[1] - 4 * s[0])
+      for (x = 0; x < 4; x++, p += s[0])
+        *q++ = *p;
+  }
+};
+
+template<>
+struct gather<3>
+{
+  template<typename Scalar>
+  static void partial(Scalar* q, const Scalar* p, const uint n[4], const int s[4])
+  {
+    uint x, y, z;
+    for (z = 0; z < n[2]; z++, p += s[2] - (ptrdiff_t)n[1] * s[1]) {
+      for (y = 0; y < n[1]; y++, p += s[1] - (ptrdiff_t)n[0] * s[0]) {
+        for (x = 0; x < n[0]; x++, p += s[0])
+          q[16 * z + 4 * y + x] = *p;
+        pad_block(q + 16 * z + 4 * y, n[0], 1);
+      }
+      for (x = 0; x < 4; x++)
+        pad_block(q + 16 * z + x, n[1], 4);
+    }
+    for (y = 0; y < 4; y++)
+      for (x = 0; x < 4; x++)
+        pad_block(q + 4 * y + x, n[2], 16);
+  }
+
+  template<typename Scalar>
+  static void full(Scalar* q, const Scalar* p, const int s[4])
+  {
+    uint x, y, z;
+    for (z = 0; z < 4; z++, p += s[2] - 4 * s[1])
+      for (y = 0; y < 4; y++, p += s[1] - 4 * s[0])
+        for (x = 0; x < 4; x++, p += s[0])
+          *q++ = *p;
+  }
+};
+
+template<>
+struct gather<4>
+{
+  template<typename Scalar>
+  static void partial(Scalar* q, const Scalar* p, const uint n[4], const int s[4])
+  {
+    uint x, y, z, w;
+    for (w = 0; w < n[3]; w++, p += s[3] - (ptrdiff_t)n[2] * s[2]) {
+      for (z = 0; z < n[2]; z++, p += s[2] - (ptrdiff_t)n[1] * s[1]) {
+        for (y = 0; y < n[1]; y++, p += s[1] - (ptrdiff_t)n[0] * s[0]) {
+          for (x = 0; x < n[0]; x++, p += s[0])
+            q[64 * w + 16 * z + 4 * y + x] = *p;
+          pad_block(q + 64 * w + 16 * z + 4 * y, n[0], 1);
+        }
+        for (x = 0; x < 4; x++)
+          pad_block(q + 64 * w + 16 * z + x, n[1], 4);
+      }
+      for (y = 0; y < 4; y++)
+        for (x = 0; x < 4; x++)
+          pad_block(q + 64 * w + 4 * y + x, n[2], 16);
+    }
+    for (z = 0; z < 4; z++)
+      for (y = 0; y < 4; y++)
+        for (x = 0; x < 4; x++)
+          pad_block(q + 16 * z + 4 * y + x, n[3], 64);
+  }
+
+  template<typename Scalar>
+  static void full(Scalar* q, const Scalar* p, const int s[4])
+  {
+    uint x, y, z, w;
+    for (w = 0; w < 4; w++, p += s[3] - 4 * s[2])
+      for (z = 0; z < 4; z++, p += s[2] - 4 * s[1])
+        for (y = 0; y < 4; y++, p += s[1] - 4 * s[0])
+          for (x = 0; x < 4; x++, p += s[0])
+            *q++ = *p;
+  }
+};
+
+//
+// encode field of Dims dimensions with one work-item per block; returns the
+// number of bytes of the compressed stream
+//
+template<class Scalar, int Dims>
+size_t encode(sycl::queue &q,
+              const Shape &shape,
+              const Scalar *d_data,
+              Word *stream,
+              const int maxbits)
+{
+  const int BlockSize = 1 << (2 * Dims);
+  const size_t blocks = total_blocks(shape);
+  const size_t stream_bytes = calc_device_mem(blocks, maxbits);
+  if(!blocks)
+  {
+    return 0;
+  }
+
+  // blocks are added to a zeroed stream
+  q.memset(stream, 0, stream_bytes).wait();
+
+  q.parallel_for(sycl::range<1>(blocks), [=](sycl::id<1> id)
+  {
+    const size_t block_idx = id[0];
+    uint n[4];
+    bool partial;
+    const Scalar *p = d_data + block_origin<Dims>(shape, block_idx, n, partial);
+
+    Scalar fblock[BlockSize];
+    if(partial)
+    {
+      gather<Dims>::partial(fblock, p, n, shape.stride);
+    }
+    else
+    {
+      gather<Dims>::full(fblock, p, shape.stride);
+    }
+
+    zfp_encode_block<Scalar, BlockSize>(fblock, maxbits, block_idx, stream);
+  }).wait();
+
+  return stream_bytes;
+}
+
+}  // namespace syclZFP
+#endif
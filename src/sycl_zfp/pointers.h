@@ -0,0 +1,20 @@
+#ifndef SYCLZFP_POINTERS_H
+#define SYCLZFP_POINTERS_H
+
+#include <sycl/sycl.hpp>
+
+namespace syclZFP
+{
+// pointers to device and shared USM allocations can be dereferenced by
+// kernels; host USM and system memory are staged through device memory
+inline
+bool is_gpu_ptr(const void *ptr, const sycl::context &context)
+{
+  const sycl::usm::alloc type = sycl::get_pointer_type(ptr, context);
+  return type == sycl::usm::alloc::device ||
+         type == sycl::usm::alloc::shared;
+}
+
+} // namespace syclZFP
+
+#endif
@@ -0,0 +1,184 @@
+#ifndef SYCLZFP_SHARED_H
+#define SYCLZFP_SHARED_H
+
+#include <sycl/sycl.hpp>
+#include <climits>
+
+typedef unsigned long long Word;
+#define Wsize ((uint)(CHAR_BIT * sizeof(Word)))
+
+#include "type_info.h"
+#include "zfp.h"
+#include "constants.h"
+
+#define MAX(x, y) ((x) > (y) ? (x) : (y))
+#define MIN(x, y) ((x) < (y) ? (x) : (y))
+#define bitsize(x) (CHAR_BIT * (uint)sizeof(x))
+
+#define LDEXP(x, e) sycl::ldexp(x, e)
+
+#define NBMASK 0xaaaaaaaaaaaaaaaaull
+
+namespace syclZFP
+{
+
+// field dimensions and strides, captured by value by the kernels; unused
+// dimensions have size one
+struct Shape
+{
+  uint dims[4];   // number of values per dimension
+  int stride[4];  // strides in number of values
+  uint blocks[4]; // number of blocks per dimension
+};
+
+inline
+size_t total_blocks(const Shape &shape)
+{
+  return (size_t)shape.blocks[0] * shape.blocks[1] * shape.blocks[2] * shape.blocks[3];
+}
+
+// offset of block origin and number of values per dimension in block
+template<int Dims>
+inline
+ptrdiff_t block_origin(const Shape &shape, size_t block_idx, uint n[4], bool &partial)
+{
+  ptrdiff_t offset = 0;
+  partial = false;
+  for(int d = 0; d < Dims; ++d)
+  {
+    const uint b = uint(block_idx % shape.blocks[d]);
+    block_idx /= shape.blocks[d];
+    const uint x = 4 * b;
+    n[d] = MIN(shape.dims[d] - x, 4u);
+    partial = partial || (n[d] < 4);
+    offset += (ptrdiff_t)x * shape.stride[d];
+  }
+  return offset;
+}
+
+// number of bytes of whole words spanned by blocks of maxbits bits each
+inline
+size_t calc_device_mem(size_t blocks, int maxbits)
+{
+  const size_t bits_per_word = sizeof(Word) * 8;
+  const size_t total_bits = blocks * maxbits;
+  return (total_bits + bits_per_word - 1) / bits_per_word * sizeof(Word);
+}
+
+// map two's complement signed integer to negabinary unsigned integer
+inline
+unsigned long long int int2uint(const long long int x)
+{
+    return (x + (unsigned long long int)0xaaaaaaaaaaaaaaaaull) ^
+                (unsigned long long int)0xaaaaaaaaaaaaaaaaull;
+}
+
+inline
+unsigned int int2uint(const int x)
+{
+    return (x + (unsigned int)0xaaaaaaaau) ^
+                (unsigned int)0xaaaaaaaau;
+}
+
+template<typename Int, typename Scalar>
+Scalar
+dequantize(const Int &x, const int &e);
+
+template<>
+inline
+double
+dequantize<long long int, double>(const long long int &x, const int &e)
+{
+	return LDEXP((double)x, e - (CHAR_BIT * scalar_sizeof<double>() - 2));
+}
+
+template<>
+inline
+float
+dequantize<int, float>(const int &x, const int &e)
+{
+	return LDEXP((float)x, e - (CHAR_BIT * scalar_sizeof<float>() - 2));
+}
+
+template<>
+inline
+int
+dequantize<int, int>(const int &x, const int &e)
+{
+	return 1;
+}
+
+template<>
+inline
+long long int
+dequantize<long long int, long long int>(const long long int &x, const int &e)
+{
+	return 1;
+}
+
+/* inverse lifting transform of 4-vector */
+template<class Int, uint s>
+static void
+inv_lift(Int* p)
+{
+	Int x, y, z, w;
+	x = *p; p += s;
+	y = *p; p += s;
+	z = *p; p += s;
+	w = *p; p += s;
+
+	/*
+	** non-orthogonal transform
+	**       ( 4  6 -4 -1) (x)
+	** 1/4 * ( 4  2  4  5) (y)
+	**       ( 4 -2  4 -5) (z)
+	**       ( 4 -6 -4  1) (w)
+	*/
+	y += w >> 1; w -= y >> 1;
+	y += w; w <<= 1; w -= y;
+	z += x; x <<= 1; x -= z;
+	y += z; z <<= 1; z -= y;
+	w += x; x <<= 1; x -= w;
+
+	p -= s; *p = w;
+	p -= s; *p = z;
+	p -= s; *p = y;
+	p -= s; *p = x;
+}
+
+
+template<int BlockSize>
+inline
+const unsigned char* get_perm();
+
+template<>
+inline
+const unsigned char* get_perm<256>()
+{
+  return perm_4;
+}
+
+template<>
+inline
+const unsigned char* get_perm<64>()
+{
+  return perm_3d;
+}
+
+template<>
+inline
+const unsigned char* get_perm<16>()
+{
+  return perm_2;
+}
+
+template<>
+inline
+const unsigned char* get_perm<4>()
+{
+  return perm_1;
+}
+
+
+} // namespace syclZFP
+#endif
@@ -0,0 +1,229 @@
+#include <sycl/sycl.hpp>
+#include <cstddef>
+
+#include "syclZFP.h"
+
+#include "encode.h"
+#include "decode.h"
+
+#include "pointers.h"
+#include "type_info.h"
+
+// we need to know about bitstream, but we don't
+// want duplicate symbols.
+#ifndef inline_
+  #define inline_ inline
+#endif
+
+#include "../inline/bitstream.c"
+namespace internal
+{
+
+//
+// SYCL queue on which all work for this zfp stream is submitted
+//
+sycl::queue &get_queue(const zfp_stream *stream)
+{
+  void *queue = stream->exec.params.sycl.queue;
+  if(queue)
+  {
+    return *static_cast<sycl::queue*>(queue);
+  }
+  static sycl::queue default_queue;
+  return default_queue;
+}
+
+//
+// dimensions and strides of field, and lowest and one past highest index of
+// field values relative to field->data
+//
+uint setup_shape(const zfp_field *field, syclZFP::Shape &shape, ptrdiff_t &min, ptrdiff_t &max)
+{
+  const uint d = zfp_field_dimensionality(field);
+  const size_t n[4] = { field->nx, field->ny, field->nz, field->nw };
+  int stride[4] = { 0, 0, 0, 0 };
+  zfp_field_stride(field, stride);
+
+  min = 0;
+  max = 1;
+  for(uint i = 0; i < 4; ++i)
+  {
+    shape.dims[i] = i < d ? (uint)n[i] : 1;
+    shape.stride[i] = i < d ? stride[i] : 0;
+    shape.blocks[i] = (shape.dims[i] + 3) / 4;
+    ptrdiff_t span = (ptrdiff_t)shape.stride[i] * (shape.dims[i] - 1);
+    if(span < 0)
+      min += span;
+    else
+      max += span;
+  }
+  return d;
+}
+
+template<typename T>
+size_t encode(sycl::queue &q, uint d, const syclZFP::Shape &shape, int bits_per_block, const T *d_data, Word *d_stream)
+{
+  switch(d)
+  {
+    case 1:
+      return syclZFP::encode<T, 1>(q, shape, d_data, d_stream, bits_per_block);
+    case 2:
+      return syclZFP::encode<T, 2>(q, shape, d_data, d_stream, bits_per_block);
+    case 3:
+      return syclZFP::encode<T, 3>(q, shape, d_data, d_stream, bits_per_block);
+    case 4:
+      return syclZFP::encode<T, 4>(q, shape, d_data, d_stream, bits_per_block);
+    default:
+      return 0;
+  }
+}
+
+template<typename T>
+size_t decode(sycl::queue &q, uint d, const syclZFP::Shape &shape, int bits_per_block, const Word *d_stream, T *d_data)
+{
+  switch(d)
+  {
+    case 1:
+      return syclZFP::decode<T, 1>(q, shape, d_stream, d_data, bits_per_block);
+    case 2:
+      return syclZFP::decode<T, 2>(q, shape, d_stream, d_data, bits_per_block);
+    case 3:
+      return syclZFP::decode<T, 3>(q, shape, d_stream, d_data, bits_per_block);
+    case 4:
+      return syclZFP::decode<T, 4>(q, shape, d_stream, d_data, bits_per_block);
+    default:
+      return 0;
+  }
+}
+
+//
+// (de)compress field on the device of the stream's queue; host-resident
+// field and stream are staged through device memory; returns the number of
+// bytes of compressed data
+//
+size_t
+run(zfp_stream *stream, const zfp_field *field, bool compress)
+{
+  // blocks are written by independent work-items and must start on a word
+  bitstream *s = zfp_stream_bit_stream(stream);
+  const size_t offset = compress ? stream_wtell(s) : stream_rtell(s);
+  const size_t type_size = zfp_type_size(field->type);
+  if(sizeof(word) != sizeof(Word) || offset % wsize || !type_size)
+  {
+    return 0;
+  }
+#ifdef BIT_STREAM_CALLBACK
+  if(s->write || s->read)
+  {
+    return 0;
+  }
+#endif
+
+  syclZFP::Shape shape;
+  ptrdiff_t min, max;
+  const uint d = setup_shape(field, shape, min, max);
+  const int maxbits = (int)stream->maxbits;
+  const size_t stream_bytes = syclZFP::calc_device_mem(syclZFP::total_blocks(shape), maxbits);
+  const size_t field_bytes = (size_t)(max - min) * type_size;
+
+  sycl::queue &q = get_queue(stream);
+  const sycl::context context = q.get_context();
+  Word *h_stream = (Word*)s->begin + offset / wsize;
+  unsigned char *h_field = (unsigned char*)field->data + min * (ptrdiff_t)type_size;
+  const bool stream_device = syclZFP::is_gpu_ptr(s->begin, context);
+  const bool field_device = syclZFP::is_gpu_ptr(field->data, context);
+
+  Word *d_stream = NULL;
+  unsigned char *d_field = NULL;
+  size_t bytes = 0;
+
+  try
+  {
+    d_stream = stream_device ? h_stream : sycl::malloc_device<Word>(stream_bytes / sizeof(Word), q);
+    d_field = field_device ? h_field : sycl::malloc_device<unsigned char>(field_bytes, q);
+    if(d_stream && d_field)
+    {
+      // strided fields are copied whole so that interleaved values survive
+      if(!field_device && (compress || !zfp_field_is_contiguous(field)))
+      {
+        q.memcpy(d_field, h_field, field_bytes).wait();
+      }
+      if(!stream_device && !compress)
+      {
+        q.memcpy(d_stream, h_stream, stream_bytes).wait();
+      }
+
+      // pointer to field value (0, 0, 0, 0) in device memory
+      void *d_data = d_field - min * (ptrdiff_t)type_size;
+      switch(field->type)
+      {
+        case zfp_type_int32:
+          bytes = compress ? encode(q, d, shape, maxbits, (const int*)d_data, d_stream)
+                           : decode(q, d, shape, maxbits, d_stream, (int*)d_data);
+          break;
+        case zfp_type_int64:
+          bytes = compress ? encode(q, d, shape, maxbits, (const long long int*)d_data, d_stream)
+                           : decode(q, d, shape, maxbits, d_stream, (long long int*)d_data);
+          break;
+        case zfp_type_float:
+          bytes = compress ? encode(q, d, shape, maxbits, (const float*)d_data, d_stream)
+                           : decode(q, d, shape, maxbits, d_stream, (float*)d_data);
+          break;
+        case zfp_type_double:
+          bytes = compress ? encode(q, d, shape, maxbits, (const double*)d_data, d_stream)
+                           : decode(q, d, shape, maxbits, d_stream, (double*)d_data);
+          break;
+        default:
+          break;
+      }
+
+      // copy results back to host
+      if(bytes && compress && !stream_device)
+      {
+        q.memcpy(h_stream, d_stream, bytes).wait();
+      }
+      else if(bytes && !compress && !field_device)
+      {
+        q.memcpy(h_field, d_field, field_bytes).wait();
+      }
+    }
+  }
+  catch(const sycl::exception &)
+  {
+    bytes = 0;
+  }
+
+  if(d_stream && !stream_device)
+  {
+    sycl::free(d_stream, q);
+  }
+  if(d_field && !field_device)
+  {
+    sycl::free(d_field, q);
+  }
+
+  if(bytes)
+  {
+    // position stream at end of field; word-aligned seeks do not touch memory
+    if(compress)
+      stream_wseek(s, offset + CHAR_BIT * bytes);
+    else
+      stream_rseek(s, offset + CHAR_BIT * bytes);
+  }
+
+  return bytes;
+}
+
+} // namespace internal
+
+size_t
+sycl_compress(zfp_stream *stream, const zfp_field *field)
+{
+  return internal::run(stream, field, true);
+}
+
+void
+sycl_decompress(zfp_stream *stream, zfp_field *field)
+{
+  internal::run(stream, field, false);
+}
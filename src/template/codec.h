@@ -2,3 +2,115 @@
 #define BLOCK_SIZE (1 << (2 * DIMS))   /* values per block */
 #define EBIAS ((1 << (EBITS - 1)) - 1) /* exponent bias */
 #define REVERSIBLE(zfp) ((zfp)->minexp < ZFP_MIN_EXP) /* reversible mode? */
+#define RAW_BLOCKS(zfp) ((zfp)->raw)   /* blocks prefixed with raw-storage flag? */
+#define BATCH_LANES 16                 /* blocks transformed together, one per SIMD lane */
+
+/* number of trailing zero-bits in x != 0 */
+inline_ uint
+ctz64(uint64 x)
+{
+#if defined(__GNUC__)
+  return (uint)__builtin_ctzll(x);
+#else
+  uint n = 0;
+  if (!(x & UINT64C(0xffffffff))) { x >>= 32; n += 32; }
+  if (!(x & UINT64C(0xffff))) { x >>= 16; n += 16; }
+  if (!(x & UINT64C(0xff))) { x >>= 8; n += 8; }
+  if (!(x & UINT64C(0xf))) { x >>= 4; n += 4; }
+  if (!(x & UINT64C(0x3))) { x >>= 2; n += 2; }
+  return n + !(x & 1u);
+#endif
+}
+
+#ifndef ZFP_OMP_TARGET_CODEC
+/* wall-clock time in seconds used to time codec phases (defined in zfp.c) */
+double zfp_stats_clock(void);
+/* gather statistics if requested */
+#define STATS_ENABLED(zfp) ((zfp)->stats)
+/* verify blocks if requested */
+#define VERIFY_ENABLED(zfp) ((zfp)->verify)
+#else
+/* statistics are not gathered on the device */
+#define zfp_stats_clock() 0.0
+#define STATS_ENABLED(zfp) 0
+/* nor are blocks verified */
+#define VERIFY_ENABLED(zfp) 0
+#endif
+
+/* add (de)compressed block of given size in bits to statistics */
+static void
+stats_add_block(zfp_stream_stats* stats, uint bits)
+{
+  uint bin = 0;
+  while (bin + 1 < ZFP_STATS_BINS && (bits >> (bin + 1)))
+    bin++;
+  stats->blocks++;
+  stats->bits += bits;
+  stats->histogram[bin]++;
+}
+
+/* name of public function in instruction set variant */
+#define _isa(function, isa) _cat2(function, isa)
+
+#ifdef ZFP_ISA
+/* ISA variant: rename public functions, e.g., to zfp_encode_block_avx2_float_3 */
+#define zfp_encode_block _isa(zfp_encode_block, ZFP_ISA)
+#define zfp_encode_block_strided _isa(zfp_encode_block_strided, ZFP_ISA)
+#define zfp_encode_partial_block_strided _isa(zfp_encode_partial_block_strided, ZFP_ISA)
+#define zfp_decode_block _isa(zfp_decode_block, ZFP_ISA)
+#define zfp_decode_block_strided _isa(zfp_decode_block_strided, ZFP_ISA)
+#define zfp_decode_partial_block_strided _isa(zfp_decode_partial_block_strided, ZFP_ISA)
+#define zfp_decode_block_lod _isa(zfp_decode_block_lod, ZFP_ISA)
+#define zfp_encode_block_coefficients _isa(zfp_encode_block_coefficients, ZFP_ISA)
+#define zfp_decode_block_coefficients _isa(zfp_decode_block_coefficients, ZFP_ISA)
+#define zfp_encode_blocks _isa(zfp_encode_blocks, ZFP_ISA)
+#define zfp_encode_block_multi _isa(zfp_encode_block_multi, ZFP_ISA)
+#define zfp_decode_blocks _isa(zfp_decode_blocks, ZFP_ISA)
+#define ISA_DECLARE_TYPED(type, function, params)
+#define ISA_DECLARE(function, params)
+#define ISA_DISPATCH(zfp, function, args)
+#else
+/* generic variant: forward public functions to variant selected by stream */
+#ifdef ZFP_WITH_ISA_AVX2
+  #define ISA_DECLARE_AVX2(type, function, params) type _t2(_isa(function, avx2), Scalar, DIMS) params;
+  #define ISA_CASE_AVX2(function, args) case zfp_isa_avx2: return _t2(_isa(function, avx2), Scalar, DIMS) args;
+#else
+  #define ISA_DECLARE_AVX2(type, function, params)
+  #define ISA_CASE_AVX2(function, args)
+#endif
+#ifdef ZFP_WITH_ISA_AVX512
+  #define ISA_DECLARE_AVX512(type, function, params) type _t2(_isa(function, avx512), Scalar, DIMS) params;
+  #define ISA_CASE_AVX512(function, args) case zfp_isa_avx512: return _t2(_isa(function, avx512), Scalar, DIMS) args;
+#else
+  #define ISA_DECLARE_AVX512(type, function, params)
+  #define ISA_CASE_AVX512(function, args)
+#endif
+#ifdef ZFP_WITH_ISA_SVE
+  #define ISA_DECLARE_SVE(type, function, params) type _t2(_isa(function, sve), Scalar, DIMS) params;
+  #define ISA_CASE_SVE(function, args) case zfp_isa_sve: return _t2(_isa(function, sve), Scalar, DIMS) args;
+#else
+  #define ISA_DECLARE_SVE(type, function, params)
+  #define ISA_CASE_SVE(function, args)
+#endif
+#ifdef ZFP_WITH_ISA_SVE2
+  #define ISA_DECLARE_SVE2(type, function, params) type _t2(_isa(function, sve2), Scalar, DIMS) params;
+  #define ISA_CASE_SVE2(function, args) case zfp_isa_sve2: return _t2(_isa(function, sve2), Scalar, DIMS) args;
+#else
+  #define ISA_DECLARE_SVE2(type, function, params)
+  #define ISA_CASE_SVE2(function, args)
+#endif
+#define ISA_DECLARE_TYPED(type, function, params) \
+  ISA_DECLARE_AVX2(type, function, params) \
+  ISA_DECLARE_AVX512(type, function, params) \
+  ISA_DECLARE_SVE(type, function, params) \
+  ISA_DECLARE_SVE2(type, function, params)
+#define ISA_DECLARE(function, params) ISA_DECLARE_TYPED(uint, function, params)
+#define ISA_DISPATCH(zfp, function, args) \
+  switch ((zfp)->isa) { \
+    ISA_CASE_AVX2(function, args) \
+    ISA_CASE_AVX512(function, args) \
+    ISA_CASE_SVE(function, args) \
+    ISA_CASE_SVE2(function, args) \
+    default: break; \
+  }
+#endif
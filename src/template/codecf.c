@@ -21,8 +21,8 @@ _t1(inv_cast, Scalar)(const Int* iblock, Scalar* fblock, uint n, int emax)
 {
   /* compute power-of-two scale factor s */
   Scalar s = _t1(dequantize, Scalar)(1, emax);
+  uint i;
   /* compute p-bit float x = s*y where |y| <= 2^(p-2) - 1 */
-  do
-    *fblock++ = (Scalar)(s * *iblock++);
-  while (--n);
+  for (i = 0; i < n; i++)
+    fblock[i] = (Scalar)(s * iblock[i]);
 }
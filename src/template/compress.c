@@ -1,3 +1,70 @@
+/* gather n consecutive 4x4x4 blocks along x from p into contiguous blocks q */
+static void
+_t2(gather_slab, Scalar, 3)(Scalar* q, const Scalar* p, size_t n, size_t nx, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz)
+{
+  /* nx values along x starting at p lie within the array */
+  ptrdiff_t ax = sx < 0 ? -sx : sx;
+  ptrdiff_t ay = sy < 0 ? -sy : sy;
+  ptrdiff_t az = sz < 0 ? -sz : sz;
+  size_t m = 4 * n;
+  size_t x;
+  uint j, k;
+
+  if (ax <= ay && ax <= az) {
+    /* x varies fastest in memory; stream along each of 16 rows */
+    for (k = 0; k < 4; k++)
+      for (j = 0; j < 4; j++) {
+        const Scalar* r = p + sy * (ptrdiff_t)j + sz * (ptrdiff_t)k;
+        for (x = 0; x < m; x++)
+          q[64 * (x / 4) + 16 * k + 4 * j + x % 4] = r[sx * (ptrdiff_t)x];
+      }
+  }
+  else if (az <= ay) {
+    /* z varies fastest; gather one 4x4 (y, z) plane per x */
+    for (x = 0; x < m; x++) {
+      const Scalar* r = p + sx * (ptrdiff_t)x;
+      Scalar* t = q + 64 * (x / 4) + x % 4;
+      if (x + SLAB_PREFETCH < nx)
+        for (j = 0; j < 4; j++)
+          prefetch_(r + sx * SLAB_PREFETCH + sy * (ptrdiff_t)j);
+      for (j = 0; j < 4; j++)
+        for (k = 0; k < 4; k++)
+          t[16 * k + 4 * j] = r[sy * (ptrdiff_t)j + sz * (ptrdiff_t)k];
+    }
+  }
+  else {
+    /* y varies fastest; gather one 4x4 (y, z) plane per x */
+    for (x = 0; x < m; x++) {
+      const Scalar* r = p + sx * (ptrdiff_t)x;
+      Scalar* t = q + 64 * (x / 4) + x % 4;
+      if (x + SLAB_PREFETCH < nx)
+        for (k = 0; k < 4; k++)
+          prefetch_(r + sx * SLAB_PREFETCH + sz * (ptrdiff_t)k);
+      for (k = 0; k < 4; k++)
+        for (j = 0; j < 4; j++)
+          t[16 * k + 4 * j] = r[sy * (ptrdiff_t)j + sz * (ptrdiff_t)k];
+    }
+  }
+}
+
+/* compress n consecutive full 4x4x4 blocks along x, a slab at a time */
+static void
+_t2(compress_slab, Scalar, 3)(zfp_stream* stream, const Scalar* p, size_t n, size_t nx, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz)
+{
+  /* nx values along x starting at p lie within the array */
+  cache_align_(Scalar block[64 * SLAB_BLOCKS]);
+  while (n) {
+    size_t m = MIN(n, SLAB_BLOCKS);
+    size_t i;
+    _t2(gather_slab, Scalar, 3)(block, p, m, nx, sx, sy, sz);
+    for (i = 0; i < m; i++)
+      _t2(zfp_encode_block, Scalar, 3)(stream, block + 64 * i);
+    p += sx * (ptrdiff_t)(4 * m);
+    nx -= 4 * m;
+    n -= m;
+  }
+}
+
 /* compress 1d contiguous array */
 static void
 _t2(compress, Scalar, 1)(zfp_stream* stream, const zfp_field* field)
@@ -14,6 +81,72 @@ _t2(compress, Scalar, 1)(zfp_stream* stream, const zfp_field* field)
     _t2(zfp_encode_partial_block_strided, Scalar, 1)(stream, data, nx - x, 1);
 }
 
+/* compress 2d contiguous array */
+static void
+_t2(compress, Scalar, 2)(zfp_stream* stream, const zfp_field* field)
+{
+  const Scalar* data = (const Scalar*)field->data;
+  size_t nx = field->nx;
+  size_t ny = field->ny;
+  size_t x, y;
+
+  /* compress array one block of 4x4 values at a time */
+  for (y = 0; y < ny; y += 4)
+    for (x = 0; x < nx; x += 4) {
+      const Scalar* p = data + x + nx * y;
+      if (nx - x < 4 || ny - y < 4)
+        _t2(zfp_encode_partial_block_strided, Scalar, 2)(stream, p, (uint)MIN(nx - x, 4u), (uint)MIN(ny - y, 4u), 1, (int)nx);
+      else
+        _t2(zfp_encode_block_strided, Scalar, 2)(stream, p, 1, (int)nx);
+    }
+}
+
+/* compress 3d contiguous array */
+static void
+_t2(compress, Scalar, 3)(zfp_stream* stream, const zfp_field* field)
+{
+  const Scalar* data = (const Scalar*)field->data;
+  size_t nx = field->nx;
+  size_t ny = field->ny;
+  size_t nz = field->nz;
+  size_t x, y, z;
+
+  /* compress array one block of 4x4x4 values at a time */
+  for (z = 0; z < nz; z += 4)
+    for (y = 0; y < ny; y += 4)
+      for (x = 0; x < nx; x += 4) {
+        const Scalar* p = data + x + nx * (y + ny * z);
+        if (nx - x < 4 || ny - y < 4 || nz - z < 4)
+          _t2(zfp_encode_partial_block_strided, Scalar, 3)(stream, p, (uint)MIN(nx - x, 4u), (uint)MIN(ny - y, 4u), (uint)MIN(nz - z, 4u), 1, (int)nx, (int)(nx * ny));
+        else
+          _t2(zfp_encode_block_strided, Scalar, 3)(stream, p, 1, (int)nx, (int)(nx * ny));
+      }
+}
+
+/* compress 4d contiguous array */
+static void
+_t2(compress, Scalar, 4)(zfp_stream* stream, const zfp_field* field)
+{
+  const Scalar* data = (const Scalar*)field->data;
+  size_t nx = field->nx;
+  size_t ny = field->ny;
+  size_t nz = field->nz;
+  size_t nw = field->nw;
+  size_t x, y, z, w;
+
+  /* compress array one block of 4x4x4x4 values at a time */
+  for (w = 0; w < nw; w += 4)
+    for (z = 0; z < nz; z += 4)
+      for (y = 0; y < ny; y += 4)
+        for (x = 0; x < nx; x += 4) {
+          const Scalar* p = data + x + nx * (y + ny * (z + nz * w));
+          if (nx - x < 4 || ny - y < 4 || nz - z < 4 || nw - w < 4)
+            _t2(zfp_encode_partial_block_strided, Scalar, 4)(stream, p, (uint)MIN(nx - x, 4u), (uint)MIN(ny - y, 4u), (uint)MIN(nz - z, 4u), (uint)MIN(nw - w, 4u), 1, (int)nx, (int)(nx * ny), (int)(nx * ny * nz));
+          else
+            _t2(zfp_encode_block_strided, Scalar, 4)(stream, p, 1, (int)nx, (int)(nx * ny), (int)(nx * ny * nz));
+        }
+}
+
 /* compress 1d strided array */
 static void
 _t2(compress_strided, Scalar, 1)(zfp_stream* stream, const zfp_field* field)
@@ -66,6 +199,7 @@ _t2(compress_strided, Scalar, 3)(zfp_stream* stream, const zfp_field* field)
   int sx = field->sx ? field->sx : 1;
   int sy = field->sy ? field->sy : (int)nx;
   int sz = field->sz ? field->sz : (int)(nx * ny);
+  zfp_bool slab = is_slab_traversal(sx);
   uint x, y, z;
 
   /* compress array one block of 4x4x4 values at a time */
@@ -75,6 +209,12 @@ _t2(compress_strided, Scalar, 3)(zfp_stream* stream, const zfp_field* field)
         const Scalar* p = data + sx * (ptrdiff_t)x + sy * (ptrdiff_t)y + sz * (ptrdiff_t)z;
         if (nx - x < 4 || ny - y < 4 || nz - z < 4)
           _t2(zfp_encode_partial_block_strided, Scalar, 3)(stream, p, MIN(nx - x, 4u), MIN(ny - y, 4u), MIN(nz - z, 4u), sx, sy, sz);
+        else if (slab) {
+          /* compress remaining full blocks in this row of blocks */
+          uint n = (nx - x) / 4;
+          _t2(compress_slab, Scalar, 3)(stream, p, n, nx - x, sx, sy, sz);
+          x += 4 * (n - 1);
+        }
         else
           _t2(zfp_encode_block_strided, Scalar, 3)(stream, p, sx, sy, sz);
       }
@@ -107,3 +247,128 @@ _t2(compress_strided, Scalar, 4)(zfp_stream* stream, const zfp_field* field)
             _t2(zfp_encode_block_strided, Scalar, 4)(stream, p, sx, sy, sz, sw);
         }
 }
+
+/* compress block with given raster index and return its size in bits */
+static uint
+_t1(compress_block, Scalar)(zfp_stream* stream, const zfp_field* field, size_t block)
+{
+  const Scalar* p = (const Scalar*)field->data;
+  uint nx = MAX(field->nx, 1u);
+  uint ny = MAX(field->ny, 1u);
+  uint nz = MAX(field->nz, 1u);
+  uint nw = MAX(field->nw, 1u);
+  int sx = field->sx ? field->sx : 1;
+  int sy = field->sy ? field->sy : (int)nx;
+  int sz = field->sz ? field->sz : (int)(nx * ny);
+  int sw = field->sw ? field->sw : (int)(nx * ny * nz);
+  uint x, y, z, w;
+  uint mx, my, mz, mw;
+
+  /* determine block origin (x, y, z, w) and extent within array */
+  x = 4 * (uint)(block % ((nx + 3) / 4)); block /= (nx + 3) / 4;
+  y = 4 * (uint)(block % ((ny + 3) / 4)); block /= (ny + 3) / 4;
+  z = 4 * (uint)(block % ((nz + 3) / 4)); block /= (nz + 3) / 4;
+  w = 4 * (uint)block;
+  mx = MIN(nx - x, 4u);
+  my = MIN(ny - y, 4u);
+  mz = MIN(nz - z, 4u);
+  mw = MIN(nw - w, 4u);
+  p += sx * (ptrdiff_t)x + sy * (ptrdiff_t)y + sz * (ptrdiff_t)z + sw * (ptrdiff_t)w;
+
+  /* compress partial or full block */
+  switch (zfp_field_dimensionality(field)) {
+    case 1:
+      if (mx < 4)
+        return _t2(zfp_encode_partial_block_strided, Scalar, 1)(stream, p, mx, sx);
+      return _t2(zfp_encode_block_strided, Scalar, 1)(stream, p, sx);
+    case 2:
+      if (mx < 4 || my < 4)
+        return _t2(zfp_encode_partial_block_strided, Scalar, 2)(stream, p, mx, my, sx, sy);
+      return _t2(zfp_encode_block_strided, Scalar, 2)(stream, p, sx, sy);
+    case 3:
+      if (mx < 4 || my < 4 || mz < 4)
+        return _t2(zfp_encode_partial_block_strided, Scalar, 3)(stream, p, mx, my, mz, sx, sy, sz);
+      return _t2(zfp_encode_block_strided, Scalar, 3)(stream, p, sx, sy, sz);
+    case 4:
+      if (mx < 4 || my < 4 || mz < 4 || mw < 4)
+        return _t2(zfp_encode_partial_block_strided, Scalar, 4)(stream, p, mx, my, mz, mw, sx, sy, sz, sw);
+      return _t2(zfp_encode_block_strided, Scalar, 4)(stream, p, sx, sy, sz, sw);
+    default:
+      return 0;
+  }
+}
+
+/* compress field of interleaved components, e.g., an array of structs, one
+   block at a time; co-located blocks of all components are encoded in turn
+   so that each cache line of the field is read from memory only once */
+static void
+_t1(compress_interleaved, Scalar)(zfp_stream* stream, const zfp_field* field, uint components)
+{
+  size_t bx = (MAX(field->nx, 1u) + 3) / 4;
+  size_t by = (MAX(field->ny, 1u) + 3) / 4;
+  size_t bz = (MAX(field->nz, 1u) + 3) / 4;
+  size_t bw = (MAX(field->nw, 1u) + 3) / 4;
+  size_t blocks = bx * by * bz * bw;
+  zfp_field f = *field;
+  size_t b;
+  uint c;
+
+  for (b = 0; b < blocks; b++)
+    for (c = 0; c < components; c++) {
+      f.data = (void*)((const Scalar*)field->data + c);
+      _t1(compress_block, Scalar)(stream, &f, b);
+    }
+}
+
+/* compress contiguous block of field with given dimensionality */
+static uint
+_t1(encode_field_block, Scalar)(zfp_stream* stream, uint dims, const void* block)
+{
+  const Scalar* p = (const Scalar*)block;
+  switch (dims) {
+    case 1:
+      return _t2(zfp_encode_block, Scalar, 1)(stream, p);
+    case 2:
+      return _t2(zfp_encode_block, Scalar, 2)(stream, p);
+    case 3:
+      return _t2(zfp_encode_block, Scalar, 3)(stream, p);
+    case 4:
+      return _t2(zfp_encode_block, Scalar, 4)(stream, p);
+    default:
+      return 0;
+  }
+}
+
+/* recompress fixed-size blocks intersecting box of size (mx, my, mz) at (x0, y0, z0) in place */
+static void
+_t1(compress_subset, Scalar)(zfp_stream* stream, const zfp_field* field, size_t x0, size_t y0, size_t z0, size_t mx, size_t my, size_t mz)
+{
+  bitstream* s = stream->stream;
+  size_t bx = (MAX(field->nx, 1u) + 3) / 4;
+  size_t by = (MAX(field->ny, 1u) + 3) / 4;
+  size_t base = stream_wtell(s);
+  size_t i, j, k;
+
+  /* re-encode each run of consecutive blocks along x */
+  for (k = z0 / 4; k <= (z0 + mz - 1) / 4; k++)
+    for (j = y0 / 4; j <= (y0 + my - 1) / 4; j++) {
+      size_t imin = x0 / 4;
+      size_t imax = (x0 + mx - 1) / 4 + 1;
+      size_t b = imin + bx * (j + by * k);
+      size_t begin = base + b * stream->maxbits;
+      size_t end = begin + (imax - imin) * stream->maxbits;
+      uint n = (uint)((stream_word_bits - end % stream_word_bits) % stream_word_bits);
+      uint64 tail = 0;
+      /* save bits that follow run in its last word */
+      if (n) {
+        stream_rseek(s, end);
+        tail = stream_read_bits(s, n);
+      }
+      /* bits that precede run in its first word are kept by the seek */
+      stream_wseek(s, begin);
+      for (i = imin; i < imax; i++, b++)
+        _t1(compress_block, Scalar)(stream, field, b);
+      /* complete last word */
+      stream_write_bits(s, tail, n);
+    }
+}
@@ -5,7 +5,7 @@
 static void
 _t2(decompress_cuda, Scalar, 1)(zfp_stream* stream, zfp_field* field)
 {
-  if(zfp_stream_compression_mode(stream) == zfp_mode_fixed_rate)
+  if(!is_reversible(stream))
   {
     cuda_decompress(stream, field);   
   }
@@ -15,7 +15,7 @@ _t2(decompress_cuda, Scalar, 1)(zfp_stream* stream, zfp_field* field)
 static void
 _t2(decompress_strided_cuda, Scalar, 1)(zfp_stream* stream, zfp_field* field)
 {
-  if(zfp_stream_compression_mode(stream) == zfp_mode_fixed_rate)
+  if(!is_reversible(stream))
   {
     cuda_decompress(stream, field);   
   }
@@ -25,7 +25,7 @@ _t2(decompress_strided_cuda, Scalar, 1)(zfp_stream* stream, zfp_field* field)
 static void
 _t2(decompress_strided_cuda, Scalar, 2)(zfp_stream* stream, zfp_field* field)
 {
-  if(zfp_stream_compression_mode(stream) == zfp_mode_fixed_rate)
+  if(!is_reversible(stream))
   {
     cuda_decompress(stream, field);   
   }
@@ -35,7 +35,17 @@ _t2(decompress_strided_cuda, Scalar, 2)(zfp_stream* stream, zfp_field* field)
 static void
 _t2(decompress_strided_cuda, Scalar, 3)(zfp_stream* stream, zfp_field* field)
 {
-  if(zfp_stream_compression_mode(stream) == zfp_mode_fixed_rate)
+  if(!is_reversible(stream))
+  {
+    cuda_decompress(stream, field);   
+  }
+}
+
+/* compress 4d strided array */
+static void
+_t2(decompress_strided_cuda, Scalar, 4)(zfp_stream* stream, zfp_field* field)
+{
+  if(!is_reversible(stream))
   {
     cuda_decompress(stream, field);   
   }
@@ -1,6 +1,7 @@
 #include <limits.h>
 
 static void _t2(inv_xform, Int, DIMS)(Int* p);
+static void _t2(inv_xform_lod, Int, DIMS)(Int* p, uint level);
 
 /* private functions ------------------------------------------------------- */
 
@@ -33,6 +34,60 @@ _t1(inv_lift, Int)(Int* p, uint s)
   p -= s; *p = x;
 }
 
+/* partial inverse lifting transform of 4-vector to 2^level averages */
+static void
+_t1(inv_lift_lod, Int)(Int* p, uint s, uint level)
+{
+  /* the DC coefficient x is already the average of all four values */
+  if (level) {
+    /* averages of (p0, p1) and (p2, p3) are x + y + w/2 and x - y - w/2 */
+    Int x = p[0];
+    Int y = p[s];
+    Int w = p[3 * s];
+    y += w >> 1;
+    p[0] = x + y;
+    p[s] = x - y;
+  }
+}
+
+/* inverse lifting transform of n 4-vectors with adjacent elements */
+static void
+_t1(inv_lift_vec, Int)(Int* p, uint s, uint n)
+{
+  Int* q = p + s;
+  Int* r = q + s;
+  Int* t = r + s;
+  uint i;
+
+  /* vectors are independent, so this loop vectorizes */
+  for (i = 0; i < n; i++) {
+    Int x = p[i];
+    Int y = q[i];
+    Int z = r[i];
+    Int w = t[i];
+    y += w >> 1; w -= y >> 1;
+    y += w; w <<= 1; w -= y;
+    z += x; x <<= 1; x -= z;
+    y += z; z <<= 1; z -= y;
+    w += x; x <<= 1; x -= w;
+    p[i] = x;
+    q[i] = y;
+    r[i] = z;
+    t[i] = w;
+  }
+}
+
+/* inverse decorrelating transform of BATCH_LANES blocks interleaved by lane */
+static void
+_t2(inv_xform_lanes, Int, DIMS)(Int* p)
+{
+  uint i, s;
+  /* transform along w, z, y, x in turn; each lift spans all lanes at once */
+  for (s = BLOCK_SIZE / 4; s; s /= 4)
+    for (i = 0; i < BLOCK_SIZE; i += 4 * s)
+      _t1(inv_lift_vec, Int)(p + i * BATCH_LANES, s * BATCH_LANES, s * BATCH_LANES);
+}
+
 /* map two's complement signed integer to negabinary unsigned integer */
 static Int
 _t1(uint2int, UInt)(UInt x)
@@ -40,6 +95,17 @@ _t1(uint2int, UInt)(UInt x)
   return (Int)((x ^ NBMASK) - NBMASK);
 }
 
+/* return nonzero if all n coefficients but the first (DC) are zero */
+static int
+_t1(is_dc_only, UInt)(const UInt* ublock, uint n)
+{
+  UInt d = 0;
+  uint i;
+  for (i = 1; i < n; i++)
+    d |= ublock[i];
+  return !d;
+}
+
 /* reorder unsigned coefficients and convert to signed integer */
 static void
 _t1(inv_order, Int)(const UInt* ublock, Int* iblock, const uchar* perm, uint n)
@@ -49,6 +115,35 @@ _t1(inv_order, Int)(const UInt* ublock, Int* iblock, const uchar* perm, uint n)
   while (--n);
 }
 
+/* skip up to n zero-bits and the one-bit after them; return zeros skipped */
+static uint
+stream_read_zeros(bitstream* s, uint n)
+{
+  uint zeros = 0;
+  while (zeros < n) {
+    uint c;
+    word y;
+    if (!s->bits) {
+      s->buffer = stream_read_word(s);
+      s->bits = wsize;
+    }
+    /* locate first one-bit among next c buffered bits */
+    c = MIN(n - zeros, s->bits);
+    y = c < wsize ? s->buffer & (((word)1 << c) - 1) : s->buffer;
+    if (y) {
+      uint t = ctz64(y);
+      s->buffer >>= t;
+      s->buffer >>= 1;
+      s->bits -= t + 1;
+      return zeros + t;
+    }
+    s->buffer = c < wsize ? s->buffer >> c : 0;
+    s->bits -= c;
+    zeros += c;
+  }
+  return zeros;
+}
+
 /* decompress sequence of size unsigned integers */
 static uint
 _t1(decode_ints, UInt)(bitstream* restrict_ stream, uint maxbits, uint maxprec, UInt* restrict_ data, uint size)
@@ -72,9 +167,13 @@ _t1(decode_ints, UInt)(bitstream* restrict_ stream, uint maxbits, uint maxprec,
     bits -= m;
     x = stream_read_bits(&s, m);
     /* unary run-length decode remainder of bit plane */
-    for (; n < size && bits && (bits--, stream_read_bit(&s)); x += (uint64)1 << n++)
-      for (; n < size - 1 && bits && (bits--, !stream_read_bit(&s)); n++)
-        ;
+    for (; n < size && bits && (bits--, stream_read_bit(&s)); x += (uint64)1 << n++) {
+      /* skip run of zeros and its one-bit; the last one-bit is implied */
+      m = MIN(size - 1 - n, bits);
+      i = stream_read_zeros(&s, m);
+      bits -= i + (i < m);
+      n += i;
+    }
     /* deposit bit plane from x */
     for (i = 0; x; i++, x >>= 1)
       data[i] += (UInt)(x & 1u) << k;
@@ -93,7 +192,7 @@ _t1(decode_many_ints, UInt)(bitstream* restrict_ stream, uint maxbits, uint maxp
   uint intprec = CHAR_BIT * (uint)sizeof(UInt);
   uint kmin = intprec > maxprec ? intprec - maxprec : 0;
   uint bits = maxbits;
-  uint i, k, m, n;
+  uint i, j, k, m, n;
 
   /* initialize data array to all zeros */
   for (i = 0; i < size; i++)
@@ -104,13 +203,20 @@ _t1(decode_many_ints, UInt)(bitstream* restrict_ stream, uint maxbits, uint maxp
     /* decode first n bits of bit plane #k */
     m = MIN(n, bits);
     bits -= m;
-    for (i = 0; i < m; i++)
-      if (stream_read_bit(&s))
-        data[i] += (UInt)1 << k;
+    for (i = 0; i < m; i += 64) {
+      uint c = MIN(m - i, 64u);
+      uint64 x = stream_read_bits(&s, c);
+      for (j = i; x; j++, x >>= 1)
+        data[j] += (UInt)(x & 1u) << k;
+    }
     /* unary run-length decode remainder of bit plane */
-    for (; n < size && bits && (--bits, stream_read_bit(&s)); data[n] += (UInt)1 << k, n++)
-      for (; n < size - 1 && bits && (--bits, !stream_read_bit(&s)); n++)
-        ;
+    for (; n < size && bits && (--bits, stream_read_bit(&s)); data[n] += (UInt)1 << k, n++) {
+      /* skip run of zeros and its one-bit; the last one-bit is implied */
+      m = MIN(size - 1 - n, bits);
+      i = stream_read_zeros(&s, m);
+      bits -= i + (i < m);
+      n += i;
+    }
   }
 
   *stream = s;
@@ -133,9 +239,107 @@ _t2(decode_block, Int, DIMS)(bitstream* stream, int minbits, int maxbits, int ma
     stream_skip(stream, minbits - bits);
     bits = minbits;
   }
+  if (_t1(is_dc_only, UInt)(ublock, BLOCK_SIZE)) {
+    /* a lone DC coefficient inverse transforms to a constant block */
+    Int x = _t1(uint2int, UInt)(ublock[0]);
+    uint i;
+    for (i = 0; i < BLOCK_SIZE; i++)
+      iblock[i] = x;
+  }
+  else {
+    /* reorder unsigned coefficients and convert to signed integer */
+    _t1(inv_order, Int)(ublock, iblock, PERM, BLOCK_SIZE);
+    /* perform decorrelating transform */
+    _t2(inv_xform, Int, DIMS)(iblock);
+  }
+  return bits;
+}
+
+/* decode block of integers, accumulating statistics and phase times since start */
+static uint
+_t2(decode_block_stats, Int, DIMS)(bitstream* stream, int minbits, int maxbits, int maxprec, Int* iblock, zfp_stream_stats* stats, double start)
+{
+  int bits;
+  double t;
+  cache_align_(UInt ublock[BLOCK_SIZE]);
+  /* decode integer coefficients */
+  if (BLOCK_SIZE <= 64)
+    bits = _t1(decode_ints, UInt)(stream, maxbits, maxprec, ublock, BLOCK_SIZE);
+  else
+    bits = _t1(decode_many_ints, UInt)(stream, maxbits, maxprec, ublock, BLOCK_SIZE);
+  if (bits < minbits) {
+    stream_skip(stream, minbits - bits);
+    bits = minbits;
+  }
+  t = zfp_stats_clock();
+  stats->coding_time += t - start;
+  stats->bit_planes += maxprec;
+  if (_t1(is_dc_only, UInt)(ublock, BLOCK_SIZE)) {
+    /* a lone DC coefficient inverse transforms to a constant block */
+    Int x = _t1(uint2int, UInt)(ublock[0]);
+    uint i;
+    for (i = 0; i < BLOCK_SIZE; i++)
+      iblock[i] = x;
+    if (x)
+      stats->constant_blocks++;
+    else
+      stats->zero_blocks++;
+  }
+  else {
+    /* reorder coefficients and perform inverse decorrelating transform */
+    _t1(inv_order, Int)(ublock, iblock, PERM, BLOCK_SIZE);
+    _t2(inv_xform, Int, DIMS)(iblock);
+  }
+  stats->transform_time += zfp_stats_clock() - t;
+  return bits;
+}
+
+/* decode block of integers and reduce to (2^level)^d sub-block averages */
+static uint
+_t2(decode_block_lod, Int, DIMS)(bitstream* stream, int minbits, int maxbits, int maxprec, Int* iblock, uint level)
+{
+  int bits;
+  cache_align_(UInt ublock[BLOCK_SIZE]);
+  /* full resolution requires the complete inverse transform */
+  if (level == 2)
+    return _t2(decode_block, Int, DIMS)(stream, minbits, maxbits, maxprec, iblock);
+  /* decode integer coefficients */
+  if (BLOCK_SIZE <= 64)
+    bits = _t1(decode_ints, UInt)(stream, maxbits, maxprec, ublock, BLOCK_SIZE);
+  else
+    bits = _t1(decode_many_ints, UInt)(stream, maxbits, maxprec, ublock, BLOCK_SIZE);
+  /* read at least minbits bits */
+  if (bits < minbits) {
+    stream_skip(stream, minbits - bits);
+    bits = minbits;
+  }
   /* reorder unsigned coefficients and convert to signed integer */
   _t1(inv_order, Int)(ublock, iblock, PERM, BLOCK_SIZE);
-  /* perform decorrelating transform */
-  _t2(inv_xform, Int, DIMS)(iblock);
+  /* invert only the low-sequency part of the decorrelating transform */
+  _t2(inv_xform_lod, Int, DIMS)(iblock, level);
+  return bits;
+}
+
+/* decode block of integers into given lane of interleaved blocks */
+static uint
+_t2(decode_lane, Int, DIMS)(bitstream* stream, int minbits, int maxbits, int maxprec, Int* iblock, uint lane)
+{
+  int bits;
+  cache_align_(UInt ublock[BLOCK_SIZE]);
+  const uchar* perm = PERM;
+  uint i;
+  /* decode integer coefficients */
+  if (BLOCK_SIZE <= 64)
+    bits = _t1(decode_ints, UInt)(stream, maxbits, maxprec, ublock, BLOCK_SIZE);
+  else
+    bits = _t1(decode_many_ints, UInt)(stream, maxbits, maxprec, ublock, BLOCK_SIZE);
+  /* read at least minbits bits */
+  if (bits < minbits) {
+    stream_skip(stream, minbits - bits);
+    bits = minbits;
+  }
+  /* reorder unsigned coefficients into lane and convert to signed integer */
+  for (i = 0; i < BLOCK_SIZE; i++)
+    iblock[perm[i] * BATCH_LANES + lane] = _t1(uint2int, UInt)(ublock[i]);
   return bits;
 }
@@ -26,27 +26,41 @@ _t2(inv_xform, Int, 1)(Int* p)
   _t1(inv_lift, Int)(p, 1);
 }
 
+/* partial inverse transform to 2^level averages stored at p */
+static void
+_t2(inv_xform_lod, Int, 1)(Int* p, uint level)
+{
+  /* transform along x */
+  _t1(inv_lift_lod, Int)(p, 1, level);
+}
+
 /* public functions -------------------------------------------------------- */
 
 /* decode 4-value block and store at p using stride sx */
+ISA_DECLARE(zfp_decode_block_strided, (zfp_stream* stream, Scalar* p, int sx))
 uint
 _t2(zfp_decode_block_strided, Scalar, 1)(zfp_stream* stream, Scalar* p, int sx)
 {
-  /* decode contiguous block */
   cache_align_(Scalar block[4]);
-  uint bits = _t2(zfp_decode_block, Scalar, 1)(stream, block);
+  uint bits;
+  ISA_DISPATCH(stream, zfp_decode_block_strided, (stream, p, sx))
+  /* decode contiguous block */
+  bits = _t2(zfp_decode_block, Scalar, 1)(stream, block);
   /* scatter block to strided array */
   _t2(scatter, Scalar, 1)(block, p, sx);
   return bits;
 }
 
 /* decode nx-value block and store at p using stride sx */
+ISA_DECLARE(zfp_decode_partial_block_strided, (zfp_stream* stream, Scalar* p, uint nx, int sx))
 uint
 _t2(zfp_decode_partial_block_strided, Scalar, 1)(zfp_stream* stream, Scalar* p, uint nx, int sx)
 {
-  /* decode contiguous block */
   cache_align_(Scalar block[4]);
-  uint bits = _t2(zfp_decode_block, Scalar, 1)(stream, block);
+  uint bits;
+  ISA_DISPATCH(stream, zfp_decode_partial_block_strided, (stream, p, nx, sx))
+  /* decode contiguous block */
+  bits = _t2(zfp_decode_block, Scalar, 1)(stream, block);
   /* scatter block to strided array */
   _t2(scatter_partial, Scalar, 1)(block, p, nx, sx);
   return bits;
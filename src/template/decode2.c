@@ -10,6 +10,16 @@ _t2(scatter, Scalar, 2)(const Scalar* q, Scalar* p, int sx, int sy)
       *p = *q++;
 }
 
+/* scatter 4*4 block to strided array with contiguous rows */
+static void
+_t2(scatter_rows, Scalar, 2)(const Scalar* q, Scalar* p, int sy)
+{
+  uint x, y;
+  for (y = 0; y < 4; y++, p += sy, q += 4)
+    for (x = 0; x < 4; x++)
+      p[x] = q[x];
+}
+
 /* scatter nx*ny block to strided array */
 static void
 _t2(scatter_partial, Scalar, 2)(const Scalar* q, Scalar* p, uint nx, uint ny, int sx, int sy)
@@ -24,36 +34,63 @@ _t2(scatter_partial, Scalar, 2)(const Scalar* q, Scalar* p, uint nx, uint ny, in
 static void
 _t2(inv_xform, Int, 2)(Int* p)
 {
+  uint y;
+  /* transform along y for all x at once */
+  _t1(inv_lift_vec, Int)(p, 4, 4);
+  /* transform along x */
+  for (y = 0; y < 4; y++)
+    _t1(inv_lift, Int)(p + 4 * y, 1);
+}
+
+/* partial inverse transform to (2^level)^2 averages stored contiguously at p */
+static void
+_t2(inv_xform_lod, Int, 2)(Int* p, uint level)
+{
+  uint n = 1u << level;
   uint x, y;
+  Int* q = p;
   /* transform along y */
   for (x = 0; x < 4; x++)
-    _t1(inv_lift, Int)(p + 1 * x, 4);
+    _t1(inv_lift_lod, Int)(p + x, 4, level);
   /* transform along x */
-  for (y = 0; y < 4; y++)
-    _t1(inv_lift, Int)(p + 4 * y, 1);
+  for (y = 0; y < n; y++)
+    _t1(inv_lift_lod, Int)(p + 4 * y, 1, level);
+  /* gather averages; no value is overwritten before it is read */
+  for (y = 0; y < n; y++)
+    for (x = 0; x < n; x++)
+      *q++ = p[x + 4 * y];
 }
 
 /* public functions -------------------------------------------------------- */
 
 /* decode 4*4 block and store at p using strides (sx, sy) */
+ISA_DECLARE(zfp_decode_block_strided, (zfp_stream* stream, Scalar* p, int sx, int sy))
 uint
 _t2(zfp_decode_block_strided, Scalar, 2)(zfp_stream* stream, Scalar* p, int sx, int sy)
 {
-  /* decode contiguous block */
   cache_align_(Scalar block[16]);
-  uint bits = _t2(zfp_decode_block, Scalar, 2)(stream, block);
-  /* scatter block to strided array */
-  _t2(scatter, Scalar, 2)(block, p, sx, sy);
+  uint bits;
+  ISA_DISPATCH(stream, zfp_decode_block_strided, (stream, p, sx, sy))
+  /* decode contiguous block */
+  bits = _t2(zfp_decode_block, Scalar, 2)(stream, block);
+  /* scatter block to strided array, a row at a time if rows are contiguous */
+  if (sx == 1)
+    _t2(scatter_rows, Scalar, 2)(block, p, sy);
+  else
+    _t2(scatter, Scalar, 2)(block, p, sx, sy);
   return bits;
 }
 
 /* decode nx*ny block and store at p using strides (sx, sy) */
+ISA_DECLARE(zfp_decode_partial_block_strided, (zfp_stream* stream, Scalar* p, uint nx, uint ny, int sx, int sy))
 uint
 _t2(zfp_decode_partial_block_strided, Scalar, 2)(zfp_stream* stream, Scalar* p, uint nx, uint ny, int sx, int sy)
 {
-  /* decode contiguous block */
   cache_align_(Scalar block[16]);
-  uint bits = _t2(zfp_decode_block, Scalar, 2)(stream, block);
+  uint bits;
+  ISA_DISPATCH(stream, zfp_decode_partial_block_strided, (stream, p, nx, ny, sx, sy))
+  /* decode contiguous block */
+  bits = _t2(zfp_decode_block, Scalar, 2)(stream, block);
   /* scatter block to strided array */
   _t2(scatter_partial, Scalar, 2)(block, p, nx, ny, sx, sy);
   return bits;
@@ -11,6 +11,17 @@ _t2(scatter, Scalar, 3)(const Scalar* q, Scalar* p, int sx, int sy, int sz)
         *p = *q++;
 }
 
+/* scatter 4*4*4 block to strided array with contiguous rows */
+static void
+_t2(scatter_rows, Scalar, 3)(const Scalar* q, Scalar* p, int sy, int sz)
+{
+  uint x, y, z;
+  for (z = 0; z < 4; z++, p += sz - 4 * sy)
+    for (y = 0; y < 4; y++, p += sy, q += 4)
+      for (x = 0; x < 4; x++)
+        p[x] = q[x];
+}
+
 /* scatter nx*ny*nz block to strided array */
 static void
 _t2(scatter_partial, Scalar, 3)(const Scalar* q, Scalar* p, uint nx, uint ny, uint nz, int sx, int sy, int sz)
@@ -26,42 +37,74 @@ _t2(scatter_partial, Scalar, 3)(const Scalar* q, Scalar* p, uint nx, uint ny, ui
 static void
 _t2(inv_xform, Int, 3)(Int* p)
 {
+  uint y, z;
+  /* transform along z for all (x, y) at once */
+  _t1(inv_lift_vec, Int)(p, 16, 16);
+  /* transform along y for all x at once */
+  for (z = 0; z < 4; z++)
+    _t1(inv_lift_vec, Int)(p + 16 * z, 4, 4);
+  /* transform along x */
+  for (z = 0; z < 4; z++)
+    for (y = 0; y < 4; y++)
+      _t1(inv_lift, Int)(p + 4 * y + 16 * z, 1);
+}
+
+/* partial inverse transform to (2^level)^3 averages stored contiguously at p */
+static void
+_t2(inv_xform_lod, Int, 3)(Int* p, uint level)
+{
+  uint n = 1u << level;
   uint x, y, z;
+  Int* q = p;
   /* transform along z */
   for (y = 0; y < 4; y++)
     for (x = 0; x < 4; x++)
-      _t1(inv_lift, Int)(p + 1 * x + 4 * y, 16);
+      _t1(inv_lift_lod, Int)(p + x + 4 * y, 16, level);
   /* transform along y */
-  for (x = 0; x < 4; x++)
-    for (z = 0; z < 4; z++)
-      _t1(inv_lift, Int)(p + 16 * z + 1 * x, 4);
+  for (z = 0; z < n; z++)
+    for (x = 0; x < 4; x++)
+      _t1(inv_lift_lod, Int)(p + x + 16 * z, 4, level);
   /* transform along x */
-  for (z = 0; z < 4; z++)
-    for (y = 0; y < 4; y++)
-      _t1(inv_lift, Int)(p + 4 * y + 16 * z, 1);
+  for (z = 0; z < n; z++)
+    for (y = 0; y < n; y++)
+      _t1(inv_lift_lod, Int)(p + 4 * y + 16 * z, 1, level);
+  /* gather averages; no value is overwritten before it is read */
+  for (z = 0; z < n; z++)
+    for (y = 0; y < n; y++)
+      for (x = 0; x < n; x++)
+        *q++ = p[x + 4 * y + 16 * z];
 }
 
 /* public functions -------------------------------------------------------- */
 
 /* decode 4*4*4 block and store at p using strides (sx, sy, sz) */
+ISA_DECLARE(zfp_decode_block_strided, (zfp_stream* stream, Scalar* p, int sx, int sy, int sz))
 uint
 _t2(zfp_decode_block_strided, Scalar, 3)(zfp_stream* stream, Scalar* p, int sx, int sy, int sz)
 {
-  /* decode contiguous block */
   cache_align_(Scalar block[64]);
-  uint bits = _t2(zfp_decode_block, Scalar, 3)(stream, block);
-  /* scatter block to strided array */
-  _t2(scatter, Scalar, 3)(block, p, sx, sy, sz);
+  uint bits;
+  ISA_DISPATCH(stream, zfp_decode_block_strided, (stream, p, sx, sy, sz))
+  /* decode contiguous block */
+  bits = _t2(zfp_decode_block, Scalar, 3)(stream, block);
+  /* scatter block to strided array, a row at a time if rows are contiguous */
+  if (sx == 1)
+    _t2(scatter_rows, Scalar, 3)(block, p, sy, sz);
+  else
+    _t2(scatter, Scalar, 3)(block, p, sx, sy, sz);
   return bits;
 }
 
 /* decode nx*ny*nz block and store at p using strides (sx, sy, sz) */
+ISA_DECLARE(zfp_decode_partial_block_strided, (zfp_stream* stream, Scalar* p, uint nx, uint ny, uint nz, int sx, int sy, int sz))
 uint
 _t2(zfp_decode_partial_block_strided, Scalar, 3)(zfp_stream* stream, Scalar* p, uint nx, uint ny, uint nz, int sx, int sy, int sz)
 {
-  /* decode contiguous block */
   cache_align_(Scalar block[64]);
-  uint bits = _t2(zfp_decode_block, Scalar, 3)(stream, block);
+  uint bits;
+  ISA_DISPATCH(stream, zfp_decode_partial_block_strided, (stream, p, nx, ny, nz, sx, sy, sz))
+  /* decode contiguous block */
+  bits = _t2(zfp_decode_block, Scalar, 3)(stream, block);
   /* scatter block to strided array */
   _t2(scatter_partial, Scalar, 3)(block, p, nx, ny, nz, sx, sy, sz);
   return bits;
@@ -12,6 +12,18 @@ _t2(scatter, Scalar, 4)(const Scalar* q, Scalar* p, int sx, int sy, int sz, int
           *p = *q++;
 }
 
+/* scatter 4*4*4*4 block to strided array with contiguous rows */
+static void
+_t2(scatter_rows, Scalar, 4)(const Scalar* q, Scalar* p, int sy, int sz, int sw)
+{
+  uint x, y, z, w;
+  for (w = 0; w < 4; w++, p += sw - 4 * sz)
+    for (z = 0; z < 4; z++, p += sz - 4 * sy)
+      for (y = 0; y < 4; y++, p += sy, q += 4)
+        for (x = 0; x < 4; x++)
+          p[x] = q[x];
+}
+
 /* scatter nx*ny*nz*nw block to strided array */
 static void
 _t2(scatter_partial, Scalar, 4)(const Scalar* q, Scalar* p, uint nx, uint ny, uint nz, uint nw, int sx, int sy, int sz, int sw)
@@ -28,50 +40,88 @@ _t2(scatter_partial, Scalar, 4)(const Scalar* q, Scalar* p, uint nx, uint ny, ui
 static void
 _t2(inv_xform, Int, 4)(Int* p)
 {
+  uint y, z, w;
+  /* transform along w for all (x, y, z) at once */
+  _t1(inv_lift_vec, Int)(p, 64, 64);
+  /* transform along z for all (x, y) at once */
+  for (w = 0; w < 4; w++)
+    _t1(inv_lift_vec, Int)(p + 64 * w, 16, 16);
+  /* transform along y for all x at once */
+  for (w = 0; w < 4; w++)
+    for (z = 0; z < 4; z++)
+      _t1(inv_lift_vec, Int)(p + 16 * z + 64 * w, 4, 4);
+  /* transform along x */
+  for (w = 0; w < 4; w++)
+    for (z = 0; z < 4; z++)
+      for (y = 0; y < 4; y++)
+        _t1(inv_lift, Int)(p + 4 * y + 16 * z + 64 * w, 1);
+}
+
+/* partial inverse transform to (2^level)^4 averages stored contiguously at p */
+static void
+_t2(inv_xform_lod, Int, 4)(Int* p, uint level)
+{
+  uint n = 1u << level;
   uint x, y, z, w;
+  Int* q = p;
   /* transform along w */
   for (z = 0; z < 4; z++)
     for (y = 0; y < 4; y++)
       for (x = 0; x < 4; x++)
-        _t1(inv_lift, Int)(p + 1 * x + 4 * y + 16 * z, 64);
+        _t1(inv_lift_lod, Int)(p + x + 4 * y + 16 * z, 64, level);
   /* transform along z */
-  for (y = 0; y < 4; y++)
-    for (x = 0; x < 4; x++)
-      for (w = 0; w < 4; w++)
-        _t1(inv_lift, Int)(p + 64 * w + 1 * x + 4 * y, 16);
+  for (w = 0; w < n; w++)
+    for (y = 0; y < 4; y++)
+      for (x = 0; x < 4; x++)
+        _t1(inv_lift_lod, Int)(p + x + 4 * y + 64 * w, 16, level);
   /* transform along y */
-  for (x = 0; x < 4; x++)
-    for (w = 0; w < 4; w++)
-      for (z = 0; z < 4; z++)
-        _t1(inv_lift, Int)(p + 16 * z + 64 * w + 1 * x, 4);
+  for (w = 0; w < n; w++)
+    for (z = 0; z < n; z++)
+      for (x = 0; x < 4; x++)
+        _t1(inv_lift_lod, Int)(p + x + 16 * z + 64 * w, 4, level);
   /* transform along x */
-  for (w = 0; w < 4; w++)
-    for (z = 0; z < 4; z++)
-      for (y = 0; y < 4; y++)
-        _t1(inv_lift, Int)(p + 4 * y + 16 * z + 64 * w, 1);
+  for (w = 0; w < n; w++)
+    for (z = 0; z < n; z++)
+      for (y = 0; y < n; y++)
+        _t1(inv_lift_lod, Int)(p + 4 * y + 16 * z + 64 * w, 1, level);
+  /* gather averages; no value is overwritten before it is read */
+  for (w = 0; w < n; w++)
+    for (z = 0; z < n; z++)
+      for (y = 0; y < n; y++)
+        for (x = 0; x < n; x++)
+          *q++ = p[x + 4 * y + 16 * z + 64 * w];
 }
 
 /* public functions -------------------------------------------------------- */
 
 /* decode 4*4*4*4 block and store at p using strides (sx, sy, sz, sw) */
+ISA_DECLARE(zfp_decode_block_strided, (zfp_stream* stream, Scalar* p, int sx, int sy, int sz, int sw))
 uint
 _t2(zfp_decode_block_strided, Scalar, 4)(zfp_stream* stream, Scalar* p, int sx, int sy, int sz, int sw)
 {
-  /* decode contiguous block */
   cache_align_(Scalar block[256]);
-  uint bits = _t2(zfp_decode_block, Scalar, 4)(stream, block);
-  /* scatter block to strided array */
-  _t2(scatter, Scalar, 4)(block, p, sx, sy, sz, sw);
+  uint bits;
+  ISA_DISPATCH(stream, zfp_decode_block_strided, (stream, p, sx, sy, sz, sw))
+  /* decode contiguous block */
+  bits = _t2(zfp_decode_block, Scalar, 4)(stream, block);
+  /* scatter block to strided array, a row at a time if rows are contiguous */
+  if (sx == 1)
+    _t2(scatter_rows, Scalar, 4)(block, p, sy, sz, sw);
+  else
+    _t2(scatter, Scalar, 4)(block, p, sx, sy, sz, sw);
   return bits;
 }
 
 /* decode nx*ny*nz*nw block and store at p using strides (sx, sy, sz, sw) */
+ISA_DECLARE(zfp_decode_partial_block_strided, (zfp_stream* stream, Scalar* p, uint nx, uint ny, uint nz, uint nw, int sx, int sy, int sz, int sw))
 uint
 _t2(zfp_decode_partial_block_strided, Scalar, 4)(zfp_stream* stream, Scalar* p, uint nx, uint ny, uint nz, uint nw, int sx, int sy, int sz, int sw)
 {
-  /* decode contiguous block */
   cache_align_(Scalar block[256]);
-  uint bits = _t2(zfp_decode_block, Scalar, 4)(stream, block);
+  uint bits;
+  ISA_DISPATCH(stream, zfp_decode_partial_block_strided, (stream, p, nx, ny, nz, nw, sx, sy, sz, sw))
+  /* decode contiguous block */
+  bits = _t2(zfp_decode_block, Scalar, 4)(stream, block);
   /* scatter block to strided array */
   _t2(scatter_partial, Scalar, 4)(block, p, nx, ny, nz, nw, sx, sy, sz, sw);
   return bits;
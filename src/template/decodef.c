@@ -1,3 +1,5 @@
+#include <string.h>
+
 static uint _t2(rev_decode_block, Scalar, DIMS)(zfp_stream* zfp, Scalar* fblock);
 
 /* private functions ------------------------------------------------------- */
@@ -33,11 +35,266 @@ _t2(decode_block, Scalar, DIMS)(zfp_stream* zfp, Scalar* fblock)
   return bits;
 }
 
+/* decode contiguous floating-point block and accumulate statistics */
+static uint
+_t2(decode_block_stats, Scalar, DIMS)(zfp_stream* zfp, Scalar* fblock)
+{
+  zfp_stream_stats* stats = zfp->stats;
+  double start = zfp_stats_clock();
+  uint bits = 1;
+  if (REVERSIBLE(zfp)) {
+    /* phases of reversible decoding are not timed separately */
+    bits = _t2(rev_decode_block, Scalar, DIMS)(zfp, fblock);
+    stats->coding_time += zfp_stats_clock() - start;
+  }
+  else if (stream_read_bit(zfp->stream)) {
+    cache_align_(Int iblock[BLOCK_SIZE]);
+    int emax, maxprec;
+    /* decode common exponent and integer block */
+    bits += EBITS;
+    emax = (int)stream_read_bits(zfp->stream, EBITS) - EBIAS;
+    maxprec = precision(emax, zfp->maxprec, zfp->minexp, DIMS);
+    bits += _t2(decode_block_stats, Int, DIMS)(zfp->stream, zfp->minbits - bits, zfp->maxbits - bits, maxprec, iblock, stats, start);
+    /* perform inverse block-floating-point transform */
+    start = zfp_stats_clock();
+    _t1(inv_cast, Scalar)(iblock, fblock, BLOCK_SIZE, emax);
+    stats->cast_time += zfp_stats_clock() - start;
+  }
+  else {
+    /* set all values to zero */
+    uint i;
+    for (i = 0; i < BLOCK_SIZE; i++)
+      fblock[i] = 0;
+    if (zfp->minbits > bits) {
+      stream_skip(zfp->stream, zfp->minbits - bits);
+      bits = zfp->minbits;
+    }
+    stats->zero_blocks++;
+    stats->coding_time += zfp_stats_clock() - start;
+  }
+  stats_add_block(stats, bits);
+  return bits;
+}
+
+/* decode contiguous floating-point block to (2^level)^d sub-block averages */
+static uint
+_t2(decode_block_lod, Scalar, DIMS)(zfp_stream* zfp, Scalar* fblock, uint level)
+{
+  uint n = 1u << (level * DIMS);
+  uint bits = 1;
+  /* test if block has nonzero values */
+  if (stream_read_bit(zfp->stream)) {
+    cache_align_(Int iblock[BLOCK_SIZE]);
+    int emax, maxprec;
+    /* decode common exponent */
+    bits += EBITS;
+    emax = (int)stream_read_bits(zfp->stream, EBITS) - EBIAS;
+    maxprec = precision(emax, zfp->maxprec, zfp->minexp, DIMS);
+    /* decode integer block averages */
+    bits += _t2(decode_block_lod, Int, DIMS)(zfp->stream, zfp->minbits - bits, zfp->maxbits - bits, maxprec, iblock, level);
+    /* perform inverse block-floating-point transform */
+    _t1(inv_cast, Scalar)(iblock, fblock, n, emax);
+  }
+  else {
+    /* set all averages to zero */
+    uint i;
+    for (i = 0; i < n; i++)
+      *fblock++ = 0;
+    if (zfp->minbits > bits) {
+      stream_skip(zfp->stream, zfp->minbits - bits);
+      bits = zfp->minbits;
+    }
+  }
+  return bits;
+}
+
+/* decode contiguous floating-point block to transform coefficients */
+static uint
+_t2(decode_block_coefficients, Scalar, DIMS)(zfp_stream* zfp, Int* iblock, int* emax)
+{
+  uint bits = 1;
+  /* test if block has nonzero values */
+  if (stream_read_bit(zfp->stream)) {
+    cache_align_(UInt ublock[BLOCK_SIZE]);
+    int maxprec;
+    uint b;
+    /* decode common exponent */
+    bits += EBITS;
+    *emax = (int)stream_read_bits(zfp->stream, EBITS) - EBIAS;
+    maxprec = precision(*emax, zfp->maxprec, zfp->minexp, DIMS);
+    /* decode integer coefficients and read at least minbits bits */
+    if (BLOCK_SIZE <= 64)
+      b = _t1(decode_ints, UInt)(zfp->stream, zfp->maxbits - bits, maxprec, ublock, BLOCK_SIZE);
+    else
+      b = _t1(decode_many_ints, UInt)(zfp->stream, zfp->maxbits - bits, maxprec, ublock, BLOCK_SIZE);
+    bits += b;
+    if (zfp->minbits > bits) {
+      stream_skip(zfp->stream, zfp->minbits - bits);
+      bits = zfp->minbits;
+    }
+    /* reorder unsigned coefficients and convert to signed integer */
+    _t1(inv_order, Int)(ublock, iblock, PERM, BLOCK_SIZE);
+  }
+  else {
+    /* set all coefficients to zero */
+    uint i;
+    for (i = 0; i < BLOCK_SIZE; i++)
+      iblock[i] = 0;
+    *emax = -EBIAS;
+    if (zfp->minbits > bits) {
+      stream_skip(zfp->stream, zfp->minbits - bits);
+      bits = zfp->minbits;
+    }
+  }
+  return bits;
+}
+
+/* decode n <= BATCH_LANES contiguous floating-point blocks using lossy algorithm */
+static size_t
+_t2(decode_lanes, Scalar, DIMS)(zfp_stream* zfp, Scalar* fblock, uint n)
+{
+  cache_align_(Int iblock[BLOCK_SIZE * BATCH_LANES]);
+  int emax[BATCH_LANES];
+  uint nonzero[BATCH_LANES];
+  size_t bits = 0;
+  uint i, l;
+  /* decode blocks one at a time into lanes */
+  for (l = 0; l < BATCH_LANES; l++) {
+    nonzero[l] = l < n && stream_read_bit(zfp->stream);
+    if (nonzero[l]) {
+      /* decode common exponent and integer block */
+      uint b = 1 + EBITS;
+      int maxprec;
+      emax[l] = (int)stream_read_bits(zfp->stream, EBITS) - EBIAS;
+      maxprec = precision(emax[l], zfp->maxprec, zfp->minexp, DIMS);
+      b += _t2(decode_lane, Int, DIMS)(zfp->stream, zfp->minbits - b, zfp->maxbits - b, maxprec, iblock, l);
+      bits += b;
+    }
+    else {
+      /* zero unused lanes and lanes whose blocks are all zero */
+      for (i = 0; i < BLOCK_SIZE; i++)
+        iblock[i * BATCH_LANES + l] = 0;
+      if (l < n) {
+        uint b = 1;
+        if (zfp->minbits > b) {
+          stream_skip(zfp->stream, zfp->minbits - b);
+          b = zfp->minbits;
+        }
+        bits += b;
+      }
+    }
+  }
+  /* perform inverse decorrelating transform on all lanes at once */
+  _t2(inv_xform_lanes, Int, DIMS)(iblock);
+  /* perform inverse block-floating-point transform of each lane */
+  for (l = 0; l < n; l++, fblock += BLOCK_SIZE) {
+    if (nonzero[l]) {
+      Scalar s = _t1(dequantize, Scalar)(1, emax[l]);
+      for (i = 0; i < BLOCK_SIZE; i++)
+        fblock[i] = (Scalar)(s * iblock[i * BATCH_LANES + l]);
+    }
+    else
+      for (i = 0; i < BLOCK_SIZE; i++)
+        fblock[i] = 0;
+  }
+  return bits;
+}
+
+/* decode contiguous floating-point block in current mode */
+static uint
+_t2(decode_block_mode, Scalar, DIMS)(zfp_stream* zfp, Scalar* fblock)
+{
+  if (STATS_ENABLED(zfp))
+    return _t2(decode_block_stats, Scalar, DIMS)(zfp, fblock);
+  return REVERSIBLE(zfp) ? _t2(rev_decode_block, Scalar, DIMS)(zfp, fblock) : _t2(decode_block, Scalar, DIMS)(zfp, fblock);
+}
+
+/* decode contiguous floating-point block prefixed with raw-storage flag */
+static uint
+_t2(decode_block_raw, Scalar, DIMS)(zfp_stream* zfp, Scalar* fblock)
+{
+  uint bits = 1;
+  if (stream_read_bit(zfp->stream)) {
+    /* block is stored verbatim */
+    uint i;
+    for (i = 0; i < BLOCK_SIZE; i++) {
+      UInt u = (UInt)stream_read_bits(zfp->stream, CHAR_BIT * (uint)sizeof(u));
+      memcpy(fblock + i, &u, sizeof(u));
+    }
+    bits += BLOCK_SIZE * CHAR_BIT * (uint)sizeof(Scalar);
+    if (zfp->minbits > bits) {
+      stream_skip(zfp->stream, zfp->minbits - bits);
+      bits = zfp->minbits;
+    }
+  }
+  else {
+    zfp_stream s = *zfp;
+    s.minbits = zfp->minbits ? zfp->minbits - 1 : 0;
+    s.maxbits = zfp->maxbits - 1;
+    bits += _t2(decode_block_mode, Scalar, DIMS)(&s, fblock);
+  }
+  return bits;
+}
+
 /* public functions -------------------------------------------------------- */
 
 /* decode contiguous floating-point block */
+ISA_DECLARE(zfp_decode_block, (zfp_stream* zfp, Scalar* fblock))
 uint
 _t2(zfp_decode_block, Scalar, DIMS)(zfp_stream* zfp, Scalar* fblock)
 {
-  return REVERSIBLE(zfp) ? _t2(rev_decode_block, Scalar, DIMS)(zfp, fblock) : _t2(decode_block, Scalar, DIMS)(zfp, fblock);
+  ISA_DISPATCH(zfp, zfp_decode_block, (zfp, fblock))
+  if (RAW_BLOCKS(zfp))
+    return _t2(decode_block_raw, Scalar, DIMS)(zfp, fblock);
+  return _t2(decode_block_mode, Scalar, DIMS)(zfp, fblock);
+}
+
+/* decode contiguous floating-point block to (2^level)^d sub-block averages */
+ISA_DECLARE(zfp_decode_block_lod, (zfp_stream* zfp, Scalar* fblock, uint level))
+uint
+_t2(zfp_decode_block_lod, Scalar, DIMS)(zfp_stream* zfp, Scalar* fblock, uint level)
+{
+  ISA_DISPATCH(zfp, zfp_decode_block_lod, (zfp, fblock, level))
+  return REVERSIBLE(zfp) || RAW_BLOCKS(zfp) || level > 2 ? 0 : _t2(decode_block_lod, Scalar, DIMS)(zfp, fblock, level);
+}
+
+/* decode contiguous floating-point block to transform coefficients and common exponent */
+ISA_DECLARE(zfp_decode_block_coefficients, (zfp_stream* zfp, Int* iblock, int* emax))
+uint
+_t2(zfp_decode_block_coefficients, Scalar, DIMS)(zfp_stream* zfp, Int* iblock, int* emax)
+{
+  ISA_DISPATCH(zfp, zfp_decode_block_coefficients, (zfp, iblock, emax))
+  return REVERSIBLE(zfp) || RAW_BLOCKS(zfp) ? 0 : _t2(decode_block_coefficients, Scalar, DIMS)(zfp, iblock, emax);
+}
+
+/* decode n contiguous floating-point blocks stored consecutively */
+ISA_DECLARE_TYPED(size_t, zfp_decode_blocks, (zfp_stream* zfp, size_t n, Scalar* fblock))
+size_t
+_t2(zfp_decode_blocks, Scalar, DIMS)(zfp_stream* zfp, size_t n, Scalar* fblock)
+{
+  size_t bits = 0;
+  uint m;
+  ISA_DISPATCH(zfp, zfp_decode_blocks, (zfp, n, fblock))
+  if (RAW_BLOCKS(zfp)) {
+    for (; n; n--, fblock += BLOCK_SIZE)
+      bits += _t2(decode_block_raw, Scalar, DIMS)(zfp, fblock);
+    return bits;
+  }
+  if (STATS_ENABLED(zfp)) {
+    /* decode one block at a time to gather per-block statistics */
+    for (; n; n--, fblock += BLOCK_SIZE)
+      bits += _t2(decode_block_stats, Scalar, DIMS)(zfp, fblock);
+    return bits;
+  }
+  if (REVERSIBLE(zfp)) {
+    for (; n; n--, fblock += BLOCK_SIZE)
+      bits += _t2(rev_decode_block, Scalar, DIMS)(zfp, fblock);
+    return bits;
+  }
+  /* transform up to BATCH_LANES blocks at a time, one per SIMD lane */
+  for (; n; n -= m, fblock += (size_t)m * BLOCK_SIZE) {
+    m = (uint)MIN(n, (size_t)BATCH_LANES);
+    bits += _t2(decode_lanes, Scalar, DIMS)(zfp, fblock, m);
+  }
+  return bits;
 }
@@ -1,10 +1,103 @@
 static uint _t2(rev_decode_block, Int, DIMS)(bitstream* stream, int minbits, int maxbits, Int* iblock);
 
+/* private functions ------------------------------------------------------- */
+
+/* decode contiguous integer block in current mode */
+static uint
+_t2(decode_block_mode, Int, DIMS)(zfp_stream* zfp, Int* iblock)
+{
+  if (STATS_ENABLED(zfp)) {
+    zfp_stream_stats* stats = zfp->stats;
+    double start = zfp_stats_clock();
+    uint bits;
+    if (REVERSIBLE(zfp)) {
+      /* phases of reversible decoding are not timed separately */
+      bits = _t2(rev_decode_block, Int, DIMS)(zfp->stream, zfp->minbits, zfp->maxbits, iblock);
+      stats->coding_time += zfp_stats_clock() - start;
+    }
+    else
+      bits = _t2(decode_block_stats, Int, DIMS)(zfp->stream, zfp->minbits, zfp->maxbits, zfp->maxprec, iblock, stats, start);
+    stats_add_block(stats, bits);
+    return bits;
+  }
+  return REVERSIBLE(zfp) ? _t2(rev_decode_block, Int, DIMS)(zfp->stream, zfp->minbits, zfp->maxbits, iblock) : _t2(decode_block, Int, DIMS)(zfp->stream, zfp->minbits, zfp->maxbits, zfp->maxprec, iblock);
+}
+
+/* decode contiguous integer block prefixed with raw-storage flag */
+static uint
+_t2(decode_block_raw, Int, DIMS)(zfp_stream* zfp, Int* iblock)
+{
+  uint bits = 1;
+  if (stream_read_bit(zfp->stream)) {
+    /* block is stored verbatim */
+    uint i;
+    for (i = 0; i < BLOCK_SIZE; i++)
+      iblock[i] = (Int)(UInt)stream_read_bits(zfp->stream, CHAR_BIT * (uint)sizeof(Int));
+    bits += BLOCK_SIZE * CHAR_BIT * (uint)sizeof(Int);
+    if (zfp->minbits > bits) {
+      stream_skip(zfp->stream, zfp->minbits - bits);
+      bits = zfp->minbits;
+    }
+  }
+  else {
+    zfp_stream s = *zfp;
+    s.minbits = zfp->minbits ? zfp->minbits - 1 : 0;
+    s.maxbits = zfp->maxbits - 1;
+    bits += _t2(decode_block_mode, Int, DIMS)(&s, iblock);
+  }
+  return bits;
+}
+
 /* public functions -------------------------------------------------------- */
 
 /* decode contiguous integer block */
+ISA_DECLARE(zfp_decode_block, (zfp_stream* zfp, Int* iblock))
 uint
 _t2(zfp_decode_block, Int, DIMS)(zfp_stream* zfp, Int* iblock)
 {
-  return REVERSIBLE(zfp) ? _t2(rev_decode_block, Int, DIMS)(zfp->stream, zfp->minbits, zfp->maxbits, iblock) : _t2(decode_block, Int, DIMS)(zfp->stream, zfp->minbits, zfp->maxbits, zfp->maxprec, iblock);
+  ISA_DISPATCH(zfp, zfp_decode_block, (zfp, iblock))
+  if (RAW_BLOCKS(zfp))
+    return _t2(decode_block_raw, Int, DIMS)(zfp, iblock);
+  return _t2(decode_block_mode, Int, DIMS)(zfp, iblock);
+}
+
+/* decode contiguous integer block to (2^level)^d sub-block averages */
+ISA_DECLARE(zfp_decode_block_lod, (zfp_stream* zfp, Int* iblock, uint level))
+uint
+_t2(zfp_decode_block_lod, Int, DIMS)(zfp_stream* zfp, Int* iblock, uint level)
+{
+  ISA_DISPATCH(zfp, zfp_decode_block_lod, (zfp, iblock, level))
+  return REVERSIBLE(zfp) || RAW_BLOCKS(zfp) || level > 2 ? 0 : _t2(decode_block_lod, Int, DIMS)(zfp->stream, zfp->minbits, zfp->maxbits, zfp->maxprec, iblock, level);
+}
+
+/* decode n contiguous integer blocks stored consecutively */
+ISA_DECLARE_TYPED(size_t, zfp_decode_blocks, (zfp_stream* zfp, size_t n, Int* iblock))
+size_t
+_t2(zfp_decode_blocks, Int, DIMS)(zfp_stream* zfp, size_t n, Int* iblock)
+{
+  cache_align_(Int block[BLOCK_SIZE * BATCH_LANES]);
+  size_t bits = 0;
+  uint i, l, m;
+  ISA_DISPATCH(zfp, zfp_decode_blocks, (zfp, n, iblock))
+  if (REVERSIBLE(zfp) || STATS_ENABLED(zfp) || RAW_BLOCKS(zfp)) {
+    for (; n; n--, iblock += BLOCK_SIZE)
+      bits += _t2(zfp_decode_block, Int, DIMS)(zfp, iblock);
+    return bits;
+  }
+  for (; n; n -= m, iblock += (size_t)m * BLOCK_SIZE) {
+    m = (uint)MIN(n, (size_t)BATCH_LANES);
+    /* decode blocks one at a time into lanes; zero unused lanes */
+    for (l = 0; l < m; l++)
+      bits += _t2(decode_lane, Int, DIMS)(zfp->stream, zfp->minbits, zfp->maxbits, zfp->maxprec, block, l);
+    for (i = 0; i < BLOCK_SIZE; i++)
+      for (l = m; l < BATCH_LANES; l++)
+        block[i * BATCH_LANES + l] = 0;
+    /* perform inverse decorrelating transform on all lanes at once */
+    _t2(inv_xform_lanes, Int, DIMS)(block);
+    /* deinterleave blocks */
+    for (l = 0; l < m; l++)
+      for (i = 0; i < BLOCK_SIZE; i++)
+        iblock[l * BLOCK_SIZE + i] = block[i * BATCH_LANES + l];
+  }
+  return bits;
 }
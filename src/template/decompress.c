@@ -14,6 +14,72 @@ _t2(decompress, Scalar, 1)(zfp_stream* stream, zfp_field* field)
     _t2(zfp_decode_partial_block_strided, Scalar, 1)(stream, data, nx - x, 1);
 }
 
+/* decompress 2d contiguous array */
+static void
+_t2(decompress, Scalar, 2)(zfp_stream* stream, zfp_field* field)
+{
+  Scalar* data = (Scalar*)field->data;
+  size_t nx = field->nx;
+  size_t ny = field->ny;
+  size_t x, y;
+
+  /* decompress array one block of 4x4 values at a time */
+  for (y = 0; y < ny; y += 4)
+    for (x = 0; x < nx; x += 4) {
+      Scalar* p = data + x + nx * y;
+      if (nx - x < 4 || ny - y < 4)
+        _t2(zfp_decode_partial_block_strided, Scalar, 2)(stream, p, (uint)MIN(nx - x, 4u), (uint)MIN(ny - y, 4u), 1, (int)nx);
+      else
+        _t2(zfp_decode_block_strided, Scalar, 2)(stream, p, 1, (int)nx);
+    }
+}
+
+/* decompress 3d contiguous array */
+static void
+_t2(decompress, Scalar, 3)(zfp_stream* stream, zfp_field* field)
+{
+  Scalar* data = (Scalar*)field->data;
+  size_t nx = field->nx;
+  size_t ny = field->ny;
+  size_t nz = field->nz;
+  size_t x, y, z;
+
+  /* decompress array one block of 4x4x4 values at a time */
+  for (z = 0; z < nz; z += 4)
+    for (y = 0; y < ny; y += 4)
+      for (x = 0; x < nx; x += 4) {
+        Scalar* p = data + x + nx * (y + ny * z);
+        if (nx - x < 4 || ny - y < 4 || nz - z < 4)
+          _t2(zfp_decode_partial_block_strided, Scalar, 3)(stream, p, (uint)MIN(nx - x, 4u), (uint)MIN(ny - y, 4u), (uint)MIN(nz - z, 4u), 1, (int)nx, (int)(nx * ny));
+        else
+          _t2(zfp_decode_block_strided, Scalar, 3)(stream, p, 1, (int)nx, (int)(nx * ny));
+      }
+}
+
+/* decompress 4d contiguous array */
+static void
+_t2(decompress, Scalar, 4)(zfp_stream* stream, zfp_field* field)
+{
+  Scalar* data = (Scalar*)field->data;
+  size_t nx = field->nx;
+  size_t ny = field->ny;
+  size_t nz = field->nz;
+  size_t nw = field->nw;
+  size_t x, y, z, w;
+
+  /* decompress array one block of 4x4x4x4 values at a time */
+  for (w = 0; w < nw; w += 4)
+    for (z = 0; z < nz; z += 4)
+      for (y = 0; y < ny; y += 4)
+        for (x = 0; x < nx; x += 4) {
+          Scalar* p = data + x + nx * (y + ny * (z + nz * w));
+          if (nx - x < 4 || ny - y < 4 || nz - z < 4 || nw - w < 4)
+            _t2(zfp_decode_partial_block_strided, Scalar, 4)(stream, p, (uint)MIN(nx - x, 4u), (uint)MIN(ny - y, 4u), (uint)MIN(nz - z, 4u), (uint)MIN(nw - w, 4u), 1, (int)nx, (int)(nx * ny), (int)(nx * ny * nz));
+          else
+            _t2(zfp_decode_block_strided, Scalar, 4)(stream, p, 1, (int)nx, (int)(nx * ny), (int)(nx * ny * nz));
+        }
+}
+
 /* decompress 1d strided array */
 static void
 _t2(decompress_strided, Scalar, 1)(zfp_stream* stream, zfp_field* field)
@@ -107,3 +173,440 @@ _t2(decompress_strided, Scalar, 4)(zfp_stream* stream, zfp_field* field)
             _t2(zfp_decode_block_strided, Scalar, 4)(stream, p, sx, sy, sz, sw);
         }
 }
+
+/* decompress block with given raster index and return number of bits read */
+static uint
+_t1(decompress_block, Scalar)(zfp_stream* stream, zfp_field* field, size_t block)
+{
+  Scalar* p = (Scalar*)field->data;
+  uint nx = MAX(field->nx, 1u);
+  uint ny = MAX(field->ny, 1u);
+  uint nz = MAX(field->nz, 1u);
+  uint nw = MAX(field->nw, 1u);
+  int sx = field->sx ? field->sx : 1;
+  int sy = field->sy ? field->sy : (int)nx;
+  int sz = field->sz ? field->sz : (int)(nx * ny);
+  int sw = field->sw ? field->sw : (int)(nx * ny * nz);
+  uint x, y, z, w;
+  uint mx, my, mz, mw;
+
+  /* determine block origin (x, y, z, w) and extent within array */
+  x = 4 * (uint)(block % ((nx + 3) / 4)); block /= (nx + 3) / 4;
+  y = 4 * (uint)(block % ((ny + 3) / 4)); block /= (ny + 3) / 4;
+  z = 4 * (uint)(block % ((nz + 3) / 4)); block /= (nz + 3) / 4;
+  w = 4 * (uint)block;
+  mx = MIN(nx - x, 4u);
+  my = MIN(ny - y, 4u);
+  mz = MIN(nz - z, 4u);
+  mw = MIN(nw - w, 4u);
+  p += sx * (ptrdiff_t)x + sy * (ptrdiff_t)y + sz * (ptrdiff_t)z + sw * (ptrdiff_t)w;
+
+  /* decompress partial or full block */
+  switch (zfp_field_dimensionality(field)) {
+    case 1:
+      if (mx < 4)
+        return _t2(zfp_decode_partial_block_strided, Scalar, 1)(stream, p, mx, sx);
+      return _t2(zfp_decode_block_strided, Scalar, 1)(stream, p, sx);
+    case 2:
+      if (mx < 4 || my < 4)
+        return _t2(zfp_decode_partial_block_strided, Scalar, 2)(stream, p, mx, my, sx, sy);
+      return _t2(zfp_decode_block_strided, Scalar, 2)(stream, p, sx, sy);
+    case 3:
+      if (mx < 4 || my < 4 || mz < 4)
+        return _t2(zfp_decode_partial_block_strided, Scalar, 3)(stream, p, mx, my, mz, sx, sy, sz);
+      return _t2(zfp_decode_block_strided, Scalar, 3)(stream, p, sx, sy, sz);
+    case 4:
+      if (mx < 4 || my < 4 || mz < 4 || mw < 4)
+        return _t2(zfp_decode_partial_block_strided, Scalar, 4)(stream, p, mx, my, mz, mw, sx, sy, sz, sw);
+      return _t2(zfp_decode_block_strided, Scalar, 4)(stream, p, sx, sy, sz, sw);
+    default:
+      return 0;
+  }
+}
+
+/* decompress field of interleaved components compressed by compress_interleaved */
+static void
+_t1(decompress_interleaved, Scalar)(zfp_stream* stream, zfp_field* field, uint components)
+{
+  size_t bx = (MAX(field->nx, 1u) + 3) / 4;
+  size_t by = (MAX(field->ny, 1u) + 3) / 4;
+  size_t bz = (MAX(field->nz, 1u) + 3) / 4;
+  size_t bw = (MAX(field->nw, 1u) + 3) / 4;
+  size_t blocks = bx * by * bz * bw;
+  zfp_field f = *field;
+  size_t b;
+  uint c;
+
+  for (b = 0; b < blocks; b++)
+    for (c = 0; c < components; c++) {
+      f.data = (Scalar*)field->data + c;
+      _t1(decompress_block, Scalar)(stream, &f, b);
+    }
+}
+
+/* decompress sub-block averages of all blocks into reduced array */
+static void
+_t1(decompress_lod, Scalar)(zfp_stream* stream, zfp_field* field, uint level)
+{
+  cache_align_(Scalar block[256]);
+  Scalar* data = (Scalar*)field->data;
+  uint dims = zfp_field_dimensionality(field);
+  uint m = 1u << level;
+  uint s = 4u >> level;
+  uint nx = MAX(field->nx, 1u);
+  uint ny = MAX(field->ny, 1u);
+  uint nz = MAX(field->nz, 1u);
+  uint nw = MAX(field->nw, 1u);
+  /* dimensions of reduced array */
+  uint lx = (nx + s - 1) / s;
+  uint ly = dims > 1 ? (ny + s - 1) / s : 1;
+  uint lz = dims > 2 ? (nz + s - 1) / s : 1;
+  uint lw = dims > 3 ? (nw + s - 1) / s : 1;
+  int sx = field->sx ? field->sx : 1;
+  int sy = field->sy ? field->sy : (int)lx;
+  int sz = field->sz ? field->sz : (int)(lx * ly);
+  int sw = field->sw ? field->sw : (int)(lx * ly * lz);
+  /* block extents in reduced array */
+  uint mx = m;
+  uint my = dims > 1 ? m : 1;
+  uint mz = dims > 2 ? m : 1;
+  uint mw = dims > 3 ? m : 1;
+  uint x, y, z, w;
+
+  /* decompress blocks in raster order */
+  for (w = 0; w < lw; w += mw)
+    for (z = 0; z < lz; z += mz)
+      for (y = 0; y < ly; y += my)
+        for (x = 0; x < lx; x += mx) {
+          const Scalar* q = block;
+          Scalar* p = data + sx * (ptrdiff_t)x + sy * (ptrdiff_t)y + sz * (ptrdiff_t)z + sw * (ptrdiff_t)w;
+          uint i, j, k, l;
+          switch (dims) {
+            case 1:
+              _t2(zfp_decode_block_lod, Scalar, 1)(stream, block, level);
+              break;
+            case 2:
+              _t2(zfp_decode_block_lod, Scalar, 2)(stream, block, level);
+              break;
+            case 3:
+              _t2(zfp_decode_block_lod, Scalar, 3)(stream, block, level);
+              break;
+            case 4:
+              _t2(zfp_decode_block_lod, Scalar, 4)(stream, block, level);
+              break;
+          }
+          /* scatter averages that lie within the reduced array */
+          for (l = 0; l < mw; l++)
+            for (k = 0; k < mz; k++)
+              for (j = 0; j < my; j++)
+                for (i = 0; i < mx; i++, q++)
+                  if (x + i < lx && y + j < ly && z + k < lz && w + l < lw)
+                    p[sx * (ptrdiff_t)i + sy * (ptrdiff_t)j + sz * (ptrdiff_t)k + sw * (ptrdiff_t)l] = *q;
+        }
+}
+
+/* decompress blocks intersecting box of size (mx, my, mz) at (x0, y0, z0) into strided array */
+static void
+_t1(decompress_subset, Scalar)(zfp_stream* stream, zfp_field* field, size_t x0, size_t y0, size_t z0, size_t mx, size_t my, size_t mz)
+{
+  cache_align_(Scalar block[64]);
+  Scalar* data = (Scalar*)field->data;
+  uint dims = zfp_field_dimensionality(field);
+  size_t bx = (MAX(field->nx, 1u) + 3) / 4;
+  size_t by = (MAX(field->ny, 1u) + 3) / 4;
+  size_t bz = (MAX(field->nz, 1u) + 3) / 4;
+  size_t blocks = bx * by * bz;
+  ptrdiff_t sx = field->sx ? field->sx : 1;
+  ptrdiff_t sy = field->sy ? field->sy : (ptrdiff_t)mx;
+  ptrdiff_t sz = field->sz ? field->sz : (ptrdiff_t)(mx * my);
+  size_t base = stream_rtell(stream->stream);
+  size_t next = blocks;
+  size_t i, j, k;
+
+  /* visit intersecting blocks in raster order */
+  for (k = z0 / 4; k <= (z0 + mz - 1) / 4; k++)
+    for (j = y0 / 4; j <= (y0 + my - 1) / 4; j++)
+      for (i = x0 / 4; i <= (x0 + mx - 1) / 4; i++) {
+        size_t b = i + bx * (j + by * k);
+        size_t xmin = MAX(x0, 4 * i), xmax = MIN(x0 + mx, 4 * i + 4);
+        size_t ymin = MAX(y0, 4 * j), ymax = MIN(y0 + my, 4 * j + 4);
+        size_t zmin = MAX(z0, 4 * k), zmax = MIN(z0 + mz, 4 * k + 4);
+        size_t x, y, z;
+        uint64 offset;
+        size_t first = locate_block(stream, blocks, b, &offset);
+        /* seek unless stream is already positioned between located block and b */
+        if (next < first || next > b) {
+          stream_rseek(stream->stream, base + (size_t)offset);
+          next = first;
+        }
+        /* decode any preceding blocks of variable size, then block b */
+        for (; next <= b; next++)
+          switch (dims) {
+            case 1:
+              _t2(zfp_decode_block, Scalar, 1)(stream, block);
+              break;
+            case 2:
+              _t2(zfp_decode_block, Scalar, 2)(stream, block);
+              break;
+            case 3:
+              _t2(zfp_decode_block, Scalar, 3)(stream, block);
+              break;
+          }
+        /* copy intersection of block and box */
+        for (z = zmin; z < zmax; z++)
+          for (y = ymin; y < ymax; y++)
+            for (x = xmin; x < xmax; x++)
+              data[sx * (ptrdiff_t)(x - x0) + sy * (ptrdiff_t)(y - y0) + sz * (ptrdiff_t)(z - z0)] = block[(x - 4 * i) + 4 * (y - 4 * j) + 16 * (z - 4 * k)];
+      }
+}
+
+/* decompress listed blocks into consecutive bricks or else into strided field */
+static void
+_t1(decompress_blocks, Scalar)(zfp_stream* stream, zfp_field* field, const size_t* index, size_t count, void* bricks)
+{
+  cache_align_(Scalar block[64]);
+  Scalar* data = (Scalar*)field->data;
+  uint dims = zfp_field_dimensionality(field);
+  size_t nx = MAX(field->nx, 1u);
+  size_t ny = MAX(field->ny, 1u);
+  size_t nz = MAX(field->nz, 1u);
+  size_t bx = (nx + 3) / 4;
+  size_t by = (ny + 3) / 4;
+  size_t bz = (nz + 3) / 4;
+  size_t blocks = bx * by * bz;
+  size_t size = (size_t)1 << (2 * dims);
+  ptrdiff_t sx = field->sx ? field->sx : 1;
+  ptrdiff_t sy = field->sy ? field->sy : (ptrdiff_t)nx;
+  ptrdiff_t sz = field->sz ? field->sz : (ptrdiff_t)(nx * ny);
+  size_t base = stream_rtell(stream->stream);
+  size_t next = blocks;
+  size_t n;
+
+  for (n = 0; n < count; n++) {
+    size_t b = index[n];
+    size_t i = 4 * (b % bx);
+    size_t j = 4 * (b / bx % by);
+    size_t k = 4 * (b / (bx * by));
+    Scalar* q = bricks ? (Scalar*)bricks + n * size : block;
+    size_t x, y, z;
+    uint64 offset;
+    size_t first = locate_block(stream, blocks, b, &offset);
+    /* seek unless stream is already positioned between located block and b */
+    if (next < first || next > b) {
+      stream_rseek(stream->stream, base + (size_t)offset);
+      next = first;
+    }
+    /* decode any preceding blocks of variable size, then block b */
+    for (; next <= b; next++)
+      switch (dims) {
+        case 1:
+          _t2(zfp_decode_block, Scalar, 1)(stream, q);
+          break;
+        case 2:
+          _t2(zfp_decode_block, Scalar, 2)(stream, q);
+          break;
+        case 3:
+          _t2(zfp_decode_block, Scalar, 3)(stream, q);
+          break;
+      }
+    /* scatter block values that lie within the field */
+    if (!bricks)
+      for (z = k; z < MIN(k + 4, nz); z++)
+        for (y = j; y < MIN(j + 4, ny); y++)
+          for (x = i; x < MIN(i + 4, nx); x++)
+            data[sx * (ptrdiff_t)x + sy * (ptrdiff_t)y + sz * (ptrdiff_t)z] = block[(x - i) + 4 * (y - j) + 16 * (z - k)];
+  }
+}
+
+/* decompress contiguous block of field with given dimensionality */
+static uint
+_t1(decode_field_block, Scalar)(zfp_stream* stream, uint dims, void* block)
+{
+  Scalar* p = (Scalar*)block;
+  switch (dims) {
+    case 1:
+      return _t2(zfp_decode_block, Scalar, 1)(stream, p);
+    case 2:
+      return _t2(zfp_decode_block, Scalar, 2)(stream, p);
+    case 3:
+      return _t2(zfp_decode_block, Scalar, 3)(stream, p);
+    case 4:
+      return _t2(zfp_decode_block, Scalar, 4)(stream, p);
+    default:
+      return 0;
+  }
+}
+
+/* decode once each block referenced by sorted taps [begin, end) and store
+   the tapped values by tap index; the stream position is left unchanged */
+static void
+_t1(sample_blocks, Scalar)(zfp_stream* stream, const zfp_field* field, const sample_tap* tap, size_t begin, size_t end, void* values)
+{
+  cache_align_(Scalar block[256]);
+  Scalar* value = (Scalar*)values;
+  uint dims = zfp_field_dimensionality(field);
+  size_t blocks = ((MAX(field->nx, 1u) + 3) / 4) * ((MAX(field->ny, 1u) + 3) / 4) *
+                  ((MAX(field->nz, 1u) + 3) / 4) * ((MAX(field->nw, 1u) + 3) / 4);
+  size_t base = stream_rtell(stream->stream);
+  size_t next = blocks;
+  size_t b = blocks;
+  size_t t;
+
+  for (t = begin; t < end; t++) {
+    if (tap[t].block != b) {
+      uint64 offset;
+      size_t first;
+      b = tap[t].block;
+      first = locate_block(stream, blocks, b, &offset);
+      /* seek unless stream is already positioned between located block and b */
+      if (next < first || next > b) {
+        stream_rseek(stream->stream, base + (size_t)offset);
+        next = first;
+      }
+      /* decode any preceding blocks of variable size, then block b */
+      for (; next <= b; next++)
+        _t1(decode_field_block, Scalar)(stream, dims, block);
+    }
+    value[tap[t].index] = block[tap[t].offset];
+  }
+  stream_rseek(stream->stream, base);
+}
+
+/* combine k tapped values per point with their weights into n point values */
+static void
+_t1(sample_combine, Scalar)(void* values, const void* taps, const double* weight, size_t n, uint k)
+{
+  Scalar* out = (Scalar*)values;
+  const Scalar* value = (const Scalar*)taps;
+  size_t p;
+  uint j;
+
+  if (k == 1)
+    memcpy(out, value, n * sizeof(Scalar));
+  else
+    for (p = 0; p < n; p++, value += k, weight += k) {
+      double sum = 0;
+      for (j = 0; j < k; j++)
+        sum += weight[j] * (double)value[j];
+      out[p] = (Scalar)sum;
+    }
+}
+
+/* accumulate reduction over values of blocks [bmin, bmax) without storing them */
+static void
+_t1(reduce_blocks, Scalar)(zfp_stream* stream, const zfp_field* field, zfp_reduce_op op, size_t bmin, size_t bmax, reduction* acc)
+{
+  cache_align_(Scalar block[256]);
+  uint dims = zfp_field_dimensionality(field);
+  uint nx = MAX(field->nx, 1u);
+  uint ny = MAX(field->ny, 1u);
+  uint nz = MAX(field->nz, 1u);
+  uint nw = MAX(field->nw, 1u);
+  size_t bx = (nx + 3) / 4;
+  size_t by = (ny + 3) / 4;
+  size_t bz = (nz + 3) / 4;
+  uint size = 1u << (2 * dims);
+  /* block averages suffice for the mean of full blocks unless reversible or raw */
+  zfp_bool lod = op == zfp_reduce_mean && zfp_stream_compression_mode(stream) != zfp_mode_reversible && !stream->raw;
+  zfp_bool square = op == zfp_reduce_l2;
+  size_t index;
+
+  for (index = bmin; index < bmax; index++) {
+    /* determine block origin (x, y, z, w) and extent within array */
+    size_t b = index;
+    uint x, y, z, w, mx, my, mz, mw, n;
+    double sum = 0, min = HUGE_VAL, max = -HUGE_VAL;
+    uint i, j, k, l;
+    x = 4 * (uint)(b % bx); b /= bx;
+    y = 4 * (uint)(b % by); b /= by;
+    z = 4 * (uint)(b % bz); b /= bz;
+    w = 4 * (uint)b;
+    mx = MIN(nx - x, 4u);
+    my = MIN(ny - y, 4u);
+    mz = MIN(nz - z, 4u);
+    mw = MIN(nw - w, 4u);
+    n = mx * my * mz * mw;
+
+    if (lod && n == size) {
+      /* decode only the DC coefficient, i.e., the block average */
+      switch (dims) {
+        case 1:
+          _t2(zfp_decode_block_lod, Scalar, 1)(stream, block, 0);
+          break;
+        case 2:
+          _t2(zfp_decode_block_lod, Scalar, 2)(stream, block, 0);
+          break;
+        case 3:
+          _t2(zfp_decode_block_lod, Scalar, 3)(stream, block, 0);
+          break;
+        case 4:
+          _t2(zfp_decode_block_lod, Scalar, 4)(stream, block, 0);
+          break;
+      }
+      acc->sum += (double)n * (double)block[0];
+      acc->count += n;
+      continue;
+    }
+
+    /* decode block and accumulate values that lie within the array */
+    _t1(decode_field_block, Scalar)(stream, dims, block);
+    for (l = 0; l < mw; l++)
+      for (k = 0; k < mz; k++)
+        for (j = 0; j < my; j++)
+          for (i = 0; i < mx; i++) {
+            double v = (double)block[i + 4 * (j + 4 * (k + 4 * l))];
+            sum += square ? v * v : v;
+            min = MIN(min, v);
+            max = MAX(max, v);
+          }
+    acc->sum += sum;
+    acc->min = MIN(acc->min, min);
+    acc->max = MAX(acc->max, max);
+    acc->count += n;
+  }
+}
+
+/* return dot product of blocks [bmin, bmax) decoded in lockstep from streams a and b */
+static double
+_t1(dot_blocks, Scalar)(zfp_stream* a, zfp_stream* b, const zfp_field* field, size_t bmin, size_t bmax)
+{
+  cache_align_(Scalar ablock[256]);
+  cache_align_(Scalar bblock[256]);
+  uint dims = zfp_field_dimensionality(field);
+  uint nx = MAX(field->nx, 1u);
+  uint ny = MAX(field->ny, 1u);
+  uint nz = MAX(field->nz, 1u);
+  uint nw = MAX(field->nw, 1u);
+  size_t bx = (nx + 3) / 4;
+  size_t by = (ny + 3) / 4;
+  size_t bz = (nz + 3) / 4;
+  double dot = 0;
+  size_t block;
+
+  for (block = bmin; block < bmax; block++) {
+    /* determine block origin (x, y, z, w) and extent within array */
+    size_t q = block;
+    uint x, y, z, w, mx, my, mz, mw;
+    uint i, j, k, l;
+    x = 4 * (uint)(q % bx); q /= bx;
+    y = 4 * (uint)(q % by); q /= by;
+    z = 4 * (uint)(q % bz); q /= bz;
+    w = 4 * (uint)q;
+    mx = MIN(nx - x, 4u);
+    my = MIN(ny - y, 4u);
+    mz = MIN(nz - z, 4u);
+    mw = MIN(nw - w, 4u);
+
+    _t1(decode_field_block, Scalar)(a, dims, ablock);
+    _t1(decode_field_block, Scalar)(b, dims, bblock);
+    for (l = 0; l < mw; l++)
+      for (k = 0; k < mz; k++)
+        for (j = 0; j < my; j++)
+          for (i = 0; i < mx; i++) {
+            uint p = i + 4 * (j + 4 * (k + 4 * l));
+            dot += (double)ablock[p] * (double)bblock[p];
+          }
+  }
+
+  return dot;
+}
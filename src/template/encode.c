@@ -26,6 +26,36 @@ _t1(pad_block, Scalar)(Scalar* p, uint n, uint s)
   }
 }
 
+#if DIMS > 1
+/* pad m partial blocks of width n < 4 and stride s with adjacent elements */
+static void
+_t1(pad_block_vec, Scalar)(Scalar* p, uint n, uint s, uint m)
+{
+  uint i;
+  /* blocks are independent, so each loop vectorizes */
+  switch (n) {
+    case 0:
+      for (i = 0; i < m; i++)
+        p[i] = 0;
+      /* FALLTHROUGH */
+    case 1:
+      for (i = 0; i < m; i++)
+        p[1 * s + i] = p[i];
+      /* FALLTHROUGH */
+    case 2:
+      for (i = 0; i < m; i++)
+        p[2 * s + i] = p[1 * s + i];
+      /* FALLTHROUGH */
+    case 3:
+      for (i = 0; i < m; i++)
+        p[3 * s + i] = p[i];
+      /* FALLTHROUGH */
+    default:
+      break;
+  }
+}
+#endif
+
 /* forward lifting transform of 4-vector */
 static void
 _t1(fwd_lift, Int)(Int* p, uint s)
@@ -55,6 +85,44 @@ _t1(fwd_lift, Int)(Int* p, uint s)
   p -= s; *p = x;
 }
 
+/* forward lifting transform of n 4-vectors with adjacent elements */
+static void
+_t1(fwd_lift_vec, Int)(Int* p, uint s, uint n)
+{
+  Int* q = p + s;
+  Int* r = q + s;
+  Int* t = r + s;
+  uint i;
+
+  /* vectors are independent, so this loop vectorizes */
+  for (i = 0; i < n; i++) {
+    Int x = p[i];
+    Int y = q[i];
+    Int z = r[i];
+    Int w = t[i];
+    x += w; x >>= 1; w -= x;
+    z += y; z >>= 1; y -= z;
+    x += z; x >>= 1; z -= x;
+    w += y; w >>= 1; y -= w;
+    w += y >> 1; y -= w >> 1;
+    p[i] = x;
+    q[i] = y;
+    r[i] = z;
+    t[i] = w;
+  }
+}
+
+/* forward decorrelating transform of BATCH_LANES blocks interleaved by lane */
+static void
+_t2(fwd_xform_lanes, Int, DIMS)(Int* p)
+{
+  uint i, s;
+  /* transform along x, y, z, w in turn; each lift spans all lanes at once */
+  for (s = 1; s < BLOCK_SIZE; s *= 4)
+    for (i = 0; i < BLOCK_SIZE; i += 4 * s)
+      _t1(fwd_lift_vec, Int)(p + i * BATCH_LANES, s * BATCH_LANES, s * BATCH_LANES);
+}
+
 /* map two's complement signed integer to negabinary unsigned integer */
 static UInt
 _t1(int2uint, Int)(Int x)
@@ -71,6 +139,55 @@ _t1(fwd_order, Int)(UInt* ublock, const Int* iblock, const uchar* perm, uint n)
   while (--n);
 }
 
+/* return nonzero if all n integers equal the first */
+static int
+_t1(is_constant, Int)(const Int* p, uint n)
+{
+  UInt d = 0;
+  uint i;
+  for (i = 1; i < n; i++)
+    d |= (UInt)(p[i] ^ p[0]);
+  return !d;
+}
+
+/* compress sequence of unsigned integers that are zero except for first, u */
+static uint
+_t1(encode_first_int, UInt)(bitstream* restrict_ stream, uint maxbits, uint maxprec, UInt u)
+{
+  /* make a copy of bit stream to avoid aliasing */
+  bitstream s = *stream;
+  uint intprec = CHAR_BIT * (uint)sizeof(UInt);
+  uint kmin = intprec > maxprec ? intprec - maxprec : 0;
+  uint bits = maxbits;
+  uint k;
+  int significant = 0;
+
+  /* emit the same bits as encode_ints, one bit plane at a time */
+  for (k = intprec; bits && k-- > kmin;) {
+    uint x = (uint)(u >> k) & 1u;
+    if (!significant) {
+      /* group test; nothing more to emit while first value is zero */
+      bits--;
+      if (!stream_write_bit(&s, x))
+        continue;
+      significant = 1;
+    }
+    /* emit bit of first value */
+    if (bits) {
+      bits--;
+      stream_write_bit(&s, x);
+    }
+    /* group test of remaining zero values */
+    if (bits) {
+      bits--;
+      stream_write_bit(&s, 0);
+    }
+  }
+
+  *stream = s;
+  return maxbits - bits;
+}
+
 /* compress sequence of size unsigned integers */
 static uint
 _t1(encode_ints, UInt)(bitstream* restrict_ stream, uint maxbits, uint maxprec, const UInt* restrict_ data, uint size)
@@ -94,9 +211,17 @@ _t1(encode_ints, UInt)(bitstream* restrict_ stream, uint maxbits, uint maxprec,
     bits -= m;
     x = stream_write_bits(&s, x, m);
     /* step 3: unary run-length encode remainder of bit plane */
-    for (; n < size && bits && (bits--, stream_write_bit(&s, !!x)); x >>= 1, n++)
-      for (; n < size - 1 && bits && (bits--, !stream_write_bit(&s, x & 1u)); x >>= 1, n++)
-        ;
+    while (n < size && bits && (bits--, stream_write_bit(&s, !!x))) {
+      /* emit run of zeros and its terminating one-bit in a single write */
+      uint t = ctz64(x);
+      m = MIN(MIN(t + 1, size - 1 - n), bits);
+      bits -= m;
+      stream_write_bits(&s, x, m);
+      /* the last coefficient's one-bit is implied by its group test */
+      x >>= t;
+      x >>= 1;
+      n += t + 1;
+    }
   }
 
   *stream = s;
@@ -135,12 +260,44 @@ _t1(encode_many_ints, UInt)(bitstream* restrict_ stream, uint maxbits, uint maxp
   return maxbits - bits;
 }
 
+/* set up s as scratch bit stream on buffer, without strides or callbacks of stream */
+static void
+scratch_stream(bitstream* s, const bitstream* stream, void* buffer, size_t bytes)
+{
+  *s = *stream;
+  stream_reopen(s, buffer, bytes);
+#ifdef BIT_STREAM_STRIDED
+  stream_set_stride(s, 0, 0);
+#endif
+#ifdef BIT_STREAM_CALLBACK
+  s->write = NULL;
+  s->read = NULL;
+#endif
+}
+
+/* encode block whose values all equal x */
+static uint
+_t2(encode_constant_block, Int, DIMS)(bitstream* stream, int minbits, int maxbits, int maxprec, Int x)
+{
+  /* the decorrelating transform maps a constant block to its DC coefficient */
+  int bits = _t1(encode_first_int, UInt)(stream, maxbits, maxprec, _t1(int2uint, Int)(x));
+  /* write at least minbits bits by padding with zeros */
+  if (bits < minbits) {
+    stream_pad(stream, minbits - bits);
+    bits = minbits;
+  }
+  return bits;
+}
+
 /* encode block of integers */
 static uint
 _t2(encode_block, Int, DIMS)(bitstream* stream, int minbits, int maxbits, int maxprec, Int* iblock)
 {
   int bits;
   cache_align_(UInt ublock[BLOCK_SIZE]);
+  /* bypass transform and bit plane extraction for constant blocks */
+  if (_t1(is_constant, Int)(iblock, BLOCK_SIZE))
+    return _t2(encode_constant_block, Int, DIMS)(stream, minbits, maxbits, maxprec, iblock[0]);
   /* perform decorrelating transform */
   _t2(fwd_xform, Int, DIMS)(iblock);
   /* reorder signed coefficients and convert to unsigned integer */
@@ -157,3 +314,64 @@ _t2(encode_block, Int, DIMS)(bitstream* stream, int minbits, int maxbits, int ma
   }
   return bits;
 }
+
+/* encode block of integers, accumulating statistics and phase times since start */
+static uint
+_t2(encode_block_stats, Int, DIMS)(bitstream* stream, int minbits, int maxbits, int maxprec, Int* iblock, zfp_stream_stats* stats, double start)
+{
+  int bits;
+  cache_align_(UInt ublock[BLOCK_SIZE]);
+  if (_t1(is_constant, Int)(iblock, BLOCK_SIZE)) {
+    /* constant blocks bypass the transform */
+    if (iblock[0])
+      stats->constant_blocks++;
+    else
+      stats->zero_blocks++;
+    bits = _t2(encode_constant_block, Int, DIMS)(stream, minbits, maxbits, maxprec, iblock[0]);
+  }
+  else {
+    double t;
+    /* perform decorrelating transform and reorder coefficients */
+    _t2(fwd_xform, Int, DIMS)(iblock);
+    _t1(fwd_order, Int)(ublock, iblock, PERM, BLOCK_SIZE);
+    t = zfp_stats_clock();
+    stats->transform_time += t - start;
+    start = t;
+    /* encode integer coefficients */
+    if (BLOCK_SIZE <= 64)
+      bits = _t1(encode_ints, UInt)(stream, maxbits, maxprec, ublock, BLOCK_SIZE);
+    else
+      bits = _t1(encode_many_ints, UInt)(stream, maxbits, maxprec, ublock, BLOCK_SIZE);
+    if (bits < minbits) {
+      stream_pad(stream, minbits - bits);
+      bits = minbits;
+    }
+  }
+  stats->coding_time += zfp_stats_clock() - start;
+  stats->bit_planes += maxprec;
+  return bits;
+}
+
+/* encode transformed block stored in given lane of interleaved blocks */
+static uint
+_t2(encode_lane, Int, DIMS)(bitstream* stream, int minbits, int maxbits, int maxprec, const Int* iblock, uint lane)
+{
+  int bits;
+  cache_align_(UInt ublock[BLOCK_SIZE]);
+  const uchar* perm = PERM;
+  uint i;
+  /* reorder signed coefficients of lane and convert to unsigned integer */
+  for (i = 0; i < BLOCK_SIZE; i++)
+    ublock[i] = _t1(int2uint, Int)(iblock[perm[i] * BATCH_LANES + lane]);
+  /* encode integer coefficients */
+  if (BLOCK_SIZE <= 64)
+    bits = _t1(encode_ints, UInt)(stream, maxbits, maxprec, ublock, BLOCK_SIZE);
+  else
+    bits = _t1(encode_many_ints, UInt)(stream, maxbits, maxprec, ublock, BLOCK_SIZE);
+  /* write at least minbits bits by padding with zeros */
+  if (bits < minbits) {
+    stream_pad(stream, minbits - bits);
+    bits = minbits;
+  }
+  return bits;
+}
@@ -30,22 +30,26 @@ _t2(fwd_xform, Int, 1)(Int* p)
 /* public functions -------------------------------------------------------- */
 
 /* encode 4-value block stored at p using stride sx */
+ISA_DECLARE(zfp_encode_block_strided, (zfp_stream* stream, const Scalar* p, int sx))
 uint
 _t2(zfp_encode_block_strided, Scalar, 1)(zfp_stream* stream, const Scalar* p, int sx)
 {
-  /* gather block from strided array */
   cache_align_(Scalar block[4]);
+  ISA_DISPATCH(stream, zfp_encode_block_strided, (stream, p, sx))
+  /* gather block from strided array */
   _t2(gather, Scalar, 1)(block, p, sx);
   /* encode block */
   return _t2(zfp_encode_block, Scalar, 1)(stream, block);
 }
 
 /* encode nx-value block stored at p using stride sx */
+ISA_DECLARE(zfp_encode_partial_block_strided, (zfp_stream* stream, const Scalar* p, uint nx, int sx))
 uint
 _t2(zfp_encode_partial_block_strided, Scalar, 1)(zfp_stream* stream, const Scalar* p, uint nx, int sx)
 {
-  /* gather block from strided array */
   cache_align_(Scalar block[4]);
+  ISA_DISPATCH(stream, zfp_encode_partial_block_strided, (stream, p, nx, sx))
+  /* gather block from strided array */
   _t2(gather_partial, Scalar, 1)(block, p, nx, sx);
   /* encode block */
   return _t2(zfp_encode_block, Scalar, 1)(stream, block);
@@ -10,6 +10,16 @@ _t2(gather, Scalar, 2)(Scalar* q, const Scalar* p, int sx, int sy)
       *q++ = *p;
 }
 
+/* gather 4*4 block from strided array with contiguous rows */
+static void
+_t2(gather_rows, Scalar, 2)(Scalar* q, const Scalar* p, int sy)
+{
+  uint x, y;
+  for (y = 0; y < 4; y++, p += sy, q += 4)
+    for (x = 0; x < 4; x++)
+      q[x] = p[x];
+}
+
 /* gather nx*ny block from strided array */
 static void
 _t2(gather_partial, Scalar, 2)(Scalar* q, const Scalar* p, uint nx, uint ny, int sx, int sy)
@@ -18,44 +28,52 @@ _t2(gather_partial, Scalar, 2)(Scalar* q, const Scalar* p, uint nx, uint ny, int
   for (y = 0; y < ny; y++, p += sy - (ptrdiff_t)nx * sx) {
     for (x = 0; x < nx; x++, p += sx)
       q[4 * y + x] = *p;
-    _t1(pad_block, Scalar)(q + 4 * y, nx, 1);
+    if (nx < 4)
+      _t1(pad_block, Scalar)(q + 4 * y, nx, 1);
   }
-  for (x = 0; x < 4; x++)
-    _t1(pad_block, Scalar)(q + x, ny, 4);
+  /* pad along y for all x at once */
+  if (ny < 4)
+    _t1(pad_block_vec, Scalar)(q, ny, 4, 4);
 }
 
 /* forward decorrelating 2D transform */
 static void
 _t2(fwd_xform, Int, 2)(Int* p)
 {
-  uint x, y;
+  uint y;
   /* transform along x */
   for (y = 0; y < 4; y++)
     _t1(fwd_lift, Int)(p + 4 * y, 1);
-  /* transform along y */
-  for (x = 0; x < 4; x++)
-    _t1(fwd_lift, Int)(p + 1 * x, 4);
+  /* transform along y for all x at once */
+  _t1(fwd_lift_vec, Int)(p, 4, 4);
 }
 
 /* public functions -------------------------------------------------------- */
 
 /* encode 4*4 block stored at p using strides (sx, sy) */
+ISA_DECLARE(zfp_encode_block_strided, (zfp_stream* stream, const Scalar* p, int sx, int sy))
 uint
 _t2(zfp_encode_block_strided, Scalar, 2)(zfp_stream* stream, const Scalar* p, int sx, int sy)
 {
-  /* gather block from strided array */
   cache_align_(Scalar block[16]);
-  _t2(gather, Scalar, 2)(block, p, sx, sy);
+  ISA_DISPATCH(stream, zfp_encode_block_strided, (stream, p, sx, sy))
+  /* gather block from strided array, a row at a time if rows are contiguous */
+  if (sx == 1)
+    _t2(gather_rows, Scalar, 2)(block, p, sy);
+  else
+    _t2(gather, Scalar, 2)(block, p, sx, sy);
   /* encode block */
   return _t2(zfp_encode_block, Scalar, 2)(stream, block);
 }
 
 /* encode nx*ny block stored at p using strides (sx, sy) */
+ISA_DECLARE(zfp_encode_partial_block_strided, (zfp_stream* stream, const Scalar* p, uint nx, uint ny, int sx, int sy))
 uint
 _t2(zfp_encode_partial_block_strided, Scalar, 2)(zfp_stream* stream, const Scalar* p, uint nx, uint ny, int sx, int sy)
 {
-  /* gather block from strided array */
   cache_align_(Scalar block[16]);
+  ISA_DISPATCH(stream, zfp_encode_partial_block_strided, (stream, p, nx, ny, sx, sy))
+  /* gather block from strided array */
   _t2(gather_partial, Scalar, 2)(block, p, nx, ny, sx, sy);
   /* encode block */
   return _t2(zfp_encode_block, Scalar, 2)(stream, block);
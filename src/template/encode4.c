@@ -12,6 +12,18 @@ _t2(gather, Scalar, 4)(Scalar* q, const Scalar* p, int sx, int sy, int sz, int s
           *q++ = *p;
 }
 
+/* gather 4*4*4*4 block from strided array with contiguous rows */
+static void
+_t2(gather_rows, Scalar, 4)(Scalar* q, const Scalar* p, int sy, int sz, int sw)
+{
+  uint x, y, z, w;
+  for (w = 0; w < 4; w++, p += sw - 4 * sz)
+    for (z = 0; z < 4; z++, p += sz - 4 * sy)
+      for (y = 0; y < 4; y++, p += sy, q += 4)
+        for (x = 0; x < 4; x++)
+          q[x] = p[x];
+}
+
 /* gather nx*ny*nz*nw block from strided array */
 static void
 _t2(gather_partial, Scalar, 4)(Scalar* q, const Scalar* p, uint nx, uint ny, uint nz, uint nw, int sx, int sy, int sz, int sw)
@@ -21,68 +33,70 @@ _t2(gather_partial, Scalar, 4)(Scalar* q, const Scalar* p, uint nx, uint ny, uin
     for (z = 0; z < nz; z++, p += sz - (ptrdiff_t)ny * sy) {
       for (y = 0; y < ny; y++, p += sy - (ptrdiff_t)nx * sx) {
         for (x = 0; x < nx; x++, p += sx)
-          q[64 * w + 16 * z + 4 * y + x] = *p; 
-        _t1(pad_block, Scalar)(q + 64 * w + 16 * z + 4 * y, nx, 1);
+          q[64 * w + 16 * z + 4 * y + x] = *p;
+        if (nx < 4)
+          _t1(pad_block, Scalar)(q + 64 * w + 16 * z + 4 * y, nx, 1);
       }
-      for (x = 0; x < 4; x++)
-        _t1(pad_block, Scalar)(q + 64 * w + 16 * z + x, ny, 4);
+      /* pad along y for all x at once */
+      if (ny < 4)
+        _t1(pad_block_vec, Scalar)(q + 64 * w + 16 * z, ny, 4, 4);
     }
-    for (y = 0; y < 4; y++)
-      for (x = 0; x < 4; x++)
-        _t1(pad_block, Scalar)(q + 64 * w + 4 * y + x, nz, 16);
+    /* pad along z for all (x, y) at once */
+    if (nz < 4)
+      _t1(pad_block_vec, Scalar)(q + 64 * w, nz, 16, 16);
   }
-  for (z = 0; z < 4; z++)
-    for (y = 0; y < 4; y++)
-      for (x = 0; x < 4; x++)
-        _t1(pad_block, Scalar)(q + 16 * z + 4 * y + x, nw, 64);
+  /* pad along w for all (x, y, z) at once */
+  if (nw < 4)
+    _t1(pad_block_vec, Scalar)(q, nw, 64, 64);
 }
 
 /* forward decorrelating 4D transform */
 static void
 _t2(fwd_xform, Int, 4)(Int* p)
 {
-  uint x, y, z, w;
+  uint y, z, w;
   /* transform along x */
   for (w = 0; w < 4; w++)
     for (z = 0; z < 4; z++)
       for (y = 0; y < 4; y++)
         _t1(fwd_lift, Int)(p + 4 * y + 16 * z + 64 * w, 1);
-  /* transform along y */
-  for (x = 0; x < 4; x++)
-    for (w = 0; w < 4; w++)
-      for (z = 0; z < 4; z++)
-        _t1(fwd_lift, Int)(p + 16 * z + 64 * w + 1 * x, 4);
-  /* transform along z */
-  for (y = 0; y < 4; y++)
-    for (x = 0; x < 4; x++)
-      for (w = 0; w < 4; w++)
-        _t1(fwd_lift, Int)(p + 64 * w + 1 * x + 4 * y, 16);
-  /* transform along w */
-  for (z = 0; z < 4; z++)
-    for (y = 0; y < 4; y++)
-      for (x = 0; x < 4; x++)
-        _t1(fwd_lift, Int)(p + 1 * x + 4 * y + 16 * z, 64);
+  /* transform along y for all x at once */
+  for (w = 0; w < 4; w++)
+    for (z = 0; z < 4; z++)
+      _t1(fwd_lift_vec, Int)(p + 16 * z + 64 * w, 4, 4);
+  /* transform along z for all (x, y) at once */
+  for (w = 0; w < 4; w++)
+    _t1(fwd_lift_vec, Int)(p + 64 * w, 16, 16);
+  /* transform along w for all (x, y, z) at once */
+  _t1(fwd_lift_vec, Int)(p, 64, 64);
 }
 
 /* public functions -------------------------------------------------------- */
 
 /* encode 4*4*4*4 block stored at p using strides (sx, sy, sz, sw) */
+ISA_DECLARE(zfp_encode_block_strided, (zfp_stream* stream, const Scalar* p, int sx, int sy, int sz, int sw))
 uint
 _t2(zfp_encode_block_strided, Scalar, 4)(zfp_stream* stream, const Scalar* p, int sx, int sy, int sz, int sw)
 {
-  /* gather block from strided array */
   cache_align_(Scalar block[256]);
-  _t2(gather, Scalar, 4)(block, p, sx, sy, sz, sw);
+  ISA_DISPATCH(stream, zfp_encode_block_strided, (stream, p, sx, sy, sz, sw))
+  /* gather block from strided array, a row at a time if rows are contiguous */
+  if (sx == 1)
+    _t2(gather_rows, Scalar, 4)(block, p, sy, sz, sw);
+  else
+    _t2(gather, Scalar, 4)(block, p, sx, sy, sz, sw);
   /* encode block */
   return _t2(zfp_encode_block, Scalar, 4)(stream, block);
 }
 
 /* encode nx*ny*nz*nw block stored at p using strides (sx, sy, sz, sw) */
+ISA_DECLARE(zfp_encode_partial_block_strided, (zfp_stream* stream, const Scalar* p, uint nx, uint ny, uint nz, uint nw, int sx, int sy, int sz, int sw))
 uint
 _t2(zfp_encode_partial_block_strided, Scalar, 4)(zfp_stream* stream, const Scalar* p, uint nx, uint ny, uint nz, uint nw, int sx, int sy, int sz, int sw)
 {
-  /* gather block from strided array */
   cache_align_(Scalar block[256]);
+  ISA_DISPATCH(stream, zfp_encode_partial_block_strided, (stream, p, nx, ny, nz, nw, sx, sy, sz, sw))
+  /* gather block from strided array */
   _t2(gather_partial, Scalar, 4)(block, p, nx, ny, nz, nw, sx, sy, sz, sw);
   /* encode block */
   return _t2(zfp_encode_block, Scalar, 4)(stream, block);
@@ -1,7 +1,9 @@
 #include <limits.h>
 #include <math.h>
+#include <string.h>
 
 static uint _t2(rev_encode_block, Scalar, DIMS)(zfp_stream* zfp, const Scalar* fblock);
+uint _t2(zfp_decode_block, Scalar, DIMS)(zfp_stream* zfp, Scalar* fblock);
 
 /* private functions ------------------------------------------------------- */
 
@@ -22,13 +24,24 @@ _t1(exponent, Scalar)(Scalar x)
 static int
 _t1(exponent_block, Scalar)(const Scalar* p, uint n)
 {
-  Scalar max = 0;
-  do {
-    Scalar f = FABS(*p++);
-    if (max < f)
-      max = f;
-  } while (--n);
-  return _t1(exponent, Scalar)(max);
+  /* nonnegative IEEE values other than NaN are ordered like their bits */
+  const Int inf = (Int)((((UInt)1 << EBITS) - 1) << (CHAR_BIT * sizeof(UInt) - 1 - EBITS));
+  Int max = 0;
+  Scalar f;
+  uint i;
+  /* take maximum magnitude as an integer, ignoring NaNs, so that loop vectorizes */
+  for (i = 0; i < n; i++) {
+    UInt u;
+    Int x;
+    memcpy(&u, p + i, sizeof(u));
+    x = (Int)(u & TCMASK);
+    if (x > inf)
+      x = 0;
+    if (max < x)
+      max = x;
+  }
+  memcpy(&f, &max, sizeof(f));
+  return _t1(exponent, Scalar)(f);
 }
 
 /* map floating-point number x to integer relative to exponent e */
@@ -44,10 +57,24 @@ _t1(fwd_cast, Scalar)(Int* iblock, const Scalar* fblock, uint n, int emax)
 {
   /* compute power-of-two scale factor s */
   Scalar s = _t1(quantize, Scalar)(1, emax);
+  uint i;
   /* compute p-bit int y = s*x where x is floating and |y| <= 2^(p-2) - 1 */
-  do
-    *iblock++ = (Int)(s * *fblock++);
-  while (--n);
+  for (i = 0; i < n; i++)
+    iblock[i] = (Int)(s * fblock[i]);
+}
+
+/* return nonzero if all n values are bitwise equal to the first */
+static int
+_t1(is_constant, Scalar)(const Scalar* p, uint n)
+{
+  UInt u, v, d = 0;
+  uint i;
+  memcpy(&u, p, sizeof(u));
+  for (i = 1; i < n; i++) {
+    memcpy(&v, p + i, sizeof(v));
+    d |= u ^ v;
+  }
+  return !d;
 }
 
 /* encode contiguous floating-point block using lossy algorithm */
@@ -65,10 +92,59 @@ _t2(encode_block, Scalar, DIMS)(zfp_stream* zfp, const Scalar* fblock)
     /* encode common exponent; LSB indicates that exponent is nonzero */
     bits += EBITS;
     stream_write_bits(zfp->stream, 2 * e + 1, bits);
-    /* perform forward block-floating-point transform */
+    if (_t1(is_constant, Scalar)(fblock, BLOCK_SIZE)) {
+      /* cast and encode the single value of a constant block */
+      _t1(fwd_cast, Scalar)(iblock, fblock, 1, emax);
+      bits += _t2(encode_constant_block, Int, DIMS)(zfp->stream, zfp->minbits - bits, zfp->maxbits - bits, maxprec, iblock[0]);
+    }
+    else {
+      /* perform forward block-floating-point transform */
+      _t1(fwd_cast, Scalar)(iblock, fblock, BLOCK_SIZE, emax);
+      /* encode integer block */
+      bits += _t2(encode_block, Int, DIMS)(zfp->stream, zfp->minbits - bits, zfp->maxbits - bits, maxprec, iblock);
+    }
+  }
+  else {
+    /* write single zero-bit to indicate that all values are zero */
+    stream_write_bit(zfp->stream, 0);
+    if (zfp->minbits > bits) {
+      stream_pad(zfp->stream, zfp->minbits - bits);
+      bits = zfp->minbits;
+    }
+  }
+  return bits;
+}
+
+/* encode contiguous floating-point block and accumulate statistics */
+static uint
+_t2(encode_block_stats, Scalar, DIMS)(zfp_stream* zfp, const Scalar* fblock)
+{
+  zfp_stream_stats* stats = zfp->stats;
+  double start = zfp_stats_clock();
+  uint bits = 1;
+  int emax, maxprec;
+  uint e;
+  if (REVERSIBLE(zfp)) {
+    /* phases of reversible coding are not timed separately */
+    bits = _t2(rev_encode_block, Scalar, DIMS)(zfp, fblock);
+    stats->coding_time += zfp_stats_clock() - start;
+    stats_add_block(stats, bits);
+    return bits;
+  }
+  emax = _t1(exponent_block, Scalar)(fblock, BLOCK_SIZE);
+  maxprec = precision(emax, zfp->maxprec, zfp->minexp, DIMS);
+  e = maxprec ? emax + EBIAS : 0;
+  if (e) {
+    cache_align_(Int iblock[BLOCK_SIZE]);
+    double t;
+    /* encode common exponent and perform block-floating-point transform */
+    bits += EBITS;
+    stream_write_bits(zfp->stream, 2 * e + 1, bits);
     _t1(fwd_cast, Scalar)(iblock, fblock, BLOCK_SIZE, emax);
+    t = zfp_stats_clock();
+    stats->cast_time += t - start;
     /* encode integer block */
-    bits += _t2(encode_block, Int, DIMS)(zfp->stream, zfp->minbits - bits, zfp->maxbits - bits, maxprec, iblock);
+    bits += _t2(encode_block_stats, Int, DIMS)(zfp->stream, zfp->minbits - bits, zfp->maxbits - bits, maxprec, iblock, stats, t);
   }
   else {
     /* write single zero-bit to indicate that all values are zero */
@@ -77,6 +153,223 @@ _t2(encode_block, Scalar, DIMS)(zfp_stream* zfp, const Scalar* fblock)
       stream_pad(zfp->stream, zfp->minbits - bits);
       bits = zfp->minbits;
     }
+    stats->zero_blocks++;
+    stats->coding_time += zfp_stats_clock() - start;
+  }
+  stats_add_block(stats, bits);
+  return bits;
+}
+
+/* encode contiguous floating-point block in current mode */
+static uint
+_t2(encode_block_mode, Scalar, DIMS)(zfp_stream* zfp, const Scalar* fblock)
+{
+  if (STATS_ENABLED(zfp))
+    return _t2(encode_block_stats, Scalar, DIMS)(zfp, fblock);
+  return REVERSIBLE(zfp) ? _t2(rev_encode_block, Scalar, DIMS)(zfp, fblock) : _t2(encode_block, Scalar, DIMS)(zfp, fblock);
+}
+
+/* store contiguous floating-point block verbatim */
+static uint
+_t2(encode_raw, Scalar, DIMS)(bitstream* stream, const Scalar* fblock)
+{
+  uint i;
+  for (i = 0; i < BLOCK_SIZE; i++) {
+    UInt u;
+    memcpy(&u, fblock + i, sizeof(u));
+    stream_write_bits(stream, u, CHAR_BIT * (uint)sizeof(u));
+  }
+  return BLOCK_SIZE * CHAR_BIT * (uint)sizeof(Scalar);
+}
+
+/* encode contiguous floating-point block behind a flag bit, storing it
+   verbatim if coding it would take more bits */
+static uint
+_t2(encode_block_raw, Scalar, DIMS)(zfp_stream* zfp, const Scalar* fblock)
+{
+  const uint rawbits = BLOCK_SIZE * CHAR_BIT * (uint)sizeof(Scalar);
+  zfp_stream s = *zfp;
+  uint bits;
+  if (rawbits < zfp->maxbits) {
+    /* code block with one bit more than raw storage, which ends coding of */
+    /* incompressible blocks early */
+    uint64 buffer[(BLOCK_SIZE * CHAR_BIT * sizeof(Scalar) + 1) / 64 + 2];
+    bitstream scratch;
+    scratch_stream(&scratch, zfp->stream, buffer, sizeof(buffer));
+    s.stream = &scratch;
+    s.minbits = 0;
+    s.maxbits = rawbits + 1;
+    bits = _t2(encode_block_mode, Scalar, DIMS)(&s, fblock);
+    if (bits <= rawbits) {
+      /* append coded block */
+      stream_write_bit(zfp->stream, 0);
+      stream_flush(&scratch);
+      stream_rewind(&scratch);
+      stream_copy(zfp->stream, &scratch, bits);
+    }
+    else {
+      stream_write_bit(zfp->stream, 1);
+      bits = _t2(encode_raw, Scalar, DIMS)(zfp->stream, fblock);
+    }
+    bits++;
+    /* write at least minbits bits by padding with zeros */
+    if (zfp->minbits > bits) {
+      stream_pad(zfp->stream, zfp->minbits - bits);
+      bits = zfp->minbits;
+    }
+  }
+  else {
+    /* raw block does not fit in budget; code block after flag */
+    stream_write_bit(zfp->stream, 0);
+    s.minbits = zfp->minbits ? zfp->minbits - 1 : 0;
+    s.maxbits = zfp->maxbits - 1;
+    bits = 1 + _t2(encode_block_mode, Scalar, DIMS)(&s, fblock);
+  }
+  return bits;
+}
+
+/* encode contiguous floating-point block, then decode it and check its error
+   against the tolerance of the current mode; a block that exceeds it is
+   stored verbatim instead when raw blocks are enabled and fit the budget */
+static uint
+_t2(encode_block_verify, Scalar, DIMS)(zfp_stream* zfp, const Scalar* fblock)
+{
+  const uint rawbits = BLOCK_SIZE * CHAR_BIT * (uint)sizeof(Scalar);
+  const double tolerance = REVERSIBLE(zfp) ? 0 : ldexp(1.0, zfp->minexp);
+  zfp_verification* verify = zfp->verify;
+  /* unpadded blocks take less than one bit per value more than raw storage */
+  uint64 buffer[(BLOCK_SIZE * (CHAR_BIT * sizeof(Scalar) + 1) + 64) / 64 + 2];
+  cache_align_(Scalar dblock[BLOCK_SIZE]);
+  zfp_stream s = *zfp;
+  bitstream scratch;
+  double error = 0;
+  uint bits, i;
+
+  /* encode block without padding to scratch stream */
+  scratch_stream(&scratch, zfp->stream, buffer, sizeof(buffer));
+  s.stream = &scratch;
+  s.minbits = 0;
+  s.verify = NULL;
+  bits = RAW_BLOCKS(zfp) ? _t2(encode_block_raw, Scalar, DIMS)(&s, fblock) : _t2(encode_block_mode, Scalar, DIMS)(&s, fblock);
+  stream_flush(&scratch);
+
+  /* decode block while still in cache and find its largest error */
+  stream_rewind(&scratch);
+  s.stats = NULL;
+  _t2(zfp_decode_block, Scalar, DIMS)(&s, dblock);
+  for (i = 0; i < BLOCK_SIZE; i++) {
+    Scalar x = fblock[i];
+    Scalar y = dblock[i];
+    double e = (x == y || (x != x && y != y)) ? 0 : fabs((double)y - (double)x);
+    /* a number decoded as NaN, or vice versa, is an unbounded error */
+    if (e != e)
+      e = HUGE_VAL;
+    error = MAX(error, e);
+  }
+
+  verify->blocks++;
+  if (error > tolerance)
+    verify->violations++;
+  if (error > tolerance && RAW_BLOCKS(zfp) && rawbits < zfp->maxbits) {
+    /* store block losslessly in place of coded block */
+    stream_write_bit(zfp->stream, 1);
+    bits = 1 + _t2(encode_raw, Scalar, DIMS)(zfp->stream, fblock);
+    verify->repaired++;
+    error = 0;
+  }
+  else {
+    /* append coded block */
+    stream_rewind(&scratch);
+    stream_copy(zfp->stream, &scratch, bits);
+  }
+  verify->max_error = MAX(verify->max_error, error);
+
+  /* write at least minbits bits by padding with zeros */
+  if (zfp->minbits > bits) {
+    stream_pad(zfp->stream, zfp->minbits - bits);
+    bits = zfp->minbits;
+  }
+  return bits;
+}
+
+/* encode transform coefficients of contiguous floating-point block */
+static uint
+_t2(encode_block_coefficients, Scalar, DIMS)(zfp_stream* zfp, const Int* iblock, int emax)
+{
+  uint bits = 1;
+  int maxprec = precision(emax, zfp->maxprec, zfp->minexp, DIMS);
+  uint e = maxprec ? emax + EBIAS : 0;
+  /* encode block only if biased exponent is nonzero */
+  if (e) {
+    cache_align_(UInt ublock[BLOCK_SIZE]);
+    /* encode common exponent; LSB indicates that exponent is nonzero */
+    bits += EBITS;
+    stream_write_bits(zfp->stream, 2 * e + 1, bits);
+    /* reorder signed coefficients and convert to unsigned integer */
+    _t1(fwd_order, Int)(ublock, iblock, PERM, BLOCK_SIZE);
+    /* encode integer coefficients */
+    if (BLOCK_SIZE <= 64)
+      bits += _t1(encode_ints, UInt)(zfp->stream, zfp->maxbits - bits, maxprec, ublock, BLOCK_SIZE);
+    else
+      bits += _t1(encode_many_ints, UInt)(zfp->stream, zfp->maxbits - bits, maxprec, ublock, BLOCK_SIZE);
+  }
+  else
+    /* write single zero-bit to indicate that all values are zero */
+    stream_write_bit(zfp->stream, 0);
+  /* write at least minbits bits by padding with zeros */
+  if (zfp->minbits > bits) {
+    stream_pad(zfp->stream, zfp->minbits - bits);
+    bits = zfp->minbits;
+  }
+  return bits;
+}
+
+/* encode n <= BATCH_LANES contiguous floating-point blocks using lossy algorithm */
+static size_t
+_t2(encode_lanes, Scalar, DIMS)(zfp_stream* zfp, const Scalar* fblock, uint n)
+{
+  cache_align_(Int iblock[BLOCK_SIZE * BATCH_LANES]);
+  Scalar s[BATCH_LANES];
+  uint e[BATCH_LANES];
+  uint maxprec[BATCH_LANES];
+  size_t bits = 0;
+  uint i, l;
+  /* compute maximum exponent and scale factor of each block */
+  for (l = 0; l < n; l++) {
+    int emax = _t1(exponent_block, Scalar)(fblock + (size_t)l * BLOCK_SIZE, BLOCK_SIZE);
+    maxprec[l] = precision(emax, zfp->maxprec, zfp->minexp, DIMS);
+    e[l] = maxprec[l] ? (uint)(emax + EBIAS) : 0;
+    /* blocks encoded as all zeros are scaled to zero */
+    s[l] = e[l] ? _t1(quantize, Scalar)(1, emax) : 0;
+  }
+  /* perform forward block-floating-point transform of each block into its lane */
+  for (i = 0; i < BLOCK_SIZE; i++) {
+    for (l = 0; l < n; l++)
+      iblock[i * BATCH_LANES + l] = (Int)(s[l] * fblock[(size_t)l * BLOCK_SIZE + i]);
+    for (; l < BATCH_LANES; l++)
+      iblock[i * BATCH_LANES + l] = 0;
+  }
+  /* perform decorrelating transform on all lanes at once */
+  _t2(fwd_xform_lanes, Int, DIMS)(iblock);
+  /* encode blocks one at a time */
+  for (l = 0; l < n; l++) {
+    uint b = 1;
+    if (e[l]) {
+      /* encode common exponent; LSB indicates that exponent is nonzero */
+      b += EBITS;
+      stream_write_bits(zfp->stream, 2 * e[l] + 1, b);
+      /* encode integer block */
+      b += _t2(encode_lane, Int, DIMS)(zfp->stream, zfp->minbits - b, zfp->maxbits - b, maxprec[l], iblock, l);
+    }
+    else {
+      /* write single zero-bit to indicate that all values are zero */
+      stream_write_bit(zfp->stream, 0);
+      if (zfp->minbits > b) {
+        stream_pad(zfp->stream, zfp->minbits - b);
+        b = zfp->minbits;
+      }
+    }
+    bits += b;
   }
   return bits;
 }
@@ -84,8 +377,92 @@ _t2(encode_block, Scalar, DIMS)(zfp_stream* zfp, const Scalar* fblock)
 /* public functions -------------------------------------------------------- */
 
 /* encode contiguous floating-point block */
+ISA_DECLARE(zfp_encode_block, (zfp_stream* zfp, const Scalar* fblock))
 uint
 _t2(zfp_encode_block, Scalar, DIMS)(zfp_stream* zfp, const Scalar* fblock)
 {
-  return REVERSIBLE(zfp) ? _t2(rev_encode_block, Scalar, DIMS)(zfp, fblock) : _t2(encode_block, Scalar, DIMS)(zfp, fblock);
+  ISA_DISPATCH(zfp, zfp_encode_block, (zfp, fblock))
+  if (VERIFY_ENABLED(zfp))
+    return _t2(encode_block_verify, Scalar, DIMS)(zfp, fblock);
+  if (RAW_BLOCKS(zfp))
+    return _t2(encode_block_raw, Scalar, DIMS)(zfp, fblock);
+  return _t2(encode_block_mode, Scalar, DIMS)(zfp, fblock);
+}
+
+/* encode transform coefficients of contiguous floating-point block with common exponent */
+ISA_DECLARE(zfp_encode_block_coefficients, (zfp_stream* zfp, const Int* iblock, int emax))
+uint
+_t2(zfp_encode_block_coefficients, Scalar, DIMS)(zfp_stream* zfp, const Int* iblock, int emax)
+{
+  ISA_DISPATCH(zfp, zfp_encode_block_coefficients, (zfp, iblock, emax))
+  return REVERSIBLE(zfp) || RAW_BLOCKS(zfp) ? 0 : _t2(encode_block_coefficients, Scalar, DIMS)(zfp, iblock, emax);
+}
+
+/* encode contiguous floating-point block to each of n streams, performing
+   the block-floating-point and decorrelating transforms only once */
+ISA_DECLARE_TYPED(size_t, zfp_encode_block_multi, (zfp_stream* const* zfp, uint n, const Scalar* fblock))
+size_t
+_t2(zfp_encode_block_multi, Scalar, DIMS)(zfp_stream* const* zfp, uint n, const Scalar* fblock)
+{
+  cache_align_(Int iblock[BLOCK_SIZE]);
+  int emax = 0;
+  int transformed = 0;
+  size_t bits = 0;
+  uint i;
+  if (!n)
+    return 0;
+  ISA_DISPATCH(zfp[0], zfp_encode_block_multi, (zfp, n, fblock))
+  for (i = 0; i < n; i++) {
+    zfp_stream* s = zfp[i];
+    if (REVERSIBLE(s) || RAW_BLOCKS(s) || STATS_ENABLED(s) || VERIFY_ENABLED(s))
+      /* these modes do not code shared transform coefficients */
+      bits += _t2(zfp_encode_block, Scalar, DIMS)(s, fblock);
+    else {
+      if (!transformed) {
+        emax = _t1(exponent_block, Scalar)(fblock, BLOCK_SIZE);
+        _t1(fwd_cast, Scalar)(iblock, fblock, BLOCK_SIZE, emax);
+        _t2(fwd_xform, Int, DIMS)(iblock);
+        transformed = 1;
+      }
+      bits += _t2(encode_block_coefficients, Scalar, DIMS)(s, iblock, emax);
+    }
+  }
+  return bits;
+}
+
+/* encode n contiguous floating-point blocks stored consecutively */
+ISA_DECLARE_TYPED(size_t, zfp_encode_blocks, (zfp_stream* zfp, size_t n, const Scalar* fblock))
+size_t
+_t2(zfp_encode_blocks, Scalar, DIMS)(zfp_stream* zfp, size_t n, const Scalar* fblock)
+{
+  size_t bits = 0;
+  uint m;
+  ISA_DISPATCH(zfp, zfp_encode_blocks, (zfp, n, fblock))
+  if (VERIFY_ENABLED(zfp)) {
+    for (; n; n--, fblock += BLOCK_SIZE)
+      bits += _t2(encode_block_verify, Scalar, DIMS)(zfp, fblock);
+    return bits;
+  }
+  if (RAW_BLOCKS(zfp)) {
+    for (; n; n--, fblock += BLOCK_SIZE)
+      bits += _t2(encode_block_raw, Scalar, DIMS)(zfp, fblock);
+    return bits;
+  }
+  if (STATS_ENABLED(zfp)) {
+    /* encode one block at a time to gather per-block statistics */
+    for (; n; n--, fblock += BLOCK_SIZE)
+      bits += _t2(encode_block_stats, Scalar, DIMS)(zfp, fblock);
+    return bits;
+  }
+  if (REVERSIBLE(zfp)) {
+    for (; n; n--, fblock += BLOCK_SIZE)
+      bits += _t2(rev_encode_block, Scalar, DIMS)(zfp, fblock);
+    return bits;
+  }
+  /* transform up to BATCH_LANES blocks at a time, one per SIMD lane */
+  for (; n; n -= m, fblock += (size_t)m * BLOCK_SIZE) {
+    m = (uint)MIN(n, (size_t)BATCH_LANES);
+    bits += _t2(encode_lanes, Scalar, DIMS)(zfp, fblock, m);
+  }
+  return bits;
 }
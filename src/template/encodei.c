@@ -1,15 +1,120 @@
 static uint _t2(rev_encode_block, Int, DIMS)(bitstream* stream, int minbits, int maxbits, int maxprec, Int* iblock);
 
+/* private functions ------------------------------------------------------- */
+
+/* encode contiguous integer block in current mode, destroying block */
+static uint
+_t2(encode_block_mode, Int, DIMS)(zfp_stream* zfp, Int* block)
+{
+  if (STATS_ENABLED(zfp)) {
+    zfp_stream_stats* stats = zfp->stats;
+    double start = zfp_stats_clock();
+    uint bits;
+    if (REVERSIBLE(zfp)) {
+      /* phases of reversible coding are not timed separately */
+      bits = _t2(rev_encode_block, Int, DIMS)(zfp->stream, zfp->minbits, zfp->maxbits, zfp->maxprec, block);
+      stats->coding_time += zfp_stats_clock() - start;
+    }
+    else
+      bits = _t2(encode_block_stats, Int, DIMS)(zfp->stream, zfp->minbits, zfp->maxbits, zfp->maxprec, block, stats, start);
+    stats_add_block(stats, bits);
+    return bits;
+  }
+  return REVERSIBLE(zfp) ? _t2(rev_encode_block, Int, DIMS)(zfp->stream, zfp->minbits, zfp->maxbits, zfp->maxprec, block) : _t2(encode_block, Int, DIMS)(zfp->stream, zfp->minbits, zfp->maxbits, zfp->maxprec, block);
+}
+
+/* encode copy of contiguous integer block behind a flag bit, storing the
+   original iblock verbatim if coding it would take more bits */
+static uint
+_t2(encode_block_raw, Int, DIMS)(zfp_stream* zfp, Int* block, const Int* iblock)
+{
+  const uint rawbits = BLOCK_SIZE * CHAR_BIT * (uint)sizeof(Int);
+  zfp_stream s = *zfp;
+  uint bits;
+  if (rawbits < zfp->maxbits) {
+    /* code block with one bit more than raw storage, which ends coding of */
+    /* incompressible blocks early */
+    uint64 buffer[(BLOCK_SIZE * CHAR_BIT * sizeof(Int) + 1) / 64 + 2];
+    bitstream scratch;
+    scratch_stream(&scratch, zfp->stream, buffer, sizeof(buffer));
+    s.stream = &scratch;
+    s.minbits = 0;
+    s.maxbits = rawbits + 1;
+    bits = _t2(encode_block_mode, Int, DIMS)(&s, block);
+    if (bits <= rawbits) {
+      /* append coded block */
+      stream_write_bit(zfp->stream, 0);
+      stream_flush(&scratch);
+      stream_rewind(&scratch);
+      stream_copy(zfp->stream, &scratch, bits);
+    }
+    else {
+      uint i;
+      stream_write_bit(zfp->stream, 1);
+      for (i = 0; i < BLOCK_SIZE; i++)
+        stream_write_bits(zfp->stream, (UInt)iblock[i], CHAR_BIT * (uint)sizeof(Int));
+      bits = rawbits;
+    }
+    bits++;
+    /* write at least minbits bits by padding with zeros */
+    if (zfp->minbits > bits) {
+      stream_pad(zfp->stream, zfp->minbits - bits);
+      bits = zfp->minbits;
+    }
+  }
+  else {
+    /* raw block does not fit in budget; code block after flag */
+    stream_write_bit(zfp->stream, 0);
+    s.minbits = zfp->minbits ? zfp->minbits - 1 : 0;
+    s.maxbits = zfp->maxbits - 1;
+    bits = 1 + _t2(encode_block_mode, Int, DIMS)(&s, block);
+  }
+  return bits;
+}
+
 /* public functions -------------------------------------------------------- */
 
 /* encode contiguous integer block */
+ISA_DECLARE(zfp_encode_block, (zfp_stream* zfp, const Int* iblock))
 uint
 _t2(zfp_encode_block, Int, DIMS)(zfp_stream* zfp, const Int* iblock)
 {
   cache_align_(Int block[BLOCK_SIZE]);
   uint i;
+  ISA_DISPATCH(zfp, zfp_encode_block, (zfp, iblock))
   /* copy block */
   for (i = 0; i < BLOCK_SIZE; i++)
     block[i] = iblock[i];
-  return REVERSIBLE(zfp) ? _t2(rev_encode_block, Int, DIMS)(zfp->stream, zfp->minbits, zfp->maxbits, zfp->maxprec, block) : _t2(encode_block, Int, DIMS)(zfp->stream, zfp->minbits, zfp->maxbits, zfp->maxprec, block);
+  if (RAW_BLOCKS(zfp))
+    return _t2(encode_block_raw, Int, DIMS)(zfp, block, iblock);
+  return _t2(encode_block_mode, Int, DIMS)(zfp, block);
+}
+
+/* encode n contiguous integer blocks stored consecutively */
+ISA_DECLARE_TYPED(size_t, zfp_encode_blocks, (zfp_stream* zfp, size_t n, const Int* iblock))
+size_t
+_t2(zfp_encode_blocks, Int, DIMS)(zfp_stream* zfp, size_t n, const Int* iblock)
+{
+  cache_align_(Int block[BLOCK_SIZE * BATCH_LANES]);
+  size_t bits = 0;
+  uint i, l, m;
+  ISA_DISPATCH(zfp, zfp_encode_blocks, (zfp, n, iblock))
+  if (REVERSIBLE(zfp) || STATS_ENABLED(zfp) || RAW_BLOCKS(zfp)) {
+    for (; n; n--, iblock += BLOCK_SIZE)
+      bits += _t2(zfp_encode_block, Int, DIMS)(zfp, iblock);
+    return bits;
+  }
+  for (; n; n -= m, iblock += (size_t)m * BLOCK_SIZE) {
+    m = (uint)MIN(n, (size_t)BATCH_LANES);
+    /* interleave blocks so that each occupies one lane; zero unused lanes */
+    for (i = 0; i < BLOCK_SIZE; i++)
+      for (l = 0; l < BATCH_LANES; l++)
+        block[i * BATCH_LANES + l] = l < m ? iblock[l * BLOCK_SIZE + i] : 0;
+    /* perform decorrelating transform on all lanes at once */
+    _t2(fwd_xform_lanes, Int, DIMS)(block);
+    /* encode blocks one at a time */
+    for (l = 0; l < m; l++)
+      bits += _t2(encode_lane, Int, DIMS)(zfp->stream, zfp->minbits, zfp->maxbits, zfp->maxprec, block, l);
+  }
+  return bits;
 }
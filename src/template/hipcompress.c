@@ -41,4 +41,14 @@ _t2(compress_strided_hip, Scalar, 3)(zfp_stream* stream, const zfp_field* field)
   }
 }
 
+/* compress 4d strided array */
+static void
+_t2(compress_strided_hip, Scalar, 4)(zfp_stream* stream, const zfp_field* field)
+{
+  if(zfp_stream_compression_mode(stream) == zfp_mode_fixed_rate)
+  {
+    hip_compress(stream, field);   
+  }
+}
+
 #endif
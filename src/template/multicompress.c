@@ -0,0 +1,73 @@
+/* gather full block of 4^dims values from strided array into contiguous block */
+static void
+_t1(gather_block_multi, Scalar)(Scalar* q, const Scalar* p, uint dims, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz, ptrdiff_t sw)
+{
+  uint nw = dims > 3 ? 4 : 1;
+  uint nz = dims > 2 ? 4 : 1;
+  uint ny = dims > 1 ? 4 : 1;
+  uint x, y, z, w;
+  for (w = 0; w < nw; w++)
+    for (z = 0; z < nz; z++)
+      for (y = 0; y < ny; y++)
+        for (x = 0; x < 4; x++)
+          *q++ = p[sx * (ptrdiff_t)x + sy * (ptrdiff_t)y + sz * (ptrdiff_t)z + sw * (ptrdiff_t)w];
+}
+
+/* encode contiguous block of given dimensionality to each of n streams */
+static void
+_t1(encode_block_multi, Scalar)(zfp_stream* const* streams, uint n, uint dims, const Scalar* block)
+{
+  switch (dims) {
+    case 1:
+      _t2(zfp_encode_block_multi, Scalar, 1)(streams, n, block);
+      break;
+    case 2:
+      _t2(zfp_encode_block_multi, Scalar, 2)(streams, n, block);
+      break;
+    case 3:
+      _t2(zfp_encode_block_multi, Scalar, 3)(streams, n, block);
+      break;
+    case 4:
+      _t2(zfp_encode_block_multi, Scalar, 4)(streams, n, block);
+      break;
+    default:
+      break;
+  }
+}
+
+/* compress field to each of n streams in a single pass over its blocks; the
+   front end of each full block is shared among streams, while the few
+   partial blocks on the field boundary are compressed once per stream */
+static void
+_t1(compress_multi, Scalar)(zfp_stream* const* streams, uint n, const zfp_field* field)
+{
+  const Scalar* data = (const Scalar*)field->data;
+  uint dims = zfp_field_dimensionality(field);
+  size_t nx = MAX(field->nx, 1u);
+  size_t ny = MAX(field->ny, 1u);
+  size_t nz = MAX(field->nz, 1u);
+  size_t nw = MAX(field->nw, 1u);
+  ptrdiff_t sx = field->sx ? field->sx : 1;
+  ptrdiff_t sy = field->sy ? field->sy : (ptrdiff_t)nx;
+  ptrdiff_t sz = field->sz ? field->sz : (ptrdiff_t)(nx * ny);
+  ptrdiff_t sw = field->sw ? field->sw : (ptrdiff_t)(nx * ny * nz);
+  cache_align_(Scalar block[256]);
+  size_t b = 0;
+  size_t x, y, z, w;
+  uint i;
+
+  /* visit blocks in raster order, as zfp_compress does */
+  for (w = 0; w < nw; w += 4)
+    for (z = 0; z < nz; z += 4)
+      for (y = 0; y < ny; y += 4)
+        for (x = 0; x < nx; x += 4, b++) {
+          if (nx - x < 4 || (dims > 1 && ny - y < 4) || (dims > 2 && nz - z < 4) || (dims > 3 && nw - w < 4))
+            for (i = 0; i < n; i++)
+              _t1(compress_block, Scalar)(streams[i], field, b);
+          else {
+            const Scalar* p = data + sx * (ptrdiff_t)x + sy * (ptrdiff_t)y + sz * (ptrdiff_t)z + sw * (ptrdiff_t)w;
+            _t1(gather_block_multi, Scalar)(block, p, dims, sx, sy, sz, sw);
+            _t1(encode_block_multi, Scalar)(streams, n, dims, block);
+          }
+        }
+}
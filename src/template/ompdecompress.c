@@ -0,0 +1,446 @@
+#ifdef _OPENMP
+
+/* decompress 1d contiguous array in parallel */
+static void
+_t2(decompress_omp, Scalar, 1)(zfp_stream* stream, zfp_field* field)
+{
+  /* array metadata */
+  Scalar* data = (Scalar*)field->data;
+  size_t nx = field->nx;
+
+  /* number of omp threads, blocks, and chunks */
+  uint threads = thread_count_omp(stream);
+  size_t blocks = (nx + 3) / 4;
+  size_t chunks = decompress_chunk_count_omp(stream, blocks, threads);
+  int chunk; /* OpenMP 2.0 requires int loop counter */
+  zfp_stream_stats* cs;
+
+  /* allocate per-thread streams; decompress serially if blocks cannot be located */
+  bitstream** bs = chunks ? decompress_init_par(stream, chunks, blocks) : NULL;
+  if (!bs) {
+    _t2(decompress, Scalar, 1)(stream, field);
+    return;
+  }
+
+  /* allocate per-chunk statistics if requested */
+  cs = stats_init_par(stream, chunks);
+
+  /* decompress chunks of blocks in parallel */
+  #pragma omp parallel for num_threads(threads)
+  for (chunk = 0; chunk < (int)chunks; chunk++) {
+    /* determine range of block indices assigned to this thread */
+    size_t bmin = chunk_offset(blocks, chunks, chunk + 0);
+    size_t bmax = chunk_offset(blocks, chunks, chunk + 1);
+    size_t block;
+    /* set up thread-local bit stream */
+    zfp_stream s = *stream;
+    zfp_stream_set_bit_stream(&s, bs[chunk]);
+    s.stats = stats_chunk_par(cs, chunk);
+    zfp_trace_begin("zfp:chunk");
+    count_blocks_omp(stream, bmax - bmin);
+    /* decompress sequence of blocks */
+    for (block = bmin; block < bmax; block++) {
+      /* determine block origin x within array */
+      Scalar* p = data;
+      size_t x = 4 * block;
+      p += x;
+      /* decompress partial or full block */
+      if (nx - x < 4u)
+        _t2(zfp_decode_partial_block_strided, Scalar, 1)(&s, p, nx - x, 1);
+      else
+        _t2(zfp_decode_block, Scalar, 1)(&s, p);
+    }
+    zfp_trace_end();
+  }
+
+  stats_finish_par(stream, cs, chunks);
+
+  /* release per-thread streams and position stream at end of field */
+  decompress_finish_par(stream, bs, chunks, blocks);
+}
+
+/* decompress 1d strided array in parallel */
+static void
+_t2(decompress_strided_omp, Scalar, 1)(zfp_stream* stream, zfp_field* field)
+{
+  /* array metadata */
+  Scalar* data = (Scalar*)field->data;
+  size_t nx = field->nx;
+  ptrdiff_t sx = field->sx ? field->sx : 1;
+
+  /* number of omp threads, blocks, and chunks */
+  uint threads = thread_count_omp(stream);
+  size_t blocks = (nx + 3) / 4;
+  size_t chunks = decompress_chunk_count_omp(stream, blocks, threads);
+  int chunk; /* OpenMP 2.0 requires int loop counter */
+  zfp_stream_stats* cs;
+
+  /* allocate per-thread streams; decompress serially if blocks cannot be located */
+  bitstream** bs = chunks ? decompress_init_par(stream, chunks, blocks) : NULL;
+  if (!bs) {
+    _t2(decompress_strided, Scalar, 1)(stream, field);
+    return;
+  }
+
+  /* allocate per-chunk statistics if requested */
+  cs = stats_init_par(stream, chunks);
+
+  /* decompress chunks of blocks in parallel */
+  #pragma omp parallel for num_threads(threads)
+  for (chunk = 0; chunk < (int)chunks; chunk++) {
+    /* determine range of block indices assigned to this thread */
+    size_t bmin = chunk_offset(blocks, chunks, chunk + 0);
+    size_t bmax = chunk_offset(blocks, chunks, chunk + 1);
+    size_t block;
+    /* set up thread-local bit stream */
+    zfp_stream s = *stream;
+    zfp_stream_set_bit_stream(&s, bs[chunk]);
+    s.stats = stats_chunk_par(cs, chunk);
+    zfp_trace_begin("zfp:chunk");
+    count_blocks_omp(stream, bmax - bmin);
+    /* decompress sequence of blocks */
+    for (block = bmin; block < bmax; block++) {
+      /* determine block origin x within array */
+      Scalar* p = data;
+      size_t x = 4 * block;
+      p += sx * (ptrdiff_t)x;
+      /* decompress partial or full block */
+      if (nx - x < 4u)
+        _t2(zfp_decode_partial_block_strided, Scalar, 1)(&s, p, nx - x, sx);
+      else
+        _t2(zfp_decode_block_strided, Scalar, 1)(&s, p, sx);
+    }
+    zfp_trace_end();
+  }
+
+  stats_finish_par(stream, cs, chunks);
+
+  /* release per-thread streams and position stream at end of field */
+  decompress_finish_par(stream, bs, chunks, blocks);
+}
+
+/* decompress 2d strided array in parallel */
+static void
+_t2(decompress_strided_omp, Scalar, 2)(zfp_stream* stream, zfp_field* field)
+{
+  /* array metadata */
+  Scalar* data = (Scalar*)field->data;
+  size_t nx = field->nx;
+  size_t ny = field->ny;
+  ptrdiff_t sx = field->sx ? field->sx : 1;
+  ptrdiff_t sy = field->sy ? field->sy : (ptrdiff_t)nx;
+
+  /* number of omp threads, blocks, and chunks */
+  uint threads = thread_count_omp(stream);
+  size_t bx = (nx + 3) / 4;
+  size_t by = (ny + 3) / 4;
+  size_t blocks = bx * by;
+  size_t chunks = decompress_chunk_count_omp(stream, blocks, threads);
+  int chunk; /* OpenMP 2.0 requires int loop counter */
+  zfp_stream_stats* cs;
+
+  /* allocate per-thread streams; decompress serially if blocks cannot be located */
+  bitstream** bs = chunks ? decompress_init_par(stream, chunks, blocks) : NULL;
+  if (!bs) {
+    _t2(decompress_strided, Scalar, 2)(stream, field);
+    return;
+  }
+
+  /* allocate per-chunk statistics if requested */
+  cs = stats_init_par(stream, chunks);
+
+  /* decompress chunks of blocks in parallel */
+  #pragma omp parallel for num_threads(threads)
+  for (chunk = 0; chunk < (int)chunks; chunk++) {
+    /* determine range of block indices assigned to this thread */
+    size_t bmin = chunk_offset(blocks, chunks, chunk + 0);
+    size_t bmax = chunk_offset(blocks, chunks, chunk + 1);
+    size_t block;
+    /* set up thread-local bit stream */
+    zfp_stream s = *stream;
+    zfp_stream_set_bit_stream(&s, bs[chunk]);
+    s.stats = stats_chunk_par(cs, chunk);
+    zfp_trace_begin("zfp:chunk");
+    count_blocks_omp(stream, bmax - bmin);
+    /* decompress sequence of blocks */
+    for (block = bmin; block < bmax; block++) {
+      /* determine block origin (x, y) within array */
+      Scalar* p = data;
+      size_t b = block;
+      size_t x, y;
+      x = 4 * (b % bx); b /= bx;
+      y = 4 * b;
+      p += sx * (ptrdiff_t)x + sy * (ptrdiff_t)y;
+      /* decompress partial or full block */
+      if (nx - x < 4u || ny - y < 4u)
+        _t2(zfp_decode_partial_block_strided, Scalar, 2)(&s, p, MIN(nx - x, 4u), MIN(ny - y, 4u), sx, sy);
+      else
+        _t2(zfp_decode_block_strided, Scalar, 2)(&s, p, sx, sy);
+    }
+    zfp_trace_end();
+  }
+
+  stats_finish_par(stream, cs, chunks);
+
+  /* release per-thread streams and position stream at end of field */
+  decompress_finish_par(stream, bs, chunks, blocks);
+}
+
+/* decompress 3d strided array in parallel */
+static void
+_t2(decompress_strided_omp, Scalar, 3)(zfp_stream* stream, zfp_field* field)
+{
+  /* array metadata */
+  Scalar* data = (Scalar*)field->data;
+  size_t nx = field->nx;
+  size_t ny = field->ny;
+  size_t nz = field->nz;
+  ptrdiff_t sx = field->sx ? field->sx : 1;
+  ptrdiff_t sy = field->sy ? field->sy : (ptrdiff_t)nx;
+  ptrdiff_t sz = field->sz ? field->sz : (ptrdiff_t)(nx * ny);
+
+  /* number of omp threads, blocks, and chunks */
+  uint threads = thread_count_omp(stream);
+  size_t bx = (nx + 3) / 4;
+  size_t by = (ny + 3) / 4;
+  size_t bz = (nz + 3) / 4;
+  size_t blocks = bx * by * bz;
+  size_t chunks = decompress_chunk_count_omp(stream, blocks, threads);
+  int chunk; /* OpenMP 2.0 requires int loop counter */
+  zfp_stream_stats* cs;
+
+  /* allocate per-thread streams; decompress serially if blocks cannot be located */
+  bitstream** bs = chunks ? decompress_init_par(stream, chunks, blocks) : NULL;
+  if (!bs) {
+    _t2(decompress_strided, Scalar, 3)(stream, field);
+    return;
+  }
+
+  /* allocate per-chunk statistics if requested */
+  cs = stats_init_par(stream, chunks);
+
+  /* decompress chunks of blocks in parallel */
+  #pragma omp parallel for num_threads(threads)
+  for (chunk = 0; chunk < (int)chunks; chunk++) {
+    /* determine range of block indices assigned to this thread */
+    size_t bmin = chunk_offset(blocks, chunks, chunk + 0);
+    size_t bmax = chunk_offset(blocks, chunks, chunk + 1);
+    size_t block;
+    /* set up thread-local bit stream */
+    zfp_stream s = *stream;
+    zfp_stream_set_bit_stream(&s, bs[chunk]);
+    s.stats = stats_chunk_par(cs, chunk);
+    zfp_trace_begin("zfp:chunk");
+    count_blocks_omp(stream, bmax - bmin);
+    /* decompress sequence of blocks */
+    for (block = bmin; block < bmax; block++) {
+      /* determine block origin (x, y, z) within array */
+      Scalar* p = data;
+      size_t b = block;
+      size_t x, y, z;
+      x = 4 * (b % bx); b /= bx;
+      y = 4 * (b % by); b /= by;
+      z = 4 * b;
+      p += sx * (ptrdiff_t)x + sy * (ptrdiff_t)y + sz * (ptrdiff_t)z;
+      /* decompress partial or full block */
+      if (nx - x < 4u || ny - y < 4u || nz - z < 4u)
+        _t2(zfp_decode_partial_block_strided, Scalar, 3)(&s, p, MIN(nx - x, 4u), MIN(ny - y, 4u), MIN(nz - z, 4u), sx, sy, sz);
+      else
+        _t2(zfp_decode_block_strided, Scalar, 3)(&s, p, sx, sy, sz);
+    }
+    zfp_trace_end();
+  }
+
+  stats_finish_par(stream, cs, chunks);
+
+  /* release per-thread streams and position stream at end of field */
+  decompress_finish_par(stream, bs, chunks, blocks);
+}
+
+/* decompress 4d strided array in parallel */
+static void
+_t2(decompress_strided_omp, Scalar, 4)(zfp_stream* stream, zfp_field* field)
+{
+  /* array metadata */
+  Scalar* data = (Scalar*)field->data;
+  size_t nx = field->nx;
+  size_t ny = field->ny;
+  size_t nz = field->nz;
+  size_t nw = field->nw;
+  ptrdiff_t sx = field->sx ? field->sx : 1;
+  ptrdiff_t sy = field->sy ? field->sy : (ptrdiff_t)nx;
+  ptrdiff_t sz = field->sz ? field->sz : (ptrdiff_t)(nx * ny);
+  ptrdiff_t sw = field->sw ? field->sw : (ptrdiff_t)(nx * ny * nz);
+
+  /* number of omp threads, blocks, and chunks */
+  uint threads = thread_count_omp(stream);
+  size_t bx = (nx + 3) / 4;
+  size_t by = (ny + 3) / 4;
+  size_t bz = (nz + 3) / 4;
+  size_t bw = (nw + 3) / 4;
+  size_t blocks = bx * by * bz * bw;
+  size_t chunks = decompress_chunk_count_omp(stream, blocks, threads);
+  int chunk; /* OpenMP 2.0 requires int loop counter */
+  zfp_stream_stats* cs;
+
+  /* allocate per-thread streams; decompress serially if blocks cannot be located */
+  bitstream** bs = chunks ? decompress_init_par(stream, chunks, blocks) : NULL;
+  if (!bs) {
+    _t2(decompress_strided, Scalar, 4)(stream, field);
+    return;
+  }
+
+  /* allocate per-chunk statistics if requested */
+  cs = stats_init_par(stream, chunks);
+
+  /* decompress chunks of blocks in parallel */
+  #pragma omp parallel for num_threads(threads)
+  for (chunk = 0; chunk < (int)chunks; chunk++) {
+    /* determine range of block indices assigned to this thread */
+    size_t bmin = chunk_offset(blocks, chunks, chunk + 0);
+    size_t bmax = chunk_offset(blocks, chunks, chunk + 1);
+    size_t block;
+    /* set up thread-local bit stream */
+    zfp_stream s = *stream;
+    zfp_stream_set_bit_stream(&s, bs[chunk]);
+    s.stats = stats_chunk_par(cs, chunk);
+    zfp_trace_begin("zfp:chunk");
+    count_blocks_omp(stream, bmax - bmin);
+    /* decompress sequence of blocks */
+    for (block = bmin; block < bmax; block++) {
+      /* determine block origin (x, y, z, w) within array */
+      Scalar* p = data;
+      size_t b = block;
+      size_t x, y, z, w;
+      x = 4 * (b % bx); b /= bx;
+      y = 4 * (b % by); b /= by;
+      z = 4 * (b % bz); b /= bz;
+      w = 4 * b;
+      p += sx * (ptrdiff_t)x + sy * (ptrdiff_t)y + sz * (ptrdiff_t)z + sw * (ptrdiff_t)w;
+      /* decompress partial or full block */
+      if (nx - x < 4u || ny - y < 4u || nz - z < 4u || nw - w < 4u)
+        _t2(zfp_decode_partial_block_strided, Scalar, 4)(&s, p, MIN(nx - x, 4u), MIN(ny - y, 4u), MIN(nz - z, 4u), MIN(nw - w, 4u), sx, sy, sz, sw);
+      else
+        _t2(zfp_decode_block_strided, Scalar, 4)(&s, p, sx, sy, sz, sw);
+    }
+    zfp_trace_end();
+  }
+
+  stats_finish_par(stream, cs, chunks);
+
+  /* release per-thread streams and position stream at end of field */
+  decompress_finish_par(stream, bs, chunks, blocks);
+}
+
+
+/* accumulate reduction over all blocks in parallel */
+static void
+_t1(reduce_omp, Scalar)(zfp_stream* stream, const zfp_field* field, zfp_reduce_op op, reduction* acc)
+{
+  /* number of omp threads, blocks, and chunks */
+  uint threads = thread_count_omp(stream);
+  size_t blocks = ((MAX(field->nx, 1u) + 3) / 4) * ((MAX(field->ny, 1u) + 3) / 4) * ((MAX(field->nz, 1u) + 3) / 4) * ((MAX(field->nw, 1u) + 3) / 4);
+  size_t chunks = decompress_chunk_count_omp(stream, blocks, threads);
+  int chunk; /* OpenMP 2.0 requires int loop counter */
+  zfp_stream_stats* cs;
+  size_t i;
+
+  /* allocate per-thread results and streams; reduce serially if blocks cannot be located */
+  reduction* partial = chunks ? (reduction*)malloc(chunks * sizeof(reduction)) : NULL;
+  bitstream** bs = partial ? decompress_init_par(stream, chunks, blocks) : NULL;
+  if (!bs) {
+    free(partial);
+    _t1(reduce_blocks, Scalar)(stream, field, op, 0, blocks, acc);
+    return;
+  }
+
+  /* allocate per-chunk statistics if requested */
+  cs = stats_init_par(stream, chunks);
+
+  /* reduce chunks of blocks in parallel */
+  #pragma omp parallel for num_threads(threads)
+  for (chunk = 0; chunk < (int)chunks; chunk++) {
+    /* determine range of block indices assigned to this thread */
+    size_t bmin = chunk_offset(blocks, chunks, chunk + 0);
+    size_t bmax = chunk_offset(blocks, chunks, chunk + 1);
+    /* set up thread-local bit stream */
+    zfp_stream s = *stream;
+    zfp_stream_set_bit_stream(&s, bs[chunk]);
+    s.stats = stats_chunk_par(cs, chunk);
+    zfp_trace_begin("zfp:chunk");
+    count_blocks_omp(stream, bmax - bmin);
+    reduction_init(&partial[chunk]);
+    _t1(reduce_blocks, Scalar)(&s, field, op, bmin, bmax, &partial[chunk]);
+    zfp_trace_end();
+  }
+
+  stats_finish_par(stream, cs, chunks);
+
+  /* combine partial results in chunk order */
+  for (i = 0; i < chunks; i++)
+    reduction_merge(acc, &partial[i]);
+  free(partial);
+
+  /* release per-thread streams and position stream at end of field */
+  decompress_finish_par(stream, bs, chunks, blocks);
+}
+
+/* return dot product of two compressed fields in parallel */
+static double
+_t1(dot_omp, Scalar)(zfp_stream* a, zfp_stream* b, const zfp_field* field)
+{
+  /* number of omp threads, blocks, and chunks */
+  uint threads = thread_count_omp(a);
+  size_t blocks = ((MAX(field->nx, 1u) + 3) / 4) * ((MAX(field->ny, 1u) + 3) / 4) * ((MAX(field->nz, 1u) + 3) / 4) * ((MAX(field->nw, 1u) + 3) / 4);
+  size_t chunks = decompress_chunk_count_omp(a, blocks, threads);
+  int chunk; /* OpenMP 2.0 requires int loop counter */
+  bitstream** as;
+  bitstream** bs;
+  double dot = 0;
+  size_t i;
+
+  /* both streams must be partitioned into the same chunks of blocks */
+  double* partial = chunks && chunks == decompress_chunk_count_omp(b, blocks, threads) ? (double*)malloc(chunks * sizeof(double)) : NULL;
+  as = partial ? decompress_init_par(a, chunks, blocks) : NULL;
+  bs = as ? decompress_init_par(b, chunks, blocks) : NULL;
+  if (!bs) {
+    /* release any streams of a without advancing a, then compute serially */
+    if (as) {
+      size_t base = stream_rtell(a->stream);
+      decompress_finish_par(a, as, chunks, blocks);
+      stream_rseek(a->stream, base);
+    }
+    free(partial);
+    return _t1(dot_blocks, Scalar)(a, b, field, 0, blocks);
+  }
+
+  /* compute dot products of chunks of blocks in parallel */
+  #pragma omp parallel for num_threads(threads)
+  for (chunk = 0; chunk < (int)chunks; chunk++) {
+    /* determine range of block indices assigned to this thread */
+    size_t bmin = chunk_offset(blocks, chunks, chunk + 0);
+    size_t bmax = chunk_offset(blocks, chunks, chunk + 1);
+    /* set up thread-local bit streams */
+    zfp_stream sa = *a;
+    zfp_stream sb = *b;
+    zfp_stream_set_bit_stream(&sa, as[chunk]);
+    zfp_stream_set_bit_stream(&sb, bs[chunk]);
+    sa.stats = sb.stats = NULL;
+    zfp_trace_begin("zfp:chunk");
+    partial[chunk] = _t1(dot_blocks, Scalar)(&sa, &sb, field, bmin, bmax);
+    zfp_trace_end();
+  }
+
+  /* sum partial results in chunk order */
+  for (i = 0; i < chunks; i++)
+    dot += partial[i];
+  free(partial);
+
+  /* release per-thread streams and position streams at end of field */
+  decompress_finish_par(b, bs, chunks, blocks);
+  decompress_finish_par(a, as, chunks, blocks);
+
+  return dot;
+}
+
+#endif
@@ -0,0 +1,37 @@
+#ifdef ZFP_WITH_OMP_TARGET
+
+#include "../omptarget_zfp/omptarget.h"
+
+/* compress 1d contiguous array */
+static void
+_t2(compress_omp_target, Scalar, 1)(zfp_stream* stream, const zfp_field* field)
+{
+  if (zfp_stream_compression_mode(stream) == zfp_mode_fixed_rate)
+    omp_target_compress(stream, field);
+}
+
+/* compress 1d strided array */
+static void
+_t2(compress_strided_omp_target, Scalar, 1)(zfp_stream* stream, const zfp_field* field)
+{
+  if (zfp_stream_compression_mode(stream) == zfp_mode_fixed_rate)
+    omp_target_compress(stream, field);
+}
+
+/* compress 2d strided array */
+static void
+_t2(compress_strided_omp_target, Scalar, 2)(zfp_stream* stream, const zfp_field* field)
+{
+  if (zfp_stream_compression_mode(stream) == zfp_mode_fixed_rate)
+    omp_target_compress(stream, field);
+}
+
+/* compress 3d strided array */
+static void
+_t2(compress_strided_omp_target, Scalar, 3)(zfp_stream* stream, const zfp_field* field)
+{
+  if (zfp_stream_compression_mode(stream) == zfp_mode_fixed_rate)
+    omp_target_compress(stream, field);
+}
+
+#endif
@@ -0,0 +1,37 @@
+#ifdef ZFP_WITH_OMP_TARGET
+
+#include "../omptarget_zfp/omptarget.h"
+
+/* decompress 1d contiguous array */
+static void
+_t2(decompress_omp_target, Scalar, 1)(zfp_stream* stream, zfp_field* field)
+{
+  if (zfp_stream_compression_mode(stream) == zfp_mode_fixed_rate)
+    omp_target_decompress(stream, field);
+}
+
+/* decompress 1d strided array */
+static void
+_t2(decompress_strided_omp_target, Scalar, 1)(zfp_stream* stream, zfp_field* field)
+{
+  if (zfp_stream_compression_mode(stream) == zfp_mode_fixed_rate)
+    omp_target_decompress(stream, field);
+}
+
+/* decompress 2d strided array */
+static void
+_t2(decompress_strided_omp_target, Scalar, 2)(zfp_stream* stream, zfp_field* field)
+{
+  if (zfp_stream_compression_mode(stream) == zfp_mode_fixed_rate)
+    omp_target_decompress(stream, field);
+}
+
+/* decompress 3d strided array */
+static void
+_t2(decompress_strided_omp_target, Scalar, 3)(zfp_stream* stream, zfp_field* field)
+{
+  if (zfp_stream_compression_mode(stream) == zfp_mode_fixed_rate)
+    omp_target_decompress(stream, field);
+}
+
+#endif
@@ -29,6 +29,32 @@ _t1(rev_inv_lift, Int)(Int* p, uint s)
   p -= s; *p = x;
 }
 
+#if DIMS > 1
+/* reversible inverse lifting transform of n 4-vectors with adjacent elements */
+static void
+_t1(rev_inv_lift_vec, Int)(Int* p, uint s, uint n)
+{
+  Int* q = p + s;
+  Int* r = q + s;
+  Int* t = r + s;
+  uint i;
+
+  /* vectors are independent, so this loop vectorizes */
+  for (i = 0; i < n; i++) {
+    Int x = p[i];
+    Int y = q[i];
+    Int z = r[i];
+    Int w = t[i];
+    w += z;
+    z += y; w += z;
+    y += x; z += y; w += z;
+    q[i] = y;
+    r[i] = z;
+    t[i] = w;
+  }
+}
+#endif
+
 /* decode block of integers using reversible algorithm */
 static uint
 _t2(rev_decode_block, Int, DIMS)(bitstream* stream, int minbits, int maxbits, Int* iblock)
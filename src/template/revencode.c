@@ -29,24 +29,43 @@ _t1(rev_fwd_lift, Int)(Int* p, uint s)
   p -= s; *p = x;
 }
 
+#if DIMS > 1
+/* reversible forward lifting transform of n 4-vectors with adjacent elements */
+static void
+_t1(rev_fwd_lift_vec, Int)(Int* p, uint s, uint n)
+{
+  Int* q = p + s;
+  Int* r = q + s;
+  Int* t = r + s;
+  uint i;
+
+  /* vectors are independent, so this loop vectorizes */
+  for (i = 0; i < n; i++) {
+    Int x = p[i];
+    Int y = q[i];
+    Int z = r[i];
+    Int w = t[i];
+    w -= z; z -= y; y -= x;
+    w -= z; z -= y;
+    w -= z;
+    q[i] = y;
+    r[i] = z;
+    t[i] = w;
+  }
+}
+#endif
+
 /* return precision required to encode block reversibly */
 static uint
 _t1(rev_precision, UInt)(const UInt* block, uint n)
 {
-  uint p = 0;
-  uint s;
-  /* compute bitwise OR of all values */
+  /* compute bitwise OR of all values; this loop vectorizes */
   UInt m = 0;
-  while (n--)
-    m |= *block++;
-  /* count trailing zeros via binary search */
-  for (s = CHAR_BIT * (uint)sizeof(UInt); m; s /= 2)
-    if ((UInt)(m << (s - 1))) {
-      m <<= s - 1;
-      m <<= 1;
-      p += s;
-    }
-  return p;
+  uint i;
+  for (i = 0; i < n; i++)
+    m |= block[i];
+  /* precision spans bit planes down to least significant one-bit */
+  return m ? CHAR_BIT * (uint)sizeof(UInt) - ctz64((uint64)m) : 0;
 }
 
 /* encode block of integers using reversible algorithm */
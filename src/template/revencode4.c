@@ -4,25 +4,19 @@
 static void
 _t2(rev_fwd_xform, Int, 4)(Int* p)
 {
-  uint x, y, z, w;
+  uint y, z, w;
   /* transform along x */
   for (w = 0; w < 4; w++)
     for (z = 0; z < 4; z++)
       for (y = 0; y < 4; y++)
         _t1(rev_fwd_lift, Int)(p + 4 * y + 16 * z + 64 * w, 1);
-  /* transform along y */
-  for (x = 0; x < 4; x++)
-    for (w = 0; w < 4; w++)
-      for (z = 0; z < 4; z++)
-        _t1(rev_fwd_lift, Int)(p + 16 * z + 64 * w + 1 * x, 4);
-  /* transform along z */
-  for (y = 0; y < 4; y++)
-    for (x = 0; x < 4; x++)
-      for (w = 0; w < 4; w++)
-        _t1(rev_fwd_lift, Int)(p + 64 * w + 1 * x + 4 * y, 16);
-  /* transform along w */
-  for (z = 0; z < 4; z++)
-    for (y = 0; y < 4; y++)
-      for (x = 0; x < 4; x++)
-        _t1(rev_fwd_lift, Int)(p + 1 * x + 4 * y + 16 * z, 64);
+  /* transform along y for all x at once */
+  for (w = 0; w < 4; w++)
+    for (z = 0; z < 4; z++)
+      _t1(rev_fwd_lift_vec, Int)(p + 16 * z + 64 * w, 4, 4);
+  /* transform along z for all (x, y) at once */
+  for (w = 0; w < 4; w++)
+    _t1(rev_fwd_lift_vec, Int)(p + 64 * w, 16, 16);
+  /* transform along w for all (x, y, z) at once */
+  _t1(rev_fwd_lift_vec, Int)(p, 64, 64);
 }
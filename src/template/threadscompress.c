@@ -0,0 +1,224 @@
+#ifdef ZFP_WITH_THREADS
+
+/* compress one chunk of 1d strided array */
+static void
+_t2(compress_chunk_threads, Scalar, 1)(void* arg, size_t chunk)
+{
+  const work_threads* work = (const work_threads*)arg;
+  const zfp_field* field = work->field;
+
+  /* array metadata */
+  const Scalar* data = (const Scalar*)field->data;
+  size_t nx = field->nx;
+  ptrdiff_t sx = field->sx ? field->sx : 1;
+
+  /* determine range of block indices assigned to this chunk */
+  size_t bmin = chunk_offset(work->blocks, work->chunks, chunk + 0);
+  size_t bmax = chunk_offset(work->blocks, work->chunks, chunk + 1);
+  size_t block;
+
+  /* set up thread-local bit stream */
+  zfp_stream s = *work->stream;
+  zfp_stream_set_bit_stream(&s, compress_chunk_par(work->stream, work->bs, chunk));
+  s.stats = stats_chunk_par(work->stats, chunk);
+  zfp_trace_begin("zfp:chunk");
+
+  /* compress sequence of blocks (none if out of memory) */
+  for (block = bmin; block < bmax && s.stream; block++) {
+    /* determine block origin x within array */
+    const Scalar* p = data;
+    size_t x = 4 * block;
+    p += sx * (ptrdiff_t)x;
+    /* compress partial or full block */
+    if (nx - x < 4u)
+      _t2(zfp_encode_partial_block_strided, Scalar, 1)(&s, p, nx - x, sx);
+    else
+      _t2(zfp_encode_block_strided, Scalar, 1)(&s, p, sx);
+  }
+  zfp_trace_end();
+}
+
+/* compress 1d strided array using thread pool */
+static void
+_t2(compress_threads, Scalar, 1)(zfp_stream* stream, const zfp_field* field)
+{
+  size_t blocks = (field->nx + 3) / 4;
+  compress_threads(stream, field, blocks, _t2(compress_chunk_threads, Scalar, 1));
+}
+
+/* compress one chunk of 2d strided array */
+static void
+_t2(compress_chunk_threads, Scalar, 2)(void* arg, size_t chunk)
+{
+  const work_threads* work = (const work_threads*)arg;
+  const zfp_field* field = work->field;
+
+  /* array metadata */
+  const Scalar* data = (const Scalar*)field->data;
+  size_t nx = field->nx;
+  size_t ny = field->ny;
+  ptrdiff_t sx = field->sx ? field->sx : 1;
+  ptrdiff_t sy = field->sy ? field->sy : (ptrdiff_t)nx;
+  size_t bx = (nx + 3) / 4;
+
+  /* determine range of block indices assigned to this chunk */
+  size_t bmin = chunk_offset(work->blocks, work->chunks, chunk + 0);
+  size_t bmax = chunk_offset(work->blocks, work->chunks, chunk + 1);
+  size_t block;
+
+  /* set up thread-local bit stream */
+  zfp_stream s = *work->stream;
+  zfp_stream_set_bit_stream(&s, compress_chunk_par(work->stream, work->bs, chunk));
+  s.stats = stats_chunk_par(work->stats, chunk);
+  zfp_trace_begin("zfp:chunk");
+
+  /* compress sequence of blocks (none if out of memory) */
+  for (block = bmin; block < bmax && s.stream; block++) {
+    /* determine block origin (x, y) within array */
+    const Scalar* p = data;
+    size_t b = block;
+    size_t x, y;
+    x = 4 * (b % bx); b /= bx;
+    y = 4 * b;
+    p += sx * (ptrdiff_t)x + sy * (ptrdiff_t)y;
+    /* compress partial or full block */
+    if (nx - x < 4u || ny - y < 4u)
+      _t2(zfp_encode_partial_block_strided, Scalar, 2)(&s, p, MIN(nx - x, 4u), MIN(ny - y, 4u), sx, sy);
+    else
+      _t2(zfp_encode_block_strided, Scalar, 2)(&s, p, sx, sy);
+  }
+  zfp_trace_end();
+}
+
+/* compress 2d strided array using thread pool */
+static void
+_t2(compress_threads, Scalar, 2)(zfp_stream* stream, const zfp_field* field)
+{
+  size_t blocks = ((field->nx + 3) / 4) * ((field->ny + 3) / 4);
+  compress_threads(stream, field, blocks, _t2(compress_chunk_threads, Scalar, 2));
+}
+
+/* compress one chunk of 3d strided array */
+static void
+_t2(compress_chunk_threads, Scalar, 3)(void* arg, size_t chunk)
+{
+  const work_threads* work = (const work_threads*)arg;
+  const zfp_field* field = work->field;
+
+  /* array metadata */
+  const Scalar* data = (const Scalar*)field->data;
+  size_t nx = field->nx;
+  size_t ny = field->ny;
+  size_t nz = field->nz;
+  ptrdiff_t sx = field->sx ? field->sx : 1;
+  ptrdiff_t sy = field->sy ? field->sy : (ptrdiff_t)nx;
+  ptrdiff_t sz = field->sz ? field->sz : (ptrdiff_t)(nx * ny);
+  size_t bx = (nx + 3) / 4;
+  size_t by = (ny + 3) / 4;
+  zfp_bool slab = is_slab_traversal(sx);
+
+  /* determine range of block indices assigned to this chunk */
+  size_t bmin = chunk_offset(work->blocks, work->chunks, chunk + 0);
+  size_t bmax = chunk_offset(work->blocks, work->chunks, chunk + 1);
+  size_t block;
+
+  /* set up thread-local bit stream */
+  zfp_stream s = *work->stream;
+  zfp_stream_set_bit_stream(&s, compress_chunk_par(work->stream, work->bs, chunk));
+  s.stats = stats_chunk_par(work->stats, chunk);
+  zfp_trace_begin("zfp:chunk");
+
+  /* compress sequence of blocks (none if out of memory) */
+  for (block = bmin; block < bmax && s.stream; block++) {
+    /* determine block origin (x, y, z) within array */
+    const Scalar* p = data;
+    size_t b = block;
+    size_t x, y, z;
+    x = 4 * (b % bx); b /= bx;
+    y = 4 * (b % by); b /= by;
+    z = 4 * b;
+    p += sx * (ptrdiff_t)x + sy * (ptrdiff_t)y + sz * (ptrdiff_t)z;
+    /* compress partial or full block */
+    if (nx - x < 4u || ny - y < 4u || nz - z < 4u)
+      _t2(zfp_encode_partial_block_strided, Scalar, 3)(&s, p, MIN(nx - x, 4u), MIN(ny - y, 4u), MIN(nz - z, 4u), sx, sy, sz);
+    else if (slab) {
+      /* compress full blocks through end of row or chunk */
+      size_t n = MIN((nx - x) / 4, bmax - block);
+      _t2(compress_slab, Scalar, 3)(&s, p, n, nx - x, sx, sy, sz);
+      block += n - 1;
+    }
+    else
+      _t2(zfp_encode_block_strided, Scalar, 3)(&s, p, sx, sy, sz);
+  }
+  zfp_trace_end();
+}
+
+/* compress 3d strided array using thread pool */
+static void
+_t2(compress_threads, Scalar, 3)(zfp_stream* stream, const zfp_field* field)
+{
+  size_t blocks = ((field->nx + 3) / 4) * ((field->ny + 3) / 4) * ((field->nz + 3) / 4);
+  compress_threads(stream, field, blocks, _t2(compress_chunk_threads, Scalar, 3));
+}
+
+/* compress one chunk of 4d strided array */
+static void
+_t2(compress_chunk_threads, Scalar, 4)(void* arg, size_t chunk)
+{
+  const work_threads* work = (const work_threads*)arg;
+  const zfp_field* field = work->field;
+
+  /* array metadata */
+  const Scalar* data = (const Scalar*)field->data;
+  size_t nx = field->nx;
+  size_t ny = field->ny;
+  size_t nz = field->nz;
+  size_t nw = field->nw;
+  ptrdiff_t sx = field->sx ? field->sx : 1;
+  ptrdiff_t sy = field->sy ? field->sy : (ptrdiff_t)nx;
+  ptrdiff_t sz = field->sz ? field->sz : (ptrdiff_t)(nx * ny);
+  ptrdiff_t sw = field->sw ? field->sw : (ptrdiff_t)(nx * ny * nz);
+  size_t bx = (nx + 3) / 4;
+  size_t by = (ny + 3) / 4;
+  size_t bz = (nz + 3) / 4;
+
+  /* determine range of block indices assigned to this chunk */
+  size_t bmin = chunk_offset(work->blocks, work->chunks, chunk + 0);
+  size_t bmax = chunk_offset(work->blocks, work->chunks, chunk + 1);
+  size_t block;
+
+  /* set up thread-local bit stream */
+  zfp_stream s = *work->stream;
+  zfp_stream_set_bit_stream(&s, compress_chunk_par(work->stream, work->bs, chunk));
+  s.stats = stats_chunk_par(work->stats, chunk);
+  zfp_trace_begin("zfp:chunk");
+
+  /* compress sequence of blocks (none if out of memory) */
+  for (block = bmin; block < bmax && s.stream; block++) {
+    /* determine block origin (x, y, z, w) within array */
+    const Scalar* p = data;
+    size_t b = block;
+    size_t x, y, z, w;
+    x = 4 * (b % bx); b /= bx;
+    y = 4 * (b % by); b /= by;
+    z = 4 * (b % bz); b /= bz;
+    w = 4 * b;
+    p += sx * (ptrdiff_t)x + sy * (ptrdiff_t)y + sz * (ptrdiff_t)z + sw * (ptrdiff_t)w;
+    /* compress partial or full block */
+    if (nx - x < 4u || ny - y < 4u || nz - z < 4u || nw - w < 4u)
+      _t2(zfp_encode_partial_block_strided, Scalar, 4)(&s, p, MIN(nx - x, 4u), MIN(ny - y, 4u), MIN(nz - z, 4u), MIN(nw - w, 4u), sx, sy, sz, sw);
+    else
+      _t2(zfp_encode_block_strided, Scalar, 4)(&s, p, sx, sy, sz, sw);
+  }
+  zfp_trace_end();
+}
+
+/* compress 4d strided array using thread pool */
+static void
+_t2(compress_threads, Scalar, 4)(zfp_stream* stream, const zfp_field* field)
+{
+  size_t blocks = ((field->nx + 3) / 4) * ((field->ny + 3) / 4) * ((field->nz + 3) / 4) * ((field->nw + 3) / 4);
+  compress_threads(stream, field, blocks, _t2(compress_chunk_threads, Scalar, 4));
+}
+
+#endif
@@ -1,11 +1,27 @@
+#if defined(__unix__) && !defined(_POSIX_C_SOURCE)
+  /* needed for clock_gettime */
+  #define _POSIX_C_SOURCE 200112L
+#endif
+#include <float.h>
 #include <limits.h>
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <time.h>
 #include "zfp.h"
 #include "zfp/macros.h"
 #include "zfp/version.h"
 #include "template/template.h"
+#if (defined(ZFP_WITH_ISA_SVE) || defined(ZFP_WITH_ISA_SVE2)) && defined(__linux__)
+  #include <sys/auxv.h>
+  #ifndef HWCAP_SVE
+    #define HWCAP_SVE (1ul << 22)
+  #endif
+  #ifndef HWCAP2_SVE2
+    #define HWCAP2_SVE2 (1ul << 1)
+  #endif
+#endif
 
 /* public data ------------------------------------------------------------- */
 
@@ -15,10 +31,28 @@ const char* const zfp_version_string = "zfp version " ZFP_VERSION_STRING " (May
 
 /* private functions ------------------------------------------------------- */
 
+/* scalar type whose codec compresses values of given type */
+static zfp_type
+codec_type(zfp_type type)
+{
+  switch (type) {
+    case zfp_type_half:
+    case zfp_type_bfloat16:
+      return zfp_type_float;
+    case zfp_type_int8:
+    case zfp_type_uint8:
+    case zfp_type_int16:
+    case zfp_type_uint16:
+      return zfp_type_int32;
+    default:
+      return type;
+  }
+}
+
 static uint
 type_precision(zfp_type type)
 {
-  switch (type) {
+  switch (codec_type(type)) {
     case zfp_type_int32:
       return CHAR_BIT * (uint)sizeof(int32);
     case zfp_type_int64:
@@ -32,6 +66,41 @@ type_precision(zfp_type type)
   }
 }
 
+/* true if scalar type has its own codec; narrower types are promoted */
+static zfp_bool
+is_native_type(zfp_type type)
+{
+  return zfp_type_int32 <= type && type <= zfp_type_double;
+}
+
+/* true if field identifies invalid values by mask or fill value */
+static zfp_bool
+is_masked(const zfp_field* field)
+{
+  return field->mask || field->has_fill;
+}
+
+/* true if field is stored by its own codec without masking */
+static zfp_bool
+is_plain_field(const zfp_field* field)
+{
+  return is_native_type(field->type) && !is_masked(field);
+}
+
+/* true if field strides, explicit or not, describe a dense row-major layout */
+static zfp_bool
+is_row_major(const zfp_field* field)
+{
+  uint dims = zfp_field_dimensionality(field);
+  ptrdiff_t sy = (ptrdiff_t)field->nx;
+  ptrdiff_t sz = sy * (ptrdiff_t)field->ny;
+  ptrdiff_t sw = sz * (ptrdiff_t)field->nz;
+  return (!field->sx || field->sx == 1) &&
+         (dims < 2 || !field->sy || field->sy == sy) &&
+         (dims < 3 || !field->sz || field->sz == sz) &&
+         (dims < 4 || !field->sw || field->sw == sw);
+}
+
 static size_t
 field_index_span(const zfp_field* field, ptrdiff_t* min, ptrdiff_t* max)
 {
@@ -61,10 +130,271 @@ is_reversible(const zfp_stream* zfp)
   return zfp->minexp < ZFP_MIN_EXP;
 }
 
+/* true if field can be (de)compressed asynchronously under current policy */
+static zfp_bool
+is_async_supported(const zfp_stream* zfp, const zfp_field* field)
+{
+  uint dims = zfp_field_dimensionality(field);
+  if (dims < 1 || dims > 4 || is_masked(field) || zfp->raw || zfp->verify)
+    return zfp_false;
+  switch (field->type) {
+    case zfp_type_int32:
+    case zfp_type_int64:
+    case zfp_type_float:
+    case zfp_type_double:
+      break;
+    default:
+      return zfp_false;
+  }
+  switch (zfp->exec.policy) {
+    case zfp_exec_cuda:
+      return !is_reversible(zfp);
+    case zfp_exec_hip:
+      return zfp_stream_compression_mode(zfp) == zfp_mode_fixed_rate;
+#ifdef ZFP_WITH_THREADS
+    case zfp_exec_threads:
+      return zfp_true;
+#endif
+    default:
+      return zfp_false;
+  }
+}
+
+/* true if field can be decompressed straight into a device surface */
+static zfp_bool
+is_surface_supported(const zfp_stream* zfp, const zfp_field* field)
+{
+  uint dims = zfp_field_dimensionality(field);
+  if (dims != 2 && dims != 3)
+    return zfp_false;
+  /* texel formats that surfaces store natively */
+  if (field->type != zfp_type_float && field->type != zfp_type_int32)
+    return zfp_false;
+  return is_async_supported(zfp, field);
+}
+
+/* true unless raw blocks are requested of a policy whose kernels lack them */
+static zfp_bool
+is_raw_supported(const zfp_stream* zfp)
+{
+  switch (zfp->exec.policy) {
+    case zfp_exec_serial:
+    case zfp_exec_omp:
+    case zfp_exec_threads:
+      return zfp_true;
+    default:
+      return !zfp->raw;
+  }
+}
+
+/* true unless verification is requested of a field or policy that lacks it */
+static zfp_bool
+is_verify_supported(const zfp_stream* zfp, const zfp_field* field)
+{
+  if (!zfp->verify)
+    return zfp_true;
+  if (is_masked(field))
+    return zfp_false;
+  switch (codec_type(field->type)) {
+    case zfp_type_float:
+    case zfp_type_double:
+      break;
+    default:
+      return zfp_false;
+  }
+  switch (zfp->exec.policy) {
+    case zfp_exec_serial:
+    case zfp_exec_omp:
+    case zfp_exec_threads:
+      return zfp_true;
+    default:
+      return zfp_false;
+  }
+}
+
+/* first block of run that contains block and whose bit offset is known */
+static size_t
+locate_block(const zfp_stream* zfp, size_t blocks, size_t block, uint64* offset)
+{
+  if (zfp->minbits == zfp->maxbits) {
+    /* blocks of fixed size are located directly */
+    *offset = (uint64)block * zfp->maxbits;
+    return block;
+  }
+  else {
+    /* find chunk containing block; chunk c begins with block blocks * c / chunks */
+    size_t chunks = zfp->index->chunks;
+    size_t chunk = (size_t)(((uint64)(block + 1) * chunks - 1) / blocks);
+    *offset = zfp->index->offset[chunk];
+    return (size_t)((uint64)blocks * chunk / chunks);
+  }
+}
+
+/* hint that the cache line holding *p will soon be read */
+#if defined(__GNUC__)
+  #define prefetch_(p) __builtin_prefetch(p)
+#else
+  #define prefetch_(p)
+#endif
+
+/* number of consecutive blocks gathered at once by slab traversal */
+#define SLAB_BLOCKS 16
+/* distance in values along x at which slab traversal prefetches */
+#define SLAB_PREFETCH 8
+
+/* true if 3d blocks are better gathered a slab of blocks at a time */
+static zfp_bool
+is_slab_traversal(ptrdiff_t sx)
+{
+  /* when x is not contiguous, e.g., for transposed arrays or arrays of */
+  /* structs, per-block gathers touch many cache lines and TLB pages */
+  return sx != 1;
+}
+
+/* true if library and processor support instruction set variant */
+static zfp_bool
+is_isa_supported(zfp_isa isa)
+{
+  switch (isa) {
+    case zfp_isa_generic:
+      return zfp_true;
+#ifdef ZFP_WITH_ISA_AVX2
+    case zfp_isa_avx2:
+      return __builtin_cpu_supports("avx2") &&
+             __builtin_cpu_supports("bmi") &&
+             __builtin_cpu_supports("bmi2");
+#endif
+#ifdef ZFP_WITH_ISA_AVX512
+    case zfp_isa_avx512:
+      return __builtin_cpu_supports("avx512f") &&
+             __builtin_cpu_supports("avx512vl") &&
+             __builtin_cpu_supports("avx512bw") &&
+             __builtin_cpu_supports("avx512dq") &&
+             __builtin_cpu_supports("bmi2");
+#endif
+#if defined(ZFP_WITH_ISA_SVE) && defined(__linux__)
+    case zfp_isa_sve:
+      return (getauxval(AT_HWCAP) & HWCAP_SVE) != 0;
+#endif
+#if defined(ZFP_WITH_ISA_SVE2) && defined(__linux__)
+    case zfp_isa_sve2:
+      return (getauxval(AT_HWCAP) & HWCAP_SVE) != 0 &&
+             (getauxval(AT_HWCAP2) & HWCAP2_SVE2) != 0;
+#endif
+    default:
+      return zfp_false;
+  }
+}
+
+/* profiling range callbacks set by zfp_set_trace_hooks() */
+static zfp_trace_hooks trace_hooks = { NULL, NULL, NULL };
+
+/* open named profiling range */
+void
+zfp_trace_begin(const char* name)
+{
+#ifdef ZFP_WITH_TRACING
+  if (trace_hooks.begin)
+    trace_hooks.begin(name, trace_hooks.context);
+#else
+  (void)name;
+#endif
+}
+
+/* close innermost profiling range */
+void
+zfp_trace_end(void)
+{
+#ifdef ZFP_WITH_TRACING
+  if (trace_hooks.end)
+    trace_hooks.end(trace_hooks.context);
+#endif
+}
+
+/* wall-clock time in seconds; used by codec to time phases for statistics */
+double
+zfp_stats_clock(void)
+{
+#if defined(CLOCK_MONOTONIC)
+  struct timespec ts;
+  if (!clock_gettime(CLOCK_MONOTONIC, &ts))
+    return (double)ts.tv_sec + 1e-9 * (double)ts.tv_nsec;
+#endif
+  return (double)clock() / CLOCKS_PER_SEC;
+}
+
+#if defined(_OPENMP) || defined(ZFP_WITH_THREADS)
+/* add statistics of src to dst */
+static void
+stats_add(zfp_stream_stats* dst, const zfp_stream_stats* src)
+{
+  uint i;
+  dst->blocks += src->blocks;
+  dst->zero_blocks += src->zero_blocks;
+  dst->constant_blocks += src->constant_blocks;
+  dst->bit_planes += src->bit_planes;
+  dst->bits += src->bits;
+  for (i = 0; i < ZFP_STATS_BINS; i++)
+    dst->histogram[i] += src->histogram[i];
+  dst->cast_time += src->cast_time;
+  dst->transform_time += src->transform_time;
+  dst->coding_time += src->coding_time;
+  dst->concat_time += src->concat_time;
+  for (i = 0; i < ZFP_DEVICE_PHASES; i++)
+    dst->device_time[i] += src->device_time[i];
+}
+#endif
+
+/* partial result of reduction over decompressed values */
+typedef struct {
+  double sum;   /* sum of values, or of their squares for the L2 norm */
+  double min;   /* smallest value */
+  double max;   /* largest value */
+  size_t count; /* number of values */
+} reduction;
+
+/* initialize empty reduction */
+static void
+reduction_init(reduction* r)
+{
+  r->sum = 0;
+  r->min = HUGE_VAL;
+  r->max = -HUGE_VAL;
+  r->count = 0;
+}
+
+#ifdef _OPENMP
+/* combine partial reduction src into dst */
+static void
+reduction_merge(reduction* dst, const reduction* src)
+{
+  dst->sum += src->sum;
+  dst->min = MIN(dst->min, src->min);
+  dst->max = MAX(dst->max, src->max);
+  dst->count += src->count;
+}
+#endif
+
 /* shared code across template instances ------------------------------------*/
 
+#include "share/memory.c"
+#include "share/pool.c"
 #include "share/parallel.c"
 #include "share/omp.c"
+#include "share/threads.c"
+#include "share/batch.c"
+#include "share/transcode.c"
+#include "share/convert.c"
+#include "share/entropy.c"
+#include "share/morton.c"
+#include "share/image.c"
+#include "share/hybrid.c"
+#include "share/scan.c"
+#include "share/sample.c"
+#include "share/container.c"
+#include "share/chunkentropy.c"
+#include "share/temporal.c"
+#include "share/inplace.c"
 
 /* template instantiation of integer and float compressor -------------------*/
 
@@ -72,40 +402,70 @@ is_reversible(const zfp_stream* zfp)
 #include "template/compress.c"
 #include "template/decompress.c"
 #include "template/ompcompress.c"
+#include "template/ompdecompress.c"
 #include "template/cudacompress.c"
 #include "template/cudadecompress.c"
 #include "template/hipcompress.c"
 #include "template/hipdecompress.c"
+#include "template/threadscompress.c"
+#include "template/threadsdecompress.c"
+#include "template/omptargetcompress.c"
+#include "template/omptargetdecompress.c"
+#include "template/syclcompress.c"
+#include "template/sycldecompress.c"
 #undef Scalar
 
 #define Scalar int64
 #include "template/compress.c"
 #include "template/decompress.c"
 #include "template/ompcompress.c"
+#include "template/ompdecompress.c"
 #include "template/cudacompress.c"
 #include "template/cudadecompress.c"
 #include "template/hipcompress.c"
 #include "template/hipdecompress.c"
+#include "template/threadscompress.c"
+#include "template/threadsdecompress.c"
+#include "template/omptargetcompress.c"
+#include "template/omptargetdecompress.c"
+#include "template/syclcompress.c"
+#include "template/sycldecompress.c"
 #undef Scalar
 
 #define Scalar float
 #include "template/compress.c"
+#include "template/multicompress.c"
 #include "template/decompress.c"
 #include "template/ompcompress.c"
+#include "template/ompdecompress.c"
 #include "template/cudacompress.c"
 #include "template/cudadecompress.c"
 #include "template/hipcompress.c"
 #include "template/hipdecompress.c"
+#include "template/threadscompress.c"
+#include "template/threadsdecompress.c"
+#include "template/omptargetcompress.c"
+#include "template/omptargetdecompress.c"
+#include "template/syclcompress.c"
+#include "template/sycldecompress.c"
 #undef Scalar
 
 #define Scalar double
 #include "template/compress.c"
+#include "template/multicompress.c"
 #include "template/decompress.c"
 #include "template/ompcompress.c"
+#include "template/ompdecompress.c"
 #include "template/cudacompress.c"
 #include "template/cudadecompress.c"
 #include "template/hipcompress.c"
 #include "template/hipdecompress.c"
+#include "template/threadscompress.c"
+#include "template/threadsdecompress.c"
+#include "template/omptargetcompress.c"
+#include "template/omptargetdecompress.c"
+#include "template/syclcompress.c"
+#include "template/sycldecompress.c"
 #undef Scalar
 
 /* public functions: miscellaneous ----------------------------------------- */
@@ -122,6 +482,14 @@ zfp_type_size(zfp_type type)
       return sizeof(float);
     case zfp_type_double:
       return sizeof(double);
+    case zfp_type_half:
+    case zfp_type_bfloat16:
+    case zfp_type_int16:
+    case zfp_type_uint16:
+      return sizeof(uint16);
+    case zfp_type_int8:
+    case zfp_type_uint8:
+      return sizeof(uint8);
     default:
       return 0;
   }
@@ -138,6 +506,9 @@ zfp_field_alloc()
     field->nx = field->ny = field->nz = field->nw = 0;
     field->sx = field->sy = field->sz = field->sw = 0;
     field->data = 0;
+    field->mask = 0;
+    field->fill = 0;
+    field->has_fill = zfp_false;
   }
   return field;
 }
@@ -329,11 +700,25 @@ zfp_field_metadata(const zfp_field* field)
   }
   /* 2 bits for dimensionality (1D, 2D, 3D, 4D) */
   meta <<= 2; meta += zfp_field_dimensionality(field) - 1;
-  /* 2 bits for scalar type */
-  meta <<= 2; meta += field->type - 1;
+  /* 2 bits for scalar type; narrow types are stored as their codec type */
+  meta <<= 2; meta += codec_type(field->type) - 1;
   return meta;
 }
 
+zfp_bool
+zfp_field_fill_value(const zfp_field* field, double* value)
+{
+  if (value)
+    *value = field->fill;
+  return field->has_fill;
+}
+
+const uint8*
+zfp_field_mask(const zfp_field* field)
+{
+  return field->mask;
+}
+
 void
 zfp_field_set_pointer(zfp_field* field, void* data)
 {
@@ -348,6 +733,12 @@ zfp_field_set_type(zfp_field* field, zfp_type type)
     case zfp_type_int64:
     case zfp_type_float:
     case zfp_type_double:
+    case zfp_type_half:
+    case zfp_type_bfloat16:
+    case zfp_type_int8:
+    case zfp_type_uint8:
+    case zfp_type_int16:
+    case zfp_type_uint16:
       field->type = type;
       return type;
     default:
@@ -467,26 +858,79 @@ zfp_field_set_metadata(zfp_field* field, uint64 meta)
   return zfp_true;
 }
 
+void
+zfp_field_set_fill_value(zfp_field* field, double value)
+{
+  field->fill = value;
+  field->has_fill = zfp_true;
+}
+
+void
+zfp_field_clear_fill_value(zfp_field* field)
+{
+  field->fill = 0;
+  field->has_fill = zfp_false;
+}
+
+void
+zfp_field_set_mask(zfp_field* field, const uint8* mask)
+{
+  field->mask = mask;
+}
+
 /* public functions: zfp compressed stream --------------------------------- */
 
+void
+zfp_stream_init(zfp_stream* zfp, bitstream* stream)
+{
+  zfp->stream = stream;
+  zfp->minbits = ZFP_MIN_BITS;
+  zfp->maxbits = ZFP_MAX_BITS;
+  zfp->maxprec = ZFP_MAX_PREC;
+  zfp->minexp = ZFP_MIN_EXP;
+  zfp->exec.policy = zfp_exec_serial;
+  memset(&zfp->exec.params, 0, sizeof(zfp->exec.params));
+  zfp->index = NULL;
+  zfp->isa = zfp_isa_detect();
+  zfp->scratch = NULL;
+  zfp->stats = NULL;
+  zfp->raw = zfp_false;
+  zfp->entropy = zfp_entropy_none;
+  zfp->verify = NULL;
+  zfp->map = NULL;
+  zfp->relative = zfp_false;
+}
+
+void
+zfp_stream_release(zfp_stream* zfp)
+{
+#if defined(_OPENMP) || defined(ZFP_WITH_THREADS)
+  scratch_free_par(zfp->scratch);
+  zfp->scratch = NULL;
+#else
+  (void)zfp;
+#endif
+#ifdef ZFP_WITH_THREADS
+  if (zfp->exec.policy == zfp_exec_threads) {
+    pool_free((pool*)zfp->exec.params.threads.pool);
+    zfp->exec.params.threads.pool = NULL;
+  }
+#endif
+}
+
 zfp_stream*
 zfp_stream_open(bitstream* stream)
 {
   zfp_stream* zfp = (zfp_stream*)malloc(sizeof(zfp_stream));
-  if (zfp) {
-    zfp->stream = stream;
-    zfp->minbits = ZFP_MIN_BITS;
-    zfp->maxbits = ZFP_MAX_BITS;
-    zfp->maxprec = ZFP_MAX_PREC;
-    zfp->minexp = ZFP_MIN_EXP;
-    zfp->exec.policy = zfp_exec_serial;
-  }
+  if (zfp)
+    zfp_stream_init(zfp, stream);
   return zfp;
 }
 
 void
 zfp_stream_close(zfp_stream* zfp)
 {
+  zfp_stream_release(zfp);
   free(zfp);
 }
 
@@ -559,7 +1003,15 @@ zfp_stream_precision(const zfp_stream* zfp)
 double
 zfp_stream_accuracy(const zfp_stream* zfp)
 {
-  return (zfp_stream_compression_mode(zfp) == zfp_mode_fixed_accuracy)
+  return (zfp_stream_compression_mode(zfp) == zfp_mode_fixed_accuracy && !zfp->relative)
+           ? ldexp(1.0, zfp->minexp)
+           : 0.0;
+}
+
+double
+zfp_stream_relative_accuracy(const zfp_stream* zfp)
+{
+  return (zfp_stream_compression_mode(zfp) == zfp_mode_fixed_accuracy && zfp->relative)
            ? ldexp(1.0, zfp->minexp)
            : 0.0;
 }
@@ -635,28 +1087,63 @@ zfp_stream_params(const zfp_stream* zfp, uint* minbits, uint* maxbits, uint* max
     *minexp = zfp->minexp;
 }
 
+zfp_bool
+zfp_stream_raw_blocks(const zfp_stream* zfp)
+{
+  return zfp->raw;
+}
+
+const uint8*
+zfp_stream_block_map(const zfp_stream* zfp)
+{
+  return zfp->map;
+}
+
+zfp_entropy
+zfp_stream_entropy(const zfp_stream* zfp)
+{
+  return zfp->entropy;
+}
+
 size_t
 zfp_stream_compressed_size(const zfp_stream* zfp)
 {
   return stream_size(zfp->stream);
 }
 
-size_t
-zfp_stream_maximum_size(const zfp_stream* zfp, const zfp_field* field)
+/* largest exponent of finite values of given scalar type as returned by
+   frexp, or zero for integer types */
+static int
+type_max_exponent(zfp_type type)
+{
+  switch (type) {
+    case zfp_type_half:
+      return 16;
+    case zfp_type_bfloat16:
+    case zfp_type_float:
+      return FLT_MAX_EXP;
+    case zfp_type_double:
+      return DBL_MAX_EXP;
+    default:
+      return 0;
+  }
+}
+
+/* maximum number of bits per block of given field; zero for invalid field */
+static uint
+block_maximum_bits(const zfp_stream* zfp, const zfp_field* field)
 {
   int reversible = is_reversible(zfp);
   uint dims = zfp_field_dimensionality(field);
-  uint mx = (MAX(field->nx, 1u) + 3) / 4;
-  uint my = (MAX(field->ny, 1u) + 3) / 4;
-  uint mz = (MAX(field->nz, 1u) + 3) / 4;
-  uint mw = (MAX(field->nw, 1u) + 3) / 4;
-  size_t blocks = (size_t)mx * (size_t)my * (size_t)mz * (size_t)mw;
   uint values = 1u << (2 * dims);
+  uint rawbits = values * type_precision(field->type);
+  uint maxprec = MIN(zfp->maxprec, type_precision(field->type));
+  int emax = type_max_exponent(field->type);
   uint maxbits = 0;
 
   if (!dims)
     return 0;
-  switch (field->type) {
+  switch (codec_type(field->type)) {
     case zfp_type_int32:
       maxbits += reversible ? 5 : 0;
       break;
@@ -672,12 +1159,119 @@ zfp_stream_maximum_size(const zfp_stream* zfp, const zfp_field* field)
     default:
       return 0;
   }
-  maxbits += values - 1 + values * MIN(zfp->maxprec, type_precision(field->type));
+  /* lossy floating-point blocks carry no bit planes below minexp, and the
+     largest finite value of the type bounds how many lie above it */
+  if (emax && !reversible && !zfp->relative)
+    maxprec = MIN(maxprec, (uint)MAX(0, emax - zfp->minexp + 2 * ((int)dims + 1)));
+  if (maxprec)
+    maxbits += values - 1 + values * maxprec;
+  /* blocks stored verbatim bound the size of coded ones, except that
+     verification may store a block verbatim in place of a smaller one */
+  if (zfp->raw)
+    maxbits = (zfp->verify ? MAX(maxbits, rawbits) : MIN(maxbits, rawbits)) + 1;
+  maxbits += mask_flag_bits(field, dims);
+  if (zfp->relative)
+    maxbits += relative_bits(codec_type(field->type));
   maxbits = MIN(maxbits, zfp->maxbits);
   maxbits = MAX(maxbits, zfp->minbits);
+  return maxbits;
+}
+
+/* number of blocks in field */
+static size_t
+field_blocks(const zfp_field* field)
+{
+  size_t mx = (MAX(field->nx, 1u) + 3) / 4;
+  size_t my = (MAX(field->ny, 1u) + 3) / 4;
+  size_t mz = (MAX(field->nz, 1u) + 3) / 4;
+  size_t mw = (MAX(field->nw, 1u) + 3) / 4;
+  return mx * my * mz * mw;
+}
+
+/* number of bytes needed to store given number of bits in whole words */
+static size_t
+word_bytes(double bits)
+{
+  double words = ceil(bits / stream_word_bits);
+  return (size_t)words * (stream_word_bits / CHAR_BIT);
+}
+
+size_t
+zfp_stream_maximum_size(const zfp_stream* zfp, const zfp_field* field)
+{
+  size_t blocks = field_blocks(field);
+  uint maxbits = block_maximum_bits(zfp, field);
+
+  if (!maxbits)
+    return 0;
   return ((ZFP_HEADER_MAX_BITS + blocks * maxbits + stream_word_bits - 1) & ~(stream_word_bits - 1)) / CHAR_BIT;
 }
 
+size_t
+zfp_stream_estimate_size(const zfp_stream* zfp, const zfp_field* field, double fraction, size_t* bound)
+{
+  /* function table [scalar type] */
+  uint (*ftable[4])(zfp_stream*, const zfp_field*, size_t) = {
+    compress_block_int32,
+    compress_block_int64,
+    compress_block_float,
+    compress_block_double,
+  };
+  size_t blocks = field_blocks(field);
+  uint maxbits = block_maximum_bits(zfp, field);
+  double max = (double)blocks * maxbits;
+  double n, sum, sum2, mean, var, estimate, margin;
+  uint64 buffer[(ZFP_MAX_BITS + 63) / 64 + 1];
+  zfp_stream sample;
+  size_t i;
+
+  if (!maxbits || !is_plain_field(field))
+    return 0;
+
+  /* in fixed-rate mode, every block has the same size */
+  if (zfp->minbits >= maxbits) {
+    if (bound)
+      *bound = word_bytes(max);
+    return word_bytes(max);
+  }
+
+  /* sample at least one block, or all blocks if fraction is not small */
+  n = ceil(fraction * (double)blocks);
+  n = MAX(n, 1.0);
+  n = MIN(n, (double)blocks);
+
+  /* encode each sampled block on its own to a scratch stream */
+  sample = *zfp;
+  sample.stats = NULL;
+  sample.verify = NULL;
+  sample.stream = stream_open(buffer, sizeof(buffer));
+  if (!sample.stream)
+    return 0;
+  sum = sum2 = 0;
+  for (i = 0; i < (size_t)n; i++) {
+    /* pick blocks evenly spaced in raster order */
+    size_t block = (size_t)(((double)i + 0.5) * (double)blocks / n);
+    double bits;
+    stream_rewind(sample.stream);
+    bits = (double)ftable[field->type - zfp_type_int32](&sample, field, block);
+    sum += bits;
+    sum2 += bits * bits;
+  }
+  stream_close(sample.stream);
+
+  /* scale sample mean to whole field */
+  mean = sum / n;
+  var = n > 1 ? MAX(sum2 - n * mean * mean, 0.0) / (n - 1) : 0;
+  estimate = mean * (double)blocks;
+
+  /* two standard errors of estimated total, with finite population correction */
+  margin = 2 * (double)blocks * sqrt(var / n * (1 - n / (double)blocks));
+  if (bound)
+    *bound = word_bytes(MIN(estimate + margin, max));
+
+  return word_bytes(estimate);
+}
+
 void
 zfp_stream_set_bit_stream(zfp_stream* zfp, bitstream* stream)
 {
@@ -691,6 +1285,7 @@ zfp_stream_set_reversible(zfp_stream* zfp)
   zfp->maxbits = ZFP_MAX_BITS;
   zfp->maxprec = ZFP_MAX_PREC;
   zfp->minexp = ZFP_MIN_EXP - 1;
+  zfp->relative = zfp_false;
 }
 
 double
@@ -698,7 +1293,7 @@ zfp_stream_set_rate(zfp_stream* zfp, double rate, zfp_type type, uint dims, zfp_
 {
   uint n = 1u << (2 * dims);
   uint bits = (uint)floor(n * rate + 0.5);
-  switch (type) {
+  switch (codec_type(type)) {
     case zfp_type_float:
       bits = MAX(bits, 1 + 8u);
       break;
@@ -717,6 +1312,7 @@ zfp_stream_set_rate(zfp_stream* zfp, double rate, zfp_type type, uint dims, zfp_
   zfp->maxbits = bits;
   zfp->maxprec = ZFP_MAX_PREC;
   zfp->minexp = ZFP_MIN_EXP;
+  zfp->relative = zfp_false;
   return (double)bits / n;
 }
 
@@ -727,6 +1323,7 @@ zfp_stream_set_precision(zfp_stream* zfp, uint precision)
   zfp->maxbits = ZFP_MAX_BITS;
   zfp->maxprec = precision ? MIN(precision, ZFP_MAX_PREC) : ZFP_MAX_PREC;
   zfp->minexp = ZFP_MIN_EXP;
+  zfp->relative = zfp_false;
   return zfp->maxprec;
 }
 
@@ -744,9 +1341,74 @@ zfp_stream_set_accuracy(zfp_stream* zfp, double tolerance)
   zfp->maxbits = ZFP_MAX_BITS;
   zfp->maxprec = ZFP_MAX_PREC;
   zfp->minexp = emin;
+  zfp->relative = zfp_false;
   return tolerance > 0 ? ldexp(1.0, emin) : 0;
 }
 
+double
+zfp_stream_set_relative_accuracy(zfp_stream* zfp, double tolerance)
+{
+  /* each block gets an absolute tolerance of 2^minexp times its smallest
+     nonzero magnitude */
+  double actual = zfp_stream_set_accuracy(zfp, tolerance);
+  zfp->relative = actual > 0;
+  return actual;
+}
+
+/* return true if upper bound on estimated compressed size is within budget */
+static zfp_bool
+within_budget(const zfp_stream* zfp, const zfp_field* field, double fraction, size_t bytes)
+{
+  size_t bound;
+  zfp_stream_estimate_size(zfp, field, fraction, &bound);
+  return bound <= bytes;
+}
+
+double
+zfp_stream_set_target_ratio(zfp_stream* zfp, const zfp_field* field, zfp_mode mode, double ratio, double fraction)
+{
+  size_t bytes;
+
+  if (!(ratio > 0) || !type_precision(field->type) || !zfp_field_dimensionality(field))
+    return 0;
+  bytes = (size_t)((double)(zfp_field_size(field, NULL) * zfp_type_size(field->type)) / ratio);
+
+  switch (mode) {
+    case zfp_mode_fixed_precision: {
+      /* find largest precision that meets budget */
+      uint lo = 1;
+      uint hi = type_precision(field->type);
+      while (lo < hi) {
+        uint mid = lo + (hi - lo + 1) / 2;
+        zfp_stream_set_precision(zfp, mid);
+        if (within_budget(zfp, field, fraction, bytes))
+          lo = mid;
+        else
+          hi = mid - 1;
+      }
+      return zfp_stream_set_precision(zfp, lo);
+    }
+    case zfp_mode_fixed_accuracy: {
+      /* find smallest power-of-two tolerance that meets budget */
+      int lo = ZFP_MIN_EXP;
+      int hi = DBL_MAX_EXP - 1;
+      if (field->type != zfp_type_float && field->type != zfp_type_double)
+        return 0;
+      while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        zfp_stream_set_accuracy(zfp, ldexp(1.0, mid));
+        if (within_budget(zfp, field, fraction, bytes))
+          hi = mid;
+        else
+          lo = mid + 1;
+      }
+      return zfp_stream_set_accuracy(zfp, ldexp(1.0, lo));
+    }
+    default:
+      return 0;
+  }
+}
+
 zfp_mode
 zfp_stream_set_mode(zfp_stream* zfp, uint64 mode)
 {
@@ -806,9 +1468,35 @@ zfp_stream_set_params(zfp_stream* zfp, uint minbits, uint maxbits, uint maxprec,
   zfp->maxbits = maxbits;
   zfp->maxprec = maxprec;
   zfp->minexp = minexp;
+  zfp->relative = zfp_false;
   return zfp_true;
 }
 
+void
+zfp_stream_set_raw_blocks(zfp_stream* zfp, zfp_bool enable)
+{
+  zfp->raw = enable;
+}
+
+void
+zfp_stream_set_block_map(zfp_stream* zfp, const uint8* map)
+{
+  zfp->map = map;
+}
+
+zfp_bool
+zfp_stream_set_entropy(zfp_stream* zfp, zfp_entropy coder)
+{
+  switch (coder) {
+    case zfp_entropy_none:
+    case zfp_entropy_huffman:
+      zfp->entropy = coder;
+      return zfp_true;
+    default:
+      return zfp_false;
+  }
+}
+
 size_t
 zfp_stream_flush(zfp_stream* zfp)
 {
@@ -847,18 +1535,156 @@ zfp_stream_omp_chunk_size(const zfp_stream* zfp)
   return zfp->exec.params.omp.chunk_size;
 }
 
+zfp_omp_schedule
+zfp_stream_omp_schedule(const zfp_stream* zfp)
+{
+  return zfp->exec.params.omp.schedule;
+}
+
+double*
+zfp_stream_omp_thread_time(const zfp_stream* zfp)
+{
+  return zfp->exec.params.omp.thread_time;
+}
+
+zfp_bool
+zfp_stream_omp_persistent(const zfp_stream* zfp)
+{
+  return zfp->exec.params.omp.persistent;
+}
+
+zfp_bool
+zfp_stream_omp_adaptive(const zfp_stream* zfp)
+{
+  return zfp->exec.params.omp.adaptive;
+}
+
+uint
+zfp_stream_thread_count(const zfp_stream* zfp)
+{
+  return zfp->exec.policy == zfp_exec_threads ? zfp->exec.params.threads.threads : 0;
+}
+
+uint
+zfp_stream_thread_chunk_size(const zfp_stream* zfp)
+{
+  return zfp->exec.policy == zfp_exec_threads ? zfp->exec.params.threads.chunk_size : 0;
+}
+
+zfp_device_allocator
+zfp_stream_cuda_allocator(const zfp_stream* zfp)
+{
+  zfp_device_allocator allocator = { NULL, NULL, NULL };
+  if (zfp->exec.policy == zfp_exec_cuda)
+    allocator = zfp->exec.params.cuda.allocator;
+  return allocator;
+}
+
+void*
+zfp_stream_cuda_stream(const zfp_stream* zfp)
+{
+  return zfp->exec.policy == zfp_exec_cuda ? zfp->exec.params.cuda.stream : NULL;
+}
+
+size_t
+zfp_stream_cuda_chunk_bytes(const zfp_stream* zfp)
+{
+  return zfp->exec.policy == zfp_exec_cuda ? zfp->exec.params.cuda.chunk_bytes : 0;
+}
+
+uint
+zfp_stream_cuda_devices(const zfp_stream* zfp)
+{
+  return zfp->exec.policy == zfp_exec_cuda ? zfp->exec.params.cuda.devices : 0;
+}
+
+int
+zfp_stream_cuda_device(const zfp_stream* zfp, uint slab)
+{
+  return slab < zfp_stream_cuda_devices(zfp) ? zfp->exec.params.cuda.device[slab] : -1;
+}
+
+zfp_bool
+zfp_stream_cuda_prefetch_host(const zfp_stream* zfp)
+{
+  return zfp->exec.policy == zfp_exec_cuda ? zfp->exec.params.cuda.prefetch_host : zfp_false;
+}
+
+void*
+zfp_stream_hip_stream(const zfp_stream* zfp)
+{
+  return zfp->exec.policy == zfp_exec_hip ? zfp->exec.params.hip.stream : NULL;
+}
+
+int
+zfp_stream_omp_target_device(const zfp_stream* zfp)
+{
+  return zfp->exec.policy == zfp_exec_omp_target ? zfp->exec.params.omp_target.device : -1;
+}
+
+zfp_bool
+zfp_stream_omp_target_device_field(const zfp_stream* zfp)
+{
+  return zfp->exec.policy == zfp_exec_omp_target ? zfp->exec.params.omp_target.device_field : zfp_false;
+}
+
+zfp_bool
+zfp_stream_omp_target_device_stream(const zfp_stream* zfp)
+{
+  return zfp->exec.policy == zfp_exec_omp_target ? zfp->exec.params.omp_target.device_stream : zfp_false;
+}
+
+void*
+zfp_stream_sycl_queue(const zfp_stream* zfp)
+{
+  return zfp->exec.policy == zfp_exec_sycl ? zfp->exec.params.sycl.queue : NULL;
+}
+
+zfp_exec_policy
+zfp_stream_hybrid_device(const zfp_stream* zfp)
+{
+  return zfp->exec.policy == zfp_exec_hybrid ? zfp->exec.params.hybrid.device : zfp_exec_serial;
+}
+
+uint
+zfp_stream_hybrid_threads(const zfp_stream* zfp)
+{
+  return zfp->exec.policy == zfp_exec_hybrid ? zfp->exec.params.hybrid.threads : 0;
+}
+
+double
+zfp_stream_hybrid_ratio(const zfp_stream* zfp)
+{
+  return zfp->exec.policy == zfp_exec_hybrid ? zfp->exec.params.hybrid.ratio : 0;
+}
+
 zfp_bool
 zfp_stream_set_execution(zfp_stream* zfp, zfp_exec_policy policy)
 {
+#ifdef ZFP_WITH_THREADS
+  /* worker threads of current policy, which are stopped if policy changes */
+  pool* p = zfp->exec.policy == zfp_exec_threads ? (pool*)zfp->exec.params.threads.pool : NULL;
+#endif
   switch (policy) {
     case zfp_exec_serial:
       break;
 #ifdef ZFP_WITH_CUDA
     case zfp_exec_cuda:
+      if (zfp->exec.policy != policy) {
+        zfp->exec.params.cuda.allocator.alloc = NULL;
+        zfp->exec.params.cuda.allocator.free = NULL;
+        zfp->exec.params.cuda.allocator.context = NULL;
+        zfp->exec.params.cuda.stream = NULL;
+        zfp->exec.params.cuda.chunk_bytes = 0;
+        zfp->exec.params.cuda.devices = 0;
+        zfp->exec.params.cuda.prefetch_host = zfp_false;
+      }
       break;
 #endif
 #ifdef ZFP_WITH_HIP
     case zfp_exec_hip:
+      if (zfp->exec.policy != policy)
+        zfp->exec.params.hip.stream = NULL;
       break;
 #endif
     case zfp_exec_omp:
@@ -866,6 +1692,52 @@ zfp_stream_set_execution(zfp_stream* zfp, zfp_exec_policy policy)
       if (zfp->exec.policy != policy) {
         zfp->exec.params.omp.threads = 0;
         zfp->exec.params.omp.chunk_size = 0;
+        zfp->exec.params.omp.schedule = zfp_omp_static;
+        zfp->exec.params.omp.thread_time = NULL;
+        zfp->exec.params.omp.persistent = zfp_false;
+        zfp->exec.params.omp.adaptive = zfp_false;
+      }
+      break;
+#else
+      return zfp_false;
+#endif
+    case zfp_exec_threads:
+#ifdef ZFP_WITH_THREADS
+      if (zfp->exec.policy != policy) {
+        zfp->exec.params.threads.threads = 0;
+        zfp->exec.params.threads.chunk_size = 0;
+        zfp->exec.params.threads.pool = NULL;
+      }
+      break;
+#else
+      return zfp_false;
+#endif
+    case zfp_exec_omp_target:
+#ifdef ZFP_WITH_OMP_TARGET
+      if (zfp->exec.policy != policy) {
+        zfp->exec.params.omp_target.device = -1;
+        zfp->exec.params.omp_target.device_field = zfp_false;
+        zfp->exec.params.omp_target.device_stream = zfp_false;
+      }
+      break;
+#else
+      return zfp_false;
+#endif
+    case zfp_exec_sycl:
+#ifdef ZFP_WITH_SYCL
+      if (zfp->exec.policy != policy)
+        zfp->exec.params.sycl.queue = NULL;
+      break;
+#else
+      return zfp_false;
+#endif
+    case zfp_exec_hybrid:
+#ifdef ZFP_WITH_HYBRID
+      if (zfp->exec.policy != policy) {
+        zfp->exec.params.hybrid.device = HYBRID_DEFAULT_DEVICE;
+        zfp->exec.params.hybrid.threads = 0;
+        zfp->exec.params.hybrid.ratio = 0.5;
+        zfp->exec.params.hybrid.calibrate = zfp_true;
       }
       break;
 #else
@@ -874,6 +1746,10 @@ zfp_stream_set_execution(zfp_stream* zfp, zfp_exec_policy policy)
     default:
       return zfp_false;
   }
+#ifdef ZFP_WITH_THREADS
+  if (policy != zfp_exec_threads)
+    pool_free(p);
+#endif
   zfp->exec.policy = policy;
   return zfp_true;
 }
@@ -896,304 +1772,3099 @@ zfp_stream_set_omp_chunk_size(zfp_stream* zfp, uint chunk_size)
   return zfp_true;
 }
 
-/* public functions: utility functions --------------------------------------*/
-
-void
-zfp_promote_int8_to_int32(int32* oblock, const int8* iblock, uint dims)
+zfp_bool
+zfp_stream_set_omp_schedule(zfp_stream* zfp, zfp_omp_schedule schedule)
 {
-  uint count = 1u << (2 * dims);
-  while (count--)
-    *oblock++ = (int32)*iblock++ << 23;
+  switch (schedule) {
+    case zfp_omp_static:
+    case zfp_omp_dynamic:
+    case zfp_omp_guided:
+    case zfp_omp_auto:
+    case zfp_omp_tasks:
+      break;
+    default:
+      return zfp_false;
+  }
+  if (!zfp_stream_set_execution(zfp, zfp_exec_omp))
+    return zfp_false;
+  zfp->exec.params.omp.schedule = schedule;
+  return zfp_true;
 }
 
-void
-zfp_promote_uint8_to_int32(int32* oblock, const uint8* iblock, uint dims)
+zfp_bool
+zfp_stream_set_omp_thread_time(zfp_stream* zfp, double* time)
 {
-  uint count = 1u << (2 * dims);
-  while (count--)
-    *oblock++ = ((int32)*iblock++ - 0x80) << 23;
+  if (!zfp_stream_set_execution(zfp, zfp_exec_omp))
+    return zfp_false;
+  zfp->exec.params.omp.thread_time = time;
+  return zfp_true;
 }
 
-void
-zfp_promote_int16_to_int32(int32* oblock, const int16* iblock, uint dims)
+zfp_bool
+zfp_stream_set_omp_persistent(zfp_stream* zfp, zfp_bool persistent)
 {
-  uint count = 1u << (2 * dims);
-  while (count--)
-    *oblock++ = (int32)*iblock++ << 15;
+  if (!zfp_stream_set_execution(zfp, zfp_exec_omp))
+    return zfp_false;
+  zfp->exec.params.omp.persistent = persistent;
+#ifdef _OPENMP
+  /* release any buffers retained so far */
+  if (!persistent) {
+    scratch_free_par(zfp->scratch);
+    zfp->scratch = NULL;
+  }
+#endif
+  return zfp_true;
 }
 
-void
-zfp_promote_uint16_to_int32(int32* oblock, const uint16* iblock, uint dims)
+zfp_bool
+zfp_stream_set_omp_adaptive(zfp_stream* zfp, zfp_bool adaptive)
 {
-  uint count = 1u << (2 * dims);
-  while (count--)
-    *oblock++ = ((int32)*iblock++ - 0x8000) << 15;
+  if (!zfp_stream_set_execution(zfp, zfp_exec_omp))
+    return zfp_false;
+  zfp->exec.params.omp.adaptive = adaptive;
+  return zfp_true;
 }
 
-void
-zfp_demote_int32_to_int8(int8* oblock, const int32* iblock, uint dims)
+zfp_bool
+zfp_stream_set_thread_count(zfp_stream* zfp, uint threads)
 {
-  uint count = 1u << (2 * dims);
-  while (count--) {
-    int32 i = *iblock++ >> 23;
-    *oblock++ = (int8)MAX(-0x80, MIN(i, 0x7f));
+  if (!zfp_stream_set_execution(zfp, zfp_exec_threads))
+    return zfp_false;
+#ifdef ZFP_WITH_THREADS
+  /* restart pool with new number of threads on next use */
+  if (zfp->exec.params.threads.threads != threads) {
+    pool_free((pool*)zfp->exec.params.threads.pool);
+    zfp->exec.params.threads.pool = NULL;
   }
+#endif
+  zfp->exec.params.threads.threads = threads;
+  return zfp_true;
 }
 
-void
-zfp_demote_int32_to_uint8(uint8* oblock, const int32* iblock, uint dims)
+zfp_bool
+zfp_stream_set_thread_chunk_size(zfp_stream* zfp, uint chunk_size)
 {
-  uint count = 1u << (2 * dims);
-  while (count--) {
-    int32 i = (*iblock++ >> 23) + 0x80;
-    *oblock++ = (uint8)MAX(0x00, MIN(i, 0xff));
-  }
+  if (!zfp_stream_set_execution(zfp, zfp_exec_threads))
+    return zfp_false;
+  zfp->exec.params.threads.chunk_size = chunk_size;
+  return zfp_true;
 }
 
-void
-zfp_demote_int32_to_int16(int16* oblock, const int32* iblock, uint dims)
+zfp_bool
+zfp_stream_set_cuda_allocator(zfp_stream* zfp, const zfp_device_allocator* allocator)
 {
-  uint count = 1u << (2 * dims);
-  while (count--) {
-    int32 i = *iblock++ >> 15;
-    *oblock++ = (int16)MAX(-0x8000, MIN(i, 0x7fff));
+  /* allocation and deallocation must be paired */
+  if (allocator && !allocator->alloc != !allocator->free)
+    return zfp_false;
+  if (!zfp_stream_set_execution(zfp, zfp_exec_cuda))
+    return zfp_false;
+  if (allocator)
+    zfp->exec.params.cuda.allocator = *allocator;
+  else {
+    zfp->exec.params.cuda.allocator.alloc = NULL;
+    zfp->exec.params.cuda.allocator.free = NULL;
+    zfp->exec.params.cuda.allocator.context = NULL;
   }
+  return zfp_true;
 }
 
-void
-zfp_demote_int32_to_uint16(uint16* oblock, const int32* iblock, uint dims)
+zfp_bool
+zfp_stream_set_cuda_stream(zfp_stream* zfp, void* cuda_stream)
 {
-  uint count = 1u << (2 * dims);
-  while (count--) {
-    int32 i = (*iblock++ >> 15) + 0x8000;
-    *oblock++ = (uint16)MAX(0x0000, MIN(i, 0xffff));
-  }
+  if (!zfp_stream_set_execution(zfp, zfp_exec_cuda))
+    return zfp_false;
+  zfp->exec.params.cuda.stream = cuda_stream;
+  return zfp_true;
 }
 
-/* public functions: compression and decompression --------------------------*/
+zfp_bool
+zfp_stream_set_cuda_chunk_bytes(zfp_stream* zfp, size_t chunk_bytes)
+{
+  if (!zfp_stream_set_execution(zfp, zfp_exec_cuda))
+    return zfp_false;
+  zfp->exec.params.cuda.chunk_bytes = chunk_bytes;
+  return zfp_true;
+}
 
-size_t
-zfp_compress(zfp_stream* zfp, const zfp_field* field)
+zfp_bool
+zfp_stream_set_cuda_devices(zfp_stream* zfp, const int* device, uint devices)
 {
-  /* function table [execution][strided][dimensionality][scalar type] */
-  void (*ftable[4][2][4][4])(zfp_stream*, const zfp_field*) = {
-    /* serial */
-    {{{ compress_int32_1,         compress_int64_1,         compress_float_1,         compress_double_1 },
-      { compress_strided_int32_2, compress_strided_int64_2, compress_strided_float_2, compress_strided_double_2 },
-      { compress_strided_int32_3, compress_strided_int64_3, compress_strided_float_3, compress_strided_double_3 },
-      { compress_strided_int32_4, compress_strided_int64_4, compress_strided_float_4, compress_strided_double_4 }},
-     {{ compress_strided_int32_1, compress_strided_int64_1, compress_strided_float_1, compress_strided_double_1 },
-      { compress_strided_int32_2, compress_strided_int64_2, compress_strided_float_2, compress_strided_double_2 },
-      { compress_strided_int32_3, compress_strided_int64_3, compress_strided_float_3, compress_strided_double_3 },
-      { compress_strided_int32_4, compress_strided_int64_4, compress_strided_float_4, compress_strided_double_4 }}},
+  uint i;
+  if (!device)
+    devices = 0;
+  if (devices > ZFP_CUDA_MAX_DEVICES)
+    return zfp_false;
+  if (!zfp_stream_set_execution(zfp, zfp_exec_cuda))
+    return zfp_false;
+  for (i = 0; i < devices; i++)
+    zfp->exec.params.cuda.device[i] = device[i];
+  zfp->exec.params.cuda.devices = devices;
+  return zfp_true;
+}
 
-    /* OpenMP */
-#ifdef _OPENMP
-    {{{ compress_omp_int32_1,         compress_omp_int64_1,         compress_omp_float_1,         compress_omp_double_1 },
-      { compress_strided_omp_int32_2, compress_strided_omp_int64_2, compress_strided_omp_float_2, compress_strided_omp_double_2 },
-      { compress_strided_omp_int32_3, compress_strided_omp_int64_3, compress_strided_omp_float_3, compress_strided_omp_double_3 },
-      { compress_strided_omp_int32_4, compress_strided_omp_int64_4, compress_strided_omp_float_4, compress_strided_omp_double_4 }},
-     {{ compress_strided_omp_int32_1, compress_strided_omp_int64_1, compress_strided_omp_float_1, compress_strided_omp_double_1 },
-      { compress_strided_omp_int32_2, compress_strided_omp_int64_2, compress_strided_omp_float_2, compress_strided_omp_double_2 },
-      { compress_strided_omp_int32_3, compress_strided_omp_int64_3, compress_strided_omp_float_3, compress_strided_omp_double_3 },
-      { compress_strided_omp_int32_4, compress_strided_omp_int64_4, compress_strided_omp_float_4, compress_strided_omp_double_4 }}},
-#else
-    {{{ NULL }}},
-#endif
+zfp_bool
+zfp_stream_set_cuda_prefetch_host(zfp_stream* zfp, zfp_bool prefetch_host)
+{
+  if (!zfp_stream_set_execution(zfp, zfp_exec_cuda))
+    return zfp_false;
+  zfp->exec.params.cuda.prefetch_host = prefetch_host;
+  return zfp_true;
+}
 
-    /* CUDA */
-#ifdef ZFP_WITH_CUDA
-    {{{ compress_cuda_int32_1,         compress_cuda_int64_1,         compress_cuda_float_1,         compress_cuda_double_1 },
-      { compress_strided_cuda_int32_2, compress_strided_cuda_int64_2, compress_strided_cuda_float_2, compress_strided_cuda_double_2 },
-      { compress_strided_cuda_int32_3, compress_strided_cuda_int64_3, compress_strided_cuda_float_3, compress_strided_cuda_double_3 },
-      { NULL,                            NULL,                            NULL,                            NULL }},
-     {{ compress_strided_cuda_int32_1, compress_strided_cuda_int64_1, compress_strided_cuda_float_1, compress_strided_cuda_double_1 },
-      { compress_strided_cuda_int32_2, compress_strided_cuda_int64_2, compress_strided_cuda_float_2, compress_strided_cuda_double_2 },
-      { compress_strided_cuda_int32_3, compress_strided_cuda_int64_3, compress_strided_cuda_float_3, compress_strided_cuda_double_3 },
-      { NULL,                            NULL,                            NULL,                            NULL }}},
-#else
-    {{{ NULL }}},
-#endif
-    /* HIP */
-#ifdef ZFP_WITH_HIP
-    {{{ compress_hip_int32_1,         compress_hip_int64_1,         compress_hip_float_1,         compress_hip_double_1 },
+zfp_bool
+zfp_stream_set_hip_stream(zfp_stream* zfp, void* hip_stream)
+{
+  if (!zfp_stream_set_execution(zfp, zfp_exec_hip))
+    return zfp_false;
+  zfp->exec.params.hip.stream = hip_stream;
+  return zfp_true;
+}
+
+zfp_bool
+zfp_stream_set_omp_target_device(zfp_stream* zfp, int device)
+{
+  if (!zfp_stream_set_execution(zfp, zfp_exec_omp_target))
+    return zfp_false;
+  zfp->exec.params.omp_target.device = device;
+  return zfp_true;
+}
+
+zfp_bool
+zfp_stream_set_omp_target_device_data(zfp_stream* zfp, zfp_bool field, zfp_bool buffer)
+{
+  if (!zfp_stream_set_execution(zfp, zfp_exec_omp_target))
+    return zfp_false;
+  zfp->exec.params.omp_target.device_field = field;
+  zfp->exec.params.omp_target.device_stream = buffer;
+  return zfp_true;
+}
+
+zfp_bool
+zfp_stream_set_sycl_queue(zfp_stream* zfp, void* queue)
+{
+  if (!zfp_stream_set_execution(zfp, zfp_exec_sycl))
+    return zfp_false;
+  zfp->exec.params.sycl.queue = queue;
+  return zfp_true;
+}
+
+zfp_bool
+zfp_stream_set_hybrid_device(zfp_stream* zfp, zfp_exec_policy device)
+{
+  switch (device) {
+#ifdef ZFP_WITH_CUDA
+    case zfp_exec_cuda:
+      break;
+#endif
+#ifdef ZFP_WITH_HIP
+    case zfp_exec_hip:
+      break;
+#endif
+    default:
+      return zfp_false;
+  }
+  if (!zfp_stream_set_execution(zfp, zfp_exec_hybrid))
+    return zfp_false;
+  zfp->exec.params.hybrid.device = device;
+  return zfp_true;
+}
+
+zfp_bool
+zfp_stream_set_hybrid_threads(zfp_stream* zfp, uint threads)
+{
+  if (!zfp_stream_set_execution(zfp, zfp_exec_hybrid))
+    return zfp_false;
+  zfp->exec.params.hybrid.threads = threads;
+  return zfp_true;
+}
+
+zfp_bool
+zfp_stream_set_hybrid_ratio(zfp_stream* zfp, double ratio, zfp_bool calibrate)
+{
+  if (!(0 <= ratio && ratio <= 1))
+    return zfp_false;
+  if (!zfp_stream_set_execution(zfp, zfp_exec_hybrid))
+    return zfp_false;
+  zfp->exec.params.hybrid.ratio = ratio;
+  zfp->exec.params.hybrid.calibrate = calibrate;
+  return zfp_true;
+}
+
+/* public functions: instruction set dispatch ----------------------------- */
+
+zfp_isa
+zfp_isa_detect()
+{
+  if (is_isa_supported(zfp_isa_sve2))
+    return zfp_isa_sve2;
+  if (is_isa_supported(zfp_isa_sve))
+    return zfp_isa_sve;
+  if (is_isa_supported(zfp_isa_avx512))
+    return zfp_isa_avx512;
+  if (is_isa_supported(zfp_isa_avx2))
+    return zfp_isa_avx2;
+  return zfp_isa_generic;
+}
+
+const char*
+zfp_isa_name(zfp_isa isa)
+{
+  switch (isa) {
+    case zfp_isa_generic:
+      return "generic";
+    case zfp_isa_avx2:
+      return "avx2";
+    case zfp_isa_avx512:
+      return "avx512";
+    case zfp_isa_sve:
+      return "sve";
+    case zfp_isa_sve2:
+      return "sve2";
+    default:
+      return NULL;
+  }
+}
+
+zfp_isa
+zfp_stream_isa(const zfp_stream* zfp)
+{
+  return zfp->isa;
+}
+
+zfp_bool
+zfp_stream_set_isa(zfp_stream* zfp, zfp_isa isa)
+{
+  if (!is_isa_supported(isa))
+    return zfp_false;
+  zfp->isa = isa;
+  return zfp_true;
+}
+
+/* public functions: profiling ranges -------------------------------------- */
+
+void
+zfp_set_trace_hooks(const zfp_trace_hooks* hooks)
+{
+  if (hooks)
+    trace_hooks = *hooks;
+  else {
+    trace_hooks.begin = NULL;
+    trace_hooks.end = NULL;
+    trace_hooks.context = NULL;
+  }
+}
+
+/* public functions: memory accounting ------------------------------------ */
+
+zfp_memory_usage
+zfp_memory_query(zfp_memory_pool pool)
+{
+  zfp_memory_usage usage;
+  memory_update(pool, memory_op_query, 0, &usage);
+  return usage;
+}
+
+size_t
+zfp_memory_available(zfp_memory_pool pool)
+{
+  zfp_memory_usage usage = zfp_memory_query(pool);
+  if (!usage.limit)
+    return (size_t)-1;
+  return usage.limit - MIN(usage.current, usage.limit);
+}
+
+void
+zfp_memory_set_limit(zfp_memory_pool pool, size_t bytes)
+{
+  memory_update(pool, memory_op_limit, bytes, NULL);
+}
+
+void
+zfp_memory_reset_peak(zfp_memory_pool pool)
+{
+  memory_update(pool, memory_op_reset, 0, NULL);
+}
+
+zfp_bool
+zfp_memory_acquire(zfp_memory_pool pool, size_t bytes)
+{
+  return memory_update(pool, memory_op_acquire, bytes, NULL);
+}
+
+void
+zfp_memory_charge(zfp_memory_pool pool, size_t bytes)
+{
+  memory_update(pool, memory_op_charge, bytes, NULL);
+}
+
+void
+zfp_memory_release(zfp_memory_pool pool, size_t bytes)
+{
+  memory_update(pool, memory_op_release, bytes, NULL);
+}
+
+/* public functions: statistics ------------------------------------------- */
+
+zfp_stream_stats*
+zfp_stream_statistics(const zfp_stream* zfp)
+{
+  return zfp->stats;
+}
+
+void
+zfp_stream_set_stats(zfp_stream* zfp, zfp_stream_stats* stats)
+{
+  zfp->stats = stats;
+}
+
+void
+zfp_stats_reset(zfp_stream_stats* stats)
+{
+  uint64* thread_blocks = stats->thread_blocks;
+  uint threads = stats->threads;
+  uint i;
+  memset(stats, 0, sizeof(*stats));
+  stats->threads = threads;
+  stats->thread_blocks = thread_blocks;
+  if (thread_blocks)
+    for (i = 0; i < threads; i++)
+      thread_blocks[i] = 0;
+}
+
+zfp_verification*
+zfp_stream_verification(const zfp_stream* zfp)
+{
+  return zfp->verify;
+}
+
+void
+zfp_stream_set_verification(zfp_stream* zfp, zfp_verification* verification)
+{
+  zfp->verify = verification;
+}
+
+void
+zfp_verification_reset(zfp_verification* verification)
+{
+  memset(verification, 0, sizeof(*verification));
+}
+
+/* public functions: chunk offset index ----------------------------------- */
+
+zfp_index*
+zfp_index_alloc()
+{
+  zfp_index* index = (zfp_index*)malloc(sizeof(zfp_index));
+  if (index) {
+    index->chunks = 0;
+    index->offset = NULL;
+    index->hashing = zfp_false;
+    index->hashes = 0;
+    index->hash = NULL;
+  }
+  return index;
+}
+
+void
+zfp_index_free(zfp_index* index)
+{
+  if (index) {
+    free(index->offset);
+    free(index->hash);
+    free(index);
+  }
+}
+
+size_t
+zfp_index_chunks(const zfp_index* index)
+{
+  return index->chunks;
+}
+
+uint64
+zfp_index_offset(const zfp_index* index, size_t chunk)
+{
+  return chunk <= index->chunks && index->offset ? index->offset[chunk] : 0;
+}
+
+zfp_bool
+zfp_index_set(zfp_index* index, size_t chunks, const uint64* offset)
+{
+  uint64* buffer;
+  size_t i;
+
+  /* offsets must begin at zero and be nondecreasing */
+  if (!chunks || offset[0])
+    return zfp_false;
+  for (i = 0; i < chunks; i++)
+    if (offset[i] > offset[i + 1])
+      return zfp_false;
+
+  buffer = (uint64*)realloc(index->offset, (chunks + 1) * sizeof(uint64));
+  if (!buffer)
+    return zfp_false;
+  for (i = 0; i <= chunks; i++)
+    buffer[i] = offset[i];
+  index->offset = buffer;
+  index->chunks = chunks;
+  index->hashes = 0;
+
+  return zfp_true;
+}
+
+void
+zfp_index_set_hashing(zfp_index* index, zfp_bool hashing)
+{
+  index->hashing = hashing;
+}
+
+zfp_bool
+zfp_index_hash(const zfp_index* index, size_t chunk, uint32* hash)
+{
+  if (!index->hash || index->hashes != index->chunks || chunk >= index->chunks)
+    return zfp_false;
+  *hash = index->hash[chunk];
+  return zfp_true;
+}
+
+zfp_index*
+zfp_stream_index(const zfp_stream* zfp)
+{
+  return zfp->index;
+}
+
+void
+zfp_stream_set_index(zfp_stream* zfp, zfp_index* index)
+{
+  zfp->index = index;
+}
+
+/* public functions: utility functions --------------------------------------*/
+
+void
+zfp_promote_int8_to_int32(int32* oblock, const int8* iblock, uint dims)
+{
+  uint count = 1u << (2 * dims);
+  while (count--)
+    *oblock++ = (int32)*iblock++ << 23;
+}
+
+void
+zfp_promote_uint8_to_int32(int32* oblock, const uint8* iblock, uint dims)
+{
+  uint count = 1u << (2 * dims);
+  while (count--)
+    *oblock++ = ((int32)*iblock++ - 0x80) << 23;
+}
+
+void
+zfp_promote_int16_to_int32(int32* oblock, const int16* iblock, uint dims)
+{
+  uint count = 1u << (2 * dims);
+  while (count--)
+    *oblock++ = (int32)*iblock++ << 15;
+}
+
+void
+zfp_promote_uint16_to_int32(int32* oblock, const uint16* iblock, uint dims)
+{
+  uint count = 1u << (2 * dims);
+  while (count--)
+    *oblock++ = ((int32)*iblock++ - 0x8000) << 15;
+}
+
+void
+zfp_demote_int32_to_int8(int8* oblock, const int32* iblock, uint dims)
+{
+  uint count = 1u << (2 * dims);
+  while (count--) {
+    int32 i = *iblock++ >> 23;
+    *oblock++ = (int8)MAX(-0x80, MIN(i, 0x7f));
+  }
+}
+
+void
+zfp_demote_int32_to_uint8(uint8* oblock, const int32* iblock, uint dims)
+{
+  uint count = 1u << (2 * dims);
+  while (count--) {
+    int32 i = (*iblock++ >> 23) + 0x80;
+    *oblock++ = (uint8)MAX(0x00, MIN(i, 0xff));
+  }
+}
+
+void
+zfp_demote_int32_to_int16(int16* oblock, const int32* iblock, uint dims)
+{
+  uint count = 1u << (2 * dims);
+  while (count--) {
+    int32 i = *iblock++ >> 15;
+    *oblock++ = (int16)MAX(-0x8000, MIN(i, 0x7fff));
+  }
+}
+
+void
+zfp_demote_int32_to_uint16(uint16* oblock, const int32* iblock, uint dims)
+{
+  uint count = 1u << (2 * dims);
+  while (count--) {
+    int32 i = (*iblock++ >> 15) + 0x8000;
+    *oblock++ = (uint16)MAX(0x0000, MIN(i, 0xffff));
+  }
+}
+
+/* describe first component of field of interleaved components with explicit
+   strides; return false if components cannot be addressed via int strides */
+static zfp_bool
+interleaved_field(zfp_field* f, const zfp_field* field, uint components)
+{
+  uint dims = zfp_field_dimensionality(field);
+
+  if (!components || !dims || !is_plain_field(field))
+    return zfp_false;
+
+  *f = *field;
+  if (!zfp_field_stride(field, NULL)) {
+    /* contiguous array of structs of components scalars each */
+    if ((size_t)components * zfp_field_size(field, NULL) > INT_MAX)
+      return zfp_false;
+    f->sx = (int)components;
+    if (dims > 1)
+      f->sy = (int)(components * field->nx);
+    if (dims > 2)
+      f->sz = (int)(components * field->nx * field->ny);
+    if (dims > 3)
+      f->sw = (int)(components * field->nx * field->ny * field->nz);
+  }
+
+  return zfp_true;
+}
+
+/* public functions: compression and decompression --------------------------*/
+
+/* wait for host (de)compression started by zfp_(de)compress_async */
+static void
+wait_async(zfp_stream* zfp)
+{
+#ifdef ZFP_WITH_THREADS
+  if (zfp->exec.policy == zfp_exec_threads)
+    pool_join((pool*)zfp->exec.params.threads.pool);
+#else
+  (void)zfp;
+#endif
+}
+
+/* execution settings of stream overridden during one call */
+typedef struct {
+  zfp_exec_policy policy; /* execution policy */
+  uint threads;           /* requested OpenMP threads */
+} exec_settings;
+
+/* adapt execution to field, if requested, or run host policies serially,
+   and record execution in statistics */
+static exec_settings
+begin_execution(zfp_stream* zfp, const zfp_field* field, zfp_bool serial)
+{
+  exec_settings settings;
+  uint threads = 0;
+
+#ifndef _OPENMP
+  (void)field;
+#endif
+#if !defined(_OPENMP) && !defined(ZFP_WITH_THREADS) && !defined(ZFP_WITH_HYBRID)
+  (void)serial;
+#endif
+  settings.policy = zfp->exec.policy;
+  settings.threads = 0;
+  switch (zfp->exec.policy) {
+    case zfp_exec_serial:
+      threads = 1;
+      break;
+#ifdef _OPENMP
+    case zfp_exec_omp:
+      settings.threads = zfp->exec.params.omp.threads;
+      if (serial) {
+        zfp->exec.policy = zfp_exec_serial;
+        threads = 1;
+      }
+      else if (is_tasking_omp(zfp))
+        threads = (uint)omp_get_num_threads();
+      else if (!zfp->exec.params.omp.adaptive)
+        threads = thread_count_omp(zfp);
+      else {
+        /* fields too small to keep threads busy use fewer or none */
+        threads = adaptive_thread_count_omp(zfp, field_blocks(field), block_maximum_bits(zfp, field));
+        if (threads > 1)
+          zfp->exec.params.omp.threads = threads;
+        else
+          zfp->exec.policy = zfp_exec_serial;
+      }
+      break;
+#endif
+#ifdef ZFP_WITH_THREADS
+    case zfp_exec_threads:
+      if (serial) {
+        zfp->exec.policy = zfp_exec_serial;
+        threads = 1;
+      }
+      else
+        threads = thread_count_threads(zfp);
+      break;
+#endif
+#ifdef ZFP_WITH_HYBRID
+    case zfp_exec_hybrid:
+      if (serial) {
+        zfp->exec.policy = zfp_exec_serial;
+        threads = 1;
+      }
+      else
+        threads = thread_count_hybrid(zfp);
+      break;
+#endif
+    default:
+      break;
+  }
+
+  if (zfp->stats) {
+    zfp->stats->exec = zfp->exec.policy;
+    zfp->stats->exec_threads = threads;
+  }
+
+  return settings;
+}
+
+/* restore execution settings saved by begin_execution */
+static void
+end_execution(zfp_stream* zfp, exec_settings settings)
+{
+  if (settings.policy == zfp_exec_omp)
+    zfp->exec.params.omp.threads = settings.threads;
+  zfp->exec.policy = settings.policy;
+}
+
+/* compress field using current execution policy; return false if not supported */
+static zfp_bool
+compress_field_exec(zfp_stream* zfp, const zfp_field* field)
+{
+  /* function table [execution][strided][dimensionality][scalar type] */
+  void (*ftable[7][2][4][4])(zfp_stream*, const zfp_field*) = {
+    /* serial */
+    {{{ compress_int32_1,         compress_int64_1,         compress_float_1,         compress_double_1 },
+      { compress_int32_2,         compress_int64_2,         compress_float_2,         compress_double_2 },
+      { compress_int32_3,         compress_int64_3,         compress_float_3,         compress_double_3 },
+      { compress_int32_4,         compress_int64_4,         compress_float_4,         compress_double_4 }},
+     {{ compress_strided_int32_1, compress_strided_int64_1, compress_strided_float_1, compress_strided_double_1 },
+      { compress_strided_int32_2, compress_strided_int64_2, compress_strided_float_2, compress_strided_double_2 },
+      { compress_strided_int32_3, compress_strided_int64_3, compress_strided_float_3, compress_strided_double_3 },
+      { compress_strided_int32_4, compress_strided_int64_4, compress_strided_float_4, compress_strided_double_4 }}},
+
+    /* OpenMP */
+#ifdef _OPENMP
+    {{{ compress_omp_int32_1,         compress_omp_int64_1,         compress_omp_float_1,         compress_omp_double_1 },
+      { compress_strided_omp_int32_2, compress_strided_omp_int64_2, compress_strided_omp_float_2, compress_strided_omp_double_2 },
+      { compress_strided_omp_int32_3, compress_strided_omp_int64_3, compress_strided_omp_float_3, compress_strided_omp_double_3 },
+      { compress_strided_omp_int32_4, compress_strided_omp_int64_4, compress_strided_omp_float_4, compress_strided_omp_double_4 }},
+     {{ compress_strided_omp_int32_1, compress_strided_omp_int64_1, compress_strided_omp_float_1, compress_strided_omp_double_1 },
+      { compress_strided_omp_int32_2, compress_strided_omp_int64_2, compress_strided_omp_float_2, compress_strided_omp_double_2 },
+      { compress_strided_omp_int32_3, compress_strided_omp_int64_3, compress_strided_omp_float_3, compress_strided_omp_double_3 },
+      { compress_strided_omp_int32_4, compress_strided_omp_int64_4, compress_strided_omp_float_4, compress_strided_omp_double_4 }}},
+#else
+    {{{ NULL }}},
+#endif
+
+    /* CUDA */
+#ifdef ZFP_WITH_CUDA
+    {{{ compress_cuda_int32_1,         compress_cuda_int64_1,         compress_cuda_float_1,         compress_cuda_double_1 },
+      { compress_strided_cuda_int32_2, compress_strided_cuda_int64_2, compress_strided_cuda_float_2, compress_strided_cuda_double_2 },
+      { compress_strided_cuda_int32_3, compress_strided_cuda_int64_3, compress_strided_cuda_float_3, compress_strided_cuda_double_3 },
+      { compress_strided_cuda_int32_4, compress_strided_cuda_int64_4, compress_strided_cuda_float_4, compress_strided_cuda_double_4 }},
+     {{ compress_strided_cuda_int32_1, compress_strided_cuda_int64_1, compress_strided_cuda_float_1, compress_strided_cuda_double_1 },
+      { compress_strided_cuda_int32_2, compress_strided_cuda_int64_2, compress_strided_cuda_float_2, compress_strided_cuda_double_2 },
+      { compress_strided_cuda_int32_3, compress_strided_cuda_int64_3, compress_strided_cuda_float_3, compress_strided_cuda_double_3 },
+      { compress_strided_cuda_int32_4, compress_strided_cuda_int64_4, compress_strided_cuda_float_4, compress_strided_cuda_double_4 }}},
+#else
+    {{{ NULL }}},
+#endif
+    /* HIP */
+#ifdef ZFP_WITH_HIP
+    {{{ compress_hip_int32_1,         compress_hip_int64_1,         compress_hip_float_1,         compress_hip_double_1 },
       { compress_strided_hip_int32_2, compress_strided_hip_int64_2, compress_strided_hip_float_2, compress_strided_hip_double_2 },
       { compress_strided_hip_int32_3, compress_strided_hip_int64_3, compress_strided_hip_float_3, compress_strided_hip_double_3 },
-      { NULL,                            NULL,                            NULL,                            NULL }},
+      { compress_strided_hip_int32_4, compress_strided_hip_int64_4, compress_strided_hip_float_4, compress_strided_hip_double_4 }},
      {{ compress_strided_hip_int32_1, compress_strided_hip_int64_1, compress_strided_hip_float_1, compress_strided_hip_double_1 },
       { compress_strided_hip_int32_2, compress_strided_hip_int64_2, compress_strided_hip_float_2, compress_strided_hip_double_2 },
       { compress_strided_hip_int32_3, compress_strided_hip_int64_3, compress_strided_hip_float_3, compress_strided_hip_double_3 },
-      { NULL,                            NULL,                            NULL,                            NULL }}},
+      { compress_strided_hip_int32_4, compress_strided_hip_int64_4, compress_strided_hip_float_4, compress_strided_hip_double_4 }}},
+#else
+    {{{ NULL }}},
+#endif
+    /* thread pool */
+#ifdef ZFP_WITH_THREADS
+    {{{ compress_threads_int32_1, compress_threads_int64_1, compress_threads_float_1, compress_threads_double_1 },
+      { compress_threads_int32_2, compress_threads_int64_2, compress_threads_float_2, compress_threads_double_2 },
+      { compress_threads_int32_3, compress_threads_int64_3, compress_threads_float_3, compress_threads_double_3 },
+      { compress_threads_int32_4, compress_threads_int64_4, compress_threads_float_4, compress_threads_double_4 }},
+     {{ compress_threads_int32_1, compress_threads_int64_1, compress_threads_float_1, compress_threads_double_1 },
+      { compress_threads_int32_2, compress_threads_int64_2, compress_threads_float_2, compress_threads_double_2 },
+      { compress_threads_int32_3, compress_threads_int64_3, compress_threads_float_3, compress_threads_double_3 },
+      { compress_threads_int32_4, compress_threads_int64_4, compress_threads_float_4, compress_threads_double_4 }}},
+#else
+    {{{ NULL }}},
+#endif
+    /* OpenMP target offload */
+#ifdef ZFP_WITH_OMP_TARGET
+    {{{ compress_omp_target_int32_1,         compress_omp_target_int64_1,         compress_omp_target_float_1,         compress_omp_target_double_1 },
+      { compress_strided_omp_target_int32_2, compress_strided_omp_target_int64_2, compress_strided_omp_target_float_2, compress_strided_omp_target_double_2 },
+      { compress_strided_omp_target_int32_3, compress_strided_omp_target_int64_3, compress_strided_omp_target_float_3, compress_strided_omp_target_double_3 },
+      { NULL, NULL, NULL, NULL }},
+     {{ compress_strided_omp_target_int32_1, compress_strided_omp_target_int64_1, compress_strided_omp_target_float_1, compress_strided_omp_target_double_1 },
+      { compress_strided_omp_target_int32_2, compress_strided_omp_target_int64_2, compress_strided_omp_target_float_2, compress_strided_omp_target_double_2 },
+      { compress_strided_omp_target_int32_3, compress_strided_omp_target_int64_3, compress_strided_omp_target_float_3, compress_strided_omp_target_double_3 },
+      { NULL, NULL, NULL, NULL }}},
+#else
+    {{{ NULL }}},
+#endif
+    /* SYCL */
+#ifdef ZFP_WITH_SYCL
+    {{{ compress_sycl_int32_1,         compress_sycl_int64_1,         compress_sycl_float_1,         compress_sycl_double_1 },
+      { compress_strided_sycl_int32_2, compress_strided_sycl_int64_2, compress_strided_sycl_float_2, compress_strided_sycl_double_2 },
+      { compress_strided_sycl_int32_3, compress_strided_sycl_int64_3, compress_strided_sycl_float_3, compress_strided_sycl_double_3 },
+      { compress_strided_sycl_int32_4, compress_strided_sycl_int64_4, compress_strided_sycl_float_4, compress_strided_sycl_double_4 }},
+     {{ compress_strided_sycl_int32_1, compress_strided_sycl_int64_1, compress_strided_sycl_float_1, compress_strided_sycl_double_1 },
+      { compress_strided_sycl_int32_2, compress_strided_sycl_int64_2, compress_strided_sycl_float_2, compress_strided_sycl_double_2 },
+      { compress_strided_sycl_int32_3, compress_strided_sycl_int64_3, compress_strided_sycl_float_3, compress_strided_sycl_double_3 },
+      { compress_strided_sycl_int32_4, compress_strided_sycl_int64_4, compress_strided_sycl_float_4, compress_strided_sycl_double_4 }}},
+#else
+    {{{ NULL }}},
+#endif
+  };
+  uint exec = zfp->exec.policy;
+  uint strided = !is_row_major(field);
+  uint dims = zfp_field_dimensionality(field);
+  uint type = field->type;
+  void (*compress)(zfp_stream*, const zfp_field*);
+
+  if (!is_verify_supported(zfp, field))
+    return zfp_false;
+
+  /* masked fields are (de)compressed one block at a time */
+  if (is_masked(field))
+    return is_maskable(zfp, field, codec_type(field->type)) && (!zfp->map || is_mappable(zfp)) && !zfp->relative && compress_field_converted(zfp, field, codec_type(field->type));
+
+  /* so are fields whose blocks are coarsened by a block map or whose
+     precision is chosen per block in relative accuracy mode */
+  if (zfp->map || zfp->relative)
+    return is_mappable(zfp) && (!zfp->relative || is_relative(zfp, codec_type(field->type))) && compress_field_converted(zfp, field, codec_type(field->type));
+
+  switch (type) {
+    case zfp_type_int32:
+    case zfp_type_int64:
+    case zfp_type_float:
+    case zfp_type_double:
+      break;
+    case zfp_type_half:
+    case zfp_type_bfloat16:
+    case zfp_type_int8:
+    case zfp_type_uint8:
+    case zfp_type_int16:
+    case zfp_type_uint16:
+      return compress_field_converted(zfp, field, codec_type((zfp_type)type));
+    default:
+      return zfp_false;
+  }
+
+  /* return false if compression mode is not supported */
+  if (!is_raw_supported(zfp))
+    return zfp_false;
+#ifdef ZFP_WITH_HYBRID
+  if (exec == zfp_exec_hybrid)
+    return hybrid_exec(zfp, field, zfp_true);
+#endif
+  compress = ftable[exec][strided][dims - 1][type - zfp_type_int32];
+  if (!compress)
+    return zfp_false;
+
+  zfp_trace_begin("zfp:compress");
+  compress(zfp, field);
+  zfp_trace_end();
+  return zfp_true;
+}
+
+/* compress field without aligning bit stream; return false if not supported */
+static zfp_bool
+compress_field(zfp_stream* zfp, const zfp_field* field)
+{
+  /* blocks are verified one at a time by a single thread */
+  exec_settings settings = begin_execution(zfp, field, zfp->verify != NULL);
+  zfp_bool success = compress_field_exec(zfp, field);
+  end_execution(zfp, settings);
+  return success;
+}
+
+size_t
+zfp_compress(zfp_stream* zfp, const zfp_field* field)
+{
+  wait_async(zfp);
+
+  /* invalidate any stale chunk index; parallel compressors repopulate it */
+  if (zfp->index)
+    zfp->index->chunks = 0;
+
+  /* compress field and align bit stream on word boundary */
+  if (!compress_field(zfp, field))
+    return 0;
+  stream_flush(zfp->stream);
+
+  return stream_size(zfp->stream);
+}
+
+size_t
+zfp_compress_as(zfp_stream* zfp, const zfp_field* field, zfp_type type)
+{
+  zfp_bool success;
+
+  if (!zfp_field_dimensionality(field) || !is_convertible(field->type, type))
+    return 0;
+  if (is_masked(field) && !is_maskable(zfp, field, type))
+    return 0;
+  if (zfp->map && !is_mappable(zfp))
+    return 0;
+  if (zfp->relative && (is_masked(field) || !is_relative(zfp, type)))
+    return 0;
+
+  /* fields of the stream type need no conversion */
+  if (field->type == type)
+    return zfp_compress(zfp, field);
+
+  if (zfp->index)
+    zfp->index->chunks = 0;
+
+  zfp_trace_begin("zfp:compress");
+  success = compress_field_converted(zfp, field, type);
+  zfp_trace_end();
+  if (!success)
+    return 0;
+  stream_flush(zfp->stream);
+
+  return stream_size(zfp->stream);
+}
+
+size_t
+zfp_compress_subset(zfp_stream* zfp, const zfp_field* field, size_t x0, size_t y0, size_t z0, size_t nx, size_t ny, size_t nz)
+{
+  /* function table [scalar type] */
+  void (*ftable[4])(zfp_stream*, const zfp_field*, size_t, size_t, size_t, size_t, size_t, size_t) = {
+    compress_subset_int32,
+    compress_subset_int64,
+    compress_subset_float,
+    compress_subset_double,
+  };
+  uint dims = zfp_field_dimensionality(field);
+  size_t base;
+
+  /* blocks can be overwritten in place only if they are of fixed size */
+  if (dims < 1 || dims > 3 || !is_plain_field(field) || zfp->minbits != zfp->maxbits)
+    return 0;
+
+  /* ignore unused dimensions */
+  if (dims < 3) {
+    z0 = 0;
+    nz = 1;
+  }
+  if (dims < 2) {
+    y0 = 0;
+    ny = 1;
+  }
+
+  /* make sure box is nonempty and lies within field */
+  if (!nx || x0 + nx > MAX(field->nx, 1u) ||
+      !ny || y0 + ny > MAX(field->ny, 1u) ||
+      !nz || z0 + nz > MAX(field->nz, 1u))
+    return 0;
+
+  /* recompress intersecting blocks and position stream at end of field */
+  base = stream_wtell(zfp->stream);
+  ftable[field->type - zfp_type_int32](zfp, field, x0, y0, z0, nx, ny, nz);
+  stream_wseek(zfp->stream, base + field_blocks(field) * zfp->maxbits);
+  stream_flush(zfp->stream);
+
+  return stream_size(zfp->stream);
+}
+
+size_t
+zfp_compress_interleaved(zfp_stream* zfp, const zfp_field* field, uint components)
+{
+  /* function table [scalar type] */
+  void (*ftable[4])(zfp_stream*, const zfp_field*, uint) = {
+    compress_interleaved_int32,
+    compress_interleaved_int64,
+    compress_interleaved_float,
+    compress_interleaved_double,
+  };
+  zfp_field f;
+
+  if (!interleaved_field(&f, field, components))
+    return 0;
+
+  /* chunk index cannot describe interleaved blocks */
+  if (zfp->index)
+    zfp->index->chunks = 0;
+
+  zfp_trace_begin("zfp:compress");
+  ftable[f.type - zfp_type_int32](zfp, &f, components);
+  zfp_trace_end();
+  stream_flush(zfp->stream);
+
+  return stream_size(zfp->stream);
+}
+
+void
+zfp_compress_begin(zfp_stream* zfp)
+{
+  /* chunk index cannot describe a stream assembled from slabs */
+  if (zfp->index)
+    zfp->index->chunks = 0;
+}
+
+zfp_bool
+zfp_compress_slab(zfp_stream* zfp, const zfp_field* slab)
+{
+  zfp_bool success;
+
+  /* slabs are appended at arbitrary bit offsets, which only host code supports */
+  switch (zfp->exec.policy) {
+    case zfp_exec_serial:
+    case zfp_exec_omp:
+    case zfp_exec_threads:
+      break;
+    default:
+      return zfp_false;
+  }
+  if (zfp_field_dimensionality(slab) != 3)
+    return zfp_false;
+
+  /* blocks of slab immediately follow those of previous slab */
+  success = compress_field(zfp, slab);
+  if (zfp->index)
+    zfp->index->chunks = 0;
+
+  return success;
+}
+
+size_t
+zfp_compress_end(zfp_stream* zfp)
+{
+  /* align bit stream on word boundary */
+  stream_flush(zfp->stream);
+
+  return stream_size(zfp->stream);
+}
+
+size_t
+zfp_compress_inplace(zfp_stream* zfp, const zfp_field* field)
+{
+  return inplace_compress(zfp, field);
+}
+
+/* decompress field using current execution policy; return false if not supported */
+static zfp_bool
+decompress_field_exec(zfp_stream* zfp, zfp_field* field)
+{
+  /* function table [execution][strided][dimensionality][scalar type] */
+  void (*ftable[7][2][4][4])(zfp_stream*, zfp_field*) = {
+    /* serial */
+    {{{ decompress_int32_1,         decompress_int64_1,         decompress_float_1,         decompress_double_1 },
+      { decompress_int32_2,         decompress_int64_2,         decompress_float_2,         decompress_double_2 },
+      { decompress_int32_3,         decompress_int64_3,         decompress_float_3,         decompress_double_3 },
+      { decompress_int32_4,         decompress_int64_4,         decompress_float_4,         decompress_double_4 }},
+     {{ decompress_strided_int32_1, decompress_strided_int64_1, decompress_strided_float_1, decompress_strided_double_1 },
+      { decompress_strided_int32_2, decompress_strided_int64_2, decompress_strided_float_2, decompress_strided_double_2 },
+      { decompress_strided_int32_3, decompress_strided_int64_3, decompress_strided_float_3, decompress_strided_double_3 },
+      { decompress_strided_int32_4, decompress_strided_int64_4, decompress_strided_float_4, decompress_strided_double_4 }}},
+
+    /* OpenMP */
+#ifdef _OPENMP
+    {{{ decompress_omp_int32_1,         decompress_omp_int64_1,         decompress_omp_float_1,         decompress_omp_double_1 },
+      { decompress_strided_omp_int32_2, decompress_strided_omp_int64_2, decompress_strided_omp_float_2, decompress_strided_omp_double_2 },
+      { decompress_strided_omp_int32_3, decompress_strided_omp_int64_3, decompress_strided_omp_float_3, decompress_strided_omp_double_3 },
+      { decompress_strided_omp_int32_4, decompress_strided_omp_int64_4, decompress_strided_omp_float_4, decompress_strided_omp_double_4 }},
+     {{ decompress_strided_omp_int32_1, decompress_strided_omp_int64_1, decompress_strided_omp_float_1, decompress_strided_omp_double_1 },
+      { decompress_strided_omp_int32_2, decompress_strided_omp_int64_2, decompress_strided_omp_float_2, decompress_strided_omp_double_2 },
+      { decompress_strided_omp_int32_3, decompress_strided_omp_int64_3, decompress_strided_omp_float_3, decompress_strided_omp_double_3 },
+      { decompress_strided_omp_int32_4, decompress_strided_omp_int64_4, decompress_strided_omp_float_4, decompress_strided_omp_double_4 }}},
+#else
+    {{{ NULL }}},
+#endif
+
+    /* CUDA */
+#ifdef ZFP_WITH_CUDA
+    {{{ decompress_cuda_int32_1,         decompress_cuda_int64_1,         decompress_cuda_float_1,         decompress_cuda_double_1 },
+      { decompress_strided_cuda_int32_2, decompress_strided_cuda_int64_2, decompress_strided_cuda_float_2, decompress_strided_cuda_double_2 },
+      { decompress_strided_cuda_int32_3, decompress_strided_cuda_int64_3, decompress_strided_cuda_float_3, decompress_strided_cuda_double_3 },
+      { decompress_strided_cuda_int32_4, decompress_strided_cuda_int64_4, decompress_strided_cuda_float_4, decompress_strided_cuda_double_4 }},
+     {{ decompress_strided_cuda_int32_1, decompress_strided_cuda_int64_1, decompress_strided_cuda_float_1, decompress_strided_cuda_double_1 },
+      { decompress_strided_cuda_int32_2, decompress_strided_cuda_int64_2, decompress_strided_cuda_float_2, decompress_strided_cuda_double_2 },
+      { decompress_strided_cuda_int32_3, decompress_strided_cuda_int64_3, decompress_strided_cuda_float_3, decompress_strided_cuda_double_3 },
+      { decompress_strided_cuda_int32_4, decompress_strided_cuda_int64_4, decompress_strided_cuda_float_4, decompress_strided_cuda_double_4 }}},
+#else
+    {{{ NULL }}},
+#endif
+
+#ifdef ZFP_WITH_HIP
+    {{{ decompress_hip_int32_1,         decompress_hip_int64_1,         decompress_hip_float_1,         decompress_hip_double_1 },
+      { decompress_strided_hip_int32_2, decompress_strided_hip_int64_2, decompress_strided_hip_float_2, decompress_strided_hip_double_2 },
+      { decompress_strided_hip_int32_3, decompress_strided_hip_int64_3, decompress_strided_hip_float_3, decompress_strided_hip_double_3 },
+      { decompress_strided_hip_int32_4, decompress_strided_hip_int64_4, decompress_strided_hip_float_4, decompress_strided_hip_double_4 }},
+     {{ decompress_strided_hip_int32_1, decompress_strided_hip_int64_1, decompress_strided_hip_float_1, decompress_strided_hip_double_1 },
+      { decompress_strided_hip_int32_2, decompress_strided_hip_int64_2, decompress_strided_hip_float_2, decompress_strided_hip_double_2 },
+      { decompress_strided_hip_int32_3, decompress_strided_hip_int64_3, decompress_strided_hip_float_3, decompress_strided_hip_double_3 },
+      { decompress_strided_hip_int32_4, decompress_strided_hip_int64_4, decompress_strided_hip_float_4, decompress_strided_hip_double_4 }}},
+#else
+    {{{ NULL }}},
+#endif
+    /* thread pool */
+#ifdef ZFP_WITH_THREADS
+    {{{ decompress_threads_int32_1, decompress_threads_int64_1, decompress_threads_float_1, decompress_threads_double_1 },
+      { decompress_threads_int32_2, decompress_threads_int64_2, decompress_threads_float_2, decompress_threads_double_2 },
+      { decompress_threads_int32_3, decompress_threads_int64_3, decompress_threads_float_3, decompress_threads_double_3 },
+      { decompress_threads_int32_4, decompress_threads_int64_4, decompress_threads_float_4, decompress_threads_double_4 }},
+     {{ decompress_threads_int32_1, decompress_threads_int64_1, decompress_threads_float_1, decompress_threads_double_1 },
+      { decompress_threads_int32_2, decompress_threads_int64_2, decompress_threads_float_2, decompress_threads_double_2 },
+      { decompress_threads_int32_3, decompress_threads_int64_3, decompress_threads_float_3, decompress_threads_double_3 },
+      { decompress_threads_int32_4, decompress_threads_int64_4, decompress_threads_float_4, decompress_threads_double_4 }}},
+#else
+    {{{ NULL }}},
+#endif
+    /* OpenMP target offload */
+#ifdef ZFP_WITH_OMP_TARGET
+    {{{ decompress_omp_target_int32_1,         decompress_omp_target_int64_1,         decompress_omp_target_float_1,         decompress_omp_target_double_1 },
+      { decompress_strided_omp_target_int32_2, decompress_strided_omp_target_int64_2, decompress_strided_omp_target_float_2, decompress_strided_omp_target_double_2 },
+      { decompress_strided_omp_target_int32_3, decompress_strided_omp_target_int64_3, decompress_strided_omp_target_float_3, decompress_strided_omp_target_double_3 },
+      { NULL, NULL, NULL, NULL }},
+     {{ decompress_strided_omp_target_int32_1, decompress_strided_omp_target_int64_1, decompress_strided_omp_target_float_1, decompress_strided_omp_target_double_1 },
+      { decompress_strided_omp_target_int32_2, decompress_strided_omp_target_int64_2, decompress_strided_omp_target_float_2, decompress_strided_omp_target_double_2 },
+      { decompress_strided_omp_target_int32_3, decompress_strided_omp_target_int64_3, decompress_strided_omp_target_float_3, decompress_strided_omp_target_double_3 },
+      { NULL, NULL, NULL, NULL }}},
+#else
+    {{{ NULL }}},
+#endif
+    /* SYCL */
+#ifdef ZFP_WITH_SYCL
+    {{{ decompress_sycl_int32_1,         decompress_sycl_int64_1,         decompress_sycl_float_1,         decompress_sycl_double_1 },
+      { decompress_strided_sycl_int32_2, decompress_strided_sycl_int64_2, decompress_strided_sycl_float_2, decompress_strided_sycl_double_2 },
+      { decompress_strided_sycl_int32_3, decompress_strided_sycl_int64_3, decompress_strided_sycl_float_3, decompress_strided_sycl_double_3 },
+      { decompress_strided_sycl_int32_4, decompress_strided_sycl_int64_4, decompress_strided_sycl_float_4, decompress_strided_sycl_double_4 }},
+     {{ decompress_strided_sycl_int32_1, decompress_strided_sycl_int64_1, decompress_strided_sycl_float_1, decompress_strided_sycl_double_1 },
+      { decompress_strided_sycl_int32_2, decompress_strided_sycl_int64_2, decompress_strided_sycl_float_2, decompress_strided_sycl_double_2 },
+      { decompress_strided_sycl_int32_3, decompress_strided_sycl_int64_3, decompress_strided_sycl_float_3, decompress_strided_sycl_double_3 },
+      { decompress_strided_sycl_int32_4, decompress_strided_sycl_int64_4, decompress_strided_sycl_float_4, decompress_strided_sycl_double_4 }}},
+#else
+    {{{ NULL }}},
+#endif
+  };
+  uint exec = zfp->exec.policy;
+  uint strided = !is_row_major(field);
+  uint dims = zfp_field_dimensionality(field);
+  uint type = field->type;
+  void (*decompress)(zfp_stream*, zfp_field*);
+
+  /* masked fields are (de)compressed one block at a time */
+  if (is_masked(field))
+    return is_maskable(zfp, field, codec_type(field->type)) && (!zfp->map || is_mappable(zfp)) && !zfp->relative && decompress_field_converted(zfp, field, codec_type(field->type));
+
+  /* so are fields whose blocks are coarsened by a block map or whose
+     precision is chosen per block in relative accuracy mode */
+  if (zfp->map || zfp->relative)
+    return is_mappable(zfp) && (!zfp->relative || is_relative(zfp, codec_type(field->type))) && decompress_field_converted(zfp, field, codec_type(field->type));
+
+  switch (type) {
+    case zfp_type_int32:
+    case zfp_type_int64:
+    case zfp_type_float:
+    case zfp_type_double:
+      break;
+    case zfp_type_half:
+    case zfp_type_bfloat16:
+    case zfp_type_int8:
+    case zfp_type_uint8:
+    case zfp_type_int16:
+    case zfp_type_uint16:
+      return decompress_field_converted(zfp, field, codec_type((zfp_type)type));
+    default:
+      return zfp_false;
+  }
+
+  /* return false if decompression mode is not supported */
+  if (!is_raw_supported(zfp))
+    return zfp_false;
+#ifdef ZFP_WITH_HYBRID
+  if (exec == zfp_exec_hybrid)
+    return hybrid_exec(zfp, field, zfp_false);
+#endif
+  decompress = ftable[exec][strided][dims - 1][type - zfp_type_int32];
+  if (!decompress)
+    return zfp_false;
+
+  zfp_trace_begin("zfp:decompress");
+  decompress(zfp, field);
+  zfp_trace_end();
+  return zfp_true;
+}
+
+/* decompress field without aligning bit stream; return false if not supported */
+static zfp_bool
+decompress_field(zfp_stream* zfp, zfp_field* field)
+{
+  exec_settings settings = begin_execution(zfp, field, zfp_false);
+  zfp_bool success = decompress_field_exec(zfp, field);
+  end_execution(zfp, settings);
+  return success;
+}
+
+size_t
+zfp_decompress(zfp_stream* zfp, zfp_field* field)
+{
+  wait_async(zfp);
+
+  /* decompress field and align bit stream on word boundary */
+  if (!decompress_field(zfp, field))
+    return 0;
+  stream_align(zfp->stream);
+
+  return stream_size(zfp->stream);
+}
+
+size_t
+zfp_decompress_as(zfp_stream* zfp, zfp_field* field, zfp_type type)
+{
+  zfp_bool success;
+
+  if (!zfp_field_dimensionality(field) || !is_convertible(field->type, type))
+    return 0;
+  if (is_masked(field) && !is_maskable(zfp, field, type))
+    return 0;
+  if (zfp->map && !is_mappable(zfp))
+    return 0;
+  if (zfp->relative && (is_masked(field) || !is_relative(zfp, type)))
+    return 0;
+
+  /* fields of the stream type need no conversion */
+  if (field->type == type)
+    return zfp_decompress(zfp, field);
+
+  zfp_trace_begin("zfp:decompress");
+  success = decompress_field_converted(zfp, field, type);
+  zfp_trace_end();
+  if (!success)
+    return 0;
+  stream_align(zfp->stream);
+
+  return stream_size(zfp->stream);
+}
+
+size_t
+zfp_decompress_interleaved(zfp_stream* zfp, zfp_field* field, uint components)
+{
+  /* function table [scalar type] */
+  void (*ftable[4])(zfp_stream*, zfp_field*, uint) = {
+    decompress_interleaved_int32,
+    decompress_interleaved_int64,
+    decompress_interleaved_float,
+    decompress_interleaved_double,
+  };
+  zfp_field f;
+
+  if (!interleaved_field(&f, field, components))
+    return 0;
+
+  zfp_trace_begin("zfp:decompress");
+  ftable[f.type - zfp_type_int32](zfp, &f, components);
+  zfp_trace_end();
+  stream_align(zfp->stream);
+
+  return stream_size(zfp->stream);
+}
+
+size_t
+zfp_decompress_lod(zfp_stream* zfp, zfp_field* field, uint level)
+{
+  /* function table [scalar type] */
+  void (*ftable[4])(zfp_stream*, zfp_field*, uint) = {
+    decompress_lod_int32,
+    decompress_lod_int64,
+    decompress_lod_float,
+    decompress_lod_double,
+  };
+
+  /* averages are obtained from the non-reversible transform only */
+  if (level > 2 || zfp_stream_compression_mode(zfp) == zfp_mode_reversible || zfp->raw || !is_plain_field(field) || !zfp_field_dimensionality(field))
+    return 0;
+
+  /* decompress averages and align bit stream on word boundary */
+  ftable[field->type - zfp_type_int32](zfp, field, level);
+  stream_align(zfp->stream);
+
+  return stream_size(zfp->stream);
+}
+
+/* decode listed blocks on device; false if policy or field is unsupported */
+static zfp_bool
+decompress_blocks_device(zfp_stream* zfp, zfp_field* field, const size_t* index, size_t count, const size_t* box, void* bricks)
+{
+  switch (zfp->exec.policy) {
+#ifdef ZFP_WITH_CUDA
+    case zfp_exec_cuda:
+      return cuda_decompress_blocks(zfp, field, index, count, box, bricks);
+#endif
+#ifdef ZFP_WITH_HIP
+    case zfp_exec_hip:
+      return hip_decompress_blocks(zfp, field, index, count, box, bricks);
+#endif
+    default:
+      (void)field;
+      (void)index;
+      (void)count;
+      (void)box;
+      (void)bricks;
+      return zfp_false;
+  }
+}
+
+size_t
+zfp_decompress_subset(zfp_stream* zfp, zfp_field* field, size_t x0, size_t y0, size_t z0, size_t nx, size_t ny, size_t nz)
+{
+  /* function table [scalar type] */
+  void (*ftable[4])(zfp_stream*, zfp_field*, size_t, size_t, size_t, size_t, size_t, size_t) = {
+    decompress_subset_int32,
+    decompress_subset_int64,
+    decompress_subset_float,
+    decompress_subset_double,
+  };
+  uint dims = zfp_field_dimensionality(field);
+  size_t blocks = field_blocks(field);
+  zfp_index* index = zfp->index;
+  uint64 bits;
+  size_t base;
+
+  if (dims < 1 || dims > 3 || !is_plain_field(field))
+    return 0;
+
+  /* ignore unused dimensions */
+  if (dims < 3) {
+    z0 = 0;
+    nz = 1;
+  }
+  if (dims < 2) {
+    y0 = 0;
+    ny = 1;
+  }
+
+  /* make sure box is nonempty and lies within field */
+  if (!nx || x0 + nx > MAX(field->nx, 1u) ||
+      !ny || y0 + ny > MAX(field->ny, 1u) ||
+      !nz || z0 + nz > MAX(field->nz, 1u))
+    return 0;
+
+  /* blocks are located by rate or by chunk index */
+  if (zfp->minbits == zfp->maxbits)
+    bits = (uint64)blocks * zfp->maxbits;
+  else if (index && index->chunks && index->chunks <= blocks)
+    bits = index->offset[index->chunks];
+  else
+    return 0;
+
+  /* device policies launch threads only for intersecting blocks */
+  if (zfp->exec.policy == zfp_exec_cuda || zfp->exec.policy == zfp_exec_hip) {
+    size_t bx = (MAX(field->nx, 1u) + 3) / 4;
+    size_t by = (MAX(field->ny, 1u) + 3) / 4;
+    size_t count = ((x0 + nx + 3) / 4 - x0 / 4) * ((y0 + ny + 3) / 4 - y0 / 4) * ((z0 + nz + 3) / 4 - z0 / 4);
+    size_t* list = (size_t*)malloc(count * sizeof(size_t));
+    if (list) {
+      size_t box[6];
+      size_t i, j, k, n = 0;
+      zfp_bool success;
+      for (k = z0 / 4; k <= (z0 + nz - 1) / 4; k++)
+        for (j = y0 / 4; j <= (y0 + ny - 1) / 4; j++)
+          for (i = x0 / 4; i <= (x0 + nx - 1) / 4; i++)
+            list[n++] = i + bx * (j + by * k);
+      box[0] = x0; box[1] = y0; box[2] = z0;
+      box[3] = nx; box[4] = ny; box[5] = nz;
+      success = decompress_blocks_device(zfp, field, list, count, box, NULL);
+      free(list);
+      if (success) {
+        stream_align(zfp->stream);
+        return stream_size(zfp->stream);
+      }
+    }
+  }
+
+  /* decompress intersecting blocks and position stream at end of field */
+  base = stream_rtell(zfp->stream);
+  ftable[field->type - zfp_type_int32](zfp, field, x0, y0, z0, nx, ny, nz);
+  stream_rseek(zfp->stream, base + (size_t)bits);
+  stream_align(zfp->stream);
+
+  return stream_size(zfp->stream);
+}
+
+size_t
+zfp_decompress_blocks(zfp_stream* zfp, zfp_field* field, const size_t* index, size_t count, void* bricks)
+{
+  /* function table [scalar type] */
+  void (*ftable[4])(zfp_stream*, zfp_field*, const size_t*, size_t, void*) = {
+    decompress_blocks_int32,
+    decompress_blocks_int64,
+    decompress_blocks_float,
+    decompress_blocks_double,
+  };
+  uint dims = zfp_field_dimensionality(field);
+  size_t blocks = field_blocks(field);
+  uint64 bits;
+  size_t base;
+  size_t n;
+
+  if (dims < 1 || dims > 3 || !is_plain_field(field) || !count)
+    return 0;
+
+  /* make sure all listed blocks lie within field */
+  for (n = 0; n < count; n++)
+    if (index[n] >= blocks)
+      return 0;
+
+  /* blocks are located by rate or by chunk index */
+  if (zfp->minbits == zfp->maxbits)
+    bits = (uint64)blocks * zfp->maxbits;
+  else if (zfp->index && zfp->index->chunks && zfp->index->chunks <= blocks)
+    bits = zfp->index->offset[zfp->index->chunks];
+  else
+    return 0;
+
+  /* device policies launch threads only for listed blocks */
+  if (zfp->exec.policy == zfp_exec_cuda || zfp->exec.policy == zfp_exec_hip) {
+    size_t box[6];
+    box[0] = box[1] = box[2] = 0;
+    box[3] = MAX(field->nx, 1u);
+    box[4] = MAX(field->ny, 1u);
+    box[5] = MAX(field->nz, 1u);
+    if (decompress_blocks_device(zfp, field, index, count, box, bricks)) {
+      stream_align(zfp->stream);
+      return stream_size(zfp->stream);
+    }
+  }
+
+  /* decompress listed blocks and position stream at end of field */
+  base = stream_rtell(zfp->stream);
+  ftable[field->type - zfp_type_int32](zfp, field, index, count, bricks);
+  stream_rseek(zfp->stream, base + (size_t)bits);
+  stream_align(zfp->stream);
+
+  return stream_size(zfp->stream);
+}
+
+size_t
+zfp_reduce(zfp_stream* zfp, const zfp_field* field, zfp_reduce_op op, double* result)
+{
+  /* function tables [scalar type] */
+  void (*ftable[4])(zfp_stream*, const zfp_field*, zfp_reduce_op, size_t, size_t, reduction*) = {
+    reduce_blocks_int32,
+    reduce_blocks_int64,
+    reduce_blocks_float,
+    reduce_blocks_double,
+  };
+#ifdef _OPENMP
+  void (*otable[4])(zfp_stream*, const zfp_field*, zfp_reduce_op, reduction*) = {
+    reduce_omp_int32,
+    reduce_omp_int64,
+    reduce_omp_float,
+    reduce_omp_double,
+  };
+#endif
+  reduction acc;
+
+  if (!is_plain_field(field) || !zfp_field_dimensionality(field))
+    return 0;
+
+  switch (op) {
+    case zfp_reduce_sum:
+    case zfp_reduce_mean:
+    case zfp_reduce_min:
+    case zfp_reduce_max:
+    case zfp_reduce_l2:
+      break;
+    default:
+      return 0;
+  }
+
+  /* decode and accumulate one block at a time; other policies run serially */
+  reduction_init(&acc);
+  zfp_trace_begin("zfp:reduce");
+#ifdef _OPENMP
+  if (zfp->exec.policy == zfp_exec_omp)
+    otable[field->type - zfp_type_int32](zfp, field, op, &acc);
+  else
+#endif
+    ftable[field->type - zfp_type_int32](zfp, field, op, 0, field_blocks(field), &acc);
+  zfp_trace_end();
+  stream_align(zfp->stream);
+
+  switch (op) {
+    case zfp_reduce_sum:
+      *result = acc.sum;
+      break;
+    case zfp_reduce_mean:
+      *result = acc.sum / (double)acc.count;
+      break;
+    case zfp_reduce_min:
+      *result = acc.min;
+      break;
+    case zfp_reduce_max:
+      *result = acc.max;
+      break;
+    case zfp_reduce_l2:
+      *result = sqrt(acc.sum);
+      break;
+  }
+
+  return stream_size(zfp->stream);
+}
+
+zfp_bool
+zfp_dot(zfp_stream* a, zfp_stream* b, const zfp_field* field, double* result)
+{
+  /* function tables [scalar type] */
+  double (*ftable[4])(zfp_stream*, zfp_stream*, const zfp_field*, size_t, size_t) = {
+    dot_blocks_int32,
+    dot_blocks_int64,
+    dot_blocks_float,
+    dot_blocks_double,
+  };
+#ifdef _OPENMP
+  double (*otable[4])(zfp_stream*, zfp_stream*, const zfp_field*) = {
+    dot_omp_int32,
+    dot_omp_int64,
+    dot_omp_float,
+    dot_omp_double,
+  };
+#endif
+
+  if (!is_plain_field(field) || !zfp_field_dimensionality(field))
+    return zfp_false;
+
+  /* decode blocks of both streams in lockstep */
+  zfp_trace_begin("zfp:dot");
+#ifdef _OPENMP
+  if (a->exec.policy == zfp_exec_omp)
+    *result = otable[field->type - zfp_type_int32](a, b, field);
+  else
+#endif
+    *result = ftable[field->type - zfp_type_int32](a, b, field, 0, field_blocks(field));
+  zfp_trace_end();
+  stream_align(a->stream);
+  stream_align(b->stream);
+
+  return zfp_true;
+}
+
+uint
+zfp_encode_block_at(zfp_stream* zfp, const zfp_field* field, size_t block, const void* data)
+{
+  /* function table [scalar type] */
+  uint (*ftable[4])(zfp_stream*, uint, const void*) = {
+    encode_field_block_int32,
+    encode_field_block_int64,
+    encode_field_block_float,
+    encode_field_block_double,
+  };
+  uint dims = zfp_field_dimensionality(field);
+  size_t base = stream_wtell(zfp->stream);
+  uint bits;
+
+  if (!dims || !is_plain_field(field) || block >= field_blocks(field))
+    return 0;
+
+  /* blocks must be of fixed size and begin on word boundaries */
+  if (zfp->minbits != zfp->maxbits || zfp->maxbits % stream_word_bits || base % stream_word_bits)
+    return 0;
+
+  /* overwrite block in place and restore stream position */
+  stream_wseek(zfp->stream, base + block * zfp->maxbits);
+  bits = ftable[field->type - zfp_type_int32](zfp, dims, data);
+  stream_wseek(zfp->stream, base);
+
+  return bits;
+}
+
+uint
+zfp_decode_block_at(zfp_stream* zfp, const zfp_field* field, size_t block, void* data)
+{
+  /* function table [scalar type] */
+  uint (*ftable[4])(zfp_stream*, uint, void*) = {
+    decode_field_block_int32,
+    decode_field_block_int64,
+    decode_field_block_float,
+    decode_field_block_double,
+  };
+  uint dims = zfp_field_dimensionality(field);
+  size_t blocks = field_blocks(field);
+  zfp_index* index = zfp->index;
+  size_t base = stream_rtell(zfp->stream);
+  size_t first;
+  uint64 offset;
+  uint bits = 0;
+
+  if (!dims || !is_plain_field(field) || block >= blocks)
+    return 0;
+
+  /* blocks are located by rate or by chunk index */
+  if (zfp->minbits != zfp->maxbits && !(index && index->chunks && index->chunks <= blocks))
+    return 0;
+
+  /* decode block, and any preceding blocks in its chunk into the same */
+  /* memory, then restore stream position */
+  first = locate_block(zfp, blocks, block, &offset);
+  stream_rseek(zfp->stream, base + (size_t)offset);
+  for (; first <= block; first++)
+    bits = ftable[field->type - zfp_type_int32](zfp, dims, data);
+  stream_rseek(zfp->stream, base);
+
+  return bits;
+}
+
+zfp_bool
+zfp_sample(zfp_stream* zfp, const zfp_field* field, const double* points, size_t n, void* values, zfp_bool interpolate)
+{
+  /* function tables [scalar type] */
+  void (*sample[4])(zfp_stream*, const zfp_field*, const sample_tap*, size_t, size_t, void*) = {
+    sample_blocks_int32,
+    sample_blocks_int64,
+    sample_blocks_float,
+    sample_blocks_double,
+  };
+  void (*combine[4])(void*, const void*, const double*, size_t, uint) = {
+    sample_combine_int32,
+    sample_combine_int64,
+    sample_combine_float,
+    sample_combine_double,
+  };
+  uint dims = zfp_field_dimensionality(field);
+  size_t blocks = field_blocks(field);
+  zfp_index* index = zfp->index;
+  uint threads = 1;
+  size_t count;
+  uint k;
+  sample_tap* tap;
+  double* weight;
+  void* value;
+
+  if (!dims || !is_plain_field(field) || (n && (!points || !values)))
+    return zfp_false;
+  /* interpolated values of integer fields would be truncated */
+  if (interpolate && field->type != zfp_type_float && field->type != zfp_type_double)
+    return zfp_false;
+  /* blocks are located by rate or by chunk index */
+  if (zfp->minbits != zfp->maxbits && !(index && index->chunks && index->chunks <= blocks))
+    return zfp_false;
+  if (!n)
+    return zfp_true;
+
+  /* gather the grid points of all queries and sort them by block */
+  k = interpolate ? 1u << dims : 1u;
+  count = n * k;
+  tap = (sample_tap*)malloc(count * sizeof(sample_tap));
+  weight = (double*)malloc(count * sizeof(double));
+  value = malloc(count * zfp_type_size(field->type));
+  if (!tap || !weight || !value) {
+    free(tap);
+    free(weight);
+    free(value);
+    return zfp_false;
+  }
+  sample_taps(tap, weight, field, points, n, k, interpolate);
+  qsort(tap, count, sizeof(sample_tap), sample_compare);
+
+#ifdef _OPENMP
+  /* decode disjoint runs of blocks on per-thread streams */
+  if (zfp->exec.policy == zfp_exec_omp)
+    threads = (uint)MIN((size_t)thread_count_omp(zfp), count);
+  if (threads > 1) {
+    bitstream** bs = (bitstream**)malloc(threads * sizeof(bitstream*));
+    uint t = 0;
+    if (bs)
+      for (; t < threads; t++)
+        if (!(bs[t] = stream_clone(zfp->stream)))
+          break;
+    if (t == threads) {
+      int part; /* OpenMP 2.0 requires int loop counter */
+      #pragma omp parallel for num_threads(threads)
+      for (part = 0; part < (int)threads; part++) {
+        zfp_stream s = *zfp;
+        zfp_stream_set_bit_stream(&s, bs[part]);
+        sample[field->type - zfp_type_int32](&s, field, tap, sample_split(tap, count, threads, (uint)part), sample_split(tap, count, threads, (uint)part + 1), value);
+      }
+    }
+    else
+      threads = 1;
+    while (t--)
+      stream_close(bs[t]);
+    free(bs);
+  }
+#endif
+  if (threads == 1)
+    sample[field->type - zfp_type_int32](zfp, field, tap, 0, count, value);
+
+  combine[field->type - zfp_type_int32](values, value, weight, n, k);
+  free(tap);
+  free(weight);
+  free(value);
+
+  return zfp_true;
+}
+
+void
+zfp_decompress_begin(zfp_stream* zfp)
+{
+  /* nothing to prepare; provided for symmetry with zfp_compress_begin() */
+  (void)zfp;
+}
+
+zfp_bool
+zfp_decompress_slab(zfp_stream* zfp, zfp_field* slab)
+{
+  zfp_index* index = zfp->index;
+  zfp_bool success;
+
+  /* slabs begin at arbitrary bit offsets, which only host code supports */
+  switch (zfp->exec.policy) {
+    case zfp_exec_serial:
+    case zfp_exec_omp:
+    case zfp_exec_threads:
+      break;
+    default:
+      return zfp_false;
+  }
+  if (zfp_field_dimensionality(slab) != 3)
+    return zfp_false;
+
+  /* chunk index describes whole field, so locate blocks of slab only by rate */
+  zfp->index = NULL;
+  success = decompress_field(zfp, slab);
+  zfp->index = index;
+
+  return success;
+}
+
+size_t
+zfp_decompress_end(zfp_stream* zfp)
+{
+  /* align bit stream on next word boundary */
+  stream_align(zfp->stream);
+
+  return stream_size(zfp->stream);
+}
+
+size_t
+zfp_decompress_inplace(zfp_stream* zfp, zfp_field* field)
+{
+  return inplace_decompress(zfp, field);
+}
+
+#ifdef ZFP_WITH_THREADS
+/* (de)compression run on driver thread of stream's pool */
+typedef struct {
+  zfp_stream zfp;    /* copy of stream sharing its bit stream, index, and pool */
+  zfp_field field;   /* copy of field metadata */
+  zfp_bool compress; /* compress if true; decompress otherwise */
+} async_threads;
+
+static void
+run_async_threads(void* arg)
+{
+  async_threads* job = (async_threads*)arg;
+  if (job->compress) {
+    compress_field(&job->zfp, &job->field);
+    stream_flush(job->zfp.stream);
+  }
+  else {
+    decompress_field(&job->zfp, &job->field);
+    stream_align(job->zfp.stream);
+  }
+  free(job);
+}
+
+/* start (de)compression of fixed-rate field in background and return its
+   eventual stream size; return zero if it must be done synchronously */
+static size_t
+start_async_threads(zfp_stream* zfp, const zfp_field* field, zfp_bool compress)
+{
+  bitstream* s = zfp->stream;
+  size_t offset = compress ? stream_wtell(s) : stream_rtell(s);
+  pool* p;
+  async_threads* job;
+
+  /* only in fixed-rate mode is the size known up front */
+  if (zfp_stream_compression_mode(zfp) != zfp_mode_fixed_rate)
+    return 0;
+  p = pool_threads(zfp);
+  job = p ? (async_threads*)malloc(sizeof(async_threads)) : NULL;
+  if (!job)
+    return 0;
+
+  job->zfp = *zfp;
+  job->zfp.scratch = NULL;
+  job->field = *field;
+  job->compress = compress;
+  offset += (size_t)((uint64)field_blocks(field) * zfp->maxbits);
+  pool_spawn(p, run_async_threads, job);
+
+  return (offset + stream_word_bits - 1) / stream_word_bits * stream_word_bits / CHAR_BIT;
+}
+#endif
+
+size_t
+zfp_compress_async(zfp_stream* zfp, const zfp_field* field)
+{
+  /* return 0 if asynchronous compression is not supported */
+  if (!is_async_supported(zfp, field))
+    return 0;
+  wait_async(zfp);
+
+  /* invalidate any stale chunk index; parallel compressors repopulate it */
+  if (zfp->index)
+    zfp->index->chunks = 0;
+
+  /* queue compression; stream size is known up front in fixed-rate mode */
+  zfp_trace_begin("zfp:compress_async");
+  switch (zfp->exec.policy) {
+#ifdef ZFP_WITH_CUDA
+    case zfp_exec_cuda:
+      cuda_compress_async(zfp, field);
+      break;
+#endif
+#ifdef ZFP_WITH_HIP
+    case zfp_exec_hip:
+      hip_compress_async(zfp, field);
+      break;
+#endif
+#ifdef ZFP_WITH_THREADS
+    case zfp_exec_threads: {
+      /* compress synchronously unless started in background */
+      size_t size = start_async_threads(zfp, field, zfp_true);
+      zfp_trace_end();
+      return size ? size : zfp_compress(zfp, field);
+    }
+#endif
+    default:
+      zfp_trace_end();
+      return 0;
+  }
+  zfp_trace_end();
+  stream_flush(zfp->stream);
+
+  return stream_size(zfp->stream);
+}
+
+size_t
+zfp_decompress_async(zfp_stream* zfp, zfp_field* field)
+{
+  /* return 0 if asynchronous decompression is not supported */
+  if (!is_async_supported(zfp, field))
+    return 0;
+  wait_async(zfp);
+
+  zfp_trace_begin("zfp:decompress_async");
+  switch (zfp->exec.policy) {
+#ifdef ZFP_WITH_CUDA
+    case zfp_exec_cuda:
+      cuda_decompress_async(zfp, field);
+      break;
+#endif
+#ifdef ZFP_WITH_HIP
+    case zfp_exec_hip:
+      hip_decompress_async(zfp, field);
+      break;
+#endif
+#ifdef ZFP_WITH_THREADS
+    case zfp_exec_threads: {
+      /* decompress synchronously unless started in background */
+      size_t size = start_async_threads(zfp, field, zfp_false);
+      zfp_trace_end();
+      return size ? size : zfp_decompress(zfp, field);
+    }
+#endif
+    default:
+      zfp_trace_end();
+      return 0;
+  }
+  zfp_trace_end();
+  stream_align(zfp->stream);
+
+  return stream_size(zfp->stream);
+}
+
+size_t
+zfp_decompress_surface(zfp_stream* zfp, const zfp_field* field, uint64 surface)
+{
+  /* return 0 if the policy cannot write to surfaces */
+  if (!is_surface_supported(zfp, field))
+    return 0;
+
+  zfp_trace_begin("zfp:decompress_surface");
+  switch (zfp->exec.policy) {
+#ifdef ZFP_WITH_CUDA
+    case zfp_exec_cuda:
+      cuda_decompress_surface(zfp, field, (unsigned long long)surface);
+      break;
+#endif
+#ifdef ZFP_WITH_HIP
+    case zfp_exec_hip:
+      hip_decompress_surface(zfp, field, (unsigned long long)surface);
+      break;
+#endif
+    default:
+      (void)surface;
+      zfp_trace_end();
+      return 0;
+  }
+  zfp_trace_end();
+  stream_align(zfp->stream);
+
+  return stream_size(zfp->stream);
+}
+
+zfp_bool
+zfp_stream_synchronize(zfp_stream* zfp)
+{
+  switch (zfp->exec.policy) {
+#ifdef ZFP_WITH_CUDA
+    case zfp_exec_cuda:
+      return cuda_synchronize(zfp);
+#endif
+#ifdef ZFP_WITH_HIP
+    case zfp_exec_hip:
+      return hip_synchronize(zfp);
+#endif
+    default:
+      /* host execution completes before returning, except as started by
+         zfp_(de)compress_async under the thread-pool policy */
+      wait_async(zfp);
+      return zfp_true;
+  }
+}
+
+zfp_bool
+zfp_stream_query(const zfp_stream* zfp)
+{
+  switch (zfp->exec.policy) {
+#ifdef ZFP_WITH_CUDA
+    case zfp_exec_cuda:
+      return cuda_query(zfp);
+#endif
+#ifdef ZFP_WITH_HIP
+    case zfp_exec_hip:
+      return hip_query(zfp);
+#endif
+#ifdef ZFP_WITH_THREADS
+    case zfp_exec_threads:
+      return pool_idle((pool*)zfp->exec.params.threads.pool);
+#endif
+    default:
+      return zfp_true;
+  }
+}
+
+zfp_cuda_plan*
+zfp_cuda_plan_create(const zfp_stream* zfp, const zfp_field* field)
+{
+  /* plans replay fixed-rate kernels on whole device-resident fields */
+  if (zfp->exec.policy != zfp_exec_cuda || zfp_stream_compression_mode(zfp) != zfp_mode_fixed_rate ||
+      !is_async_supported(zfp, field))
+    return NULL;
+#ifdef ZFP_WITH_CUDA
+  return cuda_plan_create(zfp, field);
 #else
-    {{{ NULL }}},
+  return NULL;
+#endif
+}
+
+void
+zfp_cuda_plan_free(zfp_cuda_plan* plan)
+{
+#ifdef ZFP_WITH_CUDA
+  cuda_plan_free(plan);
+#else
+  (void)plan;
+#endif
+}
+
+size_t
+zfp_cuda_plan_compress(const zfp_cuda_plan* plan, void* buffer, const void* data)
+{
+#ifdef ZFP_WITH_CUDA
+  return cuda_plan_compress(plan, buffer, data);
+#else
+  (void)plan;
+  (void)buffer;
+  (void)data;
+  return 0;
+#endif
+}
+
+size_t
+zfp_cuda_plan_decompress(const zfp_cuda_plan* plan, void* data, const void* buffer)
+{
+#ifdef ZFP_WITH_CUDA
+  return cuda_plan_decompress(plan, data, buffer);
+#else
+  (void)plan;
+  (void)data;
+  (void)buffer;
+  return 0;
+#endif
+}
+
+size_t
+zfp_cuda_write_file(const char* path, const void* buffer, size_t size)
+{
+#ifdef ZFP_WITH_CUDA
+  return cuda_write_file(path, buffer, size);
+#else
+  /* without CUDA, the buffer resides in host memory */
+  FILE* file = fopen(path, "wb");
+  size_t bytes;
+  if (!file)
+    return 0;
+  bytes = fwrite(buffer, 1, size, file);
+  if (fclose(file) || bytes != size)
+    return 0;
+  return bytes;
+#endif
+}
+
+size_t
+zfp_cuda_read_file(const char* path, void* buffer, size_t capacity)
+{
+#ifdef ZFP_WITH_CUDA
+  return cuda_read_file(path, buffer, capacity);
+#else
+  FILE* file = fopen(path, "rb");
+  size_t bytes;
+  if (!file)
+    return 0;
+  bytes = fread(buffer, 1, capacity, file);
+  if (ferror(file))
+    bytes = 0;
+  fclose(file);
+  return bytes;
+#endif
+}
+
+size_t
+zfp_compress_batch(zfp_stream* zfp, const zfp_field* const* fields, size_t n, size_t* offsets)
+{
+  size_t* pos = offsets ? offsets : (size_t*)malloc((n + 1) * sizeof(size_t));
+  zfp_bool success;
+  size_t size;
+
+  if (!pos)
+    return 0;
+
+  /* align stream so that each field begins on a word boundary */
+  stream_flush(zfp->stream);
+  pos[0] = stream_size(zfp->stream);
+
+  /* compress fields and wait for any queued device work */
+  success = compress_batch(zfp, fields, n, pos) && zfp_stream_synchronize(zfp);
+  size = pos[n];
+  if (success)
+    stream_wseek(zfp->stream, size * CHAR_BIT);
+
+  if (!offsets)
+    free(pos);
+
+  return success ? size : 0;
+}
+
+size_t
+zfp_decompress_batch(zfp_stream* zfp, zfp_field* const* fields, size_t n, const size_t* offsets)
+{
+  size_t* pos = (size_t*)malloc((n + 1) * sizeof(size_t));
+  zfp_bool success;
+  size_t size;
+
+  if (!pos)
+    return 0;
+
+  /* fields begin on word boundaries */
+  stream_align(zfp->stream);
+  if (offsets)
+    memcpy(pos, offsets, (n + 1) * sizeof(size_t));
+  else
+    pos[0] = stream_rtell(zfp->stream) / CHAR_BIT;
+
+  /* decompress fields and wait for any queued device work */
+  success = decompress_batch(zfp, fields, n, pos, offsets != NULL) && zfp_stream_synchronize(zfp);
+  size = pos[n];
+  if (success)
+    stream_rseek(zfp->stream, size * CHAR_BIT);
+
+  free(pos);
+
+  return success ? size : 0;
+}
+
+size_t
+zfp_transcode(zfp_stream* dst, zfp_stream* src, const zfp_field* field)
+{
+  size_t blocks = field_blocks(field);
+  size_t bits;
+
+  /* blocks of both streams must be of fixed size; since the decoder infers */
+  /* trailing bits of a truncated block, zero padding would alter its values */
+  if (!zfp_field_dimensionality(field) || !is_plain_field(field) || dst->raw || src->raw ||
+      zfp_stream_compression_mode(dst) != zfp_mode_fixed_rate ||
+      zfp_stream_compression_mode(src) != zfp_mode_fixed_rate ||
+      dst->maxbits > src->maxbits)
+    return 0;
+
+  /* make sure transcoded field fits in destination stream */
+  bits = stream_wtell(dst->stream) + blocks * dst->maxbits;
+  if (bits > stream_capacity(dst->stream) * CHAR_BIT)
+    return 0;
+
+  /* truncate each block, in parallel if requested */
+#ifdef _OPENMP
+  if (dst->exec.policy != zfp_exec_omp || !transcode_blocks_omp(dst, src, blocks))
+#endif
+    transcode_blocks(dst->stream, src->stream, blocks, dst->maxbits, src->maxbits);
+
+  /* align streams on word boundary */
+  stream_align(src->stream);
+  stream_flush(dst->stream);
+
+  return stream_size(dst->stream);
+}
+
+uint
+zfp_stream_layers(const zfp_stream* zfp)
+{
+#ifdef BIT_STREAM_STRIDED
+  /* each layer holds one word of every block, so blocks must be of equal whole-word size */
+  if (zfp->minbits != zfp->maxbits || zfp->maxbits % stream_word_bits || zfp_stream_compression_mode(zfp) == zfp_mode_reversible)
+    return 0;
+  return zfp->maxbits / stream_word_bits;
+#else
+  (void)zfp;
+  return 0;
+#endif
+}
+
+size_t
+zfp_stream_layer_size(const zfp_stream* zfp, const zfp_field* field, uint layers)
+{
+  if (!layers || layers > zfp_stream_layers(zfp))
+    return 0;
+  return field_blocks(field) * layers * (stream_word_bits / CHAR_BIT);
+}
+
+/* set stride of strided stream (no-op otherwise) */
+static void
+set_stream_stride(bitstream* s, size_t block, ptrdiff_t delta)
+{
+#ifdef BIT_STREAM_STRIDED
+  stream_set_stride(s, block, delta);
+#else
+  (void)s;
+  (void)block;
+  (void)delta;
 #endif
+}
+
+size_t
+zfp_compress_progressive(zfp_stream* zfp, const zfp_field* field)
+{
+  /* function table [scalar type] */
+  uint (*ftable[4])(zfp_stream*, const zfp_field*, size_t) = {
+    compress_block_int32,
+    compress_block_int64,
+    compress_block_float,
+    compress_block_double,
   };
-  uint exec = zfp->exec.policy;
-  uint strided = zfp_field_stride(field, NULL);
+  uint layers = zfp_stream_layers(zfp);
+  size_t blocks = field_blocks(field);
+  size_t block = stream_stride_block(zfp->stream);
+  ptrdiff_t delta = stream_stride_delta(zfp->stream);
+  size_t base;
+  size_t i;
+
+  /* layers are supported only by strided streams */
+  if (!layers || zfp->raw || !is_plain_field(field))
+    return 0;
+
+  /* layers begin on a word boundary */
+  stream_flush(zfp->stream);
+  base = stream_wtell(zfp->stream);
+
+  /* write word l of block i to word l * blocks + i so that layers are contiguous */
+  set_stream_stride(zfp->stream, 1, (ptrdiff_t)blocks - 1);
+  for (i = 0; i < blocks; i++) {
+    stream_wseek(zfp->stream, base + i * stream_word_bits);
+    ftable[field->type - zfp_type_int32](zfp, field, i);
+  }
+  set_stream_stride(zfp->stream, block, delta);
+  stream_wseek(zfp->stream, base + (size_t)layers * blocks * stream_word_bits);
+
+  return stream_size(zfp->stream);
+}
+
+size_t
+zfp_decompress_progressive(zfp_stream* zfp, zfp_field* field, uint layers)
+{
+  /* function table [scalar type] */
+  uint (*ftable[4])(zfp_stream*, zfp_field*, size_t) = {
+    decompress_block_int32,
+    decompress_block_int64,
+    decompress_block_float,
+    decompress_block_double,
+  };
+  size_t blocks = field_blocks(field);
+  size_t block = stream_stride_block(zfp->stream);
+  ptrdiff_t delta = stream_stride_delta(zfp->stream);
+  uint minbits = zfp->minbits;
+  uint maxbits = zfp->maxbits;
+  size_t base;
+  size_t i;
+
+  /* layers are supported only by strided streams */
+  if (!layers || layers > zfp_stream_layers(zfp) || zfp->raw || !is_plain_field(field))
+    return 0;
+
+  /* layers begin on a word boundary */
+  stream_align(zfp->stream);
+  base = stream_rtell(zfp->stream);
+
+  /* read only the leading words of each block, without skipping past them */
+  zfp->minbits = 0;
+  zfp->maxbits = layers * stream_word_bits;
+  set_stream_stride(zfp->stream, 1, (ptrdiff_t)blocks - 1);
+  for (i = 0; i < blocks; i++) {
+    stream_rseek(zfp->stream, base + i * stream_word_bits);
+    ftable[field->type - zfp_type_int32](zfp, field, i);
+  }
+  set_stream_stride(zfp->stream, block, delta);
+  zfp->minbits = minbits;
+  zfp->maxbits = maxbits;
+  stream_rseek(zfp->stream, base + (size_t)layers * blocks * stream_word_bits);
+
+  return stream_rtell(zfp->stream) / CHAR_BIT;
+}
+
+size_t
+zfp_compress_multi(zfp_stream* const* streams, size_t n, const zfp_field* field)
+{
+  /* function table [scalar type] */
+  void (*ftable[2])(zfp_stream* const*, uint, const zfp_field*) = {
+    compress_multi_float,
+    compress_multi_double,
+  };
+  zfp_bool shared = (field->type == zfp_type_float || field->type == zfp_type_double) && !is_masked(field) && zfp_field_dimensionality(field) && n <= UINT_MAX;
+  size_t size = 0;
+  size_t i;
+
+  /* only serial streams without per-block parameters share block transforms */
+  for (i = 0; i < n && shared; i++)
+    shared = streams[i]->exec.policy == zfp_exec_serial && !streams[i]->map && !streams[i]->relative && is_raw_supported(streams[i]) && is_verify_supported(streams[i], field);
+
+  if (!shared) {
+    /* compress field once per stream */
+    for (i = 0; i < n; i++) {
+      size_t bytes = zfp_compress(streams[i], field);
+      if (!bytes)
+        return 0;
+      size += bytes;
+    }
+    return size;
+  }
+
+  for (i = 0; i < n; i++) {
+    wait_async(streams[i]);
+    if (streams[i]->index)
+      streams[i]->index->chunks = 0;
+  }
+
+  zfp_trace_begin("zfp:compress");
+  ftable[field->type - zfp_type_float](streams, (uint)n, field);
+  zfp_trace_end();
+
+  /* align each stream on word boundary */
+  for (i = 0; i < n; i++) {
+    stream_flush(streams[i]->stream);
+    size += stream_size(streams[i]->stream);
+  }
+
+  return size;
+}
+
+#include "share/chunkrate.c"
+
+size_t
+zfp_compress_chunk_rate(zfp_stream* zfp, const zfp_field* field, uint chunk)
+{
+  return chunk_rate_compress_field(zfp, field, chunk);
+}
+
+size_t
+zfp_decompress_chunk_rate(zfp_stream* zfp, zfp_field* field, uint chunk)
+{
+  return chunk_rate_decompress_field(zfp, field, chunk);
+}
+
+#include "share/framed.c"
+
+size_t
+zfp_frame_maximum_size(const zfp_stream* zfp, const zfp_field* field, uint blocks)
+{
+  if (!is_framing_supported(zfp, field, blocks))
+    return 0;
+  blocks = (uint)MIN((size_t)blocks, field_blocks(field));
+  return word_bytes(ZFP_FRAME_HEADER_BITS + (double)blocks * block_maximum_bits(zfp, field));
+}
+
+size_t
+zfp_compress_framed(const zfp_stream* zfp, const zfp_field* field, uint blocks, zfp_frame_sink sink, void* context)
+{
+  return framed_compress(zfp, field, blocks, sink, context);
+}
+
+size_t
+zfp_decompress_frame(const zfp_stream* zfp, zfp_field* field, const void* frame, size_t size, uint* sequence)
+{
+  return framed_decompress(zfp, field, frame, size, sequence);
+}
+
+#include "share/sparse.c"
+
+size_t
+zfp_sparse_maximum_size(const zfp_stream* zfp, const zfp_field* field, size_t count)
+{
+  size_t blocks = field_blocks(field);
+  if (!is_sparse_supported(zfp, field) || count > blocks)
+    return 0;
+  return word_bytes((double)blocks + (double)count * block_maximum_bits(zfp, field));
+}
+
+size_t
+zfp_compress_sparse(zfp_stream* zfp, const zfp_field* field, const uint8* active, const void* bricks)
+{
+  return sparse_compress(zfp, field, active, bricks);
+}
+
+size_t
+zfp_sparse_map(zfp_stream* zfp, const zfp_field* field, uint8* active)
+{
+  return sparse_map(zfp, field, active);
+}
+
+size_t
+zfp_decompress_sparse(zfp_stream* zfp, zfp_field* field, uint8* active, void* bricks)
+{
+  return sparse_decompress(zfp, field, active, bricks);
+}
+
+size_t
+zfp_write_header(zfp_stream* zfp, const zfp_field* field, uint mask)
+{
+  size_t bits = 0;
+  uint64 meta = 0;
+
+  /* first make sure field dimensions fit in header */
+  if (mask & ZFP_HEADER_META) {
+    meta = zfp_field_metadata(field);
+    if (meta == ZFP_META_NULL)
+      return 0;
+  }
+
+  /* 32-bit magic */
+  if (mask & ZFP_HEADER_MAGIC) {
+    stream_write_bits(zfp->stream, 'z', 8);
+    stream_write_bits(zfp->stream, 'f', 8);
+    stream_write_bits(zfp->stream, 'p', 8);
+    stream_write_bits(zfp->stream, zfp_codec_version, 8);
+    bits += ZFP_MAGIC_BITS;
+  }
+  /* 52-bit field metadata */
+  if (mask & ZFP_HEADER_META) {
+    stream_write_bits(zfp->stream, meta, ZFP_META_BITS);
+    bits += ZFP_META_BITS;
+  }
+  /* 12- or 64-bit compression parameters */
+  if (mask & ZFP_HEADER_MODE) {
+    uint64 mode = zfp_stream_mode(zfp);
+    uint size = mode > ZFP_MODE_SHORT_MAX ? ZFP_MODE_LONG_BITS : ZFP_MODE_SHORT_BITS;
+    stream_write_bits(zfp->stream, mode, size);
+    bits += size;
+  }
+
+  return bits;
+}
+
+size_t
+zfp_read_header(zfp_stream* zfp, zfp_field* field, uint mask)
+{
+  size_t bits = 0;
+  if (mask & ZFP_HEADER_MAGIC) {
+    if (stream_read_bits(zfp->stream, 8) != 'z' ||
+        stream_read_bits(zfp->stream, 8) != 'f' ||
+        stream_read_bits(zfp->stream, 8) != 'p' ||
+        stream_read_bits(zfp->stream, 8) != zfp_codec_version)
+      return 0;
+    bits += ZFP_MAGIC_BITS;
+  }
+  if (mask & ZFP_HEADER_META) {
+    uint64 meta = stream_read_bits(zfp->stream, ZFP_META_BITS);
+    if (!zfp_field_set_metadata(field, meta))
+      return 0;
+    bits += ZFP_META_BITS;
+  }
+  if (mask & ZFP_HEADER_MODE) {
+    uint64 mode = stream_read_bits(zfp->stream, ZFP_MODE_SHORT_BITS);
+    bits += ZFP_MODE_SHORT_BITS;
+    if (mode > ZFP_MODE_SHORT_MAX) {
+      uint size = ZFP_MODE_LONG_BITS - ZFP_MODE_SHORT_BITS;
+      mode += stream_read_bits(zfp->stream, size) << ZFP_MODE_SHORT_BITS;
+      bits += size;
+    }
+    if (zfp_stream_set_mode(zfp, mode) == zfp_mode_null)
+      return 0;
+  }
+  return bits;
+}
+
+size_t
+zfp_write_index(zfp_stream* zfp, const zfp_index* index)
+{
+  size_t chunks = index->chunks;
+  uint64 max = 0;
+  uint width = 1;
+  size_t i;
+
+  /* make sure index is set and chunk count fits in index header */
+  if (!chunks || (uint64)chunks >> (ZFP_INDEX_CHUNK_BITS - 1) >> 1)
+    return 0;
+
+  /* determine number of bits needed to encode largest offset delta */
+  for (i = 0; i < chunks; i++)
+    max = MAX(max, index->offset[i + 1] - index->offset[i]);
+  while (width < 64 && (max >> width))
+    width++;
+
+  /* 32-bit chunk count, 6-bit delta width, and one delta per chunk */
+  stream_write_bits(zfp->stream, chunks, ZFP_INDEX_CHUNK_BITS);
+  stream_write_bits(zfp->stream, width - 1, ZFP_INDEX_WIDTH_BITS);
+  for (i = 0; i < chunks; i++)
+    stream_write_bits(zfp->stream, index->offset[i + 1] - index->offset[i], width);
+
+  return ZFP_INDEX_CHUNK_BITS + ZFP_INDEX_WIDTH_BITS + chunks * width;
+}
+
+size_t
+zfp_read_index(zfp_stream* zfp, zfp_index* index)
+{
+  size_t bits = (size_t)stream_capacity(zfp->stream) * CHAR_BIT - stream_rtell(zfp->stream);
+  size_t chunks;
+  uint width;
+  uint64* offset;
+  size_t i;
+
+  if (bits < ZFP_INDEX_CHUNK_BITS + ZFP_INDEX_WIDTH_BITS)
+    return 0;
+  bits -= ZFP_INDEX_CHUNK_BITS + ZFP_INDEX_WIDTH_BITS;
+  chunks = (size_t)stream_read_bits(zfp->stream, ZFP_INDEX_CHUNK_BITS);
+  width = (uint)stream_read_bits(zfp->stream, ZFP_INDEX_WIDTH_BITS) + 1;
+
+  /* a truncated or corrupted index holds fewer deltas than it claims */
+  if (!chunks || chunks > bits / width)
+    return 0;
+
+  /* accumulate offset deltas */
+  offset = (uint64*)realloc(index->offset, (chunks + 1) * sizeof(uint64));
+  if (!offset)
+    return 0;
+  offset[0] = 0;
+  for (i = 0; i < chunks; i++)
+    offset[i + 1] = offset[i] + stream_read_bits(zfp->stream, width);
+  index->offset = offset;
+  index->chunks = chunks;
+  index->hashes = 0;
+
+  return ZFP_INDEX_CHUNK_BITS + ZFP_INDEX_WIDTH_BITS + chunks * width;
+}
+
+size_t
+zfp_build_index(zfp_stream* zfp, const zfp_field* field, zfp_index* index, size_t granularity)
+{
   uint dims = zfp_field_dimensionality(field);
-  uint type = field->type;
-  void (*compress)(zfp_stream*, const zfp_field*);
+  size_t blocks = field_blocks(field);
+  size_t base = stream_rtell(zfp->stream);
+  size_t chunks;
+  size_t bits = 0;
+  uint64* offset;
 
-  switch (type) {
-    case zfp_type_int32:
-    case zfp_type_int64:
-    case zfp_type_float:
-    case zfp_type_double:
+  if (!dims || !granularity)
+    return 0;
+  chunks = (blocks + granularity - 1) / granularity;
+  offset = (uint64*)malloc((chunks + 1) * sizeof(uint64));
+  if (!offset)
+    return 0;
+
+  /* skip over blocks, then return to beginning of field */
+  if (scan_chunks(zfp, codec_type(field->type), dims, blocks, chunks, offset) &&
+      base + offset[chunks] <= (uint64)stream_capacity(zfp->stream) * CHAR_BIT &&
+      zfp_index_set(index, chunks, offset))
+    bits = (size_t)offset[chunks];
+  stream_rseek(zfp->stream, base);
+  free(offset);
+
+  return bits;
+}
+
+/* public functions: container --------------------------------------------- */
+
+zfp_container*
+zfp_container_create(size_t alignment)
+{
+  return container_create(alignment);
+}
+
+zfp_bool
+zfp_container_add(zfp_container* c, const char* name, zfp_stream* zfp, const zfp_field* field)
+{
+  return container_add(c, name, zfp, field);
+}
+
+const void*
+zfp_container_finish(zfp_container* c, size_t* size)
+{
+  return container_finish(c, size);
+}
+
+zfp_container*
+zfp_container_open(const void* data, size_t size)
+{
+  return container_open(data, size);
+}
+
+void
+zfp_container_close(zfp_container* c)
+{
+  container_close(c);
+}
+
+size_t
+zfp_container_fields(const zfp_container* c)
+{
+  return c->entries;
+}
+
+size_t
+zfp_container_find(const zfp_container* c, const char* name)
+{
+  size_t i;
+  for (i = 0; i < c->entries; i++)
+    if (!strcmp(c->entry[i].name, name))
+      break;
+  return i;
+}
+
+const char*
+zfp_container_name(const zfp_container* c, size_t i)
+{
+  return i < c->entries ? c->entry[i].name : NULL;
+}
+
+zfp_bool
+zfp_container_field(const zfp_container* c, size_t i, zfp_field* field)
+{
+  return i < c->entries && zfp_field_set_metadata(field, c->entry[i].meta);
+}
+
+uint64
+zfp_container_mode(const zfp_container* c, size_t i)
+{
+  return i < c->entries ? c->entry[i].mode : 0;
+}
+
+zfp_entropy
+zfp_container_entropy(const zfp_container* c, size_t i)
+{
+  return i < c->entries ? c->entry[i].entropy : zfp_entropy_none;
+}
+
+size_t
+zfp_container_size(const zfp_container* c, size_t i)
+{
+  return i < c->entries ? (size_t)c->entry[i].size : 0;
+}
+
+size_t
+zfp_container_chunks(const zfp_container* c, size_t i)
+{
+  return i < c->entries ? zfp_index_chunks(c->entry[i].index) : 0;
+}
+
+size_t
+zfp_container_decompress(const zfp_container* c, size_t i, zfp_stream* zfp, zfp_field* field)
+{
+  bitstream* stream = zfp_stream_bit_stream(zfp);
+  zfp_index* index = zfp_stream_index(zfp);
+  bitstream* s = NULL;
+  void* buffer = NULL;
+  size_t size = 0;
+
+  if (container_begin(c, i, zfp, field, &s, &buffer))
+    size = zfp_decompress(zfp, field);
+  stream_close(s);
+  free(buffer);
+  zfp_stream_set_bit_stream(zfp, stream);
+  zfp_stream_set_index(zfp, index);
+
+  return size;
+}
+
+size_t
+zfp_container_decompress_subset(const zfp_container* c, size_t i, zfp_stream* zfp, zfp_field* field, size_t x0, size_t y0, size_t z0, size_t nx, size_t ny, size_t nz)
+{
+  bitstream* stream = zfp_stream_bit_stream(zfp);
+  zfp_index* index = zfp_stream_index(zfp);
+  bitstream* s = NULL;
+  void* buffer = NULL;
+  size_t size = 0;
+
+  if (container_begin(c, i, zfp, field, &s, &buffer))
+    size = zfp_decompress_subset(zfp, field, x0, y0, z0, nx, ny, nz);
+  stream_close(s);
+  free(buffer);
+  zfp_stream_set_bit_stream(zfp, stream);
+  zfp_stream_set_index(zfp, index);
+
+  return size;
+}
+
+/* public functions: shared configuration ---------------------------------- */
+
+struct zfp_config {
+  zfp_stream zfp; /* compression parameters without per-call state */
+};
+
+zfp_config*
+zfp_config_create(const zfp_stream* zfp)
+{
+  zfp_config* config;
+
+  if (zfp_stream_compression_mode(zfp) == zfp_mode_null)
+    return NULL;
+
+  config = (zfp_config*)malloc(sizeof(zfp_config));
+  if (!config)
+    return NULL;
+
+  /* state written during (de)compression is owned by per-call streams */
+  config->zfp = *zfp;
+  config->zfp.stream = NULL;
+  config->zfp.index = NULL;
+  config->zfp.scratch = NULL;
+  config->zfp.stats = NULL;
+  config->zfp.verify = NULL;
+  switch (zfp->exec.policy) {
+    case zfp_exec_omp:
+      config->zfp.exec.params.omp.thread_time = NULL;
+      config->zfp.exec.params.omp.persistent = zfp_false;
+      break;
+    case zfp_exec_threads:
+      config->zfp.exec.params.threads.pool = NULL;
+      break;
+    case zfp_exec_hybrid:
+      config->zfp.exec.params.hybrid.calibrate = zfp_false;
       break;
     default:
-      return 0;
+      break;
+  }
+
+  return config;
+}
+
+void
+zfp_config_free(zfp_config* config)
+{
+  free(config);
+}
+
+size_t
+zfp_config_maximum_size(const zfp_config* config, const zfp_field* field)
+{
+  return zfp_stream_maximum_size(&config->zfp, field);
+}
+
+void
+zfp_stream_init_config(zfp_stream* zfp, const zfp_config* config, bitstream* stream)
+{
+  *zfp = config->zfp;
+  zfp->stream = stream;
+}
+
+size_t
+zfp_config_compress(const zfp_config* config, const zfp_field* field, void* buffer, size_t capacity)
+{
+  stream_storage storage;
+  zfp_stream zfp;
+  size_t max, size;
+
+  /* encoder does not check for overflow, so insist on worst-case capacity */
+  max = zfp_stream_maximum_size(&config->zfp, field);
+  if (!max || capacity < max)
+    return 0;
+
+  zfp_stream_init_config(&zfp, config, stream_init(&storage, buffer, capacity));
+  size = zfp_compress(&zfp, field);
+  zfp_stream_release(&zfp);
+
+  return size;
+}
+
+size_t
+zfp_config_decompress(const zfp_config* config, zfp_field* field, const void* buffer, size_t size)
+{
+  stream_storage storage;
+  zfp_stream zfp;
+
+  zfp_stream_init_config(&zfp, config, stream_init(&storage, (void*)buffer, size));
+  size = zfp_decompress(&zfp, field);
+  zfp_stream_release(&zfp);
+
+  return size;
+}
+
+/* public functions: chunk codec ------------------------------------------- */
+
+struct zfp_chunk_codec {
+  zfp_stream zfp; /* compression parameters and reusable bit stream */
+  zfp_type type;  /* scalar type of chunks */
+};
+
+/* describe chunk as field; return false if its shape is not representable */
+static zfp_bool
+chunk_field(zfp_field* field, zfp_type type, void* data, uint dims, const size_t* shape, const ptrdiff_t* strides)
+{
+  size_t n[4] = { 0, 0, 0, 0 };
+  ptrdiff_t s[4] = { 0, 0, 0, 0 };
+  uint i;
+
+  if (dims < 1 || dims > 4)
+    return zfp_false;
+  for (i = 0; i < dims; i++) {
+    if (!shape[i] || shape[i] > UINT_MAX)
+      return zfp_false;
+    n[i] = shape[i];
+    if (strides) {
+      if (strides[i] < INT_MIN || strides[i] > INT_MAX)
+        return zfp_false;
+      s[i] = strides[i];
+    }
+  }
+
+  field->type = type;
+  field->nx = (uint)n[0];
+  field->ny = (uint)n[1];
+  field->nz = (uint)n[2];
+  field->nw = (uint)n[3];
+  field->sx = (int)s[0];
+  field->sy = (int)s[1];
+  field->sz = (int)s[2];
+  field->sw = (int)s[3];
+  field->data = data;
+  field->mask = NULL;
+  field->fill = 0;
+  field->has_fill = zfp_false;
+
+  return zfp_true;
+}
+
+zfp_chunk_codec*
+zfp_chunk_codec_create(const zfp_stream* zfp, zfp_type type)
+{
+  zfp_chunk_codec* codec;
+
+  if (!is_native_type(type) || zfp_stream_compression_mode(zfp) == zfp_mode_null)
+    return NULL;
+
+  codec = (zfp_chunk_codec*)malloc(sizeof(zfp_chunk_codec));
+  if (!codec)
+    return NULL;
+
+  /* chunks are small; any parallelism is across chunks rather than within */
+  codec->zfp.minbits = zfp->minbits;
+  codec->zfp.maxbits = zfp->maxbits;
+  codec->zfp.maxprec = zfp->maxprec;
+  codec->zfp.minexp = zfp->minexp;
+  codec->zfp.exec.policy = zfp_exec_serial;
+  memset(&codec->zfp.exec.params, 0, sizeof(codec->zfp.exec.params));
+  codec->zfp.index = NULL;
+  codec->zfp.isa = zfp->isa;
+  codec->zfp.scratch = NULL;
+  codec->zfp.stats = NULL;
+  codec->zfp.raw = zfp->raw;
+  codec->zfp.entropy = zfp_entropy_none;
+  codec->zfp.verify = NULL;
+  codec->zfp.map = NULL;
+  codec->zfp.relative = zfp_false;
+  codec->type = type;
+
+  /* bit stream is retargeted at each chunk's buffer */
+  codec->zfp.stream = stream_open(NULL, 0);
+  if (!codec->zfp.stream) {
+    free(codec);
+    return NULL;
   }
 
-  /* return 0 if compression mode is not supported */
-  compress = ftable[exec][strided][dims - 1][type - zfp_type_int32];
-  if (!compress)
+  return codec;
+}
+
+void
+zfp_chunk_codec_free(zfp_chunk_codec* codec)
+{
+  if (codec) {
+    stream_close(codec->zfp.stream);
+    free(codec);
+  }
+}
+
+size_t
+zfp_chunk_codec_maximum_size(const zfp_chunk_codec* codec, uint dims, const size_t* shape)
+{
+  zfp_field field;
+
+  /* header is no larger than the one accounted for by zfp_stream_maximum_size */
+  if (!chunk_field(&field, codec->type, NULL, dims, shape, NULL))
     return 0;
 
-  /* compress field and align bit stream on word boundary */
-  compress(zfp, field);
+  return zfp_stream_maximum_size(&codec->zfp, &field);
+}
+
+size_t
+zfp_encode_chunk(zfp_chunk_codec* codec, const void* in, uint dims, const size_t* shape, const ptrdiff_t* strides, void* out, size_t capacity)
+{
+  zfp_stream* zfp = &codec->zfp;
+  zfp_field field;
+  uint64 meta;
+  size_t max;
+
+  if (!chunk_field(&field, codec->type, (void*)in, dims, shape, strides))
+    return 0;
+  meta = zfp_field_metadata(&field);
+  if (meta == ZFP_META_NULL)
+    return 0;
+
+  /* encoder does not check for overflow, so insist on worst-case capacity */
+  max = zfp_stream_maximum_size(zfp, &field);
+  if (!max || capacity < max)
+    return 0;
+
+  /* 52-bit field metadata and 12-bit codec version */
+  stream_reopen(zfp->stream, out, capacity);
+  stream_write_bits(zfp->stream, meta, ZFP_META_BITS);
+  stream_write_bits(zfp->stream, zfp_codec_version, ZFP_CHUNK_HEADER_BITS - ZFP_META_BITS);
+
+  if (!compress_field(zfp, &field))
+    return 0;
   stream_flush(zfp->stream);
 
   return stream_size(zfp->stream);
 }
 
 size_t
-zfp_decompress(zfp_stream* zfp, zfp_field* field)
+zfp_decode_chunk(zfp_chunk_codec* codec, const void* in, size_t size, void* out, uint dims, const size_t* shape, const ptrdiff_t* strides)
 {
-  /* function table [execution][strided][dimensionality][scalar type] */
-  void (*ftable[4][2][4][4])(zfp_stream*, zfp_field*) = {
-    /* serial */
-    {{{ decompress_int32_1,         decompress_int64_1,         decompress_float_1,         decompress_double_1 },
-      { decompress_strided_int32_2, decompress_strided_int64_2, decompress_strided_float_2, decompress_strided_double_2 },
-      { decompress_strided_int32_3, decompress_strided_int64_3, decompress_strided_float_3, decompress_strided_double_3 },
-      { decompress_strided_int32_4, decompress_strided_int64_4, decompress_strided_float_4, decompress_strided_double_4 }},
-     {{ decompress_strided_int32_1, decompress_strided_int64_1, decompress_strided_float_1, decompress_strided_double_1 },
-      { decompress_strided_int32_2, decompress_strided_int64_2, decompress_strided_float_2, decompress_strided_double_2 },
-      { decompress_strided_int32_3, decompress_strided_int64_3, decompress_strided_float_3, decompress_strided_double_3 },
-      { decompress_strided_int32_4, decompress_strided_int64_4, decompress_strided_float_4, decompress_strided_double_4 }}},
+  zfp_stream* zfp = &codec->zfp;
+  zfp_field field;
+  uint64 meta;
 
-    /* OpenMP; not yet supported */
-    {{{ NULL }}},
+  if (!chunk_field(&field, codec->type, out, dims, shape, strides))
+    return 0;
+  meta = zfp_field_metadata(&field);
+  if (meta == ZFP_META_NULL || size < ZFP_CHUNK_HEADER_BITS / CHAR_BIT)
+    return 0;
 
-    /* CUDA */
-#ifdef ZFP_WITH_CUDA
-    {{{ decompress_cuda_int32_1,         decompress_cuda_int64_1,         decompress_cuda_float_1,         decompress_cuda_double_1 },
-      { decompress_strided_cuda_int32_2, decompress_strided_cuda_int64_2, decompress_strided_cuda_float_2, decompress_strided_cuda_double_2 },
-      { decompress_strided_cuda_int32_3, decompress_strided_cuda_int64_3, decompress_strided_cuda_float_3, decompress_strided_cuda_double_3 },
-      { NULL,                            NULL,                            NULL,                            NULL }},
-     {{ decompress_strided_cuda_int32_1, decompress_strided_cuda_int64_1, decompress_strided_cuda_float_1, decompress_strided_cuda_double_1 },
-      { decompress_strided_cuda_int32_2, decompress_strided_cuda_int64_2, decompress_strided_cuda_float_2, decompress_strided_cuda_double_2 },
-      { decompress_strided_cuda_int32_3, decompress_strided_cuda_int64_3, decompress_strided_cuda_float_3, decompress_strided_cuda_double_3 },
-      { NULL,                            NULL,                            NULL,                            NULL }}},
-#else
-    {{{ NULL }}},
-#endif
+  /* header must match type and shape of chunk and this codec version */
+  stream_reopen(zfp->stream, (void*)in, size);
+  if (stream_read_bits(zfp->stream, ZFP_META_BITS) != meta ||
+      stream_read_bits(zfp->stream, ZFP_CHUNK_HEADER_BITS - ZFP_META_BITS) != zfp_codec_version)
+    return 0;
 
-#ifdef ZFP_WITH_HIP
-    {{{ decompress_hip_int32_1,         decompress_hip_int64_1,         decompress_hip_float_1,         decompress_hip_double_1 },
-      { decompress_strided_hip_int32_2, decompress_strided_hip_int64_2, decompress_strided_hip_float_2, decompress_strided_hip_double_2 },
-      { decompress_strided_hip_int32_3, decompress_strided_hip_int64_3, decompress_strided_hip_float_3, decompress_strided_hip_double_3 },
-      { NULL,                            NULL,                            NULL,                            NULL }},
-     {{ decompress_strided_hip_int32_1, decompress_strided_hip_int64_1, decompress_strided_hip_float_1, decompress_strided_hip_double_1 },
-      { decompress_strided_hip_int32_2, decompress_strided_hip_int64_2, decompress_strided_hip_float_2, decompress_strided_hip_double_2 },
-      { decompress_strided_hip_int32_3, decompress_strided_hip_int64_3, decompress_strided_hip_float_3, decompress_strided_hip_double_3 },
-      { NULL,                            NULL,                            NULL,                            NULL }}},
-#else
-    {{{ NULL }}},
-#endif
-  };
-  uint exec = zfp->exec.policy;
-  uint strided = zfp_field_stride(field, NULL);
-  uint dims = zfp_field_dimensionality(field);
-  uint type = field->type;
-  void (*decompress)(zfp_stream*, zfp_field*);
+  if (!decompress_field(zfp, &field))
+    return 0;
+  stream_align(zfp->stream);
 
-  switch (type) {
-    case zfp_type_int32:
-    case zfp_type_int64:
-    case zfp_type_float:
-    case zfp_type_double:
-      break;
-    default:
-      return 0;
+  return stream_size(zfp->stream);
+}
+
+/* public functions: temporal delta compression ---------------------------- */
+
+zfp_temporal*
+zfp_temporal_create(const zfp_field* field, uint interval)
+{
+  return temporal_create(field, interval);
+}
+
+void
+zfp_temporal_free(zfp_temporal* codec)
+{
+  if (codec) {
+    free(codec->reference);
+    free(codec->residual);
+    free(codec);
   }
+}
 
-  /* return 0 if decompression mode is not supported */
-  decompress = ftable[exec][strided][dims - 1][type - zfp_type_int32];
-  if (!decompress)
-    return 0;
+zfp_bool
+zfp_temporal_keyframe(const zfp_temporal* codec)
+{
+  return !codec->valid || (codec->interval && codec->frames >= codec->interval);
+}
 
-  /* decompress field and align bit stream on word boundary */
-  decompress(zfp, field);
-  stream_align(zfp->stream);
+void
+zfp_temporal_reset(zfp_temporal* codec)
+{
+  codec->valid = zfp_false;
+  codec->frames = 0;
+}
 
-  return stream_size(zfp->stream);
+zfp_bool
+zfp_temporal_set_reference(zfp_temporal* codec, const zfp_field* reference)
+{
+  if (!temporal_match(codec, reference))
+    return zfp_false;
+
+  temporal_copy(reference, codec->reference, zfp_true);
+  codec->valid = zfp_true;
+  codec->frames = 1;
+
+  return zfp_true;
 }
 
 size_t
-zfp_write_header(zfp_stream* zfp, const zfp_field* field, uint mask)
+zfp_temporal_compress(zfp_temporal* codec, zfp_stream* zfp, const zfp_field* field)
 {
-  size_t bits = 0;
-  uint64 meta = 0;
+  return temporal_compress(codec, zfp, field);
+}
 
-  /* first make sure field dimensions fit in header */
-  if (mask & ZFP_HEADER_META) {
-    meta = zfp_field_metadata(field);
-    if (meta == ZFP_META_NULL)
-      return 0;
-  }
+size_t
+zfp_temporal_decompress(zfp_temporal* codec, zfp_stream* zfp, zfp_field* field)
+{
+  return temporal_decompress(codec, zfp, field);
+}
 
-  /* 32-bit magic */
-  if (mask & ZFP_HEADER_MAGIC) {
-    stream_write_bits(zfp->stream, 'z', 8);
-    stream_write_bits(zfp->stream, 'f', 8);
-    stream_write_bits(zfp->stream, 'p', 8);
-    stream_write_bits(zfp->stream, zfp_codec_version, 8);
-    bits += ZFP_MAGIC_BITS;
-  }
-  /* 52-bit field metadata */
-  if (mask & ZFP_HEADER_META) {
-    stream_write_bits(zfp->stream, meta, ZFP_META_BITS);
-    bits += ZFP_META_BITS;
-  }
-  /* 12- or 64-bit compression parameters */
-  if (mask & ZFP_HEADER_MODE) {
-    uint64 mode = zfp_stream_mode(zfp);
-    uint size = mode > ZFP_MODE_SHORT_MAX ? ZFP_MODE_LONG_BITS : ZFP_MODE_SHORT_BITS;
-    stream_write_bits(zfp->stream, mode, size);
-    bits += size;
+/* public functions: incremental checkpoints ------------------------------- */
+
+#include "share/checkpoint.c"
+
+zfp_checkpoint*
+zfp_checkpoint_create(const zfp_field* field)
+{
+  return checkpoint_create(field);
+}
+
+void
+zfp_checkpoint_free(zfp_checkpoint* codec)
+{
+  if (codec) {
+    free(codec->hash);
+    free(codec->changed);
+    free(codec);
   }
+}
 
-  return bits;
+void
+zfp_checkpoint_reset(zfp_checkpoint* codec)
+{
+  codec->valid = zfp_false;
 }
 
 size_t
-zfp_read_header(zfp_stream* zfp, zfp_field* field, uint mask)
+zfp_checkpoint_blocks(const zfp_checkpoint* codec)
 {
-  size_t bits = 0;
-  if (mask & ZFP_HEADER_MAGIC) {
-    if (stream_read_bits(zfp->stream, 8) != 'z' ||
-        stream_read_bits(zfp->stream, 8) != 'f' ||
-        stream_read_bits(zfp->stream, 8) != 'p' ||
-        stream_read_bits(zfp->stream, 8) != zfp_codec_version)
-      return 0;
-    bits += ZFP_MAGIC_BITS;
-  }
-  if (mask & ZFP_HEADER_META) {
-    uint64 meta = stream_read_bits(zfp->stream, ZFP_META_BITS);
-    if (!zfp_field_set_metadata(field, meta))
-      return 0;
-    bits += ZFP_META_BITS;
-  }
-  if (mask & ZFP_HEADER_MODE) {
-    uint64 mode = stream_read_bits(zfp->stream, ZFP_MODE_SHORT_BITS);
-    bits += ZFP_MODE_SHORT_BITS;
-    if (mode > ZFP_MODE_SHORT_MAX) {
-      uint size = ZFP_MODE_LONG_BITS - ZFP_MODE_SHORT_BITS;
-      mode += stream_read_bits(zfp->stream, size) << ZFP_MODE_SHORT_BITS;
-      bits += size;
+  return codec->stored;
+}
+
+size_t
+zfp_checkpoint_write(zfp_checkpoint* codec, zfp_stream* zfp, const zfp_field* field)
+{
+  return checkpoint_write(codec, zfp, field);
+}
+
+size_t
+zfp_checkpoint_read(zfp_checkpoint* codec, zfp_stream* zfp, zfp_field* field)
+{
+  return checkpoint_read(codec, zfp, field);
+}
+
+/* public functions: cross-field prediction -------------------------------- */
+
+#include "share/predict.c"
+
+size_t
+zfp_compress_predicted(zfp_stream* zfp, const zfp_field* field, const zfp_field* primary, zfp_predictor predictor)
+{
+  return predict_compress(zfp, field, primary, predictor);
+}
+
+size_t
+zfp_decompress_predicted(zfp_stream* zfp, zfp_field* field, const zfp_field* primary, zfp_predictor predictor)
+{
+  return predict_decompress(zfp, field, primary, predictor);
+}
+
+/* public functions: spatial reordering ------------------------------------ */
+
+/* true if field is a 1D array of n values of given type */
+static zfp_bool
+is_vector(const zfp_field* field, zfp_type type, size_t n)
+{
+  return field && field->data && zfp_field_dimensionality(field) == 1 && field->type == type && field->nx == n;
+}
+
+zfp_bool
+zfp_morton_order(const zfp_stream* stream, size_t* perm, const zfp_field* const* coord, uint dims)
+{
+  uint threads = 1;
+  uint64* key;
+  size_t n, i;
+  uint d;
+  zfp_bool success;
+
+  if (!perm || !coord || dims < 1 || dims > 4 || !coord[0])
+    return zfp_false;
+  n = coord[0]->nx;
+  for (d = 0; d < dims; d++)
+    if (!coord[d] || (coord[d]->type != zfp_type_float && coord[d]->type != zfp_type_double) ||
+        !is_vector(coord[d], coord[d]->type, n))
+      return zfp_false;
+
+#ifdef _OPENMP
+  if (stream && stream->exec.policy == zfp_exec_omp)
+    threads = (uint)MIN((size_t)thread_count_omp(stream), MAX(n, 1));
+#else
+  (void)stream;
+#endif
+
+  key = (uint64*)malloc(MAX(n, 1) * sizeof(uint64));
+  if (!key)
+    return zfp_false;
+  for (i = 0; i < n; i++)
+    perm[i] = i;
+  morton_keys(key, coord, dims, n);
+  success = morton_sort(key, perm, n, threads);
+  free(key);
+
+  return success;
+}
+
+zfp_bool
+zfp_field_permute(zfp_field* dst, const zfp_field* src, const size_t* perm)
+{
+  size_t i;
+
+  if (!perm || !src || !is_vector(dst, src->type, src->nx) || !is_vector(src, src->type, src->nx))
+    return zfp_false;
+  for (i = 0; i < src->nx; i++)
+    morton_copy(dst, i, src, perm[i]);
+
+  return zfp_true;
+}
+
+zfp_bool
+zfp_field_unpermute(zfp_field* dst, const zfp_field* src, const size_t* perm)
+{
+  size_t i;
+
+  if (!perm || !src || !is_vector(dst, src->type, src->nx) || !is_vector(src, src->type, src->nx))
+    return zfp_false;
+  for (i = 0; i < src->nx; i++)
+    morton_copy(dst, perm[i], src, i);
+
+  return zfp_true;
+}
+
+/* public functions: 8-bit images ------------------------------------------ */
+
+/* true if image arguments are valid */
+static zfp_bool
+is_image(const uchar* pixels, size_t nx, size_t ny, uint channels)
+{
+  return pixels && nx && ny && 1 <= channels && channels <= 4;
+}
+
+size_t
+zfp_compress_image(zfp_stream* zfp, const uchar* pixels, size_t nx, size_t ny, uint channels, zfp_bool subsample)
+{
+  zfp_stream chroma;
+  size_t x, y;
+
+  if (!is_image(pixels, nx, ny, channels))
+    return 0;
+  subsample = subsample && channels >= 3;
+  image_chroma_params(&chroma, zfp);
+
+  /* compress the Y, Co, Cg, and alpha blocks of each tile in turn */
+  zfp_trace_begin("zfp:compress");
+  for (y = 0; y < ny; y += 4)
+    for (x = 0; x < nx; x += 4) {
+      int32 block[4][16];
+      size_t offset[16];
+      uint k;
+      image_offsets(offset, nx, ny, channels, x, y);
+      image_gather(block, pixels, offset, channels);
+      for (k = 0; k < channels; k++)
+        if (subsample && (k == 1 || k == 2)) {
+          image_chroma_downsample(block[k]);
+          zfp_encode_block_int32_1(&chroma, block[k]);
+        }
+        else
+          zfp_encode_block_int32_2(zfp, block[k]);
     }
-    if (zfp_stream_set_mode(zfp, mode) == zfp_mode_null)
-      return 0;
-  }
-  return bits;
+  zfp_trace_end();
+  stream_flush(zfp->stream);
+
+  return stream_size(zfp->stream);
+}
+
+size_t
+zfp_decompress_image(zfp_stream* zfp, uchar* pixels, size_t nx, size_t ny, uint channels, zfp_bool subsample)
+{
+  zfp_stream chroma;
+  size_t x, y;
+
+  if (!is_image(pixels, nx, ny, channels))
+    return 0;
+  subsample = subsample && channels >= 3;
+  image_chroma_params(&chroma, zfp);
+
+  zfp_trace_begin("zfp:decompress");
+  for (y = 0; y < ny; y += 4)
+    for (x = 0; x < nx; x += 4) {
+      int32 block[4][16];
+      size_t offset[16];
+      uint k;
+      for (k = 0; k < channels; k++)
+        if (subsample && (k == 1 || k == 2)) {
+          zfp_decode_block_int32_1(&chroma, block[k]);
+          image_chroma_upsample(block[k]);
+        }
+        else
+          zfp_decode_block_int32_2(zfp, block[k]);
+      image_offsets(offset, nx, ny, channels, x, y);
+      image_scatter(pixels, offset, channels, block, nx, ny, x, y);
+    }
+  zfp_trace_end();
+  stream_align(zfp->stream);
+
+  return stream_size(zfp->stream);
 }
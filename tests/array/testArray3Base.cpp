@@ -1,3 +1,7 @@
+#include <cmath>
+#include <thread>
+#include <vector>
+
 /* TODO: figure out templated tests (TYPED_TEST) */
 
 /* const_view */
@@ -499,6 +503,32 @@ TEST_P(TEST_FIXTURE, when_construct3dCompressedArrayFromPrivateConstView_then_pe
   EXPECT_NE(arr(offsetX, offsetY, offsetZ), arr2(0, 0, 0));
 }
 
+TEST_P(TEST_FIXTURE, given_privateConstViewWithMaxPrecision_when_read_then_fewerPlanesDecodedUntilLimitLifted)
+{
+  ZFP_ARRAY_TYPE arr(inputDataSideLen, inputDataSideLen, inputDataSideLen, getRate(), inputDataArr);
+  ZFP_ARRAY_TYPE::private_const_view v(&arr);
+  EXPECT_EQ((uint)ZFP_MAX_PREC, v.max_precision());
+
+  /* truncating bit planes cannot decrease the overall error */
+  double fullError = 0, cappedError = 0;
+  EXPECT_EQ(1u, v.set_max_precision(1));
+  for (size_t k = 0; k < arr.size_z(); k++)
+    for (size_t j = 0; j < arr.size_y(); j++)
+      for (size_t i = 0; i < arr.size_x(); i++) {
+        double value = inputDataArr[i + arr.size_x() * (j + arr.size_y() * k)];
+        fullError += std::fabs(value - (double)arr(i, j, k));
+        cappedError += std::fabs(value - (double)v(i, j, k));
+      }
+  EXPECT_GE(cappedError, fullError);
+
+  /* lifting the limit discards the truncated blocks */
+  EXPECT_EQ((uint)ZFP_MAX_PREC, v.set_max_precision(0));
+  for (size_t k = 0; k < arr.size_z(); k++)
+    for (size_t j = 0; j < arr.size_y(); j++)
+      for (size_t i = 0; i < arr.size_x(); i++)
+        EXPECT_EQ(arr(i, j, k), v(i, j, k));
+}
+
 /* private_view */
 
 TEST_P(TEST_FIXTURE, when_construct3dCompressedArrayFromPrivateView_then_rateConserved)
@@ -569,3 +599,844 @@ TEST_P(TEST_FIXTURE, when_construct3dCompressedArrayFromPrivateView_then_perform
   EXPECT_NE(arr(offsetX, offsetY, offsetZ), arr2(0, 0, 0));
 }
 
+
+/* variable-rate storage */
+
+TEST_P(TEST_FIXTURE, given_reversible3dCompressedArray_when_setAndGet_then_valuesPreservedExactly)
+{
+  ZFP_ARRAY_TYPE arr(inputDataSideLen, inputDataSideLen, inputDataSideLen, getRate());
+  arr.set_reversible();
+  EXPECT_EQ(zfp_mode_reversible, arr.mode());
+
+  arr.set(inputDataArr);
+  SCALAR* decompressedArr = new SCALAR[inputDataTotalLen];
+  arr.get(decompressedArr);
+
+  for (size_t i = 0; i < inputDataTotalLen; i++)
+    EXPECT_EQ(inputDataArr[i], decompressedArr[i]);
+
+  delete[] decompressedArr;
+}
+
+TEST_P(TEST_FIXTURE, given_fixedAccuracy3dCompressedArray_when_blocksRewritten_then_errorWithinToleranceAfterCompaction)
+{
+  ZFP_ARRAY_TYPE arr(inputDataSideLen, inputDataSideLen, inputDataSideLen, getRate());
+  double tolerance = arr.set_accuracy(1e-3);
+  EXPECT_EQ(zfp_mode_fixed_accuracy, arr.mode());
+
+  /* overwrite initially all-zero blocks, which relocates them within the store */
+  arr.set(inputDataArr);
+  arr.compact();
+
+  SCALAR* decompressedArr = new SCALAR[inputDataTotalLen];
+  arr.get(decompressedArr);
+
+  for (size_t i = 0; i < inputDataTotalLen; i++)
+    EXPECT_LE(std::fabs(double(inputDataArr[i] - decompressedArr[i])), tolerance);
+
+  delete[] decompressedArr;
+}
+
+TEST_P(TEST_FIXTURE, given_budgetedArray_when_set_then_compressedSizeWithinBudgetAndErrorWithinAccuracy)
+{
+  // budget of about 4 bits per value
+  size_t budget = inputDataTotalLen / 2;
+  ZFP_ARRAY_TYPE arr(inputDataSideLen, inputDataSideLen, inputDataSideLen, zfp::budget(budget));
+  EXPECT_EQ(zfp_mode_fixed_accuracy, arr.mode());
+  EXPECT_EQ(budget, arr.budget());
+  EXPECT_EQ(0, arr.accuracy());
+
+  arr.set(inputDataArr);
+  EXPECT_LE(arr.rate() * arr.size(), CHAR_BIT * budget);
+  double tolerance = arr.accuracy();
+  EXPECT_LT(0, tolerance);
+
+  // a larger budget gives a smaller tolerance
+  ZFP_ARRAY_TYPE arr2(inputDataSideLen, inputDataSideLen, inputDataSideLen, zfp::budget(4 * budget), inputDataArr);
+  EXPECT_LT(arr2.accuracy(), tolerance);
+
+  // each raise of the tolerance at least doubles it, so that errors
+  // accumulated by re-encoding blocks sum to less than twice the tolerance
+  SCALAR* decompressedArr = new SCALAR[inputDataTotalLen];
+  arr.get(decompressedArr);
+  for (size_t i = 0; i < inputDataTotalLen; i++)
+    EXPECT_LE(std::fabs(double(inputDataArr[i] - decompressedArr[i])), 2 * tolerance);
+  delete[] decompressedArr;
+
+  // other compression modes lift the budget
+  arr.set_accuracy(1e-3);
+  EXPECT_EQ(0u, arr.budget());
+}
+
+/* cache replacement policies */
+
+TEST_P(TEST_FIXTURE, given_setAssociativeCachePolicies_when_get_then_matchesDirectMappedCache)
+{
+  ZFP_ARRAY_TYPE arr(inputDataSideLen, inputDataSideLen, inputDataSideLen, getRate(), inputDataArr);
+  SCALAR* expectedArr = new SCALAR[inputDataTotalLen];
+  SCALAR* decompressedArr = new SCALAR[inputDataTotalLen];
+  arr.get(expectedArr);
+
+  zfp::cache_policy policies[] = { zfp::cache_lru, zfp::cache_clock, zfp::cache_arc };
+  for (size_t p = 0; p < sizeof(policies) / sizeof(policies[0]); p++) {
+    ZFP_ARRAY_TYPE arr2(inputDataSideLen, inputDataSideLen, inputDataSideLen, getRate(), inputDataArr);
+    arr2.set_cache_policy(policies[p], 4);
+    for (size_t i = 0; i < inputDataTotalLen; i++)
+      decompressedArr[i] = arr2[i];
+    for (size_t i = 0; i < inputDataTotalLen; i++)
+      EXPECT_EQ(expectedArr[i], decompressedArr[i]);
+  }
+
+  delete[] expectedArr;
+  delete[] decompressedArr;
+}
+
+/* cache statistics */
+
+TEST_P(TEST_FIXTURE, given_cacheStatsEnabled_when_blocksAccessed_then_hitsAndMissesCounted)
+{
+  ZFP_ARRAY_TYPE arr(inputDataSideLen, inputDataSideLen, inputDataSideLen, getRate(), inputDataArr);
+  arr.set_cache_stats(true);
+
+  /* first access to a block misses; repeated access to it hits */
+  SCALAR val = arr(0, 0, 0);
+  val += arr(1, 0, 0);
+  zfp::cache_statistics stats = arr.cache_stats();
+  EXPECT_EQ(1u, stats.misses);
+  EXPECT_EQ(1u, stats.hits);
+  EXPECT_EQ(1u, stats.decodes);
+
+  /* modified block is written back on flush */
+  arr(0, 0, 0) = val;
+  arr.flush_cache();
+  stats = arr.cache_stats();
+  EXPECT_EQ(1u, stats.writebacks);
+  EXPECT_EQ(1u, stats.encodes);
+
+  arr.reset_cache_stats();
+  stats = arr.cache_stats();
+  EXPECT_EQ(0u, stats.hits + stats.misses + stats.writebacks);
+}
+
+/* cache prefetching */
+
+TEST_P(TEST_FIXTURE, given_cachePrefetchEnabled_when_iterated_then_fewerMissesAndSameValues)
+{
+  ZFP_ARRAY_TYPE arr(inputDataSideLen, inputDataSideLen, inputDataSideLen, getRate(), inputDataArr);
+  ZFP_ARRAY_TYPE arr2(arr);
+  arr.set_cache_stats(true);
+  arr2.set_cache_stats(true);
+  arr2.set_cache_prefetch(3);
+
+  for (ZFP_ARRAY_TYPE::const_iterator it = arr.cbegin(), it2 = arr2.cbegin(); it != arr.cend(); ++it, ++it2)
+    EXPECT_EQ(*it, *it2);
+
+  zfp::cache_statistics stats = arr.cache_stats();
+  zfp::cache_statistics stats2 = arr2.cache_stats();
+  EXPECT_LT(stats2.misses, stats.misses);
+  EXPECT_LT(0u, stats2.prefetches);
+  EXPECT_EQ(stats.misses, stats2.misses + stats2.prefetches);
+}
+
+/* write-behind */
+
+TEST_P(TEST_FIXTURE, given_writeBehindEnabled_when_setEntries_then_sameValuesAsWithout)
+{
+  /* a few blocks more than the two-block cache holds suffice to evict through the queue */
+  const size_t n = 12;
+  ZFP_ARRAY_TYPE arr(n, n, n, getRate(), 0, 2 * 64 * sizeof(SCALAR));
+  arr.set_reversible();
+  ZFP_ARRAY_TYPE arr2(arr);
+  arr2.set_cache_write_behind(4);
+
+  for (size_t i = 0; i < n * n * n; i++) {
+    arr[i] = inputDataArr[i];
+    arr2[i] = inputDataArr[i];
+  }
+
+  /* modified blocks are visible before and after flushing */
+  for (size_t i = 0; i < n * n * n; i++)
+    EXPECT_EQ(arr[i], arr2[i]);
+  arr2.flush_cache();
+  arr2.clear_cache();
+  for (size_t i = 0; i < n * n * n; i++)
+    EXPECT_EQ(inputDataArr[i], arr2[i]);
+}
+
+/* bulk get */
+
+TEST_P(TEST_FIXTURE, given_modifiedCachedEntry_when_get_then_modifiedValueReturned)
+{
+  ZFP_ARRAY_TYPE arr(inputDataSideLen, inputDataSideLen, inputDataSideLen, getRate(), inputDataArr);
+  SCALAR val = arr(1, 2, 3) + 1;
+  arr(1, 2, 3) = val;
+
+  SCALAR* decompressedArr = new SCALAR[inputDataTotalLen];
+  arr.get(decompressedArr);
+  EXPECT_EQ(val, decompressedArr[1 + inputDataSideLen * (2 + inputDataSideLen * 3)]);
+
+  delete[] decompressedArr;
+}
+
+/* block visitor */
+
+class BlockSetter {
+public:
+  BlockSetter(SCALAR val) : val(val), count(0) {}
+  void operator()(SCALAR* p, size_t, size_t, size_t, size_t mx, size_t my, size_t mz)
+  {
+    for (size_t z = 0; z < mz; z++)
+      for (size_t y = 0; y < my; y++)
+        for (size_t x = 0; x < mx; x++, count++)
+          p[x + 4 * (y + 4 * z)] = val;
+  }
+  SCALAR val;
+  size_t count;
+};
+
+TEST_P(TEST_FIXTURE, given_viewBlockVisitor_when_blocksModified_then_onlyViewEntriesChanged)
+{
+  ZFP_ARRAY_TYPE arr(inputDataSideLen, inputDataSideLen, inputDataSideLen, getRate());
+  /* blocks are recompressed on flush, so code them losslessly */
+  arr.set_reversible();
+  ZFP_ARRAY_TYPE::view v(&arr, 1, 2, 3, 5, 4, 3);
+
+  BlockSetter setter = v.for_each_block(BlockSetter(1));
+  EXPECT_EQ(v.size(), setter.count);
+
+  arr.flush_cache();
+  for (size_t k = 0; k < arr.size_z(); k++)
+    for (size_t j = 0; j < arr.size_y(); j++)
+      for (size_t i = 0; i < arr.size_x(); i++) {
+        bool inside = 1 <= i && i < 6 && 2 <= j && j < 6 && 3 <= k && k < 6;
+        EXPECT_EQ(inside ? 1 : 0, arr(i, j, k));
+      }
+}
+
+/* parallel_for */
+
+class IndexAdder {
+public:
+  void operator()(size_t i, size_t j, size_t k, SCALAR& v) const { v += (SCALAR)(i + j + k); }
+};
+
+TEST_P(TEST_FIXTURE, given_array_when_parallelFor_then_everyEntryUpdatedOnce)
+{
+  ZFP_ARRAY_TYPE arr(inputDataSideLen, inputDataSideLen, inputDataSideLen, getRate());
+  arr.set_reversible();
+
+  zfp::parallel_for(arr, IndexAdder());
+
+  for (size_t k = 0; k < arr.size_z(); k++)
+    for (size_t j = 0; j < arr.size_y(); j++)
+      for (size_t i = 0; i < arr.size_x(); i++)
+        EXPECT_EQ((SCALAR)(i + j + k), arr(i, j, k));
+}
+
+/* block_range */
+
+TEST_P(TEST_FIXTURE, given_array_when_blockRangesModified_then_everyEntryUpdatedOnce)
+{
+  ZFP_ARRAY_TYPE arr(inputDataSideLen, inputDataSideLen, inputDataSideLen, getRate());
+  arr.set_reversible();
+
+  std::vector<ZFP_ARRAY_TYPE::block_range> ranges = arr.block_ranges(5);
+  EXPECT_EQ(5u, ranges.size());
+  for (size_t r = 0; r < ranges.size(); r++)
+    ranges[r].for_each(IndexAdder());
+  arr.clear_cache();
+
+  for (size_t k = 0; k < arr.size_z(); k++)
+    for (size_t j = 0; j < arr.size_y(); j++)
+      for (size_t i = 0; i < arr.size_x(); i++)
+        EXPECT_EQ((SCALAR)(i + j + k), arr(i, j, k));
+}
+
+class RangeSplit {};
+
+class ElementCounter {
+public:
+  ElementCounter() : count(0) {}
+  void operator()(size_t, size_t, size_t, const SCALAR&) { count++; }
+  size_t count;
+};
+
+TEST_P(TEST_FIXTURE, given_blockRange_when_splitRecursively_then_singleBlockRangesCoverArray)
+{
+  ZFP_ARRAY_TYPE arr(inputDataSideLen, inputDataSideLen, inputDataSideLen, getRate());
+  std::vector<ZFP_ARRAY_TYPE::block_range> work(1, ZFP_ARRAY_TYPE::block_range(&arr));
+  size_t ranges = 0;
+  size_t count = 0;
+  while (!work.empty()) {
+    ZFP_ARRAY_TYPE::block_range r = work.back();
+    work.pop_back();
+    if (r.is_divisible()) {
+      ZFP_ARRAY_TYPE::block_range s(r, RangeSplit());
+      EXPECT_FALSE(r.empty());
+      EXPECT_FALSE(s.empty());
+      work.push_back(r);
+      work.push_back(s);
+    }
+    else {
+      EXPECT_EQ(1u, r.blocks());
+      count += r.for_each_const(ElementCounter()).count;
+      ranges++;
+    }
+  }
+
+  size_t blocks = ((arr.size_x() + 3) / 4) * ((arr.size_y() + 3) / 4) * ((arr.size_z() + 3) / 4);
+  EXPECT_EQ(blocks, ranges);
+  EXPECT_EQ(arr.size(), count);
+}
+
+/* stencil_view */
+
+class Laplacian {
+public:
+  Laplacian(const ZFP_ARRAY_TYPE& arr) : arr(arr), mismatches(0) {}
+  void operator()(size_t i, size_t j, size_t k, const ZFP_ARRAY_TYPE::stencil_view& s)
+  {
+    if (0 < i && i + 1 < arr.size_x() && 0 < j && j + 1 < arr.size_y() && 0 < k && k + 1 < arr.size_z()) {
+      SCALAR expected = arr(i - 1, j, k) + arr(i + 1, j, k) + arr(i, j - 1, k) + arr(i, j + 1, k) + arr(i, j, k - 1) + arr(i, j, k + 1) - 6 * arr(i, j, k);
+      SCALAR actual = s(-1, 0, 0) + s(1, 0, 0) + s(0, -1, 0) + s(0, 1, 0) + s(0, 0, -1) + s(0, 0, 1) - 6 * s(0, 0, 0);
+      if (expected != actual)
+        mismatches++;
+    }
+  }
+  const ZFP_ARRAY_TYPE& arr;
+  size_t mismatches;
+};
+
+TEST_P(TEST_FIXTURE, given_stencilView_when_forEach_then_neighborsMatchArrayEntries)
+{
+  ZFP_ARRAY_TYPE arr(inputDataSideLen, inputDataSideLen, inputDataSideLen, getRate(), inputDataArr);
+  const ZFP_ARRAY_TYPE& carr = arr;
+  ZFP_ARRAY_TYPE::stencil_view s(&arr);
+
+  Laplacian laplacian = s.for_each(Laplacian(carr));
+  EXPECT_EQ(0u, laplacian.mismatches);
+}
+
+/* shared_const_view */
+
+TEST_P(TEST_FIXTURE, given_sharedConstView_when_readByThreads_then_valuesMatchArrayAndBlocksDecodedOnce)
+{
+  ZFP_ARRAY_TYPE arr(inputDataSideLen, inputDataSideLen, inputDataSideLen, getRate(), inputDataArr);
+  size_t blocks = ((arr.size_x() + 3) / 4) * ((arr.size_y() + 3) / 4) * ((arr.size_z() + 3) / 4);
+  ZFP_ARRAY_TYPE::shared_const_view v(&arr, 2 * blocks * 64 * sizeof(SCALAR));
+  const ZFP_ARRAY_TYPE& carr = arr;
+
+  // array cache is not thread safe; decompress expected values up front
+  SCALAR* expectedArr = new SCALAR[inputDataTotalLen];
+  arr.get(expectedArr);
+
+  size_t mismatches = 0;
+  #pragma omp parallel for reduction(+:mismatches)
+  for (ptrdiff_t k = 0; k < (ptrdiff_t)arr.size_z(); k++)
+    for (size_t j = 0; j < arr.size_y(); j++)
+      for (size_t i = 0; i < arr.size_x(); i++)
+        if (v(i, j, k) != expectedArr[i + arr.size_x() * (j + arr.size_y() * k)])
+          mismatches++;
+  EXPECT_EQ(0u, mismatches);
+  delete[] expectedArr;
+
+  // a cache that holds all blocks decodes each block once
+  v.clear_cache();
+  size_t decodes = v.decodes();
+  for (ZFP_ARRAY_TYPE::shared_const_view::const_iterator it = v.begin(); it != v.end(); it++)
+    EXPECT_EQ(carr(it.i(), it.j(), it.k()), *it);
+  EXPECT_EQ(blocks, v.decodes() - decodes);
+}
+
+TEST_P(TEST_FIXTURE, given_sharedConstView_when_readByStdThreads_then_valuesMatchArray)
+{
+  ZFP_ARRAY_TYPE arr(inputDataSideLen, inputDataSideLen, inputDataSideLen, getRate(), inputDataArr);
+  ZFP_ARRAY_TYPE::shared_const_view v(&arr);
+
+  // array cache is not thread safe; decompress expected values up front
+  std::vector<SCALAR> expectedArr(inputDataTotalLen);
+  arr.get(&expectedArr[0]);
+
+  // threads outside any OpenMP team must not share a codec; each thread
+  // starts at a different slab so that blocks are decoded concurrently
+  const size_t threads = 8;
+  const size_t nx = arr.size_x(), ny = arr.size_y(), nz = arr.size_z();
+  std::vector<size_t> mismatches(threads, 0);
+  std::vector<std::thread> reader;
+  for (size_t t = 0; t < threads; t++)
+    reader.push_back(std::thread([&, t]() {
+      for (size_t n = 0; n < nz; n++) {
+        size_t k = (n + t * nz / threads) % nz;
+        for (size_t j = 0; j < ny; j++)
+          for (size_t i = 0; i < nx; i++)
+            if (v(i, j, k) != expectedArr[i + nx * (j + ny * k)])
+              mismatches[t]++;
+      }
+    }));
+  for (size_t t = 0; t < threads; t++) {
+    reader[t].join();
+    EXPECT_EQ(0u, mismatches[t]);
+  }
+}
+
+/* point sampling */
+
+TEST_P(TEST_FIXTURE, given_scatteredPoints_when_sample_then_nearestAndInterpolatedValuesMatchArray)
+{
+  ZFP_ARRAY_TYPE arr(inputDataSideLen, inputDataSideLen, inputDataSideLen, getRate(), inputDataArr);
+  const ZFP_ARRAY_TYPE& carr = arr;
+  const size_t n = 200;
+  const double max = double(inputDataSideLen - 1);
+  std::vector<double> points(3 * n);
+  for (size_t i = 0; i < 3 * n; i++)
+    points[i] = max * double((i * 7919) % 1000) / 999;
+  // modify a cached block, which sampling must see
+  arr(0, 0, 0) = 1;
+  points[0] = points[1] = points[2] = 0.25;
+
+  std::vector<SCALAR> nearest(n), interpolated(n);
+  arr.sample(&points[0], n, &nearest[0]);
+  arr.sample(&points[0], n, &interpolated[0], true);
+
+  for (size_t p = 0; p < n; p++) {
+    const double* x = &points[3 * p];
+    size_t i0 = size_t(x[0]), j0 = size_t(x[1]), k0 = size_t(x[2]);
+    EXPECT_EQ(carr(size_t(x[0] + 0.5), size_t(x[1] + 0.5), size_t(x[2] + 0.5)), nearest[p]);
+    double tx = x[0] - double(i0), ty = x[1] - double(j0), tz = x[2] - double(k0);
+    double sum = 0;
+    for (uint c = 0; c < 8; c++) {
+      size_t i = std::min(i0 + (c & 1u), size_t(max));
+      size_t j = std::min(j0 + ((c >> 1) & 1u), size_t(max));
+      size_t k = std::min(k0 + ((c >> 2) & 1u), size_t(max));
+      sum += ((c & 1u) ? tx : 1 - tx) * ((c & 2u) ? ty : 1 - ty) * ((c & 4u) ? tz : 1 - tz) * double(carr(i, j, k));
+    }
+    EXPECT_EQ(SCALAR(sum), interpolated[p]);
+  }
+}
+
+/* custom allocator */
+
+class CountingAllocator : public zfp::allocator {
+public:
+  CountingAllocator() : live(0) {}
+  void* allocate(size_t size, size_t alignment) { live++; return zfp::allocate_aligned(size, alignment); }
+  void deallocate(void* ptr) { live--; zfp::deallocate_aligned(ptr); }
+  int live;
+};
+
+TEST_P(TEST_FIXTURE, given_customAllocator_when_setAllocator_then_contentsPreservedAndMemoryReleased)
+{
+  CountingAllocator memory;
+  {
+    ZFP_ARRAY_TYPE arr(inputDataSideLen, inputDataSideLen, inputDataSideLen, getRate(), inputDataArr);
+    SCALAR* expectedArr = new SCALAR[inputDataTotalLen];
+    arr.get(expectedArr);
+
+    arr.set_allocator(&memory);
+    EXPECT_LT(0, memory.live);
+
+    SCALAR* decompressedArr = new SCALAR[inputDataTotalLen];
+    arr.get(decompressedArr);
+    for (size_t i = 0; i < inputDataTotalLen; i++)
+      EXPECT_EQ(expectedArr[i], decompressedArr[i]);
+
+    delete[] expectedArr;
+    delete[] decompressedArr;
+  }
+  EXPECT_EQ(0, memory.live);
+}
+
+/* borrowed compressed data */
+
+TEST_P(TEST_FIXTURE, given_borrowedBuffer_when_modified_then_bufferCopiedAndLeftUnchanged)
+{
+  ZFP_ARRAY_TYPE arr(inputDataSideLen, inputDataSideLen, inputDataSideLen, getRate(), inputDataArr);
+  ZFP_ARRAY_TYPE::header h(arr);
+  size_t bytes = arr.compressed_size();
+  uchar* buffer = new uchar[bytes];
+  std::memcpy(buffer, arr.compressed_data(), bytes);
+
+  ZFP_ARRAY_TYPE arr2(h, buffer, bytes, true);
+  EXPECT_TRUE(arr2.borrowed());
+  EXPECT_EQ(buffer, arr2.compressed_data());
+  for (size_t i = 0; i < inputDataTotalLen; i++)
+    EXPECT_EQ(arr[i], arr2[i]);
+  EXPECT_TRUE(arr2.borrowed());
+
+  arr2(0, 0, 0) = 1;
+  arr2.flush_cache();
+  EXPECT_FALSE(arr2.borrowed());
+  EXPECT_NE(buffer, arr2.compressed_data());
+  EXPECT_EQ(0, std::memcmp(buffer, arr.compressed_data(), bytes));
+
+  delete[] buffer;
+}
+
+/* swap */
+
+TEST_P(TEST_FIXTURE, given_twoArrays_when_swap_then_contentsAndStorageExchanged)
+{
+  ZFP_ARRAY_TYPE arr(inputDataSideLen, inputDataSideLen, inputDataSideLen, getRate(), inputDataArr);
+  ZFP_ARRAY_TYPE arr2(1, 2, 3, getRate());
+  arr(1, 1, 1) = 1;
+  // compressed_data() flushes the cache, so read values back afterwards
+  const void* data = arr.compressed_data();
+  SCALAR* expectedArr = new SCALAR[inputDataTotalLen];
+  arr.get(expectedArr);
+
+  arr.swap(arr2);
+  EXPECT_EQ(1u, arr.size_x());
+  EXPECT_EQ(3u, arr.size_z());
+  EXPECT_EQ(inputDataSideLen, arr2.size_x());
+  EXPECT_EQ(data, arr2.compressed_data());
+  for (size_t i = 0; i < inputDataTotalLen; i++)
+    EXPECT_EQ(expectedArr[i], arr2[i]);
+
+  delete[] expectedArr;
+}
+
+/* snapshot */
+
+TEST_P(TEST_FIXTURE, given_snapshot_when_arrayModified_then_snapshotUnchangedAndOnlyModifiedBlocksCopied)
+{
+  ZFP_ARRAY_TYPE arr(inputDataSideLen, inputDataSideLen, inputDataSideLen, getRate(), inputDataArr);
+  SCALAR* expectedArr = new SCALAR[inputDataTotalLen];
+  arr.get(expectedArr);
+
+  ZFP_ARRAY_TYPE::snapshot_view snap = arr.snapshot();
+  EXPECT_EQ(0u, snap.preserved_blocks());
+
+  arr(0, 0, 0) = 1;
+  arr.flush_cache();
+  EXPECT_EQ(1u, snap.preserved_blocks());
+
+  SCALAR* snapshotArr = new SCALAR[inputDataTotalLen];
+  snap.get(snapshotArr);
+  for (size_t i = 0; i < inputDataTotalLen; i++)
+    EXPECT_EQ(expectedArr[i], snapshotArr[i]);
+
+  delete[] expectedArr;
+  delete[] snapshotArr;
+}
+
+/* set_rate_preserving */
+
+TEST_P(TEST_FIXTURE, given_fixedRateArray_when_setRatePreserving_then_matchesArrayCompressedAtLowerRate)
+{
+  ZFP_ARRAY_TYPE arr(inputDataSideLen, inputDataSideLen, inputDataSideLen, getRate(), inputDataArr);
+  double rate = arr.set_rate_preserving(getRate() / 2);
+  ZFP_ARRAY_TYPE arr2(inputDataSideLen, inputDataSideLen, inputDataSideLen, rate, inputDataArr);
+
+  EXPECT_EQ(arr2.rate(), arr.rate());
+  ASSERT_EQ(arr2.compressed_size(), arr.compressed_size());
+  EXPECT_EQ(0, std::memcmp(arr2.compressed_data(), arr.compressed_data(), arr.compressed_size()));
+  for (size_t i = 0; i < inputDataTotalLen; i++)
+    EXPECT_EQ(arr2[i], arr[i]);
+}
+
+/* resize_preserving */
+
+TEST_P(TEST_FIXTURE, given_array_when_resizePreservingToBlockMultiple_then_overlapUnchangedAndRestZero)
+{
+  ZFP_ARRAY_TYPE arr(inputDataSideLen, inputDataSideLen, inputDataSideLen, getRate(), inputDataArr);
+  // n spans whole blocks only; elements past p lie in blocks not in arr
+  size_t n = inputDataSideLen & ~size_t(3);
+  size_t p = (inputDataSideLen + 3) & ~size_t(3);
+  size_t m = p + 4;
+  ZFP_ARRAY_TYPE expected(arr);
+
+  arr.resize_preserving(m, n, m);
+  EXPECT_EQ(m, arr.size_x());
+  EXPECT_EQ(n, arr.size_y());
+  EXPECT_EQ(m, arr.size_z());
+  for (size_t k = 0; k < m; k++)
+    for (size_t j = 0; j < n; j++)
+      for (size_t i = 0; i < m; i++) {
+        if (i < n && k < n)
+          EXPECT_EQ(expected(i, j, k), arr(i, j, k));
+        else if (i >= p || k >= p)
+          EXPECT_EQ(0, arr(i, j, k));
+      }
+}
+
+/* set_block_order */
+
+TEST_P(TEST_FIXTURE, given_fixedRateArray_when_setBlockOrderMortonAndBack_then_valuesAndStreamUnchanged)
+{
+  ZFP_ARRAY_TYPE arr(inputDataSideLen, inputDataSideLen, inputDataSideLen, getRate(), inputDataArr);
+  ZFP_ARRAY_TYPE expected(arr);
+
+  arr.set_block_order(zfp::block_order_morton);
+  EXPECT_EQ(zfp::block_order_morton, arr.block_order());
+  for (size_t i = 0; i < inputDataTotalLen; i++)
+    EXPECT_EQ(expected[i], arr[i]);
+
+  arr.set_block_order(zfp::block_order_raster);
+  ASSERT_EQ(expected.compressed_size(), arr.compressed_size());
+  EXPECT_EQ(0, std::memcmp(expected.compressed_data(), arr.compressed_data(), arr.compressed_size()));
+}
+
+/* generate */
+
+class LinearFunction {
+public:
+  double operator()(size_t i, size_t j, size_t k) const { return double(i) + 2 * double(j) - 0.5 * double(k); }
+};
+
+TEST_P(TEST_FIXTURE, given_fixedRateArray_when_generate_then_matchesArraySetFromSameValues)
+{
+  LinearFunction f;
+  SCALAR* data = new SCALAR[inputDataTotalLen];
+  for (size_t k = 0; k < inputDataSideLen; k++)
+    for (size_t j = 0; j < inputDataSideLen; j++)
+      for (size_t i = 0; i < inputDataSideLen; i++)
+        data[i + inputDataSideLen * (j + inputDataSideLen * k)] = (SCALAR)f(i, j, k);
+
+  ZFP_ARRAY_TYPE expected(inputDataSideLen, inputDataSideLen, inputDataSideLen, getRate(), data);
+  ZFP_ARRAY_TYPE arr(inputDataSideLen, inputDataSideLen, inputDataSideLen, getRate());
+  arr.generate(f);
+
+  ASSERT_EQ(expected.compressed_size(), arr.compressed_size());
+  EXPECT_EQ(0, std::memcmp(expected.compressed_data(), arr.compressed_data(), arr.compressed_size()));
+
+  delete[] data;
+}
+
+/* set_cache_skip_unchanged */
+
+TEST_P(TEST_FIXTURE, given_skipUnchangedEnabled_when_blocksWrittenWithSameValues_then_noBlocksCompressed)
+{
+  ZFP_ARRAY_TYPE arr(inputDataSideLen, inputDataSideLen, inputDataSideLen, getRate(), inputDataArr);
+  ZFP_ARRAY_TYPE expected(arr);
+  arr.set_cache_skip_unchanged(true);
+  arr.set_cache_stats(true);
+
+  for (size_t i = 0; i < inputDataTotalLen; i++)
+    arr[i] = (SCALAR)arr[i];
+  arr.flush_cache();
+
+  EXPECT_EQ(0u, arr.cache_stats().encodes);
+  EXPECT_EQ(arr.cache_stats().writebacks, arr.cache_stats().unchanged);
+  EXPECT_EQ(0, std::memcmp(expected.compressed_data(), arr.compressed_data(), arr.compressed_size()));
+}
+
+/* pack and unpack */
+
+TEST_P(TEST_FIXTURE, given_fixedRateArray_when_packedBoxUnpackedElsewhere_then_valuesCopiedWithoutReencoding)
+{
+  ZFP_ARRAY_TYPE arr(inputDataSideLen, inputDataSideLen, inputDataSideLen, getRate(), inputDataArr);
+  ZFP_ARRAY_TYPE dst(inputDataSideLen, inputDataSideLen, inputDataSideLen, getRate());
+
+  size_t bytes = arr.packed_size(0, 0, 0, 8, 8, 8);
+  EXPECT_EQ(size_t(8 * 64 * arr.rate() / CHAR_BIT), bytes);
+  unsigned char* buffer = new unsigned char[bytes];
+  EXPECT_EQ(bytes, arr.pack(buffer, 0, 0, 0, 8, 8, 8));
+  EXPECT_EQ(bytes, dst.unpack(buffer, 4, 4, 4, 8, 8, 8));
+
+  for (size_t k = 0; k < 8; k++)
+    for (size_t j = 0; j < 8; j++)
+      for (size_t i = 0; i < 8; i++)
+        EXPECT_EQ(arr(i, j, k), dst(i + 4, j + 4, k + 4));
+  EXPECT_EQ(0, (SCALAR)dst(0, 0, 0));
+
+  delete[] buffer;
+}
+
+TEST_P(TEST_FIXTURE, given_fixedAccuracyArray_when_packedBoxUnpackedElsewhere_then_valuesCopied)
+{
+  ZFP_ARRAY_TYPE arr(inputDataSideLen, inputDataSideLen, inputDataSideLen, getRate());
+  ZFP_ARRAY_TYPE dst(inputDataSideLen, inputDataSideLen, inputDataSideLen, getRate());
+  arr.set_accuracy(1e-3);
+  dst.set_accuracy(1e-3);
+  arr.set(inputDataArr);
+
+  size_t bytes = arr.packed_size(0, 0, 0, 8, 4, 4);
+  std::vector<unsigned char> buffer(bytes);
+  EXPECT_EQ(bytes, arr.pack(&buffer[0], 0, 0, 0, 8, 4, 4));
+  EXPECT_EQ(bytes, dst.unpack(&buffer[0], 0, 4, 8, 8, 4, 4));
+
+  for (size_t k = 0; k < 4; k++)
+    for (size_t j = 0; j < 4; j++)
+      for (size_t i = 0; i < 8; i++)
+        EXPECT_EQ(arr(i, j, k), dst(i, j + 4, k + 8));
+}
+
+/* block copies */
+
+TEST_P(TEST_FIXTURE, given_fixedRateArrays_when_blockAlignedBoxCopied_then_valuesCopiedWithoutReencoding)
+{
+  ZFP_ARRAY_TYPE arr(inputDataSideLen, inputDataSideLen, inputDataSideLen, getRate(), inputDataArr);
+  ZFP_ARRAY_TYPE dst(inputDataSideLen, inputDataSideLen, inputDataSideLen, getRate());
+  dst.set_cache_stats(true);
+
+  copy_blocks(arr, 4, 0, 4, 8, 8, 8, dst, 0, 4, 8);
+  dst.flush_cache();
+  EXPECT_EQ(0u, dst.cache_stats().encodes);
+
+  for (size_t k = 0; k < 8; k++)
+    for (size_t j = 0; j < 8; j++)
+      for (size_t i = 0; i < 8; i++)
+        EXPECT_EQ(arr(i + 4, j, k + 4), dst(i, j + 4, k + 8));
+  EXPECT_EQ(0, (SCALAR)dst(8, 0, 0));
+}
+
+TEST_P(TEST_FIXTURE, given_fixedAccuracyArrays_when_unalignedBoxCopied_then_onlyEdgeBlocksReencoded)
+{
+  ZFP_ARRAY_TYPE arr(inputDataSideLen, inputDataSideLen, inputDataSideLen, getRate());
+  ZFP_ARRAY_TYPE dst(inputDataSideLen, inputDataSideLen, inputDataSideLen, getRate());
+  arr.set_accuracy(1e-3);
+  dst.set_accuracy(1e-3);
+  arr.set(inputDataArr);
+
+  // box spans 2 x 3 x 2 blocks, of which only block (4..7, 4..7, 4..7) is covered
+  copy_blocks(arr, 1, 2, 3, 7, 9, 5, dst, 1, 2, 3);
+
+  for (size_t k = 3; k < 8; k++)
+    for (size_t j = 2; j < 11; j++)
+      for (size_t i = 1; i < 8; i++) {
+        if (i >= 4 && j >= 4 && j < 8 && k >= 4)
+          EXPECT_EQ(arr(i, j, k), dst(i, j, k));
+        else
+          EXPECT_NEAR(arr(i, j, k), dst(i, j, k), 1e-3);
+      }
+  EXPECT_EQ(0, (SCALAR)dst(0, 12, 0));
+  EXPECT_EQ(0, (SCALAR)dst(8, 8, 8));
+}
+
+/* memory accounting */
+
+TEST_P(TEST_FIXTURE, given_hostCacheLimit_when_setCacheSize_then_cacheShrunkAndAccounted)
+{
+  size_t base = zfp_memory_query(zfp_memory_host_cache).current;
+  {
+    ZFP_ARRAY_TYPE arr(inputDataSideLen, inputDataSideLen, inputDataSideLen, getRate(), inputDataArr);
+    ZFP_ARRAY_TYPE ref(arr);
+    EXPECT_LE(2 * arr.cache_size(), zfp_memory_query(zfp_memory_host_cache).current - base);
+
+    size_t limit = zfp_memory_query(zfp_memory_host_cache).current + (1u << 14);
+    zfp_memory_set_limit(zfp_memory_host_cache, limit);
+    arr.set_cache_size(1u << 20);
+    zfp_memory_set_limit(zfp_memory_host_cache, 0);
+    EXPECT_LE(zfp_memory_query(zfp_memory_host_cache).current, limit);
+    EXPECT_LT(arr.cache_size(), 1u << 15);
+
+    for (size_t i = 0; i < inputDataTotalLen; i++)
+      EXPECT_EQ(ref[i], arr[i]);
+  }
+  EXPECT_EQ(base, zfp_memory_query(zfp_memory_host_cache).current);
+}
+
+/* coefficient-domain linear operations */
+
+TEST_P(TEST_FIXTURE, given_fixedRateArrays_when_axpyWithNegatedCopy_then_allValuesZero)
+{
+  ZFP_ARRAY_TYPE x(inputDataSideLen, inputDataSideLen, inputDataSideLen, getRate(), inputDataArr);
+  ZFP_ARRAY_TYPE y(x);
+
+  axpy(-1.0, x, y);
+
+  for (size_t i = 0; i < inputDataTotalLen; i++)
+    EXPECT_EQ(0, (SCALAR)y[i]);
+}
+
+TEST_P(TEST_FIXTURE, given_fixedRateArrays_when_axpyIntoZeroArray_then_valuesEqualScaledInput)
+{
+  ZFP_ARRAY_TYPE x(inputDataSideLen, inputDataSideLen, inputDataSideLen, getRate(), inputDataArr);
+  ZFP_ARRAY_TYPE y(inputDataSideLen, inputDataSideLen, inputDataSideLen, getRate());
+
+  // powers of two scale coefficients without rounding
+  axpy(1.0, x, y);
+  for (size_t i = 0; i < inputDataTotalLen; i++)
+    EXPECT_EQ((SCALAR)x[i], (SCALAR)y[i]);
+
+  scale(2.0, y);
+  for (size_t i = 0; i < inputDataTotalLen; i++)
+    EXPECT_EQ(2 * (SCALAR)x[i], (SCALAR)y[i]);
+}
+
+TEST_P(TEST_FIXTURE, given_fixedAccuracyArray_when_scale_then_exceptionThrown)
+{
+  ZFP_ARRAY_TYPE arr(inputDataSideLen, inputDataSideLen, inputDataSideLen, getRate());
+  arr.set_accuracy(1e-3);
+
+  try {
+    scale(0.5, arr);
+    FailWhenNoExceptionThrown();
+  } catch (zfp::exception const & e) {
+    EXPECT_EQ(e.what(), std::string("zfp coefficient-domain operations require fixed-rate arrays"));
+  } catch (std::exception const & e) {
+    FailAndPrintException(e);
+  }
+}
+
+/* compressed-domain coarsening */
+
+// average of values of a in cell (i, j, k) of factor^3 values, clipped to a
+static double
+coarseCellAverage(const ZFP_ARRAY_TYPE& a, size_t i, size_t j, size_t k, size_t factor)
+{
+  double sum = 0;
+  size_t count = 0;
+  for (size_t z = factor * k; z < std::min(factor * (k + 1), a.size_z()); z++)
+    for (size_t y = factor * j; y < std::min(factor * (j + 1), a.size_y()); y++)
+      for (size_t x = factor * i; x < std::min(factor * (i + 1), a.size_x()); x++, count++)
+        sum += double(a(x, y, z));
+  return sum / double(count);
+}
+
+TEST_P(TEST_FIXTURE, given_fixedRateArray_when_coarsen_then_valuesNearCellAverages)
+{
+  ZFP_ARRAY_TYPE src(inputDataSideLen, inputDataSideLen, inputDataSideLen, getRate(), inputDataArr);
+  double amax = 0;
+  for (size_t i = 0; i < inputDataTotalLen; i++)
+    amax = std::max(amax, std::fabs(double(src[i])));
+
+  for (uint factor = 2; factor <= 4; factor *= 2) {
+    ZFP_ARRAY_TYPE dst(1, 1, 1, 64);
+    coarsen(src, dst, factor);
+    size_t n = (inputDataSideLen + factor - 1) / factor;
+    EXPECT_EQ(n, dst.size_x());
+    EXPECT_EQ(n, dst.size_y());
+    EXPECT_EQ(n, dst.size_z());
+    // block averages are reconstructed from the leading coefficients up to
+    // rounding in the transform and recompression of dst
+    for (size_t k = 0; k < n; k++)
+      for (size_t j = 0; j < n; j++)
+        for (size_t i = 0; i < n; i++)
+          EXPECT_NEAR(coarseCellAverage(src, i, j, k, factor), double(dst(i, j, k)), 1e-4 * amax);
+  }
+}
+
+TEST_P(TEST_FIXTURE, given_reversibleArrayWithPartialBlocks_when_coarsen_then_exactCellAverages)
+{
+  ZFP_ARRAY_TYPE src(13, 9, 7, getRate());
+  src.set_reversible();
+  for (size_t i = 0; i < src.size(); i++)
+    src[i] = inputDataArr[i];
+  ZFP_ARRAY_TYPE dst(1, 1, 1, getRate());
+  dst.set_reversible();
+
+  coarsen(src, dst, 2);
+  EXPECT_EQ(7u, dst.size_x());
+  EXPECT_EQ(5u, dst.size_y());
+  EXPECT_EQ(4u, dst.size_z());
+  for (size_t k = 0; k < dst.size_z(); k++)
+    for (size_t j = 0; j < dst.size_y(); j++)
+      for (size_t i = 0; i < dst.size_x(); i++)
+        EXPECT_EQ(SCALAR(coarseCellAverage(src, i, j, k, 2)), (SCALAR)dst(i, j, k));
+}
+
+TEST_P(TEST_FIXTURE, given_unsupportedFactor_when_coarsen_then_exceptionThrown)
+{
+  ZFP_ARRAY_TYPE src(inputDataSideLen, inputDataSideLen, inputDataSideLen, getRate());
+  ZFP_ARRAY_TYPE dst(1, 1, 1, getRate());
+
+  try {
+    coarsen(src, dst, 3);
+    FailWhenNoExceptionThrown();
+  } catch (zfp::exception const & e) {
+    EXPECT_EQ(e.what(), std::string("zfp::coarsen requires a factor of 2 or 4"));
+  } catch (std::exception const & e) {
+    FailAndPrintException(e);
+  }
+}
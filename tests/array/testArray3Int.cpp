@@ -0,0 +1,110 @@
+#include "array/zfparray1.h"
+#include "array/zfparray3.h"
+#include "array/zfpfactory.h"
+using namespace zfp;
+
+#include "gtest/gtest.h"
+
+// this file tests compressed arrays of 32- and 64-bit integers
+
+const size_t nx = 13;
+const size_t ny = 9;
+const size_t nz = 7;
+const size_t n = nx * ny * nz;
+
+// piecewise constant labels of large magnitude
+template <typename Scalar>
+static void
+initialize(Scalar* f)
+{
+  for (size_t k = 0; k < nz; k++)
+    for (size_t j = 0; j < ny; j++)
+      for (size_t i = 0; i < nx; i++)
+        f[i + nx * (j + ny * k)] = Scalar((i / 3 + 5 * (j / 2) + 17 * k) * 1000003) - 12345;
+}
+
+template <typename Scalar>
+static void
+expect_reversible_round_trip()
+{
+  Scalar* f = new Scalar[n];
+  Scalar* g = new Scalar[n];
+  initialize(f);
+
+  array3<Scalar> a(nx, ny, nz, 8);
+  a.set_reversible();
+  a.set(f);
+  a.clear_cache();
+  a.get(g);
+  for (size_t i = 0; i < n; i++)
+    EXPECT_EQ(f[i], g[i]);
+  EXPECT_LT(a.rate(), double(CHAR_BIT * sizeof(Scalar)));
+
+  // updates through the cache are also stored exactly
+  a(4, 5, 6) = -7;
+  a.flush_cache();
+  a.clear_cache();
+  EXPECT_EQ(Scalar(-7), a(4, 5, 6));
+
+  delete[] g;
+  delete[] f;
+}
+
+// fixed-rate arrays are serialized and reconstructed with their integer type
+template <typename Scalar>
+static void
+expect_construct_from_header()
+{
+  Scalar* f = new Scalar[n];
+  initialize(f);
+
+  array3<Scalar> a(nx, ny, nz, 16, f);
+  typename array3<Scalar>::header h(a);
+  array* b = array::construct(h, a.compressed_data(), a.compressed_size());
+  EXPECT_EQ(zfp_type(trait<Scalar>::type), b->scalar_type());
+  array3<Scalar>* c = dynamic_cast<array3<Scalar>*>(b);
+  ASSERT_TRUE(c != 0);
+  for (size_t i = 0; i < n; i++)
+    EXPECT_EQ(a[i], (*c)[i]);
+  delete b;
+
+  delete[] f;
+}
+
+TEST(Array3IntTest, given_array3i_when_setReversible_then_valuesStoredExactly)
+{
+  expect_reversible_round_trip<int32>();
+}
+
+TEST(Array3IntTest, given_array3l_when_setReversible_then_valuesStoredExactly)
+{
+  expect_reversible_round_trip<int64>();
+}
+
+TEST(Array3IntTest, given_array3iHeader_when_construct_then_array3iReturned)
+{
+  expect_construct_from_header<int32>();
+}
+
+TEST(Array3IntTest, given_array3lHeader_when_construct_then_array3lReturned)
+{
+  expect_construct_from_header<int64>();
+}
+
+TEST(Array3IntTest, given_fixedRateArray1i_when_setAtFullRate_then_largeValuesNearlyExact)
+{
+  // integers spanning much of the range lose only low-order bits
+  int32 f[64];
+  for (size_t i = 0; i < 64; i++)
+    f[i] = int32((i * 7919) % 97) << 24;
+  array1i a(64, 32, f);
+  for (size_t i = 0; i < 64; i++)
+    EXPECT_NEAR(double(f[i]), double(a(i)), 256.0);
+}
+
+TEST(Array3IntTest, given_integerArray_when_axpy_then_exceptionThrown)
+{
+  array3i x(nx, ny, nz, 16);
+  array3i y(nx, ny, nz, 16);
+  EXPECT_THROW(axpy(2.0, x, y), zfp::exception);
+}
@@ -112,6 +112,47 @@ TEST_F(ARRAY_DIMS_SCALAR_TEST_VIEWS, given_view_when_setEntryWithParens_then_ori
   EXPECT_EQ(arr(offsetX + i, offsetY + j, offsetZ + k), v(i, j, k));
 }
 
+TEST_F(ARRAY_DIMS_SCALAR_TEST_VIEWS, given_constView_when_getStrided_then_entriesMatchAccessor)
+{
+  for (size_t i = 0; i < arr.size(); i++)
+    arr[i] = (SCALAR)i;
+  arr.clear_cache();
+
+  /* view spans fully and partially covered blocks */
+  ZFP_ARRAY_TYPE::const_view v(&arr, 1, 2, 0, arr.size_x() - 1, arr.size_y() - 2, arr.size_z());
+  size_t nx = v.size_x(), ny = v.size_y(), nz = v.size_z();
+  /* pad rows to exercise strides */
+  std::vector<SCALAR> buf((nx + 1) * ny * nz, 0);
+  v.get(&buf[0], 1, nx + 1, (nx + 1) * ny);
+
+  for (size_t k = 0; k < nz; k++)
+    for (size_t j = 0; j < ny; j++)
+      for (size_t i = 0; i < nx; i++)
+        EXPECT_EQ((SCALAR)v(i, j, k), buf[i + (nx + 1) * (j + ny * k)]);
+}
+
+TEST_F(ARRAY_DIMS_SCALAR_TEST_VIEWS, given_view_when_setContiguous_then_getReturnsAccessorEntries)
+{
+  ZFP_ARRAY_TYPE::view v(&arr, 1, 2, 0, arr.size_x() - 1, arr.size_y() - 2, arr.size_z());
+  size_t nx = v.size_x(), ny = v.size_y(), nz = v.size_z();
+  std::vector<SCALAR> buf(nx * ny * nz);
+  for (size_t i = 0; i < buf.size(); i++)
+    buf[i] = (SCALAR)(i % 7);
+  /* cached block must be overwritten too */
+  v(4, 4, 0) = 100;
+  v.set(&buf[0]);
+
+  std::vector<SCALAR> out(nx * ny * nz);
+  v.get(&out[0]);
+  for (size_t k = 0; k < nz; k++)
+    for (size_t j = 0; j < ny; j++)
+      for (size_t i = 0; i < nx; i++) {
+        size_t n = i + nx * (j + ny * k);
+        EXPECT_EQ((SCALAR)v(i, j, k), out[n]);
+        EXPECT_NEAR(buf[n], out[n], 1e-1);
+      }
+}
+
 /* flat_view */
 
 TEST_F(ARRAY_DIMS_SCALAR_TEST_VIEWS, when_flatViewFullConstructor_then_lengthAndOffsetSet)
@@ -0,0 +1,142 @@
+#include "array/zfpblockcodec.h"
+#include "array/zfpdevice.h"
+using namespace zfp::cpp;
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+#include "gtest/gtest.h"
+
+// this file tests that the header-only block codec matches libzfp
+
+template <typename Scalar>
+static void
+initialize(Scalar* f, size_t n, uint seed)
+{
+  for (size_t i = 0; i < n; i++)
+    f[i] = Scalar(std::sin(0.3 * (i + seed)) * std::ldexp(1.0, int((i + seed) % 23) - 11));
+}
+
+// encode block with libzfp in fixed-rate mode at given bit offset
+static size_t
+zfp_encode(uint64* data, size_t words, size_t offset, uint maxbits, const double* block)
+{
+  bitstream* s = stream_open(data, words * sizeof(uint64));
+  zfp_stream* zfp = zfp_stream_open(s);
+  zfp_stream_set_params(zfp, maxbits, maxbits, ZFP_MAX_PREC, ZFP_MIN_EXP);
+  stream_wseek(s, offset);
+  size_t bits = zfp_encode_block_double_3(zfp, block);
+  stream_flush(s);
+  zfp_stream_close(zfp);
+  stream_close(s);
+  return bits;
+}
+
+// decode block with libzfp in fixed-rate mode at given bit offset
+static size_t
+zfp_decode(uint64* data, size_t words, size_t offset, uint maxbits, double* block)
+{
+  bitstream* s = stream_open(data, words * sizeof(uint64));
+  zfp_stream* zfp = zfp_stream_open(s);
+  zfp_stream_set_params(zfp, maxbits, maxbits, ZFP_MAX_PREC, ZFP_MIN_EXP);
+  stream_rseek(s, offset);
+  size_t bits = zfp_decode_block_double_3(zfp, block);
+  zfp_stream_close(zfp);
+  stream_close(s);
+  return bits;
+}
+
+TEST(BlockCodecTest, given_3dBlock_when_encoded_then_bitsAndValuesMatchLibzfp)
+{
+  typedef block_codec<double, 3> codec;
+  const uint maxbits = 1024;
+  double f[codec::block_size];
+  initialize(f, codec::block_size, 0);
+
+  std::vector<uint64> a(maxbits / 64, 0);
+  std::vector<uint64> b(maxbits / 64, 0);
+  EXPECT_EQ(maxbits, codec::encode_block(&a[0], 0, maxbits, f));
+  EXPECT_EQ(maxbits, zfp_encode(&b[0], b.size(), 0, maxbits, f));
+  EXPECT_EQ(0, std::memcmp(&a[0], &b[0], maxbits / 8));
+
+  double g[codec::block_size];
+  double h[codec::block_size];
+  EXPECT_EQ(maxbits, codec::decode_block(&a[0], 0, maxbits, g));
+  EXPECT_EQ(maxbits, zfp_decode(&b[0], b.size(), 0, maxbits, h));
+  for (uint i = 0; i < codec::block_size; i++)
+    EXPECT_EQ(h[i], g[i]);
+}
+
+TEST(BlockCodecTest, given_unalignedOffset_when_encoded_then_neighboringBitsPreserved)
+{
+  typedef block_codec<float, 2> codec;
+  const uint maxbits = 77;
+  const size_t offset = 45;
+  float f[codec::block_size];
+  initialize(f, codec::block_size, 5);
+
+  std::vector<uint64> data(4, ~UINT64C(0));
+  EXPECT_EQ(maxbits, codec::encode_block(&data[0], offset, maxbits, f));
+
+  // bits before and after the block must be left untouched
+  EXPECT_EQ(UINT64C(0x1fffffffffff), data[0] & UINT64C(0x1fffffffffff));
+  EXPECT_EQ(~UINT64C(0) << ((offset + maxbits) % 64), data[1] & (~UINT64C(0) << ((offset + maxbits) % 64)));
+  EXPECT_EQ(~UINT64C(0), data[2]);
+
+  // decoding at the same offset must reproduce aligned encoding
+  float g[codec::block_size];
+  float h[codec::block_size];
+  std::vector<uint64> aligned(2, 0);
+  codec::encode_block(&aligned[0], 0, maxbits, f);
+  codec::decode_block(&data[0], offset, maxbits, g);
+  codec::decode_block(&aligned[0], 0, maxbits, h);
+  for (uint i = 0; i < codec::block_size; i++)
+    EXPECT_EQ(h[i], g[i]);
+}
+
+TEST(BlockCodecTest, given_zeroBlock_when_encoded_then_decodesToZero)
+{
+  typedef block_codec<double, 1> codec;
+  double f[codec::block_size] = { 0, 0, 0, 0 };
+  double g[codec::block_size] = { 1, 1, 1, 1 };
+  uint64 data = ~UINT64C(0);
+  codec::encode_block(&data, 0, codec::min_bits, f);
+  codec::decode_block(&data, 0, codec::min_bits, g);
+  for (uint i = 0; i < codec::block_size; i++)
+    EXPECT_EQ(0, g[i]);
+}
+
+TEST(BlockCodecTest, given_blocksEncodedOutOfOrder_when_deviceApiUsed_then_streamMatchesLibzfp)
+{
+  const uint blocks = 7;
+  const uint maxbits = 201;
+  std::vector<double> f(blocks * 16);
+  initialize(&f[0], f.size(), 3);
+
+  // encode unaligned blocks in reverse order, as concurrent threads might
+  const size_t words = (blocks * maxbits + 63) / 64;
+  std::vector<uint64> a(words, 0);
+  for (uint i = blocks; i--;)
+    EXPECT_EQ(maxbits, (zfp_device_encode_block<double, 2>(&a[0], i, maxbits, &f[16 * i])));
+
+  std::vector<uint64> b(words, 0);
+  bitstream* s = stream_open(&b[0], words * sizeof(uint64));
+  zfp_stream* zfp = zfp_stream_open(s);
+  zfp_stream_set_params(zfp, maxbits, maxbits, ZFP_MAX_PREC, ZFP_MIN_EXP);
+  for (uint i = 0; i < blocks; i++)
+    zfp_encode_block_double_2(zfp, &f[16 * i]);
+  zfp_stream_flush(zfp);
+  EXPECT_EQ(0, std::memcmp(&a[0], &b[0], words * sizeof(uint64)));
+
+  zfp_stream_rewind(zfp);
+  for (uint i = 0; i < blocks; i++) {
+    double g[16];
+    double h[16];
+    EXPECT_EQ(maxbits, (zfp_device_decode_block<double, 2>(&a[0], i, maxbits, g)));
+    zfp_decode_block_double_2(zfp, h);
+    for (uint j = 0; j < 16; j++)
+      EXPECT_EQ(h[j], g[j]);
+  }
+  zfp_stream_close(zfp);
+  stream_close(s);
+}
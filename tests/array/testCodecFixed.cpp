@@ -0,0 +1,106 @@
+#include "array/zfparray1.h"
+#include "array/zfparray2.h"
+#include "array/zfparray3.h"
+#include "array/zfparray4.h"
+#include "array/zfpcodecfixed.h"
+using namespace zfp;
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+#include "gtest/gtest.h"
+
+// this file tests that zfp_codec_fixed produces the same bits as zfp_codec
+
+template <typename Scalar>
+static void
+initialize(std::vector<Scalar>& f)
+{
+  for (size_t i = 0; i < f.size(); i++) {
+    switch ((i / 64) % 4) {
+      case 0:
+        f[i] = Scalar(std::sin(0.01 * i) * 100);
+        break;
+      case 1:
+        f[i] = Scalar(std::cos(0.7 * i) * std::ldexp(1.0, int(i % 37) - 18));
+        break;
+      case 2:
+        f[i] = Scalar(1.5);
+        break;
+      default:
+        f[i] = 0;
+        break;
+    }
+  }
+}
+
+template <class A, class B>
+static void
+expect_same(const A& a, const B& b)
+{
+  ASSERT_EQ(a.compressed_size(), b.compressed_size());
+  EXPECT_EQ(0, std::memcmp(a.compressed_data(), b.compressed_data(), a.compressed_size()));
+  for (size_t i = 0; i < a.size(); i++)
+    EXPECT_EQ(a[i], b[i]);
+}
+
+TEST(CodecFixedTest, given_1dArrays_when_compressed_then_bitsMatchZfpCodec)
+{
+  std::vector<float> f(103);
+  initialize(f);
+  array1f a(f.size(), 16, &f[0]);
+  array1<float, zfp_codec_fixed<float, 1, 16> > b(f.size(), 16, &f[0]);
+  expect_same(a, b);
+}
+
+TEST(CodecFixedTest, given_2dArrays_when_compressed_then_bitsMatchZfpCodec)
+{
+  std::vector<double> f(23 * 18);
+  initialize(f);
+  array2d a(23, 18, 12, &f[0]);
+  array2<double, zfp_codec_fixed<double, 2, 12> > b(23, 18, 12, &f[0]);
+  expect_same(a, b);
+}
+
+TEST(CodecFixedTest, given_3dArrays_when_modified_then_bitsMatchZfpCodec)
+{
+  std::vector<double> f(13 * 10 * 7);
+  initialize(f);
+  array3d a(13, 10, 7, 16, &f[0]);
+  array3<double, zfp_codec_fixed<double, 3, 16> > b(13, 10, 7, 16, &f[0]);
+  expect_same(a, b);
+
+  for (size_t i = 0; i < a.size(); i += 5) {
+    a[i] = double(i);
+    b[i] = double(i);
+  }
+  a.flush_cache();
+  b.flush_cache();
+  expect_same(a, b);
+}
+
+TEST(CodecFixedTest, given_4dArrays_when_compressed_then_bitsMatchZfpCodec)
+{
+  std::vector<float> f(6 * 5 * 7 * 9);
+  initialize(f);
+  array4f a(6, 5, 7, 9, 4, &f[0]);
+  array4<float, zfp_codec_fixed<float, 4, 4> > b(6, 5, 7, 9, 4, &f[0]);
+  expect_same(a, b);
+}
+
+TEST(CodecFixedTest, given_requestedRate_when_constructed_then_compileTimeRateUsed)
+{
+  array3<double, zfp_codec_fixed<double, 3, 8> > a(8, 8, 8, 20);
+  EXPECT_EQ(8, a.rate());
+  EXPECT_EQ(8, a.set_rate(2));
+}
+
+TEST(CodecFixedTest, given_zfpCodecArray_when_deserialized_then_valuesMatch)
+{
+  std::vector<double> f(13 * 10 * 7);
+  initialize(f);
+  array3d a(13, 10, 7, 16, &f[0]);
+  array3d::header h(a);
+  array3<double, zfp_codec_fixed<double, 3, 16> > b(h, a.compressed_data(), a.compressed_size());
+  expect_same(a, b);
+}
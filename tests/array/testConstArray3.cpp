@@ -0,0 +1,180 @@
+#include "array/zfparray3.h"
+#include "array/zfpcarray3.h"
+using namespace zfp;
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+#include "gtest/gtest.h"
+
+// this file tests read-only arrays built in one pass with variable-rate modes
+
+const size_t nx = 13;
+const size_t ny = 10;
+const size_t nz = 7;
+
+static void
+initialize(double* f)
+{
+  for (size_t k = 0; k < nz; k++)
+    for (size_t j = 0; j < ny; j++)
+      for (size_t i = 0; i < nx; i++)
+        f[i + nx * (j + ny * k)] = std::sin(0.3 * i) * std::cos(0.2 * j) + 0.1 * k;
+}
+
+TEST(ConstArray3Test, given_fixedAccuracyConstArray_when_accessed_then_errorWithinTolerance)
+{
+  double f[nx * ny * nz];
+  initialize(f);
+
+  const_array3d a(nx, ny, nz, 0.0);
+  double tolerance = a.set_accuracy(1e-3);
+  EXPECT_EQ(zfp_mode_fixed_accuracy, a.mode());
+  a.set(f);
+
+  for (size_t k = 0; k < nz; k++)
+    for (size_t j = 0; j < ny; j++)
+      for (size_t i = 0; i < nx; i++)
+        EXPECT_LE(std::fabs(a(i, j, k) - f[i + nx * (j + ny * k)]), tolerance);
+}
+
+TEST(ConstArray3Test, given_reversibleConstArray_when_get_then_valuesPreservedExactly)
+{
+  double f[nx * ny * nz];
+  double g[nx * ny * nz];
+  initialize(f);
+
+  const_array3d a(nx, ny, nz, 0.0);
+  a.set_reversible();
+  a.set(f);
+  a.get(g);
+
+  for (size_t i = 0; i < nx * ny * nz; i++)
+    EXPECT_EQ(f[i], g[i]);
+}
+
+TEST(ConstArray3Test, given_fixedAccuracyConstArray_when_compared_then_smallerThanVariableRateArray)
+{
+  double f[nx * ny * nz];
+  initialize(f);
+
+  const_array3d a(nx, ny, nz, 0.0);
+  a.set_accuracy(1e-3);
+  a.set(f);
+
+  array3d b(nx, ny, nz, 0.0);
+  b.set_accuracy(1e-3);
+  b.set(f);
+
+  EXPECT_LT(a.rate(), b.rate());
+}
+
+TEST(ConstArray3Test, given_constArray_when_copied_then_performsDeepCopy)
+{
+  double f[nx * ny * nz];
+  initialize(f);
+
+  const_array3d a(nx, ny, nz, 0.0);
+  a.set_precision(24);
+  a.set(f);
+  const_array3d b(a);
+  a.set_reversible();
+
+  EXPECT_EQ(zfp_mode_fixed_precision, b.mode());
+  for (size_t i = 0; i < nx * ny * nz; i++) {
+    EXPECT_EQ(0., a[i]);
+    EXPECT_NEAR(f[i], b[i], 1e-4);
+  }
+}
+
+// compress f at given rate using the C API, preceded by a full header
+static std::vector<uchar>
+compress_stream(const double* f, double rate)
+{
+  zfp_field* field = zfp_field_3d(const_cast<double*>(f), zfp_type_double, nx, ny, nz);
+  zfp_stream* zfp = zfp_stream_open(0);
+  zfp_stream_set_rate(zfp, rate, zfp_type_double, 3, zfp_false);
+  std::vector<uchar> buffer(zfp_stream_maximum_size(zfp, field));
+  bitstream* stream = stream_open(&buffer[0], buffer.size());
+  zfp_stream_set_bit_stream(zfp, stream);
+  zfp_write_header(zfp, field, ZFP_HEADER_FULL);
+  zfp_compress(zfp, field);
+  buffer.resize(zfp_stream_compressed_size(zfp));
+  zfp_field_free(field);
+  zfp_stream_close(zfp);
+  stream_close(stream);
+  return buffer;
+}
+
+// decompress stream written by compress_stream()
+static void
+decompress_stream(std::vector<uchar>& buffer, double* g)
+{
+  zfp_field* field = zfp_field_3d(g, zfp_type_double, nx, ny, nz);
+  zfp_stream* zfp = zfp_stream_open(0);
+  bitstream* stream = stream_open(&buffer[0], buffer.size());
+  zfp_stream_set_bit_stream(zfp, stream);
+  zfp_read_header(zfp, field, ZFP_HEADER_FULL);
+  zfp_decompress(zfp, field);
+  zfp_field_free(field);
+  zfp_stream_close(zfp);
+  stream_close(stream);
+}
+
+TEST(ConstArray3Test, given_fixedRateStream_when_opened_then_arraysMatchDecompressedStream)
+{
+  double f[nx * ny * nz];
+  double g[nx * ny * nz];
+  initialize(f);
+
+  // payloads start at unaligned bit offset following 96-bit header
+  const double rate[] = { 2, 8 };
+  for (size_t r = 0; r < 2; r++) {
+    std::vector<uchar> buffer = compress_stream(f, rate[r]);
+    decompress_stream(buffer, g);
+
+    array3d a(&buffer[0], buffer.size());
+    const_array3d c(&buffer[0], buffer.size());
+    EXPECT_EQ(nx, a.size_x());
+    EXPECT_EQ(nz, c.size_z());
+    EXPECT_EQ(zfp_mode_fixed_rate, c.mode());
+    for (size_t i = 0; i < nx * ny * nz; i++) {
+      EXPECT_EQ(g[i], a[i]);
+      EXPECT_EQ(g[i], c[i]);
+    }
+
+    EXPECT_THROW(array3d(&buffer[0], buffer.size() - 8), zfp::exception);
+  }
+}
+
+TEST(ConstArray3Test, given_fixedRateStreamWithPartialWordBlocks_when_opened_then_throws)
+{
+  double f[nx * ny * nz];
+  initialize(f);
+
+  std::vector<uchar> buffer = compress_stream(f, 1.5);
+  EXPECT_THROW(array3d(&buffer[0], buffer.size()), zfp::exception);
+  EXPECT_THROW(const_array3d(&buffer[0], buffer.size()), zfp::exception);
+}
+
+TEST(ConstArray3Test, given_alignedFixedRatePayload_when_borrowed_then_bufferUsedInPlace)
+{
+  double f[nx * ny * nz];
+  double g[nx * ny * nz];
+  initialize(f);
+
+  std::vector<uchar> buffer = compress_stream(f, 8);
+  decompress_stream(buffer, g);
+
+  // payload following 96-bit header is unaligned; store header separately
+  zfp::array3d::header header(&buffer[0]);
+  size_t bytes = buffer.size() - header.size_bytes();
+  std::vector<uint64> payload(bytes / sizeof(uint64) + 1);
+  std::memcpy(&payload[0], &buffer[header.size_bytes()], bytes);
+
+  array3d a(header, &payload[0], bytes, true);
+  EXPECT_TRUE(a.borrowed());
+  EXPECT_EQ(static_cast<const void*>(&payload[0]), a.compressed_data());
+  for (size_t i = 0; i < nx * ny * nz; i++)
+    EXPECT_EQ(g[i], a[i]);
+}
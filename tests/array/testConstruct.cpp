@@ -24,7 +24,7 @@ void FailAndPrintException(std::exception const & e)
   FAIL() << "Unexpected exception thrown: " << typeid(e).name() << std::endl << "With message: " << e.what();
 }
 
-TEST_F(TEST_FIXTURE, given_zfpHeaderForIntegerData_when_construct_expect_zfpArrayHeaderExceptionThrown)
+TEST_F(TEST_FIXTURE, given_zfpHeaderForIntegerData_when_construct_expect_integerArrayConstructed)
 {
   zfp_type zfpType = zfp_type_int32;
 
@@ -40,14 +40,17 @@ TEST_F(TEST_FIXTURE, given_zfpHeaderForIntegerData_when_construct_expect_zfpArra
 
   zfp::zfp_codec<double, 2>::header h(buffer);
 
+  zfp::array* arr = 0;
   try {
-    zfp::array* arr = zfp::array::construct(h);
-    FailWhenNoExceptionThrown();
-  } catch (zfp::exception const & e) {
-    EXPECT_EQ(e.what(), std::string("zfp scalar type not supported"));
+    arr = zfp::array::construct(h);
   } catch (std::exception const & e) {
     FailAndPrintException(e);
   }
+
+  ASSERT_TRUE(arr != 0);
+  EXPECT_EQ(zfp_type_int32, arr->scalar_type());
+  EXPECT_TRUE(dynamic_cast<zfp::array2i*>(arr) != 0);
+  delete arr;
 }
 
 TEST_F(TEST_FIXTURE, given_onlyInclude2D3D_and_zfpHeaderFor1D_when_construct_expect_zfpArrayHeaderExceptionThrown)
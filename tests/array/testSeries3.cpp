@@ -0,0 +1,72 @@
+#include "array/zfparray4.h"
+#include "array/zfpseries3.h"
+using namespace zfp;
+
+#include <cmath>
+#include "gtest/gtest.h"
+
+// this file tests append-only time series of 3D arrays
+
+const size_t nx = 7;
+const size_t ny = 6;
+const size_t nz = 5;
+const size_t nt = 23;
+const size_t n = nx * ny * nz;
+
+static void
+initialize(double* f)
+{
+  for (size_t t = 0; t < nt; t++)
+    for (size_t k = 0; k < nz; k++)
+      for (size_t j = 0; j < ny; j++)
+        for (size_t i = 0; i < nx; i++)
+          f[i + nx * (j + ny * (k + nz * t))] = std::sin(0.3 * i + 0.1 * t) * std::cos(0.2 * j) + 0.1 * k;
+}
+
+TEST(Series3Test, given_appendedSteps_when_accessed_then_completeGroupsMatchArray4AndOpenGroupIsExact)
+{
+  double* f = new double[n * nt];
+  initialize(f);
+
+  series3d s(nx, ny, nz, 16);
+  for (size_t t = 0; t < nt; t++)
+    s.append(f + n * t);
+  array4d a(nx, ny, nz, nt, 16, f);
+
+  EXPECT_EQ(nt, s.steps());
+  EXPECT_LE(nt, s.capacity());
+  for (size_t t = 0; t < nt; t++)
+    for (size_t k = 0; k < nz; k++)
+      for (size_t j = 0; j < ny; j++)
+        for (size_t i = 0; i < nx; i++) {
+          if (t < (nt & ~size_t(3)))
+            EXPECT_EQ(a(i, j, k, t), s(i, j, k, t));
+          else
+            EXPECT_EQ(f[i + nx * (j + ny * (k + nz * t))], s(i, j, k, t));
+        }
+
+  delete[] f;
+}
+
+TEST(Series3Test, given_series_when_reserveAndGetStep_then_contentsUnchanged)
+{
+  double* f = new double[n * nt];
+  double* g = new double[n];
+  initialize(f);
+
+  series3d s(nx, ny, nz, 16);
+  for (size_t t = 0; t < 8; t++)
+    s.append(f + n * t);
+  series3d copy(s);
+  s.reserve(100);
+  EXPECT_LE(100u, s.capacity());
+
+  s.get(5, g);
+  for (size_t k = 0; k < nz; k++)
+    for (size_t j = 0; j < ny; j++)
+      for (size_t i = 0; i < nx; i++)
+        EXPECT_EQ(copy(i, j, k, 5), g[i + nx * (j + ny * k)]);
+
+  delete[] g;
+  delete[] f;
+}
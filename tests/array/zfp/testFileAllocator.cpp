@@ -0,0 +1,103 @@
+#include "array/zfparray3.h"
+#include "array/zfp/filemem.h"
+using namespace zfp;
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include "gtest/gtest.h"
+
+// this file tests compressed arrays whose storage is paged to and from a file
+
+const size_t n = 64;
+
+static std::string
+path()
+{
+  const char* dir = std::getenv("TMPDIR");
+  return std::string(dir ? dir : "/tmp") + "/zfpTestFileAllocator";
+}
+
+static double
+value(size_t i, size_t j, size_t k)
+{
+  return std::sin(0.1 * i) * std::cos(0.2 * j) + 0.01 * k;
+}
+
+TEST(FileAllocatorTest, given_arrayWithFileBackedStore_when_accessed_then_valuesMatchInMemoryArray)
+{
+  array3d a(n, n, n, 16);
+  for (size_t k = 0; k < n; k++)
+    for (size_t j = 0; j < n; j++)
+      for (size_t i = 0; i < n; i++)
+        a(i, j, k) = value(i, j, k);
+  a.flush_cache();
+
+  file_allocator memory(path());
+  array3d b(a);
+  b.set_store_allocator(&memory);
+  EXPECT_LE(b.compressed_size(), memory.size());
+  EXPECT_EQ(0, std::memcmp(a.compressed_data(), b.compressed_data(), a.compressed_size()));
+
+  // modify one slab of both arrays
+  for (size_t j = 0; j < n; j++)
+    for (size_t i = 0; i < n; i++)
+      a(i, j, 7) = b(i, j, 7) = 1;
+  for (size_t k = 0; k < n; k++)
+    for (size_t j = 0; j < n; j++)
+      for (size_t i = 0; i < n; i++)
+        EXPECT_EQ(a(i, j, k), b(i, j, k));
+}
+
+TEST(FileAllocatorTest, given_fileBackedStore_when_viewEvictedAndPrefetched_then_residentPagesDropAndValuesPersist)
+{
+  file_allocator memory(path());
+  array3d a(n, n, n, 32);
+  a.set_store_allocator(&memory);
+  for (size_t k = 0; k < n; k++)
+    for (size_t j = 0; j < n; j++)
+      for (size_t i = 0; i < n; i++)
+        a(i, j, k) = value(i, j, k);
+  a.flush_cache();
+  size_t resident = memory.resident();
+  EXPECT_EQ(memory.size(), resident);
+
+  // write back and drop compressed blocks of lower half
+  array3d::const_view v(&a, 0, 0, 0, n, n, n / 2);
+  v.evict();
+  EXPECT_GT(resident, memory.resident());
+  EXPECT_LE(resident / 2, memory.resident());
+
+  // blocks are paged back in on demand
+  v.prefetch();
+  a.clear_cache();
+  array3d b(n, n, n, 32);
+  for (size_t k = 0; k < n; k++)
+    for (size_t j = 0; j < n; j++)
+      for (size_t i = 0; i < n; i++)
+        b(i, j, k) = value(i, j, k);
+  b.flush_cache();
+  EXPECT_EQ(0, std::memcmp(a.compressed_data(), b.compressed_data(), a.compressed_size()));
+}
+
+TEST(FileAllocatorTest, given_variableRateArray_when_evicted_then_valuesMatchInMemoryArray)
+{
+  file_allocator memory(path());
+  array3d a(n, n, n, 0);
+  array3d b(n, n, n, 0);
+  a.set_accuracy(1e-6);
+  b.set_accuracy(1e-6);
+  a.set_store_allocator(&memory);
+  for (size_t k = 0; k < n; k++)
+    for (size_t j = 0; j < n; j++)
+      for (size_t i = 0; i < n; i++)
+        a(i, j, k) = b(i, j, k) = value(i, j, k);
+  a.flush_cache();
+  a.evict(0, 0, 0, n, n, n);
+  a.clear_cache();
+  for (size_t k = 0; k < n; k++)
+    for (size_t j = 0; j < n; j++)
+      for (size_t i = 0; i < n; i++)
+        EXPECT_EQ(b(i, j, k), a(i, j, k));
+}
@@ -0,0 +1,83 @@
+#include "array/zfparray3.h"
+#include "array/zfp/sharedmem.h"
+using namespace zfp;
+
+#include <cmath>
+#include <cstring>
+#include <sys/wait.h>
+#include "gtest/gtest.h"
+
+// this file tests compressed arrays shared among processes via POSIX shared memory
+
+const size_t n = 13;
+const char* const name = "/zfpTestSharedSegment";
+
+static void
+initialize(double* f)
+{
+  for (size_t k = 0; k < n; k++)
+    for (size_t j = 0; j < n; j++)
+      for (size_t i = 0; i < n; i++)
+        f[i + n * (j + n * k)] = std::sin(0.3 * i) * std::cos(0.2 * j) + 0.1 * k;
+}
+
+// number of values of array borrowing blocks of segment that differ from a
+static int
+mismatches(const array3d& a, const shared_segment& s)
+{
+  array3d::header h(s.header_data(), s.header_size());
+  array3d b(h, s.compressed_data(), s.compressed_size(), true);
+  int count = b.borrowed() && b.compressed_data() == s.compressed_data() ? 0 : 1;
+  for (size_t k = 0; k < n; k++)
+    for (size_t j = 0; j < n; j++)
+      for (size_t i = 0; i < n; i++)
+        if (a(i, j, k) != b(i, j, k))
+          count++;
+  // modification copies blocks out of read-only segment
+  b(0, 0, 0) = 1;
+  b.flush_cache();
+  if (b.borrowed())
+    count++;
+  return count;
+}
+
+TEST(SharedSegmentTest, given_publishedArray_when_attachedByOtherProcess_then_blocksBorrowedAndValuesMatch)
+{
+  double* f = new double[n * n * n];
+  initialize(f);
+  array3d a(n, n, n, 12, f);
+
+  shared_segment w(name, a);
+  EXPECT_EQ(a.compressed_size(), w.compressed_size());
+  EXPECT_EQ(0, std::memcmp(a.compressed_data(), w.compressed_data(), a.compressed_size()));
+  EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(w.compressed_data()) % ZFP_MEMORY_ALIGNMENT);
+
+  pid_t pid = fork();
+  ASSERT_LE(0, pid);
+  if (!pid) {
+    shared_segment r(name);
+    _exit(mismatches(a, r));
+  }
+  int status;
+  ASSERT_EQ(pid, waitpid(pid, &status, 0));
+  EXPECT_TRUE(WIFEXITED(status));
+  EXPECT_EQ(0, WEXITSTATUS(status));
+
+  // segment is unaffected by readers
+  EXPECT_EQ(0, std::memcmp(a.compressed_data(), w.compressed_data(), a.compressed_size()));
+
+  delete[] f;
+  EXPECT_TRUE(w.unlink());
+}
+
+TEST(SharedSegmentTest, given_unlinkedSegment_when_attached_then_throws)
+{
+  array3d a(n, n, n, 8);
+  {
+    shared_segment w(name, a);
+    shared_segment r(name);
+    EXPECT_EQ(w.size(), r.size());
+    EXPECT_TRUE(w.unlink());
+  }
+  EXPECT_THROW(shared_segment r(name), zfp::exception);
+}
@@ -25,6 +25,7 @@ int main()
     cmocka_unit_test_setup_teardown(given_cfp_array1d_when_copyCtor_expect_paramsCopied, setupCfpArrLargeComplete, teardownCfpArr),
     cmocka_unit_test_setup_teardown(given_cfp_array1d_when_copyCtor_expect_cacheCopied, setupCfpArrLargeComplete, teardownCfpArr),
     cmocka_unit_test_setup_teardown(given_cfp_array1d_when_headerCtor_expect_copied, setupCfpArrLargeComplete, teardownCfpArr),
+    cmocka_unit_test_setup_teardown(given_cfp_array1d_when_adoptCtor_expect_bufferBorrowedUntilOwned, setupCfpArrLargeComplete, teardownCfpArr),
 
     cmocka_unit_test_setup_teardown(given_cfp_array1d_header_expect_matchingMetadata, setupCfpArrLargeComplete, teardownCfpArr),
     cmocka_unit_test_setup_teardown(given_cfp_array1d_header_when_bufferCtor_expect_copied, setupCfpArrLargeComplete, teardownCfpArr),
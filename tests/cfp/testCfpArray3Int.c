@@ -0,0 +1,84 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <stdlib.h>
+
+#include "cfparray.h"
+
+#define NX 13
+#define NY 9
+#define NZ 7
+#define SIZE (NX * NY * NZ)
+
+/* label-like volume of piecewise constant integers */
+static int64
+label(size_t i)
+{
+  size_t x = i % NX, y = (i / NX) % NY, z = i / (NX * NY);
+  return (int64)(x / 3 + 5 * (y / 2) + 17 * z) * 1000003 - 12345;
+}
+
+static void
+given_cfp_array3i_when_setReversible_expect_valuesStoredExactly(void **state)
+{
+  int32 data[SIZE], copy[SIZE];
+  size_t i;
+  for (i = 0; i < SIZE; i++)
+    data[i] = (int32)label(i);
+
+  cfp_array3i a = cfp.array3i.ctor(NX, NY, NZ, 8, 0, 0);
+  cfp.array3i.set_reversible(a);
+  cfp.array3i.set_array(a, data);
+  cfp.array3i.clear_cache(a);
+  cfp.array3i.get_array(a, copy);
+  assert_memory_equal(copy, data, sizeof(data));
+
+  cfp_header h = cfp.array3i.header.ctor(a);
+  assert_int_equal(cfp.array3i.header.scalar_type(h), zfp_type_int32);
+  cfp.array3i.header.dtor(h);
+  cfp.array3i.dtor(a);
+}
+
+static void
+given_cfp_array3l_when_setReversible_expect_valuesStoredExactly(void **state)
+{
+  int64 data[SIZE], copy[SIZE];
+  size_t i;
+  for (i = 0; i < SIZE; i++)
+    data[i] = label(i) << 24;
+
+  cfp_array3l a = cfp.array3l.ctor(NX, NY, NZ, 8, 0, 0);
+  cfp.array3l.set_reversible(a);
+  cfp.array3l.set_array(a, data);
+  cfp.array3l.clear_cache(a);
+  cfp.array3l.get_array(a, copy);
+  assert_memory_equal(copy, data, sizeof(data));
+
+  cfp_header h = cfp.array3l.header.ctor(a);
+  assert_int_equal(cfp.array3l.header.scalar_type(h), zfp_type_int64);
+  cfp.array3l.header.dtor(h);
+  cfp.array3l.dtor(a);
+}
+
+static void
+given_cfp_array3i_when_setPrecision_expect_setGetRoundTrips(void **state)
+{
+  cfp_array3i a = cfp.array3i.ctor(NX, NY, NZ, 16, 0, 0);
+  assert_int_equal(cfp.array3i.set_precision(a, 32), 32);
+  cfp.array3i.set(a, 4, 5, 6, -7);
+  assert_int_equal(cfp.array3i.get(a, 4, 5, 6), -7);
+  cfp.array3i.dtor(a);
+}
+
+int main()
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test(given_cfp_array3i_when_setReversible_expect_valuesStoredExactly),
+    cmocka_unit_test(given_cfp_array3l_when_setReversible_expect_valuesStoredExactly),
+    cmocka_unit_test(given_cfp_array3i_when_setPrecision_expect_setGetRoundTrips),
+  };
+
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
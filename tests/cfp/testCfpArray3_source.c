@@ -91,6 +91,161 @@ _catFunc3(given_, CFP_ARRAY_TYPE, _when_get_expect_entryReturned)(void **state)
   assert_true(CFP_NAMESPACE.SUB_NAMESPACE.get(cfpArr, i, j, k) == (SCALAR)VAL);
 }
 
+static void
+_catFunc3(given_, CFP_ARRAY_TYPE, _when_setBox_expect_entriesMatchGet)(void **state)
+{
+  struct setupVars *bundle = *state;
+  CFP_ARRAY_TYPE cfpArr = bundle->cfpArr;
+
+  // cache whole array so that values are not subject to lossy compression
+  CFP_NAMESPACE.SUB_NAMESPACE.set_cache_size(cfpArr, SIZE_X * SIZE_Y * SIZE_Z * sizeof(SCALAR));
+
+  // 3x5x6 box straddling block boundaries, stored transposed (z fastest)
+  size_t x = 2, y = 3, z = 1, nx = 3, ny = 5, nz = 6;
+  SCALAR box[3 * 5 * 6];
+  size_t i, j, k;
+  for (i = 0; i < nx * ny * nz; i++)
+    box[i] = (SCALAR)i;
+  CFP_NAMESPACE.SUB_NAMESPACE.set_box(cfpArr, box, x, y, z, nx, ny, nz, (ptrdiff_t)(ny * nz), (ptrdiff_t)nz, 1);
+
+  for (k = 0; k < nz; k++)
+    for (j = 0; j < ny; j++)
+      for (i = 0; i < nx; i++)
+        assert_true(CFP_NAMESPACE.SUB_NAMESPACE.get(cfpArr, x + i, y + j, z + k) == box[k + nz * (j + ny * i)]);
+}
+
+static void
+_catFunc3(given_, CFP_ARRAY_TYPE, _when_getBox_expect_entriesMatchGet)(void **state)
+{
+  struct setupVars *bundle = *state;
+  CFP_ARRAY_TYPE cfpArr = bundle->cfpArr;
+
+  // cache whole array so that values are not subject to lossy compression
+  CFP_NAMESPACE.SUB_NAMESPACE.set_cache_size(cfpArr, SIZE_X * SIZE_Y * SIZE_Z * sizeof(SCALAR));
+
+  size_t x = 2, y = 3, z = 1, nx = 3, ny = 5, nz = 6;
+  SCALAR box[3 * 5 * 6];
+  size_t i, j, k;
+  CFP_NAMESPACE.SUB_NAMESPACE.set(cfpArr, x + 1, y + 4, z + 5, (SCALAR)VAL);
+  CFP_NAMESPACE.SUB_NAMESPACE.get_box(cfpArr, box, x, y, z, nx, ny, nz, 0, 0, 0);
+
+  for (k = 0; k < nz; k++)
+    for (j = 0; j < ny; j++)
+      for (i = 0; i < nx; i++)
+        assert_true(CFP_NAMESPACE.SUB_NAMESPACE.get(cfpArr, x + i, y + j, z + k) == box[i + nx * (j + ny * k)]);
+  assert_true(box[1 + nx * (4 + ny * 5)] == (SCALAR)VAL);
+}
+
+static void
+_catFunc3(given_, CFP_ARRAY_TYPE, _when_setBlock_getBlock_expect_partialBlockRoundTrips)(void **state)
+{
+  struct setupVars *bundle = *state;
+  CFP_ARRAY_TYPE cfpArr = bundle->cfpArr;
+
+  // cache whole array so that values are not subject to lossy compression
+  CFP_NAMESPACE.SUB_NAMESPACE.set_cache_size(cfpArr, SIZE_X * SIZE_Y * SIZE_Z * sizeof(SCALAR));
+
+  // last block along each dimension of 20x21x22 array is 4x1x2
+  size_t bx = SIZE_X / 4 - 1, by = SIZE_Y / 4, bz = SIZE_Z / 4;
+  SCALAR block[4 * 1 * 2] = {1, 2, 3, 4, 5, 6, 7, 8};
+  SCALAR copy[4 * 1 * 2];
+  size_t i;
+  CFP_NAMESPACE.SUB_NAMESPACE.set_block(cfpArr, block, bx, by, bz, 0, 0, 0);
+  CFP_NAMESPACE.SUB_NAMESPACE.get_block(cfpArr, copy, bx, by, bz, 0, 0, 0);
+
+  for (i = 0; i < 8; i++)
+    assert_true(copy[i] == block[i]);
+  assert_true(CFP_NAMESPACE.SUB_NAMESPACE.get(cfpArr, 4 * bx + 3, 4 * by, 4 * bz + 1) == (SCALAR)8);
+}
+
+static void
+_catFunc2(fill_block_, CFP_ARRAY_TYPE)(SCALAR* p, size_t i, size_t j, size_t k, size_t mx, size_t my, size_t mz, void* context)
+{
+  size_t x, y, z;
+  for (z = 0; z < mz; z++)
+    for (y = 0; y < my; y++)
+      for (x = 0; x < mx; x++)
+        p[x + 4 * (y + 4 * z)] = (SCALAR)1;
+  *(size_t*)context += mx * my * mz;
+}
+
+static void
+_catFunc3(given_, CFP_ARRAY_TYPE, _when_forEachBlock_expect_everyEntryVisitedOnce)(void **state)
+{
+  struct setupVars *bundle = *state;
+  CFP_ARRAY_TYPE cfpArr = bundle->cfpArr;
+
+  // constant blocks are represented exactly even once evicted from cache
+  size_t count = 0;
+  size_t i, j, k;
+  CFP_NAMESPACE.SUB_NAMESPACE.for_each_block(cfpArr, _catFunc2(fill_block_, CFP_ARRAY_TYPE), &count, zfp_true);
+
+  assert_int_equal(count, SIZE_X * SIZE_Y * SIZE_Z);
+  for (k = 0; k < SIZE_Z; k++)
+    for (j = 0; j < SIZE_Y; j++)
+      for (i = 0; i < SIZE_X; i++)
+        assert_true(CFP_NAMESPACE.SUB_NAMESPACE.get(cfpArr, i, j, k) == (SCALAR)1);
+}
+
+static void
+_catFunc3(given_, CFP_ARRAY_TYPE, _when_privateViewCtorSubset_expect_extentAndOffsetSet)(void **state)
+{
+  struct setupVars *bundle = *state;
+  CFP_ARRAY_TYPE cfpArr = bundle->cfpArr;
+
+  CFP_VIEW_TYPE view = CFP_NAMESPACE.SUB_NAMESPACE.private_view.ctor_subset(cfpArr, 1, 2, 3, 4, 5, 6, 0);
+
+  assert_int_equal(CFP_NAMESPACE.SUB_NAMESPACE.private_view.size_x(view), 4);
+  assert_int_equal(CFP_NAMESPACE.SUB_NAMESPACE.private_view.size_y(view), 5);
+  assert_int_equal(CFP_NAMESPACE.SUB_NAMESPACE.private_view.size_z(view), 6);
+  assert_int_equal(CFP_NAMESPACE.SUB_NAMESPACE.private_view.global_x(view, 1), 2);
+  assert_int_equal(CFP_NAMESPACE.SUB_NAMESPACE.private_view.global_y(view, 1), 3);
+  assert_int_equal(CFP_NAMESPACE.SUB_NAMESPACE.private_view.global_z(view, 1), 4);
+  assert_int_equal(CFP_NAMESPACE.SUB_NAMESPACE.private_view.cache_size(view), CFP_NAMESPACE.SUB_NAMESPACE.cache_size(cfpArr));
+
+  CFP_NAMESPACE.SUB_NAMESPACE.private_view.dtor(view);
+}
+
+static void
+_catFunc3(given_, CFP_ARRAY_TYPE, _when_privateViewSet_expect_entryVisibleInArrayOnlyAfterFlush)(void **state)
+{
+  struct setupVars *bundle = *state;
+  CFP_ARRAY_TYPE cfpArr = bundle->cfpArr;
+
+  CFP_VIEW_TYPE view = CFP_NAMESPACE.SUB_NAMESPACE.private_view.ctor_subset(cfpArr, 4, 4, 4, 4, 4, 4, 0);
+  CFP_NAMESPACE.SUB_NAMESPACE.private_view.set(view, 1, 2, 3, (SCALAR)1);
+  assert_true(CFP_NAMESPACE.SUB_NAMESPACE.private_view.get(view, 1, 2, 3) == (SCALAR)1);
+  assert_true(CFP_NAMESPACE.SUB_NAMESPACE.get(cfpArr, 5, 6, 7) == (SCALAR)0);
+
+  // compressed value is approximate but nonzero
+  CFP_NAMESPACE.SUB_NAMESPACE.private_view.flush_cache(view);
+  CFP_NAMESPACE.SUB_NAMESPACE.clear_cache(cfpArr);
+  assert_true(CFP_NAMESPACE.SUB_NAMESPACE.get(cfpArr, 5, 6, 7) != (SCALAR)0);
+
+  CFP_NAMESPACE.SUB_NAMESPACE.private_view.dtor(view);
+}
+
+static void
+_catFunc3(given_, CFP_ARRAY_TYPE, _when_privateViewPartition_expect_blockAlignedPiecesCoverArray)(void **state)
+{
+  struct setupVars *bundle = *state;
+  CFP_ARRAY_TYPE cfpArr = bundle->cfpArr;
+
+  // 22 > 21 > 20, so partition splits the z dimension into 6 blocks
+  size_t count = 4, index, z = 0;
+  for (index = 0; index < count; index++) {
+    CFP_VIEW_TYPE view = CFP_NAMESPACE.SUB_NAMESPACE.private_view.ctor(cfpArr, 0);
+    CFP_NAMESPACE.SUB_NAMESPACE.private_view.partition(view, index, count);
+    assert_int_equal(CFP_NAMESPACE.SUB_NAMESPACE.private_view.size_x(view), SIZE_X);
+    assert_int_equal(CFP_NAMESPACE.SUB_NAMESPACE.private_view.size_y(view), SIZE_Y);
+    assert_int_equal(CFP_NAMESPACE.SUB_NAMESPACE.private_view.global_z(view, 0), z);
+    assert_true(z % 4 == 0);
+    z += CFP_NAMESPACE.SUB_NAMESPACE.private_view.size_z(view);
+    CFP_NAMESPACE.SUB_NAMESPACE.private_view.dtor(view);
+  }
+  assert_int_equal(z, SIZE_Z);
+}
+
 static void
 _catFunc3(given_, CFP_ARRAY_TYPE, _when_ref_expect_arrayObjectValid)(void **state)
 {
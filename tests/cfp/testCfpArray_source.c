@@ -353,6 +353,34 @@ _catFunc3(given_, CFP_ARRAY_TYPE, _when_headerCtor_expect_copied)(void **state)
   CFP_NAMESPACE.SUB_NAMESPACE.dtor(newCfpArr);
 }
 
+static void
+_catFunc3(given_, CFP_ARRAY_TYPE, _when_adoptCtor_expect_bufferBorrowedUntilOwned)(void **state)
+{
+  struct setupVars *bundle = *state;
+  CFP_ARRAY_TYPE srcCfpArr = bundle->cfpArr;
+  CFP_HEADER_TYPE srcCfpHdr = CFP_NAMESPACE.SUB_NAMESPACE.header.ctor(srcCfpArr);
+  void* srcBuff = (void*)CFP_NAMESPACE.SUB_NAMESPACE.compressed_data(srcCfpArr);
+  size_t srcSz  = CFP_NAMESPACE.SUB_NAMESPACE.compressed_size(srcCfpArr);
+  size_t i = 1;
+
+  // exec construct from header + stream without copying the stream
+  CFP_ARRAY_TYPE newCfpArr = CFP_NAMESPACE.SUB_NAMESPACE.ctor_adopt(srcCfpHdr, srcBuff, srcSz);
+
+  assert_true(CFP_NAMESPACE.SUB_NAMESPACE.borrowed(newCfpArr));
+  assert_ptr_equal(CFP_NAMESPACE.SUB_NAMESPACE.compressed_data(newCfpArr), srcBuff);
+  assert_true(CFP_NAMESPACE.SUB_NAMESPACE.get_flat(newCfpArr, i) == CFP_NAMESPACE.SUB_NAMESPACE.get_flat(srcCfpArr, i));
+
+  // taking ownership copies the stream
+  CFP_NAMESPACE.SUB_NAMESPACE.own(newCfpArr);
+  assert_false(CFP_NAMESPACE.SUB_NAMESPACE.borrowed(newCfpArr));
+  assert_ptr_not_equal(CFP_NAMESPACE.SUB_NAMESPACE.compressed_data(newCfpArr), srcBuff);
+  assert_memory_equal(CFP_NAMESPACE.SUB_NAMESPACE.compressed_data(newCfpArr), srcBuff, srcSz);
+
+  // cleanup
+  CFP_NAMESPACE.SUB_NAMESPACE.header.dtor(srcCfpHdr);
+  CFP_NAMESPACE.SUB_NAMESPACE.dtor(newCfpArr);
+}
+
 static void
 _catFunc3(given_, CFP_ARRAY_TYPE, _header_when_bufferCtor_expect_copied)(void **state)
 {
@@ -27,6 +27,12 @@ program main
   integer :: dims, wra
   integer :: zfp_type
 
+  ! compressed array and private view
+  type(zFORp_array3d) :: array
+  type(zFORp_private_view3d) :: view
+  real (kind=8), dimension(:, :, :), allocatable, target :: field_3d, array_3d
+  integer k, index, count
+
   ! initialize input and decompressed arrays
   xLen = 8
   yLen = 8
@@ -88,6 +94,46 @@ program main
   write(*, *) "Absolute errors: "
   write(*, *) abs(input_array - decompressed_array)
 
+  ! execution policy
+  if (zFORp_stream_set_execution(stream, zFORp_exec_serial) == 0) stop 1
+  if (zFORp_stream_execution(stream) /= zFORp_exec_serial) stop 1
+
+  ! compressed array initialized from and decompressed to contiguous arrays
+  allocate(field_3d(9, 10, 11))
+  allocate(array_3d(9, 10, 11))
+  do k = 1, 11
+    do j = 1, 10
+      do i = 1, 9
+        field_3d(i, j, k) = i + 2 * j + 3 * k
+      enddo
+    enddo
+  enddo
+  array = zFORp_array3d_ctor(9, 10, 11, 32.0d0, c_loc(field_3d), 0_8)
+  if (zFORp_array3d_size_z(array) /= 11) stop 1
+  call zFORp_array3d_get_array(array, c_loc(array_3d))
+  write(*, *) "Compressed array max absolute error: "
+  write(*, *) maxval(abs(array_3d - field_3d))
+
+  ! fill array in parallel through private views of block-aligned pieces
+  call zFORp_array3d_flush_cache(array)
+  count = 2
+  do index = 0, count - 1
+    view = zFORp_private_view3d_ctor(array, 0_8)
+    call zFORp_private_view3d_partition(view, index, count)
+    do k = 0, zFORp_private_view3d_size_z(view) - 1
+      do j = 0, zFORp_private_view3d_size_y(view) - 1
+        do i = 0, zFORp_private_view3d_size_x(view) - 1
+          call zFORp_private_view3d_set(view, i, j, k, 1.0d0)
+        enddo
+      enddo
+    enddo
+    call zFORp_private_view3d_flush_cache(view)
+    call zFORp_private_view3d_dtor(view)
+  enddo
+  call zFORp_array3d_clear_cache(array)
+  if (zFORp_array3d_get(array, 8, 9, 10) /= 1.0d0) stop 1
+  call zFORp_array3d_dtor(array)
+
   ! zfp library info
   write(*, *) zFORp_version_string
   write(*, *) zFORp_meta_null
@@ -100,4 +146,6 @@ program main
   deallocate(buffer)
   deallocate(input_array)
   deallocate(decompressed_array)
+  deallocate(field_3d)
+  deallocate(array_3d)
 end program main
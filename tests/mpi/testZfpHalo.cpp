@@ -0,0 +1,129 @@
+#include "array/zfparray3.h"
+#include "zfphalo.h"
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+extern "C" {
+#include <cmocka.h>
+}
+
+#include <cmath>
+#include <cstring>
+
+// this file tests ghost-layer exchange of compressed 3D arrays
+
+/* interior values per rank and dimension; ghost layers add one block per side */
+#define INTERIOR 8
+#define SIDE (INTERIOR + 8)
+
+struct setupVars {
+  MPI_Comm comm;
+  int dims[3];
+  int coords[3];
+};
+
+static int
+setup(void **state)
+{
+  setupVars *bundle = new setupVars;
+  int ranks, rank;
+  int periods[3] = { 1, 1, 1 };
+
+  MPI_Comm_size(MPI_COMM_WORLD, &ranks);
+  bundle->dims[0] = bundle->dims[1] = bundle->dims[2] = 0;
+  MPI_Dims_create(ranks, 3, bundle->dims);
+  MPI_Cart_create(MPI_COMM_WORLD, 3, bundle->dims, periods, 0, &bundle->comm);
+  MPI_Comm_rank(bundle->comm, &rank);
+  MPI_Cart_coords(bundle->comm, rank, 3, bundle->coords);
+
+  *state = bundle;
+
+  return 0;
+}
+
+static int
+teardown(void **state)
+{
+  setupVars *bundle = static_cast<setupVars*>(*state);
+  MPI_Comm_free(&bundle->comm);
+  delete bundle;
+
+  return 0;
+}
+
+/* periodic global function evaluated at local index (i, j, k), ghosts included */
+static double
+value(const setupVars* bundle, size_t i, size_t j, size_t k)
+{
+  const size_t local[3] = { i, j, k };
+  double v = 0;
+  for (int d = 0; d < 3; d++) {
+    long n = (long)INTERIOR * bundle->dims[d];
+    long x = ((long)INTERIOR * bundle->coords[d] + (long)local[d] - 4 + n) % n;
+    v += (d + 1) * std::sin(2 * M_PI * (double)x / (double)n);
+  }
+  return v;
+}
+
+/* array with true values in the interior and zeros in the ghost layers */
+static void
+initialize(const setupVars* bundle, zfp::array3d& a, bool ghosts)
+{
+  for (size_t k = 0; k < SIDE; k++)
+    for (size_t j = 0; j < SIDE; j++)
+      for (size_t i = 0; i < SIDE; i++) {
+        bool interior = 4 <= i && i < SIDE - 4 && 4 <= j && j < SIDE - 4 && 4 <= k && k < SIDE - 4;
+        a(i, j, k) = (interior || ghosts) ? value(bundle, i, j, k) : 0.0;
+      }
+}
+
+static void
+given_fixedRateArrays_when_exchangeHalo_expect_matchesArrayCompressedWithTrueGhosts(void **state)
+{
+  setupVars *bundle = static_cast<setupVars*>(*state);
+  zfp::array3d a(SIDE, SIDE, SIDE, 12.0);
+  zfp::array3d expected(SIDE, SIDE, SIDE, 12.0);
+  initialize(bundle, a, false);
+  initialize(bundle, expected, true);
+
+  zfp::mpi::exchange_halo(a, bundle->comm);
+
+  /* fixed-rate ghost blocks are copied bit for bit from their owners */
+  assert_int_equal(a.compressed_size(), expected.compressed_size());
+  assert_int_equal(std::memcmp(a.compressed_data(), expected.compressed_data(), a.compressed_size()), 0);
+}
+
+static void
+given_reversibleArrays_when_exchangeHalo_expect_ghostsHoldNeighborValues(void **state)
+{
+  setupVars *bundle = static_cast<setupVars*>(*state);
+  zfp::array3d a(SIDE, SIDE, SIDE, 0.0);
+  a.set_reversible();
+  initialize(bundle, a, false);
+
+  zfp::mpi::exchange_halo(a, bundle->comm);
+
+  size_t mismatches = 0;
+  for (size_t k = 0; k < SIDE; k++)
+    for (size_t j = 0; j < SIDE; j++)
+      for (size_t i = 0; i < SIDE; i++)
+        if (a(i, j, k) != value(bundle, i, j, k))
+          mismatches++;
+  assert_int_equal(mismatches, 0);
+}
+
+int main(int argc, char* argv[])
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test_setup_teardown(given_fixedRateArrays_when_exchangeHalo_expect_matchesArrayCompressedWithTrueGhosts, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_reversibleArrays_when_exchangeHalo_expect_ghostsHoldNeighborValues, setup, teardown),
+  };
+  int status;
+
+  MPI_Init(&argc, &argv);
+  status = cmocka_run_group_tests(tests, NULL, NULL);
+  MPI_Finalize();
+
+  return status;
+}
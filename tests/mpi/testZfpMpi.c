@@ -0,0 +1,194 @@
+#include "zfpmpi.h"
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* global field whose z extent is not a multiple of the block size */
+#define NX 16
+#define NY 12
+#define NZ 30
+#define FIELD_SIZE (NX * NY * NZ)
+#define FILENAME "testZfpMpi.bin"
+
+struct setupVars {
+  int rank;
+  int ranks;
+  double* data;
+  zfp_stream* stream;
+  zfp_field* global;
+  void* buffer;
+  size_t bufferSize;
+  void* reference;
+  MPI_File file;
+};
+
+static int
+setup(void **state)
+{
+  struct setupVars *bundle = malloc(sizeof(struct setupVars));
+  assert_non_null(bundle);
+
+  MPI_Comm_rank(MPI_COMM_WORLD, &bundle->rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &bundle->ranks);
+
+  bundle->data = malloc(FIELD_SIZE * sizeof(double));
+  assert_non_null(bundle->data);
+  size_t i;
+  for (i = 0; i < FIELD_SIZE; i++)
+    bundle->data[i] = sin(0.05 * (double)i) * (double)(i % 37);
+
+  bundle->stream = zfp_stream_open(NULL);
+  bundle->global = zfp_field_3d(bundle->data, zfp_type_double, NX, NY, NZ);
+  bundle->bufferSize = zfp_stream_maximum_size(bundle->stream, bundle->global);
+  bundle->buffer = calloc(bundle->bufferSize, 1);
+  bundle->reference = calloc(bundle->bufferSize, 1);
+  assert_non_null(bundle->buffer);
+  assert_non_null(bundle->reference);
+
+  assert_int_equal(MPI_File_open(MPI_COMM_WORLD, FILENAME, MPI_MODE_CREATE | MPI_MODE_RDWR, MPI_INFO_NULL, &bundle->file), MPI_SUCCESS);
+
+  *state = bundle;
+
+  return 0;
+}
+
+static int
+teardown(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  MPI_File_close(&bundle->file);
+  MPI_Barrier(MPI_COMM_WORLD);
+  if (!bundle->rank)
+    remove(FILENAME);
+
+  zfp_field_free(bundle->global);
+  zfp_stream_close(bundle->stream);
+  free(bundle->reference);
+  free(bundle->buffer);
+  free(bundle->data);
+  free(bundle);
+
+  return 0;
+}
+
+/* compress whole field on one rank for comparison */
+static size_t
+compressReference(struct setupVars *bundle)
+{
+  bitstream* s = stream_open(bundle->reference, bundle->bufferSize);
+  zfp_stream_set_bit_stream(bundle->stream, s);
+  size_t size = zfp_compress(bundle->stream, bundle->global);
+  zfp_stream_set_bit_stream(bundle->stream, NULL);
+  stream_close(s);
+  return size;
+}
+
+/* read back global stream written collectively */
+static void
+readGlobalStream(struct setupVars *bundle, size_t size)
+{
+  assert_int_equal(MPI_File_sync(bundle->file), MPI_SUCCESS);
+  MPI_Barrier(MPI_COMM_WORLD);
+  assert_int_equal(MPI_File_read_at(bundle->file, 0, bundle->buffer, (int)size, MPI_BYTE, MPI_STATUS_IGNORE), MPI_SUCCESS);
+}
+
+static void
+given_zSlabs_when_zfpMpiCompressVariableRate_expect_matchesSerialStream(void **state)
+{
+  struct setupVars *bundle = *state;
+  size_t z0 = 8 * bundle->rank;
+  size_t nz = bundle->rank == bundle->ranks - 1 ? NZ - z0 : 8;
+  size_t origin[3] = { 0, 0, z0 };
+  zfp_index* index = zfp_index_alloc();
+
+  zfp_stream_set_accuracy(bundle->stream, 1e-3);
+  size_t size = compressReference(bundle);
+
+  zfp_field* local = zfp_field_3d(bundle->data + z0 * NX * NY, zfp_type_double, NX, NY, nz);
+  assert_int_equal(zfp_mpi_compress(bundle->stream, bundle->global, local, origin, bundle->file, 0, index, MPI_COMM_WORLD), size);
+  readGlobalStream(bundle, size);
+  assert_memory_equal(bundle->buffer, bundle->reference, size);
+
+  /* one chunk per rank locates blocks for random access */
+  assert_int_equal(zfp_index_chunks(index), bundle->ranks);
+  bitstream* s = stream_open(bundle->buffer, size);
+  zfp_stream_set_bit_stream(bundle->stream, s);
+  zfp_stream_set_index(bundle->stream, index);
+  double* box = malloc(NX * NY * 4 * sizeof(double));
+  zfp_field* field = zfp_field_3d(box, zfp_type_double, NX, NY, NZ);
+  assert_int_not_equal(zfp_decompress_subset(bundle->stream, field, 0, 0, 20, NX, NY, 4), 0);
+  size_t i;
+  for (i = 0; i < NX * NY * 4; i++)
+    assert_true(fabs(box[i] - bundle->data[20 * NX * NY + i]) <= 1e-3);
+  zfp_stream_set_index(bundle->stream, NULL);
+  zfp_stream_set_bit_stream(bundle->stream, NULL);
+
+  zfp_field_free(field);
+  free(box);
+  stream_close(s);
+  zfp_field_free(local);
+  zfp_index_free(index);
+}
+
+static void
+given_xyBoxes_when_zfpMpiCompressFixedRate_expect_matchesSerialStream(void **state)
+{
+  struct setupVars *bundle = *state;
+  /* 2 x 2 grid of boxes; last column and row hold partial blocks */
+  size_t x0 = 8 * (bundle->rank % 2);
+  size_t y0 = 8 * (bundle->rank / 2 % 2);
+  size_t nx = x0 ? NX - x0 : 8;
+  size_t ny = y0 ? NY - y0 : 8;
+  size_t origin[3] = { x0, y0, 0 };
+
+  zfp_stream_set_rate(bundle->stream, 16, zfp_type_double, 3, zfp_true);
+  size_t size = compressReference(bundle);
+
+  zfp_field* local = zfp_field_3d(bundle->data + x0 + NX * y0, zfp_type_double, nx, ny, NZ);
+  zfp_field_set_stride_3d(local, 1, NX, NX * NY);
+  size_t written = zfp_mpi_compress(bundle->stream, bundle->global, local, origin, bundle->file, 0, NULL, MPI_COMM_WORLD);
+  if (bundle->ranks == 4) {
+    assert_int_equal(written, size);
+    readGlobalStream(bundle, size);
+    assert_memory_equal(bundle->buffer, bundle->reference, size);
+  }
+
+  zfp_field_free(local);
+}
+
+static void
+given_misalignedSubdomain_when_zfpMpiCompress_expect_returnsZeroOnAllRanks(void **state)
+{
+  struct setupVars *bundle = *state;
+  size_t origin[3] = { 0, 0, bundle->rank ? 2 : 0 };
+
+  zfp_stream_set_accuracy(bundle->stream, 1e-3);
+  zfp_field* local = zfp_field_3d(bundle->data, zfp_type_double, NX, NY, 2);
+  assert_int_equal(zfp_mpi_compress(bundle->stream, bundle->global, local, origin, bundle->file, 0, NULL, MPI_COMM_WORLD), 0);
+
+  zfp_field_free(local);
+}
+
+int main(int argc, char* argv[])
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test_setup_teardown(given_zSlabs_when_zfpMpiCompressVariableRate_expect_matchesSerialStream, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_xyBoxes_when_zfpMpiCompressFixedRate_expect_matchesSerialStream, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_misalignedSubdomain_when_zfpMpiCompress_expect_returnsZeroOnAllRanks, setup, teardown),
+  };
+  int status;
+
+  MPI_Init(&argc, &argv);
+  status = cmocka_run_group_tests(tests, NULL, NULL);
+  MPI_Finalize();
+
+  return status;
+}
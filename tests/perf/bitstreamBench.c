@@ -0,0 +1,203 @@
+/*
+Micro-benchmark of the inline bit stream functions for the word type and
+layout selected at compile time via BIT_STREAM_WORD_TYPE and
+BIT_STREAM_STRIDED.  Prints one CSV row per operation and field width with
+the median throughput over several runs in millions of operations per
+second.
+*/
+
+#if defined(__unix__) || defined(__APPLE__)
+  #ifndef _POSIX_C_SOURCE
+    #define _POSIX_C_SOURCE 200112L
+  #endif
+  #define ZFP_WITH_WALL_CLOCK
+#endif
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "include/bitstream.h"
+#include "src/inline/bitstream.c"
+
+/* number of operations per run */
+#define OPS (1u << 20)
+/* words per block and blocks between consecutive blocks of strided streams */
+#define STRIDE_BLOCK 4
+#define STRIDE_DELTA 2
+
+typedef enum {
+  op_write_bits,
+  op_read_bits,
+  op_write_bit,
+  op_read_bit,
+  op_skip,
+  op_rseek
+} bench_op;
+
+static const char* op_name[] = {
+  "write_bits",
+  "read_bits",
+  "write_bit",
+  "read_bit",
+  "skip",
+  "rseek"
+};
+
+/* sink for values read so that reads are not optimized away */
+static volatile uint64 sink;
+
+/* return wall-clock time in seconds (processor time if unavailable) */
+static double
+wall_time(void)
+{
+#ifdef ZFP_WITH_WALL_CLOCK
+  struct timespec ts;
+  if (!clock_gettime(CLOCK_MONOTONIC, &ts))
+    return (double)ts.tv_sec + 1e-9 * (double)ts.tv_nsec;
+#endif
+  return (double)clock() / CLOCKS_PER_SEC;
+}
+
+static int
+compare_double(const void* a, const void* b)
+{
+  double x = *(const double*)a;
+  double y = *(const double*)b;
+  return x < y ? -1 : x > y ? +1 : 0;
+}
+
+/* 64-bit linear congruential generator */
+static uint64
+next(uint64* seed)
+{
+  *seed = *seed * UINT64C(6364136223846793005) + UINT64C(1442695040888963407);
+  return *seed;
+}
+
+/* perform OPS operations of given kind and field width (0 for mixed) */
+static void
+run(bench_op op, bitstream* s, const uint64* value, const uint* width, const size_t* offset)
+{
+  uint64 sum = 0;
+  size_t i;
+
+  stream_rewind(s);
+  switch (op) {
+    case op_write_bits:
+      for (i = 0; i < OPS; i++)
+        stream_write_bits(s, value[i], width[i]);
+      stream_flush(s);
+      break;
+    case op_read_bits:
+      for (i = 0; i < OPS; i++)
+        sum += stream_read_bits(s, width[i]);
+      break;
+    case op_write_bit:
+      for (i = 0; i < OPS; i++)
+        stream_write_bit(s, (uint)value[i] & 1u);
+      stream_flush(s);
+      break;
+    case op_read_bit:
+      for (i = 0; i < OPS; i++)
+        sum += stream_read_bit(s);
+      break;
+    case op_skip:
+      for (i = 0; i < OPS; i++) {
+        stream_skip(s, width[i]);
+        sum += stream_read_bit(s);
+      }
+      break;
+    case op_rseek:
+      for (i = 0; i < OPS; i++) {
+        stream_rseek(s, offset[i]);
+        sum += stream_read_bits(s, width[i]);
+      }
+      break;
+  }
+  sink = sum;
+}
+
+int main(int argc, char* argv[])
+{
+  static const uint widths[] = { 0, 1, 7, 16, 33, 64 };
+  uint repeat = 5;
+  /* room for OPS reads of up to 64 bits each following a skip of one bit */
+  size_t words = (size_t)OPS * 65 / wsize + 2;
+  size_t bytes = words * sizeof(word);
+  uint64* value = (uint64*)malloc(OPS * sizeof(uint64));
+  uint* width = (uint*)malloc(OPS * sizeof(uint));
+  size_t* offset = (size_t*)malloc(OPS * sizeof(size_t));
+  double* rate = NULL;
+  void* buffer;
+  bitstream* s;
+  uint64 seed = 1;
+  int strided = 0;
+  uint o, w, r;
+  size_t i;
+
+  if (argc > 1 && (sscanf(argv[1], "%u", &repeat) != 1 || !repeat)) {
+    fprintf(stderr, "Usage: %s [repetitions]\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+
+#ifdef BIT_STREAM_STRIDED
+  /* each block is followed by STRIDE_DELTA unused blocks */
+  strided = 1;
+  bytes *= 1 + STRIDE_DELTA;
+#endif
+  buffer = calloc(bytes, 1);
+  rate = (double*)malloc(repeat * sizeof(double));
+  s = buffer ? stream_open(buffer, bytes) : NULL;
+  if (!value || !width || !offset || !rate || !s) {
+    fprintf(stderr, "out of memory\n");
+    return EXIT_FAILURE;
+  }
+#ifdef BIT_STREAM_STRIDED
+  stream_set_stride(s, STRIDE_BLOCK, STRIDE_DELTA);
+#endif
+
+  printf("word_size,strided,op,width,mops\n");
+  for (w = 0; w < sizeof(widths) / sizeof(*widths); w++) {
+    /* values fit their field widths; width 0 denotes mixed widths 1-64 */
+    for (i = 0; i < OPS; i++) {
+      width[i] = widths[w] ? widths[w] : 1 + (uint)(next(&seed) >> 58);
+      value[i] = next(&seed) >> (64 - width[i]);
+    }
+    for (i = 0; i < OPS; i++)
+      offset[i] = (size_t)(next(&seed) >> 24) % ((size_t)OPS * (widths[w] ? widths[w] : 1));
+
+    for (o = 0; o < sizeof(op_name) / sizeof(*op_name); o++) {
+      /* single-bit operations do not depend on width */
+      if ((o == op_write_bit || o == op_read_bit) && w != 1)
+        continue;
+      /* populate stream for reading */
+      if (o != op_write_bits && o != op_write_bit)
+        run(op_write_bits, s, value, width, offset);
+      for (r = 0; r < repeat; r++) {
+        double t = wall_time();
+        run((bench_op)o, s, value, width, offset);
+        t = wall_time() - t;
+        rate[r] = t > 0 ? OPS / (1e6 * t) : 0;
+      }
+      qsort(rate, repeat, sizeof(*rate), compare_double);
+      if (o == op_write_bit || o == op_read_bit)
+        printf("%u,%d,%s,1,%g\n", (uint)wsize, strided, op_name[o], rate[repeat / 2]);
+      else if (widths[w])
+        printf("%u,%d,%s,%u,%g\n", (uint)wsize, strided, op_name[o], widths[w], rate[repeat / 2]);
+      else
+        printf("%u,%d,%s,mixed,%g\n", (uint)wsize, strided, op_name[o], rate[repeat / 2]);
+    }
+  }
+
+  stream_close(s);
+  free(buffer);
+  free(value);
+  free(width);
+  free(offset);
+  free(rate);
+
+  return 0;
+}
@@ -0,0 +1,79 @@
+#!/usr/bin/env python
+
+# Run a benchmark that prints CSV to stdout and compare one of its metrics,
+# row by row, with a baseline saved by an earlier run on the same machine.
+# Fails when any row is slower than its baseline by more than the given
+# relative tolerance.  A missing baseline is created from the current run.
+#
+# usage: compare_baseline.py --baseline FILE --keys COL[,COL...]
+#                            --metric COL [--lower-is-better]
+#                            [--tolerance FRACTION] [--update] -- COMMAND...
+
+import argparse
+import csv
+import io
+import os
+import subprocess
+import sys
+
+
+def read_rows(text, keys, metric):
+    rows = {}
+    for row in csv.DictReader(io.StringIO(text)):
+        rows[tuple(row[k] for k in keys)] = float(row[metric])
+    return rows
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compare benchmark results with a baseline")
+    parser.add_argument("--baseline", required=True, help="CSV file of baseline results")
+    parser.add_argument("--keys", required=True, help="comma-separated columns identifying a row")
+    parser.add_argument("--metric", required=True, help="column to compare")
+    parser.add_argument("--lower-is-better", action="store_true", help="metric is a time rather than a rate")
+    parser.add_argument("--tolerance", type=float, default=0.1, help="allowed relative slowdown")
+    parser.add_argument("--update", action="store_true", help="replace baseline with current results")
+    parser.add_argument("command", nargs=argparse.REMAINDER, help="benchmark command")
+    args = parser.parse_args()
+
+    command = args.command[1:] if args.command[:1] == ["--"] else args.command
+    if not command:
+        parser.error("no benchmark command given")
+    output = subprocess.check_output(command).decode("utf-8")
+    keys = args.keys.split(",")
+    current = read_rows(output, keys, args.metric)
+
+    if args.update or not os.path.exists(args.baseline):
+        directory = os.path.dirname(args.baseline)
+        if directory and not os.path.isdir(directory):
+            os.makedirs(directory)
+        with open(args.baseline, "w") as f:
+            f.write(output)
+        print("wrote baseline {} with {} rows".format(args.baseline, len(current)))
+        return 0
+
+    with open(args.baseline) as f:
+        baseline = read_rows(f.read(), keys, args.metric)
+
+    failures = 0
+    for key in sorted(set(current) & set(baseline)):
+        old = baseline[key]
+        new = current[key]
+        # relative slowdown, positive when current is worse
+        if args.lower_is_better:
+            slowdown = new / old - 1 if old > 0 else 0
+        else:
+            slowdown = old / new - 1 if new > 0 else float("inf")
+        status = "ok"
+        if slowdown > args.tolerance:
+            status = "REGRESSION"
+            failures += 1
+        print("{:10s} {:40s} {}: {:g} -> {:g} ({:+.1f}%)".format(status, ",".join(key), args.metric, old, new, 100 * slowdown))
+    missing = len(set(baseline) - set(current))
+    if missing:
+        print("{} baseline rows were not measured".format(missing))
+    print("{} of {} rows regressed by more than {:g}%".format(failures, len(set(current) & set(baseline)), 100 * args.tolerance))
+    return 1 if failures else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
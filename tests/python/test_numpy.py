@@ -106,6 +106,186 @@ class TestNumpy(unittest.TestCase):
             )
             self.assertIsNone(np.testing.assert_array_equal(decompressed_array, random_array))
 
+    def test_execution_policies(self):
+        random_array = np.random.rand(16, 16, 16)
+        for execution in [zfpy.exec_serial, zfpy.exec_omp, zfpy.exec_threads]:
+            threads = 0 if execution == zfpy.exec_serial else 2
+            try:
+                compressed_array = zfpy.compress_numpy(
+                    random_array,
+                    execution=execution,
+                    threads=threads,
+                )
+            except ValueError:
+                # policy not supported by this build of zfp
+                continue
+            decompressed_array = zfpy.decompress_numpy(
+                compressed_array,
+                execution=execution,
+                threads=threads,
+            )
+            self.assertIsNone(np.testing.assert_array_equal(decompressed_array, random_array))
+
+        with self.assertRaises(ValueError):
+            zfpy.compress_numpy(random_array, threads=2)
+
+    def test_preallocated_buffers(self):
+        random_array = np.random.rand(8, 12, 16)
+        buffer = bytearray(zfpy.maximum_size(random_array))
+        size = zfpy.compress_numpy(random_array, out=buffer)
+        self.assertEqual(bytes(buffer[:size]), zfpy.compress_numpy(random_array))
+
+        # decompress from a buffer view into an existing array
+        decompressed_array = np.empty_like(random_array)
+        output = zfpy.decompress_numpy(memoryview(buffer)[:size], out=decompressed_array)
+        self.assertIs(output, decompressed_array)
+        self.assertIsNone(np.testing.assert_array_equal(decompressed_array, random_array))
+
+        with self.assertRaises(ValueError):
+            zfpy.compress_numpy(random_array, out=bytearray(size - 1))
+        with self.assertRaises(ValueError):
+            zfpy.decompress_numpy(buffer, out=np.empty((8, 12, 15)))
+
+    def test_device_arrays(self):
+        try:
+            import cupy
+        except ImportError:
+            self.skipTest("CuPy is not available")
+
+        random_array = cupy.random.rand(16, 16, 16)
+        buffer = cupy.zeros(zfpy.maximum_size(random_array, rate=16), dtype=cupy.uint8)
+        try:
+            size = zfpy.compress_device(random_array, buffer, rate=16)
+        except ValueError:
+            self.skipTest("zfp was built without CUDA support")
+
+        # device-resident stream matches one compressed from host memory
+        host_stream = zfpy.compress_numpy(cupy.asnumpy(random_array), rate=16, write_header=False)
+        self.assertEqual(cupy.asnumpy(buffer[:size]).tobytes(), host_stream)
+
+        decompressed_array = cupy.empty_like(random_array)
+        zfpy.decompress_device(buffer[:size], decompressed_array, rate=16)
+        expected_array = zfpy._decompress(host_stream, zfpy.type_double, random_array.shape, rate=16)
+        self.assertIsNone(np.testing.assert_array_equal(cupy.asnumpy(decompressed_array), expected_array))
+
+    def test_device_arrays_reject_host_memory(self):
+        host_array = np.random.rand(4, 4)
+        if not hasattr(host_array, "__dlpack__"):
+            self.skipTest("NumPy does not support DLPack")
+        with self.assertRaises(TypeError):
+            zfpy.compress_device(host_array, bytearray(1024), rate=16)
+
+    def test_compressed_array(self):
+        values = np.random.rand(6, 7, 9)
+        a = zfpy.array3d(values.shape, 64, values)
+        self.assertEqual(a.shape, values.shape)
+        self.assertEqual(a.rate, 64)
+
+        # bulk and sliced reads agree with each other
+        decompressed = a.get()
+        self.assertTrue(np.allclose(decompressed, values, atol=1e-12))
+        self.assertEqual(a[1, 2, 3], decompressed[1, 2, 3])
+        self.assertIsNone(np.testing.assert_array_equal(a[1:5:2, :, -3:], decompressed[1:5:2, :, -3:]))
+        self.assertIsNone(np.testing.assert_array_equal(a[2, ::-1], decompressed[2, ::-1]))
+
+        # sliced writes broadcast like NumPy
+        a[0, :, 1:3] = 1.5
+        a[5] = np.arange(9.0)
+        decompressed[0, :, 1:3] = 1.5
+        decompressed[5] = np.arange(9.0)
+        out = np.empty_like(values)
+        self.assertIs(a.get(out), out)
+        self.assertIsNone(np.testing.assert_array_equal(out, decompressed))
+
+        a.cache_size = 1 << 20
+        self.assertGreaterEqual(a.cache_size, 1 << 20)
+
+        # pickling preserves the compressed representation
+        import pickle
+        b = pickle.loads(pickle.dumps(a))
+        self.assertEqual(b.shape, a.shape)
+        self.assertEqual(b.compressed_size, a.compressed_size)
+        self.assertIsNone(np.testing.assert_array_equal(b.get(), out))
+
+    def test_compressed_integer_array(self):
+        import pickle
+        labels = (np.arange(6 * 7 * 9).reshape(6, 7, 9) // 5) * 100003
+        for cls, dtype in ((zfpy.array3i, np.int32), (zfpy.array3l, np.int64)):
+            values = labels.astype(dtype)
+            a = cls(values.shape, 8, values, reversible=True)
+            self.assertTrue(a.reversible)
+            self.assertIsNone(np.testing.assert_array_equal(a.get(), values))
+            self.assertEqual(a.get().dtype, dtype)
+            a[1, :, 2] = -7
+            values[1, :, 2] = -7
+            self.assertEqual(a[1, 3, 2], -7)
+            b = pickle.loads(pickle.dumps(a))
+            self.assertTrue(b.reversible)
+            self.assertIsNone(np.testing.assert_array_equal(b.get(), values))
+
+    def test_compress_file(self):
+        import os
+        import tempfile
+        values = np.random.rand(10, 7, 9)
+        expected = zfpy.compress_numpy(values, rate=13)
+        directory = tempfile.mkdtemp()
+        raw_path = os.path.join(directory, "field.raw")
+        out_path = os.path.join(directory, "field.zfp")
+        values.tofile(raw_path)
+
+        # slabs of four planes are concatenated into one stream
+        size = zfpy.compress_file(raw_path, out_path, values.shape, values.dtype, rate=13, slab_size=4)
+        with open(out_path, "rb") as f:
+            compressed = f.read()
+        self.assertEqual(size, len(compressed))
+        self.assertEqual(compressed, expected)
+
+        # memory-mapped arrays are accepted directly
+        mapped = np.memmap(raw_path, dtype=values.dtype, mode="r", shape=values.shape)
+        zfpy.compress_file(mapped, out_path, rate=13)
+        with open(out_path, "rb") as f:
+            self.assertEqual(f.read(), expected)
+
+        with self.assertRaises(ValueError):
+            zfpy.compress_file(mapped, out_path)
+        for path in (raw_path, out_path):
+            os.remove(path)
+        os.rmdir(directory)
+
+    def test_compressor(self):
+        arrays = [np.random.rand(5), np.random.rand(6, 7), np.random.rand(4, 9, 3).astype(np.float32)]
+        compressor = zfpy.Compressor(rate=16)
+        decompressor = zfpy.Decompressor()
+        for array in arrays:
+            compressed = compressor.compress(array)
+            self.assertEqual(compressed, zfpy.compress_numpy(array, rate=16))
+            self.assertIsNone(np.testing.assert_array_equal(
+                decompressor.decompress(compressed),
+                zfpy.decompress_numpy(compressed),
+            ))
+
+        # batched streams match those compressed one at a time
+        streams = compressor.compress_many(arrays)
+        self.assertEqual(streams, [zfpy.compress_numpy(array, rate=16) for array in arrays])
+        for output, array in zip(decompressor.decompress_many(streams), arrays):
+            self.assertIsNone(np.testing.assert_array_equal(output, zfpy.decompress_numpy(zfpy.compress_numpy(array, rate=16))))
+
+        # header-less streams of known dtype and shape
+        array = np.random.rand(8, 8)
+        compressor = zfpy.Compressor(write_header=False)
+        decompressor = zfpy.Decompressor(array.dtype, array.shape)
+        out = np.empty_like(array)
+        self.assertIs(decompressor.decompress(compressor.compress(array), out=out), out)
+        self.assertIsNone(np.testing.assert_array_equal(out, array))
+        for output in decompressor.decompress_many(compressor.compress_many([array, 2 * array])):
+            self.assertIsNone(np.testing.assert_array_equal(output, array))
+            array = 2 * array
+
+        with self.assertRaises(ValueError):
+            zfpy.Compressor(rate=8, precision=16)
+        with self.assertRaises(TypeError):
+            zfpy.Decompressor(dtype=np.float64)
+
     def test_utils(self):
         for ndims in range(1, 5):
             for ztype, ztype_str in [
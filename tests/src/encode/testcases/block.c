@@ -4,6 +4,7 @@ _cmocka_unit_test_setup_teardown(when_seededRandomDataGenerated_expect_ChecksumM
 
 _cmocka_unit_test_setup_teardown(_catFunc3(given_, DIM_INT_STR, Block_when_EncodeBlock_expect_ReturnValReflectsNumBitsWrittenToBitstream), setup, teardown),
 _cmocka_unit_test_setup_teardown(_catFunc3(given_, DIM_INT_STR, Block_when_EncodeBlock_expect_BitstreamChecksumMatches), setup, teardown),
+_cmocka_unit_test(_catFunc3(given_, DIM_INT_STR, ConstantBlock_when_EncodeFirstInt_expect_BitsMatchGeneralCoder)),
 
 #ifdef FL_PT_DATA
 // reversible compression of blocks containing special floating-point values
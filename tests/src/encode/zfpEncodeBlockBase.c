@@ -264,3 +264,47 @@ _catFunc3(given_, DIM_INT_STR, Block_when_EncodeSpecialBlocks_expect_BitstreamCh
     fail_msg("At least 1 special block testcase failed\n");
   }
 }
+
+static void
+_catFunc3(given_, DIM_INT_STR, ConstantBlock_when_EncodeFirstInt_expect_BitsMatchGeneralCoder)(void **state)
+{
+  const uint intprec = CHAR_BIT * (uint)sizeof(UInt);
+  const uint maxbits[] = {1, 2, 3, 7, 40, 100, ZFP_MAX_BITS};
+  const uint maxprec[] = {1, 2, 5, intprec / 2, intprec};
+  size_t words = 2 + ZFP_MAX_BITS / stream_word_bits;
+  void* expected = calloc(words, stream_word_bits / CHAR_BIT);
+  void* actual = calloc(words, stream_word_bits / CHAR_BIT);
+  bitstream* e = stream_open(expected, words * stream_word_bits / CHAR_BIT);
+  bitstream* a = stream_open(actual, words * stream_word_bits / CHAR_BIT);
+  UInt ublock[BLOCK_SIZE];
+  uint i, j, k, n;
+  (void)state;
+
+  memset(ublock, 0, sizeof(ublock));
+  for (i = 0; i < 2 * intprec + 1; i++) {
+    /* single one-bits, low-order masks, and zero */
+    UInt u = i < intprec ? (UInt)1 << i : i < 2 * intprec ? ~(UInt)0 >> (i - intprec) : 0;
+    ublock[0] = u;
+    for (j = 0; j < sizeof(maxbits) / sizeof(*maxbits); j++)
+      for (k = 0; k < sizeof(maxprec) / sizeof(*maxprec); k++) {
+        memset(expected, 0, words * stream_word_bits / CHAR_BIT);
+        memset(actual, 0, words * stream_word_bits / CHAR_BIT);
+        stream_rewind(e);
+        stream_rewind(a);
+        if (BLOCK_SIZE <= 64)
+          n = _t1(encode_ints, UInt)(e, maxbits[j], maxprec[k], ublock, BLOCK_SIZE);
+        else
+          n = _t1(encode_many_ints, UInt)(e, maxbits[j], maxprec[k], ublock, BLOCK_SIZE);
+        assert_int_equal(_t1(encode_first_int, UInt)(a, maxbits[j], maxprec[k], u), n);
+        stream_flush(e);
+        stream_flush(a);
+        assert_memory_equal(actual, expected, words * stream_word_bits / CHAR_BIT);
+      }
+  }
+
+  stream_close(a);
+  stream_close(e);
+  free(actual);
+  free(expected);
+}
+
@@ -110,35 +110,11 @@ _catFunc3(given_, DESCRIPTOR, Array_when_ZfpCompressDecompressFixedRate_expect_B
   runCompressDecompressTests(state, zfp_mode_fixed_rate, 3);
 }
 
-// cover all non=fixed-rate modes (except expert)
+// reversible mode is not supported on the GPU
 static void
-_catFunc3(given_, DESCRIPTOR, Array_when_ZfpCompressDecompressNonFixedRate_expect_BitstreamUntouchedAndReturnsZero)(void **state)
+_catFunc3(given_, DESCRIPTOR, Array_when_ZfpCompressDecompressReversible_expect_BitstreamUntouchedAndReturnsZero)(void **state)
 {
-  struct setupVars *bundle = *state;
-
-  // loop over fixed prec, fixed acc, reversible
-  zfp_mode mode;
-  int failures = 0;
-  for (mode = zfp_mode_fixed_precision; mode <= zfp_mode_reversible; mode++) {
-    zfp_type type = zfp_field_type(bundle->field);
-    if ((mode == zfp_mode_fixed_accuracy) && (type == zfp_type_int32 || type == zfp_type_int64)) {
-      // skip fixed accuracy when unsupported
-      continue;
-    }
-
-    if (setupCompressParam(bundle, mode, 1) == 1) {
-      failures++;
-      continue;
-    }
-
-    if (runZfpCompressDecompressIsNoop(state) == 1) {
-      failures++;
-    }
-  }
-
-  if (failures > 0) {
-    fail_msg("Compression/Decompression no-op test failed\n");
-  }
+  runCompressDecompressNoopTest(state, zfp_mode_reversible);
 }
 
 static void
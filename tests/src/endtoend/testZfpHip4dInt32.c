@@ -0,0 +1,13 @@
+#include "src/encode4i.c"
+
+#include "constants/4dInt32.h"
+#include "hipExecBase.c"
+
+int main()
+{
+  const struct CMUnitTest tests[] = {
+    #include "testcases/hip.c"
+  };
+
+  return cmocka_run_group_tests(tests, setupRandomData, teardownRandomData);
+}
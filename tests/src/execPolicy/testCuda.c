@@ -5,15 +5,24 @@
 #include <setjmp.h>
 #include <cmocka.h>
 
+#include <cuda_runtime_api.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+#define NX 9
+#define NY 5
+#define NZ 4
+#define NW 4
+#define RATE 16
+
 struct setupVars {
   zfp_stream* stream;
   zfp_field* field;
   bitstream* bs;
+  int* data;
   void* buffer;
-  size_t streamSize;
+  size_t bufferSize;
 };
 
 static int
@@ -25,26 +34,27 @@ setup(void **state)
   bundle->stream = zfp_stream_open(NULL);
   assert_non_null(bundle);
 
-  /* create a bitstream with buffer */
-  size_t bufferSize = 50 * sizeof(int);
-  bundle->buffer = malloc(bufferSize);
-  assert_non_null(bundle->buffer);
-  memset(bundle->buffer, 0, bufferSize);
+  /* create 4d field with smoothly varying values and partial blocks */
+  size_t n = NX * NY * NZ * NW;
+  size_t i;
+  bundle->data = malloc(n * sizeof(int));
+  assert_non_null(bundle->data);
+  for (i = 0; i < n; i++)
+    bundle->data[i] = (int)(i * i) - (int)(64 * i);
 
-  /* offset bitstream, so we can distinguish 0 from stream_size() returned from zfp_decompress() */
-  bundle->bs = stream_open(bundle->buffer, bufferSize);
-  stream_skip(bundle->bs, stream_word_bits + 1);
+  bundle->field = zfp_field_4d(bundle->data, zfp_type_int32, NX, NY, NZ, NW);
+  assert_non_null(bundle->field);
+  assert_int_equal(4, zfp_field_dimensionality(bundle->field));
 
-  bundle->streamSize = stream_size(bundle->bs);
-  assert_int_not_equal(bundle->streamSize, 0);
+  zfp_stream_set_rate(bundle->stream, RATE, zfp_type_int32, 4, 0);
 
-  /* set cuda policy */
-  assert_int_equal(1, zfp_stream_set_execution(bundle->stream, zfp_exec_cuda));
+  /* create a bitstream with buffer */
+  bundle->bufferSize = zfp_stream_maximum_size(bundle->stream, bundle->field);
+  bundle->buffer = calloc(bundle->bufferSize, 1);
+  assert_non_null(bundle->buffer);
 
-  /* create 4d field */
-  bundle->field = zfp_field_4d(NULL, zfp_type_int32, 9, 5, 4, 4);
-  assert_non_null(bundle->field);
-  assert_int_equal(4, zfp_field_dimensionality(bundle->field));
+  bundle->bs = stream_open(bundle->buffer, bundle->bufferSize);
+  zfp_stream_set_bit_stream(bundle->stream, bundle->bs);
 
   *state = bundle;
 
@@ -57,6 +67,7 @@ teardown(void **state)
   struct setupVars *bundle = *state;
 
   zfp_field_free(bundle->field);
+  free(bundle->data);
 
   stream_close(bundle->bs);
   free(bundle->buffer);
@@ -67,29 +78,493 @@ teardown(void **state)
   return 0;
 }
 
+/* compress field serially into a separate buffer */
+static void*
+compressSerial(struct setupVars *bundle, size_t* size)
+{
+  void* buffer = calloc(bundle->bufferSize, 1);
+  assert_non_null(buffer);
+  bitstream* bs = stream_open(buffer, bundle->bufferSize);
+  zfp_stream_set_bit_stream(bundle->stream, bs);
+
+  assert_int_equal(1, zfp_stream_set_execution(bundle->stream, zfp_exec_serial));
+  *size = zfp_compress(bundle->stream, bundle->field);
+  assert_int_not_equal(*size, 0);
+
+  zfp_stream_set_bit_stream(bundle->stream, bundle->bs);
+  stream_close(bs);
+
+  return buffer;
+}
+
 static void
-given_withCuda_when_4dCompressCudaPolicy_expect_noop(void **state)
+given_withCuda_when_4dCompressCudaPolicy_expect_matchesSerial(void **state)
 {
   struct setupVars *bundle = *state;
 
-  assert_int_equal(zfp_compress(bundle->stream, bundle->field), 0);
-  assert_int_equal(stream_size(bundle->bs), bundle->streamSize);
+  size_t serialSize;
+  void* serialBuffer = compressSerial(bundle, &serialSize);
+
+  assert_int_equal(1, zfp_stream_set_execution(bundle->stream, zfp_exec_cuda));
+  zfp_stream_rewind(bundle->stream);
+  assert_int_equal(zfp_compress(bundle->stream, bundle->field), serialSize);
+  assert_memory_equal(bundle->buffer, serialBuffer, serialSize);
+
+  free(serialBuffer);
 }
 
 static void
-given_withCuda_when_4dDecompressCudaPolicy_expect_noop(void **state)
+given_withCuda_when_4dDecompressCudaPolicy_expect_matchesSerial(void **state)
 {
   struct setupVars *bundle = *state;
+  size_t n = NX * NY * NZ * NW;
+  int* serialData = malloc(n * sizeof(int));
+  assert_non_null(serialData);
+
+  size_t serialSize;
+  void* serialBuffer = compressSerial(bundle, &serialSize);
+  memcpy(bundle->buffer, serialBuffer, serialSize);
+
+  /* decompress serially */
+  zfp_field_set_pointer(bundle->field, serialData);
+  zfp_stream_rewind(bundle->stream);
+  assert_int_equal(zfp_decompress(bundle->stream, bundle->field), serialSize);
+
+  /* decompress in parallel */
+  memset(bundle->data, 0, n * sizeof(int));
+  zfp_field_set_pointer(bundle->field, bundle->data);
+  assert_int_equal(1, zfp_stream_set_execution(bundle->stream, zfp_exec_cuda));
+  zfp_stream_rewind(bundle->stream);
+  assert_int_equal(zfp_decompress(bundle->stream, bundle->field), serialSize);
+
+  assert_memory_equal(bundle->data, serialData, n * sizeof(int));
+
+  free(serialBuffer);
+  free(serialData);
+}
+
+static void*
+dummyAlloc(size_t size, void* context)
+{
+  (void)size;
+  (void)context;
+  return NULL;
+}
+
+static void
+dummyFree(void* ptr, void* context)
+{
+  (void)ptr;
+  (void)context;
+}
+
+static void
+given_withCuda_when_setCudaAllocator_expect_allocatorStoredUntilPolicyChanges(void **state)
+{
+  struct setupVars *bundle = *state;
+  int context = 0;
+  zfp_device_allocator allocator = { dummyAlloc, dummyFree, &context };
+  zfp_device_allocator unpaired = { dummyAlloc, NULL, NULL };
+
+  assert_int_equal(zfp_stream_set_cuda_allocator(bundle->stream, &allocator), 1);
+  assert_int_equal(zfp_stream_execution(bundle->stream), zfp_exec_cuda);
+  zfp_device_allocator actual = zfp_stream_cuda_allocator(bundle->stream);
+  assert_ptr_equal(actual.alloc, dummyAlloc);
+  assert_ptr_equal(actual.free, dummyFree);
+  assert_ptr_equal(actual.context, &context);
+
+  /* allocation and deallocation functions must be paired */
+  assert_int_equal(zfp_stream_set_cuda_allocator(bundle->stream, &unpaired), 0);
+  actual = zfp_stream_cuda_allocator(bundle->stream);
+  assert_ptr_equal(actual.alloc, dummyAlloc);
+
+  /* changing execution policy restores the default allocator */
+  assert_int_equal(zfp_stream_set_execution(bundle->stream, zfp_exec_serial), 1);
+  assert_int_equal(zfp_stream_set_execution(bundle->stream, zfp_exec_cuda), 1);
+  actual = zfp_stream_cuda_allocator(bundle->stream);
+  assert_null(actual.alloc);
+  assert_null(actual.free);
+  assert_null(actual.context);
+
+  /* NULL also restores the default allocator */
+  assert_int_equal(zfp_stream_set_cuda_allocator(bundle->stream, &allocator), 1);
+  assert_int_equal(zfp_stream_set_cuda_allocator(bundle->stream, NULL), 1);
+  actual = zfp_stream_cuda_allocator(bundle->stream);
+  assert_null(actual.alloc);
+}
+
+static void
+given_withCuda_when_4dCompressAsyncThenSynchronize_expect_matchesSerial(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  size_t serialSize;
+  void* serialBuffer = compressSerial(bundle, &serialSize);
+
+  /* queue work on the default stream and wait for it to complete */
+  assert_int_equal(1, zfp_stream_set_cuda_stream(bundle->stream, NULL));
+  zfp_stream_rewind(bundle->stream);
+  assert_int_equal(zfp_compress_async(bundle->stream, bundle->field), serialSize);
+  assert_int_equal(1, zfp_stream_synchronize(bundle->stream));
+  assert_memory_equal(bundle->buffer, serialBuffer, serialSize);
+
+  free(serialBuffer);
+}
+
+static void
+given_withCuda_when_setCudaStream_expect_streamStoredUntilPolicyChanges(void **state)
+{
+  struct setupVars *bundle = *state;
+  int handle;
+
+  assert_int_equal(zfp_stream_set_cuda_stream(bundle->stream, &handle), 1);
+  assert_int_equal(zfp_stream_execution(bundle->stream), zfp_exec_cuda);
+  assert_ptr_equal(zfp_stream_cuda_stream(bundle->stream), &handle);
+
+  /* the allocator is independent of the stream */
+  assert_int_equal(zfp_stream_set_cuda_allocator(bundle->stream, NULL), 1);
+  assert_ptr_equal(zfp_stream_cuda_stream(bundle->stream), &handle);
+
+  /* changing execution policy restores the default stream */
+  assert_int_equal(zfp_stream_set_execution(bundle->stream, zfp_exec_serial), 1);
+  assert_int_equal(zfp_stream_set_execution(bundle->stream, zfp_exec_cuda), 1);
+  assert_null(zfp_stream_cuda_stream(bundle->stream));
+}
+
+static void
+given_withCuda_when_4dCompressDecompressInSlabs_expect_matchesSerial(void **state)
+{
+  struct setupVars *bundle = *state;
+  size_t n = NX * NY * NZ * NW;
+  int* expected = malloc(n * sizeof(int));
+  assert_non_null(expected);
+
+  size_t serialSize;
+  void* serialBuffer = compressSerial(bundle, &serialSize);
+
+  /* stage one layer of blocks at a time through the pipeline */
+  assert_int_equal(1, zfp_stream_set_cuda_chunk_bytes(bundle->stream, 1));
+  assert_int_equal(zfp_stream_cuda_chunk_bytes(bundle->stream), 1);
+  zfp_stream_rewind(bundle->stream);
+  assert_int_equal(zfp_compress(bundle->stream, bundle->field), serialSize);
+  assert_memory_equal(bundle->buffer, serialBuffer, serialSize);
+
+  /* decompress serially */
+  assert_int_equal(1, zfp_stream_set_execution(bundle->stream, zfp_exec_serial));
+  zfp_stream_rewind(bundle->stream);
+  assert_int_equal(zfp_decompress(bundle->stream, bundle->field), serialSize);
+  memcpy(expected, bundle->data, n * sizeof(int));
+
+  /* decompress in slabs */
+  memset(bundle->data, 0, n * sizeof(int));
+  assert_int_equal(1, zfp_stream_set_cuda_chunk_bytes(bundle->stream, 1));
+  zfp_stream_rewind(bundle->stream);
+  assert_int_equal(zfp_decompress(bundle->stream, bundle->field), serialSize);
+  assert_memory_equal(bundle->data, expected, n * sizeof(int));
+
+  free(serialBuffer);
+  free(expected);
+}
+
+static void
+given_withCuda_when_setCudaDevices_expect_devicesStoredUntilPolicyChanges(void **state)
+{
+  struct setupVars *bundle = *state;
+  int device[ZFP_CUDA_MAX_DEVICES + 1] = { 0 };
+  device[1] = 3;
+
+  assert_int_equal(zfp_stream_set_cuda_devices(bundle->stream, device, 2), 1);
+  assert_int_equal(zfp_stream_execution(bundle->stream), zfp_exec_cuda);
+  assert_int_equal(zfp_stream_cuda_devices(bundle->stream), 2);
+  assert_int_equal(zfp_stream_cuda_device(bundle->stream, 1), 3);
+  assert_int_equal(zfp_stream_cuda_device(bundle->stream, 2), -1);
+
+  /* too many devices leave the list unchanged */
+  assert_int_equal(zfp_stream_set_cuda_devices(bundle->stream, device, ZFP_CUDA_MAX_DEVICES + 1), 0);
+  assert_int_equal(zfp_stream_cuda_devices(bundle->stream), 2);
+
+  /* changing execution policy restores the current device */
+  assert_int_equal(zfp_stream_set_execution(bundle->stream, zfp_exec_serial), 1);
+  assert_int_equal(zfp_stream_set_execution(bundle->stream, zfp_exec_cuda), 1);
+  assert_int_equal(zfp_stream_cuda_devices(bundle->stream), 0);
+}
+
+static void
+given_withCuda_when_setCudaPrefetchHost_expect_flagStoredUntilPolicyChanges(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  assert_int_equal(zfp_stream_set_execution(bundle->stream, zfp_exec_cuda), 1);
+  assert_int_equal(zfp_stream_cuda_prefetch_host(bundle->stream), zfp_false);
+
+  assert_int_equal(zfp_stream_set_cuda_prefetch_host(bundle->stream, zfp_true), 1);
+  assert_int_equal(zfp_stream_execution(bundle->stream), zfp_exec_cuda);
+  assert_int_equal(zfp_stream_cuda_prefetch_host(bundle->stream), zfp_true);
+
+  /* changing execution policy restores the default */
+  assert_int_equal(zfp_stream_set_execution(bundle->stream, zfp_exec_serial), 1);
+  assert_int_equal(zfp_stream_cuda_prefetch_host(bundle->stream), zfp_false);
+  assert_int_equal(zfp_stream_set_execution(bundle->stream, zfp_exec_cuda), 1);
+  assert_int_equal(zfp_stream_cuda_prefetch_host(bundle->stream), zfp_false);
+}
+
+static void
+given_withCuda_when_3dCompressDecompressOnDeviceList_expect_matchesSerial(void **state)
+{
+  struct setupVars *bundle = *state;
+  size_t n = NX * NY * NZ * NW;
+  int* expected = malloc(n * sizeof(int));
+  assert_non_null(expected);
+  /* the same device may be listed more than once */
+  int device[3] = { 0, 0, 0 };
+
+  /* view field as 3d so that it spans several block layers */
+  zfp_field_set_size_3d(bundle->field, NX, NY, NZ * NW);
+  zfp_stream_set_rate(bundle->stream, RATE, zfp_type_int32, 3, 0);
+
+  size_t serialSize;
+  void* serialBuffer = compressSerial(bundle, &serialSize);
+
+  assert_int_equal(1, zfp_stream_set_cuda_devices(bundle->stream, device, 3));
+  zfp_stream_rewind(bundle->stream);
+  assert_int_equal(zfp_compress(bundle->stream, bundle->field), serialSize);
+  assert_memory_equal(bundle->buffer, serialBuffer, serialSize);
+
+  /* decompress serially */
+  assert_int_equal(1, zfp_stream_set_execution(bundle->stream, zfp_exec_serial));
+  zfp_stream_rewind(bundle->stream);
+  assert_int_equal(zfp_decompress(bundle->stream, bundle->field), serialSize);
+  memcpy(expected, bundle->data, n * sizeof(int));
+
+  /* decompress on device list */
+  memset(bundle->data, 0, n * sizeof(int));
+  assert_int_equal(1, zfp_stream_set_cuda_devices(bundle->stream, device, 3));
+  zfp_stream_rewind(bundle->stream);
+  assert_int_equal(zfp_decompress(bundle->stream, bundle->field), serialSize);
+  assert_memory_equal(bundle->data, expected, n * sizeof(int));
+
+  free(serialBuffer);
+  free(expected);
+}
+
+static void
+given_withCuda_when_3dDecompressSurface_expect_arrayMatchesSerial(void **state)
+{
+  struct setupVars *bundle = *state;
+  size_t n = NX * NY * NZ * NW;
+  int* expected = malloc(n * sizeof(int));
+  assert_non_null(expected);
+
+  /* view field as 3d, which surfaces support */
+  zfp_field_set_size_3d(bundle->field, NX, NY, NZ * NW);
+  zfp_stream_set_rate(bundle->stream, RATE, zfp_type_int32, 3, 0);
+
+  size_t serialSize;
+  void* serialBuffer = compressSerial(bundle, &serialSize);
+  memcpy(bundle->buffer, serialBuffer, serialSize);
+  zfp_stream_rewind(bundle->stream);
+  assert_int_equal(zfp_decompress(bundle->stream, bundle->field), serialSize);
+  memcpy(expected, bundle->data, n * sizeof(int));
+
+  /* 3d array with one 32-bit integer channel, bound to a surface */
+  cudaChannelFormatDesc desc = cudaCreateChannelDesc(32, 0, 0, 0, cudaChannelFormatKindSigned);
+  cudaExtent extent = make_cudaExtent(NX, NY, NZ * NW);
+  cudaArray_t array;
+  assert_int_equal(cudaMalloc3DArray(&array, &desc, extent, cudaArraySurfaceLoadStore), cudaSuccess);
+  struct cudaResourceDesc resource;
+  memset(&resource, 0, sizeof(resource));
+  resource.resType = cudaResourceTypeArray;
+  resource.res.array.array = array;
+  cudaSurfaceObject_t surface;
+  assert_int_equal(cudaCreateSurfaceObject(&surface, &resource), cudaSuccess);
+
+  /* host policies cannot write to surfaces */
+  zfp_stream_rewind(bundle->stream);
+  assert_int_equal(zfp_decompress_surface(bundle->stream, bundle->field, (uint64)surface), 0);
+
+  assert_int_equal(1, zfp_stream_set_execution(bundle->stream, zfp_exec_cuda));
+  zfp_stream_rewind(bundle->stream);
+  assert_int_equal(zfp_decompress_surface(bundle->stream, bundle->field, (uint64)surface), serialSize);
+
+  /* copy array back to host */
+  struct cudaMemcpy3DParms copy;
+  memset(&copy, 0, sizeof(copy));
+  memset(bundle->data, 0, n * sizeof(int));
+  copy.srcArray = array;
+  copy.dstPtr = make_cudaPitchedPtr(bundle->data, NX * sizeof(int), NX, NY);
+  copy.extent = extent;
+  copy.kind = cudaMemcpyDeviceToHost;
+  assert_int_equal(cudaMemcpy3D(&copy), cudaSuccess);
+  assert_memory_equal(bundle->data, expected, n * sizeof(int));
+
+  cudaDestroySurfaceObject(surface);
+  cudaFreeArray(array);
+  free(serialBuffer);
+  free(expected);
+}
+
+static void
+given_withCuda_when_4dPlanReplayedFromGraph_expect_matchesSerial(void **state)
+{
+  struct setupVars *bundle = *state;
+  size_t n = NX * NY * NZ * NW;
+  int* expected = malloc(n * sizeof(int));
+  assert_non_null(expected);
+
+  size_t serialSize;
+  void* serialBuffer = compressSerial(bundle, &serialSize);
+
+  /* copy original field to the device */
+  int* d_data;
+  void* d_buffer;
+  assert_int_equal(cudaMalloc((void**)&d_data, n * sizeof(int)), cudaSuccess);
+  assert_int_equal(cudaMalloc(&d_buffer, bundle->bufferSize), cudaSuccess);
+  cudaMemcpy(d_data, bundle->data, n * sizeof(int), cudaMemcpyHostToDevice);
+
+  /* decompress serially */
+  memcpy(bundle->buffer, serialBuffer, serialSize);
+  zfp_stream_rewind(bundle->stream);
+  assert_int_equal(zfp_decompress(bundle->stream, bundle->field), serialSize);
+  memcpy(expected, bundle->data, n * sizeof(int));
+
+  /* plans require the CUDA policy */
+  assert_null(zfp_cuda_plan_create(bundle->stream, bundle->field));
+
+  cudaStream_t cuda_stream;
+  assert_int_equal(cudaStreamCreate(&cuda_stream), cudaSuccess);
+  assert_int_equal(1, zfp_stream_set_cuda_stream(bundle->stream, cuda_stream));
+  zfp_cuda_plan* plan = zfp_cuda_plan_create(bundle->stream, bundle->field);
+  assert_non_null(plan);
+
+  /* capture compression into a graph and replay it */
+  cudaGraph_t graph;
+  cudaGraphExec_t exec;
+  assert_int_equal(cudaStreamBeginCapture(cuda_stream, cudaStreamCaptureModeGlobal), cudaSuccess);
+  assert_int_equal(zfp_cuda_plan_compress(plan, d_buffer, d_data), serialSize);
+  assert_int_equal(cudaStreamEndCapture(cuda_stream, &graph), cudaSuccess);
+  assert_int_equal(cudaGraphInstantiate(&exec, graph, NULL, NULL, 0), cudaSuccess);
+  int step;
+  for (step = 0; step < 3; step++)
+    assert_int_equal(cudaGraphLaunch(exec, cuda_stream), cudaSuccess);
+  assert_int_equal(cudaStreamSynchronize(cuda_stream), cudaSuccess);
+  memset(bundle->buffer, 0, bundle->bufferSize);
+  cudaMemcpy(bundle->buffer, d_buffer, serialSize, cudaMemcpyDeviceToHost);
+  assert_memory_equal(bundle->buffer, serialBuffer, serialSize);
+
+  /* decompress with the same plan */
+  cudaMemset(d_data, 0, n * sizeof(int));
+  assert_int_equal(zfp_cuda_plan_decompress(plan, d_data, d_buffer), serialSize);
+  assert_int_equal(cudaStreamSynchronize(cuda_stream), cudaSuccess);
+  cudaMemcpy(bundle->data, d_data, n * sizeof(int), cudaMemcpyDeviceToHost);
+  assert_memory_equal(bundle->data, expected, n * sizeof(int));
+
+  cudaGraphExecDestroy(exec);
+  cudaGraphDestroy(graph);
+  cudaFree(d_buffer);
+  cudaFree(d_data);
+  zfp_cuda_plan_free(plan);
+  cudaStreamDestroy(cuda_stream);
+  free(serialBuffer);
+  free(expected);
+}
+
+static void
+given_withCuda_when_deviceStreamWrittenAndReadFromFile_expect_matchesSerial(void **state)
+{
+  struct setupVars *bundle = *state;
+  const char* path = "testCuda-stream.zfp";
+
+  size_t serialSize;
+  void* serialBuffer = compressSerial(bundle, &serialSize);
+
+  /* write device-resident stream to file */
+  void* d_buffer;
+  assert_int_equal(cudaMalloc(&d_buffer, bundle->bufferSize), cudaSuccess);
+  cudaMemcpy(d_buffer, serialBuffer, serialSize, cudaMemcpyHostToDevice);
+  assert_int_equal(zfp_cuda_write_file(path, d_buffer, serialSize), serialSize);
+
+  /* read it back into device memory, which may exceed the file size */
+  cudaMemset(d_buffer, 0, bundle->bufferSize);
+  assert_int_equal(zfp_cuda_read_file(path, d_buffer, bundle->bufferSize), serialSize);
+  memset(bundle->buffer, 0, bundle->bufferSize);
+  cudaMemcpy(bundle->buffer, d_buffer, serialSize, cudaMemcpyDeviceToHost);
+  assert_memory_equal(bundle->buffer, serialBuffer, serialSize);
+
+  /* host buffers are read directly */
+  memset(bundle->buffer, 0, bundle->bufferSize);
+  assert_int_equal(zfp_cuda_read_file(path, bundle->buffer, bundle->bufferSize), serialSize);
+  assert_memory_equal(bundle->buffer, serialBuffer, serialSize);
+
+  remove(path);
+  cudaFree(d_buffer);
+  free(serialBuffer);
+}
+
+static void
+given_withCuda_when_3dCompressDecompressHybrid_expect_matchesSerialAndCalibratesRatio(void **state)
+{
+  struct setupVars *bundle = *state;
+  size_t n = NX * NY * NZ * NW;
+  int* expected = malloc(n * sizeof(int));
+  assert_non_null(expected);
+
+  /* view field as 3d so that it spans several block layers */
+  zfp_field_set_size_3d(bundle->field, NX, NY, NZ * NW);
+  zfp_stream_set_rate(bundle->stream, RATE, zfp_type_int32, 3, 0);
+
+  size_t serialSize;
+  void* serialBuffer = compressSerial(bundle, &serialSize);
+
+  /* hybrid execution also requires OpenMP */
+  if (!zfp_stream_set_hybrid_ratio(bundle->stream, 0.5, zfp_true)) {
+    free(serialBuffer);
+    free(expected);
+    return;
+  }
+  assert_int_equal(zfp_stream_hybrid_device(bundle->stream), zfp_exec_cuda);
+  assert_int_equal(zfp_stream_set_hybrid_device(bundle->stream, zfp_exec_hip), 0);
+  assert_int_equal(zfp_stream_set_hybrid_ratio(bundle->stream, 1.5, zfp_true), 0);
+
+  zfp_stream_rewind(bundle->stream);
+  assert_int_equal(zfp_compress(bundle->stream, bundle->field), serialSize);
+  assert_memory_equal(bundle->buffer, serialBuffer, serialSize);
+  double ratio = zfp_stream_hybrid_ratio(bundle->stream);
+  assert_true(1.0 / 16 <= ratio && ratio <= 15.0 / 16);
+
+  /* decompress serially */
+  assert_int_equal(1, zfp_stream_set_execution(bundle->stream, zfp_exec_serial));
+  zfp_stream_rewind(bundle->stream);
+  assert_int_equal(zfp_decompress(bundle->stream, bundle->field), serialSize);
+  memcpy(expected, bundle->data, n * sizeof(int));
+
+  /* decompress with fixed split */
+  memset(bundle->data, 0, n * sizeof(int));
+  assert_int_equal(1, zfp_stream_set_hybrid_ratio(bundle->stream, 0.25, zfp_false));
+  zfp_stream_rewind(bundle->stream);
+  assert_int_equal(zfp_decompress(bundle->stream, bundle->field), serialSize);
+  assert_memory_equal(bundle->data, expected, n * sizeof(int));
+  assert_true(zfp_stream_hybrid_ratio(bundle->stream) == 0.25);
 
-  assert_int_equal(zfp_decompress(bundle->stream, bundle->field), 0);
-  assert_int_equal(stream_size(bundle->bs), bundle->streamSize);
+  free(serialBuffer);
+  free(expected);
 }
 
 int main()
 {
   const struct CMUnitTest tests[] = {
-    cmocka_unit_test_setup_teardown(given_withCuda_when_4dCompressCudaPolicy_expect_noop, setup, teardown),
-    cmocka_unit_test_setup_teardown(given_withCuda_when_4dDecompressCudaPolicy_expect_noop, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_withCuda_when_4dCompressCudaPolicy_expect_matchesSerial, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_withCuda_when_4dDecompressCudaPolicy_expect_matchesSerial, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_withCuda_when_setCudaAllocator_expect_allocatorStoredUntilPolicyChanges, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_withCuda_when_4dCompressAsyncThenSynchronize_expect_matchesSerial, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_withCuda_when_setCudaStream_expect_streamStoredUntilPolicyChanges, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_withCuda_when_4dCompressDecompressInSlabs_expect_matchesSerial, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_withCuda_when_setCudaDevices_expect_devicesStoredUntilPolicyChanges, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_withCuda_when_3dCompressDecompressOnDeviceList_expect_matchesSerial, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_withCuda_when_setCudaPrefetchHost_expect_flagStoredUntilPolicyChanges, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_withCuda_when_3dDecompressSurface_expect_arrayMatchesSerial, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_withCuda_when_4dPlanReplayedFromGraph_expect_matchesSerial, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_withCuda_when_deviceStreamWrittenAndReadFromFile_expect_matchesSerial, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_withCuda_when_3dCompressDecompressHybrid_expect_matchesSerialAndCalibratesRatio, setup, teardown),
   };
   return cmocka_run_group_tests(tests, NULL, NULL);
 }
@@ -8,12 +8,19 @@
 #include <stdlib.h>
 #include <string.h>
 
+#define NX 9
+#define NY 5
+#define NZ 4
+#define NW 4
+#define RATE 16
+
 struct setupVars {
   zfp_stream* stream;
   zfp_field* field;
   bitstream* bs;
+  int* data;
   void* buffer;
-  size_t streamSize;
+  size_t bufferSize;
 };
 
 static int
@@ -25,26 +32,27 @@ setup(void **state)
   bundle->stream = zfp_stream_open(NULL);
   assert_non_null(bundle);
 
-  /* create a bitstream with buffer */
-  size_t bufferSize = 50 * sizeof(int);
-  bundle->buffer = malloc(bufferSize);
-  assert_non_null(bundle->buffer);
-  memset(bundle->buffer, 0, bufferSize);
+  /* create 4d field with smoothly varying values and partial blocks */
+  size_t n = NX * NY * NZ * NW;
+  size_t i;
+  bundle->data = malloc(n * sizeof(int));
+  assert_non_null(bundle->data);
+  for (i = 0; i < n; i++)
+    bundle->data[i] = (int)(i * i) - (int)(64 * i);
 
-  /* offset bitstream, so we can distinguish 0 from stream_size() returned from zfp_decompress() */
-  bundle->bs = stream_open(bundle->buffer, bufferSize);
-  stream_skip(bundle->bs, stream_word_bits + 1);
+  bundle->field = zfp_field_4d(bundle->data, zfp_type_int32, NX, NY, NZ, NW);
+  assert_non_null(bundle->field);
+  assert_int_equal(4, zfp_field_dimensionality(bundle->field));
 
-  bundle->streamSize = stream_size(bundle->bs);
-  assert_int_not_equal(bundle->streamSize, 0);
+  zfp_stream_set_rate(bundle->stream, RATE, zfp_type_int32, 4, 0);
 
-  /* set hip policy */
-  assert_int_equal(1, zfp_stream_set_execution(bundle->stream, zfp_exec_hip));
+  /* create a bitstream with buffer */
+  bundle->bufferSize = zfp_stream_maximum_size(bundle->stream, bundle->field);
+  bundle->buffer = calloc(bundle->bufferSize, 1);
+  assert_non_null(bundle->buffer);
 
-  /* create 4d field */
-  bundle->field = zfp_field_4d(NULL, zfp_type_int32, 9, 5, 4, 4);
-  assert_non_null(bundle->field);
-  assert_int_equal(4, zfp_field_dimensionality(bundle->field));
+  bundle->bs = stream_open(bundle->buffer, bundle->bufferSize);
+  zfp_stream_set_bit_stream(bundle->stream, bundle->bs);
 
   *state = bundle;
 
@@ -57,6 +65,7 @@ teardown(void **state)
   struct setupVars *bundle = *state;
 
   zfp_field_free(bundle->field);
+  free(bundle->data);
 
   stream_close(bundle->bs);
   free(bundle->buffer);
@@ -67,29 +76,95 @@ teardown(void **state)
   return 0;
 }
 
+/* compress field serially into a separate buffer */
+static void*
+compressSerial(struct setupVars *bundle, size_t* size)
+{
+  void* buffer = calloc(bundle->bufferSize, 1);
+  assert_non_null(buffer);
+  bitstream* bs = stream_open(buffer, bundle->bufferSize);
+  zfp_stream_set_bit_stream(bundle->stream, bs);
+
+  assert_int_equal(1, zfp_stream_set_execution(bundle->stream, zfp_exec_serial));
+  *size = zfp_compress(bundle->stream, bundle->field);
+  assert_int_not_equal(*size, 0);
+
+  zfp_stream_set_bit_stream(bundle->stream, bundle->bs);
+  stream_close(bs);
+
+  return buffer;
+}
+
+static void
+given_withHip_when_4dCompressHipPolicy_expect_matchesSerial(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  size_t serialSize;
+  void* serialBuffer = compressSerial(bundle, &serialSize);
+
+  assert_int_equal(1, zfp_stream_set_execution(bundle->stream, zfp_exec_hip));
+  zfp_stream_rewind(bundle->stream);
+  assert_int_equal(zfp_compress(bundle->stream, bundle->field), serialSize);
+  assert_memory_equal(bundle->buffer, serialBuffer, serialSize);
+
+  free(serialBuffer);
+}
+
 static void
-given_withHip_when_4dCompressHipPolicy_expect_noop(void **state)
+given_withHip_when_4dDecompressHipPolicy_expect_matchesSerial(void **state)
 {
   struct setupVars *bundle = *state;
+  size_t n = NX * NY * NZ * NW;
+  int* serialData = malloc(n * sizeof(int));
+  assert_non_null(serialData);
+
+  size_t serialSize;
+  void* serialBuffer = compressSerial(bundle, &serialSize);
+  memcpy(bundle->buffer, serialBuffer, serialSize);
+
+  /* decompress serially */
+  zfp_field_set_pointer(bundle->field, serialData);
+  zfp_stream_rewind(bundle->stream);
+  assert_int_equal(zfp_decompress(bundle->stream, bundle->field), serialSize);
+
+  /* decompress in parallel */
+  memset(bundle->data, 0, n * sizeof(int));
+  zfp_field_set_pointer(bundle->field, bundle->data);
+  assert_int_equal(1, zfp_stream_set_execution(bundle->stream, zfp_exec_hip));
+  zfp_stream_rewind(bundle->stream);
+  assert_int_equal(zfp_decompress(bundle->stream, bundle->field), serialSize);
 
-  assert_int_equal(zfp_compress(bundle->stream, bundle->field), 0);
-  assert_int_equal(stream_size(bundle->bs), bundle->streamSize);
+  assert_memory_equal(bundle->data, serialData, n * sizeof(int));
+
+  free(serialBuffer);
+  free(serialData);
 }
 
 static void
-given_withHip_when_4dDecompressHipPolicy_expect_noop(void **state)
+given_withHip_when_4dCompressAsyncThenSynchronize_expect_matchesSerial(void **state)
 {
   struct setupVars *bundle = *state;
 
-  assert_int_equal(zfp_decompress(bundle->stream, bundle->field), 0);
-  assert_int_equal(stream_size(bundle->bs), bundle->streamSize);
+  size_t serialSize;
+  void* serialBuffer = compressSerial(bundle, &serialSize);
+
+  /* queue work on the default stream and wait for it to complete */
+  assert_int_equal(1, zfp_stream_set_hip_stream(bundle->stream, NULL));
+  zfp_stream_rewind(bundle->stream);
+  assert_int_equal(zfp_compress_async(bundle->stream, bundle->field), serialSize);
+  assert_int_equal(1, zfp_stream_synchronize(bundle->stream));
+  assert_memory_equal(bundle->buffer, serialBuffer, serialSize);
+
+  free(serialBuffer);
 }
 
 int main()
 {
   const struct CMUnitTest tests[] = {
-    cmocka_unit_test_setup_teardown(given_withHip_when_4dCompressHipPolicy_expect_noop, setup, teardown),
-    cmocka_unit_test_setup_teardown(given_withHip_when_4dDecompressHipPolicy_expect_noop, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_withHip_when_4dCompressHipPolicy_expect_matchesSerial, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_withHip_when_4dDecompressHipPolicy_expect_matchesSerial, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_withHip_when_4dCompressAsyncThenSynchronize_expect_matchesSerial, setup, teardown),
   };
   return cmocka_run_group_tests(tests, NULL, NULL);
 }
@@ -126,6 +126,20 @@ given_withOpenMP_when_setOmpChunkSize_expect_set(void **state)
   assert_int_equal(zfp_stream_omp_chunk_size(stream), chunk_size);
 }
 
+static void
+given_withOpenMP_when_setOmpSchedule_expect_set(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_stream* stream = bundle->stream;
+
+  assert_int_equal(zfp_stream_set_omp_schedule(stream, zfp_omp_guided), 1);
+  assert_int_equal(zfp_stream_execution(stream), zfp_exec_omp);
+  assert_int_equal(zfp_stream_omp_schedule(stream), zfp_omp_guided);
+
+  assert_int_equal(zfp_stream_set_omp_schedule(stream, (zfp_omp_schedule)(zfp_omp_tasks + 1)), 0);
+  assert_int_equal(zfp_stream_omp_schedule(stream), zfp_omp_guided);
+}
+
 static void
 given_withOpenMP_serialExec_when_setOmpChunkSize_expect_setToExecOmp(void **state)
 {
@@ -139,12 +153,391 @@ given_withOpenMP_serialExec_when_setOmpChunkSize_expect_setToExecOmp(void **stat
 }
 
 static void
-given_withOpenMP_whenDecompressOmpPolicy_expect_noop(void **state)
+given_withOpenMP_whenCompressOmpPolicyWithIndex_expect_chunkOffsetsRecorded(void **state)
 {
   struct setupVars *bundle = *state;
+  zfp_stream* stream = bundle->stream;
+  zfp_index* index = zfp_index_alloc();
+  int32 data[9];
+  size_t i;
+  assert_non_null(index);
+
+  for (i = 0; i < 9; i++)
+    data[i] = (int32)(i * i) - 20;
+  zfp_field_set_pointer(bundle->field, data);
+
+  /* begin compressed field at an offset that is not word aligned */
+  zfp_stream_set_bit_stream(stream, bundle->bs);
+  zfp_stream_rewind(stream);
+  stream_wseek(bundle->bs, stream_word_bits + 1);
+  zfp_stream_set_precision(stream, 20);
+  assert_int_equal(zfp_stream_set_omp_chunk_size(stream, 1), 1);
+  zfp_stream_set_index(stream, index);
+
+  assert_int_not_equal(zfp_compress(stream, bundle->field), 0);
+
+  /* one chunk per block */
+  assert_int_equal(zfp_index_chunks(index), 3);
+  assert_true(zfp_index_offset(index, 0) == 0);
+  for (i = 0; i < 3; i++)
+    assert_true(zfp_index_offset(index, i) < zfp_index_offset(index, i + 1));
+  /* last offset marks end of compressed field, prior to word alignment */
+  assert_true(zfp_index_offset(index, 3) <= stream_wtell(bundle->bs) - (stream_word_bits + 1));
+  assert_true(zfp_index_offset(index, 3) + stream_word_bits > stream_wtell(bundle->bs) - (stream_word_bits + 1));
+
+  zfp_index_free(index);
+}
 
-  assert_int_equal(zfp_decompress(bundle->stream, bundle->field), 0);
-  assert_int_equal(stream_size(bundle->bs), bundle->streamSize);
+/* bitwise CRC-32C of n words taken least significant byte first */
+static uint32
+crc32c(const uint64* p, size_t n)
+{
+  uint32 c = 0xffffffffu;
+  size_t i;
+  uint k;
+  for (i = 0; i < 8 * n; i++) {
+    c ^= (uint32)(p[i / 8] >> (8 * (i % 8))) & 0xffu;
+    for (k = 0; k < 8; k++)
+      c = (c >> 1) ^ (0x82f63b78u & (0u - (c & 1u)));
+  }
+  return ~c;
+}
+
+static void
+given_withOpenMP_whenCompressOmpPolicyWithIndexHashing_expect_chunkHashesOfPaddedBits(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_stream* stream = bundle->stream;
+  zfp_index* index = zfp_index_alloc();
+  uint32 hash[3];
+  uint32 h;
+  int32 data[9];
+  size_t i;
+  assert_non_null(index);
+
+  for (i = 0; i < 9; i++)
+    data[i] = (int32)(i * i) - 20;
+  zfp_field_set_pointer(bundle->field, data);
+
+  zfp_stream_set_bit_stream(stream, bundle->bs);
+  zfp_stream_set_precision(stream, 20);
+  assert_int_equal(zfp_stream_set_omp_chunk_size(stream, 1), 1);
+  zfp_stream_set_index(stream, index);
+  zfp_index_set_hashing(index, zfp_true);
+
+  /* begin compressed field at an offset that is not word aligned */
+  zfp_stream_rewind(stream);
+  stream_wseek(bundle->bs, stream_word_bits + 1);
+  assert_int_not_equal(zfp_compress(stream, bundle->field), 0);
+  assert_int_equal(zfp_index_chunks(index), 3);
+  assert_false(zfp_index_hash(index, 3, &h));
+
+  /* each hash covers the chunk's bits padded with zeros to whole words */
+  for (i = 0; i < 3; i++) {
+    uint64 offset = zfp_index_offset(index, i);
+    uint64 bits = zfp_index_offset(index, i + 1) - offset;
+    uint64 words[2] = { 0, 0 };
+    bitstream* src = stream_open(bundle->buffer, stream_capacity(bundle->bs));
+    bitstream* dst = stream_open(words, sizeof(words));
+    assert_true(bits <= 2 * stream_word_bits);
+    stream_rseek(src, stream_word_bits + 1 + offset);
+    stream_copy(dst, src, bits);
+    stream_flush(dst);
+    assert_true(zfp_index_hash(index, i, hash + i));
+    assert_true(hash[i] == crc32c(words, (bits + 63) / 64));
+    stream_close(dst);
+    stream_close(src);
+  }
+
+  /* hashes do not depend on instruction set */
+  zfp_stream_set_isa(stream, zfp_isa_generic);
+  zfp_stream_rewind(stream);
+  stream_wseek(bundle->bs, stream_word_bits + 1);
+  assert_int_not_equal(zfp_compress(stream, bundle->field), 0);
+  for (i = 0; i < 3; i++) {
+    assert_true(zfp_index_hash(index, i, &h));
+    assert_true(h == hash[i]);
+  }
+
+  /* offsets set by other means carry no hashes */
+  {
+    uint64 offset[4];
+    for (i = 0; i <= 3; i++)
+      offset[i] = zfp_index_offset(index, i);
+    assert_true(zfp_index_set(index, 3, offset));
+    assert_false(zfp_index_hash(index, 0, &h));
+  }
+
+  zfp_index_free(index);
+}
+
+static void
+given_withOpenMP_whenCompressOmpPolicyDynamicSchedule_expect_matchesStaticAndThreadsTimed(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_stream* stream = bundle->stream;
+  uchar reference[50 * sizeof(int)];
+  double time[3];
+  int32 data[9];
+  size_t compressedSize;
+  size_t i;
+
+  for (i = 0; i < 9; i++)
+    data[i] = (int32)(i * i) - 20;
+  zfp_field_set_pointer(bundle->field, data);
+
+  /* compress in variable-rate mode with static schedule */
+  zfp_stream_set_bit_stream(stream, bundle->bs);
+  zfp_stream_set_precision(stream, 20);
+  assert_int_equal(zfp_stream_set_omp_threads(stream, 3), 1);
+  assert_int_equal(zfp_stream_set_omp_chunk_size(stream, 1), 1);
+  zfp_stream_rewind(stream);
+  compressedSize = zfp_compress(stream, bundle->field);
+  assert_int_not_equal(compressedSize, 0);
+  memcpy(reference, bundle->buffer, compressedSize);
+  memset(bundle->buffer, 0, compressedSize);
+
+  /* compress with dynamic schedule and per-thread timing */
+  for (i = 0; i < 3; i++)
+    time[i] = -1;
+  assert_int_equal(zfp_stream_set_omp_schedule(stream, zfp_omp_dynamic), 1);
+  assert_int_equal(zfp_stream_set_omp_thread_time(stream, time), 1);
+  assert_ptr_equal(zfp_stream_omp_thread_time(stream), time);
+  zfp_stream_rewind(stream);
+  assert_int_equal(zfp_compress(stream, bundle->field), compressedSize);
+  assert_memory_equal(bundle->buffer, reference, compressedSize);
+
+  /* every thread's time is reset, whether or not it compressed a chunk */
+  for (i = 0; i < 3; i++)
+    assert_true(time[i] >= 0);
+}
+
+static void
+given_withOpenMP_whenCompressOmpPolicyPersistent_expect_buffersReused(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_stream* stream = bundle->stream;
+  uchar reference[50 * sizeof(int)];
+  int32 data[9];
+  size_t compressedSize;
+  void* scratch;
+  size_t i;
+
+  for (i = 0; i < 9; i++)
+    data[i] = (int32)(i * i) - 20;
+  zfp_field_set_pointer(bundle->field, data);
+
+  /* by default, per-chunk buffers are released after compression */
+  zfp_stream_set_bit_stream(stream, bundle->bs);
+  zfp_stream_set_precision(stream, 32);
+  assert_int_equal(zfp_stream_set_omp_chunk_size(stream, 1), 1);
+  zfp_stream_rewind(stream);
+  assert_int_not_equal(zfp_compress(stream, bundle->field), 0);
+  assert_null(stream->scratch);
+
+  /* compress in variable-rate mode, retaining per-chunk buffers */
+  assert_int_equal(zfp_stream_set_omp_persistent(stream, zfp_true), 1);
+  assert_int_equal(zfp_stream_omp_persistent(stream), zfp_true);
+  zfp_stream_rewind(stream);
+  compressedSize = zfp_compress(stream, bundle->field);
+  assert_int_not_equal(compressedSize, 0);
+  memcpy(reference, bundle->buffer, compressedSize);
+  memset(bundle->buffer, 0, compressedSize);
+  scratch = stream->scratch;
+  assert_non_null(scratch);
+
+  /* compress again using the same buffers */
+  zfp_stream_rewind(stream);
+  assert_int_equal(zfp_compress(stream, bundle->field), compressedSize);
+  assert_memory_equal(bundle->buffer, reference, compressedSize);
+  assert_ptr_equal(stream->scratch, scratch);
+
+  /* turning persistence off releases buffers */
+  assert_int_equal(zfp_stream_set_omp_persistent(stream, zfp_false), 1);
+  assert_null(stream->scratch);
+}
+
+static void
+given_withOpenMP_whenDecompressOmpPolicy_expect_matchesSerial(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_stream* stream = bundle->stream;
+  zfp_index* index = zfp_index_alloc();
+  int32 data[9];
+  int32 serial[9];
+  int32 parallel[9];
+  size_t compressedSize;
+  size_t i;
+  assert_non_null(index);
+
+  for (i = 0; i < 9; i++)
+    data[i] = (int32)(i * i) - 20;
+  zfp_field_set_pointer(bundle->field, data);
+
+  /* compress in variable-rate mode with chunk index at unaligned offset */
+  zfp_stream_set_bit_stream(stream, bundle->bs);
+  zfp_stream_rewind(stream);
+  stream_wseek(bundle->bs, stream_word_bits + 1);
+  zfp_stream_set_precision(stream, 20);
+  assert_int_equal(zfp_stream_set_omp_chunk_size(stream, 1), 1);
+  zfp_stream_set_index(stream, index);
+  compressedSize = zfp_compress(stream, bundle->field);
+  assert_int_not_equal(compressedSize, 0);
+
+  /* decompress in serial */
+  assert_int_equal(zfp_stream_set_execution(stream, zfp_exec_serial), 1);
+  zfp_stream_rewind(stream);
+  stream_rseek(bundle->bs, stream_word_bits + 1);
+  zfp_field_set_pointer(bundle->field, serial);
+  assert_int_equal(zfp_decompress(stream, bundle->field), compressedSize);
+
+  /* decompress in parallel using chunk index */
+  assert_int_equal(zfp_stream_set_omp_threads(stream, 3), 1);
+  zfp_stream_rewind(stream);
+  stream_rseek(bundle->bs, stream_word_bits + 1);
+  zfp_field_set_pointer(bundle->field, parallel);
+  assert_int_equal(zfp_decompress(stream, bundle->field), compressedSize);
+
+  assert_memory_equal(serial, parallel, sizeof(serial));
+
+  zfp_index_free(index);
+}
+
+static void
+given_withOpenMP_whenCompressOmpPolicyAdaptive_expect_threadCountSizedToField(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_stream* stream = bundle->stream;
+  zfp_stream_stats stats;
+  uchar reference[50 * sizeof(int)];
+  int32 data[9];
+  size_t compressedSize;
+  size_t i;
+
+  for (i = 0; i < 9; i++)
+    data[i] = (int32)(i * i) - 20;
+  zfp_field_set_pointer(bundle->field, data);
+  memset(&stats, 0, sizeof(stats));
+  zfp_stream_set_stats(stream, &stats);
+
+  /* compress with all requested threads */
+  zfp_stream_set_bit_stream(stream, bundle->bs);
+  zfp_stream_set_precision(stream, 32);
+  assert_int_equal(zfp_stream_set_omp_threads(stream, 4), 1);
+  zfp_stream_rewind(stream);
+  compressedSize = zfp_compress(stream, bundle->field);
+  assert_int_not_equal(compressedSize, 0);
+  assert_int_equal(stats.exec, zfp_exec_omp);
+  assert_int_equal(stats.exec_threads, 4);
+  memcpy(reference, bundle->buffer, compressedSize);
+
+  /* a field of three blocks is compressed serially into the same stream */
+  assert_int_equal(zfp_stream_set_omp_adaptive(stream, zfp_true), 1);
+  assert_int_equal(zfp_stream_omp_adaptive(stream), zfp_true);
+  zfp_stream_rewind(stream);
+  assert_int_equal(zfp_compress(stream, bundle->field), compressedSize);
+  assert_memory_equal(bundle->buffer, reference, compressedSize);
+  assert_int_equal(stats.exec, zfp_exec_serial);
+  assert_int_equal(stats.exec_threads, 1);
+
+  /* settings are left as requested */
+  assert_int_equal(zfp_stream_execution(stream), zfp_exec_omp);
+  assert_int_equal(zfp_stream_omp_threads(stream), 4);
+
+  zfp_stream_set_stats(stream, NULL);
+}
+
+static void
+given_withOpenMP_whenCompressLargeFieldOmpPolicyAdaptive_expect_fewerThreads(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_stream* stream = bundle->stream;
+  zfp_stream_stats stats;
+  size_t n = 4 * 4000;
+  int32* data = calloc(n, sizeof(int32));
+  size_t bufferSize = n * sizeof(int32);
+  void* buffer = malloc(bufferSize);
+  bitstream* bs = stream_open(buffer, bufferSize);
+  zfp_field* field = zfp_field_1d(data, zfp_type_int32, n);
+  assert_non_null(data);
+  assert_non_null(buffer);
+
+  /* 4000 blocks keep three of four threads busy at 32 bits/value */
+  memset(&stats, 0, sizeof(stats));
+  zfp_stream_set_stats(stream, &stats);
+  zfp_stream_set_bit_stream(stream, bs);
+  zfp_stream_set_rate(stream, 32, zfp_type_int32, 1, zfp_false);
+  assert_int_equal(zfp_stream_set_omp_threads(stream, 4), 1);
+  assert_int_equal(zfp_stream_set_omp_adaptive(stream, zfp_true), 1);
+  assert_int_equal(zfp_compress(stream, field), bufferSize);
+  assert_int_equal(stats.exec, zfp_exec_omp);
+  assert_int_equal(stats.exec_threads, 3);
+
+  zfp_stream_rewind(stream);
+  assert_int_equal(zfp_decompress(stream, field), bufferSize);
+  assert_int_equal(stats.exec_threads, 3);
+
+  zfp_stream_set_stats(stream, NULL);
+  zfp_field_free(field);
+  stream_close(bs);
+  free(buffer);
+  free(data);
+}
+
+static void
+given_withOpenMP_whenCompressInParallelRegionWithTasks_expect_matchesSerial(void **state)
+{
+  struct setupVars *bundle = *state;
+  size_t n = 4 * 256;
+  size_t bufferSize = n * sizeof(int32);
+  int32* data = malloc(n * sizeof(int32));
+  uchar* reference = malloc(bufferSize);
+  uchar* buffer = malloc(4 * bufferSize);
+  size_t sizes[4];
+  zfp_field* field = zfp_field_1d(data, zfp_type_int32, n);
+  size_t compressedSize;
+  size_t i;
+  int k;
+  assert_non_null(data);
+  assert_non_null(reference);
+  assert_non_null(buffer);
+
+  for (i = 0; i < n; i++)
+    data[i] = (int32)(i * i % 1000) - 500;
+
+  /* compress in variable-rate mode in serial */
+  bitstream* bs = stream_open(reference, bufferSize);
+  zfp_stream_set_bit_stream(bundle->stream, bs);
+  zfp_stream_set_precision(bundle->stream, 20);
+  assert_int_equal(zfp_stream_set_execution(bundle->stream, zfp_exec_serial), 1);
+  compressedSize = zfp_compress(bundle->stream, field);
+  assert_int_not_equal(compressedSize, 0);
+  stream_close(bs);
+
+  /* each thread of the team compresses a copy of the field with chunks
+     that are run as tasks by the whole team */
+  #pragma omp parallel for num_threads(4)
+  for (k = 0; k < 4; k++) {
+    zfp_stream* stream = zfp_stream_open(NULL);
+    bitstream* s = stream_open(buffer + k * bufferSize, bufferSize);
+    zfp_stream_set_bit_stream(stream, s);
+    zfp_stream_set_precision(stream, 20);
+    zfp_stream_set_omp_chunk_size(stream, 8);
+    zfp_stream_set_omp_schedule(stream, zfp_omp_tasks);
+    sizes[k] = zfp_compress(stream, field);
+    stream_close(s);
+    zfp_stream_close(stream);
+  }
+
+  for (k = 0; k < 4; k++) {
+    assert_int_equal(sizes[k], compressedSize);
+    assert_memory_equal(buffer + k * bufferSize, reference, compressedSize);
+  }
+
+  zfp_field_free(field);
+  free(buffer);
+  free(reference);
+  free(data);
 }
 
 #else
@@ -199,8 +592,16 @@ int main()
     cmocka_unit_test_setup_teardown(given_withOpenMP_serialExec_when_setOmpThreads_expect_setToExecOmp, setup, teardown),
     cmocka_unit_test_setup_teardown(given_withOpenMP_when_setOmpChunkSize_expect_set, setup, teardown),
     cmocka_unit_test_setup_teardown(given_withOpenMP_serialExec_when_setOmpChunkSize_expect_setToExecOmp, setup, teardown),
-
-    cmocka_unit_test_setup_teardown(given_withOpenMP_whenDecompressOmpPolicy_expect_noop, setupForCompress, teardownForCompress),
+    cmocka_unit_test_setup_teardown(given_withOpenMP_when_setOmpSchedule_expect_set, setup, teardown),
+
+    cmocka_unit_test_setup_teardown(given_withOpenMP_whenCompressOmpPolicyWithIndex_expect_chunkOffsetsRecorded, setupForCompress, teardownForCompress),
+    cmocka_unit_test_setup_teardown(given_withOpenMP_whenCompressOmpPolicyWithIndexHashing_expect_chunkHashesOfPaddedBits, setupForCompress, teardownForCompress),
+    cmocka_unit_test_setup_teardown(given_withOpenMP_whenCompressOmpPolicyDynamicSchedule_expect_matchesStaticAndThreadsTimed, setupForCompress, teardownForCompress),
+    cmocka_unit_test_setup_teardown(given_withOpenMP_whenCompressOmpPolicyPersistent_expect_buffersReused, setupForCompress, teardownForCompress),
+    cmocka_unit_test_setup_teardown(given_withOpenMP_whenDecompressOmpPolicy_expect_matchesSerial, setupForCompress, teardownForCompress),
+    cmocka_unit_test_setup_teardown(given_withOpenMP_whenCompressOmpPolicyAdaptive_expect_threadCountSizedToField, setupForCompress, teardownForCompress),
+    cmocka_unit_test_setup_teardown(given_withOpenMP_whenCompressLargeFieldOmpPolicyAdaptive_expect_fewerThreads, setupForCompress, teardownForCompress),
+    cmocka_unit_test_setup_teardown(given_withOpenMP_whenCompressInParallelRegionWithTasks_expect_matchesSerial, setup, teardown),
 #else
     cmocka_unit_test_setup_teardown(given_withoutOpenMP_when_setExecutionOmp_expect_unableTo, setup, teardown),
     cmocka_unit_test_setup_teardown(given_withoutOpenMP_when_setOmpParams_expect_unableTo, setup, teardown),
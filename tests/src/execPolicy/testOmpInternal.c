@@ -73,12 +73,31 @@ given_withOpenMP_zfpStreamOmpChunkSizeNonzero_when_chunkCountOmp_expect_returnsN
   assert_int_equal(chunk_count_omp(stream, blocks, thread_count_omp(stream)), (blocks + chunkSize - 1) / chunkSize);
 }
 
+static void
+given_withOpenMP_zfpStreamOmpScheduleDynamic_when_chunkCountOmp_expect_returnsMultipleChunksPerThread(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_stream* stream = bundle->stream;
+  uint threads = 3;
+  assert_int_equal(zfp_stream_set_omp_threads(stream, threads), 1);
+  assert_int_equal(zfp_stream_set_omp_schedule(stream, zfp_omp_dynamic), 1);
+
+  /* large arrays are over-decomposed */
+  size_t blocks = 1000000;
+  assert_int_equal(chunk_count_omp(stream, blocks, threads), threads * OMP_CHUNKS_PER_THREAD);
+
+  /* small arrays are not split into chunks smaller than needed */
+  blocks = 50;
+  assert_int_equal(chunk_count_omp(stream, blocks, threads), threads);
+}
+
 int main()
 {
   const struct CMUnitTest tests[] = {
     cmocka_unit_test_setup_teardown(given_withOpenMP_zfpStreamOmpThreadsZero_when_threadCountOmp_expect_returnsOmpMaxThreadCount, setup, teardown),
     cmocka_unit_test_setup_teardown(given_withOpenMP_zfpStreamOmpChunkSizeZero_when_chunkCountOmp_expect_returnsOneChunkPerThread, setup, teardown),
     cmocka_unit_test_setup_teardown(given_withOpenMP_zfpStreamOmpChunkSizeNonzero_when_chunkCountOmp_expect_returnsNumChunks, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_withOpenMP_zfpStreamOmpScheduleDynamic_when_chunkCountOmp_expect_returnsMultipleChunksPerThread, setup, teardown),
   };
   return cmocka_run_group_tests(tests, NULL, NULL);
 }
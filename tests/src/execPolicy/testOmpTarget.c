@@ -0,0 +1,214 @@
+#include "zfp.h"
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <omp.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NX 9
+#define NY 5
+#define NZ 7
+#define RATE 13
+
+struct setupVars {
+  zfp_stream* stream;
+  zfp_field* field;
+  bitstream* bs;
+  double* data;
+  void* buffer;
+  size_t bufferSize;
+};
+
+static int
+setup(void **state)
+{
+  struct setupVars *bundle = malloc(sizeof(struct setupVars));
+  assert_non_null(bundle);
+
+  bundle->stream = zfp_stream_open(NULL);
+  assert_non_null(bundle);
+
+  /* create 3d field with smoothly varying values and partial blocks */
+  size_t n = NX * NY * NZ;
+  size_t i;
+  bundle->data = malloc(n * sizeof(double));
+  assert_non_null(bundle->data);
+  for (i = 0; i < n; i++)
+    bundle->data[i] = (double)(i * i) - 64.5 * i;
+
+  bundle->field = zfp_field_3d(bundle->data, zfp_type_double, NX, NY, NZ);
+  assert_non_null(bundle->field);
+
+  /* odd rate so that blocks straddle word boundaries */
+  zfp_stream_set_rate(bundle->stream, RATE, zfp_type_double, 3, 0);
+
+  /* create a bitstream with buffer */
+  bundle->bufferSize = zfp_stream_maximum_size(bundle->stream, bundle->field);
+  bundle->buffer = calloc(bundle->bufferSize, 1);
+  assert_non_null(bundle->buffer);
+
+  bundle->bs = stream_open(bundle->buffer, bundle->bufferSize);
+  zfp_stream_set_bit_stream(bundle->stream, bundle->bs);
+
+  *state = bundle;
+
+  return 0;
+}
+
+static int
+teardown(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  zfp_field_free(bundle->field);
+  free(bundle->data);
+
+  stream_close(bundle->bs);
+  free(bundle->buffer);
+  zfp_stream_close(bundle->stream);
+
+  free(bundle);
+
+  return 0;
+}
+
+/* compress field serially into a separate buffer */
+static void*
+compressSerial(struct setupVars *bundle, size_t* size)
+{
+  void* buffer = calloc(bundle->bufferSize, 1);
+  assert_non_null(buffer);
+  bitstream* bs = stream_open(buffer, bundle->bufferSize);
+  zfp_stream_set_bit_stream(bundle->stream, bs);
+
+  assert_int_equal(1, zfp_stream_set_execution(bundle->stream, zfp_exec_serial));
+  *size = zfp_compress(bundle->stream, bundle->field);
+  assert_int_not_equal(*size, 0);
+
+  zfp_stream_set_bit_stream(bundle->stream, bundle->bs);
+  stream_close(bs);
+
+  return buffer;
+}
+
+static void
+given_withOmpTarget_when_3dCompressOmpTargetPolicy_expect_matchesSerial(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  size_t serialSize;
+  void* serialBuffer = compressSerial(bundle, &serialSize);
+
+  assert_int_equal(1, zfp_stream_set_execution(bundle->stream, zfp_exec_omp_target));
+  zfp_stream_rewind(bundle->stream);
+  assert_int_equal(zfp_compress(bundle->stream, bundle->field), serialSize);
+  assert_memory_equal(bundle->buffer, serialBuffer, serialSize);
+
+  free(serialBuffer);
+}
+
+static void
+given_withOmpTarget_when_3dDecompressOmpTargetPolicy_expect_matchesSerial(void **state)
+{
+  struct setupVars *bundle = *state;
+  size_t n = NX * NY * NZ;
+  double* serialData = malloc(n * sizeof(double));
+  assert_non_null(serialData);
+
+  size_t serialSize;
+  void* serialBuffer = compressSerial(bundle, &serialSize);
+  memcpy(bundle->buffer, serialBuffer, serialSize);
+
+  /* decompress serially */
+  zfp_field_set_pointer(bundle->field, serialData);
+  zfp_stream_rewind(bundle->stream);
+  assert_int_equal(zfp_decompress(bundle->stream, bundle->field), serialSize);
+
+  /* decompress on device */
+  memset(bundle->data, 0, n * sizeof(double));
+  zfp_field_set_pointer(bundle->field, bundle->data);
+  assert_int_equal(1, zfp_stream_set_execution(bundle->stream, zfp_exec_omp_target));
+  zfp_stream_rewind(bundle->stream);
+  assert_int_equal(zfp_decompress(bundle->stream, bundle->field), serialSize);
+
+  assert_memory_equal(bundle->data, serialData, n * sizeof(double));
+
+  free(serialBuffer);
+  free(serialData);
+}
+
+static void
+given_withOmpTarget_when_3dCompressDeviceField_expect_matchesSerial(void **state)
+{
+  struct setupVars *bundle = *state;
+  size_t bytes = NX * NY * NZ * sizeof(double);
+  int device = omp_get_default_device();
+  int host = omp_get_initial_device();
+
+  size_t serialSize;
+  void* serialBuffer = compressSerial(bundle, &serialSize);
+
+  /* field resides in device memory */
+  void* deviceData = omp_target_alloc(bytes, device);
+  assert_non_null(deviceData);
+  assert_int_equal(0, omp_target_memcpy(deviceData, bundle->data, bytes, 0, 0, device, host));
+  zfp_field_set_pointer(bundle->field, deviceData);
+
+  assert_int_equal(1, zfp_stream_set_omp_target_device(bundle->stream, device));
+  assert_int_equal(1, zfp_stream_set_omp_target_device_data(bundle->stream, zfp_true, zfp_false));
+  zfp_stream_rewind(bundle->stream);
+  assert_int_equal(zfp_compress(bundle->stream, bundle->field), serialSize);
+  assert_memory_equal(bundle->buffer, serialBuffer, serialSize);
+
+  zfp_field_set_pointer(bundle->field, bundle->data);
+  omp_target_free(deviceData, device);
+  free(serialBuffer);
+}
+
+static void
+given_withOmpTarget_when_setOmpTargetDevice_expect_paramsStoredUntilPolicyChanges(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  assert_int_equal(zfp_stream_set_omp_target_device(bundle->stream, 2), 1);
+  assert_int_equal(zfp_stream_execution(bundle->stream), zfp_exec_omp_target);
+  assert_int_equal(zfp_stream_set_omp_target_device_data(bundle->stream, zfp_true, zfp_true), 1);
+  assert_int_equal(zfp_stream_omp_target_device(bundle->stream), 2);
+  assert_int_equal(zfp_stream_omp_target_device_field(bundle->stream), 1);
+  assert_int_equal(zfp_stream_omp_target_device_stream(bundle->stream), 1);
+
+  /* changing execution policy restores the defaults */
+  assert_int_equal(zfp_stream_set_execution(bundle->stream, zfp_exec_serial), 1);
+  assert_int_equal(zfp_stream_set_execution(bundle->stream, zfp_exec_omp_target), 1);
+  assert_true(zfp_stream_omp_target_device(bundle->stream) < 0);
+  assert_int_equal(zfp_stream_omp_target_device_field(bundle->stream), 0);
+  assert_int_equal(zfp_stream_omp_target_device_stream(bundle->stream), 0);
+}
+
+static void
+given_withOmpTarget_when_4dCompress_expect_notSupported(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_field* field = zfp_field_4d(bundle->data, zfp_type_double, 3, 3, 3, 5);
+
+  assert_int_equal(1, zfp_stream_set_execution(bundle->stream, zfp_exec_omp_target));
+  assert_int_equal(zfp_compress(bundle->stream, field), 0);
+
+  zfp_field_free(field);
+}
+
+int main()
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test_setup_teardown(given_withOmpTarget_when_3dCompressOmpTargetPolicy_expect_matchesSerial, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_withOmpTarget_when_3dDecompressOmpTargetPolicy_expect_matchesSerial, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_withOmpTarget_when_3dCompressDeviceField_expect_matchesSerial, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_withOmpTarget_when_setOmpTargetDevice_expect_paramsStoredUntilPolicyChanges, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_withOmpTarget_when_4dCompress_expect_notSupported, setup, teardown),
+  };
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
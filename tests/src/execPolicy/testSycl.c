@@ -0,0 +1,191 @@
+#include "zfp.h"
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#define NX 9
+#define NY 5
+#define NZ 7
+#define RATE 13
+
+struct setupVars {
+  zfp_stream* stream;
+  zfp_field* field;
+  bitstream* bs;
+  double* data;
+  void* buffer;
+  size_t bufferSize;
+};
+
+static int
+setup(void **state)
+{
+  struct setupVars *bundle = malloc(sizeof(struct setupVars));
+  assert_non_null(bundle);
+
+  bundle->stream = zfp_stream_open(NULL);
+  assert_non_null(bundle);
+
+  /* create 3d field with smoothly varying values and partial blocks */
+  size_t n = NX * NY * NZ;
+  size_t i;
+  bundle->data = malloc(n * sizeof(double));
+  assert_non_null(bundle->data);
+  for (i = 0; i < n; i++)
+    bundle->data[i] = (double)(i * i) - 64.5 * i;
+
+  bundle->field = zfp_field_3d(bundle->data, zfp_type_double, NX, NY, NZ);
+  assert_non_null(bundle->field);
+
+  /* odd rate so that blocks straddle word boundaries */
+  zfp_stream_set_rate(bundle->stream, RATE, zfp_type_double, 3, 0);
+
+  /* create a bitstream with buffer */
+  bundle->bufferSize = zfp_stream_maximum_size(bundle->stream, bundle->field);
+  bundle->buffer = calloc(bundle->bufferSize, 1);
+  assert_non_null(bundle->buffer);
+
+  bundle->bs = stream_open(bundle->buffer, bundle->bufferSize);
+  zfp_stream_set_bit_stream(bundle->stream, bundle->bs);
+
+  *state = bundle;
+
+  return 0;
+}
+
+static int
+teardown(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  zfp_field_free(bundle->field);
+  free(bundle->data);
+
+  stream_close(bundle->bs);
+  free(bundle->buffer);
+  zfp_stream_close(bundle->stream);
+
+  free(bundle);
+
+  return 0;
+}
+
+/* compress field serially into a separate buffer */
+static void*
+compressSerial(struct setupVars *bundle, size_t* size)
+{
+  void* buffer = calloc(bundle->bufferSize, 1);
+  assert_non_null(buffer);
+  bitstream* bs = stream_open(buffer, bundle->bufferSize);
+  zfp_stream_set_bit_stream(bundle->stream, bs);
+
+  assert_int_equal(1, zfp_stream_set_execution(bundle->stream, zfp_exec_serial));
+  *size = zfp_compress(bundle->stream, bundle->field);
+  assert_int_not_equal(*size, 0);
+
+  zfp_stream_set_bit_stream(bundle->stream, bundle->bs);
+  stream_close(bs);
+
+  return buffer;
+}
+
+static void
+given_withSycl_when_3dCompressSyclPolicy_expect_matchesSerial(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  size_t serialSize;
+  void* serialBuffer = compressSerial(bundle, &serialSize);
+
+  assert_int_equal(1, zfp_stream_set_execution(bundle->stream, zfp_exec_sycl));
+  zfp_stream_rewind(bundle->stream);
+  assert_int_equal(zfp_compress(bundle->stream, bundle->field), serialSize);
+  assert_memory_equal(bundle->buffer, serialBuffer, serialSize);
+
+  free(serialBuffer);
+}
+
+static void
+given_withSycl_when_3dDecompressSyclPolicy_expect_matchesSerial(void **state)
+{
+  struct setupVars *bundle = *state;
+  size_t n = NX * NY * NZ;
+  double* serialData = malloc(n * sizeof(double));
+  assert_non_null(serialData);
+
+  size_t serialSize;
+  void* serialBuffer = compressSerial(bundle, &serialSize);
+  memcpy(bundle->buffer, serialBuffer, serialSize);
+
+  /* decompress serially */
+  zfp_field_set_pointer(bundle->field, serialData);
+  zfp_stream_rewind(bundle->stream);
+  assert_int_equal(zfp_decompress(bundle->stream, bundle->field), serialSize);
+
+  /* decompress on device */
+  memset(bundle->data, 0, n * sizeof(double));
+  zfp_field_set_pointer(bundle->field, bundle->data);
+  assert_int_equal(1, zfp_stream_set_execution(bundle->stream, zfp_exec_sycl));
+  zfp_stream_rewind(bundle->stream);
+  assert_int_equal(zfp_decompress(bundle->stream, bundle->field), serialSize);
+
+  assert_memory_equal(bundle->data, serialData, n * sizeof(double));
+
+  free(serialBuffer);
+  free(serialData);
+}
+
+static void
+given_withSycl_when_4dCompressSyclPolicy_expect_matchesSerial(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_field* field = zfp_field_4d(bundle->data, zfp_type_double, 3, 3, 3, 5);
+  zfp_field* field3 = bundle->field;
+
+  bundle->field = field;
+  zfp_stream_set_rate(bundle->stream, RATE, zfp_type_double, 4, 0);
+  size_t serialSize;
+  void* serialBuffer = compressSerial(bundle, &serialSize);
+
+  assert_int_equal(1, zfp_stream_set_execution(bundle->stream, zfp_exec_sycl));
+  zfp_stream_rewind(bundle->stream);
+  assert_int_equal(zfp_compress(bundle->stream, field), serialSize);
+  assert_memory_equal(bundle->buffer, serialBuffer, serialSize);
+
+  bundle->field = field3;
+  zfp_field_free(field);
+  free(serialBuffer);
+}
+
+static void
+given_withSycl_when_setSyclQueue_expect_queueStoredUntilPolicyChanges(void **state)
+{
+  struct setupVars *bundle = *state;
+  int queue;
+
+  assert_int_equal(zfp_stream_set_sycl_queue(bundle->stream, &queue), 1);
+  assert_int_equal(zfp_stream_execution(bundle->stream), zfp_exec_sycl);
+  assert_ptr_equal(zfp_stream_sycl_queue(bundle->stream), &queue);
+
+  /* changing execution policy restores the default queue */
+  assert_int_equal(zfp_stream_set_execution(bundle->stream, zfp_exec_serial), 1);
+  assert_null(zfp_stream_sycl_queue(bundle->stream));
+  assert_int_equal(zfp_stream_set_execution(bundle->stream, zfp_exec_sycl), 1);
+  assert_null(zfp_stream_sycl_queue(bundle->stream));
+}
+
+int main()
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test_setup_teardown(given_withSycl_when_3dCompressSyclPolicy_expect_matchesSerial, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_withSycl_when_3dDecompressSyclPolicy_expect_matchesSerial, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_withSycl_when_4dCompressSyclPolicy_expect_matchesSerial, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_withSycl_when_setSyclQueue_expect_queueStoredUntilPolicyChanges, setup, teardown),
+  };
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,349 @@
+#include "zfp.h"
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#define NX 1001
+
+struct setupVars {
+  zfp_stream* stream;
+  zfp_field* field;
+  bitstream* bs;
+  void* buffer;
+  size_t bufferSize;
+  size_t streamSize;
+  int32* data;
+};
+
+static int
+setup(void **state)
+{
+  struct setupVars *bundle = malloc(sizeof(struct setupVars));
+  assert_non_null(bundle);
+
+  bundle->stream = zfp_stream_open(NULL);
+  *state = bundle;
+
+  return 0;
+}
+
+static int
+teardown(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  zfp_stream_close(bundle->stream);
+  free(bundle);
+
+  return 0;
+}
+
+static int
+setupForCompress(void **state)
+{
+  if (setup(state))
+    return 1;
+
+  struct setupVars *bundle = *state;
+  size_t i;
+
+  bundle->data = malloc(NX * sizeof(int32));
+  assert_non_null(bundle->data);
+  for (i = 0; i < NX; i++)
+    bundle->data[i] = (int32)((i * i) % 1009) - 500;
+
+  bundle->field = zfp_field_1d(bundle->data, zfp_type_int32, NX);
+  assert_non_null(bundle->field);
+
+  /* create a bitstream with buffer */
+  zfp_stream_set_reversible(bundle->stream);
+  bundle->bufferSize = zfp_stream_maximum_size(bundle->stream, bundle->field) + sizeof(uint64);
+  bundle->buffer = calloc(bundle->bufferSize, 1);
+  assert_non_null(bundle->buffer);
+
+  /* offset bitstream, so we can distinguish 0 from stream_size() returned from zfp_decompress() */
+  bundle->bs = stream_open(bundle->buffer, bundle->bufferSize);
+  stream_skip(bundle->bs, stream_word_bits + 1);
+
+  bundle->streamSize = stream_size(bundle->bs);
+  assert_int_not_equal(bundle->streamSize, 0);
+
+  /* manually set thread-pool policy (needed for tests compiled without thread pool) */
+  bundle->stream->exec.policy = zfp_exec_threads;
+
+  return 0;
+}
+
+static int
+teardownForCompress(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  zfp_field_free(bundle->field);
+  stream_close(bundle->bs);
+  free(bundle->buffer);
+  free(bundle->data);
+
+  return teardown(state);
+}
+
+#ifdef ZFP_WITH_THREADS
+/* compress field at unaligned offset; return compressed size */
+static size_t
+compressAt(struct setupVars *bundle, void* buffer)
+{
+  zfp_stream* stream = bundle->stream;
+  bitstream* bs = stream_open(buffer, bundle->bufferSize);
+  size_t size;
+
+  memset(buffer, 0, bundle->bufferSize);
+  stream_skip(bs, stream_word_bits + 1);
+  zfp_stream_set_bit_stream(stream, bs);
+  size = zfp_compress(stream, bundle->field);
+  zfp_stream_set_bit_stream(stream, bundle->bs);
+  stream_close(bs);
+
+  return size;
+}
+
+static void
+given_withThreads_when_setExecutionThreads_expect_set(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_stream* stream = bundle->stream;
+
+  assert_int_equal(zfp_stream_set_execution(stream, zfp_exec_threads), 1);
+  assert_int_equal(zfp_stream_execution(stream), zfp_exec_threads);
+  assert_int_equal(zfp_stream_thread_count(stream), 0);
+  assert_int_equal(zfp_stream_thread_chunk_size(stream), 0);
+}
+
+static void
+given_withThreads_serialExec_when_setThreadCount_expect_setToExecThreads(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_stream* stream = bundle->stream;
+  assert_int_equal(zfp_stream_execution(stream), zfp_exec_serial);
+
+  assert_int_equal(zfp_stream_set_thread_count(stream, 5), 1);
+
+  assert_int_equal(zfp_stream_execution(stream), zfp_exec_threads);
+  assert_int_equal(zfp_stream_thread_count(stream), 5);
+}
+
+static void
+given_withThreads_when_setThreadChunkSize_expect_set(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_stream* stream = bundle->stream;
+  uint chunk_size = 0x2u;
+
+  assert_int_equal(zfp_stream_set_thread_chunk_size(stream, chunk_size), 1);
+  assert_int_equal(zfp_stream_execution(stream), zfp_exec_threads);
+  assert_int_equal(zfp_stream_thread_chunk_size(stream), chunk_size);
+}
+
+static void
+given_withThreads_whenCompressThreadsPolicy_expect_matchesSerial(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_stream* stream = bundle->stream;
+  void* reference = malloc(bundle->bufferSize);
+  size_t size;
+  uint threads;
+  assert_non_null(reference);
+
+  /* compress in serial */
+  assert_int_equal(zfp_stream_set_execution(stream, zfp_exec_serial), 1);
+  size = compressAt(bundle, reference);
+  assert_int_not_equal(size, 0);
+
+  /* compress repeatedly using pool with chunks of varying size */
+  for (threads = 1; threads <= 4; threads++) {
+    assert_int_equal(zfp_stream_set_thread_count(stream, threads), 1);
+    assert_int_equal(zfp_stream_set_thread_chunk_size(stream, 5 * threads), 1);
+    assert_int_equal(compressAt(bundle, bundle->buffer), size);
+    assert_memory_equal(bundle->buffer, reference, size);
+    assert_int_equal(compressAt(bundle, bundle->buffer), size);
+    assert_memory_equal(bundle->buffer, reference, size);
+  }
+
+  free(reference);
+}
+
+static void
+given_withThreads_whenDecompressThreadsPolicy_expect_matchesSerial(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_stream* stream = bundle->stream;
+  zfp_index* index = zfp_index_alloc();
+  int32* serial = malloc(NX * sizeof(int32));
+  int32* parallel = malloc(NX * sizeof(int32));
+  size_t compressedSize;
+  assert_non_null(index);
+  assert_non_null(serial);
+  assert_non_null(parallel);
+
+  /* compress losslessly with chunk index at unaligned offset */
+  zfp_stream_set_bit_stream(stream, bundle->bs);
+  zfp_stream_rewind(stream);
+  stream_wseek(bundle->bs, stream_word_bits + 1);
+  assert_int_equal(zfp_stream_set_thread_count(stream, 3), 1);
+  assert_int_equal(zfp_stream_set_thread_chunk_size(stream, 7), 1);
+  zfp_stream_set_index(stream, index);
+  compressedSize = zfp_compress(stream, bundle->field);
+  assert_int_not_equal(compressedSize, 0);
+
+  /* decompress in serial */
+  assert_int_equal(zfp_stream_set_execution(stream, zfp_exec_serial), 1);
+  zfp_stream_rewind(stream);
+  stream_rseek(bundle->bs, stream_word_bits + 1);
+  zfp_field_set_pointer(bundle->field, serial);
+  assert_int_equal(zfp_decompress(stream, bundle->field), compressedSize);
+
+  /* decompress in parallel using chunk index */
+  assert_int_equal(zfp_stream_set_thread_count(stream, 3), 1);
+  zfp_stream_rewind(stream);
+  stream_rseek(bundle->bs, stream_word_bits + 1);
+  zfp_field_set_pointer(bundle->field, parallel);
+  assert_int_equal(zfp_decompress(stream, bundle->field), compressedSize);
+
+  assert_memory_equal(serial, parallel, NX * sizeof(int32));
+  assert_memory_equal(serial, bundle->data, NX * sizeof(int32));
+
+  zfp_index_free(index);
+  free(parallel);
+  free(serial);
+}
+
+static void
+given_withThreads_whenCompressDecompressAsync_expect_matchesSynchronous(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_stream* stream = bundle->stream;
+  void* reference = malloc(bundle->bufferSize);
+  int32* expected = malloc(NX * sizeof(int32));
+  int32* decompressed = malloc(NX * sizeof(int32));
+  size_t size;
+  assert_non_null(reference);
+  assert_non_null(expected);
+  assert_non_null(decompressed);
+
+  /* compress and decompress synchronously in fixed-rate mode */
+  zfp_stream_set_rate(stream, 12, zfp_type_int32, 1, zfp_false);
+  assert_int_equal(zfp_stream_set_thread_count(stream, 3), 1);
+  assert_int_equal(zfp_stream_set_thread_chunk_size(stream, 5), 1);
+  zfp_stream_set_bit_stream(stream, bundle->bs);
+  stream_wseek(bundle->bs, stream_word_bits + 1);
+  size = zfp_compress(stream, bundle->field);
+  assert_int_not_equal(size, 0);
+  memcpy(reference, bundle->buffer, size);
+  stream_rseek(bundle->bs, stream_word_bits + 1);
+  zfp_field_set_pointer(bundle->field, expected);
+  assert_int_equal(zfp_decompress(stream, bundle->field), size);
+
+  /* compress in background; size is known up front */
+  memset(bundle->buffer, 0, bundle->bufferSize);
+  stream_wseek(bundle->bs, stream_word_bits + 1);
+  zfp_field_set_pointer(bundle->field, bundle->data);
+  assert_int_equal(zfp_compress_async(stream, bundle->field), size);
+  assert_int_equal(zfp_stream_synchronize(stream), 1);
+  assert_int_equal(zfp_stream_query(stream), 1);
+  assert_int_equal(stream_size(bundle->bs), size);
+  assert_memory_equal(bundle->buffer, reference, size);
+
+  /* decompress in background */
+  stream_rseek(bundle->bs, stream_word_bits + 1);
+  zfp_field_set_pointer(bundle->field, decompressed);
+  assert_int_equal(zfp_decompress_async(stream, bundle->field), size);
+  assert_int_equal(zfp_stream_synchronize(stream), 1);
+  assert_memory_equal(decompressed, expected, NX * sizeof(int32));
+
+  /* variable-rate compression completes before returning */
+  zfp_stream_set_reversible(stream);
+  zfp_field_set_pointer(bundle->field, bundle->data);
+  stream_wseek(bundle->bs, stream_word_bits + 1);
+  size = zfp_compress(stream, bundle->field);
+  memcpy(reference, bundle->buffer, size);
+  memset(bundle->buffer, 0, bundle->bufferSize);
+  stream_wseek(bundle->bs, stream_word_bits + 1);
+  assert_int_equal(zfp_compress_async(stream, bundle->field), size);
+  assert_int_equal(zfp_stream_query(stream), 1);
+  assert_memory_equal(bundle->buffer, reference, size);
+
+  free(decompressed);
+  free(expected);
+  free(reference);
+}
+
+#else
+static void
+given_withoutThreads_when_setExecutionThreads_expect_unableTo(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_stream* stream = bundle->stream;
+
+  assert_int_equal(zfp_stream_set_execution(stream, zfp_exec_threads), 0);
+  assert_int_equal(zfp_stream_execution(stream), zfp_exec_serial);
+}
+
+static void
+given_withoutThreads_when_setThreadParams_expect_unableTo(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_stream* stream = bundle->stream;
+
+  assert_int_equal(zfp_stream_set_thread_count(stream, 5), 0);
+  assert_int_equal(zfp_stream_set_thread_chunk_size(stream, 0x200u), 0);
+
+  assert_int_equal(zfp_stream_execution(stream), zfp_exec_serial);
+}
+
+static void
+given_withoutThreads_whenCompressThreadsPolicy_expect_noop(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  zfp_stream_set_bit_stream(bundle->stream, bundle->bs);
+  assert_int_equal(zfp_compress(bundle->stream, bundle->field), 0);
+  assert_int_equal(stream_size(bundle->bs), bundle->streamSize);
+}
+
+static void
+given_withoutThreads_whenDecompressThreadsPolicy_expect_noop(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  zfp_stream_set_bit_stream(bundle->stream, bundle->bs);
+  assert_int_equal(zfp_decompress(bundle->stream, bundle->field), 0);
+  assert_int_equal(stream_size(bundle->bs), bundle->streamSize);
+}
+
+#endif
+
+int main()
+{
+  const struct CMUnitTest tests[] = {
+#ifdef ZFP_WITH_THREADS
+    cmocka_unit_test_setup_teardown(given_withThreads_when_setExecutionThreads_expect_set, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_withThreads_serialExec_when_setThreadCount_expect_setToExecThreads, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_withThreads_when_setThreadChunkSize_expect_set, setup, teardown),
+
+    cmocka_unit_test_setup_teardown(given_withThreads_whenCompressThreadsPolicy_expect_matchesSerial, setupForCompress, teardownForCompress),
+    cmocka_unit_test_setup_teardown(given_withThreads_whenDecompressThreadsPolicy_expect_matchesSerial, setupForCompress, teardownForCompress),
+    cmocka_unit_test_setup_teardown(given_withThreads_whenCompressDecompressAsync_expect_matchesSynchronous, setupForCompress, teardownForCompress),
+#else
+    cmocka_unit_test_setup_teardown(given_withoutThreads_when_setExecutionThreads_expect_unableTo, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_withoutThreads_when_setThreadParams_expect_unableTo, setup, teardown),
+
+    cmocka_unit_test_setup_teardown(given_withoutThreads_whenCompressThreadsPolicy_expect_noop, setupForCompress, teardownForCompress),
+    cmocka_unit_test_setup_teardown(given_withoutThreads_whenDecompressThreadsPolicy_expect_noop, setupForCompress, teardownForCompress),
+#endif
+  };
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -623,6 +623,29 @@ when_BitstreamOpened_expect_ProperLengthAndBoundaries(void **state)
   free(buffer);
 }
 
+static void
+given_WrittenBitstream_when_Reopen_expect_RewoundOnNewBuffer(void **state)
+{
+  const int NUM_WORDS = 2;
+
+  struct setupVars *s = *state;
+  size_t bufferLenBytes = sizeof(word) * NUM_WORDS;
+  void* buffer = calloc(NUM_WORDS, sizeof(word));
+  stream_write_word(s->b, WORD1);
+
+  stream_reopen(s->b, buffer, bufferLenBytes);
+
+  assert_ptr_equal(stream_data(s->b), buffer);
+  assert_ptr_equal(s->b->ptr, buffer);
+  assert_int_equal(s->b->bits, 0);
+  assert_int_equal(stream_capacity(s->b), bufferLenBytes);
+
+  stream_write_word(s->b, WORD2);
+  assert_int_equal(*(word*)buffer, WORD2);
+
+  free(buffer);
+}
+
 static void
 when_Alignment_expect_MatchingStreamWordBits(void **state)
 {
@@ -635,6 +658,7 @@ int main()
   const struct CMUnitTest tests[] = {
     cmocka_unit_test(when_Alignment_expect_MatchingStreamWordBits),
     cmocka_unit_test(when_BitstreamOpened_expect_ProperLengthAndBoundaries),
+    cmocka_unit_test_setup_teardown(given_WrittenBitstream_when_Reopen_expect_RewoundOnNewBuffer, setup, teardown),
     cmocka_unit_test_setup_teardown(given_RewoundBitstream_when_WriteWord_expect_WordWrittenAtStreamBegin, setup, teardown),
     cmocka_unit_test_setup_teardown(when_WriteTwoWords_expect_WordsWrittenToStreamConsecutively, setup, teardown),
     cmocka_unit_test_setup_teardown(given_BitstreamWithOneWrittenWordRewound_when_WriteWord_expect_NewerWordOverwrites, setup, teardown),
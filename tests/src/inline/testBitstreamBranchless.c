@@ -0,0 +1,157 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#define BIT_STREAM_BRANCHLESS
+
+#include "include/bitstream.h"
+#include "src/inline/bitstream.c"
+
+#define STREAM_WORD_CAPACITY 64
+#define GUARD_WORD 0x0123456789abcdefull
+
+struct setupVars {
+  word* buffer;
+  bitstream* b;
+};
+
+static int
+setup(void **state)
+{
+  struct setupVars *s = malloc(sizeof(struct setupVars));
+  assert_non_null(s);
+
+  /* one guard word past end of stream */
+  s->buffer = calloc(STREAM_WORD_CAPACITY + 1, sizeof(word));
+  assert_non_null(s->buffer);
+  s->buffer[STREAM_WORD_CAPACITY] = GUARD_WORD;
+
+  s->b = stream_open(s->buffer, STREAM_WORD_CAPACITY * sizeof(word));
+  assert_non_null(s->b);
+
+  *state = s;
+
+  return 0;
+}
+
+static int
+teardown(void **state)
+{
+  struct setupVars *s = *state;
+  free(s->buffer);
+  free(s->b);
+  free(s);
+
+  return 0;
+}
+
+/* xorshift generator of reproducible bit strings and lengths */
+static uint64
+nextRandom(uint64* x)
+{
+  *x ^= *x << 13;
+  *x ^= *x >> 7;
+  *x ^= *x << 17;
+  return *x;
+}
+
+static void
+when_WriteBitsOfRandomLengths_expect_SameAsWritingOneBitAtATime(void **state)
+{
+  struct setupVars *bundle = *state;
+  bitstream* s = bundle->b;
+  word expected[STREAM_WORD_CAPACITY];
+  uint64 seed = 1;
+  size_t total = 0;
+
+  /* write up to 64 bits at a time, including zero and full words */
+  while (total + 64 <= STREAM_WORD_CAPACITY * wsize) {
+    uint64 value = nextRandom(&seed);
+    uint n = (uint)(nextRandom(&seed) % 65);
+    uint64 remaining = stream_write_bits(s, value, n);
+    assert_int_equal(remaining, n < 64 ? value >> n : 0);
+    total += n;
+    assert_int_equal(stream_wtell(s), total);
+  }
+  stream_flush(s);
+  memcpy(expected, bundle->buffer, sizeof(expected));
+
+  /* write same bits one at a time */
+  memset(bundle->buffer, 0, sizeof(expected));
+  stream_rewind(s);
+  seed = 1;
+  for (total = 0; total + 64 <= STREAM_WORD_CAPACITY * wsize;) {
+    uint64 value = nextRandom(&seed);
+    uint n = (uint)(nextRandom(&seed) % 65);
+    uint i;
+    for (i = 0; i < n; i++, value >>= 1)
+      stream_write_bit(s, (uint)value & 1u);
+    total += n;
+  }
+  stream_flush(s);
+
+  assert_memory_equal(bundle->buffer, expected, sizeof(expected));
+}
+
+static void
+when_ReadBitsOfRandomLengths_expect_SameAsReadingOneBitAtATime(void **state)
+{
+  struct setupVars *bundle = *state;
+  bitstream* s = bundle->b;
+  uint64 seed = 2;
+  size_t i;
+
+  for (i = 0; i < STREAM_WORD_CAPACITY; i++)
+    bundle->buffer[i] = nextRandom(&seed);
+
+  /* read up to 64 bits at a time from one stream and one bit at a time from a clone */
+  bitstream* t = stream_clone(s);
+  assert_non_null(t);
+  while (stream_rtell(s) + 64 <= STREAM_WORD_CAPACITY * wsize) {
+    uint n = (uint)(nextRandom(&seed) % 65);
+    uint64 value = stream_read_bits(s, n);
+    uint64 expected = 0;
+    uint j;
+    for (j = 0; j < n; j++)
+      expected += (uint64)stream_read_bit(t) << j;
+    assert_int_equal(value, expected);
+    assert_int_equal(stream_rtell(s), stream_rtell(t));
+  }
+
+  stream_close(t);
+}
+
+static void
+given_FullStream_when_WriteAndReadAtEnd_expect_NoAccessPastEnd(void **state)
+{
+  struct setupVars *bundle = *state;
+  bitstream* s = bundle->b;
+  size_t i;
+
+  /* fill stream exactly, then write nothing more */
+  for (i = 0; i < STREAM_WORD_CAPACITY; i++)
+    stream_write_bits(s, ~(uint64)i, wsize);
+  stream_write_bits(s, 0, 0);
+  stream_flush(s);
+  assert_int_equal(stream_size(s), STREAM_WORD_CAPACITY * sizeof(word));
+  assert_int_equal(bundle->buffer[STREAM_WORD_CAPACITY], GUARD_WORD);
+
+  /* consume stream exactly, then read nothing more */
+  stream_rewind(s);
+  for (i = 0; i < STREAM_WORD_CAPACITY; i++)
+    assert_int_equal(stream_read_bits(s, wsize), ~(uint64)i);
+  assert_int_equal(stream_read_bits(s, 0), 0);
+  assert_int_equal(stream_rtell(s), STREAM_WORD_CAPACITY * wsize);
+}
+
+int main()
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test_setup_teardown(when_WriteBitsOfRandomLengths_expect_SameAsWritingOneBitAtATime, setup, teardown),
+    cmocka_unit_test_setup_teardown(when_ReadBitsOfRandomLengths_expect_SameAsReadingOneBitAtATime, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_FullStream_when_WriteAndReadAtEnd_expect_NoAccessPastEnd, setup, teardown),
+  };
+
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
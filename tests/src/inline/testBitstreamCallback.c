@@ -0,0 +1,132 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#define BIT_STREAM_CALLBACK
+
+#include "include/bitstream.h"
+#include "src/inline/bitstream.c"
+
+#define STREAM_BUFFER_LEN 3
+#define STREAM_SINK_LEN 64
+
+/* sequential byte store standing in for a file */
+struct sink {
+  unsigned char data[STREAM_SINK_LEN * sizeof(word)];
+  size_t size;
+  size_t pos;
+  size_t calls;
+};
+
+struct setupVars {
+  word buffer[STREAM_BUFFER_LEN];
+  struct sink sink;
+  bitstream* b;
+};
+
+static size_t
+writeSink(void* context, void* buffer, size_t bytes)
+{
+  struct sink* sink = context;
+  assert_true(sink->size + bytes <= sizeof(sink->data));
+  memcpy(sink->data + sink->size, buffer, bytes);
+  sink->size += bytes;
+  sink->calls++;
+  return bytes;
+}
+
+static size_t
+readSink(void* context, void* buffer, size_t bytes)
+{
+  struct sink* sink = context;
+  if (bytes > sink->size - sink->pos)
+    bytes = sink->size - sink->pos;
+  memcpy(buffer, sink->data + sink->pos, bytes);
+  sink->pos += bytes;
+  sink->calls++;
+  return bytes;
+}
+
+static int
+setup(void **state)
+{
+  struct setupVars *s = calloc(1, sizeof(struct setupVars));
+  assert_non_null(s);
+
+  s->b = stream_open_callback(s->buffer, sizeof(s->buffer), writeSink, readSink, &s->sink);
+  assert_non_null(s->b);
+
+  *state = s;
+
+  return 0;
+}
+
+static int
+teardown(void **state)
+{
+  struct setupVars *s = *state;
+  stream_close(s->b);
+  free(s);
+
+  return 0;
+}
+
+static void
+given_CallbackStream_when_WriteWordFillsBuffer_expect_BufferPassedToWriteCallback(void **state)
+{
+  struct setupVars *s = *state;
+  bitstream* b = s->b;
+
+  int i;
+  for (i = 0; i < STREAM_BUFFER_LEN - 1; i++)
+    stream_write_word(b, (word)i);
+  assert_int_equal(s->sink.calls, 0);
+
+  stream_write_word(b, (word)i);
+  assert_int_equal(s->sink.calls, 1);
+  assert_int_equal(s->sink.size, sizeof(s->buffer));
+  assert_ptr_equal(b->ptr, b->begin);
+  assert_int_equal(stream_wtell(b), STREAM_BUFFER_LEN * wsize);
+}
+
+static void
+given_CallbackStream_when_WriteBitsAndFlush_expect_ReadBitsMatch(void **state)
+{
+  struct setupVars *s = *state;
+  bitstream* b = s->b;
+  const uint n = 37;
+  const size_t count = 40;
+
+  size_t i;
+  for (i = 0; i < count; i++)
+    stream_write_bits(b, (uint64)i * 0x9e3779b9u, n);
+  stream_flush(b);
+
+  size_t bits = count * n;
+  size_t bytes = sizeof(word) * ((bits + wsize - 1) / wsize);
+  assert_int_equal(stream_size(b), bytes);
+  assert_int_equal(s->sink.size, bytes);
+
+  /* read back through callback, skipping forward across buffer refills */
+  stream_rewind(b);
+  for (i = 0; i < count; i += 2) {
+    assert_int_equal(stream_read_bits(b, n), ((uint64)i * 0x9e3779b9u) & (((uint64)1 << n) - 1));
+    stream_skip(b, n);
+  }
+  assert_int_equal(stream_rtell(b), bits);
+
+  /* bits past end of input read as zero */
+  stream_align(b);
+  assert_int_equal(stream_read_bits(b, 64), 0);
+}
+
+int main()
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test_setup_teardown(given_CallbackStream_when_WriteWordFillsBuffer_expect_BufferPassedToWriteCallback, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_CallbackStream_when_WriteBitsAndFlush_expect_ReadBitsMatch, setup, teardown),
+  };
+
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
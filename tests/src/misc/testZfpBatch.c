@@ -0,0 +1,201 @@
+#include "zfp.h"
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* a batch of small 3D patches with partial blocks */
+#define PATCHES 7
+#define NX 6
+#define NY 5
+#define NZ 4
+#define PATCH_SIZE (NX * NY * NZ)
+
+struct setupVars {
+  zfp_stream* stream;
+  zfp_field* fields[PATCHES];
+  zfp_field* outFields[PATCHES];
+  double* data;
+  double* out;
+  bitstream* bs;
+  void* buffer;
+  size_t bufferSize;
+};
+
+static int
+setup(void **state)
+{
+  struct setupVars *bundle = malloc(sizeof(struct setupVars));
+  assert_non_null(bundle);
+
+  bundle->data = malloc(PATCHES * PATCH_SIZE * sizeof(double));
+  bundle->out = calloc(PATCHES * PATCH_SIZE, sizeof(double));
+  assert_non_null(bundle->data);
+  assert_non_null(bundle->out);
+
+  size_t i;
+  for (i = 0; i < PATCHES * PATCH_SIZE; i++)
+    bundle->data[i] = (double)(i % 17) * (double)(i % 5) - 0.25 * (double)i;
+
+  bundle->stream = zfp_stream_open(NULL);
+  bundle->bufferSize = 0;
+  for (i = 0; i < PATCHES; i++) {
+    bundle->fields[i] = zfp_field_3d(bundle->data + i * PATCH_SIZE, zfp_type_double, NX, NY, NZ);
+    bundle->outFields[i] = zfp_field_3d(bundle->out + i * PATCH_SIZE, zfp_type_double, NX, NY, NZ);
+    bundle->bufferSize += zfp_stream_maximum_size(bundle->stream, bundle->fields[i]);
+  }
+
+  bundle->buffer = calloc(bundle->bufferSize, 1);
+  assert_non_null(bundle->buffer);
+  bundle->bs = stream_open(bundle->buffer, bundle->bufferSize);
+  zfp_stream_set_bit_stream(bundle->stream, bundle->bs);
+
+  *state = bundle;
+
+  return 0;
+}
+
+static int
+teardown(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  size_t i;
+  for (i = 0; i < PATCHES; i++) {
+    zfp_field_free(bundle->fields[i]);
+    zfp_field_free(bundle->outFields[i]);
+  }
+  stream_close(bundle->bs);
+  free(bundle->buffer);
+  zfp_stream_close(bundle->stream);
+  free(bundle->data);
+  free(bundle->out);
+  free(bundle);
+
+  return 0;
+}
+
+/* compress patches one at a time with zfp_compress into a separate buffer */
+static void*
+compressEach(struct setupVars *bundle, size_t* offsets)
+{
+  void* buffer = calloc(bundle->bufferSize, 1);
+  assert_non_null(buffer);
+  bitstream* bs = stream_open(buffer, bundle->bufferSize);
+  zfp_stream_set_bit_stream(bundle->stream, bs);
+
+  size_t i;
+  offsets[0] = 0;
+  for (i = 0; i < PATCHES; i++) {
+    offsets[i + 1] = zfp_compress(bundle->stream, bundle->fields[i]);
+    assert_int_not_equal(offsets[i + 1], 0);
+  }
+
+  zfp_stream_set_bit_stream(bundle->stream, bundle->bs);
+  stream_close(bs);
+
+  return buffer;
+}
+
+static void
+assertBatchMatchesEach(struct setupVars *bundle)
+{
+  size_t expectedOffsets[PATCHES + 1];
+  size_t offsets[PATCHES + 1];
+  zfp_exec_policy policy = zfp_stream_execution(bundle->stream);
+
+  assert_int_equal(1, zfp_stream_set_execution(bundle->stream, zfp_exec_serial));
+  void* expected = compressEach(bundle, expectedOffsets);
+  assert_int_equal(1, zfp_stream_set_execution(bundle->stream, policy));
+
+  /* compressed stream is identical to that of separate calls */
+  zfp_stream_rewind(bundle->stream);
+  assert_int_equal(zfp_compress_batch(bundle->stream, (const zfp_field* const*)bundle->fields, PATCHES, offsets), expectedOffsets[PATCHES]);
+  assert_memory_equal(offsets, expectedOffsets, sizeof(offsets));
+  assert_memory_equal(bundle->buffer, expected, expectedOffsets[PATCHES]);
+
+  /* decompress with and without offsets */
+  zfp_stream_rewind(bundle->stream);
+  assert_int_equal(zfp_decompress_batch(bundle->stream, bundle->outFields, PATCHES, offsets), offsets[PATCHES]);
+  double* decompressed = malloc(PATCHES * PATCH_SIZE * sizeof(double));
+  assert_non_null(decompressed);
+  memcpy(decompressed, bundle->out, PATCHES * PATCH_SIZE * sizeof(double));
+
+  memset(bundle->out, 0, PATCHES * PATCH_SIZE * sizeof(double));
+  zfp_stream_rewind(bundle->stream);
+  assert_int_equal(zfp_decompress_batch(bundle->stream, bundle->outFields, PATCHES, NULL), offsets[PATCHES]);
+  assert_memory_equal(bundle->out, decompressed, PATCHES * PATCH_SIZE * sizeof(double));
+
+  /* each patch can be decompressed on its own */
+  memset(bundle->out, 0, PATCH_SIZE * sizeof(double));
+  assert_int_equal(1, zfp_stream_set_execution(bundle->stream, zfp_exec_serial));
+  zfp_stream_rewind(bundle->stream);
+  stream_rseek(bundle->bs, offsets[PATCHES - 1] * CHAR_BIT);
+  assert_int_equal(zfp_decompress(bundle->stream, bundle->outFields[0]), offsets[PATCHES]);
+  assert_memory_equal(bundle->out, decompressed + (PATCHES - 1) * PATCH_SIZE, PATCH_SIZE * sizeof(double));
+
+  free(decompressed);
+  free(expected);
+}
+
+static void
+given_fixedRate_when_zfpCompressBatch_expect_matchesSeparateCalls(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_stream_set_rate(bundle->stream, 12, zfp_type_double, 3, 0);
+  assertBatchMatchesEach(bundle);
+}
+
+static void
+given_fixedAccuracy_when_zfpCompressBatch_expect_matchesSeparateCalls(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_stream_set_accuracy(bundle->stream, 1e-3);
+  assertBatchMatchesEach(bundle);
+}
+
+static void
+given_ompPolicy_when_zfpCompressBatch_expect_matchesSeparateCalls(void **state)
+{
+  struct setupVars *bundle = *state;
+  if (!zfp_stream_set_execution(bundle->stream, zfp_exec_omp))
+    skip();
+
+  zfp_stream_set_rate(bundle->stream, 12, zfp_type_double, 3, 0);
+  assertBatchMatchesEach(bundle);
+
+  assert_int_equal(1, zfp_stream_set_execution(bundle->stream, zfp_exec_omp));
+  zfp_stream_set_accuracy(bundle->stream, 1e-3);
+  assertBatchMatchesEach(bundle);
+}
+
+static void
+given_insufficientCapacity_when_zfpCompressBatch_expect_returnsZero(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_stream_set_rate(bundle->stream, 12, zfp_type_double, 3, 0);
+
+  bitstream* bs = stream_open(bundle->buffer, zfp_stream_maximum_size(bundle->stream, bundle->fields[0]));
+  zfp_stream_set_bit_stream(bundle->stream, bs);
+  assert_int_equal(zfp_compress_batch(bundle->stream, (const zfp_field* const*)bundle->fields, PATCHES, NULL), 0);
+
+  zfp_stream_set_bit_stream(bundle->stream, bundle->bs);
+  stream_close(bs);
+}
+
+int main()
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test_setup_teardown(given_fixedRate_when_zfpCompressBatch_expect_matchesSeparateCalls, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_fixedAccuracy_when_zfpCompressBatch_expect_matchesSeparateCalls, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_ompPolicy_when_zfpCompressBatch_expect_matchesSeparateCalls, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_insufficientCapacity_when_zfpCompressBatch_expect_returnsZero, setup, teardown),
+  };
+
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,189 @@
+#include "zfp.h"
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#define NX 13
+#define NY 11
+#define NZ 9
+#define FIELD_SIZE (NX * NY * NZ)
+#define BLOCKS (((NX + 3) / 4) * ((NY + 3) / 4) * ((NZ + 3) / 4))
+#define CHUNKS 5
+
+struct setupVars {
+  zfp_stream* stream;
+  zfp_field* field;
+  zfp_index* index;
+  double* data;
+  double* blocks;
+  void* buffer;
+  size_t bufferSize;
+};
+
+static int
+setup(void **state, zfp_bool fixedRate)
+{
+  struct setupVars *bundle = malloc(sizeof(struct setupVars));
+  assert_non_null(bundle);
+
+  bundle->data = malloc(FIELD_SIZE * sizeof(double));
+  bundle->blocks = calloc(BLOCKS * 64, sizeof(double));
+  assert_non_null(bundle->data);
+  assert_non_null(bundle->blocks);
+
+  size_t i;
+  for (i = 0; i < FIELD_SIZE; i++)
+    bundle->data[i] = (double)(i % 23) * (double)(i % 7) - 0.125 * (double)i;
+
+  bundle->stream = zfp_stream_open(NULL);
+  bundle->field = zfp_field_3d(bundle->data, zfp_type_double, NX, NY, NZ);
+  bundle->index = zfp_index_alloc();
+  assert_non_null(bundle->index);
+  if (fixedRate)
+    zfp_stream_set_rate(bundle->stream, 16, zfp_type_double, 3, zfp_true);
+  else
+    zfp_stream_set_accuracy(bundle->stream, 1e-3);
+  bundle->bufferSize = zfp_stream_maximum_size(bundle->stream, bundle->field);
+  bundle->buffer = calloc(bundle->bufferSize, 1);
+  assert_non_null(bundle->buffer);
+
+  /* compress field, then decode all blocks sequentially for reference */
+  bitstream* bs = stream_open(bundle->buffer, bundle->bufferSize);
+  zfp_stream_set_bit_stream(bundle->stream, bs);
+  assert_int_not_equal(zfp_compress(bundle->stream, bundle->field), 0);
+  zfp_stream_rewind(bundle->stream);
+  uint64 offset[CHUNKS + 1];
+  size_t chunk = 0;
+  for (i = 0; i < BLOCKS; i++) {
+    if (i == (size_t)BLOCKS * chunk / CHUNKS)
+      offset[chunk++] = stream_rtell(bs);
+    zfp_decode_block_double_3(bundle->stream, bundle->blocks + 64 * i);
+  }
+  offset[CHUNKS] = stream_rtell(bs);
+  assert_int_equal(zfp_index_set(bundle->index, CHUNKS, offset), zfp_true);
+  zfp_stream_rewind(bundle->stream);
+
+  *state = bundle;
+
+  return 0;
+}
+
+static int
+setupFixedRate(void **state)
+{
+  return setup(state, zfp_true);
+}
+
+static int
+setupFixedAccuracy(void **state)
+{
+  return setup(state, zfp_false);
+}
+
+static int
+teardown(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  stream_close(zfp_stream_bit_stream(bundle->stream));
+  zfp_index_free(bundle->index);
+  zfp_field_free(bundle->field);
+  zfp_stream_close(bundle->stream);
+  free(bundle->buffer);
+  free(bundle->blocks);
+  free(bundle->data);
+  free(bundle);
+
+  return 0;
+}
+
+/* decode blocks in scrambled order and compare with sequentially decoded blocks */
+static void
+assertBlocksMatchSequentialDecode(struct setupVars *bundle)
+{
+  double block[64];
+  size_t i;
+
+  for (i = 0; i < BLOCKS; i++) {
+    size_t b = (7 * i + 3) % BLOCKS;
+    assert_int_not_equal(zfp_decode_block_at(bundle->stream, bundle->field, b, block), 0);
+    assert_memory_equal(block, bundle->blocks + 64 * b, sizeof(block));
+    assert_int_equal(stream_rtell(zfp_stream_bit_stream(bundle->stream)), 0);
+  }
+}
+
+static void
+given_fixedRateStream_when_zfpDecodeBlockAt_expect_matchesSequentialDecode(void **state)
+{
+  assertBlocksMatchSequentialDecode(*state);
+}
+
+static void
+given_indexedStream_when_zfpDecodeBlockAt_expect_matchesSequentialDecode(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  zfp_stream_set_index(bundle->stream, bundle->index);
+  assertBlocksMatchSequentialDecode(bundle);
+}
+
+static void
+given_unindexedVariableRateStream_when_zfpDecodeBlockAt_expect_returnsZero(void **state)
+{
+  struct setupVars *bundle = *state;
+  double block[64];
+
+  assert_int_equal(zfp_decode_block_at(bundle->stream, bundle->field, 1, block), 0);
+  assert_int_equal(zfp_decode_block_at(bundle->stream, bundle->field, BLOCKS, block), 0);
+}
+
+static void
+given_fixedRateStream_when_zfpEncodeBlockAt_expect_onlyThatBlockChanges(void **state)
+{
+  struct setupVars *bundle = *state;
+  double block[64];
+  size_t i;
+  size_t b = BLOCKS / 2;
+
+  for (i = 0; i < 64; i++)
+    block[i] = (double)i;
+  assert_int_equal(zfp_encode_block_at(bundle->stream, bundle->field, b, block), 16 * 64);
+  assert_int_equal(stream_wtell(zfp_stream_bit_stream(bundle->stream)), 0);
+
+  /* decode whole stream sequentially */
+  zfp_stream_rewind(bundle->stream);
+  for (i = 0; i < BLOCKS; i++) {
+    double decoded[64];
+    zfp_decode_block_double_3(bundle->stream, decoded);
+    if (i == b)
+      assert_true(decoded[63] > 60);
+    else
+      assert_memory_equal(decoded, bundle->blocks + 64 * i, sizeof(decoded));
+  }
+}
+
+static void
+given_variableRateStream_when_zfpEncodeBlockAt_expect_returnsZero(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  assert_int_equal(zfp_encode_block_at(bundle->stream, bundle->field, 0, bundle->blocks), 0);
+}
+
+int main()
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test_setup_teardown(given_fixedRateStream_when_zfpDecodeBlockAt_expect_matchesSequentialDecode, setupFixedRate, teardown),
+    cmocka_unit_test_setup_teardown(given_indexedStream_when_zfpDecodeBlockAt_expect_matchesSequentialDecode, setupFixedAccuracy, teardown),
+    cmocka_unit_test_setup_teardown(given_unindexedVariableRateStream_when_zfpDecodeBlockAt_expect_returnsZero, setupFixedAccuracy, teardown),
+    cmocka_unit_test_setup_teardown(given_fixedRateStream_when_zfpEncodeBlockAt_expect_onlyThatBlockChanges, setupFixedRate, teardown),
+    cmocka_unit_test_setup_teardown(given_variableRateStream_when_zfpEncodeBlockAt_expect_returnsZero, setupFixedAccuracy, teardown),
+  };
+
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,177 @@
+#include "zfp.h"
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* 2D field with partial blocks and a feature of interest near its center */
+#define NX 61
+#define NY 46
+#define MX ((NX + 3) / 4)
+#define MY ((NY + 3) / 4)
+#define FIELD_SIZE (NX * NY)
+#define BLOCKS (MX * MY)
+#define TOLERANCE 1e-6
+#define LEVEL 12
+
+struct setupVars {
+  double* data;
+  double* decompressed;
+  double* reference;
+  uint8 map[BLOCKS];
+  void* buffer;
+  size_t bufferSize;
+  zfp_field* field;
+  zfp_stream* stream;
+  bitstream* s;
+};
+
+static int
+setup(void **state)
+{
+  struct setupVars *bundle = malloc(sizeof(struct setupVars));
+  assert_non_null(bundle);
+
+  bundle->data = malloc(FIELD_SIZE * sizeof(double));
+  bundle->decompressed = calloc(FIELD_SIZE, sizeof(double));
+  bundle->reference = calloc(FIELD_SIZE, sizeof(double));
+  assert_non_null(bundle->data);
+  assert_non_null(bundle->decompressed);
+  assert_non_null(bundle->reference);
+
+  /* sharp front on smooth background */
+  size_t x, y;
+  for (y = 0; y < NY; y++)
+    for (x = 0; x < NX; x++)
+      bundle->data[x + NX * y] = sin(0.1 * (double)x) * cos(0.07 * (double)y) + tanh(2.0 * ((double)x - 0.8 * (double)y - 10));
+
+  /* full fidelity only for blocks near the center */
+  for (y = 0; y < MY; y++)
+    for (x = 0; x < MX; x++)
+      bundle->map[x + MX * y] = (4 <= x && x < 11 && 3 <= y && y < 8) ? 0 : LEVEL;
+
+  bundle->field = zfp_field_2d(bundle->data, zfp_type_double, NX, NY);
+  bundle->stream = zfp_stream_open(NULL);
+  zfp_stream_set_accuracy(bundle->stream, TOLERANCE);
+  bundle->bufferSize = zfp_stream_maximum_size(bundle->stream, bundle->field);
+  bundle->buffer = calloc(bundle->bufferSize, 1);
+  assert_non_null(bundle->buffer);
+  bundle->s = stream_open(bundle->buffer, bundle->bufferSize);
+  zfp_stream_set_bit_stream(bundle->stream, bundle->s);
+
+  *state = bundle;
+
+  return 0;
+}
+
+static int
+teardown(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  zfp_field_free(bundle->field);
+  zfp_stream_close(bundle->stream);
+  stream_close(bundle->s);
+  free(bundle->buffer);
+  free(bundle->reference);
+  free(bundle->decompressed);
+  free(bundle->data);
+  free(bundle);
+
+  return 0;
+}
+
+/* compress and decompress field into given array; return compressed size */
+static size_t
+roundtrip(struct setupVars *bundle, double* decompressed)
+{
+  size_t size;
+  zfp_stream_rewind(bundle->stream);
+  zfp_field_set_pointer(bundle->field, bundle->data);
+  size = zfp_compress(bundle->stream, bundle->field);
+  assert_int_not_equal(size, 0);
+  zfp_stream_rewind(bundle->stream);
+  zfp_field_set_pointer(bundle->field, decompressed);
+  assert_int_equal(zfp_decompress(bundle->stream, bundle->field), size);
+  return size;
+}
+
+static void
+given_blockMap_when_zfpCompress_expect_fullFidelityOnlyInImportantBlocks(void **state)
+{
+  struct setupVars *bundle = *state;
+  size_t x, y;
+
+  /* reference without map */
+  size_t size = roundtrip(bundle, bundle->reference);
+
+  zfp_stream_set_block_map(bundle->stream, bundle->map);
+  assert_ptr_equal(zfp_stream_block_map(bundle->stream), bundle->map);
+  assert_true(roundtrip(bundle, bundle->decompressed) < size / 2);
+
+  for (y = 0; y < NY; y++)
+    for (x = 0; x < NX; x++) {
+      size_t i = x + NX * y;
+      double error = fabs(bundle->decompressed[i] - bundle->data[i]);
+      if (bundle->map[x / 4 + MX * (y / 4)])
+        /* coarsened blocks meet a tolerance larger by 2^LEVEL */
+        assert_true(error <= TOLERANCE * (1 << LEVEL));
+      else
+        /* other blocks are coded exactly as without a map */
+        assert_true(bundle->decompressed[i] == bundle->reference[i]);
+    }
+}
+
+static void
+given_blockMapAndIndex_when_zfpDecompressWithOpenMP_expect_matchesSerial(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_index* index = zfp_index_alloc();
+  assert_non_null(index);
+
+  zfp_stream_set_block_map(bundle->stream, bundle->map);
+  if (!zfp_stream_set_execution(bundle->stream, zfp_exec_omp)) {
+    zfp_index_free(index);
+    skip();
+  }
+  zfp_stream_set_index(bundle->stream, index);
+  roundtrip(bundle, bundle->decompressed);
+
+  zfp_stream_set_execution(bundle->stream, zfp_exec_serial);
+  zfp_stream_rewind(bundle->stream);
+  zfp_field_set_pointer(bundle->field, bundle->reference);
+  assert_int_not_equal(zfp_decompress(bundle->stream, bundle->field), 0);
+  assert_memory_equal(bundle->decompressed, bundle->reference, FIELD_SIZE * sizeof(double));
+
+  zfp_stream_set_index(bundle->stream, NULL);
+  zfp_index_free(index);
+}
+
+static void
+given_blockMapInFixedRateOrReversibleMode_when_zfpCompress_expect_returnsZero(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  zfp_stream_set_block_map(bundle->stream, bundle->map);
+  zfp_stream_set_rate(bundle->stream, 16, zfp_type_double, 2, zfp_false);
+  assert_int_equal(zfp_compress(bundle->stream, bundle->field), 0);
+  zfp_stream_set_reversible(bundle->stream);
+  assert_int_equal(zfp_compress(bundle->stream, bundle->field), 0);
+  assert_int_equal(zfp_decompress(bundle->stream, bundle->field), 0);
+}
+
+int main()
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test_setup_teardown(given_blockMap_when_zfpCompress_expect_fullFidelityOnlyInImportantBlocks, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_blockMapAndIndex_when_zfpDecompressWithOpenMP_expect_matchesSerial, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_blockMapInFixedRateOrReversibleMode_when_zfpCompress_expect_returnsZero, setup, teardown),
+  };
+
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
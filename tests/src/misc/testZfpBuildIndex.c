@@ -0,0 +1,351 @@
+#include "zfp.h"
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* fields of 1-4 dimensions with partial blocks along each dimension */
+#define FIELD_SIZE 2100
+#define GRANULARITY 3
+
+static const size_t extent[4][4] = {
+  { 2085, 0, 0, 0 },
+  { 46, 45, 0, 0 },
+  { 15, 14, 10, 0 },
+  { 9, 6, 7, 5 },
+};
+
+struct setupVars {
+  void* data;
+  void* decompressed;
+  void* buffer;
+  size_t bufferSize;
+  zfp_stream* stream;
+  zfp_index* index;
+  bitstream* s;
+};
+
+static int
+setup(void **state)
+{
+  struct setupVars *bundle = malloc(sizeof(struct setupVars));
+  assert_non_null(bundle);
+
+  bundle->data = malloc(FIELD_SIZE * sizeof(double));
+  bundle->decompressed = malloc(FIELD_SIZE * sizeof(double));
+  assert_non_null(bundle->data);
+  assert_non_null(bundle->decompressed);
+
+  /* room for every block of the largest scalar type stored verbatim */
+  bundle->stream = zfp_stream_open(NULL);
+  bundle->bufferSize = 2 * FIELD_SIZE * sizeof(double) + 0x1000;
+  bundle->buffer = calloc(bundle->bufferSize, 1);
+  assert_non_null(bundle->buffer);
+  bundle->s = stream_open(bundle->buffer, bundle->bufferSize);
+  zfp_stream_set_bit_stream(bundle->stream, bundle->s);
+  bundle->index = zfp_index_alloc();
+  assert_non_null(bundle->index);
+
+  *state = bundle;
+
+  return 0;
+}
+
+static int
+teardown(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  zfp_index_free(bundle->index);
+  zfp_stream_close(bundle->stream);
+  stream_close(bundle->s);
+  free(bundle->buffer);
+  free(bundle->decompressed);
+  free(bundle->data);
+  free(bundle);
+
+  return 0;
+}
+
+/* smooth values, followed by all-zero blocks, followed by random noise */
+static zfp_field*
+initField(struct setupVars *bundle, zfp_type type, uint dims)
+{
+  const size_t* n = extent[dims - 1];
+  size_t i;
+  uint64 u = 1;
+  zfp_field* field;
+
+  for (i = 0; i < FIELD_SIZE; i++) {
+    double x = i < FIELD_SIZE / 2 ? 1e3 * sin(0.01 * (double)i) : 0;
+    u = u * 6364136223846793005ull + 1442695040888963407ull;
+    if (i >= 3 * FIELD_SIZE / 4)
+      x = (double)(int32)(u >> 32);
+    switch (type) {
+      case zfp_type_int32:
+        ((int32*)bundle->data)[i] = (int32)((uint32)(int64)x << 8);
+        break;
+      case zfp_type_int64:
+        ((int64*)bundle->data)[i] = (int64)((uint64)(int64)x << 24);
+        break;
+      case zfp_type_float:
+        ((float*)bundle->data)[i] = (float)x;
+        break;
+      case zfp_type_double:
+        ((double*)bundle->data)[i] = x;
+        break;
+      default:
+        break;
+    }
+  }
+
+  switch (dims) {
+    case 1:
+      field = zfp_field_1d(bundle->data, type, n[0]);
+      break;
+    case 2:
+      field = zfp_field_2d(bundle->data, type, n[0], n[1]);
+      break;
+    case 3:
+      field = zfp_field_3d(bundle->data, type, n[0], n[1], n[2]);
+      break;
+    default:
+      field = zfp_field_4d(bundle->data, type, n[0], n[1], n[2], n[3]);
+      break;
+  }
+  assert_non_null(field);
+
+  return field;
+}
+
+/* number of blocks in field */
+static size_t
+fieldBlocks(const zfp_field* field)
+{
+  size_t n[4];
+  size_t blocks = 1;
+  uint i;
+  n[0] = field->nx;
+  n[1] = field->ny;
+  n[2] = field->nz;
+  n[3] = field->nw;
+  for (i = 0; i < zfp_field_dimensionality(field); i++)
+    blocks *= (n[i] + 3) / 4;
+  return blocks;
+}
+
+/* decode one block of given type and dimensionality; return bits read */
+static size_t
+decodeBlock(zfp_stream* stream, zfp_type type, uint dims, void* block)
+{
+  switch (type) {
+    case zfp_type_int32:
+      switch (dims) {
+        case 1: return zfp_decode_block_int32_1(stream, (int32*)block);
+        case 2: return zfp_decode_block_int32_2(stream, (int32*)block);
+        case 3: return zfp_decode_block_int32_3(stream, (int32*)block);
+        default: return zfp_decode_block_int32_4(stream, (int32*)block);
+      }
+    case zfp_type_int64:
+      switch (dims) {
+        case 1: return zfp_decode_block_int64_1(stream, (int64*)block);
+        case 2: return zfp_decode_block_int64_2(stream, (int64*)block);
+        case 3: return zfp_decode_block_int64_3(stream, (int64*)block);
+        default: return zfp_decode_block_int64_4(stream, (int64*)block);
+      }
+    case zfp_type_float:
+      switch (dims) {
+        case 1: return zfp_decode_block_float_1(stream, (float*)block);
+        case 2: return zfp_decode_block_float_2(stream, (float*)block);
+        case 3: return zfp_decode_block_float_3(stream, (float*)block);
+        default: return zfp_decode_block_float_4(stream, (float*)block);
+      }
+    default:
+      switch (dims) {
+        case 1: return zfp_decode_block_double_1(stream, (double*)block);
+        case 2: return zfp_decode_block_double_2(stream, (double*)block);
+        case 3: return zfp_decode_block_double_3(stream, (double*)block);
+        default: return zfp_decode_block_double_4(stream, (double*)block);
+      }
+  }
+}
+
+/* compress field and check that index built by skipping blocks matches
+   offsets obtained by fully decoding them */
+static void
+assertIndexMatchesDecoder(struct setupVars *bundle, zfp_field* field)
+{
+  zfp_stream* stream = bundle->stream;
+  uint dims = zfp_field_dimensionality(field);
+  size_t blocks = fieldBlocks(field);
+  size_t chunks = (blocks + GRANULARITY - 1) / GRANULARITY;
+  double block[256];
+  size_t chunk, i, bits, size;
+
+  zfp_stream_rewind(stream);
+  size = zfp_compress(stream, field);
+  assert_int_not_equal(size, 0);
+
+  /* index covers field, and stream is left at beginning of field */
+  zfp_stream_rewind(stream);
+  bits = zfp_build_index(stream, field, bundle->index, GRANULARITY);
+  assert_int_equal((bits + 63) / 64 * 8, size);
+  assert_int_equal(stream_rtell(bundle->s), 0);
+  assert_int_equal(zfp_index_chunks(bundle->index), chunks);
+
+  for (chunk = 0, i = 0; i < blocks; i++) {
+    if (i == blocks * chunk / chunks) {
+      assert_int_equal(zfp_index_offset(bundle->index, chunk), stream_rtell(bundle->s));
+      chunk++;
+    }
+    decodeBlock(stream, field->type, dims, block);
+  }
+  assert_int_equal(zfp_index_offset(bundle->index, chunks), stream_rtell(bundle->s));
+  assert_int_equal(bits, stream_rtell(bundle->s));
+}
+
+/* check index for all scalar types and dimensionalities in current mode */
+static void
+assertIndexMatchesDecoderForAllFields(struct setupVars *bundle)
+{
+  static const zfp_type types[] = { zfp_type_int32, zfp_type_int64, zfp_type_float, zfp_type_double };
+  uint t, dims;
+
+  for (t = 0; t < 4; t++)
+    for (dims = 1; dims <= 4; dims++) {
+      zfp_field* field = initField(bundle, types[t], dims);
+      assertIndexMatchesDecoder(bundle, field);
+      zfp_field_free(field);
+    }
+}
+
+static void
+given_fixedPrecision_when_zfpBuildIndex_expect_offsetsMatchDecoder(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_stream_set_precision(bundle->stream, 19);
+  assertIndexMatchesDecoderForAllFields(bundle);
+}
+
+static void
+given_fixedAccuracy_when_zfpBuildIndex_expect_offsetsMatchDecoder(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_stream_set_accuracy(bundle->stream, 1e-2);
+  assertIndexMatchesDecoderForAllFields(bundle);
+}
+
+static void
+given_expertModeWithMinAndMaxBits_when_zfpBuildIndex_expect_offsetsMatchDecoder(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_stream_set_params(bundle->stream, 100, 700, 24, -20);
+  assertIndexMatchesDecoderForAllFields(bundle);
+}
+
+static void
+given_reversible_when_zfpBuildIndex_expect_offsetsMatchDecoder(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_stream_set_reversible(bundle->stream);
+  assertIndexMatchesDecoderForAllFields(bundle);
+}
+
+static void
+given_rawBlocks_when_zfpBuildIndex_expect_offsetsMatchDecoder(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_stream_set_raw_blocks(bundle->stream, zfp_true);
+  zfp_stream_set_reversible(bundle->stream);
+  assertIndexMatchesDecoderForAllFields(bundle);
+  zfp_stream_set_precision(bundle->stream, 40);
+  assertIndexMatchesDecoderForAllFields(bundle);
+}
+
+static void
+given_fixedRate_when_zfpBuildIndex_expect_offsetsAreMultiplesOfBlockSize(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_field* field = initField(bundle, zfp_type_float, 3);
+  size_t blocks = fieldBlocks(field);
+  size_t chunks = (blocks + GRANULARITY - 1) / GRANULARITY;
+  uint maxbits = (uint)(zfp_stream_set_rate(bundle->stream, 6, zfp_type_float, 3, zfp_false) * 64);
+  size_t chunk;
+
+  assert_int_not_equal(zfp_compress(bundle->stream, field), 0);
+  zfp_stream_rewind(bundle->stream);
+  assert_int_equal(zfp_build_index(bundle->stream, field, bundle->index, GRANULARITY), blocks * maxbits);
+  for (chunk = 0; chunk <= chunks; chunk++)
+    assert_int_equal(zfp_index_offset(bundle->index, chunk), (uint64)(blocks * chunk / chunks) * maxbits);
+
+  zfp_field_free(field);
+}
+
+static void
+given_indexBuiltForSerialStream_when_zfpDecompressInParallel_expect_matchesSerial(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_field* field = initField(bundle, zfp_type_double, 3);
+  size_t size;
+
+  /* legacy stream compressed serially carries no chunk index */
+  zfp_stream_set_accuracy(bundle->stream, 1e-3);
+  size = zfp_compress(bundle->stream, field);
+  assert_int_not_equal(size, 0);
+  zfp_stream_rewind(bundle->stream);
+  assert_int_not_equal(zfp_build_index(bundle->stream, field, bundle->index, GRANULARITY), 0);
+
+  if (!zfp_stream_set_execution(bundle->stream, zfp_exec_omp)) {
+    zfp_field_free(field);
+    skip();
+  }
+  zfp_stream_set_index(bundle->stream, bundle->index);
+  zfp_field_set_pointer(field, bundle->decompressed);
+  assert_int_equal(zfp_decompress(bundle->stream, field), size);
+
+  /* compare with serial decompression */
+  zfp_stream_set_execution(bundle->stream, zfp_exec_serial);
+  zfp_stream_set_index(bundle->stream, NULL);
+  zfp_stream_rewind(bundle->stream);
+  zfp_field_set_pointer(field, bundle->data);
+  assert_int_equal(zfp_decompress(bundle->stream, field), size);
+  assert_memory_equal(bundle->decompressed, bundle->data, zfp_field_size(field, NULL) * sizeof(double));
+
+  zfp_field_free(field);
+}
+
+static void
+given_invalidArguments_when_zfpBuildIndex_expect_returnsZero(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_field* field = initField(bundle, zfp_type_float, 2);
+
+  zfp_stream_set_precision(bundle->stream, 16);
+  assert_int_not_equal(zfp_compress(bundle->stream, field), 0);
+  zfp_stream_rewind(bundle->stream);
+  assert_int_equal(zfp_build_index(bundle->stream, field, bundle->index, 0), 0);
+  assert_int_equal(zfp_index_chunks(bundle->index), 0);
+
+  zfp_field_free(field);
+}
+
+int main()
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test_setup_teardown(given_fixedPrecision_when_zfpBuildIndex_expect_offsetsMatchDecoder, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_fixedAccuracy_when_zfpBuildIndex_expect_offsetsMatchDecoder, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_expertModeWithMinAndMaxBits_when_zfpBuildIndex_expect_offsetsMatchDecoder, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_reversible_when_zfpBuildIndex_expect_offsetsMatchDecoder, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_rawBlocks_when_zfpBuildIndex_expect_offsetsMatchDecoder, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_fixedRate_when_zfpBuildIndex_expect_offsetsAreMultiplesOfBlockSize, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_indexBuiltForSerialStream_when_zfpDecompressInParallel_expect_matchesSerial, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_invalidArguments_when_zfpBuildIndex_expect_returnsZero, setup, teardown),
+  };
+
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
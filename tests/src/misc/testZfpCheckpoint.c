@@ -0,0 +1,210 @@
+#include "zfp.h"
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NX 32
+#define NY 32
+#define NZ 16
+#define FIELD_SIZE (NX * NY * NZ)
+#define BLOCKS ((NX / 4) * (NY / 4) * (NZ / 4))
+
+struct setupVars {
+  zfp_field* field;
+  zfp_field* output;
+  double* data;
+  double* decompressed;
+  zfp_checkpoint* writer;
+  zfp_checkpoint* reader;
+  zfp_stream* zfp;
+  void* buffer;
+  size_t size;
+};
+
+static int
+setup(void **state)
+{
+  struct setupVars *bundle = malloc(sizeof(struct setupVars));
+  assert_non_null(bundle);
+
+  bundle->data = malloc(FIELD_SIZE * sizeof(double));
+  bundle->decompressed = calloc(FIELD_SIZE, sizeof(double));
+  assert_non_null(bundle->data);
+  assert_non_null(bundle->decompressed);
+
+  size_t i;
+  for (i = 0; i < FIELD_SIZE; i++)
+    bundle->data[i] = (double)((i * 7919) % 101) - 0.5 * (double)(i % 13);
+
+  bundle->field = zfp_field_3d(bundle->data, zfp_type_double, NX, NY, NZ);
+  bundle->output = zfp_field_3d(bundle->decompressed, zfp_type_double, NX, NY, NZ);
+  bundle->writer = zfp_checkpoint_create(bundle->field);
+  bundle->reader = zfp_checkpoint_create(bundle->field);
+  assert_non_null(bundle->writer);
+  assert_non_null(bundle->reader);
+
+  bundle->zfp = zfp_stream_open(NULL);
+  zfp_stream_set_accuracy(bundle->zfp, 1e-3);
+  bundle->size = 1 + BLOCKS / CHAR_BIT + zfp_stream_maximum_size(bundle->zfp, bundle->field);
+  bundle->buffer = malloc(bundle->size);
+  assert_non_null(bundle->buffer);
+  zfp_stream_set_bit_stream(bundle->zfp, stream_open(bundle->buffer, bundle->size));
+
+  *state = bundle;
+
+  return 0;
+}
+
+static int
+teardown(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  stream_close(zfp_stream_bit_stream(bundle->zfp));
+  zfp_stream_close(bundle->zfp);
+  zfp_checkpoint_free(bundle->writer);
+  zfp_checkpoint_free(bundle->reader);
+  zfp_field_free(bundle->field);
+  zfp_field_free(bundle->output);
+  free(bundle->buffer);
+  free(bundle->data);
+  free(bundle->decompressed);
+  free(bundle);
+
+  return 0;
+}
+
+/* write checkpoint of field into empty stream and return its byte size */
+static size_t
+write_checkpoint(struct setupVars *bundle)
+{
+  zfp_stream_rewind(bundle->zfp);
+  return zfp_checkpoint_write(bundle->writer, bundle->zfp, bundle->field);
+}
+
+/* read checkpoint from start of stream into output field */
+static size_t
+read_checkpoint(struct setupVars *bundle)
+{
+  zfp_stream_rewind(bundle->zfp);
+  return zfp_checkpoint_read(bundle->reader, bundle->zfp, bundle->output);
+}
+
+/* compress and decompress field with zfp_compress() and return values */
+static double*
+reference(struct setupVars *bundle)
+{
+  double* values = malloc(FIELD_SIZE * sizeof(double));
+  void* buffer = malloc(bundle->size);
+  zfp_stream* zfp = zfp_stream_open(stream_open(buffer, bundle->size));
+  zfp_field* field = zfp_field_3d(values, zfp_type_double, NX, NY, NZ);
+
+  zfp_stream_set_accuracy(zfp, 1e-3);
+  assert_true(zfp_compress(zfp, bundle->field) != 0);
+  zfp_stream_rewind(zfp);
+  assert_true(zfp_decompress(zfp, field) != 0);
+
+  zfp_field_free(field);
+  stream_close(zfp_stream_bit_stream(zfp));
+  zfp_stream_close(zfp);
+  free(buffer);
+
+  return values;
+}
+
+static void
+given_firstCheckpoint_when_written_expect_allBlocksStoredAndDecompressedAsZfpCompress(void **state)
+{
+  struct setupVars *bundle = *state;
+  double* expected = reference(bundle);
+
+  assert_true(write_checkpoint(bundle) != 0);
+  assert_int_equal(zfp_checkpoint_blocks(bundle->writer), BLOCKS);
+  assert_true(read_checkpoint(bundle) != 0);
+  assert_int_equal(zfp_checkpoint_blocks(bundle->reader), BLOCKS);
+  assert_memory_equal(bundle->decompressed, expected, FIELD_SIZE * sizeof(double));
+
+  free(expected);
+}
+
+static void
+given_oneBlockChanged_when_checkpointWritten_expect_onlyThatBlockStoredAndOverlaid(void **state)
+{
+  struct setupVars *bundle = *state;
+  size_t full, increment;
+  double* expected;
+
+  full = write_checkpoint(bundle);
+  assert_true(read_checkpoint(bundle) != 0);
+
+  /* change one value in block (1, 2, 3) */
+  bundle->data[5 + NX * (9 + NY * 13)] += 100;
+  expected = reference(bundle);
+
+  increment = write_checkpoint(bundle);
+  assert_int_equal(zfp_checkpoint_blocks(bundle->writer), 1);
+  assert_true(increment != 0);
+  assert_true(increment < full / 8);
+
+  assert_true(read_checkpoint(bundle) == increment);
+  assert_int_equal(zfp_checkpoint_blocks(bundle->reader), 1);
+  assert_memory_equal(bundle->decompressed, expected, FIELD_SIZE * sizeof(double));
+
+  free(expected);
+}
+
+static void
+given_unchangedField_when_checkpointWritten_expect_noBlocksStored(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  write_checkpoint(bundle);
+  assert_true(write_checkpoint(bundle) != 0);
+  assert_int_equal(zfp_checkpoint_blocks(bundle->writer), 0);
+
+  /* after reset, next checkpoint is written in full */
+  zfp_checkpoint_reset(bundle->writer);
+  write_checkpoint(bundle);
+  assert_int_equal(zfp_checkpoint_blocks(bundle->writer), BLOCKS);
+}
+
+static void
+given_incrementalCheckpoint_when_readWithoutBase_expect_failure(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  write_checkpoint(bundle);
+  write_checkpoint(bundle);
+  assert_int_equal(read_checkpoint(bundle), 0);
+}
+
+static void
+given_mismatchedField_when_checkpointWritten_expect_failure(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_field* field = zfp_field_3d(bundle->data, zfp_type_double, NX, NY, NZ / 2);
+
+  zfp_stream_rewind(bundle->zfp);
+  assert_int_equal(zfp_checkpoint_write(bundle->writer, bundle->zfp, field), 0);
+
+  zfp_field_free(field);
+}
+
+int main()
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test_setup_teardown(given_firstCheckpoint_when_written_expect_allBlocksStoredAndDecompressedAsZfpCompress, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_oneBlockChanged_when_checkpointWritten_expect_onlyThatBlockStoredAndOverlaid, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_unchangedField_when_checkpointWritten_expect_noBlocksStored, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_incrementalCheckpoint_when_readWithoutBase_expect_failure, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_mismatchedField_when_checkpointWritten_expect_failure, setup, teardown),
+  };
+
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,174 @@
+#include "zfp.h"
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* chunk with partial blocks along each dimension */
+#define NX 7
+#define NY 5
+#define NZ 6
+#define CHUNK_SIZE (NX * NY * NZ)
+
+struct setupVars {
+  double* data;
+  double* decoded;
+  void* buffer;
+  size_t bufferSize;
+  size_t shape[3];
+  zfp_chunk_codec* codec;
+};
+
+static int
+setup(void **state)
+{
+  struct setupVars *bundle = malloc(sizeof(struct setupVars));
+  assert_non_null(bundle);
+
+  bundle->data = malloc(CHUNK_SIZE * sizeof(double));
+  bundle->decoded = calloc(CHUNK_SIZE, sizeof(double));
+  assert_non_null(bundle->data);
+  assert_non_null(bundle->decoded);
+
+  size_t i;
+  for (i = 0; i < CHUNK_SIZE; i++)
+    bundle->data[i] = cos(0.1 * (double)i) + 0.001 * (double)i;
+
+  bundle->shape[0] = NX;
+  bundle->shape[1] = NY;
+  bundle->shape[2] = NZ;
+
+  zfp_stream* stream = zfp_stream_open(NULL);
+  zfp_stream_set_reversible(stream);
+  bundle->codec = zfp_chunk_codec_create(stream, zfp_type_double);
+  zfp_stream_close(stream);
+  assert_non_null(bundle->codec);
+
+  bundle->bufferSize = zfp_chunk_codec_maximum_size(bundle->codec, 3, bundle->shape);
+  assert_int_not_equal(bundle->bufferSize, 0);
+  bundle->buffer = calloc(bundle->bufferSize, 1);
+  assert_non_null(bundle->buffer);
+
+  *state = bundle;
+
+  return 0;
+}
+
+static int
+teardown(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  zfp_chunk_codec_free(bundle->codec);
+  free(bundle->buffer);
+  free(bundle->decoded);
+  free(bundle->data);
+  free(bundle);
+
+  return 0;
+}
+
+static void
+given_invalidMode_when_zfpChunkCodecCreate_expect_returnsNull(void **state)
+{
+  zfp_stream* stream = zfp_stream_open(NULL);
+  stream->minbits = 2;
+  stream->maxbits = 1;
+
+  assert_null(zfp_chunk_codec_create(stream, zfp_type_double));
+  zfp_stream_set_reversible(stream);
+  assert_null(zfp_chunk_codec_create(stream, zfp_type_none));
+
+  zfp_stream_close(stream);
+}
+
+static void
+given_chunkCodec_when_zfpEncodeChunk_then_zfpDecodeChunk_expect_chunkReconstructed(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  size_t size = zfp_encode_chunk(bundle->codec, bundle->data, 3, bundle->shape, NULL, bundle->buffer, bundle->bufferSize);
+  assert_int_not_equal(size, 0);
+  assert_true(size <= bundle->bufferSize);
+
+  assert_int_equal(zfp_decode_chunk(bundle->codec, bundle->buffer, size, bundle->decoded, 3, bundle->shape, NULL), size);
+  assert_memory_equal(bundle->decoded, bundle->data, CHUNK_SIZE * sizeof(double));
+
+  /* codec is reusable for further chunks */
+  memset(bundle->decoded, 0, CHUNK_SIZE * sizeof(double));
+  assert_int_equal(zfp_encode_chunk(bundle->codec, bundle->data, 3, bundle->shape, NULL, bundle->buffer, bundle->bufferSize), size);
+  assert_int_equal(zfp_decode_chunk(bundle->codec, bundle->buffer, size, bundle->decoded, 3, bundle->shape, NULL), size);
+  assert_memory_equal(bundle->decoded, bundle->data, CHUNK_SIZE * sizeof(double));
+}
+
+static void
+given_transposedChunk_when_zfpEncodeChunkWithStrides_expect_sameAsContiguous(void **state)
+{
+  struct setupVars *bundle = *state;
+  double* transposed = malloc(CHUNK_SIZE * sizeof(double));
+  void* reference = calloc(bundle->bufferSize, 1);
+  assert_non_null(transposed);
+  assert_non_null(reference);
+
+  /* store chunk with x varying slowest */
+  size_t x, y, z;
+  for (z = 0; z < NZ; z++)
+    for (y = 0; y < NY; y++)
+      for (x = 0; x < NX; x++)
+        transposed[z + NZ * (y + NY * x)] = bundle->data[x + NX * (y + NY * z)];
+  ptrdiff_t strides[3] = { NY * NZ, NZ, 1 };
+
+  size_t size = zfp_encode_chunk(bundle->codec, bundle->data, 3, bundle->shape, NULL, reference, bundle->bufferSize);
+  assert_int_equal(zfp_encode_chunk(bundle->codec, transposed, 3, bundle->shape, strides, bundle->buffer, bundle->bufferSize), size);
+  assert_memory_equal(bundle->buffer, reference, size);
+
+  memset(transposed, 0, CHUNK_SIZE * sizeof(double));
+  assert_int_equal(zfp_decode_chunk(bundle->codec, bundle->buffer, size, transposed, 3, bundle->shape, strides), size);
+  for (z = 0; z < NZ; z++)
+    for (y = 0; y < NY; y++)
+      for (x = 0; x < NX; x++)
+        assert_true(transposed[z + NZ * (y + NY * x)] == bundle->data[x + NX * (y + NY * z)]);
+
+  free(reference);
+  free(transposed);
+}
+
+static void
+given_smallBuffer_when_zfpEncodeChunk_expect_returnsZero(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  assert_int_equal(zfp_encode_chunk(bundle->codec, bundle->data, 3, bundle->shape, NULL, bundle->buffer, bundle->bufferSize - 1), 0);
+}
+
+static void
+given_mismatchedShape_when_zfpDecodeChunk_expect_returnsZero(void **state)
+{
+  struct setupVars *bundle = *state;
+  size_t shape[3] = { NY, NX, NZ };
+
+  size_t size = zfp_encode_chunk(bundle->codec, bundle->data, 3, bundle->shape, NULL, bundle->buffer, bundle->bufferSize);
+  assert_int_not_equal(size, 0);
+
+  assert_int_equal(zfp_decode_chunk(bundle->codec, bundle->buffer, size, bundle->decoded, 3, shape, NULL), 0);
+  assert_int_equal(zfp_decode_chunk(bundle->codec, bundle->buffer, size, bundle->decoded, 2, bundle->shape, NULL), 0);
+  assert_int_equal(zfp_decode_chunk(bundle->codec, bundle->buffer, ZFP_CHUNK_HEADER_BITS / 8 - 1, bundle->decoded, 3, bundle->shape, NULL), 0);
+}
+
+int main()
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test(given_invalidMode_when_zfpChunkCodecCreate_expect_returnsNull),
+    cmocka_unit_test_setup_teardown(given_chunkCodec_when_zfpEncodeChunk_then_zfpDecodeChunk_expect_chunkReconstructed, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_transposedChunk_when_zfpEncodeChunkWithStrides_expect_sameAsContiguous, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_smallBuffer_when_zfpEncodeChunk_expect_returnsZero, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_mismatchedShape_when_zfpDecodeChunk_expect_returnsZero, setup, teardown),
+  };
+
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,234 @@
+#include "zfp.h"
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* fields of 1-4 dimensions with partial blocks along each dimension */
+#define FIELD_SIZE 4200
+#define CHUNK 64
+
+static const size_t extent[4][4] = {
+  { 4190, 0, 0, 0 },
+  { 70, 59, 0, 0 },
+  { 17, 15, 16, 0 },
+  { 9, 10, 7, 6 },
+};
+
+struct setupVars {
+  void* data;
+  void* decompressed;
+  void* buffer;
+  size_t bufferSize;
+  zfp_stream* stream;
+  bitstream* s;
+};
+
+static int
+setup(void **state)
+{
+  struct setupVars *bundle = malloc(sizeof(struct setupVars));
+  assert_non_null(bundle);
+
+  bundle->data = malloc(FIELD_SIZE * sizeof(double));
+  bundle->decompressed = malloc(FIELD_SIZE * sizeof(double));
+  assert_non_null(bundle->data);
+  assert_non_null(bundle->decompressed);
+
+  bundle->stream = zfp_stream_open(NULL);
+  bundle->bufferSize = FIELD_SIZE * sizeof(double) + 0x1000;
+  bundle->buffer = calloc(bundle->bufferSize, 1);
+  assert_non_null(bundle->buffer);
+  bundle->s = stream_open(bundle->buffer, bundle->bufferSize);
+  zfp_stream_set_bit_stream(bundle->stream, bundle->s);
+
+  *state = bundle;
+
+  return 0;
+}
+
+static int
+teardown(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  zfp_stream_close(bundle->stream);
+  stream_close(bundle->s);
+  free(bundle->buffer);
+  free(bundle->decompressed);
+  free(bundle->data);
+  free(bundle);
+
+  return 0;
+}
+
+/* mostly smooth values with a localized feature of high complexity */
+static zfp_field*
+initField(struct setupVars *bundle, zfp_type type, uint dims)
+{
+  const size_t* n = extent[dims - 1];
+  size_t i;
+  uint64 u = 1;
+  zfp_field* field;
+
+  for (i = 0; i < FIELD_SIZE; i++) {
+    double x = 1e3 * sin(0.003 * (double)i);
+    u = u * 6364136223846793005ull + 1442695040888963407ull;
+    if (i % 1000 < 100)
+      x += (double)(int32)(u >> 32) * 1e-6;
+    switch (type) {
+      case zfp_type_int32:
+        ((int32*)bundle->data)[i] = (int32)(x * 0x10000);
+        break;
+      case zfp_type_int64:
+        ((int64*)bundle->data)[i] = (int64)(x * 0x10000) * 0x10000;
+        break;
+      case zfp_type_float:
+        ((float*)bundle->data)[i] = (float)x;
+        break;
+      case zfp_type_double:
+        ((double*)bundle->data)[i] = x;
+        break;
+      default:
+        break;
+    }
+  }
+
+  switch (dims) {
+    case 1:
+      field = zfp_field_1d(bundle->data, type, n[0]);
+      break;
+    case 2:
+      field = zfp_field_2d(bundle->data, type, n[0], n[1]);
+      break;
+    case 3:
+      field = zfp_field_3d(bundle->data, type, n[0], n[1], n[2]);
+      break;
+    default:
+      field = zfp_field_4d(bundle->data, type, n[0], n[1], n[2], n[3]);
+      break;
+  }
+  assert_non_null(field);
+
+  return field;
+}
+
+/* sum of squared differences between original and decompressed values */
+static double
+squaredError(const struct setupVars *bundle, zfp_type type, size_t n)
+{
+  double e = 0;
+  size_t i;
+  for (i = 0; i < n; i++) {
+    double d;
+    switch (type) {
+      case zfp_type_int32:
+        d = (double)((const int32*)bundle->data)[i] - (double)((const int32*)bundle->decompressed)[i];
+        break;
+      case zfp_type_int64:
+        d = (double)((const int64*)bundle->data)[i] - (double)((const int64*)bundle->decompressed)[i];
+        break;
+      case zfp_type_float:
+        d = (double)((const float*)bundle->data)[i] - (double)((const float*)bundle->decompressed)[i];
+        break;
+      default:
+        d = ((const double*)bundle->data)[i] - ((const double*)bundle->decompressed)[i];
+        break;
+    }
+    e += d * d;
+  }
+  return e;
+}
+
+/* compress field in fixed-rate and chunk-rate modes; return ratio of errors */
+static double
+errorRatio(struct setupVars *bundle, zfp_type type, uint dims, double rate)
+{
+  zfp_stream* stream = bundle->stream;
+  zfp_field* field = initField(bundle, type, dims);
+  size_t n = zfp_field_size(field, NULL);
+  size_t blocks = 1;
+  size_t chunks, size, bits;
+  double fixed, chunked;
+  uint i;
+
+  for (i = 0; i < dims; i++)
+    blocks *= (extent[dims - 1][i] + 3) / 4;
+  chunks = (blocks + CHUNK - 1) / CHUNK;
+  bits = (size_t)(zfp_stream_set_rate(stream, rate, type, dims, zfp_false) * (1u << (2 * dims)));
+
+  /* reference fixed-rate error */
+  zfp_stream_rewind(stream);
+  assert_int_not_equal(zfp_compress(stream, field), 0);
+  zfp_stream_rewind(stream);
+  zfp_field_set_pointer(field, bundle->decompressed);
+  assert_int_not_equal(zfp_decompress(stream, field), 0);
+  fixed = squaredError(bundle, type, n);
+
+  /* every chunk, including the last, has the same size */
+  zfp_stream_rewind(stream);
+  zfp_field_set_pointer(field, bundle->data);
+  size = zfp_compress_chunk_rate(stream, field, CHUNK);
+  assert_int_equal(size, (chunks * CHUNK * bits + 63) / 64 * 8);
+  zfp_stream_rewind(stream);
+  zfp_field_set_pointer(field, bundle->decompressed);
+  assert_int_equal(zfp_decompress_chunk_rate(stream, field, CHUNK), size);
+  chunked = squaredError(bundle, type, n);
+
+  zfp_field_free(field);
+
+  return fixed > 0 ? chunked / fixed : chunked;
+}
+
+static void
+given_fixedRate_when_zfpCompressChunkRate_expect_lowerErrorThanFixedRate(void **state)
+{
+  struct setupVars *bundle = *state;
+  static const zfp_type types[] = { zfp_type_int32, zfp_type_int64, zfp_type_float, zfp_type_double };
+  uint t, dims;
+
+  for (t = 0; t < 4; t++)
+    for (dims = 1; dims <= 4; dims++)
+      assert_true(errorRatio(bundle, types[t], dims, 8) < 1);
+}
+
+static void
+given_lowRate_when_zfpCompressChunkRate_expect_chunksOfFixedSize(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  /* not even the block exponents fit, so trailing blocks are truncated */
+  errorRatio(bundle, zfp_type_double, 1, 1);
+  errorRatio(bundle, zfp_type_float, 3, 0.25);
+}
+
+static void
+given_invalidArguments_when_zfpCompressChunkRate_expect_returnsZero(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_field* field = initField(bundle, zfp_type_float, 2);
+
+  zfp_stream_set_precision(bundle->stream, 16);
+  assert_int_equal(zfp_compress_chunk_rate(bundle->stream, field, CHUNK), 0);
+  zfp_stream_set_rate(bundle->stream, 8, zfp_type_float, 2, zfp_false);
+  assert_int_equal(zfp_compress_chunk_rate(bundle->stream, field, 0), 0);
+  assert_int_equal(zfp_decompress_chunk_rate(bundle->stream, field, 0), 0);
+
+  zfp_field_free(field);
+}
+
+int main()
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test_setup_teardown(given_fixedRate_when_zfpCompressChunkRate_expect_lowerErrorThanFixedRate, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_lowRate_when_zfpCompressChunkRate_expect_chunksOfFixedSize, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_invalidArguments_when_zfpCompressChunkRate_expect_returnsZero, setup, teardown),
+  };
+
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
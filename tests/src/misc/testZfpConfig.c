@@ -0,0 +1,156 @@
+#include "zfp.h"
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NX 37
+#define NY 23
+#define FIELD_SIZE (NX * NY)
+
+struct setupVars {
+  double data[FIELD_SIZE];
+  double decompressed[FIELD_SIZE];
+  zfp_field* field;
+  zfp_stream* stream;
+  void* expected;
+  void* actual;
+  size_t bufferSize;
+  size_t expectedSize;
+};
+
+static int
+setup(void **state)
+{
+  struct setupVars *bundle = calloc(1, sizeof(struct setupVars));
+  assert_non_null(bundle);
+
+  size_t i;
+  for (i = 0; i < FIELD_SIZE; i++)
+    bundle->data[i] = sin(0.05 * (double)i) * cos(0.3 * (double)(i % NX));
+  bundle->field = zfp_field_2d(bundle->data, zfp_type_double, NX, NY);
+
+  /* reference stream compressed the usual way */
+  bundle->stream = zfp_stream_open(NULL);
+  zfp_stream_set_accuracy(bundle->stream, 1e-4);
+  bundle->bufferSize = zfp_stream_maximum_size(bundle->stream, bundle->field);
+  bundle->expected = calloc(bundle->bufferSize, 1);
+  bundle->actual = calloc(bundle->bufferSize, 1);
+  assert_non_null(bundle->expected);
+  assert_non_null(bundle->actual);
+  bitstream* s = stream_open(bundle->expected, bundle->bufferSize);
+  zfp_stream_set_bit_stream(bundle->stream, s);
+  bundle->expectedSize = zfp_compress(bundle->stream, bundle->field);
+  assert_int_not_equal(bundle->expectedSize, 0);
+  zfp_stream_set_bit_stream(bundle->stream, NULL);
+  stream_close(s);
+
+  *state = bundle;
+
+  return 0;
+}
+
+static int
+teardown(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  zfp_field_free(bundle->field);
+  zfp_stream_close(bundle->stream);
+  free(bundle->expected);
+  free(bundle->actual);
+  free(bundle);
+
+  return 0;
+}
+
+static void
+given_config_when_zfpConfigCompress_expect_sameStreamAsZfpCompress(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_config* config = zfp_config_create(bundle->stream);
+  assert_non_null(config);
+
+  /* later changes to the stream do not affect the configuration */
+  zfp_stream_set_rate(bundle->stream, 4, zfp_type_double, 2, zfp_false);
+
+  assert_int_equal(zfp_config_maximum_size(config, bundle->field), bundle->bufferSize);
+  assert_int_equal(zfp_config_compress(config, bundle->field, bundle->actual, bundle->bufferSize), bundle->expectedSize);
+  assert_memory_equal(bundle->actual, bundle->expected, bundle->expectedSize);
+
+  zfp_field_set_pointer(bundle->field, bundle->decompressed);
+  assert_int_equal(zfp_config_decompress(config, bundle->field, bundle->actual, bundle->expectedSize), bundle->expectedSize);
+  size_t i;
+  for (i = 0; i < FIELD_SIZE; i++)
+    assert_true(fabs(bundle->decompressed[i] - bundle->data[i]) <= 1e-4);
+
+  zfp_config_free(config);
+}
+
+static void
+given_config_when_zfpStreamInitConfig_expect_perCallStreamWithConfigParameters(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_config* config = zfp_config_create(bundle->stream);
+  assert_non_null(config);
+
+  stream_storage storage;
+  zfp_stream zfp;
+  zfp_stream_init_config(&zfp, config, stream_init(&storage, bundle->actual, bundle->bufferSize));
+  assert_int_equal(zfp_stream_compression_mode(&zfp), zfp_mode_fixed_accuracy);
+  assert_int_equal(zfp_stream_mode(&zfp), zfp_stream_mode(bundle->stream));
+  assert_int_equal(zfp_compress(&zfp, bundle->field), bundle->expectedSize);
+  assert_memory_equal(bundle->actual, bundle->expected, bundle->expectedSize);
+  zfp_stream_release(&zfp);
+
+  zfp_config_free(config);
+}
+
+static void
+given_configWithOpenMP_when_zfpConfigCompress_expect_sameStreamAsSerial(void **state)
+{
+  struct setupVars *bundle = *state;
+  double time[64];
+
+  if (!zfp_stream_set_execution(bundle->stream, zfp_exec_omp))
+    skip();
+  zfp_stream_set_omp_thread_time(bundle->stream, time);
+  zfp_config* config = zfp_config_create(bundle->stream);
+  assert_non_null(config);
+
+  assert_int_equal(zfp_config_compress(config, bundle->field, bundle->actual, bundle->bufferSize), bundle->expectedSize);
+  assert_memory_equal(bundle->actual, bundle->expected, bundle->expectedSize);
+
+  zfp_config_free(config);
+}
+
+static void
+given_smallBufferOrInvalidMode_when_zfpConfig_expect_failure(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_config* config = zfp_config_create(bundle->stream);
+  assert_non_null(config);
+
+  assert_int_equal(zfp_config_compress(config, bundle->field, bundle->actual, bundle->bufferSize - 8), 0);
+  zfp_config_free(config);
+
+  bundle->stream->maxprec = 0;
+  assert_null(zfp_config_create(bundle->stream));
+}
+
+int main()
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test_setup_teardown(given_config_when_zfpConfigCompress_expect_sameStreamAsZfpCompress, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_config_when_zfpStreamInitConfig_expect_perCallStreamWithConfigParameters, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_configWithOpenMP_when_zfpConfigCompress_expect_sameStreamAsSerial, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_smallBufferOrInvalidMode_when_zfpConfig_expect_failure, setup, teardown),
+  };
+
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
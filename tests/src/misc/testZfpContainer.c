@@ -0,0 +1,340 @@
+#include "zfp.h"
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NX 20
+#define NY 24
+#define NZ 12
+#define FIELD_SIZE (NX * NY * NZ)
+#define INT_SIZE 1000
+#define ALIGNMENT 4096
+
+struct setupVars {
+  double* data;
+  int32* ints;
+  void* copy;
+  size_t size;
+  zfp_stream* stream;
+  zfp_field* field;
+  zfp_field* intField;
+};
+
+/* write container of one lossy and one reversible field; keep copy of its data */
+static int
+setup(void **state)
+{
+  struct setupVars *bundle = malloc(sizeof(struct setupVars));
+  assert_non_null(bundle);
+
+  bundle->data = malloc(FIELD_SIZE * sizeof(double));
+  bundle->ints = malloc(INT_SIZE * sizeof(int32));
+  assert_non_null(bundle->data);
+  assert_non_null(bundle->ints);
+
+  size_t i;
+  for (i = 0; i < FIELD_SIZE; i++)
+    bundle->data[i] = sin(0.01 * (double)i);
+  for (i = 0; i < INT_SIZE; i++)
+    bundle->ints[i] = (int32)(i * i) - 5000;
+
+  bundle->stream = zfp_stream_open(NULL);
+  bundle->field = zfp_field_3d(bundle->data, zfp_type_double, NX, NY, NZ);
+  bundle->intField = zfp_field_1d(bundle->ints, zfp_type_int32, INT_SIZE);
+
+  zfp_container* c = zfp_container_create(ALIGNMENT);
+  assert_non_null(c);
+
+  zfp_stream_set_accuracy(bundle->stream, 1e-6);
+  assert_true(zfp_container_add(c, "pressure", bundle->stream, bundle->field));
+  zfp_stream_set_reversible(bundle->stream);
+  assert_true(zfp_container_add(c, "ids", bundle->stream, bundle->intField));
+
+  const void* data = zfp_container_finish(c, &bundle->size);
+  assert_non_null(data);
+  bundle->copy = malloc(bundle->size);
+  assert_non_null(bundle->copy);
+  memcpy(bundle->copy, data, bundle->size);
+  zfp_container_close(c);
+
+  *state = bundle;
+
+  return 0;
+}
+
+static int
+teardown(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  zfp_field_free(bundle->field);
+  zfp_field_free(bundle->intField);
+  zfp_stream_close(bundle->stream);
+  free(bundle->copy);
+  free(bundle->ints);
+  free(bundle->data);
+  free(bundle);
+
+  return 0;
+}
+
+static void
+given_container_when_zfpContainerAddDuplicateName_expect_returnsFalse(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_container* c = zfp_container_create(0);
+  assert_non_null(c);
+
+  zfp_stream_set_reversible(bundle->stream);
+  assert_true(zfp_container_add(c, "ids", bundle->stream, bundle->intField));
+  assert_false(zfp_container_add(c, "ids", bundle->stream, bundle->intField));
+  assert_int_equal(zfp_container_fields(c), 1);
+
+  /* no fields may be added once finished */
+  assert_non_null(zfp_container_finish(c, NULL));
+  assert_false(zfp_container_add(c, "more", bundle->stream, bundle->intField));
+
+  zfp_container_close(c);
+}
+
+static void
+given_nonPowerOfTwoAlignment_when_zfpContainerCreate_expect_returnsNull(void **state)
+{
+  assert_null(zfp_container_create(3000));
+}
+
+static void
+given_writtenContainer_when_zfpContainerOpen_expect_indexRestored(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_container* c = zfp_container_open(bundle->copy, bundle->size);
+  assert_non_null(c);
+
+  assert_int_equal(zfp_container_fields(c), 2);
+  assert_int_equal(zfp_container_find(c, "pressure"), 0);
+  assert_int_equal(zfp_container_find(c, "ids"), 1);
+  assert_int_equal(zfp_container_find(c, "missing"), 2);
+  assert_string_equal(zfp_container_name(c, 1), "ids");
+  assert_int_equal(zfp_container_chunks(c, 0), 1);
+  assert_true(zfp_container_size(c, 0) > 0);
+
+  zfp_field* field = zfp_field_alloc();
+  assert_true(zfp_container_field(c, 0, field));
+  assert_int_equal(zfp_field_type(field), zfp_type_double);
+  assert_int_equal(zfp_field_dimensionality(field), 3);
+  assert_int_equal(zfp_field_size(field, NULL), FIELD_SIZE);
+
+  zfp_field_free(field);
+  zfp_container_close(c);
+}
+
+static void
+given_writtenContainer_when_zfpContainerDecompress_expect_fieldsReconstructed(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_container* c = zfp_container_open(bundle->copy, bundle->size);
+  assert_non_null(c);
+
+  double* data = malloc(FIELD_SIZE * sizeof(double));
+  int32* ints = malloc(INT_SIZE * sizeof(int32));
+  assert_non_null(data);
+  assert_non_null(ints);
+
+  zfp_field* field = zfp_field_alloc();
+  assert_true(zfp_container_field(c, 0, field));
+  zfp_field_set_pointer(field, data);
+  assert_int_equal(zfp_container_decompress(c, 0, bundle->stream, field), zfp_container_size(c, 0));
+  size_t i;
+  for (i = 0; i < FIELD_SIZE; i++)
+    assert_true(fabs(data[i] - bundle->data[i]) <= 1e-6);
+
+  /* field of wrong type or dimensions is rejected */
+  assert_int_equal(zfp_container_decompress(c, 1, bundle->stream, field), 0);
+
+  assert_true(zfp_container_field(c, 1, field));
+  zfp_field_set_pointer(field, ints);
+  assert_int_not_equal(zfp_container_decompress(c, 1, bundle->stream, field), 0);
+  assert_memory_equal(ints, bundle->ints, INT_SIZE * sizeof(int32));
+
+  zfp_field_free(field);
+  free(ints);
+  free(data);
+  zfp_container_close(c);
+}
+
+static void
+given_writtenContainer_when_zfpContainerDecompressSubset_expect_boxMatchesField(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_container* c = zfp_container_open(bundle->copy, bundle->size);
+  assert_non_null(c);
+
+  double* data = malloc(FIELD_SIZE * sizeof(double));
+  double box[3 * 5 * 7];
+  assert_non_null(data);
+
+  zfp_field* field = zfp_field_alloc();
+  assert_true(zfp_container_field(c, 0, field));
+  zfp_field_set_pointer(field, data);
+  assert_int_not_equal(zfp_container_decompress(c, 0, bundle->stream, field), 0);
+  zfp_field_set_pointer(field, box);
+  assert_int_not_equal(zfp_container_decompress_subset(c, 0, bundle->stream, field, 2, 9, 4, 3, 5, 7), 0);
+
+  size_t x, y, z;
+  for (z = 0; z < 7; z++)
+    for (y = 0; y < 5; y++)
+      for (x = 0; x < 3; x++)
+        assert_true(box[x + 3 * (y + 5 * z)] == data[(2 + x) + NX * ((9 + y) + NY * (4 + z))]);
+
+  zfp_field_free(field);
+  free(data);
+  zfp_container_close(c);
+}
+
+static void
+given_entropyCodedChunks_when_zfpContainerDecompress_expect_smallerAndExact(void **state)
+{
+  struct setupVars *bundle = *state;
+  double* data = malloc(FIELD_SIZE * sizeof(double));
+  assert_non_null(data);
+  size_t plain;
+
+  /* reversible field in several chunks when compressed in parallel */
+  zfp_stream_set_reversible(bundle->stream);
+  if (zfp_stream_set_execution(bundle->stream, zfp_exec_omp))
+    zfp_stream_set_omp_chunk_size(bundle->stream, 50);
+  zfp_container* c = zfp_container_create(0);
+  assert_non_null(c);
+  assert_true(zfp_container_add(c, "plain", bundle->stream, bundle->field));
+  assert_true(zfp_stream_set_entropy(bundle->stream, zfp_entropy_huffman));
+  assert_int_equal(zfp_stream_entropy(bundle->stream), zfp_entropy_huffman);
+  assert_true(zfp_container_add(c, "coded", bundle->stream, bundle->field));
+  assert_int_equal(zfp_container_entropy(c, 0), zfp_entropy_none);
+  assert_int_equal(zfp_container_entropy(c, 1), zfp_entropy_huffman);
+  assert_int_equal(zfp_container_chunks(c, 1), zfp_container_chunks(c, 0));
+  plain = zfp_container_size(c, 0);
+  assert_true(zfp_container_size(c, 1) < plain);
+
+  /* coded chunks are restored serially or in parallel */
+  size_t size;
+  const void* bytes = zfp_container_finish(c, &size);
+  assert_non_null(bytes);
+  zfp_container* r = zfp_container_open(bytes, size);
+  assert_non_null(r);
+  zfp_field* field = zfp_field_alloc();
+  assert_true(zfp_container_field(r, 1, field));
+  zfp_field_set_pointer(field, data);
+  assert_int_equal(zfp_container_decompress(r, 1, bundle->stream, field), plain);
+  assert_memory_equal(data, bundle->data, FIELD_SIZE * sizeof(double));
+  memset(data, 0, FIELD_SIZE * sizeof(double));
+  zfp_stream_set_execution(bundle->stream, zfp_exec_serial);
+  assert_int_equal(zfp_container_decompress(r, 1, bundle->stream, field), plain);
+  assert_memory_equal(data, bundle->data, FIELD_SIZE * sizeof(double));
+
+  zfp_field_free(field);
+  zfp_container_close(r);
+  zfp_container_close(c);
+  free(data);
+}
+
+static void
+given_invalidEntropyCodedChunk_when_zfpContainerDecompress_expect_returnsZero(void **state)
+{
+  struct setupVars *bundle = *state;
+  double* data = malloc(FIELD_SIZE * sizeof(double));
+  assert_non_null(data);
+
+  zfp_stream_set_entropy(bundle->stream, zfp_entropy_huffman);
+  zfp_container* c = zfp_container_create(0);
+  assert_non_null(c);
+  assert_true(zfp_container_add(c, "coded", bundle->stream, bundle->field));
+  size_t size;
+  const void* bytes = zfp_container_finish(c, &size);
+  assert_non_null(bytes);
+
+  /* unknown coding method of first chunk */
+  unsigned char* copy = malloc(size);
+  assert_non_null(copy);
+  memcpy(copy, bytes, size);
+  copy[16] = 0xff;
+  zfp_container* r = zfp_container_open(copy, size);
+  assert_non_null(r);
+  zfp_field* field = zfp_field_alloc();
+  assert_true(zfp_container_field(r, 0, field));
+  zfp_field_set_pointer(field, data);
+  assert_int_equal(zfp_container_decompress(r, 0, bundle->stream, field), 0);
+
+  zfp_field_free(field);
+  zfp_container_close(r);
+  zfp_container_close(c);
+  free(copy);
+  free(data);
+}
+
+static void
+given_truncatedContainer_when_zfpContainerOpen_expect_returnsNull(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  assert_null(zfp_container_open(bundle->copy, bundle->size - 1));
+  assert_null(zfp_container_open(bundle->copy, 16));
+}
+
+/* little-endian 64-bit integer at p */
+static uint64
+get_uint64(const unsigned char* p)
+{
+  uint64 value = 0;
+  uint i;
+  for (i = 8; i--;)
+    value = (value << 8) + p[i];
+  return value;
+}
+
+static void
+put_uint64(unsigned char* p, uint64 value)
+{
+  uint i;
+  for (i = 0; i < 8; i++, value >>= 8)
+    p[i] = (unsigned char)value;
+}
+
+static void
+given_oversizedEntryNameLength_when_zfpContainerOpen_expect_returnsNull(void **state)
+{
+  struct setupVars *bundle = *state;
+  unsigned char* bytes = bundle->copy;
+  /* footer offset is first word of trailer; first entry begins with its name length */
+  uint64 offset = get_uint64(bytes + bundle->size - 32);
+
+  /* name length that wraps around to zero when aligned or terminated */
+  put_uint64(bytes + offset, ~(uint64)0);
+  assert_null(zfp_container_open(bundle->copy, bundle->size));
+
+  /* name length extending past the end of the container */
+  put_uint64(bytes + offset, (uint64)bundle->size - offset);
+  assert_null(zfp_container_open(bundle->copy, bundle->size));
+}
+
+int main()
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test_setup_teardown(given_container_when_zfpContainerAddDuplicateName_expect_returnsFalse, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_nonPowerOfTwoAlignment_when_zfpContainerCreate_expect_returnsNull, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_writtenContainer_when_zfpContainerOpen_expect_indexRestored, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_writtenContainer_when_zfpContainerDecompress_expect_fieldsReconstructed, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_writtenContainer_when_zfpContainerDecompressSubset_expect_boxMatchesField, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_entropyCodedChunks_when_zfpContainerDecompress_expect_smallerAndExact, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_invalidEntropyCodedChunk_when_zfpContainerDecompress_expect_returnsZero, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_truncatedContainer_when_zfpContainerOpen_expect_returnsNull, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_oversizedEntryNameLength_when_zfpContainerOpen_expect_returnsNull, setup, teardown),
+  };
+
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
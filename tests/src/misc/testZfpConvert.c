@@ -0,0 +1,185 @@
+#include "zfp.h"
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* 3D field with partial blocks along each dimension */
+#define NX 21
+#define NY 10
+#define NZ 7
+#define FIELD_SIZE (NX * NY * NZ)
+
+struct setupVars {
+  double* data;
+  float* rounded;
+  void* buffer;
+  size_t bufferSize;
+  zfp_field* field;
+  zfp_stream* stream;
+  bitstream* s;
+};
+
+static int
+setup(void **state)
+{
+  struct setupVars *bundle = malloc(sizeof(struct setupVars));
+  assert_non_null(bundle);
+
+  bundle->data = malloc(FIELD_SIZE * sizeof(double));
+  bundle->rounded = malloc(FIELD_SIZE * sizeof(float));
+  assert_non_null(bundle->data);
+  assert_non_null(bundle->rounded);
+
+  size_t i;
+  for (i = 0; i < FIELD_SIZE; i++) {
+    bundle->data[i] = exp(0.01 * (double)(i % NX)) * sin(0.1 * (double)i) + 1e-9 * (double)i;
+    bundle->rounded[i] = (float)bundle->data[i];
+  }
+
+  bundle->field = zfp_field_3d(bundle->data, zfp_type_double, NX, NY, NZ);
+  bundle->stream = zfp_stream_open(NULL);
+  zfp_stream_set_reversible(bundle->stream);
+  bundle->bufferSize = 2 * zfp_stream_maximum_size(bundle->stream, bundle->field);
+  bundle->buffer = calloc(bundle->bufferSize, 1);
+  assert_non_null(bundle->buffer);
+  bundle->s = stream_open(bundle->buffer, bundle->bufferSize);
+  zfp_stream_set_bit_stream(bundle->stream, bundle->s);
+
+  *state = bundle;
+
+  return 0;
+}
+
+static int
+teardown(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  zfp_field_free(bundle->field);
+  zfp_stream_close(bundle->stream);
+  stream_close(bundle->s);
+  free(bundle->buffer);
+  free(bundle->rounded);
+  free(bundle->data);
+  free(bundle);
+
+  return 0;
+}
+
+static void
+given_doubleField_when_zfpCompressAsFloat_expect_streamOfRoundedFloatField(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  size_t size = zfp_compress_as(bundle->stream, bundle->field, zfp_type_float);
+  assert_int_not_equal(size, 0);
+  void* reference = malloc(size);
+  assert_non_null(reference);
+  memcpy(reference, bundle->buffer, size);
+
+  zfp_field* field = zfp_field_3d(bundle->rounded, zfp_type_float, NX, NY, NZ);
+  zfp_stream_rewind(bundle->stream);
+  assert_int_equal(zfp_compress(bundle->stream, field), size);
+  assert_memory_equal(bundle->buffer, reference, size);
+
+  free(reference);
+  zfp_field_free(field);
+}
+
+static void
+given_floatStream_when_zfpDecompressAsDouble_expect_widenedValues(void **state)
+{
+  struct setupVars *bundle = *state;
+  double* decompressed = calloc(FIELD_SIZE, sizeof(double));
+  assert_non_null(decompressed);
+
+  zfp_field* field = zfp_field_3d(bundle->rounded, zfp_type_float, NX, NY, NZ);
+  size_t size = zfp_compress(bundle->stream, field);
+  assert_int_not_equal(size, 0);
+
+  /* decompress into strided double field */
+  zfp_field_set_type(field, zfp_type_double);
+  zfp_field_set_pointer(field, decompressed + FIELD_SIZE - 1);
+  zfp_field_set_stride_3d(field, -1, -NX, -NX * NY);
+  zfp_stream_rewind(bundle->stream);
+  assert_int_equal(zfp_decompress_as(bundle->stream, field, zfp_type_float), size);
+
+  size_t i;
+  for (i = 0; i < FIELD_SIZE; i++)
+    assert_true(decompressed[FIELD_SIZE - 1 - i] == (double)bundle->rounded[i]);
+
+  zfp_field_free(field);
+  free(decompressed);
+}
+
+static void
+given_lossyDoubleStream_when_zfpDecompressAsFloat_expect_roundedDoubleValues(void **state)
+{
+  struct setupVars *bundle = *state;
+  double* wide = malloc(FIELD_SIZE * sizeof(double));
+  float* narrow = malloc(FIELD_SIZE * sizeof(float));
+  assert_non_null(wide);
+  assert_non_null(narrow);
+
+  zfp_stream_set_accuracy(bundle->stream, 1e-6);
+  size_t size = zfp_compress(bundle->stream, bundle->field);
+  assert_int_not_equal(size, 0);
+
+  zfp_field* field = zfp_field_3d(wide, zfp_type_double, NX, NY, NZ);
+  zfp_stream_rewind(bundle->stream);
+  assert_int_equal(zfp_decompress(bundle->stream, field), size);
+
+  /* conversion is the same under parallel decompression, where supported */
+  zfp_field_set_type(field, zfp_type_float);
+  zfp_field_set_pointer(field, narrow);
+  zfp_stream_set_execution(bundle->stream, zfp_exec_omp);
+  zfp_stream_rewind(bundle->stream);
+  assert_int_equal(zfp_decompress_as(bundle->stream, field, zfp_type_double), size);
+
+  size_t i;
+  for (i = 0; i < FIELD_SIZE; i++)
+    assert_true(narrow[i] == (float)wide[i]);
+
+  zfp_field_free(field);
+  free(narrow);
+  free(wide);
+}
+
+static void
+given_incompatibleTypes_when_zfpCompressAs_expect_returnsZero(void **state)
+{
+  struct setupVars *bundle = *state;
+  int32 values[FIELD_SIZE];
+
+  memset(values, 0, sizeof(values));
+  zfp_field* field = zfp_field_3d(values, zfp_type_int32, NX, NY, NZ);
+
+  /* integers do not convert to or from floating point */
+  assert_int_equal(zfp_compress_as(bundle->stream, field, zfp_type_float), 0);
+  assert_int_equal(zfp_decompress_as(bundle->stream, field, zfp_type_int64), 0);
+  assert_int_equal(zfp_compress_as(bundle->stream, bundle->field, zfp_type_int32), 0);
+
+  /* 16-bit floating-point values convert to either precision */
+  zfp_field_set_type(field, zfp_type_half);
+  assert_int_not_equal(zfp_compress_as(bundle->stream, field, zfp_type_double), 0);
+
+  zfp_field_free(field);
+}
+
+int main()
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test_setup_teardown(given_doubleField_when_zfpCompressAsFloat_expect_streamOfRoundedFloatField, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_floatStream_when_zfpDecompressAsDouble_expect_widenedValues, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_lossyDoubleStream_when_zfpDecompressAsFloat_expect_roundedDoubleValues, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_incompatibleTypes_when_zfpCompressAs_expect_returnsZero, setup, teardown),
+  };
+
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
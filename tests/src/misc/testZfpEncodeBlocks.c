@@ -0,0 +1,146 @@
+#include "zfp.h"
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+/* more blocks than are transformed together, and not a multiple thereof */
+#define BLOCKS 37
+#define BLOCK_SIZE 64
+#define FIELD_SIZE (BLOCKS * BLOCK_SIZE)
+
+struct setupVars {
+  double* data;
+  double* expected;
+  double* actual;
+  void* buffer[2];
+  size_t bufferSize;
+  zfp_stream* stream[2];
+};
+
+static int
+setup(void **state)
+{
+  struct setupVars *bundle = malloc(sizeof(struct setupVars));
+  assert_non_null(bundle);
+
+  bundle->data = malloc(FIELD_SIZE * sizeof(double));
+  bundle->expected = malloc(FIELD_SIZE * sizeof(double));
+  bundle->actual = malloc(FIELD_SIZE * sizeof(double));
+  assert_non_null(bundle->data);
+  assert_non_null(bundle->expected);
+  assert_non_null(bundle->actual);
+
+  /* mix smooth, constant, and all-zero blocks */
+  size_t i;
+  for (i = 0; i < FIELD_SIZE; i++)
+    switch ((i / BLOCK_SIZE) % 3) {
+      case 0:
+        bundle->data[i] = (double)(i % 23) * (double)(i % 7) - 0.125 * (double)i;
+        break;
+      case 1:
+        bundle->data[i] = 0.5 * (double)(i / BLOCK_SIZE);
+        break;
+      default:
+        bundle->data[i] = 0;
+        break;
+    }
+
+  bundle->bufferSize = FIELD_SIZE * sizeof(double) * 2;
+  for (i = 0; i < 2; i++) {
+    bundle->buffer[i] = calloc(bundle->bufferSize, 1);
+    assert_non_null(bundle->buffer[i]);
+    bundle->stream[i] = zfp_stream_open(stream_open(bundle->buffer[i], bundle->bufferSize));
+  }
+
+  *state = bundle;
+
+  return 0;
+}
+
+static int
+teardown(void **state)
+{
+  struct setupVars *bundle = *state;
+  size_t i;
+
+  for (i = 0; i < 2; i++) {
+    stream_close(zfp_stream_bit_stream(bundle->stream[i]));
+    zfp_stream_close(bundle->stream[i]);
+    free(bundle->buffer[i]);
+  }
+  free(bundle->actual);
+  free(bundle->expected);
+  free(bundle->data);
+  free(bundle);
+
+  return 0;
+}
+
+/* compare batched (de)compression with one block at a time */
+static void
+assertBlocksMatchSingleBlockCoding(struct setupVars *bundle)
+{
+  zfp_stream* single = bundle->stream[0];
+  zfp_stream* batch = bundle->stream[1];
+  size_t bits = 0;
+  size_t i;
+
+  zfp_stream_set_params(batch, single->minbits, single->maxbits, single->maxprec, single->minexp);
+
+  for (i = 0; i < BLOCKS; i++)
+    bits += zfp_encode_block_double_3(single, bundle->data + BLOCK_SIZE * i);
+  assert_int_equal(zfp_encode_blocks_double_3(batch, BLOCKS, bundle->data), bits);
+  zfp_stream_flush(single);
+  zfp_stream_flush(batch);
+  assert_memory_equal(bundle->buffer[1], bundle->buffer[0], bundle->bufferSize);
+
+  zfp_stream_rewind(single);
+  zfp_stream_rewind(batch);
+  for (i = 0; i < BLOCKS; i++)
+    zfp_decode_block_double_3(single, bundle->expected + BLOCK_SIZE * i);
+  assert_int_equal(zfp_decode_blocks_double_3(batch, BLOCKS, bundle->actual), bits);
+  assert_memory_equal(bundle->actual, bundle->expected, FIELD_SIZE * sizeof(double));
+}
+
+static void
+given_fixedRate_when_zfpEncodeBlocks_expect_matchesSingleBlockCoding(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  zfp_stream_set_rate(bundle->stream[0], 12, zfp_type_double, 3, zfp_false);
+  assertBlocksMatchSingleBlockCoding(bundle);
+}
+
+static void
+given_fixedAccuracy_when_zfpEncodeBlocks_expect_matchesSingleBlockCoding(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  zfp_stream_set_accuracy(bundle->stream[0], 1e-3);
+  assertBlocksMatchSingleBlockCoding(bundle);
+}
+
+static void
+given_reversible_when_zfpEncodeBlocks_expect_matchesSingleBlockCoding(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  zfp_stream_set_reversible(bundle->stream[0]);
+  assertBlocksMatchSingleBlockCoding(bundle);
+}
+
+int main()
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test_setup_teardown(given_fixedRate_when_zfpEncodeBlocks_expect_matchesSingleBlockCoding, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_fixedAccuracy_when_zfpEncodeBlocks_expect_matchesSingleBlockCoding, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_reversible_when_zfpEncodeBlocks_expect_matchesSingleBlockCoding, setup, teardown),
+  };
+
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
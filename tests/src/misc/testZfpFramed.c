@@ -0,0 +1,212 @@
+#include "zfp.h"
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <limits.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NX 21
+#define NY 10
+#define NZ 7
+#define FIELD_SIZE (NX * NY * NZ)
+#define BLOCKS (6 * 3 * 2)
+#define FRAME_BLOCKS 5
+#define MAX_FRAMES ((BLOCKS + FRAME_BLOCKS - 1) / FRAME_BLOCKS)
+
+/* frames collected by sink in the order emitted */
+struct frames {
+  void* data[MAX_FRAMES];
+  size_t size[MAX_FRAMES];
+  size_t count;
+  size_t limit; /* number of frames accepted before aborting */
+};
+
+struct setupVars {
+  double* data;
+  double* expected;
+  double* decompressed;
+  zfp_field* field;
+  zfp_stream* zfp;
+  struct frames frames;
+};
+
+static zfp_bool
+collect(const void* frame, size_t size, void* context)
+{
+  struct frames* frames = (struct frames*)context;
+  if (frames->count == frames->limit)
+    return zfp_false;
+  frames->data[frames->count] = malloc(size);
+  memcpy(frames->data[frames->count], frame, size);
+  frames->size[frames->count] = size;
+  frames->count++;
+  return zfp_true;
+}
+
+static int
+setup(void **state)
+{
+  struct setupVars *bundle = calloc(1, sizeof(struct setupVars));
+  size_t x, y, z;
+  assert_non_null(bundle);
+
+  bundle->data = malloc(FIELD_SIZE * sizeof(double));
+  bundle->expected = calloc(FIELD_SIZE, sizeof(double));
+  bundle->decompressed = calloc(FIELD_SIZE, sizeof(double));
+  assert_non_null(bundle->data);
+  assert_non_null(bundle->expected);
+  assert_non_null(bundle->decompressed);
+
+  for (z = 0; z < NZ; z++)
+    for (y = 0; y < NY; y++)
+      for (x = 0; x < NX; x++)
+        bundle->data[x + NX * (y + NY * z)] = sin(0.3 * x) * cos(0.2 * y) + 0.1 * z * z;
+
+  bundle->field = zfp_field_3d(bundle->data, zfp_type_double, NX, NY, NZ);
+  bundle->zfp = zfp_stream_open(NULL);
+  zfp_stream_set_accuracy(bundle->zfp, 1e-4);
+  bundle->frames.limit = MAX_FRAMES;
+
+  *state = bundle;
+
+  return 0;
+}
+
+static int
+teardown(void **state)
+{
+  struct setupVars *bundle = *state;
+  size_t i;
+
+  for (i = 0; i < bundle->frames.count; i++)
+    free(bundle->frames.data[i]);
+  zfp_stream_close(bundle->zfp);
+  zfp_field_free(bundle->field);
+  free(bundle->data);
+  free(bundle->expected);
+  free(bundle->decompressed);
+  free(bundle);
+
+  return 0;
+}
+
+/* decompress field with zfp_decompress for reference */
+static void
+decompress_reference(struct setupVars *bundle)
+{
+  size_t size = zfp_stream_maximum_size(bundle->zfp, bundle->field);
+  void* buffer = malloc(size);
+  bitstream* stream = stream_open(buffer, size);
+  zfp_field* field = zfp_field_3d(bundle->expected, zfp_type_double, NX, NY, NZ);
+
+  zfp_stream_set_bit_stream(bundle->zfp, stream);
+  zfp_stream_rewind(bundle->zfp);
+  assert_true(zfp_compress(bundle->zfp, bundle->field) != 0);
+  zfp_stream_rewind(bundle->zfp);
+  assert_true(zfp_decompress(bundle->zfp, field) != 0);
+  zfp_stream_set_bit_stream(bundle->zfp, NULL);
+
+  zfp_field_free(field);
+  stream_close(stream);
+  free(buffer);
+}
+
+static void
+given_field_when_framesDecodedInReverseOrder_expect_matchesZfpDecompress(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_field* output = zfp_field_3d(bundle->decompressed, zfp_type_double, NX, NY, NZ);
+  size_t bytes = zfp_compress_framed(bundle->zfp, bundle->field, FRAME_BLOCKS, collect, &bundle->frames);
+  size_t blocks = 0;
+  size_t i;
+
+  assert_int_equal(bundle->frames.count, MAX_FRAMES);
+  for (i = 0; i < bundle->frames.count; i++) {
+    bytes -= bundle->frames.size[i];
+    assert_true(bundle->frames.size[i] <= zfp_frame_maximum_size(bundle->zfp, bundle->field, FRAME_BLOCKS));
+  }
+  /* return value sums frame sizes */
+  assert_int_equal(bytes, 0);
+
+  for (i = bundle->frames.count; i-- > 0;) {
+    uint sequence = UINT_MAX;
+    size_t n = zfp_decompress_frame(bundle->zfp, output, bundle->frames.data[i], bundle->frames.size[i], &sequence);
+    assert_int_equal(n, i + 1 < bundle->frames.count ? FRAME_BLOCKS : BLOCKS - i * FRAME_BLOCKS);
+    assert_int_equal(sequence, i);
+    blocks += n;
+  }
+  assert_int_equal(blocks, BLOCKS);
+
+  decompress_reference(bundle);
+  assert_memory_equal(bundle->decompressed, bundle->expected, FIELD_SIZE * sizeof(double));
+
+  zfp_field_free(output);
+}
+
+static void
+given_reversibleMode_when_framesDecoded_expect_exactReconstruction(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_field* output = zfp_field_3d(bundle->decompressed, zfp_type_double, NX, NY, NZ);
+  size_t i;
+
+  zfp_stream_set_reversible(bundle->zfp);
+  assert_true(zfp_compress_framed(bundle->zfp, bundle->field, FRAME_BLOCKS, collect, &bundle->frames) != 0);
+  for (i = 0; i < bundle->frames.count; i++)
+    assert_true(zfp_decompress_frame(bundle->zfp, output, bundle->frames.data[i], bundle->frames.size[i], NULL) != 0);
+  assert_memory_equal(bundle->decompressed, bundle->data, FIELD_SIZE * sizeof(double));
+
+  zfp_field_free(output);
+}
+
+static void
+given_sinkReturnsFalse_when_compressFramed_expect_abortedAfterRejectedFrame(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  bundle->frames.limit = 2;
+  assert_int_equal(zfp_compress_framed(bundle->zfp, bundle->field, FRAME_BLOCKS, collect, &bundle->frames), 0);
+  assert_int_equal(bundle->frames.count, 2);
+}
+
+static void
+given_damagedFrame_when_decompressFrame_expect_rejected(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_field* output = zfp_field_3d(bundle->decompressed, zfp_type_double, NX, NY, NZ);
+  zfp_field* small = zfp_field_3d(bundle->decompressed, zfp_type_double, 4, 4, 4);
+  size_t last;
+
+  zfp_stream_set_rate(bundle->zfp, 16, zfp_type_double, 3, zfp_false);
+  assert_true(zfp_compress_framed(bundle->zfp, bundle->field, FRAME_BLOCKS, collect, &bundle->frames) != 0);
+  last = bundle->frames.count - 1;
+
+  /* truncated frame */
+  assert_int_equal(zfp_decompress_frame(bundle->zfp, output, bundle->frames.data[0], bundle->frames.size[0] - 8, NULL), 0);
+  /* frame whose blocks lie outside field */
+  assert_int_equal(zfp_decompress_frame(bundle->zfp, small, bundle->frames.data[last], bundle->frames.size[last], NULL), 0);
+  /* frame shorter than its header */
+  assert_int_equal(zfp_decompress_frame(bundle->zfp, output, bundle->frames.data[0], 8, NULL), 0);
+  /* zero blocks per frame */
+  assert_int_equal(zfp_frame_maximum_size(bundle->zfp, bundle->field, 0), 0);
+
+  zfp_field_free(small);
+  zfp_field_free(output);
+}
+
+int main()
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test_setup_teardown(given_field_when_framesDecodedInReverseOrder_expect_matchesZfpDecompress, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_reversibleMode_when_framesDecoded_expect_exactReconstruction, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_sinkReturnsFalse_when_compressFramed_expect_abortedAfterRejectedFrame, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_damagedFrame_when_decompressFrame_expect_rejected, setup, teardown),
+  };
+
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
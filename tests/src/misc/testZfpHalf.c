@@ -0,0 +1,255 @@
+#include "zfp.h"
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* 2D field holding every 16-bit pattern, with partial blocks along y */
+#define NX 256
+#define NY 255
+#define FIELD_SIZE (NX * NY)
+
+struct setupVars {
+  uint16* data;
+  uint16* decompressed;
+  void* buffer;
+  size_t bufferSize;
+  zfp_field* field;
+  zfp_stream* stream;
+  bitstream* s;
+};
+
+/* true if 16-bit pattern is a half-precision NaN */
+static int
+is_half_nan(uint16 h)
+{
+  return (h & 0x7c00u) == 0x7c00u && (h & 0x3ffu);
+}
+
+static int
+setup(void **state)
+{
+  struct setupVars *bundle = malloc(sizeof(struct setupVars));
+  assert_non_null(bundle);
+
+  bundle->data = malloc(FIELD_SIZE * sizeof(uint16));
+  bundle->decompressed = calloc(FIELD_SIZE, sizeof(uint16));
+  assert_non_null(bundle->data);
+  assert_non_null(bundle->decompressed);
+
+  /* NaN payloads need not survive conversion, so replace NaNs with zeros */
+  size_t i;
+  for (i = 0; i < FIELD_SIZE; i++) {
+    uint16 h = (uint16)(i * 40503u);
+    bundle->data[i] = is_half_nan(h) ? 0 : h;
+  }
+
+  bundle->field = zfp_field_2d(bundle->data, zfp_type_half, NX, NY);
+  bundle->stream = zfp_stream_open(NULL);
+  zfp_stream_set_reversible(bundle->stream);
+  bundle->bufferSize = zfp_stream_maximum_size(bundle->stream, bundle->field);
+  bundle->buffer = calloc(bundle->bufferSize, 1);
+  assert_non_null(bundle->buffer);
+  bundle->s = stream_open(bundle->buffer, bundle->bufferSize);
+  zfp_stream_set_bit_stream(bundle->stream, bundle->s);
+
+  *state = bundle;
+
+  return 0;
+}
+
+static int
+teardown(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  zfp_field_free(bundle->field);
+  zfp_stream_close(bundle->stream);
+  stream_close(bundle->s);
+  free(bundle->buffer);
+  free(bundle->decompressed);
+  free(bundle->data);
+  free(bundle);
+
+  return 0;
+}
+
+/* compress and decompress field, returning compressed size */
+static size_t
+roundTrip(struct setupVars *bundle, zfp_field* field, void* decompressed)
+{
+  void* data = zfp_field_pointer(field);
+  size_t size = zfp_compress(bundle->stream, field);
+  assert_int_not_equal(size, 0);
+
+  zfp_stream_rewind(bundle->stream);
+  zfp_field_set_pointer(field, decompressed);
+  assert_int_equal(zfp_decompress(bundle->stream, field), size);
+  zfp_field_set_pointer(field, data);
+  zfp_stream_rewind(bundle->stream);
+
+  return size;
+}
+
+static void
+given_reversibleHalfField_when_zfpDecompress_expect_exactValues(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  roundTrip(bundle, bundle->field, bundle->decompressed);
+  assert_memory_equal(bundle->decompressed, bundle->data, FIELD_SIZE * sizeof(uint16));
+
+  /* generic conversions match those of any instruction set variant */
+  memset(bundle->decompressed, 0, FIELD_SIZE * sizeof(uint16));
+  zfp_stream_set_isa(bundle->stream, zfp_isa_generic);
+  roundTrip(bundle, bundle->field, bundle->decompressed);
+  assert_memory_equal(bundle->decompressed, bundle->data, FIELD_SIZE * sizeof(uint16));
+
+  /* parallel (de)compression, where supported, yields the same values */
+  if (zfp_stream_set_execution(bundle->stream, zfp_exec_omp)) {
+    memset(bundle->decompressed, 0, FIELD_SIZE * sizeof(uint16));
+    zfp_stream_set_omp_chunk_size(bundle->stream, 7);
+    roundTrip(bundle, bundle->field, bundle->decompressed);
+    assert_memory_equal(bundle->decompressed, bundle->data, FIELD_SIZE * sizeof(uint16));
+  }
+}
+
+static void
+given_fixedRateHalfField_when_zfpCompress_expect_streamOfEquivalentFloatField(void **state)
+{
+  struct setupVars *bundle = *state;
+  float* values = malloc(FIELD_SIZE * sizeof(float));
+  assert_non_null(values);
+
+  /* finite values only, as infinities do not survive lossy compression */
+  size_t i;
+  for (i = 0; i < FIELD_SIZE; i++)
+    bundle->data[i] &= 0xbfffu;
+
+  /* widen to float by decompressing reversible stream into a float field */
+  zfp_field* field = zfp_field_2d(values, zfp_type_float, NX, NY);
+  size_t size = zfp_compress(bundle->stream, bundle->field);
+  zfp_stream_rewind(bundle->stream);
+  assert_int_equal(zfp_decompress(bundle->stream, field), size);
+
+  /* fixed-rate half stream is that of the float field */
+  zfp_stream_rewind(bundle->stream);
+  zfp_stream_set_rate(bundle->stream, 12, zfp_type_half, 2, zfp_false);
+  size = zfp_compress(bundle->stream, bundle->field);
+  void* reference = malloc(size);
+  assert_non_null(reference);
+  memcpy(reference, bundle->buffer, size);
+  zfp_stream_rewind(bundle->stream);
+  assert_int_equal(zfp_compress(bundle->stream, field), size);
+  assert_memory_equal(bundle->buffer, reference, size);
+
+  free(reference);
+  zfp_field_free(field);
+  free(values);
+}
+
+static void
+given_floatStream_when_zfpDecompressHalf_expect_roundedToNearestEven(void **state)
+{
+  struct setupVars *bundle = *state;
+  const float values[8] = {
+    1.0f + 0x1p-11f,       /* tie rounds down to even */
+    1.0f + 0x3p-11f,       /* tie rounds up to even */
+    65504.0f,              /* largest half */
+    65520.0f,              /* rounds to infinity */
+    0x1p-24f,              /* smallest subnormal half */
+    0x1p-25f,              /* tie rounds down to zero */
+    -0x1.8p-25f,           /* rounds up in magnitude to smallest subnormal */
+    0x1.ffcp-15f,          /* subnormal rounds up to smallest normal */
+  };
+  const uint16 expected[8] = { 0x3c00, 0x3c02, 0x7bff, 0x7c00, 0x0001, 0x0000, 0x8001, 0x0400 };
+  uint16 decoded[8];
+  uint isa;
+
+  zfp_field* field = zfp_field_1d((void*)values, zfp_type_float, 8);
+  size_t size = zfp_compress(bundle->stream, field);
+  assert_int_not_equal(size, 0);
+
+  zfp_field_set_type(field, zfp_type_half);
+  zfp_field_set_pointer(field, decoded);
+  for (isa = zfp_isa_generic; isa <= zfp_isa_avx512; isa++) {
+    if (!zfp_stream_set_isa(bundle->stream, (zfp_isa)isa))
+      continue;
+    zfp_stream_rewind(bundle->stream);
+    assert_int_equal(zfp_decompress(bundle->stream, field), size);
+    assert_memory_equal(decoded, expected, sizeof(expected));
+  }
+
+  zfp_field_free(field);
+}
+
+static void
+given_fixedAccuracyBfloat16Field_when_zfpDecompress_expect_errorsWithinTolerance(void **state)
+{
+  struct setupVars *bundle = *state;
+  const double tolerance = 1e-3;
+  size_t i;
+
+  /* smooth bfloat16 values, truncated from float */
+  for (i = 0; i < FIELD_SIZE; i++) {
+    float f = (float)(sin(0.01 * (double)(i % NX)) * cos(0.02 * (double)(i / NX)));
+    uint32 u;
+    memcpy(&u, &f, sizeof(u));
+    bundle->data[i] = (uint16)(u >> 16);
+  }
+
+  zfp_stream_set_accuracy(bundle->stream, tolerance);
+  zfp_field_set_type(bundle->field, zfp_type_bfloat16);
+  roundTrip(bundle, bundle->field, bundle->decompressed);
+
+  /* error is bounded by tolerance plus bfloat16 rounding of the result */
+  for (i = 0; i < FIELD_SIZE; i++) {
+    uint32 a = (uint32)bundle->data[i] << 16;
+    uint32 b = (uint32)bundle->decompressed[i] << 16;
+    float x, y;
+    memcpy(&x, &a, sizeof(x));
+    memcpy(&y, &b, sizeof(y));
+    assert_true(fabs((double)x - (double)y) <= tolerance + ldexp(fabs((double)y), -8));
+  }
+}
+
+static void
+given_halfField_when_zfpWriteHeader_expect_floatMetadataAndTwoByteValues(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_field* field = zfp_field_alloc();
+
+  assert_int_equal(zfp_type_size(zfp_type_half), 2);
+  assert_int_equal(zfp_type_size(zfp_type_bfloat16), 2);
+
+  /* 16-bit fields are stored as float streams */
+  assert_int_not_equal(zfp_write_header(bundle->stream, bundle->field, ZFP_HEADER_FULL), 0);
+  zfp_stream_flush(bundle->stream);
+  zfp_stream_rewind(bundle->stream);
+  assert_int_not_equal(zfp_read_header(bundle->stream, field, ZFP_HEADER_FULL), 0);
+  assert_int_equal(zfp_field_type(field), zfp_type_float);
+  assert_int_equal(zfp_field_set_type(field, zfp_type_half), zfp_type_half);
+
+  /* functions without 16-bit support reject such fields */
+  assert_int_equal(zfp_stream_estimate_size(bundle->stream, bundle->field, 1.0, NULL), 0);
+
+  zfp_field_free(field);
+}
+
+int main()
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test_setup_teardown(given_reversibleHalfField_when_zfpDecompress_expect_exactValues, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_fixedRateHalfField_when_zfpCompress_expect_streamOfEquivalentFloatField, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_floatStream_when_zfpDecompressHalf_expect_roundedToNearestEven, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_fixedAccuracyBfloat16Field_when_zfpDecompress_expect_errorsWithinTolerance, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_halfField_when_zfpWriteHeader_expect_floatMetadataAndTwoByteValues, setup, teardown),
+  };
+
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -6,6 +6,7 @@
 #include <setjmp.h>
 #include <cmocka.h>
 
+#include <limits.h>
 #include <stdlib.h>
 
 #define FIELD_X_LEN 33
@@ -423,6 +424,92 @@ given_invalidCompressParamsInHeader_when_zfpReadHeaderMode_expect_streamParamsNo
   assertCompressParamsBehaviorWhenReadHeader(state, ZFP_MODE_LONG_BITS, 0);
 }
 
+static void
+given_emptyIndex_when_zfpWriteIndex_expect_returnsZero(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_index* index = zfp_index_alloc();
+  assert_non_null(index);
+
+  assert_int_equal(zfp_write_index(bundle->stream, index), 0);
+
+  zfp_index_free(index);
+}
+
+static void
+when_zfpWriteIndex_expect_deltasEncodedWithMinimalWidth(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_stream* stream = bundle->stream;
+  const uint64 offset[] = {0, 7, 7, 300, 301};
+  zfp_index* index = zfp_index_alloc();
+  assert_non_null(index);
+  assert_int_equal(zfp_index_set(index, 4, offset), 1);
+
+  // largest delta (293) requires 9 bits
+  assert_int_equal(zfp_write_index(stream, index), ZFP_INDEX_CHUNK_BITS + ZFP_INDEX_WIDTH_BITS + 4 * 9);
+  zfp_stream_flush(stream);
+
+  zfp_stream_rewind(stream);
+  assert_int_equal(stream_read_bits(stream->stream, ZFP_INDEX_CHUNK_BITS), 4);
+  assert_int_equal(stream_read_bits(stream->stream, ZFP_INDEX_WIDTH_BITS) + 1, 9);
+  assert_int_equal(stream_read_bits(stream->stream, 9), 7);
+  assert_int_equal(stream_read_bits(stream->stream, 9), 0);
+  assert_int_equal(stream_read_bits(stream->stream, 9), 293);
+  assert_int_equal(stream_read_bits(stream->stream, 9), 1);
+
+  zfp_index_free(index);
+}
+
+static void
+given_writtenIndex_when_zfpReadIndex_expect_offsetsRestored(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_stream* stream = bundle->stream;
+  const uint64 offset[] = {0, 1000, 20000, 20001};
+  zfp_index* index = zfp_index_alloc();
+  zfp_index* copy = zfp_index_alloc();
+  size_t bits;
+  size_t i;
+  assert_non_null(index);
+  assert_non_null(copy);
+  assert_int_equal(zfp_index_set(index, 3, offset), 1);
+
+  bits = zfp_write_index(stream, index);
+  assert_int_not_equal(bits, 0);
+  zfp_stream_flush(stream);
+
+  zfp_stream_rewind(stream);
+  assert_int_equal(zfp_read_index(stream, copy), bits);
+  assert_int_equal(zfp_index_chunks(copy), 3);
+  for (i = 0; i <= 3; i++)
+    assert_true(zfp_index_offset(copy, i) == offset[i]);
+
+  zfp_index_free(copy);
+  zfp_index_free(index);
+}
+
+static void
+given_chunkCountExceedingStream_when_zfpReadIndex_expect_returnsZero(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_stream* stream = bundle->stream;
+  zfp_index* index = zfp_index_alloc();
+  assert_non_null(index);
+
+  // claim one more 1-bit delta than the whole buffer holds
+  bitstream* s = zfp_stream_bit_stream(stream);
+  stream_write_bits(s, stream_capacity(s) * CHAR_BIT + 1, ZFP_INDEX_CHUNK_BITS);
+  stream_write_bits(s, 0, ZFP_INDEX_WIDTH_BITS);
+  zfp_stream_flush(stream);
+
+  zfp_stream_rewind(stream);
+  assert_int_equal(zfp_read_index(stream, index), 0);
+  assert_int_equal(zfp_index_chunks(index), 0);
+
+  zfp_index_free(index);
+}
+
 int main()
 {
   const struct CMUnitTest tests[] = {
@@ -462,6 +549,12 @@ int main()
     cmocka_unit_test_setup_teardown(given_customCompressParamsAndProperHeader_when_zfpReadHeaderMode_expect_streamParamsSet, setup, teardown),
     cmocka_unit_test_setup_teardown(given_invalidCompressParamsInHeader_when_zfpReadHeaderMode_expect_properNumBitsRead, setup, teardown),
     cmocka_unit_test_setup_teardown(given_invalidCompressParamsInHeader_when_zfpReadHeaderMode_expect_streamParamsNotSet, setup, teardown),
+
+    // write/read chunk index
+    cmocka_unit_test_setup_teardown(given_emptyIndex_when_zfpWriteIndex_expect_returnsZero, setup, teardown),
+    cmocka_unit_test_setup_teardown(when_zfpWriteIndex_expect_deltasEncodedWithMinimalWidth, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_writtenIndex_when_zfpReadIndex_expect_offsetsRestored, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_chunkCountExceedingStream_when_zfpReadIndex_expect_returnsZero, setup, teardown),
   };
   return cmocka_run_group_tests(tests, NULL, NULL);
 }
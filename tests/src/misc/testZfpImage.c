@@ -0,0 +1,164 @@
+#include "zfp.h"
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* RGBA image with partial blocks along each dimension */
+#define NX 37
+#define NY 22
+#define CHANNELS 4
+#define IMAGE_SIZE (NX * NY * CHANNELS)
+
+struct setupVars {
+  uchar* pixels;
+  uchar* decompressed;
+  void* buffer;
+  size_t bufferSize;
+  zfp_stream* stream;
+  bitstream* s;
+};
+
+static int
+setup(void **state)
+{
+  struct setupVars *bundle = malloc(sizeof(struct setupVars));
+  assert_non_null(bundle);
+
+  bundle->pixels = malloc(IMAGE_SIZE);
+  bundle->decompressed = malloc(IMAGE_SIZE);
+  assert_non_null(bundle->pixels);
+  assert_non_null(bundle->decompressed);
+
+  /* smooth color gradients with full-range extremes */
+  size_t x, y;
+  for (y = 0; y < NY; y++)
+    for (x = 0; x < NX; x++) {
+      uchar* p = bundle->pixels + CHANNELS * (x + NX * y);
+      p[0] = (uchar)(255 * x / (NX - 1));
+      p[1] = (uchar)(255 * y / (NY - 1));
+      p[2] = (uchar)(127.5 + 127.5 * sin(0.2 * (double)(x + y)));
+      p[3] = (uchar)(x < NX / 2 ? 255 : 0);
+    }
+
+  /* room for all blocks of all channels stored losslessly */
+  zfp_field* field = zfp_field_2d(NULL, zfp_type_int32, NX, NY);
+  bundle->stream = zfp_stream_open(NULL);
+  zfp_stream_set_reversible(bundle->stream);
+  bundle->bufferSize = CHANNELS * zfp_stream_maximum_size(bundle->stream, field);
+  zfp_field_free(field);
+  bundle->buffer = malloc(bundle->bufferSize);
+  assert_non_null(bundle->buffer);
+  bundle->s = stream_open(bundle->buffer, bundle->bufferSize);
+  zfp_stream_set_bit_stream(bundle->stream, bundle->s);
+
+  *state = bundle;
+
+  return 0;
+}
+
+static int
+teardown(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  zfp_stream_close(bundle->stream);
+  stream_close(bundle->s);
+  free(bundle->buffer);
+  free(bundle->decompressed);
+  free(bundle->pixels);
+  free(bundle);
+
+  return 0;
+}
+
+/* compress and decompress image; return compressed size */
+static size_t
+roundtrip(struct setupVars *bundle, uint channels, zfp_bool subsample)
+{
+  zfp_stream_rewind(bundle->stream);
+  size_t size = zfp_compress_image(bundle->stream, bundle->pixels, NX, NY * CHANNELS / channels, channels, subsample);
+  assert_int_not_equal(size, 0);
+  memset(bundle->decompressed, 0, IMAGE_SIZE);
+  zfp_stream_rewind(bundle->stream);
+  assert_int_equal(zfp_decompress_image(bundle->stream, bundle->decompressed, NX, NY * CHANNELS / channels, channels, subsample), size);
+  return size;
+}
+
+/* largest absolute difference of channel k */
+static int
+max_error(const struct setupVars *bundle, uint k)
+{
+  int error = 0;
+  size_t i;
+  for (i = k; i < IMAGE_SIZE; i += CHANNELS) {
+    int e = abs((int)bundle->decompressed[i] - (int)bundle->pixels[i]);
+    if (error < e)
+      error = e;
+  }
+  return error;
+}
+
+static void
+given_reversibleMode_when_zfpCompressImage_expect_losslessForAllChannelCounts(void **state)
+{
+  struct setupVars *bundle = *state;
+  uint channels;
+
+  /* image of width NX with 1, 2, or 4 channels per pixel */
+  for (channels = 1; channels <= CHANNELS; channels *= 2) {
+    roundtrip(bundle, channels, zfp_false);
+    assert_memory_equal(bundle->decompressed, bundle->pixels, IMAGE_SIZE);
+  }
+}
+
+static void
+given_fixedRate_when_zfpCompressImageSubsampled_expect_smallerStreamAndExactAlpha(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_stream_set_rate(bundle->stream, 12, zfp_type_int32, 2, zfp_false);
+  size_t tiles = ((NX + 3) / 4) * ((NY + 3) / 4);
+
+  /* each tile occupies exactly four blocks */
+  size_t size = roundtrip(bundle, CHANNELS, zfp_false);
+  assert_int_equal(size, (4 * tiles * 16 * 12 + 63) / 64 * 8);
+  assert_true(max_error(bundle, 0) <= 8);
+  assert_true(max_error(bundle, 1) <= 8);
+  assert_true(max_error(bundle, 2) <= 8);
+  assert_int_equal(max_error(bundle, 3), 0);
+
+  /* subsampled chroma blocks have a quarter of the bits */
+  size_t subsampled = roundtrip(bundle, CHANNELS, zfp_true);
+  assert_int_equal(subsampled, ((2 * 16 + 2 * 4) * 12 * tiles + 63) / 64 * 8);
+  assert_true(max_error(bundle, 1) <= 32);
+  assert_int_equal(max_error(bundle, 3), 0);
+}
+
+static void
+given_invalidArguments_when_zfpCompressImage_expect_returnsZero(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  assert_int_equal(zfp_compress_image(bundle->stream, NULL, NX, NY, CHANNELS, zfp_false), 0);
+  assert_int_equal(zfp_compress_image(bundle->stream, bundle->pixels, 0, NY, CHANNELS, zfp_false), 0);
+  assert_int_equal(zfp_compress_image(bundle->stream, bundle->pixels, NX, 0, CHANNELS, zfp_false), 0);
+  assert_int_equal(zfp_compress_image(bundle->stream, bundle->pixels, NX, NY, 0, zfp_false), 0);
+  assert_int_equal(zfp_compress_image(bundle->stream, bundle->pixels, NX, NY, 5, zfp_false), 0);
+  assert_int_equal(zfp_decompress_image(bundle->stream, bundle->decompressed, NX, NY, 5, zfp_false), 0);
+}
+
+int main()
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test_setup_teardown(given_reversibleMode_when_zfpCompressImage_expect_losslessForAllChannelCounts, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_fixedRate_when_zfpCompressImageSubsampled_expect_smallerStreamAndExactAlpha, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_invalidArguments_when_zfpCompressImage_expect_returnsZero, setup, teardown),
+  };
+
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,228 @@
+#include "zfp.h"
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* 3D field of several slabs with partial blocks along each dimension */
+#define NX 21
+#define NY 10
+#define NZ 37
+#define FIELD_SIZE (NX * NY * NZ)
+
+struct setupVars {
+  double* data;
+  double* storage;
+  double* decompressed;
+  void* buffer;
+  size_t bufferSize;
+  zfp_stream* stream;
+};
+
+static int
+setup(void **state)
+{
+  struct setupVars *bundle = malloc(sizeof(struct setupVars));
+  assert_non_null(bundle);
+
+  bundle->data = malloc(FIELD_SIZE * sizeof(double));
+  bundle->storage = malloc(FIELD_SIZE * sizeof(double));
+  bundle->decompressed = malloc(FIELD_SIZE * sizeof(double));
+  assert_non_null(bundle->data);
+  assert_non_null(bundle->storage);
+  assert_non_null(bundle->decompressed);
+
+  size_t i;
+  for (i = 0; i < FIELD_SIZE; i++)
+    bundle->data[i] = exp(0.01 * (double)(i % NX)) * sin(0.1 * (double)i) + 1e-9 * (double)i;
+  memcpy(bundle->storage, bundle->data, FIELD_SIZE * sizeof(double));
+
+  bundle->stream = zfp_stream_open(NULL);
+  zfp_stream_set_accuracy(bundle->stream, 1e-6);
+  bundle->bufferSize = FIELD_SIZE * sizeof(double);
+  bundle->buffer = calloc(bundle->bufferSize, 1);
+  assert_non_null(bundle->buffer);
+
+  *state = bundle;
+
+  return 0;
+}
+
+static int
+teardown(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  zfp_stream_close(bundle->stream);
+  free(bundle->buffer);
+  free(bundle->decompressed);
+  free(bundle->storage);
+  free(bundle->data);
+  free(bundle);
+
+  return 0;
+}
+
+/* compress field into separate buffer and decompress it; return compressed size */
+static size_t
+referenceRoundTrip(struct setupVars *bundle, zfp_field* field)
+{
+  bitstream* s = stream_open(bundle->buffer, bundle->bufferSize);
+  zfp_stream_set_bit_stream(bundle->stream, s);
+  size_t size = zfp_compress(bundle->stream, field);
+  assert_int_not_equal(size, 0);
+
+  void* data = zfp_field_pointer(field);
+  zfp_stream_rewind(bundle->stream);
+  zfp_field_set_pointer(field, bundle->decompressed);
+  assert_int_equal(zfp_decompress(bundle->stream, field), size);
+  zfp_field_set_pointer(field, data);
+
+  stream_close(s);
+  return size;
+}
+
+/* compress field in place; return compressed size */
+static size_t
+compressInplace(struct setupVars *bundle, zfp_field* field)
+{
+  bitstream* s = stream_open(zfp_field_pointer(field), FIELD_SIZE * sizeof(double));
+  zfp_stream_set_bit_stream(bundle->stream, s);
+  size_t size = zfp_compress_inplace(bundle->stream, field);
+  stream_close(s);
+  return size;
+}
+
+/* decompress field in place from stream of given size; return bytes consumed */
+static size_t
+decompressInplace(struct setupVars *bundle, zfp_field* field, size_t size)
+{
+  bitstream* s = stream_open(zfp_field_pointer(field), size);
+  zfp_stream_set_bit_stream(bundle->stream, s);
+  size = zfp_decompress_inplace(bundle->stream, field);
+  stream_close(s);
+  return size;
+}
+
+static void
+given_contiguousField_when_zfpCompressInplace_expect_sameStreamAndValuesAsZfpCompress(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_field* field = zfp_field_3d(bundle->storage, zfp_type_double, NX, NY, NZ);
+  zfp_field* reference = zfp_field_3d(bundle->data, zfp_type_double, NX, NY, NZ);
+  size_t size = referenceRoundTrip(bundle, reference);
+
+  assert_int_equal(compressInplace(bundle, field), size);
+  assert_memory_equal(bundle->storage, bundle->buffer, size);
+
+  assert_int_equal(decompressInplace(bundle, field, size), size);
+  assert_memory_equal(bundle->storage, bundle->decompressed, FIELD_SIZE * sizeof(double));
+
+  zfp_field_free(reference);
+  zfp_field_free(field);
+}
+
+static void
+given_parallelExecution_when_zfpCompressInplace_expect_sameStreamAndValuesAsZfpCompress(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_field* field = zfp_field_3d(bundle->storage, zfp_type_double, NX, NY, NZ);
+  zfp_field* reference = zfp_field_3d(bundle->data, zfp_type_double, NX, NY, NZ);
+
+  if (!zfp_stream_set_execution(bundle->stream, zfp_exec_omp)) {
+    zfp_field_free(reference);
+    zfp_field_free(field);
+    skip();
+  }
+  zfp_stream_set_omp_chunk_size(bundle->stream, 7);
+
+  /* both variable- and fixed-rate streams */
+  uint mode;
+  for (mode = 0; mode < 2; mode++) {
+    if (mode)
+      zfp_stream_set_rate(bundle->stream, 16, zfp_type_double, 3, zfp_false);
+    memcpy(bundle->storage, bundle->data, FIELD_SIZE * sizeof(double));
+    size_t size = referenceRoundTrip(bundle, reference);
+
+    assert_int_equal(compressInplace(bundle, field), size);
+    assert_memory_equal(bundle->storage, bundle->buffer, size);
+
+    assert_int_equal(decompressInplace(bundle, field, size), size);
+    assert_memory_equal(bundle->storage, bundle->decompressed, FIELD_SIZE * sizeof(double));
+  }
+
+  zfp_field_free(reference);
+  zfp_field_free(field);
+}
+
+static void
+given_incompressibleNarrowField_when_zfpCompressInplace_expect_streamFitsAndRoundTrips(void **state)
+{
+  struct setupVars *bundle = *state;
+  uint64* bits = (uint64*)bundle->storage;
+  uint64 x = 1;
+  size_t i;
+
+  /* random bits expand under reversible compression */
+  for (i = 0; i < FIELD_SIZE; i++) {
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    bits[i] = x;
+  }
+  memcpy(bundle->data, bundle->storage, FIELD_SIZE * sizeof(double));
+
+  /* a single column of blocks leaves little room per slab */
+  zfp_field* field = zfp_field_2d(bundle->storage, zfp_type_int64, 4, FIELD_SIZE / 4);
+  zfp_stream_set_reversible(bundle->stream);
+  size_t size = compressInplace(bundle, field);
+  assert_int_not_equal(size, 0);
+  assert_true(size < FIELD_SIZE * sizeof(double));
+
+  assert_int_equal(decompressInplace(bundle, field, size), size);
+
+  zfp_field_free(field);
+}
+
+static void
+given_unsupportedFieldOrStream_when_zfpCompressInplace_expect_returnsZeroAndFieldUntouched(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_field* field = zfp_field_3d(bundle->storage, zfp_type_double, NX, NY, NZ);
+
+  /* strides that do not describe a dense layout */
+  zfp_field_set_stride_3d(field, 1, NX, 2 * NX * NY);
+  assert_int_equal(compressInplace(bundle, field), 0);
+
+  /* bit stream that does not begin at field storage */
+  zfp_field_set_stride_3d(field, 0, 0, 0);
+  bitstream* s = stream_open(bundle->buffer, bundle->bufferSize);
+  zfp_stream_set_bit_stream(bundle->stream, s);
+  assert_int_equal(zfp_compress_inplace(bundle->stream, field), 0);
+  stream_close(s);
+
+  /* fixed-rate blocks larger than their values */
+  zfp_stream_set_rate(bundle->stream, 64, zfp_type_double, 3, zfp_false);
+  assert_int_equal(compressInplace(bundle, field), 0);
+
+  assert_memory_equal(bundle->storage, bundle->data, FIELD_SIZE * sizeof(double));
+
+  zfp_field_free(field);
+}
+
+int main()
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test_setup_teardown(given_contiguousField_when_zfpCompressInplace_expect_sameStreamAndValuesAsZfpCompress, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_parallelExecution_when_zfpCompressInplace_expect_sameStreamAndValuesAsZfpCompress, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_incompressibleNarrowField_when_zfpCompressInplace_expect_streamFitsAndRoundTrips, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_unsupportedFieldOrStream_when_zfpCompressInplace_expect_returnsZeroAndFieldUntouched, setup, teardown),
+  };
+
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
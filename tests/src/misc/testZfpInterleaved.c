@@ -0,0 +1,194 @@
+#include "zfp.h"
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <limits.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* array of velocity structs with partial blocks along each dimension */
+#define NX 9
+#define NY 7
+#define NZ 5
+#define FIELD_SIZE (NX * NY * NZ)
+
+typedef struct {
+  double u, v, w;
+} velocity;
+
+struct setupVars {
+  velocity* data;
+  velocity* decompressed;
+  void* buffer;
+  size_t bufferSize;
+  zfp_field* field;
+  zfp_stream* stream;
+  bitstream* s;
+};
+
+static int
+setup(void **state)
+{
+  struct setupVars *bundle = malloc(sizeof(struct setupVars));
+  assert_non_null(bundle);
+
+  bundle->data = malloc(FIELD_SIZE * sizeof(velocity));
+  bundle->decompressed = calloc(FIELD_SIZE, sizeof(velocity));
+  assert_non_null(bundle->data);
+  assert_non_null(bundle->decompressed);
+
+  size_t i;
+  for (i = 0; i < FIELD_SIZE; i++) {
+    bundle->data[i].u = sin(0.1 * (double)i);
+    bundle->data[i].v = 100 * cos(0.03 * (double)i);
+    bundle->data[i].w = 1e-3 * (double)(i % 17);
+  }
+
+  /* field describes first component; zero strides imply contiguous structs */
+  bundle->field = zfp_field_3d(bundle->data, zfp_type_double, NX, NY, NZ);
+  bundle->stream = zfp_stream_open(NULL);
+  zfp_stream_set_reversible(bundle->stream);
+  bundle->bufferSize = 3 * zfp_stream_maximum_size(bundle->stream, bundle->field);
+  bundle->buffer = calloc(bundle->bufferSize, 1);
+  assert_non_null(bundle->buffer);
+  bundle->s = stream_open(bundle->buffer, bundle->bufferSize);
+  zfp_stream_set_bit_stream(bundle->stream, bundle->s);
+
+  *state = bundle;
+
+  return 0;
+}
+
+static int
+teardown(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  zfp_field_free(bundle->field);
+  zfp_stream_close(bundle->stream);
+  stream_close(bundle->s);
+  free(bundle->buffer);
+  free(bundle->decompressed);
+  free(bundle->data);
+  free(bundle);
+
+  return 0;
+}
+
+static void
+given_reversibleArrayOfStructs_when_zfpDecompressInterleaved_expect_exactValues(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  size_t size = zfp_compress_interleaved(bundle->stream, bundle->field, 3);
+  assert_int_not_equal(size, 0);
+
+  zfp_stream_rewind(bundle->stream);
+  zfp_field_set_pointer(bundle->field, bundle->decompressed);
+  assert_int_equal(zfp_decompress_interleaved(bundle->stream, bundle->field, 3), size);
+
+  assert_memory_equal(bundle->decompressed, bundle->data, FIELD_SIZE * sizeof(velocity));
+}
+
+static void
+given_fixedRateArrayOfStructs_when_zfpCompressInterleaved_expect_blocksMatchPerComponentStreams(void **state)
+{
+  struct setupVars *bundle = *state;
+  const uint bits = 256;
+  size_t blocks = ((NX + 3) / 4) * ((NY + 3) / 4) * ((NZ + 3) / 4);
+  uint c;
+
+  zfp_stream_set_rate(bundle->stream, (double)bits / 64, zfp_type_double, 3, zfp_true);
+  size_t size = zfp_compress_interleaved(bundle->stream, bundle->field, 3);
+  assert_int_equal(size, 3 * blocks * bits / CHAR_BIT);
+
+  /* compress each component separately as a strided field */
+  void* reference = calloc(size, 1);
+  assert_non_null(reference);
+  bitstream* s = stream_open(reference, size);
+  zfp_stream_set_bit_stream(bundle->stream, s);
+  for (c = 0; c < 3; c++) {
+    zfp_field* field = zfp_field_3d((double*)bundle->data + c, zfp_type_double, NX, NY, NZ);
+    zfp_field_set_stride_3d(field, 3, 3 * NX, 3 * NX * NY);
+    assert_int_equal(zfp_compress(bundle->stream, field), (c + 1) * blocks * bits / CHAR_BIT);
+    zfp_field_free(field);
+  }
+
+  /* block b of component c is block 3 b + c of interleaved stream */
+  bitstream* a = stream_open(bundle->buffer, size);
+  size_t b;
+  for (b = 0; b < blocks; b++)
+    for (c = 0; c < 3; c++) {
+      stream_rseek(a, (3 * b + c) * bits);
+      stream_rseek(s, (c * blocks + b) * bits);
+      uint n;
+      for (n = 0; n < bits; n += 64)
+        assert_true(stream_read_bits(a, 64) == stream_read_bits(s, 64));
+    }
+
+  stream_close(a);
+  stream_close(s);
+  free(reference);
+}
+
+static void
+given_paddedStructStrides_when_zfpDecompressInterleaved_expect_paddingUntouched(void **state)
+{
+  struct setupVars *bundle = *state;
+  double* padded = malloc(4 * FIELD_SIZE * sizeof(double));
+  assert_non_null(padded);
+  size_t i;
+  for (i = 0; i < FIELD_SIZE; i++) {
+    padded[4 * i + 0] = bundle->data[i].u;
+    padded[4 * i + 1] = bundle->data[i].v;
+    padded[4 * i + 2] = bundle->data[i].w;
+    padded[4 * i + 3] = -1;
+  }
+
+  /* compress three of four scalars per struct */
+  zfp_field* field = zfp_field_3d(padded, zfp_type_double, NX, NY, NZ);
+  zfp_field_set_stride_3d(field, 4, 4 * NX, 4 * NX * NY);
+  size_t size = zfp_compress_interleaved(bundle->stream, field, 3);
+  assert_int_not_equal(size, 0);
+
+  memset(padded, 0, 4 * FIELD_SIZE * sizeof(double));
+  for (i = 0; i < FIELD_SIZE; i++)
+    padded[4 * i + 3] = -1;
+  zfp_stream_rewind(bundle->stream);
+  assert_int_equal(zfp_decompress_interleaved(bundle->stream, field, 3), size);
+
+  for (i = 0; i < FIELD_SIZE; i++) {
+    assert_true(padded[4 * i + 0] == bundle->data[i].u);
+    assert_true(padded[4 * i + 1] == bundle->data[i].v);
+    assert_true(padded[4 * i + 2] == bundle->data[i].w);
+    assert_true(padded[4 * i + 3] == -1);
+  }
+
+  zfp_field_free(field);
+  free(padded);
+}
+
+static void
+given_zeroComponents_when_zfpCompressInterleaved_expect_returnsZero(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  assert_int_equal(zfp_compress_interleaved(bundle->stream, bundle->field, 0), 0);
+  assert_int_equal(zfp_decompress_interleaved(bundle->stream, bundle->field, 0), 0);
+}
+
+int main()
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test_setup_teardown(given_reversibleArrayOfStructs_when_zfpDecompressInterleaved_expect_exactValues, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_fixedRateArrayOfStructs_when_zfpCompressInterleaved_expect_blocksMatchPerComponentStreams, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_paddedStructStrides_when_zfpDecompressInterleaved_expect_paddingUntouched, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_zeroComponents_when_zfpCompressInterleaved_expect_returnsZero, setup, teardown),
+  };
+
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,161 @@
+#include "zfp.h"
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#define NX 13
+#define NY 11
+#define NZ 9
+#define FIELD_SIZE (NX * NY * NZ)
+
+struct setupVars {
+  zfp_stream* stream;
+  double* data;
+  void* buffer;
+  void* reference;
+  size_t bufferSize;
+};
+
+static int
+setup(void **state)
+{
+  struct setupVars *bundle = malloc(sizeof(struct setupVars));
+  assert_non_null(bundle);
+
+  bundle->data = malloc(FIELD_SIZE * sizeof(double));
+  assert_non_null(bundle->data);
+
+  size_t i;
+  for (i = 0; i < FIELD_SIZE; i++)
+    bundle->data[i] = (double)(i % 23) * (double)(i % 7) - 0.125 * (double)i;
+
+  bundle->stream = zfp_stream_open(NULL);
+
+  zfp_field* field = zfp_field_3d(bundle->data, zfp_type_double, NX, NY, NZ);
+  zfp_stream_set_reversible(bundle->stream);
+  bundle->bufferSize = zfp_stream_maximum_size(bundle->stream, field);
+  zfp_field_free(field);
+
+  bundle->buffer = calloc(bundle->bufferSize, 1);
+  bundle->reference = calloc(bundle->bufferSize, 1);
+  assert_non_null(bundle->buffer);
+  assert_non_null(bundle->reference);
+
+  *state = bundle;
+
+  return 0;
+}
+
+static int
+teardown(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  zfp_stream_close(bundle->stream);
+  free(bundle->reference);
+  free(bundle->buffer);
+  free(bundle->data);
+  free(bundle);
+
+  return 0;
+}
+
+/* compress field using given instruction set variant; return stream size */
+static size_t
+compressWithIsa(struct setupVars *bundle, zfp_isa isa, void* buffer)
+{
+  zfp_stream* stream = bundle->stream;
+  zfp_field* field = zfp_field_3d(bundle->data, zfp_type_double, NX, NY, NZ);
+  bitstream* bs = stream_open(buffer, bundle->bufferSize);
+
+  assert_int_equal(zfp_stream_set_isa(stream, isa), zfp_true);
+  zfp_stream_set_bit_stream(stream, bs);
+  size_t size = zfp_compress(stream, field);
+
+  stream_close(bs);
+  zfp_field_free(field);
+
+  return size;
+}
+
+static void
+given_openedZfpStream_when_zfpStreamIsa_expect_returnsDetectedIsa(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  assert_int_equal(zfp_stream_isa(bundle->stream), zfp_isa_detect());
+  assert_non_null(zfp_isa_name(zfp_stream_isa(bundle->stream)));
+}
+
+static void
+given_zfpStream_when_zfpStreamSetIsaGeneric_expect_returnsTrue(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  assert_int_equal(zfp_stream_set_isa(bundle->stream, zfp_isa_generic), zfp_true);
+  assert_int_equal(zfp_stream_isa(bundle->stream), zfp_isa_generic);
+}
+
+static void
+given_zfpStream_when_zfpStreamSetIsaInvalid_expect_returnsFalse_and_isaUnchanged(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_isa isa = zfp_stream_isa(bundle->stream);
+
+  assert_int_equal(zfp_stream_set_isa(bundle->stream, (zfp_isa)(zfp_isa_sve2 + 1)), zfp_false);
+  assert_int_equal(zfp_stream_isa(bundle->stream), isa);
+}
+
+static void
+given_supportedIsa_when_zfpCompress_expect_streamMatchesGeneric(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_stream* stream = bundle->stream;
+  int mode;
+
+  for (mode = 0; mode < 4; mode++) {
+    switch (mode) {
+      case 0:
+        zfp_stream_set_rate(stream, 19, zfp_type_double, 3, zfp_false);
+        break;
+      case 1:
+        zfp_stream_set_precision(stream, 37);
+        break;
+      case 2:
+        zfp_stream_set_accuracy(stream, 1e-5);
+        break;
+      default:
+        zfp_stream_set_reversible(stream);
+        break;
+    }
+
+    size_t size = compressWithIsa(bundle, zfp_isa_generic, bundle->reference);
+    assert_int_not_equal(size, 0);
+
+    zfp_isa isa;
+    for (isa = zfp_isa_avx2; isa <= zfp_isa_sve2; isa++) {
+      if (zfp_stream_set_isa(stream, isa)) {
+        memset(bundle->buffer, 0, bundle->bufferSize);
+        assert_int_equal(compressWithIsa(bundle, isa, bundle->buffer), size);
+        assert_memory_equal(bundle->buffer, bundle->reference, size);
+      }
+    }
+  }
+}
+
+int main()
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test_setup_teardown(given_openedZfpStream_when_zfpStreamIsa_expect_returnsDetectedIsa, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_zfpStream_when_zfpStreamSetIsaGeneric_expect_returnsTrue, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_zfpStream_when_zfpStreamSetIsaInvalid_expect_returnsFalse_and_isaUnchanged, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_supportedIsa_when_zfpCompress_expect_streamMatchesGeneric, setup, teardown),
+  };
+
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
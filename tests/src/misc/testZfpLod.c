@@ -0,0 +1,155 @@
+#include "zfp.h"
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NX 13
+#define NY 11
+#define NZ 9
+#define FIELD_SIZE (NX * NY * NZ)
+
+struct setupVars {
+  zfp_stream* stream;
+  zfp_field* field;
+  double* data;
+  double* decompressed;
+  double* lod;
+  void* buffer;
+  size_t bufferSize;
+  size_t streamSize;
+};
+
+static int
+setup(void **state)
+{
+  struct setupVars *bundle = malloc(sizeof(struct setupVars));
+  assert_non_null(bundle);
+
+  bundle->data = malloc(FIELD_SIZE * sizeof(double));
+  bundle->decompressed = calloc(FIELD_SIZE, sizeof(double));
+  bundle->lod = calloc(FIELD_SIZE, sizeof(double));
+  assert_non_null(bundle->data);
+  assert_non_null(bundle->decompressed);
+  assert_non_null(bundle->lod);
+
+  size_t i;
+  for (i = 0; i < FIELD_SIZE; i++)
+    bundle->data[i] = sin(0.1 * (double)i) + 0.001 * (double)(i % 97);
+
+  bundle->stream = zfp_stream_open(NULL);
+  bundle->field = zfp_field_3d(bundle->data, zfp_type_double, NX, NY, NZ);
+  zfp_stream_set_accuracy(bundle->stream, 1e-6);
+  bundle->bufferSize = zfp_stream_maximum_size(bundle->stream, bundle->field);
+  bundle->buffer = calloc(bundle->bufferSize, 1);
+  assert_non_null(bundle->buffer);
+
+  /* compress and decompress whole field for reference */
+  bitstream* bs = stream_open(bundle->buffer, bundle->bufferSize);
+  zfp_stream_set_bit_stream(bundle->stream, bs);
+  bundle->streamSize = zfp_compress(bundle->stream, bundle->field);
+  assert_int_not_equal(bundle->streamSize, 0);
+  zfp_stream_rewind(bundle->stream);
+  zfp_field_set_pointer(bundle->field, bundle->decompressed);
+  assert_int_equal(zfp_decompress(bundle->stream, bundle->field), bundle->streamSize);
+  zfp_stream_rewind(bundle->stream);
+
+  *state = bundle;
+
+  return 0;
+}
+
+static int
+teardown(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  stream_close(zfp_stream_bit_stream(bundle->stream));
+  zfp_field_free(bundle->field);
+  zfp_stream_close(bundle->stream);
+  free(bundle->buffer);
+  free(bundle->lod);
+  free(bundle->decompressed);
+  free(bundle->data);
+  free(bundle);
+
+  return 0;
+}
+
+/* decompress given level of detail and compare with averages of decompressed field */
+static void
+assertLodMatchesAverages(struct setupVars *bundle, uint level)
+{
+  size_t s = 4u >> level;
+  size_t lx = (NX + s - 1) / s;
+  size_t ly = (NY + s - 1) / s;
+  size_t lz = (NZ + s - 1) / s;
+  size_t x, y, z;
+
+  zfp_field_set_pointer(bundle->field, bundle->lod);
+  assert_int_equal(zfp_decompress_lod(bundle->stream, bundle->field, level), bundle->streamSize);
+
+  /* sub-blocks extending past the array average padded values */
+  for (z = 0; z + 1 < lz; z++)
+    for (y = 0; y + 1 < ly; y++)
+      for (x = 0; x + 1 < lx; x++) {
+        double sum = 0;
+        size_t i, j, k;
+        for (k = 0; k < s; k++)
+          for (j = 0; j < s; j++)
+            for (i = 0; i < s; i++)
+              sum += bundle->decompressed[(x * s + i) + NX * ((y * s + j) + NY * (z * s + k))];
+        assert_true(fabs(sum / (double)(s * s * s) - bundle->lod[x + lx * (y + ly * z)]) <= 1e-12);
+      }
+}
+
+static void
+given_level0_when_zfpDecompressLod_expect_blockAverages(void **state)
+{
+  assertLodMatchesAverages(*state, 0);
+}
+
+static void
+given_level1_when_zfpDecompressLod_expect_subBlockAverages(void **state)
+{
+  assertLodMatchesAverages(*state, 1);
+}
+
+static void
+given_level2_when_zfpDecompressLod_expect_matchesZfpDecompress(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  zfp_field_set_pointer(bundle->field, bundle->lod);
+  assert_int_equal(zfp_decompress_lod(bundle->stream, bundle->field, 2), bundle->streamSize);
+  assert_memory_equal(bundle->lod, bundle->decompressed, FIELD_SIZE * sizeof(double));
+}
+
+static void
+given_invalidLevelOrReversibleMode_when_zfpDecompressLod_expect_returnsZero(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  zfp_field_set_pointer(bundle->field, bundle->lod);
+  assert_int_equal(zfp_decompress_lod(bundle->stream, bundle->field, 3), 0);
+
+  zfp_stream_set_reversible(bundle->stream);
+  assert_int_equal(zfp_decompress_lod(bundle->stream, bundle->field, 0), 0);
+}
+
+int main()
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test_setup_teardown(given_level0_when_zfpDecompressLod_expect_blockAverages, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_level1_when_zfpDecompressLod_expect_subBlockAverages, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_level2_when_zfpDecompressLod_expect_matchesZfpDecompress, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_invalidLevelOrReversibleMode_when_zfpDecompressLod_expect_returnsZero, setup, teardown),
+  };
+
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
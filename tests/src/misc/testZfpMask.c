@@ -0,0 +1,227 @@
+#include "zfp.h"
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* 2D ocean field with land in a disk, with partial blocks along each dimension */
+#define NX 45
+#define NY 30
+#define FIELD_SIZE (NX * NY)
+#define FILL 1e20
+#define SENTINEL -12345.0
+
+struct setupVars {
+  double* data;
+  double* decompressed;
+  uint8* mask;
+  void* buffer;
+  size_t bufferSize;
+  zfp_field* field;
+  zfp_stream* stream;
+  bitstream* s;
+};
+
+static int
+setup(void **state)
+{
+  struct setupVars *bundle = malloc(sizeof(struct setupVars));
+  assert_non_null(bundle);
+
+  bundle->data = malloc(FIELD_SIZE * sizeof(double));
+  bundle->decompressed = malloc(FIELD_SIZE * sizeof(double));
+  bundle->mask = malloc(FIELD_SIZE);
+  assert_non_null(bundle->data);
+  assert_non_null(bundle->decompressed);
+  assert_non_null(bundle->mask);
+
+  size_t i;
+  for (i = 0; i < FIELD_SIZE; i++) {
+    double x = (double)(i % NX) - 12.0;
+    double y = (double)(i / NX) - 10.0;
+    bundle->mask[i] = x * x + y * y > 64.0;
+    bundle->data[i] = bundle->mask[i] ? 15.0 + sin(0.2 * x) * cos(0.1 * y) : FILL;
+    bundle->decompressed[i] = SENTINEL;
+  }
+
+  bundle->field = zfp_field_2d(bundle->data, zfp_type_double, NX, NY);
+  bundle->stream = zfp_stream_open(NULL);
+  zfp_stream_set_accuracy(bundle->stream, 1e-6);
+  bundle->bufferSize = 2 * zfp_stream_maximum_size(bundle->stream, bundle->field);
+  bundle->buffer = calloc(bundle->bufferSize, 1);
+  assert_non_null(bundle->buffer);
+  bundle->s = stream_open(bundle->buffer, bundle->bufferSize);
+  zfp_stream_set_bit_stream(bundle->stream, bundle->s);
+
+  *state = bundle;
+
+  return 0;
+}
+
+static int
+teardown(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  zfp_field_free(bundle->field);
+  zfp_stream_close(bundle->stream);
+  stream_close(bundle->s);
+  free(bundle->buffer);
+  free(bundle->mask);
+  free(bundle->decompressed);
+  free(bundle->data);
+  free(bundle);
+
+  return 0;
+}
+
+/* compress and decompress field into decompressed, returning compressed size */
+static size_t
+roundTrip(struct setupVars *bundle, zfp_field* field, void* decompressed)
+{
+  void* data = zfp_field_pointer(field);
+  size_t size = zfp_compress(bundle->stream, field);
+  assert_int_not_equal(size, 0);
+
+  zfp_stream_rewind(bundle->stream);
+  zfp_field_set_pointer(field, decompressed);
+  assert_int_equal(zfp_decompress(bundle->stream, field), size);
+  zfp_field_set_pointer(field, data);
+  zfp_stream_rewind(bundle->stream);
+
+  return size;
+}
+
+static void
+given_maskedField_when_zfpDecompress_expect_validValuesWithinToleranceAndInvalidUntouched(void **state)
+{
+  struct setupVars *bundle = *state;
+  size_t i;
+
+  /* fill values inflate the stream when not masked */
+  size_t unmasked = zfp_compress(bundle->stream, bundle->field);
+  zfp_stream_rewind(bundle->stream);
+
+  zfp_field_set_mask(bundle->field, bundle->mask);
+  size_t size = roundTrip(bundle, bundle->field, bundle->decompressed);
+  assert_true(size < unmasked);
+
+  for (i = 0; i < FIELD_SIZE; i++)
+    if (bundle->mask[i])
+      assert_true(fabs(bundle->decompressed[i] - bundle->data[i]) <= 1e-6);
+    else
+      assert_true(bundle->decompressed[i] == SENTINEL);
+
+  /* parallel (de)compression, where supported, yields the same stream */
+  if (zfp_stream_set_execution(bundle->stream, zfp_exec_omp)) {
+    void* reference = malloc(size);
+    assert_non_null(reference);
+    memcpy(reference, bundle->buffer, size);
+    zfp_stream_set_omp_chunk_size(bundle->stream, 5);
+    assert_int_equal(roundTrip(bundle, bundle->field, bundle->decompressed), size);
+    assert_memory_equal(bundle->buffer, reference, size);
+    free(reference);
+  }
+}
+
+static void
+given_fixedRateNanFilledField_when_zfpDecompress_expect_fixedSizeAndNansRestored(void **state)
+{
+  struct setupVars *bundle = *state;
+  float* values = malloc(FIELD_SIZE * sizeof(float));
+  float* decoded = malloc(FIELD_SIZE * sizeof(float));
+  assert_non_null(values);
+  assert_non_null(decoded);
+  size_t i;
+
+  for (i = 0; i < FIELD_SIZE; i++)
+    values[i] = bundle->mask[i] ? (float)bundle->data[i] : (float)NAN;
+
+  /* fixed-rate blocks keep their size, including flags */
+  zfp_field* field = zfp_field_2d(values, zfp_type_float, NX, NY);
+  zfp_field_set_fill_value(field, NAN);
+  zfp_stream_set_rate(bundle->stream, 16, zfp_type_float, 2, zfp_false);
+  size_t size = roundTrip(bundle, field, decoded);
+  assert_int_equal(size, ((NX + 3) / 4) * ((NY + 3) / 4) * 16 * 16 / 8);
+
+  for (i = 0; i < FIELD_SIZE; i++)
+    if (bundle->mask[i])
+      assert_true(fabs(decoded[i] - values[i]) <= 1e-2);
+    else
+      assert_true(isnan(decoded[i]));
+
+  zfp_field_free(field);
+  free(decoded);
+  free(values);
+}
+
+static void
+given_fillValueAndMask_when_zfpDecompress_expect_fillValueWrittenWhereMasked(void **state)
+{
+  struct setupVars *bundle = *state;
+  size_t i;
+
+  /* mask determines validity; fill value is written where invalid */
+  zfp_field_set_mask(bundle->field, bundle->mask);
+  zfp_field_set_fill_value(bundle->field, -1.0);
+  roundTrip(bundle, bundle->field, bundle->decompressed);
+
+  for (i = 0; i < FIELD_SIZE; i++)
+    if (!bundle->mask[i])
+      assert_true(bundle->decompressed[i] == -1.0);
+
+  /* entirely invalid field costs only one bit per block, rounded up to words */
+  memset(bundle->mask, 0, FIELD_SIZE);
+  zfp_field_set_mask(bundle->field, NULL);
+  zfp_field_set_fill_value(bundle->field, FILL);
+  for (i = 0; i < FIELD_SIZE; i++)
+    bundle->data[i] = FILL;
+  assert_int_equal(zfp_compress(bundle->stream, bundle->field), 16);
+
+  double fill;
+  assert_true(zfp_field_fill_value(bundle->field, &fill));
+  assert_true(fill == FILL);
+  zfp_field_clear_fill_value(bundle->field);
+  assert_false(zfp_field_fill_value(bundle->field, NULL));
+}
+
+static void
+given_maskedField_when_unsupportedFunctionOrType_expect_returnsZero(void **state)
+{
+  struct setupVars *bundle = *state;
+  int32 values[FIELD_SIZE];
+
+  /* only whole floating-point fields are masked */
+  zfp_field_set_mask(bundle->field, bundle->mask);
+  assert_int_equal(zfp_compress_subset(bundle->stream, bundle->field, 0, 0, 0, 4, 4, 0), 0);
+  assert_int_equal(zfp_stream_estimate_size(bundle->stream, bundle->field, 1.0, NULL), 0);
+
+  memset(values, 0, sizeof(values));
+  zfp_field* field = zfp_field_2d(values, zfp_type_int32, NX, NY);
+  zfp_field_set_fill_value(field, 0);
+  assert_int_equal(zfp_compress(bundle->stream, field), 0);
+
+  /* fixed rate must leave room for flags */
+  zfp_field_set_type(field, zfp_type_float);
+  zfp_stream_set_rate(bundle->stream, 1, zfp_type_float, 2, zfp_false);
+  assert_int_equal(zfp_compress(bundle->stream, field), 0);
+
+  zfp_field_free(field);
+}
+
+int main()
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test_setup_teardown(given_maskedField_when_zfpDecompress_expect_validValuesWithinToleranceAndInvalidUntouched, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_fixedRateNanFilledField_when_zfpDecompress_expect_fixedSizeAndNansRestored, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_fillValueAndMask_when_zfpDecompress_expect_fillValueWrittenWhereMasked, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_maskedField_when_unsupportedFunctionOrType_expect_returnsZero, setup, teardown),
+  };
+
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,192 @@
+#include "zfp.h"
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#define NX 32
+#define NY 32
+#define NZ 16
+#define FIELD_SIZE (NX * NY * NZ)
+
+struct setupVars {
+  zfp_field* field;
+  double* data;
+};
+
+static int
+setup(void **state)
+{
+  struct setupVars *bundle = malloc(sizeof(struct setupVars));
+  assert_non_null(bundle);
+
+  bundle->data = malloc(FIELD_SIZE * sizeof(double));
+  assert_non_null(bundle->data);
+
+  size_t i;
+  for (i = 0; i < FIELD_SIZE; i++)
+    bundle->data[i] = (double)((i * 7919) % 101) - 0.5 * (double)(i % 13);
+
+  bundle->field = zfp_field_3d(bundle->data, zfp_type_double, NX, NY, NZ);
+
+  *state = bundle;
+
+  return 0;
+}
+
+static int
+teardown(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  zfp_memory_set_limit(zfp_memory_host_scratch, 0);
+  zfp_memory_set_limit(zfp_memory_host_cache, 0);
+  zfp_field_free(bundle->field);
+  free(bundle->data);
+  free(bundle);
+
+  return 0;
+}
+
+/* compress field in fixed-accuracy mode using policy and return stream size */
+static size_t
+compress(const zfp_field* field, zfp_exec_policy policy, void** buffer, zfp_stream** zfp)
+{
+  size_t size;
+  *zfp = zfp_stream_open(NULL);
+  zfp_stream_set_accuracy(*zfp, 1e-3);
+  size = zfp_stream_maximum_size(*zfp, field);
+  *buffer = calloc(size, 1);
+  zfp_stream_set_bit_stream(*zfp, stream_open(*buffer, size));
+  if (!zfp_stream_set_execution(*zfp, policy))
+    return 0;
+  if (policy == zfp_exec_omp)
+    zfp_stream_set_omp_threads(*zfp, 4);
+  return zfp_compress(*zfp, field);
+}
+
+/* close stream opened by compress() */
+static void
+close_stream(void* buffer, zfp_stream* zfp)
+{
+  stream_close(zfp_stream_bit_stream(zfp));
+  zfp_stream_close(zfp);
+  free(buffer);
+}
+
+static void
+given_memoryPool_when_acquiredAndReleased_expect_currentAndPeakTracked(void **state)
+{
+  zfp_memory_usage base = zfp_memory_query(zfp_memory_host_cache);
+  zfp_memory_usage usage;
+
+  zfp_memory_reset_peak(zfp_memory_host_cache);
+  assert_true(zfp_memory_acquire(zfp_memory_host_cache, 1000));
+  zfp_memory_charge(zfp_memory_host_cache, 500);
+  zfp_memory_release(zfp_memory_host_cache, 1000);
+
+  usage = zfp_memory_query(zfp_memory_host_cache);
+  assert_int_equal(usage.current, base.current + 500);
+  assert_int_equal(usage.peak, base.current + 1500);
+  assert_int_equal(usage.limit, 0);
+  assert_true(zfp_memory_available(zfp_memory_host_cache) == (size_t)-1);
+
+  zfp_memory_reset_peak(zfp_memory_host_cache);
+  zfp_memory_release(zfp_memory_host_cache, 500);
+  usage = zfp_memory_query(zfp_memory_host_cache);
+  assert_int_equal(usage.current, base.current);
+  assert_int_equal(usage.peak, base.current + 500);
+}
+
+static void
+given_memoryLimit_when_acquireExceedsIt_expect_refusedAndUncounted(void **state)
+{
+  zfp_memory_usage base = zfp_memory_query(zfp_memory_host_cache);
+
+  zfp_memory_set_limit(zfp_memory_host_cache, base.current + 1000);
+  assert_int_equal(zfp_memory_available(zfp_memory_host_cache), 1000);
+  assert_true(zfp_memory_acquire(zfp_memory_host_cache, 600));
+  assert_false(zfp_memory_acquire(zfp_memory_host_cache, 600));
+  assert_int_equal(zfp_memory_available(zfp_memory_host_cache), 400);
+
+  /* charges are counted regardless of limit */
+  zfp_memory_charge(zfp_memory_host_cache, 600);
+  assert_int_equal(zfp_memory_available(zfp_memory_host_cache), 0);
+  zfp_memory_release(zfp_memory_host_cache, 1200);
+  assert_int_equal(zfp_memory_query(zfp_memory_host_cache).current, base.current);
+}
+
+static void
+given_invalidMemoryPool_when_queried_expect_zeroUsage(void **state)
+{
+  zfp_memory_usage usage = zfp_memory_query((zfp_memory_pool)ZFP_MEMORY_POOLS);
+  assert_int_equal(usage.current, 0);
+  assert_int_equal(usage.peak, 0);
+  assert_int_equal(usage.limit, 0);
+  assert_false(zfp_memory_acquire((zfp_memory_pool)ZFP_MEMORY_POOLS, 1));
+}
+
+static void
+given_ompVariableRate_when_zfpCompress_expect_scratchPeakRecordedAndReleased(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_memory_usage usage;
+  zfp_stream* zfp;
+  void* buffer;
+
+  zfp_memory_reset_peak(zfp_memory_host_scratch);
+  if (!compress(bundle->field, zfp_exec_omp, &buffer, &zfp)) {
+    close_stream(buffer, zfp);
+    skip();
+  }
+
+  /* per-chunk buffers are released once streams are concatenated */
+  usage = zfp_memory_query(zfp_memory_host_scratch);
+  assert_int_equal(usage.current, 0);
+  assert_true(usage.peak >= zfp_stream_compressed_size(zfp));
+
+  close_stream(buffer, zfp);
+}
+
+static void
+given_ompScratchLimit_when_zfpCompress_expect_serialFallbackWithSameStream(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_stream* serial;
+  zfp_stream* omp;
+  void* reference;
+  void* buffer;
+  size_t size = compress(bundle->field, zfp_exec_serial, &reference, &serial);
+
+  zfp_memory_set_limit(zfp_memory_host_scratch, 1);
+  zfp_memory_reset_peak(zfp_memory_host_scratch);
+  if (!compress(bundle->field, zfp_exec_omp, &buffer, &omp)) {
+    close_stream(buffer, omp);
+    close_stream(reference, serial);
+    skip();
+  }
+
+  assert_int_equal(zfp_stream_compressed_size(omp), size);
+  assert_memory_equal(buffer, reference, size);
+  assert_int_equal(zfp_memory_query(zfp_memory_host_scratch).peak, 0);
+
+  close_stream(buffer, omp);
+  close_stream(reference, serial);
+}
+
+int main()
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test_setup_teardown(given_memoryPool_when_acquiredAndReleased_expect_currentAndPeakTracked, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_memoryLimit_when_acquireExceedsIt_expect_refusedAndUncounted, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_invalidMemoryPool_when_queried_expect_zeroUsage, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_ompVariableRate_when_zfpCompress_expect_scratchPeakRecordedAndReleased, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_ompScratchLimit_when_zfpCompress_expect_serialFallbackWithSameStream, setup, teardown),
+  };
+
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
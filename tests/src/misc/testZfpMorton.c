@@ -0,0 +1,227 @@
+#include "zfp.h"
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* particles on a 3D lattice, stored in shuffled order */
+#define SIDE 16
+#define PARTICLES (SIDE * SIDE * SIDE)
+
+struct setupVars {
+  double* coord[3];
+  double* value;
+  double* reordered;
+  double* restored;
+  size_t* perm;
+  zfp_field* field[3];
+  zfp_stream* stream;
+};
+
+/* Morton key of lattice point (x, y, z) */
+static uint64
+lattice_key(uint x, uint y, uint z)
+{
+  uint64 key = 0;
+  uint b;
+  for (b = 0; b < 4; b++)
+    key += ((uint64)((x >> b) & 1u) << (3 * b + 0)) +
+           ((uint64)((y >> b) & 1u) << (3 * b + 1)) +
+           ((uint64)((z >> b) & 1u) << (3 * b + 2));
+  return key;
+}
+
+static int
+setup(void **state)
+{
+  struct setupVars *bundle = calloc(1, sizeof(struct setupVars));
+  assert_non_null(bundle);
+
+  size_t* order = malloc(PARTICLES * sizeof(size_t));
+  assert_non_null(order);
+  size_t i;
+  uint d;
+  for (d = 0; d < 3; d++) {
+    bundle->coord[d] = malloc(PARTICLES * sizeof(double));
+    assert_non_null(bundle->coord[d]);
+  }
+  bundle->value = malloc(PARTICLES * sizeof(double));
+  bundle->reordered = malloc(PARTICLES * sizeof(double));
+  bundle->restored = malloc(PARTICLES * sizeof(double));
+  bundle->perm = malloc(PARTICLES * sizeof(size_t));
+  assert_non_null(bundle->value);
+  assert_non_null(bundle->reordered);
+  assert_non_null(bundle->restored);
+  assert_non_null(bundle->perm);
+
+  /* deterministic shuffle of lattice points */
+  for (i = 0; i < PARTICLES; i++)
+    order[i] = i;
+  srand(42);
+  for (i = PARTICLES - 1; i > 0; i--) {
+    size_t j = (size_t)rand() % (i + 1);
+    size_t t = order[i];
+    order[i] = order[j];
+    order[j] = t;
+  }
+  for (i = 0; i < PARTICLES; i++) {
+    double x = (double)(order[i] % SIDE);
+    double y = (double)(order[i] / SIDE % SIDE);
+    double z = (double)(order[i] / (SIDE * SIDE));
+    bundle->coord[0][i] = x;
+    bundle->coord[1][i] = y;
+    bundle->coord[2][i] = z;
+    bundle->value[i] = sin(0.2 * x) * cos(0.3 * y) + 0.1 * z;
+  }
+  free(order);
+
+  for (d = 0; d < 3; d++)
+    bundle->field[d] = zfp_field_1d(bundle->coord[d], zfp_type_double, PARTICLES);
+  bundle->stream = zfp_stream_open(NULL);
+
+  *state = bundle;
+
+  return 0;
+}
+
+static int
+teardown(void **state)
+{
+  struct setupVars *bundle = *state;
+  uint d;
+
+  for (d = 0; d < 3; d++) {
+    zfp_field_free(bundle->field[d]);
+    free(bundle->coord[d]);
+  }
+  zfp_stream_close(bundle->stream);
+  free(bundle->perm);
+  free(bundle->restored);
+  free(bundle->reordered);
+  free(bundle->value);
+  free(bundle);
+
+  return 0;
+}
+
+/* compressed byte size of 1D array at given tolerance */
+static size_t
+compressed_size(const double* data, double tolerance)
+{
+  zfp_field* field = zfp_field_1d((void*)data, zfp_type_double, PARTICLES);
+  zfp_stream* zfp = zfp_stream_open(NULL);
+  zfp_stream_set_accuracy(zfp, tolerance);
+  size_t capacity = zfp_stream_maximum_size(zfp, field);
+  void* buffer = malloc(capacity);
+  assert_non_null(buffer);
+  bitstream* s = stream_open(buffer, capacity);
+  zfp_stream_set_bit_stream(zfp, s);
+  size_t size = zfp_compress(zfp, field);
+  stream_close(s);
+  free(buffer);
+  zfp_stream_close(zfp);
+  zfp_field_free(field);
+  return size;
+}
+
+static void
+given_shuffledLattice_when_zfpMortonOrder_expect_increasingMortonKeys(void **state)
+{
+  struct setupVars *bundle = *state;
+  const zfp_field* const* coord = (const zfp_field* const*)bundle->field;
+  size_t i;
+
+  assert_true(zfp_morton_order(bundle->stream, bundle->perm, coord, 3));
+
+  /* lattice fills bounding box, so keys match those of integer coordinates */
+  for (i = 0; i < PARTICLES; i++) {
+    size_t p = bundle->perm[i];
+    uint64 key = lattice_key((uint)bundle->coord[0][p], (uint)bundle->coord[1][p], (uint)bundle->coord[2][p]);
+    assert_int_equal(key, i);
+  }
+
+  /* parallel sort yields same permutation */
+  if (zfp_stream_set_execution(bundle->stream, zfp_exec_omp)) {
+    size_t* perm = malloc(PARTICLES * sizeof(size_t));
+    assert_non_null(perm);
+    zfp_stream_set_omp_threads(bundle->stream, 3);
+    assert_true(zfp_morton_order(bundle->stream, perm, coord, 3));
+    assert_memory_equal(perm, bundle->perm, PARTICLES * sizeof(size_t));
+    free(perm);
+  }
+}
+
+static void
+given_mortonOrder_when_zfpFieldPermuteAndUnpermute_expect_originalValuesAndSmallerStream(void **state)
+{
+  struct setupVars *bundle = *state;
+  const zfp_field* const* coord = (const zfp_field* const*)bundle->field;
+  zfp_field* value = zfp_field_1d(bundle->value, zfp_type_double, PARTICLES);
+  zfp_field* reordered = zfp_field_1d(bundle->reordered, zfp_type_double, PARTICLES);
+  zfp_field* restored = zfp_field_1d(bundle->restored, zfp_type_double, PARTICLES);
+  size_t i;
+
+  assert_true(zfp_morton_order(NULL, bundle->perm, coord, 3));
+  assert_true(zfp_field_permute(reordered, value, bundle->perm));
+  for (i = 0; i < PARTICLES; i++)
+    assert_true(bundle->reordered[i] == bundle->value[bundle->perm[i]]);
+  assert_true(zfp_field_unpermute(restored, reordered, bundle->perm));
+  assert_memory_equal(bundle->restored, bundle->value, PARTICLES * sizeof(double));
+
+  /* spatially coherent order compresses better */
+  assert_true(compressed_size(bundle->reordered, 1e-3) < compressed_size(bundle->value, 1e-3));
+
+  zfp_field_free(restored);
+  zfp_field_free(reordered);
+  zfp_field_free(value);
+}
+
+static void
+given_invalidArguments_when_zfpMortonOrder_expect_returnsFalse(void **state)
+{
+  struct setupVars *bundle = *state;
+  const zfp_field* coord[5];
+  int32 ints[PARTICLES];
+  uint d;
+
+  for (d = 0; d < 5; d++)
+    coord[d] = bundle->field[d % 3];
+  assert_false(zfp_morton_order(NULL, bundle->perm, coord, 0));
+  assert_false(zfp_morton_order(NULL, bundle->perm, coord, 5));
+  assert_false(zfp_morton_order(NULL, NULL, coord, 3));
+
+  /* coordinates must be floating-point vectors of equal length */
+  memset(ints, 0, sizeof(ints));
+  zfp_field* field = zfp_field_1d(ints, zfp_type_int32, PARTICLES);
+  coord[1] = field;
+  assert_false(zfp_morton_order(NULL, bundle->perm, coord, 3));
+  zfp_field_set_type(field, zfp_type_float);
+  zfp_field_set_size_1d(field, PARTICLES - 1);
+  assert_false(zfp_morton_order(NULL, bundle->perm, coord, 3));
+  zfp_field_set_size_1d(field, PARTICLES);
+  assert_true(zfp_morton_order(NULL, bundle->perm, coord, 3));
+
+  /* permuted fields must match in type */
+  zfp_field* value = zfp_field_1d(bundle->value, zfp_type_double, PARTICLES);
+  assert_false(zfp_field_permute(field, value, bundle->perm));
+  assert_false(zfp_field_unpermute(field, value, bundle->perm));
+
+  zfp_field_free(value);
+  zfp_field_free(field);
+}
+
+int main()
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test_setup_teardown(given_shuffledLattice_when_zfpMortonOrder_expect_increasingMortonKeys, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_mortonOrder_when_zfpFieldPermuteAndUnpermute_expect_originalValuesAndSmallerStream, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_invalidArguments_when_zfpMortonOrder_expect_returnsFalse, setup, teardown),
+  };
+
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,202 @@
+#include "zfp.h"
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#define NX 13
+#define NY 11
+#define NZ 9
+#define FIELD_SIZE (NX * NY * NZ)
+#define TARGETS 4
+
+struct setupVars {
+  zfp_field* field;
+  float* data;
+  zfp_stream* streams[TARGETS];
+  void* buffers[TARGETS];
+  size_t size;
+};
+
+/* set compression mode of target t */
+static void
+set_target(zfp_stream* zfp, uint t)
+{
+  switch (t) {
+    case 0:
+      zfp_stream_set_rate(zfp, 4, zfp_type_float, 3, zfp_false);
+      break;
+    case 1:
+      zfp_stream_set_rate(zfp, 16, zfp_type_float, 3, zfp_true);
+      break;
+    case 2:
+      zfp_stream_set_precision(zfp, 20);
+      break;
+    default:
+      zfp_stream_set_accuracy(zfp, 1e-3);
+      break;
+  }
+}
+
+/* open stream for target t with its own buffer */
+static zfp_stream*
+open_target(uint t, void* buffer, size_t size)
+{
+  zfp_stream* zfp = zfp_stream_open(stream_open(buffer, size));
+  set_target(zfp, t);
+  return zfp;
+}
+
+/* close stream opened by open_target() */
+static void
+close_target(zfp_stream* zfp)
+{
+  stream_close(zfp_stream_bit_stream(zfp));
+  zfp_stream_close(zfp);
+}
+
+static int
+setup(void **state)
+{
+  struct setupVars *bundle = malloc(sizeof(struct setupVars));
+  uint t;
+  assert_non_null(bundle);
+
+  bundle->data = malloc(FIELD_SIZE * sizeof(float));
+  assert_non_null(bundle->data);
+
+  size_t i;
+  for (i = 0; i < FIELD_SIZE; i++)
+    bundle->data[i] = (float)((i * 7919) % 101) - 0.25f * (float)(i % 13);
+  /* make first block constant and second block zero */
+  for (i = 0; i < 64; i++) {
+    size_t x = i % 4, y = (i / 4) % 4, z = i / 16;
+    bundle->data[x + NX * (y + NY * z)] = 3.5f;
+    bundle->data[4 + x + NX * (y + NY * z)] = 0.0f;
+  }
+
+  bundle->field = zfp_field_3d(bundle->data, zfp_type_float, NX, NY, NZ);
+  bundle->size = 2 * FIELD_SIZE * sizeof(float) + 1024;
+  for (t = 0; t < TARGETS; t++) {
+    bundle->buffers[t] = calloc(bundle->size, 1);
+    assert_non_null(bundle->buffers[t]);
+    bundle->streams[t] = open_target(t, bundle->buffers[t], bundle->size);
+  }
+
+  *state = bundle;
+
+  return 0;
+}
+
+static int
+teardown(void **state)
+{
+  struct setupVars *bundle = *state;
+  uint t;
+
+  for (t = 0; t < TARGETS; t++) {
+    close_target(bundle->streams[t]);
+    free(bundle->buffers[t]);
+  }
+  zfp_field_free(bundle->field);
+  free(bundle->data);
+  free(bundle);
+
+  return 0;
+}
+
+/* check that stream t matches zfp_compress() of field in target mode t */
+static void
+assert_matches_single(struct setupVars *bundle, const zfp_field* field, uint t)
+{
+  void* buffer = calloc(bundle->size, 1);
+  zfp_stream* zfp = open_target(t, buffer, bundle->size);
+  size_t size = zfp_compress(zfp, field);
+
+  assert_true(size != 0);
+  assert_int_equal(zfp_stream_compressed_size(bundle->streams[t]), size);
+  assert_memory_equal(bundle->buffers[t], buffer, size);
+
+  close_target(zfp);
+  free(buffer);
+}
+
+static void
+given_severalTargets_when_zfpCompressMulti_expect_streamsMatchSingleTargetCompression(void **state)
+{
+  struct setupVars *bundle = *state;
+  size_t size = zfp_compress_multi(bundle->streams, TARGETS, bundle->field);
+  size_t total = 0;
+  uint t;
+
+  for (t = 0; t < TARGETS; t++) {
+    total += zfp_stream_compressed_size(bundle->streams[t]);
+    assert_matches_single(bundle, bundle->field, t);
+  }
+  assert_int_equal(size, total);
+}
+
+static void
+given_stridedField_when_zfpCompressMulti_expect_streamsMatchSingleTargetCompression(void **state)
+{
+  struct setupVars *bundle = *state;
+  /* traverse field with x and z swapped */
+  zfp_field* field = zfp_field_3d(bundle->data, zfp_type_float, NZ, NY, NX);
+  uint t;
+
+  zfp_field_set_stride_3d(field, NX * NY, NX, 1);
+  assert_true(zfp_compress_multi(bundle->streams, TARGETS, field) != 0);
+  for (t = 0; t < TARGETS; t++)
+    assert_matches_single(bundle, field, t);
+
+  zfp_field_free(field);
+}
+
+static void
+given_reversibleTarget_when_zfpCompressMulti_expect_streamsMatchSingleTargetCompression(void **state)
+{
+  struct setupVars *bundle = *state;
+  uint t;
+
+  zfp_stream_set_reversible(bundle->streams[TARGETS - 1]);
+  assert_true(zfp_compress_multi(bundle->streams, TARGETS, bundle->field) != 0);
+  for (t = 0; t < TARGETS - 1; t++)
+    assert_matches_single(bundle, bundle->field, t);
+}
+
+static void
+given_integerField_when_zfpCompressMulti_expect_eachTargetCompressed(void **state)
+{
+  struct setupVars *bundle = *state;
+  int32* data = malloc(FIELD_SIZE * sizeof(int32));
+  zfp_field* field = zfp_field_3d(data, zfp_type_int32, NX, NY, NZ);
+  size_t i;
+  uint t;
+
+  for (i = 0; i < FIELD_SIZE; i++)
+    data[i] = (int32)((i * 7919) % 101) << 20;
+  for (t = 0; t < TARGETS; t++)
+    zfp_stream_set_precision(bundle->streams[t], 8 * (t + 1));
+  assert_true(zfp_compress_multi(bundle->streams, TARGETS, field) != 0);
+  for (t = 1; t < TARGETS; t++)
+    assert_true(zfp_stream_compressed_size(bundle->streams[t]) > zfp_stream_compressed_size(bundle->streams[t - 1]));
+
+  zfp_field_free(field);
+  free(data);
+}
+
+int main()
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test_setup_teardown(given_severalTargets_when_zfpCompressMulti_expect_streamsMatchSingleTargetCompression, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_stridedField_when_zfpCompressMulti_expect_streamsMatchSingleTargetCompression, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_reversibleTarget_when_zfpCompressMulti_expect_streamsMatchSingleTargetCompression, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_integerField_when_zfpCompressMulti_expect_eachTargetCompressed, setup, teardown),
+  };
+
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
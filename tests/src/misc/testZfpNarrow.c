@@ -0,0 +1,194 @@
+#include "zfp.h"
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+/* 3D detector frames with partial blocks along each dimension */
+#define NX 19
+#define NY 13
+#define NZ 6
+#define FIELD_SIZE (NX * NY * NZ)
+
+struct setupVars {
+  uint16* data;
+  uint16* decompressed;
+  void* buffer;
+  size_t bufferSize;
+  zfp_field* field;
+  zfp_stream* stream;
+  bitstream* s;
+};
+
+static int
+setup(void **state)
+{
+  struct setupVars *bundle = malloc(sizeof(struct setupVars));
+  assert_non_null(bundle);
+
+  bundle->data = malloc(FIELD_SIZE * sizeof(uint16));
+  bundle->decompressed = calloc(FIELD_SIZE, sizeof(uint16));
+  assert_non_null(bundle->data);
+  assert_non_null(bundle->decompressed);
+
+  /* smooth counts with noise, spanning the full range */
+  size_t i;
+  for (i = 0; i < FIELD_SIZE; i++)
+    bundle->data[i] = (uint16)(i % NX == 0 ? 0xffffu : 1000 * (i % NX) + (i * 2654435761u) % 97);
+
+  bundle->field = zfp_field_3d(bundle->data, zfp_type_uint16, NX, NY, NZ);
+  bundle->stream = zfp_stream_open(NULL);
+  zfp_stream_set_reversible(bundle->stream);
+  bundle->bufferSize = zfp_stream_maximum_size(bundle->stream, bundle->field);
+  bundle->buffer = calloc(bundle->bufferSize, 1);
+  assert_non_null(bundle->buffer);
+  bundle->s = stream_open(bundle->buffer, bundle->bufferSize);
+  zfp_stream_set_bit_stream(bundle->stream, bundle->s);
+
+  *state = bundle;
+
+  return 0;
+}
+
+static int
+teardown(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  zfp_field_free(bundle->field);
+  zfp_stream_close(bundle->stream);
+  stream_close(bundle->s);
+  free(bundle->buffer);
+  free(bundle->decompressed);
+  free(bundle->data);
+  free(bundle);
+
+  return 0;
+}
+
+static void
+given_reversibleUint16Field_when_zfpDecompress_expect_exactValues(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  size_t size = zfp_compress(bundle->stream, bundle->field);
+  assert_int_not_equal(size, 0);
+
+  zfp_stream_rewind(bundle->stream);
+  zfp_field_set_pointer(bundle->field, bundle->decompressed);
+  assert_int_equal(zfp_decompress(bundle->stream, bundle->field), size);
+  assert_memory_equal(bundle->decompressed, bundle->data, FIELD_SIZE * sizeof(uint16));
+
+  /* parallel decompression, where supported, yields the same values */
+  if (zfp_stream_set_execution(bundle->stream, zfp_exec_omp)) {
+    memset(bundle->decompressed, 0, FIELD_SIZE * sizeof(uint16));
+    zfp_stream_rewind(bundle->stream);
+    assert_int_equal(zfp_decompress(bundle->stream, bundle->field), size);
+    assert_memory_equal(bundle->decompressed, bundle->data, FIELD_SIZE * sizeof(uint16));
+  }
+}
+
+static void
+given_transposedInt8Field_when_zfpCompress_expect_streamOfPromotedInt32Field(void **state)
+{
+  struct setupVars *bundle = *state;
+  int8 values[FIELD_SIZE];
+  int32 promoted[FIELD_SIZE];
+  size_t i;
+
+  for (i = 0; i < FIELD_SIZE; i++) {
+    values[i] = (int8)(bundle->data[i] >> 8);
+    zfp_promote_int8_to_int32(promoted + i, values + i, 0);
+  }
+
+  /* traverse values in transposed order */
+  zfp_field* field = zfp_field_3d(values, zfp_type_int8, NZ, NY, NX);
+  zfp_field_set_stride_3d(field, NX * NY, NX, 1);
+  zfp_stream_set_rate(bundle->stream, 6, zfp_type_int8, 3, zfp_false);
+  size_t size = zfp_compress(bundle->stream, field);
+  assert_int_not_equal(size, 0);
+  void* reference = malloc(size);
+  assert_non_null(reference);
+  memcpy(reference, bundle->buffer, size);
+
+  zfp_field_set_type(field, zfp_type_int32);
+  zfp_field_set_pointer(field, promoted);
+  zfp_stream_rewind(bundle->stream);
+  assert_int_equal(zfp_compress(bundle->stream, field), size);
+  assert_memory_equal(bundle->buffer, reference, size);
+
+  free(reference);
+  zfp_field_free(field);
+}
+
+static void
+given_lowPrecisionInt16Stream_when_zfpDecompress_expect_clampedDemotedValues(void **state)
+{
+  struct setupVars *bundle = *state;
+  int16 values[FIELD_SIZE];
+  int16 decoded[FIELD_SIZE];
+  int32 wide[FIELD_SIZE];
+  int16 expected[FIELD_SIZE];
+  size_t i;
+
+  /* extreme values overshoot the range when decompressed at low precision */
+  for (i = 0; i < FIELD_SIZE; i++)
+    values[i] = (int16)((i / 3) % 2 ? 0x7fff : -0x8000);
+
+  zfp_field* field = zfp_field_3d(values, zfp_type_int16, NX, NY, NZ);
+  zfp_stream_set_precision(bundle->stream, 3);
+  size_t size = zfp_compress(bundle->stream, field);
+  assert_int_not_equal(size, 0);
+
+  zfp_field_set_pointer(field, decoded);
+  zfp_stream_rewind(bundle->stream);
+  assert_int_equal(zfp_decompress(bundle->stream, field), size);
+
+  /* compare with decompressing to int32 and demoting value by value */
+  zfp_field_set_type(field, zfp_type_int32);
+  zfp_field_set_pointer(field, wide);
+  zfp_stream_rewind(bundle->stream);
+  assert_int_equal(zfp_decompress(bundle->stream, field), size);
+  for (i = 0; i < FIELD_SIZE; i++)
+    zfp_demote_int32_to_int16(expected + i, wide + i, 0);
+  assert_memory_equal(decoded, expected, sizeof(expected));
+
+  zfp_field_free(field);
+}
+
+static void
+given_narrowTypes_when_zfpTypeSize_expect_byteSizesAndInt32Metadata(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_field* field = zfp_field_alloc();
+
+  assert_int_equal(zfp_type_size(zfp_type_int8), 1);
+  assert_int_equal(zfp_type_size(zfp_type_uint8), 1);
+  assert_int_equal(zfp_type_size(zfp_type_int16), 2);
+  assert_int_equal(zfp_type_size(zfp_type_uint16), 2);
+
+  /* narrow integer fields are stored as int32 streams */
+  assert_int_not_equal(zfp_write_header(bundle->stream, bundle->field, ZFP_HEADER_FULL), 0);
+  zfp_stream_flush(bundle->stream);
+  zfp_stream_rewind(bundle->stream);
+  assert_int_not_equal(zfp_read_header(bundle->stream, field, ZFP_HEADER_FULL), 0);
+  assert_int_equal(zfp_field_type(field), zfp_type_int32);
+
+  zfp_field_free(field);
+}
+
+int main()
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test_setup_teardown(given_reversibleUint16Field_when_zfpDecompress_expect_exactValues, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_transposedInt8Field_when_zfpCompress_expect_streamOfPromotedInt32Field, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_lowPrecisionInt16Stream_when_zfpDecompress_expect_clampedDemotedValues, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_narrowTypes_when_zfpTypeSize_expect_byteSizesAndInt32Metadata, setup, teardown),
+  };
+
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,176 @@
+#include "zfp.h"
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NX 32
+#define NY 32
+#define NZ 16
+#define FIELD_SIZE (NX * NY * NZ)
+#define TOLERANCE 1e-3
+
+struct setupVars {
+  double* primary;
+  double* secondary;
+  double* decompressed;
+  zfp_field* field;
+  zfp_field* primaryField;
+  zfp_field* output;
+  zfp_stream* zfp;
+  void* buffer;
+  size_t size;
+};
+
+static int
+setup(void **state)
+{
+  struct setupVars *bundle = malloc(sizeof(struct setupVars));
+  size_t x, y, z;
+  assert_non_null(bundle);
+
+  bundle->primary = malloc(FIELD_SIZE * sizeof(double));
+  bundle->secondary = malloc(FIELD_SIZE * sizeof(double));
+  bundle->decompressed = calloc(FIELD_SIZE, sizeof(double));
+  assert_non_null(bundle->primary);
+  assert_non_null(bundle->secondary);
+  assert_non_null(bundle->decompressed);
+
+  /* secondary field is a multiple of a rough primary field that varies from
+     block to block, plus a small independent component */
+  for (z = 0; z < NZ; z++)
+    for (y = 0; y < NY; y++)
+      for (x = 0; x < NX; x++) {
+        size_t i = x + NX * (y + NY * z);
+        double p = sin(0.9 * x) * cos(1.3 * y) + 0.5 * sin(2.1 * z + x * y);
+        bundle->primary[i] = p;
+        bundle->secondary[i] = (2.0 + 0.1 * (double)(x / 4 + y / 4 + z / 4)) * p + 1.0 + 1e-4 * cos(x + 2.0 * y);
+      }
+
+  bundle->field = zfp_field_3d(bundle->secondary, zfp_type_double, NX, NY, NZ);
+  bundle->primaryField = zfp_field_3d(bundle->primary, zfp_type_double, NX, NY, NZ);
+  bundle->output = zfp_field_3d(bundle->decompressed, zfp_type_double, NX, NY, NZ);
+
+  bundle->zfp = zfp_stream_open(NULL);
+  zfp_stream_set_accuracy(bundle->zfp, TOLERANCE);
+  bundle->size = 2 * FIELD_SIZE * sizeof(double) + 1024;
+  bundle->buffer = malloc(bundle->size);
+  assert_non_null(bundle->buffer);
+  zfp_stream_set_bit_stream(bundle->zfp, stream_open(bundle->buffer, bundle->size));
+
+  *state = bundle;
+
+  return 0;
+}
+
+static int
+teardown(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  stream_close(zfp_stream_bit_stream(bundle->zfp));
+  zfp_stream_close(bundle->zfp);
+  zfp_field_free(bundle->field);
+  zfp_field_free(bundle->primaryField);
+  zfp_field_free(bundle->output);
+  free(bundle->buffer);
+  free(bundle->primary);
+  free(bundle->secondary);
+  free(bundle->decompressed);
+  free(bundle);
+
+  return 0;
+}
+
+/* compress secondary field with predictor, decompress it, and return size */
+static size_t
+round_trip(struct setupVars *bundle, zfp_predictor predictor)
+{
+  size_t size;
+
+  zfp_stream_rewind(bundle->zfp);
+  size = zfp_compress_predicted(bundle->zfp, bundle->field, bundle->primaryField, predictor);
+  assert_true(size != 0);
+  zfp_stream_rewind(bundle->zfp);
+  assert_int_equal(zfp_decompress_predicted(bundle->zfp, bundle->output, bundle->primaryField, predictor), size);
+
+  return size;
+}
+
+/* largest absolute error of decompressed secondary field */
+static double
+max_error(struct setupVars *bundle)
+{
+  double error = 0;
+  size_t i;
+  for (i = 0; i < FIELD_SIZE; i++)
+    error = fmax(error, fabs(bundle->decompressed[i] - bundle->secondary[i]));
+  return error;
+}
+
+static void
+given_correlatedFields_when_linearPredictorUsed_expect_smallerStreamWithinTolerance(void **state)
+{
+  struct setupVars *bundle = *state;
+  size_t plain, predicted;
+
+  zfp_stream_rewind(bundle->zfp);
+  plain = zfp_compress(bundle->zfp, bundle->field);
+  assert_true(plain != 0);
+
+  predicted = round_trip(bundle, zfp_predict_linear);
+  assert_true(max_error(bundle) <= TOLERANCE);
+  assert_true(2 * predicted < plain);
+}
+
+static void
+given_differencePredictor_when_roundTripped_expect_withinTolerance(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  round_trip(bundle, zfp_predict_difference);
+  assert_true(max_error(bundle) <= TOLERANCE);
+}
+
+static void
+given_reversibleMode_when_linearPredictorUsed_expect_exactReconstruction(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  zfp_stream_set_reversible(bundle->zfp);
+  round_trip(bundle, zfp_predict_linear);
+  assert_memory_equal(bundle->decompressed, bundle->secondary, FIELD_SIZE * sizeof(double));
+}
+
+static void
+given_mismatchedPrimary_when_compressPredicted_expect_failure(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_field* primary = zfp_field_3d(bundle->primary, zfp_type_double, NX, NY, NZ / 2);
+  int32 data[4] = { 0 };
+  zfp_field* field = zfp_field_1d(data, zfp_type_int32, 4);
+
+  assert_int_equal(zfp_compress_predicted(bundle->zfp, bundle->field, primary, zfp_predict_linear), 0);
+  /* integer fields support only the difference predictor */
+  assert_int_equal(zfp_compress_predicted(bundle->zfp, field, field, zfp_predict_linear), 0);
+
+  zfp_field_free(field);
+  zfp_field_free(primary);
+}
+
+int main()
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test_setup_teardown(given_correlatedFields_when_linearPredictorUsed_expect_smallerStreamWithinTolerance, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_differencePredictor_when_roundTripped_expect_withinTolerance, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_reversibleMode_when_linearPredictorUsed_expect_exactReconstruction, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_mismatchedPrimary_when_compressPredicted_expect_failure, setup, teardown),
+  };
+
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
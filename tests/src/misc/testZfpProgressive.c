@@ -0,0 +1,201 @@
+#include "zfp.h"
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#define NX 13
+#define NY 11
+#define NZ 9
+#define FIELD_SIZE (NX * NY * NZ)
+#define RATE 16
+
+struct setupVars {
+  zfp_stream* stream;
+  zfp_field* field;
+  double* data;
+  double* output;
+  double* reference;
+  void* buffer;
+  size_t bufferSize;
+};
+
+static int
+setup(void **state)
+{
+  struct setupVars *bundle = malloc(sizeof(struct setupVars));
+  assert_non_null(bundle);
+
+  bundle->data = malloc(FIELD_SIZE * sizeof(double));
+  bundle->output = calloc(FIELD_SIZE, sizeof(double));
+  bundle->reference = calloc(FIELD_SIZE, sizeof(double));
+  assert_non_null(bundle->data);
+  assert_non_null(bundle->output);
+  assert_non_null(bundle->reference);
+
+  size_t i;
+  for (i = 0; i < FIELD_SIZE; i++)
+    bundle->data[i] = (double)(i % 23) * (double)(i % 7) - 0.125 * (double)i;
+
+  bundle->stream = zfp_stream_open(NULL);
+  bundle->field = zfp_field_3d(bundle->data, zfp_type_double, NX, NY, NZ);
+  zfp_stream_set_rate(bundle->stream, RATE, zfp_type_double, 3, zfp_true);
+  bundle->bufferSize = zfp_stream_maximum_size(bundle->stream, bundle->field);
+  bundle->buffer = calloc(bundle->bufferSize, 1);
+  assert_non_null(bundle->buffer);
+
+  *state = bundle;
+
+  return 0;
+}
+
+static int
+teardown(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  zfp_field_free(bundle->field);
+  zfp_stream_close(bundle->stream);
+  free(bundle->buffer);
+  free(bundle->reference);
+  free(bundle->output);
+  free(bundle->data);
+  free(bundle);
+
+  return 0;
+}
+
+#ifdef BIT_STREAM_STRIDED
+/* compress and decompress field in fixed-rate mode with given number of bits per block */
+static void
+decompressFixedRate(struct setupVars *bundle, uint maxbits, double* output)
+{
+  zfp_stream* stream = zfp_stream_open(NULL);
+  zfp_field* field = zfp_field_3d(bundle->data, zfp_type_double, NX, NY, NZ);
+  void* buffer = calloc(bundle->bufferSize, 1);
+  bitstream* bs = stream_open(buffer, bundle->bufferSize);
+  assert_non_null(buffer);
+
+  assert_int_equal(zfp_stream_set_params(stream, maxbits, maxbits, ZFP_MAX_PREC, ZFP_MIN_EXP), zfp_true);
+  zfp_stream_set_bit_stream(stream, bs);
+  assert_int_not_equal(zfp_compress(stream, field), 0);
+  zfp_stream_rewind(stream);
+  zfp_field_set_pointer(field, output);
+  assert_int_not_equal(zfp_decompress(stream, field), 0);
+
+  stream_close(bs);
+  free(buffer);
+  zfp_field_free(field);
+  zfp_stream_close(stream);
+}
+
+/* compress field progressively; return stream size */
+static size_t
+compressProgressive(struct setupVars *bundle)
+{
+  bitstream* bs = stream_open(bundle->buffer, bundle->bufferSize);
+  zfp_stream_set_bit_stream(bundle->stream, bs);
+  size_t size = zfp_compress_progressive(bundle->stream, bundle->field);
+  zfp_stream_set_bit_stream(bundle->stream, NULL);
+  stream_close(bs);
+
+  return size;
+}
+
+static void
+given_fixedRateStream_when_zfpStreamLayers_expect_oneLayerPerWordOfBlock(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_stream* stream = bundle->stream;
+
+  assert_int_equal(zfp_stream_layers(stream), RATE * 64 / stream_word_bits);
+  assert_int_equal(zfp_stream_layer_size(stream, bundle->field, 1), 4 * 3 * 3 * stream_word_bits / 8);
+  assert_int_equal(zfp_stream_layer_size(stream, bundle->field, zfp_stream_layers(stream) + 1), 0);
+
+  zfp_stream_set_accuracy(stream, 1e-3);
+  assert_int_equal(zfp_stream_layers(stream), 0);
+  assert_int_equal(compressProgressive(bundle), 0);
+}
+
+static void
+given_progressiveStream_when_decompressAllLayers_expect_matchesFixedRate(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_stream* stream = bundle->stream;
+  uint layers = zfp_stream_layers(stream);
+
+  size_t size = compressProgressive(bundle);
+  assert_int_equal(size, zfp_stream_layer_size(stream, bundle->field, layers));
+
+  bitstream* bs = stream_open(bundle->buffer, size);
+  zfp_stream_set_bit_stream(stream, bs);
+  zfp_field_set_pointer(bundle->field, bundle->output);
+  assert_int_equal(zfp_decompress_progressive(stream, bundle->field, layers), size);
+  stream_close(bs);
+
+  decompressFixedRate(bundle, RATE * 64, bundle->reference);
+  assert_memory_equal(bundle->output, bundle->reference, FIELD_SIZE * sizeof(double));
+}
+
+static void
+given_progressiveStream_when_decompressLeadingLayers_expect_matchesLowerRate(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_stream* stream = bundle->stream;
+  uint layers;
+
+  assert_int_not_equal(compressProgressive(bundle), 0);
+
+  for (layers = 1; layers < zfp_stream_layers(stream); layers *= 2) {
+    /* decompress from copy of only the bytes holding the leading layers */
+    size_t size = zfp_stream_layer_size(stream, bundle->field, layers);
+    void* prefix = malloc(size);
+    assert_non_null(prefix);
+    memcpy(prefix, bundle->buffer, size);
+
+    bitstream* bs = stream_open(prefix, size);
+    zfp_stream_set_bit_stream(stream, bs);
+    zfp_field_set_pointer(bundle->field, bundle->output);
+    assert_int_equal(zfp_decompress_progressive(stream, bundle->field, layers), size);
+    stream_close(bs);
+    free(prefix);
+
+    decompressFixedRate(bundle, layers * stream_word_bits, bundle->reference);
+    assert_memory_equal(bundle->output, bundle->reference, FIELD_SIZE * sizeof(double));
+  }
+}
+
+#else
+static void
+given_withoutStridedStreams_when_compressProgressive_expect_unsupported(void **state)
+{
+  struct setupVars *bundle = *state;
+  bitstream* bs = stream_open(bundle->buffer, bundle->bufferSize);
+
+  zfp_stream_set_bit_stream(bundle->stream, bs);
+  assert_int_equal(zfp_stream_layers(bundle->stream), 0);
+  assert_int_equal(zfp_compress_progressive(bundle->stream, bundle->field), 0);
+  assert_int_equal(zfp_decompress_progressive(bundle->stream, bundle->field, 1), 0);
+  stream_close(bs);
+}
+
+#endif
+
+int main()
+{
+  const struct CMUnitTest tests[] = {
+#ifdef BIT_STREAM_STRIDED
+    cmocka_unit_test_setup_teardown(given_fixedRateStream_when_zfpStreamLayers_expect_oneLayerPerWordOfBlock, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_progressiveStream_when_decompressAllLayers_expect_matchesFixedRate, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_progressiveStream_when_decompressLeadingLayers_expect_matchesLowerRate, setup, teardown),
+#else
+    cmocka_unit_test_setup_teardown(given_withoutStridedStreams_when_compressProgressive_expect_unsupported, setup, teardown),
+#endif
+  };
+
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,193 @@
+#include "zfp.h"
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* 3D field with partial blocks along each dimension */
+#define NX 21
+#define NY 10
+#define NZ 7
+#define FIELD_SIZE (NX * NY * NZ)
+#define BLOCKS (((NX + 3) / 4) * ((NY + 3) / 4) * ((NZ + 3) / 4))
+
+struct setupVars {
+  float* data;
+  float* decompressed;
+  void* buffer;
+  size_t bufferSize;
+  zfp_field* field;
+  zfp_stream* stream;
+  bitstream* s;
+};
+
+static int
+setup(void **state)
+{
+  struct setupVars *bundle = malloc(sizeof(struct setupVars));
+  assert_non_null(bundle);
+
+  bundle->data = malloc(FIELD_SIZE * sizeof(float));
+  bundle->decompressed = calloc(FIELD_SIZE, sizeof(float));
+  assert_non_null(bundle->data);
+  assert_non_null(bundle->decompressed);
+
+  /* random bit patterns, excluding NaNs and infinities, do not compress */
+  size_t i;
+  uint32 u = 1;
+  for (i = 0; i < FIELD_SIZE; i++) {
+    u = u * 1664525u + 1013904223u;
+    uint32 v = (u & 0x7f800000u) == 0x7f800000u ? u ^ 0x40000000u : u;
+    memcpy(bundle->data + i, &v, sizeof(v));
+  }
+
+  bundle->field = zfp_field_3d(bundle->data, zfp_type_float, NX, NY, NZ);
+  bundle->stream = zfp_stream_open(NULL);
+  zfp_stream_set_reversible(bundle->stream);
+  zfp_stream_set_raw_blocks(bundle->stream, zfp_true);
+  bundle->bufferSize = zfp_stream_maximum_size(bundle->stream, bundle->field);
+  bundle->buffer = calloc(bundle->bufferSize, 1);
+  assert_non_null(bundle->buffer);
+  bundle->s = stream_open(bundle->buffer, bundle->bufferSize);
+  zfp_stream_set_bit_stream(bundle->stream, bundle->s);
+
+  *state = bundle;
+
+  return 0;
+}
+
+static int
+teardown(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  zfp_field_free(bundle->field);
+  zfp_stream_close(bundle->stream);
+  stream_close(bundle->s);
+  free(bundle->buffer);
+  free(bundle->decompressed);
+  free(bundle->data);
+  free(bundle);
+
+  return 0;
+}
+
+/* compress and decompress field, returning compressed size */
+static size_t
+roundTrip(struct setupVars *bundle, zfp_field* field, void* decompressed)
+{
+  void* data = zfp_field_pointer(field);
+  size_t size = zfp_compress(bundle->stream, field);
+  assert_int_not_equal(size, 0);
+
+  zfp_stream_rewind(bundle->stream);
+  zfp_field_set_pointer(field, decompressed);
+  assert_int_equal(zfp_decompress(bundle->stream, field), size);
+  zfp_field_set_pointer(field, data);
+  zfp_stream_rewind(bundle->stream);
+
+  return size;
+}
+
+static void
+given_noisyReversibleField_when_rawBlocks_expect_exactValuesAndBoundedSize(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  /* noise costs at most one bit per block over raw storage */
+  size_t size = roundTrip(bundle, bundle->field, bundle->decompressed);
+  assert_true(size <= (BLOCKS * (64 * 32 + 1) + 63) / 64 * 8);
+  assert_memory_equal(bundle->decompressed, bundle->data, FIELD_SIZE * sizeof(float));
+
+  /* parallel (de)compression, where supported, yields the same stream */
+  if (zfp_stream_set_execution(bundle->stream, zfp_exec_omp)) {
+    void* reference = malloc(size);
+    assert_non_null(reference);
+    memcpy(reference, bundle->buffer, size);
+    memset(bundle->decompressed, 0, FIELD_SIZE * sizeof(float));
+    zfp_stream_set_omp_chunk_size(bundle->stream, 3);
+    assert_int_equal(roundTrip(bundle, bundle->field, bundle->decompressed), size);
+    assert_memory_equal(bundle->buffer, reference, size);
+    assert_memory_equal(bundle->decompressed, bundle->data, FIELD_SIZE * sizeof(float));
+    free(reference);
+  }
+
+  /* reversible coding of noise exceeds raw storage */
+  zfp_stream_set_raw_blocks(bundle->stream, zfp_false);
+  assert_true(zfp_compress(bundle->stream, bundle->field) > size);
+}
+
+static void
+given_noisyInt64Field_when_rawBlocks_expect_exactValues(void **state)
+{
+  struct setupVars *bundle = *state;
+  int64* values = malloc(FIELD_SIZE * sizeof(int64));
+  int64* decoded = calloc(FIELD_SIZE, sizeof(int64));
+  assert_non_null(values);
+  assert_non_null(decoded);
+  size_t i;
+
+  for (i = 0; i < FIELD_SIZE; i++)
+    values[i] = (int64)(((uint64)i + 1) * 0x9e3779b97f4a7c15ull);
+
+  zfp_field* field = zfp_field_3d(values, zfp_type_int64, NX, NY, NZ);
+  roundTrip(bundle, field, decoded);
+  assert_memory_equal(decoded, values, FIELD_SIZE * sizeof(int64));
+
+  zfp_field_free(field);
+  free(decoded);
+  free(values);
+}
+
+static void
+given_smoothField_when_rawBlocks_expect_codedBlocksPlusFlag(void **state)
+{
+  struct setupVars *bundle = *state;
+  size_t i;
+
+  for (i = 0; i < FIELD_SIZE; i++)
+    bundle->data[i] = (float)sin(0.1 * (double)i);
+
+  /* fixed-accuracy blocks are coded, costing one flag bit each */
+  zfp_stream_set_accuracy(bundle->stream, 1e-3);
+  zfp_stream_set_raw_blocks(bundle->stream, zfp_false);
+  size_t coded = zfp_compress(bundle->stream, bundle->field);
+  zfp_stream_rewind(bundle->stream);
+  zfp_stream_set_raw_blocks(bundle->stream, zfp_true);
+  size_t size = roundTrip(bundle, bundle->field, bundle->decompressed);
+  assert_true(size <= coded + (BLOCKS + 63) / 64 * 8);
+  for (i = 0; i < FIELD_SIZE; i++)
+    assert_true(fabs(bundle->decompressed[i] - bundle->data[i]) <= 1e-3);
+
+  /* fixed-rate blocks keep their size, with raw storage too large to fit */
+  zfp_stream_set_rate(bundle->stream, 8, zfp_type_float, 3, zfp_false);
+  size = roundTrip(bundle, bundle->field, bundle->decompressed);
+  assert_int_equal(size, BLOCKS * 64 * 8 / 8);
+}
+
+static void
+given_rawBlocks_when_unsupportedFunction_expect_returnsZero(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  assert_true(zfp_stream_raw_blocks(bundle->stream));
+  zfp_stream_set_accuracy(bundle->stream, 1e-3);
+  assert_int_equal(zfp_decompress_lod(bundle->stream, bundle->field, 1), 0);
+}
+
+int main()
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test_setup_teardown(given_noisyReversibleField_when_rawBlocks_expect_exactValuesAndBoundedSize, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_noisyInt64Field_when_rawBlocks_expect_exactValues, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_smoothField_when_rawBlocks_expect_codedBlocksPlusFlag, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_rawBlocks_when_unsupportedFunction_expect_returnsZero, setup, teardown),
+  };
+
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,208 @@
+#include "zfp.h"
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* 3D field with partial blocks along each dimension */
+#define NX 21
+#define NY 14
+#define NZ 9
+#define FIELD_SIZE (NX * NY * NZ)
+
+struct setupVars {
+  double* data;
+  double* other;
+  void* buffer;
+  void* otherBuffer;
+  size_t bufferSize;
+  zfp_field* field;
+  zfp_stream* stream;
+  zfp_stream* otherStream;
+  bitstream* s;
+  bitstream* t;
+};
+
+static int
+setup(void **state)
+{
+  struct setupVars *bundle = malloc(sizeof(struct setupVars));
+  assert_non_null(bundle);
+
+  bundle->data = malloc(FIELD_SIZE * sizeof(double));
+  bundle->other = malloc(FIELD_SIZE * sizeof(double));
+  assert_non_null(bundle->data);
+  assert_non_null(bundle->other);
+
+  size_t i;
+  for (i = 0; i < FIELD_SIZE; i++) {
+    bundle->data[i] = 2 + sin(0.1 * (double)i) * (double)(i % 13);
+    bundle->other[i] = cos(0.07 * (double)i);
+  }
+
+  bundle->field = zfp_field_3d(bundle->data, zfp_type_double, NX, NY, NZ);
+  bundle->stream = zfp_stream_open(NULL);
+  bundle->otherStream = zfp_stream_open(NULL);
+  zfp_stream_set_reversible(bundle->stream);
+  zfp_stream_set_reversible(bundle->otherStream);
+  bundle->bufferSize = zfp_stream_maximum_size(bundle->stream, bundle->field);
+  bundle->buffer = calloc(bundle->bufferSize, 1);
+  bundle->otherBuffer = calloc(bundle->bufferSize, 1);
+  assert_non_null(bundle->buffer);
+  assert_non_null(bundle->otherBuffer);
+  bundle->s = stream_open(bundle->buffer, bundle->bufferSize);
+  bundle->t = stream_open(bundle->otherBuffer, bundle->bufferSize);
+  zfp_stream_set_bit_stream(bundle->stream, bundle->s);
+  zfp_stream_set_bit_stream(bundle->otherStream, bundle->t);
+
+  *state = bundle;
+
+  return 0;
+}
+
+static int
+teardown(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  zfp_field_free(bundle->field);
+  zfp_stream_close(bundle->otherStream);
+  zfp_stream_close(bundle->stream);
+  stream_close(bundle->t);
+  stream_close(bundle->s);
+  free(bundle->otherBuffer);
+  free(bundle->buffer);
+  free(bundle->other);
+  free(bundle->data);
+  free(bundle);
+
+  return 0;
+}
+
+/* reference reductions of uncompressed values */
+static void
+reduceValues(const double* data, double* sum, double* min, double* max, double* l2)
+{
+  size_t i;
+  *sum = 0;
+  *min = *max = data[0];
+  *l2 = 0;
+  for (i = 0; i < FIELD_SIZE; i++) {
+    *sum += data[i];
+    *min = fmin(*min, data[i]);
+    *max = fmax(*max, data[i]);
+    *l2 += data[i] * data[i];
+  }
+  *l2 = sqrt(*l2);
+}
+
+/* compress field, reduce it, and return reduced value */
+static double
+compressAndReduce(struct setupVars *bundle, zfp_reduce_op op)
+{
+  double result = 0;
+  size_t size;
+
+  zfp_stream_rewind(bundle->stream);
+  size = zfp_compress(bundle->stream, bundle->field);
+  assert_int_not_equal(size, 0);
+  zfp_stream_rewind(bundle->stream);
+  assert_int_equal(zfp_reduce(bundle->stream, bundle->field, op, &result), size);
+
+  return result;
+}
+
+static void
+given_reversibleField_when_zfpReduce_expect_reductionsOfOriginalValues(void **state)
+{
+  struct setupVars *bundle = *state;
+  double sum, min, max, l2;
+  double tolerance = 1e-12 * FIELD_SIZE;
+
+  reduceValues(bundle->data, &sum, &min, &max, &l2);
+
+  assert_true(fabs(compressAndReduce(bundle, zfp_reduce_sum) - sum) <= tolerance);
+  assert_true(fabs(compressAndReduce(bundle, zfp_reduce_mean) - sum / FIELD_SIZE) <= tolerance);
+  assert_true(compressAndReduce(bundle, zfp_reduce_min) == min);
+  assert_true(compressAndReduce(bundle, zfp_reduce_max) == max);
+  assert_true(fabs(compressAndReduce(bundle, zfp_reduce_l2) - l2) <= tolerance);
+}
+
+static void
+given_fixedAccuracyField_when_zfpReduceMean_expect_meanWithinTolerance(void **state)
+{
+  struct setupVars *bundle = *state;
+  const double tolerance = 1e-6;
+  double sum, min, max, l2;
+
+  /* full blocks contribute their averages only; partial blocks are decoded */
+  reduceValues(bundle->data, &sum, &min, &max, &l2);
+  zfp_stream_set_accuracy(bundle->stream, tolerance);
+  assert_true(fabs(compressAndReduce(bundle, zfp_reduce_mean) - sum / FIELD_SIZE) <= tolerance);
+  assert_true(fabs(compressAndReduce(bundle, zfp_reduce_max) - max) <= tolerance);
+}
+
+static void
+given_ompExecution_when_zfpReduce_expect_matchesSerialReduction(void **state)
+{
+  struct setupVars *bundle = *state;
+  double serial, parallel;
+
+  zfp_stream_set_rate(bundle->stream, 16, zfp_type_double, 3, zfp_true);
+  serial = compressAndReduce(bundle, zfp_reduce_l2);
+  if (!zfp_stream_set_execution(bundle->stream, zfp_exec_omp))
+    skip();
+  zfp_stream_set_omp_threads(bundle->stream, 4);
+  parallel = compressAndReduce(bundle, zfp_reduce_l2);
+
+  assert_true(fabs(parallel - serial) <= 1e-12 * serial);
+}
+
+static void
+given_twoReversibleFields_when_zfpDot_expect_dotProductOfOriginalValues(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_field* field = zfp_field_3d(bundle->other, zfp_type_double, NX, NY, NZ);
+  double expected = 0;
+  double result = 0;
+  size_t i;
+
+  for (i = 0; i < FIELD_SIZE; i++)
+    expected += bundle->data[i] * bundle->other[i];
+
+  assert_int_not_equal(zfp_compress(bundle->stream, bundle->field), 0);
+  assert_int_not_equal(zfp_compress(bundle->otherStream, field), 0);
+  zfp_stream_rewind(bundle->stream);
+  zfp_stream_rewind(bundle->otherStream);
+  assert_true(zfp_dot(bundle->stream, bundle->otherStream, bundle->field, &result));
+  assert_true(fabs(result - expected) <= 1e-12 * FIELD_SIZE);
+
+  zfp_field_free(field);
+}
+
+static void
+given_invalidOperation_when_zfpReduce_expect_returnsZero(void **state)
+{
+  struct setupVars *bundle = *state;
+  double result;
+
+  assert_int_equal(zfp_reduce(bundle->stream, bundle->field, (zfp_reduce_op)5, &result), 0);
+}
+
+int main()
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test_setup_teardown(given_reversibleField_when_zfpReduce_expect_reductionsOfOriginalValues, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_fixedAccuracyField_when_zfpReduceMean_expect_meanWithinTolerance, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_ompExecution_when_zfpReduce_expect_matchesSerialReduction, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_twoReversibleFields_when_zfpDot_expect_dotProductOfOriginalValues, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_invalidOperation_when_zfpReduce_expect_returnsZero, setup, teardown),
+  };
+
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
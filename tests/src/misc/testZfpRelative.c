@@ -0,0 +1,181 @@
+#include "zfp.h"
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* 2D field with partial blocks spanning many orders of magnitude */
+#define NX 65
+#define NY 47
+#define FIELD_SIZE (NX * NY)
+#define TOLERANCE 0x1p-10
+
+struct setupVars {
+  double* data;
+  double* decompressed;
+  void* buffer;
+  size_t bufferSize;
+  zfp_field* field;
+  zfp_stream* stream;
+  bitstream* s;
+};
+
+static int
+setup(void **state)
+{
+  struct setupVars *bundle = malloc(sizeof(struct setupVars));
+  assert_non_null(bundle);
+
+  bundle->data = malloc(FIELD_SIZE * sizeof(double));
+  bundle->decompressed = calloc(FIELD_SIZE, sizeof(double));
+  assert_non_null(bundle->data);
+  assert_non_null(bundle->decompressed);
+
+  /* positive field ranging from about 1e-12 to 1e+12 with a few zeros */
+  size_t x, y;
+  for (y = 0; y < NY; y++)
+    for (x = 0; x < NX; x++)
+      bundle->data[x + NX * y] = exp(0.4 * (double)x + 0.05 * (double)y - 27.6) * (1.5 + sin(0.3 * (double)(x + y)));
+  bundle->data[17 + NX * 9] = 0;
+  bundle->data[40 + NX * 33] = 0;
+
+  bundle->field = zfp_field_2d(bundle->data, zfp_type_double, NX, NY);
+  bundle->stream = zfp_stream_open(NULL);
+  assert_true(zfp_stream_set_relative_accuracy(bundle->stream, TOLERANCE) == TOLERANCE);
+  bundle->bufferSize = zfp_stream_maximum_size(bundle->stream, bundle->field);
+  bundle->buffer = calloc(bundle->bufferSize, 1);
+  assert_non_null(bundle->buffer);
+  bundle->s = stream_open(bundle->buffer, bundle->bufferSize);
+  zfp_stream_set_bit_stream(bundle->stream, bundle->s);
+
+  *state = bundle;
+
+  return 0;
+}
+
+static int
+teardown(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  zfp_field_free(bundle->field);
+  zfp_stream_close(bundle->stream);
+  stream_close(bundle->s);
+  free(bundle->buffer);
+  free(bundle->decompressed);
+  free(bundle->data);
+  free(bundle);
+
+  return 0;
+}
+
+/* compress and decompress field; return compressed size */
+static size_t
+roundtrip(struct setupVars *bundle)
+{
+  size_t size;
+  zfp_stream_rewind(bundle->stream);
+  zfp_field_set_pointer(bundle->field, bundle->data);
+  size = zfp_compress(bundle->stream, bundle->field);
+  assert_int_not_equal(size, 0);
+  zfp_stream_rewind(bundle->stream);
+  zfp_field_set_pointer(bundle->field, bundle->decompressed);
+  assert_int_equal(zfp_decompress(bundle->stream, bundle->field), size);
+  return size;
+}
+
+static void
+given_relativeAccuracy_when_zfpCompress_expect_pointwiseRelativeErrorBounded(void **state)
+{
+  struct setupVars *bundle = *state;
+  size_t i;
+
+  assert_true(zfp_stream_relative_accuracy(bundle->stream) == TOLERANCE);
+  assert_true(zfp_stream_accuracy(bundle->stream) == 0);
+  roundtrip(bundle);
+
+  for (i = 0; i < FIELD_SIZE; i++) {
+    double error = fabs(bundle->decompressed[i] - bundle->data[i]);
+    if (bundle->data[i] != 0)
+      assert_true(error <= TOLERANCE * fabs(bundle->data[i]));
+  }
+}
+
+static void
+given_relativeAccuracy_when_zfpCompress_expect_smallerThanAbsoluteAccuracyOfSameBound(void **state)
+{
+  struct setupVars *bundle = *state;
+  double amin = HUGE_VAL;
+  size_t size, i;
+
+  size = roundtrip(bundle);
+
+  /* an absolute tolerance must accommodate the smallest nonzero magnitude */
+  for (i = 0; i < FIELD_SIZE; i++)
+    if (bundle->data[i] != 0)
+      amin = fmin(amin, fabs(bundle->data[i]));
+  zfp_stream_set_accuracy(bundle->stream, TOLERANCE * amin);
+  assert_true(zfp_stream_relative_accuracy(bundle->stream) == 0);
+  assert_true(2 * size < roundtrip(bundle));
+}
+
+static void
+given_relativeAccuracyAndIndex_when_zfpDecompressWithOpenMP_expect_matchesSerial(void **state)
+{
+  struct setupVars *bundle = *state;
+  double* serial = malloc(FIELD_SIZE * sizeof(double));
+  zfp_index* index = zfp_index_alloc();
+  assert_non_null(serial);
+  assert_non_null(index);
+
+  if (!zfp_stream_set_execution(bundle->stream, zfp_exec_omp)) {
+    zfp_index_free(index);
+    free(serial);
+    skip();
+  }
+  zfp_stream_set_index(bundle->stream, index);
+  roundtrip(bundle);
+
+  zfp_stream_set_execution(bundle->stream, zfp_exec_serial);
+  zfp_stream_rewind(bundle->stream);
+  zfp_field_set_pointer(bundle->field, serial);
+  assert_int_not_equal(zfp_decompress(bundle->stream, bundle->field), 0);
+  assert_memory_equal(bundle->decompressed, serial, FIELD_SIZE * sizeof(double));
+
+  zfp_stream_set_index(bundle->stream, NULL);
+  zfp_index_free(index);
+  free(serial);
+}
+
+static void
+given_relativeAccuracyWithIntegerOrMaskedField_when_zfpCompress_expect_returnsZero(void **state)
+{
+  struct setupVars *bundle = *state;
+  int32 ints[16] = { 0 };
+  uint8 mask[FIELD_SIZE];
+  zfp_field* field = zfp_field_1d(ints, zfp_type_int32, 16);
+
+  assert_int_equal(zfp_compress(bundle->stream, field), 0);
+  zfp_field_free(field);
+
+  memset(mask, 1, sizeof(mask));
+  zfp_field_set_mask(bundle->field, mask);
+  assert_int_equal(zfp_compress(bundle->stream, bundle->field), 0);
+}
+
+int main()
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test_setup_teardown(given_relativeAccuracy_when_zfpCompress_expect_pointwiseRelativeErrorBounded, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_relativeAccuracy_when_zfpCompress_expect_smallerThanAbsoluteAccuracyOfSameBound, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_relativeAccuracyAndIndex_when_zfpDecompressWithOpenMP_expect_matchesSerial, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_relativeAccuracyWithIntegerOrMaskedField_when_zfpCompress_expect_returnsZero, setup, teardown),
+  };
+
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
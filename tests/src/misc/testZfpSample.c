@@ -0,0 +1,185 @@
+#include "zfp.h"
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NX 18
+#define NY 13
+#define NZ 10
+#define FIELD_SIZE (NX * NY * NZ)
+#define POINTS 500
+#define RATE 16
+
+struct setupVars {
+  double* data;
+  double* decompressed;
+  double* points;
+  zfp_field* field;
+  zfp_stream* zfp;
+  void* buffer;
+};
+
+static int
+setup(void **state)
+{
+  struct setupVars *bundle = malloc(sizeof(struct setupVars));
+  size_t bufsize, i;
+  assert_non_null(bundle);
+
+  bundle->data = malloc(FIELD_SIZE * sizeof(double));
+  bundle->decompressed = malloc(FIELD_SIZE * sizeof(double));
+  bundle->points = malloc(3 * POINTS * sizeof(double));
+  assert_non_null(bundle->data);
+  assert_non_null(bundle->decompressed);
+  assert_non_null(bundle->points);
+
+  for (i = 0; i < FIELD_SIZE; i++)
+    bundle->data[i] = sin(0.3 * (double)(i % NX)) + cos(0.2 * (double)(i / NX));
+  /* scattered points, some of them outside the field */
+  srand(1);
+  for (i = 0; i < 3 * POINTS; i += 3) {
+    bundle->points[i + 0] = (NX + 2) * ((double)rand() / RAND_MAX) - 1;
+    bundle->points[i + 1] = (NY + 2) * ((double)rand() / RAND_MAX) - 1;
+    bundle->points[i + 2] = (NZ + 2) * ((double)rand() / RAND_MAX) - 1;
+  }
+
+  bundle->field = zfp_field_3d(bundle->data, zfp_type_double, NX, NY, NZ);
+  bundle->zfp = zfp_stream_open(NULL);
+  zfp_stream_set_rate(bundle->zfp, RATE, zfp_type_double, 3, zfp_false);
+  bufsize = zfp_stream_maximum_size(bundle->zfp, bundle->field);
+  bundle->buffer = malloc(bufsize);
+  assert_non_null(bundle->buffer);
+  zfp_stream_set_bit_stream(bundle->zfp, stream_open(bundle->buffer, bufsize));
+  assert_true(zfp_compress(bundle->zfp, bundle->field) != 0);
+
+  /* reference values */
+  zfp_field_set_pointer(bundle->field, bundle->decompressed);
+  zfp_stream_rewind(bundle->zfp);
+  assert_true(zfp_decompress(bundle->zfp, bundle->field) != 0);
+  zfp_stream_rewind(bundle->zfp);
+
+  *state = bundle;
+
+  return 0;
+}
+
+static int
+teardown(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  stream_close(zfp_stream_bit_stream(bundle->zfp));
+  zfp_stream_close(bundle->zfp);
+  zfp_field_free(bundle->field);
+  free(bundle->buffer);
+  free(bundle->data);
+  free(bundle->decompressed);
+  free(bundle->points);
+  free(bundle);
+
+  return 0;
+}
+
+/* decompressed value at grid point (x, y, z) clamped to field */
+static double
+value_at(const struct setupVars *bundle, double x, double y, double z)
+{
+  size_t i = x > 0 ? (size_t)fmin(x, NX - 1) : 0;
+  size_t j = y > 0 ? (size_t)fmin(y, NY - 1) : 0;
+  size_t k = z > 0 ? (size_t)fmin(z, NZ - 1) : 0;
+  return bundle->decompressed[i + NX * (j + NY * k)];
+}
+
+/* trilinear interpolation of decompressed field */
+static double
+interpolate(const struct setupVars *bundle, const double* p)
+{
+  double x = p[0] > 0 ? fmin(p[0], NX - 1) : 0;
+  double y = p[1] > 0 ? fmin(p[1], NY - 1) : 0;
+  double z = p[2] > 0 ? fmin(p[2], NZ - 1) : 0;
+  double x0 = floor(x), y0 = floor(y), z0 = floor(z);
+  double tx = x - x0, ty = y - y0, tz = z - z0;
+  double sum = 0;
+  uint j;
+  for (j = 0; j < 8; j++)
+    sum += ((j & 1u) ? tx : 1 - tx) * ((j & 2u) ? ty : 1 - ty) * ((j & 4u) ? tz : 1 - tz) *
+           value_at(bundle, x0 + (j & 1u), y0 + !!(j & 2u), z0 + !!(j & 4u));
+  return sum;
+}
+
+static void
+given_scatteredPoints_when_zfpSampleNearest_expect_decompressedValues(void **state)
+{
+  struct setupVars *bundle = *state;
+  double values[POINTS];
+  size_t i;
+
+  assert_true(zfp_sample(bundle->zfp, bundle->field, bundle->points, POINTS, values, zfp_false));
+  for (i = 0; i < POINTS; i++) {
+    const double* p = bundle->points + 3 * i;
+    assert_true(values[i] == value_at(bundle, floor(p[0] + 0.5), floor(p[1] + 0.5), floor(p[2] + 0.5)));
+  }
+  /* stream position is unchanged */
+  assert_int_equal(stream_rtell(zfp_stream_bit_stream(bundle->zfp)), 0);
+}
+
+static void
+given_scatteredPoints_when_zfpSampleInterpolated_expect_trilinearInterpolant(void **state)
+{
+  struct setupVars *bundle = *state;
+  double values[POINTS];
+  size_t i;
+
+  assert_true(zfp_sample(bundle->zfp, bundle->field, bundle->points, POINTS, values, zfp_true));
+  for (i = 0; i < POINTS; i++)
+    assert_true(fabs(values[i] - interpolate(bundle, bundle->points + 3 * i)) < 1e-12);
+}
+
+static void
+given_ompPolicy_when_zfpSample_expect_sameValuesAsSerial(void **state)
+{
+  struct setupVars *bundle = *state;
+  double serial[POINTS];
+  double parallel[POINTS];
+
+  assert_true(zfp_sample(bundle->zfp, bundle->field, bundle->points, POINTS, serial, zfp_true));
+  if (!zfp_stream_set_execution(bundle->zfp, zfp_exec_omp))
+    skip();
+  zfp_stream_set_omp_threads(bundle->zfp, 4);
+  assert_true(zfp_sample(bundle->zfp, bundle->field, bundle->points, POINTS, parallel, zfp_true));
+  assert_memory_equal(serial, parallel, sizeof(serial));
+}
+
+static void
+given_variableRateStreamWithoutIndex_when_zfpSample_expect_failure(void **state)
+{
+  struct setupVars *bundle = *state;
+  int32 ivalues[POINTS];
+  double values[POINTS];
+  zfp_field* field = zfp_field_3d(NULL, zfp_type_int32, NX, NY, NZ);
+
+  /* integer fields cannot be interpolated */
+  assert_false(zfp_sample(bundle->zfp, field, bundle->points, POINTS, ivalues, zfp_true));
+  zfp_stream_set_accuracy(bundle->zfp, 1e-3);
+  assert_false(zfp_sample(bundle->zfp, bundle->field, bundle->points, POINTS, values, zfp_false));
+
+  zfp_field_free(field);
+}
+
+int main()
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test_setup_teardown(given_scatteredPoints_when_zfpSampleNearest_expect_decompressedValues, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_scatteredPoints_when_zfpSampleInterpolated_expect_trilinearInterpolant, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_ompPolicy_when_zfpSample_expect_sameValuesAsSerial, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_variableRateStreamWithoutIndex_when_zfpSample_expect_failure, setup, teardown),
+  };
+
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
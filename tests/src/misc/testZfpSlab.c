@@ -0,0 +1,194 @@
+#include "zfp.h"
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#define NX 13
+#define NY 11
+#define NZ 18
+#define FIELD_SIZE (NX * NY * NZ)
+
+struct setupVars {
+  zfp_stream* stream;
+  double* data;
+  void* buffer;
+  void* reference;
+  size_t bufferSize;
+};
+
+static int
+setup(void **state)
+{
+  struct setupVars *bundle = malloc(sizeof(struct setupVars));
+  assert_non_null(bundle);
+
+  bundle->data = malloc(FIELD_SIZE * sizeof(double));
+  assert_non_null(bundle->data);
+
+  size_t i;
+  for (i = 0; i < FIELD_SIZE; i++)
+    bundle->data[i] = (double)(i % 23) * (double)(i % 7) - 0.125 * (double)i;
+
+  bundle->stream = zfp_stream_open(NULL);
+
+  zfp_field* field = zfp_field_3d(bundle->data, zfp_type_double, NX, NY, NZ);
+  zfp_stream_set_accuracy(bundle->stream, 1e-3);
+  bundle->bufferSize = zfp_stream_maximum_size(bundle->stream, field);
+  zfp_field_free(field);
+
+  bundle->buffer = calloc(bundle->bufferSize, 1);
+  bundle->reference = calloc(bundle->bufferSize, 1);
+  assert_non_null(bundle->buffer);
+  assert_non_null(bundle->reference);
+
+  *state = bundle;
+
+  return 0;
+}
+
+static int
+teardown(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  zfp_stream_close(bundle->stream);
+  free(bundle->reference);
+  free(bundle->buffer);
+  free(bundle->data);
+  free(bundle);
+
+  return 0;
+}
+
+/* compress whole field at unaligned offset; return stream size */
+static size_t
+compressField(struct setupVars *bundle, void* buffer)
+{
+  zfp_stream* stream = bundle->stream;
+  zfp_field* field = zfp_field_3d(bundle->data, zfp_type_double, NX, NY, NZ);
+  bitstream* bs = stream_open(buffer, bundle->bufferSize);
+
+  stream_wseek(bs, 3);
+  zfp_stream_set_bit_stream(stream, bs);
+  size_t size = zfp_compress(stream, field);
+
+  stream_close(bs);
+  zfp_field_free(field);
+
+  return size;
+}
+
+/* compress field at unaligned offset in slabs of given thickness; return stream size */
+static size_t
+compressSlabs(struct setupVars *bundle, void* buffer, size_t thickness)
+{
+  zfp_stream* stream = bundle->stream;
+  bitstream* bs = stream_open(buffer, bundle->bufferSize);
+  size_t z;
+
+  stream_wseek(bs, 3);
+  zfp_stream_set_bit_stream(stream, bs);
+  zfp_compress_begin(stream);
+  for (z = 0; z < NZ; z += thickness) {
+    size_t nz = NZ - z < thickness ? NZ - z : thickness;
+    zfp_field* slab = zfp_field_3d(bundle->data + NX * NY * z, zfp_type_double, NX, NY, nz);
+    assert_int_equal(zfp_compress_slab(stream, slab), zfp_true);
+    zfp_field_free(slab);
+  }
+  size_t size = zfp_compress_end(stream);
+
+  stream_close(bs);
+
+  return size;
+}
+
+static void
+given_slabsOfVaryingThickness_when_zfpCompressSlab_expect_streamMatchesZfpCompress(void **state)
+{
+  struct setupVars *bundle = *state;
+  size_t thickness;
+
+  size_t size = compressField(bundle, bundle->reference);
+  assert_int_not_equal(size, 0);
+
+  for (thickness = 4; thickness <= NZ + 2; thickness += 4) {
+    memset(bundle->buffer, 0, bundle->bufferSize);
+    assert_int_equal(compressSlabs(bundle, bundle->buffer, thickness), size);
+    assert_memory_equal(bundle->buffer, bundle->reference, size);
+  }
+}
+
+static void
+given_slabsOfVaryingThickness_when_zfpDecompressSlab_expect_valuesMatchZfpDecompress(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_stream* stream = bundle->stream;
+  double* whole = malloc(FIELD_SIZE * sizeof(double));
+  double* slabData = malloc(NX * NY * 8 * sizeof(double));
+  size_t thickness;
+  assert_non_null(whole);
+  assert_non_null(slabData);
+
+  size_t size = compressField(bundle, bundle->reference);
+  assert_int_not_equal(size, 0);
+
+  /* decompress whole field */
+  zfp_field* field = zfp_field_3d(whole, zfp_type_double, NX, NY, NZ);
+  bitstream* bs = stream_open(bundle->reference, bundle->bufferSize);
+  stream_rseek(bs, 3);
+  zfp_stream_set_bit_stream(stream, bs);
+  assert_int_equal(zfp_decompress(stream, field), size);
+  zfp_field_free(field);
+
+  /* decompress field into small buffer one slab at a time */
+  for (thickness = 4; thickness <= 8; thickness += 4) {
+    size_t z;
+    stream_rseek(bs, 3);
+    zfp_decompress_begin(stream);
+    for (z = 0; z < NZ; z += thickness) {
+      size_t nz = NZ - z < thickness ? NZ - z : thickness;
+      zfp_field* slab = zfp_field_3d(slabData, zfp_type_double, NX, NY, nz);
+      assert_int_equal(zfp_decompress_slab(stream, slab), zfp_true);
+      assert_memory_equal(slabData, whole + NX * NY * z, NX * NY * nz * sizeof(double));
+      zfp_field_free(slab);
+    }
+    assert_int_equal(zfp_decompress_end(stream), size);
+  }
+
+  stream_close(bs);
+  free(slabData);
+  free(whole);
+}
+
+static void
+given_2dField_when_zfpCompressSlab_expect_returnsFalse(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_stream* stream = bundle->stream;
+  bitstream* bs = stream_open(bundle->buffer, bundle->bufferSize);
+  zfp_field* field = zfp_field_2d(bundle->data, zfp_type_double, NX, NY);
+
+  zfp_stream_set_bit_stream(stream, bs);
+  zfp_compress_begin(stream);
+  assert_int_equal(zfp_compress_slab(stream, field), zfp_false);
+  assert_int_equal(zfp_compress_end(stream), 0);
+
+  zfp_field_free(field);
+  stream_close(bs);
+}
+
+int main()
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test_setup_teardown(given_slabsOfVaryingThickness_when_zfpCompressSlab_expect_streamMatchesZfpCompress, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_slabsOfVaryingThickness_when_zfpDecompressSlab_expect_valuesMatchZfpDecompress, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_2dField_when_zfpCompressSlab_expect_returnsFalse, setup, teardown),
+  };
+
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,210 @@
+#include "zfp.h"
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NX 21
+#define NY 10
+#define NZ 7
+#define FIELD_SIZE (NX * NY * NZ)
+#define BX 6
+#define BY 3
+#define BZ 2
+#define BLOCKS (BX * BY * BZ)
+#define MIN(x, y) ((y) < (x) ? (y) : (x))
+
+struct setupVars {
+  double* data;
+  double* expected;
+  double* decompressed;
+  uint8 active[BLOCKS];
+  size_t count;
+  zfp_field* field;
+  zfp_stream* zfp;
+  void* buffer;
+  bitstream* stream;
+};
+
+static int
+setup(void **state)
+{
+  struct setupVars *bundle = calloc(1, sizeof(struct setupVars));
+  size_t bufsize;
+  size_t x, y, z, b;
+  assert_non_null(bundle);
+
+  bundle->data = malloc(FIELD_SIZE * sizeof(double));
+  bundle->expected = calloc(FIELD_SIZE, sizeof(double));
+  bundle->decompressed = calloc(FIELD_SIZE, sizeof(double));
+  assert_non_null(bundle->data);
+  assert_non_null(bundle->expected);
+  assert_non_null(bundle->decompressed);
+
+  for (z = 0; z < NZ; z++)
+    for (y = 0; y < NY; y++)
+      for (x = 0; x < NX; x++)
+        bundle->data[x + NX * (y + NY * z)] = sin(0.3 * x) * cos(0.2 * y) + 0.1 * z * z;
+
+  /* every third block is active, including partial blocks on the boundary */
+  for (b = 0; b < BLOCKS; b++) {
+    bundle->active[b] = (b % 3 == 1);
+    bundle->count += bundle->active[b];
+  }
+
+  bundle->field = zfp_field_3d(bundle->data, zfp_type_double, NX, NY, NZ);
+  bundle->zfp = zfp_stream_open(NULL);
+  zfp_stream_set_accuracy(bundle->zfp, 1e-4);
+
+  bufsize = zfp_stream_maximum_size(bundle->zfp, bundle->field);
+  bundle->buffer = malloc(bufsize);
+  assert_non_null(bundle->buffer);
+  bundle->stream = stream_open(bundle->buffer, bufsize);
+  zfp_stream_set_bit_stream(bundle->zfp, bundle->stream);
+
+  *state = bundle;
+
+  return 0;
+}
+
+static int
+teardown(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  zfp_stream_close(bundle->zfp);
+  stream_close(bundle->stream);
+  free(bundle->buffer);
+  zfp_field_free(bundle->field);
+  free(bundle->data);
+  free(bundle->expected);
+  free(bundle->decompressed);
+  free(bundle);
+
+  return 0;
+}
+
+/* decompress whole field with zfp_decompress for reference */
+static void
+decompress_reference(struct setupVars *bundle)
+{
+  zfp_field* field = zfp_field_3d(bundle->expected, zfp_type_double, NX, NY, NZ);
+
+  zfp_stream_rewind(bundle->zfp);
+  assert_true(zfp_compress(bundle->zfp, bundle->field) != 0);
+  zfp_stream_rewind(bundle->zfp);
+  assert_true(zfp_decompress(bundle->zfp, field) != 0);
+
+  zfp_field_free(field);
+}
+
+/* whether value at (x, y, z) lies in active block */
+static int
+is_active(const struct setupVars *bundle, size_t x, size_t y, size_t z)
+{
+  return bundle->active[x / 4 + BX * (y / 4 + BY * (z / 4))];
+}
+
+static void
+given_sparseField_when_decompressSparse_expect_activeBlocksScatteredAndOthersUnchanged(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_field* output = zfp_field_3d(bundle->decompressed, zfp_type_double, NX, NY, NZ);
+  uint8 active[BLOCKS];
+  size_t bytes, x, y, z;
+
+  zfp_stream_rewind(bundle->zfp);
+  bytes = zfp_compress_sparse(bundle->zfp, bundle->field, bundle->active, NULL);
+  assert_true(bytes != 0);
+  assert_true(bytes <= zfp_sparse_maximum_size(bundle->zfp, bundle->field, bundle->count));
+
+  zfp_stream_rewind(bundle->zfp);
+  memset(active, 0xff, sizeof(active));
+  assert_int_equal(zfp_decompress_sparse(bundle->zfp, output, active, NULL), bytes);
+  assert_memory_equal(active, bundle->active, sizeof(active));
+
+  /* blocks are coded independently, so active blocks match dense decompression */
+  decompress_reference(bundle);
+  for (z = 0; z < NZ; z++)
+    for (y = 0; y < NY; y++)
+      for (x = 0; x < NX; x++) {
+        size_t i = x + NX * (y + NY * z);
+        if (is_active(bundle, x, y, z))
+          assert_true(bundle->decompressed[i] == bundle->expected[i]);
+        else
+          assert_true(bundle->decompressed[i] == 0);
+      }
+
+  /* only active blocks are stored */
+  assert_true(bytes < zfp_stream_compressed_size(bundle->zfp));
+
+  zfp_field_free(output);
+}
+
+static void
+given_bricks_when_sparseRoundTripInReversibleMode_expect_exactPackedBricks(void **state)
+{
+  struct setupVars *bundle = *state;
+  double* bricks = malloc(bundle->count * 64 * sizeof(double));
+  double* packed = malloc(bundle->count * 64 * sizeof(double));
+  uint8 active[BLOCKS];
+  size_t b, n, i;
+
+  /* gather active blocks into packed bricks, padding partial blocks */
+  for (b = n = 0; b < BLOCKS; b++)
+    if (bundle->active[b]) {
+      size_t x0 = 4 * (b % BX), y0 = 4 * (b / BX % BY), z0 = 4 * (b / (BX * BY));
+      for (i = 0; i < 64; i++) {
+        size_t x = MIN(x0 + i % 4, NX - 1), y = MIN(y0 + i / 4 % 4, NY - 1), z = MIN(z0 + i / 16, NZ - 1);
+        bricks[64 * n + i] = bundle->data[x + NX * (y + NY * z)];
+      }
+      n++;
+    }
+
+  zfp_stream_set_reversible(bundle->zfp);
+  zfp_stream_rewind(bundle->zfp);
+  assert_true(zfp_compress_sparse(bundle->zfp, bundle->field, bundle->active, bricks) != 0);
+
+  /* bitmap can be read before sizing bricks */
+  zfp_stream_rewind(bundle->zfp);
+  assert_int_equal(zfp_sparse_map(bundle->zfp, bundle->field, active), bundle->count);
+  assert_memory_equal(active, bundle->active, sizeof(active));
+
+  assert_true(zfp_decompress_sparse(bundle->zfp, bundle->field, NULL, packed) != 0);
+  assert_memory_equal(packed, bricks, bundle->count * 64 * sizeof(double));
+
+  free(packed);
+  free(bricks);
+}
+
+static void
+given_noActiveBlocks_when_compressSparse_expect_bitmapOnly(void **state)
+{
+  struct setupVars *bundle = *state;
+  uint8 active[BLOCKS];
+
+  memset(active, 0, sizeof(active));
+  zfp_stream_rewind(bundle->zfp);
+  assert_int_equal(zfp_compress_sparse(bundle->zfp, bundle->field, active, NULL), zfp_sparse_maximum_size(bundle->zfp, bundle->field, 0));
+  zfp_stream_rewind(bundle->zfp);
+  assert_int_equal(zfp_sparse_map(bundle->zfp, bundle->field, NULL), 0);
+
+  /* more active blocks than the bounding box holds */
+  assert_int_equal(zfp_sparse_maximum_size(bundle->zfp, bundle->field, BLOCKS + 1), 0);
+}
+
+int main()
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test_setup_teardown(given_sparseField_when_decompressSparse_expect_activeBlocksScatteredAndOthersUnchanged, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_bricks_when_sparseRoundTripInReversibleMode_expect_exactPackedBricks, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_noActiveBlocks_when_compressSparse_expect_bitmapOnly, setup, teardown),
+  };
+
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,206 @@
+#include "zfp.h"
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+/* 4 x 4 x 3 blocks of which the first row of blocks is zero and the second constant */
+#define NX 16
+#define NY 16
+#define NZ 12
+#define FIELD_SIZE (NX * NY * NZ)
+#define BLOCKS (FIELD_SIZE / 64)
+#define ZERO_BLOCKS 4
+#define CONSTANT_BLOCKS 4
+
+struct setupVars {
+  zfp_stream* stream;
+  zfp_field* field;
+  double* data;
+  void* buffer;
+  void* reference;
+  size_t bufferSize;
+};
+
+static int
+setup(void **state)
+{
+  struct setupVars *bundle = malloc(sizeof(struct setupVars));
+  assert_non_null(bundle);
+
+  bundle->data = malloc(FIELD_SIZE * sizeof(double));
+  assert_non_null(bundle->data);
+
+  size_t x, y, z;
+  for (z = 0; z < NZ; z++)
+    for (y = 0; y < NY; y++)
+      for (x = 0; x < NX; x++) {
+        double v = (double)((x * y + z) % 17) - 0.25 * (double)x;
+        if (z < 4 && y < 4)
+          v = 0;
+        else if (z < 4 && y < 8)
+          v = 3.5;
+        bundle->data[x + NX * (y + NY * z)] = v;
+      }
+
+  bundle->stream = zfp_stream_open(NULL);
+  bundle->field = zfp_field_3d(bundle->data, zfp_type_double, NX, NY, NZ);
+  zfp_stream_set_accuracy(bundle->stream, 1e-3);
+  bundle->bufferSize = zfp_stream_maximum_size(bundle->stream, bundle->field);
+
+  bundle->buffer = calloc(bundle->bufferSize, 1);
+  bundle->reference = calloc(bundle->bufferSize, 1);
+  assert_non_null(bundle->buffer);
+  assert_non_null(bundle->reference);
+
+  *state = bundle;
+
+  return 0;
+}
+
+static int
+teardown(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  zfp_field_free(bundle->field);
+  zfp_stream_close(bundle->stream);
+  free(bundle->reference);
+  free(bundle->buffer);
+  free(bundle->data);
+  free(bundle);
+
+  return 0;
+}
+
+/* compress field to buffer and return stream size */
+static size_t
+compressField(struct setupVars *bundle, void* buffer)
+{
+  bitstream* bs = stream_open(buffer, bundle->bufferSize);
+  size_t size;
+
+  zfp_stream_set_bit_stream(bundle->stream, bs);
+  size = zfp_compress(bundle->stream, bundle->field);
+  stream_close(bs);
+
+  return size;
+}
+
+static uint64
+histogramSum(const zfp_stream_stats* stats)
+{
+  uint64 sum = 0;
+  uint i;
+  for (i = 0; i < ZFP_STATS_BINS; i++)
+    sum += stats->histogram[i];
+  return sum;
+}
+
+static void
+given_openedZfpStream_when_zfpStreamStatistics_expect_returnsNull(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  assert_null(zfp_stream_statistics(bundle->stream));
+}
+
+static void
+given_zfpStreamWithStats_when_zfpCompress_expect_streamUnchanged(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_stream_stats stats;
+  memset(&stats, 0, sizeof(stats));
+
+  size_t size = compressField(bundle, bundle->reference);
+  assert_int_not_equal(size, 0);
+
+  zfp_stream_set_stats(bundle->stream, &stats);
+  assert_ptr_equal(zfp_stream_statistics(bundle->stream), &stats);
+  assert_int_equal(compressField(bundle, bundle->buffer), size);
+  assert_memory_equal(bundle->buffer, bundle->reference, size);
+}
+
+static void
+given_zfpStreamWithStats_when_zfpCompress_expect_blocksCounted(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_stream_stats stats;
+  memset(&stats, 0, sizeof(stats));
+
+  zfp_stream_set_stats(bundle->stream, &stats);
+  size_t size = compressField(bundle, bundle->buffer);
+
+  assert_int_equal(stats.blocks, BLOCKS);
+  assert_int_equal(stats.zero_blocks, ZERO_BLOCKS);
+  assert_int_equal(stats.constant_blocks, CONSTANT_BLOCKS);
+  assert_int_equal(histogramSum(&stats), BLOCKS);
+  assert_true(stats.bit_planes > 0);
+  /* stream is padded to a whole number of words */
+  assert_true(stats.bits <= 8 * size);
+  assert_true(8 * size - stats.bits < stream_word_bits);
+  assert_true(stats.coding_time >= 0);
+}
+
+static void
+given_zfpStreamWithStats_when_zfpDecompress_expect_blocksCounted(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_stream_stats stats;
+  memset(&stats, 0, sizeof(stats));
+
+  size_t size = compressField(bundle, bundle->buffer);
+  bitstream* bs = stream_open(bundle->buffer, size);
+  zfp_stream_set_bit_stream(bundle->stream, bs);
+  zfp_stream_set_stats(bundle->stream, &stats);
+  assert_int_equal(zfp_decompress(bundle->stream, bundle->field), size);
+  stream_close(bs);
+
+  assert_int_equal(stats.blocks, BLOCKS);
+  assert_int_equal(stats.zero_blocks, ZERO_BLOCKS);
+  assert_int_equal(stats.constant_blocks, CONSTANT_BLOCKS);
+  assert_int_equal(histogramSum(&stats), BLOCKS);
+  assert_true(8 * size - stats.bits < stream_word_bits);
+}
+
+static void
+given_zfpStreamWithStats_when_zfpStatsReset_expect_countsZeroed_and_threadBlocksRetained(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_stream_stats stats;
+  uint64 thread_blocks[2] = { 1, 2 };
+  memset(&stats, 0, sizeof(stats));
+  stats.threads = 2;
+  stats.thread_blocks = thread_blocks;
+
+  zfp_stream_set_stats(bundle->stream, &stats);
+  compressField(bundle, bundle->buffer);
+  assert_int_not_equal(stats.blocks, 0);
+
+  zfp_stats_reset(&stats);
+  assert_int_equal(stats.blocks, 0);
+  assert_int_equal(stats.bits, 0);
+  assert_int_equal(histogramSum(&stats), 0);
+  assert_true(stats.coding_time == 0);
+  assert_int_equal(stats.threads, 2);
+  assert_ptr_equal(stats.thread_blocks, thread_blocks);
+  assert_int_equal(thread_blocks[0], 0);
+  assert_int_equal(thread_blocks[1], 0);
+}
+
+int main()
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test_setup_teardown(given_openedZfpStream_when_zfpStreamStatistics_expect_returnsNull, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_zfpStreamWithStats_when_zfpCompress_expect_streamUnchanged, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_zfpStreamWithStats_when_zfpCompress_expect_blocksCounted, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_zfpStreamWithStats_when_zfpDecompress_expect_blocksCounted, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_zfpStreamWithStats_when_zfpStatsReset_expect_countsZeroed_and_threadBlocksRetained, setup, teardown),
+  };
+
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
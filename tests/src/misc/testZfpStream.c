@@ -5,6 +5,7 @@
 #include <setjmp.h>
 #include <cmocka.h>
 
+#include <float.h>
 #include <limits.h>
 #include <math.h>
 #include <stdlib.h>
@@ -545,6 +546,232 @@ given_invalidCompressParamsModeVal_when_zfpStreamSetMode_expect_returnsNullMode_
   assertCompressParamsBehaviorThroughSetMode(state, zfp_mode_null);
 }
 
+/* compress 2d field of given values and return compressed size in bytes */
+static size_t
+compressField(zfp_stream* stream, zfp_field* field)
+{
+  size_t bufferSize = zfp_stream_maximum_size(stream, field);
+  void* buffer = malloc(bufferSize);
+  assert_non_null(buffer);
+
+  bitstream* bs = stream_open(buffer, bufferSize);
+  zfp_stream_set_bit_stream(stream, bs);
+  zfp_stream_rewind(stream);
+  size_t size = zfp_compress(stream, field);
+
+  zfp_stream_set_bit_stream(stream, NULL);
+  stream_close(bs);
+  free(buffer);
+
+  return size;
+}
+
+static void
+given_zfpStreamSetAccuracy_when_zfpStreamEstimateSizeAllBlocks_expect_returnsCompressedSize(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_stream* stream = bundle->stream;
+  double data[30 * 21];
+  size_t i, bound;
+  for (i = 0; i < 30 * 21; i++)
+    data[i] = sin(0.1 * (double)i) * (double)(i % 30);
+  zfp_field* field = zfp_field_2d(data, zfp_type_double, 30, 21);
+  zfp_stream_set_accuracy(stream, 1e-3);
+
+  size_t size = compressField(stream, field);
+  assert_int_equal(zfp_stream_estimate_size(stream, field, 1.0, &bound), size);
+  assert_int_equal(bound, size);
+
+  zfp_field_free(field);
+}
+
+static void
+given_zfpStreamSetRate_when_zfpStreamEstimateSize_expect_returnsCompressedSize(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_stream* stream = bundle->stream;
+  float data[30 * 21];
+  size_t i, bound;
+  for (i = 0; i < 30 * 21; i++)
+    data[i] = (float)(i % 17);
+  zfp_field* field = zfp_field_2d(data, zfp_type_float, 30, 21);
+  zfp_stream_set_rate(stream, 7, zfp_type_float, 2, zfp_false);
+
+  size_t size = compressField(stream, field);
+  assert_int_equal(zfp_stream_estimate_size(stream, field, 0.01, &bound), size);
+  assert_int_equal(bound, size);
+
+  zfp_field_free(field);
+}
+
+static void
+given_zfpStreamSetPrecision_when_zfpStreamEstimateSizeSampled_expect_boundWithinMaximumSize(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_stream* stream = bundle->stream;
+  int32 data[40 * 40];
+  size_t i, bound;
+  for (i = 0; i < 40 * 40; i++)
+    data[i] = (int32)((i * i) % 1009) - 500;
+  zfp_field* field = zfp_field_2d(data, zfp_type_int32, 40, 40);
+  zfp_stream_set_precision(stream, 20);
+
+  size_t estimate = zfp_stream_estimate_size(stream, field, 0.25, &bound);
+  assert_int_not_equal(estimate, 0);
+  assert_true(estimate <= bound);
+  assert_true(bound <= zfp_stream_maximum_size(stream, field));
+  assert_int_equal(zfp_stream_estimate_size(stream, field, 0.25, NULL), estimate);
+
+  zfp_field_free(field);
+}
+
+static void
+given_largeTolerance_when_zfpStreamMaximumSize_expect_boundByTypeExponentRange(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_stream* stream = bundle->stream;
+  double data[30 * 21];
+  size_t i;
+  for (i = 0; i < 30 * 21; i++)
+    data[i] = ldexp(sin(0.7 * (double)i), 1000 + (int)(i % 24));
+  zfp_field* field = zfp_field_2d(data, zfp_type_double, 30, 21);
+
+  /* no bit planes can be stored above the largest double exponent */
+  zfp_stream_set_params(stream, ZFP_MIN_BITS, ZFP_MAX_BITS, ZFP_MAX_PREC, DBL_MAX_EXP + 6);
+  size_t bound = zfp_stream_maximum_size(stream, field);
+  assert_int_equal(bound, (ZFP_HEADER_MAX_BITS + 8 * 6 * (1 + 11) + 63) / 64 * 8);
+  assert_true(compressField(stream, field) <= bound);
+
+  /* a few bit planes are */
+  zfp_stream_set_accuracy(stream, ldexp(1.0, DBL_MAX_EXP - 4));
+  bound = zfp_stream_maximum_size(stream, field);
+  assert_int_equal(bound, (ZFP_HEADER_MAX_BITS + 8 * 6 * (1 + 11 + 15 + 16 * 10) + 63) / 64 * 8);
+  assert_true(compressField(stream, field) <= bound);
+
+  zfp_field_free(field);
+}
+
+static void
+given_rawBlocksAndVerification_when_zfpStreamMaximumSize_expect_boundsRepairedBlocks(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_stream* stream = bundle->stream;
+  zfp_verification verification = { 0 };
+  float data[30 * 21];
+  size_t i;
+  for (i = 0; i < 30 * 21; i++)
+    data[i] = (float)((i * 7919) % 1013) - 500.5f;
+  zfp_field* field = zfp_field_2d(data, zfp_type_float, 30, 21);
+
+  /* every block violates the tolerance and is stored verbatim */
+  zfp_stream_set_precision(stream, 4);
+  zfp_stream_set_raw_blocks(stream, zfp_true);
+  zfp_stream_set_verification(stream, &verification);
+  size_t size = compressField(stream, field);
+  assert_int_equal(verification.repaired, 8 * 6);
+  assert_true(size <= zfp_stream_maximum_size(stream, field));
+
+  zfp_field_free(field);
+}
+
+static void
+given_zfpField_when_zfpStreamSetTargetRatioPrecision_expect_largestPrecisionWithinBudget(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_stream* stream = bundle->stream;
+  double data[30 * 21];
+  size_t i;
+  for (i = 0; i < 30 * 21; i++)
+    data[i] = sin(0.1 * (double)i) * (double)(i % 30);
+  zfp_field* field = zfp_field_2d(data, zfp_type_double, 30, 21);
+  size_t budget = (size_t)(sizeof(data) / 6.0);
+
+  uint precision = (uint)zfp_stream_set_target_ratio(stream, field, zfp_mode_fixed_precision, 6, 1);
+  assert_int_equal(zfp_stream_compression_mode(stream), zfp_mode_fixed_precision);
+  assert_int_equal(zfp_stream_precision(stream), precision);
+  assert_true(compressField(stream, field) <= budget);
+
+  zfp_stream_set_precision(stream, precision + 1);
+  assert_true(compressField(stream, field) > budget);
+
+  zfp_field_free(field);
+}
+
+static void
+given_zfpField_when_zfpStreamSetTargetRatioAccuracy_expect_smallestToleranceWithinBudget(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_stream* stream = bundle->stream;
+  float data[30 * 21];
+  size_t i;
+  for (i = 0; i < 30 * 21; i++)
+    data[i] = (float)(sin(0.1 * (double)i) * (double)(i % 30));
+  zfp_field* field = zfp_field_2d(data, zfp_type_float, 30, 21);
+  size_t budget = (size_t)(sizeof(data) / 4.0);
+
+  double tolerance = zfp_stream_set_target_ratio(stream, field, zfp_mode_fixed_accuracy, 4, 1);
+  assert_int_equal(zfp_stream_compression_mode(stream), zfp_mode_fixed_accuracy);
+  assert_true(zfp_stream_accuracy(stream) == tolerance);
+  assert_true(compressField(stream, field) <= budget);
+
+  zfp_stream_set_accuracy(stream, tolerance / 2);
+  assert_true(compressField(stream, field) > budget);
+
+  zfp_field_free(field);
+}
+
+static void
+given_intField_when_zfpStreamSetTargetRatioAccuracy_expect_returnsZero_and_paramsUnchanged(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_stream* stream = bundle->stream;
+  int32 data[16] = {0};
+  zfp_field* field = zfp_field_1d(data, zfp_type_int32, 16);
+  zfp_stream_set_precision(stream, 13);
+  uint64 mode = zfp_stream_mode(stream);
+
+  assert_true(zfp_stream_set_target_ratio(stream, field, zfp_mode_fixed_accuracy, 4, 1) == 0);
+  assert_true(zfp_stream_set_target_ratio(stream, field, zfp_mode_fixed_precision, 0, 1) == 0);
+  assert_true(zfp_stream_mode(stream) == mode);
+
+  zfp_field_free(field);
+}
+
+static void
+given_stackAllocatedStreams_when_zfpCompress_expect_sameStreamAsOpenedStreams(void **state)
+{
+  struct setupVars *bundle = *state;
+  double data[64];
+  uint64 heapBuffer[64] = {0};
+  uint64 stackBuffer[64] = {0};
+  size_t i;
+
+  for (i = 0; i < 64; i++)
+    data[i] = sin(0.1 * (double)i);
+  zfp_field* field = zfp_field_1d(data, zfp_type_double, 64);
+
+  // heap-allocated streams
+  bitstream* s = stream_open(heapBuffer, sizeof(heapBuffer));
+  zfp_stream_set_bit_stream(bundle->stream, s);
+  zfp_stream_set_accuracy(bundle->stream, 1e-3);
+  size_t size = zfp_compress(bundle->stream, field);
+  assert_int_not_equal(size, 0);
+
+  // caller-owned streams initialized in place
+  stream_storage storage;
+  zfp_stream zfp;
+  assert_true(stream_struct_bytes <= sizeof(storage));
+  zfp_stream_init(&zfp, stream_init(&storage, stackBuffer, sizeof(stackBuffer)));
+  assert_int_equal(zfp_stream_compression_mode(&zfp), zfp_mode_expert);
+  zfp_stream_set_accuracy(&zfp, 1e-3);
+  assert_int_equal(zfp_compress(&zfp, field), size);
+  assert_memory_equal(stackBuffer, heapBuffer, size);
+  zfp_stream_release(&zfp);
+
+  zfp_field_free(field);
+  stream_close(s);
+}
+
 int main()
 {
   const struct CMUnitTest tests[] = {
@@ -571,6 +798,23 @@ int main()
     cmocka_unit_test_setup_teardown(given_zfpStreamSetReversibleModeVal_when_zfpStreamSetMode_expect_returnsReversible_and_compressParamsConserved, setup, teardown),
     cmocka_unit_test_setup_teardown(given_customCompressParamsModeVal_when_zfpStreamSetMode_expect_returnsExpert_and_compressParamsConserved, setup, teardown),
     cmocka_unit_test_setup_teardown(given_invalidCompressParamsModeVal_when_zfpStreamSetMode_expect_returnsNullMode_and_paramsNotSet, setup, teardown),
+
+    /* test zfp_stream_estimate_size() */
+    cmocka_unit_test_setup_teardown(given_zfpStreamSetAccuracy_when_zfpStreamEstimateSizeAllBlocks_expect_returnsCompressedSize, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_zfpStreamSetRate_when_zfpStreamEstimateSize_expect_returnsCompressedSize, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_zfpStreamSetPrecision_when_zfpStreamEstimateSizeSampled_expect_boundWithinMaximumSize, setup, teardown),
+
+    /* test zfp_stream_maximum_size() */
+    cmocka_unit_test_setup_teardown(given_largeTolerance_when_zfpStreamMaximumSize_expect_boundByTypeExponentRange, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_rawBlocksAndVerification_when_zfpStreamMaximumSize_expect_boundsRepairedBlocks, setup, teardown),
+
+    /* test zfp_stream_set_target_ratio() */
+    cmocka_unit_test_setup_teardown(given_zfpField_when_zfpStreamSetTargetRatioPrecision_expect_largestPrecisionWithinBudget, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_zfpField_when_zfpStreamSetTargetRatioAccuracy_expect_smallestToleranceWithinBudget, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_intField_when_zfpStreamSetTargetRatioAccuracy_expect_returnsZero_and_paramsUnchanged, setup, teardown),
+
+    /* test zfp_stream_init() */
+    cmocka_unit_test_setup_teardown(given_stackAllocatedStreams_when_zfpCompress_expect_sameStreamAsOpenedStreams, setup, teardown),
   };
 
   return cmocka_run_group_tests(tests, NULL, NULL);
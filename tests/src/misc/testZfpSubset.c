@@ -0,0 +1,306 @@
+#include "zfp.h"
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#define NX 13
+#define NY 11
+#define NZ 9
+#define FIELD_SIZE (NX * NY * NZ)
+#define BLOCKS (((NX + 3) / 4) * ((NY + 3) / 4) * ((NZ + 3) / 4))
+#define CHUNKS 5
+
+struct setupVars {
+  zfp_stream* stream;
+  zfp_field* field;
+  zfp_index* index;
+  double* data;
+  double* decompressed;
+  double* box;
+  void* buffer;
+  size_t bufferSize;
+  size_t streamSize;
+};
+
+static int
+setup(void **state, zfp_bool fixedRate)
+{
+  struct setupVars *bundle = malloc(sizeof(struct setupVars));
+  assert_non_null(bundle);
+
+  bundle->data = malloc(FIELD_SIZE * sizeof(double));
+  bundle->decompressed = calloc(FIELD_SIZE, sizeof(double));
+  bundle->box = calloc(FIELD_SIZE, sizeof(double));
+  assert_non_null(bundle->data);
+  assert_non_null(bundle->decompressed);
+  assert_non_null(bundle->box);
+
+  size_t i;
+  for (i = 0; i < FIELD_SIZE; i++)
+    bundle->data[i] = (double)(i % 23) * (double)(i % 7) - 0.125 * (double)i;
+
+  bundle->stream = zfp_stream_open(NULL);
+  bundle->field = zfp_field_3d(bundle->data, zfp_type_double, NX, NY, NZ);
+  bundle->index = zfp_index_alloc();
+  assert_non_null(bundle->index);
+  if (fixedRate)
+    /* blocks of 96 bits are not word aligned */
+    zfp_stream_set_rate(bundle->stream, 1.5, zfp_type_double, 3, zfp_false);
+  else
+    zfp_stream_set_accuracy(bundle->stream, 1e-3);
+  bundle->bufferSize = zfp_stream_maximum_size(bundle->stream, bundle->field);
+  bundle->buffer = calloc(bundle->bufferSize, 1);
+  assert_non_null(bundle->buffer);
+
+  /* compress and decompress whole field for reference */
+  bitstream* bs = stream_open(bundle->buffer, bundle->bufferSize);
+  zfp_stream_set_bit_stream(bundle->stream, bs);
+  bundle->streamSize = zfp_compress(bundle->stream, bundle->field);
+  assert_int_not_equal(bundle->streamSize, 0);
+  zfp_stream_rewind(bundle->stream);
+  zfp_field_set_pointer(bundle->field, bundle->decompressed);
+  assert_int_equal(zfp_decompress(bundle->stream, bundle->field), bundle->streamSize);
+  zfp_stream_rewind(bundle->stream);
+
+  *state = bundle;
+
+  return 0;
+}
+
+static int
+setupFixedRate(void **state)
+{
+  return setup(state, zfp_true);
+}
+
+static int
+setupFixedAccuracy(void **state)
+{
+  return setup(state, zfp_false);
+}
+
+static int
+teardown(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  stream_close(zfp_stream_bit_stream(bundle->stream));
+  zfp_index_free(bundle->index);
+  zfp_field_free(bundle->field);
+  zfp_stream_close(bundle->stream);
+  free(bundle->buffer);
+  free(bundle->box);
+  free(bundle->decompressed);
+  free(bundle->data);
+  free(bundle);
+
+  return 0;
+}
+
+/* record offsets of chunks of consecutive blocks by decoding blocks one at a time */
+static void
+buildIndex(struct setupVars *bundle)
+{
+  zfp_stream* stream = bundle->stream;
+  uint64 offset[CHUNKS + 1];
+  double block[64];
+  size_t chunk = 0;
+  size_t i;
+
+  for (i = 0; i < BLOCKS; i++) {
+    if (i == (size_t)BLOCKS * chunk / CHUNKS)
+      offset[chunk++] = stream_rtell(zfp_stream_bit_stream(stream));
+    zfp_decode_block_double_3(stream, block);
+  }
+  offset[CHUNKS] = stream_rtell(zfp_stream_bit_stream(stream));
+  assert_int_equal(zfp_index_set(bundle->index, CHUNKS, offset), zfp_true);
+  zfp_stream_set_index(stream, bundle->index);
+  zfp_stream_rewind(stream);
+}
+
+/* decompress box and compare with corresponding values of whole field */
+static void
+assertBoxMatchesZfpDecompress(struct setupVars *bundle, size_t x0, size_t y0, size_t z0, size_t nx, size_t ny, size_t nz)
+{
+  size_t x, y, z;
+
+  zfp_stream_rewind(bundle->stream);
+  zfp_field_set_pointer(bundle->field, bundle->box);
+  assert_int_equal(zfp_decompress_subset(bundle->stream, bundle->field, x0, y0, z0, nx, ny, nz), bundle->streamSize);
+
+  for (z = 0; z < nz; z++)
+    for (y = 0; y < ny; y++)
+      for (x = 0; x < nx; x++)
+        assert_true(bundle->box[x + nx * (y + ny * z)] == bundle->decompressed[(x0 + x) + NX * ((y0 + y) + NY * (z0 + z))]);
+}
+
+static void
+assertBoxesMatchZfpDecompress(struct setupVars *bundle)
+{
+  assertBoxMatchesZfpDecompress(bundle, 0, 0, 0, NX, NY, NZ);
+  assertBoxMatchesZfpDecompress(bundle, 5, 2, 3, 1, 1, 1);
+  assertBoxMatchesZfpDecompress(bundle, 3, 7, 1, 7, 4, 8);
+  assertBoxMatchesZfpDecompress(bundle, 9, 0, 8, 4, 11, 1);
+}
+
+static void
+given_fixedRateStream_when_zfpDecompressSubset_expect_boxMatchesZfpDecompress(void **state)
+{
+  assertBoxesMatchZfpDecompress(*state);
+}
+
+static void
+given_indexedStream_when_zfpDecompressSubset_expect_boxMatchesZfpDecompress(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  buildIndex(bundle);
+  assertBoxesMatchZfpDecompress(bundle);
+}
+
+static void
+given_unindexedVariableRateStream_when_zfpDecompressSubset_expect_returnsZero(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  zfp_field_set_pointer(bundle->field, bundle->box);
+  assert_int_equal(zfp_decompress_subset(bundle->stream, bundle->field, 0, 0, 0, 1, 1, 1), 0);
+}
+
+/* decompress listed blocks into bricks and into field and compare with whole field */
+static void
+assertBlocksMatchZfpDecompress(struct setupVars *bundle)
+{
+  /* blocks out of order, including last partial block */
+  const size_t index[] = { 7, 2, 3, BLOCKS - 1, 0, 26 };
+  const size_t count = sizeof(index) / sizeof(*index);
+  const size_t bx = (NX + 3) / 4;
+  const size_t by = (NY + 3) / 4;
+  double bricks[sizeof(index) / sizeof(*index) * 64];
+  size_t n, x, y, z;
+
+  zfp_stream_rewind(bundle->stream);
+  assert_int_equal(zfp_decompress_blocks(bundle->stream, bundle->field, index, count, bricks), bundle->streamSize);
+
+  memset(bundle->box, 0, FIELD_SIZE * sizeof(double));
+  zfp_field_set_pointer(bundle->field, bundle->box);
+  zfp_stream_rewind(bundle->stream);
+  assert_int_equal(zfp_decompress_blocks(bundle->stream, bundle->field, index, count, NULL), bundle->streamSize);
+
+  for (n = 0; n < count; n++) {
+    size_t i = 4 * (index[n] % bx);
+    size_t j = 4 * (index[n] / bx % by);
+    size_t k = 4 * (index[n] / (bx * by));
+    for (z = k; z < k + 4 && z < NZ; z++)
+      for (y = j; y < j + 4 && y < NY; y++)
+        for (x = i; x < i + 4 && x < NX; x++) {
+          size_t offset = x + NX * (y + NY * z);
+          assert_true(bricks[64 * n + (x - i) + 4 * (y - j) + 16 * (z - k)] == bundle->decompressed[offset]);
+          assert_true(bundle->box[offset] == bundle->decompressed[offset]);
+        }
+  }
+}
+
+static void
+given_fixedRateStream_when_zfpDecompressBlocks_expect_blocksMatchZfpDecompress(void **state)
+{
+  assertBlocksMatchZfpDecompress(*state);
+}
+
+static void
+given_indexedStream_when_zfpDecompressBlocks_expect_blocksMatchZfpDecompress(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  buildIndex(bundle);
+  assertBlocksMatchZfpDecompress(bundle);
+}
+
+static void
+given_blockOutsideField_when_zfpDecompressBlocks_expect_returnsZero(void **state)
+{
+  struct setupVars *bundle = *state;
+  const size_t index[] = { 0, BLOCKS };
+  double bricks[2 * 64];
+
+  assert_int_equal(zfp_decompress_blocks(bundle->stream, bundle->field, index, 2, bricks), 0);
+}
+
+/* modify values in box, recompress box in place, and compare with compressing whole field */
+static void
+assertRecompressedBoxMatchesZfpCompress(struct setupVars *bundle, size_t x0, size_t y0, size_t z0, size_t nx, size_t ny, size_t nz)
+{
+  void* reference = calloc(bundle->bufferSize, 1);
+  size_t x, y, z;
+  assert_non_null(reference);
+
+  for (z = z0; z < z0 + nz; z++)
+    for (y = y0; y < y0 + ny; y++)
+      for (x = x0; x < x0 + nx; x++)
+        bundle->data[x + NX * (y + NY * z)] += 1;
+
+  zfp_field_set_pointer(bundle->field, bundle->data);
+  zfp_stream_rewind(bundle->stream);
+  assert_int_equal(zfp_compress_subset(bundle->stream, bundle->field, x0, y0, z0, nx, ny, nz), bundle->streamSize);
+
+  bitstream* bs = stream_open(reference, bundle->bufferSize);
+  bitstream* saved = zfp_stream_bit_stream(bundle->stream);
+  zfp_stream_set_bit_stream(bundle->stream, bs);
+  assert_int_equal(zfp_compress(bundle->stream, bundle->field), bundle->streamSize);
+  zfp_stream_set_bit_stream(bundle->stream, saved);
+  stream_close(bs);
+
+  assert_memory_equal(bundle->buffer, reference, bundle->streamSize);
+  free(reference);
+}
+
+static void
+given_fixedRateStream_when_zfpCompressSubset_expect_streamMatchesZfpCompress(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  assertRecompressedBoxMatchesZfpCompress(bundle, 5, 2, 3, 1, 1, 1);
+  assertRecompressedBoxMatchesZfpCompress(bundle, 3, 7, 1, 7, 4, 8);
+  assertRecompressedBoxMatchesZfpCompress(bundle, 0, 3, 2, NX, 6, 5);
+}
+
+static void
+given_variableRateStream_when_zfpCompressSubset_expect_returnsZero(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  zfp_field_set_pointer(bundle->field, bundle->data);
+  assert_int_equal(zfp_compress_subset(bundle->stream, bundle->field, 0, 0, 0, 1, 1, 1), 0);
+}
+
+static void
+given_boxOutsideField_when_zfpDecompressSubset_expect_returnsZero(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  zfp_field_set_pointer(bundle->field, bundle->box);
+  assert_int_equal(zfp_decompress_subset(bundle->stream, bundle->field, 10, 0, 0, 4, 1, 1), 0);
+  assert_int_equal(zfp_decompress_subset(bundle->stream, bundle->field, 0, 0, 0, 1, 0, 1), 0);
+}
+
+int main()
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test_setup_teardown(given_fixedRateStream_when_zfpDecompressSubset_expect_boxMatchesZfpDecompress, setupFixedRate, teardown),
+    cmocka_unit_test_setup_teardown(given_indexedStream_when_zfpDecompressSubset_expect_boxMatchesZfpDecompress, setupFixedAccuracy, teardown),
+    cmocka_unit_test_setup_teardown(given_unindexedVariableRateStream_when_zfpDecompressSubset_expect_returnsZero, setupFixedAccuracy, teardown),
+    cmocka_unit_test_setup_teardown(given_boxOutsideField_when_zfpDecompressSubset_expect_returnsZero, setupFixedRate, teardown),
+    cmocka_unit_test_setup_teardown(given_fixedRateStream_when_zfpDecompressBlocks_expect_blocksMatchZfpDecompress, setupFixedRate, teardown),
+    cmocka_unit_test_setup_teardown(given_indexedStream_when_zfpDecompressBlocks_expect_blocksMatchZfpDecompress, setupFixedAccuracy, teardown),
+    cmocka_unit_test_setup_teardown(given_blockOutsideField_when_zfpDecompressBlocks_expect_returnsZero, setupFixedRate, teardown),
+    cmocka_unit_test_setup_teardown(given_fixedRateStream_when_zfpCompressSubset_expect_streamMatchesZfpCompress, setupFixedRate, teardown),
+    cmocka_unit_test_setup_teardown(given_variableRateStream_when_zfpCompressSubset_expect_returnsZero, setupFixedAccuracy, teardown),
+  };
+
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,224 @@
+#include "zfp.h"
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* time series of slowly varying 3D fields */
+#define NX 16
+#define NY 12
+#define NZ 10
+#define FIELD_SIZE (NX * NY * NZ)
+#define STEPS 8
+#define INTERVAL 4
+
+struct setupVars {
+  double* data;
+  double* decoded;
+  void* buffer;
+  size_t bufferSize;
+  zfp_field* field;
+  zfp_stream* stream;
+  bitstream* s;
+  zfp_temporal* encoder;
+  zfp_temporal* decoder;
+};
+
+static int
+setup(void **state)
+{
+  struct setupVars *bundle = malloc(sizeof(struct setupVars));
+  assert_non_null(bundle);
+
+  bundle->data = malloc(FIELD_SIZE * sizeof(double));
+  bundle->decoded = calloc(FIELD_SIZE, sizeof(double));
+  assert_non_null(bundle->data);
+  assert_non_null(bundle->decoded);
+
+  bundle->field = zfp_field_3d(bundle->data, zfp_type_double, NX, NY, NZ);
+  bundle->stream = zfp_stream_open(NULL);
+  zfp_stream_set_reversible(bundle->stream);
+  bundle->bufferSize = STEPS * zfp_stream_maximum_size(bundle->stream, bundle->field);
+  bundle->buffer = calloc(bundle->bufferSize, 1);
+  assert_non_null(bundle->buffer);
+  bundle->s = stream_open(bundle->buffer, bundle->bufferSize);
+  zfp_stream_set_bit_stream(bundle->stream, bundle->s);
+
+  bundle->encoder = zfp_temporal_create(bundle->field, INTERVAL);
+  bundle->decoder = zfp_temporal_create(bundle->field, INTERVAL);
+  assert_non_null(bundle->encoder);
+  assert_non_null(bundle->decoder);
+
+  *state = bundle;
+
+  return 0;
+}
+
+static int
+teardown(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  zfp_temporal_free(bundle->decoder);
+  zfp_temporal_free(bundle->encoder);
+  zfp_field_free(bundle->field);
+  zfp_stream_close(bundle->stream);
+  stream_close(bundle->s);
+  free(bundle->buffer);
+  free(bundle->decoded);
+  free(bundle->data);
+  free(bundle);
+
+  return 0;
+}
+
+/* values at given step, which change only in the two lowest xy planes */
+static void
+initialize(double* data, uint step)
+{
+  size_t i;
+  for (i = 0; i < FIELD_SIZE; i++) {
+    data[i] = sin(0.05 * (double)i) * (double)(i % 11);
+    if (i < 2 * NX * NY)
+      data[i] += 1e-3 * (double)step * cos(0.02 * (double)i);
+  }
+}
+
+/* compress all steps, recording the stream size after each */
+static void
+compressSeries(struct setupVars *bundle, size_t* sizes)
+{
+  uint t;
+  for (t = 0; t < STEPS; t++) {
+    initialize(bundle->data, t);
+    assert_int_equal(zfp_temporal_keyframe(bundle->encoder), t % INTERVAL == 0);
+    sizes[t] = zfp_temporal_compress(bundle->encoder, bundle->stream, bundle->field);
+    assert_int_not_equal(sizes[t], 0);
+  }
+  zfp_stream_rewind(bundle->stream);
+}
+
+static void
+given_reversibleSeries_when_zfpTemporalDecompress_expect_exactValuesAndSmallerDeltaFrames(void **state)
+{
+  struct setupVars *bundle = *state;
+  size_t sizes[STEPS];
+  uint t;
+
+  compressSeries(bundle, sizes);
+
+  /* residual frames are cheaper than keyframes */
+  assert_true(sizes[1] - sizes[0] < sizes[0]);
+  assert_true(sizes[INTERVAL + 1] - sizes[INTERVAL] < sizes[INTERVAL] - sizes[INTERVAL - 1]);
+
+  zfp_field* field = zfp_field_3d(bundle->decoded, zfp_type_double, NX, NY, NZ);
+  for (t = 0; t < STEPS; t++) {
+    assert_int_equal(zfp_temporal_decompress(bundle->decoder, bundle->stream, field), sizes[t]);
+    initialize(bundle->data, t);
+    assert_memory_equal(bundle->decoded, bundle->data, FIELD_SIZE * sizeof(double));
+  }
+  zfp_field_free(field);
+}
+
+static void
+given_fixedAccuracySeries_when_zfpTemporalDecompress_expect_errorsWithinToleranceAtEachStep(void **state)
+{
+  struct setupVars *bundle = *state;
+  const double tolerance = 1e-4;
+  size_t sizes[STEPS];
+  uint t;
+
+  zfp_stream_set_accuracy(bundle->stream, tolerance);
+  compressSeries(bundle, sizes);
+
+  /* decode into a strided field to exercise gathering of the reference */
+  double* strided = calloc(2 * FIELD_SIZE, sizeof(double));
+  assert_non_null(strided);
+  zfp_field* field = zfp_field_3d(strided, zfp_type_double, NX, NY, NZ);
+  zfp_field_set_stride_3d(field, 2, 2 * NX, 2 * NX * NY);
+  for (t = 0; t < STEPS; t++) {
+    assert_int_equal(zfp_temporal_decompress(bundle->decoder, bundle->stream, field), sizes[t]);
+    initialize(bundle->data, t);
+    size_t i;
+    for (i = 0; i < FIELD_SIZE; i++)
+      assert_true(fabs(strided[2 * i] - bundle->data[i]) <= tolerance);
+  }
+  zfp_field_free(field);
+  free(strided);
+}
+
+static void
+given_reversibleInt32Reference_when_zfpTemporalSetReference_expect_firstStepIsDeltaFrame(void **state)
+{
+  struct setupVars *bundle = *state;
+  int32 reference[FIELD_SIZE];
+  int32 values[FIELD_SIZE];
+  int32 decoded[FIELD_SIZE];
+  size_t i;
+
+  for (i = 0; i < FIELD_SIZE; i++) {
+    reference[i] = (int32)(i * 2654435761u);
+    values[i] = reference[i] + (int32)(i % 3) - 1;
+  }
+
+  zfp_field* field = zfp_field_3d(values, zfp_type_int32, NX, NY, NZ);
+  zfp_field* ref = zfp_field_3d(reference, zfp_type_int32, NX, NY, NZ);
+  zfp_temporal* encoder = zfp_temporal_create(field, 0);
+  zfp_temporal* decoder = zfp_temporal_create(field, 0);
+
+  assert_true(zfp_temporal_set_reference(encoder, ref));
+  assert_true(zfp_temporal_set_reference(decoder, ref));
+  assert_false(zfp_temporal_keyframe(encoder));
+  size_t size = zfp_temporal_compress(encoder, bundle->stream, field);
+  assert_int_not_equal(size, 0);
+  assert_false(zfp_temporal_keyframe(encoder));
+
+  /* residuals of -1, 0, or 1 cost far less than the 32-bit values */
+  assert_true(size < FIELD_SIZE * sizeof(int32) / 4);
+
+  zfp_stream_rewind(bundle->stream);
+  zfp_field_set_pointer(field, decoded);
+  assert_int_equal(zfp_temporal_decompress(decoder, bundle->stream, field), size);
+  assert_memory_equal(decoded, values, sizeof(values));
+
+  zfp_temporal_reset(encoder);
+  assert_true(zfp_temporal_keyframe(encoder));
+
+  zfp_temporal_free(decoder);
+  zfp_temporal_free(encoder);
+  zfp_field_free(ref);
+  zfp_field_free(field);
+}
+
+static void
+given_fieldOfDifferentShape_when_zfpTemporalCompress_expect_returnsZero(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_field* field = zfp_field_3d(bundle->data, zfp_type_double, NX, NY, NZ - 1);
+
+  assert_int_equal(zfp_temporal_compress(bundle->encoder, bundle->stream, field), 0);
+  assert_false(zfp_temporal_set_reference(bundle->encoder, field));
+
+  zfp_field_set_size_3d(field, NX, NY, NZ);
+  zfp_field_set_type(field, zfp_type_float);
+  assert_int_equal(zfp_temporal_decompress(bundle->decoder, bundle->stream, field), 0);
+
+  zfp_field_free(field);
+}
+
+int main()
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test_setup_teardown(given_reversibleSeries_when_zfpTemporalDecompress_expect_exactValuesAndSmallerDeltaFrames, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_fixedAccuracySeries_when_zfpTemporalDecompress_expect_errorsWithinToleranceAtEachStep, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_reversibleInt32Reference_when_zfpTemporalSetReference_expect_firstStepIsDeltaFrame, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_fieldOfDifferentShape_when_zfpTemporalCompress_expect_returnsZero, setup, teardown),
+  };
+
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
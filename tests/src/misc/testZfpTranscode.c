@@ -0,0 +1,162 @@
+#include "zfp.h"
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#define NX 13
+#define NY 11
+#define NZ 9
+#define FIELD_SIZE (NX * NY * NZ)
+#define RATE 16
+
+struct setupVars {
+  zfp_field* field;
+  double* data;
+  void* source;
+  size_t sourceSize;
+};
+
+/* compress field at given rate into buffer of given size; return stream size */
+static size_t
+compressFixedRate(const zfp_field* field, double rate, void* buffer, size_t size)
+{
+  zfp_stream* stream = zfp_stream_open(NULL);
+  bitstream* bs = stream_open(buffer, size);
+
+  zfp_stream_set_rate(stream, rate, zfp_type_double, 3, zfp_false);
+  zfp_stream_set_bit_stream(stream, bs);
+  size = zfp_compress(stream, field);
+  stream_close(bs);
+  zfp_stream_close(stream);
+
+  return size;
+}
+
+/* transcode source stream to given rate; return stream size */
+static size_t
+transcode(struct setupVars *bundle, double rate, zfp_exec_policy policy, void* buffer, size_t size)
+{
+  zfp_stream* src = zfp_stream_open(stream_open(bundle->source, bundle->sourceSize));
+  zfp_stream* dst = zfp_stream_open(stream_open(buffer, size));
+
+  zfp_stream_set_rate(src, RATE, zfp_type_double, 3, zfp_false);
+  zfp_stream_set_rate(dst, rate, zfp_type_double, 3, zfp_false);
+  zfp_stream_set_execution(dst, policy);
+  size = zfp_transcode(dst, src, bundle->field);
+
+  stream_close(zfp_stream_bit_stream(src));
+  stream_close(zfp_stream_bit_stream(dst));
+  zfp_stream_close(src);
+  zfp_stream_close(dst);
+
+  return size;
+}
+
+static int
+setup(void **state)
+{
+  struct setupVars *bundle = malloc(sizeof(struct setupVars));
+  assert_non_null(bundle);
+
+  bundle->data = malloc(FIELD_SIZE * sizeof(double));
+  assert_non_null(bundle->data);
+
+  size_t i;
+  for (i = 0; i < FIELD_SIZE; i++)
+    bundle->data[i] = (double)(i % 23) * (double)(i % 7) - 0.125 * (double)i;
+
+  bundle->field = zfp_field_3d(bundle->data, zfp_type_double, NX, NY, NZ);
+  bundle->sourceSize = FIELD_SIZE * sizeof(double);
+  bundle->source = calloc(bundle->sourceSize, 1);
+  assert_non_null(bundle->source);
+  bundle->sourceSize = compressFixedRate(bundle->field, RATE, bundle->source, bundle->sourceSize);
+  assert_int_not_equal(bundle->sourceSize, 0);
+
+  *state = bundle;
+
+  return 0;
+}
+
+static int
+teardown(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  zfp_field_free(bundle->field);
+  free(bundle->source);
+  free(bundle->data);
+  free(bundle);
+
+  return 0;
+}
+
+/* transcoded stream must be bitwise identical to one compressed at the lower rate */
+static void
+assertTranscodeMatchesCompression(struct setupVars *bundle, double rate, zfp_exec_policy policy)
+{
+  size_t size = bundle->sourceSize;
+  void* expected = calloc(size, 1);
+  void* actual = calloc(size, 1);
+  assert_non_null(expected);
+  assert_non_null(actual);
+
+  size_t expectedSize = compressFixedRate(bundle->field, rate, expected, size);
+  size_t actualSize = transcode(bundle, rate, policy, actual, size);
+  assert_int_equal(actualSize, expectedSize);
+  assert_memory_equal(actual, expected, expectedSize);
+
+  free(actual);
+  free(expected);
+}
+
+static void
+given_fixedRateStream_when_transcodeToLowerRate_expect_matchesCompressionAtLowerRate(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  assertTranscodeMatchesCompression(bundle, 8, zfp_exec_serial);
+  assertTranscodeMatchesCompression(bundle, 5, zfp_exec_serial);
+  assertTranscodeMatchesCompression(bundle, RATE, zfp_exec_serial);
+}
+
+#ifdef _OPENMP
+static void
+given_ompPolicy_when_transcodeToLowerRate_expect_matchesCompressionAtLowerRate(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  assertTranscodeMatchesCompression(bundle, 8, zfp_exec_omp);
+  assertTranscodeMatchesCompression(bundle, 5, zfp_exec_omp);
+}
+#endif
+
+static void
+given_fixedRateStream_when_transcodeToHigherRate_expect_failure(void **state)
+{
+  struct setupVars *bundle = *state;
+  size_t size = 2 * bundle->sourceSize;
+  void* buffer = calloc(size, 1);
+  assert_non_null(buffer);
+
+  assert_int_equal(transcode(bundle, 2 * RATE, zfp_exec_serial, buffer, size), 0);
+
+  free(buffer);
+}
+
+int main()
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test_setup_teardown(given_fixedRateStream_when_transcodeToLowerRate_expect_matchesCompressionAtLowerRate, setup, teardown),
+#ifdef _OPENMP
+    cmocka_unit_test_setup_teardown(given_ompPolicy_when_transcodeToLowerRate_expect_matchesCompressionAtLowerRate, setup, teardown),
+#endif
+    cmocka_unit_test_setup_teardown(given_fixedRateStream_when_transcodeToHigherRate_expect_failure, setup, teardown),
+  };
+
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
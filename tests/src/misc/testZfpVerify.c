@@ -0,0 +1,207 @@
+#include "zfp.h"
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* 3D field with partial blocks along each dimension */
+#define NX 21
+#define NY 10
+#define NZ 13
+#define FIELD_SIZE (NX * NY * NZ)
+#define FIELD_BLOCKS (((NX + 3) / 4) * ((NY + 3) / 4) * ((NZ + 3) / 4))
+#define TOLERANCE 1e-6
+
+struct setupVars {
+  double* data;
+  double* decompressed;
+  void* buffer;
+  void* reference;
+  size_t bufferSize;
+  zfp_field* field;
+  zfp_stream* stream;
+  bitstream* s;
+  zfp_verification verification;
+};
+
+static int
+setup(void **state)
+{
+  struct setupVars *bundle = malloc(sizeof(struct setupVars));
+  assert_non_null(bundle);
+
+  bundle->data = malloc(FIELD_SIZE * sizeof(double));
+  bundle->decompressed = malloc(FIELD_SIZE * sizeof(double));
+  assert_non_null(bundle->data);
+  assert_non_null(bundle->decompressed);
+
+  size_t i;
+  for (i = 0; i < FIELD_SIZE; i++)
+    bundle->data[i] = exp(0.01 * (double)(i % NX)) * sin(0.1 * (double)i) + 1e-9 * (double)i;
+
+  bundle->field = zfp_field_3d(bundle->data, zfp_type_double, NX, NY, NZ);
+  bundle->stream = zfp_stream_open(NULL);
+  zfp_stream_set_accuracy(bundle->stream, TOLERANCE);
+  /* room for all blocks stored verbatim behind a flag */
+  bundle->bufferSize = 2 * FIELD_BLOCKS * 64 * sizeof(double);
+  bundle->buffer = calloc(bundle->bufferSize, 1);
+  bundle->reference = calloc(bundle->bufferSize, 1);
+  assert_non_null(bundle->buffer);
+  assert_non_null(bundle->reference);
+  bundle->s = stream_open(bundle->buffer, bundle->bufferSize);
+  zfp_stream_set_bit_stream(bundle->stream, bundle->s);
+  zfp_verification_reset(&bundle->verification);
+
+  *state = bundle;
+
+  return 0;
+}
+
+static int
+teardown(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  zfp_field_free(bundle->field);
+  zfp_stream_close(bundle->stream);
+  stream_close(bundle->s);
+  free(bundle->reference);
+  free(bundle->buffer);
+  free(bundle->decompressed);
+  free(bundle->data);
+  free(bundle);
+
+  return 0;
+}
+
+/* compress field, optionally verified, and return compressed size */
+static size_t
+compress(struct setupVars *bundle, zfp_bool verify)
+{
+  zfp_stream_set_verification(bundle->stream, verify ? &bundle->verification : NULL);
+  zfp_stream_rewind(bundle->stream);
+  size_t size = zfp_compress(bundle->stream, bundle->field);
+  zfp_stream_set_verification(bundle->stream, NULL);
+  return size;
+}
+
+/* decompress field and return largest error */
+static double
+decompress(struct setupVars *bundle, size_t size)
+{
+  double error = 0;
+  size_t i;
+
+  zfp_stream_rewind(bundle->stream);
+  zfp_field_set_pointer(bundle->field, bundle->decompressed);
+  assert_int_equal(zfp_decompress(bundle->stream, bundle->field), size);
+  zfp_field_set_pointer(bundle->field, bundle->data);
+  for (i = 0; i < FIELD_SIZE; i++)
+    error = fmax(error, fabs(bundle->decompressed[i] - bundle->data[i]));
+
+  return error;
+}
+
+static void
+given_fixedAccuracy_when_zfpCompressVerified_expect_sameStreamAndErrorWithinTolerance(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_verification* v = &bundle->verification;
+
+  size_t size = compress(bundle, zfp_false);
+  assert_int_not_equal(size, 0);
+  memcpy(bundle->reference, bundle->buffer, size);
+
+  /* verification leaves stream unchanged */
+  assert_int_equal(compress(bundle, zfp_true), size);
+  assert_memory_equal(bundle->buffer, bundle->reference, size);
+  assert_int_equal(v->blocks, FIELD_BLOCKS);
+  assert_int_equal(v->violations, 0);
+  assert_int_equal(v->repaired, 0);
+  assert_true(v->max_error > 0);
+  assert_true(v->max_error <= TOLERANCE);
+  assert_true(decompress(bundle, size) <= v->max_error);
+
+  /* parallel execution falls back on verifying serially */
+  if (zfp_stream_set_execution(bundle->stream, zfp_exec_omp)) {
+    zfp_stream_stats stats;
+    memset(&stats, 0, sizeof(stats));
+    zfp_stream_set_stats(bundle->stream, &stats);
+    zfp_verification_reset(v);
+    assert_int_equal(compress(bundle, zfp_true), size);
+    assert_memory_equal(bundle->buffer, bundle->reference, size);
+    assert_int_equal(v->blocks, FIELD_BLOCKS);
+    assert_int_equal(stats.exec, zfp_exec_serial);
+    assert_int_equal(zfp_stream_execution(bundle->stream), zfp_exec_omp);
+    zfp_stream_set_stats(bundle->stream, NULL);
+  }
+}
+
+static void
+given_lowPrecisionAndRawBlocks_when_zfpCompressVerified_expect_violationsRepaired(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_verification* v = &bundle->verification;
+
+  /* too few bit planes to meet tolerance */
+  assert_true(zfp_stream_set_params(bundle->stream, 0, ZFP_MAX_BITS, 8, -20));
+  size_t size = compress(bundle, zfp_true);
+  assert_int_not_equal(size, 0);
+  assert_true(v->violations > 0);
+  assert_int_equal(v->repaired, 0);
+  assert_true(v->max_error > ldexp(1.0, -20));
+  assert_true(decompress(bundle, size) <= v->max_error);
+
+  /* with raw blocks, violating blocks are stored losslessly */
+  zfp_verification_reset(v);
+  zfp_stream_set_raw_blocks(bundle->stream, zfp_true);
+  bundle->data[7] = NAN;
+  size = compress(bundle, zfp_true);
+  assert_int_not_equal(size, 0);
+  assert_true(v->violations > 0);
+  assert_int_equal(v->repaired, v->violations);
+  assert_true(v->max_error <= ldexp(1.0, -20));
+
+  /* NaN is restored exactly along with rest of its block */
+  decompress(bundle, size);
+  assert_true(isnan(bundle->decompressed[7]));
+  bundle->decompressed[7] = bundle->data[7] = 0;
+  assert_true(decompress(bundle, size) <= ldexp(1.0, -20));
+}
+
+static void
+given_unsupportedField_when_zfpCompressVerified_expect_returnsZero(void **state)
+{
+  struct setupVars *bundle = *state;
+  int32 values[FIELD_SIZE];
+  uint8 mask[FIELD_SIZE];
+
+  /* only unmasked floating-point fields are verified */
+  memset(values, 0, sizeof(values));
+  zfp_field* field = zfp_field_3d(values, zfp_type_int32, NX, NY, NZ);
+  zfp_stream_set_verification(bundle->stream, &bundle->verification);
+  assert_int_equal(zfp_compress(bundle->stream, field), 0);
+
+  memset(mask, 1, sizeof(mask));
+  zfp_field_set_mask(bundle->field, mask);
+  assert_int_equal(zfp_compress(bundle->stream, bundle->field), 0);
+  assert_int_equal(bundle->verification.blocks, 0);
+
+  zfp_field_free(field);
+}
+
+int main()
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test_setup_teardown(given_fixedAccuracy_when_zfpCompressVerified_expect_sameStreamAndErrorWithinTolerance, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_lowPrecisionAndRawBlocks_when_zfpCompressVerified_expect_violationsRepaired, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_unsupportedField_when_zfpCompressVerified_expect_returnsZero, setup, teardown),
+  };
+
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,395 @@
+#if defined(__unix__) || defined(__APPLE__)
+  // measure wall-clock time using POSIX calls
+  #ifndef _POSIX_C_SOURCE
+    #define _POSIX_C_SOURCE 200112L
+  #endif
+  #define ZFP_WITH_WALL_CLOCK
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <vector>
+#ifdef _OPENMP
+  #include <omp.h>
+#endif
+#include "zfparray1.h"
+#include "zfparray2.h"
+#include "zfparray3.h"
+#include "zfparray4.h"
+
+/*
+Benchmark element access to compressed arrays under common access patterns
+for a range of rates and cache sizes.  Each pattern starts with an empty
+cache and reports the time per element access; for 3D arrays, the cache
+miss rate and the number of blocks encoded and decoded are also reported
+from the cache statistics gathered at run time.
+*/
+
+// result of one access pattern
+struct result {
+  result() : accesses(0), seconds(0), stats(false) {}
+  size_t accesses;              // number of element accesses
+  double seconds;               // wall-clock time
+  bool stats;                   // whether cache statistics are available
+  zfp::cache_statistics cache;  // cache statistics
+};
+
+static bool csv = false;
+static bool first = true;
+
+// return wall-clock time in seconds (processor time if unavailable)
+static double
+wall_time()
+{
+#ifdef ZFP_WITH_WALL_CLOCK
+  struct timespec ts;
+  if (!clock_gettime(CLOCK_MONOTONIC, &ts))
+    return double(ts.tv_sec) + 1e-9 * double(ts.tv_nsec);
+#endif
+  return double(std::clock()) / CLOCKS_PER_SEC;
+}
+
+// cache statistics are gathered only by 3D arrays
+template <class Array>
+inline void start_stats(Array&) {}
+
+template <typename Scalar>
+inline void start_stats(zfp::array3<Scalar>& a)
+{
+  a.set_cache_stats(true);
+  a.reset_cache_stats();
+}
+
+template <class Array>
+inline bool get_stats(const Array&, zfp::cache_statistics&) { return false; }
+
+template <typename Scalar>
+inline bool get_stats(const zfp::array3<Scalar>& a, zfp::cache_statistics& stats)
+{
+  stats = a.cache_stats();
+  return true;
+}
+
+// empty cache and start timing
+template <class Array>
+static double
+start(Array& a)
+{
+  a.flush_cache();
+  a.clear_cache();
+  start_stats(a);
+  return wall_time();
+}
+
+// stop timing and gather statistics
+template <class Array>
+static result
+stop(const Array& a, double time, size_t accesses)
+{
+  result r;
+  r.seconds = wall_time() - time;
+  r.accesses = accesses;
+  r.stats = get_stats(a, r.cache);
+  return r;
+}
+
+// print result of one access pattern
+static void
+print(const std::string& shape, double rate, size_t cache, const char* pattern, const result& r, double checksum)
+{
+  const double ns = 1e9 * r.seconds / double(r.accesses);
+  const zfp::cache_statistics& s = r.cache;
+  const double lookups = double(s.hits + s.misses);
+  char stats[80] = "-,-,-";
+  if (r.stats)
+    snprintf(stats, sizeof(stats), csv ? "%g,%lu,%lu" : "%.4f %10lu %10lu", lookups > 0 ? double(s.misses) / lookups : 0.0, (unsigned long)s.encodes, (unsigned long)s.decodes);
+  else if (!csv)
+    snprintf(stats, sizeof(stats), "%6s %10s %10s", "-", "-", "-");
+  if (csv) {
+    if (first)
+      std::printf("shape,rate,cache_bytes,pattern,accesses,ns_per_access,miss_rate,encodes,decodes\n");
+    std::printf("%s,%g,%lu,%s,%lu,%g,%s\n", shape.c_str(), rate, (unsigned long)cache, pattern, (unsigned long)r.accesses, ns, stats);
+  }
+  else {
+    if (first)
+      std::printf("%-16s %5s %10s %-14s %10s %9s %6s %10s %10s\n", "shape", "rate", "cache", "pattern", "accesses", "ns/access", "miss", "encodes", "decodes");
+    std::printf("%-16s %5g %10lu %-14s %10lu %9.2f %s\n", shape.c_str(), rate, (unsigned long)cache, pattern, (unsigned long)r.accesses, ns, stats);
+  }
+  first = false;
+  std::fflush(stdout);
+  // keep the compiler from eliding reads
+  if (checksum != checksum)
+    std::fprintf(stderr, "invalid checksum\n");
+}
+
+// patterns common to arrays of all dimensionalities
+template <class Array>
+static void
+run_common(Array& a, const std::string& shape, double rate, const std::vector<size_t>& index)
+{
+  typedef typename Array::value_type value_type;
+  const size_t n = a.size();
+  double t, sum;
+
+  // flat indexing in raster order
+  sum = 0;
+  t = start(a);
+  for (size_t i = 0; i < n; i++)
+    sum += a[i];
+  print(shape, rate, a.cache_size(), "sequential", stop(a, t, n), sum);
+
+  // iteration in block order
+  sum = 0;
+  t = start(a);
+  for (typename Array::const_iterator it = a.cbegin(); it != a.cend(); ++it)
+    sum += *it;
+  print(shape, rate, a.cache_size(), "iterator", stop(a, t, n), sum);
+
+  // iteration over a view of the whole array
+  sum = 0;
+  t = start(a);
+  typename Array::view v(&a);
+  for (typename Array::view::const_iterator it = v.cbegin(); it != v.cend(); ++it)
+    sum += *it;
+  print(shape, rate, a.cache_size(), "view", stop(a, t, n), sum);
+
+  // uniformly random reads
+  sum = 0;
+  t = start(a);
+  for (size_t i = 0; i < index.size(); i++)
+    sum += a[index[i]];
+  print(shape, rate, a.cache_size(), "random", stop(a, t, index.size()), sum);
+
+  // read-modify-write through iterator proxies, including write-back
+  t = start(a);
+  for (typename Array::iterator it = a.begin(); it != a.end(); ++it)
+    *it += value_type(1);
+  a.flush_cache();
+  print(shape, rate, a.cache_size(), "mutate", stop(a, t, n), 0);
+
+  // uniformly random writes, including write-back
+  t = start(a);
+  for (size_t i = 0; i < index.size(); i++)
+    a[index[i]] = value_type(i);
+  a.flush_cache();
+  print(shape, rate, a.cache_size(), "random_write", stop(a, t, index.size()), 0);
+}
+
+// 7-point Laplacian at (i, j, k) via stencil view
+struct laplacian {
+  laplacian() : sum(0) {}
+  template <class Stencil>
+  void operator()(size_t, size_t, size_t, const Stencil& s)
+  {
+    sum += s(-1, 0, 0) + s(+1, 0, 0) + s(0, -1, 0) + s(0, +1, 0) + s(0, 0, -1) + s(0, 0, +1) - 6 * s(0, 0, 0);
+  }
+  double sum;
+};
+
+// patterns specific to 3D arrays
+template <class Array>
+static void
+run_3d(Array& a, const std::string& shape, double rate, size_t cache, int threads)
+{
+  const Array& c = a;
+  const size_t nx = a.size_x();
+  const size_t ny = a.size_y();
+  const size_t nz = a.size_z();
+  double t, sum;
+
+  // 7-point stencil over interior elements in raster order
+  sum = 0;
+  t = start(a);
+  for (size_t k = 1; k + 1 < nz; k++)
+    for (size_t j = 1; j + 1 < ny; j++)
+      for (size_t i = 1; i + 1 < nx; i++)
+        sum += c(i - 1, j, k) + c(i + 1, j, k) + c(i, j - 1, k) + c(i, j + 1, k) + c(i, j, k - 1) + c(i, j, k + 1) - 6 * c(i, j, k);
+  print(shape, rate, a.cache_size(), "stencil", stop(a, t, 7 * (nx - 2) * (ny - 2) * (nz - 2)), sum);
+
+  // 7-point stencil over all elements in block order via stencil view
+  t = start(a);
+  typename Array::stencil_view s(&a);
+  sum = s.for_each(laplacian()).sum;
+  print(shape, rate, a.cache_size(), "stencil_view", stop(a, t, 7 * nx * ny * nz), sum);
+
+#ifdef _OPENMP
+  // parallel reads through one private view per thread; the shared cache
+  // is not used, so no statistics are available
+  if (threads <= 0)
+    threads = omp_get_max_threads();
+  sum = 0;
+  t = start(a);
+  #pragma omp parallel num_threads(threads) reduction(+:sum)
+  {
+    typename Array::private_view v(&a, cache);
+    v.partition(omp_get_thread_num(), omp_get_num_threads());
+    for (typename Array::private_view::const_iterator it = v.cbegin(); it != v.cend(); ++it)
+      sum += *it;
+  }
+  result r = stop(a, t, nx * ny * nz);
+  r.stats = false;
+  char pattern[32];
+  snprintf(pattern, sizeof(pattern), "private_view=%d", threads);
+  print(shape, rate, a.cache_size(), pattern, r, sum);
+#else
+  (void)cache;
+  (void)threads;
+#endif
+}
+
+// smooth field value at normalized coordinates
+static double
+field(double x, double y, double z, double w)
+{
+  return std::sin(6 * x + 1) * std::cos(5 * y + 2) * std::sin(4 * z + 3) * std::cos(3 * w + 4);
+}
+
+// benchmark d-dimensional array with side n^(1/d)
+static void
+run(uint dims, size_t count, double rate, size_t cache, size_t accesses, int threads)
+{
+  const size_t side = std::max(size_t(4), size_t(std::floor(std::pow(double(count), 1.0 / dims) + 0.5)));
+  size_t n[4] = { side, dims > 1 ? side : 1, dims > 2 ? side : 1, dims > 3 ? side : 1 };
+  size_t size = n[0] * n[1] * n[2] * n[3];
+  std::vector<double> data(size);
+  for (size_t l = 0; l < n[3]; l++)
+    for (size_t k = 0; k < n[2]; k++)
+      for (size_t j = 0; j < n[1]; j++)
+        for (size_t i = 0; i < n[0]; i++)
+          data[i + n[0] * (j + n[1] * (k + n[2] * l))] = field(double(i) / side, double(j) / side, double(k) / side, double(l) / side);
+
+  // same pseudo-random indices for every configuration
+  std::vector<size_t> index(std::min(accesses, size));
+  uint64 seed = 1;
+  for (size_t i = 0; i < index.size(); i++) {
+    seed = seed * UINT64C(6364136223846793005) + UINT64C(1442695040888963407);
+    index[i] = size_t(seed >> 16) % size;
+  }
+
+  char shape[96];
+  switch (dims) {
+    case 1: {
+      snprintf(shape, sizeof(shape), "%lu", (unsigned long)n[0]);
+      zfp::array1d a(n[0], rate, &data[0], cache);
+      run_common(a, shape, rate, index);
+      break;
+    }
+    case 2: {
+      snprintf(shape, sizeof(shape), "%lux%lu", (unsigned long)n[0], (unsigned long)n[1]);
+      zfp::array2d a(n[0], n[1], rate, &data[0], cache);
+      run_common(a, shape, rate, index);
+      break;
+    }
+    case 3: {
+      snprintf(shape, sizeof(shape), "%lux%lux%lu", (unsigned long)n[0], (unsigned long)n[1], (unsigned long)n[2]);
+      zfp::array3d a(n[0], n[1], n[2], rate, &data[0], cache);
+      run_common(a, shape, rate, index);
+      run_3d(a, shape, rate, cache, threads);
+      break;
+    }
+    case 4: {
+      snprintf(shape, sizeof(shape), "%lux%lux%lux%lu", (unsigned long)n[0], (unsigned long)n[1], (unsigned long)n[2], (unsigned long)n[3]);
+      zfp::array4d a(n[0], n[1], n[2], n[3], rate, &data[0], cache);
+      run_common(a, shape, rate, index);
+      break;
+    }
+  }
+}
+
+static void
+usage()
+{
+  std::fprintf(stderr, "Usage: zfp_array_bench <options>\n");
+  std::fprintf(stderr, "  -d <dims> : dimensionality 1-4 of double-precision arrays (repeatable; default 1-4)\n");
+  std::fprintf(stderr, "  -n <count> : approximate number of array elements (default 2097152)\n");
+  std::fprintf(stderr, "  -r <rate> : rate in compressed bits per value (repeatable; default 8 and 16)\n");
+  std::fprintf(stderr, "  -c <bytes> : cache size, 0 for the array default (repeatable; default 0)\n");
+  std::fprintf(stderr, "  -a <count> : number of random accesses (default 1048576)\n");
+  std::fprintf(stderr, "  -j <threads> : number of threads for private views (default all)\n");
+  std::fprintf(stderr, "  -o <table|csv> : output format (default table)\n");
+  std::fprintf(stderr, "Patterns: sequential (flat index), iterator, view, random, mutate,\n");
+  std::fprintf(stderr, "  random_write, and for 3D arrays stencil, stencil_view, private_view\n");
+  std::exit(EXIT_FAILURE);
+}
+
+int main(int argc, char* argv[])
+{
+  std::vector<uint> dims;
+  std::vector<double> rates;
+  std::vector<size_t> caches;
+  size_t count = size_t(1) << 21;
+  size_t accesses = size_t(1) << 20;
+  int threads = 0;
+  unsigned long value;
+  uint d;
+  double rate;
+
+  // parse command-line arguments
+  for (int i = 1; i < argc; i++) {
+    if (argv[i][0] != '-' || argv[i][2] || ++i == argc)
+      usage();
+    switch (argv[i - 1][1]) {
+      case 'a':
+        if (std::sscanf(argv[i], "%lu", &value) != 1 || !value)
+          usage();
+        accesses = value;
+        break;
+      case 'c':
+        if (std::sscanf(argv[i], "%lu", &value) != 1)
+          usage();
+        caches.push_back(value);
+        break;
+      case 'd':
+        if (std::sscanf(argv[i], "%u", &d) != 1 || d < 1 || d > 4)
+          usage();
+        dims.push_back(d);
+        break;
+      case 'j':
+        if (std::sscanf(argv[i], "%d", &threads) != 1 || threads < 1)
+          usage();
+        break;
+      case 'n':
+        if (std::sscanf(argv[i], "%lu", &value) != 1 || !value)
+          usage();
+        count = value;
+        break;
+      case 'o':
+        if (!std::strcmp(argv[i], "csv"))
+          csv = true;
+        else if (std::strcmp(argv[i], "table"))
+          usage();
+        break;
+      case 'r':
+        if (std::sscanf(argv[i], "%lf", &rate) != 1 || rate <= 0)
+          usage();
+        rates.push_back(rate);
+        break;
+      default:
+        usage();
+        break;
+    }
+  }
+
+  // apply defaults
+  if (dims.empty())
+    for (d = 1; d <= 4; d++)
+      dims.push_back(d);
+  if (rates.empty()) {
+    rates.push_back(8);
+    rates.push_back(16);
+  }
+  if (caches.empty())
+    caches.push_back(0);
+
+  for (size_t i = 0; i < dims.size(); i++)
+    for (size_t j = 0; j < rates.size(); j++)
+      for (size_t k = 0; k < caches.size(); k++)
+        run(dims[i], count, rates[j], caches[k], accesses, threads);
+
+  return 0;
+}
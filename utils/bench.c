@@ -0,0 +1,1093 @@
+#if defined(__unix__) || defined(__APPLE__)
+  /* measure wall-clock time using POSIX calls */
+  #ifndef _POSIX_C_SOURCE
+    #define _POSIX_C_SOURCE 200112L
+  #endif
+  #define ZFP_WITH_WALL_CLOCK
+#endif
+
+#if defined(__linux__)
+  /* read hardware performance counters via perf_event_open */
+  #ifndef _DEFAULT_SOURCE
+    #define _DEFAULT_SOURCE /* for syscall() */
+  #endif
+  #include <linux/perf_event.h>
+  #include <sys/ioctl.h>
+  #include <sys/syscall.h>
+  #include <unistd.h>
+  #define ZFP_WITH_PERF_EVENT
+#endif
+
+#if defined(ZFP_BENCH_WITH_CUDA)
+  /* allocate device-resident arrays for CUDA execution */
+  #include <cuda_runtime_api.h>
+  #define BENCH_DEVICE_POLICY zfp_exec_cuda
+#elif defined(ZFP_BENCH_WITH_HIP)
+  /* allocate device-resident arrays for HIP execution */
+  #include <hip/hip_runtime_api.h>
+  #define BENCH_DEVICE_POLICY zfp_exec_hip
+#endif
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "zfp.h"
+
+/*
+Benchmark zfp (de)compression throughput over the cross product of scalar
+types, dimensionalities, compression modes, execution policies, and memory
+layouts.  Arrays are either generated as smooth synthetic fields or read from a
+raw binary file.  Each case is run a number of times after warmup, and the
+median and 10th/90th percentile throughput in MB/s of uncompressed data are
+reported as a table, CSV, or JSON.  On Linux, hardware performance counters
+may optionally be read around each (de)compression to report cycles per
+value, instructions per cycle, and branch and cache misses per block.  For a
+given I/O bandwidth, container writes with and without the lossless entropy
+back end may also be timed to report effective write throughput, i.e., the
+rate at which uncompressed data is compressed and written out.  For GPU
+execution, the time spent per call in each phase of GPU (de)compression
+(allocation, transfers, kernels, offset computation, and deallocation) may
+be reported, and arrays already resident in device memory may be
+benchmarked alongside host arrays to separate transfer from kernel costs.
+*/
+
+#define MAX_CASES 16
+
+/* compression mode and its parameter */
+typedef struct {
+  char kind; /* 'r': rate; 'p': precision; 'a': accuracy; 'R': reversible */
+  double param;
+} bench_mode;
+
+/* execution policy and its parameters */
+typedef struct {
+  zfp_exec_policy policy;
+  uint threads;
+  uint chunk_size;
+  const char* name;
+} bench_exec;
+
+/* field to benchmark */
+typedef struct {
+  zfp_type type;
+  uint dims;
+  size_t n[4];
+  size_t count;
+  void* data;
+} bench_array;
+
+/* throughput statistics in MB/s */
+typedef struct {
+  double median;
+  double p10;
+  double p90;
+} bench_stats;
+
+/* container writes without and with entropy coding at given I/O bandwidth */
+typedef struct {
+  double bandwidth; /* I/O bandwidth in MB/s */
+  size_t size[2];   /* byte size of field stored without and with coding */
+  double write[2];  /* median effective write throughput in MB/s */
+} bench_entropy;
+
+/* hardware counters: cycles, instructions, branch misses, cache misses */
+#define COUNTERS 4
+
+/* mean hardware counts per (de)compression */
+typedef struct {
+  double count[COUNTERS];
+} bench_counters;
+
+/* mean seconds per (de)compression in each zfp_device_phase */
+typedef struct {
+  double time[ZFP_DEVICE_PHASES];
+} bench_phases;
+
+typedef enum {
+  format_table,
+  format_csv,
+  format_json
+} bench_format;
+
+/* memory layout and residency of benchmarked field */
+typedef enum {
+  layout_contiguous, /* contiguous host array */
+  layout_strided,    /* host array interleaved with a second component */
+  layout_device      /* contiguous array and stream in device memory */
+} bench_layout;
+
+static const char* const phase_name[ZFP_DEVICE_PHASES] = {
+  "alloc", "h2d", "kernel", "offsets", "d2h", "free"
+};
+
+/* return wall-clock time in seconds (processor time if unavailable) */
+static double
+wall_time(void)
+{
+#ifdef ZFP_WITH_WALL_CLOCK
+  struct timespec ts;
+  if (!clock_gettime(CLOCK_MONOTONIC, &ts))
+    return (double)ts.tv_sec + 1e-9 * (double)ts.tv_nsec;
+#endif
+  return (double)clock() / CLOCKS_PER_SEC;
+}
+
+#ifdef ZFP_WITH_PERF_EVENT
+/* group of counters led by cycle counter (-1 if not open) */
+static int counter_fd[COUNTERS] = { -1, -1, -1, -1 };
+#endif
+
+/* open hardware counters for calling thread; return zfp_false if unavailable */
+static zfp_bool
+open_counters(void)
+{
+#ifdef ZFP_WITH_PERF_EVENT
+  static const uint64 config[COUNTERS] = {
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_BRANCH_MISSES,
+    PERF_COUNT_HW_CACHE_MISSES,
+  };
+  uint i;
+  for (i = 0; i < COUNTERS; i++) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config[i];
+    attr.read_format = PERF_FORMAT_GROUP;
+    /* count user space only, which unprivileged users may do */
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.disabled = (i == 0);
+    counter_fd[i] = (int)syscall(__NR_perf_event_open, &attr, 0, -1, counter_fd[0], 0);
+    if (counter_fd[i] < 0) {
+      while (i--)
+        close(counter_fd[i]);
+      counter_fd[0] = -1;
+      return zfp_false;
+    }
+  }
+  ioctl(counter_fd[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+  return zfp_true;
+#else
+  return zfp_false;
+#endif
+}
+
+/* read current counts into value[] */
+static void
+read_counters(double* value)
+{
+  uint i;
+#ifdef ZFP_WITH_PERF_EVENT
+  uint64 buffer[1 + COUNTERS];
+  if (counter_fd[0] >= 0 && read(counter_fd[0], buffer, sizeof(buffer)) == (ssize_t)sizeof(buffer) && buffer[0] == COUNTERS) {
+    for (i = 0; i < COUNTERS; i++)
+      value[i] = (double)buffer[1 + i];
+    return;
+  }
+#endif
+  for (i = 0; i < COUNTERS; i++)
+    value[i] = 0;
+}
+
+static int
+compare_double(const void* a, const void* b)
+{
+  double x = *(const double*)a;
+  double y = *(const double*)b;
+  return x < y ? -1 : x > y ? +1 : 0;
+}
+
+/* linearly interpolated percentile p in [0, 1] of sorted values */
+static double
+percentile(const double* value, uint count, double p)
+{
+  double x = p * (count - 1);
+  uint i = (uint)x;
+  if (i + 1 >= count)
+    return value[count - 1];
+  return value[i] + (x - i) * (value[i + 1] - value[i]);
+}
+
+/* throughput statistics for given byte count and times (sorted in place) */
+static bench_stats
+throughput(size_t bytes, double* seconds, uint count)
+{
+  bench_stats stats;
+  uint i;
+  for (i = 0; i < count; i++)
+    seconds[i] = seconds[i] > 0 ? (double)bytes / (1e6 * seconds[i]) : 0;
+  qsort(seconds, count, sizeof(*seconds), compare_double);
+  stats.median = percentile(seconds, count, 0.5);
+  stats.p10 = percentile(seconds, count, 0.1);
+  stats.p90 = percentile(seconds, count, 0.9);
+  return stats;
+}
+
+/* parse scalar type name (zfp_type_none if invalid) */
+static zfp_type
+parse_type(const char* name)
+{
+  if (!strcmp(name, "i32"))
+    return zfp_type_int32;
+  if (!strcmp(name, "i64"))
+    return zfp_type_int64;
+  if (!strcmp(name, "f32"))
+    return zfp_type_float;
+  if (!strcmp(name, "f64"))
+    return zfp_type_double;
+  return zfp_type_none;
+}
+
+static const char*
+type_name(zfp_type type)
+{
+  switch (type) {
+    case zfp_type_int32:
+      return "i32";
+    case zfp_type_int64:
+      return "i64";
+    case zfp_type_float:
+      return "f32";
+    case zfp_type_double:
+      return "f64";
+    default:
+      return "none";
+  }
+}
+
+/* parse execution policy (zfp_false if invalid) */
+static zfp_bool
+parse_exec(const char* arg, bench_exec* exec)
+{
+  exec->threads = 0;
+  exec->chunk_size = 0;
+  exec->name = arg;
+  if (!strcmp(arg, "serial"))
+    exec->policy = zfp_exec_serial;
+  else if (!strncmp(arg, "omp", 3) && (!arg[3] || sscanf(arg, "omp=%u,%u", &exec->threads, &exec->chunk_size) >= 1))
+    exec->policy = zfp_exec_omp;
+  else if (!strncmp(arg, "threads", 7) && (!arg[7] || sscanf(arg, "threads=%u,%u", &exec->threads, &exec->chunk_size) >= 1))
+    exec->policy = zfp_exec_threads;
+  else if (!strcmp(arg, "cuda"))
+    exec->policy = zfp_exec_cuda;
+  else if (!strcmp(arg, "hip"))
+    exec->policy = zfp_exec_hip;
+  else if (!strcmp(arg, "omp_target"))
+    exec->policy = zfp_exec_omp_target;
+  else if (!strcmp(arg, "sycl"))
+    exec->policy = zfp_exec_sycl;
+  else if (!strcmp(arg, "hybrid"))
+    exec->policy = zfp_exec_hybrid;
+  else
+    return zfp_false;
+  return zfp_true;
+}
+
+/* set execution policy and its parameters (zfp_false if unavailable) */
+static zfp_bool
+set_exec(zfp_stream* zfp, const bench_exec* exec)
+{
+  if (!zfp_stream_set_execution(zfp, exec->policy))
+    return zfp_false;
+  switch (exec->policy) {
+    case zfp_exec_omp:
+      zfp_stream_set_omp_threads(zfp, exec->threads);
+      zfp_stream_set_omp_chunk_size(zfp, exec->chunk_size);
+      break;
+    case zfp_exec_threads:
+      zfp_stream_set_thread_count(zfp, exec->threads);
+      zfp_stream_set_thread_chunk_size(zfp, exec->chunk_size);
+      break;
+    default:
+      break;
+  }
+  return zfp_true;
+}
+
+/* set compression mode (zfp_false if not applicable to type) */
+static zfp_bool
+set_mode(zfp_stream* zfp, const bench_mode* mode, zfp_type type, uint dims)
+{
+  switch (mode->kind) {
+    case 'r':
+      zfp_stream_set_rate(zfp, mode->param, type, dims, zfp_false);
+      return zfp_true;
+    case 'p':
+      zfp_stream_set_precision(zfp, (uint)mode->param);
+      return zfp_true;
+    case 'a':
+      if (type == zfp_type_int32 || type == zfp_type_int64)
+        return zfp_false;
+      zfp_stream_set_accuracy(zfp, mode->param);
+      return zfp_true;
+    default:
+      zfp_stream_set_reversible(zfp);
+      return zfp_true;
+  }
+}
+
+static const char*
+mode_name(const bench_mode* mode)
+{
+  switch (mode->kind) {
+    case 'r':
+      return "rate";
+    case 'p':
+      return "precision";
+    case 'a':
+      return "accuracy";
+    default:
+      return "reversible";
+  }
+}
+
+/* smooth value in [-1, 1] at grid point x of side^dims grid */
+static double
+smooth_value(const size_t* x, uint dims, size_t side)
+{
+  static const double freq[4] = { 3.1, 2.3, 1.7, 1.3 };
+  static const double phase[4] = { 0.7, 1.9, 2.8, 0.4 };
+  double v = 1;
+  uint d;
+  for (d = 0; d < dims; d++)
+    v *= sin(6.283185307179586 * freq[d] * (double)x[d] / (double)side + phase[d]);
+  return v;
+}
+
+/* generate smooth synthetic array with at least count values, scaled to
+   span most of the range of integer types */
+static zfp_bool
+generate_array(bench_array* array, zfp_type type, uint dims, size_t count)
+{
+  size_t side, total, i;
+  size_t x[4];
+  uint d;
+  array->type = type;
+  array->dims = dims;
+  array->data = NULL;
+  switch (type) {
+    case zfp_type_int32:
+    case zfp_type_int64:
+    case zfp_type_float:
+    case zfp_type_double:
+      break;
+    default:
+      return zfp_false;
+  }
+  /* smallest hypercube holding count values */
+  for (side = 1;; side++) {
+    for (total = 1, d = 0; d < dims; d++)
+      total *= side;
+    if (total >= count)
+      break;
+  }
+  array->data = malloc(total * zfp_type_size(type));
+  if (!array->data)
+    return zfp_false;
+  array->count = total;
+  for (d = 0; d < 4; d++)
+    array->n[d] = d < dims ? side : 0;
+  for (i = 0; i < total; i++) {
+    size_t j = i;
+    double v;
+    for (d = 0; d < dims; d++) {
+      x[d] = j % side;
+      j /= side;
+    }
+    v = smooth_value(x, dims, side);
+    switch (type) {
+      case zfp_type_int32:
+        ((int32*)array->data)[i] = (int32)(v * 0x3fffffff);
+        break;
+      case zfp_type_int64:
+        ((int64*)array->data)[i] = (int64)(v * 4611686018427387904.0);
+        break;
+      case zfp_type_float:
+        ((float*)array->data)[i] = (float)(v * 2048);
+        break;
+      default:
+        ((double*)array->data)[i] = v * 67108864;
+        break;
+    }
+  }
+  return zfp_true;
+}
+
+/* read raw binary array of given type and dimensions from file */
+static zfp_bool
+read_array(bench_array* array, const char* path, zfp_type type, const size_t* n)
+{
+  FILE* file;
+  size_t size;
+  uint i;
+  array->type = type;
+  array->dims = 0;
+  array->count = 1;
+  for (i = 0; i < 4; i++) {
+    array->n[i] = n[i];
+    if (n[i]) {
+      array->dims++;
+      array->count *= n[i];
+    }
+  }
+  size = array->count * zfp_type_size(type);
+  array->data = malloc(size);
+  file = fopen(path, "rb");
+  if (!array->data || !file || fread(array->data, 1, size, file) != size) {
+    fprintf(stderr, "cannot read input file %s\n", path);
+    if (file)
+      fclose(file);
+    free(array->data);
+    array->data = NULL;
+    return zfp_false;
+  }
+  fclose(file);
+  return zfp_true;
+}
+
+/*
+field over array data, either contiguous or interleaved with a second
+component of the same size in a buffer of twice the size, as in an array of
+2-vectors; the caller frees the buffer
+*/
+static zfp_field*
+make_field(const bench_array* array, zfp_bool strided, void** buffer)
+{
+  size_t typesize = zfp_type_size(array->type);
+  zfp_field* field = zfp_field_alloc();
+  ptrdiff_t s = strided ? 2 : 1;
+  size_t i;
+  uchar* dst;
+
+  *buffer = malloc((size_t)s * array->count * typesize);
+  if (!field || !*buffer) {
+    zfp_field_free(field);
+    free(*buffer);
+    *buffer = NULL;
+    return NULL;
+  }
+
+  /* copy values into every s-th slot of buffer */
+  dst = (uchar*)*buffer;
+  if (strided) {
+    memset(dst, 0, (size_t)s * array->count * typesize);
+    for (i = 0; i < array->count; i++)
+      memcpy(dst + (size_t)s * i * typesize, (const uchar*)array->data + i * typesize, typesize);
+  }
+  else
+    memcpy(dst, array->data, array->count * typesize);
+
+  zfp_field_set_type(field, array->type);
+  zfp_field_set_pointer(field, *buffer);
+  switch (array->dims) {
+    case 1:
+      zfp_field_set_size_1d(field, array->n[0]);
+      zfp_field_set_stride_1d(field, s);
+      break;
+    case 2:
+      zfp_field_set_size_2d(field, array->n[0], array->n[1]);
+      zfp_field_set_stride_2d(field, s, s * (ptrdiff_t)array->n[0]);
+      break;
+    case 3:
+      zfp_field_set_size_3d(field, array->n[0], array->n[1], array->n[2]);
+      zfp_field_set_stride_3d(field, s, s * (ptrdiff_t)array->n[0], s * (ptrdiff_t)(array->n[0] * array->n[1]));
+      break;
+    case 4:
+      zfp_field_set_size_4d(field, array->n[0], array->n[1], array->n[2], array->n[3]);
+      zfp_field_set_stride_4d(field, s, s * (ptrdiff_t)array->n[0], s * (ptrdiff_t)(array->n[0] * array->n[1]), s * (ptrdiff_t)(array->n[0] * array->n[1] * array->n[2]));
+      break;
+  }
+  return field;
+}
+
+/* device copy of size bytes at host pointer ptr, or uninitialized device
+   memory if ptr is NULL (NULL if unavailable) */
+static void*
+device_alloc(const void* ptr, size_t size)
+{
+  void* d_ptr = NULL;
+#if defined(ZFP_BENCH_WITH_CUDA)
+  if (cudaMalloc(&d_ptr, size) != cudaSuccess)
+    return NULL;
+  if (ptr && cudaMemcpy(d_ptr, ptr, size, cudaMemcpyHostToDevice) != cudaSuccess) {
+    cudaFree(d_ptr);
+    return NULL;
+  }
+#elif defined(ZFP_BENCH_WITH_HIP)
+  if (hipMalloc(&d_ptr, size) != hipSuccess)
+    return NULL;
+  if (ptr && hipMemcpy(d_ptr, ptr, size, hipMemcpyHostToDevice) != hipSuccess) {
+    hipFree(d_ptr);
+    return NULL;
+  }
+#else
+  (void)ptr;
+  (void)size;
+#endif
+  return d_ptr;
+}
+
+/* whether arrays may reside in device memory for execution policy */
+static zfp_bool
+device_resident(zfp_exec_policy policy)
+{
+#ifdef BENCH_DEVICE_POLICY
+  return policy == BENCH_DEVICE_POLICY;
+#else
+  (void)policy;
+  return zfp_false;
+#endif
+}
+
+/* deallocate memory obtained from device_alloc() */
+static void
+device_free(void* d_ptr)
+{
+  if (!d_ptr)
+    return;
+#if defined(ZFP_BENCH_WITH_CUDA)
+  cudaFree(d_ptr);
+#elif defined(ZFP_BENCH_WITH_HIP)
+  hipFree(d_ptr);
+#endif
+}
+
+static const char*
+layout_name(bench_layout layout)
+{
+  switch (layout) {
+    case layout_strided:
+      return "strided";
+    case layout_device:
+      return "device";
+    default:
+      return "contiguous";
+  }
+}
+
+/* print one benchmark result */
+static void
+print_result(bench_format format, zfp_bool first, const bench_array* array, bench_layout layout_kind, const bench_mode* mode, const bench_exec* exec, size_t rawsize, size_t zfpsize, const bench_stats* zip, const bench_stats* unzip, const bench_counters* zipc, const bench_counters* unzipc, const bench_entropy* entropy, const bench_phases* zipd, const bench_phases* unzipd)
+{
+  char shape[80];
+  const char* layout = layout_name(layout_kind);
+  double ratio = (double)rawsize / zfpsize;
+  double blocks = 1;
+  double rate[2][4];
+  uint i, j;
+
+  shape[0] = '\0';
+  for (i = 0; i < array->dims; i++) {
+    sprintf(shape + strlen(shape), "%s%lu", i ? "x" : "", (unsigned long)array->n[i]);
+    blocks *= (double)((array->n[i] + 3) / 4);
+  }
+
+  /* cycles/value, instructions/cycle, and branch and cache misses/block */
+  if (zipc)
+    for (i = 0; i < 2; i++) {
+      const double* c = (i ? unzipc : zipc)->count;
+      rate[i][0] = c[0] / (double)array->count;
+      rate[i][1] = c[0] > 0 ? c[1] / c[0] : 0;
+      rate[i][2] = c[2] / blocks;
+      rate[i][3] = c[3] / blocks;
+    }
+
+  switch (format) {
+    case format_table:
+      if (first)
+        printf("%-4s %-16s %-10s %-10s %8s %-10s %8s %10s %10s %10s %10s %10s %10s\n", "type", "shape", "layout", "mode", "param", "exec", "ratio", "zip", "zip_p10", "zip_p90", "unzip", "unzip_p10", "unzip_p90");
+      if (first && zipc)
+        printf("%-4s %-16s %-10s %-10s %8s %-10s %10s %10s %10s %10s %10s %10s %10s %10s\n", "", "", "", "", "", "", "zip_cpv", "zip_ipc", "zip_bmpb", "zip_cmpb", "unzip_cpv", "unzip_ipc", "unzip_bmpb", "unzip_cmpb");
+      printf("%-4s %-16s %-10s %-10s %8g %-10s %8.3f %10.1f %10.1f %10.1f %10.1f %10.1f %10.1f\n", type_name(array->type), shape, layout, mode_name(mode), mode->param, exec->name, ratio, zip->median, zip->p10, zip->p90, unzip->median, unzip->p10, unzip->p90);
+      if (first && entropy)
+        printf("%-4s %-16s %-10s %-10s %8s %-10s %8s %10s %10s\n", "", "", "", "", "", "", "coded", "write", "write_cod");
+      if (first && zipd) {
+        printf("%-4s %-16s %-10s %-10s %8s %-10s", "", "", "", "", "", "");
+        for (i = 0; i < 2; i++)
+          for (j = 0; j < ZFP_DEVICE_PHASES; j++) {
+            char name[16];
+            sprintf(name, "%s_%s", i ? "unzip" : "zip", phase_name[j]);
+            printf(" %13s", name);
+          }
+        printf("\n");
+      }
+      if (zipc)
+        printf("%-4s %-16s %-10s %-10s %8s %-10s %10.2f %10.2f %10.2f %10.2f %10.2f %10.2f %10.2f %10.2f\n", "", "", "", "", "", "", rate[0][0], rate[0][1], rate[0][2], rate[0][3], rate[1][0], rate[1][1], rate[1][2], rate[1][3]);
+      if (entropy)
+        printf("%-4s %-16s %-10s %-10s %8s %-10s %8.3f %10.1f %10.1f\n", "", "", "", "", "", "", (double)rawsize / entropy->size[1], entropy->write[0], entropy->write[1]);
+      if (zipd) {
+        printf("%-4s %-16s %-10s %-10s %8s %-10s", "", "", "", "", "", "");
+        for (i = 0; i < 2; i++)
+          for (j = 0; j < ZFP_DEVICE_PHASES; j++)
+            printf(" %13.3f", 1e3 * (i ? unzipd : zipd)->time[j]);
+        printf("\n");
+      }
+      break;
+    case format_csv:
+      if (first) {
+        printf("type,dims,shape,layout,mode,param,exec,raw_bytes,zfp_bytes,ratio,zip_mbps,zip_p10_mbps,zip_p90_mbps,unzip_mbps,unzip_p10_mbps,unzip_p90_mbps%s%s", zipc ? ",zip_cycles_per_value,zip_ipc,zip_branch_misses_per_block,zip_cache_misses_per_block,unzip_cycles_per_value,unzip_ipc,unzip_branch_misses_per_block,unzip_cache_misses_per_block" : "", entropy ? ",io_mbps,coded_bytes,coded_ratio,write_mbps,coded_write_mbps" : "");
+        for (i = 0; zipd && i < 2; i++)
+          for (j = 0; j < ZFP_DEVICE_PHASES; j++)
+            printf(",%s_%s_ms", i ? "unzip" : "zip", phase_name[j]);
+        printf("\n");
+      }
+      printf("%s,%u,%s,%s,%s,%g,%s,%lu,%lu,%g,%g,%g,%g,%g,%g,%g", type_name(array->type), array->dims, shape, layout, mode_name(mode), mode->param, exec->name, (unsigned long)rawsize, (unsigned long)zfpsize, ratio, zip->median, zip->p10, zip->p90, unzip->median, unzip->p10, unzip->p90);
+      if (zipc)
+        printf(",%g,%g,%g,%g,%g,%g,%g,%g", rate[0][0], rate[0][1], rate[0][2], rate[0][3], rate[1][0], rate[1][1], rate[1][2], rate[1][3]);
+      if (entropy)
+        printf(",%g,%lu,%g,%g,%g", entropy->bandwidth, (unsigned long)entropy->size[1], (double)rawsize / entropy->size[1], entropy->write[0], entropy->write[1]);
+      for (i = 0; zipd && i < 2; i++)
+        for (j = 0; j < ZFP_DEVICE_PHASES; j++)
+          printf(",%g", 1e3 * (i ? unzipd : zipd)->time[j]);
+      printf("\n");
+      break;
+    case format_json:
+      printf("%s\n  {\"type\": \"%s\", \"dims\": %u, \"shape\": \"%s\", \"layout\": \"%s\", \"mode\": \"%s\", \"param\": %g, \"exec\": \"%s\", ", first ? "[" : ",", type_name(array->type), array->dims, shape, layout, mode_name(mode), mode->param, exec->name);
+      printf("\"raw_bytes\": %lu, \"zfp_bytes\": %lu, \"ratio\": %g, ", (unsigned long)rawsize, (unsigned long)zfpsize, ratio);
+      printf("\"zip_mbps\": %g, \"zip_p10_mbps\": %g, \"zip_p90_mbps\": %g, \"unzip_mbps\": %g, \"unzip_p10_mbps\": %g, \"unzip_p90_mbps\": %g", zip->median, zip->p10, zip->p90, unzip->median, unzip->p10, unzip->p90);
+      for (i = 0; zipc && i < 2; i++)
+        printf(", \"%s_cycles_per_value\": %g, \"%s_ipc\": %g, \"%s_branch_misses_per_block\": %g, \"%s_cache_misses_per_block\": %g", i ? "unzip" : "zip", rate[i][0], i ? "unzip" : "zip", rate[i][1], i ? "unzip" : "zip", rate[i][2], i ? "unzip" : "zip", rate[i][3]);
+      if (entropy)
+        printf(", \"io_mbps\": %g, \"coded_bytes\": %lu, \"coded_ratio\": %g, \"write_mbps\": %g, \"coded_write_mbps\": %g", entropy->bandwidth, (unsigned long)entropy->size[1], (double)rawsize / entropy->size[1], entropy->write[0], entropy->write[1]);
+      for (i = 0; zipd && i < 2; i++)
+        for (j = 0; j < ZFP_DEVICE_PHASES; j++)
+          printf(", \"%s_%s_ms\": %g", i ? "unzip" : "zip", phase_name[j], 1e3 * (i ? unzipd : zipd)->time[j]);
+      printf("}");
+      break;
+  }
+  fflush(stdout);
+}
+
+/* time container writes without and with entropy coding (zfp_false if unsupported) */
+static zfp_bool
+run_entropy(bench_entropy* entropy, zfp_stream* zfp, const zfp_field* field, size_t rawsize, uint warmup, uint repeat, double* seconds)
+{
+  uint i, k;
+  for (k = 0; k < 2; k++) {
+    zfp_stream_set_entropy(zfp, k ? zfp_entropy_huffman : zfp_entropy_none);
+    for (i = 0; i < warmup + repeat; i++) {
+      zfp_container* c = zfp_container_create(0);
+      double start = wall_time();
+      zfp_bool added = c && zfp_container_add(c, "field", zfp, field);
+      double time = wall_time() - start;
+      if (added)
+        entropy->size[k] = zfp_container_size(c, 0);
+      zfp_container_close(c);
+      if (!added) {
+        zfp_stream_set_entropy(zfp, zfp_entropy_none);
+        return zfp_false;
+      }
+      /* add time to write stored bytes */
+      if (i >= warmup)
+        seconds[i - warmup] = time + (double)entropy->size[k] / (1e6 * entropy->bandwidth);
+    }
+    entropy->write[k] = throughput(rawsize, seconds, repeat).median;
+  }
+  zfp_stream_set_entropy(zfp, zfp_entropy_none);
+  return zfp_true;
+}
+
+/* run one benchmark case; return zfp_true if a result was printed */
+static zfp_bool
+run_case(bench_format format, zfp_bool first, const bench_array* array, bench_layout layout, const bench_mode* mode, const bench_exec* exec, uint warmup, uint repeat, zfp_bool counters, double bandwidth, zfp_bool phases)
+{
+  size_t rawsize = array->count * zfp_type_size(array->type);
+  void* data = NULL;
+  void* copy = NULL;
+  void* buffer = NULL;
+  void* d_data = NULL;
+  void* d_copy = NULL;
+  void* d_buffer = NULL;
+  zfp_field* field = make_field(array, layout == layout_strided, &data);
+  zfp_field* output = make_field(array, layout == layout_strided, &copy);
+  zfp_stream* zfp = zfp_stream_open(NULL);
+  bitstream* stream = NULL;
+  double* ziptime = (double*)malloc(repeat * sizeof(double));
+  double* unziptime = (double*)malloc(repeat * sizeof(double));
+  size_t zfpsize = 0;
+  size_t bufsize;
+  zfp_bool done = zfp_false;
+  zfp_bool decompressed = zfp_true;
+  bench_stats zip, unzip;
+  bench_counters zipc, unzipc;
+  bench_entropy entropy;
+  bench_phases zipd, unzipd;
+  zfp_stream_stats stats;
+  double before[COUNTERS] = { 0 }, after[COUNTERS] = { 0 };
+  uint i, j;
+
+  if (!field || !output || !zfp || !ziptime || !unziptime) {
+    fprintf(stderr, "out of memory\n");
+    goto cleanup;
+  }
+  if (!set_mode(zfp, mode, array->type, array->dims))
+    goto cleanup;
+  if (!set_exec(zfp, exec))
+    goto cleanup;
+  bufsize = zfp_stream_maximum_size(zfp, field);
+  if (layout == layout_device) {
+    /* field, output, and stream all reside in device memory */
+    if (!device_resident(exec->policy) || bandwidth > 0) {
+      fprintf(stderr, "skipping device-resident arrays with execution policy %s\n", exec->name);
+      goto cleanup;
+    }
+    d_data = device_alloc(data, rawsize);
+    d_copy = device_alloc(NULL, rawsize);
+    d_buffer = device_alloc(NULL, bufsize);
+    if (!d_data || !d_copy || !d_buffer) {
+      fprintf(stderr, "out of device memory\n");
+      goto cleanup;
+    }
+    zfp_field_set_pointer(field, d_data);
+    zfp_field_set_pointer(output, d_copy);
+    stream = stream_open(d_buffer, bufsize);
+  }
+  else {
+    buffer = malloc(bufsize);
+    stream = buffer ? stream_open(buffer, bufsize) : NULL;
+  }
+  if (!stream) {
+    fprintf(stderr, "out of memory\n");
+    goto cleanup;
+  }
+  zfp_stream_set_bit_stream(zfp, stream);
+  memset(&zipc, 0, sizeof(zipc));
+  memset(&unzipc, 0, sizeof(unzipc));
+  memset(&stats, 0, sizeof(stats));
+  /* only GPU policies time device phases; spare others the cost of stats */
+  if (phases && (exec->policy == zfp_exec_cuda || exec->policy == zfp_exec_hip))
+    zfp_stream_set_stats(zfp, &stats);
+
+  /* compress */
+  for (i = 0; i < warmup + repeat; i++) {
+    double start;
+    if (i == warmup)
+      zfp_stats_reset(&stats);
+    if (counters)
+      read_counters(before);
+    start = wall_time();
+    zfp_stream_rewind(zfp);
+    zfpsize = zfp_compress(zfp, field);
+    if (!zfpsize) {
+      fprintf(stderr, "skipping %s %s compression with execution policy %s\n", type_name(array->type), mode_name(mode), exec->name);
+      goto cleanup;
+    }
+    if (i >= warmup) {
+      ziptime[i - warmup] = wall_time() - start;
+      if (counters) {
+        read_counters(after);
+        for (j = 0; j < COUNTERS; j++)
+          zipc.count[j] += (after[j] - before[j]) / repeat;
+      }
+    }
+  }
+  for (j = 0; j < ZFP_DEVICE_PHASES; j++)
+    zipd.time[j] = stats.device_time[j] / repeat;
+
+  /* decompress; not all policies support all modes */
+  for (i = 0; i < warmup + repeat; i++) {
+    double start;
+    if (i == warmup)
+      zfp_stats_reset(&stats);
+    if (counters)
+      read_counters(before);
+    start = wall_time();
+    zfp_stream_rewind(zfp);
+    if (!zfp_decompress(zfp, output)) {
+      decompressed = zfp_false;
+      break;
+    }
+    if (i >= warmup) {
+      unziptime[i - warmup] = wall_time() - start;
+      if (counters) {
+        read_counters(after);
+        for (j = 0; j < COUNTERS; j++)
+          unzipc.count[j] += (after[j] - before[j]) / repeat;
+      }
+    }
+  }
+  for (j = 0; j < ZFP_DEVICE_PHASES; j++)
+    unzipd.time[j] = decompressed ? stats.device_time[j] / repeat : 0;
+  zfp_stream_set_stats(zfp, NULL);
+
+  zip = throughput(rawsize, ziptime, repeat);
+  if (decompressed)
+    unzip = throughput(rawsize, unziptime, repeat);
+  else {
+    unzip.median = unzip.p10 = unzip.p90 = 0;
+    memset(&unzipc, 0, sizeof(unzipc));
+  }
+  entropy.bandwidth = bandwidth;
+  if (bandwidth > 0 && !run_entropy(&entropy, zfp, field, rawsize, warmup, repeat, ziptime)) {
+    fprintf(stderr, "skipping %s %s container writes with execution policy %s\n", type_name(array->type), mode_name(mode), exec->name);
+    goto cleanup;
+  }
+  print_result(format, first, array, layout, mode, exec, rawsize, zfpsize, &zip, &unzip, counters ? &zipc : NULL, counters ? &unzipc : NULL, bandwidth > 0 ? &entropy : NULL, phases ? &zipd : NULL, phases ? &unzipd : NULL);
+  done = zfp_true;
+
+cleanup:
+  zfp_field_free(field);
+  zfp_field_free(output);
+  if (zfp)
+    zfp_stream_close(zfp);
+  if (stream)
+    stream_close(stream);
+  free(buffer);
+  free(data);
+  free(copy);
+  device_free(d_data);
+  device_free(d_copy);
+  device_free(d_buffer);
+  free(ziptime);
+  free(unziptime);
+  return done;
+}
+
+static void
+usage()
+{
+  fprintf(stderr, "%s\n", zfp_version_string);
+  fprintf(stderr, "Usage: zfp_bench <options>\n");
+  fprintf(stderr, "Input arrays (cross product of types and dimensionalities):\n");
+  fprintf(stderr, "  -t <i32|i64|f32|f64> : scalar type (repeatable; default f32 and f64)\n");
+  fprintf(stderr, "  -d <dims> : dimensionality 1-4 of generated arrays (repeatable; default 1, 2, 3)\n");
+  fprintf(stderr, "  -n <count> : minimum number of values per generated array (repeatable; default 16777216)\n");
+  fprintf(stderr, "  -i <path> : benchmark raw binary file of type -t and dimensions given by:\n");
+  fprintf(stderr, "  -1 <nx> : dimensions for 1D array a[nx]\n");
+  fprintf(stderr, "  -2 <nx> <ny> : dimensions for 2D array a[ny][nx]\n");
+  fprintf(stderr, "  -3 <nx> <ny> <nz> : dimensions for 3D array a[nz][ny][nx]\n");
+  fprintf(stderr, "  -4 <nx> <ny> <nz> <nw> : dimensions for 4D array a[nw][nz][ny][nx]\n");
+  fprintf(stderr, "Compression modes (repeatable; default -r 8 -r 16 -R):\n");
+  fprintf(stderr, "  -R : reversible (lossless) compression\n");
+  fprintf(stderr, "  -r <rate> : fixed rate (# compressed bits per value)\n");
+  fprintf(stderr, "  -p <precision> : fixed precision (# uncompressed bits per value)\n");
+  fprintf(stderr, "  -a <tolerance> : fixed accuracy (absolute error tolerance; floating types only)\n");
+  fprintf(stderr, "Execution policies (repeatable; default serial):\n");
+  fprintf(stderr, "  -x serial : serial compression\n");
+  fprintf(stderr, "  -x omp[=threads[,chunk_size]] : OpenMP parallel compression/decompression\n");
+  fprintf(stderr, "  -x threads[=threads[,chunk_size]] : thread-pool parallel compression/decompression\n");
+  fprintf(stderr, "  -x cuda|hip|omp_target|sycl : GPU parallel compression/decompression\n");
+  fprintf(stderr, "  -x hybrid : GPU and OpenMP co-execution (fixed rate only)\n");
+  fprintf(stderr, "Measurement and output:\n");
+  fprintf(stderr, "  -s : also benchmark arrays interleaved with a second component (strided)\n");
+  fprintf(stderr, "  -D : also benchmark arrays and streams resident in device memory (CUDA/HIP builds)\n");
+  fprintf(stderr, "  -g : report milliseconds per call spent in each phase of GPU (de)compression:\n");
+  fprintf(stderr, "       allocation, host-to-device copy, kernels, offsets, device-to-host copy, free\n");
+  fprintf(stderr, "  -c : report hardware counters of calling thread (Linux only): cycles/value,\n");
+  fprintf(stderr, "       instructions/cycle, and branch and cache misses/block\n");
+  fprintf(stderr, "  -e <MB/s> : also time container writes without and with entropy coding and\n");
+  fprintf(stderr, "       report effective write throughput at given I/O bandwidth\n");
+  fprintf(stderr, "  -w <count> : number of untimed warmup runs per case (default 1)\n");
+  fprintf(stderr, "  -k <count> : number of timed runs per case (default 5)\n");
+  fprintf(stderr, "  -o <table|csv|json> : output format (default table)\n");
+  fprintf(stderr, "Examples:\n");
+  fprintf(stderr, "  -t f64 -d 3 -r 16 -x serial -x omp=8 : serial vs. 8-thread OpenMP fixed-rate 3D doubles\n");
+  fprintf(stderr, "  -t f32 -i file -3 512 512 512 -a 1e-3 -o csv : real data at tolerance 1e-3 as CSV\n");
+  fprintf(stderr, "  -t f64 -d 3 -R -x omp -e 2000 : entropy coding for 2 GB/s parallel file system\n");
+  fprintf(stderr, "  -d 3 -n 1048576 -n 16777216 -r 8 -x cuda -D -g : host vs. device arrays, by phase\n");
+  exit(EXIT_FAILURE);
+}
+
+int main(int argc, char* argv[])
+{
+  /* default settings */
+  zfp_type type[MAX_CASES];
+  uint types = 0;
+  uint dim[MAX_CASES];
+  uint dims = 0;
+  bench_mode mode[MAX_CASES];
+  uint modes = 0;
+  bench_exec exec[MAX_CASES];
+  uint execs = 0;
+  size_t count[MAX_CASES];
+  uint counts = 0;
+  size_t n[4] = { 0, 0, 0, 0 };
+  char* inpath = 0;
+  zfp_bool strided = zfp_false;
+  zfp_bool device = zfp_false;
+  zfp_bool phases = zfp_false;
+  zfp_bool counters = zfp_false;
+  double bandwidth = 0;
+  uint warmup = 1;
+  uint repeat = 5;
+  bench_format format = format_table;
+
+  /* local variables */
+  unsigned long value;
+  zfp_bool first = zfp_true;
+  uint t, d, c, m, x, l;
+  int i;
+
+  /* parse command-line arguments */
+  for (i = 1; i < argc; i++) {
+    if (argv[i][0] != '-' || argv[i][2])
+      usage();
+    switch (argv[i][1]) {
+      case '1':
+      case '2':
+      case '3':
+      case '4':
+        for (d = 0; d < 4; d++) {
+          n[d] = 0;
+          if (d < (uint)(argv[i][1] - '0')) {
+            if (++i == argc || sscanf(argv[i], "%lu", &value) != 1 || !value)
+              usage();
+            n[d] = value;
+          }
+        }
+        break;
+      case 'a':
+      case 'p':
+      case 'r':
+        if (modes == MAX_CASES || ++i == argc || sscanf(argv[i], "%lf", &mode[modes].param) != 1)
+          usage();
+        mode[modes++].kind = argv[i - 1][1];
+        break;
+      case 'R':
+        if (modes == MAX_CASES)
+          usage();
+        mode[modes].kind = 'R';
+        mode[modes++].param = 0;
+        break;
+      case 'c':
+        counters = zfp_true;
+        break;
+      case 'D':
+        device = zfp_true;
+        break;
+      case 'e':
+        if (++i == argc || sscanf(argv[i], "%lf", &bandwidth) != 1 || !(bandwidth > 0))
+          usage();
+        break;
+      case 'd':
+        if (dims == MAX_CASES || ++i == argc || sscanf(argv[i], "%u", &dim[dims]) != 1 || dim[dims] < 1 || dim[dims] > 4)
+          usage();
+        dims++;
+        break;
+      case 'g':
+        phases = zfp_true;
+        break;
+      case 'i':
+        if (++i == argc)
+          usage();
+        inpath = argv[i];
+        break;
+      case 'k':
+        if (++i == argc || sscanf(argv[i], "%u", &repeat) != 1 || !repeat)
+          usage();
+        break;
+      case 'n':
+        if (counts == MAX_CASES || ++i == argc || sscanf(argv[i], "%lu", &value) != 1 || !value)
+          usage();
+        count[counts++] = value;
+        break;
+      case 'o':
+        if (++i == argc)
+          usage();
+        if (!strcmp(argv[i], "table"))
+          format = format_table;
+        else if (!strcmp(argv[i], "csv"))
+          format = format_csv;
+        else if (!strcmp(argv[i], "json"))
+          format = format_json;
+        else
+          usage();
+        break;
+      case 's':
+        strided = zfp_true;
+        break;
+      case 't':
+        if (types == MAX_CASES || ++i == argc || (type[types] = parse_type(argv[i])) == zfp_type_none)
+          usage();
+        types++;
+        break;
+      case 'w':
+        if (++i == argc || sscanf(argv[i], "%u", &warmup) != 1)
+          usage();
+        break;
+      case 'x':
+        if (execs == MAX_CASES || ++i == argc || !parse_exec(argv[i], &exec[execs]))
+          usage();
+        execs++;
+        break;
+      default:
+        usage();
+        break;
+    }
+  }
+
+  /* apply defaults */
+  if (!types) {
+    type[types++] = zfp_type_float;
+    type[types++] = zfp_type_double;
+  }
+  if (!dims) {
+    dim[dims++] = 1;
+    dim[dims++] = 2;
+    dim[dims++] = 3;
+  }
+  if (!counts)
+    count[counts++] = 1u << 24;
+  if (!modes) {
+    mode[modes].kind = 'r';
+    mode[modes++].param = 8;
+    mode[modes].kind = 'r';
+    mode[modes++].param = 16;
+    mode[modes].kind = 'R';
+    mode[modes++].param = 0;
+  }
+  if (!execs)
+    parse_exec("serial", &exec[execs++]);
+  else {
+    /* drop policies not supported by this build of zfp */
+    zfp_stream* zfp = zfp_stream_open(NULL);
+    for (x = 0; x < execs; x++)
+      if (!zfp_stream_set_execution(zfp, exec[x].policy)) {
+        fprintf(stderr, "skipping unavailable execution policy %s\n", exec[x].name);
+        memmove(exec + x, exec + x + 1, (execs - x - 1) * sizeof(*exec));
+        execs--;
+        x--;
+      }
+    zfp_stream_close(zfp);
+  }
+  if (inpath) {
+    if (types != 1 || !n[0]) {
+      fprintf(stderr, "input file requires one scalar type and dimensions\n");
+      usage();
+    }
+    dims = 1;
+    counts = 1;
+  }
+
+  if (counters && !open_counters()) {
+    fprintf(stderr, "hardware performance counters are unavailable\n");
+    return EXIT_FAILURE;
+  }
+
+  for (t = 0; t < types; t++)
+    for (d = 0; d < dims; d++)
+      for (c = 0; c < counts; c++) {
+        bench_array array;
+        if (inpath ? !read_array(&array, inpath, type[t], n) : !generate_array(&array, type[t], dim[d], count[c])) {
+          fprintf(stderr, "cannot create %s array\n", type_name(type[t]));
+          return EXIT_FAILURE;
+        }
+        for (m = 0; m < modes; m++)
+          for (x = 0; x < execs; x++)
+            for (l = layout_contiguous; l <= layout_device; l++)
+              if ((l != layout_strided || strided) && (l != layout_device || device))
+                if (run_case(format, first, &array, (bench_layout)l, &mode[m], &exec[x], warmup, repeat, counters, bandwidth, phases))
+                  first = zfp_false;
+        free(array.data);
+      }
+
+  if (format == format_json)
+    printf("%s\n", first ? "[]" : "\n]");
+
+  return 0;
+}
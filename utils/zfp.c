@@ -1,9 +1,39 @@
+#if defined(__unix__) || defined(__APPLE__)
+  /* memory-map files and measure wall-clock time using POSIX calls */
+  #ifndef _POSIX_C_SOURCE
+    #define _POSIX_C_SOURCE 200112L
+  #endif
+  #define ZFP_WITH_MMAP
+  #define ZFP_WITH_WALL_CLOCK
+#endif
+#if defined(__linux__) && defined(ZFP_WITH_THREADS)
+  /* write compressed files with O_DIRECT, overlapping writes with compression */
+  #ifndef _GNU_SOURCE
+    #define _GNU_SOURCE
+  #endif
+  #define ZFP_WITH_DIRECT_IO
+#endif
+
+#include <ctype.h>
 #include <float.h>
 #include <limits.h>
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
+#ifdef ZFP_WITH_MMAP
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+#ifdef ZFP_WITH_DIRECT_IO
+  #include <pthread.h>
+#endif
+#ifdef _OPENMP
+  #include <omp.h>
+#endif
 #include "zfp.h"
 #include "zfp/macros.h"
 
@@ -26,9 +56,452 @@ The 7 major tasks to be accomplished are:
 - compute stats:      s
 */
 
-/* compute and print reconstruction error */
+/* return wall-clock time in seconds (processor time if unavailable) */
+static double
+wall_time(void)
+{
+#ifdef ZFP_WITH_WALL_CLOCK
+  struct timespec ts;
+  if (!clock_gettime(CLOCK_MONOTONIC, &ts))
+    return (double)ts.tv_sec + 1e-9 * (double)ts.tv_nsec;
+#endif
+  return (double)clock() / CLOCKS_PER_SEC;
+}
+
+/* print time spent on task and throughput in MB/s for given byte count */
 static void
-print_error(const void* fin, const void* fout, zfp_type type, size_t n)
+print_time(const char* task, double seconds, size_t bytes)
+{
+  fprintf(stderr, " %s=%.3fs", task, seconds);
+  if (seconds > 0)
+    fprintf(stderr, " (%.1f MB/s)", (double)bytes / (1e6 * seconds));
+}
+
+/* insert chunk index between header of given bit size and compressed field */
+static zfp_bool
+embed_index(zfp_stream* zfp, const zfp_field* field, bitstream** stream, void** buffer, size_t* bufsize, size_t offset)
+{
+  const zfp_index* index = zfp_stream_index(zfp);
+  size_t bits = stream_wtell(*stream) - offset;
+  size_t size;
+  bitstream* src;
+  void* dst;
+
+  if (!index || !zfp_index_chunks(index))
+    return zfp_false;
+
+  /* allocate room for field and index of at most 64 bits per chunk */
+  size = *bufsize + (zfp_index_chunks(index) + 2) * sizeof(uint64);
+  dst = malloc(size);
+  src = stream_open(*buffer, *bufsize);
+  if (!dst || !src) {
+    free(dst);
+    stream_close(src);
+    return zfp_false;
+  }
+  stream_rseek(src, offset);
+
+  /* rewrite header, then write index and copy field */
+  stream_close(*stream);
+  *stream = stream_open(dst, size);
+  zfp_stream_set_bit_stream(zfp, *stream);
+  if ((offset && !zfp_write_header(zfp, field, ZFP_HEADER_FULL)) || !zfp_write_index(zfp, index)) {
+    stream_close(src);
+    free(*buffer);
+    *buffer = dst;
+    return zfp_false;
+  }
+  stream_copy(*stream, src, bits);
+  zfp_stream_flush(zfp);
+  stream_close(src);
+
+  free(*buffer);
+  *buffer = dst;
+  *bufsize = size;
+  return zfp_true;
+}
+
+/* map file into memory for sequential reading (NULL upon failure) */
+static void*
+map_file(const char* path, size_t* size)
+{
+#ifdef ZFP_WITH_MMAP
+  void* data;
+  struct stat st;
+  int fd = open(path, O_RDONLY);
+  if (fd < 0)
+    return NULL;
+  if (fstat(fd, &st) || !st.st_size) {
+    close(fd);
+    return NULL;
+  }
+  *size = (size_t)st.st_size;
+  data = mmap(NULL, *size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED)
+    return NULL;
+  /* request aggressive read-ahead so that I/O overlaps compression */
+  posix_madvise(data, *size, POSIX_MADV_SEQUENTIAL);
+  return data;
+#else
+  (void)path;
+  (void)size;
+  return NULL;
+#endif
+}
+
+/* unmap file mapped by map_file() */
+static void
+unmap_file(void* data, size_t size)
+{
+#ifdef ZFP_WITH_MMAP
+  if (data)
+    munmap(data, size);
+#else
+  (void)data;
+  (void)size;
+#endif
+}
+
+#ifdef ZFP_WITH_DIRECT_IO
+/* file offset, length, and memory alignment required by O_DIRECT */
+#define DIRECT_ALIGN 0x1000
+/* byte size of each of the two buffers that alternate between being filled
+   and being written */
+#define DIRECT_BUFFER_SIZE 0x400000
+
+/* compressed output file written with direct I/O from double buffers */
+typedef struct {
+  int fd;             /* file descriptor opened with O_DIRECT */
+  uchar* buffer[2];   /* aligned buffers */
+  uint current;       /* index of buffer being filled */
+  size_t fill;        /* byte count of buffer being filled */
+  size_t offset;      /* file offset of buffer being filled */
+  pthread_t thread;   /* thread writing other buffer */
+  zfp_bool pending;   /* is other buffer being written? */
+  zfp_bool failed;    /* did any write fail? */
+  /* arguments and result of pending write */
+  const uchar* data;
+  size_t bytes;
+  off_t position;
+  zfp_bool written;
+} direct_file;
+
+/* write all bytes of pending write; executed by writer thread */
+static void*
+direct_writer(void* arg)
+{
+  direct_file* f = (direct_file*)arg;
+  size_t done = 0;
+  while (done < f->bytes) {
+    ssize_t n = pwrite(f->fd, f->data + done, f->bytes - done, f->position + (off_t)done);
+    if (n <= 0)
+      break;
+    done += (size_t)n;
+  }
+  f->written = (done == f->bytes);
+  return NULL;
+}
+
+/* wait for pending write, if any, to complete */
+static void
+direct_wait(direct_file* f)
+{
+  if (f->pending) {
+    pthread_join(f->thread, NULL);
+    f->pending = zfp_false;
+    if (!f->written)
+      f->failed = zfp_true;
+  }
+}
+
+/* write aligned byte count of current buffer in the background and switch
+   to filling the other buffer */
+static void
+direct_submit(direct_file* f, size_t bytes)
+{
+  direct_wait(f);
+  f->data = f->buffer[f->current];
+  f->bytes = bytes;
+  f->position = (off_t)f->offset;
+  if (pthread_create(&f->thread, NULL, direct_writer, f))
+    direct_writer(f);
+  else
+    f->pending = zfp_true;
+  f->current ^= 1u;
+  f->offset += bytes;
+  f->fill = 0;
+}
+
+/* create file for direct output (NULL if direct I/O is not supported) */
+static direct_file*
+direct_open(const char* path)
+{
+  direct_file* f = (direct_file*)calloc(1, sizeof(direct_file));
+  if (!f)
+    return NULL;
+  f->fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_DIRECT, 0644);
+  if (f->fd < 0 ||
+      posix_memalign((void**)&f->buffer[0], DIRECT_ALIGN, DIRECT_BUFFER_SIZE) ||
+      posix_memalign((void**)&f->buffer[1], DIRECT_ALIGN, DIRECT_BUFFER_SIZE)) {
+    if (f->fd >= 0)
+      close(f->fd);
+    free(f->buffer[0]);
+    free(f);
+    return NULL;
+  }
+  return f;
+}
+
+/* append bytes to file, writing each buffer as it fills up */
+static zfp_bool
+direct_write(direct_file* f, const void* data, size_t bytes)
+{
+  const uchar* p = (const uchar*)data;
+  while (bytes) {
+    size_t n = MIN(bytes, DIRECT_BUFFER_SIZE - f->fill);
+    memcpy(f->buffer[f->current] + f->fill, p, n);
+    f->fill += n;
+    p += n;
+    bytes -= n;
+    if (f->fill == DIRECT_BUFFER_SIZE)
+      direct_submit(f, DIRECT_BUFFER_SIZE);
+  }
+  return !f->failed;
+}
+
+/* write remaining bytes, close file, and deallocate; return true upon success */
+static zfp_bool
+direct_close(direct_file* f)
+{
+  size_t size = f->offset + f->fill;
+  zfp_bool success;
+  /* pad last buffer to alignment and truncate file to its actual size */
+  if (f->fill) {
+    size_t bytes = (f->fill + DIRECT_ALIGN - 1) / DIRECT_ALIGN * DIRECT_ALIGN;
+    memset(f->buffer[f->current] + f->fill, 0, bytes - f->fill);
+    direct_submit(f, bytes);
+  }
+  direct_wait(f);
+  success = !f->failed && !ftruncate(f->fd, (off_t)size);
+  if (close(f->fd))
+    success = zfp_false;
+  free(f->buffer[0]);
+  free(f->buffer[1]);
+  free(f);
+  return success;
+}
+#else
+typedef void direct_file;
+
+static direct_file*
+direct_open(const char* path)
+{
+  (void)path;
+  return NULL;
+}
+#endif
+
+/* write bytes to direct output file, if any, or else to stdio file out */
+static zfp_bool
+write_output(FILE* out, direct_file* direct, const void* data, size_t bytes)
+{
+#ifdef ZFP_WITH_DIRECT_IO
+  if (direct)
+    return direct_write(direct, data, bytes);
+#else
+  (void)direct;
+#endif
+  return fwrite(data, 1, bytes, out) == bytes;
+}
+
+/* close direct output file, if any, or else stdio file out */
+static zfp_bool
+close_output(FILE* out, direct_file* direct)
+{
+#ifdef ZFP_WITH_DIRECT_IO
+  if (direct)
+    return direct_close(direct);
+#else
+  (void)direct;
+#endif
+  return out == stdout || !fclose(out);
+}
+
+/* read entire file with direct I/O into newly allocated aligned buffer of
+   byte capacity bufsize (NULL upon failure) */
+static void*
+read_direct(const char* path, size_t* size, size_t* bufsize)
+{
+#ifdef ZFP_WITH_DIRECT_IO
+  void* buffer = NULL;
+  struct stat st;
+  int fd = open(path, O_RDONLY | O_DIRECT);
+  if (fd < 0)
+    return NULL;
+  if (fstat(fd, &st) || !st.st_size) {
+    close(fd);
+    return NULL;
+  }
+  /* O_DIRECT reads whole aligned blocks, so round capacity up */
+  *bufsize = ((size_t)st.st_size + DIRECT_ALIGN - 1) / DIRECT_ALIGN * DIRECT_ALIGN;
+  if (posix_memalign(&buffer, DIRECT_ALIGN, *bufsize)) {
+    close(fd);
+    return NULL;
+  }
+  *size = 0;
+  while (*size < *bufsize) {
+    ssize_t n = read(fd, (uchar*)buffer + *size, *bufsize - *size);
+    if (n < 0) {
+      free(buffer);
+      close(fd);
+      return NULL;
+    }
+    if (!n)
+      break;
+    *size += (size_t)n;
+  }
+  close(fd);
+  *size = MIN(*size, (size_t)st.st_size);
+  return buffer;
+#else
+  (void)path;
+  (void)size;
+  (void)bufsize;
+  return NULL;
+#endif
+}
+
+/* compress 3D field one slab of planes at a time, taking slabs from data (if
+   not NULL) or reading them from file in and writing compressed data to file
+   out (or direct) as it is produced; return compressed byte size (zero upon
+   failure) */
+static size_t
+compress_slabs(zfp_stream* zfp, const zfp_field* field, const void* data, FILE* in, FILE* out, direct_file* direct, uint planes, int header)
+{
+  zfp_type type = zfp_field_type(field);
+  size_t typesize = zfp_type_size(type);
+  size_t nxy = (size_t)field->nx * (size_t)field->ny;
+  uint nz = (uint)field->nz;
+  size_t wordsize = stream_word_bits / CHAR_BIT;
+  zfp_field* slab = zfp_field_3d(NULL, type, field->nx, field->ny, planes);
+  void* values = data ? NULL : malloc(typesize * nxy * planes);
+  /* buffer holds one compressed slab plus header or bits carried over */
+  size_t bufsize = zfp_stream_maximum_size(zfp, slab) + wordsize;
+  void* buffer = malloc(bufsize);
+  bitstream* stream = buffer ? stream_open(buffer, bufsize) : NULL;
+  size_t zfpsize = 0;
+  zfp_bool success = slab && (data || values) && stream;
+  uint z;
+
+  if (success) {
+    zfp_stream_set_bit_stream(zfp, stream);
+    if (header && !zfp_write_header(zfp, field, ZFP_HEADER_FULL))
+      success = zfp_false;
+  }
+  if (success)
+    zfp_compress_begin(zfp);
+
+  for (z = 0; success && z < nz; z += planes) {
+    uint n = MIN(planes, nz - z);
+    size_t count = nxy * n;
+    /* obtain next slab */
+    if (data)
+      zfp_field_set_pointer(slab, (uchar*)data + typesize * nxy * z);
+    else if (fread(values, typesize, count, in) == count)
+      zfp_field_set_pointer(slab, values);
+    else {
+      success = zfp_false;
+      break;
+    }
+    zfp_field_set_size_3d(slab, field->nx, field->ny, n);
+    if (!zfp_compress_slab(zfp, slab))
+      success = zfp_false;
+    else if (z + n < nz) {
+      /* write whole words and carry partial word over to beginning of buffer */
+      size_t bits = stream_wtell(stream);
+      size_t bytes = bits / stream_word_bits * wordsize;
+      stream_flush(stream);
+      if (!write_output(out, direct, buffer, bytes))
+        success = zfp_false;
+      memmove(buffer, (uchar*)buffer + bytes, wordsize);
+      stream_wseek(stream, bits % stream_word_bits);
+      zfpsize += bytes;
+    }
+  }
+
+  /* write remaining words */
+  if (success) {
+    size_t bytes = zfp_compress_end(zfp);
+    if (!write_output(out, direct, buffer, bytes))
+      success = zfp_false;
+    zfpsize += bytes;
+  }
+
+  zfp_stream_set_bit_stream(zfp, NULL);
+  stream_close(stream);
+  free(buffer);
+  free(values);
+  zfp_field_free(slab);
+
+  return success ? zfpsize : 0;
+}
+
+/* decompress 3D field one slab of planes at a time and write slabs to file
+   out (or direct) */
+static zfp_bool
+decompress_slabs(zfp_stream* zfp, const zfp_field* field, FILE* out, direct_file* direct, uint planes)
+{
+  zfp_type type = zfp_field_type(field);
+  size_t typesize = zfp_type_size(type);
+  size_t nxy = (size_t)field->nx * (size_t)field->ny;
+  uint nz = (uint)field->nz;
+  void* values = malloc(typesize * nxy * planes);
+  zfp_field* slab = zfp_field_3d(values, type, field->nx, field->ny, planes);
+  zfp_bool success = values && slab;
+  uint z;
+
+  if (success)
+    zfp_decompress_begin(zfp);
+  for (z = 0; success && z < nz; z += planes) {
+    uint n = MIN(planes, nz - z);
+    size_t count = nxy * n;
+    zfp_field_set_size_3d(slab, field->nx, field->ny, n);
+    if (!zfp_decompress_slab(zfp, slab) || !write_output(out, direct, values, typesize * count))
+      success = zfp_false;
+  }
+  if (success)
+    zfp_decompress_end(zfp);
+
+  zfp_field_free(slab);
+  free(values);
+
+  return success;
+}
+
+/* error statistics accumulated over one or more arrays */
+typedef struct {
+  size_t count; /* number of values */
+  double sse;   /* sum of squared errors */
+  double emax;  /* maximum absolute error */
+  double fmin;  /* minimum value */
+  double fmax;  /* maximum value */
+} error_stats;
+
+/* initialize error statistics */
+static void
+init_error(error_stats* e)
+{
+  e->count = 0;
+  e->sse = 0;
+  e->emax = 0;
+  e->fmin = +DBL_MAX;
+  e->fmax = -DBL_MAX;
+}
+
+/* accumulate reconstruction error of n values */
+static void
+add_error(error_stats* e, const void* fin, const void* fout, zfp_type type, size_t n)
 {
   const int32* i32i = (const int32*)fin;
   const int64* i64i = (const int64*)fin;
@@ -38,12 +511,10 @@ print_error(const void* fin, const void* fout, zfp_type type, size_t n)
   const int64* i64o = (const int64*)fout;
   const float* f32o = (const float*)fout;
   const double* f64o = (const double*)fout;
-  double fmin = +DBL_MAX;
-  double fmax = -DBL_MAX;
-  double erms = 0;
-  double ermsn = 0;
-  double emax = 0;
-  double psnr = 0;
+  double fmin = e->fmin;
+  double fmax = e->fmax;
+  double sse = 0;
+  double emax = e->emax;
   size_t i;
 
   for (i = 0; i < n; i++) {
@@ -69,14 +540,712 @@ print_error(const void* fin, const void* fout, zfp_type type, size_t n)
         return;
     }
     emax = MAX(emax, d);
-    erms += d * d;
+    sse += d * d;
     fmin = MIN(fmin, val);
     fmax = MAX(fmax, val);
   }
-  erms = sqrt(erms / n);
-  ermsn = erms / (fmax - fmin);
-  psnr = 20 * log10((fmax - fmin) / (2 * erms));
-  fprintf(stderr, " rmse=%.4g nrmse=%.4g maxe=%.4g psnr=%.2f", erms, ermsn, emax, psnr);
+  e->count += n;
+  e->sse += sse;
+  e->emax = emax;
+  e->fmin = fmin;
+  e->fmax = fmax;
+}
+
+/* combine error statistics */
+static void
+merge_error(error_stats* e, const error_stats* f)
+{
+  e->count += f->count;
+  e->sse += f->sse;
+  e->emax = MAX(e->emax, f->emax);
+  e->fmin = MIN(e->fmin, f->fmin);
+  e->fmax = MAX(e->fmax, f->fmax);
+}
+
+/* accumulate reconstruction error using given number of threads (zero for default) */
+static void
+add_error_par(error_stats* e, const void* fin, const void* fout, zfp_type type, size_t n, uint threads)
+{
+#ifdef _OPENMP
+  if (threads != 1) {
+    size_t typesize = zfp_type_size(type);
+    #pragma omp parallel num_threads(threads ? (int)threads : omp_get_max_threads())
+    {
+      /* each thread accumulates a contiguous range of values */
+      size_t t = (size_t)omp_get_thread_num();
+      size_t p = (size_t)omp_get_num_threads();
+      size_t begin = n / p * t + MIN(n % p, t);
+      size_t end = n / p * (t + 1) + MIN(n % p, t + 1);
+      error_stats local;
+      init_error(&local);
+      add_error(&local, (const uchar*)fin + typesize * begin, (const uchar*)fout + typesize * begin, type, end - begin);
+      #pragma omp critical
+      merge_error(e, &local);
+    }
+    return;
+  }
+#else
+  (void)threads;
+#endif
+  add_error(e, fin, fout, type, n);
+}
+
+/* print accumulated reconstruction error */
+static void
+print_error_stats(const error_stats* e)
+{
+  double erms = sqrt(e->sse / e->count);
+  double ermsn = erms / (e->fmax - e->fmin);
+  double psnr = 20 * log10((e->fmax - e->fmin) / (2 * erms));
+  fprintf(stderr, " rmse=%.4g nrmse=%.4g maxe=%.4g psnr=%.2f", erms, ermsn, e->emax, psnr);
+}
+
+/* number of z-planes per slab when fusing error computation with decompression */
+#define STATS_SLAB_PLANES 16
+
+/* decompress 3D field one slab of planes at a time and accumulate error
+   relative to data, so that the reconstruction is never stored in full */
+static zfp_bool
+decompress_error(zfp_stream* zfp, const zfp_field* field, const void* data, uint planes, uint threads, error_stats* err, double* seconds)
+{
+  zfp_type type = zfp_field_type(field);
+  size_t typesize = zfp_type_size(type);
+  size_t nxy = (size_t)field->nx * (size_t)field->ny;
+  uint nz = (uint)field->nz;
+  void* values = malloc(typesize * nxy * planes);
+  zfp_field* slab = zfp_field_3d(values, type, field->nx, field->ny, planes);
+  zfp_bool success = values && slab;
+  uint z;
+
+  if (success)
+    zfp_decompress_begin(zfp);
+  for (z = 0; success && z < nz; z += planes) {
+    uint n = MIN(planes, nz - z);
+    double start;
+    zfp_field_set_size_3d(slab, field->nx, field->ny, n);
+    if (!zfp_decompress_slab(zfp, slab))
+      success = zfp_false;
+    else {
+      start = wall_time();
+      add_error_par(err, (const uchar*)data + typesize * nxy * z, values, type, nxy * n, threads);
+      *seconds += wall_time() - start;
+    }
+  }
+  if (success)
+    zfp_decompress_end(zfp);
+
+  zfp_field_free(slab);
+  free(values);
+
+  return success;
+}
+
+/* number of threads to compute error statistics with (zero for default) */
+static uint
+stats_threads(zfp_exec_policy exec, uint threads)
+{
+  return exec == zfp_exec_omp || exec == zfp_exec_threads ? threads : 1;
+}
+
+/* file to (de)compress in batch mode */
+typedef struct {
+  char op;         /* 'c' to compress, 'd' to decompress */
+  const char* src; /* input file */
+  const char* dst; /* output file */
+  zfp_type type;   /* scalar type (zfp_type_none if given by header) */
+  uint dims;       /* dimensionality (zero if given by header) */
+  uint n[4];       /* array dimensions */
+} batch_job;
+
+/* totals accumulated over files processed in batch mode */
+typedef struct {
+  size_t files;     /* number of files processed successfully */
+  size_t failed;    /* number of files that could not be processed */
+  size_t values;    /* number of values processed */
+  size_t rawsize;   /* total uncompressed byte size */
+  size_t zfpsize;   /* total compressed byte size */
+  error_stats err;  /* reconstruction error of compressed files */
+} batch_stats;
+
+/* initialize batch totals */
+static void
+init_batch(batch_stats* s)
+{
+  s->files = 0;
+  s->failed = 0;
+  s->values = 0;
+  s->rawsize = 0;
+  s->zfpsize = 0;
+  init_error(&s->err);
+}
+
+/* combine batch totals */
+static void
+merge_batch(batch_stats* s, const batch_stats* t)
+{
+  s->files += t->files;
+  s->failed += t->failed;
+  s->values += t->values;
+  s->rawsize += t->rawsize;
+  s->zfpsize += t->zfpsize;
+  merge_error(&s->err, &t->err);
+}
+
+/* read entire file into newly allocated buffer (NULL upon failure) */
+static void*
+read_file(const char* path, size_t* size)
+{
+  FILE* file = fopen(path, "rb");
+  size_t bufsize = 0x1000;
+  void* buffer = NULL;
+  *size = 0;
+  if (!file)
+    return NULL;
+  do {
+    void* p;
+    bufsize *= 2;
+    p = realloc(buffer, bufsize);
+    if (!p) {
+      free(buffer);
+      fclose(file);
+      return NULL;
+    }
+    buffer = p;
+    *size += fread((uchar*)buffer + *size, 1, bufsize - *size, file);
+  } while (*size == bufsize);
+  if (ferror(file)) {
+    free(buffer);
+    buffer = NULL;
+  }
+  fclose(file);
+  return buffer;
+}
+
+/* write buffer to file; return true upon success */
+static zfp_bool
+write_file(const char* path, const void* buffer, size_t size)
+{
+  FILE* file = fopen(path, "wb");
+  zfp_bool success;
+  if (!file)
+    return zfp_false;
+  success = fwrite(buffer, 1, size, file) == size;
+  return fclose(file) ? zfp_false : success;
+}
+
+/* set scalar type and dimensions of field */
+static void
+set_field(zfp_field* field, zfp_type type, uint dims, const uint* n)
+{
+  zfp_field_set_type(field, type);
+  switch (dims) {
+    case 1:
+      zfp_field_set_size_1d(field, n[0]);
+      break;
+    case 2:
+      zfp_field_set_size_2d(field, n[0], n[1]);
+      break;
+    case 3:
+      zfp_field_set_size_3d(field, n[0], n[1], n[2]);
+      break;
+    case 4:
+      zfp_field_set_size_4d(field, n[0], n[1], n[2], n[3]);
+      break;
+  }
+}
+
+/* compress file into memory buffer and write it; return compressed size */
+static size_t
+batch_compress(zfp_stream* zfp, zfp_field* field, const batch_job* job, int header, error_stats* err)
+{
+  size_t rawsize = zfp_type_size(zfp_field_type(field)) * zfp_field_size(field, NULL);
+  size_t size = 0;
+  size_t zfpsize = 0;
+  void* fi = read_file(job->src, &size);
+  void* fo = NULL;
+  void* buffer = NULL;
+  bitstream* stream = NULL;
+
+  /* compress file of expected size */
+  if (fi && size == rawsize) {
+    zfp_field_set_pointer(field, fi);
+    size = zfp_stream_maximum_size(zfp, field);
+    buffer = malloc(size);
+    stream = buffer ? stream_open(buffer, size) : NULL;
+  }
+  if (stream) {
+    zfp_stream_set_bit_stream(zfp, stream);
+    zfp_stream_rewind(zfp);
+    if (!header || zfp_write_header(zfp, field, ZFP_HEADER_FULL))
+      zfpsize = zfp_compress(zfp, field);
+    if (zfpsize && !write_file(job->dst, buffer, zfpsize))
+      zfpsize = 0;
+  }
+
+  /* optionally decompress to measure error */
+  if (zfpsize && err) {
+    fo = malloc(rawsize);
+    zfp_field_set_pointer(field, fo);
+    zfp_stream_rewind(zfp);
+    if (fo && (!header || zfp_read_header(zfp, field, ZFP_HEADER_FULL)) && zfp_decompress(zfp, field))
+      add_error(err, fi, fo, zfp_field_type(field), zfp_field_size(field, NULL));
+    else
+      zfpsize = 0;
+  }
+
+  stream_close(stream);
+  free(buffer);
+  free(fo);
+  free(fi);
+  return zfpsize;
+}
+
+/* decompress file and write uncompressed data; return compressed size */
+static size_t
+batch_decompress(zfp_stream* zfp, zfp_field* field, const batch_job* job, int header)
+{
+  size_t zfpsize = 0;
+  void* buffer = read_file(job->src, &zfpsize);
+  bitstream* stream = buffer ? stream_open(buffer, zfpsize) : NULL;
+  void* fo = NULL;
+  size_t rawsize;
+
+  if (!stream) {
+    free(buffer);
+    return 0;
+  }
+
+  /* obtain metadata from header when present */
+  zfp_stream_set_bit_stream(zfp, stream);
+  zfp_stream_rewind(zfp);
+  if (header && !zfp_read_header(zfp, field, ZFP_HEADER_FULL))
+    zfpsize = 0;
+
+  /* decompress and write uncompressed file */
+  rawsize = zfp_type_size(zfp_field_type(field)) * zfp_field_size(field, NULL);
+  fo = zfpsize ? malloc(rawsize) : NULL;
+  zfp_field_set_pointer(field, fo);
+  if (!fo || !zfp_decompress(zfp, field) || !write_file(job->dst, fo, rawsize))
+    zfpsize = 0;
+
+  stream_close(stream);
+  free(buffer);
+  free(fo);
+  return zfpsize;
+}
+
+/* (de)compress one file using given mode and update totals */
+static zfp_bool
+batch_file(zfp_stream* zfp, const batch_job* job, uint64 mode, double rate, int header, int stats, batch_stats* total)
+{
+  zfp_field* field = zfp_field_alloc();
+  size_t zfpsize = 0;
+
+  if (field) {
+    /* undo any mode read from previous header; fixed rate depends on type and dimensionality */
+    zfp_stream_set_mode(zfp, mode);
+    if (job->op == 'c' || !header) {
+      set_field(field, job->type, job->dims, job->n);
+      if (rate)
+        zfp_stream_set_rate(zfp, rate, job->type, job->dims, zfp_false);
+    }
+    if (job->op == 'c')
+      zfpsize = batch_compress(zfp, field, job, header, stats ? &total->err : NULL);
+    else
+      zfpsize = batch_decompress(zfp, field, job, header);
+  }
+
+  if (zfpsize) {
+    total->files++;
+    total->values += zfp_field_size(field, NULL);
+    total->rawsize += zfp_type_size(zfp_field_type(field)) * zfp_field_size(field, NULL);
+    total->zfpsize += zfpsize;
+  }
+  else
+    total->failed++;
+
+  zfp_field_free(field);
+  return zfpsize != 0;
+}
+
+/* byte alignment of fields in containers, which allows mapping them as pages */
+#define CONTAINER_ALIGNMENT 4096
+
+/* compress file into container under name given by destination; update totals */
+static zfp_bool
+container_add(zfp_container* c, zfp_stream* zfp, const batch_job* job, uint64 mode, double rate, batch_stats* total)
+{
+  zfp_field* field = zfp_field_alloc();
+  size_t size = 0;
+  void* fi = NULL;
+  zfp_bool done = zfp_false;
+
+  if (field) {
+    zfp_stream_set_mode(zfp, mode);
+    set_field(field, job->type, job->dims, job->n);
+    if (rate)
+      zfp_stream_set_rate(zfp, rate, job->type, job->dims, zfp_false);
+    fi = read_file(job->src, &size);
+    if (fi && size == zfp_type_size(job->type) * zfp_field_size(field, NULL)) {
+      zfp_field_set_pointer(field, fi);
+      done = zfp_container_add(c, job->dst, zfp, field);
+    }
+  }
+
+  if (done) {
+    total->files++;
+    total->values += zfp_field_size(field, NULL);
+    total->rawsize += size;
+    total->zfpsize += zfp_container_size(c, zfp_container_fields(c) - 1);
+  }
+  else
+    total->failed++;
+
+  free(fi);
+  zfp_field_free(field);
+  return done;
+}
+
+/* decompress field named by source from container to file; update totals */
+static zfp_bool
+container_extract(const zfp_container* c, zfp_stream* zfp, const batch_job* job, batch_stats* total)
+{
+  size_t i = zfp_container_find(c, job->src);
+  zfp_field* field = zfp_field_alloc();
+  size_t rawsize = 0;
+  void* fo = NULL;
+  zfp_bool done = zfp_false;
+
+  if (field && zfp_container_field(c, i, field)) {
+    rawsize = zfp_type_size(zfp_field_type(field)) * zfp_field_size(field, NULL);
+    fo = malloc(rawsize);
+    zfp_field_set_pointer(field, fo);
+    done = fo && zfp_container_decompress(c, i, zfp, field) && write_file(job->dst, fo, rawsize);
+  }
+
+  if (done) {
+    total->files++;
+    total->values += zfp_field_size(field, NULL);
+    total->rawsize += rawsize;
+    total->zfpsize += zfp_container_size(c, i);
+  }
+  else
+    total->failed++;
+
+  free(fo);
+  zfp_field_free(field);
+  return done;
+}
+
+/* pack files into container, then extract fields from it, using shared stream */
+static void
+batch_container(const char* path, zfp_stream* zfp, const batch_job* jobs, size_t count, uint64 mode, double rate, batch_stats* total)
+{
+  zfp_container* c = NULL;
+  const void* data = NULL;
+  void* buffer = NULL;
+  size_t size = 0;
+  size_t mapsize = 0;
+  size_t packed = 0;
+  size_t j;
+
+  for (j = 0; j < count; j++)
+    packed += (jobs[j].op == 'c');
+
+  /* compress files and write container */
+  if (packed) {
+    batch_stats local;
+    init_batch(&local);
+    c = zfp_container_create(CONTAINER_ALIGNMENT);
+    for (j = 0; j < count; j++)
+      if (jobs[j].op == 'c' && (!c || !container_add(c, zfp, jobs + j, mode, rate, &local)))
+        fprintf(stderr, "cannot compress %s\n", jobs[j].src);
+    data = c ? zfp_container_finish(c, &size) : NULL;
+    if (data && write_file(path, data, size))
+      merge_batch(total, &local);
+    else {
+      fprintf(stderr, "cannot write container %s\n", path);
+      total->failed += packed;
+    }
+  }
+
+  /* decompress fields from container just written or read from file */
+  if (packed < count) {
+    zfp_container* r;
+    if (!data) {
+      data = buffer = map_file(path, &mapsize);
+      size = mapsize;
+      if (!data)
+        data = buffer = read_file(path, &size);
+    }
+    r = data ? zfp_container_open(data, size) : NULL;
+    if (!r)
+      fprintf(stderr, "cannot read container %s\n", path);
+    for (j = 0; j < count; j++)
+      if (jobs[j].op == 'd') {
+        if (!r)
+          total->failed++;
+        else if (!container_extract(r, zfp, jobs + j, total))
+          fprintf(stderr, "cannot decompress %s\n", jobs[j].src);
+      }
+    zfp_container_close(r);
+  }
+
+  if (mapsize)
+    unmap_file(buffer, mapsize);
+  else
+    free(buffer);
+  zfp_container_close(c);
+}
+
+/* print fields stored in container; return zfp_true upon success */
+static zfp_bool
+list_container(const char* path)
+{
+  const char* type_name[] = { "i32", "i64", "f32", "f64" };
+  size_t size = 0;
+  size_t mapsize = 0;
+  void* data = map_file(path, &mapsize);
+  zfp_container* c;
+  zfp_stream* zfp = zfp_stream_open(NULL);
+  zfp_field* field = zfp_field_alloc();
+  size_t i;
+
+  if (data)
+    size = mapsize;
+  else
+    data = read_file(path, &size);
+  c = data ? zfp_container_open(data, size) : NULL;
+  if (c && zfp && field) {
+    for (i = 0; i < zfp_container_fields(c); i++) {
+      uint n[4];
+      uint dims, d;
+      zfp_container_field(c, i, field);
+      dims = zfp_field_dimensionality(field);
+      zfp_field_size(field, n);
+      printf("%s %s ", zfp_container_name(c, i), type_name[zfp_field_type(field) - zfp_type_int32]);
+      for (d = 0; d < dims; d++)
+        printf("%s%lu", d ? "x" : "", (unsigned long)n[d]);
+      zfp_stream_set_mode(zfp, zfp_container_mode(c, i));
+      switch (zfp_stream_compression_mode(zfp)) {
+        case zfp_mode_fixed_rate:
+          printf(" rate=%g", zfp_stream_rate(zfp, dims));
+          break;
+        case zfp_mode_fixed_precision:
+          printf(" precision=%u", zfp_stream_precision(zfp));
+          break;
+        case zfp_mode_fixed_accuracy:
+          printf(" accuracy=%g", zfp_stream_accuracy(zfp));
+          break;
+        case zfp_mode_reversible:
+          printf(" reversible");
+          break;
+        default:
+          printf(" expert");
+          break;
+      }
+      printf(" bytes=%lu chunks=%lu\n", (unsigned long)zfp_container_size(c, i), (unsigned long)zfp_container_chunks(c, i));
+    }
+  }
+  else
+    fprintf(stderr, "cannot read container %s\n", path);
+
+  zfp_container_close(c);
+  zfp_field_free(field);
+  zfp_stream_close(zfp);
+  if (mapsize)
+    unmap_file(data, mapsize);
+  else
+    free(data);
+  return c != NULL;
+}
+
+/* parse scalar type name (zfp_type_none if invalid) */
+static zfp_type
+parse_type(const char* name)
+{
+  if (!strcmp(name, "i32"))
+    return zfp_type_int32;
+  if (!strcmp(name, "i64"))
+    return zfp_type_int64;
+  if (!strcmp(name, "f32"))
+    return zfp_type_float;
+  if (!strcmp(name, "f64"))
+    return zfp_type_double;
+  return zfp_type_none;
+}
+
+/* split manifest text in place into jobs; return number of jobs (or zero if invalid) */
+static size_t
+parse_manifest(char* text, batch_job** jobs, const batch_job* defaults, char mode, int header)
+{
+  size_t lines = 1;
+  size_t count = 0;
+  size_t line;
+  char* p;
+
+  for (p = text; *p; p++)
+    lines += (*p == '\n');
+  *jobs = (batch_job*)malloc(lines * sizeof(batch_job));
+  if (!*jobs)
+    return 0;
+
+  for (line = 1, p = text; *p; line++) {
+    char* token[9];
+    uint tokens = 0;
+    batch_job* job = *jobs + count;
+
+    /* split line into whitespace-separated tokens, ignoring comments */
+    while (*p && *p != '\n') {
+      if (isspace((uchar)*p))
+        *p++ = '\0';
+      else if (*p == '#')
+        while (*p && *p != '\n')
+          *p++ = '\0';
+      else {
+        if (tokens < 9)
+          token[tokens++] = p;
+        while (*p && !isspace((uchar)*p))
+          p++;
+      }
+    }
+    if (*p == '\n')
+      *p++ = '\0';
+    if (!tokens)
+      continue;
+
+    /* parse operation, paths, and optional type and dimensions */
+    *job = *defaults;
+    if (tokens < 3 || tokens == 4 || tokens > 8 || strlen(token[0]) != 1 || !strchr("cd", token[0][0])) {
+      fprintf(stderr, "manifest line %lu: expected c|d <src> <dst> [<type> <nx> [<ny> [<nz> [<nw>]]]]\n", (unsigned long)line);
+      free(*jobs);
+      return 0;
+    }
+    job->op = token[0][0];
+    job->src = token[1];
+    job->dst = token[2];
+    if (tokens > 3) {
+      uint i;
+      job->type = parse_type(token[3]);
+      job->dims = tokens - 4;
+      for (i = 0; i < 4; i++)
+        job->n[i] = 1;
+      for (i = 0; i < job->dims; i++)
+        if (sscanf(token[4 + i], "%u", &job->n[i]) != 1 || !job->n[i])
+          job->type = zfp_type_none;
+      if (job->type == zfp_type_none) {
+        fprintf(stderr, "manifest line %lu: invalid scalar type or dimensions\n", (unsigned long)line);
+        free(*jobs);
+        return 0;
+      }
+    }
+
+    /* make sure type, dimensions, and mode are known */
+    if ((job->op == 'c' || !header) && (job->type == zfp_type_none || !job->dims || !mode)) {
+      fprintf(stderr, "manifest line %lu: must specify scalar type, dimensions, and compression parameters%s\n", (unsigned long)line, job->op == 'c' ? "" : " or header");
+      free(*jobs);
+      return 0;
+    }
+    count++;
+  }
+
+  if (!count) {
+    fprintf(stderr, "manifest lists no files\n");
+    free(*jobs);
+  }
+  return count;
+}
+
+/* (de)compress files listed in manifest, concurrently if requested; return number of failures */
+static size_t
+batch(const char* path, const char* container, zfp_stream* config, const batch_job* defaults, char mode, double rate, int header, int stats, int quiet, int timing, int concurrent, uint threads)
+{
+  uint64 zmode = zfp_stream_mode(config);
+  batch_stats total;
+  batch_job* jobs = NULL;
+  size_t count = 0;
+  size_t size;
+  double start;
+  char* text = (char*)read_file(path, &size);
+
+  /* read manifest as null-terminated text and parse it */
+  if (text) {
+    char* p = (char*)realloc(text, size + 1);
+    if (p) {
+      text = p;
+      text[size] = '\0';
+      /* fields in containers carry their type and dimensions */
+      count = parse_manifest(text, &jobs, defaults, mode, header || container);
+    }
+  }
+  else
+    fprintf(stderr, "cannot read manifest\n");
+  if (!count) {
+    free(text);
+    return 1;
+  }
+
+  init_batch(&total);
+  start = wall_time();
+
+#ifndef _OPENMP
+  (void)concurrent;
+  (void)threads;
+#endif
+  if (container) {
+    /* pack into or extract from container in order using shared stream */
+    batch_container(container, config, jobs, count, zmode, rate, &total);
+  }
+#ifdef _OPENMP
+  else if (concurrent) {
+    /* (de)compress one file per thread, each with its own serial stream */
+    int j;
+    if (threads)
+      omp_set_num_threads((int)threads);
+    #pragma omp parallel
+    {
+      zfp_stream* zfp = zfp_stream_open(NULL);
+      batch_stats local;
+      init_batch(&local);
+      #pragma omp for schedule(dynamic)
+      for (j = 0; j < (int)count; j++)
+        if (!zfp || !batch_file(zfp, jobs + j, zmode, rate, header, stats, &local))
+          fprintf(stderr, "cannot %s %s\n", jobs[j].op == 'c' ? "compress" : "decompress", jobs[j].src);
+      #pragma omp critical
+      merge_batch(&total, &local);
+      zfp_stream_close(zfp);
+    }
+  }
+#endif
+  else {
+    /* (de)compress files in order using shared stream and execution policy */
+    batch_stats local;
+    size_t j;
+    init_batch(&local);
+    for (j = 0; j < count; j++)
+      if (!batch_file(config, jobs + j, zmode, rate, header, stats, &local))
+        fprintf(stderr, "cannot %s %s\n", jobs[j].op == 'c' ? "compress" : "decompress", jobs[j].src);
+    merge_batch(&total, &local);
+  }
+
+  /* print aggregate statistics */
+  if (!quiet) {
+    fprintf(stderr, "files=%lu failed=%lu raw=%lu zfp=%lu", (unsigned long)total.files, (unsigned long)total.failed, (unsigned long)total.rawsize, (unsigned long)total.zfpsize);
+    if (total.zfpsize)
+      fprintf(stderr, " ratio=%.3g rate=%.4g", (double)total.rawsize / total.zfpsize, CHAR_BIT * (double)total.zfpsize / total.values);
+    if (stats && total.err.count)
+      print_error_stats(&total.err);
+    fprintf(stderr, "\n");
+  }
+  if (timing) {
+    fprintf(stderr, "time:");
+    print_time("batch", wall_time() - start, total.rawsize);
+    fprintf(stderr, "\n");
+  }
+
+  free(jobs);
+  free(text);
+  return total.failed;
 }
 
 static void
@@ -88,10 +1257,21 @@ usage()
   fprintf(stderr, "  -h : read/write array and compression parameters from/to compressed header\n");
   fprintf(stderr, "  -q : quiet mode; suppress output\n");
   fprintf(stderr, "  -s : print error statistics\n");
+  fprintf(stderr, "  -T : print time and throughput of I/O, compression, decompression, and stats\n");
   fprintf(stderr, "Input and output:\n");
   fprintf(stderr, "  -i <path> : uncompressed binary input file (\"-\" for stdin)\n");
   fprintf(stderr, "  -o <path> : decompressed binary output file (\"-\" for stdout)\n");
   fprintf(stderr, "  -z <path> : compressed input (w/o -i) or output file (\"-\" for stdin/stdout)\n");
+  fprintf(stderr, "  -B <path> : (de)compress files listed in manifest, one per line:\n");
+  fprintf(stderr, "      c|d <src> <dst> [<type> <nx> [<ny> [<nz> [<nw>]]]]\n");
+  fprintf(stderr, "  -P <path> : with -B, pack files into container under name <dst> (c) or\n");
+  fprintf(stderr, "      extract fields named <src> from container (d)\n");
+  fprintf(stderr, "  -L <path> : list fields stored in container\n");
+  fprintf(stderr, "  -I : read/write chunk index for parallel decompression from/to compressed stream\n");
+  fprintf(stderr, "  -m : memory-map input files instead of reading them into memory\n");
+  fprintf(stderr, "  -S <planes> : stream 3D arrays in slabs of z planes (multiple of 4)\n");
+  fprintf(stderr, "  -D : read and write compressed files and slabs with direct I/O, bypassing\n");
+  fprintf(stderr, "       the page cache and overlapping writes with compression (Linux only)\n");
   fprintf(stderr, "Array type and dimensions (needed with -i):\n");
   fprintf(stderr, "  -f : single precision (float type)\n");
   fprintf(stderr, "  -d : double precision (double type)\n");
@@ -112,7 +1292,8 @@ usage()
   fprintf(stderr, "      minexp : min bit plane # coded (-1074 for all bit planes)\n");
   fprintf(stderr, "Execution parameters:\n");
   fprintf(stderr, "  -x serial : serial compression (default)\n");
-  fprintf(stderr, "  -x omp[=threads[,chunk_size]] : OpenMP parallel compression\n");
+  fprintf(stderr, "  -x omp[=threads[,chunk_size]] : OpenMP parallel compression/decompression\n");
+  fprintf(stderr, "  -x threads[=threads[,chunk_size]] : thread-pool parallel compression/decompression\n");
   fprintf(stderr, "  -x cuda : CUDA fixed rate parallel compression/decompression\n");
   fprintf(stderr, "  -x hip : HIP fixed rate parallel compression/decompression\n");
   fprintf(stderr, "Examples:\n");
@@ -129,6 +1310,11 @@ usage()
   fprintf(stderr, "  -d -1 1000000 -a 1e-9 : compression of 1M doubles with < 1e-9 max error\n");
   fprintf(stderr, "  -d -1 1000000 -c 64 64 0 -1074 : 4x fixed-rate compression of 1M doubles\n");
   fprintf(stderr, "  -x omp=16,256 : parallel compression with 16 threads, 256-block chunks\n");
+  fprintf(stderr, "  -x omp -I -h -i ifile -z zfile : compress in parallel, store chunk index\n");
+  fprintf(stderr, "  -x omp -I -h -z zfile -o ofile -T : decompress in parallel, print timings\n");
+  fprintf(stderr, "  -x omp -a 1e-6 -B list -P cfile : compress files in list into container\n");
+  fprintf(stderr, "  -x omp=8 -h -a 1e-6 -B list : compress files in list using 8 threads\n");
+  fprintf(stderr, "  -m -S 16 -i ifile -z zfile : compress 16 mapped planes at a time\n");
   exit(EXIT_FAILURE);
 }
 
@@ -156,10 +1342,18 @@ int main(int argc, char* argv[])
   char* inpath = 0;
   char* zfppath = 0;
   char* outpath = 0;
+  char* batchpath = 0;
+  char* containerpath = 0;
+  char* listpath = 0;
   char mode = 0;
   zfp_exec_policy exec = zfp_exec_serial;
   uint threads = 0;
   uint chunk_size = 0;
+  int mapped = 0;
+  int direct = 0;
+  uint planes = 0;
+  int indexed = 0;
+  int timing = 0;
 
   /* local variables */
   int i;
@@ -172,6 +1366,16 @@ int main(int argc, char* argv[])
   size_t rawsize = 0;
   size_t zfpsize = 0;
   size_t bufsize = 0;
+  size_t mapsize = 0;
+  size_t hdrbits = 0;
+  FILE* infile = NULL;
+  double start = 0;
+  double iotime = 0;
+  double ziptime = 0;
+  double unziptime = 0;
+  double statstime = 0;
+  size_t iosize = 0;
+  error_stats err;
 
   if (argc == 1)
     usage();
@@ -215,6 +1419,11 @@ int main(int argc, char* argv[])
           usage();
         mode = 'a';
         break;
+      case 'B':
+        if (++i == argc)
+          usage();
+        batchpath = argv[i];
+        break;
       case 'c':
         if (++i == argc || sscanf(argv[i], "%u", &minbits) != 1 ||
             ++i == argc || sscanf(argv[i], "%u", &maxbits) != 1 ||
@@ -223,6 +1432,11 @@ int main(int argc, char* argv[])
           usage();
         mode = 'c';
         break;
+      case 'D':
+#ifdef ZFP_WITH_DIRECT_IO
+        direct = 1;
+#endif
+        break;
       case 'd':
         type = zfp_type_double;
         break;
@@ -237,11 +1451,27 @@ int main(int argc, char* argv[])
           usage();
         inpath = argv[i];
         break;
+      case 'I':
+        indexed = 1;
+        break;
+      case 'L':
+        if (++i == argc)
+          usage();
+        listpath = argv[i];
+        break;
+      case 'm':
+        mapped = 1;
+        break;
       case 'o':
         if (++i == argc)
           usage();
         outpath = argv[i];
         break;
+      case 'P':
+        if (++i == argc)
+          usage();
+        containerpath = argv[i];
+        break;
       case 'p':
         if (++i == argc || sscanf(argv[i], "%u", &precision) != 1)
           usage();
@@ -261,18 +1491,18 @@ int main(int argc, char* argv[])
       case 's':
         stats = 1;
         break;
+      case 'S':
+        if (++i == argc || sscanf(argv[i], "%u", &planes) != 1 || !planes || planes % 4)
+          usage();
+        break;
+      case 'T':
+        timing = 1;
+        break;
       case 't':
         if (++i == argc)
           usage();
-        if (!strcmp(argv[i], "i32"))
-          type = zfp_type_int32;
-        else if (!strcmp(argv[i], "i64"))
-          type = zfp_type_int64;
-        else if (!strcmp(argv[i], "f32"))
-          type = zfp_type_float;
-        else if (!strcmp(argv[i], "f64"))
-          type = zfp_type_double;
-        else
+        type = parse_type(argv[i]);
+        if (type == zfp_type_none)
           usage();
         break;
       case 'x':
@@ -291,6 +1521,17 @@ int main(int argc, char* argv[])
           threads = 0;
           chunk_size = 0;
         }
+        else if (sscanf(argv[i], "threads=%u,%u", &threads, &chunk_size) == 2)
+          exec = zfp_exec_threads;
+        else if (sscanf(argv[i], "threads=%u", &threads) == 1) {
+          exec = zfp_exec_threads;
+          chunk_size = 0;
+        }
+        else if (!strcmp(argv[i], "threads")) {
+          exec = zfp_exec_threads;
+          threads = 0;
+          chunk_size = 0;
+        }
         else if (!strcmp(argv[i], "cuda"))
           exec = zfp_exec_cuda;
 	else if (!strcmp(argv[i], "hip"))
@@ -318,14 +1559,30 @@ int main(int argc, char* argv[])
     return EXIT_FAILURE;
   }
 
+  /* list container contents */
+  if (listpath)
+    return list_container(listpath) ? EXIT_SUCCESS : EXIT_FAILURE;
+
+  /* containers are packed and extracted in batch mode */
+  if (containerpath && !batchpath) {
+    fprintf(stderr, "must specify manifest via -B to use container\n");
+    return EXIT_FAILURE;
+  }
+
+  /* make sure batch mode reads and writes only files listed in manifest */
+  if (batchpath && (inpath || zfppath || outpath || mapped || planes || indexed)) {
+    fprintf(stderr, "cannot combine batch mode with -i, -z, -o, -m, -S, or -I\n");
+    return EXIT_FAILURE;
+  }
+
   /* make sure we have an input file */
-  if (!inpath && !zfppath) {
+  if (!batchpath && !inpath && !zfppath) {
     fprintf(stderr, "must specify uncompressed or compressed input file via -i or -z\n");
     return EXIT_FAILURE;
   }
 
   /* make sure we (will) know scalar type */
-  if (!typesize) {
+  if (!typesize && !batchpath) {
     if (inpath) {
       fprintf(stderr, "must specify scalar type via -f, -d, or -t to compress\n");
       return EXIT_FAILURE;
@@ -337,7 +1594,7 @@ int main(int argc, char* argv[])
   }
 
   /* make sure we (will) know array dimensions */
-  if (!dims) {
+  if (!dims && !batchpath) {
     if (inpath) {
       fprintf(stderr, "must specify array dimensions via -1, -2, -3, or -4 to compress\n");
       return EXIT_FAILURE;
@@ -349,7 +1606,7 @@ int main(int argc, char* argv[])
   }
 
   /* make sure we (will) know (de)compression mode and parameters */
-  if (!mode) {
+  if (!mode && !batchpath) {
     if (inpath) {
       fprintf(stderr, "must specify compression parameters via -a, -c, -p, or -r to compress\n");
       return EXIT_FAILURE;
@@ -361,11 +1618,48 @@ int main(int argc, char* argv[])
   }
 
   /* make sure we have input file for stats */
-  if (stats && !inpath) {
+  if (stats && !inpath && !batchpath) {
     fprintf(stderr, "must specify input file via -i to compute stats\n");
     return EXIT_FAILURE;
   }
 
+  /* make sure input files can be mapped */
+  if (mapped) {
+#ifdef ZFP_WITH_MMAP
+    if (inpath ? !strcmp(inpath, "-") : !strcmp(zfppath, "-")) {
+      fprintf(stderr, "cannot memory-map standard input\n");
+      return EXIT_FAILURE;
+    }
+#else
+    fprintf(stderr, "memory mapping not available\n");
+    return EXIT_FAILURE;
+#endif
+  }
+
+  /* make sure slabs are streamed from one file to another */
+  if (planes) {
+    if (stats || !zfppath || (inpath ? !!outpath : !outpath)) {
+      fprintf(stderr, "slab streaming requires -i with -z or -z with -o and no -s\n");
+      return EXIT_FAILURE;
+    }
+    if (inpath && dims != 3) {
+      fprintf(stderr, "slab streaming requires 3D array\n");
+      return EXIT_FAILURE;
+    }
+  }
+
+  /* make sure chunk index is recorded by parallel compressor in memory */
+  if (indexed) {
+    if (planes) {
+      fprintf(stderr, "cannot combine chunk index with slab streaming\n");
+      return EXIT_FAILURE;
+    }
+    if (inpath && exec != zfp_exec_omp && exec != zfp_exec_threads) {
+      fprintf(stderr, "chunk index requires -x omp or -x threads to compress\n");
+      return EXIT_FAILURE;
+    }
+  }
+
   /* make sure meta data comes from header or command line, not both */
   if (!inpath && zfppath && header && (typesize || dims)) {
     fprintf(stderr, "cannot specify both field type/size and header\n");
@@ -376,27 +1670,66 @@ int main(int argc, char* argv[])
   field = zfp_field_alloc();
 
   /* read uncompressed or compressed file */
+  start = wall_time();
   if (inpath) {
-    /* read uncompressed input file */
-    FILE* file = !strcmp(inpath, "-") ? stdin : fopen(inpath, "rb");
-    if (!file) {
-      fprintf(stderr, "cannot open input file\n");
+    rawsize = typesize * count;
+    if (mapped) {
+      /* map uncompressed input file */
+      fi = map_file(inpath, &mapsize);
+      if (!fi || mapsize < rawsize) {
+        fprintf(stderr, "cannot map input file\n");
+        return EXIT_FAILURE;
+      }
+    }
+    else {
+      /* read uncompressed input file, or leave it open when streaming slabs */
+      FILE* file = !strcmp(inpath, "-") ? stdin : fopen(inpath, "rb");
+      if (!file) {
+        fprintf(stderr, "cannot open input file\n");
+        return EXIT_FAILURE;
+      }
+      if (planes)
+        infile = file;
+      else {
+        fi = malloc(rawsize);
+        if (!fi) {
+          fprintf(stderr, "cannot allocate memory\n");
+          return EXIT_FAILURE;
+        }
+        if (fread(fi, typesize, count, file) != count) {
+          fprintf(stderr, "cannot read input file\n");
+          return EXIT_FAILURE;
+        }
+        fclose(file);
+      }
+    }
+    zfp_field_set_pointer(field, fi);
+  }
+  else if (mapped) {
+    /* map compressed input file */
+    buffer = map_file(zfppath, &mapsize);
+    if (!buffer) {
+      fprintf(stderr, "cannot map compressed file\n");
       return EXIT_FAILURE;
     }
-    rawsize = typesize * count;
-    fi = malloc(rawsize);
-    if (!fi) {
-      fprintf(stderr, "cannot allocate memory\n");
+    zfpsize = mapsize;
+    stream = stream_open(buffer, mapsize);
+    if (!stream) {
+      fprintf(stderr, "cannot open compressed stream\n");
       return EXIT_FAILURE;
     }
-    if (fread(fi, typesize, count, file) != count) {
-      fprintf(stderr, "cannot read input file\n");
+    zfp_stream_set_bit_stream(zfp, stream);
+  }
+  else if (direct && zfppath && strcmp(zfppath, "-") && (buffer = read_direct(zfppath, &zfpsize, &bufsize)) != NULL) {
+    /* compressed input file was read with direct I/O */
+    stream = stream_open(buffer, bufsize);
+    if (!stream) {
+      fprintf(stderr, "cannot open compressed stream\n");
       return EXIT_FAILURE;
     }
-    fclose(file);
-    zfp_field_set_pointer(field, fi);
+    zfp_stream_set_bit_stream(zfp, stream);
   }
-  else {
+  else if (zfppath) {
     /* read compressed input file in increasingly large chunks */
     FILE* file = !strcmp(zfppath, "-") ? stdin : fopen(zfppath, "rb");
     if (!file) {
@@ -427,9 +1760,11 @@ int main(int argc, char* argv[])
     }
     zfp_stream_set_bit_stream(zfp, stream);
   }
+  iotime += wall_time() - start;
+  iosize += inpath ? (infile ? 0 : rawsize) : zfpsize;
 
   /* set field dimensions and (de)compression parameters */
-  if (inpath || !header) {
+  if (inpath || batchpath || !header) {
     /* initialize uncompressed field */
     zfp_field_set_type(field, type);
     switch (dims) {
@@ -465,7 +1800,7 @@ int main(int argc, char* argv[])
         if (!maxbits)
           maxbits = ZFP_MAX_BITS;
         if (!maxprec)
-          maxprec = zfp_field_precision(field);
+          maxprec = type == zfp_type_none ? ZFP_MAX_PREC : zfp_field_precision(field);
         if (!zfp_stream_set_params(zfp, minbits, maxbits, maxprec, minexp)) {
           fprintf(stderr, "invalid compression parameters\n");
           return EXIT_FAILURE;
@@ -495,6 +1830,18 @@ int main(int argc, char* argv[])
         fprintf(stderr, "OpenMP execution not available\n");
         return EXIT_FAILURE;
       }
+      /* record chunk offsets to allow parallel decompression */
+      zfp_stream_set_index(zfp, zfp_index_alloc());
+      break;
+    case zfp_exec_threads:
+      if (!zfp_stream_set_execution(zfp, exec) ||
+          !zfp_stream_set_thread_count(zfp, threads) ||
+          !zfp_stream_set_thread_chunk_size(zfp, chunk_size)) {
+        fprintf(stderr, "thread-pool execution not available\n");
+        return EXIT_FAILURE;
+      }
+      /* record chunk offsets to allow parallel decompression */
+      zfp_stream_set_index(zfp, zfp_index_alloc());
       break;
     case zfp_exec_serial:
     default:
@@ -505,8 +1852,49 @@ int main(int argc, char* argv[])
       break;
   }
 
+  /* (de)compress files listed in manifest */
+  if (batchpath) {
+    batch_job defaults;
+    size_t failed;
+    defaults.op = 0;
+    defaults.src = defaults.dst = NULL;
+    defaults.type = type;
+    defaults.dims = dims;
+    defaults.n[0] = nx;
+    defaults.n[1] = ny;
+    defaults.n[2] = nz;
+    defaults.n[3] = nw;
+    failed = batch(batchpath, containerpath, zfp, &defaults, mode, mode == 'r' ? rate : 0, header, stats, quiet, timing, exec == zfp_exec_omp || exec == zfp_exec_threads, threads);
+    zfp_field_free(field);
+    zfp_index_free(zfp_stream_index(zfp));
+    zfp_stream_close(zfp);
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+  }
+
+  /* compress input file one slab at a time if requested */
+  if (inpath && planes) {
+    direct_file* dfile = direct && strcmp(zfppath, "-") ? direct_open(zfppath) : NULL;
+    FILE* file = dfile ? NULL : !strcmp(zfppath, "-") ? stdout : fopen(zfppath, "wb");
+    if (!file && !dfile) {
+      fprintf(stderr, "cannot create compressed file\n");
+      return EXIT_FAILURE;
+    }
+    start = wall_time();
+    zfpsize = compress_slabs(zfp, field, fi, infile, file, dfile, planes, header);
+    if (zfpsize == 0) {
+      fprintf(stderr, "compression failed\n");
+      return EXIT_FAILURE;
+    }
+    if (!close_output(file, dfile)) {
+      fprintf(stderr, "cannot write compressed file\n");
+      return EXIT_FAILURE;
+    }
+    if (infile)
+      fclose(infile);
+    ziptime += wall_time() - start;
+  }
   /* compress input file if provided */
-  if (inpath) {
+  else if (inpath) {
     /* allocate buffer for compressed data */
     bufsize = zfp_stream_maximum_size(zfp, field);
     if (!bufsize) {
@@ -528,9 +1916,13 @@ int main(int argc, char* argv[])
     zfp_stream_set_bit_stream(zfp, stream);
 
     /* optionally write header */
-    if (header && !zfp_write_header(zfp, field, ZFP_HEADER_FULL)) {
-      fprintf(stderr, "cannot write header\n");
-      return EXIT_FAILURE;
+    start = wall_time();
+    if (header) {
+      hdrbits = zfp_write_header(zfp, field, ZFP_HEADER_FULL);
+      if (!hdrbits) {
+        fprintf(stderr, "cannot write header\n");
+        return EXIT_FAILURE;
+      }
     }
 
     /* compress data */
@@ -540,18 +1932,33 @@ int main(int argc, char* argv[])
       return EXIT_FAILURE;
     }
 
+    /* optionally insert chunk index between header and compressed data */
+    if (indexed) {
+      if (!embed_index(zfp, field, &stream, &buffer, &bufsize, hdrbits)) {
+        fprintf(stderr, "cannot write chunk index\n");
+        return EXIT_FAILURE;
+      }
+      zfpsize = stream_size(stream);
+    }
+    ziptime += wall_time() - start;
+
     /* optionally write compressed data */
     if (zfppath) {
-      FILE* file = !strcmp(zfppath, "-") ? stdout : fopen(zfppath, "wb");
-      if (!file) {
+      direct_file* dfile;
+      FILE* file;
+      start = wall_time();
+      dfile = direct && strcmp(zfppath, "-") ? direct_open(zfppath) : NULL;
+      file = dfile ? NULL : !strcmp(zfppath, "-") ? stdout : fopen(zfppath, "wb");
+      if (!file && !dfile) {
         fprintf(stderr, "cannot create compressed file\n");
         return EXIT_FAILURE;
       }
-      if (fwrite(buffer, 1, zfpsize, file) != zfpsize) {
+      if (!write_output(file, dfile, buffer, zfpsize) || !close_output(file, dfile)) {
         fprintf(stderr, "cannot write compressed file\n");
         return EXIT_FAILURE;
       }
-      fclose(file);
+      iotime += wall_time() - start;
+      iosize += zfpsize;
     }
   }
 
@@ -583,42 +1990,107 @@ int main(int argc, char* argv[])
       count = (size_t)nx * (size_t)ny * (size_t)nz * (size_t)nw;
     }
 
-    /* allocate memory for decompressed data */
-    rawsize = typesize * count;
-    fo = malloc(rawsize);
-    if (!fo) {
-      fprintf(stderr, "cannot allocate memory\n");
-      return EXIT_FAILURE;
+    /* obtain chunk offsets from index when present */
+    if (indexed) {
+      if (!zfp_stream_index(zfp))
+        zfp_stream_set_index(zfp, zfp_index_alloc());
+      if (!zfp_stream_index(zfp) || !zfp_read_index(zfp, zfp_stream_index(zfp))) {
+        fprintf(stderr, "incorrect or missing chunk index\n");
+        return EXIT_FAILURE;
+      }
     }
-    zfp_field_set_pointer(field, fo);
 
-    /* decompress data */
-    while (!zfp_decompress(zfp, field)) {
-      /* fall back on serial decompression if execution policy not supported */
-      if (inpath && zfp_stream_execution(zfp) != zfp_exec_serial) {
-        if (!zfp_stream_set_execution(zfp, zfp_exec_serial)) {
-          fprintf(stderr, "cannot change execution policy\n");
-          return EXIT_FAILURE;
-        }
+    /* decompress one slab at a time if requested */
+    rawsize = typesize * count;
+    if (planes) {
+      direct_file* dfile;
+      FILE* file;
+      if (zfp_field_dimensionality(field) != 3) {
+        fprintf(stderr, "slab streaming requires 3D array\n");
+        return EXIT_FAILURE;
       }
-      else {
+      dfile = direct && strcmp(outpath, "-") ? direct_open(outpath) : NULL;
+      file = dfile ? NULL : !strcmp(outpath, "-") ? stdout : fopen(outpath, "wb");
+      if (!file && !dfile) {
+        fprintf(stderr, "cannot create output file\n");
+        return EXIT_FAILURE;
+      }
+      start = wall_time();
+      if (!decompress_slabs(zfp, field, file, dfile, planes)) {
         fprintf(stderr, "decompression failed\n");
         return EXIT_FAILURE;
       }
+      if (!close_output(file, dfile)) {
+        fprintf(stderr, "cannot write output file\n");
+        return EXIT_FAILURE;
+      }
+      unziptime += wall_time() - start;
     }
-
-    /* optionally write reconstructed data */
-    if (outpath) {
-      FILE* file = !strcmp(outpath, "-") ? stdout : fopen(outpath, "wb");
-      if (!file) {
-        fprintf(stderr, "cannot create output file\n");
+    /* fuse error computation with decompression one slab at a time unless
+       this would prevent parallel decompression of variable-rate streams */
+    else if (stats && !outpath && zfp_field_dimensionality(field) == 3 &&
+             (zfp_stream_execution(zfp) == zfp_exec_serial ||
+              (zfp_stream_compression_mode(zfp) == zfp_mode_fixed_rate &&
+               (zfp_stream_execution(zfp) == zfp_exec_omp || zfp_stream_execution(zfp) == zfp_exec_threads)))) {
+      init_error(&err);
+      start = wall_time();
+      if (!decompress_error(zfp, field, fi, STATS_SLAB_PLANES, stats_threads(exec, threads), &err, &statstime)) {
+        fprintf(stderr, "decompression failed\n");
         return EXIT_FAILURE;
       }
-      if (fwrite(fo, typesize, count, file) != count) {
-        fprintf(stderr, "cannot write output file\n");
+      unziptime += wall_time() - start - statstime;
+    }
+    else {
+      /* allocate memory for decompressed data */
+      fo = malloc(rawsize);
+      if (!fo) {
+        fprintf(stderr, "cannot allocate memory\n");
         return EXIT_FAILURE;
       }
-      fclose(file);
+      zfp_field_set_pointer(field, fo);
+
+      /* decompress data */
+      start = wall_time();
+      while (!zfp_decompress(zfp, field)) {
+        /* fall back on serial decompression if execution policy not supported */
+        if (zfp_stream_execution(zfp) != zfp_exec_serial) {
+          if (!zfp_stream_set_execution(zfp, zfp_exec_serial)) {
+            fprintf(stderr, "cannot change execution policy\n");
+            return EXIT_FAILURE;
+          }
+        }
+        else {
+          fprintf(stderr, "decompression failed\n");
+          return EXIT_FAILURE;
+        }
+      }
+      unziptime += wall_time() - start;
+
+      /* optionally write reconstructed data */
+      if (outpath) {
+        FILE* file;
+        start = wall_time();
+        file = !strcmp(outpath, "-") ? stdout : fopen(outpath, "wb");
+        if (!file) {
+          fprintf(stderr, "cannot create output file\n");
+          return EXIT_FAILURE;
+        }
+        if (fwrite(fo, typesize, count, file) != count) {
+          fprintf(stderr, "cannot write output file\n");
+          return EXIT_FAILURE;
+        }
+        fclose(file);
+        iotime += wall_time() - start;
+        iosize += rawsize;
+      }
+
+      /* compute error statistics */
+      if (stats) {
+        init_error(&err);
+        start = wall_time();
+        add_error_par(&err, fi, fo, type, count, stats_threads(exec, threads));
+        statstime += wall_time() - start;
+      }
     }
   }
 
@@ -628,16 +2100,36 @@ int main(int argc, char* argv[])
     fprintf(stderr, "type=%s nx=%u ny=%u nz=%u nw=%u", type_name[type - zfp_type_int32], nx, ny, nz, nw);
     fprintf(stderr, " raw=%lu zfp=%lu ratio=%.3g rate=%.4g", (unsigned long)rawsize, (unsigned long)zfpsize, (double)rawsize / zfpsize, CHAR_BIT * (double)zfpsize / count);
     if (stats)
-      print_error(fi, fo, type, count);
+      print_error_stats(&err);
+    fprintf(stderr, "\n");
+  }
+
+  /* print time spent on each task and corresponding throughput */
+  if (timing) {
+    fprintf(stderr, "time:");
+    print_time("io", iotime, iosize);
+    if (inpath)
+      print_time("compress", ziptime, rawsize);
+    if ((!inpath && zfppath) || outpath || stats)
+      print_time("decompress", unziptime, rawsize);
+    if (stats)
+      print_time("stats", statstime, rawsize);
     fprintf(stderr, "\n");
   }
 
   /* free allocated storage */
   zfp_field_free(field);
+  zfp_index_free(zfp_stream_index(zfp));
   zfp_stream_close(zfp);
   stream_close(stream);
-  free(buffer);
-  free(fi);
+  if (mapped && !inpath)
+    unmap_file(buffer, mapsize);
+  else
+    free(buffer);
+  if (mapped && inpath)
+    unmap_file(fi, mapsize);
+  else
+    free(fi);
   free(fo);
 
   return EXIT_SUCCESS;